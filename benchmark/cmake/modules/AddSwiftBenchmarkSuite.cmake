@@ -351,6 +351,22 @@ function (swift_benchmark_compile_archopts)
       COMMAND
         "codesign" "-f" "-s" "-" "${OUTPUT_EXEC}")
   set(new_output_exec "${OUTPUT_EXEC}" PARENT_SCOPE)
+
+  # The code size of each module, from the object files rather than the
+  # executable, which is moved into the Swift bin directory after the build.
+  set(size_report
+      "${CMAKE_CURRENT_BINARY_DIR}/sizes/CodeSize_${BENCH_COMPILE_ARCHOPTS_OPT}-${target}.csv")
+  add_custom_command(
+      OUTPUT "${size_report}"
+      DEPENDS
+        ${bench_library_objects} ${SWIFT_BENCH_OBJFILES}
+        "${srcdir}/scripts/Benchmark_CodeSize"
+      COMMAND "${CMAKE_COMMAND}" "-E" "make_directory"
+              "${CMAKE_CURRENT_BINARY_DIR}/sizes"
+      COMMAND "${srcdir}/scripts/Benchmark_CodeSize"
+              "--output" "${size_report}"
+              "${objdir}")
+  set(new_size_report "${size_report}" PARENT_SCOPE)
 endfunction()
 
 function(swift_benchmark_compile)
@@ -369,12 +385,14 @@ function(swift_benchmark_compile)
   set(platform_executables)
   foreach(arch ${${SWIFT_BENCHMARK_COMPILE_PLATFORM}_arch})
     set(platform_executables)
+    set(platform_size_reports)
     foreach(optset ${SWIFT_OPTIMIZATION_LEVELS})
       swift_benchmark_compile_archopts(
         PLATFORM "${platform}"
         ARCH "${arch}"
         OPT "${optset}")
       list(APPEND platform_executables ${new_output_exec})
+      list(APPEND platform_size_reports ${new_size_report})
     endforeach()
 
     set(executable_target "swift-benchmark-${SWIFT_BENCHMARK_COMPILE_PLATFORM}-${arch}")
@@ -382,6 +400,9 @@ function(swift_benchmark_compile)
     add_custom_target("${executable_target}"
         DEPENDS ${platform_executables})
 
+    add_custom_target("swift-benchmark-size-report-${SWIFT_BENCHMARK_COMPILE_PLATFORM}-${arch}"
+        DEPENDS ${platform_size_reports})
+
     if(IS_SWIFT_BUILD AND "${SWIFT_BENCHMARK_COMPILE_PLATFORM}" STREQUAL "macosx")
       add_custom_command(
           TARGET "${executable_target}"
@@ -0,0 +1,483 @@
+//===--- BigLiterals.swift ------------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+// Large array and dictionary literals, some without a type annotation. Stresses
+// literal type inference in the constraint solver and SILGen of big
+// initializers.
+
+
+public let integerTable: [Int] = [
+  65314, 58412, 43313, 72134, 68668, 49360, 61773, 1274, 19894, 18510,
+  58026, 87190, 98998, 78441, -813, 40569, 36837, 93443, 45909, 28044,
+  38942, 88462, 16332, 78071, 8874, 26749, 66361, 97349, 38047, 75003,
+  72276, 22556, 93141, 42389, 23231, 49319, 29660, 84239, 57781, 31158,
+  90339, 57703, 1340, 72065, 92827, 94885, 55762, 44788, 37168, 44782,
+  96060, 34935, 75699, 44592, 93308, 11872, 20388, 7121, 55029, 85978,
+  39248, 33881, 22792, 28396, 59611, 12150, 28685, 23756, 13980, 23143,
+  80777, 93885, 38105, 49040, 3751, 1446, 50271, 69160, 21664, 16432,
+  14981, 48971, 49973, 30543, 3701, 75415, 44895, 1005, 89366, 29200,
+  47572, 58395, 54075, 39066, 11620, 53815, 92913, 3551, 54932, 24676,
+  11740, 2495, 68035, 96346, 86015, 98153, 95676, 60932, 89603, 23916,
+  45315, 36669, 74348, 73433, 1446, 60675, 66528, 49953, 65516, 42827,
+  23586, 34954, 51980, 32195, 55321, 88742, 99859, 70122, 98351, 76451,
+  17687, 75396, 91194, 4409, 66949, 4475, 20836, 93122, 8866, 31066,
+  32496, 6228, 88331, 99710, 38856, 66297, 27121, 20149, 88634, 57450,
+  21488, 94345, 8229, 29725, 74639, 51297, 39761, 46262, 89207, 26671,
+  28917, 29479, 42620, 94241, 44254, 97537, 66087, 13227, 39360, 49207,
+  97808, 39237, 63390, 10453, 55655, 14890, 7708, 83992, 19323, 47609,
+  26811, 32464, 67166, 73738, 85936, 58793, 16388, 78585, 24660, 81374,
+  3521, 94516, 80440, 53885, 30395, 56498, 90453, 60694, 12830, 38748,
+  87990, 21736, 63008, 92862, 4692, 23674, 29887, 20812, 48876, 56574,
+  55180, 56990, 28309, 18678, 11843, 97210, 58778, 97884, 97779, 59007,
+  32325, 38511, 39609, 71294, 96994, 45815, 31452, 46149, 86679, 82642,
+  33677, 21613, 27960, 7770, 46789, -734, 18255, 41079, 97781, 29507,
+  59846, 77623, 71203, 29805, 65349, 59507, 65288, 10151, 81758, 82943,
+  35363, 45714, 20918, -226, 46216, 44002, 51466, 33759, 6036, 70416,
+  36028, 41729, 39384, 64150, 18255, 54420, 85418, 5718, 7546, 63390,
+  97192, 43680, 37245, 8535, 84608, 10255, 82470, 67162, 14565, 44083,
+  14447, 11966, 84942, 15976, 47089, 64701, 20146, 83056, 35158, 84212,
+  34709, 65919, 30523, 52069, 3400, 44028, 49104, 5816, -937, 2286,
+  18970, 6384, 70492, 69245, 41932, 56410, 92665, 74767, 94885, 84775,
+  93195, 62122, 1872, 35538, 74824, 16024, 50776, 50312, 45281, 78349,
+  84004, 56327, 51812, 59145, 93180, 23196, 35340, 89752, 10076, 40221,
+  12729, 97662, 54661, 97547, 78173, 83632, 35846, 30983, 65649, 30057,
+  89588, 3184, 24665, 3745, 43359, 69400, 38658, 43663, 4534, 50963,
+  14015, 57666, 18462, 39046, 86454, 6263, 58865, 26943, 27536, 94239,
+  77873, 3613, 617, 54628, 57204, 96895, 70007, 91444, 97964, 976,
+  42343, 96516, 54946, 43265, 57773, 71688, 33829, 14716, 95973, 54008,
+  52789, 24893, 10340, 15844, 70550, 79771, 37138, 40849, 7255, 19624,
+  42619, 4912, 33718, 62841, -726, 87928, 84273, 84297, 1603, 47211,
+  99969, 92941, 99168, 58664, 90198, 52164, 24002, 71409, 68750, 76644,
+  58178, 2385, 45962, 59977, 34585, 19396, 5701, 24064, 49995, 14324,
+  67200, 22292, 30256, 72358, 387, 45719, 64217, 25393, 48051, 1611,
+  66226, 90977, 22242, 76605, 25172, 96974, 47631, 6580, 19137, 88980,
+  78365, 1955, 86840, 30719, 97640, 73708, 33649, 80149, 35455, 34965,
+  83479, 74834, 58776, 11465, 19403, 8563, 79263, 1246, 95113, 24197,
+  82509, 51373, 1004, 61765, 19776, 18700, 14343, 47397, 79852, 24317,
+  7479, 70446, 27409, 62314, 13550, 64537, 23662, 19171, 93961, 85023,
+  35623, 91747, 88900, 83666, 18676, 51217, 55827, 99898, 97966, 8084,
+  41060, 12015, 39061, 59004, 2005, 55099, 6985, 41931, 74542, 97666,
+  37389, 58650, 81509, 35106, 32800, 93066, 53755, 97650, 30093, 34526,
+  15388, 77959, 29822, 70521, 42582, 81996, 36709, 608, 47270, 51588,
+  59785, 3675, 53799, 74059, 48974, 40375, 74273, 927, 33343, 49278,
+  32880, 75087, 41906, 74348, 92869, 33161, 92579, 33029, 2087, 78299,
+  90246, 19176, 92432, 5722, 76187, 66195, 90242, 38989, 92910, 8416,
+  70243, 50846, 56136, 65543, 55961, 59745, 7015, 52621, 78961, 47570,
+  78456, 38406, 4994, 54435, 65388, 15584, 55411, 79376, 72620, 6872,
+  32875, 46005, 43265, 23525, 38803, 11844, 74189, 63055, 30988, 2202,
+  66956, 19176, 3941, 59808, 28294, 76628, 5280, 27470, 16584, 71751,
+  13001, 72057, 25097, 80478, 51332, 45520, 57791, 10274, 77127, 35188,
+]
+
+public let mixedPoints = [
+  [384, 210.2, 5],
+  [156, 14.6, 20],
+  [277, 474.5, 33],
+  [366, 436.9, 16],
+  [362, 168.6, 42],
+  [330, 393.8, 45],
+  [151, 302.5, 14],
+  [392, 28.2, 41],
+  [39, 307.8, 21],
+  [415, 478.0, 12],
+  [400, 203.3, 11],
+  [234, 359.4, 42],
+  [425, 473.2, 17],
+  [103, 123.9, 22],
+  [129, 303.1, 4],
+  [228, 36.1, 44],
+  [469, 319.3, 25],
+  [345, 72.8, 26],
+  [422, 291.8, 30],
+  [221, 290.9, 10],
+  [363, 15.1, 8],
+  [172, 40.5, 4],
+  [157, 413.5, 49],
+  [66, 498.4, 8],
+  [190, 392.9, 0],
+  [280, 6.9, 32],
+  [100, 428.6, 30],
+  [383, 184.6, 25],
+  [240, 204.9, 2],
+  [455, 208.6, 3],
+  [348, 182.6, 10],
+  [172, 371.7, 19],
+  [89, 361.1, 0],
+  [359, 318.7, 37],
+  [178, 483.3, 8],
+  [154, 218.0, 23],
+  [297, 202.2, 2],
+  [292, 313.5, 13],
+  [382, 253.2, 18],
+  [83, 458.1, 33],
+  [24, 301.9, 31],
+  [191, 279.0, 29],
+  [232, 462.8, 8],
+  [156, 447.1, 8],
+  [262, 203.0, 31],
+  [463, 327.7, 14],
+  [388, 364.0, 9],
+  [124, 221.5, 18],
+  [398, 360.2, 19],
+  [133, 444.0, 22],
+  [221, 75.2, 6],
+  [34, 425.5, 29],
+  [56, 94.5, 30],
+  [366, 392.4, 19],
+  [66, 208.6, 0],
+  [192, 55.5, 25],
+  [96, 334.6, 25],
+  [332, 393.3, 42],
+  [42, 179.9, 4],
+  [205, 176.1, 6],
+  [404, 350.2, 38],
+  [72, 460.8, 47],
+  [252, 354.6, 39],
+  [322, 459.6, 0],
+  [131, 15.8, 6],
+  [405, 84.6, 48],
+  [262, 309.1, 8],
+  [181, 393.0, 17],
+  [126, 199.4, 18],
+  [71, 493.6, 42],
+  [306, 159.6, 27],
+  [435, 92.7, 47],
+  [44, 483.8, 5],
+  [445, 132.7, 44],
+  [49, 93.0, 15],
+  [151, 308.0, 40],
+  [103, 442.4, 28],
+  [425, 295.6, 33],
+  [194, 195.6, 16],
+  [418, 162.8, 46],
+  [158, 236.8, 47],
+  [65, 428.6, 35],
+  [107, 26.5, 31],
+  [300, 54.6, 49],
+  [450, 392.3, 18],
+  [197, 401.1, 22],
+  [287, 359.3, 32],
+  [204, 337.3, 18],
+  [280, 181.9, 1],
+  [96, 45.7, 40],
+  [405, 73.7, 22],
+  [488, 396.1, 4],
+  [23, 135.0, 9],
+  [273, 170.7, 46],
+  [15, 324.4, 35],
+  [206, 49.6, 19],
+  [389, 118.7, 38],
+  [437, 2.1, 27],
+  [152, 326.2, 36],
+  [174, 99.1, 7],
+  [294, 426.8, 47],
+  [164, 492.9, 9],
+  [498, 204.4, 20],
+  [301, 37.2, 41],
+  [227, 137.2, 22],
+  [376, 48.4, 26],
+  [213, 242.8, 32],
+  [317, 471.3, 29],
+  [144, 252.2, 14],
+  [111, 235.3, 15],
+  [164, 27.4, 16],
+  [9, 342.0, 31],
+  [435, 199.3, 22],
+  [49, 113.2, 5],
+  [304, 389.9, 14],
+  [332, 144.3, 22],
+  [189, 322.3, 5],
+  [199, 188.9, 10],
+  [34, 376.1, 16],
+  [281, 353.7, 43],
+  [97, 452.0, 6],
+  [190, 94.5, 22],
+  [243, 456.7, 17],
+  [268, 331.0, 25],
+  [397, 110.1, 20],
+  [199, 152.0, 6],
+  [134, 174.5, 13],
+  [84, 194.2, 28],
+  [353, 338.5, 12],
+  [378, 120.1, 11],
+  [29, 154.2, 24],
+  [338, 300.1, 30],
+  [175, 379.2, 16],
+  [87, 82.5, 38],
+  [150, 358.9, 26],
+  [337, 297.8, 40],
+  [93, 43.0, 16],
+  [177, 325.7, 21],
+  [267, 376.1, 33],
+  [263, 65.0, 28],
+  [297, 12.0, 45],
+  [56, 363.5, 0],
+  [459, 161.8, 15],
+  [98, 369.8, 7],
+  [374, 66.7, 46],
+  [106, 199.4, 38],
+  [1, 409.3, 14],
+  [358, 103.0, 3],
+  [136, 114.8, 0],
+  [172, 141.7, 9],
+]
+
+public let namedValues: [String: (Int, Double)] = [
+  "key0": (603, 94.58),
+  "key1": (916, 20.41),
+  "key2": (461, 98.78),
+  "key3": (245, 71.87),
+  "key4": (734, 30.73),
+  "key5": (403, 20.96),
+  "key6": (862, 97.91),
+  "key7": (733, 82.50),
+  "key8": (666, 9.39),
+  "key9": (316, 61.55),
+  "key10": (583, 57.63),
+  "key11": (529, 62.87),
+  "key12": (892, 19.58),
+  "key13": (285, 87.91),
+  "key14": (899, 49.67),
+  "key15": (982, 7.43),
+  "key16": (288, 19.98),
+  "key17": (785, 8.10),
+  "key18": (572, 1.11),
+  "key19": (583, 50.76),
+  "key20": (285, 61.42),
+  "key21": (144, 72.9),
+  "key22": (721, 5.20),
+  "key23": (105, 34.79),
+  "key24": (777, 94.63),
+  "key25": (420, 97.80),
+  "key26": (505, 17.10),
+  "key27": (778, 66.79),
+  "key28": (546, 47.19),
+  "key29": (862, 81.75),
+  "key30": (628, 56.68),
+  "key31": (365, 10.37),
+  "key32": (333, 96.44),
+  "key33": (986, 64.74),
+  "key34": (538, 20.15),
+  "key35": (649, 54.75),
+  "key36": (1, 70.19),
+  "key37": (15, 40.27),
+  "key38": (709, 23.95),
+  "key39": (718, 71.10),
+  "key40": (641, 66.54),
+  "key41": (149, 0.14),
+  "key42": (499, 69.44),
+  "key43": (771, 10.3),
+  "key44": (431, 20.15),
+  "key45": (346, 44.12),
+  "key46": (391, 97.24),
+  "key47": (535, 53.31),
+  "key48": (715, 68.22),
+  "key49": (28, 11.58),
+  "key50": (175, 14.6),
+  "key51": (436, 13.14),
+  "key52": (825, 51.59),
+  "key53": (196, 97.78),
+  "key54": (155, 38.99),
+  "key55": (16, 8.5),
+  "key56": (157, 40.63),
+  "key57": (576, 90.30),
+  "key58": (986, 63.50),
+  "key59": (128, 21.99),
+  "key60": (139, 95.64),
+  "key61": (325, 58.40),
+  "key62": (687, 61.70),
+  "key63": (474, 73.47),
+  "key64": (216, 49.44),
+  "key65": (792, 0.1),
+  "key66": (113, 2.39),
+  "key67": (951, 48.48),
+  "key68": (104, 65.93),
+  "key69": (792, 45.47),
+  "key70": (261, 63.12),
+  "key71": (420, 63.94),
+  "key72": (319, 65.20),
+  "key73": (446, 71.88),
+  "key74": (770, 9.66),
+  "key75": (6, 64.34),
+  "key76": (123, 70.33),
+  "key77": (697, 88.32),
+  "key78": (667, 55.63),
+  "key79": (849, 93.61),
+  "key80": (908, 38.13),
+  "key81": (403, 78.31),
+  "key82": (123, 10.83),
+  "key83": (503, 38.85),
+  "key84": (597, 4.26),
+  "key85": (341, 39.22),
+  "key86": (470, 100.82),
+  "key87": (378, 67.33),
+  "key88": (396, 25.49),
+  "key89": (933, 39.47),
+  "key90": (21, 85.30),
+  "key91": (312, 1.0),
+  "key92": (193, 30.86),
+  "key93": (891, 53.46),
+  "key94": (550, 2.96),
+  "key95": (865, 72.74),
+  "key96": (366, 45.72),
+  "key97": (148, 91.97),
+  "key98": (966, 39.60),
+  "key99": (597, 47.5),
+  "key100": (91, 80.67),
+  "key101": (921, 82.99),
+  "key102": (73, 15.2),
+  "key103": (976, 79.68),
+  "key104": (221, 9.62),
+  "key105": (617, 80.44),
+  "key106": (9, 61.98),
+  "key107": (844, 81.35),
+  "key108": (199, 63.37),
+  "key109": (155, 51.23),
+  "key110": (638, 22.58),
+  "key111": (541, 65.13),
+  "key112": (344, 80.39),
+  "key113": (969, 2.71),
+  "key114": (670, 43.48),
+  "key115": (81, 28.87),
+  "key116": (741, 10.48),
+  "key117": (425, 46.60),
+  "key118": (270, 72.16),
+  "key119": (306, 7.93),
+  "key120": (500, 24.59),
+  "key121": (546, 25.75),
+  "key122": (686, 78.31),
+  "key123": (343, 37.23),
+  "key124": (632, 13.72),
+  "key125": (656, 82.73),
+  "key126": (855, 88.85),
+  "key127": (451, 68.10),
+  "key128": (567, 4.33),
+  "key129": (865, 92.45),
+  "key130": (515, 53.29),
+  "key131": (840, 17.98),
+  "key132": (504, 3.48),
+  "key133": (433, 74.37),
+  "key134": (227, 5.52),
+  "key135": (924, 64.62),
+  "key136": (952, 80.63),
+  "key137": (346, 83.36),
+  "key138": (597, 79.16),
+  "key139": (297, 9.76),
+  "key140": (528, 29.47),
+  "key141": (593, 63.8),
+  "key142": (239, 69.5),
+  "key143": (786, 7.31),
+  "key144": (230, 93.6),
+  "key145": (327, 48.99),
+  "key146": (943, 30.54),
+  "key147": (795, 27.92),
+  "key148": (602, 25.36),
+  "key149": (88, 18.37),
+  "key150": (738, 84.13),
+  "key151": (951, 68.20),
+  "key152": (39, 13.50),
+  "key153": (338, 10.77),
+  "key154": (903, 69.93),
+  "key155": (397, 68.97),
+  "key156": (70, 4.59),
+  "key157": (611, 1.6),
+  "key158": (103, 87.62),
+  "key159": (524, 99.71),
+  "key160": (493, 39.16),
+  "key161": (526, 65.72),
+  "key162": (366, 74.87),
+  "key163": (651, 0.1),
+  "key164": (563, 100.90),
+  "key165": (653, 19.16),
+  "key166": (823, 50.72),
+  "key167": (925, 69.66),
+  "key168": (554, 43.98),
+  "key169": (532, 58.3),
+  "key170": (331, 36.77),
+  "key171": (699, 94.84),
+  "key172": (642, 81.18),
+  "key173": (730, 18.29),
+  "key174": (577, 8.29),
+  "key175": (579, 5.77),
+  "key176": (962, 22.14),
+  "key177": (713, 86.61),
+  "key178": (635, 9.0),
+  "key179": (263, 27.21),
+  "key180": (825, 35.61),
+  "key181": (605, 40.74),
+  "key182": (28, 91.53),
+  "key183": (235, 8.61),
+  "key184": (266, 67.6),
+  "key185": (606, 37.52),
+  "key186": (146, 52.63),
+  "key187": (844, 59.78),
+  "key188": (945, 31.54),
+  "key189": (116, 89.1),
+  "key190": (192, 30.85),
+  "key191": (818, 67.11),
+  "key192": (537, 54.25),
+  "key193": (391, 90.95),
+  "key194": (360, 70.63),
+  "key195": (458, 40.55),
+  "key196": (246, 66.9),
+  "key197": (559, 5.67),
+  "key198": (937, 51.78),
+  "key199": (412, 24.45),
+]
+
+public let nested: [String: [String: [Int]]] = [
+  "outer0": ["a": [0, 1], "b": [0], "c": []],
+  "outer1": ["a": [1, 2], "b": [2], "c": []],
+  "outer2": ["a": [2, 3], "b": [4], "c": []],
+  "outer3": ["a": [3, 4], "b": [6], "c": []],
+  "outer4": ["a": [4, 5], "b": [8], "c": []],
+  "outer5": ["a": [5, 6], "b": [10], "c": []],
+  "outer6": ["a": [6, 7], "b": [12], "c": []],
+  "outer7": ["a": [7, 8], "b": [14], "c": []],
+  "outer8": ["a": [8, 9], "b": [16], "c": []],
+  "outer9": ["a": [9, 10], "b": [18], "c": []],
+  "outer10": ["a": [10, 11], "b": [20], "c": []],
+  "outer11": ["a": [11, 12], "b": [22], "c": []],
+  "outer12": ["a": [12, 13], "b": [24], "c": []],
+  "outer13": ["a": [13, 14], "b": [26], "c": []],
+  "outer14": ["a": [14, 15], "b": [28], "c": []],
+  "outer15": ["a": [15, 16], "b": [30], "c": []],
+  "outer16": ["a": [16, 17], "b": [32], "c": []],
+  "outer17": ["a": [17, 18], "b": [34], "c": []],
+  "outer18": ["a": [18, 19], "b": [36], "c": []],
+  "outer19": ["a": [19, 20], "b": [38], "c": []],
+  "outer20": ["a": [20, 21], "b": [40], "c": []],
+  "outer21": ["a": [21, 22], "b": [42], "c": []],
+  "outer22": ["a": [22, 23], "b": [44], "c": []],
+  "outer23": ["a": [23, 24], "b": [46], "c": []],
+  "outer24": ["a": [24, 25], "b": [48], "c": []],
+  "outer25": ["a": [25, 26], "b": [50], "c": []],
+  "outer26": ["a": [26, 27], "b": [52], "c": []],
+  "outer27": ["a": [27, 28], "b": [54], "c": []],
+  "outer28": ["a": [28, 29], "b": [56], "c": []],
+  "outer29": ["a": [29, 30], "b": [58], "c": []],
+  "outer30": ["a": [30, 31], "b": [60], "c": []],
+  "outer31": ["a": [31, 32], "b": [62], "c": []],
+  "outer32": ["a": [32, 33], "b": [64], "c": []],
+  "outer33": ["a": [33, 34], "b": [66], "c": []],
+  "outer34": ["a": [34, 35], "b": [68], "c": []],
+  "outer35": ["a": [35, 36], "b": [70], "c": []],
+  "outer36": ["a": [36, 37], "b": [72], "c": []],
+  "outer37": ["a": [37, 38], "b": [74], "c": []],
+  "outer38": ["a": [38, 39], "b": [76], "c": []],
+  "outer39": ["a": [39, 40], "b": [78], "c": []],
+]
+
+public func run_BigLiterals() -> Int {
+  return integerTable.count + mixedPoints.count + namedValues.count +
+         nested.count
+}
@@ -0,0 +1,81 @@
+//===--- DeepGenerics.swift -----------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+// Deeply nested generic types and long chains of generic calls. Stresses
+// generic signature building, substitution and specialization.
+
+public struct Box<T> {
+  public var value: T
+  public init(_ value: T) { self.value = value }
+
+  public func map<U>(_ f: (T) -> U) -> Box<U> {
+    return Box<U>(f(value))
+  }
+}
+
+public struct Pair<A, B> {
+  public var first: A
+  public var second: B
+  public init(_ first: A, _ second: B) {
+    self.first = first
+    self.second = second
+  }
+
+  public func swapped() -> Pair<B, A> {
+    return Pair<B, A>(second, first)
+  }
+}
+
+extension Pair where A: Equatable, B: Equatable {
+  public func isEqual(to other: Pair) -> Bool {
+    return first == other.first && second == other.second
+  }
+}
+
+extension Box where T: Sequence, T.Iterator.Element: Comparable {
+  public func largest() -> T.Iterator.Element? {
+    return value.max()
+  }
+}
+
+public func compose<A, B, C>(_ f: @escaping (A) -> B,
+                             _ g: @escaping (B) -> C) -> (A) -> C {
+  return { g(f($0)) }
+}
+
+public func nest<T>(_ x: T) -> Box<Box<Box<Box<Box<T>>>>> {
+  return Box(Box(Box(Box(Box(x)))))
+}
+
+public func unnest<T>(_ x: Box<Box<Box<Box<Box<T>>>>>) -> T {
+  return x.value.value.value.value.value
+}
+
+public func pairs<A, B, C, D>(_ a: A, _ b: B, _ c: C, _ d: D)
+    -> Pair<Pair<A, B>, Pair<C, D>> {
+  return Pair(Pair(a, b), Pair(c, d))
+}
+
+public func run_DeepGenerics() -> Int {
+  let f = compose(compose(compose({ (x: Int) in x + 1 },
+                                  { (x: Int) in Box(x) }),
+                          { (b: Box<Int>) in b.map { [$0, $0 * 2] } }),
+                  { (b: Box<[Int]>) in b.largest() ?? 0 })
+  let nested = nest(pairs(1, "a", 2.0, [f(3)]))
+  let p = unnest(nested)
+  let q = p.swapped().swapped()
+  var result = f(q.first.first)
+  if q.first.isEqual(to: p.first) {
+    result += q.second.second.count
+  }
+  return unnest(nest(nest(nest(result)))).value.value.value.value.value
+}
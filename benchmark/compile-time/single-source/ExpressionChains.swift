@@ -0,0 +1,28 @@
+//===--- ExpressionChains.swift -------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+// Long expressions mixing literals, overloaded operators and closures.
+// Stresses overload resolution in the constraint solver.
+
+
+public func run_ExpressionChains(_ x: Int, _ y: Double) -> Double {
+  let a = Double(x) * 2.5 + y / 3 - 1.25 * y + 4 * (y - 0.5) / 7.0
+  let b = [1, 2, 3, 4, 5].map { $0 * 2 + 1 }.filter { $0 % 3 != 0 }
+          .reduce(0, +)
+  let c = Double(b) + a * a - y * (a + 2) / (y + 1.5) + 0.25 * Double(x)
+  let d = (x + 1) * (x + 2) * (x + 3) - (x - 1) * (x - 2) + 37 % (x | 1)
+  let e = [0.5, 1.5, 2.5].reduce(0) { $0 + $1 * 2 } + Double(d) / 3
+  let f = y > 0 ? (a + c) * 0.5 - e : (a - c) * 2 + e - Double(x << 2)
+  let g = (1...10).map { Double($0) * 0.1 + y }.map { $0 * $0 - 2 * $0 }
+          .reduce(1) { $0 + $1 / 2 }
+  return a + c + e + f + g - Double(1 + 2 * 3 - 4 / 2 + 5 * 6 - 7)
+}
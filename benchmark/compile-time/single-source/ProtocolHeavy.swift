@@ -0,0 +1,149 @@
+//===--- ProtocolHeavy.swift ----------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+// Protocol hierarchies with associated types, protocol extensions and many
+// conformances. Stresses conformance checking, associated type inference and
+// witness table emission.
+
+public protocol Shape {
+  associatedtype Measure: Comparable
+  var area: Measure { get }
+  var name: String { get }
+}
+
+public protocol Scalable: Shape {
+  func scaled(by factor: Double) -> Self
+}
+
+public protocol Container {
+  associatedtype Element
+  associatedtype Index: Comparable
+  var startIndex: Index { get }
+  var endIndex: Index { get }
+  subscript(i: Index) -> Element { get }
+  func index(after i: Index) -> Index
+}
+
+extension Shape {
+  public var name: String { return String(describing: type(of: self)) }
+
+  public func isLarger<S: Shape>(than other: S) -> Bool
+      where S.Measure == Measure {
+    return area > other.area
+  }
+}
+
+extension Scalable where Measure == Double {
+  public func doubled() -> Self { return scaled(by: 2) }
+}
+
+extension Container {
+  public var count: Int {
+    var n = 0
+    var i = startIndex
+    while i < endIndex {
+      n += 1
+      i = index(after: i)
+    }
+    return n
+  }
+
+  public func first(where predicate: (Element) -> Bool) -> Element? {
+    var i = startIndex
+    while i < endIndex {
+      if predicate(self[i]) { return self[i] }
+      i = index(after: i)
+    }
+    return nil
+  }
+}
+
+extension Container where Element: Shape {
+  public func largest() -> Element? {
+    var best: Element? = nil
+    var i = startIndex
+    while i < endIndex {
+      if best == nil || self[i].isLarger(than: best!) {
+        best = self[i]
+      }
+      i = index(after: i)
+    }
+    return best
+  }
+}
+
+public struct Circle: Scalable {
+  public var radius: Double
+  public var area: Double { return 3.14159 * radius * radius }
+  public func scaled(by factor: Double) -> Circle {
+    return Circle(radius: radius * factor)
+  }
+}
+
+public struct Square: Scalable {
+  public var side: Double
+  public var area: Double { return side * side }
+  public func scaled(by factor: Double) -> Square {
+    return Square(side: side * factor)
+  }
+}
+
+public struct Rectangle: Scalable {
+  public var width: Double
+  public var height: Double
+  public var area: Double { return width * height }
+  public func scaled(by factor: Double) -> Rectangle {
+    return Rectangle(width: width * factor, height: height * factor)
+  }
+}
+
+public struct Grid: Shape {
+  public var cells: Int
+  public var area: Int { return cells }
+}
+
+public struct ShapeList<S: Shape>: Container {
+  public var shapes: [S]
+  public var startIndex: Int { return 0 }
+  public var endIndex: Int { return shapes.count }
+  public subscript(i: Int) -> S { return shapes[i] }
+  public func index(after i: Int) -> Int { return i + 1 }
+}
+
+public struct Repeated<T>: Container {
+  public var element: T
+  public var times: Int
+  public var startIndex: Int { return 0 }
+  public var endIndex: Int { return times }
+  public subscript(i: Int) -> T { return element }
+  public func index(after i: Int) -> Int { return i + 1 }
+}
+
+public func run_ProtocolHeavy() -> Int {
+  let circles = ShapeList(shapes: [Circle(radius: 1), Circle(radius: 2)])
+  let squares = ShapeList(shapes: [Square(side: 1).doubled(), Square(side: 3)])
+  let rects = ShapeList(shapes: [Rectangle(width: 1, height: 2).doubled()])
+  let grids = ShapeList(shapes: [Grid(cells: 4), Grid(cells: 9)])
+  let repeated = Repeated(element: Circle(radius: 3), times: 3)
+  var total = circles.count + squares.count + rects.count + grids.count
+  if let c = circles.largest(), let s = squares.largest(),
+     c.isLarger(than: s) {
+    total += 1
+  }
+  if let g = grids.first(where: { $0.area > 5 }) {
+    total += g.area
+  }
+  if let r = repeated.largest(), r.isLarger(than: Circle(radius: 1)) {
+    total += repeated.count
+  }
+  return total + (rects.largest()?.name.characters.count ?? 0)
+}
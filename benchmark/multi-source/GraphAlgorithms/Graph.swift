@@ -0,0 +1,111 @@
+//===--- Graph.swift ------------------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+/// A weighted directed graph over any hashable vertex type. Vertices are
+/// numbered in the order in which they are added, and the algorithms work on
+/// those numbers.
+struct Graph<Vertex : Hashable> {
+  private(set) var vertices: [Vertex] = []
+  private var indices: [Vertex: Int] = [:]
+  private(set) var edges: [[(to: Int, weight: Int)]] = []
+
+  mutating func index(of vertex: Vertex) -> Int {
+    if let index = indices[vertex] {
+      return index
+    }
+    let index = vertices.count
+    vertices.append(vertex)
+    indices[vertex] = index
+    edges.append([])
+    return index
+  }
+
+  mutating func addEdge(from: Vertex, to: Vertex, weight: Int) {
+    let source = index(of: from)
+    let destination = index(of: to)
+    edges[source].append((to: destination, weight: weight))
+  }
+
+  mutating func addUndirectedEdge(_ a: Vertex, _ b: Vertex, weight: Int) {
+    addEdge(from: a, to: b, weight: weight)
+    addEdge(from: b, to: a, weight: weight)
+  }
+
+  /// Returns the number of edges on the shortest path from `source` to each
+  /// vertex, or nil for vertices which cannot be reached.
+  func hops(from source: Vertex) -> [Int?] {
+    var result = [Int?](repeating: nil, count: vertices.count)
+    guard let start = indices[source] else {
+      return result
+    }
+    result[start] = 0
+    var queue = [start]
+    var head = 0
+    while head < queue.count {
+      let u = queue[head]
+      head += 1
+      for edge in edges[u] where result[edge.to] == nil {
+        result[edge.to] = result[u]! + 1
+        queue.append(edge.to)
+      }
+    }
+    return result
+  }
+
+  /// Dijkstra's algorithm: returns the weight of the lightest path from
+  /// `source` to each vertex, or nil for vertices which cannot be reached.
+  func distances(from source: Vertex) -> [Int?] {
+    var result = [Int?](repeating: nil, count: vertices.count)
+    guard let start = indices[source] else {
+      return result
+    }
+    var queue = PriorityQueue<(vertex: Int, distance: Int)> {
+      $0.distance < $1.distance
+    }
+    queue.push((vertex: start, distance: 0))
+    while let (u, distance) = queue.pop() {
+      if result[u] != nil {
+        continue
+      }
+      result[u] = distance
+      for edge in edges[u] where result[edge.to] == nil {
+        queue.push((vertex: edge.to, distance: distance + edge.weight))
+      }
+    }
+    return result
+  }
+
+  /// Returns the number of weakly connected components.
+  func componentCount() -> Int {
+    var parent = Array(0..<vertices.count)
+    func find(_ v: Int) -> Int {
+      var v = v
+      while parent[v] != v {
+        parent[v] = parent[parent[v]]
+        v = parent[v]
+      }
+      return v
+    }
+    var count = vertices.count
+    for u in 0..<vertices.count {
+      for edge in edges[u] {
+        let a = find(u)
+        let b = find(edge.to)
+        if a != b {
+          parent[a] = b
+          count -= 1
+        }
+      }
+    }
+    return count
+  }
+}
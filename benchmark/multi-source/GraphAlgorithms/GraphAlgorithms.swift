@@ -0,0 +1,126 @@
+//===--- GraphAlgorithms.swift --------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+// Shortest paths and connectivity on generic graphs, with a struct and a
+// String as vertex types.
+import TestsUtils
+
+struct GridPoint : Hashable {
+  var x: Int
+  var y: Int
+
+  var hashValue: Int {
+    return x &* 31 &+ y
+  }
+
+  static func == (lhs: GridPoint, rhs: GridPoint) -> Bool {
+    return lhs.x == rhs.x && lhs.y == rhs.y
+  }
+}
+
+/// A grid with edges to the four neighbours of each point, weighted by a
+/// function of their position.
+private func makeGrid(_ size: Int, unitWeights: Bool) -> Graph<GridPoint> {
+  var graph = Graph<GridPoint>()
+  for x in 0..<size {
+    for y in 0..<size {
+      let p = GridPoint(x: x, y: y)
+      let weight = unitWeights ? 1 : 1 + (x * 7 + y * 13) % 9
+      if x + 1 < size {
+        graph.addUndirectedEdge(p, GridPoint(x: x + 1, y: y), weight: weight)
+      }
+      if y + 1 < size {
+        graph.addUndirectedEdge(p, GridPoint(x: x, y: y + 1), weight: weight)
+      }
+    }
+  }
+  return graph
+}
+
+/// Several rings of named places, joined by a few roads.
+private func makeRoads(rings: Int, size: Int) -> Graph<String> {
+  var graph = Graph<String>()
+  for ring in 0..<rings {
+    for i in 0..<size {
+      graph.addUndirectedEdge("place \(ring).\(i)",
+                              "place \(ring).\((i + 1) % size)",
+                              weight: 1 + (ring + i) % 5)
+    }
+  }
+  // Join every pair of neighbouring rings but the last one.
+  for ring in 0..<(rings - 2) {
+    graph.addUndirectedEdge("place \(ring).0", "place \(ring + 1).\(ring)",
+                            weight: 10)
+  }
+  return graph
+}
+
+/// Checks that `distances` are shortest path weights from `source`: every
+/// edge is relaxed, and every reached vertex but the source has an edge on a
+/// shortest path to it.
+private func verify<V : Hashable>(_ graph: Graph<V>, _ distances: [Int?],
+                       from source: V) -> Bool {
+  var tight = [Bool](repeating: false, count: graph.vertices.count)
+  for (u, edges) in graph.edges.enumerated() {
+    guard let du = distances[u] else {
+      continue
+    }
+    for edge in edges {
+      guard let dv = distances[edge.to], dv <= du + edge.weight else {
+        return false
+      }
+      if dv == du + edge.weight {
+        tight[edge.to] = true
+      }
+    }
+  }
+  for (v, vertex) in graph.vertices.enumerated() where vertex != source {
+    if distances[v] != nil && !tight[v] {
+      return false
+    }
+  }
+  return true
+}
+
+@inline(never)
+public func run_GraphAlgorithms(_ N: Int) {
+  let size = 40
+  let grid = makeGrid(size, unitWeights: false)
+  let unitGrid = makeGrid(size, unitWeights: true)
+  let roads = makeRoads(rings: 10, size: 50)
+  let corner = GridPoint(x: 0, y: 0)
+  let farCorner = GridPoint(x: size - 1, y: size - 1)
+  let farIndex = unitGrid.vertices.index(of: farCorner)!
+
+  CheckResults(
+    verify(grid, grid.distances(from: corner), from: corner) &&
+    verify(roads, roads.distances(from: "place 0.0"), from: "place 0.0"),
+    "Incorrect results in GraphAlgorithms: wrong distances")
+
+  for _ in 1...N {
+    let distances = grid.distances(from: corner)
+    let unitDistances = unitGrid.distances(from: corner)
+    let hops = unitGrid.hops(from: corner)
+    let roadDistances = roads.distances(from: "place 0.0")
+    let components = grid.componentCount() + roads.componentCount()
+
+    var unreachable = 0
+    for distance in roadDistances where distance == nil {
+      unreachable += 1
+    }
+    CheckResults(distances[farIndex] != nil &&
+                 unitDistances.elementsEqual(hops) { $0 == $1 } &&
+                 hops[farIndex] == 2 * (size - 1) &&
+                 components == 1 + 2 && unreachable == 50,
+                 "Incorrect results in GraphAlgorithms")
+  }
+}
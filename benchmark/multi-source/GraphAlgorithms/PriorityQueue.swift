@@ -0,0 +1,68 @@
+//===--- PriorityQueue.swift ----------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+/// A binary min-heap ordered by a comparison closure.
+struct PriorityQueue<Element> {
+  private var heap: [Element] = []
+  private let areInIncreasingOrder: (Element, Element) -> Bool
+
+  init(by areInIncreasingOrder: @escaping (Element, Element) -> Bool) {
+    self.areInIncreasingOrder = areInIncreasingOrder
+  }
+
+  var isEmpty: Bool {
+    return heap.isEmpty
+  }
+
+  mutating func push(_ element: Element) {
+    heap.append(element)
+    var child = heap.count - 1
+    while child > 0 {
+      let parent = (child - 1) / 2
+      if !areInIncreasingOrder(heap[child], heap[parent]) {
+        break
+      }
+      swap(&heap[child], &heap[parent])
+      child = parent
+    }
+  }
+
+  mutating func pop() -> Element? {
+    if heap.isEmpty {
+      return nil
+    }
+    if heap.count == 1 {
+      return heap.removeLast()
+    }
+    let top = heap[0]
+    let last = heap.removeLast()
+    heap[0] = last
+    var parent = 0
+    while true {
+      let left = 2 * parent + 1
+      let right = left + 1
+      var smallest = parent
+      if left < heap.count && areInIncreasingOrder(heap[left], heap[smallest]) {
+        smallest = left
+      }
+      if right < heap.count &&
+         areInIncreasingOrder(heap[right], heap[smallest]) {
+        smallest = right
+      }
+      if smallest == parent {
+        return top
+      }
+      swap(&heap[parent], &heap[smallest])
+      parent = smallest
+    }
+  }
+}
@@ -0,0 +1,185 @@
+//===--- HTTPParser.swift -------------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+import TestsUtils
+
+enum HTTPParseError : Error {
+  case incomplete
+  case malformedRequestLine
+  case unsupportedMethod
+  case malformedHeader
+  case malformedBody
+}
+
+private let CR = UInt8(ascii: "\r")
+private let LF = UInt8(ascii: "\n")
+private let SP = UInt8(ascii: " ")
+private let HTAB = UInt8(ascii: "\t")
+private let colon = UInt8(ascii: ":")
+
+/// Parses a stream of pipelined HTTP/1.x requests.
+struct HTTPParser {
+  let bytes: [UInt8]
+  var position = 0
+
+  init(_ bytes: [UInt8]) {
+    self.bytes = bytes
+  }
+
+  var isAtEnd: Bool {
+    return position == bytes.count
+  }
+
+  /// Returns the next line without its CRLF.
+  private mutating func readLine() throws -> ArraySlice<UInt8> {
+    var end = position
+    while end + 1 < bytes.count {
+      if bytes[end] == CR && bytes[end + 1] == LF {
+        let line = bytes[position..<end]
+        position = end + 2
+        return line
+      }
+      end += 1
+    }
+    throw HTTPParseError.incomplete
+  }
+
+  private mutating func readBytes(_ count: Int) throws -> ArraySlice<UInt8> {
+    guard count <= bytes.count - position else {
+      throw HTTPParseError.incomplete
+    }
+    let result = bytes[position..<(position + count)]
+    position += count
+    return result
+  }
+
+  private func isWhitespace(_ byte: UInt8) -> Bool {
+    return byte == SP || byte == HTAB
+  }
+
+  /// Parses a non-negative integer in the given base.
+  private func parseInteger(_ digits: ArraySlice<UInt8>, base: Int) -> Int? {
+    if digits.isEmpty {
+      return nil
+    }
+    var value = 0
+    for byte in digits {
+      var digit: Int
+      switch byte {
+      case UInt8(ascii: "0")...UInt8(ascii: "9"):
+        digit = Int(byte - UInt8(ascii: "0"))
+      case UInt8(ascii: "a")...UInt8(ascii: "f"):
+        digit = Int(byte - UInt8(ascii: "a")) + 10
+      case UInt8(ascii: "A")...UInt8(ascii: "F"):
+        digit = Int(byte - UInt8(ascii: "A")) + 10
+      default:
+        return nil
+      }
+      if digit >= base {
+        return nil
+      }
+      value = value * base + digit
+    }
+    return value
+  }
+
+  private mutating func parseRequestLine() throws -> HTTPRequest {
+    let line = try readLine()
+    let parts = line.split(separator: SP, maxSplits: 2,
+                           omittingEmptySubsequences: false)
+    guard parts.count == 3 else {
+      throw HTTPParseError.malformedRequestLine
+    }
+    guard let method =
+        HTTPMethod(rawValue: makeString(fromUTF8: Array(parts[0]))) else {
+      throw HTTPParseError.unsupportedMethod
+    }
+    let version = parts[2]
+    guard version.count == 8 &&
+          version.starts(with: "HTTP/1.".utf8),
+          let minor = parseInteger(version.suffix(1), base: 10) else {
+      throw HTTPParseError.malformedRequestLine
+    }
+    return HTTPRequest(method: method,
+                       target: makeString(fromUTF8: Array(parts[1])),
+                       minorVersion: minor)
+  }
+
+  private mutating func parseHeaders(into request: inout HTTPRequest) throws {
+    while true {
+      let line = try readLine()
+      if line.isEmpty {
+        return
+      }
+      guard let colonIndex = line.index(of: colon),
+            colonIndex != line.startIndex else {
+        throw HTTPParseError.malformedHeader
+      }
+      var valueStart = colonIndex + 1
+      var valueEnd = line.endIndex
+      while valueStart < valueEnd && isWhitespace(line[valueStart]) {
+        valueStart += 1
+      }
+      while valueEnd > valueStart && isWhitespace(line[valueEnd - 1]) {
+        valueEnd -= 1
+      }
+      let name = line[line.startIndex..<colonIndex]
+      if isWhitespace(name[name.endIndex - 1]) {
+        throw HTTPParseError.malformedHeader
+      }
+      request.headers.append((
+        name: makeString(fromUTF8: Array(name)),
+        value: makeString(fromUTF8: Array(line[valueStart..<valueEnd]))))
+    }
+  }
+
+  private mutating func parseChunkedBody(into request: inout HTTPRequest)
+      throws {
+    while true {
+      var sizeLine = try readLine()
+      // Ignore chunk extensions.
+      if let extensionStart = sizeLine.index(of: UInt8(ascii: ";")) {
+        sizeLine = sizeLine[sizeLine.startIndex..<extensionStart]
+      }
+      guard let size = parseInteger(sizeLine, base: 16) else {
+        throw HTTPParseError.malformedBody
+      }
+      if size == 0 {
+        // Skip the trailer.
+        while !(try readLine().isEmpty) {}
+        return
+      }
+      request.body.append(contentsOf: try readBytes(size))
+      guard try readLine().isEmpty else {
+        throw HTTPParseError.malformedBody
+      }
+    }
+  }
+
+  mutating func parseRequest() throws -> HTTPRequest {
+    var request = try parseRequestLine()
+    try parseHeaders(into: &request)
+
+    if let encoding = request.header("transfer-encoding") {
+      guard encoding.lowercased() == "chunked" else {
+        throw HTTPParseError.malformedBody
+      }
+      try parseChunkedBody(into: &request)
+    } else if let length = request.header("content-length") {
+      guard let count = parseInteger(ArraySlice(length.utf8), base: 10) else {
+        throw HTTPParseError.malformedBody
+      }
+      request.body = Array(try readBytes(count))
+    }
+    return request
+  }
+}
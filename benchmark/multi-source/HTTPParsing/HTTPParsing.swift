@@ -0,0 +1,110 @@
+//===--- HTTPParsing.swift ------------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+// Parses a buffer of pipelined HTTP/1.1 requests, the way a server reads
+// them off a connection, and routes them by method and path.
+import TestsUtils
+
+private let userAgent =
+  "Mozilla/5.0 (Macintosh; Intel Mac OS X 10_12) AppleWebKit/602.1.50"
+
+/// Returns the requests as sent by clients, together with the total size of
+/// their bodies.
+private func makeRequests(_ count: Int) -> (bytes: [UInt8], bodySize: Int) {
+  var text = ""
+  var bodySize = 0
+  for i in 0..<count {
+    switch i % 4 {
+    case 0, 1:
+      text += "GET /api/v1/items/\(i)?fields=name,price&page=\(i % 7)"
+      text += " HTTP/1.1\r\n"
+      text += "Host: api.example.com\r\n"
+      text += "User-Agent: \(userAgent)\r\n"
+      text += "Accept: application/json, text/plain;q=0.9, */*;q=0.8\r\n"
+      text += "Accept-Encoding: gzip, deflate\r\n"
+      text += "Cookie: session=\(i * 7_919); theme=dark; tracking=off\r\n"
+      text += "\r\n"
+    case 2:
+      let body = "{\"name\":\"item \(i)\",\"price\":\(i * 3),\"tags\":[]}"
+      text += "POST /api/v1/items HTTP/1.1\r\n"
+      text += "Host: api.example.com\r\n"
+      text += "Content-Type: application/json\r\n"
+      text += "content-length: \(body.utf8.count)\r\n"
+      text += "X-Request-ID:  \(i)-abcdef  \r\n"
+      text += "\r\n"
+      text += body
+      bodySize += body.utf8.count
+    default:
+      text += "PUT /api/v1/items/\(i) HTTP/1.1\r\n"
+      text += "Host: api.example.com\r\n"
+      text += "Transfer-Encoding: chunked\r\n"
+      text += "Connection: close\r\n"
+      text += "\r\n"
+      for chunk in ["{\"name\":", "\"renamed \(i)\"", "}"] {
+        let size = String(chunk.utf8.count, radix: 16)
+        text += "\(size);ext=1\r\n\(chunk)\r\n"
+        bodySize += chunk.utf8.count
+      }
+      text += "0\r\n"
+      text += "Trailer-Checksum: 0\r\n"
+      text += "\r\n"
+    }
+  }
+  return (Array(text.utf8), bodySize)
+}
+
+struct RouteStats {
+  var reads = 0
+  var writes = 0
+  var closes = 0
+  var bodyBytes = 0
+}
+
+@inline(never)
+func route(_ bytes: [UInt8]) throws -> RouteStats {
+  var stats = RouteStats()
+  var parser = HTTPParser(bytes)
+  while !parser.isAtEnd {
+    let request = try parser.parseRequest()
+    guard request.path.characters.starts(with: "/api/v1/items".characters),
+          request.header("host") == "api.example.com" else {
+      throw HTTPParseError.malformedRequestLine
+    }
+    switch request.method {
+    case .get, .head:
+      stats.reads += 1
+    case .post, .put, .delete:
+      stats.writes += 1
+    }
+    if !request.keepAlive {
+      stats.closes += 1
+    }
+    stats.bodyBytes += request.body.count
+  }
+  return stats
+}
+
+@inline(never)
+public func run_HTTPParsing(_ N: Int) {
+  let count = 100
+  let requests = makeRequests(count)
+  for _ in 1...10*N {
+    guard let stats = try? route(requests.bytes) else {
+      CheckResults(false, "Incorrect results in HTTPParsing: parse failed")
+      return
+    }
+    CheckResults(stats.reads == count / 2 && stats.writes == count / 2 &&
+                 stats.closes == count / 4 &&
+                 stats.bodyBytes == requests.bodySize,
+                 "Incorrect results in HTTPParsing")
+  }
+}
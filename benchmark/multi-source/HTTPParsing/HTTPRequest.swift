@@ -0,0 +1,57 @@
+//===--- HTTPRequest.swift ------------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+enum HTTPMethod : String {
+  case get = "GET"
+  case head = "HEAD"
+  case post = "POST"
+  case put = "PUT"
+  case delete = "DELETE"
+}
+
+struct HTTPRequest {
+  var method: HTTPMethod
+  var target: String
+  var minorVersion: Int
+  var headers: [(name: String, value: String)] = []
+  var body: [UInt8] = []
+
+  init(method: HTTPMethod, target: String, minorVersion: Int) {
+    self.method = method
+    self.target = target
+    self.minorVersion = minorVersion
+  }
+
+  /// Returns the value of the first header called `name`, compared
+  /// case-insensitively; `name` must be lowercase.
+  func header(_ name: String) -> String? {
+    for header in headers where header.name.lowercased() == name {
+      return header.value
+    }
+    return nil
+  }
+
+  var keepAlive: Bool {
+    if let connection = header("connection") {
+      return connection.lowercased() != "close"
+    }
+    return minorVersion >= 1
+  }
+
+  /// The path of the target, without the query.
+  var path: String {
+    if let query = target.characters.index(of: "?") {
+      return String(target.characters[target.startIndex..<query])
+    }
+    return target
+  }
+}
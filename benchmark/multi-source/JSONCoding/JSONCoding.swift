@@ -0,0 +1,140 @@
+//===--- JSONCoding.swift -------------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+// Encodes a document of records, the way a service would render an API
+// response, parses it back and maps it to model values.
+import TestsUtils
+
+struct Customer {
+  var id: Int
+  var name: String
+  var email: String
+  var active: Bool
+  var balance: Int
+  var tags: [String]
+  var city: String
+  var note: String?
+}
+
+private let cities = ["Zürich", "São Paulo", "Kraków", "Cupertino", "東京"]
+
+private func makeCustomers(_ count: Int) -> [Customer] {
+  var customers: [Customer] = []
+  for i in 0..<count {
+    customers.append(Customer(
+      id: i,
+      name: "Customer \(i)",
+      email: "customer\(i)@example.com",
+      active: i % 3 != 0,
+      balance: (i * 7_919) % 100_000 - 50_000,
+      tags: (0..<(i % 4)).map { "tag\($0)" },
+      city: cities[i % cities.count],
+      note: i % 5 == 0 ? "Said \"hi\"\n\tand left\\" : nil))
+  }
+  return customers
+}
+
+private func encode(_ customer: Customer) -> JSONValue {
+  return .object([
+    (key: "id", value: .number(customer.id)),
+    (key: "name", value: .string(customer.name)),
+    (key: "email", value: .string(customer.email)),
+    (key: "active", value: .bool(customer.active)),
+    (key: "balance", value: .number(customer.balance)),
+    (key: "tags", value: .array(customer.tags.map { JSONValue.string($0) })),
+    (key: "address", value: .object([
+      (key: "city", value: .string(customer.city)),
+      (key: "country", value: .null),
+    ])),
+    (key: "note", value: customer.note.map { JSONValue.string($0) } ?? .null),
+  ])
+}
+
+private func decode(_ value: JSONValue) -> Customer? {
+  guard case .number(let id)? = value["id"],
+        case .string(let name)? = value["name"],
+        case .string(let email)? = value["email"],
+        case .bool(let active)? = value["active"],
+        case .number(let balance)? = value["balance"],
+        case .array(let tagValues)? = value["tags"],
+        case .string(let city)? = value["address"]?["city"],
+        let noteValue = value["note"] else {
+    return nil
+  }
+  var tags: [String] = []
+  for tagValue in tagValues {
+    guard case .string(let tag) = tagValue else {
+      return nil
+    }
+    tags.append(tag)
+  }
+  var note: String? = nil
+  if case .string(let s) = noteValue {
+    note = s
+  }
+  return Customer(id: id, name: name, email: email, active: active,
+                  balance: balance, tags: tags, city: city, note: note)
+}
+
+@inline(never)
+func encodeCustomers(_ customers: [Customer]) -> [UInt8] {
+  var writer = JSONWriter()
+  writer.write(.object([
+    (key: "customers", value: .array(customers.map(encode))),
+    (key: "count", value: .number(customers.count)),
+  ]))
+  return writer.bytes
+}
+
+@inline(never)
+func decodeCustomers(_ bytes: [UInt8]) -> [Customer]? {
+  var parser = JSONParser(bytes)
+  guard let document = try? parser.parse(),
+        case .array(let values)? = document["customers"] else {
+    return nil
+  }
+  var customers: [Customer] = []
+  for value in values {
+    guard let customer = decode(value) else {
+      return nil
+    }
+    customers.append(customer)
+  }
+  return customers
+}
+
+@inline(never)
+public func run_JSONCoding(_ N: Int) {
+  let customers = makeCustomers(200)
+  var balance = 0
+  for _ in 1...10*N {
+    let encoded = encodeCustomers(customers)
+    guard let decoded = decodeCustomers(encoded) else {
+      CheckResults(false, "Incorrect results in JSONCoding: parse failed")
+      return
+    }
+    CheckResults(decoded.count == customers.count,
+                 "Incorrect results in JSONCoding: wrong number of records")
+    balance += decoded.reduce(0) { $0 + $1.balance }
+  }
+  let expected = customers.reduce(0) { $0 + $1.balance } * 10 * N
+  CheckResults(balance == expected,
+               "Incorrect results in JSONCoding: \(balance) != \(expected)")
+
+  // Round-tripping must not lose anything.
+  let decoded = decodeCustomers(encodeCustomers(customers))!
+  for (l, r) in zip(customers, decoded) {
+    CheckResults(l.name == r.name && l.tags == r.tags && l.city == r.city &&
+                 l.note == r.note && l.active == r.active,
+                 "Incorrect results in JSONCoding: \(l.id) changed")
+  }
+}
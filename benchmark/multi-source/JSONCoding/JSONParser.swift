@@ -0,0 +1,242 @@
+//===--- JSONParser.swift -------------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+import TestsUtils
+
+enum JSONError : Error {
+  case unexpectedEnd
+  case unexpectedByte(UInt8, at: Int)
+  case unsupportedEscape(at: Int)
+}
+
+/// A recursive descent parser working directly on UTF-8 bytes.
+struct JSONParser {
+  let bytes: [UInt8]
+  var position = 0
+
+  init(_ bytes: [UInt8]) {
+    self.bytes = bytes
+  }
+
+  mutating func parse() throws -> JSONValue {
+    let value = try parseValue()
+    skipWhitespace()
+    if position != bytes.count {
+      throw JSONError.unexpectedByte(bytes[position], at: position)
+    }
+    return value
+  }
+
+  private mutating func skipWhitespace() {
+    while position < bytes.count {
+      switch bytes[position] {
+      case 0x20, 0x09, 0x0A, 0x0D:
+        position += 1
+      default:
+        return
+      }
+    }
+  }
+
+  private func peek() throws -> UInt8 {
+    guard position < bytes.count else {
+      throw JSONError.unexpectedEnd
+    }
+    return bytes[position]
+  }
+
+  private mutating func next() throws -> UInt8 {
+    let byte = try peek()
+    position += 1
+    return byte
+  }
+
+  private mutating func expect(_ byte: UInt8) throws {
+    let actual = try next()
+    if actual != byte {
+      throw JSONError.unexpectedByte(actual, at: position - 1)
+    }
+  }
+
+  private mutating func parseValue() throws -> JSONValue {
+    skipWhitespace()
+    switch try peek() {
+    case UInt8(ascii: "n"):
+      try parseLiteral("null")
+      return .null
+    case UInt8(ascii: "t"):
+      try parseLiteral("true")
+      return .bool(true)
+    case UInt8(ascii: "f"):
+      try parseLiteral("false")
+      return .bool(false)
+    case UInt8(ascii: "\""):
+      return .string(try parseString())
+    case UInt8(ascii: "["):
+      return try parseArray()
+    case UInt8(ascii: "{"):
+      return try parseObject()
+    default:
+      return .number(try parseNumber())
+    }
+  }
+
+  private mutating func parseLiteral(_ literal: String) throws {
+    for byte in literal.utf8 {
+      try expect(byte)
+    }
+  }
+
+  private mutating func parseNumber() throws -> Int {
+    var negative = false
+    if try peek() == UInt8(ascii: "-") {
+      negative = true
+      position += 1
+    }
+    let start = position
+    var value = 0
+    while position < bytes.count {
+      let digit = bytes[position] &- UInt8(ascii: "0")
+      if digit > 9 {
+        break
+      }
+      value = value &* 10 &+ Int(digit)
+      position += 1
+    }
+    if position == start {
+      throw JSONError.unexpectedByte(try peek(), at: position)
+    }
+    return negative ? -value : value
+  }
+
+  private mutating func parseHexDigit() throws -> Int {
+    let byte = try next()
+    switch byte {
+    case UInt8(ascii: "0")...UInt8(ascii: "9"):
+      return Int(byte - UInt8(ascii: "0"))
+    case UInt8(ascii: "a")...UInt8(ascii: "f"):
+      return Int(byte - UInt8(ascii: "a")) + 10
+    case UInt8(ascii: "A")...UInt8(ascii: "F"):
+      return Int(byte - UInt8(ascii: "A")) + 10
+    default:
+      throw JSONError.unexpectedByte(byte, at: position - 1)
+    }
+  }
+
+  /// Appends the UTF-8 encoding of a \u escape to `utf8`. Surrogate pairs
+  /// and NUL are not supported.
+  private mutating func parseUnicodeEscape(into utf8: inout [UInt8]) throws {
+    let start = position
+    var code = 0
+    for _ in 0..<4 {
+      let digit = try parseHexDigit()
+      code = code << 4 | digit
+    }
+    switch code {
+    case 0:
+      throw JSONError.unsupportedEscape(at: start)
+    case 1..<0x80:
+      utf8.append(UInt8(code))
+    case 0x80..<0x800:
+      utf8.append(UInt8(0xC0 | code >> 6))
+      utf8.append(UInt8(0x80 | code & 0x3F))
+    case 0xD800..<0xE000:
+      throw JSONError.unsupportedEscape(at: start)
+    default:
+      utf8.append(UInt8(0xE0 | code >> 12))
+      utf8.append(UInt8(0x80 | code >> 6 & 0x3F))
+      utf8.append(UInt8(0x80 | code & 0x3F))
+    }
+  }
+
+  private mutating func parseString() throws -> String {
+    try expect(UInt8(ascii: "\""))
+    var utf8: [UInt8] = []
+    while true {
+      let byte = try next()
+      switch byte {
+      case UInt8(ascii: "\""):
+        return makeString(fromUTF8: utf8)
+      case UInt8(ascii: "\\"):
+        let escaped = try next()
+        switch escaped {
+        case UInt8(ascii: "\""), UInt8(ascii: "\\"), UInt8(ascii: "/"):
+          utf8.append(escaped)
+        case UInt8(ascii: "n"):
+          utf8.append(0x0A)
+        case UInt8(ascii: "t"):
+          utf8.append(0x09)
+        case UInt8(ascii: "r"):
+          utf8.append(0x0D)
+        case UInt8(ascii: "b"):
+          utf8.append(0x08)
+        case UInt8(ascii: "f"):
+          utf8.append(0x0C)
+        case UInt8(ascii: "u"):
+          try parseUnicodeEscape(into: &utf8)
+        default:
+          throw JSONError.unexpectedByte(escaped, at: position - 1)
+        }
+      case 0..<0x20:
+        throw JSONError.unexpectedByte(byte, at: position - 1)
+      default:
+        utf8.append(byte)
+      }
+    }
+  }
+
+  private mutating func parseArray() throws -> JSONValue {
+    try expect(UInt8(ascii: "["))
+    var elements: [JSONValue] = []
+    skipWhitespace()
+    if try peek() == UInt8(ascii: "]") {
+      position += 1
+      return .array(elements)
+    }
+    while true {
+      elements.append(try parseValue())
+      skipWhitespace()
+      let byte = try next()
+      if byte == UInt8(ascii: "]") {
+        return .array(elements)
+      }
+      if byte != UInt8(ascii: ",") {
+        throw JSONError.unexpectedByte(byte, at: position - 1)
+      }
+    }
+  }
+
+  private mutating func parseObject() throws -> JSONValue {
+    try expect(UInt8(ascii: "{"))
+    var members: [(key: String, value: JSONValue)] = []
+    skipWhitespace()
+    if try peek() == UInt8(ascii: "}") {
+      position += 1
+      return .object(members)
+    }
+    while true {
+      skipWhitespace()
+      let key = try parseString()
+      skipWhitespace()
+      try expect(UInt8(ascii: ":"))
+      members.append((key: key, value: try parseValue()))
+      skipWhitespace()
+      let byte = try next()
+      if byte == UInt8(ascii: "}") {
+        return .object(members)
+      }
+      if byte != UInt8(ascii: ",") {
+        throw JSONError.unexpectedByte(byte, at: position - 1)
+      }
+    }
+  }
+}
@@ -0,0 +1,63 @@
+//===--- JSONValue.swift --------------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+/// A JSON document. Numbers are restricted to integers, and object members
+/// keep the order in which they appear in the document.
+enum JSONValue {
+  case null
+  case bool(Bool)
+  case number(Int)
+  case string(String)
+  case array([JSONValue])
+  case object([(key: String, value: JSONValue)])
+}
+
+extension JSONValue : Equatable {
+  static func == (lhs: JSONValue, rhs: JSONValue) -> Bool {
+    switch (lhs, rhs) {
+    case (.null, .null):
+      return true
+    case let (.bool(l), .bool(r)):
+      return l == r
+    case let (.number(l), .number(r)):
+      return l == r
+    case let (.string(l), .string(r)):
+      return l == r
+    case let (.array(l), .array(r)):
+      return l == r
+    case let (.object(l), .object(r)):
+      if l.count != r.count {
+        return false
+      }
+      for i in l.indices {
+        if l[i].key != r[i].key || l[i].value != r[i].value {
+          return false
+        }
+      }
+      return true
+    default:
+      return false
+    }
+  }
+}
+
+extension JSONValue {
+  subscript(key: String) -> JSONValue? {
+    guard case .object(let members) = self else {
+      return nil
+    }
+    for member in members where member.key == key {
+      return member.value
+    }
+    return nil
+  }
+}
@@ -0,0 +1,77 @@
+//===--- JSONWriter.swift -------------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+private let hexDigits = Array("0123456789abcdef".utf8)
+
+/// Encodes JSON values as compact UTF-8 text.
+struct JSONWriter {
+  var bytes: [UInt8] = []
+
+  mutating func write(_ value: JSONValue) {
+    switch value {
+    case .null:
+      append("null")
+    case .bool(let b):
+      append(b ? "true" : "false")
+    case .number(let n):
+      append(String(n))
+    case .string(let s):
+      writeString(s)
+    case .array(let elements):
+      bytes.append(UInt8(ascii: "["))
+      for (i, element) in elements.enumerated() {
+        if i > 0 {
+          bytes.append(UInt8(ascii: ","))
+        }
+        write(element)
+      }
+      bytes.append(UInt8(ascii: "]"))
+    case .object(let members):
+      bytes.append(UInt8(ascii: "{"))
+      for (i, member) in members.enumerated() {
+        if i > 0 {
+          bytes.append(UInt8(ascii: ","))
+        }
+        writeString(member.key)
+        bytes.append(UInt8(ascii: ":"))
+        write(member.value)
+      }
+      bytes.append(UInt8(ascii: "}"))
+    }
+  }
+
+  private mutating func append(_ s: String) {
+    bytes.append(contentsOf: s.utf8)
+  }
+
+  private mutating func writeString(_ s: String) {
+    bytes.append(UInt8(ascii: "\""))
+    for c in s.utf8 {
+      switch c {
+      case UInt8(ascii: "\""), UInt8(ascii: "\\"):
+        bytes.append(UInt8(ascii: "\\"))
+        bytes.append(c)
+      case UInt8(ascii: "\n"):
+        append("\\n")
+      case UInt8(ascii: "\t"):
+        append("\\t")
+      case 0..<0x20:
+        append("\\u00")
+        bytes.append(hexDigits[Int(c >> 4)])
+        bytes.append(hexDigits[Int(c & 0xF)])
+      default:
+        bytes.append(c)
+      }
+    }
+    bytes.append(UInt8(ascii: "\""))
+  }
+}
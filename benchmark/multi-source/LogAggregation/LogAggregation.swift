@@ -0,0 +1,103 @@
+//===--- LogAggregation.swift ---------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+// Splits an access log into lines and fields, groups the requests by
+// endpoint and summarizes the busiest ones, like a log processing job.
+import TestsUtils
+
+private let endpoints: [(method: String, components: [String])] = [
+  ("GET", ["v1", "users", ":id"]),
+  ("GET", ["v1", "users", ":id", "orders"]),
+  ("POST", ["v1", "orders"]),
+  ("GET", ["v1", "products", ":id"]),
+  ("DELETE", ["v1", "sessions", ":id"]),
+  ("GET", ["health"]),
+]
+
+private let statuses = [200, 200, 200, 201, 204, 304, 404, 500, 503]
+
+private struct ExpectedTotals {
+  var lines = 0
+  var skipped = 0
+  var serverErrors = 0
+  var errorLines = 0
+  var keys = Set<String>()
+}
+
+private func makeLog(_ count: Int) -> (String, ExpectedTotals) {
+  var expected = ExpectedTotals()
+  var log = ""
+  var seed = 42
+  for i in 0..<count {
+    seed = (seed &* 1_103_515_245 &+ 12_345) & 0x7FFF_FFFF
+    expected.lines += 1
+    if i % 50 == 49 {
+      log += "2016-11-03T14:59:59.999Z WARN log truncated\n"
+      expected.skipped += 1
+      continue
+    }
+    let endpoint = endpoints[seed % endpoints.count]
+    let path = endpoint.components.map {
+      $0 == ":id" ? String(seed % 10_000) : $0
+    }.joined(separator: "/")
+    let status = statuses[(seed >> 8) % statuses.count]
+    let level = status >= 500 ? "ERROR" : (status >= 400 ? "WARN" : "INFO")
+    let hour = 10 + i * 8 / count
+    let minute = seed % 60
+    let latency = (seed >> 4) % 250
+    let size = (seed >> 12) % 20_000
+    log += "2016-11-03T\(hour):\(minute / 10)\(minute % 10):00.000Z \(level) "
+    log += "web-\(seed % 7) \(endpoint.method) /\(path) \(status) "
+    log += "\(latency)ms \(size)\n"
+
+    expected.keys.insert(
+      endpoint.method + " /" + endpoint.components.joined(separator: "/"))
+    if status >= 500 {
+      expected.serverErrors += 1
+      expected.errorLines += 1
+    }
+  }
+  return (log, expected)
+}
+
+@inline(never)
+func aggregate(_ log: String) -> LogAggregator {
+  var aggregator = LogAggregator()
+  aggregator.add(log)
+  return aggregator
+}
+
+@inline(never)
+public func run_LogAggregation(_ N: Int) {
+  let (log, expected) = makeLog(500)
+  for _ in 1...N {
+    let aggregator = aggregate(log)
+    let report = aggregator.report(top: 5)
+
+    var requests = 0
+    var serverErrors = 0
+    for stats in aggregator.endpoints.values {
+      requests += stats.requests
+      serverErrors += stats.serverErrors
+    }
+    let errorLines = aggregator.errorsPerHour.values.reduce(0, +)
+    CheckResults(
+      requests + aggregator.skippedLines == expected.lines &&
+      aggregator.skippedLines == expected.skipped &&
+      serverErrors == expected.serverErrors &&
+      errorLines == expected.errorLines &&
+      Set(aggregator.endpoints.keys) == expected.keys &&
+      aggregator.hosts.count <= 7 &&
+      report.count == min(5, expected.keys.count),
+      "Incorrect results in LogAggregation")
+  }
+}
@@ -0,0 +1,83 @@
+//===--- LogAggregator.swift ----------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+struct EndpointStats {
+  var requests = 0
+  var serverErrors = 0
+  var bytes = 0
+  var latencies: [Int] = []
+
+  var averageLatency: Int {
+    return latencies.reduce(0, +) / max(latencies.count, 1)
+  }
+
+  /// The 95th percentile of the latencies.
+  var tailLatency: Int {
+    if latencies.isEmpty {
+      return 0
+    }
+    let sorted = latencies.sorted()
+    return sorted[(sorted.count - 1) * 95 / 100]
+  }
+}
+
+struct LogAggregator {
+  var endpoints: [String: EndpointStats] = [:]
+  var errorsPerHour: [String: Int] = [:]
+  var hosts = Set<String>()
+  var skippedLines = 0
+
+  mutating func add(_ text: String) {
+    for line in text.characters.split(separator: "\n") {
+      guard let record = LogRecord(line) else {
+        skippedLines += 1
+        continue
+      }
+      add(record)
+    }
+  }
+
+  mutating func add(_ record: LogRecord) {
+    hosts.insert(record.host)
+    let key = record.endpoint
+    // Take the entry out of the dictionary while updating it, so that
+    // appending to its latencies does not copy them.
+    var stats = endpoints[key] ?? EndpointStats()
+    endpoints[key] = nil
+    stats.requests += 1
+    stats.bytes += record.size
+    stats.latencies.append(record.latency)
+    if record.status >= 500 {
+      stats.serverErrors += 1
+    }
+    endpoints[key] = stats
+    if record.level == .error {
+      errorsPerHour[record.hour] = (errorsPerHour[record.hour] ?? 0) + 1
+    }
+  }
+
+  /// Returns a line for each of the `count` busiest endpoints.
+  func report(top count: Int) -> [String] {
+    let busiest = endpoints.sorted {
+      $0.value.requests > $1.value.requests ||
+        ($0.value.requests == $1.value.requests && $0.key < $1.key)
+    }
+    var lines: [String] = []
+    for (endpoint, stats) in busiest.prefix(count) {
+      lines.append("\(endpoint): \(stats.requests) requests, " +
+                   "\(stats.serverErrors) errors, " +
+                   "avg \(stats.averageLatency)ms, " +
+                   "p95 \(stats.tailLatency)ms, \(stats.bytes / 1024)KB")
+    }
+    return lines
+  }
+}
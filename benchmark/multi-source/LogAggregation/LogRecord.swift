@@ -0,0 +1,70 @@
+//===--- LogRecord.swift --------------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+enum LogLevel : String {
+  case debug = "DEBUG"
+  case info = "INFO"
+  case warning = "WARN"
+  case error = "ERROR"
+}
+
+/// One line of an access log, such as
+///
+///     2016-11-03T14:02:17.123Z INFO web-3 GET /v1/users/12 200 17ms 5120
+struct LogRecord {
+  var timestamp: String
+  var level: LogLevel
+  var host: String
+  var method: String
+  var path: String
+  var status: Int
+  var latency: Int
+  var size: Int
+
+  init?(_ line: String.CharacterView) {
+    let fields = line.split(separator: " ").map { String($0) }
+    guard fields.count == 8,
+          let level = LogLevel(rawValue: fields[1]),
+          let status = Int(fields[5]),
+          String(fields[6].characters.suffix(2)) == "ms",
+          let latency = Int(String(fields[6].characters.dropLast(2))),
+          let size = Int(fields[7]) else {
+      return nil
+    }
+    self.timestamp = fields[0]
+    self.level = level
+    self.host = fields[2]
+    self.method = fields[3]
+    self.path = fields[4]
+    self.status = status
+    self.latency = latency
+    self.size = size
+  }
+
+  /// The hour of the timestamp, e.g. "2016-11-03T14".
+  var hour: String {
+    return String(timestamp.characters.prefix(13))
+  }
+
+  /// The path with the numeric components replaced by ":id", so that
+  /// requests for different resources of one endpoint are counted together.
+  var endpoint: String {
+    let components = path.characters.split(separator: "/").map {
+      (component: String.CharacterView) -> String in
+      for c in component where c < "0" || c > "9" {
+        return String(component)
+      }
+      return ":id"
+    }
+    return method + " /" + components.joined(separator: "/")
+  }
+}
@@ -0,0 +1,134 @@
+//===--- Entities.swift ---------------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+struct User : Entity {
+  static var kind: String { return "user" }
+
+  var id: Int
+  var name: String
+  var email: String
+  var age: Int
+
+  func validate() -> [String] {
+    var problems: [String] = []
+    if name.isEmpty {
+      problems.append("user \(id) has no name")
+    }
+    if !email.characters.contains("@") {
+      problems.append("user \(id) has an invalid email address")
+    }
+    if age < 13 {
+      problems.append("user \(id) is too young")
+    }
+    return problems
+  }
+
+  func write(to record: inout [String: String]) {
+    record["name"] = name
+    record["email"] = email
+    record["age"] = String(age)
+  }
+}
+
+struct Product : Entity {
+  static var kind: String { return "product" }
+
+  var id: Int
+  var title: String
+  var price: Int
+  var stock: Int
+
+  func validate() -> [String] {
+    if price <= 0 {
+      return ["product \(id) has no price"]
+    }
+    return []
+  }
+
+  func write(to record: inout [String: String]) {
+    record["title"] = title
+    record["price"] = String(price)
+    record["stock"] = String(stock)
+  }
+}
+
+enum OrderStatus : String {
+  case pending, paid, shipped, cancelled
+}
+
+struct OrderLine {
+  var product: Int
+  var quantity: Int
+}
+
+final class Order : Entity, Billable {
+  static var kind: String { return "order" }
+
+  let id: Int
+  let customer: Int
+  var status: OrderStatus
+  var lines: [OrderLine]
+
+  init(id: Int, customer: Int, status: OrderStatus, lines: [OrderLine]) {
+    self.id = id
+    self.customer = customer
+    self.status = status
+    self.lines = lines
+  }
+
+  func validate() -> [String] {
+    if lines.isEmpty {
+      return ["order \(id) is empty"]
+    }
+    return []
+  }
+
+  func write(to record: inout [String: String]) {
+    record["customer"] = String(customer)
+    record["status"] = status.rawValue
+    record["lines"] = String(lines.count)
+  }
+
+  func amount(prices: [Int: Int]) -> Int {
+    if status == .cancelled {
+      return 0
+    }
+    var total = 0
+    for line in lines {
+      total += (prices[line.product] ?? 0) * line.quantity
+    }
+    return total
+  }
+}
+
+struct Refund : Entity, Billable {
+  static var kind: String { return "refund" }
+
+  var id: Int
+  var order: Int
+  var value: Int
+  var reason: String
+
+  func validate() -> [String] {
+    return value < 0 ? ["refund \(id) is negative"] : []
+  }
+
+  func write(to record: inout [String: String]) {
+    record["order"] = String(order)
+    record["value"] = String(value)
+    record["reason"] = reason
+  }
+
+  func amount(prices: [Int: Int]) -> Int {
+    return -value
+  }
+}
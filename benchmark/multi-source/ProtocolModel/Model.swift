@@ -0,0 +1,41 @@
+//===--- Model.swift ------------------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+protocol Identifiable {
+  var id: Int { get }
+}
+
+protocol Validatable {
+  /// Returns a description of each problem with the value.
+  func validate() -> [String]
+}
+
+protocol RecordConvertible {
+  func write(to record: inout [String: String])
+}
+
+protocol Entity : Identifiable, Validatable, RecordConvertible {
+  static var kind: String { get }
+}
+
+extension Entity {
+  func record() -> [String: String] {
+    var record = ["kind": Self.kind, "id": String(id)]
+    write(to: &record)
+    return record
+  }
+}
+
+/// Something that contributes to the revenue of the store.
+protocol Billable {
+  func amount(prices: [Int: Int]) -> Int
+}
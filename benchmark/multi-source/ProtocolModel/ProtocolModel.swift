@@ -0,0 +1,99 @@
+//===--- ProtocolModel.swift ----------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+// A model layer built from protocols: heterogeneous entities are stored as
+// existentials, and validation, export and reporting go through protocol
+// requirements and dynamic casts.
+import TestsUtils
+
+private struct Expected {
+  var problems = 0
+  var revenue = 0
+  var users = 0
+}
+
+private func makeStore() -> (Store, Expected) {
+  let store = Store()
+  var expected = Expected()
+
+  var prices: [Int] = []
+  for i in 0..<50 {
+    let price = 100 + (i * 37) % 900
+    prices.append(price)
+    store.add(Product(id: i, title: "Product \(i)", price: price,
+                      stock: i % 13))
+  }
+  for i in 0..<100 {
+    let email = i % 10 == 0 ? "user\(i).example.com" : "user\(i)@example.com"
+    let age = i % 17 == 0 ? 12 : 20 + i % 50
+    store.add(User(id: i, name: "User \(i)", email: email, age: age))
+    expected.users += 1
+    if i % 10 == 0 {
+      expected.problems += 1
+    }
+    if i % 17 == 0 {
+      expected.problems += 1
+    }
+  }
+  let statuses: [OrderStatus] = [.pending, .paid, .shipped, .cancelled]
+  for i in 0..<300 {
+    var lines: [OrderLine] = []
+    if i % 50 != 0 {
+      for j in 0..<(1 + i % 4) {
+        lines.append(OrderLine(product: (i + j * 7) % 50, quantity: 1 + j))
+      }
+    } else {
+      expected.problems += 1
+    }
+    let status = statuses[i % statuses.count]
+    store.add(Order(id: i, customer: i % 100, status: status, lines: lines))
+    if status != .cancelled {
+      for line in lines {
+        expected.revenue += prices[line.product] * line.quantity
+      }
+    }
+    if i % 15 == 0 {
+      let refund = Refund(id: i / 15, order: i, value: 50, reason: "damaged")
+      store.add(refund)
+      expected.revenue -= refund.value
+    }
+  }
+  return (store, expected)
+}
+
+@inline(never)
+func summarize(_ store: Store) -> (problems: Int, revenue: Int, users: Int,
+                                    fields: Int) {
+  let problems = store.problems().count
+  let revenue = store.revenue()
+  let users = store.all(User.self).count
+  var fields = 0
+  for record in store.export() {
+    fields += record.count
+  }
+  return (problems, revenue, users, fields)
+}
+
+@inline(never)
+public func run_ProtocolModel(_ N: Int) {
+  let (store, expected) = makeStore()
+  // Every record has a kind and an id, and three more fields per entity.
+  let expectedFields = store.entities.count * 5
+  for _ in 1...10*N {
+    let summary = summarize(store)
+    CheckResults(summary.problems == expected.problems &&
+                 summary.revenue == expected.revenue &&
+                 summary.users == expected.users &&
+                 summary.fields == expectedFields,
+                 "Incorrect results in ProtocolModel")
+  }
+}
@@ -0,0 +1,57 @@
+//===--- Store.swift ------------------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+/// Keeps entities of all kinds, the way a model layer would, and answers
+/// queries over them through their protocols.
+final class Store {
+  private(set) var entities: [Entity] = []
+
+  func add(_ entity: Entity) {
+    entities.append(entity)
+  }
+
+  func all<T : Entity>(_ type: T.Type) -> [T] {
+    var result: [T] = []
+    for entity in entities {
+      if let e = entity as? T {
+        result.append(e)
+      }
+    }
+    return result
+  }
+
+  func problems() -> [String] {
+    var problems: [String] = []
+    for entity in entities {
+      problems.append(contentsOf: entity.validate())
+    }
+    return problems
+  }
+
+  func export() -> [[String: String]] {
+    return entities.map { $0.record() }
+  }
+
+  func revenue() -> Int {
+    var prices: [Int: Int] = [:]
+    for product in all(Product.self) {
+      prices[product.id] = product.price
+    }
+    var total = 0
+    for entity in entities {
+      if let billable = entity as? Billable {
+        total += billable.amount(prices: prices)
+      }
+    }
+    return total
+  }
+}
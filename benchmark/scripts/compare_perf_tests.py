@@ -15,6 +15,8 @@
 
 import argparse
 import csv
+import math
+import re
 import sys
 
 TESTNAME = 1
@@ -24,6 +26,16 @@ MAX = 4
 MEAN = 5
 SD = 6
 MEDIAN = 7
+MEMORY = 11
+
+# The columns from MEMORY on, written by Benchmark_O --memory-metrics.
+MEMORY_METRICS = ['ALLOCS', 'ALLOC_BYTES', 'RETAINS', 'RELEASES', 'MAX_RSS(B)']
+
+# The columns written by Benchmark_O --hardware-counters. They are found by
+# their names in the header row, as they follow the memory metrics if both
+# were requested.
+HARDWARE_COUNTERS = ['INSTRUCTIONS', 'CYCLES', 'BRANCH_MISSES', 'L1D_MISSES',
+                     'LLC_MISSES']
 
 HTML = """
 <!DOCTYPE html>
@@ -74,6 +86,190 @@ PAIN_DETAIL = """
 RATIO_MIN = None
 RATIO_MAX = None
 
+# Tests whose change the Mann-Whitney U test does not find significant.
+INSIGNIFICANT = set()
+
+RUNNING_RE = re.compile(r"Running (\w+) for ")
+SAMPLE_RE = re.compile(r"\s+(Sample|Outlier) (\d+),(\d+)")
+
+
+def read_samples(file_name):
+    """
+    Return the samples of each test in a log of Benchmark_O --verbose, without
+    the samples it rejected as outliers.
+    """
+    samples = {}
+    test = None
+    for line in open(file_name):
+        m = RUNNING_RE.match(line)
+        if m:
+            test = m.group(1)
+            samples[test] = {}
+            continue
+        m = SAMPLE_RE.match(line)
+        if m and test:
+            if m.group(1) == 'Sample':
+                samples[test][int(m.group(2))] = int(m.group(3))
+            else:
+                samples[test].pop(int(m.group(2)), None)
+    return dict((test, values.values()) for test, values in samples.items()
+                if values)
+
+
+def mann_whitney_p_value(a, b):
+    """
+    Return the two-sided p-value of the Mann-Whitney U test of the samples a
+    and b, using the normal approximation with a correction for ties. Return
+    None if there are too few samples for the approximation.
+    """
+    n1 = len(a)
+    n2 = len(b)
+    if n1 < 5 or n2 < 5:
+        return None
+
+    # Rank all samples, giving tied samples the average of their ranks.
+    values = sorted([(v, 0) for v in a] + [(v, 1) for v in b])
+    rank_sum = 0.0
+    tie_term = 0.0
+    i = 0
+    while i < len(values):
+        j = i
+        while j < len(values) and values[j][0] == values[i][0]:
+            j += 1
+        rank = (i + j + 1) / 2.0
+        rank_sum += rank * sum(1 for v in values[i:j] if v[1] == 0)
+        tie_term += (j - i) ** 3 - (j - i)
+        i = j
+
+    n = n1 + n2
+    u = rank_sum - n1 * (n1 + 1) / 2.0
+    mean = n1 * n2 / 2.0
+    variance = n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1)))
+    if variance <= 0:
+        return 1.0
+    z = (abs(u - mean) - 0.5) / math.sqrt(variance)
+    return max(0.0, min(1.0, math.erfc(max(z, 0.0) / math.sqrt(2))))
+
+
+def read_metrics(row, header, metrics, default_column, results):
+    """
+    Record the values of the metrics columns of a result row, if it has them.
+    The columns are looked up in the header row of the file if there is one,
+    and start at default_column otherwise.
+    """
+    if header:
+        if metrics[0] not in header:
+            return
+        column = header.index(metrics[0])
+    elif default_column is None:
+        return
+    else:
+        column = default_column
+    values = row[column:column + len(metrics)]
+    if len(values) == len(metrics) and all(v.isdigit() for v in values):
+        results[row[TESTNAME]] = [int(v) for v in values]
+
+
+def metric_changes(old_values, new_values, metrics):
+    """
+    Return the (test, metric, old, new, delta) of each metric which changed
+    by more than the delta threshold, largest increases first.
+    """
+    changes = []
+    for key in new_values.keys():
+        if key not in old_values:
+            continue
+        for i, metric in enumerate(metrics):
+            old = old_values[key][i]
+            new = new_values[key][i]
+            ratio = (new + 0.001) / (old + 0.001)
+            if ratio > RATIO_MAX or ratio < RATIO_MIN:
+                changes.append((key, metric, old, new,
+                                round((ratio - 1) * 100, 2)))
+    return sorted(changes, key=lambda x: x[4], reverse=True)
+
+
+def hardware_counter_changes(old_counters, new_counters):
+    """
+    Return the changes of the hardware counters, as metric_changes does,
+    together with the changes of the instructions per cycle.
+    """
+    changes = metric_changes(old_counters, new_counters, HARDWARE_COUNTERS)
+    instructions = HARDWARE_COUNTERS.index('INSTRUCTIONS')
+    cycles = HARDWARE_COUNTERS.index('CYCLES')
+    for key in new_counters.keys():
+        if key not in old_counters:
+            continue
+        if not old_counters[key][cycles] or not new_counters[key][cycles]:
+            continue
+        old = old_counters[key][instructions] / \
+            float(old_counters[key][cycles])
+        new = new_counters[key][instructions] / \
+            float(new_counters[key][cycles])
+        ratio = (new + 0.001) / (old + 0.001)
+        if ratio > RATIO_MAX or ratio < RATIO_MIN:
+            changes.append((key, 'IPC', "{0:.2f}".format(old),
+                            "{0:.2f}".format(new),
+                            round((ratio - 1) * 100, 2)))
+    return sorted(changes, key=lambda x: x[4], reverse=True)
+
+
+def metric_table(changes):
+    """
+    Return a markdown table of the (test, metric, old, new, delta) changes.
+    """
+    if not changes:
+        return ""
+    test_width = max(len('TEST'), *[len(c[0]) for c in changes])
+    metric_width = max(len('METRIC'), *[len(c[1]) for c in changes])
+    old_width = max(len('OLD'), *[len(str(c[2])) for c in changes])
+    new_width = max(len('NEW'), *[len(str(c[3])) for c in changes])
+    table = "\n" + MARKDOWN_ROW.format(
+        "TEST".ljust(test_width), "METRIC".ljust(metric_width),
+        "OLD".ljust(old_width), "NEW".ljust(new_width), "DELTA (%)")
+    table += MARKDOWN_ROW.format(
+        HEADER_SPLIT.ljust(test_width), HEADER_SPLIT.ljust(metric_width),
+        HEADER_SPLIT.ljust(old_width), HEADER_SPLIT.ljust(new_width),
+        HEADER_SPLIT)
+    for (key, metric, old, new, delta) in changes:
+        table += MARKDOWN_ROW.format(
+            key.ljust(test_width), metric.ljust(metric_width),
+            str(old).ljust(old_width), str(new).ljust(new_width),
+            "{0:+.1f}%".format(delta))
+    return table
+
+
+def read_code_sizes(file_name):
+    """
+    Return the module sizes of a Benchmark_CodeSize report, without the sizes
+    of individual functions.
+    """
+    sizes = {}
+    for row in csv.reader(open(file_name)):
+        if (len(row) > 7 and row[MIN].isdigit() and
+                '.' not in row[TESTNAME]):
+            sizes[row[TESTNAME]] = int(row[MIN])
+    return sizes
+
+
+def code_size_changes(old_sizes, new_sizes, delta_list):
+    """
+    Return the (module, old, new, delta, time delta) of each module whose code
+    size changed by more than the delta threshold, largest increases first.
+    The time delta is the one of the benchmark with the same name, if any.
+    """
+    changes = []
+    for key in new_sizes.keys():
+        if key not in old_sizes:
+            continue
+        old = old_sizes[key]
+        new = new_sizes[key]
+        ratio = (new + 0.001) / (old + 0.001)
+        if ratio > RATIO_MAX or ratio < RATIO_MIN:
+            changes.append((key, old, new, round((ratio - 1) * 100, 2),
+                            delta_list.get(key)))
+    return sorted(changes, key=lambda x: x[3], reverse=True)
+
 
 def main():
     global RATIO_MIN
@@ -83,6 +279,10 @@ def main():
     new_results = {}
     old_max_results = {}
     new_max_results = {}
+    old_memory = {}
+    new_memory = {}
+    old_counters = {}
+    new_counters = {}
     ratio_list = {}
     delta_list = {}
     unknown_list = {}
@@ -110,8 +310,22 @@ def main():
                         help='Name of the old branch', default="OLD_MIN")
     parser.add_argument('--delta-threshold',
                         help='delta threshold', default="0.05")
+    parser.add_argument('--significance',
+                        help='only report changes which the Mann-Whitney U '
+                        'test finds significant at this level, for tests '
+                        'with samples in both files (from --verbose logs)',
+                        default="0.05")
+    parser.add_argument('--old-size-file',
+                        help='Baseline code size report of '
+                        'Benchmark_CodeSize (csv file)')
+    parser.add_argument('--new-size-file',
+                        help='New code size report of Benchmark_CodeSize '
+                        '(csv file)')
 
     args = parser.parse_args()
+    if bool(args.old_size_file) != bool(args.new_size_file):
+        parser.error('--old-size-file and --new-size-file must be used '
+                     'together')
 
     old_file = args.old_file
     new_file = args.new_file
@@ -125,7 +339,10 @@ def main():
     RATIO_MIN = 1 - float(args.delta_threshold)
     RATIO_MAX = 1 + float(args.delta_threshold)
 
+    old_header = None
     for row in old_data:
+        if row and row[0] == '#':
+            old_header = row
         if (len(row) > 7 and row[MIN].isdigit()):
             if row[TESTNAME] in old_results:
                 if old_results[row[TESTNAME]] > int(row[MIN]):
@@ -135,8 +352,15 @@ def main():
             else:
                 old_results[row[TESTNAME]] = int(row[MIN])
                 old_max_results[row[TESTNAME]] = int(row[MAX])
+            read_metrics(row, old_header, MEMORY_METRICS, MEMORY,
+                         old_memory)
+            read_metrics(row, old_header, HARDWARE_COUNTERS, None,
+                         old_counters)
 
+    new_header = None
     for row in new_data:
+        if row and row[0] == '#':
+            new_header = row
         if (len(row) > 7 and row[MIN].isdigit()):
             if row[TESTNAME] in new_results:
                 if int(new_results[row[TESTNAME]]) > int(row[MIN]):
@@ -146,6 +370,19 @@ def main():
             else:
                 new_results[row[TESTNAME]] = int(row[MIN])
                 new_max_results[row[TESTNAME]] = int(row[MAX])
+            read_metrics(row, new_header, MEMORY_METRICS, MEMORY,
+                         new_memory)
+            read_metrics(row, new_header, HARDWARE_COUNTERS, None,
+                         new_counters)
+
+    old_samples = read_samples(old_file)
+    new_samples = read_samples(new_file)
+    significance = float(args.significance)
+    for key in new_results.keys():
+        if key in old_samples and key in new_samples:
+            p_value = mann_whitney_p_value(old_samples[key], new_samples[key])
+            if p_value is not None and p_value >= significance:
+                INSIGNIFICANT.add(key)
 
     ratio_total = 0
     for key in new_results.keys():
@@ -224,6 +461,37 @@ def main():
             ("{0:+.1f}%".format(delta_list[key])).ljust(delta_width),
             "{0}{1}".format(str(ratio).ljust(2), unknown_list[key]))
 
+    changes = metric_changes(old_memory, new_memory, MEMORY_METRICS)
+    markdown_memory = metric_table(changes)
+
+    counter_changes = hardware_counter_changes(old_counters, new_counters)
+    markdown_counters = metric_table(counter_changes)
+
+    size_changes = []
+    markdown_size = ""
+    if args.old_size_file:
+        size_changes = code_size_changes(read_code_sizes(args.old_size_file),
+                                         read_code_sizes(args.new_size_file),
+                                         delta_list)
+    if size_changes:
+        test_width = max(len('TEST'), *[len(c[0]) for c in size_changes])
+        old_width = max(len('OLD'), *[len(str(c[1])) for c in size_changes])
+        new_width = max(len('NEW'), *[len(str(c[2])) for c in size_changes])
+        delta_width = len('DELTA (%)')
+        markdown_size = "\n" + MARKDOWN_ROW.format(
+            "TEST".ljust(test_width), "OLD".ljust(old_width),
+            "NEW".ljust(new_width), "DELTA (%)", "TIME DELTA (%)")
+        markdown_size += MARKDOWN_ROW.format(
+            HEADER_SPLIT.ljust(test_width), HEADER_SPLIT.ljust(old_width),
+            HEADER_SPLIT.ljust(new_width), HEADER_SPLIT.ljust(delta_width),
+            HEADER_SPLIT)
+        for (key, old, new, delta, time_delta) in size_changes:
+            markdown_size += MARKDOWN_ROW.format(
+                key.ljust(test_width), str(old).ljust(old_width),
+                str(new).ljust(new_width),
+                "{0:+.1f}%".format(delta).ljust(delta_width),
+                "" if time_delta is None else "{0:+.1f}%".format(time_delta))
+
     markdown_data = MARKDOWN_DETAIL.format("Regression",
                                            len(decreased_perf_list),
                                            markdown_regression, "open")
@@ -234,6 +502,18 @@ def main():
         markdown_data += MARKDOWN_DETAIL.format("No Changes",
                                                 len(normal_perf_list),
                                                 markdown_normal, "")
+    if old_memory and new_memory:
+        markdown_data += MARKDOWN_DETAIL.format("Memory Changes",
+                                                len(changes),
+                                                markdown_memory, "open")
+    if old_counters and new_counters:
+        markdown_data += MARKDOWN_DETAIL.format("Hardware Counter Changes",
+                                                len(counter_changes),
+                                                markdown_counters, "open")
+    if args.old_size_file:
+        markdown_data += MARKDOWN_DETAIL.format("Code Size Changes",
+                                                len(size_changes),
+                                                markdown_size, "open")
 
     if args.format:
         if args.format.lower() != "markdown":
@@ -242,6 +522,15 @@ def main():
                                             markdown_improvement)
             if not args.changes_only:
                 pain_data += PAIN_DETAIL.format("No Changes", markdown_normal)
+            if old_memory and new_memory:
+                pain_data += PAIN_DETAIL.format("Memory Changes",
+                                                markdown_memory)
+            if old_counters and new_counters:
+                pain_data += PAIN_DETAIL.format("Hardware Counter Changes",
+                                                markdown_counters)
+            if args.old_size_file:
+                pain_data += PAIN_DETAIL.format("Code Size Changes",
+                                                markdown_size)
 
             print(pain_data.replace("|", " ").replace("-", " "))
         else:
@@ -278,7 +567,9 @@ def convert_to_html(ratio_list, old_results, new_results, delta_list,
 
     html_rows = ""
     for key in complete_perf_list:
-        if ratio_list[key] < RATIO_MIN:
+        if key in INSIGNIFICANT:
+            color = "black"
+        elif ratio_list[key] < RATIO_MIN:
             color = "red"
         elif ratio_list[key] > RATIO_MAX:
             color = "green"
@@ -329,7 +620,9 @@ def sort_ratio_list(ratio_list, changes_only=False):
     normal_perf_list = {}
 
     for key, v in sorted(ratio_list.items(), key=lambda x: x[1]):
-        if ratio_list[key] < RATIO_MIN:
+        if key in INSIGNIFICANT:
+            normal_perf_list[key] = v
+        elif ratio_list[key] < RATIO_MIN:
             decreased_perf_list.append(key)
         elif ratio_list[key] > RATIO_MAX:
             increased_perf_list.append(key)
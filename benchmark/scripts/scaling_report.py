@@ -0,0 +1,80 @@
+#!/usr/bin/python
+# -*- coding: utf-8 -*-
+
+# ===--- scaling_report.py -----------------------------------------------===//
+#
+#  This source file is part of the Swift.org open source project
+#
+#  Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+#  Licensed under Apache License v2.0 with Runtime Library Exception
+#
+#  See https://swift.org/LICENSE.txt for license information
+#  See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+#
+# ===---------------------------------------------------------------------===//
+#
+# Summarizes the multi-threaded benchmarks of a benchmark log as scalability
+# curves. Benchmarks named <Workload>_T<threads> are grouped by workload, and
+# for each thread count the report shows the minimum time and the efficiency
+# relative to one thread. Every thread does the same amount of work, so an
+# efficiency of 1.0 means perfect scaling.
+#
+# ===---------------------------------------------------------------------===//
+
+import argparse
+import csv
+import re
+import sys
+
+TESTNAME = 1
+MIN = 3
+
+THREADED_TEST = re.compile(r'^(.*)_T(\d+)$')
+
+
+def read_scaling_results(path):
+    """Return a map from workload to a map from thread count to time."""
+    results = {}
+    with open(path) as f:
+        for row in csv.reader(f):
+            if len(row) <= MIN or not row[0].isdigit():
+                continue
+            match = THREADED_TEST.match(row[TESTNAME])
+            if not match:
+                continue
+            results.setdefault(match.group(1), {})[int(match.group(2))] = \
+                int(row[MIN])
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Report how the multi-threaded benchmarks scale')
+    parser.add_argument('file', help='benchmark log in CSV format')
+    args = parser.parse_args()
+
+    results = read_scaling_results(args.file)
+    if not results:
+        print('no multi-threaded benchmarks found in ' + args.file)
+        return 1
+
+    for workload in sorted(results):
+        times = results[workload]
+        print(workload)
+        print('{:>9} {:>12} {:>11}'.format('THREADS', 'MIN (us)',
+                                           'EFFICIENCY'))
+        base = times.get(1)
+        for threads in sorted(times):
+            if base and times[threads]:
+                efficiency = '{:.2f}'.format(
+                    base / float(times[threads]))
+            else:
+                efficiency = '-'
+            print('{:>9} {:>12} {:>11}'.format(threads, times[threads],
+                                               efficiency))
+        print('')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
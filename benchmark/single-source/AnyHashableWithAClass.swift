@@ -12,7 +12,9 @@
 
 // This benchmark tests AnyHashable's initializer that needs to dynamically
 // upcast the instance to the type that introduces the Hashable
-// conformance.
+// conformance, and, for comparison, its fast path for common value types.
+
+import TestsUtils
 
 class TestHashableBase : Hashable {
   var value: Int
@@ -44,3 +46,15 @@ public func run_AnyHashableWithAClass(_ N: Int) {
   }
 }
 
+@inline(never)
+public func run_AnyHashableWithScalars(_ N: Int) {
+  var keys: [AnyHashable: Int] = [:]
+  for i in 0..<N*1000 {
+    let n = i % 100
+    keys[AnyHashable(n)] = i
+    keys[AnyHashable(String(n))] = i
+    keys[AnyHashable(Double(n))] = i
+  }
+  CheckResults(keys.count == 300,
+               "Incorrect results in AnyHashableWithScalars")
+}
@@ -0,0 +1,332 @@
+//===--- ConcurrentRuntime.swift ------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+// Runtime and stdlib workloads run on several threads at once, to expose
+// contention in the runtime: reference counting of a shared object, generic
+// metadata lookup, protocol conformance lookup and malloc.
+//
+// Each workload runs as one benchmark per thread count, named
+// <Workload>_T<threads>. Every thread does the same amount of work, so on a
+// machine with enough cores the time stays flat as threads are added when
+// nothing is contended. scripts/scaling_report.py summarizes the results as
+// a scalability curve for each workload.
+import TestsUtils
+
+//===----------------------------------------------------------------------===//
+// Reference counting of an object shared by all threads.
+//===----------------------------------------------------------------------===//
+
+final class SharedObject {
+  var value = 1
+}
+
+let sharedObject = SharedObject()
+
+@inline(never)
+func retainReleaseShared(_ N: Int) -> Int {
+  // Storing the object into the array retains it and releases the previous
+  // element.
+  var slots = [SharedObject?](repeating: nil, count: 16)
+  var sum = 0
+  for i in 0..<(N * 10_000) {
+    slots[i & 15] = sharedObject
+    sum += slots[(i + 1) & 15]?.value ?? 0
+  }
+  return sum
+}
+
+@inline(never)
+func runConcurrentRetainRelease(_ N: Int, threads: Int) {
+  runConcurrently(threads: threads) { _ in
+    CheckResults(retainReleaseShared(N) > 0, "Incorrect results")
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Generic metadata lookup.
+//===----------------------------------------------------------------------===//
+
+struct Wrapper<T> {
+  var value: T
+}
+
+/// Wraps `x` in `depth` levels of Wrapper. The recursion changes the type
+/// argument, so it cannot be specialized and every level asks the runtime for
+/// the metadata of a Wrapper type.
+@inline(never)
+func wrap<T>(_ x: T, depth: Int) -> Any {
+  if depth == 0 {
+    return x
+  }
+  return wrap(Wrapper(value: x), depth: depth - 1)
+}
+
+/// A different base type per thread, so that the first run instantiates
+/// metadata on all threads at once.
+let metadataBaseValues: [Any] = [
+  1, "a", 1.0, Int8(1), Int16(1), Int32(1), Int64(1), UInt(1),
+  UInt8(1), UInt16(1), UInt32(1), UInt64(1), Float(1), true,
+  [1], ["a": 1],
+]
+
+@inline(never)
+func wrapBaseValue(_ index: Int, depth: Int) -> Any {
+  switch metadataBaseValues[index % metadataBaseValues.count] {
+  case let x as Int: return wrap(x, depth: depth)
+  case let x as String: return wrap(x, depth: depth)
+  case let x as Double: return wrap(x, depth: depth)
+  case let x as Int8: return wrap(x, depth: depth)
+  case let x as Int16: return wrap(x, depth: depth)
+  case let x as Int32: return wrap(x, depth: depth)
+  case let x as Int64: return wrap(x, depth: depth)
+  case let x as UInt: return wrap(x, depth: depth)
+  case let x as UInt8: return wrap(x, depth: depth)
+  case let x as UInt16: return wrap(x, depth: depth)
+  case let x as UInt32: return wrap(x, depth: depth)
+  case let x as UInt64: return wrap(x, depth: depth)
+  case let x as Float: return wrap(x, depth: depth)
+  case let x as Bool: return wrap(x, depth: depth)
+  case let x as [Int]: return wrap(x, depth: depth)
+  case let x as [String: Int]: return wrap(x, depth: depth)
+  default: return wrap(0, depth: depth)
+  }
+}
+
+@inline(never)
+func runConcurrentGenericMetadata(_ N: Int, threads: Int) {
+  runConcurrently(threads: threads) { thread in
+    var count = 0
+    for i in 0..<(N * 100) {
+      if wrapBaseValue(thread + i, depth: 32) is Wrapper<Int> {
+        count += 1
+      }
+    }
+    CheckResults(count == 0, "Incorrect results")
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Protocol conformance lookup in dynamic casts.
+//===----------------------------------------------------------------------===//
+
+protocol Named {
+  var name: String { get }
+}
+
+struct NamedThing : Named {
+  var name: String { return "thing" }
+}
+
+struct UnnamedThing {}
+
+final class NamedClass : Named {
+  var name: String { return "class" }
+}
+
+final class UnnamedClass {}
+
+let castValues: [Any] = [
+  NamedThing(), UnnamedThing(), NamedClass(), UnnamedClass(), 1, "a",
+  [1], Wrapper(value: 1),
+]
+
+@inline(never)
+func countNamed(_ N: Int) -> Int {
+  var count = 0
+  for _ in 0..<(N * 1_000) {
+    for value in castValues {
+      if value is Named {
+        count += 1
+      }
+      if value is CustomStringConvertible {
+        count += 1
+      }
+    }
+  }
+  return count
+}
+
+@inline(never)
+func runConcurrentProtocolCast(_ N: Int, threads: Int) {
+  runConcurrently(threads: threads) { _ in
+    CheckResults(countNamed(N) == N * 1_000 * 5, "Incorrect results")
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// A Dictionary per thread, which mostly contends on malloc.
+//===----------------------------------------------------------------------===//
+
+@inline(never)
+func buildDictionaries(_ N: Int, seed: Int) -> Int {
+  var total = 0
+  for i in 0..<(N * 10) {
+    var dict = [Int: String]()
+    for j in 0..<100 {
+      dict[seed &+ i &* 100 &+ j] = "\(j)"
+    }
+    total += dict.count
+  }
+  return total
+}
+
+@inline(never)
+func runConcurrentDictionary(_ N: Int, threads: Int) {
+  runConcurrently(threads: threads) { thread in
+    CheckResults(buildDictionaries(N, seed: thread) == N * 10 * 100,
+                 "Incorrect results")
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Entry points.
+//===----------------------------------------------------------------------===//
+
+@inline(never)
+public func run_ConcurrentDictionary_T1(_ N: Int) {
+  runConcurrentDictionary(N, threads: 1)
+}
+
+@inline(never)
+public func run_ConcurrentDictionary_T2(_ N: Int) {
+  runConcurrentDictionary(N, threads: 2)
+}
+
+@inline(never)
+public func run_ConcurrentDictionary_T4(_ N: Int) {
+  runConcurrentDictionary(N, threads: 4)
+}
+
+@inline(never)
+public func run_ConcurrentDictionary_T8(_ N: Int) {
+  runConcurrentDictionary(N, threads: 8)
+}
+
+@inline(never)
+public func run_ConcurrentDictionary_T16(_ N: Int) {
+  runConcurrentDictionary(N, threads: 16)
+}
+
+@inline(never)
+public func run_ConcurrentDictionary_T32(_ N: Int) {
+  runConcurrentDictionary(N, threads: 32)
+}
+
+@inline(never)
+public func run_ConcurrentDictionary_T64(_ N: Int) {
+  runConcurrentDictionary(N, threads: 64)
+}
+
+@inline(never)
+public func run_ConcurrentGenericMetadata_T1(_ N: Int) {
+  runConcurrentGenericMetadata(N, threads: 1)
+}
+
+@inline(never)
+public func run_ConcurrentGenericMetadata_T2(_ N: Int) {
+  runConcurrentGenericMetadata(N, threads: 2)
+}
+
+@inline(never)
+public func run_ConcurrentGenericMetadata_T4(_ N: Int) {
+  runConcurrentGenericMetadata(N, threads: 4)
+}
+
+@inline(never)
+public func run_ConcurrentGenericMetadata_T8(_ N: Int) {
+  runConcurrentGenericMetadata(N, threads: 8)
+}
+
+@inline(never)
+public func run_ConcurrentGenericMetadata_T16(_ N: Int) {
+  runConcurrentGenericMetadata(N, threads: 16)
+}
+
+@inline(never)
+public func run_ConcurrentGenericMetadata_T32(_ N: Int) {
+  runConcurrentGenericMetadata(N, threads: 32)
+}
+
+@inline(never)
+public func run_ConcurrentGenericMetadata_T64(_ N: Int) {
+  runConcurrentGenericMetadata(N, threads: 64)
+}
+
+@inline(never)
+public func run_ConcurrentProtocolCast_T1(_ N: Int) {
+  runConcurrentProtocolCast(N, threads: 1)
+}
+
+@inline(never)
+public func run_ConcurrentProtocolCast_T2(_ N: Int) {
+  runConcurrentProtocolCast(N, threads: 2)
+}
+
+@inline(never)
+public func run_ConcurrentProtocolCast_T4(_ N: Int) {
+  runConcurrentProtocolCast(N, threads: 4)
+}
+
+@inline(never)
+public func run_ConcurrentProtocolCast_T8(_ N: Int) {
+  runConcurrentProtocolCast(N, threads: 8)
+}
+
+@inline(never)
+public func run_ConcurrentProtocolCast_T16(_ N: Int) {
+  runConcurrentProtocolCast(N, threads: 16)
+}
+
+@inline(never)
+public func run_ConcurrentProtocolCast_T32(_ N: Int) {
+  runConcurrentProtocolCast(N, threads: 32)
+}
+
+@inline(never)
+public func run_ConcurrentProtocolCast_T64(_ N: Int) {
+  runConcurrentProtocolCast(N, threads: 64)
+}
+
+@inline(never)
+public func run_ConcurrentRetainRelease_T1(_ N: Int) {
+  runConcurrentRetainRelease(N, threads: 1)
+}
+
+@inline(never)
+public func run_ConcurrentRetainRelease_T2(_ N: Int) {
+  runConcurrentRetainRelease(N, threads: 2)
+}
+
+@inline(never)
+public func run_ConcurrentRetainRelease_T4(_ N: Int) {
+  runConcurrentRetainRelease(N, threads: 4)
+}
+
+@inline(never)
+public func run_ConcurrentRetainRelease_T8(_ N: Int) {
+  runConcurrentRetainRelease(N, threads: 8)
+}
+
+@inline(never)
+public func run_ConcurrentRetainRelease_T16(_ N: Int) {
+  runConcurrentRetainRelease(N, threads: 16)
+}
+
+@inline(never)
+public func run_ConcurrentRetainRelease_T32(_ N: Int) {
+  runConcurrentRetainRelease(N, threads: 32)
+}
+
+@inline(never)
+public func run_ConcurrentRetainRelease_T64(_ N: Int) {
+  runConcurrentRetainRelease(N, threads: 64)
+}
@@ -0,0 +1,81 @@
+//===--- DequeOperations.swift --------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+// Queue operations on Deque. DequePopFront is the Deque counterpart of
+// PopFrontArray, and the other two model work lists which never drain.
+
+import TestsUtils
+
+let dequeCount = 1024
+
+@inline(never)
+public func run_DequePopFront(_ N: Int) {
+  let orig = Array(repeating: 1, count: dequeCount)
+  var d = Deque<Int>()
+  for _ in 1...20*N {
+    var result = 0
+    d.append(contentsOf: orig)
+    while let x = d.popFirst() {
+      result += x
+    }
+    CheckResults(result == dequeCount,
+      "IncorrectResults in DequePopFront: \(result) != \(dequeCount)")
+  }
+}
+
+// A breadth-first traversal of an implicit binary tree, which keeps the
+// queue's contents wrapping around the end of its storage.
+@inline(never)
+public func run_DequeBreadthFirst(_ N: Int) {
+  let nodeCount = 100_000
+  for _ in 1...N {
+    var queue: Deque = [0]
+    var visited = 0
+    while let node = queue.popFirst() {
+      visited += 1
+      if 2 * node + 1 < nodeCount {
+        queue.append(2 * node + 1)
+      }
+      if 2 * node + 2 < nodeCount {
+        queue.append(2 * node + 2)
+      }
+    }
+    CheckResults(visited == nodeCount,
+      "IncorrectResults in DequeBreadthFirst: \(visited) != \(nodeCount)")
+  }
+}
+
+// Work-stealing style use: the owner pushes and pops at the back while
+// stealers take from the front.
+@inline(never)
+public func run_DequeBothEnds(_ N: Int) {
+  var d = Deque<Int>(minimumCapacity: dequeCount)
+  for _ in 1...100*N {
+    var result = 0
+    for i in 0..<dequeCount {
+      d.append(i)
+      if i % 3 == 0 {
+        result += d.removeLast()
+      }
+      if i % 4 == 0 {
+        d.prepend(i)
+      }
+      if i % 5 == 0 {
+        result -= d.removeFirst()
+      }
+    }
+    while let x = d.popLast() {
+      result += x
+    }
+    CheckResults(result != 0, "IncorrectResults in DequeBothEnds")
+  }
+}
@@ -0,0 +1,69 @@
+//===--- StableSort.swift -------------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+// This test checks performance and correctness of stableSort on random and
+// nearly sorted arrays of records.
+import TestsUtils
+
+struct Record {
+  var key: Int
+  var position: Int
+}
+
+func makeRecords(count: Int, nearlySorted: Bool) -> [Record] {
+  var records: [Record] = []
+  records.reserveCapacity(count)
+  for i in 0..<count {
+    let key = nearlySorted ? i / 4 : Int(Random() & 0x3ff)
+    records.append(Record(key: key, position: i))
+  }
+  if nearlySorted {
+    for i in stride(from: 0, to: count - 1, by: 97) {
+      swap(&records[i], &records[i + 1])
+    }
+  }
+  return records
+}
+
+func isStablySorted(_ records: [Record]) -> Bool {
+  for i in records.indices.dropFirst() {
+    let (prev, next) = (records[i - 1], records[i])
+    if prev.key > next.key ||
+       (prev.key == next.key && prev.position > next.position) {
+      return false
+    }
+  }
+  return true
+}
+
+@inline(never)
+func benchStableSort(_ records: [Record]) {
+  var sorted = records
+  sorted.stableSort { $0.key < $1.key }
+  CheckResults(isStablySorted(sorted), "Incorrect results in StableSort.")
+}
+
+@inline(never)
+public func run_StableSortRandom(_ N: Int) {
+  let records = makeRecords(count: 4096, nearlySorted: false)
+  for _ in 1...N {
+    benchStableSort(records)
+  }
+}
+
+@inline(never)
+public func run_StableSortNearlySorted(_ N: Int) {
+  let records = makeRecords(count: 4096, nearlySorted: true)
+  for _ in 1...N {
+    benchStableSort(records)
+  }
+}
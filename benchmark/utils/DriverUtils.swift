@@ -10,7 +10,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#if os(Linux)
+import Glibc
+#else
 import Darwin
+#endif
 
 struct BenchResults {
   var delim: String  = ","
@@ -20,8 +24,11 @@ struct BenchResults {
   var mean: UInt64 = 0
   var sd: UInt64 = 0
   var median: UInt64 = 0
+  var mad: UInt64 = 0
+  var p10: UInt64 = 0
+  var p90: UInt64 = 0
   init() {}
-  init(delim: String, sampleCount: UInt64, min: UInt64, max: UInt64, mean: UInt64, sd: UInt64, median: UInt64) {
+  init(delim: String, sampleCount: UInt64, min: UInt64, max: UInt64, mean: UInt64, sd: UInt64, median: UInt64, mad: UInt64, p10: UInt64, p90: UInt64) {
     self.delim = delim
     self.sampleCount = sampleCount
     self.min = min
@@ -29,6 +36,9 @@ struct BenchResults {
     self.mean = mean
     self.sd = sd
     self.median = median
+    self.mad = mad
+    self.p10 = p10
+    self.p90 = p90
 
     // Sanity the bounds of our results
     precondition(self.min <= self.max, "min should always be <= max")
@@ -36,12 +46,47 @@ struct BenchResults {
     precondition(self.min <= self.median, "min should always be <= median")
     precondition(self.max >= self.mean, "max should always be >= mean")
     precondition(self.max >= self.median, "max should always be >= median")
+    precondition(self.p10 <= self.median, "p10 should always be <= median")
+    precondition(self.p90 >= self.median, "p90 should always be >= median")
+  }
+}
+
+/// The runtime's allocation and reference counting work for one iteration of
+/// a benchmark, and the process's peak resident memory after running it.
+struct MemoryResults {
+  var delim: String = ","
+  var allocations: UInt64 = 0
+  var allocatedBytes: UInt64 = 0
+  var retains: UInt64 = 0
+  var releases: UInt64 = 0
+  var maxRSS: UInt64 = 0
+}
+
+/// The CPU events of one iteration of a benchmark.
+struct HardwareCounterResults {
+  var delim: String = ","
+  var instructions: UInt64 = 0
+  var cycles: UInt64 = 0
+  var branchMisses: UInt64 = 0
+  var l1DataMisses: UInt64 = 0
+  var lastLevelCacheMisses: UInt64 = 0
+}
+
+extension HardwareCounterResults : CustomStringConvertible {
+  var description: String {
+    return "\(instructions)\(delim)\(cycles)\(delim)\(branchMisses)\(delim)\(l1DataMisses)\(delim)\(lastLevelCacheMisses)"
+  }
+}
+
+extension MemoryResults : CustomStringConvertible {
+  var description: String {
+    return "\(allocations)\(delim)\(allocatedBytes)\(delim)\(retains)\(delim)\(releases)\(delim)\(maxRSS)"
   }
 }
 
 extension BenchResults : CustomStringConvertible {
   var description: String {
-     return "\(sampleCount)\(delim)\(min)\(delim)\(max)\(delim)\(mean)\(delim)\(sd)\(delim)\(median)"
+     return "\(sampleCount)\(delim)\(min)\(delim)\(max)\(delim)\(mean)\(delim)\(sd)\(delim)\(median)\(delim)\(mad)\(delim)\(p10)\(delim)\(p90)"
   }
 }
 
@@ -88,6 +133,26 @@ struct TestConfig {
   /// The number of samples we should take of each test.
   var numSamples: Int = 1
 
+  /// The maximum number of samples to take of each test. If this is larger
+  /// than numSamples, sampling continues after numSamples samples until the
+  /// median is known to within targetPrecision.
+  var maxSamples: Int = 0
+
+  /// The half-width of the 95% confidence interval of the median, relative to
+  /// the median, at which we stop taking more samples.
+  var targetPrecision: Double = 0.01
+
+  /// Should samples which are much slower than the others be discarded?
+  var rejectOutliers: Bool = false
+
+  /// Should we report the allocations, retains and releases per iteration
+  /// and the peak memory use of each test?
+  var memoryMetrics: Bool = false
+
+  /// Should we report the instructions, cycles, branch misses and cache
+  /// misses per iteration of each test? Requires Linux perf events.
+  var hardwareCounters: Bool = false
+
   /// Is verbose output enabled?
   var verbose: Bool = false
 
@@ -104,7 +169,9 @@ struct TestConfig {
   mutating func processArguments() -> TestAction {
     let validOptions = [
       "--iter-scale", "--num-samples", "--num-iters",
-      "--verbose", "--delim", "--run-all", "--list", "--sleep"
+      "--verbose", "--delim", "--run-all", "--list", "--sleep",
+      "--max-samples", "--target-precision", "--reject-outliers",
+      "--memory-metrics", "--hardware-counters"
     ]
     let maybeBenchArgs: Arguments? = parseArgs(validOptions)
     if maybeBenchArgs == nil {
@@ -131,6 +198,28 @@ struct TestConfig {
       numSamples = Int(x)!
     }
 
+    if let x = benchArgs.optionalArgsMap["--max-samples"] {
+      if x.isEmpty { return .Fail("--max-samples requires a value") }
+      maxSamples = Int(x)!
+    }
+
+    if let x = benchArgs.optionalArgsMap["--target-precision"] {
+      if x.isEmpty { return .Fail("--target-precision requires a value") }
+      targetPrecision = Double(x)!
+    }
+
+    if let _ = benchArgs.optionalArgsMap["--reject-outliers"] {
+      rejectOutliers = true
+    }
+
+    if let _ = benchArgs.optionalArgsMap["--memory-metrics"] {
+      memoryMetrics = true
+    }
+
+    if let _ = benchArgs.optionalArgsMap["--hardware-counters"] {
+      hardwareCounters = true
+    }
+
     if let _ = benchArgs.optionalArgsMap["--verbose"] {
       verbose = true
       print("Verbose")
@@ -217,6 +306,49 @@ func internalMedian(_ inputs: [UInt64]) -> UInt64 {
   return inputs.sorted()[inputs.count / 2]
 }
 
+/// Returns the median absolute deviation of the inputs from their median.
+func internalMAD(_ inputs: [UInt64], _ median: UInt64) -> UInt64 {
+  return internalMedian(inputs.map { $0 > median ? $0 - median : median - $0 })
+}
+
+/// Returns the p-th percentile of the sorted inputs, using the nearest-rank
+/// method.
+func internalPercentile(_ sorted: [UInt64], _ p: Double) -> UInt64 {
+  let rank = Int((p / 100 * Double(sorted.count)).rounded(.up))
+  return sorted[max(rank, 1) - 1]
+}
+
+/// Returns the half-width of a distribution-free 95% confidence interval of
+/// the median of the inputs, relative to the median. Returns infinity if there
+/// are too few inputs to tell.
+func internalMedianPrecision(_ inputs: [UInt64]) -> Double {
+  let n = inputs.count
+  if n < 6 {
+    return Double.infinity
+  }
+  let sorted = inputs.sorted()
+  let median = sorted[n / 2]
+  if median == 0 {
+    return 0
+  }
+  // The ranks of the interval bounds follow from the normal approximation of
+  // the binomial distribution of the number of samples below the median.
+  let offset = 1.96 * sqrt(Double(n)) / 2
+  let lower = max(Int((Double(n) / 2 - offset).rounded(.down)), 0)
+  let upper = min(Int((Double(n) / 2 + offset).rounded(.up)), n - 1)
+  return Double(sorted[upper] - sorted[lower]) / 2 / Double(median)
+}
+
+/// Returns the value above which a sample is considered an outlier: the third
+/// quartile plus 1.5 times the interquartile range. There is no lower fence,
+/// as interference from the rest of the system only makes samples slower.
+func internalUpperFence(_ inputs: [UInt64]) -> UInt64 {
+  let sorted = inputs.sorted()
+  let q1 = internalPercentile(sorted, 25)
+  let q3 = internalPercentile(sorted, 75)
+  return q3 + (q3 - q1) * 3 / 2
+}
+
 #if SWIFT_RUNTIME_ENABLE_LEAK_CHECKER
 
 @_silgen_name("swift_leaks_startTrackingObjects")
@@ -226,42 +358,154 @@ func stopTrackingObjects(_: UnsafeMutableRawPointer) -> Int
 
 #endif
 
+@_silgen_name("swift_profiler_startCounting")
+func startCountingRuntimeCalls() -> ()
+@_silgen_name("swift_profiler_stopCounting")
+func stopCountingRuntimeCalls(_: UnsafeMutablePointer<UInt64>) -> ()
+
+/// Returns the number of allocations, allocated bytes, retains and releases
+/// done by the runtime while running \p fn for \p num_iters iterations.
+func countRuntimeCalls(_ fn: (Int) -> Void, num_iters: UInt) -> [UInt64] {
+  // The order of the counts is defined by RuntimeCallCount in the runtime.
+  var counts = [UInt64](repeating: 0, count: 4)
+  startCountingRuntimeCalls()
+  fn(Int(num_iters))
+  stopCountingRuntimeCalls(&counts)
+  return counts
+}
+
+/// Returns the peak resident memory of the process, in bytes.
+func getMaxRSS() -> UInt64 {
+  var usage = rusage()
+  getrusage(RUSAGE_SELF, &usage)
+#if os(Linux)
+  // Linux reports kilobytes.
+  return UInt64(usage.ru_maxrss) * 1024
+#else
+  return UInt64(usage.ru_maxrss)
+#endif
+}
+
+/// Measure the runtime work of one iteration of a benchmark.
+func measureMemory(_ fn: (Int) -> Void, _ c: TestConfig) -> MemoryResults {
+  // The difference between two iterations and one iteration leaves out the
+  // benchmark's setup, which it does once per call.
+  let one = countRuntimeCalls(fn, num_iters: 1)
+  let two = countRuntimeCalls(fn, num_iters: 2)
+  let perIteration = zip(two, one).map { $0 > $1 ? $0 - $1 : 0 }
+
+  var results = MemoryResults()
+  results.delim = c.delim
+  results.allocations = perIteration[0]
+  results.allocatedBytes = perIteration[1]
+  results.retains = perIteration[2]
+  results.releases = perIteration[3]
+  results.maxRSS = getMaxRSS()
+  return results
+}
+
+@_silgen_name("swift_profiler_startHardwareCounters")
+func startHardwareCounters() -> Bool
+@_silgen_name("swift_profiler_stopHardwareCounters")
+func stopHardwareCounters(_: UnsafeMutablePointer<UInt64>) -> ()
+
+/// Returns the instructions, cycles, branch misses, L1 data cache misses and
+/// last level cache misses of running \p fn for \p num_iters iterations.
+func countHardwareEvents(_ fn: (Int) -> Void, num_iters: UInt) -> [UInt64] {
+  // The order of the counts is defined by HardwareCounter in the runtime.
+  var counts = [UInt64](repeating: 0, count: 5)
+  if !startHardwareCounters() {
+    fatalError("--hardware-counters requires Linux perf events; check " +
+               "/proc/sys/kernel/perf_event_paranoid")
+  }
+  fn(Int(num_iters))
+  stopHardwareCounters(&counts)
+  return counts
+}
+
+/// Measure the CPU events of one iteration of a benchmark.
+func measureHardwareCounters(_ fn: (Int) -> Void, _ c: TestConfig)
+    -> HardwareCounterResults {
+  // As for memory, subtract one iteration from two to leave out the setup,
+  // and keep the smallest of a few measurements, since interference only
+  // adds events.
+  var perIteration = [UInt64](repeating: UInt64.max, count: 5)
+  for _ in 0..<3 {
+    let one = countHardwareEvents(fn, num_iters: 1)
+    let two = countHardwareEvents(fn, num_iters: 2)
+    for i in perIteration.indices {
+      perIteration[i] = min(perIteration[i], two[i] > one[i] ? two[i] - one[i] : 0)
+    }
+  }
+
+  var results = HardwareCounterResults()
+  results.delim = c.delim
+  results.instructions = perIteration[0]
+  results.cycles = perIteration[1]
+  results.branchMisses = perIteration[2]
+  results.l1DataMisses = perIteration[3]
+  results.lastLevelCacheMisses = perIteration[4]
+  return results
+}
+
 class SampleRunner {
+#if os(Linux)
+  init() {}
+  func getTimeNanoseconds() -> UInt64 {
+    var ts = timespec(tv_sec: 0, tv_nsec: 0)
+    clock_gettime(CLOCK_MONOTONIC, &ts)
+    return UInt64(ts.tv_sec) * 1_000_000_000 + UInt64(ts.tv_nsec)
+  }
+#else
   var info = mach_timebase_info_data_t(numer: 0, denom: 0)
   init() {
     mach_timebase_info(&info)
   }
+  func getTimeNanoseconds() -> UInt64 {
+    return mach_absolute_time() * UInt64(info.numer) / UInt64(info.denom)
+  }
+#endif
   func run(_ name: String, fn: (Int) -> Void, num_iters: UInt) -> UInt64 {
     // Start the timer.
 #if SWIFT_RUNTIME_ENABLE_LEAK_CHECKER
     var str = name
     startTrackingObjects(UnsafeMutableRawPointer(str._core.startASCII))
 #endif
-    let start_ticks = mach_absolute_time()
+    let start_ns = getTimeNanoseconds()
     fn(Int(num_iters))
     // Stop the timer.
-    let end_ticks = mach_absolute_time()
+    let end_ns = getTimeNanoseconds()
 #if SWIFT_RUNTIME_ENABLE_LEAK_CHECKER
     stopTrackingObjects(UnsafeMutableRawPointer(str._core.startASCII))
 #endif
 
-    // Compute the spent time and the scaling factor.
-    let elapsed_ticks = end_ticks - start_ticks
-    return elapsed_ticks * UInt64(info.numer) / UInt64(info.denom)
+    // Compute the spent time.
+    return end_ns - start_ns
   }
 }
 
 /// Invoke the benchmark entry point and return the run time in milliseconds.
 func runBench(_ name: String, _ fn: (Int) -> Void, _ c: TestConfig) -> BenchResults {
 
-  var samples = [UInt64](repeating: 0, count: c.numSamples)
+  var samples = [UInt64]()
+  let maxSamples = max(c.numSamples, c.maxSamples)
 
   if c.verbose {
-    print("Running \(name) for \(c.numSamples) samples.")
+    if maxSamples > c.numSamples {
+      print("Running \(name) for \(c.numSamples) to \(maxSamples) samples.")
+    } else {
+      print("Running \(name) for \(c.numSamples) samples.")
+    }
   }
 
   let sampler = SampleRunner()
-  for s in 0..<c.numSamples {
+  while samples.count < maxSamples {
+    // Stop sampling adaptively once the median is precise enough.
+    if samples.count >= c.numSamples &&
+       internalMedianPrecision(samples) <= c.targetPrecision {
+      break
+    }
+    let s = samples.count
     let time_per_sample: UInt64 = 1_000_000_000 * UInt64(c.iterationScale)
 
     var scale : UInt
@@ -284,24 +528,47 @@ func runBench(_ name: String, _ fn: (Int) -> Void, _ c: TestConfig) -> BenchResu
       scale = 1
     }
     // save result in microseconds or k-ticks
-    samples[s] = elapsed_time / UInt64(scale) / 1000
+    samples.append(elapsed_time / UInt64(scale) / 1000)
     if c.verbose {
       print("    Sample \(s),\(samples[s])")
     }
   }
 
+  // Quartiles of fewer samples don't tell outliers apart.
+  if c.rejectOutliers && samples.count >= 4 {
+    let fence = internalUpperFence(samples)
+    if c.verbose {
+      for (s, sample) in samples.enumerated() where sample > fence {
+        print("    Outlier \(s),\(sample)")
+      }
+    }
+    samples = samples.filter { $0 <= fence }
+  }
+
   let (mean, sd) = internalMeanSD(samples)
+  let median = internalMedian(samples)
+  let sorted = samples.sorted()
 
   // Return our benchmark results.
   return BenchResults(delim: c.delim, sampleCount: UInt64(samples.count),
-                      min: samples.min()!, max: samples.max()!,
-                      mean: mean, sd: sd, median: internalMedian(samples))
+                      min: sorted.first!, max: sorted.last!,
+                      mean: mean, sd: sd, median: median,
+                      mad: internalMAD(samples, median),
+                      p10: internalPercentile(sorted, 10),
+                      p90: internalPercentile(sorted, 90))
 }
 
 func printRunInfo(_ c: TestConfig) {
   if c.verbose {
     print("--- CONFIG ---")
     print("NumSamples: \(c.numSamples)")
+    if c.maxSamples > c.numSamples {
+      print("MaxSamples: \(c.maxSamples)")
+      print("TargetPrecision: \(c.targetPrecision)")
+    }
+    print("RejectOutliers: \(c.rejectOutliers)")
+    print("MemoryMetrics: \(c.memoryMetrics)")
+    print("HardwareCounters: \(c.hardwareCounters)")
     print("Verbose: \(c.verbose)")
     print("IterScale: \(c.iterationScale)")
     if c.fixedNumIters != 0 {
@@ -322,7 +589,7 @@ func printRunInfo(_ c: TestConfig) {
 
 func runBenchmarks(_ c: TestConfig) {
   let units = "us"
-  print("#\(c.delim)TEST\(c.delim)SAMPLES\(c.delim)MIN(\(units))\(c.delim)MAX(\(units))\(c.delim)MEAN(\(units))\(c.delim)SD(\(units))\(c.delim)MEDIAN(\(units))")
+  print("#\(c.delim)TEST\(c.delim)SAMPLES\(c.delim)MIN(\(units))\(c.delim)MAX(\(units))\(c.delim)MEAN(\(units))\(c.delim)SD(\(units))\(c.delim)MEDIAN(\(units))\(c.delim)MAD(\(units))\(c.delim)P10(\(units))\(c.delim)P90(\(units))\(c.memoryMetrics ? "\(c.delim)ALLOCS\(c.delim)ALLOC_BYTES\(c.delim)RETAINS\(c.delim)RELEASES\(c.delim)MAX_RSS(B)" : "")\(c.hardwareCounters ? "\(c.delim)INSTRUCTIONS\(c.delim)CYCLES\(c.delim)BRANCH_MISSES\(c.delim)L1D_MISSES\(c.delim)LLC_MISSES" : "")")
   var SumBenchResults = BenchResults()
   SumBenchResults.sampleCount = 0
 
@@ -334,7 +601,16 @@ func runBenchmarks(_ c: TestConfig) {
     let BenchName = t.name
     let BenchFunc = t.f
     let results = runBench(BenchName, BenchFunc, c)
-    print("\(BenchIndex)\(c.delim)\(BenchName)\(c.delim)\(results.description)")
+    var line = "\(BenchIndex)\(c.delim)\(BenchName)\(c.delim)\(results.description)"
+    if c.memoryMetrics {
+      let memory = measureMemory(BenchFunc, c)
+      line += "\(c.delim)\(memory.description)"
+    }
+    if c.hardwareCounters {
+      let counters = measureHardwareCounters(BenchFunc, c)
+      line += "\(c.delim)\(counters.description)"
+    }
+    print(line)
     fflush(stdout)
 
     SumBenchResults.min += results.min
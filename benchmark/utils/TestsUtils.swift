@@ -10,7 +10,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#if os(Linux)
+import Glibc
+#else
 import Darwin
+#endif
 
 // Linear function shift register.
 //
@@ -63,3 +67,59 @@ struct MyStruct : SomeProtocol {
 }
 public func someProtocolFactory() -> SomeProtocol { return MyStruct() }
 
+/// Returns the string whose UTF-8 encoding is `bytes`, which must not contain
+/// a NUL byte.
+public func makeString(fromUTF8 bytes: [UInt8]) -> String {
+  var terminated = bytes
+  terminated.append(0)
+  return terminated.withUnsafeBufferPointer {
+    String(cString: $0.baseAddress!)
+  }
+}
+
+/// The work of one thread started by runConcurrently.
+final class ThreadWork {
+  let body: (Int) -> ()
+  let index: Int
+  init(_ body: @escaping (Int) -> (), _ index: Int) {
+    self.body = body
+    self.index = index
+  }
+  func run() { body(index) }
+}
+
+#if os(Linux)
+private func threadEntry(_ arg: UnsafeMutableRawPointer?)
+    -> UnsafeMutableRawPointer? {
+  Unmanaged<ThreadWork>.fromOpaque(arg!).takeRetainedValue().run()
+  return nil
+}
+#else
+private func threadEntry(_ arg: UnsafeMutableRawPointer)
+    -> UnsafeMutableRawPointer? {
+  Unmanaged<ThreadWork>.fromOpaque(arg).takeRetainedValue().run()
+  return nil
+}
+#endif
+
+/// Runs `body` on `threads` threads at the same time, passing each the index
+/// of its thread, and returns when all of them are done.
+public func runConcurrently(threads: Int, _ body: @escaping (Int) -> ()) {
+#if os(Linux)
+  var handles = [pthread_t](repeating: 0, count: threads)
+#else
+  var handles = [pthread_t?](repeating: nil, count: threads)
+#endif
+  for i in 0..<threads {
+    let work = Unmanaged.passRetained(ThreadWork(body, i)).toOpaque()
+    let result = pthread_create(&handles[i], nil, threadEntry, work)
+    CheckResults(result == 0, "pthread_create failed")
+  }
+  for handle in handles {
+#if os(Linux)
+    pthread_join(handle, nil)
+#else
+    pthread_join(handle!, nil)
+#endif
+  }
+}
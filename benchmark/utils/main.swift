@@ -38,7 +38,9 @@ import Calculator
 import CaptureProp
 import Chars
 import ClassArrayGetter
+import ConcurrentRuntime
 import DeadArray
+import DequeOperations
 import DictTest
 import DictTest2
 import DictTest3
@@ -49,13 +51,17 @@ import DictionarySwap
 import ErrorHandling
 import Fibonacci
 import GlobalClass
+import GraphAlgorithms
+import HTTPParsing
 import Hanoi
 import Hash
 import Histogram
 import Integrate
 import IterateData
+import JSONCoding
 import Join
 import LinkedList
+import LogAggregation
 import MapReduce
 import Memset
 import MonteCarloE
@@ -80,6 +86,7 @@ import PopFrontGeneric
 import Prims
 import ProtocolDispatch
 import ProtocolDispatch2
+import ProtocolModel
 import RC4
 import RGBHistogram
 import RangeAssignment
@@ -89,6 +96,7 @@ import SevenBoom
 import Sim2DArray
 import SortLettersInPlace
 import SortStrings
+import StableSort
 import StackPromo
 import StaticArray
 import StrComplexWalk
@@ -107,6 +115,7 @@ import XorLoop
 precommitTests = [
   "AngryPhonebook": run_AngryPhonebook,
   "AnyHashableWithAClass": run_AnyHashableWithAClass,
+  "AnyHashableWithScalars": run_AnyHashableWithScalars,
   "Array2D": run_Array2D,
   "ArrayAppend": run_ArrayAppend,
   "ArrayAppendReserved": run_ArrayAppendReserved,
@@ -134,7 +143,38 @@ precommitTests = [
   "CaptureProp": run_CaptureProp,
   "Chars": run_Chars,
   "ClassArrayGetter": run_ClassArrayGetter,
+  "ConcurrentDictionary_T1": run_ConcurrentDictionary_T1,
+  "ConcurrentDictionary_T16": run_ConcurrentDictionary_T16,
+  "ConcurrentDictionary_T2": run_ConcurrentDictionary_T2,
+  "ConcurrentDictionary_T32": run_ConcurrentDictionary_T32,
+  "ConcurrentDictionary_T4": run_ConcurrentDictionary_T4,
+  "ConcurrentDictionary_T64": run_ConcurrentDictionary_T64,
+  "ConcurrentDictionary_T8": run_ConcurrentDictionary_T8,
+  "ConcurrentGenericMetadata_T1": run_ConcurrentGenericMetadata_T1,
+  "ConcurrentGenericMetadata_T16": run_ConcurrentGenericMetadata_T16,
+  "ConcurrentGenericMetadata_T2": run_ConcurrentGenericMetadata_T2,
+  "ConcurrentGenericMetadata_T32": run_ConcurrentGenericMetadata_T32,
+  "ConcurrentGenericMetadata_T4": run_ConcurrentGenericMetadata_T4,
+  "ConcurrentGenericMetadata_T64": run_ConcurrentGenericMetadata_T64,
+  "ConcurrentGenericMetadata_T8": run_ConcurrentGenericMetadata_T8,
+  "ConcurrentProtocolCast_T1": run_ConcurrentProtocolCast_T1,
+  "ConcurrentProtocolCast_T16": run_ConcurrentProtocolCast_T16,
+  "ConcurrentProtocolCast_T2": run_ConcurrentProtocolCast_T2,
+  "ConcurrentProtocolCast_T32": run_ConcurrentProtocolCast_T32,
+  "ConcurrentProtocolCast_T4": run_ConcurrentProtocolCast_T4,
+  "ConcurrentProtocolCast_T64": run_ConcurrentProtocolCast_T64,
+  "ConcurrentProtocolCast_T8": run_ConcurrentProtocolCast_T8,
+  "ConcurrentRetainRelease_T1": run_ConcurrentRetainRelease_T1,
+  "ConcurrentRetainRelease_T16": run_ConcurrentRetainRelease_T16,
+  "ConcurrentRetainRelease_T2": run_ConcurrentRetainRelease_T2,
+  "ConcurrentRetainRelease_T32": run_ConcurrentRetainRelease_T32,
+  "ConcurrentRetainRelease_T4": run_ConcurrentRetainRelease_T4,
+  "ConcurrentRetainRelease_T64": run_ConcurrentRetainRelease_T64,
+  "ConcurrentRetainRelease_T8": run_ConcurrentRetainRelease_T8,
   "DeadArray": run_DeadArray,
+  "DequeBothEnds": run_DequeBothEnds,
+  "DequeBreadthFirst": run_DequeBreadthFirst,
+  "DequePopFront": run_DequePopFront,
   "Dictionary": run_Dictionary,
   "Dictionary2": run_Dictionary2,
   "Dictionary2OfObjects": run_Dictionary2OfObjects,
@@ -149,13 +189,17 @@ precommitTests = [
   "DictionarySwapOfObjects": run_DictionarySwapOfObjects,
   "ErrorHandling": run_ErrorHandling,
   "GlobalClass": run_GlobalClass,
+  "GraphAlgorithms": run_GraphAlgorithms,
+  "HTTPParsing": run_HTTPParsing,
   "Hanoi": run_Hanoi,
   "HashTest": run_HashTest,
   "Histogram": run_Histogram,
   "Integrate": run_Integrate,
   "IterateData": run_IterateData,
+  "JSONCoding": run_JSONCoding,
   "Join": run_Join,
   "LinkedList": run_LinkedList,
+  "LogAggregation": run_LogAggregation,
   "MapReduce": run_MapReduce,
   "Memset": run_Memset,
   "MonteCarloE": run_MonteCarloE,
@@ -214,6 +258,7 @@ precommitTests = [
   "Prims": run_Prims,
   "ProtocolDispatch": run_ProtocolDispatch,
   "ProtocolDispatch2": run_ProtocolDispatch2,
+  "ProtocolModel": run_ProtocolModel,
   "RC4": run_RC4,
   "RGBHistogram": run_RGBHistogram,
   "RGBHistogramOfObjects": run_RGBHistogramOfObjects,
@@ -232,6 +277,8 @@ precommitTests = [
   "SortLettersInPlace": run_SortLettersInPlace,
   "SortStrings": run_SortStrings,
   "SortStringsUnicode": run_SortStringsUnicode,
+  "StableSortNearlySorted": run_StableSortNearlySorted,
+  "StableSortRandom": run_StableSortRandom,
   "StackPromo": run_StackPromo,
   "StaticArray": run_StaticArray,
   "StrComplexWalk": run_StrComplexWalk,
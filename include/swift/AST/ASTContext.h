@@ -86,6 +86,7 @@ namespace swift {
   class DiagnosticEngine;
   class Substitution;
   class TypeCheckerDebugConsumer;
+  class UnifiedStatsReporter;
   class DocComment;
   class SILBoxType;
 
@@ -188,6 +189,9 @@ public:
   /// Diags - The diagnostics engine.
   DiagnosticEngine &Diags;
 
+  /// If non-null, the reporter for always-on compiler statistics.
+  UnifiedStatsReporter *Stats = nullptr;
+
   /// The set of top-level modules we have loaded.
   /// This map is used for iteration, therefore it's a MapVector and not a
   /// DenseMap.
@@ -2675,6 +2675,14 @@ class NominalTypeDecl : public GenericTypeDecl, public IterableDeclContext {
   /// Prepare the lookup table to make it ready for lookups.
   void prepareLookupTable(bool ignoreNewExtensions);
 
+  /// Make sure the lookup table has every member of this type and its
+  /// extensions with the given base name, deserializing only those members
+  /// if possible.
+  ///
+  /// \returns false if the members couldn't be loaded by name, in which case
+  /// the full lookup table has to be prepared instead.
+  bool prepareLookupTableForName(Identifier name);
+
   /// Note that we have added a member into the iterable declaration context,
   /// so that it can also be added to the lookup table (if needed).
   void addedMember(Decl *member);
@@ -625,6 +625,17 @@ public:
   /// Load all of the members of this context.
   void loadAllMembers() const;
 
+  /// Load only the members of this context whose base name is \p name,
+  /// appending them to \p members.
+  ///
+  /// The members are not added to this context. This may only be called
+  /// when the context has lazily-loaded members.
+  ///
+  /// \returns false if the members can't be loaded by name, in which case
+  /// the caller should fall back to loadAllMembers().
+  bool loadNamedMembers(Identifier name,
+                        SmallVectorImpl<ValueDecl *> &members) const;
+
   // Some Decls are IterableDeclContexts, but not all.
   static bool classof(const Decl *D);
 
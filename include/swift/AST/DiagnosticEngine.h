@@ -393,6 +393,7 @@ namespace swift {
       Unspecified,
       Ignore,
       Note,
+      Remark,
       Warning,
       Error,
       Fatal,
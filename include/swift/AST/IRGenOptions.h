@@ -65,6 +65,12 @@ public:
   /// The name of the first input file, used by the debug info.
   std::string MainInputFilename;
   std::vector<std::string> OutputFilenames;
+
+  /// Additional object files for the partitions of the LLVM module, if code
+  /// generation of a single output file should be split up and run in
+  /// parallel.
+  std::vector<std::string> CodeGenPartitionOutputs;
+
   std::string ModuleName;
 
   /// The compilation directory for the debug info.
@@ -125,6 +131,17 @@ public:
   /// (includes alloc_stack allocations).
   unsigned StackPromotionSizeLimit = 1024;
 
+  /// The minimum number of values in the explosion of a non-trivial struct or
+  /// tuple for its copies and destroys to be emitted as calls to shared helper
+  /// functions. Multi-payload enums are always outlined. Zero disables
+  /// outlining.
+  unsigned OutlineCopySizeThreshold = 8;
+
+  /// The maximum estimated cost of a loop-invariant type metadata or witness
+  /// table request that is moved to the entry block of a function, so that it
+  /// is made once instead of on every loop iteration. Zero disables hoisting.
+  unsigned TypeDataHoistingCostLimit = 8;
+
   /// Emit code to verify that static and runtime type layout are consistent for
   /// the given type names.
   SmallVector<StringRef, 1> VerifyTypeLayoutNames;
@@ -135,6 +152,9 @@ public:
   /// Instrument code to generate profiling information.
   unsigned GenerateProfile : 1;
 
+  /// Set profile counters to 1 instead of incrementing them.
+  unsigned ProfileFirstHit : 1;
+
   /// Print the LLVM inline tree at the end of the LLVM pass pipeline.
   unsigned PrintInlineTree : 1;
 
@@ -151,6 +171,14 @@ public:
   /// Emit names of struct stored properties and enum cases.
   unsigned EnableReflectionNames : 1;
 
+  /// Lay out the fields of structs that are only visible in this module
+  /// by decreasing alignment instead of in declaration order.
+  unsigned EnableStructFieldReordering : 1;
+
+  /// Have the entry point instantiate the metadata of the specialized generic
+  /// types the module uses on a background thread.
+  unsigned WarmGenericMetadata : 1;
+
   /// Should we try to build incrementally by not emitting an object file if it
   /// has the same IR hash as the module that we are preparing to emit?
   ///
@@ -174,9 +202,11 @@ public:
         DisableLLVMOptzns(false), DisableLLVMARCOpts(false),
         DisableLLVMSLPVectorizer(false), DisableFPElim(true), Playground(false),
         EmitStackPromotionChecks(false), GenerateProfile(false),
-        PrintInlineTree(false), EmbedMode(IRGenEmbedMode::None),
+        ProfileFirstHit(false), PrintInlineTree(false),
+        EmbedMode(IRGenEmbedMode::None),
         HasValueNamesSetting(false), ValueNames(false),
         EnableReflectionMetadata(true), EnableReflectionNames(true),
+        EnableStructFieldReordering(false), WarmGenericMetadata(false),
         UseIncrementalLLVMCodeGen(true), UseSwiftCall(false), CmdArgs(),
         SanitizeCoverage(llvm::SanitizerCoverageOptions()) {}
 
@@ -246,6 +246,20 @@ public:
     llvm_unreachable("unimplemented");
   }
 
+  /// Populates \p Members with the members of \p D whose base name is
+  /// \p N, without loading the rest.
+  ///
+  /// Unlike loadAllMembers, the implementation should \em not add the
+  /// members to \p D.
+  ///
+  /// \returns false if the loader can't load a subset of the members, in
+  /// which case the caller should load all of them instead.
+  virtual bool
+  loadNamedMembers(const Decl *D, Identifier N, uint64_t contextData,
+                   SmallVectorImpl<ValueDecl *> &Members) {
+    return false;
+  }
+
   /// Populates the given vector with all conformances for \p D.
   ///
   /// The implementation should \em not call setConformances on \p D.
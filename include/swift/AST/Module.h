@@ -787,6 +787,14 @@ private:
   /// This is filled in by the Name Binding phase.
   ArrayRef<std::pair<ModuleDecl::ImportedModule, ImportOptions>> Imports;
 
+  /// Module-scope results of unqualified lookups made from this file, keyed
+  /// by name and lookup flags.
+  mutable llvm::DenseMap<std::pair<DeclName, unsigned>,
+                         TinyPtrVector<ValueDecl *>> UnqualifiedLookups;
+
+  /// The ASTContext generation at which \c UnqualifiedLookups was filled in.
+  mutable unsigned UnqualifiedLookupsGeneration = 0;
+
   /// A unique identifier representing this file; used to mark private decls
   /// within the file to keep them from conflicting with other files in the
   /// same module.
@@ -882,8 +890,22 @@ public:
 
   bool hasTestableImport(const ModuleDecl *module) const;
 
+  /// Drops this file's lookup tables, along with any cached unqualified
+  /// lookups made from any file in the same module.
   void clearLookupCache();
 
+  /// Returns the cached module-scope results of an unqualified lookup of
+  /// \p name from this file, or null if there are none.
+  ///
+  /// Cached results are dropped when a file in the module is re-bound and
+  /// when a module import bumps the ASTContext's generation.
+  const TinyPtrVector<ValueDecl *> *
+  getCachedUnqualifiedLookup(DeclName name, unsigned flags) const;
+
+  /// Records the module-scope results of an unqualified lookup of \p name.
+  void cacheUnqualifiedLookup(DeclName name, unsigned flags,
+                              ArrayRef<ValueDecl *> results) const;
+
   void cacheVisibleDecls(SmallVectorImpl<ValueDecl *> &&globals) const;
   const SmallVectorImpl<ValueDecl *> &getCachedVisibleDecls() const;
 
@@ -1045,7 +1067,7 @@ public:
     InterfaceHash.update(a);
   }
 
-  const llvm::MD5 &getInterfaceHashState() { return InterfaceHash; }
+  const llvm::MD5 &getInterfaceHashState() const { return InterfaceHash; }
   void setInterfaceHashState(const llvm::MD5 &state) { InterfaceHash = state; }
 
   void getInterfaceHash(llvm::SmallString<32> &str) {
@@ -19,8 +19,10 @@
 #define SWIFT_AST_SILOPTIONS_H
 
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Regex.h"
 #include <string>
 #include <climits>
+#include <memory>
 
 namespace swift {
 
@@ -47,6 +49,7 @@ public:
   enum class SILOptMode: unsigned {
     NotSet,
     None,
+    /// -Odebug: only optimizations which preserve debug info.
     Debug,
     Optimize,
     OptimizeUnchecked
@@ -72,12 +75,20 @@ public:
   /// Are we debugging sil serialization.
   bool DebugSerialization = false;
 
+  /// Serialize the bodies of public generic functions, and what they depend
+  /// on, so that clients can specialize and inline them.
+  bool CrossModuleOptimization = false;
+
   /// Whether to dump verbose SIL with scope and location information.
   bool EmitVerboseSIL = false;
 
   /// Optimization mode being used.
   SILOptMode Optimization = SILOptMode::NotSet;
 
+  /// Prefer smaller code over faster code where the two conflict (-Osize).
+  /// Only meaningful together with an optimizing mode.
+  bool OptimizeForSize = false;
+
   enum AssertConfiguration: unsigned {
     // Used by standard library code to distinguish between a debug and release
     // build.
@@ -101,6 +112,10 @@ public:
   /// Emit a mapping of profile counters for use in coverage.
   bool EmitProfileCoverageMapping = false;
 
+  /// The path of an indexed profile (as produced by llvm-profdata) whose
+  /// execution counts should guide optimization. Empty if there is none.
+  std::string UseProfile;
+
   /// Should we use a pass pipeline passed in via a json file? Null by default.
   llvm::StringRef ExternalPassPipelineFilename;
   
@@ -122,6 +137,18 @@ public:
 
   /// Assume that code will be executed in a single-threaded environment.
   bool AssumeSingleThreaded = false;
+
+  /// Emit remarks for the optimizations performed by the passes whose name
+  /// matches this pattern (-Rpass=). Null if none are emitted.
+  std::shared_ptr<llvm::Regex> OptRemarkPassedPattern;
+
+  /// Emit remarks for the optimizations missed by the passes whose name
+  /// matches this pattern (-Rpass-missed=). Null if none are emitted.
+  std::shared_ptr<llvm::Regex> OptRemarkMissedPattern;
+
+  /// The file into which all optimization remarks are recorded as YAML, or
+  /// empty if they are not recorded.
+  std::string OptRecordFile;
 };
 
 } // end namespace swift
@@ -1489,10 +1489,24 @@ inline CanType getCanTupleEltType(const TupleTypeElt &elt) {
 typedef ArrayRefView<TupleTypeElt,CanType,getCanTupleEltType>
   CanTupleEltTypeArrayRef;
 
+/// A node in one of the ASTContext's structural type uniquing tables that
+/// remembers the hash of its profile.
+///
+/// Lookups can then reject the other nodes of a bucket by comparing hashes
+/// instead of re-profiling each of them, and growing a table never
+/// re-profiles anything.
+class HashedFoldingSetNode : public llvm::FoldingSetNode {
+  unsigned ProfileHash = 0;
+
+public:
+  unsigned getProfileHash() const { return ProfileHash; }
+  void setProfileHash(unsigned hash) { ProfileHash = hash; }
+};
+
 /// TupleType - A tuple is a parenthesized list of types where each name has an
 /// optional name.
 ///
-class TupleType : public TypeBase, public llvm::FoldingSetNode {
+class TupleType : public TypeBase, public HashedFoldingSetNode {
   const ArrayRef<TupleTypeElt> Elements;
   
 public:
@@ -1614,7 +1628,7 @@ typedef ArrayRefView<Type,CanType,getAsCanType> CanTypeArrayRef;
 
 /// BoundGenericType - An abstract class for applying a generic type to the
 /// given type arguments.
-class BoundGenericType : public TypeBase, public llvm::FoldingSetNode {
+class BoundGenericType : public TypeBase, public HashedFoldingSetNode {
   NominalTypeDecl *TheDecl;
 
   /// \brief The type of the parent, in which this type is nested.
@@ -2546,7 +2560,7 @@ std::string getParamListAsString(ArrayRef<CallArgParam> parameters);
 /// output types of the generic function can be expressed in terms of those
 /// generic parameters.
 class GenericFunctionType : public AnyFunctionType,
-                            public llvm::FoldingSetNode
+                            public HashedFoldingSetNode
 {
   GenericSignature *Signature;
 
@@ -3605,7 +3619,7 @@ END_CAN_TYPE_WRAPPER(ProtocolType, NominalType)
 /// inheritance) protocol list. If the sorted, minimized list is a single
 /// protocol, then the canonical type is that protocol type. Otherwise, it is
 /// a composition of the protocols in that list.
-class ProtocolCompositionType : public TypeBase, public llvm::FoldingSetNode {
+class ProtocolCompositionType : public TypeBase, public HashedFoldingSetNode {
   ArrayRef<Type> Protocols;
   
 public:
@@ -4555,6 +4569,36 @@ struct DenseMapInfo<swift::BuiltinIntegerWidth> {
   }
 };
 
+/// FoldingSet trait for HashedFoldingSetNodes, which compares the remembered
+/// profile hash before re-profiling a node.
+template<typename T>
+struct HashedFoldingSetTrait : DefaultFoldingSetTrait<T> {
+  static bool Equals(T &X, const FoldingSetNodeID &ID, unsigned IDHash,
+                     FoldingSetNodeID &TempID) {
+    if (X.getProfileHash() != IDHash)
+      return false;
+    X.Profile(TempID);
+    return TempID == ID;
+  }
+
+  static unsigned ComputeHash(T &X, FoldingSetNodeID &TempID) {
+    return X.getProfileHash();
+  }
+};
+
+template<>
+struct FoldingSetTrait<swift::TupleType>
+  : HashedFoldingSetTrait<swift::TupleType> {};
+template<>
+struct FoldingSetTrait<swift::BoundGenericType>
+  : HashedFoldingSetTrait<swift::BoundGenericType> {};
+template<>
+struct FoldingSetTrait<swift::GenericFunctionType>
+  : HashedFoldingSetTrait<swift::GenericFunctionType> {};
+template<>
+struct FoldingSetTrait<swift::ProtocolCompositionType>
+  : HashedFoldingSetTrait<swift::ProtocolCompositionType> {};
+
 
 }
   
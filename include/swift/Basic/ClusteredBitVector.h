@@ -599,6 +599,10 @@ public:
     return !(lhs == rhs);
   }
 
+  /// Return the bits [start, start + numBits) of this vector as a new
+  /// vector.
+  ClusteredBitVector getSlice(size_t start, size_t numBits) const;
+
   /// Return this bit-vector as an APInt, with low indices becoming
   /// the least significant bits of the number.
   llvm::APInt asAPInt() const;
@@ -13,7 +13,9 @@
 #ifndef SWIFT_BASIC_DEMANGLE_H
 #define SWIFT_BASIC_DEMANGLE_H
 
+#include <algorithm>
 #include <memory>
+#include <new>
 #include <string>
 #include <vector>
 #include <cassert>
@@ -69,7 +71,11 @@ struct DemangleOptions {
 };
 
 class Node;
-typedef std::shared_ptr<Node> NodePointer;
+class NodeFactory;
+
+/// Nodes are owned by the NodeFactory which created them. A NodePointer is
+/// only valid as long as its factory is alive and has not been cleared.
+typedef Node *NodePointer;
 
 enum class FunctionSigSpecializationParamKind : unsigned {
   // Option Flags use bits 0-5. This give us 6 bits implying 64 entries to
@@ -117,7 +123,12 @@ enum class Directness {
   Direct, Indirect
 };
 
-class Node : public std::enable_shared_from_this<Node> {
+/// A node of a demangle tree.
+///
+/// Nodes are allocated by a NodeFactory, together with their text and their
+/// children arrays, and are trivially destructible: a tree is freed all at
+/// once by destroying or clearing its factory.
+class Node {
 public:
   enum class Kind : uint16_t {
 #define NODE(ID) ID,
@@ -127,6 +138,10 @@ public:
   typedef uint64_t IndexType;
 
 private:
+  /// The number of children which fit into the node itself. Most nodes have
+  /// at most two children, so adding them doesn't allocate.
+  enum { NumInlineChildren = 2 };
+
   Kind NodeKind;
 
   enum class PayloadKind : uint8_t {
@@ -134,40 +149,48 @@ private:
   };
   PayloadKind NodePayloadKind;
 
+  uint32_t NumChildren = 0;
+  uint32_t ChildrenCapacity = NumInlineChildren;
+
   union {
-    std::string TextPayload;
+    struct {
+      const char *Data;
+      size_t Length;
+    } TextPayload;
     IndexType IndexPayload;
   };
 
-  // FIXME: use allocator.
-  typedef std::vector<NodePointer> NodeVector;
-  NodeVector Children;
+  /// The factory which allocated this node, and which allocates its children
+  /// array once it outgrows InlineChildren.
+  NodeFactory *Factory;
 
-  Node(Kind k)
-      : NodeKind(k), NodePayloadKind(PayloadKind::None) {
+  NodePointer *Children = InlineChildren;
+  NodePointer InlineChildren[NumInlineChildren];
+
+  Node(NodeFactory &Factory, Kind k)
+      : NodeKind(k), NodePayloadKind(PayloadKind::None), Factory(&Factory) {
   }
-  Node(Kind k, std::string &&t)
-      : NodeKind(k), NodePayloadKind(PayloadKind::Text) {
-    new (&TextPayload) std::string(std::move(t));
+  Node(NodeFactory &Factory, Kind k, llvm::StringRef t)
+      : NodeKind(k), NodePayloadKind(PayloadKind::Text), Factory(&Factory) {
+    TextPayload.Data = t.data();
+    TextPayload.Length = t.size();
   }
-  Node(Kind k, IndexType index)
-      : NodeKind(k), NodePayloadKind(PayloadKind::Index) {
+  Node(NodeFactory &Factory, Kind k, IndexType index)
+      : NodeKind(k), NodePayloadKind(PayloadKind::Index), Factory(&Factory) {
     IndexPayload = index;
   }
   Node(const Node &) = delete;
   Node &operator=(const Node &) = delete;
 
-  friend struct NodeFactory;
+  friend class NodeFactory;
 
 public:
-  ~Node();
-
   Kind getKind() const { return NodeKind; }
 
   bool hasText() const { return NodePayloadKind == PayloadKind::Text; }
-  const std::string &getText() const {
+  llvm::StringRef getText() const {
     assert(hasText());
-    return TextPayload;
+    return llvm::StringRef(TextPayload.Data, TextPayload.Length);
   }
 
   bool hasIndex() const { return NodePayloadKind == PayloadKind::Index; }
@@ -175,47 +198,135 @@ public:
     assert(hasIndex());
     return IndexPayload;
   }
-  
-  typedef NodeVector::iterator iterator;
-  typedef NodeVector::const_iterator const_iterator;
-  typedef NodeVector::size_type size_type;
 
-  bool hasChildren() const { return !Children.empty(); }
-  size_t getNumChildren() const { return Children.size(); }
-  iterator begin() { return Children.begin(); }
-  iterator end() { return Children.end(); }
-  const_iterator begin() const { return Children.begin(); }
-  const_iterator end() const { return Children.end(); }
+  /// Returns the factory which owns this node.
+  NodeFactory &getFactory() const { return *Factory; }
 
-  NodePointer getFirstChild() const { return Children.front(); }
-  NodePointer getChild(size_t index) const { return Children[index]; }
+  typedef NodePointer *iterator;
+  typedef const NodePointer *const_iterator;
+  typedef size_t size_type;
+
+  bool hasChildren() const { return NumChildren != 0; }
+  size_t getNumChildren() const { return NumChildren; }
+  iterator begin() { return Children; }
+  iterator end() { return Children + NumChildren; }
+  const_iterator begin() const { return Children; }
+  const_iterator end() const { return Children + NumChildren; }
+
+  NodePointer getFirstChild() const {
+    assert(NumChildren > 0);
+    return Children[0];
+  }
+  NodePointer getChild(size_t index) const {
+    assert(index < NumChildren);
+    return Children[index];
+  }
 
   /// Add a new node as a child of this one.
   ///
+  /// The child must stay alive as long as this node, i.e. it should come
+  /// from the same factory.
+  ///
   /// \param child - should have no parent or siblings
   /// \returns child
-  NodePointer addChild(NodePointer child) {
-    assert(child && "adding null child!");
-    Children.push_back(child);
-    return child;
-  }
+  inline NodePointer addChild(NodePointer child);
 
   /// A convenience method for adding two children at once.
   void addChildren(NodePointer child1, NodePointer child2) {
-    addChild(std::move(child1));
-    addChild(std::move(child2));
+    addChild(child1);
+    addChild(child2);
+  }
+};
+
+/// Allocates the nodes of demangle trees.
+///
+/// Memory is carved out of large slabs, which are only freed when the
+/// factory is destroyed or cleared, so creating a node is a pointer bump
+/// rather than a heap allocation and freeing a tree costs nothing.
+class NodeFactory {
+  /// The header of a slab. The memory of the slab follows it.
+  struct Slab {
+    Slab *Previous;
+    size_t Size;
+  };
+
+  enum : size_t {
+    InitialSlabSize = 4096,
+    MaxSlabSize = 1024 * 1024
+  };
+
+  Slab *CurrentSlab = nullptr;
+  char *CurPtr = nullptr;
+  char *End = nullptr;
+  size_t NextSlabSize = InitialSlabSize;
+
+  void *allocateInNewSlab(size_t Size, size_t Alignment);
+
+public:
+  NodeFactory() = default;
+  NodeFactory(const NodeFactory &) = delete;
+  NodeFactory &operator=(const NodeFactory &) = delete;
+  ~NodeFactory();
+
+  /// Frees all nodes which were created by this factory.
+  ///
+  /// The memory of the most recent slab is kept for reuse, so a factory
+  /// which is cleared after each demangling settles on a single slab.
+  void clear();
+
+  /// Allocates \p Size bytes which live as long as the factory.
+  void *allocate(size_t Size, size_t Alignment) {
+    uintptr_t Aligned =
+        (uintptr_t(CurPtr) + Alignment - 1) & ~uintptr_t(Alignment - 1);
+    if (CurPtr && Aligned + Size <= uintptr_t(End)) {
+      CurPtr = reinterpret_cast<char *>(Aligned + Size);
+      return reinterpret_cast<void *>(Aligned);
+    }
+    return allocateInNewSlab(Size, Alignment);
+  }
+
+  template <typename T> T *allocate(size_t NumObjects = 1) {
+    return static_cast<T *>(allocate(sizeof(T) * NumObjects, alignof(T)));
+  }
+
+  /// Copies \p Text into memory owned by the factory.
+  llvm::StringRef copyString(llvm::StringRef Text);
+
+  NodePointer create(Node::Kind K) {
+    return new (allocate<Node>()) Node(*this, K);
+  }
+  NodePointer create(Node::Kind K, Node::IndexType Index) {
+    return new (allocate<Node>()) Node(*this, K, Index);
+  }
+  NodePointer create(Node::Kind K, llvm::StringRef Text) {
+    return new (allocate<Node>()) Node(*this, K, copyString(Text));
   }
 };
 
+inline NodePointer Node::addChild(NodePointer child) {
+  assert(child && "adding null child!");
+  if (NumChildren == ChildrenCapacity) {
+    uint32_t NewCapacity = ChildrenCapacity * 2;
+    NodePointer *NewChildren = Factory->allocate<NodePointer>(NewCapacity);
+    std::copy(Children, Children + NumChildren, NewChildren);
+    Children = NewChildren;
+    ChildrenCapacity = NewCapacity;
+  }
+  Children[NumChildren++] = child;
+  return child;
+}
+
 /// \brief Demangle the given string as a Swift symbol.
 ///
 /// Typical usage:
 /// \code
+///   NodeFactory Factory;
 ///   NodePointer aDemangledName =
-/// swift::Demangler::demangleSymbolAsNode("SomeSwiftMangledName")
+/// swift::Demangle::demangleSymbolAsNode("SomeSwiftMangledName", Factory)
 /// \endcode
 ///
 /// \param mangledName The mangled string.
+/// \param Factory The factory which allocates the nodes of the tree.
 /// \param options An object encapsulating options to use to perform this demangling.
 ///
 ///
@@ -224,12 +335,14 @@ public:
 ///
 NodePointer
 demangleSymbolAsNode(const char *mangledName, size_t mangledNameLength,
+                     NodeFactory &Factory,
                      const DemangleOptions &options = DemangleOptions());
 
 inline NodePointer
-demangleSymbolAsNode(const std::string &mangledName,
+demangleSymbolAsNode(llvm::StringRef mangledName, NodeFactory &Factory,
                      const DemangleOptions &options = DemangleOptions()) {
-  return demangleSymbolAsNode(mangledName.data(), mangledName.size(), options);
+  return demangleSymbolAsNode(mangledName.data(), mangledName.size(), Factory,
+                              options);
 }
 
 /// \brief Demangle the given string as a Swift symbol.
@@ -261,11 +374,13 @@ demangleSymbolAsString(const std::string &mangledName,
 ///
 /// Typical usage:
 /// \code
+///   NodeFactory Factory;
 ///   NodePointer aDemangledName =
-/// swift::Demangler::demangleTypeAsNode("SomeSwiftMangledName")
+/// swift::Demangle::demangleTypeAsNode("SomeSwiftMangledName", Factory)
 /// \endcode
 ///
 /// \param mangledName The mangled string.
+/// \param Factory The factory which allocates the nodes of the tree.
 /// \param options An object encapsulating options to use to perform this demangling.
 ///
 ///
@@ -274,12 +389,14 @@ demangleSymbolAsString(const std::string &mangledName,
 ///
 NodePointer
 demangleTypeAsNode(const char *mangledName, size_t mangledNameLength,
+                   NodeFactory &Factory,
                    const DemangleOptions &options = DemangleOptions());
 
 inline NodePointer
-demangleTypeAsNode(const std::string &mangledName,
+demangleTypeAsNode(llvm::StringRef mangledName, NodeFactory &Factory,
                    const DemangleOptions &options = DemangleOptions()) {
-  return demangleTypeAsNode(mangledName.data(), mangledName.size(), options);
+  return demangleTypeAsNode(mangledName.data(), mangledName.size(), Factory,
+                            options);
 }
 
 /// \brief Demangle the given string as a Swift type mangling.
@@ -340,23 +457,41 @@ inline std::string mangleNode(const NodePointer &root, bool NewMangling) {
 std::string nodeToString(NodePointer Root,
                          const DemangleOptions &Options = DemangleOptions());
 
-struct NodeFactory {
-  static NodePointer create(Node::Kind K) {
-    return NodePointer(new Node(K));
-  }
-  static NodePointer create(Node::Kind K, Node::IndexType Index) {
-    return NodePointer(new Node(K, Index));
-  }
-  static NodePointer create(Node::Kind K, llvm::StringRef Text) {
-    return NodePointer(new Node(K, Text));
-  }
-  static NodePointer create(Node::Kind K, std::string &&Text) {
-    return NodePointer(new Node(K, std::move(Text)));
-  }
-  template <size_t N>
-  static NodePointer create(Node::Kind K, const char (&Text)[N]) {
-    return NodePointer(new Node(K, llvm::StringRef(Text)));
-  }
+/// Owns the nodes of the demangle trees it returns.
+///
+/// This is the convenient way to demangle a name and inspect the tree: the
+/// trees stay valid until the context is cleared or destroyed. Clients which
+/// demangle many names should reuse one context and clear it in between.
+class Context {
+  NodeFactory Factory;
+
+public:
+  Context() = default;
+
+  NodeFactory &getFactory() { return Factory; }
+
+  /// Frees all trees which were returned by this context.
+  void clear() { Factory.clear(); }
+
+  /// Demangle the given symbol and return the parse tree, or a null pointer
+  /// on failure.
+  NodePointer demangleSymbolAsNode(llvm::StringRef MangledName,
+                          const DemangleOptions &Options = DemangleOptions());
+
+  /// Demangle the given type and return the parse tree, or a null pointer
+  /// on failure.
+  NodePointer demangleTypeAsNode(llvm::StringRef MangledName,
+                          const DemangleOptions &Options = DemangleOptions());
+
+  /// Demangle the given symbol and return the readable name, or the mangled
+  /// name itself on failure.
+  std::string demangleSymbolAsString(llvm::StringRef MangledName,
+                          const DemangleOptions &Options = DemangleOptions());
+
+  /// Demangle the given type and return the readable name, or the mangled
+  /// name itself on failure.
+  std::string demangleTypeAsString(llvm::StringRef MangledName,
+                          const DemangleOptions &Options = DemangleOptions());
 };
 
   /// A class for printing to a std::string.
@@ -406,7 +541,7 @@ private:
 
 bool mangleStandardSubstitution(Node *node, DemanglerPrinter &Out);
 bool isSpecialized(Node *node);
-NodePointer getUnspecialized(Node *node);
+NodePointer getUnspecialized(Node *node, NodeFactory &Factory);
 
 /// Is a character considered a digit by the demangling grammar?
 ///
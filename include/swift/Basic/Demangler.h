@@ -25,6 +25,7 @@ namespace NewMangling {
 class Demangler {
   StringRef Text;
   size_t Pos;
+  NodeFactory &Factory;
 
   struct NodeWithPos {
     NodePointer Node;
@@ -110,7 +111,8 @@ class Demangler {
   }
 
 public:
-  Demangler(llvm::StringRef mangled) : Text(mangled), Pos(0) {}
+  Demangler(llvm::StringRef mangled, NodeFactory &Factory)
+    : Text(mangled), Pos(0), Factory(Factory) {}
 
   NodePointer demangleTopLevel();
 
@@ -128,34 +130,34 @@ private:
     return Parent;
   }
 
-  static NodePointer createWithChild(Node::Kind kind, NodePointer Child) {
+  NodePointer createWithChild(Node::Kind kind, NodePointer Child) {
     if (!Child)
       return nullptr;
-    NodePointer Nd = NodeFactory::create(kind);
+    NodePointer Nd = Factory.create(kind);
     Nd->addChild(Child);
     return Nd;
   }
 
-  static NodePointer createType(NodePointer Child) {
+  NodePointer createType(NodePointer Child) {
     return createWithChild(Node::Kind::Type, Child);
   }
   
-  static NodePointer createWithChildren(Node::Kind kind, NodePointer Child1,
-                                        NodePointer Child2) {
+  NodePointer createWithChildren(Node::Kind kind, NodePointer Child1,
+                                 NodePointer Child2) {
     if (!Child1 || !Child2)
       return nullptr;
-    NodePointer Nd = NodeFactory::create(kind);
+    NodePointer Nd = Factory.create(kind);
     Nd->addChild(Child1);
     Nd->addChild(Child2);
     return Nd;
   }
 
-  static NodePointer createWithChildren(Node::Kind kind, NodePointer Child1,
-                                        NodePointer Child2,
-                                        NodePointer Child3) {
+  NodePointer createWithChildren(Node::Kind kind, NodePointer Child1,
+                                 NodePointer Child2,
+                                 NodePointer Child3) {
     if (!Child1 || !Child2 || !Child3)
       return nullptr;
-    NodePointer Nd = NodeFactory::create(kind);
+    NodePointer Nd = Factory.create(kind);
     Nd->addChild(Child1);
     Nd->addChild(Child2);
     Nd->addChild(Child3);
@@ -177,7 +179,7 @@ private:
   NodePointer demangleOperatorIdentifier();
 
   NodePointer demangleMultiSubstitutions();
-  static NodePointer createSwiftType(Node::Kind typeKind, StringRef name);
+  NodePointer createSwiftType(Node::Kind typeKind, StringRef name);
   NodePointer demangleKnownType();
   NodePointer demangleLocalIdentifier();
 
@@ -202,13 +204,13 @@ private:
   NodePointer demangleImplResultConvention(Node::Kind ConvKind);
   NodePointer demangleImplFunctionType();
   NodePointer demangleMetatype();
-  static NodePointer createArchetypeRef(int depth, int i);
+  NodePointer createArchetypeRef(int depth, int i);
   NodePointer demangleArchetype();
   NodePointer demangleAssociatedTypeSimple(NodePointer GenericParamIdx);
   NodePointer demangleAssociatedTypeCompound(NodePointer GenericParamIdx);
 
   NodePointer popAssocTypeName();
-  static NodePointer getDependentGenericParamType(int depth, int index);
+  NodePointer getDependentGenericParamType(int depth, int index);
   NodePointer demangleGenericParamIndex();
   NodePointer popProtocolConformance();
   NodePointer demangleThunkOrSpecialization();
@@ -31,6 +31,7 @@ namespace swift {
 enum class DiagnosticKind : uint8_t {
   Error,
   Warning,
+  Remark,
   Note
 };
 
@@ -93,6 +94,13 @@ public:
   virtual void handleDiagnostic(SourceManager &SM, SourceLoc Loc,
                                 DiagnosticKind Kind, StringRef Text,
                                 const DiagnosticInfo &Info) = 0;
+
+  /// \brief Returns true if handleDiagnostic looks at the text of the
+  /// diagnostic.
+  ///
+  /// When no consumer does, the diagnostic engine doesn't format the
+  /// arguments of the diagnostic, and passes empty text instead.
+  virtual bool needsDiagnosticText() const { return true; }
 };
   
 /// \brief DiagnosticConsumer that discards all diagnostics.
@@ -101,6 +109,8 @@ public:
   void handleDiagnostic(SourceManager &SM, SourceLoc Loc,
                         DiagnosticKind Kind, StringRef Text,
                         const DiagnosticInfo &Info) override;
+
+  bool needsDiagnosticText() const override { return false; }
 };
   
 } // end namespace swift
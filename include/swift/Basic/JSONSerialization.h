@@ -566,6 +566,17 @@ jsonize(Output &out, T &Val, bool) {
   }
 }
 
+// Strings don't need to be rendered first, which for large ones, like the
+// output of a job, saves a copy.
+inline void jsonize(Output &out, StringRef &Val, bool) {
+  out.scalarString(Val, ScalarTraits<StringRef>::mustQuote(Val));
+}
+
+inline void jsonize(Output &out, std::string &Val, bool) {
+  StringRef Str = Val;
+  out.scalarString(Str, ScalarTraits<std::string>::mustQuote(Str));
+}
+
 
 template<typename T>
 typename std::enable_if<validatedObjectTraits<T>::value, void>::type
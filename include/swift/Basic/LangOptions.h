@@ -153,6 +153,10 @@ namespace swift {
     /// Should we use \c ASTScope-based resolution for unqualified name lookup?
     bool EnableASTScopeLookup = false;
 
+    /// Should direct lookups into serialized types only deserialize the
+    /// members with the name being looked up?
+    bool NamedLazyMemberLoading = false;
+
     /// Whether to use the import as member inference system
     ///
     /// When importing a global, try to infer whether we can import it as a
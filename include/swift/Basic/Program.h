@@ -33,6 +33,9 @@ namespace swift {
 int ExecuteInPlace(const char *Program, const char **args,
                    const char **env = nullptr);
 
+/// \brief Returns the operating system's identifier for the current process.
+unsigned getCurrentProcessID();
+
 } // end namespace swift
 
 #endif // SWIFT_BASIC_PROGRAM_H
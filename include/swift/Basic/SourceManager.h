@@ -18,6 +18,7 @@
 #include "llvm/ADT/StringMap.h"
 #include "llvm/Support/SourceMgr.h"
 #include <map>
+#include <vector>
 
 namespace swift {
 
@@ -42,6 +43,21 @@ class SourceManager {
   std::map<const char *, VirtualFile> VirtualFiles;
   mutable std::pair<const char *, const VirtualFile*> CachedVFile = {nullptr, nullptr};
 
+  /// The byte offsets at which each line after the first starts, per buffer
+  /// ID, built the first time a line number is requested in that buffer.
+  ///
+  /// llvm::SourceMgr only remembers the last line it found, so diagnostics,
+  /// debug info and coverage, which visit locations out of order, would
+  /// otherwise rescan the buffer from the start for most lookups.
+  mutable std::vector<std::vector<uint32_t>> LineStartOffsets;
+
+  /// The buffer that contained the most recently looked-up location.
+  mutable unsigned LastBufferID = 0U;
+
+  /// Whether any buffer's memory overlaps an earlier buffer's, in which case
+  /// the latest buffer containing a location must be found by searching.
+  bool HasAliasBuffers = false;
+
 public:
   llvm::SourceMgr &getLLVMSourceMgr() {
     return LLVMSourceMgr;
@@ -184,7 +200,7 @@ public:
     assert(Loc.isValid());
     int LineOffset = getLineOffset(Loc);
     int l, c;
-    std::tie(l, c) = LLVMSourceMgr.getLineAndColumn(Loc.Value, BufferID);
+    std::tie(l, c) = findLineAndColumn(Loc, BufferID);
     assert(LineOffset+l > 0 && "bogus line offset");
     return { LineOffset + l, c };
   }
@@ -196,7 +212,7 @@ public:
   /// This does not respect #line directives.
   unsigned getLineNumber(SourceLoc Loc, unsigned BufferID = 0) const {
     assert(Loc.isValid());
-    return LLVMSourceMgr.FindLineNumber(Loc.Value, BufferID);
+    return findLineAndColumn(Loc, BufferID).first;
   }
 
   StringRef extractText(CharSourceRange Range,
@@ -223,6 +239,15 @@ public:
 private:
   const VirtualFile *getVirtualFile(SourceLoc Loc) const;
 
+  /// Returns the real line and column of \p Loc, which must come from
+  /// \p BufferID if it is nonzero.
+  std::pair<unsigned, unsigned> findLineAndColumn(SourceLoc Loc,
+                                                  unsigned BufferID) const;
+
+  /// Returns the line start offsets for \p BufferID, computing them if this
+  /// is the first lookup in the buffer.
+  const std::vector<uint32_t> &getLineStartOffsets(unsigned BufferID) const;
+
   int getLineOffset(SourceLoc Loc) const {
     if (auto VFile = getVirtualFile(Loc))
       return VFile->LineOffset;
@@ -0,0 +1,83 @@
+//===--- SpawnServer.h - Start tasks from a long-lived server ---*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief A spawn server is a long-lived process which starts the tasks of
+/// TaskQueues on their behalf, by forking itself. A task which would run the
+/// server's own executable can then run in the forked child directly, which
+/// inherits everything the server has set up already, instead of starting
+/// and initializing the executable from scratch.
+///
+/// TaskQueues talk to the server over a Unix domain socket. A task's output
+/// still goes to the TaskQueue's pipe, and the server reports the task's
+/// process ID and, once it exits, its wait status.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_BASIC_SPAWNSERVER_H
+#define SWIFT_BASIC_SPAWNSERVER_H
+
+#include "swift/Basic/LLVM.h"
+#include "swift/Basic/TaskQueue.h"
+#include "llvm/ADT/Optional.h"
+
+#include <functional>
+
+namespace swift {
+namespace sys {
+
+/// Runs a task in the forked child of a spawn server, instead of executing
+/// \p ExecPath, and returns its exit code. Returns None if the task should be
+/// executed as usual.
+///
+/// The handler runs with the task's working directory, environment and
+/// output already set up.
+typedef std::function<Optional<int>(StringRef ExecPath,
+                                    ArrayRef<const char *> Args)>
+  SpawnServerHandler;
+
+/// Indicates whether spawn servers are supported on the current system.
+bool supportsSpawnServer();
+
+/// Serves the TaskQueues connecting to the Unix domain socket at
+/// \p SocketPath until the executable at \p ExecutablePath changes, which
+/// would leave the server running an outdated compiler.
+///
+/// Only the user running the server can connect to the socket, and the server
+/// only starts tasks that run \p ExecutablePath. It declines any other task,
+/// which the TaskQueue then starts itself.
+///
+/// \returns the exit code for the server process.
+int runSpawnServer(StringRef SocketPath, StringRef ExecutablePath,
+                   SpawnServerHandler Handler);
+
+/// Asks the spawn server at \p SocketPath to start a task, with its standard
+/// output and error redirected to \p OutputFD.
+///
+/// \param[out] Pid the process ID of the task.
+/// \returns a connection to pass to waitForSpawnedTask, or -1 if there is no
+/// server or it declined to start the task.
+int spawnWithServer(StringRef SocketPath, const char *ExecPath,
+                    ArrayRef<const char *> Args, ArrayRef<const char *> Env,
+                    int OutputFD, ProcessId &Pid);
+
+/// Waits for a task started by spawnWithServer to exit, and closes
+/// \p Connection.
+///
+/// \param[out] Status the wait status of the task, as set by waitpid().
+/// \returns true on error, false on success
+bool waitForSpawnedTask(int Connection, int &Status);
+
+} // end namespace sys
+} // end namespace swift
+
+#endif // SWIFT_BASIC_SPAWNSERVER_H
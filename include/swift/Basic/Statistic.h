@@ -13,7 +13,13 @@
 #ifndef SWIFT_BASIC_STATISTIC_H
 #define SWIFT_BASIC_STATISTIC_H
 
+#include "swift/Basic/LLVM.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Support/TimeValue.h"
 
 #define SWIFT_FUNC_STAT                                                 \
   do {                                                                  \
@@ -22,4 +28,86 @@
     ++FStat;                                                            \
   } while (0)
 
+namespace swift {
+
+/// Collects the counters and phase timings of a single driver or frontend
+/// process, and writes them to a JSON file in a statistics directory when
+/// destroyed.
+///
+/// Unlike LLVM's STATISTIC counters, these are kept in every build of the
+/// compiler, so that release compilers can be measured. Code that updates a
+/// counter should check whether there is a reporter first; e.g.
+///
+/// \code
+///   if (auto *Stats = Ctx.Stats)
+///     ++Stats->getFrontendCounters().NumDeclsDeserialized;
+/// \endcode
+///
+/// The driver's reporter also combines the files written by the frontend
+/// jobs started since the reporter was created into its own file, summing
+/// each counter (or taking the maximum, for counters named "Max...").
+///
+/// \sa Statistics.def
+class UnifiedStatsReporter {
+public:
+  struct AlwaysOnDriverCounters {
+#define DRIVER_STATISTIC(ID) size_t ID = 0;
+#include "swift/Basic/Statistics.def"
+  };
+
+  struct AlwaysOnFrontendCounters {
+#define FRONTEND_STATISTIC(TY, ID) size_t ID = 0;
+#include "swift/Basic/Statistics.def"
+  };
+
+private:
+  SmallString<128> Directory;
+  SmallString<128> Filename;
+  bool IsDriver;
+  llvm::sys::TimeValue StartTime;
+
+  Optional<AlwaysOnDriverCounters> DriverCounters;
+  Optional<AlwaysOnFrontendCounters> FrontendCounters;
+
+  /// Counters whose names are only known at runtime, such as the change in
+  /// instruction count made by each SIL pass.
+  llvm::StringMap<int64_t> NamedCounters;
+
+  /// Wall time, in seconds, spent in each SharedTimer phase.
+  llvm::StringMap<double> PhaseTimes;
+
+  /// The statistics files that already existed in \c Directory when a driver
+  /// reporter was created, which are not combined into its output.
+  llvm::StringSet<> PreexistingFiles;
+
+  void combineFrontendStats(llvm::StringMap<int64_t> &counters,
+                            llvm::StringMap<double> &times);
+
+public:
+  /// Creates a reporter that will write to a file in \p directory, named
+  /// after \p programName and \p auxName.
+  ///
+  /// \p programName should be "swift-driver" or "swift-frontend"; the
+  /// driver's reporter is the one that combines the frontends' statistics.
+  UnifiedStatsReporter(StringRef programName, StringRef auxName,
+                       StringRef directory);
+  ~UnifiedStatsReporter();
+
+  UnifiedStatsReporter(const UnifiedStatsReporter &) = delete;
+  UnifiedStatsReporter &operator=(const UnifiedStatsReporter &) = delete;
+
+  AlwaysOnDriverCounters &getDriverCounters();
+  AlwaysOnFrontendCounters &getFrontendCounters();
+
+  /// Adds \p delta to the named counter \p name, creating it if needed.
+  void addNamedCounter(StringRef name, int64_t delta) {
+    NamedCounters[name] += delta;
+  }
+
+  /// Records the current heap usage as the peak, if it is the largest seen.
+  void noteCurrentMemoryUsage();
+};
+
+} // end namespace swift
+
 #endif // SWIFT_BASIC_STATISTIC_H
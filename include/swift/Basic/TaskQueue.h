@@ -15,12 +15,14 @@
 
 #include "swift/Basic/LLVM.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/Optional.h"
 #include "llvm/Config/config.h"
 #include "llvm/Support/Program.h"
 
 #include <functional>
 #include <memory>
 #include <queue>
+#include <string>
 
 namespace swift {
 namespace sys {
@@ -38,6 +40,24 @@ enum class TaskFinishedResponse {
   StopExecution,
 };
 
+/// \brief The resources which a task used while it executed, as reported by
+/// the operating system.
+struct TaskResourceUsage {
+  /// The CPU time the task spent in user mode, in microseconds.
+  uint64_t UserTimeMicroseconds;
+  /// The CPU time the task spent in the kernel, in microseconds.
+  uint64_t SystemTimeMicroseconds;
+  /// The task's peak resident set size, in bytes.
+  uint64_t MaxResidentSetSizeBytes;
+};
+
+/// The name of the environment variable which TaskQueue sets for each task it
+/// begins executing (on systems which support parallel execution). Its value
+/// is the number of parallel task slots which are not needed by any other
+/// executing or queued task, so that the task can make use of that many
+/// additional threads without oversubscribing the system.
+constexpr const char *TaskQueueIdleSlotsEnvVar = "SWIFT_TASK_QUEUE_IDLE_SLOTS";
+
 /// \brief A class encapsulating the execution of multiple tasks in parallel.
 class TaskQueue {
   /// Tasks which have not begun execution.
@@ -46,13 +66,30 @@ class TaskQueue {
   /// The number of tasks to execute in parallel.
   unsigned NumberOfParallelTasks;
 
+protected:
+  /// The socket of the spawn server which should start the tasks, if any.
+  std::string SpawnServerPath;
+
+  /// The total memory, in bytes, which the tasks executing at once are
+  /// estimated to use at most, or 0 for no limit.
+  uint64_t MemoryLimit;
+
 public:
   /// \brief Create a new TaskQueue instance.
   ///
   /// \param NumberOfParallelTasks indicates the number of tasks which should
   /// be run in parallel. If 0, the TaskQueue will choose the most appropriate
   /// number of parallel tasks for the current system.
-  TaskQueue(unsigned NumberOfParallelTasks = 0);
+  /// \param SpawnServerPath the socket of a spawn server (see SpawnServer.h)
+  /// which should start the tasks. Tasks which the server can't start are
+  /// started as usual.
+  /// \param MemoryLimit the total memory, in bytes, which the tasks executing
+  /// at once may use according to their estimates (see \ref addTask), or 0
+  /// for no limit. A task is started whenever nothing else is executing, even
+  /// if its estimate alone exceeds the limit.
+  TaskQueue(unsigned NumberOfParallelTasks = 0,
+            StringRef SpawnServerPath = StringRef(),
+            uint64_t MemoryLimit = 0);
   virtual ~TaskQueue();
 
   // TODO: remove once -Wdocumentation stops warning for \param, \returns on
@@ -72,12 +109,16 @@ public:
   /// \param ReturnCode the return code of the task which finished execution.
   /// \param Output the output from the task which finished execution,
   /// if available. (This may not be available on all platforms.)
+  /// \param Usage the resources used by the task which finished execution,
+  /// if available. (This may not be available on all platforms.)
   /// \param Context the context which was passed when the task was added
   ///
   /// \returns true if further execution of tasks should stop,
   /// false if execution should continue
   typedef std::function<TaskFinishedResponse(ProcessId Pid, int ReturnCode,
-                                             StringRef Output, void *Context)>
+                                             StringRef Output,
+                                             Optional<TaskResourceUsage> Usage,
+                                             void *Context)>
     TaskFinishedCallback;
 
   /// \brief A callback which will be executed if a task exited abnormally due
@@ -88,12 +129,16 @@ public:
   /// no reason could be deduced, this may be empty.
   /// \param Output the output from the task which exited abnormally, if
   /// available. (This may not be available on all platforms.)
+  /// \param Usage the resources used by the task which exited abnormally, if
+  /// available. (This may not be available on all platforms.)
   /// \param Context the context which was passed when the task was added
   ///
   /// \returns a TaskFinishedResponse indicating whether or not execution
   /// should proceed
   typedef std::function<TaskFinishedResponse(ProcessId Pid, StringRef ErrorMsg,
-                                             StringRef Output, void *Context)>
+                                             StringRef Output,
+                                             Optional<TaskResourceUsage> Usage,
+                                             void *Context)>
     TaskSignalledCallback;
 #pragma clang diagnostic pop
 
@@ -120,9 +165,12 @@ public:
   /// \param Env the environment which should be used for the task;
   /// must be null-terminated. If empty, inherits the parent's environment.
   /// \param Context an optional context which will be associated with the task
+  /// \param MemoryEstimate the memory, in bytes, which the task is expected to
+  /// use at most, or 0 if unknown. Only used if the TaskQueue has a memory
+  /// limit.
   virtual void addTask(const char *ExecPath, ArrayRef<const char *> Args,
                        ArrayRef<const char *> Env = llvm::None,
-                       void *Context = nullptr);
+                       void *Context = nullptr, uint64_t MemoryEstimate = 0);
 
   /// \brief Synchronously executes the tasks in the TaskQueue.
   ///
@@ -168,7 +216,7 @@ public:
 
   virtual void addTask(const char *ExecPath, ArrayRef<const char *> Args,
                        ArrayRef<const char *> Env = llvm::None,
-                       void *Context = nullptr);
+                       void *Context = nullptr, uint64_t MemoryEstimate = 0);
 
   virtual bool
   execute(TaskBeganCallback Began = TaskBeganCallback(),
@@ -15,11 +15,56 @@
 
 #include "swift/Basic/LLVM.h"
 #include "llvm/ADT/Optional.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/Twine.h"
 #include "llvm/Support/Timer.h"
+#include <string>
 
 namespace swift {
+  /// Records a span of compiler work as a "complete" event in a Chrome trace,
+  /// which can be loaded into chrome://tracing or Perfetto.
+  ///
+  /// Events are only recorded once tracing has been enabled for the process;
+  /// otherwise constructing a TracedEvent does nothing. Callers that would
+  /// have to do work to compute an event's name should check
+  /// #isTracingEnabled first.
+  class TracedEvent {
+    static bool TracingEnabled;
+
+    const char *Category;
+    std::string Name;
+    std::string Detail;
+    uint64_t StartTime;
+    bool Active;
+
+  public:
+    TracedEvent(const char *category, const llvm::Twine &name,
+                const llvm::Twine &detail = llvm::Twine());
+    ~TracedEvent();
+
+    TracedEvent(const TracedEvent &) = delete;
+    TracedEvent &operator=(const TracedEvent &) = delete;
+
+    static bool isTracingEnabled() { return TracingEnabled; }
+
+    /// Starts recording events for the rest of the process.
+    static void enableTracing() { TracingEnabled = true; }
+
+    /// Writes every event recorded so far to \p out as a JSON trace object.
+    ///
+    /// Each event is written on its own line, between a line opening the
+    /// "traceEvents" array and a line closing it, so that the driver can
+    /// merge the traces of several frontend jobs without a JSON parser.
+    ///
+    /// \p processName labels this process's track in the trace viewer.
+    static void writeTrace(raw_ostream &out, StringRef processName);
+  };
+
   /// A convenience class for declaring a timer that's part of the Swift
   /// compilation timers group.
+  ///
+  /// Each shared timer is also recorded as a TracedEvent in the "phase"
+  /// category.
   class SharedTimer {
     enum class State {
       Initial,
@@ -27,23 +72,50 @@ namespace swift {
       Enabled
     };
     static State CompilationTimersEnabled;
+    static llvm::StringMap<double> *PhaseTimes;
 
     Optional<llvm::NamedRegionTimer> Timer;
+    Optional<TracedEvent> Event;
+    StringRef Name;
+    Optional<double> StartWallTime;
 
   public:
-    explicit SharedTimer(StringRef name) {
+    explicit SharedTimer(StringRef name) : Name(name) {
+      if (PhaseTimes)
+        StartWallTime = llvm::TimeRecord::getCurrentTime().getWallTime();
+      if (TracedEvent::isTracingEnabled())
+        Event.emplace("phase", name);
       if (CompilationTimersEnabled == State::Enabled)
         Timer.emplace(name, StringRef("Swift compilation"));
       else
         CompilationTimersEnabled = State::Skipped;
     }
 
+    ~SharedTimer() {
+      if (StartWallTime)
+        recordPhaseTime();
+    }
+
+    SharedTimer(const SharedTimer &) = delete;
+    SharedTimer &operator=(const SharedTimer &) = delete;
+
     /// Must be called before any SharedTimers have been created.
     static void enableCompilationTimers() {
       assert(CompilationTimersEnabled != State::Skipped &&
              "a timer has already been created");
       CompilationTimersEnabled = State::Enabled;
     }
+
+    /// Accumulates the wall time, in seconds, spent in each phase timed
+    /// from now on into \p phaseTimes, or stops doing so if null.
+    ///
+    /// \sa UnifiedStatsReporter
+    static void recordPhaseTimes(llvm::StringMap<double> *phaseTimes) {
+      PhaseTimes = phaseTimes;
+    }
+
+  private:
+    void recordPhaseTime();
   };
 } // end namespace swift
 
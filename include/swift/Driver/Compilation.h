@@ -37,6 +37,7 @@ namespace opt {
 
 namespace swift {
   class DiagnosticEngine;
+  class UnifiedStatsReporter;
 
 namespace driver {
   class Driver;
@@ -95,6 +96,29 @@ private:
   /// A hash representing all the arguments that could trigger a full rebuild.
   std::string ArgsHash;
 
+  /// Write a Chrome trace combining the traces of all frontend jobs to this
+  /// file.
+  std::string CompileEventTracePath;
+
+  /// The socket of the frontend server which should start the jobs, if any.
+  std::string FrontendServerPath;
+
+  /// The memory, in bytes, which the jobs executing in parallel may use
+  /// according to their estimates, or 0 for no limit.
+  ///
+  /// A job is estimated to use as much memory as it did in the previous
+  /// build, as recorded in the compilation record.
+  uint64_t JobMemoryLimit = 0;
+
+  /// The per-job trace files to combine into \c CompileEventTracePath.
+  ///
+  /// These are also listed in \c TempFilePaths.
+  std::vector<std::string> CompileEventTraceFiles;
+
+  /// If non-null, the reporter for the driver's always-on statistics, which
+  /// also combines the statistics of the frontend jobs when destroyed.
+  std::unique_ptr<UnifiedStatsReporter> Stats;
+
   /// When the build was started.
   ///
   /// This should be as close as possible to when the driver was invoked, since
@@ -203,6 +227,29 @@ public:
     LastBuildTime = time;
   }
 
+  void setCompileEventTracePath(StringRef path) {
+    assert(CompileEventTracePath.empty() && "already set");
+    CompileEventTracePath = path;
+  }
+
+  void setFrontendServerPath(StringRef path) {
+    FrontendServerPath = path;
+  }
+
+  void setJobMemoryLimit(uint64_t bytes) {
+    JobMemoryLimit = bytes;
+  }
+
+  /// Records that a job will write a trace to \p file, to be merged into
+  /// the compilation's trace once all jobs have finished.
+  void addCompileEventTraceFile(StringRef file) {
+    CompileEventTraceFiles.push_back(file.str());
+  }
+
+  void setStatsReporter(std::unique_ptr<UnifiedStatsReporter> reporter) {
+    Stats = std::move(reporter);
+  }
+
   /// Requests the path to a file containing all input source files. This can
   /// be shared across jobs.
   ///
@@ -233,6 +280,10 @@ private:
   /// successfully executed. In the event of an error, this function will return
   /// a negative value indicating a failure to execute.
   int performSingleCommand(const Job *Cmd);
+
+  /// Concatenates the events in each of the \c CompileEventTraceFiles into
+  /// a single trace at \c CompileEventTracePath.
+  void writeCompileEventTrace();
 };
 
 } // end namespace driver
@@ -90,6 +90,9 @@ private:
   struct ProvidesEntryTy {
     std::string name;
     DependencyMaskTy kindMask;
+    /// The subset of \c kindMask whose contents may have changed since the
+    /// previous load of the node, based on the recorded fingerprints.
+    DependencyMaskTy changedMask;
   };
   static_assert(std::is_move_constructible<ProvidesEntryTy>::value, "");
 
@@ -129,6 +132,15 @@ private:
   /// \sa SourceFile::getInterfaceHash
   llvm::DenseMap<const void *, std::string> InterfaceHashes;
 
+  /// The content fingerprint of each provided (kind, name) pair for each
+  /// node, as of the most recent load. Comparing these across loads
+  /// determines which provided entries need to be followed when a node is
+  /// marked, so that an edit to a single member of a type doesn't dirty
+  /// every file that uses the type.
+  ///
+  /// \sa ProvidesEntryTy::changedMask
+  llvm::DenseMap<const void *, llvm::StringMap<std::string>> Fingerprints;
+
   LoadResult loadFromBuffer(const void *node, llvm::MemoryBuffer &buffer);
 
   // FIXME: We should be able to use llvm::mapped_iterator for this, but
@@ -277,6 +289,10 @@ public:
   /// Nodes that are only reachable through "non-cascading" edges are added to
   /// the \p visited set, but are \em not added to the graph's marked set.
   ///
+  /// If the dependency file for \p node recorded fingerprints for what it
+  /// provides, only entries whose fingerprints changed in the most recent
+  /// load are followed out of \p node itself.
+  ///
   /// If you want to see how each node gets added to \p visited, pass a local
   /// MarkTracer instance to \p tracer.
   template <unsigned N>
@@ -106,6 +106,17 @@ public:
 
   /// Returns true if multi-threading is enabled.
   bool isMultiThreading() const { return numThreads > 0; }
+
+  /// The maximum number of partitions into which the LLVM code generation of
+  /// each standard compile job is split, or 0 if it is not split.
+  unsigned CodeGenPartitions = 0;
+
+  /// The number of frontend invocations over which the primary files of a
+  /// standard compile are partitioned, or 0 if batch mode is not in use.
+  unsigned BatchCount = 0;
+
+  /// Returns true if compile jobs may have more than one primary file.
+  bool isBatchMode() const { return BatchCount > 0; }
   
   /// The name of the module which we are building.
   std::string ModuleName;
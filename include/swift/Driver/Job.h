@@ -48,6 +48,10 @@ class CommandOutput {
 
   llvm::SmallDenseMap<types::ID, std::string, 4> AdditionalOutputsMap;
 
+  /// Object files for the code generation partitions of the primary output,
+  /// which are produced in addition to the primary output file itself.
+  SmallVector<std::string, 0> CodeGenPartitionFilenames;
+
 public:
   CommandOutput(types::ID PrimaryOutputType)
       : PrimaryOutputType(PrimaryOutputType) { }
@@ -70,6 +74,14 @@ public:
     return PrimaryOutputFilenames;
   }
   
+  void addCodeGenPartitionOutput(StringRef FileName) {
+    CodeGenPartitionFilenames.push_back(FileName);
+  }
+
+  ArrayRef<std::string> getCodeGenPartitionFilenames() const {
+    return CodeGenPartitionFilenames;
+  }
+
   void setAdditionalOutputForType(types::ID type, StringRef OutputFilename);
   const std::string &getAdditionalOutputForType(types::ID type) const;
 
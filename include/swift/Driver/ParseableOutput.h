@@ -29,17 +29,26 @@ class Job;
 namespace parseable_output {
 
 using swift::sys::ProcessId;
+using swift::sys::TaskResourceUsage;
 
 /// \brief Emits a "began" message to the given stream.
 void emitBeganMessage(raw_ostream &os, const Job &Cmd, ProcessId Pid);
 
 /// \brief Emits a "finished" message to the given stream.
+///
+/// If \p Usage is given, the message includes the task's CPU time and peak
+/// memory use.
 void emitFinishedMessage(raw_ostream &os, const Job &Cmd, ProcessId Pid,
-                         int ExitStatus, StringRef Output);
+                         int ExitStatus, StringRef Output,
+                         Optional<TaskResourceUsage> Usage = None);
 
 /// \brief Emits a "signalled" message to the given stream.
+///
+/// If \p Usage is given, the message includes the task's CPU time and peak
+/// memory use.
 void emitSignalledMessage(raw_ostream &os, const Job &Cmd, ProcessId Pid,
-                          StringRef ErrorMsg, StringRef Output);
+                          StringRef ErrorMsg, StringRef Output,
+                          Optional<TaskResourceUsage> Usage = None);
 
 /// \brief Emits a "skipped" message to the given stream.
 void emitSkippedMessage(raw_ostream &os, const Job &Cmd);
@@ -83,6 +83,12 @@ protected:
     /// arguments.
     const char *getTemporaryFilePath(const llvm::Twine &name,
                                      StringRef suffix = "") const;
+
+    /// Creates a temporary file for a job to write its compile event trace
+    /// to, which will be merged into the compilation's trace.
+    ///
+    /// \sa Compilation::addCompileEventTraceFile
+    const char *getCompileEventTraceFilePath() const;
   };
 
   /// Packs together information chosen by toolchains to create jobs.
@@ -0,0 +1,79 @@
+//===--- CompilationCache.h - Cache of frontend job outputs -----*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// A directory of the outputs of earlier frontend jobs, so that a job which
+// has already run with the same compiler, arguments and inputs can restore
+// its outputs instead of compiling again. The directory may be shared
+// between builds and machines.
+//
+// An entry is found by CompilerInvocation::computeCompilationCacheKey. It
+// records the files the job read besides its inputs, such as the modules
+// it imported, with hashes of their contents, and is only used while all of
+// them are unchanged.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_FRONTEND_COMPILATIONCACHE_H
+#define SWIFT_FRONTEND_COMPILATIONCACHE_H
+
+#include "swift/Basic/LLVM.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <string>
+#include <vector>
+
+namespace swift {
+
+class CompilerInvocation;
+
+class CompilationCache {
+  /// The cache directory.
+  std::string Path;
+
+  /// The outputs of the invocation, in a fixed order.
+  std::vector<std::string> Outputs;
+
+  /// The key of the invocation's entry.
+  std::string Key;
+
+  /// Returns the directory of the invocation's entry.
+  std::string getEntryPath() const;
+
+public:
+  /// Returns true if the outputs of \p invocation can be cached, which
+  /// requires that they are all files and that the job doesn't have any
+  /// other effects, like writing statistics or running code.
+  static bool canCache(const CompilerInvocation &invocation);
+
+  /// Creates a cache in the directory at \p path for the outputs of
+  /// \p invocation, whose entry has the given \p key.
+  CompilationCache(StringRef path, const CompilerInvocation &invocation,
+                   StringRef key);
+
+  /// Restores the outputs of the invocation from its entry, if there is one
+  /// and the files it depends on haven't changed, and writes the
+  /// diagnostics the job emitted to \p diagnostics.
+  ///
+  /// \returns true if the outputs were restored.
+  bool replay(raw_ostream &diagnostics);
+
+  /// Stores the outputs of the invocation after it has succeeded, along
+  /// with the textual \p diagnostics it emitted and the hashes of the
+  /// \p dependencies it read.
+  ///
+  /// Failing to store them is not an error; the next job just misses.
+  void store(ArrayRef<std::string> dependencies, StringRef diagnostics);
+};
+
+} // end namespace swift
+
+#endif // SWIFT_FRONTEND_COMPILATIONCACHE_H
@@ -111,6 +111,18 @@ public:
                                    StringRef SDKPath,
                                    StringRef ResourceDir);
 
+  /// Computes the key of this invocation's entry in a CompilationCache,
+  /// from the compiler at \p mainExecutablePath, the command line \p Args
+  /// it was parsed from, \p workingDirectory and the contents of the input
+  /// files. The files found by searching, like imported modules, are not
+  /// covered; the cache checks them itself.
+  ///
+  /// \returns None if one of the files can't be read.
+  Optional<std::string>
+  computeCompilationCacheKey(ArrayRef<const char *> Args,
+                             StringRef workingDirectory,
+                             StringRef mainExecutablePath) const;
+
   void setTargetTriple(StringRef Triple);
 
   StringRef getTargetTriple() const {
@@ -310,6 +322,7 @@ class CompilerInstance {
 
   DependencyTracker *DepTracker = nullptr;
   ReferencedNameTracker *NameTracker = nullptr;
+  DelayedParsingCallbacks *DelayedParseCB = nullptr;
 
   Module *MainModule = nullptr;
   SerializedModuleLoader *SML = nullptr;
@@ -330,11 +343,21 @@ class CompilerInstance {
   unsigned MainBufferID = NO_SUCH_BUFFER;
   unsigned PrimaryBufferID = NO_SUCH_BUFFER;
 
+  /// The buffer IDs of any further primary inputs in batch mode, in the order
+  /// of FrontendOptions::BatchPrimaryInputs.
+  SmallVector<unsigned, 4> BatchPrimaryBufferIDs;
+
   SourceFile *PrimarySourceFile = nullptr;
 
+  /// The source files for BatchPrimaryBufferIDs, once they have been created.
+  SmallVector<SourceFile *, 4> BatchPrimarySourceFiles;
+
   void createSILModule(bool WholeModule = false);
   void setPrimarySourceFile(SourceFile *SF);
 
+  /// Returns true if \p BufferID belongs to any of the primary inputs.
+  bool isPrimaryBuffer(unsigned BufferID) const;
+
 public:
   SourceManager &getSourceMgr() { return SourceMgr; }
 
@@ -368,6 +391,17 @@ public:
     return NameTracker;
   }
 
+  /// Use \p CB to decide which function bodies of the input files get parsed.
+  ///
+  /// Bodies that it delays are parsed before the library files are
+  /// type-checked; bodies that it skips are never parsed. This is ignored for
+  /// code completion and with delayed function body parsing, which install
+  /// their own callbacks.
+  void setDelayedParsingCallbacks(DelayedParsingCallbacks *CB) {
+    assert(!PrimarySourceFile && "must be called before performSema()");
+    DelayedParseCB = CB;
+  }
+
   /// Set the SIL module for this compilation instance.
   ///
   /// The CompilerInstance takes ownership of the given SILModule object.
@@ -405,6 +439,12 @@ public:
   /// \returns the primary SourceFile, or nullptr if there is no primary input
   SourceFile *getPrimarySourceFile() { return PrimarySourceFile; }
 
+  /// Gets the SourceFiles for the further primary inputs of a batch mode
+  /// CompilerInstance, in the order of FrontendOptions::BatchPrimaryInputs.
+  ArrayRef<SourceFile *> getBatchPrimarySourceFiles() const {
+    return BatchPrimarySourceFiles;
+  }
+
   /// \brief Returns true if there was an error during setup.
   bool setup(const CompilerInvocation &Invocation);
 
@@ -74,6 +74,16 @@ public:
   /// be generated for the whole module.
   Optional<SelectedInput> PrimaryInput;
 
+  /// Any further inputs for which output should be generated, in the order
+  /// in which they were specified. This is only non-empty when the frontend
+  /// is given several -primary-file arguments ("batch mode"), in which case
+  /// PrimaryInput is the first of them and each primary input has its own
+  /// entry in OutputFilenames.
+  std::vector<SelectedInput> BatchPrimaryInputs;
+
+  /// \returns true if more than one primary input was specified.
+  bool isInBatchMode() const { return !BatchPrimaryInputs.empty(); }
+
   /// The kind of input on which the frontend should operate.
   InputFileKind InputKind = InputFileKind::IFK_Swift;
 
@@ -128,6 +138,10 @@ public:
   /// The path to collect the group information for the compiled source files.
   std::string GroupInfoPath;
 
+  /// If non-empty, the directory of the index store that index records for
+  /// the compiled source files are written to.
+  std::string IndexStorePath;
+
   /// If non-zero, warn when a function body takes longer than this many
   /// milliseconds to type-check.
   ///
@@ -185,10 +199,32 @@ public:
   /// \sa swift::SharedTimer
   bool DebugTimeCompilation = false;
 
+  /// If non-empty, a Chrome trace of each compilation phase, function body
+  /// type-check, and SIL pass run is written to this path.
+  ///
+  /// \sa swift::TracedEvent
+  std::string TraceCompileEventsPath;
+
+  /// If non-empty, a file of counters and phase timings for this job is
+  /// written to this directory.
+  ///
+  /// \sa swift::UnifiedStatsReporter
+  std::string StatsOutputDir;
+
+  /// If non-empty, the outputs of this job are restored from this directory
+  /// when an identical job has stored them there, and stored otherwise.
+  ///
+  /// \sa swift::CompilationCache
+  std::string CompilationCachePath;
+
   /// Indicates whether function body parsing should be delayed
   /// until the end of all files.
   bool DelayedFunctionBodyParsing = false;
 
+  /// Indicates whether the function bodies of non-primary files should be
+  /// skipped by brace matching instead of being parsed.
+  bool SkipNonPrimaryFunctionBodies = false;
+
   /// Indicates whether or not an import statement can pick up a Swift source
   /// file (as opposed to a module file).
   bool EnableSourceImport = false;
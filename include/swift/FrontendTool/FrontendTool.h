@@ -78,6 +78,20 @@ int performFrontend(ArrayRef<const char *> args,
                     void *mainAddr,
                     FrontendObserver *observer = nullptr);
 
+/// Run frontend jobs for drivers which connect to the spawn server socket at
+/// \p socketPath, as with -frontend-server, until the executable is replaced.
+///
+/// Each job runs in a process forked from the server, which saves starting
+/// and initializing a new compiler for it. Other jobs, like linking, are
+/// started from the forked processes as usual.
+///
+/// \param argv0 the name used as the frontend executable
+/// \param mainAddr an address from the main executable
+///
+/// \return the exit value of the server
+int performFrontendServer(StringRef socketPath, const char *argv0,
+                          void *mainAddr);
+
 
 } // namespace swift
 
@@ -0,0 +1,85 @@
+//===--- IndexRecord.h - On-disk index records ------------------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// An index record is a compact on-disk copy of what indexSourceFile() reports
+// for one source file. The frontend writes records into an index store as a
+// side effect of compilation (-index-store-path), and tools can replay them
+// later without parsing or type-checking the file again.
+//
+// Records are keyed by a hash of the file's name, module and contents and of
+// the compiler options that affect how it is indexed, so a file whose contents
+// did not change keeps its record across builds. A record also lists the size
+// and modification time of each module it depends on, and is ignored once any
+// of them changes.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_INDEX_INDEXRECORD_H
+#define SWIFT_INDEX_INDEXRECORD_H
+
+#include "swift/Index/IndexDataConsumer.h"
+#include <string>
+
+namespace swift {
+class LangOptions;
+class SearchPathOptions;
+class SourceFile;
+
+namespace index {
+
+/// Returns a hash of the options that change what indexing a file reports:
+/// the target, the conditional compilation flags, the SDK and the module and
+/// framework search paths.
+///
+/// This must be computed before any modules are loaded, since loading a
+/// module can add search paths.
+std::string getIndexRecordInvocationHash(const LangOptions &langOpts,
+                                         const SearchPathOptions &searchOpts);
+
+/// Returns the key of the index record for the file \p filename with the
+/// given \p contents in module \p moduleName, compiled with options whose
+/// getIndexRecordInvocationHash() is \p invocationHash.
+std::string getIndexRecordKey(StringRef invocationHash, StringRef moduleName,
+                              StringRef filename, StringRef contents);
+
+/// Returns the key of the index record for \p SF.
+std::string getIndexRecordKey(SourceFile *SF, StringRef invocationHash);
+
+/// Returns the path of the record for \p key in \p storePath.
+std::string getIndexRecordPath(StringRef storePath, StringRef key);
+
+/// Indexes \p SF and writes the result to \p storePath, unless the store
+/// already has an up-to-date record for the file's current contents.
+///
+/// The record is written to a temporary file and renamed into place, so
+/// concurrent compiler invocations sharing a store never see partial records.
+///
+/// \returns true on error, with a description in \p error.
+bool emitIndexRecord(SourceFile *SF, StringRef invocationHash,
+                     StringRef storePath, std::string &error);
+
+/// Replays the record for \p key in \p storePath into \p consumer, reporting
+/// the same callbacks as indexSourceFile() with \p knownHash.
+///
+/// Symbols read from a record have a null \c decl; their attributes are
+/// provided through \c IndexSymbol::attributeNames instead.
+///
+/// \returns false if the store has no valid record for \p key, or if one of
+/// the modules the record depends on changed since it was written, in which
+/// case \p consumer was not called.
+bool readIndexRecord(StringRef storePath, StringRef key, StringRef knownHash,
+                     IndexDataConsumer &consumer);
+
+} // end namespace index
+} // end namespace swift
+
+#endif // SWIFT_INDEX_INDEXRECORD_H
@@ -19,6 +19,7 @@
 
 namespace swift {
 class Decl;
+class DeclAttributes;
 class ValueDecl;
 
 namespace index {
@@ -105,12 +106,20 @@ struct IndexSymbol {
   StringRef receiverUSR;
   unsigned line = 0;
   unsigned column = 0;
+  // Only set for symbols read back from an index record, which have no decl;
+  // these are the names from getDeclAttributeNames().
+  ArrayRef<StringRef> attributeNames;
 
   IndexSymbol() = default;
 };
 
 SymbolKind getSymbolKindForDecl(const Decl *D);
 
+/// Appends the names of the attributes in \p attrs that are reported to
+/// index clients, e.g. "objc.name" or "ibaction".
+void getDeclAttributeNames(const DeclAttributes &attrs,
+                           SmallVectorImpl<StringRef> &names);
+
 } // end namespace index
 } // end namespace swift
 
@@ -87,6 +87,13 @@ namespace swift {
     SwiftARCContract() : llvm::FunctionPass(ID) {}
   };
 
+  class SwiftProfileFirstHit : public llvm::FunctionPass {
+    virtual bool runOnFunction(llvm::Function &F) override;
+  public:
+    static char ID;
+    SwiftProfileFirstHit() : llvm::FunctionPass(ID) {}
+  };
+
   class InlineTreePrinter : public llvm::ModulePass {
     virtual void getAnalysisUsage(llvm::AnalysisUsage &AU) const override;
     virtual bool runOnModule(llvm::Module &M) override;
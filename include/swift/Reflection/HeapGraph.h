@@ -0,0 +1,132 @@
+//===--- HeapGraph.h - Object graph of a Swift heap -------------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// A graph of heap objects and the strong references between them, with the
+// statistics needed to attribute heap memory to types: the number and the
+// size of the instances of each type, and the memory each object and each
+// type keeps alive.
+//
+// The graph itself knows nothing about Swift; HeapWalker builds it from the
+// memory of a remote process.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_REFLECTION_HEAPGRAPH_H
+#define SWIFT_REFLECTION_HEAPGRAPH_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace swift {
+namespace reflection {
+
+class HeapGraph {
+public:
+  using NodeID = unsigned;
+  using TypeID = unsigned;
+
+  struct Node {
+    uint64_t Address;
+    TypeID Type;
+    /// The number of bytes allocated for the object.
+    uint64_t Size;
+    /// The number of bytes which would be freed with the object, i.e. the
+    /// sizes of the objects it dominates, including itself. Valid after
+    /// computeRetainedSizes().
+    uint64_t RetainedSize;
+  };
+
+  struct TypeStatistics {
+    std::string Name;
+    unsigned InstanceCount = 0;
+    /// The sum of the sizes of all instances.
+    uint64_t ShallowSize = 0;
+    /// The number of bytes which would be freed with all instances. Objects
+    /// which are retained by several instances of the type are counted
+    /// once. Valid after computeRetainedSizes().
+    uint64_t RetainedSize = 0;
+  };
+
+private:
+  std::vector<Node> Nodes;
+  std::vector<TypeStatistics> Types;
+  std::unordered_map<std::string, TypeID> TypesByName;
+  std::vector<std::pair<NodeID, NodeID>> Edges;
+  std::vector<NodeID> Roots;
+
+  /// The immediate dominator of each node; the node itself for the nodes
+  /// which are only dominated by the virtual root of the graph.
+  std::vector<NodeID> Dominators;
+
+public:
+  /// Returns the type with the given name, adding it if necessary.
+  TypeID getType(const std::string &Name);
+
+  NodeID addNode(uint64_t Address, TypeID Type, uint64_t Size);
+
+  /// Records that \p From holds a strong reference to \p To.
+  void addEdge(NodeID From, NodeID To) {
+    Edges.push_back({From, To});
+  }
+
+  /// Records that \p Node is referenced from outside of the graph, e.g. by a
+  /// global variable or from the stack.
+  ///
+  /// Objects which are not reachable from any root are treated as roots
+  /// themselves, so that leaked memory shows up, too.
+  void addRoot(NodeID Node) {
+    Roots.push_back(Node);
+  }
+
+  const std::vector<Node> &getNodes() const { return Nodes; }
+  const std::vector<TypeStatistics> &getTypes() const { return Types; }
+  const std::vector<std::pair<NodeID, NodeID>> &getEdges() const {
+    return Edges;
+  }
+
+  /// Returns the immediate dominator of \p Node, or \p Node itself if it is
+  /// only dominated by the roots. Valid after computeRetainedSizes().
+  NodeID getDominator(NodeID Node) const {
+    return Dominators[Node];
+  }
+
+  /// Computes the dominator tree of the graph and the retained sizes of its
+  /// nodes and types.
+  void computeRetainedSizes();
+
+  /// Returns the IDs of the types sorted by decreasing retained size.
+  std::vector<TypeID> getTypesByRetainedSize() const;
+
+  /// Writes the type statistics as a table.
+  void dumpTypeStatistics(std::ostream &OS) const;
+
+  /// Writes the graph in a compact line-oriented text format:
+  ///
+  ///   types <count>
+  ///   <type> <instances> <shallow size> <retained size> <name>
+  ///   nodes <count>
+  ///   <node> 0x<address> <type> <size> <retained size> <dominator>
+  ///   edges <count>
+  ///   <from node> <to node>
+  ///
+  /// Types and nodes are numbered from zero in the order they are listed.
+  void writeGraph(std::ostream &OS) const;
+};
+
+} // end namespace reflection
+} // end namespace swift
+
+#endif // SWIFT_REFLECTION_HEAPGRAPH_H
@@ -0,0 +1,328 @@
+//===--- HeapWalker.h - Object graph of a remote Swift heap -----*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Builds a HeapGraph of the Swift objects in a remote process or a core file.
+//
+// The client knows where the heap allocations are, e.g. from the malloc
+// implementation of the target, and hands them to addObject(), which keeps
+// the ones that turn out to be Swift class instances, boxes or closure
+// contexts. buildGraph() then finds the strong references between them,
+// using the type layouts from the reflection metadata:
+//
+//   HeapWalker<Runtime> Walker(Context);
+//   for (auto &Allocation : Allocations)
+//     Walker.addObject(Allocation.Address, Allocation.Size);
+//   auto &Graph = Walker.buildGraph();
+//   Graph.dumpTypeStatistics(std::cout);
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_REFLECTION_HEAPWALKER_H
+#define SWIFT_REFLECTION_HEAPWALKER_H
+
+#include "swift/Basic/Demangle.h"
+#include "swift/Reflection/HeapGraph.h"
+#include "swift/Reflection/ReflectionContext.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace swift {
+namespace reflection {
+
+template <typename Runtime>
+class HeapWalker {
+  using StoredPointer = typename Runtime::StoredPointer;
+
+  ReflectionContext<Runtime> &Context;
+  HeapGraph Graph;
+
+  /// The graph nodes of the objects, by address.
+  std::unordered_map<StoredPointer, HeapGraph::NodeID> Objects;
+
+  /// The graph types of the heap metadata seen so far, or -1 for metadata
+  /// of objects we don't recognize.
+  std::unordered_map<StoredPointer, int> TypesByMetadata;
+
+  /// Returns a readable name for \p TR.
+  std::string getTypeName(const TypeRef *TR) {
+    if (auto *N = dyn_cast<NominalTypeRef>(TR))
+      return Demangle::demangleTypeAsString(N->getMangledName());
+
+    if (auto *BG = dyn_cast<BoundGenericTypeRef>(TR)) {
+      auto Name = Demangle::demangleTypeAsString(BG->getMangledName());
+      const char *Separator = "<";
+      for (auto *Arg : BG->getGenericParams()) {
+        Name += Separator;
+        Name += getTypeName(Arg);
+        Separator = ", ";
+      }
+      return Name + ">";
+    }
+
+    if (auto *T = dyn_cast<TupleTypeRef>(TR)) {
+      std::string Name = "(";
+      const char *Separator = "";
+      for (auto *Element : T->getElements()) {
+        Name += Separator;
+        Name += getTypeName(Element);
+        Separator = ", ";
+      }
+      return Name + ")";
+    }
+
+    if (auto *B = dyn_cast<BuiltinTypeRef>(TR))
+      return B->getMangledName();
+
+    return "<unknown>";
+  }
+
+  /// Returns the graph type for objects with the given heap metadata, or -1
+  /// if they aren't Swift objects we know how to traverse.
+  int getTypeForMetadata(StoredPointer MetadataAddress) {
+    auto found = TypesByMetadata.find(MetadataAddress);
+    if (found != TypesByMetadata.end())
+      return found->second;
+
+    int Type = -1;
+    auto Kind = Context.readKindFromMetadata(MetadataAddress);
+    if (Kind.first) {
+      switch (Kind.second) {
+      case MetadataKind::Class:
+        if (auto *TR = Context.readTypeFromMetadata(MetadataAddress))
+          Type = Graph.getType(getTypeName(TR));
+        break;
+      case MetadataKind::HeapLocalVariable:
+        Type = Graph.getType("(closure context or box)");
+        break;
+      case MetadataKind::HeapGenericLocalVariable:
+        Type = Graph.getType("(generic box)");
+        break;
+      case MetadataKind::ErrorObject:
+        Type = Graph.getType("(error box)");
+        break;
+      default:
+        break;
+      }
+    }
+
+    TypesByMetadata.insert({MetadataAddress, Type});
+    return Type;
+  }
+
+  /// Records a reference from \p From to the object at \p Address, if it
+  /// is one of ours.
+  void addReference(HeapGraph::NodeID From, StoredPointer Address) {
+    auto found = Objects.find(Address);
+    if (found != Objects.end())
+      Graph.addEdge(From, found->second);
+  }
+
+  /// Treats every aligned word from \p Address to \p Address + \p Size as a
+  /// potential reference. Used where we don't know the layout, e.g. for
+  /// enum payloads and tail-allocated elements.
+  void scanConservatively(HeapGraph::NodeID From, StoredPointer Address,
+                          uint64_t Size) {
+    auto Mask = StoredPointer(sizeof(StoredPointer) - 1);
+    StoredPointer Begin = (Address + Mask) & ~Mask;
+    StoredPointer End = Address + Size;
+    if (End <= Begin)
+      return;
+
+    std::vector<StoredPointer> Words((End - Begin) / sizeof(StoredPointer));
+    if (Words.empty() ||
+        !Context.getReader().readBytes(
+            RemoteAddress(Begin), reinterpret_cast<uint8_t *>(Words.data()),
+            Words.size() * sizeof(StoredPointer)))
+      return;
+    for (auto Word : Words)
+      addReference(From, Word);
+  }
+
+  /// Records the strong references held by a value of the given type at
+  /// \p Address.
+  void addReferencesInValue(HeapGraph::NodeID From, StoredPointer Address,
+                            const TypeRef *TR, const TypeInfo &TI) {
+    switch (TI.getKind()) {
+    case TypeInfoKind::Builtin:
+      return;
+
+    case TypeInfoKind::Reference: {
+      auto &ReferenceTI = cast<ReferenceTypeInfo>(TI);
+      if (ReferenceTI.getReferenceKind() != ReferenceKind::Strong)
+        return;
+      StoredPointer Referent;
+      if (Context.getReader().readInteger(RemoteAddress(Address), &Referent))
+        addReference(From, Referent);
+      return;
+    }
+
+    case TypeInfoKind::Record: {
+      auto &RecordTI = cast<RecordTypeInfo>(TI);
+      switch (RecordTI.getRecordKind()) {
+      case RecordKind::Invalid:
+      case RecordKind::NoPayloadEnum:
+      case RecordKind::ExistentialMetatype:
+        return;
+
+      case RecordKind::SinglePayloadEnum:
+      case RecordKind::MultiPayloadEnum:
+        // Which payload is valid depends on the case.
+        scanConservatively(From, Address, TI.getSize());
+        return;
+
+      case RecordKind::OpaqueExistential: {
+        const TypeRef *InstanceTR = nullptr;
+        RemoteAddress InstanceAddress(uint64_t(0));
+        if (!TR || !Context.projectExistential(RemoteAddress(Address), TR,
+                                               &InstanceTR, &InstanceAddress))
+          return;
+
+        // Large values live in a box.
+        if (InstanceAddress.getAddressData() != Address) {
+          addReference(From, InstanceAddress.getAddressData());
+          return;
+        }
+        if (auto *InstanceTI = Context.getTypeInfo(InstanceTR))
+          addReferencesInValue(From, Address, InstanceTR, *InstanceTI);
+        return;
+      }
+
+      case RecordKind::ErrorExistential: {
+        StoredPointer Referent;
+        if (Context.getReader().readInteger(RemoteAddress(Address), &Referent))
+          addReference(From, Referent);
+        return;
+      }
+
+      case RecordKind::Tuple:
+      case RecordKind::Struct:
+      case RecordKind::ThickFunction:
+      case RecordKind::ClassExistential:
+      case RecordKind::ClassInstance:
+      case RecordKind::ClosureContext:
+        for (auto &Field : RecordTI.getFields())
+          addReferencesInValue(From, Address + Field.Offset, Field.TR,
+                               Field.TI);
+        return;
+      }
+    }
+    }
+  }
+
+  /// Records the strong references held by the object of node \p ID, and
+  /// returns the number of bytes whose layout we know.
+  uint64_t addReferencesInObject(HeapGraph::NodeID ID, StoredPointer Address,
+                                 StoredPointer MetadataAddress) {
+    auto Kind = Context.readKindFromMetadata(MetadataAddress);
+    if (!Kind.first)
+      return 0;
+
+    if (Kind.second != MetadataKind::Class) {
+      auto *TI = Context.getInstanceTypeInfo(Address);
+      if (TI == nullptr)
+        return 0;
+      addReferencesInValue(ID, Address, nullptr, *TI);
+      return TI->getSize();
+    }
+
+    // The layout of each class only covers its own stored properties.
+    uint64_t LayoutSize = 0;
+    while (MetadataAddress) {
+      auto *TI = Context.getMetadataTypeInfo(MetadataAddress);
+      if (TI == nullptr)
+        return 0;
+      addReferencesInValue(ID, Address, nullptr, *TI);
+      LayoutSize = std::max(LayoutSize, uint64_t(TI->getSize()));
+
+      MetadataAddress =
+        Context.readSuperClassFromClassMetadata(MetadataAddress);
+      if (MetadataAddress && getTypeForMetadata(MetadataAddress) < 0)
+        break;
+    }
+    return LayoutSize;
+  }
+
+public:
+  explicit HeapWalker(ReflectionContext<Runtime> &Context)
+    : Context(Context) {}
+
+  /// Adds the heap allocation at \p Address to the graph if it holds a Swift
+  /// object.
+  ///
+  /// \param Size The size of the allocation, or 0 to use the size of the
+  /// object's layout. Allocations may be larger than the layout, e.g. for
+  /// the tail-allocated elements of array buffers; the rest of the
+  /// allocation is scanned for anything that looks like a reference.
+  ///
+  /// \returns true if the allocation is a Swift object.
+  bool addObject(StoredPointer Address, uint64_t Size = 0) {
+    if (Objects.count(Address))
+      return true;
+
+    auto MetadataAddress = Context.readMetadataFromInstance(Address);
+    if (!MetadataAddress.first)
+      return false;
+
+    int Type = getTypeForMetadata(MetadataAddress.second);
+    if (Type < 0)
+      return false;
+
+    if (Size == 0) {
+      if (auto *TI = Context.getInstanceTypeInfo(Address))
+        Size = TI->getSize();
+    }
+
+    auto ID = Graph.addNode(Address, Type, Size);
+    Objects.insert({Address, ID});
+    return true;
+  }
+
+  /// Marks the object at \p Address as referenced from outside of the heap,
+  /// e.g. from a global variable or the stack.
+  void addRoot(StoredPointer Address) {
+    auto found = Objects.find(Address);
+    if (found != Objects.end())
+      Graph.addRoot(found->second);
+  }
+
+  /// Finds the references between the objects added so far and computes
+  /// the retained sizes.
+  HeapGraph &buildGraph() {
+    auto &Nodes = Graph.getNodes();
+    for (HeapGraph::NodeID ID = 0, e = Nodes.size(); ID != e; ++ID) {
+      StoredPointer Address = Nodes[ID].Address;
+      auto MetadataAddress = Context.readMetadataFromInstance(Address);
+      uint64_t LayoutSize = 0;
+      if (MetadataAddress.first)
+        LayoutSize = addReferencesInObject(ID, Address,
+                                           MetadataAddress.second);
+
+      // Skip the heap object header.
+      LayoutSize = std::max(LayoutSize,
+                            uint64_t(sizeof(StoredPointer) + 8));
+      if (Nodes[ID].Size > LayoutSize)
+        scanConservatively(ID, Address + LayoutSize,
+                           Nodes[ID].Size - LayoutSize);
+    }
+
+    Graph.computeRetainedSizes();
+    return Graph;
+  }
+
+  HeapGraph &getGraph() { return Graph; }
+};
+
+} // end namespace reflection
+} // end namespace swift
+
+#endif // SWIFT_REFLECTION_HEAPWALKER_H
@@ -296,6 +296,30 @@ public:
 private:
   std::vector<ReflectionInfo> ReflectionInfos;
 
+  /// The number of ReflectionInfos which have been added to the indexes
+  /// below. Images added after the last lookup are indexed by the next one.
+  size_t NumIndexedReflectionInfos = 0;
+
+  /// Field descriptors by mangled type name.
+  std::unordered_map<std::string, const FieldDescriptor *> FieldDescriptors;
+
+  /// Builtin type descriptors by mangled type name.
+  std::unordered_map<std::string, const BuiltinTypeDescriptor *>
+    BuiltinTypeDescriptors;
+
+  /// Associated type descriptors by mangled conforming type name, in the
+  /// order of the images they came from.
+  std::unordered_map<std::string,
+                     std::vector<const AssociatedTypeDescriptor *>>
+    AssociatedTypeDescriptors;
+
+  /// Capture descriptors by their address in the remote process.
+  std::unordered_map<uintptr_t, const CaptureDescriptor *> CaptureDescriptors;
+
+  /// Adds the sections of all images which aren't indexed yet to the
+  /// lookup tables.
+  void indexReflectionInfos();
+
 public:
   TypeConverter &getTypeConverter() { return TC; }
 
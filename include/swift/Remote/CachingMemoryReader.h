@@ -0,0 +1,177 @@
+//===--- CachingMemoryReader.h - Page cache for remote memory ---*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file declares a MemoryReader which caches the memory read through
+//  another MemoryReader a page at a time.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_REMOTE_CACHINGMEMORYREADER_H
+#define SWIFT_REMOTE_CACHINGMEMORYREADER_H
+
+#include "swift/Remote/MemoryReader.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+
+namespace swift {
+namespace remote {
+
+/// A MemoryReader which reads whole pages through another MemoryReader and
+/// keeps them until the cache is invalidated.
+///
+/// Reading a metadata record or a nominal type descriptor takes several
+/// small reads of neighbouring fields; with the cache, they cost a single
+/// read of the underlying reader, which matters when every read is a round
+/// trip to another process. The missing pages of a read are fetched with
+/// one underlying read.
+///
+/// The cache does not notice changes to the remote memory: clients must call
+/// invalidateCache() whenever the remote process may have run.
+class CachingMemoryReader final : public MemoryReader {
+  std::shared_ptr<MemoryReader> Underlying;
+
+  /// The size of a cached page. A power of two which must not be larger than
+  /// the remote process's page size, so that the pages containing readable
+  /// bytes are readable in whole.
+  const uint64_t PageSize;
+
+  /// The cache is dropped when it would grow beyond this many pages.
+  const size_t MaxCachedPages;
+
+  /// Reads spanning more pages than this go straight to the underlying
+  /// reader.
+  static const uint64_t MaxPagesPerRead = 16;
+
+  /// The cached pages, keyed by their address.
+  std::unordered_map<uint64_t, std::unique_ptr<uint8_t[]>> Pages;
+
+  uint64_t getPageAddress(uint64_t address) const {
+    return address & ~(PageSize - 1);
+  }
+
+  /// Makes sure that the pages from \p firstPage to \p lastPage inclusive
+  /// are cached. Returns false if they could not be read.
+  bool fetchPages(uint64_t firstPage, uint64_t lastPage) {
+    // Drop the cache up front, so that the pages we don't read again below
+    // stay around.
+    if (Pages.size() + (lastPage - firstPage) / PageSize + 1 > MaxCachedPages)
+      Pages.clear();
+
+    while (firstPage <= lastPage && Pages.count(firstPage))
+      firstPage += PageSize;
+    while (lastPage > firstPage && Pages.count(lastPage))
+      lastPage -= PageSize;
+    if (firstPage > lastPage)
+      return true;
+
+    uint64_t numPages = (lastPage - firstPage) / PageSize + 1;
+    std::unique_ptr<uint8_t[]> buffer(new uint8_t[numPages * PageSize]);
+    if (!Underlying->readBytes(RemoteAddress(firstPage), buffer.get(),
+                               numPages * PageSize))
+      return false;
+
+    for (uint64_t i = 0; i < numPages; ++i) {
+      auto &page = Pages[firstPage + i * PageSize];
+      if (page)
+        continue;
+      page.reset(new uint8_t[PageSize]);
+      memcpy(page.get(), buffer.get() + i * PageSize, PageSize);
+    }
+    return true;
+  }
+
+public:
+  CachingMemoryReader(std::shared_ptr<MemoryReader> underlying,
+                      uint64_t pageSize = 4096,
+                      size_t maxCachedPages = 4096)
+    : Underlying(std::move(underlying)), PageSize(pageSize),
+      MaxCachedPages(maxCachedPages) {
+    assert(PageSize && (PageSize & (PageSize - 1)) == 0 &&
+           "Page size must be a power of two");
+    assert(MaxCachedPages >= MaxPagesPerRead && "Cache too small");
+  }
+
+  MemoryReader &getUnderlyingReader() { return *Underlying; }
+
+  uint8_t getPointerSize() override {
+    return Underlying->getPointerSize();
+  }
+
+  uint8_t getSizeSize() override {
+    return Underlying->getSizeSize();
+  }
+
+  RemoteAddress getSymbolAddress(const std::string &name) override {
+    return Underlying->getSymbolAddress(name);
+  }
+
+  bool readBytes(RemoteAddress address, uint8_t *dest,
+                 uint64_t size) override {
+    if (size == 0)
+      return true;
+
+    uint64_t start = address.getAddressData();
+    uint64_t firstPage = getPageAddress(start);
+    uint64_t lastPage = getPageAddress(start + size - 1);
+
+    // The readable part of the remote memory might not end on a page
+    // boundary, e.g. in a core file, so read whatever we can't cache
+    // directly.
+    if (lastPage < firstPage ||
+        (lastPage - firstPage) / PageSize >= MaxPagesPerRead ||
+        !fetchPages(firstPage, lastPage))
+      return Underlying->readBytes(address, dest, size);
+
+    for (uint64_t page = firstPage; page <= lastPage; page += PageSize) {
+      uint64_t begin = std::max(start, page);
+      uint64_t last = std::min(start + size - 1, page + PageSize - 1);
+      memcpy(dest + (begin - start), Pages[page].get() + (begin - page),
+             last - begin + 1);
+    }
+    return true;
+  }
+
+  bool readString(RemoteAddress address, std::string &dest) override {
+    uint64_t start = address.getAddressData();
+    std::string result;
+    for (uint64_t page = getPageAddress(start); ; page += PageSize) {
+      if (!fetchPages(page, page))
+        return Underlying->readString(address, dest);
+
+      auto *begin = Pages[page].get();
+      uint64_t offset = std::max(start, page) - page;
+      auto *chars = reinterpret_cast<const char *>(begin + offset);
+      auto *nul = memchr(chars, '\0', PageSize - offset);
+      if (nul) {
+        result.append(chars, static_cast<const char *>(nul) - chars);
+        dest = std::move(result);
+        return true;
+      }
+      result.append(chars, PageSize - offset);
+    }
+  }
+
+  /// Drops all cached pages.
+  void invalidateCache() override {
+    Pages.clear();
+    Underlying->invalidateCache();
+  }
+};
+
+} // end namespace remote
+} // end namespace swift
+
+#endif // SWIFT_REMOTE_CACHINGMEMORYREADER_H
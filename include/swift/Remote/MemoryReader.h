@@ -63,6 +63,10 @@ public:
                      sizeof(IntegerType));
   }
 
+  /// Discards anything the reader has cached about the remote memory,
+  /// because the remote process may have changed it.
+  virtual void invalidateCache() {}
+
   virtual ~MemoryReader() = default;
 };
 
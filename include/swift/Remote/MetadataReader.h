@@ -105,7 +105,7 @@ class TypeDecoder {
         if (repr->getKind() != NodeKind::MetatypeRepresentation ||
             !repr->hasText())
           return BuiltType();
-        auto &str = repr->getText();
+        auto str = repr->getText();
         if (str != "@thin")
           wasAbstract = true;
       }
@@ -142,9 +142,10 @@ class TypeDecoder {
       auto name = Node->getChild(1)->getText();
 
       // Consistent handling of protocols and protocol compositions
-      auto protocolList = Demangle::NodeFactory::create(NodeKind::ProtocolList);
-      auto typeList = Demangle::NodeFactory::create(NodeKind::TypeList);
-      auto type = Demangle::NodeFactory::create(NodeKind::Type);
+      Demangle::NodeFactory Factory;
+      auto protocolList = Factory.create(NodeKind::ProtocolList);
+      auto typeList = Factory.create(NodeKind::TypeList);
+      auto type = Factory.create(NodeKind::Type);
       type->addChild(Node);
       typeList->addChild(type);
       protocolList->addChild(typeList);
@@ -199,7 +200,7 @@ class TypeDecoder {
           if (!child->hasText())
             return BuiltType();
 
-          auto &text = child->getText();
+          auto text = child->getText();
 
           if (text == "@convention(thin)") {
             flags =
@@ -209,7 +210,7 @@ class TypeDecoder {
           if (!child->hasText())
             return BuiltType();
 
-          auto &text = child->getText();
+          auto text = child->getText();
           if (text == "@convention(c)") {
             flags =
               flags.withConvention(FunctionMetadataConvention::CFunctionPointer);
@@ -521,11 +522,13 @@ public:
   MetadataReader(const MetadataReader &other) = delete;
   MetadataReader &operator=(const MetadataReader &other) = delete;
 
-  /// Clear all of the caches in this reader.
+  /// Clear all of the caches in this reader, including the memory cached
+  /// by the memory reader.
   void clear() {
     TypeCache.clear();
     MetadataCache.clear();
     NominalTypeDescriptorCache.clear();
+    Reader->invalidateCache();
   }
 
   /// Given a demangle tree, attempt to turn it into a type.
@@ -579,7 +582,7 @@ public:
     // Grab the RO-data pointer.  This part is not ABI.
     StoredPointer roDataPtr = readObjCRODataPtr(MetadataAddress);
     if (!roDataPtr)
-      return std::make_pair(false, 0);
+      return readInstanceStartFromSuperclassMetadata(meta);
 
     // Get the address of the InstanceStart field.
     auto address = roDataPtr + sizeof(uint32_t) * 1;
@@ -591,6 +594,33 @@ public:
     return std::make_pair(true, start);
   }
 
+  /// Without Objective-C interop, a class's stored properties start at the
+  /// end of its superclass's instance, or after the heap object header for
+  /// a root class.
+  std::pair<bool, unsigned>
+  readInstanceStartFromSuperclassMetadata(MetadataRef meta) {
+    auto classMeta = cast<TargetClassMetadata<Runtime>>(meta);
+    if (!classMeta->isTypeMetadata())
+      return std::make_pair(false, 0);
+
+    StoredPointer superClass = classMeta->SuperClass;
+    if (!superClass) {
+      // The isa pointer followed by two 32-bit reference counts. This is
+      // just sizeof(HeapObject) in the target.
+      return std::make_pair(true, unsigned(sizeof(StoredPointer) + 8));
+    }
+
+    auto superMeta = readMetadata(superClass);
+    if (!superMeta || superMeta->getKind() != MetadataKind::Class)
+      return std::make_pair(false, 0);
+
+    auto superClassMeta = cast<TargetClassMetadata<Runtime>>(superMeta);
+    if (!superClassMeta->isTypeMetadata())
+      return std::make_pair(false, 0);
+
+    return std::make_pair(true, unsigned(superClassMeta->getInstanceSize()));
+  }
+
   /// Given a remote pointer to metadata, attempt to turn it into a type.
   BuiltType readTypeFromMetadata(StoredPointer MetadataAddress) {
     auto Cached = TypeCache.find(MetadataAddress);
@@ -698,7 +728,8 @@ public:
         if (!Reader->readString(RemoteAddress(ProtocolDescriptor->Name),
                                 MangledName))
           return BuiltType();
-        auto Demangled = Demangle::demangleSymbolAsNode(MangledName);
+        Demangle::NodeFactory Factory;
+        auto Demangled = Demangle::demangleSymbolAsNode(MangledName, Factory);
         auto Protocol = decodeMangledType(Demangled);
         if (!Protocol)
           return BuiltType();
@@ -768,7 +799,9 @@ public:
 
   BuiltType readTypeFromMangledName(const char *MangledTypeName,
                                     size_t Length) {
-    auto Demangled = Demangle::demangleSymbolAsNode(MangledTypeName, Length);
+    Demangle::NodeFactory Factory;
+    auto Demangled = Demangle::demangleSymbolAsNode(MangledTypeName, Length,
+                                                    Factory);
     return decodeMangledType(Demangled);
   }
 
@@ -18,5 +18,45 @@
 #define SWIFT_RUNTIME_HEAP_H
 
 #include <llvm/Support/Compiler.h>
+#include <cstddef>
+#include <cstdint>
+#include "swift/Runtime/Config.h"
+
+namespace swift {
+
+/// Counters describing the activity of the runtime's small-object allocator.
+///
+/// \sa swift_getSlabAllocatorStatistics
+struct SlabAllocatorStatistics {
+  /// The number of allocations served from size-class slabs.
+  uint64_t NumAllocations;
+  /// The number of slab allocations which were freed again.
+  uint64_t NumDeallocations;
+  /// The number of chunks carved into blocks so far.
+  uint64_t NumChunks;
+  /// The number of batches of free blocks moved between a thread's cache and
+  /// the shared pool.
+  uint64_t NumTransfers;
+};
+
+/// Fills in \p stats with the current counters of the small-object
+/// allocator used by swift_slowAlloc.
+///
+/// Returns false, leaving \p stats untouched, if the runtime was built
+/// without SWIFT_RUNTIME_ENABLE_SLAB_ALLOCATOR or the allocator was not
+/// enabled with the SWIFT_RUNTIME_SLAB_ALLOCATOR environment variable.
+SWIFT_RUNTIME_EXPORT
+extern "C"
+bool swift_getSlabAllocatorStatistics(SlabAllocatorStatistics *stats);
+
+/// Returns the number of usable bytes in \p ptr if swift_slowAlloc served
+/// it from the small-object allocator, or 0 if it came from malloc.
+///
+/// malloc_size and friends must not be asked about such blocks.
+SWIFT_RUNTIME_EXPORT
+extern "C"
+size_t swift_getSlabAllocationSize(const void *ptr);
+
+} // end namespace swift
 
 #endif /* SWIFT_RUNTIME_HEAP_H */
@@ -336,6 +336,24 @@ SWIFT_RUNTIME_EXPORT
 extern "C" void (*SWIFT_CC(RegisterPreservingCC)
                      _swift_release_n)(HeapObject *object, uint32_t n);
 
+/// Atomically increments the retain count of each of the \p count objects
+/// in \p objects by one. Null entries are ignored.
+///
+/// This is equivalent to calling swift_retain on each object in turn, but
+/// only costs a single call.
+SWIFT_RUNTIME_EXPORT
+extern "C" void swift_retain_array(HeapObject * const *objects, uint32_t count);
+
+/// Atomically decrements the retain count of each of the \p count objects
+/// in \p objects by one, destroying any object whose count reaches zero.
+/// Null entries are ignored.
+///
+/// The objects are released in order, so this is equivalent to calling
+/// swift_release on each object in turn.
+SWIFT_RUNTIME_EXPORT
+extern "C" void swift_release_array(HeapObject * const *objects,
+                                    uint32_t count);
+
 /// Sets the RC_DEALLOCATING_FLAG flag. This is done non-atomically.
 /// The strong reference count of \p object must be 1 and no other thread may
 /// retain the object during executing this function.
@@ -2636,7 +2636,11 @@ struct TargetGenericWitnessTable {
                              void * const *instantiationArgs),
                         /*nullable*/ true> Instantiator;
 
-  void *PrivateData[swift::NumGenericMetadataPrivateDataWords];
+  /// Private storage of NumGenericMetadataPrivateDataWords words, which the
+  /// runtime uses to cache instantiations. It lives outside of this
+  /// structure so that the structure itself can be emitted into read-only
+  /// memory.
+  RelativeDirectPointer<void *> PrivateData;
 };
 using GenericWitnessTable = TargetGenericWitnessTable<InProcess>;
 
@@ -3462,6 +3466,14 @@ extern "C"
 void swift_registerProtocolConformances(const ProtocolConformanceRecord *begin,
                                         const ProtocolConformanceRecord *end);
 
+/// Call each of the given metadata accessors on a background thread, so that
+/// the metadata is already instantiated when the program first needs it.
+/// With -warm-generic-metadata, a program's entry point passes this the
+/// specialized generic types its module uses.
+SWIFT_RUNTIME_EXPORT
+extern "C"
+void swift_warmMetadata(const Metadata *(* const *accessors)(), size_t count);
+
 /// Register a block of type metadata records dynamic lookup.
 SWIFT_RUNTIME_EXPORT
 extern "C"
@@ -41,6 +41,15 @@ typedef pthread_rwlock_t ReadWriteLockHandle;
 #define SWIFT_READWRITELOCK_SUPPORTS_CONSTEXPR 1
 #endif
 
+// The runtime's mutexes guard short critical sections, like inserting into a
+// cache, so where glibc can, have waiters spin briefly before they block in
+// the kernel.
+#if defined(PTHREAD_ADAPTIVE_MUTEX_INITIALIZER_NP)
+#define SWIFT_MUTEX_IS_ADAPTIVE 1
+#else
+#define SWIFT_MUTEX_IS_ADAPTIVE 0
+#endif
+
 /// PThread low-level implementation that supports ConditionVariable
 /// found in Mutex.h
 ///
@@ -74,7 +83,11 @@ struct MutexPlatformHelper {
 #endif
       MutexHandle
       staticInit() {
+#if SWIFT_MUTEX_IS_ADAPTIVE
+    return PTHREAD_ADAPTIVE_MUTEX_INITIALIZER_NP;
+#else
     return PTHREAD_MUTEX_INITIALIZER;
+#endif
   };
   static void init(MutexHandle &mutex, bool checked = false);
   static void destroy(MutexHandle &mutex);
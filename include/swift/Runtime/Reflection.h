@@ -52,4 +52,27 @@ swift_reflectAny(OpaqueValue *value, const Metadata *T);
 
 #pragma clang diagnostic pop
 
+/// A stored property of a struct or class type, as reflected by Mirror.
+struct ReflectedField {
+  /// The name of the property.
+  const char *Name;
+
+  /// The offset of the property within the struct value or class instance.
+  uintptr_t Offset;
+
+  /// The type of the property.
+  FieldType Type;
+};
+
+/// Returns the stored properties of a struct type, or those a class type
+/// declares itself, in declaration order. The table is built the first time
+/// it is asked for and is never freed, so walking the children of many
+/// values of the same type doesn't allocate or look at the type's field
+/// metadata again.
+///
+/// \param count set to the number of properties.
+SWIFT_RUNTIME_EXPORT
+const ReflectedField *swift_getReflectedFields(const Metadata *type,
+                                               size_t *count);
+
 }
@@ -0,0 +1,185 @@
+//===--- OptimizationRemark.h - Optimization diagnostics --------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Optimization remarks tell the user which optimizations a pass performed
+// (or failed to perform) and why. They are shown as 'remark' diagnostics if
+// the pass name matches the -Rpass or -Rpass-missed pattern, and written to
+// the YAML optimization record if -save-optimization-record is given.
+//
+// A pass creates an Emitter with its pass name, which is the pass's
+// DEBUG_TYPE, and builds remarks in a lambda so that the message is only
+// assembled when somebody asks for it:
+//
+//   OptRemark::Emitter ORE(DEBUG_TYPE, M);
+//   ORE.emit([&]() {
+//     using namespace OptRemark;
+//     return RemarkPassed("Inlined", *AI)
+//            << NV("Callee", Callee) << " inlined into "
+//            << NV("Caller", Caller);
+//   });
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_SIL_OPTIMIZATIONREMARK_H
+#define SWIFT_SIL_OPTIMIZATIONREMARK_H
+
+#include "swift/Basic/SourceLoc.h"
+#include "llvm/ADT/StringRef.h"
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace swift {
+
+class SILFunction;
+class SILInstruction;
+class SILModule;
+class SILType;
+class ValueDecl;
+
+namespace OptRemark {
+
+/// One piece of a remark's message.
+///
+/// Arguments with a key other than "String" name the value they show, e.g.
+/// the callee of an inlined call, so that tools reading the optimization
+/// record can pick them out.
+struct Argument {
+  std::string Key;
+  std::string Val;
+  /// The source location of the value, if it has one.
+  SourceLoc Loc;
+
+  explicit Argument(StringRef Str = "") : Key("String"), Val(Str) {}
+  Argument(StringRef Key, StringRef Val) : Key(Key), Val(Val) {}
+
+  Argument(StringRef Key, int N);
+  Argument(StringRef Key, long N);
+  Argument(StringRef Key, long long N);
+  Argument(StringRef Key, unsigned N);
+  Argument(StringRef Key, unsigned long N);
+  Argument(StringRef Key, unsigned long long N);
+
+  /// Shows the demangled name of \p F and points to its definition.
+  Argument(StringRef Key, SILFunction *F);
+  Argument(StringRef Key, SILType Ty);
+
+  /// Shows the name of \p D and points to its declaration.
+  Argument(StringRef Key, ValueDecl *D);
+};
+
+/// Shorthand to build a named argument.
+using NV = Argument;
+
+enum class RemarkKind { Passed, Missed };
+
+/// The parts of a remark which don't depend on its kind.
+class RemarkBase {
+  RemarkKind Kind;
+
+  /// Identifies the remark within its pass, e.g. "NoDefinition".
+  StringRef Identifier;
+
+  /// The name of the pass which emitted the remark. Set by the Emitter.
+  StringRef PassName;
+
+  /// The location of the instruction the remark is about.
+  SourceLoc Location;
+
+  /// The function containing the instruction.
+  SILFunction *Function;
+
+  std::vector<Argument> Args;
+
+protected:
+  RemarkBase(RemarkKind Kind, StringRef Identifier, SILInstruction &I);
+
+  void addArgument(Argument A) { Args.push_back(std::move(A)); }
+
+public:
+  RemarkKind getKind() const { return Kind; }
+  StringRef getIdentifier() const { return Identifier; }
+  StringRef getPassName() const { return PassName; }
+  void setPassName(StringRef Name) { PassName = Name; }
+  SourceLoc getLocation() const { return Location; }
+  SILFunction *getFunction() const { return Function; }
+  std::vector<Argument> &getArgs() { return Args; }
+  const std::vector<Argument> &getArgs() const { return Args; }
+
+  /// Returns the message, which is all arguments' values concatenated.
+  std::string getMsg() const;
+};
+
+/// Adds the streaming operators, which return the derived remark so that
+/// a remark can be built and returned in a single expression.
+template <typename DerivedT> class Remark : public RemarkBase {
+protected:
+  Remark(RemarkKind Kind, StringRef Identifier, SILInstruction &I)
+      : RemarkBase(Kind, Identifier, I) {}
+
+public:
+  DerivedT &operator<<(StringRef S) {
+    addArgument(Argument(S));
+    return *static_cast<DerivedT *>(this);
+  }
+
+  DerivedT &operator<<(Argument A) {
+    addArgument(std::move(A));
+    return *static_cast<DerivedT *>(this);
+  }
+};
+
+/// A remark about an optimization which was performed.
+struct RemarkPassed : public Remark<RemarkPassed> {
+  RemarkPassed(StringRef Identifier, SILInstruction &I)
+      : Remark(RemarkKind::Passed, Identifier, I) {}
+};
+
+/// A remark about an optimization which could not be performed.
+struct RemarkMissed : public Remark<RemarkMissed> {
+  RemarkMissed(StringRef Identifier, SILInstruction &I)
+      : Remark(RemarkKind::Missed, Identifier, I) {}
+};
+
+/// Emits the remarks of one pass.
+class Emitter {
+  SILModule &Module;
+  std::string PassName;
+  bool PassedEnabled;
+  bool MissedEnabled;
+
+  bool isEnabled(RemarkKind Kind) const;
+  void emitRemark(RemarkBase &R);
+
+public:
+  Emitter(StringRef PassName, SILModule &M);
+
+  /// Emits the remark returned by \p RemarkBuilder. The builder is only
+  /// called if remarks of its kind are shown or recorded for this pass.
+  template <typename RemarkBuilderT>
+  void emit(RemarkBuilderT RemarkBuilder) {
+    using RemarkT = decltype(RemarkBuilder());
+    RemarkKind Kind = std::is_same<RemarkT, RemarkPassed>::value
+                          ? RemarkKind::Passed
+                          : RemarkKind::Missed;
+    if (!isEnabled(Kind))
+      return;
+    RemarkT R = RemarkBuilder();
+    R.setPassName(PassName);
+    emitRemark(R);
+  }
+};
+
+} // end namespace OptRemark
+} // end namespace swift
+
+#endif // SWIFT_SIL_OPTIMIZATIONREMARK_H
@@ -45,6 +45,12 @@ private:
   /// The ordered set of instructions in the SILBasicBlock.
   InstListType InstList;
 
+  /// The number of times this block was executed in the profile passed with
+  /// -profile-use, if known. This is only set on blocks that begin a profiled
+  /// region and is not maintained when the CFG is transformed, so it is a
+  /// hint rather than an invariant.
+  Optional<uint64_t> ProfileCount;
+
   friend struct llvm::ilist_traits<SILBasicBlock>;
   SILBasicBlock() : Parent(nullptr) {}
   void operator=(const SILBasicBlock &) = delete;
@@ -73,6 +79,15 @@ public:
   /// Returns true if this BB is the entry BB of its parent.
   bool isEntry() const;
 
+  /// Returns the profiled execution count of this block, if known.
+  Optional<uint64_t> getProfileCount() const { return ProfileCount; }
+  void setProfileCount(uint64_t Count) { ProfileCount = Count; }
+
+  /// Returns true if the profile says this block was never executed, either
+  /// because the block itself has a zero count or because its function was
+  /// never entered.
+  bool isProfiledCold() const;
+
   //===--------------------------------------------------------------------===//
   // SILInstruction List Inspection and Manipulation
   //===--------------------------------------------------------------------===//
@@ -589,13 +589,16 @@ void
 SILCloner<ImplClass>::visitPartialApplyInst(PartialApplyInst *Inst) {
   auto Args = getOpValueArray<8>(Inst->getArguments());
   getBuilder().setCurrentDebugScope(getOpScope(Inst->getDebugScope()));
-  doPostProcess(Inst,
+  auto *NewInst =
     getBuilder().createPartialApply(getOpLocation(Inst->getLoc()),
                                     getOpValue(Inst->getCallee()),
                                     getOpType(Inst->getSubstCalleeSILType()),
                                     getOpSubstitutions(Inst->getSubstitutions()),
                                     Args,
-                                    getOpType(Inst->getType())));
+                                    getOpType(Inst->getType()));
+  if (Inst->canAllocOnStack())
+    NewInst->setStackAllocatable();
+  doPostProcess(Inst, NewInst);
 }
 
 template<typename ImplClass>
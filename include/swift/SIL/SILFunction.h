@@ -183,6 +183,24 @@ private:
   /// after the pass runs, we only see a semantic-arc world.
   bool HasQualifiedOwnership = true;
 
+  /// The number of times this function was entered in the profile passed
+  /// with -profile-use, if the profile has data for it.
+  Optional<uint64_t> EntryCount;
+
+  /// The module's change stamp of the most recent time instructions were
+  /// added to, removed from or moved within this function, or of the
+  /// function's creation.
+  ///
+  /// \sa SILModule::allocateChangeStamp
+  uint64_t ChangeStamp;
+
+  /// The change stamp of the body the last time the linker visited every
+  /// function it references in LinkAll mode, or zero.
+  ///
+  /// While the body keeps that stamp, linking it again can't find anything
+  /// new to deserialize.
+  uint64_t LinkedAllChangeStamp = 0;
+
   SILFunction(SILModule &module, SILLinkage linkage,
               StringRef mangledName, CanSILFunctionType loweredType,
               GenericEnvironment *genericEnv,
@@ -218,6 +236,22 @@ public:
 
   SILModule &getModule() const { return Module; }
 
+  /// Returns the change stamp of the most recent change to the function's
+  /// instructions. Stamps only increase, and are never shared with another
+  /// function.
+  uint64_t getChangeStamp() const { return ChangeStamp; }
+
+  /// Records that instructions of this function changed.
+  void noteBodyChanged();
+
+  /// Returns true if the linker already visited everything the current body
+  /// references in LinkAll mode.
+  bool isLinkedAll() const { return LinkedAllChangeStamp == ChangeStamp; }
+
+  /// Records that the linker visited everything the current body references
+  /// in LinkAll mode.
+  void setLinkedAll() { LinkedAllChangeStamp = ChangeStamp; }
+
   SILType getLoweredType() const {
     return SILType::getPrimitiveObjectType(LoweredType);
   }
@@ -291,6 +325,10 @@ public:
   /// Returns true if this function has qualified ownership instructions in it.
   bool hasQualifiedOwnership() const { return HasQualifiedOwnership; }
 
+  /// Returns the profiled entry count of this function, if there is one.
+  Optional<uint64_t> getEntryCount() const { return EntryCount; }
+  void setEntryCount(uint64_t Count) { EntryCount = Count; }
+
   /// Returns true if this function has unqualified ownership instructions in
   /// it.
   bool hasUnqualifiedOwnership() const { return !HasQualifiedOwnership; }
@@ -1316,8 +1316,13 @@ public:
 
 /// PartialApplyInst - Represents the creation of a closure object by partial
 /// application of a function value.
+///
+/// The context holding the partially applied arguments can be allocated on
+/// the stack if the closure does not escape. In that case its lifetime is
+/// ended by a dealloc_ref [stack] of the partial_apply.
 class PartialApplyInst
-    : public ApplyInstBase<PartialApplyInst, SILInstruction> {
+    : public ApplyInstBase<PartialApplyInst, SILInstruction>,
+      public StackPromotable {
   friend SILBuilder;
 
   PartialApplyInst(SILDebugLocation DebugLoc, SILValue Callee,
@@ -36,6 +36,7 @@
 #include "swift/SIL/TypeLowering.h"
 #include "swift/SIL/SILPrintContext.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/PointerIntPair.h"
 #include "llvm/ADT/SetVector.h"
@@ -43,6 +44,13 @@
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/raw_ostream.h"
 #include <functional>
+#include <vector>
+
+namespace llvm {
+namespace yaml {
+class Output;
+} // end namespace yaml
+} // end namespace llvm
 
 namespace swift {
   class AnyFunctionType;
@@ -104,6 +112,32 @@ private:
   /// Allocator that manages the memory of all the pieces of the SILModule.
   mutable llvm::BumpPtrAllocator BPA;
 
+  /// Instruction memory released by deallocateInst, as singly-linked free
+  /// lists indexed by size class.
+  ///
+  /// Instructions are carved out of \c BPA so that the instructions of a
+  /// function, which are usually created together, end up next to each other
+  /// rather than scattered across the heap. This needs to be declared before
+  /// \p functions so that it outlives the instructions it recycles.
+  mutable std::vector<void *> InstFreeLists;
+
+  /// The most recently allocated function change stamp.
+  uint64_t LastChangeStamp = 0;
+
+  /// The most recently allocated change stamp at the last call of
+  /// clearChanges.
+  uint64_t ChangesClearedStamp = 0;
+
+  /// The functions which were created or whose body changed since the last
+  /// call of clearChanges, not including erased functions. This needs to be
+  /// declared before \p functions because destroying a function changes its
+  /// body.
+  llvm::DenseSet<SILFunction *> ChangedFunctions;
+
+  /// The vtable and witness table entries which were added or removed since
+  /// the last call of clearChanges.
+  std::vector<std::pair<SILDeclRef, SILFunction *>> ChangedDispatchEntries;
+
   /// The swift Module associated with this SILModule.
   ModuleDecl *TheSwiftModule;
 
@@ -195,6 +229,13 @@ private:
   /// invalidation message is sent.
   llvm::SetVector<DeleteNotificationHandler*> NotificationHandlers;
 
+  /// The file which OptRecordStream writes to.
+  std::unique_ptr<llvm::raw_ostream> OptRecordRawStream;
+
+  /// If non-null, optimization remarks are also recorded as YAML into this
+  /// stream (-save-optimization-record).
+  std::unique_ptr<llvm::yaml::Output> OptRecordStream;
+
   // Intentionally marked private so that we need to use 'constructSIL()'
   // to construct a SILModule.
   SILModule(ModuleDecl *M, SILOptions &Options, const DeclContext *associatedDC,
@@ -296,6 +337,15 @@ public:
 
   SILOptions &getOptions() const { return Options; }
 
+  /// Returns the stream into which optimization remarks are recorded, or
+  /// null if they are not recorded.
+  llvm::yaml::Output *getOptRecordStream() { return OptRecordStream.get(); }
+
+  /// Record optimization remarks into \p Stream, which writes to
+  /// \p RawStream.
+  void setOptRecordStream(std::unique_ptr<llvm::yaml::Output> &&Stream,
+                          std::unique_ptr<llvm::raw_ostream> &&RawStream);
+
   using iterator = FunctionListType::iterator;
   using const_iterator = FunctionListType::const_iterator;
   FunctionListType &getFunctionList() { return functions; }
@@ -589,6 +639,50 @@ public:
   /// Allocate memory for an instruction using the module's internal allocator.
   void *allocateInst(unsigned Size, unsigned Align) const;
 
+  /// Returns a new change stamp for a function whose body changed. Each call
+  /// returns a larger value than all previous ones.
+  uint64_t allocateChangeStamp() { return ++LastChangeStamp; }
+
+  /// Returns the most recently allocated change stamp.
+  uint64_t getLastChangeStamp() const { return LastChangeStamp; }
+
+  /// Records that the body of \p F changed. Only needs to be called for the
+  /// first change after the last call of clearChanges.
+  void noteFunctionChanged(SILFunction *F) { ChangedFunctions.insert(F); }
+
+  /// Returns true if \p Stamp was allocated after the last call of
+  /// clearChanges.
+  bool isChangeStampUncleared(uint64_t Stamp) const {
+    return Stamp > ChangesClearedStamp;
+  }
+
+  /// Records that the vtable or witness table entry dispatching \p Method to
+  /// \p Impl was added or removed.
+  void noteDispatchEntryChanged(SILDeclRef Method, SILFunction *Impl) {
+    ChangedDispatchEntries.push_back({Method, Impl});
+  }
+
+  /// Returns the functions which were created or whose body changed since the
+  /// last call of clearChanges. Erased functions are not included.
+  const llvm::DenseSet<SILFunction *> &getChangedFunctions() const {
+    return ChangedFunctions;
+  }
+
+  /// Returns the vtable and witness table entries which were added or removed
+  /// since the last call of clearChanges. A removed entry's function may
+  /// have been erased since.
+  ArrayRef<std::pair<SILDeclRef, SILFunction *>>
+  getChangedDispatchEntries() const {
+    return ChangedDispatchEntries;
+  }
+
+  /// Forgets all changes recorded so far.
+  void clearChanges() {
+    ChangedFunctions.clear();
+    ChangedDispatchEntries.clear();
+    ChangesClearedStamp = LastChangeStamp;
+  }
+
   /// Deallocate memory of an instruction.
   void deallocateInst(SILInstruction *I);
 
@@ -241,6 +241,11 @@ public:
   /// Return all of the witness table entries.
   ArrayRef<Entry> getEntries() const { return Entries; }
 
+private:
+  /// Clears the method of the MethodWitness entry \p entry.
+  void removeWitnessMethod(Entry &entry);
+
+public:
   /// Clears methods in MethodWitness entries.
   /// \p predicate Returns true if the passed entry should be set to null.
   template <typename Predicate> void clearMethods_if(Predicate predicate) {
@@ -248,7 +253,7 @@ public:
       if (entry.getKind() == WitnessKind::Method) {
         const MethodWitness &MW = entry.getMethodWitness();
         if (predicate(MW)) {
-          entry.removeWitnessMethod();
+          removeWitnessMethod(entry);
         }
       }
     }
@@ -497,6 +497,10 @@ class TypeConverter {
   /// Mapping for types dependent on contextual generic parameters, which is
   /// cleared when the generic context is popped.
   llvm::DenseMap<CachingTypeKey, const TypeLowering *> DependentTypes;
+  /// Mapping for types whose lowering depends neither on their abstraction
+  /// pattern nor on the generic context, such as non-generic nominal types.
+  /// These are looked up by type alone, without building a caching key.
+  llvm::DenseMap<TypeBase *, const TypeLowering *> ContextFreeTypes;
   
   llvm::DenseMap<SILDeclRef, SILConstantInfo> ConstantTypes;
   
@@ -519,6 +523,7 @@ class TypeConverter {
 
   const TypeLowering &getTypeLoweringForLoweredType(TypeKey key);
   const TypeLowering &getTypeLoweringForUncachedLoweredType(TypeKey key);
+  const TypeLowering &getContextFreeTypeLowering(CanType type);
 
 public:
   SILModule &M;
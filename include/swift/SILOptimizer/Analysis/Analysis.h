@@ -15,6 +15,7 @@
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/SmallVector.h"
+#include "swift/Basic/LLVM.h"
 #include "swift/SIL/Notifications.h"
 #include <vector>
 
@@ -142,6 +143,19 @@ namespace swift {
 
     /// Verify that the function \p F can be used by the analysis.
     static void verifyFunction(SILFunction *F);
+
+    /// Returns the name of the analysis kind \p K.
+    static StringRef getAnalysisName(AnalysisKind K);
+
+  protected:
+    /// Records in the frontend statistics that this analysis computed its
+    /// result for \p Count functions in the module of \p F, or dropped results
+    /// when \p Invalidated is set.
+    ///
+    /// This makes it visible how often passes force an analysis to be
+    /// rebuilt from scratch.
+    void recordFunctionResults(SILFunction *F, unsigned Count,
+                               bool Invalidated) const;
   };
 
   // RAII helper for locking analyses.
@@ -185,16 +199,40 @@ namespace swift {
       verifyFunction(F);
 
       auto &it = Storage.FindAndConstruct(F);
-      if (!it.second)
+      if (!it.second) {
         it.second = newFunctionAnalysis(F);
+        recordFunctionResults(F, 1, /*Invalidated=*/false);
+      }
       return it.second;
     }
 
+    /// Returns the analysis provider for \p F if it has already been
+    /// computed and not invalidated since, or null otherwise.
+    ///
+    /// Transforms that can keep an analysis up to date while they change the
+    /// function use this to avoid computing it only for the sake of updating
+    /// it.
+    AnalysisTy *getIfComputed(SILFunction *F) const {
+      auto it = Storage.find(F);
+      if (it == Storage.end())
+        return nullptr;
+      return it->second;
+    }
+
     virtual void invalidate(SILAnalysis::InvalidationKind K) override {
       if (!shouldInvalidate(K)) return;
 
-      for (auto D : Storage)
+      unsigned NumInvalidated = 0;
+      SILFunction *AnyF = nullptr;
+      for (auto D : Storage) {
+        if (!D.second)
+          continue;
+        AnyF = D.first;
+        ++NumInvalidated;
         delete D.second;
+      }
+      if (AnyF)
+        recordFunctionResults(AnyF, NumInvalidated, /*Invalidated=*/true);
 
       Storage.clear();
     }
@@ -203,10 +241,11 @@ namespace swift {
                             SILAnalysis::InvalidationKind K) override {
       if (!shouldInvalidate(K)) return;
 
-      auto &it = Storage.FindAndConstruct(F);
-      if (it.second) {
-        delete it.second;
-        it.second = nullptr;
+      auto it = Storage.find(F);
+      if (it != Storage.end() && it->second) {
+        delete it->second;
+        it->second = nullptr;
+        recordFunctionResults(F, 1, /*Invalidated=*/true);
       }
     }
 
@@ -14,6 +14,7 @@
 #define SWIFT_SILOPTIMIZER_ANALYSIS_COLDBLOCKS_H
 
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Optional.h"
 #include "swift/SIL/SILValue.h"
 
 namespace swift {
@@ -61,6 +62,15 @@ public:
   }
 
   bool isCold(const SILBasicBlock *BB) { return isCold(BB, 0); }
+
+  /// Returns the execution count of \p BB as recorded by -profile-use, taken
+  /// from the nearest dominating block that has one, or None if the function
+  /// has no profile.
+  Optional<uint64_t> getProfileCount(const SILBasicBlock *BB);
+
+  /// \return true if the profile says \p BB runs more often than its function
+  /// is entered, e.g. because it is in a loop.
+  bool isProfiledHot(const SILBasicBlock *BB);
 };
 } // end namespace swift
 
@@ -396,6 +396,12 @@ public:
       return Values2Nodes.empty() && Nodes.empty() && UsePoints.empty();
     }
 
+    /// Returns true if the graph has more than \p Limit nodes. Nodes which
+    /// were merged into other nodes are counted, too.
+    bool exceedsNodeLimit(unsigned Limit) const {
+      return Nodes.size() > Limit;
+    }
+
     /// Removes all nodes from the graph.
     void clear();
     
@@ -637,7 +643,13 @@ private:
     MaxRecursionDepth = 3,
 
     /// A limit for the number of call-graph iterations in recompute().
-    MaxGraphMerges = 4
+    MaxGraphMerges = 4,
+
+    /// The maximum number of nodes in a function's connection graph. Once a
+    /// graph reaches this size, the remaining instructions and callee graphs
+    /// are handled conservatively, i.e. their operands are set to escaping.
+    /// This limits compile time for huge (e.g. generated) functions.
+    MaxGraphNodes = 10000
   };
 
   /// The connection graphs for all functions (does not include external
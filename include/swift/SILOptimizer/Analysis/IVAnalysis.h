@@ -31,7 +31,7 @@ public:
 public:
 
   /// A descriptor for an induction variable comprised of a header argument
-  /// (phi node) and an increment by an integer literal.
+  /// (phi node) and an increment or decrement by an integer literal.
   class IVDesc {
   public:
     BuiltinInst *Inc;
@@ -41,6 +41,10 @@ public:
     IVDesc(BuiltinInst *AI, IntegerLiteralInst *I) : Inc(AI), IncVal(I) {}
 
     operator bool() { return Inc != nullptr && IncVal != nullptr; }
+
+    /// Returns the signed amount the induction variable changes by in each
+    /// iteration. This is negative for a decrement.
+    APInt getStride() const;
     static IVDesc invalidIV() { return IVDesc(); }
   };
 
@@ -15,6 +15,8 @@
 #include "swift/SILOptimizer/PassManager/Passes.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/ErrorHandling.h"
@@ -25,12 +27,14 @@
 
 namespace swift {
 
+struct SILDeclRef;
 class SILFunction;
 class SILFunctionTransform;
 class SILModule;
 class SILModuleTransform;
 class SILOptions;
 class SILTransform;
+class ValueDecl;
 
 /// \brief The SIL pass manager.
 class SILPassManager {
@@ -78,6 +82,42 @@ class SILPassManager {
   /// A completed-passes mask for each function.
   llvm::DenseMap<SILFunction *, CompletedPasses> CompletedPassesMap;
 
+  /// The change stamp each function had when its completed-passes mask was
+  /// last updated. If the function changed since then without the change
+  /// being reported through invalidateAnalysis, its mask is stale.
+  llvm::DenseMap<SILFunction *, uint64_t> CompletedPassesStamps;
+
+  /// What a function's passes may depend on besides its own body.
+  struct FunctionDependencies {
+    /// The functions referenced through function_ref.
+    llvm::SmallVector<SILFunction *, 4> Functions;
+    /// The methods dispatched on through method instructions, each identified
+    /// by its most overridden declaration.
+    llvm::SmallVector<ValueDecl *, 2> Methods;
+  };
+
+  /// True once the dependency maps below cover the whole module.
+  bool HasDependencies = false;
+
+  /// The dependencies of each function, as of its last change.
+  llvm::DenseMap<SILFunction *, FunctionDependencies> Dependencies;
+
+  /// The functions which reference each function through function_ref.
+  llvm::DenseMap<SILFunction *, llvm::SmallPtrSet<SILFunction *, 4>>
+    Referrers;
+
+  /// The functions which dispatch on each method.
+  llvm::DenseMap<ValueDecl *, llvm::SmallPtrSet<SILFunction *, 4>>
+    DispatchUsers;
+
+  /// The methods each function implements in a vtable or witness table. Only
+  /// grows, so it may still list entries which were removed since.
+  llvm::DenseMap<SILFunction *, llvm::SmallVector<ValueDecl *, 2>>
+    ImplementedMethods;
+
+  /// The change stamp each function had when it was last verified.
+  llvm::DenseMap<SILFunction *, uint64_t> VerifiedChangeStamps;
+
   /// Stores for each function the number of levels of specializations it is
   /// derived from an original function. E.g. if a function is a signature
   /// optimized specialization of a generic specialization, it has level 2.
@@ -88,6 +128,21 @@ class SILPassManager {
   /// Set to true when a pass invalidates an analysis.
   bool CurrentPassHasInvalidated = false;
 
+  /// The number of times passes invalidated analyses so far.
+  unsigned NumInvalidations = 0;
+
+  /// What the runs of a pass cost, for -sil-pass-report.
+  struct PassReportEntry {
+    unsigned NumRuns = 0;
+    double Seconds = 0;
+    unsigned NumInvalidations = 0;
+    int64_t InstructionDelta = 0;
+  };
+
+  /// The cost of each pass which ran so far, keyed by the pass's name, if
+  /// -sil-pass-report is enabled.
+  llvm::MapVector<StringRef, PassReportEntry> PassReport;
+
   /// True if we need to stop running passes and restart again on the
   /// same function.
   bool RestartPipeline = false;
@@ -135,9 +190,10 @@ public:
         AP->invalidate(K);
 
     CurrentPassHasInvalidated = true;
+    ++NumInvalidations;
 
-    // Assume that all functions have changed. Clear all masks of all functions.
-    CompletedPassesMap.clear();
+    // Let passes run again on the functions that may be affected.
+    resetCompletedPassesOfChangedFunctions();
   }
 
   /// \brief Add the function \p F to the function pass worklist.
@@ -164,6 +220,7 @@ public:
         AP->invalidate(F, K);
     
     CurrentPassHasInvalidated = true;
+    ++NumInvalidations;
     // Any change let all passes run again.
     CompletedPassesMap[F].reset();
   }
@@ -179,14 +236,39 @@ public:
         AP->invalidateForDeadFunction(F, K);
     
     CurrentPassHasInvalidated = true;
-    // Any change let all passes run again.
-    CompletedPassesMap[F].reset();
+    ++NumInvalidations;
+    CompletedPassesMap.erase(F);
+    CompletedPassesStamps.erase(F);
+    removeDependencies(F);
+    Referrers.erase(F);
+    ImplementedMethods.erase(F);
   }
 
   /// \brief Reset the state of the pass manager and remove all transformation
   /// owned by the pass manager. Analysis passes will be kept.
   void resetAndRemoveTransformations();
 
+  /// Clears the completed-passes masks of all functions whose body changed
+  /// since the last module-wide invalidation, and of all functions that
+  /// directly or transitively depend on one of them, by referencing it or
+  /// dispatching to it through a vtable or witness table. Also clears the
+  /// masks of the functions dispatching on a method whose vtable or witness
+  /// table entries changed.
+  void resetCompletedPassesOfChangedFunctions();
+
+private:
+  /// Records the dependencies of the body of \p F, replacing the ones
+  /// recorded before.
+  void updateDependencies(SILFunction *F);
+
+  /// Forgets the dependencies of \p F, which is about to be erased.
+  void removeDependencies(SILFunction *F);
+
+  /// Records that \p Impl implements \p Method.
+  void addImplementedMethod(SILFunction *Impl, SILDeclRef Method);
+
+public:
+
   // Sets the name of the current optimization stage used for debugging.
   void setStageName(llvm::StringRef NextStage = "");
 
@@ -214,6 +296,7 @@ public:
 
   void executePassPipelinePlan(const SILPassPipelinePlan &Plan) {
     for (const SILPassPipeline &Pipeline : Plan.getPipelines()) {
+      captureStage(Plan, Pipeline);
       setStageName(Pipeline.Name);
       resetAndRemoveTransformations();
       for (PassKind Kind : Plan.getPipelinePasses(Pipeline)) {
@@ -237,6 +320,19 @@ private:
     }
   }
 
+  /// If -sil-capture-pipeline-dir is given, writes the module and the
+  /// passes of \p Pipeline to that directory before the pipeline runs, so
+  /// that sil-opt can replay it.
+  void captureStage(const SILPassPipelinePlan &Plan,
+                    const SILPassPipeline &Pipeline);
+
+  /// Records the cost of a run of \p T for -sil-pass-report.
+  void recordPassRun(SILTransform *T, double Seconds,
+                     unsigned NumInvalidations, int64_t InstructionDelta);
+
+  /// Prints the -sil-pass-report table.
+  void printPassReport(llvm::raw_ostream &OS) const;
+
   /// Add a pass of a specific kind.
   void addPass(PassKind Kind);
 
@@ -262,6 +358,19 @@ private:
   /// Return true if all analyses are unlocked.
   bool analysesUnlocked();
 
+  /// Returns true if \p F should be verified after the current pass, given
+  /// the -sil-verify-changed-only and -sil-verify-sample-rate options.
+  /// \p IsKnownChanged is true if the pass invalidated F, in which case F
+  /// counts as changed whatever its change stamp says.
+  bool shouldVerify(SILFunction *F, bool IsKnownChanged = false) const;
+
+  /// Verify \p F and remember the state it was verified in.
+  void verifyFunction(SILFunction *F);
+
+  /// Verify the module after a module pass, or only some of its functions if
+  /// partial verification was requested.
+  void verifyModule();
+
   /// Displays the call graph in an external dot-viewer.
   /// This function is meant for use from the debugger.
   /// When asserts are disabled, this is a NoOp.
@@ -47,6 +47,16 @@ APInt constantFoldDiv(APInt lhs, APInt rhs, bool &Overflow, BuiltinValueKind ID)
   /// The \p ID must be the ID of a trunc/sext/zext builtin.
 APInt constantFoldCast(APInt val, const BuiltinInfo &BI);
 
+/// Evaluates a global initializer function at compile time.
+///
+/// If \p InitF computes a constant value out of integer, floating point and
+/// string literals, possibly across several basic blocks, and stores it
+/// into a single global variable, replace its body with the straight-line
+/// form which can be emitted as static data: only literals, struct and
+/// tuple instructions and a single store. Returns true if the function was
+/// rewritten.
+bool evaluateGlobalInitializer(SILFunction *InitF);
+
 } // End namespace swift.
 
 #endif
@@ -29,6 +29,7 @@
 
 namespace swift {
 
+class AbstractFunctionDecl;
 class ClassDecl;
 class DeclContext;
 class EnumDecl;
@@ -149,6 +150,9 @@ public:
     case PayloadKind::TypeDeclResolution:
       Payload.TypeDeclResolution = T.Payload.TypeDeclResolution;
       break;
+    case PayloadKind::Function:
+      Payload.Function = T.Payload.Function;
+      break;
     }
     return *this;
   }
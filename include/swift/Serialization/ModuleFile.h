@@ -21,6 +21,7 @@
 #include "swift/AST/RawComment.h"
 #include "swift/AST/TypeLoc.h"
 #include "swift/Serialization/ModuleFormat.h"
+#include "swift/Serialization/SerializedModuleLoader.h"
 #include "swift/Serialization/Validation.h"
 #include "swift/Basic/LLVM.h"
 #include "llvm/ADT/ArrayRef.h"
@@ -75,12 +76,24 @@ class ModuleFile : public LazyMemberLoader {
   /// The target the module was built for.
   StringRef TargetTriple;
 
+  /// The hash of the module's public interface, if it was recorded.
+  StringRef InterfaceHash;
+
   /// The data blob containing all of the module's identifiers.
+  ///
+  /// \sa identifier_block::IdentifierDataLayout
   StringRef IdentifierData;
 
+  /// The offsets in IdentifierData of the identifiers stored in full.
+  std::vector<serialization::CharOffset> IdentifierRestarts;
+
   /// A callback to be invoked every time a type was deserialized.
   std::function<void(Type)> DeserializedTypeCallback;
 
+  /// The types found by cross-references from any module file in the
+  /// ASTContext, if this module file was loaded by a SerializedModuleLoader.
+  XRefTypeCache *SharedXRefTypes = nullptr;
+
 public:
   /// Represents another module that has been imported as a dependency.
   class Dependency {
@@ -488,6 +501,14 @@ private:
   /// after reading. Nothing should ever follow a MEMBERS record.
   bool readMembers(SmallVectorImpl<Decl *> &Members);
 
+  /// Reads the raw contents of a MEMBERS record from \c DeclTypeCursor:
+  /// alternating member DeclIDs and the IdentifierIDs of their base names.
+  ///
+  /// Returns true if there is an error. The same caveats apply as for
+  /// readMembers.
+  bool readRawMembers(SmallVectorImpl<uint64_t> &scratch,
+                      ArrayRef<uint64_t> &rawMemberIDsAndNames);
+
   /// Populates the protocol's default witness table.
   ///
   /// Returns true if there is an error.
@@ -652,6 +673,14 @@ public:
   /// shadowed clang module.
   void getDisplayDecls(SmallVectorImpl<Decl*> &results);
 
+  /// Shares the types found by cross-references with the other module files
+  /// using \p cache.
+  void setXRefTypeCache(XRefTypeCache *cache) { SharedXRefTypes = cache; }
+
+  /// Returns the hash of the module's public interface, or an empty string
+  /// if the module doesn't record one.
+  StringRef getInterfaceHash() const { return InterfaceHash; }
+
   StringRef getModuleFilename() const {
     // FIXME: This seems fragile, maybe store the filename separately ?
     return ModuleInputBuffer->getBufferIdentifier();
@@ -665,6 +694,10 @@ public:
   virtual void loadAllMembers(Decl *D,
                               uint64_t contextData) override;
 
+  virtual bool
+  loadNamedMembers(const Decl *D, Identifier N, uint64_t contextData,
+                   SmallVectorImpl<ValueDecl *> &Members) override;
+
   virtual void
   loadAllConformances(const Decl *D, uint64_t contextData,
                     SmallVectorImpl<ProtocolConformance*> &Conforms) override;
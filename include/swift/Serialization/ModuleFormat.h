@@ -54,10 +54,11 @@ const uint16_t VERSION_MAJOR = 0;
 /// in source control, you should also update the comment to briefly
 /// describe what change you made. The content of this comment isn't important;
 /// it just ensures a conflict if two people change the module format.
-const uint16_t VERSION_MINOR = 298; // Last change: Added {store,begin}_borrow
+const uint16_t VERSION_MINOR = 302; // Last change: front-coded identifiers
 
 using DeclID = PointerEmbeddedInt<unsigned, 31>;
-using DeclIDField = BCFixed<31>;
+// Most IDs are small, so they take up less space in chunks.
+using DeclIDField = BCVBR<8>;
 
 // TypeID must be the same as DeclID because it is stored in the same way.
 using TypeID = DeclID;
@@ -418,7 +419,8 @@ namespace control_block {
   enum {
     METADATA = 1,
     MODULE_NAME,
-    TARGET
+    TARGET,
+    INTERFACE_HASH
   };
 
   using MetadataLayout = BCRecordLayout<
@@ -438,6 +440,11 @@ namespace control_block {
     TARGET,
     BCBlob // LLVM triple
   >;
+
+  using InterfaceHashLayout = BCRecordLayout<
+    INTERFACE_HASH,
+    BCBlob // MD5 of the public interface, as 32 hex digits
+  >;
 }
 
 /// The record types within the options block (a sub-block of the control
@@ -1145,6 +1152,9 @@ namespace decls_block {
     ModuleIDField // the module in which the conformance can be found
   >;
 
+  /// Each member's ID is followed by the IdentifierID of its base name (or 0
+  /// if it doesn't have one), so that members can be loaded by name without
+  /// deserializing the others.
   using MembersLayout = BCRecordLayout<
     MEMBERS,
     BCArray<DeclIDField>
@@ -1393,10 +1403,25 @@ static inline decls_block::RecordKind getKindForTable(const Decl *D) {
 /// \sa IDENTIFIER_BLOCK_ID
 namespace identifier_block {
   enum {
-    IDENTIFIER_DATA = 1
+    IDENTIFIER_DATA = 1,
+    IDENTIFIER_RESTARTS
   };
 
+  /// The identifiers are sorted and front-coded. Each one is stored as the
+  /// length of the prefix it shares with the one before it, as a varint,
+  /// followed by the rest of its characters and a null byte.
+  ///
+  /// Every IDENTIFIER_RESTART_INTERVAL-th identifier is stored in full, so
+  /// that one can be decoded without reading all the ones before it.
   using IdentifierDataLayout = BCRecordLayout<IDENTIFIER_DATA, BCBlob>;
+
+  /// The offsets in the identifier data of the identifiers stored in full.
+  using IdentifierRestartsLayout = BCRecordLayout<
+    IDENTIFIER_RESTARTS,
+    BCArray<CharOffsetField>
+  >;
+
+  const unsigned IDENTIFIER_RESTART_INTERVAL = 16;
 };
 
 /// The record types within the index block.
@@ -20,6 +20,15 @@
 namespace swift {
 class ModuleFile;
 
+/// The types found by the first piece of cross-references in serialized
+/// modules, keyed by the module and name that were looked up.
+///
+/// This is shared by all the module files in an ASTContext, so that a type
+/// many modules refer to, often one imported from Clang, is only looked up
+/// once.
+using XRefTypeCache =
+  llvm::DenseMap<std::pair<const ModuleDecl *, Identifier>, ValueDecl *>;
+
 /// \brief Imports serialized Swift modules into an ASTContext.
 class SerializedModuleLoader : public ModuleLoader {
 private:
@@ -29,6 +38,9 @@ private:
   using LoadedModulePair = std::pair<std::unique_ptr<ModuleFile>, unsigned>;
   std::vector<LoadedModulePair> LoadedModuleFiles;
 
+  /// Shared by the loaded module files.
+  XRefTypeCache XRefTypes;
+
   explicit SerializedModuleLoader(ASTContext &ctx, DependencyTracker *tracker);
 
 public:
@@ -112,6 +124,10 @@ class SerializedASTFile final : public LoadedFile {
 public:
   bool isSIB() const { return IsSIB; }
 
+  /// Returns the hash of the module's public interface, or an empty string
+  /// if the module doesn't record one.
+  StringRef getInterfaceHash() const;
+
   virtual bool isSystemModule() const override;
 
   virtual void lookupValue(Module::AccessPathTy accessPath,
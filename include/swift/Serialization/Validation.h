@@ -71,6 +71,7 @@ struct ValidationInfo {
   StringRef name = {};
   StringRef targetTriple = {};
   StringRef shortVersion = {};
+  StringRef interfaceHash = {};
   size_t bytes = 0;
   Status status = Status::Malformed;
 };
@@ -27,7 +27,7 @@
 
 /// Minor version changes when new APIs are added in ABI- and source-compatible
 /// way.
-#define SWIFT_DEMANGLE_VERSION_MINOR 2
+#define SWIFT_DEMANGLE_VERSION_MINOR 3
 
 /// @}
 
@@ -53,6 +53,41 @@ size_t swift_demangle_getSimplifiedDemangledName(const char *MangledName,
                                                  char *OutputBuffer,
                                                  size_t Length);
 
+/// @{
+/// Bulk demangling.
+///
+/// A demangle context keeps the memory of the demangler alive between calls,
+/// so clients which demangle many names, e.g. all the frames of a batch of
+/// crash reports, don't pay for setting up the demangler for every name.
+///
+/// A context is not thread-safe. Clients which demangle on several threads
+/// should create a context per thread.
+
+/// An opaque demangle context.
+typedef struct swift_demangle_context_s *swift_demangle_context_t;
+
+/// \brief Creates a demangle context. Dispose it with
+/// \c swift_demangle_disposeContext().
+swift_demangle_context_t swift_demangle_createContext(void);
+
+/// \brief Frees a demangle context created by
+/// \c swift_demangle_createContext().
+void swift_demangle_disposeContext(swift_demangle_context_t Context);
+
+/// \brief Like \c swift_demangle_getDemangledName(), but reuses the memory of
+/// \p Context.
+size_t swift_demangle_getDemangledNameInContext(
+    swift_demangle_context_t Context, const char *MangledName,
+    char *OutputBuffer, size_t Length);
+
+/// \brief Like \c swift_demangle_getSimplifiedDemangledName(), but reuses
+/// the memory of \p Context.
+size_t swift_demangle_getSimplifiedDemangledNameInContext(
+    swift_demangle_context_t Context, const char *MangledName,
+    char *OutputBuffer, size_t Length);
+
+/// @}
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -30,7 +30,7 @@
 
 /// Minor version changes when new APIs are added in ABI- and source-compatible
 /// way.
-#define SWIFT_REFLECTION_VERSION_MINOR 0
+#define SWIFT_REFLECTION_VERSION_MINOR 1
 
 #ifdef __cplusplus
 extern "C" {
@@ -50,6 +50,26 @@ swift_reflection_createReflectionContext(
     GetStringLengthFunction getStringLength,
     GetSymbolAddressFunction getSymbolAddress);
 
+/// \returns An opaque reflection context which reads the memory of the
+/// target a page at a time and keeps the pages it has read.
+///
+/// Call swift_reflection_clearCaches() whenever the target may have changed
+/// its memory, e.g. after it was resumed.
+SwiftReflectionContextRef
+swift_reflection_createCachingReflectionContext(
+    void *ReaderContext,
+    PointerSizeFunction getPointerSize,
+    SizeSizeFunction getSizeSize,
+    ReadBytesFunction readBytes,
+    GetStringLengthFunction getStringLength,
+    GetSymbolAddressFunction getSymbolAddress);
+
+/// Forgets everything the reflection context has read from the target,
+/// except for the reflection sections added with
+/// swift_reflection_addReflectionInfo().
+void
+swift_reflection_clearCaches(SwiftReflectionContextRef ContextRef);
+
 /// Destroys an opaque reflection context.
 void
 swift_reflection_destroyReflectionContext(SwiftReflectionContextRef Context);
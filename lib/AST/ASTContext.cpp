@@ -1274,7 +1274,7 @@ ArchetypeBuilder *ASTContext::getOrCreateArchetypeBuilder(
 GenericEnvironment *ASTContext::getOrCreateCanonicalGenericEnvironment(
                                                     ArchetypeBuilder *builder) {
   auto known = Impl.CanonicalGenericEnvironments.find(builder);
-  if (known != Impl.CanonicalGenericEnvironments.find(builder))
+  if (known != Impl.CanonicalGenericEnvironments.end())
     return known->second;
 
   auto sig = builder->getGenericSignature();
@@ -2552,6 +2552,7 @@ Type TupleType::get(ArrayRef<TupleTypeElt> Fields, const ASTContext &C) {
 
   TupleType *New =
       new (C, arena) TupleType(Fields, IsCanonical ? &C : nullptr, properties);
+  New->setProfileHash(ID.ComputeHash());
   C.Impl.getArena(arena).TupleTypes.InsertNode(New, InsertPos);
   return New;
 }
@@ -2651,6 +2652,7 @@ BoundGenericType *BoundGenericType::get(NominalTypeDecl *TheDecl,
     newType = new (C, arena) BoundGenericEnumType(
         theEnum, Parent, ArgsCopy, IsCanonical ? &C : nullptr, properties);
   }
+  newType->setProfileHash(ID.ComputeHash());
   C.Impl.getArena(arena).BoundGenericTypes.InsertNode(newType, InsertPos);
 
   return newType;
@@ -2782,6 +2784,7 @@ ProtocolCompositionType::build(const ASTContext &C, ArrayRef<Type> Protocols) {
     = new (C, AllocationArena::Permanent)
         ProtocolCompositionType(isCanonical ? &C : nullptr,
                                 C.AllocateCopy(Protocols));
+  New->setProfileHash(ID.ComputeHash());
   C.Impl.ProtocolCompositionTypes.InsertNode(New, InsertPos);
   return New;
 }
@@ -3038,6 +3041,7 @@ GenericFunctionType::get(GenericSignature *sig,
                                               isCanonical ? &ctx : nullptr,
                                               properties);
 
+  result->setProfileHash(id.ComputeHash());
   ctx.Impl.GenericFunctionTypes.InsertNode(result, insertPos);
   return result;
 }
@@ -749,6 +749,19 @@ static ValueDecl *getDeallocOperation(ASTContext &Context, Identifier Id) {
   return getBuiltinFunction(Id, ArgElts, ResultTy);
 }
 
+static ValueDecl *getStackAllocOperation(ASTContext &Context, Identifier Id) {
+  Type PtrSizeTy = BuiltinIntegerType::getWordType(Context);
+  Type ResultTy = Context.TheRawPointerType;
+  return getBuiltinFunction(Id, { PtrSizeTy }, ResultTy);
+}
+
+static ValueDecl *getStackDeallocOperation(ASTContext &Context,
+                                           Identifier Id) {
+  Type ArgElts[] = { Context.TheRawPointerType };
+  Type ResultTy = TupleType::getEmpty(Context);
+  return getBuiltinFunction(Id, ArgElts, ResultTy);
+}
+
 static ValueDecl *getFenceOperation(ASTContext &Context, Identifier Id) {
   return getBuiltinFunction(Id, {}, TupleType::getEmpty(Context));
 }
@@ -1637,6 +1650,12 @@ ValueDecl *swift::getBuiltinValueDecl(ASTContext &Context, Identifier Id) {
   case BuiltinValueKind::DeallocRaw:
     return getDeallocOperation(Context, Id);
 
+  case BuiltinValueKind::StackAlloc:
+    return getStackAllocOperation(Context, Id);
+
+  case BuiltinValueKind::StackDealloc:
+    return getStackDeallocOperation(Context, Id);
+
   case BuiltinValueKind::CastToNativeObject:
   case BuiltinValueKind::CastFromNativeObject:
   case BuiltinValueKind::CastToUnknownObject:
@@ -274,6 +274,9 @@ void ConformanceLookupTable::updateLookupTable(NominalTypeDecl *nominal,
     // Record all of the explicit conformances.
     forEachInStage(stage, nominal, resolver,
                    [&](NominalTypeDecl *nominal) {
+                     if (SerializedContexts.count(nominal))
+                       return;
+
                      if (resolver)
                        resolver->resolveInheritanceClause(nominal);
 
@@ -282,6 +285,9 @@ void ConformanceLookupTable::updateLookupTable(NominalTypeDecl *nominal,
                                   resolver);
                    },
                    [&](ExtensionDecl *ext) {
+                     if (SerializedContexts.count(ext))
+                       return;
+
                      if (resolver)
                        resolver->resolveInheritanceClause(ext);
 
@@ -348,10 +354,12 @@ void ConformanceLookupTable::updateLookupTable(NominalTypeDecl *nominal,
     // Expand inherited conformances.
     forEachInStage(stage, nominal, resolver,
                    [&](NominalTypeDecl *nominal) {
-                     expandImpliedConformances(nominal, nominal, resolver);
+                     if (!SerializedContexts.count(nominal))
+                       expandImpliedConformances(nominal, nominal, resolver);
                    },
                    [&](ExtensionDecl *ext) {
-                     expandImpliedConformances(nominal, ext, resolver);
+                     if (!SerializedContexts.count(ext))
+                       expandImpliedConformances(nominal, ext, resolver);
                    });
     break;
 
@@ -410,6 +418,11 @@ void ConformanceLookupTable::loadAllConformances(
   for (auto conformance : conformances) {
     registerProtocolConformance(conformance);
   }
+
+  // Conformances from a serialized module are already complete.
+  auto file = dyn_cast<FileUnit>(dc->getModuleScopeContext());
+  if (file && file->getKind() == FileUnitKind::SerializedAST)
+    SerializedContexts.insert(dc);
 }
 
 namespace {
@@ -27,6 +27,7 @@
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/PointerUnion.h"
 #include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include <unordered_map>
 
 namespace swift {
@@ -309,6 +310,15 @@ class ConformanceLookupTable {
 
   typedef llvm::SmallVector<ProtocolDecl *, 2> ProtocolList;
 
+  /// Declaration contexts whose conformances were loaded from a serialized
+  /// module.
+  ///
+  /// A serialized module records the complete, resolved set of conformances
+  /// for each context, including implied ones, so these contexts don't need
+  /// their inheritance clauses scanned or their implied conformances
+  /// expanded again.
+  llvm::SmallPtrSet<DeclContext *, 4> SerializedContexts;
+
   /// List of all of the protocols to which a given context declares
   /// conformance, both explicitly and implicitly.
   llvm::MapVector<DeclContext *, SmallVector<ConformanceEntry *, 4>>
@@ -940,6 +940,30 @@ void IterableDeclContext::loadAllMembers() const {
   --NumUnloadedLazyIterableDeclContexts;
 }
 
+bool IterableDeclContext::loadNamedMembers(
+    Identifier name, SmallVectorImpl<ValueDecl *> &members) const {
+  assert(hasLazyMembers() && "members have already been loaded");
+
+  ASTContext &ctx = getASTContext();
+  auto contextInfo = ctx.getOrCreateLazyIterableContextData(this,
+                                                            /*loader=*/nullptr);
+
+  const Decl *container = nullptr;
+  switch (getIterableContextKind()) {
+  case IterableDeclContextKind::NominalTypeDecl:
+    container = cast<NominalTypeDecl>(this);
+    break;
+
+  case IterableDeclContextKind::ExtensionDecl:
+    container = cast<ExtensionDecl>(this);
+    break;
+  }
+
+  return contextInfo->loader->loadNamedMembers(container, name,
+                                               contextInfo->memberData,
+                                               members);
+}
+
 bool IterableDeclContext::classof(const Decl *D) {
   switch (D->getKind()) {
 #define DECL(ID, PARENT)              case DeclKind::ID: return false;
@@ -25,6 +25,7 @@
 #include "swift/Basic/SourceManager.h"
 #include "swift/Parse/Lexer.h" // bad dependency
 #include "swift/Config.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/raw_ostream.h"
@@ -77,6 +78,8 @@ static StoredDiagnosticInfo storedDiagnosticInfos[] = {
   StoredDiagnosticInfo(DiagnosticKind::Warning, DiagnosticOptions::Options),
 #define NOTE(ID, Options, Text, Signature)                                     \
   StoredDiagnosticInfo(DiagnosticKind::Note, DiagnosticOptions::Options),
+#define REMARK(ID, Options, Text, Signature)                                   \
+  StoredDiagnosticInfo(DiagnosticKind::Remark, DiagnosticOptions::Options),
 #include "swift/AST/DiagnosticsAll.def"
 };
 static_assert(sizeof(storedDiagnosticInfos) / sizeof(StoredDiagnosticInfo) ==
@@ -87,6 +90,7 @@ static const char *diagnosticStrings[] = {
 #define ERROR(ID, Options, Text, Signature) Text,
 #define WARNING(ID, Options, Text, Signature) Text,
 #define NOTE(ID, Options, Text, Signature) Text,
+#define REMARK(ID, Options, Text, Signature) Text,
 #include "swift/AST/DiagnosticsAll.def"
     "<not a diagnostic>",
 };
@@ -513,6 +517,8 @@ static DiagnosticKind toDiagnosticKind(DiagnosticState::Behavior behavior) {
     return DiagnosticKind::Error;
   case DiagnosticState::Behavior::Note:
     return DiagnosticKind::Note;
+  case DiagnosticState::Behavior::Remark:
+    return DiagnosticKind::Remark;
   case DiagnosticState::Behavior::Warning:
     return DiagnosticKind::Warning;
   }
@@ -576,6 +582,8 @@ DiagnosticState::Behavior DiagnosticState::determineBehavior(DiagID id) {
     return set(diagInfo.isFatal ? Behavior::Fatal : Behavior::Error);
   case DiagnosticKind::Warning:
     return set(Behavior::Warning);
+  case DiagnosticKind::Remark:
+    return set(Behavior::Remark);
   }
 }
 
@@ -601,6 +609,11 @@ void DiagnosticEngine::emitDiagnostic(const Diagnostic &diagnostic) {
   if (behavior == DiagnosticState::Behavior::Ignore)
     return;
 
+  // Nobody is listening, e.g. while code completion re-typechecks code in
+  // the REPL. Don't bother pretty-printing declarations or formatting.
+  if (Consumers.empty())
+    return;
+
   // Figure out the source location.
   SourceLoc loc = diagnostic.getLoc();
   if (loc.isInvalid() && diagnostic.getDecl()) {
@@ -715,9 +728,14 @@ void DiagnosticEngine::emitDiagnostic(const Diagnostic &diagnostic) {
     }
   }
 
-  // Actually substitute the diagnostic arguments into the diagnostic text.
+  // Actually substitute the diagnostic arguments into the diagnostic text,
+  // unless all the consumers ignore it. Printing types and declarations
+  // isn't free.
   llvm::SmallString<256> Text;
-  {
+  bool needsText = llvm::any_of(Consumers, [](DiagnosticConsumer *consumer) {
+    return consumer->needsDiagnosticText();
+  });
+  if (needsText) {
     llvm::raw_svector_ostream Out(Text);
     formatDiagnosticText(diagnosticStrings[(unsigned)diagnostic.getID()],
                          diagnostic.getArgs(), Out);
@@ -1395,6 +1395,11 @@ bool SourceFile::hasTestableImport(const swift::Module *module) const {
 }
 
 void SourceFile::clearLookupCache() {
+  // Unqualified lookups from any file can see this file's top-level decls.
+  for (auto *file : getParentModule()->getFiles())
+    if (auto *SF = dyn_cast<SourceFile>(file))
+      SF->UnqualifiedLookups.clear();
+
   if (!Cache)
     return;
 
@@ -1403,6 +1408,32 @@ void SourceFile::clearLookupCache() {
   Cache.reset();
 }
 
+const TinyPtrVector<ValueDecl *> *
+SourceFile::getCachedUnqualifiedLookup(DeclName name, unsigned flags) const {
+  if (UnqualifiedLookupsGeneration != getASTContext().getCurrentGeneration()) {
+    UnqualifiedLookups.clear();
+    UnqualifiedLookupsGeneration = getASTContext().getCurrentGeneration();
+    return nullptr;
+  }
+
+  auto known = UnqualifiedLookups.find({name, flags});
+  if (known == UnqualifiedLookups.end())
+    return nullptr;
+  return &known->second;
+}
+
+void SourceFile::cacheUnqualifiedLookup(DeclName name, unsigned flags,
+                                        ArrayRef<ValueDecl *> results) const {
+  if (UnqualifiedLookupsGeneration != getASTContext().getCurrentGeneration()) {
+    UnqualifiedLookups.clear();
+    UnqualifiedLookupsGeneration = getASTContext().getCurrentGeneration();
+  }
+  auto &cached = UnqualifiedLookups[{name, flags}];
+  cached.clear();
+  for (auto *VD : results)
+    cached.push_back(VD);
+}
+
 void
 SourceFile::cacheVisibleDecls(SmallVectorImpl<ValueDecl*> &&globals) const {
   SmallVectorImpl<ValueDecl*> &cached = getCache().AllVisibleValues;
@@ -923,12 +923,29 @@ UnqualifiedLookup::UnqualifiedLookup(DeclName Name, DeclContext *DC,
   if (auto FU = dyn_cast<FileUnit>(DC))
     FU->getImportedModules(extraImports, Module::ImportFilter::Private);
 
+  // Module-scope results only depend on the name, the kind of lookup and the
+  // file we're looking from, so non-REPL source files remember them. Without
+  // a type resolver, shadowing depends on what has been validated so far.
+  auto *cachingSF = dyn_cast<SourceFile>(DC);
+  if (cachingSF && (cachingSF->Kind == SourceFileKind::REPL ||
+                    DebugClient || !TypeResolver))
+    cachingSF = nullptr;
+  unsigned cacheFlags = IsTypeLookup ? 1 : 0;
+
   using namespace namelookup;
   SmallVector<ValueDecl *, 8> CurModuleResults;
-  auto resolutionKind =
-    IsTypeLookup ? ResolutionKind::TypesOnly : ResolutionKind::Overloadable;
-  lookupInModule(&M, {}, Name, CurModuleResults, NLKind::UnqualifiedLookup,
-                 resolutionKind, TypeResolver, DC, extraImports);
+  if (auto *cached = cachingSF ? cachingSF->getCachedUnqualifiedLookup(
+                                     Name, cacheFlags)
+                               : nullptr) {
+    CurModuleResults.append(cached->begin(), cached->end());
+  } else {
+    auto resolutionKind =
+      IsTypeLookup ? ResolutionKind::TypesOnly : ResolutionKind::Overloadable;
+    lookupInModule(&M, {}, Name, CurModuleResults, NLKind::UnqualifiedLookup,
+                   resolutionKind, TypeResolver, DC, extraImports);
+    if (cachingSF)
+      cachingSF->cacheUnqualifiedLookup(Name, cacheFlags, CurModuleResults);
+  }
 
   for (auto VD : CurModuleResults)
     Results.push_back(UnqualifiedLookupResult(VD));
@@ -1000,6 +1017,11 @@ class swift::MemberLookupTable {
   /// Lookup table mapping names to the set of declarations with that name.
   LookupTable Lookup;
 
+  /// The base names whose members have all been added to the table without
+  /// walking the full member lists, along with the last extension that was
+  /// known at the time.
+  llvm::DenseMap<Identifier, ExtensionDecl *> NamesLoadedLazily;
+
 public:
   /// Create a new member lookup table.
   explicit MemberLookupTable(ASTContext &ctx);
@@ -1022,6 +1044,20 @@ public:
                            ExtensionDecl *ext,
                            DeclRange members);
 
+  /// Whether every member with the given base name, in the nominal type and
+  /// all of its current extensions, has already been added.
+  bool isLazilyComplete(NominalTypeDecl *nominal, Identifier name) const {
+    auto known = NamesLoadedLazily.find(name);
+    return known != NamesLoadedLazily.end() &&
+           known->second == nominal->LastExtension;
+  }
+
+  /// Note that every member with the given base name in the nominal type and
+  /// all of its current extensions has been added.
+  void markLazilyComplete(NominalTypeDecl *nominal, Identifier name) {
+    NamesLoadedLazily[name] = nominal->LastExtension;
+  }
+
   /// Iterator into the lookup table.
   typedef LookupTable::iterator iterator;
 
@@ -1202,6 +1238,53 @@ void NominalTypeDecl::prepareLookupTable(bool ignoreNewExtensions) {
   }
 }
 
+bool NominalTypeDecl::prepareLookupTableForName(Identifier name) {
+  // Once the members have been walked, the full table is cheaper.
+  if (LookupTable.getInt() || !hasLazyMembers())
+    return false;
+
+  // Protocols read their default witness tables along with their members, so
+  // always load those in full.
+  if (isa<ProtocolDecl>(this))
+    return false;
+
+  // Make sure we have the complete list of extensions.
+  auto extensions = getExtensions();
+
+  if (!LookupTable.getPointer()) {
+    auto &ctx = getASTContext();
+    LookupTable.setPointer(new (ctx) MemberLookupTable(ctx));
+  }
+  auto *table = LookupTable.getPointer();
+  if (table->isLazilyComplete(this, name))
+    return true;
+
+  // Collect everything first, so that the table is left alone if some
+  // context can't load its members by name.
+  SmallVector<ValueDecl *, 4> members;
+  if (!loadNamedMembers(name, members))
+    return false;
+
+  for (auto ext : extensions) {
+    if (ext->hasLazyMembers()) {
+      if (!ext->loadNamedMembers(name, members))
+        return false;
+      continue;
+    }
+
+    for (auto member : ext->getMembers()) {
+      auto VD = dyn_cast<ValueDecl>(member);
+      if (VD && VD->getName() == name)
+        members.push_back(VD);
+    }
+  }
+
+  for (auto member : members)
+    table->addMember(member);
+  table->markLazilyComplete(this, name);
+  return true;
+}
+
 void NominalTypeDecl::makeMemberVisible(ValueDecl *member) {
   if (!LookupTable.getPointer()) {
     auto &ctx = getASTContext();
@@ -1213,6 +1296,17 @@ void NominalTypeDecl::makeMemberVisible(ValueDecl *member) {
 
 ArrayRef<ValueDecl *> NominalTypeDecl::lookupDirect(DeclName name,
                                                     bool ignoreNewExtensions) {
+  // If the members haven't been loaded yet, try to load only the ones with
+  // this name.
+  if (!ignoreNewExtensions &&
+      getASTContext().LangOpts.NamedLazyMemberLoading &&
+      prepareLookupTableForName(name.getBaseName())) {
+    auto known = LookupTable.getPointer()->find(name);
+    if (known == LookupTable.getPointer()->end())
+      return { };
+    return { known->second.begin(), known->second.size() };
+  }
+
   // Make sure we have the complete list of members (in this nominal and in all
   // extensions).
   if (!ignoreNewExtensions) {
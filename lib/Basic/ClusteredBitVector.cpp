@@ -22,15 +22,52 @@
 using namespace swift;
 
 ClusteredBitVector ClusteredBitVector::fromAPInt(const llvm::APInt &bits) {
-  // This is not a very efficient algorithm.
   ClusteredBitVector result;
-  for (unsigned i = 0, e = bits.getBitWidth(); i != e; ++i) {
-    if (bits[i]) {
-      result.appendSetBits(1);
-    } else {
-      result.appendClearBits(1);
-    }
+  auto numBits = bits.getBitWidth();
+  if (numBits == 0)
+    return result;
+
+  // Don't allocate space for zero bits.
+  if (bits == 0) {
+    result.appendClearBits(numBits);
+    return result;
+  }
+
+  // Copy a chunk at a time.  This assumes that the chunk size is the same
+  // as APInt's, and relies on APInt keeping its unused high bits clear.
+  result.reserve(numBits);
+  result.appendReserved(numBits, bits.getRawData());
+  return result;
+}
+
+ClusteredBitVector ClusteredBitVector::getSlice(size_t start,
+                                                size_t numBits) const {
+  assert(start + numBits <= size());
+  ClusteredBitVector result;
+  if (numBits == 0)
+    return result;
+
+  if (isInlineAndAllClear()) {
+    result.appendClearBits(numBits);
+    return result;
   }
+
+  // Extract a chunk's worth of bits at a time, combining the ends of
+  // adjacent chunks if the slice doesn't start on a chunk boundary.
+  const ChunkType *chunks = getChunksPtr();
+  size_t nextBit = start;
+  result.reserve(numBits);
+  result.appendReserved(numBits, [&](size_t numBitsWanted) -> ChunkType {
+    auto index = nextBit / ChunkSizeInBits;
+    auto offset = nextBit % ChunkSizeInBits;
+    ChunkType value = chunks[index] >> offset;
+    if (offset && offset + numBitsWanted > ChunkSizeInBits)
+      value |= chunks[index + 1] << (ChunkSizeInBits - offset);
+    if (numBitsWanted != ChunkSizeInBits)
+      value &= (ChunkType(1) << numBitsWanted) - 1;
+    nextBit += numBitsWanted;
+    return value;
+  });
   return result;
 }
 
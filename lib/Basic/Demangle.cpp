@@ -29,6 +29,7 @@
 #include <vector>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 
 using namespace swift;
 using namespace Demangle;
@@ -91,25 +92,54 @@ static DemanglerPrinter &operator<<(DemanglerPrinter &printer,
   return printer;
 }
 
-Node::~Node() {
-  switch (NodePayloadKind) {
-  case PayloadKind::None: return;
-  case PayloadKind::Index: return;
-  case PayloadKind::Text: TextPayload.~basic_string(); return;
+NodeFactory::~NodeFactory() {
+  while (CurrentSlab) {
+    Slab *Previous = CurrentSlab->Previous;
+    free(CurrentSlab);
+    CurrentSlab = Previous;
   }
-  unreachable("bad payload kind");
 }
 
-namespace {
-  struct FindPtr {
-    FindPtr(Node *v) : Target(v) {}
-    bool operator()(NodePointer sp) const {
-      return sp.get() == Target;
-    }
-  private:
-    Node *Target;
-  };
-} // end anonymous namespace
+void NodeFactory::clear() {
+  if (!CurrentSlab)
+    return;
+
+  // Free all but the most recent, and largest, slab.
+  while (Slab *Previous = CurrentSlab->Previous) {
+    CurrentSlab->Previous = Previous->Previous;
+    free(Previous);
+  }
+  CurPtr = reinterpret_cast<char *>(CurrentSlab + 1);
+  End = CurPtr + CurrentSlab->Size;
+}
+
+void *NodeFactory::allocateInNewSlab(size_t Size, size_t Alignment) {
+  // Objects which don't fit into a regular slab get a slab of their own.
+  size_t SlabSize = std::max(size_t(NextSlabSize), Size + Alignment);
+  if (NextSlabSize < MaxSlabSize)
+    NextSlabSize *= 2;
+
+  auto *NewSlab = static_cast<Slab *>(malloc(sizeof(Slab) + SlabSize));
+  if (!NewSlab)
+    unreachable("out of memory");
+  NewSlab->Previous = CurrentSlab;
+  NewSlab->Size = SlabSize;
+  CurrentSlab = NewSlab;
+  CurPtr = reinterpret_cast<char *>(NewSlab + 1);
+  End = CurPtr + SlabSize;
+
+  void *Result = allocate(Size, Alignment);
+  assert(Result && "slab is too small");
+  return Result;
+}
+
+StringRef NodeFactory::copyString(StringRef Text) {
+  if (Text.empty())
+    return StringRef();
+  char *Copy = allocate<char>(Text.size());
+  memcpy(Copy, Text.data(), Text.size());
+  return StringRef(Copy, Text.size());
+}
 
 static bool isStartOfIdentifier(char c) {
   if (c >= '0' && c <= '9')
@@ -298,8 +328,10 @@ static StringRef toString(ValueWitnessKind k) {
 class Demangler {
   std::vector<NodePointer> Substitutions;
   NameSource Mangled;
+  NodeFactory &Factory;
 public:  
-  Demangler(llvm::StringRef mangled) : Mangled(mangled) {}
+  Demangler(llvm::StringRef mangled, NodeFactory &Factory)
+    : Mangled(mangled), Factory(Factory) {}
 
 /// Try to demangle a child node of the given kind.  If that fails,
 /// return; otherwise add it to the parent.
@@ -314,8 +346,8 @@ public:
 #define DEMANGLE_CHILD_AS_NODE_OR_RETURN(PARENT, CHILD_KIND) do {  \
     auto _kind = demangle##CHILD_KIND();                           \
     if (!_kind.hasValue()) return nullptr;                         \
-    (PARENT)->addChild(NodeFactory::create(Node::Kind::CHILD_KIND, \
-                                           unsigned(*_kind)));     \
+    (PARENT)->addChild(Factory.create(Node::Kind::CHILD_KIND,      \
+                                      unsigned(*_kind)));          \
   } while (false)
 
   /// Attempt to demangle the source string.  The root node will
@@ -327,14 +359,14 @@ public:
   NodePointer demangleTopLevel() {
 #ifndef NO_NEW_DEMANGLING
     if (Mangled.str().startswith(MANGLING_PREFIX_STR)) {
-      NewMangling::Demangler D(Mangled.str());
+      NewMangling::Demangler D(Mangled.str(), Factory);
       return D.demangleTopLevel();
     }
 #endif
     if (!Mangled.nextIf("_T"))
       return nullptr;
 
-    NodePointer topLevel = NodeFactory::create(Node::Kind::Global);
+    NodePointer topLevel = Factory.create(Node::Kind::Global);
 
     // First demangle any specialization prefixes.
     if (Mangled.nextIf("TS")) {
@@ -351,23 +383,23 @@ public:
         return nullptr;
 
     } else if (Mangled.nextIf("To")) {
-      topLevel->addChild(NodeFactory::create(Node::Kind::ObjCAttribute));
+      topLevel->addChild(Factory.create(Node::Kind::ObjCAttribute));
     } else if (Mangled.nextIf("TO")) {
-      topLevel->addChild(NodeFactory::create(Node::Kind::NonObjCAttribute));
+      topLevel->addChild(Factory.create(Node::Kind::NonObjCAttribute));
     } else if (Mangled.nextIf("TD")) {
-      topLevel->addChild(NodeFactory::create(Node::Kind::DynamicAttribute));
+      topLevel->addChild(Factory.create(Node::Kind::DynamicAttribute));
     } else if (Mangled.nextIf("Td")) {
-      topLevel->addChild(NodeFactory::create(
+      topLevel->addChild(Factory.create(
                                    Node::Kind::DirectMethodReferenceAttribute));
     } else if (Mangled.nextIf("TV")) {
-      topLevel->addChild(NodeFactory::create(Node::Kind::VTableAttribute));
+      topLevel->addChild(Factory.create(Node::Kind::VTableAttribute));
     }
 
     DEMANGLE_CHILD_OR_RETURN(topLevel, Global);
 
     // Add a suffix node if there's anything left unmangled.
     if (!Mangled.isEmpty()) {
-      topLevel->addChild(NodeFactory::create(Node::Kind::Suffix,
+      topLevel->addChild(Factory.create(Node::Kind::Suffix,
                                              Mangled.getString()));
     }
 
@@ -445,43 +477,43 @@ private:
     if (Mangled.nextIf('M')) {
       if (Mangled.nextIf('P')) {
         auto pattern =
-            NodeFactory::create(Node::Kind::GenericTypeMetadataPattern);
+            Factory.create(Node::Kind::GenericTypeMetadataPattern);
         DEMANGLE_CHILD_OR_RETURN(pattern, Type);
         return pattern;
       }
       if (Mangled.nextIf('a')) {
         auto accessor =
-          NodeFactory::create(Node::Kind::TypeMetadataAccessFunction);
+          Factory.create(Node::Kind::TypeMetadataAccessFunction);
         DEMANGLE_CHILD_OR_RETURN(accessor, Type);
         return accessor;
       }
       if (Mangled.nextIf('L')) {
-        auto cache = NodeFactory::create(Node::Kind::TypeMetadataLazyCache);
+        auto cache = Factory.create(Node::Kind::TypeMetadataLazyCache);
         DEMANGLE_CHILD_OR_RETURN(cache, Type);
         return cache;
       }
       if (Mangled.nextIf('m')) {
-        auto metaclass = NodeFactory::create(Node::Kind::Metaclass);
+        auto metaclass = Factory.create(Node::Kind::Metaclass);
         DEMANGLE_CHILD_OR_RETURN(metaclass, Type);
         return metaclass;
       }
       if (Mangled.nextIf('n')) {
         auto nominalType =
-            NodeFactory::create(Node::Kind::NominalTypeDescriptor);
+            Factory.create(Node::Kind::NominalTypeDescriptor);
         DEMANGLE_CHILD_OR_RETURN(nominalType, Type);
         return nominalType;
       }
       if (Mangled.nextIf('f')) {
-        auto metadata = NodeFactory::create(Node::Kind::FullTypeMetadata);
+        auto metadata = Factory.create(Node::Kind::FullTypeMetadata);
         DEMANGLE_CHILD_OR_RETURN(metadata, Type);
         return metadata;
       }
       if (Mangled.nextIf('p')) {
-        auto metadata = NodeFactory::create(Node::Kind::ProtocolDescriptor);
+        auto metadata = Factory.create(Node::Kind::ProtocolDescriptor);
         DEMANGLE_CHILD_OR_RETURN(metadata, ProtocolName);
         return metadata;
       }
-      auto metadata = NodeFactory::create(Node::Kind::TypeMetadata);
+      auto metadata = Factory.create(Node::Kind::TypeMetadata);
       DEMANGLE_CHILD_OR_RETURN(metadata, Type);
       return metadata;
     }
@@ -491,7 +523,7 @@ private:
       Node::Kind kind = Node::Kind::PartialApplyForwarder;
       if (Mangled.nextIf('o'))
         kind = Node::Kind::PartialApplyObjCForwarder;
-      auto forwarder = NodeFactory::create(kind);
+      auto forwarder = Factory.create(kind);
       if (Mangled.nextIf("__T"))
         DEMANGLE_CHILD_OR_RETURN(forwarder, Global);
       return forwarder;
@@ -499,7 +531,7 @@ private:
 
     // Top-level types, for various consumers.
     if (Mangled.nextIf('t')) {
-      auto type = NodeFactory::create(Node::Kind::TypeMangling);
+      auto type = Factory.create(Node::Kind::TypeMangling);
       DEMANGLE_CHILD_OR_RETURN(type, Type);
       return type;
     }
@@ -510,7 +542,7 @@ private:
       if (!w.hasValue())
         return nullptr;
       auto witness =
-        NodeFactory::create(Node::Kind::ValueWitness, unsigned(w.getValue()));
+        Factory.create(Node::Kind::ValueWitness, unsigned(w.getValue()));
       DEMANGLE_CHILD_OR_RETURN(witness, Type);
       return witness;
     }
@@ -518,69 +550,69 @@ private:
     // Offsets, value witness tables, and protocol witnesses.
     if (Mangled.nextIf('W')) {
       if (Mangled.nextIf('V')) {
-        auto witnessTable = NodeFactory::create(Node::Kind::ValueWitnessTable);
+        auto witnessTable = Factory.create(Node::Kind::ValueWitnessTable);
         DEMANGLE_CHILD_OR_RETURN(witnessTable, Type);
         return witnessTable;
       }
       if (Mangled.nextIf('o')) {
         auto witnessTableOffset =
-            NodeFactory::create(Node::Kind::WitnessTableOffset);
+            Factory.create(Node::Kind::WitnessTableOffset);
         DEMANGLE_CHILD_OR_RETURN(witnessTableOffset, Entity);
         return witnessTableOffset;
       }
       if (Mangled.nextIf('v')) {
-        auto fieldOffset = NodeFactory::create(Node::Kind::FieldOffset);
+        auto fieldOffset = Factory.create(Node::Kind::FieldOffset);
         DEMANGLE_CHILD_AS_NODE_OR_RETURN(fieldOffset, Directness);
         DEMANGLE_CHILD_OR_RETURN(fieldOffset, Entity);
         return fieldOffset;
       }
       if (Mangled.nextIf('P')) {
         auto witnessTable =
-            NodeFactory::create(Node::Kind::ProtocolWitnessTable);
+            Factory.create(Node::Kind::ProtocolWitnessTable);
         DEMANGLE_CHILD_OR_RETURN(witnessTable, ProtocolConformance);
         return witnessTable;
       }
       if (Mangled.nextIf('G')) {
         auto witnessTable =
-            NodeFactory::create(Node::Kind::GenericProtocolWitnessTable);
+            Factory.create(Node::Kind::GenericProtocolWitnessTable);
         DEMANGLE_CHILD_OR_RETURN(witnessTable, ProtocolConformance);
         return witnessTable;
       }
       if (Mangled.nextIf('I')) {
-        auto witnessTable = NodeFactory::create(
+        auto witnessTable = Factory.create(
             Node::Kind::GenericProtocolWitnessTableInstantiationFunction);
         DEMANGLE_CHILD_OR_RETURN(witnessTable, ProtocolConformance);
         return witnessTable;
       }
       if (Mangled.nextIf('l')) {
         auto accessor =
-          NodeFactory::create(Node::Kind::LazyProtocolWitnessTableAccessor);
+          Factory.create(Node::Kind::LazyProtocolWitnessTableAccessor);
         DEMANGLE_CHILD_OR_RETURN(accessor, Type);
         DEMANGLE_CHILD_OR_RETURN(accessor, ProtocolConformance);
         return accessor;
       }
       if (Mangled.nextIf('L')) {
         auto accessor =
-          NodeFactory::create(Node::Kind::LazyProtocolWitnessTableCacheVariable);
+          Factory.create(Node::Kind::LazyProtocolWitnessTableCacheVariable);
         DEMANGLE_CHILD_OR_RETURN(accessor, Type);
         DEMANGLE_CHILD_OR_RETURN(accessor, ProtocolConformance);
         return accessor;
       }
       if (Mangled.nextIf('a')) {
         auto tableTemplate =
-          NodeFactory::create(Node::Kind::ProtocolWitnessTableAccessor);
+          Factory.create(Node::Kind::ProtocolWitnessTableAccessor);
         DEMANGLE_CHILD_OR_RETURN(tableTemplate, ProtocolConformance);
         return tableTemplate;
       }
       if (Mangled.nextIf('t')) {
-        auto accessor = NodeFactory::create(
+        auto accessor = Factory.create(
             Node::Kind::AssociatedTypeMetadataAccessor);
         DEMANGLE_CHILD_OR_RETURN(accessor, ProtocolConformance);
         DEMANGLE_CHILD_OR_RETURN(accessor, DeclName);
         return accessor;
       }
       if (Mangled.nextIf('T')) {
-        auto accessor = NodeFactory::create(
+        auto accessor = Factory.create(
             Node::Kind::AssociatedTypeWitnessTableAccessor);
         DEMANGLE_CHILD_OR_RETURN(accessor, ProtocolConformance);
         DEMANGLE_CHILD_OR_RETURN(accessor, DeclName);
@@ -593,19 +625,19 @@ private:
     // Other thunks.
     if (Mangled.nextIf('T')) {
       if (Mangled.nextIf('R')) {
-        auto thunk = NodeFactory::create(Node::Kind::ReabstractionThunkHelper);
+        auto thunk = Factory.create(Node::Kind::ReabstractionThunkHelper);
         if (!demangleReabstractSignature(thunk))
           return nullptr;
         return thunk;
       }
       if (Mangled.nextIf('r')) {
-        auto thunk = NodeFactory::create(Node::Kind::ReabstractionThunk);
+        auto thunk = Factory.create(Node::Kind::ReabstractionThunk);
         if (!demangleReabstractSignature(thunk))
           return nullptr;
         return thunk;
       }
       if (Mangled.nextIf('W')) {
-        NodePointer thunk = NodeFactory::create(Node::Kind::ProtocolWitness);
+        NodePointer thunk = Factory.create(Node::Kind::ProtocolWitness);
         DEMANGLE_CHILD_OR_RETURN(thunk, ProtocolConformance);
         // The entity is mangled in its own generic context.
         DEMANGLE_CHILD_OR_RETURN(thunk, Entity);
@@ -621,7 +653,7 @@ private:
   NodePointer demangleGenericSpecialization(NodePointer specialization) {
     while (!Mangled.nextIf('_')) {
       // Otherwise, we have another parameter. Demangle the type.
-      NodePointer param = NodeFactory::create(Node::Kind::GenericSpecializationParam);
+      NodePointer param = Factory.create(Node::Kind::GenericSpecializationParam);
       DEMANGLE_CHILD_OR_RETURN(param, Type);
 
       // Then parse any conformances until we find an underscore. Pop off the
@@ -639,10 +671,10 @@ private:
 
 /// TODO: This is an atrocity. Come up with a shorter name.
 #define FUNCSIGSPEC_CREATE_PARAM_KIND(kind)                                    \
-  NodeFactory::create(Node::Kind::FunctionSignatureSpecializationParamKind,    \
+  Factory.create(Node::Kind::FunctionSignatureSpecializationParamKind,    \
                       unsigned(FunctionSigSpecializationParamKind::kind))
 #define FUNCSIGSPEC_CREATE_PARAM_PAYLOAD(payload)                              \
-  NodeFactory::create(Node::Kind::FunctionSignatureSpecializationParamPayload, \
+  Factory.create(Node::Kind::FunctionSignatureSpecializationParamPayload, \
                       payload)
 
   bool demangleFuncSigSpecializationConstantProp(NodePointer parent) {
@@ -729,7 +761,7 @@ private:
     parent->addChild(FUNCSIGSPEC_CREATE_PARAM_PAYLOAD(name->getText()));
 
     // Then demangle types until we fail.
-    NodePointer type;
+    NodePointer type = nullptr;
     while (Mangled.peek() != '_' && (type = demangleType())) {
       parent->addChild(type);
     }
@@ -749,7 +781,7 @@ private:
     while (!Mangled.nextIf('_')) {
       // Create the parameter.
       NodePointer param =
-        NodeFactory::create(Node::Kind::FunctionSignatureSpecializationParam,
+        Factory.create(Node::Kind::FunctionSignatureSpecializationParam,
                             paramCount);
 
       // First handle options.
@@ -794,7 +826,7 @@ private:
         if (!Value)
           return nullptr;
 
-        auto result = NodeFactory::create(
+        auto result = Factory.create(
             Node::Kind::FunctionSignatureSpecializationParamKind, Value);
         if (!result)
           return nullptr;
@@ -814,18 +846,18 @@ private:
   NodePointer demangleSpecializedAttribute() {
     bool isNotReAbstracted = false;
     if (Mangled.nextIf("g") || (isNotReAbstracted = Mangled.nextIf("r"))) {
-      auto spec = NodeFactory::create(isNotReAbstracted ?
+      auto spec = Factory.create(isNotReAbstracted ?
                               Node::Kind::GenericSpecializationNotReAbstracted :
                               Node::Kind::GenericSpecialization);
 
       // Create a node if the specialization is externally inlineable.
       if (Mangled.nextIf("q")) {
         auto kind = Node::Kind::SpecializationIsFragile;
-        spec->addChild(NodeFactory::create(kind));
+        spec->addChild(Factory.create(kind));
       }
 
       // Create a node for the pass id.
-      spec->addChild(NodeFactory::create(Node::Kind::SpecializationPassID,
+      spec->addChild(Factory.create(Node::Kind::SpecializationPassID,
                                          unsigned(Mangled.next() - 48)));
 
       // And then mangle the generic specialization.
@@ -833,16 +865,16 @@ private:
     }
     if (Mangled.nextIf("f")) {
       auto spec =
-          NodeFactory::create(Node::Kind::FunctionSignatureSpecialization);
+          Factory.create(Node::Kind::FunctionSignatureSpecialization);
 
       // Create a node if the specialization is externally inlineable.
       if (Mangled.nextIf("q")) {
         auto kind = Node::Kind::SpecializationIsFragile;
-        spec->addChild(NodeFactory::create(kind));
+        spec->addChild(Factory.create(kind));
       }
 
       // Add the pass id.
-      spec->addChild(NodeFactory::create(Node::Kind::SpecializationPassID,
+      spec->addChild(Factory.create(Node::Kind::SpecializationPassID,
                                          unsigned(Mangled.next() - 48)));
 
       // Then perform the function signature specialization.
@@ -863,7 +895,7 @@ private:
       NodePointer name = demangleIdentifier();
       if (!name) return nullptr;
 
-      NodePointer localName = NodeFactory::create(Node::Kind::LocalDeclName);
+      NodePointer localName = Factory.create(Node::Kind::LocalDeclName);
       localName->addChild(std::move(discriminator));
       localName->addChild(std::move(name));
       return localName;
@@ -875,7 +907,7 @@ private:
       NodePointer name = demangleIdentifier();
       if (!name) return nullptr;
 
-      auto privateName = NodeFactory::create(Node::Kind::PrivateDeclName);
+      auto privateName = Factory.create(Node::Kind::PrivateDeclName);
       privateName->addChildren(std::move(discriminator), std::move(name));
       return privateName;
     }
@@ -961,7 +993,7 @@ private:
       identifier = opDecodeBuffer;
     }
     
-    return NodeFactory::create(*kind, identifier);
+    return Factory.create(*kind, identifier);
   }
 
   bool demangleIndex(Node::IndexType &natural) {
@@ -983,13 +1015,13 @@ private:
     Node::IndexType index;
     if (!demangleIndex(index))
       return nullptr;
-    return NodeFactory::create(kind, index);
+    return Factory.create(kind, index);
   }
 
   NodePointer createSwiftType(Node::Kind typeKind, StringRef name) {
-    NodePointer type = NodeFactory::create(typeKind);
-    type->addChild(NodeFactory::create(Node::Kind::Module, STDLIB_NAME));
-    type->addChild(NodeFactory::create(Node::Kind::Identifier, name));
+    NodePointer type = Factory.create(typeKind);
+    type->addChild(Factory.create(Node::Kind::Module, STDLIB_NAME));
+    type->addChild(Factory.create(Node::Kind::Identifier, name));
     return type;
   }
 
@@ -998,9 +1030,9 @@ private:
     if (!Mangled)
       return nullptr;
     if (Mangled.nextIf('o'))
-      return NodeFactory::create(Node::Kind::Module, MANGLING_MODULE_OBJC);
+      return Factory.create(Node::Kind::Module, MANGLING_MODULE_OBJC);
     if (Mangled.nextIf('C'))
-      return NodeFactory::create(Node::Kind::Module, MANGLING_MODULE_C);
+      return Factory.create(Node::Kind::Module, MANGLING_MODULE_C);
     if (Mangled.nextIf('a'))
       return createSwiftType(Node::Kind::Structure, "Array");
     if (Mangled.nextIf('b'))
@@ -1043,7 +1075,7 @@ private:
 
   NodePointer demangleModule() {
     if (Mangled.nextIf('s')) {
-      return NodeFactory::create(Node::Kind::Module, STDLIB_NAME);
+      return Factory.create(Node::Kind::Module, STDLIB_NAME);
     }
     if (Mangled.nextIf('S')) {
       NodePointer module = demangleSubstitutionIndex();
@@ -1067,7 +1099,7 @@ private:
     auto name = demangleDeclName();
     if (!name) return nullptr;
 
-    auto decl = NodeFactory::create(kind);
+    auto decl = Factory.create(kind);
     decl->addChild(context);
     decl->addChild(name);
     Substitutions.push_back(decl);
@@ -1078,7 +1110,7 @@ private:
     NodePointer proto = demangleProtocolNameImpl();
     if (!proto) return nullptr;
 
-    NodePointer type = NodeFactory::create(Node::Kind::Type);
+    NodePointer type = Factory.create(Node::Kind::Type);
     type->addChild(proto);
     return type;
   }
@@ -1087,7 +1119,7 @@ private:
     NodePointer name = demangleDeclName();
     if (!name) return nullptr;
 
-    auto proto = NodeFactory::create(Node::Kind::Protocol);
+    auto proto = Factory.create(Node::Kind::Protocol);
     proto->addChild(std::move(context));
     proto->addChild(std::move(name));
     Substitutions.push_back(proto);
@@ -1112,7 +1144,7 @@ private:
     }
 
     if (Mangled.nextIf('s')) {
-      NodePointer stdlib = NodeFactory::create(Node::Kind::Module, STDLIB_NAME);
+      NodePointer stdlib = Factory.create(Node::Kind::Module, STDLIB_NAME);
 
       return demangleProtocolNameGivenContext(stdlib);
     }
@@ -1145,14 +1177,14 @@ private:
 
       // Rebuild this type with the new parent type, which may have
       // had its generic arguments applied.
-      NodePointer result = NodeFactory::create(nominalType->getKind());
+      NodePointer result = Factory.create(nominalType->getKind());
       result->addChild(parentOrModule);
       result->addChild(nominalType->getChild(1));
 
       nominalType = result;
     }
 
-    NodePointer args = NodeFactory::create(Node::Kind::TypeList);
+    NodePointer args = Factory.create(Node::Kind::TypeList);
     while (!Mangled.nextIf('_')) {
       NodePointer type = demangleType();
       if (!type)
@@ -1169,7 +1201,7 @@ private:
 
     // Otherwise, build a bound generic type node from the unbound
     // type and arguments.
-    NodePointer unboundType = NodeFactory::create(Node::Kind::Type);
+    NodePointer unboundType = Factory.create(Node::Kind::Type);
     unboundType->addChild(nominalType);
 
     Node::Kind kind;
@@ -1186,7 +1218,7 @@ private:
       default:
         return nullptr;
     }
-    NodePointer result = NodeFactory::create(kind);
+    NodePointer result = Factory.create(kind);
     result->addChild(unboundType);
     result->addChild(args);
     return result;
@@ -1211,7 +1243,7 @@ private:
     // context ::= 'e' module context generic-signature (constrained extension)
     if (!Mangled) return nullptr;
     if (Mangled.nextIf('E')) {
-      NodePointer ext = NodeFactory::create(Node::Kind::Extension);
+      NodePointer ext = Factory.create(Node::Kind::Extension);
       NodePointer def_module = demangleModule();
       if (!def_module) return nullptr;
       NodePointer type = demangleContext();
@@ -1221,7 +1253,7 @@ private:
       return ext;
     }
     if (Mangled.nextIf('e')) {
-      NodePointer ext = NodeFactory::create(Node::Kind::Extension);
+      NodePointer ext = Factory.create(Node::Kind::Extension);
       NodePointer def_module = demangleModule();
       if (!def_module) return nullptr;
       NodePointer sig = demangleGenericSignature();
@@ -1240,7 +1272,7 @@ private:
     if (Mangled.nextIf('S'))
       return demangleSubstitutionIndex();
     if (Mangled.nextIf('s'))
-      return NodeFactory::create(Node::Kind::Module, STDLIB_NAME);
+      return Factory.create(Node::Kind::Module, STDLIB_NAME);
     if (Mangled.nextIf('G'))
       return demangleBoundGenericType();
     if (isStartOfEntity(Mangled.peek()))
@@ -1249,8 +1281,8 @@ private:
   }
   
   NodePointer demangleProtocolList() {
-    NodePointer proto_list = NodeFactory::create(Node::Kind::ProtocolList);
-    NodePointer type_list = NodeFactory::create(Node::Kind::TypeList);
+    NodePointer proto_list = Factory.create(Node::Kind::ProtocolList);
+    NodePointer type_list = Factory.create(Node::Kind::TypeList);
     proto_list->addChild(type_list);
     while (!Mangled.nextIf('_')) {
       NodePointer proto = demangleProtocolName();
@@ -1272,7 +1304,7 @@ private:
     if (!context)
       return nullptr;
     NodePointer proto_conformance =
-        NodeFactory::create(Node::Kind::ProtocolConformance);
+        Factory.create(Node::Kind::ProtocolConformance);
     proto_conformance->addChild(type);
     proto_conformance->addChild(protocol);
     proto_conformance->addChild(context);
@@ -1305,7 +1337,7 @@ private:
     // entity-name
     Node::Kind entityKind;
     bool hasType = true;
-    NodePointer name;
+    NodePointer name = nullptr;
     if (Mangled.nextIf('D')) {
       entityKind = Node::Kind::Deallocator;
       hasType = false;
@@ -1401,7 +1433,7 @@ private:
       if (!name) return nullptr;
     }
 
-    NodePointer entity = NodeFactory::create(entityKind);
+    NodePointer entity = Factory.create(entityKind);
     entity->addChild(context);
 
     if (name) entity->addChild(name);
@@ -1413,7 +1445,7 @@ private:
     }
     
     if (isStatic) {
-      auto staticNode = NodeFactory::create(Node::Kind::Static);
+      auto staticNode = Factory.create(Node::Kind::Static);
       staticNode->addChild(entity);
       return staticNode;
     }
@@ -1423,10 +1455,10 @@ private:
 
   NodePointer demangleArchetypeRef(Node::IndexType depth, Node::IndexType i) {
     // FIXME: Name won't match demangled context generic signatures correctly.
-    auto ref = NodeFactory::create(Node::Kind::ArchetypeRef,
+    auto ref = Factory.create(Node::Kind::ArchetypeRef,
                                    archetypeName(i, depth));
-    ref->addChild(NodeFactory::create(Node::Kind::Index, depth));
-    ref->addChild(NodeFactory::create(Node::Kind::Index, i));
+    ref->addChild(Factory.create(Node::Kind::Index, depth));
+    ref->addChild(Factory.create(Node::Kind::Index, i));
     return ref;
   }
 
@@ -1434,10 +1466,10 @@ private:
     DemanglerPrinter PrintName;
     PrintName << archetypeName(index, depth);
 
-    auto paramTy = NodeFactory::create(Node::Kind::DependentGenericParamType,
+    auto paramTy = Factory.create(Node::Kind::DependentGenericParamType,
                                        std::move(PrintName).str());
-    paramTy->addChild(NodeFactory::create(Node::Kind::Index, depth));
-    paramTy->addChild(NodeFactory::create(Node::Kind::Index, index));
+    paramTy->addChild(Factory.create(Node::Kind::Index, depth));
+    paramTy->addChild(Factory.create(Node::Kind::Index, index));
 
     return paramTy;
   }
@@ -1466,7 +1498,7 @@ private:
   NodePointer demangleDependentMemberTypeName(NodePointer base) {
     assert(base->getKind() == Node::Kind::Type
            && "base should be a type");
-    NodePointer assocTy;
+    NodePointer assocTy = nullptr;
 
     if (Mangled.nextIf('S')) {
       assocTy = demangleSubstitutionIndex();
@@ -1492,7 +1524,7 @@ private:
       Substitutions.push_back(assocTy);
     }
 
-    NodePointer depTy = NodeFactory::create(Node::Kind::DependentMemberType);
+    NodePointer depTy = Factory.create(Node::Kind::DependentMemberType);
     depTy->addChild(base);
     depTy->addChild(assocTy);
     return depTy;
@@ -1504,7 +1536,7 @@ private:
     if (!base)
       return nullptr;
 
-    NodePointer nodeType = NodeFactory::create(Node::Kind::Type);
+    NodePointer nodeType = Factory.create(Node::Kind::Type);
     nodeType->addChild(base);
 
     // Demangle the associated type name.
@@ -1519,7 +1551,7 @@ private:
 
     // Demangle the associated type chain.
     while (!Mangled.nextIf('_')) {
-      NodePointer nodeType = NodeFactory::create(Node::Kind::Type);
+      NodePointer nodeType = Factory.create(Node::Kind::Type);
       nodeType->addChild(base);
       
       base = demangleDependentMemberTypeName(nodeType);
@@ -1563,14 +1595,14 @@ private:
     if (!type)
       return nullptr;
 
-    NodePointer nodeType = NodeFactory::create(Node::Kind::Type);
+    NodePointer nodeType = Factory.create(Node::Kind::Type);
     nodeType->addChild(type);
     return nodeType;
   }
 
   NodePointer demangleGenericSignature(bool isPseudogeneric = false) {
     auto sig =
-      NodeFactory::create(isPseudogeneric
+      Factory.create(isPseudogeneric
                             ? Node::Kind::DependentPseudogenericSignature
                             : Node::Kind::DependentGenericSignature);
     // First read in the parameter counts at each depth.
@@ -1578,7 +1610,7 @@ private:
     
     auto addCount = [&]{
       auto countNode =
-        NodeFactory::create(Node::Kind::DependentGenericParamCount, count);
+        Factory.create(Node::Kind::DependentGenericParamCount, count);
       sig->addChild(countNode);
     };
     
@@ -1617,13 +1649,13 @@ private:
 
   NodePointer demangleMetatypeRepresentation() {
     if (Mangled.nextIf('t'))
-      return NodeFactory::create(Node::Kind::MetatypeRepresentation, "@thin");
+      return Factory.create(Node::Kind::MetatypeRepresentation, "@thin");
 
     if (Mangled.nextIf('T'))
-      return NodeFactory::create(Node::Kind::MetatypeRepresentation, "@thick");
+      return Factory.create(Node::Kind::MetatypeRepresentation, "@thick");
 
     if (Mangled.nextIf('o'))
-      return NodeFactory::create(Node::Kind::MetatypeRepresentation,
+      return Factory.create(Node::Kind::MetatypeRepresentation,
                                  "@objc_metatype");
 
     unreachable("Unhandled metatype representation");
@@ -1636,7 +1668,7 @@ private:
     if (Mangled.nextIf('z')) {
       NodePointer second = demangleType();
       if (!second) return nullptr;
-      auto reqt = NodeFactory::create(
+      auto reqt = Factory.create(
           Node::Kind::DependentGenericSameTypeRequirement);
       reqt->addChild(constrainedType);
       reqt->addChild(second);
@@ -1647,7 +1679,7 @@ private:
     // will begin with either 'C' or 'S'.
     if (!Mangled)
       return nullptr;
-    NodePointer constraint;
+    NodePointer constraint = nullptr;
 
     auto next = Mangled.peek();
 
@@ -1657,7 +1689,7 @@ private:
     } else if (next == 'S') {
       // A substitution may be either the module name of a protocol or a full
       // type name.
-      NodePointer typeName;
+      NodePointer typeName = nullptr;
       Mangled.next();
       NodePointer sub = demangleSubstitutionIndex();
       if (!sub) return nullptr;
@@ -1671,14 +1703,14 @@ private:
       } else {
         return nullptr;
       }
-      constraint = NodeFactory::create(Node::Kind::Type);
+      constraint = Factory.create(Node::Kind::Type);
       constraint->addChild(typeName);
     } else {
       constraint = demangleProtocolName();
       if (!constraint)
         return nullptr;
     }
-    auto reqt = NodeFactory::create(
+    auto reqt = Factory.create(
                           Node::Kind::DependentGenericConformanceRequirement);
     reqt->addChild(constrainedType);
     reqt->addChild(constraint);
@@ -1689,7 +1721,7 @@ private:
     auto makeAssociatedType = [&](NodePointer root) -> NodePointer {
       NodePointer name = demangleIdentifier();
       if (!name) return nullptr;
-      auto assocType = NodeFactory::create(Node::Kind::AssociatedTypeRef);
+      auto assocType = Factory.create(Node::Kind::AssociatedTypeRef);
       assocType->addChild(root);
       assocType->addChild(name);
       Substitutions.push_back(assocType);
@@ -1707,7 +1739,7 @@ private:
       return makeAssociatedType(sub);
     }
     if (Mangled.nextIf('s')) {
-      NodePointer stdlib = NodeFactory::create(Node::Kind::Module, STDLIB_NAME);
+      NodePointer stdlib = Factory.create(Node::Kind::Module, STDLIB_NAME);
       return makeAssociatedType(stdlib);
     }
     if (Mangled.nextIf('d')) {
@@ -1722,12 +1754,12 @@ private:
       NodePointer index = demangleIndexAsNode();
       if (!index)
         return nullptr;
-      NodePointer decl_ctx = NodeFactory::create(Node::Kind::DeclContext);
+      NodePointer decl_ctx = Factory.create(Node::Kind::DeclContext);
       NodePointer ctx = demangleContext();
       if (!ctx)
         return nullptr;
       decl_ctx->addChild(ctx);
-      auto qual_atype = NodeFactory::create(Node::Kind::QualifiedArchetype);
+      auto qual_atype = Factory.create(Node::Kind::QualifiedArchetype);
       qual_atype->addChild(index);
       qual_atype->addChild(decl_ctx);
       return qual_atype;
@@ -1739,13 +1771,13 @@ private:
   }
 
   NodePointer demangleTuple(IsVariadic isV) {
-    NodePointer tuple = NodeFactory::create(
+    NodePointer tuple = Factory.create(
         isV == IsVariadic::yes ? Node::Kind::VariadicTuple
                                : Node::Kind::NonVariadicTuple);
     while (!Mangled.nextIf('_')) {
       if (!Mangled)
         return nullptr;
-      NodePointer elt = NodeFactory::create(Node::Kind::TupleElement);
+      NodePointer elt = Factory.create(Node::Kind::TupleElement);
 
       if (isStartOfIdentifier(Mangled.peek())) {
         NodePointer label = demangleIdentifier(Node::Kind::TupleElementName);
@@ -1765,7 +1797,7 @@ private:
   }
   
   NodePointer postProcessReturnTypeNode (NodePointer out_args) {
-    NodePointer out_node = NodeFactory::create(Node::Kind::ReturnType);
+    NodePointer out_node = Factory.create(Node::Kind::ReturnType);
     out_node->addChild(out_args);
     return out_node;
   }
@@ -1774,7 +1806,7 @@ private:
     NodePointer type = demangleTypeImpl();
     if (!type)
       return nullptr;
-    NodePointer nodeType = NodeFactory::create(Node::Kind::Type);
+    NodePointer nodeType = Factory.create(Node::Kind::Type);
     nodeType->addChild(type);
     return nodeType;
   }
@@ -1791,13 +1823,13 @@ private:
     NodePointer out_args = demangleType();
     if (!out_args)
       return nullptr;
-    NodePointer block = NodeFactory::create(kind);
+    NodePointer block = Factory.create(kind);
     
     if (throws) {
-      block->addChild(NodeFactory::create(Node::Kind::ThrowsAnnotation));
+      block->addChild(Factory.create(Node::Kind::ThrowsAnnotation));
     }
     
-    NodePointer in_node = NodeFactory::create(Node::Kind::ArgumentTuple);
+    NodePointer in_node = Factory.create(Node::Kind::ArgumentTuple);
     block->addChild(in_node);
     in_node->addChild(in_args);
     block->addChild(postProcessReturnTypeNode(out_args));
@@ -1813,15 +1845,15 @@ private:
         return nullptr;
       c = Mangled.next();
       if (c == 'b')
-        return NodeFactory::create(Node::Kind::BuiltinTypeName,
+        return Factory.create(Node::Kind::BuiltinTypeName,
                                      "Builtin.BridgeObject");
       if (c == 'B')
-        return NodeFactory::create(Node::Kind::BuiltinTypeName,
+        return Factory.create(Node::Kind::BuiltinTypeName,
                                      "Builtin.UnsafeValueBuffer");
       if (c == 'f') {
         Node::IndexType size;
         if (demangleBuiltinSize(size)) {
-          return NodeFactory::create(
+          return Factory.create(
               Node::Kind::BuiltinTypeName,
               std::move(DemanglerPrinter() << "Builtin.Float" << size).str());
         }
@@ -1829,7 +1861,7 @@ private:
       if (c == 'i') {
         Node::IndexType size;
         if (demangleBuiltinSize(size)) {
-          return NodeFactory::create(
+          return Factory.create(
               Node::Kind::BuiltinTypeName,
               (DemanglerPrinter() << "Builtin.Int" << size).str());
         }
@@ -1843,7 +1875,7 @@ private:
             Node::IndexType size;
             if (!demangleBuiltinSize(size))
               return nullptr;
-            return NodeFactory::create(
+            return Factory.create(
                 Node::Kind::BuiltinTypeName,
                 (DemanglerPrinter() << "Builtin.Vec" << elts << "xInt" << size)
                     .str());
@@ -1852,29 +1884,29 @@ private:
             Node::IndexType size;
             if (!demangleBuiltinSize(size))
               return nullptr;
-            return NodeFactory::create(
+            return Factory.create(
                 Node::Kind::BuiltinTypeName,
                 (DemanglerPrinter() << "Builtin.Vec" << elts << "xFloat"
                                     << size).str());
           }
           if (Mangled.nextIf('p'))
-            return NodeFactory::create(
+            return Factory.create(
                 Node::Kind::BuiltinTypeName,
                 (DemanglerPrinter() << "Builtin.Vec" << elts << "xRawPointer")
                     .str());
         }
       }
       if (c == 'O')
-        return NodeFactory::create(Node::Kind::BuiltinTypeName,
+        return Factory.create(Node::Kind::BuiltinTypeName,
                                      "Builtin.UnknownObject");
       if (c == 'o')
-        return NodeFactory::create(Node::Kind::BuiltinTypeName,
+        return Factory.create(Node::Kind::BuiltinTypeName,
                                      "Builtin.NativeObject");
       if (c == 'p')
-        return NodeFactory::create(Node::Kind::BuiltinTypeName,
+        return Factory.create(Node::Kind::BuiltinTypeName,
                                      "Builtin.RawPointer");
       if (c == 'w')
-        return NodeFactory::create(Node::Kind::BuiltinTypeName,
+        return Factory.create(Node::Kind::BuiltinTypeName,
                                      "Builtin.Word");
       return nullptr;
     }
@@ -1892,7 +1924,7 @@ private:
       if (!type)
         return nullptr;
 
-      NodePointer dynamicSelf = NodeFactory::create(Node::Kind::DynamicSelf);
+      NodePointer dynamicSelf = Factory.create(Node::Kind::DynamicSelf);
       dynamicSelf->addChild(type);
       return dynamicSelf;
     }
@@ -1901,7 +1933,7 @@ private:
         return nullptr;
       if (!Mangled.nextIf('R'))
         return nullptr;
-      return NodeFactory::create(Node::Kind::ErrorType, std::string());
+      return Factory.create(Node::Kind::ErrorType, std::string());
     }
     if (c == 'F') {
       return demangleFunctionType(Node::Kind::FunctionType);
@@ -1917,18 +1949,18 @@ private:
         NodePointer type = demangleType();
         if (!type)
           return nullptr;
-        NodePointer boxType = NodeFactory::create(Node::Kind::SILBoxType);
+        NodePointer boxType = Factory.create(Node::Kind::SILBoxType);
         boxType->addChild(type);
         return boxType;
       }
       if (Mangled.nextIf('B')) {
-        NodePointer signature;
+        NodePointer signature = nullptr;
         if (Mangled.nextIf('G')) {
           signature = demangleGenericSignature(/*pseudogeneric*/ false);
           if (!signature)
             return nullptr;
         }
-        NodePointer layout = NodeFactory::create(Node::Kind::SILBoxLayout);
+        NodePointer layout = Factory.create(Node::Kind::SILBoxLayout);
         while (!Mangled.nextIf('_')) {
           Node::Kind kind;
           if (Mangled.nextIf('m'))
@@ -1941,13 +1973,13 @@ private:
           auto type = demangleType();
           if (!type)
             return nullptr;
-          auto field = NodeFactory::create(kind);
+          auto field = Factory.create(kind);
           field->addChild(type);
           layout->addChild(field);
         }
-        NodePointer genericArgs;
+        NodePointer genericArgs = nullptr;
         if (signature) {
-          genericArgs = NodeFactory::create(Node::Kind::TypeList);
+          genericArgs = Factory.create(Node::Kind::TypeList);
           while (!Mangled.nextIf('_')) {
             auto type = demangleType();
             if (!type)
@@ -1956,7 +1988,7 @@ private:
           }
         }
         NodePointer boxType =
-          NodeFactory::create(Node::Kind::SILBoxTypeWithLayout);
+          Factory.create(Node::Kind::SILBoxTypeWithLayout);
         boxType->addChild(layout);
         if (signature) {
           boxType->addChild(signature);
@@ -1973,7 +2005,7 @@ private:
       NodePointer type = demangleType();
       if (!type)
         return nullptr;
-      NodePointer metatype = NodeFactory::create(Node::Kind::Metatype);
+      NodePointer metatype = Factory.create(Node::Kind::Metatype);
       metatype->addChild(type);
       return metatype;
     }
@@ -1985,7 +2017,7 @@ private:
         NodePointer type = demangleType();
         if (!type)
           return nullptr;
-        NodePointer metatype = NodeFactory::create(Node::Kind::Metatype);
+        NodePointer metatype = Factory.create(Node::Kind::Metatype);
         metatype->addChild(metatypeRepr);
         metatype->addChild(type);
         return metatype;
@@ -1995,7 +2027,7 @@ private:
       if (Mangled.nextIf('M')) {
         NodePointer type = demangleType();
         if (!type) return nullptr;
-        auto metatype = NodeFactory::create(Node::Kind::ExistentialMetatype);
+        auto metatype = Factory.create(Node::Kind::ExistentialMetatype);
         metatype->addChild(type);
         return metatype;
       }
@@ -2012,7 +2044,7 @@ private:
           NodePointer type = demangleType();
           if (!type) return nullptr;
 
-          auto metatype = NodeFactory::create(Node::Kind::ExistentialMetatype);
+          auto metatype = Factory.create(Node::Kind::ExistentialMetatype);
           metatype->addChild(metatypeRepr);
           metatype->addChild(type);
           return metatype;
@@ -2038,7 +2070,7 @@ private:
       return demangleAssociatedTypeCompound();
     }
     if (c == 'R') {
-      NodePointer inout = NodeFactory::create(Node::Kind::InOut);
+      NodePointer inout = Factory.create(Node::Kind::InOut);
       NodePointer type = demangleTypeImpl();
       if (!type)
         return nullptr;
@@ -2060,7 +2092,7 @@ private:
       NodePointer sub = demangleType();
       if (!sub) return nullptr;
       NodePointer dependentGenericType
-        = NodeFactory::create(Node::Kind::DependentGenericType);
+        = Factory.create(Node::Kind::DependentGenericType);
       dependentGenericType->addChild(sig);
       dependentGenericType->addChild(sub);
       return dependentGenericType;
@@ -2073,7 +2105,7 @@ private:
         NodePointer type = demangleType();
         if (!type)
           return nullptr;
-        NodePointer unowned = NodeFactory::create(Node::Kind::Unowned);
+        NodePointer unowned = Factory.create(Node::Kind::Unowned);
         unowned->addChild(type);
         return unowned;
       }
@@ -2081,7 +2113,7 @@ private:
         NodePointer type = demangleType();
         if (!type)
           return nullptr;
-        NodePointer unowned = NodeFactory::create(Node::Kind::Unmanaged);
+        NodePointer unowned = Factory.create(Node::Kind::Unmanaged);
         unowned->addChild(type);
         return unowned;
       }
@@ -2089,7 +2121,7 @@ private:
         NodePointer type = demangleType();
         if (!type)
           return nullptr;
-        NodePointer weak = NodeFactory::create(Node::Kind::Weak);
+        NodePointer weak = Factory.create(Node::Kind::Weak);
         weak->addChild(type);
         return weak;
       }
@@ -2133,7 +2165,7 @@ private:
   // impl-function-attribute ::= 'Cw'            // compatible with protocol witness
   // impl-function-attribute ::= 'G'             // generic
   NodePointer demangleImplFunctionType() {
-    NodePointer type = NodeFactory::create(Node::Kind::ImplFunctionType);
+    NodePointer type = Factory.create(Node::Kind::ImplFunctionType);
 
     if (!demangleImplCalleeConvention(type))
       return nullptr;
@@ -2227,13 +2259,13 @@ private:
     if (attr.empty()) {
       return false;
     }
-    type->addChild(NodeFactory::create(Node::Kind::ImplConvention, attr));
+    type->addChild(Factory.create(Node::Kind::ImplConvention, attr));
     return true;
   }
 
   void addImplFunctionAttribute(NodePointer parent, StringRef attr,
                          Node::Kind kind = Node::Kind::ImplFunctionAttribute) {
-    parent->addChild(NodeFactory::create(kind, attr));
+    parent->addChild(Factory.create(kind, attr));
   }
 
   // impl-parameter ::= impl-convention type
@@ -2279,8 +2311,8 @@ private:
     auto type = demangleType();
     if (!type) return nullptr;
 
-    NodePointer node = NodeFactory::create(kind);
-    node->addChild(NodeFactory::create(Node::Kind::ImplConvention,
+    NodePointer node = Factory.create(kind);
+    node->addChild(Factory.create(Node::Kind::ImplConvention,
                                        convention));
     node->addChild(type);
     
@@ -2292,16 +2324,18 @@ private:
 NodePointer
 swift::Demangle::demangleSymbolAsNode(const char *MangledName,
                                       size_t MangledNameLength,
+                                      NodeFactory &Factory,
                                       const DemangleOptions &Options) {
-  Demangler demangler(StringRef(MangledName, MangledNameLength));
+  Demangler demangler(StringRef(MangledName, MangledNameLength), Factory);
   return demangler.demangleTopLevel();
 }
 
 NodePointer
 swift::Demangle::demangleTypeAsNode(const char *MangledName,
                                     size_t MangledNameLength,
+                                    NodeFactory &Factory,
                                     const DemangleOptions &Options) {
-  Demangler demangler(StringRef(MangledName, MangledNameLength));
+  Demangler demangler(StringRef(MangledName, MangledNameLength), Factory);
   return demangler.demangleTypeName();
 }
 
@@ -2924,7 +2958,7 @@ void NodePrinter::printSimplifiedEntityType(NodePointer context,
   assert(type->getKind() == Node::Kind::Type);
   type = type->getChild(0);
 
-  NodePointer generics;
+  NodePointer generics = nullptr;
   if (type->getKind() == Node::Kind::DependentGenericType) {
     generics = type->getChild(0);
     type = type->getChild(1)->getChild(0);
@@ -3758,7 +3792,7 @@ void NodePrinter::print(NodePointer pointer, bool asContext, bool suppressType)
     assert(pointer->getNumChildren() == 1 || pointer->getNumChildren() == 3);
     NodePointer layout = pointer->getChild(0);
     assert(layout->getKind() == Node::Kind::SILBoxLayout);
-    NodePointer signature, genericArgs;
+    NodePointer signature = nullptr, genericArgs = nullptr;
     if (pointer->getNumChildren() == 3) {
       signature = pointer->getChild(1);
       assert(signature->getKind() == Node::Kind::DependentGenericSignature);
@@ -3814,26 +3848,48 @@ std::string Demangle::nodeToString(NodePointer root,
 std::string Demangle::demangleSymbolAsString(const char *MangledName,
                                              size_t MangledNameLength,
                                              const DemangleOptions &Options) {
-  auto mangled = StringRef(MangledName, MangledNameLength);
-  auto root = demangleSymbolAsNode(MangledName, MangledNameLength, Options);
-  if (!root) return mangled.str();
-
-  std::string demangling = nodeToString(std::move(root), Options);
-  if (demangling.empty())
-    return mangled.str();
-  return demangling;
+  Context Ctx;
+  return Ctx.demangleSymbolAsString(StringRef(MangledName, MangledNameLength),
+                                    Options);
 }
 
 std::string Demangle::demangleTypeAsString(const char *MangledName,
                                            size_t MangledNameLength,
                                            const DemangleOptions &Options) {
-  auto mangled = StringRef(MangledName, MangledNameLength);
-  auto root = demangleTypeAsNode(MangledName, MangledNameLength, Options);
-  if (!root) return mangled.str();
+  Context Ctx;
+  return Ctx.demangleTypeAsString(StringRef(MangledName, MangledNameLength),
+                                  Options);
+}
+
+NodePointer Context::demangleSymbolAsNode(StringRef MangledName,
+                                          const DemangleOptions &Options) {
+  return Demangle::demangleSymbolAsNode(MangledName, Factory, Options);
+}
+
+NodePointer Context::demangleTypeAsNode(StringRef MangledName,
+                                        const DemangleOptions &Options) {
+  return Demangle::demangleTypeAsNode(MangledName, Factory, Options);
+}
+
+std::string Context::demangleSymbolAsString(StringRef MangledName,
+                                            const DemangleOptions &Options) {
+  auto root = demangleSymbolAsNode(MangledName, Options);
+  if (!root) return MangledName.str();
+
+  std::string demangling = nodeToString(root, Options);
+  if (demangling.empty())
+    return MangledName.str();
+  return demangling;
+}
+
+std::string Context::demangleTypeAsString(StringRef MangledName,
+                                          const DemangleOptions &Options) {
+  auto root = demangleTypeAsNode(MangledName, Options);
+  if (!root) return MangledName.str();
   
-  std::string demangling = nodeToString(std::move(root), Options);
+  std::string demangling = nodeToString(root, Options);
   if (demangling.empty())
-    return mangled.str();
+    return MangledName.str();
   return demangling;
 }
 
@@ -113,7 +113,7 @@ NodePointer Demangler::demangleTopLevel() {
   if (!nextIf(MANGLING_PREFIX_STR))
     return nullptr;
 
-  NodePointer topLevel = NodeFactory::create(Node::Kind::Global);
+  NodePointer topLevel = Factory.create(Node::Kind::Global);
 
   int Idx = 0;
   while (!Text.empty()) {
@@ -144,7 +144,7 @@ NodePointer Demangler::demangleTopLevel() {
         break;
       case Node::Kind::Identifier:
         if (StringRef(Nd->getText()).startswith("_T")) {
-          NodePointer Global = demangleSymbolAsNode(Nd->getText());
+          NodePointer Global = demangleSymbolAsNode(Nd->getText(), Factory);
           if (Global && Global->getKind() == Node::Kind::Global) {
             for (NodePointer Child : *Global) {
               Parent->addChild(Child);
@@ -159,7 +159,7 @@ NodePointer Demangler::demangleTopLevel() {
     }
   }
   if (EndPos < Text.size()) {
-    topLevel->addChild(NodeFactory::create(Node::Kind::Suffix,
+    topLevel->addChild(Factory.create(Node::Kind::Suffix,
                                            Text.substr(EndPos)));
   }
 
@@ -169,13 +169,13 @@ NodePointer Demangler::demangleTopLevel() {
 NodePointer Demangler::changeKind(NodePointer Node, Node::Kind NewKind) {
   if (!Node)
     return nullptr;
-  NodePointer NewNode;
+  NodePointer NewNode = nullptr;
   if (Node->hasText()) {
-    NewNode = NodeFactory::create(NewKind, Node->getText());
+    NewNode = Factory.create(NewKind, Node->getText());
   } else if (Node->hasIndex()) {
-    NewNode = NodeFactory::create(NewKind, Node->getIndex());
+    NewNode = Factory.create(NewKind, Node->getIndex());
   } else {
-    NewNode = NodeFactory::create(NewKind);
+    NewNode = Factory.create(NewKind);
   }
   for (NodePointer Child : *Node) {
     NewNode->addChild(Child);
@@ -194,7 +194,7 @@ NodePointer Demangler::demangleOperator() {
     case 'F': return demanglePlainFunction();
     case 'G': return demangleBoundGenericType();
     case 'I': return demangleImplFunctionType();
-    case 'K': return NodeFactory::create(Node::Kind::ThrowsAnnotation);
+    case 'K': return Factory.create(Node::Kind::ThrowsAnnotation);
     case 'L': return demangleLocalIdentifier();
     case 'M': return demangleMetatype();
     case 'N': return createWithChild(Node::Kind::TypeMetadata,
@@ -211,7 +211,7 @@ NodePointer Demangler::demangleOperator() {
     case 'Z': return createWithChild(Node::Kind::Static, popNode(isEntity));
     case 'a': return demangleTypeAlias();
     case 'c': return popFunctionType(Node::Kind::FunctionType);
-    case 'd': return NodeFactory::create(Node::Kind::VariadicMarker);
+    case 'd': return Factory.create(Node::Kind::VariadicMarker);
     case 'f': return demangleFunctionEntity();
     case 'i': return demangleEntity(Node::Kind::Subscript);
     case 'l': return demangleGenericSignature(/*hasParamCounts*/ false);
@@ -221,16 +221,16 @@ NodePointer Demangler::demangleOperator() {
     case 'p': return demangleProtocolListType();
     case 'q': return createType(demangleGenericParamIndex());
     case 'r': return demangleGenericSignature(/*hasParamCounts*/ true);
-    case 's': return NodeFactory::create(Node::Kind::Module, STDLIB_NAME);
+    case 's': return Factory.create(Node::Kind::Module, STDLIB_NAME);
     case 't': return popTuple();
     case 'u': return demangleGenericType();
     case 'v': return demangleEntity(Node::Kind::Variable);
     case 'w': return demangleValueWitness();
     case 'x': return createType(getDependentGenericParamType(0, 0));
-    case 'y': return NodeFactory::create(Node::Kind::EmptyList);
+    case 'y': return Factory.create(Node::Kind::EmptyList);
     case 'z': return createType(createWithChild(Node::Kind::InOut,
                                                 popTypeAndGetChild()));
-    case '_': return NodeFactory::create(Node::Kind::FirstElementMarker);
+    case '_': return Factory.create(Node::Kind::FirstElementMarker);
     default:
       pushBack();
       return demangleIdentifier();
@@ -265,7 +265,7 @@ int Demangler::demangleIndex() {
 NodePointer Demangler::demangleIndexAsNode() {
   int Idx = demangleIndex();
   if (Idx >= 0)
-    return NodeFactory::create(Node::Kind::Number, Idx);
+    return Factory.create(Node::Kind::Number, Idx);
   return nullptr;
 }
 
@@ -295,16 +295,16 @@ NodePointer Demangler::demangleMultiSubstitutions() {
 
 NodePointer Demangler::createSwiftType(Node::Kind typeKind, StringRef name) {
   return createType(createWithChildren(typeKind,
-    NodeFactory::create(Node::Kind::Module, STDLIB_NAME),
-    NodeFactory::create(Node::Kind::Identifier, name)));
+    Factory.create(Node::Kind::Module, STDLIB_NAME),
+    Factory.create(Node::Kind::Identifier, name)));
 }
 
 NodePointer Demangler::demangleKnownType() {
   switch (nextChar()) {
     case 'o':
-      return NodeFactory::create(Node::Kind::Module, MANGLING_MODULE_OBJC);
+      return Factory.create(Node::Kind::Module, MANGLING_MODULE_OBJC);
     case 'C':
-      return NodeFactory::create(Node::Kind::Module, MANGLING_MODULE_C);
+      return Factory.create(Node::Kind::Module, MANGLING_MODULE_C);
     case 'a':
       return createSwiftType(Node::Kind::Structure, "Array");
     case 'b':
@@ -407,7 +407,7 @@ NodePointer Demangler::demangleIdentifier() {
 
   if (Identifier.empty())
     return nullptr;
-  NodePointer Ident = NodeFactory::create(Node::Kind::Identifier, Identifier);
+  NodePointer Ident = Factory.create(Node::Kind::Identifier, Identifier);
   addSubstitution(Ident);
   return Ident;
 }
@@ -433,9 +433,9 @@ NodePointer Demangler::demangleOperatorIdentifier() {
     OpStr.push_back(o);
   }
   switch (nextChar()) {
-    case 'i': return NodeFactory::create(Node::Kind::InfixOperator, OpStr);
-    case 'p': return NodeFactory::create(Node::Kind::PrefixOperator, OpStr);
-    case 'P': return NodeFactory::create(Node::Kind::PostfixOperator, OpStr);
+    case 'i': return Factory.create(Node::Kind::InfixOperator, OpStr);
+    case 'p': return Factory.create(Node::Kind::PrefixOperator, OpStr);
+    case 'P': return Factory.create(Node::Kind::PostfixOperator, OpStr);
     default: return nullptr;
   }
 }
@@ -487,21 +487,21 @@ NodePointer Demangler::popTypeAndGetNominal() {
 }
 
 NodePointer Demangler::demangleBuiltinType() {
-  NodePointer Ty;
+  NodePointer Ty = nullptr;
   switch (nextChar()) {
     case 'b':
-      Ty = NodeFactory::create(Node::Kind::BuiltinTypeName,
+      Ty = Factory.create(Node::Kind::BuiltinTypeName,
                                "Builtin.BridgeObject");
       break;
     case 'B':
-      Ty = NodeFactory::create(Node::Kind::BuiltinTypeName,
+      Ty = Factory.create(Node::Kind::BuiltinTypeName,
                               "Builtin.UnsafeValueBuffer");
       break;
     case 'f': {
       int size = demangleIndex() - 1;
       if (size <= 0)
         return nullptr;
-      Ty = NodeFactory::create(Node::Kind::BuiltinTypeName,
+      Ty = Factory.create(Node::Kind::BuiltinTypeName,
                std::move(DemanglerPrinter() << "Builtin.Float" << size).str());
       break;
     }
@@ -509,7 +509,7 @@ NodePointer Demangler::demangleBuiltinType() {
       int size = demangleIndex() - 1;
       if (size <= 0)
         return nullptr;
-      Ty = NodeFactory::create(Node::Kind::BuiltinTypeName,
+      Ty = Factory.create(Node::Kind::BuiltinTypeName,
                           (DemanglerPrinter() << "Builtin.Int" << size).str());
       break;
     }
@@ -521,25 +521,25 @@ NodePointer Demangler::demangleBuiltinType() {
       if (!EltType || EltType->getKind() != Node::Kind::BuiltinTypeName ||
           EltType->getText().find("Builtin.") != 0)
         return nullptr;
-      Ty = NodeFactory::create(Node::Kind::BuiltinTypeName,
+      Ty = Factory.create(Node::Kind::BuiltinTypeName,
                       (DemanglerPrinter() << "Builtin.Vec" << elts << "x" <<
                       EltType->getText().substr(sizeof("Builtin.") - 1)).str());
       break;
     }
     case 'O':
-      Ty = NodeFactory::create(Node::Kind::BuiltinTypeName,
+      Ty = Factory.create(Node::Kind::BuiltinTypeName,
                                "Builtin.UnknownObject");
       break;
     case 'o':
-      Ty = NodeFactory::create(Node::Kind::BuiltinTypeName,
+      Ty = Factory.create(Node::Kind::BuiltinTypeName,
                                "Builtin.NativeObject");
       break;
     case 'p':
-      Ty = NodeFactory::create(Node::Kind::BuiltinTypeName,
+      Ty = Factory.create(Node::Kind::BuiltinTypeName,
                                "Builtin.RawPointer");
       break;
     case 'w':
-      Ty = NodeFactory::create(Node::Kind::BuiltinTypeName,
+      Ty = Factory.create(Node::Kind::BuiltinTypeName,
                                "Builtin.Word");
       break;
     default:
@@ -573,7 +573,7 @@ NodePointer Demangler::demangleExtensionContext() {
 }
 
 NodePointer Demangler::demanglePlainFunction() {
-  NodePointer Func = NodeFactory::create(Node::Kind::Function);
+  NodePointer Func = Factory.create(Node::Kind::Function);
   NodePointer GenSig = popNode(Node::Kind::DependentGenericSignature);
   NodePointer Type = popFunctionType(Node::Kind::FunctionType);
   if (GenSig) {
@@ -586,7 +586,7 @@ NodePointer Demangler::demanglePlainFunction() {
 }
 
 NodePointer Demangler::popFunctionType(Node::Kind kind) {
-  NodePointer FuncType = NodeFactory::create(kind);
+  NodePointer FuncType = Factory.create(kind);
   addChild(FuncType, popNode(Node::Kind::ThrowsAnnotation));
 
   FuncType = addChild(FuncType, popFunctionParams(Node::Kind::ArgumentTuple));
@@ -595,9 +595,9 @@ NodePointer Demangler::popFunctionType(Node::Kind kind) {
 }
 
 NodePointer Demangler::popFunctionParams(Node::Kind kind) {
-  NodePointer ParamsType;
+  NodePointer ParamsType = nullptr;
   if (popNode(Node::Kind::EmptyList)) {
-    ParamsType = createType(NodeFactory::create(Node::Kind::NonVariadicTuple));
+    ParamsType = createType(Factory.create(Node::Kind::NonVariadicTuple));
   } else {
     ParamsType = popNode(Node::Kind::Type);
   }
@@ -605,7 +605,7 @@ NodePointer Demangler::popFunctionParams(Node::Kind kind) {
 }
 
 NodePointer Demangler::popTuple() {
-  NodePointer Root = NodeFactory::create(popNode(Node::Kind::VariadicMarker) ?
+  NodePointer Root = Factory.create(popNode(Node::Kind::VariadicMarker) ?
                                          Node::Kind::VariadicTuple :
                                          Node::Kind::NonVariadicTuple);
 
@@ -614,9 +614,9 @@ NodePointer Demangler::popTuple() {
     bool firstElem = false;
     do {
       firstElem = (popNode(Node::Kind::FirstElementMarker) != nullptr);
-      NodePointer TupleElmt = NodeFactory::create(Node::Kind::TupleElement);
+      NodePointer TupleElmt = Factory.create(Node::Kind::TupleElement);
       if (NodePointer Ident = popNode(Node::Kind::Identifier)) {
-        TupleElmt->addChild(NodeFactory::create(Node::Kind::TupleElementName,
+        TupleElmt->addChild(Factory.create(Node::Kind::TupleElementName,
                                                 Ident->getText()));
       }
       NodePointer Ty = popNode(Node::Kind::Type);
@@ -634,7 +634,7 @@ NodePointer Demangler::popTuple() {
 }
 
 NodePointer Demangler::popTypeList() {
-  NodePointer Root = NodeFactory::create(Node::Kind::TypeList);
+  NodePointer Root = Factory.create(Node::Kind::TypeList);
 
   if (!popNode(Node::Kind::EmptyList)) {
     std::vector<NodePointer> Nodes;
@@ -727,7 +727,7 @@ NodePointer Demangler::demangleImplParamConvention() {
       return nullptr;
   }
   return createWithChild(Node::Kind::ImplParameter,
-                         NodeFactory::create(Node::Kind::ImplConvention, attr));
+                         Factory.create(Node::Kind::ImplConvention, attr));
 }
 
 NodePointer Demangler::demangleImplResultConvention(Node::Kind ConvKind) {
@@ -743,11 +743,11 @@ NodePointer Demangler::demangleImplResultConvention(Node::Kind ConvKind) {
       return nullptr;
   }
   return createWithChild(ConvKind,
-                         NodeFactory::create(Node::Kind::ImplConvention, attr));
+                         Factory.create(Node::Kind::ImplConvention, attr));
 }
 
 NodePointer Demangler::demangleImplFunctionType() {
-  NodePointer type = NodeFactory::create(Node::Kind::ImplFunctionType);
+  NodePointer type = Factory.create(Node::Kind::ImplFunctionType);
 
   NodePointer GenSig = popNode(Node::Kind::DependentGenericSignature);
   if (GenSig && nextIf('P'))
@@ -761,7 +761,7 @@ NodePointer Demangler::demangleImplFunctionType() {
     case 't': CAttr = "@convention(thin)"; break;
     default: return nullptr;
   }
-  type->addChild(NodeFactory::create(Node::Kind::ImplConvention, CAttr));
+  type->addChild(Factory.create(Node::Kind::ImplConvention, CAttr));
 
   StringRef FAttr;
   switch (nextChar()) {
@@ -776,7 +776,7 @@ NodePointer Demangler::demangleImplFunctionType() {
       break;
   }
   if (!FAttr.empty())
-    type->addChild(NodeFactory::create(Node::Kind::ImplFunctionAttribute, FAttr));
+    type->addChild(Factory.create(Node::Kind::ImplFunctionAttribute, FAttr));
 
   addChild(type, GenSig);
 
@@ -860,10 +860,10 @@ NodePointer Demangler::createArchetypeRef(int depth, int i) {
     return nullptr;
 
   // FIXME: Name won't match demangled context generic signatures correctly.
-  auto ref = NodeFactory::create(Node::Kind::ArchetypeRef,
+  auto ref = Factory.create(Node::Kind::ArchetypeRef,
                                  getArchetypeName(i, depth));
-  ref->addChild(NodeFactory::create(Node::Kind::Index, depth));
-  ref->addChild(NodeFactory::create(Node::Kind::Index, i));
+  ref->addChild(Factory.create(Node::Kind::Index, depth));
+  ref->addChild(Factory.create(Node::Kind::Index, i));
   return createType(ref);
 }
 
@@ -945,7 +945,7 @@ NodePointer Demangler::demangleAssociatedTypeCompound(
   NodePointer Base = GenericParamIdx;
 
   while (NodePointer AssocTy = pop_back_val(AssocTyNames)) {
-    NodePointer depTy = NodeFactory::create(Node::Kind::DependentMemberType);
+    NodePointer depTy = Factory.create(Node::Kind::DependentMemberType);
     depTy = addChild(depTy, createType(Base));
     Base = addChild(depTy, AssocTy);
   }
@@ -969,10 +969,10 @@ NodePointer Demangler::getDependentGenericParamType(int depth, int index) {
   DemanglerPrinter PrintName;
   PrintName << getArchetypeName(index, depth);
   
-  auto paramTy = NodeFactory::create(Node::Kind::DependentGenericParamType,
+  auto paramTy = Factory.create(Node::Kind::DependentGenericParamType,
                                      std::move(PrintName).str());
-  paramTy->addChild(NodeFactory::create(Node::Kind::Index, depth));
-  paramTy->addChild(NodeFactory::create(Node::Kind::Index, index));
+  paramTy->addChild(Factory.create(Node::Kind::Index, depth));
+  paramTy->addChild(Factory.create(Node::Kind::Index, index));
   return paramTy;
 }
 
@@ -1004,13 +1004,13 @@ NodePointer Demangler::popProtocolConformance() {
 NodePointer Demangler::demangleThunkOrSpecialization() {
   switch (char c = nextChar()) {
     case 'c': return createWithChild(Node::Kind::CurryThunk, popNode(isEntity));
-    case 'o': return NodeFactory::create(Node::Kind::ObjCAttribute);
-    case 'O': return NodeFactory::create(Node::Kind::NonObjCAttribute);
-    case 'D': return NodeFactory::create(Node::Kind::DynamicAttribute);
-    case 'd': return NodeFactory::create(Node::Kind::DirectMethodReferenceAttribute);
-    case 'V': return NodeFactory::create(Node::Kind::VTableAttribute);
-    case 'a': return NodeFactory::create(Node::Kind::PartialApplyObjCForwarder);
-    case 'A': return NodeFactory::create(Node::Kind::PartialApplyForwarder);
+    case 'o': return Factory.create(Node::Kind::ObjCAttribute);
+    case 'O': return Factory.create(Node::Kind::NonObjCAttribute);
+    case 'D': return Factory.create(Node::Kind::DynamicAttribute);
+    case 'd': return Factory.create(Node::Kind::DirectMethodReferenceAttribute);
+    case 'V': return Factory.create(Node::Kind::VTableAttribute);
+    case 'a': return Factory.create(Node::Kind::PartialApplyObjCForwarder);
+    case 'A': return Factory.create(Node::Kind::PartialApplyForwarder);
     case 'W': {
       NodePointer Entity = popNode(isEntity);
       NodePointer Conf = popProtocolConformance();
@@ -1018,7 +1018,7 @@ NodePointer Demangler::demangleThunkOrSpecialization() {
     }
     case 'R':
     case 'r': {
-      NodePointer Thunk = NodeFactory::create(c == 'R' ?
+      NodePointer Thunk = Factory.create(c == 'R' ?
                                         Node::Kind::ReabstractionThunkHelper :
                                         Node::Kind::ReabstractionThunk);
       if (NodePointer GenSig = popNode(Node::Kind::DependentGenericSignature))
@@ -1078,7 +1078,7 @@ NodePointer Demangler::demangleFunctionSpecialization() {
 }
 
 NodePointer Demangler::demangleFuncSpecParam(Node::IndexType ParamIdx) {
-  NodePointer Param = NodeFactory::create(
+  NodePointer Param = Factory.create(
             Node::Kind::FunctionSignatureSpecializationParam, ParamIdx);
   switch (nextChar()) {
     case 'n':
@@ -1124,14 +1124,14 @@ NodePointer Demangler::demangleFuncSpecParam(Node::IndexType ParamIdx) {
           if (Text.size() > 0 && Text[0] == '_')
             Text = Text.drop_front(1);
 
-          Param->addChild(NodeFactory::create(
+          Param->addChild(Factory.create(
                   Node::Kind::FunctionSignatureSpecializationParamKind,
                   unsigned(swift::Demangle::FunctionSigSpecializationParamKind::
                            ConstantPropString)));
-          Param->addChild(NodeFactory::create(
+          Param->addChild(Factory.create(
                   Node::Kind::FunctionSignatureSpecializationParamPayload,
                   Encoding));
-          return addChild(Param, NodeFactory::create(
+          return addChild(Param, Factory.create(
                   Node::Kind::FunctionSignatureSpecializationParamPayload,
                   Text));
         }
@@ -1145,7 +1145,7 @@ NodePointer Demangler::demangleFuncSpecParam(Node::IndexType ParamIdx) {
         Value |= unsigned(FunctionSigSpecializationParamKind::OwnedToGuaranteed);
       if (nextIf('X'))
         Value |= unsigned(FunctionSigSpecializationParamKind::SROA);
-      return addChild(Param, NodeFactory::create(
+      return addChild(Param, Factory.create(
                   Node::Kind::FunctionSignatureSpecializationParamKind, Value));
     }
     case 'g': {
@@ -1153,19 +1153,19 @@ NodePointer Demangler::demangleFuncSpecParam(Node::IndexType ParamIdx) {
                                 OwnedToGuaranteed);
       if (nextIf('X'))
         Value |= unsigned(FunctionSigSpecializationParamKind::SROA);
-      return addChild(Param, NodeFactory::create(
+      return addChild(Param, Factory.create(
                   Node::Kind::FunctionSignatureSpecializationParamKind, Value));
     }
     case 'x':
-      return addChild(Param, NodeFactory::create(
+      return addChild(Param, Factory.create(
                 Node::Kind::FunctionSignatureSpecializationParamKind,
                 unsigned(FunctionSigSpecializationParamKind::SROA)));
     case 'i':
-      return addChild(Param, NodeFactory::create(
+      return addChild(Param, Factory.create(
                 Node::Kind::FunctionSignatureSpecializationParamKind,
                 unsigned(FunctionSigSpecializationParamKind::BoxToValue)));
     case 's':
-      return addChild(Param, NodeFactory::create(
+      return addChild(Param, Factory.create(
                 Node::Kind::FunctionSignatureSpecializationParamKind,
                 unsigned(FunctionSigSpecializationParamKind::BoxToStack)));
     default:
@@ -1179,19 +1179,19 @@ NodePointer Demangler::addFuncSpecParamIdentifier(NodePointer Param,
   NodePointer Name = popNode(Node::Kind::Identifier);
   if (!Name)
     return nullptr;
-  Param->addChild(NodeFactory::create(
+  Param->addChild(Factory.create(
         Node::Kind::FunctionSignatureSpecializationParamKind, unsigned(Kind)));
   if (!FirstParam.empty()) {
-    Param->addChild(NodeFactory::create(
+    Param->addChild(Factory.create(
           Node::Kind::FunctionSignatureSpecializationParamPayload, FirstParam));
   }
-  return addChild(Param, NodeFactory::create(
+  return addChild(Param, Factory.create(
      Node::Kind::FunctionSignatureSpecializationParamPayload, Name->getText()));
 }
 
 NodePointer Demangler::addFuncSpecParamNumber(NodePointer Param,
                                     FunctionSigSpecializationParamKind Kind) {
-  Param->addChild(NodeFactory::create(
+  Param->addChild(Factory.create(
         Node::Kind::FunctionSignatureSpecializationParamKind, unsigned(Kind)));
   std::string Str;
   while (isDigit(peekChar())) {
@@ -1199,20 +1199,20 @@ NodePointer Demangler::addFuncSpecParamNumber(NodePointer Param,
   }
   if (Str.empty())
     return nullptr;
-  return addChild(Param, NodeFactory::create(
+  return addChild(Param, Factory.create(
      Node::Kind::FunctionSignatureSpecializationParamPayload, Str));
 }
 
 NodePointer Demangler::demangleSpecAttributes(Node::Kind SpecKind) {
-  NodePointer SpecNd = NodeFactory::create(SpecKind);
+  NodePointer SpecNd = Factory.create(SpecKind);
   if (nextIf('q'))
-    SpecNd->addChild(NodeFactory::create(Node::Kind::SpecializationIsFragile));
+    SpecNd->addChild(Factory.create(Node::Kind::SpecializationIsFragile));
 
   int PassID = (int)nextChar() - '0';
   if (PassID < 0 || PassID > 9)
     return nullptr;
 
-  SpecNd->addChild(NodeFactory::create(Node::Kind::SpecializationPassID,
+  SpecNd->addChild(Factory.create(Node::Kind::SpecializationPassID,
                                        PassID));
   return SpecNd;
 }
@@ -1232,7 +1232,7 @@ NodePointer Demangler::demangleWitness() {
         default: return nullptr;
       }
       return createWithChildren(Node::Kind::FieldOffset,
-                        NodeFactory::create(Node::Kind::Directness, Directness),
+                        Factory.create(Node::Kind::Directness, Directness),
                         popNode(isEntity));
     }
     case 'P':
@@ -1322,7 +1322,7 @@ NodePointer Demangler::demangleSpecialType() {
     case 'X':
     case 'x': {
       // SIL box types.
-      NodePointer signature, genericArgs;
+      NodePointer signature = nullptr, genericArgs = nullptr;
       if (specialChar == 'X') {
         signature = popNode(Node::Kind::DependentGenericSignature);
         if (!signature)
@@ -1336,7 +1336,7 @@ NodePointer Demangler::demangleSpecialType() {
       if (!fieldTypes)
         return nullptr;
       // Build layout.
-      auto layout = NodeFactory::create(Node::Kind::SILBoxLayout);
+      auto layout = Factory.create(Node::Kind::SILBoxLayout);
       for (unsigned i = 0, e = fieldTypes->getNumChildren(); i < e; ++i) {
         auto fieldType = fieldTypes->getChild(i);
         assert(fieldType->getKind() == Node::Kind::Type);
@@ -1346,13 +1346,13 @@ NodePointer Demangler::demangleSpecialType() {
           isMutable = true;
           fieldType = createType(fieldType->getChild(0)->getChild(0));
         }
-        auto field = NodeFactory::create(isMutable
+        auto field = Factory.create(isMutable
                                          ? Node::Kind::SILBoxMutableField
                                          : Node::Kind::SILBoxImmutableField);
         field->addChild(fieldType);
         layout->addChild(field);
       }
-      auto boxTy = NodeFactory::create(Node::Kind::SILBoxTypeWithLayout);
+      auto boxTy = Factory.create(Node::Kind::SILBoxTypeWithLayout);
       boxTy->addChild(layout);
       if (signature) {
         boxTy->addChild(signature);
@@ -1362,7 +1362,7 @@ NodePointer Demangler::demangleSpecialType() {
       return createType(boxTy);
     }
     case 'e':
-      return createType(NodeFactory::create(Node::Kind::ErrorType, std::string()));
+      return createType(Factory.create(Node::Kind::ErrorType, std::string()));
     default:
       return nullptr;
   }
@@ -1371,11 +1371,11 @@ NodePointer Demangler::demangleSpecialType() {
 NodePointer Demangler::demangleMetatypeRepresentation() {
   switch (nextChar()) {
     case 't':
-      return NodeFactory::create(Node::Kind::MetatypeRepresentation, "@thin");
+      return Factory.create(Node::Kind::MetatypeRepresentation, "@thin");
     case 'T':
-      return NodeFactory::create(Node::Kind::MetatypeRepresentation, "@thick");
+      return Factory.create(Node::Kind::MetatypeRepresentation, "@thick");
     case 'o':
-      return NodeFactory::create(Node::Kind::MetatypeRepresentation,
+      return Factory.create(Node::Kind::MetatypeRepresentation,
                                  "@objc_metatype");
     default:
       return nullptr;
@@ -1427,7 +1427,7 @@ NodePointer Demangler::demangleFunctionEntity() {
     default: return nullptr;
   }
 
-  NodePointer Child1, Child2;
+  NodePointer Child1 = nullptr, Child2 = nullptr;
   switch (Args) {
     case None:
       break;
@@ -1471,7 +1471,7 @@ NodePointer Demangler::demangleEntity(Node::Kind Kind) {
 }
 
 NodePointer Demangler::demangleProtocolListType() {
-  NodePointer TypeList = NodeFactory::create(Node::Kind::TypeList);
+  NodePointer TypeList = Factory.create(Node::Kind::TypeList);
   NodePointer ProtoList = createWithChild(Node::Kind::ProtocolList, TypeList);
   if (!popNode(Node::Kind::EmptyList)) {
     std::vector<NodePointer> ProtoNames;
@@ -1496,7 +1496,7 @@ NodePointer Demangler::demangleGenericSignature(bool hasParamCounts) {
   while (NodePointer Req = popNode(isRequirement)) {
     Requirements.push_back(Req);
   }
-  NodePointer Sig = NodeFactory::create(Node::Kind::DependentGenericSignature);
+  NodePointer Sig = Factory.create(Node::Kind::DependentGenericSignature);
   if (hasParamCounts) {
     while (!nextIf('l')) {
       int count = 0;
@@ -1504,11 +1504,11 @@ NodePointer Demangler::demangleGenericSignature(bool hasParamCounts) {
         count = demangleIndex() + 1;
       if (count < 0)
         return nullptr;
-      Sig->addChild(NodeFactory::create(Node::Kind::DependentGenericParamCount,
+      Sig->addChild(Factory.create(Node::Kind::DependentGenericParamCount,
                                         count));
     }
   } else {
-    Sig->addChild(NodeFactory::create(Node::Kind::DependentGenericParamCount,
+    Sig->addChild(Factory.create(Node::Kind::DependentGenericParamCount,
                                       1));
   }
   if (Sig->getNumChildren() == 0)
@@ -1539,7 +1539,7 @@ NodePointer Demangler::demangleGenericRequirement() {
     default:  ConstraintKind = Protocol; TypeKind = Generic; pushBack(); break;
   }
   
-  NodePointer ConstrTy;
+  NodePointer ConstrTy = nullptr;
   switch (TypeKind) {
     case Generic:
       ConstrTy = createType(demangleGenericParamIndex());
@@ -1592,7 +1592,7 @@ NodePointer Demangler::demangleValueWitness() {
   int Kind = decodeValueWitnessKind(StringRef(Code, 2));
   if (Kind < 0)
     return nullptr;
-  NodePointer VW = NodeFactory::create(Node::Kind::ValueWitness, unsigned(Kind));
+  NodePointer VW = Factory.create(Node::Kind::ValueWitness, unsigned(Kind));
   return addChild(VW, popNode(Node::Kind::Type));
 }
 
@@ -29,5 +29,5 @@ void NullDiagnosticConsumer::handleDiagnostic(SourceManager &SM,
                                               StringRef Text,
                                               const DiagnosticInfo &Info) {
   DEBUG(llvm::dbgs() << "NullDiagnosticConsumer received diagnostic: "
-                     << Text << "\n");
+                     << unsigned(Info.ID) << "\n");
 }
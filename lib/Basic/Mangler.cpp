@@ -161,8 +161,9 @@ std::string NewMangling::selectMangling(const std::string &Old,
   static int numCmp = 0;
   using namespace Demangle;
 
-  NodePointer OldNode = demangleSymbolAsNode(Old);
-  NodePointer NewNode = demangleSymbolAsNode(New);
+  NodeFactory Factory;
+  NodePointer OldNode = demangleSymbolAsNode(Old, Factory);
+  NodePointer NewNode = demangleSymbolAsNode(New, Factory);
 
   if (OldNode) {
     if (!areTreesEqual(OldNode, NewNode)) {
@@ -184,7 +185,7 @@ std::string NewMangling::selectMangling(const std::string &Old,
             // Does the mangling contain an identifier which is the name of
             // an old-mangled function?
             New.find("_T") != std::string::npos) {
-          NodePointer RemangledNode = demangleSymbolAsNode(Remangled);
+          NodePointer RemangledNode = demangleSymbolAsNode(Remangled, Factory);
           isEqual = areTreesEqual(NewNode, RemangledNode);
         }
         if (!isEqual) {
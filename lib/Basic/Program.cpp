@@ -19,6 +19,8 @@
 #if HAVE_UNISTD_H
 #include <unistd.h>
 #endif
+#elif LLVM_ON_WIN32
+#include <process.h>
 #endif
 
 int swift::ExecuteInPlace(const char *Program, const char **args,
@@ -39,3 +41,11 @@ int swift::ExecuteInPlace(const char *Program, const char **args,
   return result;
 #endif
 }
+
+unsigned swift::getCurrentProcessID() {
+#if LLVM_ON_WIN32
+  return _getpid();
+#else
+  return getpid();
+#endif
+}
@@ -110,7 +110,7 @@ private:
       combineHash(node->getText());
     }
     for (const auto &child : *node) {
-      deepHash(child.get());
+      deepHash(child);
     }
   }
 
@@ -142,7 +142,7 @@ bool SubstitutionEntry::deepEquals(Node *lhs, Node *rhs) const {
 
   for (auto li = lhs->begin(), ri = lhs->begin(), le = lhs->end();
        li != le; ++li, ++ri) {
-    if (!deepEquals(li->get(), ri->get()))
+    if (!deepEquals(*li, *ri))
       return false;
   }
   
@@ -166,8 +166,8 @@ class Remangler {
   int lastSubstIdx = -2;
 
   // We have to cons up temporary nodes sometimes when remangling
-  // nested generics. This vector owns them.
-  std::vector<NodePointer> TemporaryNodes;
+  // nested generics. This factory owns them.
+  NodeFactory Factory;
 
   StringRef getBufferStr() const { return Buffer.getStringRef(); }
 
@@ -198,7 +198,7 @@ class Remangler {
 
   Node *getSingleChild(Node *node) {
     assert(node->getNumChildren() == 1);
-    return node->getFirstChild().get();
+    return node->getFirstChild();
   }
 
   Node *getSingleChild(Node *node, Node::Kind kind) {
@@ -243,18 +243,18 @@ class Remangler {
 
   void mangleNodes(Node::iterator i, Node::iterator e) {
     for (; i != e; ++i) {
-      mangle(i->get());
+      mangle(*i);
     }
   }
 
   void mangleSingleChildNode(Node *node) {
     assert(node->getNumChildren() == 1);
-    mangle(node->begin()->get());
+    mangle(*node->begin());
   }
 
   void mangleChildNode(Node *node, unsigned index) {
     assert(index < node->getNumChildren());
-    mangle(node->begin()[index].get());
+    mangle(node->begin()[index]);
   }
 
   void manglePureProtocol(Node *Proto) {
@@ -391,8 +391,8 @@ std::pair<int, Node *> Remangler::mangleConstrainedType(Node *node) {
 
   std::vector<Node *> Chain;
   while (node->getKind() == Node::Kind::DependentMemberType) {
-    Chain.push_back(node->getChild(1).get());
-    node = getChildOfType(node->getFirstChild().get());
+    Chain.push_back(node->getChild(1));
+    node = getChildOfType(node->getFirstChild());
   }
   assert(node->getKind() == Node::Kind::DependentGenericParamType);
 
@@ -417,10 +417,9 @@ void Remangler::mangleNominalType(Node *node, char TypeOp) {
 
 void Remangler::mangleAnyNominalType(Node *node) {
   if (isSpecialized(node)) {
-    NodePointer unboundType = getUnspecialized(node);
-    TemporaryNodes.push_back(unboundType);
+    NodePointer unboundType = getUnspecialized(node, Factory);
     mangleGenericArgs(node);
-    mangleAnyNominalType(unboundType.get());
+    mangleAnyNominalType(unboundType);
     Buffer << 'G';
     return;
   }
@@ -439,7 +438,7 @@ void Remangler::mangleGenericArgs(Node *node) {
     case Node::Kind::Enum:
     case Node::Kind::Class: {
       NodePointer parentOrModule = node->getChild(0);
-      mangleGenericArgs(parentOrModule.get());
+      mangleGenericArgs(parentOrModule);
 
       // No generic arguments at this level
       Buffer << 'y';
@@ -453,9 +452,9 @@ void Remangler::mangleGenericArgs(Node *node) {
       assert(unboundType->getKind() == Node::Kind::Type);
       NodePointer nominalType = unboundType->getChild(0);
       NodePointer parentOrModule = nominalType->getChild(0);
-      mangleGenericArgs(parentOrModule.get());
+      mangleGenericArgs(parentOrModule);
 
-      mangleTypeList(node->getChild(1).get());
+      mangleTypeList(node->getChild(1));
       break;
     }
       
@@ -617,10 +616,10 @@ void Remangler::mangleDependentAssociatedTypeRef(Node *node) {
 }
 
 void Remangler::mangleDependentGenericConformanceRequirement(Node *node) {
-  Node *ProtoOrClass = node->getChild(1).get();
+  Node *ProtoOrClass = node->getChild(1);
   if (ProtoOrClass->getFirstChild()->getKind() == Node::Kind::Protocol) {
     manglePureProtocol(ProtoOrClass);
-    auto NumMembersAndParamIdx = mangleConstrainedType(node->getChild(0).get());
+    auto NumMembersAndParamIdx = mangleConstrainedType(node->getChild(0));
     switch (NumMembersAndParamIdx.first) {
       case -1: Buffer << "RQ"; return; // substitution
       case 0: Buffer << "R"; break;
@@ -631,7 +630,7 @@ void Remangler::mangleDependentGenericConformanceRequirement(Node *node) {
     return;
   }
   mangle(ProtoOrClass);
-  auto NumMembersAndParamIdx = mangleConstrainedType(node->getChild(0).get());
+  auto NumMembersAndParamIdx = mangleConstrainedType(node->getChild(0));
   switch (NumMembersAndParamIdx.first) {
     case -1: Buffer << "RB"; return; // substitution
     case 0: Buffer << "Rb"; break;
@@ -658,7 +657,7 @@ void Remangler::mangleDependentGenericParamType(Node *node) {
 
 void Remangler::mangleDependentGenericSameTypeRequirement(Node *node) {
   mangleChildNode(node, 1);
-  auto NumMembersAndParamIdx = mangleConstrainedType(node->getChild(0).get());
+  auto NumMembersAndParamIdx = mangleConstrainedType(node->getChild(0));
   switch (NumMembersAndParamIdx.first) {
     case -1: Buffer << "RS"; return; // substitution
     case 0: Buffer << "Rs"; break;
@@ -671,7 +670,7 @@ void Remangler::mangleDependentGenericSameTypeRequirement(Node *node) {
 void Remangler::mangleDependentGenericSignature(Node *node) {
   size_t ParamCountEnd = 0;
   for (size_t Idx = 0, Num = node->getNumChildren(); Idx < Num; Idx++) {
-    Node *Child = node->getChild(Idx).get();
+    Node *Child = node->getChild(Idx);
     if (Child->getKind() == Node::Kind::DependentGenericParamCount) {
       ParamCountEnd = Idx + 1;
     } else {
@@ -688,7 +687,7 @@ void Remangler::mangleDependentGenericSignature(Node *node) {
   // Remangle generic params.
   Buffer << 'r';
   for (size_t Idx = 0; Idx < ParamCountEnd; ++Idx) {
-    Node *Count = node->getChild(Idx).get();
+    Node *Count = node->getChild(Idx);
     if (Count->getIndex() > 0) {
       mangleIndex(Count->getIndex() - 1);
     } else {
@@ -805,9 +804,9 @@ void Remangler::mangleFullTypeMetadata(Node *node) {
 void Remangler::mangleFunction(Node *node) {
   mangleChildNode(node, 0); // context
   mangleChildNode(node, 1); // name
-  Node *FuncType = getSingleChild(node->getChild(2).get());
+  Node *FuncType = getSingleChild(node->getChild(2));
   if (FuncType->getKind() == Node::Kind::DependentGenericType) {
-    mangleFunctionSignature(getSingleChild(FuncType->getChild(1).get()));
+    mangleFunctionSignature(getSingleChild(FuncType->getChild(1)));
     mangleChildNode(FuncType, 0); // generic signature
   } else {
     mangleFunctionSignature(FuncType);
@@ -819,19 +818,19 @@ void Remangler::mangleFunctionSignatureSpecialization(Node *node) {
   for (NodePointer Param : *node) {
     if (Param->getKind() == Node::Kind::FunctionSignatureSpecializationParam &&
         Param->getNumChildren() > 0) {
-      Node *KindNd = Param->getChild(0).get();
+      Node *KindNd = Param->getChild(0);
       switch (FunctionSigSpecializationParamKind(KindNd->getIndex())) {
         case FunctionSigSpecializationParamKind::ConstantPropFunction:
         case FunctionSigSpecializationParamKind::ConstantPropGlobal:
-          mangleIdentifier(Param->getChild(1).get());
+          mangleIdentifier(Param->getChild(1));
           break;
         case FunctionSigSpecializationParamKind::ConstantPropString:
-          mangleIdentifier(Param->getChild(2).get());
+          mangleIdentifier(Param->getChild(2));
           break;
         case FunctionSigSpecializationParamKind::ClosureProp:
-          mangleIdentifier(Param->getChild(1).get());
+          mangleIdentifier(Param->getChild(1));
           for (unsigned i = 2, e = Param->getNumChildren(); i != e; ++i) {
-            mangleType(Param->getChild(i).get());
+            mangleType(Param->getChild(i));
           }
           break;
         default:
@@ -848,7 +847,7 @@ void Remangler::mangleFunctionSignatureSpecialization(Node *node) {
         returnValMangled = true;
       }
     }
-    mangle(Child.get());
+    mangle(Child);
   }
   if (!returnValMangled)
     Buffer << "_n";
@@ -862,7 +861,7 @@ void Remangler::mangleFunctionSignatureSpecializationParam(Node *node) {
 
   // The first child is always a kind that specifies the type of param that we
   // have.
-  Node *KindNd = node->getChild(0).get();
+  Node *KindNd = node->getChild(0);
   unsigned kindValue = KindNd->getIndex();
   auto kind = FunctionSigSpecializationParamKind(kindValue);
 
@@ -947,7 +946,7 @@ void Remangler::mangleGenericProtocolWitnessTableInstantiationFunction(Node *nod
 void Remangler::mangleGenericPartialSpecialization(Node *node) {
   for (NodePointer Child : *node) {
     if (Child->getKind() == Node::Kind::GenericSpecializationParam) {
-      mangleChildNode(Child.get(), 0);
+      mangleChildNode(Child, 0);
       break;
     }
   }
@@ -955,7 +954,7 @@ void Remangler::mangleGenericPartialSpecialization(Node *node) {
         Node::Kind::GenericPartialSpecializationNotReAbstracted ? "TP" : "Tp");
   for (NodePointer Child : *node) {
     if (Child->getKind() != Node::Kind::GenericSpecializationParam)
-      mangle(Child.get());
+      mangle(Child);
   }
 }
 
@@ -967,7 +966,7 @@ void Remangler::mangleGenericSpecialization(Node *node) {
   bool FirstParam = true;
   for (NodePointer Child : *node) {
     if (Child->getKind() == Node::Kind::GenericSpecializationParam) {
-      mangleChildNode(Child.get(), 0);
+      mangleChildNode(Child, 0);
       mangleListSeparator(FirstParam);
     }
   }
@@ -977,7 +976,7 @@ void Remangler::mangleGenericSpecialization(Node *node) {
                Node::Kind::GenericSpecializationNotReAbstracted ? "TG" : "Tg");
   for (NodePointer Child : *node) {
     if (Child->getKind() != Node::Kind::GenericSpecializationParam)
-      mangle(Child.get());
+      mangle(Child);
   }
 }
 
@@ -1008,7 +1007,7 @@ void Remangler::mangleGlobal(Node *node) {
   Buffer << MANGLING_PREFIX_STR;
   bool mangleInReverseOrder = false;
   for (auto Iter = node->begin(), End = node->end(); Iter != End; ++Iter) {
-    Node *Child = Iter->get();
+    Node *Child = *Iter;
     switch (Child->getKind()) {
       case Node::Kind::FunctionSignatureSpecialization:
       case Node::Kind::GenericSpecialization:
@@ -1028,7 +1027,7 @@ void Remangler::mangleGlobal(Node *node) {
           auto ReverseIter = Iter;
           while (ReverseIter != node->begin()) {
             --ReverseIter;
-            mangle(ReverseIter->get());
+            mangle(*ReverseIter);
           }
           mangleInReverseOrder = false;
         }
@@ -1081,13 +1080,13 @@ void Remangler::mangleImplFunctionType(Node *node) {
       case Node::Kind::ImplParameter:
       case Node::Kind::ImplResult:
       case Node::Kind::ImplErrorResult:
-        mangleChildNode(Child.get(), 1);
+        mangleChildNode(Child, 1);
         break;
       case Node::Kind::DependentPseudogenericSignature:
         PseudoGeneric = "P";
         SWIFT_FALLTHROUGH;
       case Node::Kind::DependentGenericSignature:
-        mangle(Child.get());
+        mangle(Child);
         break;
       default:
         break;
@@ -1331,14 +1330,14 @@ void Remangler::mangleProtocol(Node *node) {
 }
 
 void Remangler::mangleProtocolConformance(Node *node) {
-  Node *Ty = getChildOfType(node->getChild(0).get());
+  Node *Ty = getChildOfType(node->getChild(0));
   Node *GenSig = nullptr;
   if (Ty->getKind() == Node::Kind::DependentGenericType) {
-    GenSig = Ty->getFirstChild().get();
-    Ty = Ty->getChild(1).get();
+    GenSig = Ty->getFirstChild();
+    Ty = Ty->getChild(1);
   }
   mangle(Ty);
-  manglePureProtocol(node->getChild(1).get());
+  manglePureProtocol(node->getChild(1));
   mangleChildNode(node, 2);
   if (GenSig)
     mangle(GenSig);
@@ -1353,7 +1352,7 @@ void Remangler::mangleProtocolList(Node *node) {
   node = getSingleChild(node, Node::Kind::TypeList);
   bool FirstElem = true;
   for (NodePointer Child : *node) {
-    manglePureProtocol(Child.get());
+    manglePureProtocol(Child);
     mangleListSeparator(FirstElem);
   }
   mangleEndOfList(FirstElem);
@@ -1378,7 +1377,7 @@ void Remangler::mangleProtocolWitnessTableAccessor(Node *node) {
 void Remangler::mangleQualifiedArchetype(Node *node) {
   mangleChildNode(node, 1);
   Buffer << "Qq";
-  mangleNumber(node->getFirstChild().get());
+  mangleNumber(node->getFirstChild());
 }
 
 void Remangler::mangleReabstractionThunk(Node *node) {
@@ -1612,7 +1611,7 @@ void Remangler::mangleSILBoxTypeWithLayout(Node *node) {
   assert(node->getNumChildren() == 1 || node->getNumChildren() == 3);
   assert(node->getChild(0)->getKind() == Node::Kind::SILBoxLayout);
   auto layout = node->getChild(0);
-  auto layoutTypeList = NodeFactory::create(Node::Kind::TypeList);
+  auto layoutTypeList = Factory.create(Node::Kind::TypeList);
   for (unsigned i = 0, e = layout->getNumChildren(); i < e; ++i) {
     assert(layout->getChild(i)->getKind() == Node::Kind::SILBoxImmutableField
            || layout->getChild(i)->getKind() == Node::Kind::SILBoxMutableField);
@@ -1622,22 +1621,22 @@ void Remangler::mangleSILBoxTypeWithLayout(Node *node) {
     auto fieldType = field->getChild(0);
     // 'inout' mangling is used to represent mutable fields.
     if (field->getKind() == Node::Kind::SILBoxMutableField) {
-      auto inout = NodeFactory::create(Node::Kind::InOut);
+      auto inout = Factory.create(Node::Kind::InOut);
       inout->addChild(fieldType->getChild(0));
-      fieldType = NodeFactory::create(Node::Kind::Type);
+      fieldType = Factory.create(Node::Kind::Type);
       fieldType->addChild(inout);
     }
     layoutTypeList->addChild(fieldType);
   }
-  mangleTypeList(layoutTypeList.get());
+  mangleTypeList(layoutTypeList);
   
   if (node->getNumChildren() == 3) {
     auto signature = node->getChild(1);
     auto genericArgs = node->getChild(2);
     assert(signature->getKind() == Node::Kind::DependentGenericSignature);
     assert(genericArgs->getKind() == Node::Kind::TypeList);
-    mangleTypeList(genericArgs.get());
-    mangleDependentGenericSignature(signature.get());
+    mangleTypeList(genericArgs);
+    mangleDependentGenericSignature(signature);
     Buffer << "XX";
   } else {
     Buffer << "Xx";
@@ -1663,7 +1662,7 @@ std::string Demangle::mangleNodeNew(const NodePointer &node) {
   if (!node) return "";
 
   DemanglerPrinter printer;
-  Remangler(printer).mangle(node.get());
+  Remangler(printer).mangle(node);
 
   return std::move(printer).str();
 }
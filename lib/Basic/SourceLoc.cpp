@@ -15,6 +15,7 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/PrettyStackTrace.h"
 #include "llvm/Support/raw_ostream.h"
+#include <algorithm>
 
 using namespace swift;
 
@@ -42,6 +43,18 @@ SourceLoc SourceManager::getCodeCompletionLoc() const {
 unsigned
 SourceManager::addNewSourceBuffer(std::unique_ptr<llvm::MemoryBuffer> Buffer) {
   assert(Buffer);
+  if (!HasAliasBuffers) {
+    auto less = std::less<const char *>();
+    for (unsigned i = 1, e = LLVMSourceMgr.getNumBuffers(); i <= e; ++i) {
+      auto *Existing = LLVMSourceMgr.getMemoryBuffer(i);
+      if (!less(Buffer->getBufferEnd(), Existing->getBufferStart()) &&
+          !less(Existing->getBufferEnd(), Buffer->getBufferStart())) {
+        HasAliasBuffers = true;
+        break;
+      }
+    }
+  }
+
   StringRef BufIdentifier = Buffer->getBufferIdentifier();
   auto ID = LLVMSourceMgr.AddNewSourceBuffer(std::move(Buffer), llvm::SMLoc());
   BufIdentIDMap[BufIdentifier] = ID;
@@ -187,20 +200,75 @@ StringRef SourceManager::extractText(CharSourceRange Range,
 
 unsigned SourceManager::findBufferContainingLoc(SourceLoc Loc) const {
   assert(Loc.isValid());
-  // Search the buffers back-to front, so later alias buffers are
-  // visited first.
   auto less_equal = std::less_equal<const char *>();
-  for (unsigned i = LLVMSourceMgr.getNumBuffers(), e = 1; i >= e; --i) {
+  auto contains = [&](unsigned i) -> bool {
     auto Buf = LLVMSourceMgr.getMemoryBuffer(i);
-    if (less_equal(Buf->getBufferStart(), Loc.Value.getPointer()) &&
-        // Use <= here so that a pointer to the null at the end of the buffer
-        // is included as part of the buffer.
-        less_equal(Loc.Value.getPointer(), Buf->getBufferEnd()))
+    return less_equal(Buf->getBufferStart(), Loc.Value.getPointer()) &&
+           // Use <= here so that a pointer to the null at the end of the
+           // buffer is included as part of the buffer.
+           less_equal(Loc.Value.getPointer(), Buf->getBufferEnd());
+  };
+
+  // Consecutive lookups are almost always in the same buffer. If a later
+  // alias buffer might also contain the location, it has to win instead.
+  unsigned NumBuffers = LLVMSourceMgr.getNumBuffers();
+  if (LastBufferID != 0 && (!HasAliasBuffers || LastBufferID == NumBuffers) &&
+      contains(LastBufferID))
+    return LastBufferID;
+
+  // Search the buffers back-to front, so later alias buffers are
+  // visited first.
+  for (unsigned i = NumBuffers, e = 1; i >= e; --i) {
+    if (contains(i)) {
+      LastBufferID = i;
       return i;
+    }
   }
   llvm_unreachable("no buffer containing location found");
 }
 
+const std::vector<uint32_t> &
+SourceManager::getLineStartOffsets(unsigned BufferID) const {
+  if (LineStartOffsets.size() <= BufferID)
+    LineStartOffsets.resize(BufferID + 1);
+
+  auto &Offsets = LineStartOffsets[BufferID];
+  if (!Offsets.empty())
+    return Offsets;
+
+  // The first line always starts at offset 0 and is left implicit, so the
+  // entry at index N is the start of line N + 2. A sentinel past the end of
+  // the buffer keeps an empty table distinguishable from an unbuilt one.
+  StringRef Buffer = LLVMSourceMgr.getMemoryBuffer(BufferID)->getBuffer();
+  for (size_t I = Buffer.find('\n'); I != StringRef::npos;
+       I = Buffer.find('\n', I + 1))
+    Offsets.push_back(I + 1);
+  Offsets.push_back(UINT32_MAX);
+  return Offsets;
+}
+
+std::pair<unsigned, unsigned>
+SourceManager::findLineAndColumn(SourceLoc Loc, unsigned BufferID) const {
+  if (BufferID == 0)
+    BufferID = findBufferContainingLoc(Loc);
+  unsigned Offset = getLocOffsetInBuffer(Loc, BufferID);
+
+  // Find the last line that starts at or before the location.
+  auto &Offsets = getLineStartOffsets(BufferID);
+  auto NextLine = std::upper_bound(Offsets.begin(), Offsets.end(), Offset);
+  unsigned Line = (NextLine - Offsets.begin()) + 1;
+  unsigned LineStart = Line == 1 ? 0 : *(NextLine - 1);
+
+  // Match llvm::SourceMgr, which also treats a lone '\r' as the start of a
+  // new column count.
+  StringRef Buffer = LLVMSourceMgr.getMemoryBuffer(BufferID)->getBuffer();
+  size_t LastCR = Buffer.substr(LineStart, Offset - LineStart).rfind('\r');
+  if (LastCR != StringRef::npos)
+    LineStart += LastCR + 1;
+
+  return { Line, Offset - LineStart + 1 };
+}
+
 void SourceLoc::printLineAndColumn(raw_ostream &OS,
                                    const SourceManager &SM) const {
   if (isInvalid()) {
@@ -0,0 +1,29 @@
+//===--- SpawnServer.cpp - Start tasks from a long-lived server -----------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief This file includes the appropriate platform-specific spawn server
+/// implementation, or the fallback if there is none.
+///
+//===----------------------------------------------------------------------===//
+
+#include "swift/Basic/SpawnServer.h"
+
+using namespace swift;
+using namespace swift::sys;
+
+// Include the correct spawn server implementation.
+#if LLVM_ON_UNIX && !defined(__CYGWIN__)
+#include "Unix/SpawnServer.inc"
+#else
+#include "Default/SpawnServer.inc"
+#endif
@@ -0,0 +1,211 @@
+//===--- Statistic.cpp - Swift unified stats reporting --------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/Basic/Statistic.h"
+#include "swift/Basic/Program.h"
+#include "swift/Basic/Timer.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <cctype>
+#include <vector>
+
+using namespace swift;
+
+static const char FrontendProgramName[] = "swift-frontend";
+static const char DriverProgramName[] = "swift-driver";
+
+/// Replaces anything in \p name that would be awkward in a file name.
+static std::string cleanName(StringRef name) {
+  std::string result;
+  for (char c : name)
+    result += (isalnum(c) || c == '.' || c == '_') ? c : '-';
+  return result;
+}
+
+/// Returns a number to distinguish this run of the compiler from others with
+/// the same program and auxiliary name.
+static std::string makeUniqueSuffix(llvm::sys::TimeValue time) {
+  std::string result;
+  llvm::raw_string_ostream out(result);
+  out << time.toEpochTime() << "-" << getCurrentProcessID();
+  return out.str();
+}
+
+UnifiedStatsReporter::UnifiedStatsReporter(StringRef programName,
+                                           StringRef auxName,
+                                           StringRef directory)
+    : Directory(directory), IsDriver(programName == DriverProgramName),
+      StartTime(llvm::sys::TimeValue::now()) {
+  // Ignore the error; writing the file will fail and be reported below.
+  (void)llvm::sys::fs::create_directories(Directory);
+
+  llvm::sys::path::append(Filename, Directory,
+                          "stats-" + makeUniqueSuffix(StartTime) + "-" +
+                          programName + "-" + cleanName(auxName) + ".json");
+
+  if (IsDriver) {
+    DriverCounters.emplace();
+    std::error_code EC;
+    for (llvm::sys::fs::directory_iterator I(Directory, EC), E;
+         I != E && !EC; I.increment(EC)) {
+      PreexistingFiles.insert(llvm::sys::path::filename(I->path()));
+    }
+  } else {
+    FrontendCounters.emplace();
+  }
+
+  SharedTimer::recordPhaseTimes(&PhaseTimes);
+}
+
+UnifiedStatsReporter::AlwaysOnDriverCounters &
+UnifiedStatsReporter::getDriverCounters() {
+  assert(DriverCounters && "not a driver stats reporter");
+  return *DriverCounters;
+}
+
+UnifiedStatsReporter::AlwaysOnFrontendCounters &
+UnifiedStatsReporter::getFrontendCounters() {
+  assert(FrontendCounters && "not a frontend stats reporter");
+  return *FrontendCounters;
+}
+
+void UnifiedStatsReporter::noteCurrentMemoryUsage() {
+  if (FrontendCounters) {
+    size_t &maxUsage = FrontendCounters->MaxMallocUsage;
+    maxUsage = std::max(maxUsage, llvm::sys::Process::GetMallocUsage());
+  }
+}
+
+/// Adds a counter read from another job's statistics into \p counters.
+static void combineCounter(llvm::StringMap<int64_t> &counters, StringRef name,
+                           int64_t value) {
+  StringRef baseName = name.rsplit('.').second;
+  if (baseName.empty())
+    baseName = name;
+  auto &entry = counters[name];
+  if (baseName.startswith("Max"))
+    entry = std::max(entry, value);
+  else
+    entry += value;
+}
+
+void UnifiedStatsReporter::combineFrontendStats(
+    llvm::StringMap<int64_t> &counters, llvm::StringMap<double> &times) {
+  std::vector<std::string> paths;
+  std::error_code EC;
+  for (llvm::sys::fs::directory_iterator I(Directory, EC), E;
+       I != E && !EC; I.increment(EC)) {
+    StringRef name = llvm::sys::path::filename(I->path());
+    if (PreexistingFiles.count(name))
+      continue;
+    if (!name.startswith("stats-") || !name.endswith(".json") ||
+        name.find(FrontendProgramName) == StringRef::npos)
+      continue;
+    paths.push_back(I->path());
+  }
+
+  for (const std::string &path : paths) {
+    auto buffer = llvm::MemoryBuffer::getFile(path);
+    if (!buffer)
+      continue;
+    ++DriverCounters->NumFrontendStatsFilesCombined;
+
+    // Each entry is written on its own line as "name": value; see below.
+    SmallVector<StringRef, 64> lines;
+    buffer.get()->getBuffer().split(lines, '\n');
+    for (StringRef line : lines) {
+      line = line.trim().rtrim(',');
+      if (!line.consume_front("\""))
+        continue;
+      StringRef name, value;
+      std::tie(name, value) = line.split("\":");
+      value = value.trim();
+      if (name.empty() || value.empty())
+        continue;
+
+      int64_t intValue;
+      if (!value.getAsInteger(10, intValue)) {
+        combineCounter(counters, name, intValue);
+        continue;
+      }
+      double doubleValue;
+      if (!value.getAsDouble(doubleValue))
+        times[name] += doubleValue;
+    }
+  }
+}
+
+UnifiedStatsReporter::~UnifiedStatsReporter() {
+  SharedTimer::recordPhaseTimes(nullptr);
+  noteCurrentMemoryUsage();
+
+  llvm::StringMap<int64_t> counters;
+  llvm::StringMap<double> times;
+  if (IsDriver)
+    combineFrontendStats(counters, times);
+
+  if (DriverCounters) {
+#define DRIVER_STATISTIC(ID) counters["Driver." #ID] += DriverCounters->ID;
+#include "swift/Basic/Statistics.def"
+  }
+  if (FrontendCounters) {
+#define FRONTEND_STATISTIC(TY, ID) \
+    counters[#TY "." #ID] += FrontendCounters->ID;
+#include "swift/Basic/Statistics.def"
+  }
+  for (auto &entry : NamedCounters)
+    counters[entry.getKey()] += entry.getValue();
+
+  StringRef programName = IsDriver ? DriverProgramName : FrontendProgramName;
+  for (auto &entry : PhaseTimes)
+    times[("Time." + programName + "." + entry.getKey()).str()] +=
+        entry.getValue();
+  llvm::sys::TimeValue elapsed = llvm::sys::TimeValue::now() - StartTime;
+  times[("Time." + programName + ".Total").str()] += elapsed.seconds() +
+      elapsed.nanoseconds() / 1e9;
+
+  std::error_code EC;
+  llvm::raw_fd_ostream out(Filename, EC, llvm::sys::fs::F_Text);
+  if (EC) {
+    llvm::errs() << "error opening '" << Filename << "' for output: "
+                 << EC.message() << "\n";
+    return;
+  }
+
+  // Sort the entries so that files from different runs can be diffed.
+  std::vector<StringRef> counterNames, timeNames;
+  for (auto &entry : counters)
+    counterNames.push_back(entry.getKey());
+  for (auto &entry : times)
+    timeNames.push_back(entry.getKey());
+  std::sort(counterNames.begin(), counterNames.end());
+  std::sort(timeNames.begin(), timeNames.end());
+
+  out << "{\n";
+  bool isFirst = true;
+  for (StringRef name : counterNames) {
+    out << (isFirst ? "" : ",\n") << "  \"" << name << "\": " << counters[name];
+    isFirst = false;
+  }
+  for (StringRef name : timeNames) {
+    out << (isFirst ? "" : ",\n") << "  \"" << name << "\": "
+        << llvm::format("%.6f", times[name]);
+    isFirst = false;
+  }
+  out << "\n}\n";
+}
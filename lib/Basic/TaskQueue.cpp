@@ -29,8 +29,10 @@ using namespace swift::sys;
 #include "Default/TaskQueue.inc"
 #endif
 
-TaskQueue::TaskQueue(unsigned NumberOfParallelTasks)
-  : NumberOfParallelTasks(NumberOfParallelTasks) {}
+TaskQueue::TaskQueue(unsigned NumberOfParallelTasks,
+                     StringRef SpawnServerPath, uint64_t MemoryLimit)
+  : NumberOfParallelTasks(NumberOfParallelTasks),
+    SpawnServerPath(SpawnServerPath), MemoryLimit(MemoryLimit) {}
 
 TaskQueue::~TaskQueue() = default;
 
@@ -42,7 +44,8 @@ DummyTaskQueue::DummyTaskQueue(unsigned NumberOfParallelTasks)
 DummyTaskQueue::~DummyTaskQueue() = default;
 
 void DummyTaskQueue::addTask(const char *ExecPath, ArrayRef<const char *> Args,
-                             ArrayRef<const char *> Env, void *Context) {
+                             ArrayRef<const char *> Env, void *Context,
+                             uint64_t MemoryEstimate) {
   QueuedTasks.emplace(
     std::unique_ptr<DummyTask>(new DummyTask(ExecPath, Args, Env, Context)));
 }
@@ -80,7 +83,7 @@ bool DummyTaskQueue::execute(TaskQueue::TaskBeganCallback Began,
 
     if (Finished) {
       std::string Output = "Output placeholder\n";
-        if (Finished(P.first, 0, Output, P.second->Context) ==
+        if (Finished(P.first, 0, Output, None, P.second->Context) ==
             TaskFinishedResponse::StopExecution)
           SubtaskFailed = true;
     }
@@ -11,7 +11,144 @@
 //===----------------------------------------------------------------------===//
 
 #include "swift/Basic/Timer.h"
+#include "swift/Basic/Program.h"
+#include "llvm/Support/Compiler.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/raw_ostream.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
 
 using namespace swift;
 
 SharedTimer::State SharedTimer::CompilationTimersEnabled = State::Initial;
+llvm::StringMap<double> *SharedTimer::PhaseTimes = nullptr;
+
+/// Guards SharedTimer::PhaseTimes, since LLVM code generation may time its
+/// phases on several threads at once.
+static llvm::ManagedStatic<std::mutex> PhaseTimesLock;
+
+void SharedTimer::recordPhaseTime() {
+  double elapsed =
+      llvm::TimeRecord::getCurrentTime(false).getWallTime() - *StartWallTime;
+  std::lock_guard<std::mutex> guard(*PhaseTimesLock);
+  if (PhaseTimes)
+    (*PhaseTimes)[Name] += elapsed;
+}
+
+bool TracedEvent::TracingEnabled = false;
+
+namespace {
+struct RecordedEvent {
+  const char *Category;
+  std::string Name;
+  std::string Detail;
+  uint64_t StartTime;
+  uint64_t Duration;
+  unsigned ThreadID;
+};
+
+/// All events recorded in this process.
+///
+/// LLVM code generation may run on several threads at once, so access is
+/// guarded by a lock.
+struct EventLog {
+  std::mutex Lock;
+  std::vector<RecordedEvent> Events;
+};
+} // end anonymous namespace
+
+static llvm::ManagedStatic<EventLog> Log;
+
+/// Returns the current time in microseconds since the Unix epoch.
+///
+/// Using wall-clock time rather than a per-process clock lets traces from
+/// separate frontend processes line up when they are merged.
+static uint64_t getCurrentTime() {
+  using namespace std::chrono;
+  return duration_cast<microseconds>(
+      system_clock::now().time_since_epoch()).count();
+}
+
+/// Returns a small number identifying the current thread.
+static unsigned getCurrentThreadID() {
+  static std::atomic<unsigned> LastThreadID{0};
+  static LLVM_THREAD_LOCAL unsigned ThreadID = 0;
+  if (!ThreadID)
+    ThreadID = ++LastThreadID;
+  return ThreadID;
+}
+
+TracedEvent::TracedEvent(const char *category, const llvm::Twine &name,
+                         const llvm::Twine &detail)
+    : Category(category), StartTime(0), Active(TracingEnabled) {
+  if (!Active)
+    return;
+  Name = name.str();
+  if (!detail.isTriviallyEmpty())
+    Detail = detail.str();
+  StartTime = getCurrentTime();
+}
+
+TracedEvent::~TracedEvent() {
+  if (!Active)
+    return;
+  uint64_t duration = getCurrentTime() - StartTime;
+  std::lock_guard<std::mutex> guard(Log->Lock);
+  Log->Events.push_back({Category, std::move(Name), std::move(Detail),
+                         StartTime, duration, getCurrentThreadID()});
+}
+
+static void writeEscaped(raw_ostream &out, StringRef str) {
+  out << '"';
+  for (unsigned char c : str) {
+    switch (c) {
+    case '"':
+      out << "\\\"";
+      break;
+    case '\\':
+      out << "\\\\";
+      break;
+    case '\n':
+      out << "\\n";
+      break;
+    case '\t':
+      out << "\\t";
+      break;
+    default:
+      if (c < 0x20)
+        out << "\\u" << llvm::format("%04x", c);
+      else
+        out << c;
+    }
+  }
+  out << '"';
+}
+
+void TracedEvent::writeTrace(raw_ostream &out, StringRef processName) {
+  unsigned pid = getCurrentProcessID();
+
+  out << "{\"traceEvents\":[\n";
+  out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+      << ",\"tid\":0,\"args\":{\"name\":";
+  writeEscaped(out, processName);
+  out << "}}";
+
+  std::lock_guard<std::mutex> guard(Log->Lock);
+  for (const RecordedEvent &event : Log->Events) {
+    out << ",\n{\"name\":";
+    writeEscaped(out, event.Name);
+    out << ",\"cat\":\"" << event.Category << "\",\"ph\":\"X\""
+        << ",\"ts\":" << event.StartTime << ",\"dur\":" << event.Duration
+        << ",\"pid\":" << pid << ",\"tid\":" << event.ThreadID;
+    if (!event.Detail.empty()) {
+      out << ",\"args\":{\"detail\":";
+      writeEscaped(out, event.Detail);
+      out << "}";
+    }
+    out << "}";
+  }
+  out << "\n]}\n";
+}
@@ -30,6 +30,7 @@
 #include "swift/Basic/Platform.h"
 #include "swift/Basic/Range.h"
 #include "swift/Basic/StringExtras.h"
+#include "swift/Basic/Timer.h"
 #include "swift/Basic/Version.h"
 #include "swift/ClangImporter/ClangImporterOptions.h"
 #include "swift/Parse/Lexer.h"
@@ -878,8 +879,14 @@ bool ClangImporter::Implementation::importHeader(
   pp.EndSourceFile();
   bumpGeneration();
 
-  // Add any defined macros to the bridging header lookup table.
-  addMacrosToLookupTable(BridgingHeaderLookupTable, getNameImporter());
+  // Add the macros this header defined to the bridging header lookup table.
+  // Headers are imported one after another in the REPL and the debugger, so
+  // don't go over the ones that were added before again.
+  addMacrosToLookupTable(BridgingHeaderLookupTable,
+                         llvm::makeArrayRef(BridgeHeaderMacros)
+                           .slice(NumBridgeHeaderMacrosInLookupTable),
+                         getNameImporter());
+  NumBridgeHeaderMacrosInLookupTable = BridgeHeaderMacros.size();
 
   // Wrap all Clang imports under a Swift import decl.
   for (auto &Import : BridgeHeaderTopLevelImports) {
@@ -1027,6 +1034,8 @@ Module *ClangImporter::loadModule(
   auto &clangContext = Impl.getClangASTContext();
   auto &clangHeaderSearch = Impl.getClangPreprocessor().getHeaderSearchInfo();
 
+  TracedEvent event("import", path.front().first.str());
+
   // Look up the top-level module first, to see if it exists at all.
   clang::Module *clangModule =
     clangHeaderSearch.lookupModule(path.front().first.str());
@@ -1650,14 +1650,17 @@ static ImportNameOptions mapVersionToOptions(ImportNameVersion version) {
 ImportedName NameImporter::importName(const clang::NamedDecl *decl,
                                       ImportNameVersion version) {
   auto options = mapVersionToOptions(version);
-  CacheKeyType key(decl, (unsigned)version);
-  if (importNameCache.count(key)) {
+  CacheKeyType key(decl, options.toRaw());
+  auto known = importNameCache.find(key);
+  if (known != importNameCache.end()) {
     ++ImportNameNumCacheHits;
-    return importNameCache[key];
+    auto res = known->second;
+    res.info.version = version;
+    return res;
   }
   ++ImportNameNumCacheMisses;
   auto res = importNameImpl(decl, options);
-  res.info.version = version;
   importNameCache[key] = res;
+  res.info.version = version;
   return res;
 }
@@ -237,6 +237,8 @@ class NameImporter {
   const bool inferImportAsMember;
 
   // TODO: remove when we drop the options (i.e. import all names)
+  /// The key is the decl and the raw value of the ImportNameOptions, since
+  /// several versions import names the same way.
   using CacheKeyType =
       std::pair<const clang::NamedDecl *, unsigned>;
 
@@ -256,6 +256,15 @@ private:
 using LookupTableMap = llvm::StringMap<std::unique_ptr<SwiftLookupTable>>;
 
 /// \brief Implementation of the Clang importer.
+///
+/// FIXME: Swift lookup tables are already stored in Clang PCMs by
+/// SwiftNameLookupExtension, but the Swift declarations themselves are
+/// re-imported by every frontend process. Caching them on disk would need a
+/// serialized form for imported declarations that refers back to their Clang
+/// nodes by stable ID, keyed by the module's signature plus every importer
+/// option that affects naming and typing (Swift version, API notes, inference
+/// of import-as-member, and so on), along with a way to load them lazily
+/// through this class rather than through the module loader.
 class LLVM_LIBRARY_VISIBILITY ClangImporter::Implementation 
   : public LazyMemberLoader
 {
@@ -560,6 +569,11 @@ public:
 
   /// Tracks macro definitions from the bridging header.
   std::vector<clang::IdentifierInfo *> BridgeHeaderMacros;
+
+  /// The number of BridgeHeaderMacros that have been added to
+  /// BridgingHeaderLookupTable.
+  size_t NumBridgeHeaderMacrosInLookupTable = 0;
+
   /// Tracks included headers from the bridging header.
   llvm::DenseSet<const clang::FileEntry *> BridgeHeaderFiles;
 
@@ -27,6 +27,7 @@
 #include "clang/Serialization/ASTBitCodes.h"
 #include "clang/Serialization/ASTReader.h"
 #include "clang/Serialization/ASTWriter.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringExtras.h"
@@ -493,15 +494,18 @@ void SwiftLookupTable::addEntry(DeclName name, SingleEntry newEntry,
   }
 
   // Find the list of entries for this base name.
-  auto &entries = LookupTable[name.getBaseName().str()];
+  StringRef baseName = name.getBaseName().str();
+  auto &entries = LookupTable[baseName];
   auto decl = newEntry.dyn_cast<clang::NamedDecl *>();
   auto macro = newEntry.dyn_cast<clang::MacroInfo *>();
-  for (auto &entry : entries) {
-    if (entry.Context == context) {
-      // We have entries for this context.
-      (void)addLocalEntry(newEntry, entry.DeclsOrMacros, PP);
-      return;
-    }
+  auto knownIndex =
+    LookupTableIndices.insert({{baseName, context}, entries.size()});
+  if (!knownIndex.second) {
+    // We have entries for this context.
+    auto &entry = entries[knownIndex.first->second];
+    assert(entry.Context == context && "lookup table index out of date");
+    (void)addLocalEntry(newEntry, entry.DeclsOrMacros, PP);
+    return;
   }
 
   // This is a new context for this name. Add it.
@@ -1579,53 +1583,72 @@ void importer::addEntryToLookupTable(SwiftLookupTable &table,
   }
 }
 
-void importer::addMacrosToLookupTable(SwiftLookupTable &table,
-                                      NameImporter &nameImporter) {
+/// Add the definitions of the macro named \p name that aren't followed by
+/// an undef to the lookup table.
+static void addMacroToLookupTable(SwiftLookupTable &table,
+                                  clang::IdentifierInfo *name,
+                                  NameImporter &nameImporter) {
   auto &pp = nameImporter.getClangPreprocessor();
-  for (const auto &macro : pp.macros(false)) {
-    // Find the local history of this macro directive.
-    clang::MacroDirective *MD = pp.getLocalMacroDirectiveHistory(macro.first);
-
-    // Walk the history.
-    for (; MD; MD = MD->getPrevious()) {
-      // Don't look at any definitions that are followed by undefs.
-      // FIXME: This isn't quite correct across explicit submodules -- one
-      // submodule might define a macro, while another defines and then
-      // undefines the same macro. If they are processed in that order, the
-      // history will have the undef at the end, and we'll miss the first
-      // definition.
-      if (isa<clang::UndefMacroDirective>(MD))
-        break;
 
-      // Only interested in macro definitions.
-      auto *defMD = dyn_cast<clang::DefMacroDirective>(MD);
-      if (!defMD)
-        continue;
+  // Find the local history of this macro directive.
+  clang::MacroDirective *MD = pp.getLocalMacroDirectiveHistory(name);
+
+  // Walk the history.
+  for (; MD; MD = MD->getPrevious()) {
+    // Don't look at any definitions that are followed by undefs.
+    // FIXME: This isn't quite correct across explicit submodules -- one
+    // submodule might define a macro, while another defines and then
+    // undefines the same macro. If they are processed in that order, the
+    // history will have the undef at the end, and we'll miss the first
+    // definition.
+    if (isa<clang::UndefMacroDirective>(MD))
+      break;
 
-      // Is this definition from this module?
-      auto info = defMD->getInfo();
-      if (!info || info->isFromASTFile())
-        continue;
+    // Only interested in macro definitions.
+    auto *defMD = dyn_cast<clang::DefMacroDirective>(MD);
+    if (!defMD)
+      continue;
 
-      // If we hit a builtin macro, we're done.
-      if (info->isBuiltinMacro())
-        break;
+    // Is this definition from this module?
+    auto info = defMD->getInfo();
+    if (!info || info->isFromASTFile())
+      continue;
 
-      // If we hit a macro with invalid or predefined location, we're done.
-      auto loc = defMD->getLocation();
-      if (loc.isInvalid())
-        break;
-      if (pp.getSourceManager().getFileID(loc) == pp.getPredefinesFileID())
-        break;
+    // If we hit a builtin macro, we're done.
+    if (info->isBuiltinMacro())
+      break;
 
-      // Add this entry.
-      auto name = nameImporter.importMacroName(macro.first, info);
-      if (name.empty())
-        continue;
-      table.addEntry(name, info,
-                     nameImporter.getClangContext().getTranslationUnitDecl(),
-                     &pp);
-    }
+    // If we hit a macro with invalid or predefined location, we're done.
+    auto loc = defMD->getLocation();
+    if (loc.isInvalid())
+      break;
+    if (pp.getSourceManager().getFileID(loc) == pp.getPredefinesFileID())
+      break;
+
+    // Add this entry.
+    auto swiftName = nameImporter.importMacroName(name, info);
+    if (swiftName.empty())
+      continue;
+    table.addEntry(swiftName, info,
+                   nameImporter.getClangContext().getTranslationUnitDecl(),
+                   &pp);
+  }
+}
+
+void importer::addMacrosToLookupTable(SwiftLookupTable &table,
+                                      NameImporter &nameImporter) {
+  auto &pp = nameImporter.getClangPreprocessor();
+  for (const auto &macro : pp.macros(false))
+    addMacroToLookupTable(table, macro.first, nameImporter);
+}
+
+void importer::addMacrosToLookupTable(
+    SwiftLookupTable &table, ArrayRef<clang::IdentifierInfo *> macros,
+    NameImporter &nameImporter) {
+  llvm::SmallPtrSet<clang::IdentifierInfo *, 16> visited;
+  for (auto *macro : macros) {
+    if (visited.insert(macro).second)
+      addMacroToLookupTable(table, macro, nameImporter);
   }
 }
 
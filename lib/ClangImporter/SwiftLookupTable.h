@@ -268,6 +268,12 @@ private:
   /// the C entities that have that name, in all contexts.
   llvm::DenseMap<StringRef, SmallVector<FullTableEntry, 2>> LookupTable;
 
+  /// The index of the entry for each base name and context in LookupTable,
+  /// so that adding an entry doesn't search all the contexts that have a
+  /// common base name such as "init".
+  llvm::DenseMap<std::pair<StringRef, StoredContext>, unsigned>
+    LookupTableIndices;
+
   /// The list of Objective-C categories and extensions.
   llvm::SmallVector<clang::ObjCCategoryDecl *, 4> Categories;
 
@@ -410,6 +416,12 @@ void addEntryToLookupTable(SwiftLookupTable &table, clang::NamedDecl *named,
 /// Swift name lookup table.
 void addMacrosToLookupTable(SwiftLookupTable &table, NameImporter &);
 
+/// Add only the macros with the given names to the given Swift name lookup
+/// table, rather than walking every macro the preprocessor knows about.
+void addMacrosToLookupTable(SwiftLookupTable &table,
+                            ArrayRef<clang::IdentifierInfo *> macros,
+                            NameImporter &);
+
 /// Finalize a lookup table, handling any as-yet-unresolved entries
 /// and emitting diagnostics if necessary.
 void finalizeLookupTable(SwiftLookupTable &table, NameImporter &);
@@ -14,8 +14,10 @@
 
 #include "swift/AST/DiagnosticEngine.h"
 #include "swift/AST/DiagnosticsDriver.h"
+#include "swift/Basic/Defer.h"
 #include "swift/Basic/Fallthrough.h"
 #include "swift/Basic/Program.h"
+#include "swift/Basic/Statistic.h"
 #include "swift/Basic/TaskQueue.h"
 #include "swift/Basic/Version.h"
 #include "swift/Basic/type_traits.h"
@@ -24,6 +26,8 @@
 #include "swift/Driver/Driver.h"
 #include "swift/Driver/Job.h"
 #include "swift/Driver/ParseableOutput.h"
+#include "swift/Serialization/Validation.h"
+#include "swift/Strings.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/StringExtras.h"
@@ -31,13 +35,18 @@
 #include "llvm/Option/Arg.h"
 #include "llvm/Option/ArgList.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/YAMLParser.h"
 
 #include "CompilationRecord.h"
 
+#include <chrono>
+
 using namespace swift;
 using namespace swift::sys;
 using namespace swift::driver;
@@ -177,9 +186,25 @@ static void checkForOutOfDateInputs(DiagnosticEngine &diags,
   }
 }
 
+/// How long the most recent successful compile job of each input took, in
+/// seconds, keyed by the input's name.
+using JobTimeMap = llvm::StringMap<double>;
+
+/// The peak memory use of the most recent successful compile job of each
+/// input, in bytes, keyed by the input's name.
+using JobMemoryMap = llvm::StringMap<uint64_t>;
+
+/// The interface hash of each external dependency which is a serialized
+/// module, as of the start of the build that depended on it, keyed by the
+/// module's path.
+using InterfaceHashMap = llvm::StringMap<std::string>;
+
 static void writeCompilationRecord(StringRef path, StringRef argsHash,
                                    llvm::sys::TimeValue buildTime,
-                                   const InputInfoMap &inputs) {
+                                   const InputInfoMap &inputs,
+                                   const JobTimeMap &jobTimes,
+                                   const JobMemoryMap &jobMemory,
+                                   const InterfaceHashMap &interfaceHashes) {
   // Before writing to the dependencies file path, preserve any previous file
   // that may have been there. No error handling -- this is just a nicety, it
   // doesn't matter if it fails.
@@ -224,6 +249,294 @@ static void writeCompilationRecord(StringRef path, StringRef argsHash,
     writeTimeValue(out, entry.second.previousModTime);
     out << "\n";
   }
+
+  out << compilation_record::getName(TopLevelKey::JobTimes) << ":\n";
+  for (auto &entry : inputs) {
+    auto time = jobTimes.find(entry.first->getValue());
+    if (time == jobTimes.end())
+      continue;
+    out << "  \"" << llvm::yaml::escape(entry.first->getValue()) << "\": "
+        << llvm::format("%.3f", time->getValue()) << "\n";
+  }
+
+  out << compilation_record::getName(TopLevelKey::JobMemory) << ":\n";
+  for (auto &entry : inputs) {
+    auto memory = jobMemory.find(entry.first->getValue());
+    if (memory == jobMemory.end())
+      continue;
+    out << "  \"" << llvm::yaml::escape(entry.first->getValue()) << "\": "
+        << memory->getValue() << "\n";
+  }
+
+  out << compilation_record::getName(TopLevelKey::ExternalInterfaceHashes)
+      << ":\n";
+  std::vector<StringRef> dependencies;
+  for (auto &entry : interfaceHashes)
+    dependencies.push_back(entry.getKey());
+  std::sort(dependencies.begin(), dependencies.end());
+  for (StringRef dependency : dependencies) {
+    out << "  \"" << llvm::yaml::escape(dependency) << "\": \""
+        << llvm::yaml::escape(interfaceHashes.lookup(dependency)) << "\"\n";
+  }
+}
+
+/// Calls \p fn with the key and value of each entry in the section \p section
+/// of the compilation record at \p path, if there is one. Anything unexpected
+/// is ignored, since these sections only serve to speed up the build.
+static void forEachCompilationRecordEntry(
+    StringRef path, compilation_record::TopLevelKey section,
+    llvm::function_ref<void(StringRef, StringRef)> fn) {
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  if (!buffer)
+    return;
+
+  namespace yaml = llvm::yaml;
+
+  // The driver reports malformed records when it reads them for incremental
+  // builds.
+  llvm::SourceMgr SM;
+  SM.setDiagHandler([](const llvm::SMDiagnostic &, void *) {});
+  yaml::Stream stream(buffer.get()->getMemBufferRef(), SM);
+
+  auto I = stream.begin();
+  if (I == stream.end() || !I->getRoot())
+    return;
+
+  auto *topLevelMap = dyn_cast<yaml::MappingNode>(I->getRoot());
+  if (!topLevelMap)
+    return;
+
+  SmallString<64> scratch;
+  // FIXME: LLVM's YAML support does incremental parsing in such a way that
+  // for-range loops break.
+  for (auto i = topLevelMap->begin(), e = topLevelMap->end(); i != e; ++i) {
+    auto *key = dyn_cast<yaml::ScalarNode>(i->getKey());
+    if (!key || key->getValue(scratch) != compilation_record::getName(section))
+      continue;
+
+    auto *sectionMap = dyn_cast<yaml::MappingNode>(i->getValue());
+    if (!sectionMap)
+      return;
+
+    for (auto i = sectionMap->begin(), e = sectionMap->end(); i != e; ++i) {
+      auto *key = dyn_cast<yaml::ScalarNode>(i->getKey());
+      auto *value = dyn_cast<yaml::ScalarNode>(i->getValue());
+      if (!key || !value)
+        continue;
+
+      SmallString<64> valueScratch;
+      fn(key->getValue(scratch), value->getValue(valueScratch));
+    }
+  }
+}
+
+/// Reads the job times from the compilation record at \p path, if there is
+/// one.
+static void readJobTimes(StringRef path, JobTimeMap &jobTimes) {
+  forEachCompilationRecordEntry(path,
+                                compilation_record::TopLevelKey::JobTimes,
+                                [&](StringRef input, StringRef value) {
+    double time;
+    if (value.getAsDouble(time) || time < 0)
+      return;
+    jobTimes[input] = time;
+  });
+}
+
+/// Reads the peak memory use of the compile jobs from the compilation record
+/// at \p path, if there is one.
+static void readJobMemory(StringRef path, JobMemoryMap &jobMemory) {
+  forEachCompilationRecordEntry(path,
+                                compilation_record::TopLevelKey::JobMemory,
+                                [&](StringRef input, StringRef value) {
+    uint64_t bytes;
+    if (value.getAsInteger(10, bytes))
+      return;
+    jobMemory[input] = bytes;
+  });
+}
+
+/// Reads the interface hashes of the external dependencies from the
+/// compilation record at \p path, if there is one.
+static void readInterfaceHashes(StringRef path,
+                                InterfaceHashMap &interfaceHashes) {
+  using compilation_record::TopLevelKey;
+  forEachCompilationRecordEntry(path, TopLevelKey::ExternalInterfaceHashes,
+                                [&](StringRef dependency, StringRef hash) {
+    interfaceHashes[dependency] = hash;
+  });
+}
+
+/// Returns the interface hash recorded in the serialized module at \p path,
+/// or an empty string if it isn't a module or doesn't record one.
+static std::string readInterfaceHashOfModule(StringRef path) {
+  if (llvm::sys::path::extension(path) !=
+        (Twine(".") + SERIALIZED_MODULE_EXTENSION).str())
+    return std::string();
+
+  auto buffer = llvm::MemoryBuffer::getFile(path, /*FileSize=*/-1,
+                                            /*RequiresNullTerminator=*/false);
+  if (!buffer)
+    return std::string();
+
+  auto info = serialization::validateSerializedAST(buffer.get()->getBuffer());
+  if (info.status != serialization::Status::Valid)
+    return std::string();
+  return info.interfaceHash;
+}
+
+/// Calls \p fn with each input file of \p Cmd if it's a compile job.
+static void
+forEachCompileInput(const Job *Cmd, llvm::function_ref<void(StringRef)> fn) {
+  if (!isa<CompileJobAction>(Cmd->getSource()))
+    return;
+  for (auto *A : Cmd->getSource().getInputs())
+    if (auto *IA = dyn_cast<InputAction>(A))
+      fn(IA->getInputArg().getValue());
+}
+
+using JobPriorityMap = llvm::DenseMap<const Job *, double>;
+
+/// Computes a priority for each job, which is the estimated time from
+/// starting the job to finishing everything that waits for it, so that the
+/// longest chains of jobs start first.
+///
+/// A compile job takes as long as it did in the previous build. If it didn't
+/// run then, its time is estimated from the size of its inputs. Other jobs,
+/// like merge-module and link, are assumed to take no time of their own, but
+/// still pass on the priorities of the jobs waiting for them.
+static void computeJobPriorities(const Compilation &C,
+                                 const JobTimeMap &jobTimes,
+                                 JobPriorityMap &priorities) {
+  llvm::DenseMap<const Job *, double> costs;
+  llvm::DenseMap<const Job *, uint64_t> unknownBytes;
+  double recordedSeconds = 0;
+  uint64_t recordedBytes = 0;
+  for (const Job *Cmd : C.getJobs()) {
+    forEachCompileInput(Cmd, [&](StringRef input) {
+      uint64_t size = 0;
+      if (llvm::sys::fs::file_size(input, size))
+        size = 0;
+      auto time = jobTimes.find(input);
+      if (time == jobTimes.end()) {
+        unknownBytes[Cmd] += size;
+        return;
+      }
+      costs[Cmd] += time->getValue();
+      recordedSeconds += time->getValue();
+      recordedBytes += size;
+    });
+  }
+
+  // Without any times, the sizes alone give the order.
+  double secondsPerByte = 1;
+  if (recordedSeconds > 0 && recordedBytes > 0)
+    secondsPerByte = recordedSeconds / recordedBytes;
+  for (auto &entry : unknownBytes)
+    costs[entry.first] += entry.second * secondsPerByte;
+
+  llvm::DenseMap<const Job *, TinyPtrVector<const Job *>> dependents;
+  for (const Job *Cmd : C.getJobs())
+    for (const Job *input : Cmd->getInputs())
+      dependents[input].push_back(Cmd);
+
+  // Jobs are created after their inputs, so visiting them in reverse order
+  // sees every job after the jobs waiting for it.
+  auto jobs = C.getJobs();
+  for (size_t i = jobs.size(); i-- != 0;) {
+    const Job *Cmd = jobs[i];
+    double longestDependent = 0;
+    for (const Job *dependent : dependents.lookup(Cmd))
+      longestDependent = std::max(longestDependent,
+                                  priorities.lookup(dependent));
+    priorities[Cmd] = costs.lookup(Cmd) + longestDependent;
+  }
+}
+
+using JobMemoryEstimateMap = llvm::DenseMap<const Job *, uint64_t>;
+
+/// Estimates the peak memory use of each compile job, in bytes.
+///
+/// A compile job uses as much memory as it did in the previous build. If it
+/// didn't run then, its memory is estimated from the size of its inputs, at
+/// the rate the recorded jobs used. Without any recorded jobs nothing is
+/// known, and other jobs, like merge-module and link, aren't estimated at all;
+/// these are left out of \p estimates.
+static void computeJobMemoryEstimates(const Compilation &C,
+                                      const JobMemoryMap &jobMemory,
+                                      JobMemoryEstimateMap &estimates) {
+  llvm::DenseMap<const Job *, uint64_t> unknownBytes;
+  uint64_t recordedMemory = 0;
+  uint64_t recordedBytes = 0;
+  for (const Job *Cmd : C.getJobs()) {
+    forEachCompileInput(Cmd, [&](StringRef input) {
+      uint64_t size = 0;
+      if (llvm::sys::fs::file_size(input, size))
+        size = 0;
+      auto memory = jobMemory.find(input);
+      if (memory == jobMemory.end()) {
+        unknownBytes[Cmd] += size;
+        return;
+      }
+      estimates[Cmd] += memory->getValue();
+      recordedMemory += memory->getValue();
+      recordedBytes += size;
+    });
+  }
+
+  if (recordedMemory == 0 || recordedBytes == 0)
+    return;
+  double memoryPerByte = double(recordedMemory) / recordedBytes;
+  for (auto &entry : unknownBytes)
+    estimates[entry.first] += uint64_t(entry.second * memoryPerByte);
+}
+
+/// Returns true if \p Cmd, a merge-module job, doesn't have to run because
+/// its outputs are newer than all the modules it would merge.
+///
+/// Compile jobs leave their partial modules untouched when the contents
+/// don't change, as for most edits inside function bodies, so after such
+/// edits the merged module is still up to date.
+static bool areMergedModuleOutputsUpToDate(const Job *Cmd) {
+  using llvm::sys::TimeValue;
+  namespace fs = llvm::sys::fs;
+  assert(isa<MergeModuleJobAction>(Cmd->getSource()));
+
+  TimeValue oldestOutput = TimeValue::MaxTime();
+  for (types::ID type : {types::TY_SwiftModuleFile,
+                         types::TY_SwiftModuleDocFile, types::TY_ObjCHeader}) {
+    const std::string &output = Cmd->getOutput().getAnyOutputForType(type);
+    if (output.empty())
+      continue;
+    fs::file_status status;
+    if (fs::status(output, status))
+      return false;
+    oldestOutput = std::min(oldestOutput, status.getLastModificationTime());
+  }
+
+  SmallVector<StringRef, 16> inputs;
+  for (const Action *A : Cmd->getSource().getInputs())
+    if (auto *IA = dyn_cast<InputAction>(A))
+      if (IA->getType() == types::TY_SwiftModuleFile)
+        inputs.push_back(IA->getInputArg().getValue());
+  for (const Job *input : Cmd->getInputs()) {
+    for (types::ID type : {types::TY_SwiftModuleFile,
+                           types::TY_SwiftModuleDocFile}) {
+      StringRef path = input->getOutput().getAnyOutputForType(type);
+      if (!path.empty())
+        inputs.push_back(path);
+    }
+  }
+
+  // Modification times may only have a resolution of a second, so an input
+  // from the same second as an output may have been written after it.
+  for (StringRef input : inputs) {
+    fs::file_status status;
+    if (fs::status(input, status) ||
+        !(status.getLastModificationTime() < oldestOutput))
+      return false;
+  }
+  return true;
 }
 
 static bool writeFilelistIfNecessary(const Job *job, DiagnosticEngine &diags) {
@@ -247,6 +560,8 @@ static bool writeFilelistIfNecessary(const Job *job, DiagnosticEngine &diags) {
       if (outputInfo.getPrimaryOutputType() == filelistInfo.type) {
         for (auto &output : outputInfo.getPrimaryOutputFilenames())
           out << output << "\n";
+        for (auto &output : outputInfo.getCodeGenPartitionFilenames())
+          out << output << "\n";
       } else {
         auto &output = outputInfo.getAnyOutputForType(filelistInfo.type);
         if (!output.empty())
@@ -269,7 +584,8 @@ int Compilation::performJobsImpl() {
   if (SkipTaskExecution)
     TQ.reset(new DummyTaskQueue(NumberOfParallelCommands));
   else
-    TQ.reset(new TaskQueue(NumberOfParallelCommands));
+    TQ.reset(new TaskQueue(NumberOfParallelCommands, FrontendServerPath,
+                           JobMemoryLimit));
 
   PerformJobsState State;
 
@@ -283,6 +599,56 @@ int Compilation::performJobsImpl() {
   if (ShowIncrementalBuildDecisions)
     IncrementalTracer = &ActualIncrementalTracer;
 
+  // How long the compile jobs took in the previous build, and in this one.
+  JobTimeMap JobTimes;
+  if (!CompilationRecordPath.empty())
+    readJobTimes(CompilationRecordPath, JobTimes);
+
+  // How much memory the compile jobs used in the previous build, and in this
+  // one.
+  JobMemoryMap JobMemory;
+  if (!CompilationRecordPath.empty())
+    readJobMemory(CompilationRecordPath, JobMemory);
+
+  // The interface hashes of the modules the previous build depended on, and
+  // the ones this build depends on.
+  InterfaceHashMap PreviousInterfaceHashes;
+  InterfaceHashMap InterfaceHashes;
+  if (!CompilationRecordPath.empty() && getIncrementalBuildEnabled())
+    readInterfaceHashes(CompilationRecordPath, PreviousInterfaceHashes);
+  llvm::DenseMap<const Job *, std::chrono::steady_clock::time_point>
+    JobStartTimes;
+
+  // With more than one job running at a time, start the jobs on the longest
+  // chains first, so that they don't end up running alone at the end of the
+  // build. Otherwise jobs run in the order they became ready.
+  JobPriorityMap JobPriorities;
+  if (NumberOfParallelCommands > 1)
+    computeJobPriorities(*this, JobTimes, JobPriorities);
+
+  // With a memory limit, don't start jobs which are expected to need more
+  // memory than the jobs already running leave.
+  JobMemoryEstimateMap JobMemoryEstimates;
+  if (NumberOfParallelCommands > 1 && JobMemoryLimit > 0)
+    computeJobMemoryEstimates(*this, JobMemory, JobMemoryEstimates);
+
+  // Jobs whose inputs are ready, waiting to be handed to the TaskQueue.
+  SmallVector<const Job *, 16> ReadyCommands;
+  // Jobs whose inputs are ready, but which don't have to run.
+  SmallVector<const Job *, 4> UpToDateCommands;
+  auto addReadyCommandsToTaskQueue = [&] {
+    if (NumberOfParallelCommands > 1) {
+      std::stable_sort(ReadyCommands.begin(), ReadyCommands.end(),
+                       [&](const Job *LHS, const Job *RHS) {
+        return JobPriorities.lookup(LHS) > JobPriorities.lookup(RHS);
+      });
+    }
+    for (const Job *Cmd : ReadyCommands)
+      TQ->addTask(Cmd->getExecutable(), Cmd->getArguments(), llvm::None,
+                  (void *)Cmd, JobMemoryEstimates.lookup(Cmd));
+    ReadyCommands.clear();
+  };
+
   auto noteBuilding = [&] (const Job *cmd, StringRef reason) {
     if (!ShowIncrementalBuildDecisions)
       return;
@@ -299,7 +665,9 @@ int Compilation::performJobsImpl() {
 
   // Set up scheduleCommandIfNecessaryAndPossible.
   // This will only schedule the given command if it has not been scheduled
-  // and if all of its inputs are in FinishedCommands.
+  // and if all of its inputs are in FinishedCommands. The command is added to
+  // ReadyCommands, which addReadyCommandsToTaskQueue passes on to the
+  // TaskQueue.
   auto scheduleCommandIfNecessaryAndPossible = [&] (const Job *Cmd) {
     if (State.ScheduledCommands.count(Cmd))
       return;
@@ -318,8 +686,15 @@ int Compilation::performJobsImpl() {
     assert(Cmd->getExtraEnvironment().empty() &&
            "not implemented for compilations with multiple jobs");
     State.ScheduledCommands.insert(Cmd);
-    TQ->addTask(Cmd->getExecutable(), Cmd->getArguments(), llvm::None,
-                (void *)Cmd);
+
+    // In an incremental build, the merged module may not have changed.
+    if (getIncrementalBuildEnabled() &&
+        isa<MergeModuleJobAction>(Cmd->getSource()) &&
+        areMergedModuleOutputsUpToDate(Cmd)) {
+      UpToDateCommands.push_back(Cmd);
+      return;
+    }
+    ReadyCommands.push_back(Cmd);
   };
 
   // When a task finishes, we need to reevaluate the other commands that
@@ -336,6 +711,19 @@ int Compilation::performJobsImpl() {
     }
   };
 
+  // Skip the jobs found to be up to date, which may let the jobs waiting for
+  // them go ahead.
+  auto skipUpToDateCommands = [&] {
+    while (!UpToDateCommands.empty()) {
+      const Job *Cmd = UpToDateCommands.pop_back_val();
+      if (Stats)
+        ++Stats->getDriverCounters().NumDriverJobsSkipped;
+      if (Level == OutputLevel::Parseable)
+        parseable_output::emitSkippedMessage(llvm::errs(), *Cmd);
+      markFinished(Cmd);
+    }
+  };
+
   // Schedule all jobs we can.
   for (const Job *Cmd : getJobs()) {
     if (!getIncrementalBuildEnabled()) {
@@ -390,6 +778,8 @@ int Compilation::performJobsImpl() {
     }
   }
 
+  addReadyCommandsToTaskQueue();
+
   if (getIncrementalBuildEnabled()) {
     SmallVector<const Job *, 16> AdditionalOutOfDateCommands;
 
@@ -407,10 +797,30 @@ int Compilation::performJobsImpl() {
 
     // Check all cross-module dependencies as well.
     for (StringRef dependency : DepGraph.getExternalDependencies()) {
+      auto previousHash = PreviousInterfaceHashes.find(dependency);
       llvm::sys::fs::file_status depStatus;
-      if (!llvm::sys::fs::status(dependency, depStatus))
-        if (depStatus.getLastModificationTime() < LastBuildTime)
+      if (!llvm::sys::fs::status(dependency, depStatus)) {
+        if (depStatus.getLastModificationTime() < LastBuildTime) {
+          if (previousHash != PreviousInterfaceHashes.end())
+            InterfaceHashes[dependency] = previousHash->getValue();
           continue;
+        }
+
+        // A module that was rebuilt without changing its interface doesn't
+        // affect anything that imports it.
+        std::string hash = readInterfaceHashOfModule(dependency);
+        if (!hash.empty()) {
+          InterfaceHashes[dependency] = hash;
+          if (previousHash != PreviousInterfaceHashes.end() &&
+              previousHash->getValue() == hash) {
+            if (ShowIncrementalBuildDecisions) {
+              llvm::outs() << "Ignoring changed dependency with an unchanged "
+                           << "interface: " << dependency << "\n";
+            }
+            continue;
+          }
+        }
+      }
 
       // If the dependency has been modified since the oldest built file,
       // or if we can't stat it for some reason (perhaps it's been deleted?),
@@ -431,6 +841,8 @@ int Compilation::performJobsImpl() {
     }
   }
 
+  addReadyCommandsToTaskQueue();
+
   int Result = EXIT_SUCCESS;
   llvm::TimerGroup DriverTimerGroup("Driver Time Compilation");
   llvm::SmallDenseMap<const Job *, std::unique_ptr<llvm::Timer>, 16>
@@ -443,6 +855,8 @@ int Compilation::performJobsImpl() {
     // TODO: properly handle task began.
     const Job *BeganCmd = (const Job *)Context;
 
+    JobStartTimes[BeganCmd] = std::chrono::steady_clock::now();
+
     if (ShowDriverTimeCompilation) {
       llvm::SmallString<128> TimerName;
       llvm::raw_svector_ostream OS(TimerName);
@@ -482,17 +896,27 @@ int Compilation::performJobsImpl() {
   // it should also schedule any additional commands which we now know need
   // to run.
   auto taskFinished = [&] (ProcessId Pid, int ReturnCode, StringRef Output,
+                           Optional<TaskResourceUsage> Usage,
                            void *Context) -> TaskFinishedResponse {
     const Job *FinishedCmd = (const Job *)Context;
 
+    // Start whatever this job unblocked once we're done.
+    SWIFT_DEFER {
+      skipUpToDateCommands();
+      addReadyCommandsToTaskQueue();
+    };
+
     if (ShowDriverTimeCompilation) {
       DriverTimers[FinishedCmd]->stopTimer();
     }
 
+    if (Stats)
+      ++Stats->getDriverCounters().NumDriverJobsRun;
+
     if (Level == OutputLevel::Parseable) {
       // Parseable output was requested.
       parseable_output::emitFinishedMessage(llvm::errs(), *FinishedCmd, Pid,
-                                            ReturnCode, Output);
+                                            ReturnCode, Output, Usage);
     } else {
       // Otherwise, send the buffered output to stderr, though only if we
       // support getting buffered output.
@@ -599,6 +1023,22 @@ int Compilation::performJobsImpl() {
           TaskFinishedResponse::StopExecution;
     }
 
+    // Remember how long the job took and how much memory it used for the
+    // next build, splitting both evenly between the inputs of a job with
+    // several.
+    if (!SkipTaskExecution) {
+      std::chrono::duration<double> Duration =
+        std::chrono::steady_clock::now() - JobStartTimes[FinishedCmd];
+      SmallVector<StringRef, 4> Inputs;
+      forEachCompileInput(FinishedCmd,
+                          [&](StringRef input) { Inputs.push_back(input); });
+      for (StringRef Input : Inputs) {
+        JobTimes[Input] = Duration.count() / Inputs.size();
+        if (Usage)
+          JobMemory[Input] = Usage->MaxResidentSetSizeBytes / Inputs.size();
+      }
+    }
+
     // When a task finishes, we need to reevaluate the other commands that
     // might have been blocked.
     markFinished(FinishedCmd);
@@ -613,6 +1053,7 @@ int Compilation::performJobsImpl() {
   };
 
   auto taskSignalled = [&] (ProcessId Pid, StringRef ErrorMsg, StringRef Output,
+                            Optional<TaskResourceUsage> Usage,
                             void *Context) -> TaskFinishedResponse {
     const Job *SignalledCmd = (const Job *)Context;
 
@@ -620,10 +1061,13 @@ int Compilation::performJobsImpl() {
       DriverTimers[SignalledCmd]->stopTimer();
     }
 
+    if (Stats)
+      ++Stats->getDriverCounters().NumDriverJobsRun;
+
     if (Level == OutputLevel::Parseable) {
       // Parseable output was requested.
       parseable_output::emitSignalledMessage(llvm::errs(), *SignalledCmd, Pid,
-                                             ErrorMsg, Output);
+                                             ErrorMsg, Output, Usage);
     } else {
       // Otherwise, send the buffered output to stderr, though only if we
       // support getting buffered output.
@@ -650,6 +1094,9 @@ int Compilation::performJobsImpl() {
 
     // Mark all remaining deferred commands as skipped.
     for (const Job *Cmd : DeferredCommands) {
+      if (Stats)
+        ++Stats->getDriverCounters().NumDriverJobsSkipped;
+
       if (Level == OutputLevel::Parseable) {
         // Provide output indicating this command was skipped if parseable output
         // was requested.
@@ -659,6 +1106,9 @@ int Compilation::performJobsImpl() {
       State.ScheduledCommands.insert(Cmd);
       markFinished(Cmd);
     }
+    DeferredCommands.clear();
+    skipUpToDateCommands();
+    addReadyCommandsToTaskQueue();
 
     // ...which may allow us to go on and do later tasks.
   } while (Result == 0 && TQ->hasRemainingTasks());
@@ -692,8 +1142,19 @@ int Compilation::performJobsImpl() {
     InputInfoMap InputInfo;
     populateInputInfoMap(InputInfo, State);
     checkForOutOfDateInputs(Diags, InputInfo);
+
+    // Modules that this build found it depends on haven't been hashed yet.
+    if (getIncrementalBuildEnabled()) {
+      for (StringRef dependency : DepGraph.getExternalDependencies()) {
+        if (InterfaceHashes.count(dependency))
+          continue;
+        std::string hash = readInterfaceHashOfModule(dependency);
+        if (!hash.empty())
+          InterfaceHashes[dependency] = hash;
+      }
+    }
     writeCompilationRecord(CompilationRecordPath, ArgsHash, BuildStartTime,
-                           InputInfo);
+                           InputInfo, JobTimes, JobMemory, InterfaceHashes);
   }
 
   if (Result == 0)
@@ -772,6 +1233,9 @@ int Compilation::performJobs() {
       !ShowDriverTimeCompilation &&
       (SaveTemps || TempFilePaths.empty()) &&
       CompilationRecordPath.empty() &&
+      CompileEventTracePath.empty() &&
+      FrontendServerPath.empty() &&
+      !Stats &&
       Jobs.size() == 1) {
     return performSingleCommand(Jobs.front().get());
   }
@@ -782,6 +1246,9 @@ int Compilation::performJobs() {
   
   int result = performJobsImpl();
 
+  if (!CompileEventTracePath.empty())
+    writeCompileEventTrace();
+
   if (!SaveTemps) {
     // FIXME: Do we want to be deleting temporaries even when a child process
     // crashes?
@@ -794,6 +1261,45 @@ int Compilation::performJobs() {
   return result;
 }
 
+void Compilation::writeCompileEventTrace() {
+  std::error_code EC;
+  llvm::raw_fd_ostream out(CompileEventTracePath, EC, llvm::sys::fs::F_None);
+  if (EC) {
+    Diags.diagnose(SourceLoc(), diag::error_opening_output,
+                   CompileEventTracePath, EC.message());
+    return;
+  }
+
+  // Each frontend trace has the opening of the event array on its first line,
+  // one event per line after that, and the closing of the array on its last
+  // line; see TracedEvent::writeTrace. Every frontend process has its own pid
+  // in its events, so the events can simply be concatenated.
+  out << "{\"traceEvents\":[";
+  bool isFirst = true;
+  for (const std::string &path : CompileEventTraceFiles) {
+    auto buffer = llvm::MemoryBuffer::getFile(path);
+    if (!buffer) {
+      // The job may not have run, or may have crashed before writing its
+      // trace.
+      continue;
+    }
+
+    SmallVector<StringRef, 64> lines;
+    buffer.get()->getBuffer().split(lines, '\n', /*MaxSplit=*/-1,
+                                     /*KeepEmpty=*/false);
+    if (lines.size() < 2)
+      continue;
+    for (StringRef line : makeArrayRef(lines).slice(1, lines.size() - 2)) {
+      line = line.rtrim(',');
+      if (line.empty())
+        continue;
+      out << (isFirst ? "\n" : ",\n") << line;
+      isFirst = false;
+    }
+  }
+  out << "\n]}\n";
+}
+
 const char *Compilation::getAllSourcesPath() const {
   if (!AllSourceFilesPath) {
     SmallString<128> Buffer;
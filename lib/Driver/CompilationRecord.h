@@ -34,6 +34,17 @@ enum class TopLevelKey {
   /// The key for the list of inputs to the compilation that produced the
   /// compilation record.
   Inputs,
+  /// The key for how long the most recent successful compile job of each
+  /// input took, in seconds. Used to schedule long-running jobs first.
+  JobTimes,
+  /// The key for the peak memory use of the most recent successful compile
+  /// job of each input, in bytes. Used to estimate how much memory the jobs
+  /// running in parallel will need.
+  JobMemory,
+  /// The key for the interface hash of each serialized module the
+  /// compilation depended on. Used to avoid rebuilding files when a module
+  /// changes without changing its interface.
+  ExternalInterfaceHashes,
 };
 
 /// \returns A string representation of the given key.
@@ -43,6 +54,10 @@ inline static StringRef getName(TopLevelKey Key) {
   case TopLevelKey::Options: return "options";
   case TopLevelKey::BuildTime: return "build_time";
   case TopLevelKey::Inputs: return "inputs";
+  case TopLevelKey::JobTimes: return "job_times";
+  case TopLevelKey::JobMemory: return "job_memory";
+  case TopLevelKey::ExternalInterfaceHashes:
+    return "external_interface_hashes";
   }
 
   // Work around MSVC warning: not all control paths return a value
@@ -48,12 +48,14 @@ using LoadResult = DependencyGraphImpl::LoadResult;
 using DependencyKind = DependencyGraphImpl::DependencyKind;
 using DependencyCallbackTy = LoadResult(StringRef, DependencyKind, bool);
 using InterfaceHashCallbackTy = LoadResult(StringRef);
+using FingerprintCallbackTy = LoadResult(StringRef, DependencyKind, StringRef);
 
 static LoadResult
 parseDependencyFile(llvm::MemoryBuffer &buffer,
                     llvm::function_ref<DependencyCallbackTy> providesCallback,
                     llvm::function_ref<DependencyCallbackTy> dependsCallback,
-                    llvm::function_ref<InterfaceHashCallbackTy> interfaceHashCallback) {
+                    llvm::function_ref<InterfaceHashCallbackTy> interfaceHashCallback,
+                    llvm::function_ref<FingerprintCallbackTy> fingerprintCallback) {
   namespace yaml = llvm::yaml;
 
   // FIXME: Switch to a format other than YAML.
@@ -105,6 +107,51 @@ parseDependencyFile(llvm::MemoryBuffer &buffer,
       StringRef valueString = value->getValue(scratch);
       UPDATE_RESULT(interfaceHashCallback(valueString));
 
+    } else if (keyString.startswith("fingerprints-")) {
+      DependencyKind kind =
+          llvm::StringSwitch<DependencyKind>(keyString)
+        .Case("fingerprints-top-level", DependencyKind::TopLevelName)
+        .Case("fingerprints-nominal", DependencyKind::NominalType)
+        .Case("fingerprints-member", DependencyKind::NominalTypeMember)
+        .Default(DependencyKind());
+      if (kind == DependencyKind())
+        return LoadResult::HadError;
+
+      auto *entries = dyn_cast<yaml::SequenceNode>(i->getValue());
+      if (!entries)
+        return LoadResult::HadError;
+
+      // Each entry has the form ["name", "fingerprint"], or
+      // ["{MangledBaseName}", "memberName", "fingerprint"] for members.
+      for (yaml::Node &rawEntry : *entries) {
+        auto *entry = dyn_cast<yaml::SequenceNode>(&rawEntry);
+        if (!entry)
+          return LoadResult::HadError;
+
+        SmallVector<std::string, 3> fields;
+        for (yaml::Node &rawField : *entry) {
+          auto *field = dyn_cast<yaml::ScalarNode>(&rawField);
+          if (!field)
+            return LoadResult::HadError;
+          fields.push_back(field->getValue(scratch));
+        }
+
+        size_t expectedSize = kind == DependencyKind::NominalTypeMember ? 3 : 2;
+        if (fields.size() != expectedSize)
+          return LoadResult::HadError;
+
+        // Smash the type and member names together, just as for
+        // "provides-member".
+        SmallString<64> name;
+        name += fields.front();
+        if (kind == DependencyKind::NominalTypeMember) {
+          name.push_back('\0');
+          name += fields[1];
+        }
+
+        UPDATE_RESULT(fingerprintCallback(name.str(), kind, fields.back()));
+      }
+
     } else {
       enum class DependencyDirection : bool {
         Depends,
@@ -206,6 +253,16 @@ parseDependencyFile(llvm::MemoryBuffer &buffer,
   return result;
 }
 
+/// Builds the key used to look up the fingerprint of a provided entry.
+///
+/// The same name may be provided with several kinds, so the kind is folded
+/// into the key.
+static void getFingerprintKey(StringRef name, DependencyKind kind,
+                              SmallVectorImpl<char> &key) {
+  key.push_back(static_cast<char>(kind));
+  key.append(name.begin(), name.end());
+}
+
 LoadResult DependencyGraphImpl::loadFromPath(const void *node, StringRef path) {
   auto buffer = llvm::MemoryBuffer::getFile(path);
   if (!buffer)
@@ -222,9 +279,10 @@ DependencyGraphImpl::loadFromString(const void *node, StringRef data) {
 LoadResult DependencyGraphImpl::loadFromBuffer(const void *node,
                                                llvm::MemoryBuffer &buffer) {
   auto &provides = Provides[node];
+  bool dependsOnMarkedName = false;
 
-  auto dependsCallback = [this, node](StringRef name, DependencyKind kind,
-                                      bool isCascading) -> LoadResult {
+  auto dependsCallback = [this, node, &dependsOnMarkedName](
+      StringRef name, DependencyKind kind, bool isCascading) -> LoadResult {
     if (kind == DependencyKind::ExternalFile)
       ExternalDependencies.insert(name);
 
@@ -245,8 +303,10 @@ LoadResult DependencyGraphImpl::loadFromBuffer(const void *node,
       iter->flags |= flags;
     }
 
-    if (isCascading && (entries.second & kind))
+    if (isCascading && (entries.second & kind)) {
+      dependsOnMarkedName = true;
       return LoadResult::AffectsDownstream;
+    }
     return LoadResult::UpToDate;
   };
 
@@ -260,7 +320,7 @@ LoadResult DependencyGraphImpl::loadFromBuffer(const void *node,
     });
 
     if (iter == provides.end())
-      provides.push_back({name, kind});
+      provides.push_back({name, kind, kind});
     else
       iter->kindMask |= kind;
 
@@ -285,8 +345,62 @@ LoadResult DependencyGraphImpl::loadFromBuffer(const void *node,
     return LoadResult::UpToDate;
   };
 
-  return parseDependencyFile(buffer, providesCallback, dependsCallback,
-                             interfaceHashCallback);
+  // Start over with this node's fingerprints, but hold on to the previous
+  // ones so we can tell which of the provided entries actually changed.
+  llvm::StringMap<std::string> oldFingerprints;
+  std::swap(oldFingerprints, Fingerprints[node]);
+
+  auto fingerprintCallback =
+      [this, node](StringRef name, DependencyKind kind,
+                   StringRef fingerprint) -> LoadResult {
+    SmallString<64> key;
+    getFingerprintKey(name, kind, key);
+    Fingerprints[node][key] = fingerprint;
+    return LoadResult::UpToDate;
+  };
+
+  LoadResult result = parseDependencyFile(buffer, providesCallback,
+                                          dependsCallback,
+                                          interfaceHashCallback,
+                                          fingerprintCallback);
+  if (result == LoadResult::HadError)
+    return result;
+
+  // Work out which of the provided entries may have changed since the last
+  // load. An entry is only known to be unchanged if both the old and the new
+  // file recorded the same fingerprint for it; anything without a
+  // fingerprint, or that was added or removed, is conservatively treated as
+  // changed. Fingerprints only reflect the node's own contents, so if it now
+  // depends on something that has already been marked, everything it
+  // provides is suspect.
+  const auto &newFingerprints = Fingerprints[node];
+  const DependencyKind fingerprintedKinds[] = {
+    DependencyKind::TopLevelName,
+    DependencyKind::NominalType,
+    DependencyKind::NominalTypeMember,
+  };
+  for (auto &entry : provides) {
+    entry.changedMask = entry.kindMask;
+    if (dependsOnMarkedName)
+      continue;
+    for (DependencyKind kind : fingerprintedKinds) {
+      if (!entry.kindMask.contains(kind))
+        continue;
+
+      SmallString<64> key;
+      getFingerprintKey(entry.name, kind, key);
+      auto oldIter = oldFingerprints.find(key);
+      if (oldIter == oldFingerprints.end())
+        continue;
+      auto newIter = newFingerprints.find(key);
+      if (newIter == newFingerprints.end())
+        continue;
+      if (oldIter->getValue() == newIter->getValue())
+        entry.changedMask -= kind;
+    }
+  }
+
+  return result;
 }
 
 void DependencyGraphImpl::markExternal(SmallVectorImpl<const void *> &visited,
@@ -322,26 +436,32 @@ DependencyGraphImpl::markTransitive(SmallVectorImpl<const void *> &visited,
   SmallPtrSet<const void *, 16> visitedSet;
 
   auto addDependentsToWorklist = [&](const void *next,
-                                     ArrayRef<MarkTracerImpl::Entry> reason) {
+                                     ArrayRef<MarkTracerImpl::Entry> reason,
+                                     bool onlyChanged) {
     auto allProvided = Provides.find(next);
     if (allProvided == Provides.end())
       return;
 
     for (const auto &provided : allProvided->second) {
+      DependencyMaskTy kindMask =
+          onlyChanged ? provided.changedMask : provided.kindMask;
+      if (!kindMask)
+        continue;
+
       auto allDependents = Dependencies.find(provided.name);
       if (allDependents == Dependencies.end())
         continue;
 
-      if (allDependents->second.second.contains(provided.kindMask))
+      if (allDependents->second.second.contains(kindMask))
         continue;
 
       // Record that we've traversed this dependency.
-      allDependents->second.second |= provided.kindMask;
+      allDependents->second.second |= kindMask;
 
       for (const auto &dependent : allDependents->second.first) {
         if (dependent.node == next)
           continue;
-        auto intersectingKinds = provided.kindMask & dependent.kindMask;
+        auto intersectingKinds = kindMask & dependent.kindMask;
         if (!intersectingKinds)
           continue;
         if (isMarked(dependent.node))
@@ -373,8 +493,11 @@ DependencyGraphImpl::markTransitive(SmallVectorImpl<const void *> &visited,
   };
 
   // Always mark through the starting node, even if it's already marked.
+  // Only the entries it provides that may have changed since it was last
+  // loaded need to be followed; nodes reached from there are rebuilt, so
+  // everything they provide is suspect.
   markIntransitive(node);
-  addDependentsToWorklist(node, {});
+  addDependentsToWorklist(node, {}, /*onlyChanged=*/true);
 
   while (!worklist.empty()) {
     auto next = worklist.pop_back_val();
@@ -386,7 +509,7 @@ DependencyGraphImpl::markTransitive(SmallVectorImpl<const void *> &visited,
       continue;
     }
 
-    addDependentsToWorklist(next.Node, next.Reason);
+    addDependentsToWorklist(next.Node, next.Reason, /*onlyChanged=*/false);
     if (!markIntransitive(next.Node))
       continue;
     record(next);
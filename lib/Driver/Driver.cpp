@@ -23,6 +23,7 @@
 #include "swift/AST/DiagnosticsFrontend.h"
 #include "swift/Basic/Fallthrough.h"
 #include "swift/Basic/LLVM.h"
+#include "swift/Basic/Statistic.h"
 #include "swift/Basic/TaskQueue.h"
 #include "swift/Basic/Version.h"
 #include "swift/Basic/Range.h"
@@ -54,6 +55,7 @@
 
 #include "CompilationRecord.h"
 
+#include <algorithm>
 #include <memory>
 
 using namespace swift;
@@ -156,6 +158,13 @@ static void validateArgs(DiagnosticEngine &diags, const ArgList &Args) {
     diags.diagnose(SourceLoc(), diag::error_conflicting_options,
                    "-warnings-as-errors", "-suppress-warnings");
   }
+
+  // Instrumenting code and optimizing it with a profile don't mix.
+  if (Args.hasArg(options::OPT_profile_generate) &&
+      Args.hasArg(options::OPT_profile_use_EQ)) {
+    diags.diagnose(SourceLoc(), diag::error_conflicting_options,
+                   "-profile-generate", "-profile-use");
+  }
 }
 
 /// Creates an appropriate ToolChain for a given driver and target triple.
@@ -611,6 +620,15 @@ std::unique_ptr<Compilation> Driver::buildCompilation(
     }
   }
 
+  uint64_t JobMemoryLimitMB = 0;
+  if (const Arg *A = ArgList->getLastArg(options::OPT_job_memory_limit)) {
+    if (StringRef(A->getValue()).getAsInteger(10, JobMemoryLimitMB)) {
+      Diags.diagnose(SourceLoc(), diag::error_invalid_arg_value,
+                     A->getAsString(*ArgList), A->getValue());
+      return nullptr;
+    }
+  }
+
   OutputLevel Level = OutputLevel::Normal;
   if (const Arg *A = ArgList->getLastArg(options::OPT_v,
                                          options::OPT_parseable_output)) {
@@ -646,6 +664,21 @@ std::unique_ptr<Compilation> Driver::buildCompilation(
   if (ShowIncrementalBuildDecisions)
     C->setShowsIncrementalBuildDecisions();
 
+  if (const Arg *A = C->getArgs().getLastArg(options::OPT_trace_compile_events))
+    C->setCompileEventTracePath(A->getValue());
+
+  if (const Arg *A =
+        C->getArgs().getLastArg(options::OPT_driver_use_frontend_server))
+    C->setFrontendServerPath(A->getValue());
+
+  if (JobMemoryLimitMB > 0)
+    C->setJobMemoryLimit(JobMemoryLimitMB * 1024 * 1024);
+
+  if (const Arg *A = C->getArgs().getLastArg(options::OPT_stats_output_dir)) {
+    C->setStatsReporter(llvm::make_unique<UnifiedStatsReporter>(
+        "swift-driver", OI.ModuleName, A->getValue()));
+  }
+
   // This has to happen after building jobs, because otherwise we won't even
   // emit .swiftdeps files for the next build.
   if (rebuildEverything)
@@ -988,6 +1021,25 @@ static bool isSDKTooOld(StringRef sdkPath, const llvm::Triple &target) {
   }
 }
 
+/// Returns true if a frontend invocation with several primary files can
+/// produce outputs of type \p OutputType.
+static bool canBatchCompilerOutputType(types::ID OutputType,
+                                       const ArgList &Args) {
+  switch (OutputType) {
+  case types::TY_Object:
+  case types::TY_Assembly:
+  case types::TY_LLVM_IR:
+  case types::TY_LLVM_BC:
+  case types::TY_SIL:
+  case types::TY_RawSIL:
+    return true;
+  case types::TY_Nothing:
+    return Args.hasArg(options::OPT_typecheck);
+  default:
+    return false;
+  }
+}
+
 void Driver::buildOutputInfo(const ToolChain &TC, const DerivedArgList &Args,
                              const InputFileList &Inputs,
                              OutputInfo &OI) const {
@@ -1014,6 +1066,14 @@ void Driver::buildOutputInfo(const ToolChain &TC, const DerivedArgList &Args,
     }
   }
 
+  if (const Arg *A =
+          Args.getLastArg(options::OPT_parallel_codegen_partitions)) {
+    if (StringRef(A->getValue()).getAsInteger(10, OI.CodeGenPartitions)) {
+      Diags.diagnose(SourceLoc(), diag::error_invalid_arg_value,
+                     A->getAsString(Args), A->getValue());
+    }
+  }
+
   const Arg *const OutputModeArg = Args.getLastArg(options::OPT_modes_Group);
 
   if (!OutputModeArg) {
@@ -1181,6 +1241,42 @@ void Driver::buildOutputInfo(const ToolChain &TC, const DerivedArgList &Args,
     OI.ShouldGenerateFixitEdits = true;
   }
 
+  if (OI.CompilerMode == OutputInfo::Mode::StandardCompile &&
+      Args.hasFlag(options::OPT_enable_batch_mode,
+                   options::OPT_disable_batch_mode, false)) {
+    // A batch job only produces the main output for each of its primary
+    // files, so anything that needs per-file supplementary outputs falls back
+    // to one frontend invocation per file.
+    StringRef Conflict;
+    if (const Arg *A = Args.getLastArg(options::OPT_incremental,
+                                       options::OPT_emit_dependencies,
+                                       options::OPT_serialize_diagnostics,
+                                       options::OPT_embed_bitcode,
+                                       options::OPT_fixit_code))
+      Conflict = A->getSpelling();
+    else if (OI.ShouldGenerateModule)
+      Conflict = "-emit-module";
+    else if (!canBatchCompilerOutputType(OI.CompilerOutputType, Args))
+      Conflict = OutputModeArg ? OutputModeArg->getSpelling()
+                               : types::getTypeName(OI.CompilerOutputType);
+
+    if (!Conflict.empty()) {
+      Diags.diagnose(SourceLoc(), diag::warning_batch_mode_ignored, Conflict);
+    } else {
+      // By default, use one batch per parallel command.
+      OI.BatchCount = 1;
+      if (const Arg *A = Args.getLastArg(options::OPT_driver_batch_count,
+                                         options::OPT_j)) {
+        if (StringRef(A->getValue()).getAsInteger(10, OI.BatchCount) ||
+            OI.BatchCount == 0) {
+          Diags.diagnose(SourceLoc(), diag::error_invalid_arg_value,
+                         A->getAsString(Args), A->getValue());
+          OI.BatchCount = 0;
+        }
+      }
+    }
+  }
+
   {
     if (const Arg *A = Args.getLastArg(options::OPT_sdk)) {
       OI.SDKPath = A->getValue();
@@ -1204,6 +1300,7 @@ void Driver::buildOutputInfo(const ToolChain &TC, const DerivedArgList &Args,
                         [&OI](sys::ProcessId PID,
                               int returnCode,
                               StringRef output,
+                              Optional<sys::TaskResourceUsage> usage,
                               void *unused) -> sys::TaskFinishedResponse {
             if (returnCode == 0) {
               output = output.rtrim();
@@ -1265,11 +1362,37 @@ void Driver::buildActions(const ToolChain &TC,
   switch (OI.CompilerMode) {
   case OutputInfo::Mode::StandardCompile:
   case OutputInfo::Mode::UpdateCode: {
+    // In batch mode, the Swift source inputs are split into OI.BatchCount
+    // contiguous partitions, each of which is compiled by a single job.
+    unsigned NumBatchableInputs = 0;
+    if (OI.isBatchMode())
+      NumBatchableInputs = std::count_if(Inputs.begin(), Inputs.end(),
+                                         [](const InputPair &Input) {
+        return Input.first == types::TY_Swift;
+      });
+    unsigned NumBatches = std::min(OI.BatchCount, NumBatchableInputs);
+    unsigned BatchableInputIndex = 0;
+    unsigned CurrentBatchIndex = ~0U;
+    CompileJobAction *CurrentBatch = nullptr;
+
     for (const InputPair &Input : Inputs) {
       types::ID InputType = Input.first;
       const Arg *InputArg = Input.second;
 
       std::unique_ptr<Action> Current(new InputAction(*InputArg, InputType));
+      if (NumBatches > 0 && InputType == types::TY_Swift) {
+        unsigned BatchIndex =
+          BatchableInputIndex++ * NumBatches / NumBatchableInputs;
+        if (BatchIndex != CurrentBatchIndex) {
+          CurrentBatchIndex = BatchIndex;
+          CurrentBatch = new CompileJobAction(OI.CompilerOutputType);
+          AllModuleInputs.push_back(CurrentBatch);
+          AllLinkerInputs.push_back(CurrentBatch);
+        }
+        CurrentBatch->addInput(Current.release());
+        continue;
+      }
+
       switch (InputType) {
       case types::TY_Swift:
       case types::TY_SIL:
@@ -1830,10 +1953,12 @@ Job *Driver::buildJobsForAction(Compilation &C, const JobAction *JA,
   llvm::SmallString<128> Buf;
   StringRef OutputFile;
 
-  if (OI.isMultiThreading() && isa<CompileJobAction>(JA) &&
-      types::isAfterLLVM(JA->getType())) {
-    // Multi-threaded compilation: A single frontend command produces multiple
-    // output file: one for each input files.
+  bool IsBatchCompile = OI.isBatchMode() && isa<CompileJobAction>(JA) &&
+                        InputActions.size() > 1;
+  if ((OI.isMultiThreading() && isa<CompileJobAction>(JA) &&
+       types::isAfterLLVM(JA->getType())) || IsBatchCompile) {
+    // Multi-threaded or batch mode compilation: A single frontend command
+    // produces multiple output file: one for each input files.
     auto OutputFunc = [&](StringRef Input) {
       const TypeToPathMap *OMForInput = nullptr;
       if (OFM)
@@ -1860,6 +1985,25 @@ Job *Driver::buildJobsForAction(Compilation &C, const JobAction *JA,
                                    AtTopLevel, BaseInput, InputJobs,
                                    Diags, Buf);
     Output->addPrimaryOutput(OutputFile, BaseInput);
+
+    // If code generation is split into partitions, each partition after the
+    // first one is written to an object file next to the primary output.
+    // With -embed-bitcode, code generation happens in the backend job.
+    if (OI.CodeGenPartitions > 1 &&
+        (isa<CompileJobAction>(JA) || isa<BackendJobAction>(JA)) &&
+        OI.CompilerMode == OutputInfo::Mode::StandardCompile &&
+        JA->getType() == types::TY_Object && !OutputFile.empty()) {
+      bool isTempFile = C.isTemporaryFile(OutputFile);
+      StringRef Extension = llvm::sys::path::extension(OutputFile);
+      for (unsigned i = 1; i < OI.CodeGenPartitions; ++i) {
+        llvm::SmallString<128> Path(OutputFile);
+        llvm::sys::path::replace_extension(Path, Twine("part") + Twine(i) +
+                                                     Extension);
+        Output->addCodeGenPartitionOutput(Path);
+        if (isTempFile)
+          C.addTemporaryFile(Path);
+      }
+    }
   }
 
   // Choose the swiftmodule output path.
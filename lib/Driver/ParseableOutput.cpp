@@ -16,6 +16,7 @@
 #include "swift/Driver/Action.h"
 #include "swift/Driver/Job.h"
 #include "swift/Driver/Types.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/Option/Arg.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -173,15 +174,29 @@ public:
 };
 
 class TaskOutputMessage : public TaskBasedMessage {
-  std::string Output;
+  // Messages only live while they are emitted, so don't copy the output.
+  StringRef Output;
+  Optional<uint64_t> UserTime;
+  Optional<uint64_t> SystemTime;
+  Optional<uint64_t> MaxRSS;
 public:
   TaskOutputMessage(StringRef Kind, const Job &Cmd, ProcessId Pid,
-                    StringRef Output) : TaskBasedMessage(Kind, Cmd, Pid),
-                                        Output(Output) {}
+                    StringRef Output, Optional<TaskResourceUsage> Usage)
+      : TaskBasedMessage(Kind, Cmd, Pid), Output(Output) {
+    if (Usage) {
+      UserTime = Usage->UserTimeMicroseconds;
+      SystemTime = Usage->SystemTimeMicroseconds;
+      MaxRSS = Usage->MaxResidentSetSizeBytes;
+    }
+  }
 
   virtual void provideMapping(swift::json::Output &out) {
     TaskBasedMessage::provideMapping(out);
-    out.mapOptional("output", Output, std::string());
+    out.mapOptional("output", Output, StringRef());
+    // CPU times are in microseconds, the peak resident set size in bytes.
+    out.mapOptional("user-time", UserTime);
+    out.mapOptional("system-time", SystemTime);
+    out.mapOptional("max-rss", MaxRSS);
   }
 };
 
@@ -189,9 +204,9 @@ class FinishedMessage : public TaskOutputMessage {
   int ExitStatus;
 public:
   FinishedMessage(const Job &Cmd, ProcessId Pid, StringRef Output,
-                  int ExitStatus) : TaskOutputMessage("finished", Cmd, Pid,
-                                                      Output),
-                                    ExitStatus(ExitStatus) {}
+                  Optional<TaskResourceUsage> Usage, int ExitStatus)
+      : TaskOutputMessage("finished", Cmd, Pid, Output, Usage),
+        ExitStatus(ExitStatus) {}
 
   virtual void provideMapping(swift::json::Output &out) {
     TaskOutputMessage::provideMapping(out);
@@ -203,9 +218,9 @@ class SignalledMessage : public TaskOutputMessage {
   std::string ErrorMsg;
 public:
   SignalledMessage(const Job &Cmd, ProcessId Pid, StringRef Output,
-                   StringRef ErrorMsg) : TaskOutputMessage("signalled", Cmd,
-                                                           Pid, Output),
-                                         ErrorMsg(ErrorMsg) {}
+                   Optional<TaskResourceUsage> Usage, StringRef ErrorMsg)
+      : TaskOutputMessage("signalled", Cmd, Pid, Output, Usage),
+        ErrorMsg(ErrorMsg) {}
 
   virtual void provideMapping(swift::json::Output &out) {
     TaskOutputMessage::provideMapping(out);
@@ -235,12 +250,13 @@ struct ObjectTraits<Message> {
 } // end namespace llvm
 
 static void emitMessage(raw_ostream &os, Message &msg) {
-  std::string JSONString;
-  llvm::raw_string_ostream BufferStream(JSONString);
+  // The length goes first, so the message has to be rendered before any of
+  // it can be written.
+  SmallString<1024> JSONString;
+  llvm::raw_svector_ostream BufferStream(JSONString);
   json::Output yout(BufferStream);
   yout << msg;
-  BufferStream.flush();
-  os << JSONString.length() << '\n';
+  os << JSONString.size() << '\n';
   os << JSONString << '\n';
 }
 
@@ -252,16 +268,18 @@ void parseable_output::emitBeganMessage(raw_ostream &os,
 
 void parseable_output::emitFinishedMessage(raw_ostream &os,
                                            const Job &Cmd, ProcessId Pid,
-                                           int ExitStatus, StringRef Output) {
-  FinishedMessage msg(Cmd, Pid, Output, ExitStatus);
+                                           int ExitStatus, StringRef Output,
+                                           Optional<TaskResourceUsage> Usage) {
+  FinishedMessage msg(Cmd, Pid, Output, Usage, ExitStatus);
   emitMessage(os, msg);
 }
 
 void parseable_output::emitSignalledMessage(raw_ostream &os,
                                             const Job &Cmd, ProcessId Pid,
                                             StringRef ErrorMsg,
-                                            StringRef Output) {
-  SignalledMessage msg(Cmd, Pid, Output, ErrorMsg);
+                                            StringRef Output,
+                                            Optional<TaskResourceUsage> Usage) {
+  SignalledMessage msg(Cmd, Pid, Output, Usage, ErrorMsg);
   emitMessage(os, msg);
 }
 
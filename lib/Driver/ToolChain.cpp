@@ -63,6 +63,12 @@ ToolChain::JobContext::getTemporaryFilePath(const llvm::Twine &name,
   return C.getArgs().MakeArgString(buffer.str());
 }
 
+const char *ToolChain::JobContext::getCompileEventTraceFilePath() const {
+  const char *path = getTemporaryFilePath("trace", "json");
+  C.addCompileEventTraceFile(path);
+  return path;
+}
+
 std::unique_ptr<Job>
 ToolChain::constructJob(const JobAction &JA,
                         Compilation &C,
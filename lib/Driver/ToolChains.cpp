@@ -25,6 +25,7 @@
 #include "swift/Config.h"
 #include "clang/Basic/Version.h"
 #include "clang/Driver/Util.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/Option/Arg.h"
 #include "llvm/Option/ArgList.h"
@@ -72,6 +73,10 @@ static void addPrimaryInputsOfType(ArgStringList &Arguments,
       for (const std::string &Output : outputInfo.getPrimaryOutputFilenames()) {
         Arguments.push_back(Output.c_str());
       }
+      for (const std::string &Output :
+             outputInfo.getCodeGenPartitionFilenames()) {
+        Arguments.push_back(Output.c_str());
+      }
     }
   }
 }
@@ -115,21 +120,30 @@ static void addCommonFrontendArgs(const ToolChain &TC,
   inputArgs.AddLastArg(arguments, options::OPT_AssertConfig);
   inputArgs.AddLastArg(arguments, options::OPT_autolink_force_load);
   inputArgs.AddLastArg(arguments, options::OPT_color_diagnostics);
+  inputArgs.AddLastArg(arguments, options::OPT_compilation_cache_path);
+  inputArgs.AddLastArg(arguments, options::OPT_cross_module_optimization);
   inputArgs.AddLastArg(arguments, options::OPT_fixit_all);
   inputArgs.AddLastArg(arguments, options::OPT_enable_app_extension);
   inputArgs.AddLastArg(arguments, options::OPT_enable_testing);
   inputArgs.AddLastArg(arguments, options::OPT_g_Group);
   inputArgs.AddLastArg(arguments, options::OPT_import_objc_header);
   inputArgs.AddLastArg(arguments, options::OPT_import_underlying_module);
+  inputArgs.AddLastArg(arguments, options::OPT_index_store_path);
   inputArgs.AddLastArg(arguments, options::OPT_module_cache_path);
   inputArgs.AddLastArg(arguments, options::OPT_module_link_name);
   inputArgs.AddLastArg(arguments, options::OPT_nostdimport);
   inputArgs.AddLastArg(arguments, options::OPT_parse_stdlib);
   inputArgs.AddLastArg(arguments, options::OPT_resource_dir);
   inputArgs.AddLastArg(arguments, options::OPT_solver_memory_threshold);
+  inputArgs.AddLastArg(arguments, options::OPT_stats_output_dir);
   inputArgs.AddLastArg(arguments, options::OPT_suppress_warnings);
   inputArgs.AddLastArg(arguments, options::OPT_profile_generate);
   inputArgs.AddLastArg(arguments, options::OPT_profile_coverage_mapping);
+  inputArgs.AddLastArg(arguments, options::OPT_profile_use_EQ);
+  inputArgs.AddLastArg(arguments, options::OPT_Rpass_EQ);
+  inputArgs.AddLastArg(arguments, options::OPT_Rpass_missed_EQ);
+  inputArgs.AddLastArg(arguments, options::OPT_save_optimization_record);
+  inputArgs.AddLastArg(arguments, options::OPT_save_optimization_record_path);
   inputArgs.AddLastArg(arguments, options::OPT_warnings_as_errors);
   inputArgs.AddLastArg(arguments, options::OPT_sanitize_EQ);
   inputArgs.AddLastArg(arguments, options::OPT_sanitize_coverage_EQ);
@@ -248,30 +262,31 @@ ToolChain::constructInvocation(const CompileJobAction &job,
   switch (context.OI.CompilerMode) {
   case OutputInfo::Mode::StandardCompile:
   case OutputInfo::Mode::UpdateCode: {
-    assert(context.InputActions.size() == 1 &&
-           "The Swift frontend expects exactly one input (the primary file)!");
-
-    auto *IA = cast<InputAction>(context.InputActions[0]);
-    const Arg &PrimaryInputArg = IA->getInputArg();
+    assert((context.InputActions.size() == 1 || context.OI.isBatchMode()) &&
+           "The Swift frontend expects exactly one input (the primary file) "
+           "outside of batch mode!");
 
     if (context.Args.hasArg(options::OPT_driver_use_filelists) ||
         context.getTopLevelInputFiles().size() > TOO_MANY_FILES) {
       Arguments.push_back("-filelist");
       Arguments.push_back(context.getAllSourcesPath());
-      Arguments.push_back("-primary-file");
-      PrimaryInputArg.render(context.Args, Arguments);
+      for (const Action *A : context.InputActions) {
+        Arguments.push_back("-primary-file");
+        cast<InputAction>(A)->getInputArg().render(context.Args, Arguments);
+      }
     } else {
-      bool FoundPrimaryInput = false;
+      llvm::SmallDenseSet<unsigned, 4> PrimaryInputIndices;
+      for (const Action *A : context.InputActions)
+        PrimaryInputIndices.insert(
+            cast<InputAction>(A)->getInputArg().getIndex());
+
       for (auto inputPair : context.getTopLevelInputFiles()) {
         if (!types::isPartOfSwiftCompilation(inputPair.first))
           continue;
 
         // See if this input should be passed with -primary-file.
-        if (!FoundPrimaryInput &&
-            PrimaryInputArg.getIndex() == inputPair.second->getIndex()) {
+        if (PrimaryInputIndices.erase(inputPair.second->getIndex()))
           Arguments.push_back("-primary-file");
-          FoundPrimaryInput = true;
-        }
         Arguments.push_back(inputPair.second->getValue());
       }
     }
@@ -301,6 +316,11 @@ ToolChain::constructInvocation(const CompileJobAction &job,
   addCommonFrontendArgs(*this, context.OI, context.Output, context.Args,
                         Arguments);
 
+  if (context.Args.hasArg(options::OPT_trace_compile_events)) {
+    Arguments.push_back("-trace-compile-events");
+    Arguments.push_back(context.getCompileEventTraceFilePath());
+  }
+
   // Pass the optimization level down to the frontend.
   context.Args.AddLastArg(Arguments, options::OPT_O_Group);
 
@@ -365,6 +385,11 @@ ToolChain::constructInvocation(const CompileJobAction &job,
         context.Args.MakeArgString(Twine(context.OI.numThreads)));
   }
 
+  for (auto &FileName : context.Output.getCodeGenPartitionFilenames()) {
+    Arguments.push_back("-codegen-partition-output");
+    Arguments.push_back(FileName.c_str());
+  }
+
   // Add the output file argument if necessary.
   if (context.Output.getPrimaryOutputType() != types::TY_Nothing) {
     if (context.Args.hasArg(options::OPT_driver_use_filelists) ||
@@ -551,6 +576,11 @@ ToolChain::constructInvocation(const BackendJobAction &job,
     }
   }
 
+  for (auto &FileName : context.Output.getCodeGenPartitionFilenames()) {
+    Arguments.push_back("-codegen-partition-output");
+    Arguments.push_back(FileName.c_str());
+  }
+
   // Add flags implied by -embed-bitcode.
   Arguments.push_back("-embed-bitcode");
   // Disable all llvm IR level optimizations.
@@ -778,6 +808,7 @@ static bool findXcodeClangPath(llvm::SmallVectorImpl<char> &path) {
                   [&path](sys::ProcessId PID,
                           int returnCode,
                           StringRef output,
+                          Optional<sys::TaskResourceUsage> usage,
                           void *unused) -> sys::TaskFinishedResponse {
       if (returnCode == 0) {
         output = output.rtrim();
@@ -0,0 +1,281 @@
+//===--- CompilationCache.cpp - Cache of frontend job outputs -------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Each entry is a directory named after its key, holding the outputs of the
+// job as files named by their index, the textual diagnostics and a
+// manifest:
+//
+//   swift-compilation-cache 1
+//   outputs <number of outputs>
+//   dependency <MD5 of the contents> <path>
+//   ...
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/Frontend/CompilationCache.h"
+#include "swift/Basic/FileSystem.h"
+#include "swift/Frontend/Frontend.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+
+using namespace swift;
+namespace fs = llvm::sys::fs;
+namespace path = llvm::sys::path;
+
+static const char ManifestHeader[] = "swift-compilation-cache 1";
+
+/// Returns the MD5 of the contents of the file at \p filePath, or None if it
+/// can't be read.
+static Optional<std::string> hashFile(StringRef filePath) {
+  auto buffer = llvm::MemoryBuffer::getFile(filePath);
+  if (!buffer)
+    return None;
+
+  llvm::MD5 hash;
+  hash.update(buffer.get()->getBuffer());
+  llvm::MD5::MD5Result result;
+  hash.final(result);
+  SmallString<32> str;
+  llvm::MD5::stringifyResult(result, str);
+  return str.str().str();
+}
+
+/// Replaces the file at \p filePath with \p contents, without leaving a
+/// partially written file behind. A file which already has these contents is
+/// left untouched, so that its modification time says when it last changed.
+///
+/// \returns true on error
+static bool writeFileIfDifferent(StringRef filePath, StringRef contents) {
+  int FD;
+  SmallString<128> tempPath;
+  if (fs::createUniqueFile(filePath + "-%%%%%%%%.tmp", FD, tempPath))
+    return true;
+
+  {
+    llvm::raw_fd_ostream out(FD, /*shouldClose=*/true);
+    out << contents;
+    out.close();
+    if (out.has_error()) {
+      out.clear_error();
+      fs::remove(tempPath);
+      return true;
+    }
+  }
+
+  if (swift::moveFileIfDifferent(tempPath, filePath)) {
+    fs::remove(tempPath);
+    return true;
+  }
+  return false;
+}
+
+/// Reads the whole file at \p filePath.
+static std::unique_ptr<llvm::MemoryBuffer> readFile(StringRef filePath) {
+  auto buffer = llvm::MemoryBuffer::getFile(filePath, /*FileSize=*/-1,
+                                            /*RequiresNullTerminator=*/false);
+  if (!buffer)
+    return nullptr;
+  return std::move(buffer.get());
+}
+
+static std::vector<std::string>
+getOutputs(const CompilerInvocation &invocation) {
+  const FrontendOptions &opts = invocation.getFrontendOptions();
+  std::vector<std::string> outputs;
+  opts.forAllOutputPaths([&](const std::string &output) {
+    outputs.push_back(output);
+  });
+
+  const std::string *otherOutputs[] = {
+    &opts.SerializedDiagnosticsPath,
+    &opts.DependenciesFilePath,
+    &opts.ReferenceDependenciesFilePath,
+    &opts.FixitsOutputPath
+  };
+  for (const std::string *output : otherOutputs) {
+    if (!output->empty())
+      outputs.push_back(*output);
+  }
+
+  // The objects of the partitions are part of the primary output.
+  auto &partitions = invocation.getIRGenOptions().CodeGenPartitionOutputs;
+  outputs.insert(outputs.end(), partitions.begin(), partitions.end());
+  return outputs;
+}
+
+bool CompilationCache::canCache(const CompilerInvocation &invocation) {
+  const FrontendOptions &opts = invocation.getFrontendOptions();
+  switch (opts.RequestedAction) {
+  case FrontendOptions::EmitModuleOnly:
+    break;
+  case FrontendOptions::EmitAssembly:
+  case FrontendOptions::EmitIR:
+  case FrontendOptions::EmitBC:
+  case FrontendOptions::EmitObject:
+    if (opts.OutputFilenames.empty())
+      return false;
+    break;
+  default:
+    return false;
+  }
+
+  if (opts.InputFilenames.empty() || !opts.InputBuffers.empty())
+    return false;
+
+  // Jobs which write anything but their outputs, or which report on the
+  // compilation itself, have to run.
+  if (!opts.DumpAPIPath.empty() || !opts.IndexStorePath.empty() ||
+      !opts.TraceCompileEventsPath.empty() || !opts.StatsOutputDir.empty() ||
+      opts.PrintStats || opts.PrintClangStats || opts.DebugTimeCompilation ||
+      opts.DebugTimeFunctionBodies || opts.WarnLongFunctionBodies ||
+      opts.CrashMode != FrontendOptions::DebugCrashMode::None)
+    return false;
+  if (!invocation.getSILOptions().OptRecordFile.empty() ||
+      !invocation.getSILOptions().SILOutputFileNameForDebugging.empty())
+    return false;
+  if (invocation.getDiagnosticOptions().VerifyMode !=
+        DiagnosticOptions::NoVerify)
+    return false;
+
+  for (auto &output : getOutputs(invocation)) {
+    if (output == "-")
+      return false;
+  }
+  return true;
+}
+
+CompilationCache::CompilationCache(StringRef path,
+                                   const CompilerInvocation &invocation,
+                                   StringRef key)
+  : Path(path), Outputs(getOutputs(invocation)),
+    Key(key) {}
+
+std::string CompilationCache::getEntryPath() const {
+  // Spread the entries over subdirectories, like Git's objects.
+  SmallString<128> entryPath(Path);
+  path::append(entryPath, StringRef(Key).substr(0, 2), Key);
+  return entryPath.str();
+}
+
+bool CompilationCache::replay(raw_ostream &diagnostics) {
+  std::string entryPath = getEntryPath();
+  SmallString<128> filePath(entryPath);
+  path::append(filePath, "manifest");
+  auto manifest = readFile(filePath);
+  if (!manifest)
+    return false;
+
+  SmallVector<StringRef, 16> lines;
+  manifest->getBuffer().split(lines, '\n', /*MaxSplit=*/-1,
+                              /*KeepEmpty=*/false);
+  if (lines.size() < 2 || lines[0] != ManifestHeader ||
+      lines[1] != ("outputs " + Twine(Outputs.size())).str())
+    return false;
+
+  for (StringRef line : llvm::makeArrayRef(lines).slice(2)) {
+    if (!line.startswith("dependency "))
+      return false;
+    auto hashAndPath = line.drop_front(strlen("dependency ")).split(' ');
+    auto currentHash = hashFile(hashAndPath.second);
+    if (!currentHash || *currentHash != hashAndPath.first)
+      return false;
+  }
+
+  // Read everything before writing any output, so that an incomplete entry
+  // doesn't leave a mix of old and new outputs behind.
+  std::vector<std::unique_ptr<llvm::MemoryBuffer>> contents;
+  for (unsigned i = 0, e = Outputs.size(); i != e; ++i) {
+    filePath = entryPath;
+    path::append(filePath, Twine(i));
+    contents.push_back(readFile(filePath));
+    if (!contents.back())
+      return false;
+  }
+  filePath = entryPath;
+  path::append(filePath, "diagnostics");
+  auto cachedDiagnostics = readFile(filePath);
+  if (!cachedDiagnostics)
+    return false;
+
+  for (unsigned i = 0, e = Outputs.size(); i != e; ++i) {
+    if (writeFileIfDifferent(Outputs[i], contents[i]->getBuffer()))
+      return false;
+  }
+
+  diagnostics << cachedDiagnostics->getBuffer();
+  return true;
+}
+
+void CompilationCache::store(ArrayRef<std::string> dependencies,
+                             StringRef diagnostics) {
+  std::string manifest;
+  llvm::raw_string_ostream manifestOS(manifest);
+  manifestOS << ManifestHeader << "\n";
+  manifestOS << "outputs " << Outputs.size() << "\n";
+  for (auto &dependency : dependencies) {
+    auto hash = hashFile(dependency);
+    if (!hash || StringRef(dependency).find('\n') != StringRef::npos)
+      return;
+    manifestOS << "dependency " << *hash << " " << dependency << "\n";
+  }
+  manifestOS.flush();
+
+  // Build the entry next to where it goes and move it into place at once,
+  // so that concurrent jobs never see a partial entry.
+  std::string entryPath = getEntryPath();
+  StringRef parentPath = path::parent_path(entryPath);
+  if (fs::create_directories(parentPath))
+    return;
+
+  SmallString<128> tempPath;
+  if (fs::getPotentiallyUniqueFileName(entryPath + "-%%%%%%%%.tmp",
+                                       tempPath) ||
+      fs::create_directory(tempPath, /*IgnoreExisting=*/false))
+    return;
+
+  auto writeEntryFile = [&](const Twine &name, StringRef contents) -> bool {
+    SmallString<128> filePath(tempPath);
+    path::append(filePath, name);
+    std::error_code EC;
+    llvm::raw_fd_ostream out(filePath, EC, fs::F_None);
+    if (EC)
+      return true;
+    out << contents;
+    out.close();
+    if (out.has_error()) {
+      out.clear_error();
+      return true;
+    }
+    return false;
+  };
+
+  bool failed = false;
+  for (unsigned i = 0, e = Outputs.size(); i != e && !failed; ++i) {
+    auto contents = readFile(Outputs[i]);
+    failed = !contents || writeEntryFile(Twine(i), contents->getBuffer());
+  }
+  failed = failed || writeEntryFile("diagnostics", diagnostics) ||
+           writeEntryFile("manifest", manifest);
+
+  // An existing entry is out of date, or we wouldn't have compiled.
+  if (!failed) {
+    fs::remove_directories(entryPath);
+    failed = bool(fs::rename(tempPath, entryPath));
+  }
+  if (failed)
+    fs::remove_directories(tempPath);
+}
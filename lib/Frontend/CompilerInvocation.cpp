@@ -15,15 +15,18 @@
 #include "swift/Strings.h"
 #include "swift/AST/DiagnosticsFrontend.h"
 #include "swift/Basic/Platform.h"
+#include "swift/Basic/Version.h"
 #include "swift/Option/Options.h"
 #include "swift/Option/SanitizerOptions.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/Triple.h"
 #include "llvm/Option/Arg.h"
 #include "llvm/Option/ArgList.h"
 #include "llvm/Option/Option.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/LineIterator.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/Path.h"
 
 using namespace swift;
@@ -96,14 +99,17 @@ static void debugFailWithCrash() {
 
 /// Try to read a file list file.
 ///
+/// If \p primaryFileArgs is non-empty, the index of each primary file in the
+/// list is appended to \p primaryFileIndices, in the order of the arguments.
+///
 /// Returns false on error.
 static bool readFileList(DiagnosticEngine &diags,
                          std::vector<std::string> &inputFiles,
                          const llvm::opt::Arg *filelistPath,
-                         const llvm::opt::Arg *primaryFileArg = nullptr,
-                         unsigned *primaryFileIndex = nullptr) {
-  assert((primaryFileArg == nullptr) || (primaryFileIndex != nullptr) &&
-         "did not provide argument for primary file index");
+                         ArrayRef<const llvm::opt::Arg *> primaryFileArgs = {},
+                         std::vector<unsigned> *primaryFileIndices = nullptr) {
+  assert((primaryFileArgs.empty() || primaryFileIndices != nullptr) &&
+         "did not provide argument for primary file indices");
 
   llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> buffer =
       llvm::MemoryBuffer::getFile(filelistPath->getValue());
@@ -113,24 +119,21 @@ static bool readFileList(DiagnosticEngine &diags,
     return false;
   }
 
-  bool foundPrimaryFile = false;
-  if (primaryFileIndex) *primaryFileIndex = 0;
-
+  llvm::StringMap<unsigned> lineIndices;
   for (StringRef line : make_range(llvm::line_iterator(*buffer.get()), {})) {
+    if (!primaryFileArgs.empty())
+      lineIndices.insert({line, inputFiles.size()});
     inputFiles.push_back(line);
-
-    if (foundPrimaryFile || primaryFileArg == nullptr)
-      continue;
-    if (line == primaryFileArg->getValue())
-      foundPrimaryFile = true;
-    else
-      ++*primaryFileIndex;
   }
 
-  if (primaryFileArg && !foundPrimaryFile) {
-    diags.diagnose(SourceLoc(), diag::error_primary_file_not_found,
-                   primaryFileArg->getValue(), filelistPath->getValue());
-    return false;
+  for (const llvm::opt::Arg *primaryFileArg : primaryFileArgs) {
+    auto found = lineIndices.find(primaryFileArg->getValue());
+    if (found == lineIndices.end()) {
+      diags.diagnose(SourceLoc(), diag::error_primary_file_not_found,
+                     primaryFileArg->getValue(), filelistPath->getValue());
+      return false;
+    }
+    primaryFileIndices->push_back(found->second);
   }
 
   return true;
@@ -165,10 +168,16 @@ static bool ParseFrontendArgs(FrontendOptions &Opts, ArgList &Args,
     Opts.GroupInfoPath = A->getValue();
   }
 
+  if (const Arg *A = Args.getLastArg(OPT_index_store_path)) {
+    Opts.IndexStorePath = A->getValue();
+  }
+
   Opts.EmitVerboseSIL |= Args.hasArg(OPT_emit_verbose_sil);
   Opts.EmitSortedSIL |= Args.hasArg(OPT_emit_sorted_sil);
 
   Opts.DelayedFunctionBodyParsing |= Args.hasArg(OPT_delayed_function_body_parsing);
+  Opts.SkipNonPrimaryFunctionBodies |=
+    Args.hasArg(OPT_skip_non_primary_function_bodies);
   Opts.EnableTesting |= Args.hasArg(OPT_enable_testing);
   Opts.EnableResilience |= Args.hasArg(OPT_enable_resilience);
 
@@ -176,6 +185,12 @@ static bool ParseFrontendArgs(FrontendOptions &Opts, ArgList &Args,
   Opts.PrintClangStats |= Args.hasArg(OPT_print_clang_stats);
   Opts.DebugTimeFunctionBodies |= Args.hasArg(OPT_debug_time_function_bodies);
   Opts.DebugTimeCompilation |= Args.hasArg(OPT_debug_time_compilation);
+  if (const Arg *A = Args.getLastArg(OPT_trace_compile_events))
+    Opts.TraceCompileEventsPath = A->getValue();
+  if (const Arg *A = Args.getLastArg(OPT_stats_output_dir))
+    Opts.StatsOutputDir = A->getValue();
+  if (const Arg *A = Args.getLastArg(OPT_compilation_cache_path))
+    Opts.CompilationCachePath = A->getValue();
 
   if (const Arg *A = Args.getLastArg(OPT_warn_long_function_bodies)) {
     unsigned attempt;
@@ -203,13 +218,12 @@ static bool ParseFrontendArgs(FrontendOptions &Opts, ArgList &Args,
     }
   }
 
+  std::vector<unsigned> primaryFileIndices;
   if (const Arg *A = Args.getLastArg(OPT_filelist)) {
-    const Arg *primaryFileArg = Args.getLastArg(OPT_primary_file);
-    unsigned primaryFileIndex = 0;
+    SmallVector<const Arg *, 4> primaryFileArgs(
+        Args.filtered_begin(OPT_primary_file), Args.filtered_end());
     if (readFileList(Diags, Opts.InputFilenames, A,
-                     primaryFileArg, &primaryFileIndex)) {
-      if (primaryFileArg)
-        Opts.PrimaryInput = SelectedInput(primaryFileIndex);
+                     primaryFileArgs, &primaryFileIndices)) {
       assert(!Args.hasArg(OPT_INPUT) && "mixing -filelist with inputs");
     }
   } else {
@@ -219,7 +233,7 @@ static bool ParseFrontendArgs(FrontendOptions &Opts, ArgList &Args,
       if (A->getOption().matches(OPT_INPUT)) {
         Opts.InputFilenames.push_back(A->getValue());
       } else if (A->getOption().matches(OPT_primary_file)) {
-        Opts.PrimaryInput = SelectedInput(Opts.InputFilenames.size());
+        primaryFileIndices.push_back(Opts.InputFilenames.size());
         Opts.InputFilenames.push_back(A->getValue());
       } else {
         llvm_unreachable("Unknown input-related argument!");
@@ -227,6 +241,15 @@ static bool ParseFrontendArgs(FrontendOptions &Opts, ArgList &Args,
     }
   }
 
+  // The first primary file is the primary input; any others put the frontend
+  // into batch mode.
+  for (unsigned index : primaryFileIndices) {
+    if (!Opts.PrimaryInput.hasValue())
+      Opts.PrimaryInput = SelectedInput(index);
+    else
+      Opts.BatchPrimaryInputs.push_back(SelectedInput(index));
+  }
+
   Opts.ParseStdlib |= Args.hasArg(OPT_parse_stdlib);
 
   // Determine what the user has asked the frontend to do.
@@ -740,6 +763,50 @@ static bool ParseFrontendArgs(FrontendOptions &Opts, ArgList &Args,
     }
   }
 
+  if (Opts.isInBatchMode()) {
+    // In batch mode each primary file only gets its own main output; anything
+    // that would be written once per invocation is rejected.
+    switch (Opts.RequestedAction) {
+    case FrontendOptions::Typecheck:
+    case FrontendOptions::EmitSILGen:
+    case FrontendOptions::EmitSIL:
+    case FrontendOptions::EmitIR:
+    case FrontendOptions::EmitBC:
+    case FrontendOptions::EmitAssembly:
+    case FrontendOptions::EmitObject:
+      break;
+    default:
+      Diags.diagnose(SourceLoc(), diag::error_batch_mode_unsupported_action);
+      return true;
+    }
+
+    std::pair<StringRef, StringRef> supplementaryOutputs[] = {
+      {Opts.ModuleOutputPath, "-emit-module-path"},
+      {Opts.ModuleDocOutputPath, "-emit-module-doc-path"},
+      {Opts.ObjCHeaderOutputPath, "-emit-objc-header-path"},
+      {Opts.SerializedDiagnosticsPath, "-serialize-diagnostics-path"},
+      {Opts.DependenciesFilePath, "-emit-dependencies-path"},
+      {Opts.ReferenceDependenciesFilePath,
+       "-emit-reference-dependencies-path"},
+      {Opts.FixitsOutputPath, "-emit-fixits-path"},
+    };
+    for (auto &output : supplementaryOutputs) {
+      if (output.first.empty())
+        continue;
+      Diags.diagnose(SourceLoc(), diag::error_batch_mode_unsupported_output,
+                     output.second);
+      return true;
+    }
+
+    unsigned numPrimaries = Opts.BatchPrimaryInputs.size() + 1;
+    if (Opts.actionHasOutput() &&
+        Opts.OutputFilenames.size() != numPrimaries) {
+      Diags.diagnose(SourceLoc(), diag::error_batch_mode_output_count,
+                     Opts.OutputFilenames.size(), numPrimaries);
+      return true;
+    }
+  }
+
   if (const Arg *A = Args.getLastArg(OPT_module_link_name)) {
     Opts.ModuleLinkName = A->getValue();
   }
@@ -838,6 +905,8 @@ static bool ParseLangArgs(LangOptions &Opts, ArgList &Args,
   }
   
   Opts.EnableASTScopeLookup |= Args.hasArg(OPT_enable_astscope_lookup);
+  Opts.NamedLazyMemberLoading |=
+      Args.hasArg(OPT_enable_named_lazy_member_loading);
   Opts.DebugConstraintSolver |= Args.hasArg(OPT_debug_constraints);
   Opts.IterativeTypeChecker |= Args.hasArg(OPT_iterative_type_checker);
   Opts.DebugGenericSignatures |= Args.hasArg(OPT_debug_generic_signatures);
@@ -1060,6 +1129,20 @@ static void PrintArg(raw_ostream &OS, const char *Arg, bool Quote) {
   OS << '"';
 }
 
+/// Returns the pattern of an -Rpass= or -Rpass-missed= argument, or null
+/// (after diagnosing it) if it is not a valid regular expression.
+static std::shared_ptr<llvm::Regex>
+createOptRemarkPattern(ArgList &Args, const Arg *A, DiagnosticEngine &Diags) {
+  auto Pattern = std::make_shared<llvm::Regex>(A->getValue());
+  std::string Error;
+  if (!Pattern->isValid(Error)) {
+    Diags.diagnose(SourceLoc(), diag::error_optimization_remark_pattern,
+                   Error, A->getAsString(Args));
+    return nullptr;
+  }
+  return Pattern;
+}
+
 static bool ParseSILArgs(SILOptions &Opts, ArgList &Args,
                          IRGenOptions &IRGenOpts,
                          FrontendOptions &FEOpts,
@@ -1096,6 +1179,10 @@ static bool ParseSILArgs(SILOptions &Opts, ArgList &Args,
     if (A->getOption().matches(OPT_Onone)) {
       IRGenOpts.Optimize = false;
       Opts.Optimization = SILOptions::SILOptMode::None;
+    } else if (A->getOption().matches(OPT_Odebug)) {
+      // Don't optimize in LLVM, but specialize generic code in SIL.
+      IRGenOpts.Optimize = false;
+      Opts.Optimization = SILOptions::SILOptMode::Debug;
     } else if (A->getOption().matches(OPT_Ounchecked)) {
       // Turn on optimizations and remove all runtime checks.
       IRGenOpts.Optimize = true;
@@ -1103,6 +1190,11 @@ static bool ParseSILArgs(SILOptions &Opts, ArgList &Args,
       // Removal of cond_fail (overflow on binary operations).
       Opts.RemoveRuntimeAsserts = true;
       Opts.AssertConfig = SILOptions::Unchecked;
+    } else if (A->getOption().matches(OPT_Osize)) {
+      // Optimize, but favor passes and heuristics which reduce code size.
+      IRGenOpts.Optimize = true;
+      Opts.Optimization = SILOptions::SILOptMode::Optimize;
+      Opts.OptimizeForSize = true;
     } else if (A->getOption().matches(OPT_Oplayground)) {
       // For now -Oplayground is equivalent to -Onone.
       IRGenOpts.Optimize = false;
@@ -1152,6 +1244,7 @@ static bool ParseSILArgs(SILOptions &Opts, ArgList &Args,
   Opts.DisableSILPerfOptimizations |= Args.hasArg(OPT_disable_sil_perf_optzns);
   Opts.VerifyAll |= Args.hasArg(OPT_sil_verify_all);
   Opts.DebugSerialization |= Args.hasArg(OPT_sil_debug_serialization);
+  Opts.CrossModuleOptimization |= Args.hasArg(OPT_cross_module_optimization);
   Opts.EmitVerboseSIL |= Args.hasArg(OPT_emit_verbose_sil);
   Opts.PrintInstCounts |= Args.hasArg(OPT_print_inst_counts);
   if (const Arg *A = Args.getLastArg(OPT_external_pass_pipeline_filename))
@@ -1159,6 +1252,8 @@ static bool ParseSILArgs(SILOptions &Opts, ArgList &Args,
 
   Opts.GenerateProfile |= Args.hasArg(OPT_profile_generate);
   Opts.EmitProfileCoverageMapping |= Args.hasArg(OPT_profile_coverage_mapping);
+  if (const Arg *A = Args.getLastArg(OPT_profile_use_EQ))
+    Opts.UseProfile = A->getValue();
   Opts.EnableGuaranteedClosureContexts |=
     Args.hasArg(OPT_enable_guaranteed_closure_contexts);
   Opts.DisableSILPartialApply |=
@@ -1167,6 +1262,30 @@ static bool ParseSILArgs(SILOptions &Opts, ArgList &Args,
   Opts.AssumeUnqualifiedOwnershipWhenParsing
     |= Args.hasArg(OPT_assume_parsing_unqualified_ownership_sil);
 
+  if (const Arg *A = Args.getLastArg(OPT_Rpass_EQ)) {
+    Opts.OptRemarkPassedPattern = createOptRemarkPattern(Args, A, Diags);
+    if (!Opts.OptRemarkPassedPattern)
+      return true;
+  }
+  if (const Arg *A = Args.getLastArg(OPT_Rpass_missed_EQ)) {
+    Opts.OptRemarkMissedPattern = createOptRemarkPattern(Args, A, Diags);
+    if (!Opts.OptRemarkMissedPattern)
+      return true;
+  }
+
+  if (const Arg *A = Args.getLastArg(OPT_save_optimization_record_path)) {
+    Opts.OptRecordFile = A->getValue();
+  } else if (Args.hasArg(OPT_save_optimization_record)) {
+    // Put the record next to the regular output file, or name it after the
+    // module if there is none.
+    StringRef BaseName = FEOpts.getSingleOutputFilename();
+    if (BaseName.empty() || BaseName == "-")
+      BaseName = FEOpts.ModuleName;
+    llvm::SmallString<128> Path(BaseName);
+    llvm::sys::path::replace_extension(Path, "opt.yaml");
+    Opts.OptRecordFile = Path.str();
+  }
+
   if (Args.hasArg(OPT_debug_on_sil)) {
     // Derive the name of the SIL file for debugging from
     // the regular outputfile.
@@ -1210,6 +1329,74 @@ void CompilerInvocation::buildDWARFDebugFlags(std::string &Output,
   }
 }
 
+Optional<std::string>
+CompilerInvocation::computeCompilationCacheKey(ArrayRef<const char *> Args,
+                                               StringRef workingDirectory,
+                                               StringRef mainExecutablePath)
+                                               const {
+  llvm::MD5 hash;
+  auto addString = [&](StringRef str) {
+    hash.update(str);
+    // Separate the strings, so that different lists can't hash the same.
+    hash.update(StringRef("", 1));
+  };
+  auto addFile = [&](StringRef path) -> bool {
+    auto buffer = llvm::MemoryBuffer::getFile(path);
+    if (!buffer)
+      return false;
+    addString(path);
+    addString(buffer.get()->getBuffer());
+    return true;
+  };
+
+  // A rebuilt compiler may produce different outputs from the same version.
+  addString(version::getSwiftFullVersion());
+  llvm::sys::fs::file_status status;
+  if (llvm::sys::fs::status(mainExecutablePath, status))
+    return None;
+  addString(std::to_string(status.getSize()));
+  addString(std::to_string(status.getLastModificationTime().seconds()));
+
+  addString(workingDirectory);
+  for (unsigned i = 0, e = Args.size(); i != e; ++i) {
+    StringRef arg = Args[i];
+    // The cache's location doesn't affect the outputs.
+    if (arg == "-compilation-cache-path") {
+      ++i;
+      continue;
+    }
+    addString(arg);
+    // Temporary file lists get a new name for each build.
+    if (arg == "-filelist" && i + 1 != e && !addFile(Args[++i]))
+      return None;
+  }
+
+  for (auto &input : FrontendOpts.InputFilenames) {
+    if (!addFile(input))
+      return None;
+  }
+  if (!FrontendOpts.ImplicitObjCHeaderPath.empty() &&
+      !addFile(FrontendOpts.ImplicitObjCHeaderPath))
+    return None;
+
+  // Files which options point at directly are read without the dependency
+  // tracker seeing them, and may change without their paths changing.
+  StringRef referencedFiles[] = {
+    SILOpts.UseProfile,
+    SILOpts.ExternalPassPipelineFilename,
+  };
+  for (StringRef file : referencedFiles) {
+    if (!file.empty() && !addFile(file))
+      return None;
+  }
+
+  llvm::MD5::MD5Result result;
+  hash.final(result);
+  SmallString<32> key;
+  llvm::MD5::stringifyResult(result, key);
+  return key.str().str();
+}
+
 static bool ParseIRGenArgs(IRGenOptions &Opts, ArgList &Args,
                            DiagnosticEngine &Diags,
                            const FrontendOptions &FrontendOpts,
@@ -1284,6 +1471,32 @@ static bool ParseIRGenArgs(IRGenOptions &Opts, ArgList &Args,
     Opts.StackPromotionSizeLimit = limit;
   }
 
+  if (const Arg *A = Args.getLastArg(OPT_outline_copy_threshold)) {
+    unsigned threshold;
+    if (StringRef(A->getValue()).getAsInteger(10, threshold)) {
+      Diags.diagnose(SourceLoc(), diag::error_invalid_arg_value,
+                     A->getAsString(Args), A->getValue());
+      return true;
+    }
+    Opts.OutlineCopySizeThreshold = threshold;
+  }
+
+  if (const Arg *A = Args.getLastArg(OPT_type_data_hoisting_cost_limit)) {
+    unsigned limit;
+    if (StringRef(A->getValue()).getAsInteger(10, limit)) {
+      Diags.diagnose(SourceLoc(), diag::error_invalid_arg_value,
+                     A->getAsString(Args), A->getValue());
+      return true;
+    }
+    Opts.TypeDataHoistingCostLimit = limit;
+  }
+
+  for (const Arg *A : make_range(Args.filtered_begin(
+                                     OPT_codegen_partition_output),
+                                 Args.filtered_end())) {
+    Opts.CodeGenPartitionOutputs.push_back(A->getValue());
+  }
+
   if (Args.hasArg(OPT_autolink_force_load))
     Opts.ForceLoadSymbolName = Args.getLastArgValue(OPT_module_link_name);
 
@@ -1315,6 +1528,7 @@ static bool ParseIRGenArgs(IRGenOptions &Opts, ArgList &Args,
   }
 
   Opts.GenerateProfile |= Args.hasArg(OPT_profile_generate);
+  Opts.ProfileFirstHit |= Args.hasArg(OPT_profile_first_hit);
   Opts.PrintInlineTree |= Args.hasArg(OPT_print_llvm_inline_tree);
 
   Opts.UseSwiftCall = Args.hasArg(OPT_enable_swiftcall);
@@ -1370,6 +1584,14 @@ static bool ParseIRGenArgs(IRGenOptions &Opts, ArgList &Args,
     Opts.EnableReflectionNames = false;
   }
 
+  if (Args.hasArg(OPT_enable_struct_field_reordering)) {
+    Opts.EnableStructFieldReordering = true;
+  }
+
+  if (Args.hasArg(OPT_warm_generic_metadata)) {
+    Opts.WarmGenericMetadata = true;
+  }
+
   for (const auto &Lib : Args.getAllArgValues(options::OPT_autolink_library))
     Opts.LinkLibraries.push_back(LinkLibrary(Lib, LibraryKind::Library));
 
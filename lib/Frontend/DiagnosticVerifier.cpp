@@ -67,6 +67,7 @@ static std::string getDiagKindString(llvm::SourceMgr::DiagKind Kind) {
   case llvm::SourceMgr::DK_Error: return "error";
   case llvm::SourceMgr::DK_Warning: return "warning";
   case llvm::SourceMgr::DK_Note: return "note";
+  case llvm::SourceMgr::DK_Remark: return "remark";
   }
 
   llvm_unreachable("Unhandled DiagKind in switch.");
@@ -227,7 +228,7 @@ bool DiagnosticVerifier::verifyFile(unsigned BufferID,
   };
   
   
-  // Scan the memory buffer looking for expected-note/warning/error.
+  // Scan the memory buffer looking for expected-note/warning/error/remark.
   for (size_t Match = InputFile.find("expected-");
        Match != StringRef::npos; Match = InputFile.find("expected-", Match+1)) {
     // Process this potential match.  If we fail to process it, just move on to
@@ -245,6 +246,9 @@ bool DiagnosticVerifier::verifyFile(unsigned BufferID,
     } else if (MatchStart.startswith("expected-error")) {
       ExpectedClassification = llvm::SourceMgr::DK_Error;
       MatchStart = MatchStart.substr(strlen("expected-error"));
+    } else if (MatchStart.startswith("expected-remark")) {
+      ExpectedClassification = llvm::SourceMgr::DK_Remark;
+      MatchStart = MatchStart.substr(strlen("expected-remark"));
     } else
       continue;
 
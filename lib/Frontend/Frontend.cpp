@@ -45,6 +45,23 @@ void CompilerInstance::createSILModule(bool WholeModule) {
 void CompilerInstance::setPrimarySourceFile(SourceFile *SF) {
   assert(SF);
   assert(MainModule && "main module not created yet");
+
+  // In batch mode, the additional primary files are recorded separately. Only
+  // the first primary file tracks referenced names.
+  if (SF->getBufferID().hasValue() &&
+      SF->getBufferID().getValue() != PrimaryBufferID) {
+    auto found = std::find(BatchPrimaryBufferIDs.begin(),
+                           BatchPrimaryBufferIDs.end(),
+                           SF->getBufferID().getValue());
+    if (found != BatchPrimaryBufferIDs.end()) {
+      auto &Slot =
+        BatchPrimarySourceFiles[found - BatchPrimaryBufferIDs.begin()];
+      assert(!Slot && "already has this primary source file");
+      Slot = SF;
+      return;
+    }
+  }
+
   assert(!PrimarySourceFile && "already has a primary source file");
   assert(PrimaryBufferID == NO_SUCH_BUFFER || !SF->getBufferID().hasValue() ||
          SF->getBufferID().getValue() == PrimaryBufferID);
@@ -52,6 +69,15 @@ void CompilerInstance::setPrimarySourceFile(SourceFile *SF) {
   PrimarySourceFile->setReferencedNameTracker(NameTracker);
 }
 
+bool CompilerInstance::isPrimaryBuffer(unsigned BufferID) const {
+  if (BufferID == NO_SUCH_BUFFER)
+    return false;
+  if (BufferID == PrimaryBufferID)
+    return true;
+  return std::find(BatchPrimaryBufferIDs.begin(), BatchPrimaryBufferIDs.end(),
+                   BufferID) != BatchPrimaryBufferIDs.end();
+}
+
 bool CompilerInstance::setup(const CompilerInvocation &Invok) {
   Invocation = Invok;
 
@@ -132,6 +158,22 @@ bool CompilerInstance::setup(const CompilerInvocation &Invok) {
 
   const Optional<SelectedInput> &PrimaryInput =
     Invocation.getFrontendOptions().PrimaryInput;
+  ArrayRef<SelectedInput> BatchPrimaryInputs =
+    Invocation.getFrontendOptions().BatchPrimaryInputs;
+  BatchPrimaryBufferIDs.assign(BatchPrimaryInputs.size(), NO_SUCH_BUFFER);
+  BatchPrimarySourceFiles.assign(BatchPrimaryInputs.size(), nullptr);
+
+  // Records \p BufferID if the input at \p Index is one of the primary inputs.
+  auto recordPrimaryInput = [&](SelectedInput::InputKind Kind, unsigned Index,
+                                unsigned BufferID) {
+    if (PrimaryInput && PrimaryInput->Kind == Kind &&
+        PrimaryInput->Index == Index)
+      PrimaryBufferID = BufferID;
+    for (unsigned i = 0, e = BatchPrimaryInputs.size(); i != e; ++i)
+      if (BatchPrimaryInputs[i].Kind == Kind &&
+          BatchPrimaryInputs[i].Index == Index)
+        BatchPrimaryBufferIDs[i] = BufferID;
+  };
 
   // Add the memory buffers first, these will be associated with a filename
   // and they can replace the contents of an input filename.
@@ -150,8 +192,7 @@ bool CompilerInstance::setup(const CompilerInvocation &Invok) {
       if (SILMode)
         MainBufferID = BufferID;
 
-      if (PrimaryInput && PrimaryInput->isBuffer() && PrimaryInput->Index == i)
-        PrimaryBufferID = BufferID;
+      recordPrimaryInput(SelectedInput::InputKind::Buffer, i, BufferID);
     }
   }
 
@@ -166,9 +207,8 @@ bool CompilerInstance::setup(const CompilerInvocation &Invok) {
       if (SILMode || (MainMode && filename(File) == "main.swift"))
         MainBufferID = ExistingBufferID.getValue();
 
-      if (PrimaryInput && PrimaryInput->isFilename() &&
-          PrimaryInput->Index == i)
-        PrimaryBufferID = ExistingBufferID.getValue();
+      recordPrimaryInput(SelectedInput::InputKind::Filename, i,
+                         ExistingBufferID.getValue());
 
       continue; // replaced by a memory buffer.
     }
@@ -209,8 +249,7 @@ bool CompilerInstance::setup(const CompilerInvocation &Invok) {
     if (SILMode || (MainMode && filename(File) == "main.swift"))
       MainBufferID = BufferID;
 
-    if (PrimaryInput && PrimaryInput->isFilename() && PrimaryInput->Index == i)
-      PrimaryBufferID = BufferID;
+    recordPrimaryInput(SelectedInput::InputKind::Filename, i, BufferID);
   }
 
   // Set the primary file to the code-completion point if one exists.
@@ -277,11 +316,12 @@ void CompilerInstance::performSema() {
     }
 
     const auto &silOptions = Invocation.getSILOptions();
-    if ((silOptions.Optimization <= SILOptions::SILOptMode::None &&
+    if ((silOptions.Optimization <= SILOptions::SILOptMode::Debug &&
          (options.RequestedAction == FrontendOptions::EmitObject ||
           options.RequestedAction == FrontendOptions::Immediate ||
           options.RequestedAction == FrontendOptions::EmitSIL)) ||
-        (silOptions.Optimization == SILOptions::SILOptMode::None &&
+        ((silOptions.Optimization == SILOptions::SILOptMode::None ||
+          silOptions.Optimization == SILOptions::SILOptMode::Debug) &&
          options.RequestedAction >= FrontendOptions::EmitSILGen)) {
       // Implicitly import the SwiftOnoneSupport module in non-optimized
       // builds. This allows for use of popular specialized functions
@@ -382,9 +422,21 @@ void CompilerInstance::performSema() {
   } else if (Invocation.isDelayedFunctionBodyParsing()) {
     DelayedCB.reset(new AlwaysDelayedCallbacks);
   }
+  DelayedParsingCallbacks *ParseCB =
+      DelayedCB ? DelayedCB.get() : DelayedParseCB;
 
   PersistentParserState PersistentState;
 
+  // Function bodies in non-primary files are never type-checked, so unless
+  // the client asked for specific callbacks they can be skipped by brace
+  // matching without building their AST.
+  NeverDelayedCallbacks SkipBodiesCB;
+  auto getParseCallbacks = [&](bool IsPrimary) -> DelayedParsingCallbacks * {
+    if (IsPrimary || ParseCB || !options.SkipNonPrimaryFunctionBodies)
+      return ParseCB;
+    return &SkipBodiesCB;
+  };
+
   // Make sure the main file is the first file in the module. This may only be
   // a source file, or it may be a SIL file, which requires pumping the parser.
   // We parse it last, though, to make sure that it can use decls from other
@@ -401,7 +453,7 @@ void CompilerInstance::performSema() {
     MainModule->addFile(*MainFile);
     addAdditionalInitialImports(MainFile);
 
-    if (MainBufferID == PrimaryBufferID)
+    if (isPrimaryBuffer(MainBufferID))
       setPrimarySourceFile(MainFile);
   }
 
@@ -427,13 +479,13 @@ void CompilerInstance::performSema() {
     MainModule->addFile(*NextInput);
     addAdditionalInitialImports(NextInput);
 
-    if (BufferID == PrimaryBufferID)
+    if (isPrimaryBuffer(BufferID))
       setPrimarySourceFile(NextInput);
 
     auto &Diags = NextInput->getASTContext().Diags;
     auto DidSuppressWarnings = Diags.getSuppressWarnings();
     auto IsPrimary
-      = PrimaryBufferID == NO_SUCH_BUFFER || BufferID == PrimaryBufferID;
+      = PrimaryBufferID == NO_SUCH_BUFFER || isPrimaryBuffer(BufferID);
     Diags.setSuppressWarnings(DidSuppressWarnings || !IsPrimary);
 
     bool Done;
@@ -441,7 +493,7 @@ void CompilerInstance::performSema() {
       // Parser may stop at some erroneous constructions like #else, #endif
       // or '}' in some cases, continue parsing until we are done
       parseIntoSourceFile(*NextInput, BufferID, &Done, nullptr,
-                          &PersistentState, DelayedCB.get());
+                          &PersistentState, getParseCallbacks(IsPrimary));
     } while (!Done);
 
     Diags.setSuppressWarnings(DidSuppressWarnings);
@@ -475,7 +527,7 @@ void CompilerInstance::performSema() {
   // Parse the main file last.
   if (MainBufferID != NO_SUCH_BUFFER) {
     bool mainIsPrimary =
-      (PrimaryBufferID == NO_SUCH_BUFFER || MainBufferID == PrimaryBufferID);
+      (PrimaryBufferID == NO_SUCH_BUFFER || isPrimaryBuffer(MainBufferID));
 
     SourceFile &MainFile =
       MainModule->getMainSourceFile(Invocation.getSourceFileKind());
@@ -485,6 +537,8 @@ void CompilerInstance::performSema() {
     Diags.setSuppressWarnings(DidSuppressWarnings || !mainIsPrimary);
 
     SILParserState SILContext(TheSILModule.get());
+    DelayedParsingCallbacks *MainParseCB =
+        TheSILModule ? ParseCB : getParseCallbacks(mainIsPrimary);
     unsigned CurTUElem = 0;
     bool Done;
     do {
@@ -494,7 +548,7 @@ void CompilerInstance::performSema() {
       // with 'sil' definitions.
       parseIntoSourceFile(MainFile, MainFile.getBufferID().getValue(), &Done,
                           TheSILModule ? &SILContext : nullptr,
-                          &PersistentState, DelayedCB.get());
+                          &PersistentState, MainParseCB);
       if (mainIsPrimary) {
         performTypeChecking(MainFile, PersistentState.getTopLevelContext(),
                             TypeCheckOptions, CurTUElem,
@@ -512,10 +566,16 @@ void CompilerInstance::performSema() {
       performNameBinding(MainFile);
   }
 
+  // Bodies delayed by the client's callbacks must be available before the
+  // library files are type-checked.
+  if (!DelayedCB && DelayedParseCB)
+    performDelayedParsing(MainModule, PersistentState, nullptr);
+
   // Type-check each top-level input besides the main source file.
   for (auto File : MainModule->getFiles())
     if (auto SF = dyn_cast<SourceFile>(File))
-      if (PrimaryBufferID == NO_SUCH_BUFFER || SF == PrimarySourceFile)
+      if (PrimaryBufferID == NO_SUCH_BUFFER ||
+          isPrimaryBuffer(SF->getBufferID().getValueOr(NO_SUCH_BUFFER)))
         performTypeChecking(*SF, PersistentState.getTopLevelContext(),
                             TypeCheckOptions, /*curElem*/0,
                             options.WarnLongFunctionBodies);
@@ -539,7 +599,8 @@ void CompilerInstance::performSema() {
 
   for (auto File : MainModule->getFiles())
     if (auto SF = dyn_cast<SourceFile>(File))
-      if (PrimaryBufferID == NO_SUCH_BUFFER || SF == PrimarySourceFile)
+      if (PrimaryBufferID == NO_SUCH_BUFFER ||
+          isPrimaryBuffer(SF->getBufferID().getValueOr(NO_SUCH_BUFFER)))
         finishTypeChecking(*SF);
 }
 
@@ -83,6 +83,10 @@ PrintingDiagnosticConsumer::handleDiagnostic(SourceManager &SM, SourceLoc Loc,
     case DiagnosticKind::Note: 
       SMKind = llvm::SourceMgr::DK_Note; 
       break;
+
+    case DiagnosticKind::Remark:
+      SMKind = llvm::SourceMgr::DK_Remark;
+      break;
   }
 
   if (Kind == DiagnosticKind::Error) {
@@ -155,6 +155,9 @@ public:
   /// \brief The version of the diagnostics file.
   enum { Version = 1 };
 
+  /// \brief How many bytes to buffer before writing them to the output.
+  enum { BufferFlushThreshold = 64 * 1024 };
+
 private:
   /// \brief Emit bitcode for the preamble.
   void emitPreamble();
@@ -165,6 +168,19 @@ private:
   /// \brief Emit bitcode for metadata block (part of preamble).
   void emitMetaBlock();
 
+  /// \brief Write what has been serialized so far to the output once it
+  /// gets large, so that jobs with many diagnostics don't keep all of them
+  /// in memory.
+  ///
+  /// Must only be called when no block is open; blocks are backpatched
+  /// with their size when they are exited.
+  void flushBufferIfFull() {
+    if (State->Buffer.size() < BufferFlushThreshold)
+      return;
+    State->OS->write(State->Buffer.data(), State->Buffer.size());
+    State->Buffer.clear();
+  }
+
   /// \brief Emit bitcode to enter a block for a diagnostic.
   void enterDiagBlock() {
     State->Stream.EnterSubblock(BLOCK_DIAG, 4);
@@ -265,6 +281,8 @@ static clang::serialized_diags::Level getDiagnosticLevel(DiagnosticKind Kind) {
     return clang::serialized_diags::Note;
   case DiagnosticKind::Warning:
     return clang::serialized_diags::Warning;
+  case DiagnosticKind::Remark:
+    return clang::serialized_diags::Remark;
   }
 
   llvm_unreachable("Unhandled DiagnosticKind in switch.");
@@ -503,6 +521,9 @@ SerializedDiagnosticConsumer::handleDiagnostic(SourceManager &SM,
     if (State->EmittedAnyDiagBlocks)
       exitDiagBlock();
 
+    // No block is open now, so everything before this point is final.
+    flushBufferIfFull();
+
     enterDiagBlock();
     State->EmittedAnyDiagBlocks = true;
   }
@@ -25,11 +25,15 @@
 
 #include "swift/Subsystems.h"
 #include "swift/AST/ASTScope.h"
+#include "swift/AST/ASTWalker.h"
 #include "swift/AST/DiagnosticsFrontend.h"
 #include "swift/AST/DiagnosticsSema.h"
+#include "swift/AST/Expr.h"
 #include "swift/AST/IRGenOptions.h"
 #include "swift/AST/ASTMangler.h"
+#include "swift/AST/Pattern.h"
 #include "swift/AST/ReferencedNameTracker.h"
+#include "swift/AST/Stmt.h"
 #include "swift/AST/TypeRefinementContext.h"
 #include "swift/Basic/Dwarf.h"
 #include "swift/Basic/Edit.h"
@@ -37,15 +41,20 @@
 #include "swift/Basic/FileSystem.h"
 #include "swift/Basic/LLVMContext.h"
 #include "swift/Basic/SourceManager.h"
+#include "swift/Basic/SpawnServer.h"
+#include "swift/Basic/Statistic.h"
 #include "swift/Basic/Timer.h"
+#include "swift/Frontend/CompilationCache.h"
 #include "swift/Frontend/DiagnosticVerifier.h"
 #include "swift/Frontend/Frontend.h"
 #include "swift/Frontend/PrintingDiagnosticConsumer.h"
 #include "swift/Frontend/SerializedDiagnosticConsumer.h"
 #include "swift/Immediate/Immediate.h"
+#include "swift/Index/IndexRecord.h"
 #include "swift/Option/Options.h"
 #include "swift/PrintAsObjC/PrintAsObjC.h"
 #include "swift/Serialization/SerializationOptions.h"
+#include "swift/SIL/SILModule.h"
 #include "swift/SILOptimizer/PassManager/Passes.h"
 
 // FIXME: We're just using CompilerInstance::createOutputFile.
@@ -58,10 +67,13 @@
 #include "llvm/IRReader/IRReader.h"
 #include "llvm/Option/Option.h"
 #include "llvm/Option/OptTable.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/Timer.h"
+#include "llvm/Support/YAMLTraits.h"
 
 #include <memory>
 #include <unordered_set>
@@ -228,6 +240,8 @@ private:
     }
   }
 
+  bool needsDiagnosticText() const override { return false; }
+
   bool shouldFix(DiagnosticKind Kind, const DiagnosticInfo &Info) {
     if (FixitAll)
       return true;
@@ -322,194 +336,38 @@ static void debugFailWithCrash() {
   LLVM_BUILTIN_TRAP;
 }
 
-/// Performs the compile requested by the user.
+/// Performs everything after semantic analysis for a single primary file, or
+/// for the whole module if \p PrimarySourceFile is null: SILGen, the SIL
+/// pipeline, serialization and IRGen.
 /// \returns true on error
-static bool performCompile(CompilerInstance &Instance,
-                           CompilerInvocation &Invocation,
-                           ArrayRef<const char *> Args,
-                           int &ReturnValue,
-                           FrontendObserver *observer) {
-  FrontendOptions opts = Invocation.getFrontendOptions();
-  FrontendOptions::ActionType Action = opts.RequestedAction;
-
-  IRGenOptions &IRGenOpts = Invocation.getIRGenOptions();
-
-  bool inputIsLLVMIr = Invocation.getInputKind() == InputFileKind::IFK_LLVM_IR;
-  if (inputIsLLVMIr) {
-    auto &LLVMContext = getGlobalLLVMContext();
-
-    // Load in bitcode file.
-    assert(Invocation.getInputFilenames().size() == 1 &&
-           "We expect a single input for bitcode input!");
-    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> FileBufOrErr =
-      llvm::MemoryBuffer::getFileOrSTDIN(Invocation.getInputFilenames()[0]);
-    if (!FileBufOrErr) {
-      Instance.getASTContext().Diags.diagnose(SourceLoc(),
-                                              diag::error_open_input_file,
-                                              Invocation.getInputFilenames()[0],
-                                              FileBufOrErr.getError().message());
-      return true;
-    }
-    llvm::MemoryBuffer *MainFile = FileBufOrErr.get().get();
-
-    llvm::SMDiagnostic Err;
-    std::unique_ptr<llvm::Module> Module = llvm::parseIR(
-                                             MainFile->getMemBufferRef(),
-                                             Err, LLVMContext);
-    if (!Module) {
-      // TODO: Translate from the diagnostic info to the SourceManager location
-      // if available.
-      Instance.getASTContext().Diags.diagnose(SourceLoc(),
-                                              diag::error_parse_input_file,
-                                              Invocation.getInputFilenames()[0],
-                                              Err.getMessage());
-      return true;
-    }
-
-    // TODO: remove once the frontend understands what action it should perform
-    IRGenOpts.OutputKind = getOutputKind(Action);
-
-    return performLLVM(IRGenOpts, Instance.getASTContext(), Module.get());
-  }
-
-  ReferencedNameTracker nameTracker;
-  bool shouldTrackReferences = !opts.ReferenceDependenciesFilePath.empty();
-  if (shouldTrackReferences)
-    Instance.setReferencedNameTracker(&nameTracker);
-
-  if (Action == FrontendOptions::Parse ||
-      Action == FrontendOptions::DumpParse ||
-      Action == FrontendOptions::DumpInterfaceHash)
-    Instance.performParseOnly();
-  else
-    Instance.performSema();
-
-  if (Action == FrontendOptions::Parse)
-    return false;
-
-  if (observer) {
-    observer->performedSemanticAnalysis(Instance);
+/// Counts the functions and instructions in \p SM.
+static void countSILModule(const SILModule &SM, size_t &NumFunctions,
+                           size_t &NumInstructions) {
+  NumFunctions = 0;
+  NumInstructions = 0;
+  for (const SILFunction &F : SM) {
+    ++NumFunctions;
+    for (const SILBasicBlock &BB : F)
+      NumInstructions += BB.size();
   }
+}
 
-  FrontendOptions::DebugCrashMode CrashMode = opts.CrashMode;
-  if (CrashMode == FrontendOptions::DebugCrashMode::AssertAfterParse)
-    debugFailWithAssertion();
-  else if (CrashMode == FrontendOptions::DebugCrashMode::CrashAfterParse)
-    debugFailWithCrash();
-
+static bool performCompileStepsPostSema(CompilerInstance &Instance,
+                                        CompilerInvocation &Invocation,
+                                        SourceFile *PrimarySourceFile,
+                                        IRGenOptions &IRGenOpts,
+                                        StringRef OutputFilename,
+                                        std::unique_ptr<SILModule> SM,
+                                        bool moduleIsPublic,
+                                        int &ReturnValue,
+                                        FrontendObserver *observer) {
+  const FrontendOptions &opts = Invocation.getFrontendOptions();
+  FrontendOptions::ActionType Action = opts.RequestedAction;
   ASTContext &Context = Instance.getASTContext();
 
-  if (Action == FrontendOptions::REPL) {
-    runREPL(Instance, ProcessCmdLine(Args.begin(), Args.end()),
-            Invocation.getParseStdlib());
-    return false;
-  }
-
-  SourceFile *PrimarySourceFile = Instance.getPrimarySourceFile();
-
-  // We've been told to dump the AST (either after parsing or type-checking,
-  // which is already differentiated in CompilerInstance::performSema()),
-  // so dump or print the main source file and return.
-  if (Action == FrontendOptions::DumpParse ||
-      Action == FrontendOptions::DumpAST ||
-      Action == FrontendOptions::PrintAST ||
-      Action == FrontendOptions::DumpScopeMaps ||
-      Action == FrontendOptions::DumpTypeRefinementContexts ||
-      Action == FrontendOptions::DumpInterfaceHash) {
-    SourceFile *SF = PrimarySourceFile;
-    if (!SF) {
-      SourceFileKind Kind = Invocation.getSourceFileKind();
-      SF = &Instance.getMainModule()->getMainSourceFile(Kind);
-    }
-    if (Action == FrontendOptions::PrintAST)
-      SF->print(llvm::outs(), PrintOptions::printEverything());
-    else if (Action == FrontendOptions::DumpScopeMaps) {
-      ASTScope &scope = SF->getScope();
-
-      if (opts.DumpScopeMapLocations.empty()) {
-        scope.expandAll();
-      } else if (auto bufferID = SF->getBufferID()) {
-        SourceManager &sourceMgr = Instance.getSourceMgr();
-        // Probe each of the locations, and dump what we find.
-        for (auto lineColumn : opts.DumpScopeMapLocations) {
-          SourceLoc loc = sourceMgr.getLocForLineCol(*bufferID,
-                                                     lineColumn.first,
-                                                     lineColumn.second);
-          if (loc.isInvalid()) continue;
-
-          llvm::errs() << "***Scope at " << lineColumn.first << ":"
-            << lineColumn.second << "***\n";
-          auto locScope = scope.findInnermostEnclosingScope(loc);
-          locScope->print(llvm::errs(), 0, false, false);
-
-          // Dump the AST context, too.
-          if (auto dc = locScope->getDeclContext()) {
-            dc->printContext(llvm::errs());
-          }
-
-          // Grab the local bindings introduced by this scope.
-          auto localBindings = locScope->getLocalBindings();
-          if (!localBindings.empty()) {
-            llvm::errs() << "Local bindings: ";
-            interleave(localBindings.begin(), localBindings.end(),
-                       [&](ValueDecl *value) {
-                         llvm::errs() << value->getFullName();
-                       },
-                       [&]() {
-                         llvm::errs() << " ";
-                       });
-            llvm::errs() << "\n";
-          }
-        }
-
-        llvm::errs() << "***Complete scope map***\n";
-      }
-
-      // Print the resulting map.
-      scope.print(llvm::errs());
-    } else if (Action == FrontendOptions::DumpTypeRefinementContexts)
-      SF->getTypeRefinementContext()->dump(llvm::errs(), Context.SourceMgr);
-    else if (Action == FrontendOptions::DumpInterfaceHash)
-      SF->dumpInterfaceHash(llvm::errs());
-    else
-      SF->dump();
-    return false;
-  }
-
-  // If we were asked to print Clang stats, do so.
-  if (opts.PrintClangStats && Context.getClangModuleLoader())
-    Context.getClangModuleLoader()->printStatistics();
-
-  if (!opts.DependenciesFilePath.empty())
-    (void)emitMakeDependencies(Context.Diags, *Instance.getDependencyTracker(),
-                               opts);
-
-  if (shouldTrackReferences)
-    emitReferenceDependencies(Context.Diags, Instance.getPrimarySourceFile(),
-                              *Instance.getDependencyTracker(), opts);
-
-  if (Context.hadError())
-    return true;
-
-  // FIXME: This is still a lousy approximation of whether the module file will
-  // be externally consumed.
-  bool moduleIsPublic =
-      !Instance.getMainModule()->hasEntryPoint() &&
-      opts.ImplicitObjCHeaderPath.empty() &&
-      !Context.LangOpts.EnableAppExtensionRestrictions;
-
-  // We've just been told to perform a typecheck, so we can return now.
-  if (Action == FrontendOptions::Typecheck) {
-    if (!opts.ObjCHeaderOutputPath.empty())
-      return printAsObjC(opts.ObjCHeaderOutputPath, Instance.getMainModule(),
-                         opts.ImplicitObjCHeaderPath, moduleIsPublic);
-    return false;
-  }
-
   assert(Action >= FrontendOptions::EmitSILGen &&
          "All actions not requiring SILGen must have been handled!");
 
-  std::unique_ptr<SILModule> SM = Instance.takeSILModule();
   if (!SM) {
     if (opts.PrimaryInput.hasValue() && opts.PrimaryInput.getValue().isFilename()) {
       FileUnit *PrimaryFile = PrimarySourceFile;
@@ -530,13 +388,19 @@ static bool performCompile(CompilerInstance &Instance,
     observer->performedSILGeneration(*SM);
   }
 
+  if (auto *Stats = Context.Stats) {
+    auto &C = Stats->getFrontendCounters();
+    countSILModule(*SM, C.NumSILGenFunctions, C.NumSILGenInstructions);
+    Stats->noteCurrentMemoryUsage();
+  }
+
   // We've been told to emit SIL after SILGen, so write it now.
   if (Action == FrontendOptions::EmitSILGen) {
     // If we are asked to link all, link all.
     if (Invocation.getSILOptions().LinkMode == SILOptions::LinkAll)
       performSILLinking(SM.get(), true);
     return writeSIL(*SM, Instance.getMainModule(), opts.EmitVerboseSIL,
-                    opts.getSingleOutputFilename(), opts.EmitSortedSIL);
+                    OutputFilename, opts.EmitSortedSIL);
   }
 
   if (Action == FrontendOptions::EmitSIBGen) {
@@ -581,12 +445,29 @@ static bool performCompile(CompilerInstance &Instance,
     SM->verify();
   }
 
+  // Open the optimization record, which the optimization passes write their
+  // remarks to.
+  const std::string &OptRecordFile = Invocation.getSILOptions().OptRecordFile;
+  if (!OptRecordFile.empty()) {
+    std::error_code EC;
+    auto OS = llvm::make_unique<llvm::raw_fd_ostream>(OptRecordFile, EC,
+                                                      llvm::sys::fs::F_None);
+    if (EC) {
+      Context.Diags.diagnose(SourceLoc(), diag::cannot_open_file,
+                             OptRecordFile, EC.message());
+      return true;
+    }
+    auto Stream = llvm::make_unique<llvm::yaml::Output>(*OS,
+                                                        &Context.SourceMgr);
+    SM->setOptRecordStream(std::move(Stream), std::move(OS));
+  }
+
   // Perform SIL optimization passes if optimizations haven't been disabled.
   // These may change across compiler versions.
   {
     SharedTimer timer("SIL optimization");
     if (Invocation.getSILOptions().Optimization >
-        SILOptions::SILOptMode::None) {
+        SILOptions::SILOptMode::Debug) {
       StringRef CustomPipelinePath =
         Invocation.getSILOptions().ExternalPassPipelineFilename;
       if (!CustomPipelinePath.empty()) {
@@ -603,6 +484,12 @@ static bool performCompile(CompilerInstance &Instance,
     observer->performedSILOptimization(*SM);
   }
 
+  if (auto *Stats = Context.Stats) {
+    auto &C = Stats->getFrontendCounters();
+    countSILModule(*SM, C.NumSILOptFunctions, C.NumSILOptInstructions);
+    Stats->noteCurrentMemoryUsage();
+  }
+
   {
     SharedTimer timer("SIL verification (post-optimization)");
     SM->verify();
@@ -676,7 +563,7 @@ static bool performCompile(CompilerInstance &Instance,
   // We've been told to write canonical SIL, so write it now.
   if (Action == FrontendOptions::EmitSIL) {
     return writeSIL(*SM, Instance.getMainModule(), opts.EmitVerboseSIL,
-                    opts.getSingleOutputFilename(), opts.EmitSortedSIL);
+                    OutputFilename, opts.EmitSortedSIL);
   }
 
   assert(Action >= FrontendOptions::Immediate &&
@@ -715,15 +602,378 @@ static bool performCompile(CompilerInstance &Instance,
   auto &LLVMContext = getGlobalLLVMContext();
   if (PrimarySourceFile) {
     performIRGeneration(IRGenOpts, *PrimarySourceFile, std::move(SM),
-                        opts.getSingleOutputFilename(), LLVMContext);
+                        OutputFilename, LLVMContext);
   } else {
     performIRGeneration(IRGenOpts, Instance.getMainModule(), std::move(SM),
-                        opts.getSingleOutputFilename(), LLVMContext);
+                        OutputFilename, LLVMContext);
   }
 
   return false;
 }
 
+/// Writes an index record for each source file this job is responsible for:
+/// the primary files, or every file of the module if there are none.
+///
+/// Failing to write a record only produces a warning; the index is a side
+/// product of the compile.
+static void emitIndexRecords(CompilerInstance &Instance,
+                             StringRef InvocationHash, StringRef StorePath) {
+  SmallVector<SourceFile *, 8> Files;
+  if (SourceFile *Primary = Instance.getPrimarySourceFile()) {
+    Files.push_back(Primary);
+    Files.append(Instance.getBatchPrimarySourceFiles().begin(),
+                 Instance.getBatchPrimarySourceFiles().end());
+  } else {
+    for (FileUnit *File : Instance.getMainModule()->getFiles())
+      if (auto *SF = dyn_cast<SourceFile>(File))
+        if (SF->getBufferID().hasValue())
+          Files.push_back(SF);
+  }
+
+  for (SourceFile *SF : Files) {
+    std::string Error;
+    if (index::emitIndexRecord(SF, InvocationHash, StorePath, Error))
+      Instance.getDiags().diagnose(SourceLoc(),
+                                   diag::warning_index_record_failed,
+                                   SF->getFilename(), Error);
+  }
+}
+
+namespace {
+/// Counts the AST nodes of each kind that are reachable from a source file.
+class ASTNodeCounter : public ASTWalker {
+public:
+  llvm::DenseMap<unsigned, unsigned> DeclCounts;
+  llvm::DenseMap<unsigned, unsigned> StmtCounts;
+  llvm::DenseMap<unsigned, unsigned> ExprCounts;
+  llvm::DenseMap<unsigned, unsigned> PatternCounts;
+
+  bool walkToDeclPre(Decl *D) override {
+    ++DeclCounts[unsigned(D->getKind())];
+    return true;
+  }
+  std::pair<bool, Stmt *> walkToStmtPre(Stmt *S) override {
+    ++StmtCounts[unsigned(S->getKind())];
+    return { true, S };
+  }
+  std::pair<bool, Expr *> walkToExprPre(Expr *E) override {
+    ++ExprCounts[unsigned(E->getKind())];
+    return { true, E };
+  }
+  std::pair<bool, Pattern *> walkToPatternPre(Pattern *P) override {
+    ++PatternCounts[unsigned(P->getKind())];
+    return { true, P };
+  }
+};
+} // end anonymous namespace
+
+/// Reports how many declarations, statements, expressions and patterns of
+/// each kind the source files of the main module contain, and how much
+/// memory their nodes take up.
+///
+/// Sizes are those of the node classes themselves; trailing storage such as
+/// the elements of a TupleExpr is not included.
+static void reportASTNodeStatistics(CompilerInstance &Instance,
+                                    bool PrintStats) {
+  ASTNodeCounter Counter;
+  for (auto File : Instance.getMainModule()->getFiles())
+    if (auto SF = dyn_cast<SourceFile>(File))
+      for (auto D : SF->Decls)
+        D->walk(Counter);
+
+  struct Entry {
+    StringRef Category;
+    StringRef Kind;
+    unsigned Count;
+    size_t Bytes;
+  };
+  std::vector<Entry> Entries;
+  auto addEntry = [&](StringRef Category, StringRef Kind, unsigned Count,
+                      size_t Size) {
+    if (Count)
+      Entries.push_back({ Category, Kind, Count, Count * Size });
+  };
+#define DECL(Id, Parent) \
+  addEntry("Decl", #Id, Counter.DeclCounts.lookup(unsigned(DeclKind::Id)), \
+           sizeof(Id##Decl));
+#include "swift/AST/DeclNodes.def"
+#define STMT(Id, Parent) \
+  addEntry("Stmt", #Id, Counter.StmtCounts.lookup(unsigned(StmtKind::Id)), \
+           sizeof(Id##Stmt));
+#include "swift/AST/StmtNodes.def"
+#define EXPR(Id, Parent) \
+  addEntry("Expr", #Id, Counter.ExprCounts.lookup(unsigned(ExprKind::Id)), \
+           sizeof(Id##Expr));
+#include "swift/AST/ExprNodes.def"
+#define PATTERN(Id, Parent) \
+  addEntry("Pattern", #Id, \
+           Counter.PatternCounts.lookup(unsigned(PatternKind::Id)), \
+           sizeof(Id##Pattern));
+#include "swift/AST/PatternNodes.def"
+
+  std::sort(Entries.begin(), Entries.end(),
+            [](const Entry &LHS, const Entry &RHS) {
+    return LHS.Bytes > RHS.Bytes;
+  });
+
+  ASTContext &Context = Instance.getASTContext();
+  if (auto *Stats = Context.Stats) {
+    for (auto &E : Entries) {
+      std::string Prefix = ("AST." + E.Category + "." + E.Kind + ".").str();
+      Stats->addNamedCounter(Prefix + "Count", E.Count);
+      Stats->addNamedCounter(Prefix + "Bytes", E.Bytes);
+    }
+  }
+
+  if (!PrintStats)
+    return;
+
+  size_t TotalBytes = 0;
+  for (auto &E : Entries)
+    TotalBytes += E.Bytes;
+
+  llvm::raw_ostream &OS = llvm::errs();
+  OS << "*** AST node statistics ***\n";
+  OS << llvm::format("%10s %12s  %s\n", "count", "bytes", "kind");
+  for (auto &E : Entries)
+    OS << llvm::format("%10u %12zu  ", E.Count, E.Bytes)
+       << E.Kind << E.Category << "\n";
+  OS << llvm::format("%10s %12zu  ", "", TotalBytes) << "total in nodes\n";
+  OS << llvm::format("%10s %12zu  ", "", Context.getTotalMemory())
+     << "total ASTContext memory\n";
+}
+
+/// Performs the compile requested by the user.
+/// \returns true on error
+static bool performCompile(CompilerInstance &Instance,
+                           CompilerInvocation &Invocation,
+                           ArrayRef<const char *> Args,
+                           int &ReturnValue,
+                           FrontendObserver *observer) {
+  FrontendOptions opts = Invocation.getFrontendOptions();
+  FrontendOptions::ActionType Action = opts.RequestedAction;
+
+  IRGenOptions &IRGenOpts = Invocation.getIRGenOptions();
+
+  bool inputIsLLVMIr = Invocation.getInputKind() == InputFileKind::IFK_LLVM_IR;
+  if (inputIsLLVMIr) {
+    auto &LLVMContext = getGlobalLLVMContext();
+
+    // Load in bitcode file.
+    assert(Invocation.getInputFilenames().size() == 1 &&
+           "We expect a single input for bitcode input!");
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> FileBufOrErr =
+      llvm::MemoryBuffer::getFileOrSTDIN(Invocation.getInputFilenames()[0]);
+    if (!FileBufOrErr) {
+      Instance.getASTContext().Diags.diagnose(SourceLoc(),
+                                              diag::error_open_input_file,
+                                              Invocation.getInputFilenames()[0],
+                                              FileBufOrErr.getError().message());
+      return true;
+    }
+    llvm::MemoryBuffer *MainFile = FileBufOrErr.get().get();
+
+    llvm::SMDiagnostic Err;
+    std::unique_ptr<llvm::Module> Module = llvm::parseIR(
+                                             MainFile->getMemBufferRef(),
+                                             Err, LLVMContext);
+    if (!Module) {
+      // TODO: Translate from the diagnostic info to the SourceManager location
+      // if available.
+      Instance.getASTContext().Diags.diagnose(SourceLoc(),
+                                              diag::error_parse_input_file,
+                                              Invocation.getInputFilenames()[0],
+                                              Err.getMessage());
+      return true;
+    }
+
+    // TODO: remove once the frontend understands what action it should perform
+    IRGenOpts.OutputKind = getOutputKind(Action);
+
+    return performLLVM(IRGenOpts, Instance.getASTContext(), Module.get());
+  }
+
+  ReferencedNameTracker nameTracker;
+  bool shouldTrackReferences = !opts.ReferenceDependenciesFilePath.empty();
+  if (shouldTrackReferences)
+    Instance.setReferencedNameTracker(&nameTracker);
+
+  // Loading modules during type-checking can add search paths, so hash the
+  // options the index records depend on before that happens.
+  std::string IndexInvocationHash;
+  if (!opts.IndexStorePath.empty())
+    IndexInvocationHash = index::getIndexRecordInvocationHash(
+        Invocation.getLangOptions(), Invocation.getSearchPathOptions());
+
+  if (Action == FrontendOptions::Parse ||
+      Action == FrontendOptions::DumpParse ||
+      Action == FrontendOptions::DumpInterfaceHash)
+    Instance.performParseOnly();
+  else
+    Instance.performSema();
+
+  if (opts.PrintStats || Instance.getASTContext().Stats)
+    reportASTNodeStatistics(Instance, opts.PrintStats);
+
+  if (Action == FrontendOptions::Parse)
+    return false;
+
+  if (observer) {
+    observer->performedSemanticAnalysis(Instance);
+  }
+
+  FrontendOptions::DebugCrashMode CrashMode = opts.CrashMode;
+  if (CrashMode == FrontendOptions::DebugCrashMode::AssertAfterParse)
+    debugFailWithAssertion();
+  else if (CrashMode == FrontendOptions::DebugCrashMode::CrashAfterParse)
+    debugFailWithCrash();
+
+  ASTContext &Context = Instance.getASTContext();
+
+  if (Action == FrontendOptions::REPL) {
+    runREPL(Instance, ProcessCmdLine(Args.begin(), Args.end()),
+            Invocation.getParseStdlib());
+    return false;
+  }
+
+  SourceFile *PrimarySourceFile = Instance.getPrimarySourceFile();
+
+  // We've been told to dump the AST (either after parsing or type-checking,
+  // which is already differentiated in CompilerInstance::performSema()),
+  // so dump or print the main source file and return.
+  if (Action == FrontendOptions::DumpParse ||
+      Action == FrontendOptions::DumpAST ||
+      Action == FrontendOptions::PrintAST ||
+      Action == FrontendOptions::DumpScopeMaps ||
+      Action == FrontendOptions::DumpTypeRefinementContexts ||
+      Action == FrontendOptions::DumpInterfaceHash) {
+    SourceFile *SF = PrimarySourceFile;
+    if (!SF) {
+      SourceFileKind Kind = Invocation.getSourceFileKind();
+      SF = &Instance.getMainModule()->getMainSourceFile(Kind);
+    }
+    if (Action == FrontendOptions::PrintAST)
+      SF->print(llvm::outs(), PrintOptions::printEverything());
+    else if (Action == FrontendOptions::DumpScopeMaps) {
+      ASTScope &scope = SF->getScope();
+
+      if (opts.DumpScopeMapLocations.empty()) {
+        scope.expandAll();
+      } else if (auto bufferID = SF->getBufferID()) {
+        SourceManager &sourceMgr = Instance.getSourceMgr();
+        // Probe each of the locations, and dump what we find.
+        for (auto lineColumn : opts.DumpScopeMapLocations) {
+          SourceLoc loc = sourceMgr.getLocForLineCol(*bufferID,
+                                                     lineColumn.first,
+                                                     lineColumn.second);
+          if (loc.isInvalid()) continue;
+
+          llvm::errs() << "***Scope at " << lineColumn.first << ":"
+            << lineColumn.second << "***\n";
+          auto locScope = scope.findInnermostEnclosingScope(loc);
+          locScope->print(llvm::errs(), 0, false, false);
+
+          // Dump the AST context, too.
+          if (auto dc = locScope->getDeclContext()) {
+            dc->printContext(llvm::errs());
+          }
+
+          // Grab the local bindings introduced by this scope.
+          auto localBindings = locScope->getLocalBindings();
+          if (!localBindings.empty()) {
+            llvm::errs() << "Local bindings: ";
+            interleave(localBindings.begin(), localBindings.end(),
+                       [&](ValueDecl *value) {
+                         llvm::errs() << value->getFullName();
+                       },
+                       [&]() {
+                         llvm::errs() << " ";
+                       });
+            llvm::errs() << "\n";
+          }
+        }
+
+        llvm::errs() << "***Complete scope map***\n";
+      }
+
+      // Print the resulting map.
+      scope.print(llvm::errs());
+    } else if (Action == FrontendOptions::DumpTypeRefinementContexts)
+      SF->getTypeRefinementContext()->dump(llvm::errs(), Context.SourceMgr);
+    else if (Action == FrontendOptions::DumpInterfaceHash)
+      SF->dumpInterfaceHash(llvm::errs());
+    else
+      SF->dump();
+    return false;
+  }
+
+  // If we were asked to print Clang stats, do so.
+  if (opts.PrintClangStats && Context.getClangModuleLoader())
+    Context.getClangModuleLoader()->printStatistics();
+
+  if (!opts.DependenciesFilePath.empty())
+    (void)emitMakeDependencies(Context.Diags, *Instance.getDependencyTracker(),
+                               opts);
+
+  if (shouldTrackReferences)
+    emitReferenceDependencies(Context.Diags, Instance.getPrimarySourceFile(),
+                              *Instance.getDependencyTracker(), opts);
+
+  if (Context.hadError())
+    return true;
+
+  if (!opts.IndexStorePath.empty())
+    emitIndexRecords(Instance, IndexInvocationHash, opts.IndexStorePath);
+
+  // FIXME: This is still a lousy approximation of whether the module file will
+  // be externally consumed.
+  bool moduleIsPublic =
+      !Instance.getMainModule()->hasEntryPoint() &&
+      opts.ImplicitObjCHeaderPath.empty() &&
+      !Context.LangOpts.EnableAppExtensionRestrictions;
+
+  // We've just been told to perform a typecheck, so we can return now.
+  if (Action == FrontendOptions::Typecheck) {
+    if (!opts.ObjCHeaderOutputPath.empty())
+      return printAsObjC(opts.ObjCHeaderOutputPath, Instance.getMainModule(),
+                         opts.ImplicitObjCHeaderPath, moduleIsPublic);
+    return false;
+  }
+
+  assert(Action >= FrontendOptions::EmitSILGen &&
+         "All actions not requiring SILGen must have been handled!");
+
+  if (opts.isInBatchMode()) {
+    // Each primary file gets its own SIL module and output file, but shares
+    // the module imports and type-checking done above with the others.
+    SmallVector<SourceFile *, 8> PrimaryFiles;
+    PrimaryFiles.push_back(PrimarySourceFile);
+    PrimaryFiles.append(Instance.getBatchPrimarySourceFiles().begin(),
+                        Instance.getBatchPrimarySourceFiles().end());
+    assert(PrimaryFiles.size() == opts.OutputFilenames.size() &&
+           "one output per primary file");
+
+    for (unsigned i = 0, e = PrimaryFiles.size(); i != e; ++i) {
+      SourceFile *SF = PrimaryFiles[i];
+      assert(SF && "batch mode requires source file primary inputs");
+      IRGenOptions PrimaryIRGenOpts = IRGenOpts;
+      PrimaryIRGenOpts.MainInputFilename = SF->getFilename();
+      PrimaryIRGenOpts.OutputFilenames = { opts.OutputFilenames[i] };
+      if (performCompileStepsPostSema(Instance, Invocation, SF,
+                                      PrimaryIRGenOpts, opts.OutputFilenames[i],
+                                      nullptr, moduleIsPublic, ReturnValue,
+                                      observer))
+        return true;
+    }
+    return false;
+  }
+
+  return performCompileStepsPostSema(Instance, Invocation, PrimarySourceFile,
+                                     IRGenOpts, opts.getSingleOutputFilename(),
+                                     Instance.takeSILModule(), moduleIsPublic,
+                                     ReturnValue, observer);
+}
+
 /// Returns true if an error occurred.
 static bool dumpAPI(Module *Mod, StringRef OutDir) {
   using namespace llvm::sys;
@@ -786,6 +1036,19 @@ static bool dumpAPI(Module *Mod, StringRef OutDir) {
   return false;
 }
 
+/// Names this frontend job by its module and primary input file, for
+/// labelling its traces and statistics.
+static std::string describeJob(const CompilerInvocation &Invocation) {
+  const FrontendOptions &opts = Invocation.getFrontendOptions();
+  std::string result = Invocation.getModuleName().str();
+  if (opts.PrimaryInput && opts.PrimaryInput->isFilename()) {
+    result += " ";
+    result += llvm::sys::path::filename(
+        opts.InputFilenames[opts.PrimaryInput->Index]);
+  }
+  return result;
+}
+
 int swift::performFrontend(ArrayRef<const char *> Args,
                            const char *Argv0, void *MainAddr,
                            FrontendObserver *observer) {
@@ -845,6 +1108,27 @@ int swift::performFrontend(ArrayRef<const char *> Args,
     return 1;
   }
 
+  // Look up the outputs before anything opens them for writing.
+  std::unique_ptr<CompilationCache> Cache;
+  std::string CachedDiagnostics;
+  llvm::raw_string_ostream CachedDiagnosticsOS(CachedDiagnostics);
+  PrintingDiagnosticConsumer CachePDC(CachedDiagnosticsOS);
+  {
+    const std::string &CompilationCachePath =
+      Invocation.getFrontendOptions().CompilationCachePath;
+    if (!CompilationCachePath.empty() &&
+        CompilationCache::canCache(Invocation)) {
+      if (auto Key = Invocation.computeCompilationCacheKey(
+              Args, workingDirectory, MainExecutablePath)) {
+        Cache.reset(new CompilationCache(CompilationCachePath, Invocation,
+                                         *Key));
+        if (Cache->replay(llvm::errs()))
+          return 0;
+        Instance.addDiagnosticConsumer(&CachePDC);
+      }
+    }
+  }
+
   // Because the serialized diagnostics consumer is initialized here,
   // diagnostics emitted above, within CompilerInvocation::parseArgs, are never
   // serialized. This is a non-issue because, in nearly all cases, frontend
@@ -905,6 +1189,9 @@ int swift::performFrontend(ArrayRef<const char *> Args,
   if (Invocation.getFrontendOptions().DebugTimeCompilation)
     SharedTimer::enableCompilationTimers();
 
+  if (!Invocation.getFrontendOptions().TraceCompileEventsPath.empty())
+    TracedEvent::enableTracing();
+
   if (Invocation.getFrontendOptions().PrintStats) {
     llvm::EnableStatistics();
   }
@@ -916,14 +1203,25 @@ int swift::performFrontend(ArrayRef<const char *> Args,
 
   DependencyTracker depTracker;
   if (!Invocation.getFrontendOptions().DependenciesFilePath.empty() ||
-      !Invocation.getFrontendOptions().ReferenceDependenciesFilePath.empty()) {
+      !Invocation.getFrontendOptions().ReferenceDependenciesFilePath.empty() ||
+      Cache) {
     Instance.setDependencyTracker(&depTracker);
   }
 
+  std::unique_ptr<UnifiedStatsReporter> StatsReporter;
+  if (!Invocation.getFrontendOptions().StatsOutputDir.empty()) {
+    StatsReporter = llvm::make_unique<UnifiedStatsReporter>(
+        "swift-frontend", describeJob(Invocation),
+        Invocation.getFrontendOptions().StatsOutputDir);
+  }
+
   if (Instance.setup(Invocation)) {
     return 1;
   }
 
+  if (StatsReporter)
+    Instance.getASTContext().Stats = StatsReporter.get();
+
   // The compiler instance has been configured; notify our observer.
   if (observer) {
     observer->configuredCompiler(Instance);
@@ -958,9 +1256,77 @@ int swift::performFrontend(ArrayRef<const char *> Args,
     }
   }
 
+  const FrontendOptions &frontendOpts = Invocation.getFrontendOptions();
+  if (!frontendOpts.TraceCompileEventsPath.empty()) {
+    std::error_code EC;
+    llvm::raw_fd_ostream out(frontendOpts.TraceCompileEventsPath, EC,
+                             llvm::sys::fs::F_None);
+    if (EC) {
+      Instance.getDiags().diagnose(SourceLoc(), diag::cannot_open_file,
+                                   frontendOpts.TraceCompileEventsPath,
+                                   EC.message());
+      HadError = true;
+    } else {
+      TracedEvent::writeTrace(out, describeJob(Invocation));
+    }
+  }
+
+  if (StatsReporter) {
+    ASTContext &Context = Instance.getASTContext();
+    auto &C = StatsReporter->getFrontendCounters();
+    C.NumSourceBuffers = Instance.getSourceMgr().getLLVMSourceMgr()
+                                                .getNumBuffers();
+    C.NumLoadedModules = Context.LoadedModules.size();
+    Context.Stats = nullptr;
+    StatsReporter.reset();
+  }
+
+  if (Cache && !HadError && ReturnValue == 0) {
+    // The serialized diagnostics and fix-its are written out when their
+    // consumers are destroyed, and have to be complete to be stored.
+    DiagnosticEngine &diags = Instance.getDiags();
+    for (DiagnosticConsumer *consumer : diags.takeConsumers()) {
+      if (consumer != SerializedConsumer.get() &&
+          consumer != FixitsConsumer.get())
+        diags.addConsumer(*consumer);
+    }
+    SerializedConsumer.reset();
+    FixitsConsumer.reset();
+    Cache->store(depTracker.getDependencies(), CachedDiagnosticsOS.str());
+  }
+
   return (HadError ? 1 : ReturnValue);
 }
 
+int swift::performFrontendServer(StringRef socketPath, const char *argv0,
+                                 void *mainAddr) {
+  // Do everything that doesn't depend on the job up front, so that the
+  // forked processes inherit it.
+  llvm::InitializeAllTargets();
+  llvm::InitializeAllTargetMCs();
+  llvm::InitializeAllAsmPrinters();
+  llvm::InitializeAllAsmParsers();
+
+  std::string mainExecutablePath =
+    llvm::sys::fs::getMainExecutable(argv0, mainAddr);
+
+  auto runJob = [&](StringRef execPath,
+                    ArrayRef<const char *> args) -> Optional<int> {
+    if (args.empty() || StringRef(args.front()) != "-frontend" ||
+        !llvm::sys::fs::equivalent(execPath, mainExecutablePath))
+      return None;
+
+    std::string jobArgv0 = execPath;
+    int result = performFrontend(args.slice(1), jobArgv0.c_str(), mainAddr);
+
+    // Report statistics and timers as a frontend process does on exit.
+    llvm::llvm_shutdown();
+    return result;
+  };
+
+  return sys::runSpawnServer(socketPath, mainExecutablePath, runJob);
+}
+
 void FrontendObserver::parsedArgs(CompilerInvocation &invocation) {}
 void FrontendObserver::configuredCompiler(CompilerInstance &instance) {}
 void FrontendObserver::performedSemanticAnalysis(CompilerInstance &instance) {}
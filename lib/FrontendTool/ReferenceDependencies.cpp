@@ -24,10 +24,14 @@
 #include "swift/AST/Types.h"
 #include "swift/Frontend/FrontendOptions.h"
 #include "swift/Basic/LLVM.h"
+#include "swift/Basic/SourceManager.h"
+#include "swift/Parse/Lexer.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/YAMLParser.h"
 
 using namespace swift;
@@ -98,6 +102,178 @@ static bool extendedTypeIsPrivate(TypeLoc inheritedType) {
   return std::all_of(protocols.begin(), protocols.end(), declIsPrivate);
 }
 
+/// Returns true if \p member can be given a fingerprint of its own, rather
+/// than contributing to the fingerprint of the type that contains it.
+///
+/// Stored properties and enum cases affect the layout of the type, and any
+/// member of a class or protocol may affect its vtable or witness tables, so
+/// only methods, initializers and subscripts of structs, enums and
+/// non-protocol extensions qualify.
+static bool hasOwnFingerprint(const Decl *member) {
+  if (!isa<AbstractFunctionDecl>(member) && !isa<SubscriptDecl>(member))
+    return false;
+
+  // Operators are provided at the top level instead.
+  auto *VD = cast<ValueDecl>(member);
+  if (!VD->hasName() || VD->getFullName().isOperator())
+    return false;
+
+  const DeclContext *DC = member->getDeclContext();
+  if (isa<ExtensionDecl>(DC))
+    return !DC->getAsProtocolExtensionContext();
+  return isa<StructDecl>(DC) || isa<EnumDecl>(DC);
+}
+
+namespace {
+/// Computes content fingerprints for the declarations a file provides, so
+/// that the driver can tell which of them actually changed between builds.
+///
+/// Each type is split into the text of the members that have their own
+/// fingerprint (see hasOwnFingerprint) and everything else, which is hashed
+/// together as the "skeleton" of the type.
+class FingerprintCollector {
+  const SourceManager &SM;
+
+public:
+  using MemberKeyTy = std::pair<const NominalTypeDecl *, Identifier>;
+
+  /// Fingerprints of top-level names.
+  llvm::MapVector<Identifier, llvm::MD5> TopLevel;
+  /// Fingerprints of the skeleton of each type.
+  llvm::MapVector<const NominalTypeDecl *, llvm::MD5> Nominals;
+  /// Fingerprints of the complete contents of each type, members included.
+  llvm::MapVector<const NominalTypeDecl *, llvm::MD5> Contents;
+  /// Fingerprints of the members that have their own.
+  llvm::MapVector<MemberKeyTy, llvm::MD5> Members;
+
+  explicit FingerprintCollector(const SourceManager &SM) : SM(SM) {}
+
+private:
+  void hashText(llvm::MD5 &hash, SourceLoc start, SourceLoc end) {
+    StringRef text = SM.extractText(CharSourceRange(SM, start, end));
+    hash.update(text.trim());
+    // Keep adjacent pieces from running together.
+    hash.update(ArrayRef<uint8_t>{0});
+  }
+
+  /// Hashes the canonical type of \p VD, so that the fingerprint changes when
+  /// something the declaration's type is written in terms of changes, even
+  /// if its text doesn't.
+  void hashType(llvm::MD5 &hash, const ValueDecl *VD) {
+    if (!VD->hasInterfaceType())
+      return;
+    hash.update(VD->getInterfaceType()->getCanonicalType().getString());
+    hash.update(ArrayRef<uint8_t>{0});
+  }
+
+  /// Returns the range of \p D, extended to cover any attributes written
+  /// before it.
+  SourceRange getRangeIncludingAttrs(const Decl *D) {
+    SourceRange range = D->getSourceRange();
+    if (range.isInvalid())
+      return range;
+    for (auto *attr : D->getAttrs()) {
+      SourceRange attrRange = attr->getRange();
+      if (attr->isImplicit() || attrRange.isInvalid())
+        continue;
+      if (SM.isBeforeInBuffer(attrRange.Start, range.Start))
+        range.Start = attrRange.Start;
+    }
+    return range;
+  }
+
+public:
+  /// Records the text of \p D under the top-level name \p name.
+  void addTopLevel(Identifier name, const Decl *D) {
+    SourceRange range = getRangeIncludingAttrs(D);
+    if (range.isInvalid())
+      return;
+    auto &hash = TopLevel[name];
+    hashText(hash, range.Start, Lexer::getLocForEndOfToken(SM, range.End));
+    if (auto *VD = dyn_cast<ValueDecl>(D))
+      hashType(hash, VD);
+  }
+
+  /// Records the text of \p D, which is either \p nominal itself or an
+  /// extension of it, along with any types nested within it.
+  ///
+  /// If \p topLevelName is non-empty, the skeleton is also recorded under
+  /// that top-level name.
+  void addContext(const Decl *D, const NominalTypeDecl *nominal,
+                  DeclRange members, Identifier topLevelName = Identifier()) {
+    SourceRange range = getRangeIncludingAttrs(D);
+    if (range.isInvalid())
+      return;
+
+    auto hashSkeleton = [&](SourceLoc start, SourceLoc end) {
+      hashText(Nominals[nominal], start, end);
+      hashText(Contents[nominal], start, end);
+      if (!topLevelName.empty())
+        hashText(TopLevel[topLevelName], start, end);
+    };
+
+    auto hashSkeletonType = [&](const ValueDecl *VD) {
+      hashType(Nominals[nominal], VD);
+      hashType(Contents[nominal], VD);
+      if (!topLevelName.empty())
+        hashType(TopLevel[topLevelName], VD);
+    };
+
+    SmallVector<const NominalTypeDecl *, 4> nestedNominals;
+    SourceLoc cursor = range.Start;
+    for (const Decl *member : members) {
+      // Implicit members, such as inferred associated types and synthesized
+      // initializers, have no text but can still change.
+      if (auto *VD = dyn_cast<ValueDecl>(member)) {
+        if (!hasOwnFingerprint(VD)) {
+          hashSkeletonType(VD);
+        } else if (!declIsPrivate(VD)) {
+          hashType(Members[{nominal, VD->getName()}], VD);
+          hashType(Contents[nominal], VD);
+        }
+      }
+
+      SourceRange memberRange = member->getSourceRange();
+      if (member->isImplicit() || memberRange.isInvalid())
+        continue;
+      SourceLoc memberEnd = Lexer::getLocForEndOfToken(SM, memberRange.End);
+
+      // Skip members that lie within ones we've already seen, such as the
+      // variables of a pattern binding.
+      if (!SM.isBeforeInBuffer(cursor, memberEnd))
+        continue;
+
+      if (auto *nested = dyn_cast<NominalTypeDecl>(member))
+        if (!declIsPrivate(nested))
+          nestedNominals.push_back(nested);
+
+      if (!hasOwnFingerprint(member)) {
+        hashSkeleton(cursor, memberEnd);
+      } else if (!declIsPrivate(member)) {
+        // Private members can't be used from other files, so they don't
+        // contribute to any fingerprint.
+        auto name = cast<ValueDecl>(member)->getName();
+        hashText(Members[{nominal, name}], cursor, memberEnd);
+        hashText(Contents[nominal], cursor, memberEnd);
+      }
+      cursor = memberEnd;
+    }
+    hashSkeleton(cursor, Lexer::getLocForEndOfToken(SM, range.End));
+
+    for (auto *nested : nestedNominals)
+      addContext(nested, nested, nested->getMembers());
+  }
+};
+} // end anonymous namespace
+
+static std::string stringifyFingerprint(llvm::MD5 hash) {
+  llvm::MD5::MD5Result result;
+  hash.final(result);
+  llvm::SmallString<32> str;
+  llvm::MD5::stringifyResult(result, str);
+  return str.str();
+}
+
 static std::string mangleTypeAsContext(const NominalTypeDecl *type) {
   Mangle::Mangler mangler(/*debug style=*/false, /*Unicode=*/true);
   mangler.mangleContext(type);
@@ -145,6 +321,8 @@ bool swift::emitReferenceDependencies(DiagnosticEngine &diags,
   llvm::MapVector<const NominalTypeDecl *, bool> extendedNominals;
   llvm::SmallVector<const FuncDecl *, 8> memberOperatorDecls;
   llvm::SmallVector<const ExtensionDecl *, 8> extensionsWithJustMembers;
+  FingerprintCollector fingerprints(SF->getASTContext().SourceMgr);
+  llvm::SmallDenseSet<Identifier, 8> topLevelNamesWithoutFingerprints;
 
   out << "provides-top-level:\n";
   for (const Decl *D : SF->Decls) {
@@ -180,6 +358,7 @@ bool swift::emitReferenceDependencies(DiagnosticEngine &diags,
       extendedNominals[NTD] |= !justMembers;
       findNominalsAndOperators(extendedNominals, memberOperatorDecls,
                                ED->getMembers());
+      fingerprints.addContext(ED, NTD, ED->getMembers());
       break;
     }
 
@@ -187,10 +366,12 @@ bool swift::emitReferenceDependencies(DiagnosticEngine &diags,
     case DeclKind::PrefixOperator:
     case DeclKind::PostfixOperator:
       out << "- \"" << escape(cast<OperatorDecl>(D)->getName()) << "\"\n";
+      fingerprints.addTopLevel(cast<OperatorDecl>(D)->getName(), D);
       break;
 
     case DeclKind::PrecedenceGroup:
       out << "- \"" << escape(cast<PrecedenceGroupDecl>(D)->getName()) << "\"\n";
+      fingerprints.addTopLevel(cast<PrecedenceGroupDecl>(D)->getName(), D);
       break;
 
     case DeclKind::Enum:
@@ -208,6 +389,7 @@ bool swift::emitReferenceDependencies(DiagnosticEngine &diags,
       extendedNominals[NTD] |= true;
       findNominalsAndOperators(extendedNominals, memberOperatorDecls,
                                NTD->getMembers());
+      fingerprints.addContext(NTD, NTD, NTD->getMembers(), NTD->getName());
       break;
     }
 
@@ -222,6 +404,12 @@ bool swift::emitReferenceDependencies(DiagnosticEngine &diags,
         break;
       }
       out << "- \"" << escape(VD->getName()) << "\"\n";
+      // The text of a variable is in its pattern binding, so don't try to
+      // fingerprint it.
+      if (isa<VarDecl>(VD))
+        topLevelNamesWithoutFingerprints.insert(VD->getName());
+      else
+        fingerprints.addTopLevel(VD->getName(), VD);
       break;
     }
 
@@ -244,8 +432,10 @@ bool swift::emitReferenceDependencies(DiagnosticEngine &diags,
   }
 
   // This is also part of "provides-top-level".
-  for (auto *operatorFunction : memberOperatorDecls)
+  for (auto *operatorFunction : memberOperatorDecls) {
     out << "- \"" << escape(operatorFunction->getName()) << "\"\n";
+    topLevelNamesWithoutFingerprints.insert(operatorFunction->getName());
+  }
 
   out << "provides-nominal:\n";
   for (auto entry : extendedNominals) {
@@ -264,9 +454,10 @@ bool swift::emitReferenceDependencies(DiagnosticEngine &diags,
   }
 
   // This is also part of "provides-member".
+  llvm::DenseSet<FingerprintCollector::MemberKeyTy> providedMembers;
   for (auto *ED : extensionsWithJustMembers) {
-    auto mangledName = mangleTypeAsContext(
-                                        ED->getExtendedType()->getAnyNominal());
+    auto *NTD = ED->getExtendedType()->getAnyNominal();
+    auto mangledName = mangleTypeAsContext(NTD);
 
     for (auto *member : ED->getMembers()) {
       auto *VD = dyn_cast<ValueDecl>(member);
@@ -274,11 +465,22 @@ bool swift::emitReferenceDependencies(DiagnosticEngine &diags,
           VD->getFormalAccess() <= Accessibility::FilePrivate) {
         continue;
       }
+      if (!providedMembers.insert({NTD, VD->getName()}).second)
+        continue;
       out << "- [\"" << mangledName << "\", \""
           << escape(VD->getName()) << "\"]\n";
     }
   }
 
+  // As are the members with their own fingerprints, so that depending on one
+  // of them doesn't mean depending on the rest of the type.
+  for (auto &entry : fingerprints.Members) {
+    if (!providedMembers.insert(entry.first).second)
+      continue;
+    out << "- [\"" << mangleTypeAsContext(entry.first.first) << "\", \""
+        << escape(entry.first.second) << "\"]\n";
+  }
+
   if (SF->getASTContext().LangOpts.EnableObjCInterop) {
     // FIXME: This requires a traversal of the whole file to compute.
     // We should (a) see if there's a cheaper way to keep it up to date,
@@ -402,6 +604,41 @@ bool swift::emitReferenceDependencies(DiagnosticEngine &diags,
     out << "- \"" << llvm::yaml::escape(entry) << "\"\n";
   }
 
+  out << "fingerprints-top-level:\n";
+  for (auto &entry : fingerprints.TopLevel) {
+    if (topLevelNamesWithoutFingerprints.count(entry.first))
+      continue;
+    out << "- [\"" << escape(entry.first) << "\", \""
+        << stringifyFingerprint(entry.second) << "\"]\n";
+  }
+
+  out << "fingerprints-nominal:\n";
+  for (auto entry : extendedNominals) {
+    if (!entry.second)
+      continue;
+    auto iter = fingerprints.Nominals.find(entry.first);
+    if (iter == fingerprints.Nominals.end())
+      continue;
+    out << "- [\"" << mangleTypeAsContext(entry.first) << "\", \""
+        << stringifyFingerprint(iter->second) << "\"]\n";
+  }
+
+  // The whole-type member entry covers everything in the type, since its
+  // dependents may care about any of its members.
+  out << "fingerprints-member:\n";
+  for (auto entry : extendedNominals) {
+    auto iter = fingerprints.Contents.find(entry.first);
+    if (iter == fingerprints.Contents.end())
+      continue;
+    out << "- [\"" << mangleTypeAsContext(entry.first) << "\", \"\", \""
+        << stringifyFingerprint(iter->second) << "\"]\n";
+  }
+  for (auto &entry : fingerprints.Members) {
+    out << "- [\"" << mangleTypeAsContext(entry.first.first) << "\", \""
+        << escape(entry.first.second) << "\", \""
+        << stringifyFingerprint(entry.second) << "\"]\n";
+  }
+
   llvm::SmallString<32> interfaceHash;
   SF->getInterfaceHash(interfaceHash);
   out << "interface-hash: \"" << interfaceHash << "\"\n";
@@ -816,7 +816,8 @@ static void VisitNodeAssociatedTypeRef(
   }
   result._types.clear();
   result._error = stringWithFormat(
-      "unable to find associated type %s in context", ident->getText().c_str());
+      "unable to find associated type %s in context",
+      ident->getText().str().c_str());
 }
 
 static void VisitNodeBoundGeneric(
@@ -1284,7 +1285,7 @@ static void VisitNodeFunction(
       if (decl_scope_result._decls.size() == 0) {
         result._error = stringWithFormat(
             "demangled identifier %s could not be found by name lookup",
-            (*pos)->getText().c_str());
+            (*pos)->getText().str().c_str());
         break;
       }
       std::copy(decl_scope_result._decls.begin(),
@@ -1614,7 +1615,7 @@ static void VisitNodeIdentifier(
     if (result._error.empty())
       result._error =
           stringWithFormat("unable to find Node::Kind::Identifier '%s'",
-                           cur_node->getText().c_str());
+                           cur_node->getText().str().c_str());
   }
 }
 
@@ -1670,11 +1671,12 @@ static void VisitNodePrivateDeclName(
   }
 
   if (!FindFirstNamedDeclWithKind(ast, id_node->getText(), decl_kind, result,
-                                  priv_decl_id_node->getText())) {
+                                  priv_decl_id_node->getText().str())) {
     if (result._error.empty())
       result._error = stringWithFormat(
           "unable to find Node::Kind::PrivateDeclName '%s' in '%s'",
-          id_node->getText().c_str(), priv_decl_id_node->getText().c_str());
+          id_node->getText().str().c_str(),
+          priv_decl_id_node->getText().str().c_str());
   }
 }
 
@@ -1738,8 +1740,8 @@ static void VisitNodeModule(
     Demangle::NodePointer &cur_node, VisitNodeResult &result,
     const VisitNodeResult &generic_context) { // set by GenericType case
   std::string error;
-  const char *module_name = cur_node->getText().c_str();
-  if (!module_name || *module_name == '\0') {
+  std::string module_name = cur_node->getText();
+  if (module_name.empty()) {
     result._error = stringWithFormat("error: empty module name.");
     return;
   }
@@ -1748,7 +1750,7 @@ static void VisitNodeModule(
       DeclsLookupSource::GetDeclsLookupSource(*ast, ConstString(module_name));
   if (!result._module) {
     result._error = stringWithFormat("unable to load module '%s' (%s)",
-                                     module_name, error.data());
+                                     module_name.c_str(), error.data());
   }
 }
 
@@ -1817,9 +1819,9 @@ static void VisitNodeQualifiedArchetype(
     VisitNodeResult type_result;
     uint64_t index = 0xFFFFFFFFFFFFFFFF;
     for (Demangle::Node::iterator pos = cur_node->begin(); pos != end; ++pos) {
-      switch (pos->get()->getKind()) {
+      switch ((*pos)->getKind()) {
       case Demangle::Node::Kind::Number:
-        index = pos->get()->getIndex();
+        index = (*pos)->getIndex();
         break;
       case Demangle::Node::Kind::DeclContext:
         nodes.push_back(*pos);
@@ -1858,14 +1860,14 @@ static void VisitNodeTupleElement(
     ASTContext *ast, std::vector<Demangle::NodePointer> &nodes,
     Demangle::NodePointer &cur_node, VisitNodeResult &result,
     const VisitNodeResult &generic_context) { // set by GenericType case
-  const char *tuple_name = nullptr;
+  StringRef tuple_name;
   VisitNodeResult tuple_type_result;
   Demangle::Node::iterator end = cur_node->end();
   for (Demangle::Node::iterator pos = cur_node->begin(); pos != end; ++pos) {
     const Demangle::Node::Kind child_node_kind = (*pos)->getKind();
     switch (child_node_kind) {
     case Demangle::Node::Kind::TupleElementName:
-      tuple_name = (*pos)->getText().c_str();
+      tuple_name = (*pos)->getText();
       break;
     case Demangle::Node::Kind::Type:
       nodes.push_back((*pos)->getFirstChild());
@@ -1878,7 +1880,7 @@ static void VisitNodeTupleElement(
 
   if (tuple_type_result._error.empty() &&
       tuple_type_result._types.size() == 1) {
-    if (tuple_name)
+    if (!tuple_name.empty())
       result._tuple_type_element =
           TupleTypeElt(tuple_type_result._types.front().getPointer(),
                        ast->getIdentifier(tuple_name));
@@ -2175,9 +2177,9 @@ Decl *ide::getDeclFromUSR(ASTContext &context, StringRef USR,
 Decl *ide::getDeclFromMangledSymbolName(ASTContext &context,
                                         StringRef mangledName,
                                         std::string &error) {
+  Demangle::Context DemangleCtx;
   std::vector<Demangle::NodePointer> nodes;
-  nodes.push_back(
-      Demangle::demangleSymbolAsNode(mangledName.data(), mangledName.size()));
+  nodes.push_back(DemangleCtx.demangleSymbolAsNode(mangledName));
   VisitNodeResult emptyGenericContext;
   VisitNodeResult result;
   VisitNode(&context, nodes, result, emptyGenericContext);
@@ -2195,9 +2197,9 @@ Decl *ide::getDeclFromMangledSymbolName(ASTContext &context,
 Type ide::getTypeFromMangledTypename(ASTContext &Ctx,
                                      StringRef mangledName,
                                      std::string &error) {
+  Demangle::Context DemangleCtx;
   std::vector<Demangle::NodePointer> nodes;
-  nodes.push_back(
-      Demangle::demangleTypeAsNode(mangledName.data(), mangledName.size()));
+  nodes.push_back(DemangleCtx.demangleTypeAsNode(mangledName));
   VisitNodeResult empty_generic_context;
   VisitNodeResult result;
 
@@ -2216,9 +2218,9 @@ Type ide::getTypeFromMangledTypename(ASTContext &Ctx,
 Type ide::getTypeFromMangledSymbolname(ASTContext &Ctx,
                                        StringRef mangledName,
                                        std::string &error) {
+  Demangle::Context DemangleCtx;
   std::vector<Demangle::NodePointer> nodes;
-  nodes.push_back(
-      Demangle::demangleSymbolAsNode(mangledName.data(), mangledName.size()));
+  nodes.push_back(DemangleCtx.demangleSymbolAsNode(mangledName));
   VisitNodeResult empty_generic_context;
   VisitNodeResult result;
 
@@ -754,14 +754,8 @@ EnumPayload::emitGatherSpareBits(IRGenFunction &IGF,
     
     unsigned size = DL.getTypeSizeInBits(v->getType());
     // Slice the spare bit vector.
-    // FIXME: this is inefficient.
-    auto spareBitsPart = SpareBitVector::getConstant(size, false);
-    unsigned numBitsInPart = 0;
-    for (unsigned i = 0; i < size; ++i)
-      if (spareBits[payloadOffset + i]) {
-        spareBitsPart.setBit(i);
-        ++numBitsInPart;
-      }
+    auto spareBitsPart = spareBits.getSlice(payloadOffset, size);
+    unsigned numBitsInPart = spareBitsPart.count();
     
     payloadOffset += size;
     
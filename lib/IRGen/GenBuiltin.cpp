@@ -368,6 +368,20 @@ if (Builtin.ID == BuiltinValueKind::id) { \
     return;
   }
 
+  if (Builtin.ID == BuiltinValueKind::StackAlloc) {
+    auto size = args.claimNext();
+    auto alloc = IGF.emitDynamicAlloca(size, Alignment(16),
+                                       "builtin-stackAlloc");
+    out.add(alloc.getAddress());
+    return;
+  }
+
+  if (Builtin.ID == BuiltinValueKind::StackDealloc) {
+    auto pointer = args.claimNext();
+    IGF.emitDeallocateDynamicAlloca(pointer);
+    return;
+  }
+
   if (Builtin.ID == BuiltinValueKind::Fence) {
     SmallVector<Type, 4> Types;
     StringRef BuiltinName =
@@ -710,6 +724,8 @@ if (Builtin.ID == BuiltinValueKind::id) { \
     if (auto ExpectedPred = IGF.IGM.TargetInfo.OnceDonePredicateValue) {
       auto PredValue = IGF.Builder.CreateLoad(PredPtr,
                                               IGF.IGM.getPointerAlignment());
+      if (IGF.IGM.TargetInfo.OnceDonePredicateNeedsAcquire)
+        PredValue->setOrdering(llvm::AtomicOrdering::Acquire);
       auto ExpectedPredValue = llvm::ConstantInt::getSigned(IGF.IGM.OnceTy,
                                                             *ExpectedPred);
       auto PredIsDone = IGF.Builder.CreateICmpEQ(PredValue, ExpectedPredValue);
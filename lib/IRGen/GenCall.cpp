@@ -2015,6 +2015,10 @@ bool IRGenFunction::emitBranchToReturnBB() {
 void IRGenFunction::emitEpilogue() {
   // Destroy the alloca insertion point.
   AllocaIP->eraseFromParent();
+
+  // Destroy the type data hoisting point.
+  if (TypeDataHoistingPoint)
+    TypeDataHoistingPoint->eraseFromParent();
 }
 
 std::pair<Address, Size>
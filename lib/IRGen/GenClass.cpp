@@ -33,6 +33,7 @@
 #include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/MDBuilder.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/IR/CallSite.h"
 
@@ -579,6 +580,54 @@ Address irgen::emitTailProjection(IRGenFunction &IGF, llvm::Value *Base,
   return Address(Addr, Align);
 }
 
+/// Return the root of the TBAA type hierarchy for Swift class storage.  It
+/// is distinct from Clang's root, so our tags never say anything about
+/// accesses emitted by Clang.
+llvm::MDNode *IRGenModule::getTBAARoot() {
+  if (!TBAARoot) {
+    llvm::MDBuilder builder(getLLVMContext());
+    TBAARoot = builder.createTBAARoot("Swift class storage");
+  }
+  return TBAARoot;
+}
+
+/// Create an access tag for a new type directly below the root.  Two
+/// accesses with different tags are known not to alias.
+static llvm::MDNode *createTBAATag(IRGenModule &IGM, llvm::MDNode *root,
+                                   StringRef name) {
+  llvm::MDBuilder builder(IGM.getLLVMContext());
+  auto type = builder.createTBAAScalarTypeNode(name, root);
+  return builder.createTBAAStructTagNode(type, type, 0);
+}
+
+llvm::MDNode *IRGenModule::getTBAATagForField(VarDecl *field) {
+  auto &tag = TBAAFieldTags[field];
+  if (tag)
+    return tag;
+
+  // Every stored property of a class occupies its own memory in an
+  // instance, so accesses to different properties never alias.  The name
+  // only has to be the same for the same property; collisions just make
+  // the tags more conservative.
+  auto theClass = field->getDeclContext()
+    ->getAsNominalTypeOrNominalTypeExtensionContext();
+  llvm::SmallString<64> name;
+  llvm::raw_svector_ostream os(name);
+  os << field->getModuleContext()->getName() << '.'
+     << theClass->getName() << '.' << field->getName();
+  tag = createTBAATag(*this, getTBAARoot(), os.str());
+  return tag;
+}
+
+llvm::MDNode *IRGenModule::getTBAATagForTailElements() {
+  // Tail-allocated elements are stored after all of the stored properties
+  // of the instance.
+  if (!TBAATailElementsTag)
+    TBAATailElementsTag = createTBAATag(*this, getTBAARoot(),
+                                        "tail-allocated elements");
+  return TBAATailElementsTag;
+}
+
 /// Try to stack promote a class instance with possible tail allocated arrays.
 ///
 /// Returns the alloca if successful, or nullptr otherwise.
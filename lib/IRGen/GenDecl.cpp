@@ -678,6 +678,44 @@ void IRGenModule::emitRuntimeRegistration() {
   RegIGF.Builder.CreateRetVoid();
 }
 
+/// Pass the metadata accessors of the given types to swift_warmMetadata on
+/// entry to the program, so that the runtime instantiates them on a
+/// background thread instead of on whichever thread first uses them.
+void IRGenModule::emitGenericMetadataWarming(llvm::Function *entryFunction,
+                                             ArrayRef<CanType> types) {
+  SmallVector<llvm::Constant *, 16> accessors;
+  for (CanType type : types) {
+    // A private accessor may be defined in another of the module's object
+    // files, where we can't reference it.
+    if (getTypeMetadataAccessStrategy(*this, type) ==
+          MetadataAccessStrategy::PrivateAccessor)
+      continue;
+    auto accessor = getOrCreateTypeMetadataAccessFunction(*this, type);
+    accessors.push_back(llvm::ConstantExpr::getBitCast(accessor, Int8PtrTy));
+  }
+  if (accessors.empty())
+    return;
+
+  auto arrayTy = llvm::ArrayType::get(Int8PtrTy, accessors.size());
+  auto var = new llvm::GlobalVariable(Module, arrayTy, /*isConstant*/ true,
+                                      llvm::GlobalValue::PrivateLinkage,
+                                      llvm::ConstantArray::get(arrayTy,
+                                                               accessors),
+                                      "generic_metadata_to_warm");
+  var->setAlignment(getPointerAlignment().getValue());
+
+  llvm::BasicBlock *EntryBB = &entryFunction->getEntryBlock();
+  llvm::BasicBlock::iterator IP = EntryBB->getFirstInsertionPt();
+  IRBuilder Builder(getLLVMContext(),
+                    DebugInfo && !Context.LangOpts.DebuggerSupport);
+  Builder.llvm::IRBuilderBase::SetInsertPoint(EntryBB, IP);
+  if (DebugInfo && !Context.LangOpts.DebuggerSupport)
+    DebugInfo->setEntryPointLoc(Builder);
+  Builder.CreateCall(getWarmMetadataFn(),
+                     {llvm::ConstantExpr::getBitCast(var, Int8PtrPtrTy),
+                      llvm::ConstantInt::get(SizeTy, accessors.size())});
+}
+
 /// Add the given global value to @llvm.used.
 ///
 /// This value must have a definition by the time the module is finalized.
@@ -876,6 +914,21 @@ void IRGenerator::emitTypeMetadataRecords() {
   }
 }
 
+void IRGenerator::emitGenericMetadataWarming() {
+  if (GenericMetadataToWarm.empty())
+    return;
+
+  for (auto &m : *this) {
+    IRGenModule *IGM = m.second;
+    auto entryFunction = IGM->Module.getFunction(SWIFT_ENTRY_POINT_FUNCTION);
+    if (entryFunction && !entryFunction->isDeclaration()) {
+      IGM->emitGenericMetadataWarming(entryFunction,
+                                      GenericMetadataToWarm.getArrayRef());
+      return;
+    }
+  }
+}
+
 /// Emit any lazy definitions (of globals or functions or whatever
 /// else) that we require.
 void IRGenerator::emitLazyDefinitions() {
@@ -3091,7 +3144,7 @@ llvm::StructType *IRGenModule::getGenericWitnessTableCacheTy() {
       // Instantiator
       RelativeAddressTy,
       // PrivateData
-      llvm::ArrayType::get(Int8PtrTy, swift::NumGenericMetadataPrivateDataWords)
+      RelativeAddressTy
     }, "swift.generic_witness_table_cache");
   return GenericWitnessTableCacheTy;
 }
@@ -5692,6 +5692,9 @@ void IRGenModule::emitEnumDecl(EnumDecl *theEnum) {
   emitEnumMetadata(*this, theEnum);
   emitNestedTypeDecls(theEnum->getMembers());
 
+  if (DebugInfo)
+    DebugInfo->emitTypeDecl(theEnum);
+
   if (shouldEmitOpaqueTypeMetadataRecord(theEnum)) {
     emitOpaqueTypeMetadataRecord(theEnum);
     return;
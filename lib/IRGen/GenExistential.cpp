@@ -1682,11 +1682,12 @@ Address irgen::emitOpenExistentialBox(IRGenFunction &IGF,
 }
 
 /// Allocate a boxed existential container with uninitialized space to hold a
-/// value of a given type.
+/// value of a given type, or with the value taken from \p initialValue.
 OwnedAddress irgen::emitBoxedExistentialContainerAllocation(IRGenFunction &IGF,
                                   SILType destType,
                                   CanType formalSrcType,
-                                ArrayRef<ProtocolConformanceRef> conformances) {
+                                  ArrayRef<ProtocolConformanceRef> conformances,
+                                  Address initialValue) {
   // TODO: Non-Error boxed existentials.
   assert(_isError(destType));
 
@@ -1700,13 +1701,20 @@ OwnedAddress irgen::emitBoxedExistentialContainerAllocation(IRGenFunction &IGF,
   auto witness = emitWitnessTableRef(IGF, formalSrcType, &srcMetadata,
                                      conformances[0]);
   
-  // Call the runtime to allocate the box.
-  // TODO: When there's a store or copy_addr immediately into the box, peephole
-  // it into the initializer parameter to allocError.
+  // Call the runtime to allocate the box. Passing the value lets the runtime
+  // share one box between errors that have the same small value.
+  // TODO: Peephole other stores and copy_addrs into the box, not just the
+  // ones of enum cases without payloads.
+  llvm::Value *initialValuePtr;
+  if (initialValue.isValid())
+    initialValuePtr = IGF.Builder.CreateBitCast(initialValue.getAddress(),
+                                                IGF.IGM.OpaquePtrTy);
+  else
+    initialValuePtr = llvm::ConstantPointerNull::get(IGF.IGM.OpaquePtrTy);
   auto result = IGF.Builder.CreateCall(IGF.IGM.getAllocErrorFn(),
-                         {srcMetadata, witness,
-                           llvm::ConstantPointerNull::get(IGF.IGM.OpaquePtrTy),
-                           llvm::ConstantInt::get(IGF.IGM.Int1Ty, 0)});
+                         {srcMetadata, witness, initialValuePtr,
+                           llvm::ConstantInt::get(IGF.IGM.Int1Ty,
+                                                  initialValue.isValid())});
   
   // Extract the box and value address from the result.
   auto box = IGF.Builder.CreateExtractValue(result, 0);
@@ -1157,7 +1157,12 @@ void irgen::emitFunctionPartialApplication(IRGenFunction &IGF,
                                            CanSILFunctionType origType,
                                            CanSILFunctionType substType,
                                            CanSILFunctionType outType,
+                                           int &StackAllocSize,
                                            Explosion &out) {
+  // Only a context we actually allocate below can live on the stack.
+  int AvailableStackSize = StackAllocSize;
+  StackAllocSize = -1;
+
   // If we have a single Swift-refcounted context value, we can adopt it
   // directly as our closure context without creating a box and thunk.
   enum HasSingleSwiftRefcountedContext { Maybe, Yes, No, Thunkable }
@@ -1371,7 +1376,21 @@ void irgen::emitFunctionPartialApplication(IRGenFunction &IGF,
     // Allocate a new object.
     HeapNonFixedOffsets offsets(IGF, layout);
 
-    data = IGF.emitUnmanagedAlloc(layout, "closure", descriptor, &offsets);
+    // If the closure doesn't escape and the context fits into the remaining
+    // stack budget, allocate it on the stack.
+    if (AvailableStackSize >= 0 && layout.isFixedLayout() &&
+        layout.getSize() <= Size(AvailableStackSize)) {
+      StackAllocSize = layout.getSize().getValue();
+      Address alloca = IGF.createAlloca(layout.getType(),
+                                        layout.getAlignment(),
+                                        "closure.raw");
+      llvm::Value *metadata = layout.getPrivateMetadata(IGF.IGM, descriptor);
+      data = IGF.Builder.CreateBitCast(alloca.getAddress(),
+                                       IGF.IGM.RefCountedPtrTy);
+      data = IGF.emitInitStackObjectCall(metadata, data, "closure");
+    } else {
+      data = IGF.emitUnmanagedAlloc(layout, "closure", descriptor, &offsets);
+    }
     Address dataAddr = layout.emitCastTo(IGF, data);
     
     unsigned i = 0;
@@ -47,6 +47,10 @@ namespace irgen {
 
   /// Emit a partial application thunk for a function pointer applied to a
   /// partial set of argument values.
+  ///
+  /// If \p StackAllocSize is not negative, the context may be allocated on
+  /// the stack if it fits into \p StackAllocSize bytes. On return it holds
+  /// the number of bytes allocated on the stack, or -1 if nothing was.
   void emitFunctionPartialApplication(IRGenFunction &IGF,
                                       SILFunction &SILFn,
                                       llvm::Value *fnPtr,
@@ -57,6 +61,7 @@ namespace irgen {
                                       CanSILFunctionType origType,
                                       CanSILFunctionType substType,
                                       CanSILFunctionType outType,
+                                      int &StackAllocSize,
                                       Explosion &out);
   
 } // end namespace irgen
@@ -1335,9 +1335,56 @@ llvm::Value *IRGenFunction::emitLoadRefcountedPtr(Address addr,
   return Builder.CreateLoad(src);
 }
 
+/// Check the strong reference count of a non-null native object inline,
+/// the way swift_isUniquelyReferenced[OrPinned]_nonNull_native does. This
+/// must agree with the layout of StrongRefCount in SwiftShims/RefCount.h.
+///
+/// The load is volatile so that LLVM doesn't forward or hoist it across
+/// retains and releases, which Swift's alias analysis says don't touch
+/// memory, and so that the LLVM ARC optimizer knows not to move retains
+/// below it.
+static llvm::Value *emitInlineIsUniqueCheck(IRGenFunction &IGF,
+                                            llvm::Value *object,
+                                            bool checkPinned) {
+  // The low bit of the count is the pinned flag and the next one is the
+  // deallocating flag. A count of one is 4.
+  enum : uint32_t {
+    RC_PINNED_FLAG = 0x1,
+    RC_FLAGS_MASK = 0x3,
+    RC_ONE = 0x4
+  };
+
+  auto &IGM = IGF.IGM;
+  Address refCountAddr =
+    IGF.Builder.CreateStructGEP(Address(object, IGM.getPointerAlignment()),
+                                1, IGM.getPointerSize());
+  llvm::LoadInst *refCount = IGF.Builder.CreateLoad(refCountAddr);
+  refCount->setVolatile(true);
+
+  if (!checkPinned) {
+    auto count = IGF.Builder.CreateAnd(refCount,
+                                       ~uint32_t(RC_FLAGS_MASK));
+    return IGF.Builder.CreateICmpEQ(
+        count, llvm::ConstantInt::get(IGM.Int32Ty, RC_ONE));
+  }
+
+  // Rotate the pinned flag into the sign bit. The value is then negative if
+  // the object is pinned, and below RC_ONE if its count is one.
+  static_assert(RC_PINNED_FLAG == 1, "The pinned flag must be the lowest bit");
+  auto rotated = IGF.Builder.CreateOr(IGF.Builder.CreateLShr(refCount, 1),
+                                      IGF.Builder.CreateShl(refCount, 31));
+  return IGF.Builder.CreateICmpSLT(
+      rotated, llvm::ConstantInt::get(IGM.Int32Ty, RC_ONE));
+}
+
 llvm::Value *IRGenFunction::
 emitIsUniqueCall(llvm::Value *value, SourceLoc loc, bool isNonNull,
                  bool checkPinned) {
+  // Non-null native objects are common in the standard library's
+  // copy-on-write buffers, so check them without calling the runtime.
+  if (value->getType() == IGM.RefCountedPtrTy && isNonNull)
+    return emitInlineIsUniqueCheck(*this, value, checkPinned);
+
   llvm::Constant *fn;
   if (value->getType() == IGM.RefCountedPtrTy) {
     if (checkPinned) {
@@ -1484,15 +1484,96 @@ static llvm::Value *emitCallToTypeMetadataAccessFunction(IRGenFunction &IGF,
   return call;
 }
 
+Optional<unsigned> irgen::getTypeMetadataHoistingCost(IRGenModule &IGM,
+                                                      CanType type) {
+  type = getRuntimeReifiedType(IGM, type);
+
+  // Metadata for a non-dependent type is either trivial to access or
+  // produced by a single call to its caching accessor.
+  if (!type->hasArchetype())
+    return isTypeMetadataAccessTrivial(IGM, type) ? 0 : 1;
+
+  if (auto archetype = dyn_cast<ArchetypeType>(type)) {
+    // Opened archetypes are bound in the middle of the function.
+    if (archetype->getOpenedExistentialType())
+      return None;
+
+    // Primary archetypes are bound on entry.
+    if (archetype->isPrimary())
+      return 0;
+
+    // Associated types are fetched through the parent's witness table.
+    auto parentCost =
+      getTypeMetadataHoistingCost(IGM, CanType(archetype->getParent()));
+    if (!parentCost)
+      return None;
+    return *parentCost + 1;
+  }
+
+  // Specialized generic types are instantiated by the runtime from the
+  // metadata for their arguments.
+  if (isa<BoundGenericType>(type)) {
+    unsigned cost = 2;
+    for (Type cur = type; cur; ) {
+      if (auto boundGeneric = cur->getAs<BoundGenericType>()) {
+        for (Type arg : boundGeneric->getGenericArgs()) {
+          auto argCost =
+            getTypeMetadataHoistingCost(IGM, arg->getCanonicalType());
+          if (!argCost)
+            return None;
+          cost += *argCost;
+        }
+        cur = boundGeneric->getParent();
+      } else if (auto nominal = cur->getAs<NominalType>()) {
+        cur = nominal->getParent();
+      } else {
+        break;
+      }
+    }
+    return cost;
+  }
+
+  // Small tuples are instantiated from the metadata for their elements.
+  // Larger ones pass them in a buffer, which we don't bother with.
+  if (auto tuple = dyn_cast<TupleType>(type)) {
+    if (tuple->getNumElements() > 3)
+      return None;
+    unsigned cost = tuple->getNumElements() > 1 ? 2 : 0;
+    for (CanType elt : tuple.getElementTypes()) {
+      auto eltCost = getTypeMetadataHoistingCost(IGM, elt);
+      if (!eltCost)
+        return None;
+      cost += *eltCost;
+    }
+    return cost;
+  }
+
+  return None;
+}
+
 /// Produce the type metadata pointer for the given type.
 llvm::Value *IRGenFunction::emitTypeMetadataRef(CanType type) {
   type = getRuntimeReifiedType(IGM, type);
 
+  // If the request is loop-invariant and cheap enough, make it on entry to
+  // the function instead, so that the result is shared by every block.
+  Optional<TypeDataHoistingScope> hoisting;
+  if (canHoistTypeData() &&
+      !tryGetConcreteLocalTypeData({type,
+                                    LocalTypeDataKind::forTypeMetadata()})) {
+    auto cost = getTypeMetadataHoistingCost(IGM, type);
+    if (cost && shouldHoistTypeData(*cost))
+      hoisting.emplace(*this);
+  }
+
   if (type->hasArchetype() ||
       isTypeMetadataAccessTrivial(IGM, type)) {
     return emitDirectTypeMetadataRef(*this, type);
   }
 
+  if (isa<BoundGenericType>(type))
+    IGM.IRGen.noteGenericMetadataAccess(type);
+
   switch (getTypeMetadataAccessStrategy(IGM, type)) {
   case MetadataAccessStrategy::PublicUniqueAccessor:
   case MetadataAccessStrategy::HiddenUniqueAccessor:
@@ -292,6 +292,12 @@ namespace irgen {
   /// need a cache variable in its accessor.
   bool isTypeMetadataAccessTrivial(IRGenModule &IGM, CanType type);
 
+  /// Estimate the cost of emitting the metadata for the given type at the
+  /// type data hoisting point of a function, or return None if its
+  /// emission may depend on values defined after the entry block.
+  Optional<unsigned> getTypeMetadataHoistingCost(IRGenModule &IGM,
+                                                 CanType type);
+
   /// Determine how the given type metadata should be accessed.
   MetadataAccessStrategy getTypeMetadataAccessStrategy(IRGenModule &IGM,
                                                        CanType type);
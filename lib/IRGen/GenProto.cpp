@@ -1587,7 +1587,8 @@ void WitnessTableBuilder::buildAccessFunction(llvm::Constant *wtable) {
   //    /// The instantiation function, which is called after the template is copied.
   //    RelativeDirectPointer<void(WitnessTable *, const Metadata *)> Instantiator;
   //
-  //    void *PrivateData[swift::NumGenericMetadataPrivateDataWords];
+  //    /// The runtime's cache.
+  //    RelativeDirectPointer<void *> PrivateData;
   //  };
 
   // First, create the global.  We have to build this in two phases because
@@ -1612,6 +1613,19 @@ void WitnessTableBuilder::buildAccessFunction(llvm::Constant *wtable) {
                 LinkEntity::forProtocolDescriptor(Conformance.getProtocol()),
                 IGM.getPointerAlignment(), IGM.ProtocolDescriptorStructTy);
 
+  // The runtime's cache is the only part which is written to at runtime.
+  // Keep it in separate zero-initialized memory, so that the structure itself
+  // can be placed in a read-only section.
+  auto privateDataTy =
+    llvm::ArrayType::get(IGM.Int8PtrTy,
+                         swift::NumGenericMetadataPrivateDataWords);
+  auto privateData =
+    new llvm::GlobalVariable(IGM.Module, privateDataTy, /*constant*/ false,
+                             llvm::GlobalValue::InternalLinkage,
+                             llvm::Constant::getNullValue(privateDataTy),
+                             cache->getName() + "_private");
+  privateData->setAlignment(IGM.getPointerAlignment().getValue());
+
   // Fill in the global.
   auto cacheTy = cast<llvm::StructType>(cache->getValueType());
   llvm::Constant *cacheData[] = {
@@ -1626,9 +1640,11 @@ void WitnessTableBuilder::buildAccessFunction(llvm::Constant *wtable) {
     // Instantiation function
     instantiationFn,
     // Private data
-    llvm::Constant::getNullValue(cacheTy->getStructElementType(5))
+    IGM.emitDirectRelativeReference(privateData, cache, { 5 }),
   };
   cache->setInitializer(llvm::ConstantStruct::get(cacheTy, cacheData));
+  cache->setConstant(true);
+  IGM.setTrueConstGlobal(cache);
 
   auto call = IGF.Builder.CreateCall(IGM.getGetGenericWitnessTableFn(),
                                      { cache, metadata, instantiationArgs });
@@ -2315,7 +2331,37 @@ llvm::Value *irgen::emitWitnessTableRef(IRGenFunction &IGF,
   auto &protoI = IGF.IGM.getProtocolInfo(proto);
   auto &conformanceI =
     protoI.getConformance(IGF.IGM, proto, concreteConformance);
-  return conformanceI.getTable(IGF, srcType, srcMetadataCache);
+  if (auto constantTable = conformanceI.tryGetConstantTable(IGF.IGM, srcType))
+    return constantTable;
+
+  // Otherwise the table comes from an accessor call; remember the result.
+  auto cacheKey = LocalTypeDataKey{srcType,
+          LocalTypeDataKind::forConcreteProtocolWitnessTable(
+                                                    concreteConformance)}
+    .getCachingKey();
+  if (auto cached = IGF.tryGetConcreteLocalTypeData(cacheKey))
+    return cached;
+
+  // If the call is loop-invariant and cheap enough, make it on entry to the
+  // function.  The source metadata has to be emitted there as well.
+  Optional<IRGenFunction::TypeDataHoistingScope> hoisting;
+  llvm::Value *hoistedMetadataCache = nullptr;
+  if (IGF.canHoistTypeData()) {
+    Optional<unsigned> cost = 1;
+    if (srcType->hasArchetype()) {
+      cost = getTypeMetadataHoistingCost(IGF.IGM, srcType);
+      if (cost)
+        *cost += 2;
+    }
+    if (cost && IGF.shouldHoistTypeData(*cost)) {
+      hoisting.emplace(IGF);
+      srcMetadataCache = &hoistedMetadataCache;
+    }
+  }
+
+  auto wtable = conformanceI.getTable(IGF, srcType, srcMetadataCache);
+  IGF.setScopedLocalTypeData(cacheKey, wtable);
+  return wtable;
 }
 
 /// Emit the witness table references required for the given type
@@ -28,6 +28,7 @@
 #include "GenEnum.h"
 #include "GenHeap.h"
 #include "GenProto.h"
+#include "GenStruct.h"
 #include "IRGenModule.h"
 #include "Linking.h"
 #include "LoadableTypeInfo.h"
@@ -416,8 +417,18 @@ class FieldTypeMetadataBuilder : public ReflectionMetadataBuilder {
       return;
     }
 
-    auto properties = NTD->getStoredProperties();
-    addConstantInt32(std::distance(properties.begin(), properties.end()));
+    // Remote mirrors lay out the fields in the order they appear in the
+    // descriptor, so structs list them in memory order.
+    SmallVector<VarDecl *, 8> properties;
+    if (auto SD = dyn_cast<StructDecl>(NTD)) {
+      getPhysicalStructFieldsInLayoutOrder(IGM, const_cast<StructDecl *>(SD),
+                                           properties);
+    } else {
+      for (auto property : NTD->getStoredProperties())
+        properties.push_back(property);
+    }
+
+    addConstantInt32(properties.size());
     for (auto property : properties)
       addFieldDecl(property,
                    property->getInterfaceType()
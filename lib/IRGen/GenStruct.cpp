@@ -31,6 +31,7 @@
 #include "GenMeta.h"
 #include "GenRecord.h"
 #include "GenType.h"
+#include "IRGenDebugInfo.h"
 #include "IRGenFunction.h"
 #include "IRGenModule.h"
 #include "Linking.h"
@@ -107,6 +108,10 @@ namespace {
      public RecordTypeInfo<Impl, Base, FieldInfoType> {
     typedef RecordTypeInfo<Impl, Base, FieldInfoType> super;
 
+    /// The index of the field whose extra inhabitants are used as the
+    /// struct's own.
+    unsigned ExtraInhabitantFieldIndex = 0;
+
   protected:
     template <class... As>
     StructTypeInfoBase(StructTypeInfoKind kind, As &&...args)
@@ -190,17 +195,63 @@ namespace {
       return fieldInfo.getStructIndex();
     }
 
-    // For now, just use extra inhabitants from the first field.
-    // FIXME: generalize
+    /// Collect the stored properties in the order in which they are laid
+    /// out in memory.
+    void getFieldsInLayoutOrder(IRGenModule &IGM,
+                                SmallVectorImpl<VarDecl *> &out) const {
+      SmallVector<const FieldInfoType *, 8> fields;
+      for (auto &fieldInfo : asImpl().getFields()) {
+        // Fields at non-fixed offsets are always in declaration order.
+        if (fieldInfo.getKind() != ElementLayout::Kind::Fixed &&
+            fieldInfo.getKind() != ElementLayout::Kind::Empty)
+          return;
+        if (fieldInfo.Field)
+          fields.push_back(&fieldInfo);
+      }
+
+      std::stable_sort(fields.begin(), fields.end(),
+                       [](const FieldInfoType *a, const FieldInfoType *b) {
+        return a->getFixedByteOffset() < b->getFixedByteOffset();
+      });
+
+      out.clear();
+      for (auto *fieldInfo : fields)
+        out.push_back(fieldInfo->Field);
+    }
+
+    /// Use the extra inhabitants of the given field instead of the first
+    /// field's.  This is only valid if no other module computes the
+    /// struct's layout.
+    void setExtraInhabitantFieldIndex(unsigned index) {
+      assert(index < asImpl().getFields().size());
+      ExtraInhabitantFieldIndex = index;
+    }
+
+    // By default, just use extra inhabitants from the first field.
+    const FieldInfoType &getExtraInhabitantField() const {
+      return asImpl().getFields()[ExtraInhabitantFieldIndex];
+    }
+
+    /// Return the bit offset of the extra inhabitant field in the struct,
+    /// which is nonzero only if the fields have been reordered.
+    unsigned getExtraInhabitantFieldBitOffset() const {
+      auto &field = getExtraInhabitantField();
+      if (field.getKind() != ElementLayout::Kind::Fixed)
+        return 0;
+      return field.getFixedByteOffset().getValueInBits();
+    }
+
     bool mayHaveExtraInhabitants(IRGenModule &IGM) const override {
       if (asImpl().getFields().empty()) return false;
-      return asImpl().getFields()[0].getTypeInfo().mayHaveExtraInhabitants(IGM);
+      return getExtraInhabitantField().getTypeInfo()
+        .mayHaveExtraInhabitants(IGM);
     }
 
     // This is dead code in NonFixedStructTypeInfo.
     unsigned getFixedExtraInhabitantCount(IRGenModule &IGM) const {
       if (asImpl().getFields().empty()) return 0;
-      auto &fieldTI = cast<FixedTypeInfo>(asImpl().getFields()[0].getTypeInfo());
+      auto &fieldTI =
+        cast<FixedTypeInfo>(getExtraInhabitantField().getTypeInfo());
       return fieldTI.getFixedExtraInhabitantCount(IGM);
     }
 
@@ -208,8 +259,17 @@ namespace {
     APInt getFixedExtraInhabitantValue(IRGenModule &IGM,
                                        unsigned bits,
                                        unsigned index) const {
-      auto &fieldTI = cast<FixedTypeInfo>(asImpl().getFields()[0].getTypeInfo());
-      return fieldTI.getFixedExtraInhabitantValue(IGM, bits, index);
+      auto &fieldTI =
+        cast<FixedTypeInfo>(getExtraInhabitantField().getTypeInfo());
+      unsigned offset = getExtraInhabitantFieldBitOffset();
+      if (offset == 0)
+        return fieldTI.getFixedExtraInhabitantValue(IGM, bits, index);
+
+      // Move the field's bit pattern to where the field is in the struct.
+      unsigned fieldBits = fieldTI.getFixedSize().getValueInBits();
+      APInt value = fieldTI.getFixedExtraInhabitantValue(IGM, fieldBits, index);
+      value = value.zext(std::max(bits, offset + fieldBits)).shl(offset);
+      return value.zextOrTrunc(bits);
     }
 
     // This is dead code in NonFixedStructTypeInfo.
@@ -217,25 +277,27 @@ namespace {
       if (asImpl().getFields().empty())
         return APInt();
       
-      // Currently we only use the first field's extra inhabitants. The other
-      // fields can be ignored.
+      // We only use one field's extra inhabitants. The other fields can be
+      // ignored.
+      auto &field = getExtraInhabitantField();
       const FixedTypeInfo &fieldTI
-        = cast<FixedTypeInfo>(asImpl().getFields()[0].getTypeInfo());
+        = cast<FixedTypeInfo>(field.getTypeInfo());
       auto targetSize = asImpl().getFixedSize().getValueInBits();
       
       if (fieldTI.isKnownEmpty(ResilienceExpansion::Maximal))
         return APInt(targetSize, 0);
       
       APInt fieldMask = fieldTI.getFixedExtraInhabitantMask(IGM);
+      unsigned offset = getExtraInhabitantFieldBitOffset();
       if (targetSize > fieldMask.getBitWidth())
         fieldMask = fieldMask.zext(targetSize);
-      return fieldMask;
+      return fieldMask.shl(offset);
     }
 
     llvm::Value *getExtraInhabitantIndex(IRGenFunction &IGF,
                                          Address structAddr,
                                          SILType structType) const override {
-      auto &field = asImpl().getFields()[0];
+      auto &field = getExtraInhabitantField();
       Address fieldAddr =
         asImpl().projectFieldAddress(IGF, structAddr, structType, field.Field);
       return field.getTypeInfo().getExtraInhabitantIndex(IGF, fieldAddr,
@@ -246,7 +308,7 @@ namespace {
                               llvm::Value *index,
                               Address structAddr,
                               SILType structType) const override {
-      auto &field = asImpl().getFields()[0];
+      auto &field = getExtraInhabitantField();
       Address fieldAddr =
         asImpl().projectFieldAddress(IGF, structAddr, structType, field.Field);
       field.getTypeInfo().storeExtraInhabitant(IGF, index, fieldAddr,
@@ -526,10 +588,49 @@ namespace {
       RecordTypeBuilder(IGM), StructTy(structTy), TheStruct(type) {
     }
 
+    /// Can we lay out this struct's fields in an order other than the
+    /// declaration order?  The runtime, reflection metadata and other
+    /// modules all assume declaration order, so we only reorder structs
+    /// whose layout is never computed outside of this module.
+    bool canReorderFields() const {
+      if (!IGM.IRGen.Opts.EnableStructFieldReordering)
+        return false;
+
+      auto decl = TheStruct->getStructOrBoundGenericStruct();
+      if (!decl || decl->hasClangNode() || decl->isGenericContext())
+        return false;
+      if (decl->getEffectiveAccess() >= Accessibility::Public)
+        return false;
+      if (decl->getAttrs().hasAttribute<VersionedAttr>() ||
+          decl->getAttrs().hasAttribute<FixedLayoutAttr>())
+        return false;
+      return true;
+    }
+
+    /// If the fields were reordered, take extra inhabitants from the field
+    /// with the most of them instead of from the first field.
+    template <class TI>
+    TI *chooseExtraInhabitantField(TI *ti, ArrayRef<StructFieldInfo> fields) {
+      if (!canReorderFields())
+        return ti;
+
+      unsigned bestIndex = 0, bestCount = 0;
+      for (unsigned i = 0, e = fields.size(); i != e; ++i) {
+        auto &fieldTI = cast<FixedTypeInfo>(fields[i].getTypeInfo());
+        unsigned count = fieldTI.getFixedExtraInhabitantCount(IGM);
+        if (count > bestCount) {
+          bestIndex = i;
+          bestCount = count;
+        }
+      }
+      ti->setExtraInhabitantFieldIndex(bestIndex);
+      return ti;
+    }
+
     LoadableStructTypeInfo *createLoadable(ArrayRef<StructFieldInfo> fields,
                                            StructLayout &&layout,
                                            unsigned explosionSize) {
-      return LoadableStructTypeInfo::create(fields,
+      auto ti = LoadableStructTypeInfo::create(fields,
                                             explosionSize,
                                             layout.getType(),
                                             layout.getSize(),
@@ -537,17 +638,19 @@ namespace {
                                             layout.getAlignment(),
                                             layout.isPOD(),
                                             layout.isAlwaysFixedSize());
+      return chooseExtraInhabitantField(ti, fields);
     }
 
     FixedStructTypeInfo *createFixed(ArrayRef<StructFieldInfo> fields,
                                      StructLayout &&layout) {
-      return FixedStructTypeInfo::create(fields, layout.getType(),
-                                         layout.getSize(),
-                                         std::move(layout.getSpareBits()),
-                                         layout.getAlignment(),
-                                         layout.isPOD(),
-                                         layout.isBitwiseTakable(),
-                                         layout.isAlwaysFixedSize());
+      auto ti = FixedStructTypeInfo::create(fields, layout.getType(),
+                                            layout.getSize(),
+                                            std::move(layout.getSpareBits()),
+                                            layout.getAlignment(),
+                                            layout.isPOD(),
+                                            layout.isBitwiseTakable(),
+                                            layout.isAlwaysFixedSize());
+      return chooseExtraInhabitantField(ti, fields);
     }
 
     NonFixedStructTypeInfo *createNonFixed(ArrayRef<StructFieldInfo> fields,
@@ -570,8 +673,10 @@ namespace {
     }
 
     StructLayout performLayout(ArrayRef<const TypeInfo *> fieldTypes) {
+      auto strategy = canReorderFields() ? LayoutStrategy::Reordered
+                                         : LayoutStrategy::Optimal;
       return StructLayout(IGM, TheStruct, LayoutKind::NonHeapObject,
-                          LayoutStrategy::Optimal, fieldTypes, StructTy);
+                          strategy, fieldTypes, StructTy);
     }
   };
 
@@ -836,10 +941,41 @@ unsigned irgen::getPhysicalStructFieldIndex(IRGenModule &IGM, SILType baseType,
   FOR_STRUCT_IMPL(IGM, baseType, getFieldIndex, field);
 }
 
+void irgen::getPhysicalStructFieldsInLayoutOrder(IRGenModule &IGM,
+                                                StructDecl *decl,
+                                          SmallVectorImpl<VarDecl *> &fields) {
+  fields.clear();
+  for (auto *field : decl->getStoredProperties())
+    fields.push_back(field);
+
+  // Only concrete native structs have their fields reordered.
+  if (decl->hasClangNode() || decl->isGenericContext())
+    return;
+
+  auto baseType = IGM.getLoweredType(decl->getDeclaredTypeInContext());
+  auto &structTI = IGM.getTypeInfo(baseType);
+  switch (getStructTypeInfoKind(structTI)) {
+  case StructTypeInfoKind::LoadableStructTypeInfo:
+    return structTI.as<LoadableStructTypeInfo>()
+             .getFieldsInLayoutOrder(IGM, fields);
+  case StructTypeInfoKind::FixedStructTypeInfo:
+    return structTI.as<FixedStructTypeInfo>()
+             .getFieldsInLayoutOrder(IGM, fields);
+  case StructTypeInfoKind::ClangRecordTypeInfo:
+  case StructTypeInfoKind::NonFixedStructTypeInfo:
+  case StructTypeInfoKind::ResilientStructTypeInfo:
+    return;
+  }
+  llvm_unreachable("bad struct type info kind");
+}
+
 void IRGenModule::emitStructDecl(StructDecl *st) {
   emitStructMetadata(*this, st);
   emitNestedTypeDecls(st->getMembers());
 
+  if (DebugInfo)
+    DebugInfo->emitTypeDecl(st);
+
   if (shouldEmitOpaqueTypeMetadataRecord(st)) {
     emitOpaqueTypeMetadataRecord(st);
     return;
@@ -19,11 +19,13 @@
 
 namespace llvm {
   class Constant;
+  template <class T> class SmallVectorImpl;
 }
 
 namespace swift {
   class CanType;
   class SILType;
+  class StructDecl;
   class VarDecl;
 
 namespace irgen {
@@ -59,6 +61,12 @@ namespace irgen {
   unsigned getPhysicalStructFieldIndex(IRGenModule &IGM, SILType baseType,
                                        VarDecl *field);
 
+  /// Collect the stored properties of the given struct in the order in which
+  /// they are laid out in memory.  This is declaration order unless the
+  /// struct's fields were reordered.
+  void getPhysicalStructFieldsInLayoutOrder(IRGenModule &IGM, StructDecl *decl,
+                                   llvm::SmallVectorImpl<VarDecl *> &fields);
+
 } // end namespace irgen
 } // end namespace swift
 
@@ -24,6 +24,8 @@
 #include "swift/Basic/Defer.h"
 #include "swift/Basic/Dwarf.h"
 #include "swift/Basic/Platform.h"
+#include "swift/Basic/Statistic.h"
+#include "swift/Basic/TaskQueue.h"
 #include "swift/Basic/Timer.h"
 #include "swift/Basic/Version.h"
 #include "swift/ClangImporter/ClangImporter.h"
@@ -40,6 +42,7 @@
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/IRReader/IRReader.h"
 #include "llvm/Linker/Linker.h"
 #include "llvm/MC/SubtargetFeature.h"
 #include "llvm/Support/Debug.h"
@@ -50,6 +53,8 @@
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Mutex.h"
 #include "llvm/Support/MD5.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/ADT/StringSet.h"
 #include "llvm/Analysis/AliasAnalysis.h"
 #include "llvm/Target/TargetMachine.h"
@@ -58,6 +63,8 @@
 #include "llvm/Transforms/IPO.h"
 #include "llvm/Transforms/IPO/PassManagerBuilder.h"
 #include "llvm/Transforms/ObjCARC.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
 #include "llvm/Object/ObjectFile.h"
 #include "IRGenModule.h"
 
@@ -223,8 +230,11 @@ void swift::performLLVMOptimizations(IRGenOptions &Opts, llvm::Module *Module,
       TargetMachine->getTargetIRAnalysis()));
 
   // If we're generating a profile, add the lowering pass now.
-  if (Opts.GenerateProfile)
+  if (Opts.GenerateProfile) {
     ModulePasses.add(createInstrProfilingLegacyPass());
+    if (Opts.ProfileFirstHit)
+      ModulePasses.add(createSwiftProfileFirstHitPass());
+  }
 
   PMBuilder.populateModulePassManager(ModulePasses);
 
@@ -291,6 +301,9 @@ static void getHashOfModule(MD5::MD5Result &Result, IRGenOptions &Opts,
   // reflected in the llvm module itself.
   HashStream << Opts.getLLVMCodeGenOptionsHash();
 
+  // The code of a partitioned compilation is spread over all its outputs.
+  HashStream << Opts.CodeGenPartitionOutputs.size();
+
   HashStream.final(Result);
 }
 
@@ -344,6 +357,20 @@ static bool needsRecompile(StringRef OutputFilename, ArrayRef<uint8_t> HashData,
   return true;
 }
 
+/// Counts the defined functions and instructions in \p Module.
+static void countLLVMModule(const llvm::Module &Module, size_t &NumFunctions,
+                            size_t &NumInstructions) {
+  NumFunctions = 0;
+  NumInstructions = 0;
+  for (const llvm::Function &F : Module) {
+    if (F.isDeclaration())
+      continue;
+    ++NumFunctions;
+    for (const llvm::BasicBlock &BB : F)
+      NumInstructions += BB.size();
+  }
+}
+
 /// Run the LLVM passes. In multi-threaded compilation this will be done for
 /// multiple LLVM modules in parallel.
 static bool performLLVM(IRGenOptions &Opts, DiagnosticEngine &Diags,
@@ -582,6 +609,164 @@ static void embedBitcode(llvm::Module *M, const IRGenOptions &Opts)
   NewUsed->setSection("llvm.metadata");
 }
 
+/// Returns the number of threads to use for code generation of
+/// \p NumPartitions partitions. If the driver reports how many of its task
+/// slots are idle, use one thread for this job plus one for each idle slot.
+static unsigned getNumCodeGenThreads(unsigned NumPartitions) {
+  const char *IdleSlotsStr = ::getenv(swift::sys::TaskQueueIdleSlotsEnvVar);
+  if (!IdleSlotsStr)
+    return NumPartitions;
+
+  unsigned IdleSlots;
+  if (StringRef(IdleSlotsStr).getAsInteger(10, IdleSlots))
+    return 1;
+  return std::min(NumPartitions, 1 + IdleSlots);
+}
+
+/// Returns true if the driver asked for the object file to be generated in
+/// partitions.
+static bool shouldPartitionCodeGen(const IRGenOptions &Opts) {
+  return !Opts.CodeGenPartitionOutputs.empty() &&
+         Opts.OutputKind == IRGenOutputKind::ObjectFile && !Opts.UseJIT;
+}
+
+/// Run the LLVM passes on \p Module and split its code generation into
+/// partitions, one for the primary output file and for each of the
+/// CodeGenPartitionOutputs. The partitions are compiled on as many threads as
+/// the driver has idle task slots.
+///
+/// As in performLLVM, code generation is skipped if \p HashGlobal is given
+/// and the existing outputs were generated from the same llvm IR. With
+/// -embed-bitcode each object file embeds the bitcode of its own partition.
+///
+/// \returns true on error
+static bool performPartitionedLLVM(IRGenOptions &Opts, ASTContext &Ctx,
+                                   llvm::GlobalVariable *HashGlobal,
+                                   std::unique_ptr<llvm::Module> Module,
+                                   llvm::TargetMachine *TargetMachine,
+                                   StringRef OutputFilename) {
+  SmallVector<StringRef, 4> OutputFilenames;
+  OutputFilenames.push_back(OutputFilename);
+  OutputFilenames.append(Opts.CodeGenPartitionOutputs.begin(),
+                         Opts.CodeGenPartitionOutputs.end());
+
+  if (Opts.UseIncrementalLLVMCodeGen && HashGlobal) {
+    MD5::MD5Result Result;
+    getHashOfModule(Result, Opts, Module.get(), TargetMachine,
+                    Ctx.LangOpts.EffectiveLanguageVersion);
+    ArrayRef<uint8_t> HashData(Result, sizeof(MD5::MD5Result));
+
+    // The hash ends up in whichever partition the hash global was put into,
+    // and the other outputs of the same compilation must still be there.
+    bool AllOutputsExist = true;
+    bool HashMatches = false;
+    for (StringRef Filename : OutputFilenames) {
+      if (!llvm::sys::fs::exists(Filename)) {
+        AllOutputsExist = false;
+        break;
+      }
+      if (!HashMatches &&
+          !needsRecompile(Filename, HashData, HashGlobal, nullptr))
+        HashMatches = true;
+    }
+    if (AllOutputsExist && HashMatches && !Opts.PrintInlineTree) {
+      // The llvm IR did not change. We don't need to re-create the objects.
+      return false;
+    }
+
+    auto *HashConstant = ConstantDataArray::get(Module->getContext(), HashData);
+    HashGlobal->setInitializer(HashConstant);
+  }
+
+  std::vector<std::unique_ptr<raw_fd_ostream>> OutputStreams;
+  for (StringRef Filename : OutputFilenames) {
+    std::error_code EC;
+    OutputStreams.emplace_back(
+        new raw_fd_ostream(Filename, EC, llvm::sys::fs::F_None));
+    if (OutputStreams.back()->has_error() || EC) {
+      Ctx.Diags.diagnose(SourceLoc(), diag::error_opening_output,
+                         Filename, EC.message());
+      OutputStreams.back()->clear_error();
+      return true;
+    }
+  }
+
+  // The module-level optimizations are not split up.
+  performLLVMOptimizations(Opts, Module.get(), TargetMachine);
+  if (Opts.Optimize) {
+    // See performLLVM.
+    legacy::PassManager ARCContractPasses;
+    ARCContractPasses.add(createObjCARCContractPass());
+    ARCContractPasses.run(*Module);
+  }
+
+  SharedTimer timer("LLVM output");
+
+  // As in llvm::splitCodeGen, the partitions are handed over to the threads
+  // as bitcode, because each thread needs an LLVMContext of its own. Unlike
+  // splitCodeGen, this lets us embed each partition's bitcode in its object.
+  SmallVector<SmallString<0>, 4> PartitionBitcode;
+  llvm::SplitModule(std::move(Module), OutputFilenames.size(),
+                    [&](std::unique_ptr<llvm::Module> Partition) {
+    PartitionBitcode.emplace_back();
+    raw_svector_ostream BitcodeOS(PartitionBitcode.back());
+    llvm::WriteBitcodeToFile(Partition.get(), BitcodeOS);
+  });
+  assert(PartitionBitcode.size() == OutputFilenames.size());
+
+  llvm::sys::Mutex Mutex;
+  bool HadError = false;
+  {
+    llvm::ThreadPool Pool(getNumCodeGenThreads(OutputFilenames.size()));
+    for (unsigned i = 0, e = OutputFilenames.size(); i != e; ++i) {
+      Pool.async([&, i] {
+        llvm::LLVMContext Context;
+        llvm::SMDiagnostic Err;
+        std::unique_ptr<llvm::Module> Partition = llvm::parseIR(
+            llvm::MemoryBufferRef(PartitionBitcode[i], OutputFilenames[i]),
+            Err, Context);
+        if (!Partition)
+          llvm::report_fatal_error("failed to read back a module partition");
+
+        embedBitcode(Partition.get(), Opts);
+
+        std::unique_ptr<llvm::TargetMachine> PartitionTargetMachine;
+        {
+          llvm::sys::ScopedLock Lock(Mutex);
+          PartitionTargetMachine = createTargetMachine(Opts, Ctx);
+        }
+
+        legacy::PassManager EmitPasses;
+        if (!PartitionTargetMachine ||
+            PartitionTargetMachine->addPassesToEmitFile(
+                EmitPasses, *OutputStreams[i],
+                llvm::TargetMachine::CGFT_ObjectFile, !Opts.Verify)) {
+          llvm::sys::ScopedLock Lock(Mutex);
+          Ctx.Diags.diagnose(SourceLoc(), diag::error_codegen_init_fail);
+          HadError = true;
+          return;
+        }
+        EmitPasses.run(*Partition);
+      });
+    }
+    Pool.wait();
+  }
+
+  // Make sure that the objects were completely written, so that the driver
+  // doesn't go on and link a truncated object.
+  for (unsigned i = 0, e = OutputStreams.size(); i != e; ++i) {
+    OutputStreams[i]->close();
+    if (OutputStreams[i]->has_error()) {
+      Ctx.Diags.diagnose(SourceLoc(), diag::error_opening_output,
+                         OutputFilenames[i],
+                         std::make_error_code(std::errc::io_error).message());
+      OutputStreams[i]->clear_error();
+      HadError = true;
+    }
+  }
+  return HadError;
+}
+
 static void initLLVMModule(const IRGenModule &IGM) {
   auto *Module = IGM.getModule();
   assert(Module && "Expected llvm:Module for IR generation!");
@@ -648,6 +833,8 @@ static std::unique_ptr<llvm::Module> performIRGeneration(IRGenOptions &Opts,
       IGM.emitReflectionMetadataVersion();
     }
 
+    irgen.emitGenericMetadataWarming();
+
     // Okay, emit any definitions that we suddenly need.
     irgen.emitLazyDefinitions();
 
@@ -695,6 +882,22 @@ static std::unique_ptr<llvm::Module> performIRGeneration(IRGenOptions &Opts,
   // Wait for the thread to terminate.
   SWIFT_DEFER { Thread.join(); };
 
+  if (auto *Stats = Ctx.Stats) {
+    auto &C = Stats->getFrontendCounters();
+    countLLVMModule(*IGM.getModule(), C.NumIRFunctions, C.NumIRInstructions);
+    Stats->noteCurrentMemoryUsage();
+  }
+
+  // Split code generation into partitions if the driver asked for it. The
+  // module can't be returned in this case, because it is consumed by the
+  // partitioning. The partitions embed their own bitcode.
+  if (shouldPartitionCodeGen(Opts)) {
+    performPartitionedLLVM(Opts, Ctx, IGM.ModuleHash,
+                           std::unique_ptr<llvm::Module>(IGM.releaseModule()),
+                           IGM.TargetMachine.get(), IGM.OutputFilename);
+    return nullptr;
+  }
+
   embedBitcode(IGM.getModule(), Opts);
 
   if (performLLVM(Opts, IGM.Context.Diags, nullptr, IGM.ModuleHash,
@@ -703,6 +906,13 @@ static std::unique_ptr<llvm::Module> performIRGeneration(IRGenOptions &Opts,
                   IGM.OutputFilename))
     return nullptr;
 
+  if (auto *Stats = Ctx.Stats) {
+    size_t NumFunctions;
+    countLLVMModule(*IGM.getModule(), NumFunctions,
+                    Stats->getFrontendCounters().NumLLVMInstructions);
+    Stats->noteCurrentMemoryUsage();
+  }
+
   return std::unique_ptr<llvm::Module>(IGM.releaseModule());
 }
 
@@ -817,6 +1027,8 @@ static void performParallelIRGeneration(IRGenOptions &Opts,
   // Emit reflection metadata for builtin and imported types.
   irgen.emitBuiltinReflectionMetadata();
 
+  irgen.emitGenericMetadataWarming();
+
   // Okay, emit any definitions that we suddenly need.
   irgen.emitLazyDefinitions();
   
@@ -1008,6 +1220,14 @@ bool swift::performLLVM(IRGenOptions &Opts, ASTContext &Ctx,
   if (!TargetMachine)
     return true;
 
+  // The backend job of -embed-bitcode builds is split up like the compile
+  // jobs of other builds.
+  if (shouldPartitionCodeGen(Opts))
+    return performPartitionedLLVM(Opts, Ctx, nullptr,
+                                  llvm::CloneModule(Module),
+                                  TargetMachine.get(),
+                                  Opts.getSingleOutputFilename());
+
   embedBitcode(Module, Opts);
   if (::performLLVM(Opts, Ctx.Diags, nullptr, nullptr, Module,
                     TargetMachine.get(),
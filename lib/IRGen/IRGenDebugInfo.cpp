@@ -17,6 +17,7 @@
 #define DEBUG_TYPE "debug-info"
 #include "IRGenDebugInfo.h"
 #include "GenOpaque.h"
+#include "GenStruct.h"
 #include "GenType.h"
 #include "Linking.h"
 #include "swift/AST/Expr.h"
@@ -808,6 +809,19 @@ llvm::DISubprogram *IRGenDebugInfo::emitFunction(SILFunction &SILFn,
                       SILFn.getDeclContext());
 }
 
+void IRGenDebugInfo::emitTypeDecl(NominalTypeDecl *Decl) {
+  // Only -gdwarf-types describes members, and a generic type has no single
+  // layout to describe.
+  if (Opts.DebugInfoKind <= IRGenDebugInfoKind::ASTTypes ||
+      Decl->isGenericContext())
+    return;
+
+  Type Ty = Decl->getDeclaredInterfaceType();
+  DebugTypeInfo DbgTy(Ty, IGM.getTypeInfoForUnlowered(Ty),
+                      Decl->getDeclContext());
+  DBuilder.retainType(getOrCreateType(DbgTy));
+}
+
 void IRGenDebugInfo::emitArtificialFunction(IRBuilder &Builder,
                                             llvm::Function *Fn, SILType SILTy) {
   RegularLocation ALoc = RegularLocation::getAutoGeneratedLocation();
@@ -1079,7 +1093,22 @@ IRGenDebugInfo::getStructMembers(NominalTypeDecl *D, Type BaseTy,
                                  unsigned Flags, unsigned &SizeInBits) {
   SmallVector<llvm::Metadata *, 16> Elements;
   unsigned OffsetInBits = 0;
-  for (VarDecl *VD : D->getStoredProperties()) {
+  unsigned SizeOfByte = CI.getTargetInfo().getCharWidth();
+
+  // Describe the members in memory order and at their physical offsets;
+  // stored properties are not necessarily laid out in declaration order.
+  SmallVector<VarDecl *, 16> Fields;
+  auto *SD = dyn_cast<StructDecl>(D);
+  if (SD)
+    getPhysicalStructFieldsInLayoutOrder(IGM, SD, Fields);
+  else
+    for (VarDecl *VD : D->getStoredProperties())
+      Fields.push_back(VD);
+  bool HasFixedOffsets = SD && !SD->isGenericContext() &&
+                         !SD->hasClangNode() &&
+                         IGM.getTypeInfoForUnlowered(BaseTy).isFixedSize();
+
+  for (VarDecl *VD : Fields) {
     auto memberTy =
         BaseTy->getTypeOfMember(IGM.getSwiftModule(), VD, nullptr);
     DebugTypeInfo DbgTy(
@@ -1087,6 +1116,11 @@ IRGenDebugInfo::getStructMembers(NominalTypeDecl *D, Type BaseTy,
         IGM.getTypeInfoForUnlowered(IGM.getSILTypes().getAbstractionPattern(VD),
                                     memberTy),
         nullptr);
+    if (HasFixedOffsets)
+      if (auto *Offset = dyn_cast_or_null<llvm::ConstantInt>(
+              emitPhysicalStructMemberFixedOffset(
+                  IGM, IGM.getLoweredType(BaseTy), VD)))
+        OffsetInBits = SizeOfByte * Offset->getZExtValue();
     Elements.push_back(createMemberType(DbgTy, VD->getName().str(),
                                         OffsetInBits, Scope, File, Flags));
   }
@@ -1358,6 +1392,28 @@ IRGenDebugInfo::createOpaqueStruct(llvm::DIScope *Scope, StringRef Name,
       llvm::dwarf::DW_LANG_Swift, nullptr, MangledName);
 }
 
+bool IRGenDebugInfo::shouldEmitFullType(NominalTypeDecl *Decl) {
+  // Nobody else describes imported Clang types.
+  if (Decl->hasClangNode())
+    return true;
+
+  // Another module may not have been built with -gdwarf-types, so there is
+  // no telling whether its object files describe the type.
+  if (Decl->getModuleContext() != IGM.getSwiftModule())
+    return true;
+
+  // Each source file may go to its own object file in a multi-threaded
+  // whole-module build...
+  if (IGM.IRGen.getGenModule(Decl) != &IGM)
+    return false;
+
+  // ...or only one of them is being compiled.
+  auto *DeclSF = Decl->getDeclContext()->getParentSourceFile();
+  auto *PrimarySF =
+    dyn_cast_or_null<SourceFile>(IGM.getSILModule().getAssociatedContext());
+  return !DeclSF || !PrimarySF || DeclSF == PrimarySF;
+}
+
 llvm::DIType *IRGenDebugInfo::createType(DebugTypeInfo DbgTy,
                                          StringRef MangledName,
                                          llvm::DIScope *Scope,
@@ -1453,14 +1509,16 @@ llvm::DIType *IRGenDebugInfo::createType(DebugTypeInfo DbgTy,
     auto *Decl = StructTy->getDecl();
     auto L = getDebugLoc(SM, Decl);
     auto *File = getOrCreateFile(L.Filename);
-    if (Opts.DebugInfoKind > IRGenDebugInfoKind::ASTTypes)
-      return createStructType(DbgTy, Decl, StructTy, Scope, File, L.Line,
-                              SizeInBits, AlignInBits, Flags,
-                              nullptr, // DerivedFrom
-                              llvm::dwarf::DW_LANG_Swift, MangledName);
-    else
-      return createOpaqueStruct(Scope, Decl->getName().str(), File, L.Line,
-                                SizeInBits, AlignInBits, Flags, MangledName);
+    if (Opts.DebugInfoKind > IRGenDebugInfoKind::ASTTypes) {
+      if (MangledName.empty() || shouldEmitFullType(Decl))
+        return createStructType(DbgTy, Decl, StructTy, Scope, File, L.Line,
+                                SizeInBits, AlignInBits, Flags,
+                                nullptr, // DerivedFrom
+                                llvm::dwarf::DW_LANG_Swift, MangledName);
+      Flags |= llvm::DINode::FlagFwdDecl;
+    }
+    return createOpaqueStruct(Scope, Decl->getName().str(), File, L.Line,
+                              SizeInBits, AlignInBits, Flags, MangledName);
   }
 
   case TypeKind::Class: {
@@ -1645,12 +1703,14 @@ llvm::DIType *IRGenDebugInfo::createType(DebugTypeInfo DbgTy,
     auto *Decl = EnumTy->getDecl();
     auto L = getDebugLoc(SM, Decl);
     auto *File = getOrCreateFile(L.Filename);
-    if (Opts.DebugInfoKind > IRGenDebugInfoKind::ASTTypes)
-      return createEnumType(DbgTy, Decl, MangledName, Scope, File, L.Line,
-                            Flags);
-    else
-      return createOpaqueStruct(Scope, Decl->getName().str(), File, L.Line,
-                                SizeInBits, AlignInBits, Flags, MangledName);
+    if (Opts.DebugInfoKind > IRGenDebugInfoKind::ASTTypes) {
+      if (MangledName.empty() || shouldEmitFullType(Decl))
+        return createEnumType(DbgTy, Decl, MangledName, Scope, File, L.Line,
+                              Flags);
+      Flags |= llvm::DINode::FlagFwdDecl;
+    }
+    return createOpaqueStruct(Scope, Decl->getName().str(), File, L.Line,
+                              SizeInBits, AlignInBits, Flags, MangledName);
   }
 
   case TypeKind::BoundGenericEnum: {
@@ -153,6 +153,10 @@ public:
   ///
   void emitImport(ImportDecl *D);
 
+  /// Emit the full DWARF description of a struct or enum declared in the
+  /// file being compiled, whether or not anything in the file uses it.
+  void emitTypeDecl(NominalTypeDecl *Decl);
+
   /// Emit debug info for the given function.
   /// \param DS The parent scope of the function.
   /// \param Fn The IR representation of the function.
@@ -330,6 +334,12 @@ private:
                             unsigned SizeInBits, unsigned AlignInBits,
                             unsigned Flags, StringRef MangledName);
 
+  /// Returns true if the full DWARF type of \p Decl is emitted into this
+  /// object file. The other object files of the declaring module only emit
+  /// a declaration with its mangled name, so that each type of the module
+  /// is described once.
+  bool shouldEmitFullType(NominalTypeDecl *Decl);
+
   /// Create an opaque struct with a mangled name.
   llvm::DIType *createOpaqueStruct(llvm::DIScope *Scope, StringRef Name,
                                    llvm::DIFile *File, unsigned Line,
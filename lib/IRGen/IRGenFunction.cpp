@@ -19,6 +19,7 @@
 #include "swift/Basic/SourceLoc.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/Function.h"
+#include "llvm/IR/Intrinsics.h"
 #include "llvm/Support/raw_ostream.h"
 
 #include "Explosion.h"
@@ -217,6 +218,34 @@ void IRGenFunction::emitDeallocRawCall(llvm::Value *pointer,
                               {pointer, size, alignMask});
 }
 
+Address IRGenFunction::emitDynamicAlloca(llvm::Value *size, Alignment align,
+                                         const llvm::Twine &name) {
+  // Unlike createAlloca, allocate at the current insertion point: the size
+  // isn't known at the start of the function, and the allocation may be
+  // executed many times.
+  auto stackSave =
+    llvm::Intrinsic::getDeclaration(&IGM.Module, llvm::Intrinsic::stacksave);
+  llvm::Value *savedStackPointer = Builder.CreateCall(stackSave, {});
+
+  auto alloca = Builder.CreateAlloca(IGM.Int8Ty, size, name);
+  alloca->setAlignment(align.getValue());
+  DynamicAllocaStackPointers[alloca] = savedStackPointer;
+  return Address(alloca, align);
+}
+
+void IRGenFunction::emitDeallocateDynamicAlloca(llvm::Value *pointer) {
+  auto found = DynamicAllocaStackPointers.find(pointer->stripPointerCasts());
+  // If the pointer no longer refers directly to the allocation, e.g. because
+  // it went through a phi, leave it to be released on return.
+  if (found == DynamicAllocaStackPointers.end())
+    return;
+
+  auto stackRestore =
+    llvm::Intrinsic::getDeclaration(&IGM.Module,
+                                    llvm::Intrinsic::stackrestore);
+  Builder.CreateCall(stackRestore, found->second);
+}
+
 /// Initialize a relative indirectable pointer to the given value.
 /// This always leaves the value in the direct state; if it's not a
 /// far reference, it's the caller's responsibility to ensure that the
@@ -171,6 +171,13 @@ public:
                                 const llvm::Twine &name ="");
   void emitDeallocRawCall(llvm::Value *pointer, llvm::Value *size,
                           llvm::Value *alignMask);
+
+  /// Allocate \p size bytes on the stack at the current insertion point.
+  /// The allocation is released, together with any later dynamic stack
+  /// allocations, by emitDeallocateDynamicAlloca.
+  Address emitDynamicAlloca(llvm::Value *size, Alignment align,
+                            const llvm::Twine &name = "");
+  void emitDeallocateDynamicAlloca(llvm::Value *pointer);
   
   void emitAllocBoxCall(llvm::Value *typeMetadata,
                          llvm::Value *&box,
@@ -228,6 +235,10 @@ private:
   llvm::Instruction *AllocaIP;
   const SILDebugScope *DbgScope;
 
+  /// The stack pointer saved before each dynamic stack allocation, which is
+  /// restored to release it.
+  llvm::DenseMap<llvm::Value *, llvm::Value *> DynamicAllocaStackPointers;
+
 //--- Reference-counting methods -----------------------------------------------
 public:
   llvm::Value *emitUnmanagedAlloc(const HeapLayout &layout,
@@ -545,6 +556,75 @@ public:
     ~ConditionalDominanceScope();
   };
 
+  /// Set the point in the entry block at which loop-invariant type data
+  /// can be emitted so that it dominates the rest of the function.
+  void setTypeDataHoistingPoint(llvm::Instruction *point) {
+    assert(TypeDataHoistingPoint == nullptr);
+    TypeDataHoistingPoint = point;
+  }
+
+  /// Set the maximum estimated cost of a type data request that may be
+  /// moved from the active dominance point to the hoisting point.
+  void setTypeDataHoistingBudget(unsigned budget) {
+    TypeDataHoistingBudget = budget;
+  }
+
+  /// Can any type data request be moved from the current insertion point
+  /// to the hoisting point?
+  bool canHoistTypeData() const {
+    return TypeDataHoistingPoint && TypeDataHoistingBudget != 0 &&
+           !ActiveDominancePoint.isUniversal();
+  }
+
+  /// Should a loop-invariant type data request with the given estimated
+  /// cost be emitted at the hoisting point instead of the current
+  /// insertion point?
+  bool shouldHoistTypeData(unsigned cost) const {
+    return canHoistTypeData() && cost != 0 && cost <= TypeDataHoistingBudget;
+  }
+
+  /// A RAII object for emitting type data at the hoisting point.  Anything
+  /// cached while the scope is active is available to the whole function,
+  /// so the request must not depend on values defined after the entry
+  /// block.
+  class TypeDataHoistingScope {
+    IRGenFunction &IGF;
+    llvm::BasicBlock *OldBlock;
+    llvm::BasicBlock::iterator OldPoint;
+    llvm::DebugLoc OldDebugLoc;
+    DominancePoint OldDominancePoint;
+    ConditionalDominanceScope *OldConditionalDominance;
+    unsigned OldBudget;
+
+  public:
+    explicit TypeDataHoistingScope(IRGenFunction &IGF)
+        : IGF(IGF), OldBlock(IGF.Builder.GetInsertBlock()),
+          OldPoint(IGF.Builder.GetInsertPoint()),
+          OldDebugLoc(IGF.Builder.getCurrentDebugLocation()),
+          OldDominancePoint(IGF.ActiveDominancePoint),
+          OldConditionalDominance(IGF.ConditionalDominance),
+          OldBudget(IGF.TypeDataHoistingBudget) {
+      assert(IGF.TypeDataHoistingPoint && "no hoisting point");
+      auto point = IGF.TypeDataHoistingPoint;
+      IGF.Builder.SetInsertPoint(point->getParent(), point->getIterator());
+      IGF.ActiveDominancePoint = DominancePoint::universal();
+      IGF.ConditionalDominance = nullptr;
+      IGF.TypeDataHoistingBudget = 0;
+    }
+
+    TypeDataHoistingScope(const TypeDataHoistingScope &other) = delete;
+    TypeDataHoistingScope &operator=(const TypeDataHoistingScope &other)
+      = delete;
+
+    ~TypeDataHoistingScope() {
+      IGF.Builder.SetInsertPoint(OldBlock, OldPoint);
+      IGF.Builder.SetCurrentDebugLocation(OldDebugLoc);
+      IGF.ActiveDominancePoint = OldDominancePoint;
+      IGF.ConditionalDominance = OldConditionalDominance;
+      IGF.TypeDataHoistingBudget = OldBudget;
+    }
+  };
+
   /// The kind of value LocalSelf is.
   enum LocalSelfKind {
     /// An object reference.
@@ -569,6 +649,11 @@ private:
   DominanceResolverFunction DominanceResolver = nullptr;
   DominancePoint ActiveDominancePoint = DominancePoint::universal();
   ConditionalDominanceScope *ConditionalDominance = nullptr;
+
+  /// A placeholder instruction in the entry block before which hoisted
+  /// type data is emitted, or null if type data is never hoisted.
+  llvm::Instruction *TypeDataHoistingPoint = nullptr;
+  unsigned TypeDataHoistingBudget = 0;
   
   /// The value that satisfies metadata lookups for dynamic Self.
   llvm::Value *LocalSelf = nullptr;
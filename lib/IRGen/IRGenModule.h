@@ -208,6 +208,11 @@ private:
   /// SIL functions that we need to emit lazily.
   llvm::SmallVector<SILFunction*, 4> LazyFunctionDefinitions;
 
+  /// The specialized generic types whose metadata the module accesses, in
+  /// the order they are first used. Only collected with
+  /// -warm-generic-metadata.
+  llvm::SetVector<CanType> GenericMetadataToWarm;
+
   /// The order in which all the SIL function definitions should
   /// appear in the translation unit.
   llvm::DenseMap<SILFunction*, unsigned> FunctionOrder;
@@ -298,6 +303,15 @@ public:
     if (LazilyEmittedTypeMetadata.insert(type).second)
       LazyTypeMetadata.push_back(type);
   }
+
+  void noteGenericMetadataAccess(CanType type) {
+    if (Opts.WarmGenericMetadata)
+      GenericMetadataToWarm.insert(type);
+  }
+
+  /// Have the entry point, if the module has one, instantiate the metadata
+  /// passed to noteGenericMetadataAccess on a background thread.
+  void emitGenericMetadataWarming();
   
   void addLazyFieldTypeAccessor(NominalTypeDecl *type,
                                 ArrayRef<FieldTypeInfo> fieldTypes,
@@ -597,8 +611,21 @@ public:
   ResilienceExpansion getResilienceExpansionForLayout(SILGlobalVariable *var);
 
   SpareBitVector getSpareBitsForType(llvm::Type *scalarTy, Size size);
+
+  /// Return the TBAA access tag for loads and stores of a stored property
+  /// of a class instance.
+  llvm::MDNode *getTBAATagForField(VarDecl *field);
+
+  /// Return the TBAA access tag for loads and stores of the tail-allocated
+  /// elements of a class instance.
+  llvm::MDNode *getTBAATagForTailElements();
   
 private:
+  llvm::MDNode *getTBAARoot();
+  llvm::MDNode *TBAARoot = nullptr;
+  llvm::MDNode *TBAATailElementsTag = nullptr;
+  llvm::DenseMap<VarDecl *, llvm::MDNode *> TBAAFieldTags;
+
   TypeConverter &Types;
   friend class TypeConverter;
 
@@ -1007,6 +1034,8 @@ private:
 //--- Global context emission --------------------------------------------------
 public:
   void emitRuntimeRegistration();
+  void emitGenericMetadataWarming(llvm::Function *entryFunction,
+                                  ArrayRef<CanType> types);
   void emitVTableStubs();
   void emitTypeVerifier();
 private:
@@ -22,6 +22,7 @@
 #include "llvm/IR/IntrinsicInst.h"
 #include "llvm/IR/InlineAsm.h"
 #include "llvm/IR/Intrinsics.h"
+#include "llvm/IR/Operator.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/SmallBitVector.h"
 #include "llvm/ADT/TinyPtrVector.h"
@@ -37,6 +38,7 @@
 #include "swift/AST/ParameterList.h"
 #include "swift/AST/Types.h"
 #include "swift/SIL/Dominance.h"
+#include "swift/SIL/LoopInfo.h"
 #include "swift/SIL/PrettyStackTrace.h"
 #include "swift/SIL/SILDebugScope.h"
 #include "swift/SIL/SILDeclRef.h"
@@ -364,6 +366,11 @@ public:
 
   // A cached dominance analysis.
   std::unique_ptr<DominanceInfo> Dominance;
+
+  // The loops and post-dominators of the function, if type data may be
+  // hoisted to its entry block.
+  std::unique_ptr<SILLoopInfo> Loops;
+  std::unique_ptr<PostDominanceInfo> PostDominance;
   
   IRGenSILFunction(IRGenModule &IGM, SILFunction *f);
   ~IRGenSILFunction();
@@ -374,6 +381,10 @@ public:
   /// Calculates EstimatedStackSize.
   void estimateStackSize();
 
+  /// Returns the maximum cost of a type data request that is moved from the
+  /// given block to the entry block.
+  unsigned getTypeDataHoistingBudget(SILBasicBlock *BB);
+
   void setLoweredValue(SILValue v, LoweredValue &&lv) {
     auto inserted = LoweredValues.insert({v, std::move(lv)});
     assert(inserted.second && "already had lowered value for sil value?!");
@@ -1359,6 +1370,17 @@ void IRGenSILFunction::emitSILFunction() {
                                     activePoint.as<SILBasicBlock>());
   });
   
+  // Type data requests that are made on every path through the function are
+  // moved to the entry block in optimized code.
+  auto &Opts = IGM.IRGen.Opts;
+  if (Opts.Optimize && Opts.TypeDataHoistingCostLimit != 0 &&
+      std::next(CurSILFn->begin()) != CurSILFn->end()) {
+    if (!Dominance)
+      Dominance.reset(new DominanceInfo(CurSILFn));
+    Loops.reset(new SILLoopInfo(CurSILFn, Dominance.get()));
+    PostDominance.reset(new PostDominanceInfo(CurSILFn));
+  }
+
   if (IGM.DebugInfo)
     IGM.DebugInfo->emitFunction(*CurSILFn, CurFn);
 
@@ -1477,6 +1499,32 @@ void IRGenSILFunction::estimateStackSize() {
   }
 }
 
+unsigned IRGenSILFunction::getTypeDataHoistingBudget(SILBasicBlock *BB) {
+  if (!Loops)
+    return 0;
+
+  // Only hoist out of blocks that every path from the entry block passes
+  // through, so the request is never made speculatively. A request that might
+  // not be made could have been guarded by a check, such as an availability
+  // check for a weakly linked type, which hoisting would skip. Blocks without
+  // a post-dominator tree node, e.g. in infinite loops, are left alone.
+  auto *EntryNode = PostDominance->getNode(&*CurSILFn->begin());
+  auto *BBNode = PostDominance->getNode(BB);
+  if (!EntryNode || !BBNode || !PostDominance->dominates(BBNode, EntryNode))
+    return 0;
+
+  // A request in a loop is made again on every iteration, so even an
+  // expensive one is worth making once up front.
+  unsigned limit = IGM.IRGen.Opts.TypeDataHoistingCostLimit;
+  if (Loops->getLoopFor(BB))
+    return limit;
+
+  // Otherwise, only hoist requests served by a single call to a caching
+  // accessor, which lets the blocks between the entry and this one share the
+  // call.
+  return std::min(limit, 1U);
+}
+
 void IRGenSILFunction::visitSILBasicBlock(SILBasicBlock *BB) {
   // Insert into the lowered basic block.
   llvm::BasicBlock *llBB = getLoweredBB(BB).bb;
@@ -1489,6 +1537,8 @@ void IRGenSILFunction::visitSILBasicBlock(SILBasicBlock *BB) {
   DominanceScope dominance(*this, InEntryBlock ? DominancePoint::universal()
                                                : DominancePoint(BB));
 
+  setTypeDataHoistingBudget(InEntryBlock ? 0 : getTypeDataHoistingBudget(BB));
+
   // The basic blocks are visited in a random order. Reset the debug location.
   std::unique_ptr<AutoRestoreLocation> ScopedLoc;
   if (InEntryBlock)
@@ -1555,6 +1605,16 @@ void IRGenSILFunction::visitSILBasicBlock(SILBasicBlock *BB) {
       if (isa<TermInst>(&I))
         emitDebugVariableRangeExtension(BB);
     }
+
+    // Everything the entry block binds is available before its terminator,
+    // so that's where type data hoisted out of the other blocks goes.
+    if (InEntryBlock && Loops && isa<TermInst>(&I) && Builder.hasValidIP()) {
+      auto undef = llvm::UndefValue::get(IGM.Int8PtrTy);
+      setTypeDataHoistingPoint(
+        Builder.Insert(new llvm::BitCastInst(undef, IGM.Int8PtrTy),
+                       "typedata.hoist"));
+    }
+
     visit(&I);
 
     assert(!EmissionNotes.count(&I) &&
@@ -2206,6 +2266,13 @@ void IRGenSILFunction::visitPartialApplyInst(swift::PartialApplyInst *i) {
     = getPartialApplicationFunction(*this, i->getCallee(),
                                     i->getSubstitutions());
 
+  int StackAllocSize = -1;
+  if (i->canAllocOnStack()) {
+    estimateStackSize();
+    // Is there enough space for stack allocation?
+    StackAllocSize = IGM.IRGen.Opts.StackPromotionSizeLimit - EstimatedStackSize;
+  }
+
   // Create the thunk and function value.
   Explosion function;
   emitFunctionPartialApplication(*this, *CurSILFn,
@@ -2213,7 +2280,12 @@ void IRGenSILFunction::visitPartialApplyInst(swift::PartialApplyInst *i) {
                                  params, i->getSubstitutions(),
                                  origCalleeTy, i->getSubstCalleeType(),
                                  i->getType().castTo<SILFunctionType>(),
-                                 function);
+                                 StackAllocSize, function);
+  if (StackAllocSize >= 0) {
+    // Remember that this partial_apply allocates its context on the stack.
+    StackAllocs.insert(i);
+    EstimatedStackSize += StackAllocSize;
+  }
   setLoweredExplosion(v, function);
 }
 
@@ -2904,20 +2976,126 @@ void IRGenSILFunction::visitCondBranchInst(swift::CondBranchInst *i) {
   Builder.CreateCondBr(condValue, trueBB.bb, falseBB.bb);
 }
 
+/// Should copies and destroys of values of type \p T be emitted as calls to
+/// shared helper functions instead of being expanded inline?
+///
+/// Expanding a copy of a struct with many reference fields or of a
+/// multi-payload enum inline at every use costs a lot of code size, while the
+/// call of a helper is cheap compared to the reference counting operations.
+static bool shouldOutlineCopyAndDestroy(IRGenSILFunction &IGF, SILType T,
+                                        const LoadableTypeInfo &ti) {
+  unsigned Threshold = IGF.IGM.IRGen.Opts.OutlineCopySizeThreshold;
+  if (Threshold == 0 || ti.isPOD(ResilienceExpansion::Maximal))
+    return false;
+
+  // The helpers are shared by name, so the type must be the same in every
+  // function which uses it.
+  if (T.hasArchetype())
+    return false;
+
+  if (T.getEnumOrBoundGenericEnum()) {
+    // Copying a multi-payload enum needs a switch over its cases, unless all
+    // payloads are single references and a copy is just a retain of the
+    // masked payload.
+    auto payloads = getEnumImplStrategy(IGF.IGM, T).getElementsWithPayload();
+    if (payloads.size() > 1 &&
+        !std::all_of(payloads.begin(), payloads.end(),
+                     [](const EnumImplStrategy::Element &e) -> bool {
+          return e.ti->isSingleRetainablePointer(ResilienceExpansion::Maximal);
+        }))
+      return true;
+  } else if (!T.getStructOrBoundGenericStruct() && !T.is<TupleType>()) {
+    return false;
+  }
+  return ti.getExplosionSize() >= Threshold;
+}
+
+/// Return the shared helper function which performs the operation \p op on
+/// an explosion of type \p T, creating it if necessary.
+static llvm::Constant *
+getOrCreateOutlinedCopyOrDestroyFunction(IRGenSILFunction &IGF, SILType T,
+                                         const LoadableTypeInfo &ti,
+                                         Explosion &in, bool isCopy) {
+  llvm::SmallString<64> fnName(isCopy ? "__swift_outlined_copy_"
+                                      : "__swift_outlined_destroy_");
+  llvm::SmallString<32> typeName;
+  fnName += IGF.IGM.mangleType(T.getSwiftRValueType(), typeName);
+
+  llvm::SmallVector<llvm::Type *, 8> argTys;
+  for (llvm::Value *v : in.getAll())
+    argTys.push_back(v->getType());
+
+  llvm::Constant *fn = IGF.IGM.getOrCreateHelperFunction(
+      fnName, IGF.IGM.VoidTy, argTys, [&](IRGenFunction &helperIGF) {
+    Explosion params = helperIGF.collectParameters();
+    if (isCopy) {
+      Explosion copy;
+      ti.copy(helperIGF, params, copy, irgen::Atomicity::Atomic);
+      copy.claimAll();
+    } else {
+      ti.consume(helperIGF, params, irgen::Atomicity::Atomic);
+    }
+    helperIGF.Builder.CreateRetVoid();
+  });
+
+  // Keep LLVM from inlining the expansion right back into every caller.
+  if (auto *def = dyn_cast<llvm::Function>(fn))
+    def->addFnAttr(llvm::Attribute::NoInline);
+  return fn;
+}
+
+/// Emit a copy of the explosion \p in of type \p T into \p out.
+static void emitCopy(IRGenSILFunction &IGF, SILType T, Explosion &in,
+                     Explosion &out, irgen::Atomicity atomicity) {
+  auto &ti = cast<LoadableTypeInfo>(IGF.getTypeInfo(T));
+  if (atomicity == irgen::Atomicity::NonAtomic ||
+      !shouldOutlineCopyAndDestroy(IGF, T, ti)) {
+    ti.copy(IGF, in, out, atomicity);
+    return;
+  }
+
+  // Copies are bit-identical to their source, so the helper only has to do
+  // the reference counting.
+  auto *fn = getOrCreateOutlinedCopyOrDestroyFunction(IGF, T, ti, in,
+                                                      /*isCopy*/ true);
+  auto values = in.claimAll();
+  auto *call = IGF.Builder.CreateCall(fn, values);
+  call->setCallingConv(IGF.IGM.DefaultCC);
+  call->setDoesNotThrow();
+  out.add(values);
+}
+
+/// Emit a destroy of the explosion \p in of type \p T.
+static void emitConsume(IRGenSILFunction &IGF, SILType T, Explosion &in,
+                        irgen::Atomicity atomicity) {
+  auto &ti = cast<LoadableTypeInfo>(IGF.getTypeInfo(T));
+  if (atomicity == irgen::Atomicity::NonAtomic ||
+      !shouldOutlineCopyAndDestroy(IGF, T, ti)) {
+    ti.consume(IGF, in, atomicity);
+    return;
+  }
+
+  auto *fn = getOrCreateOutlinedCopyOrDestroyFunction(IGF, T, ti, in,
+                                                      /*isCopy*/ false);
+  auto *call = IGF.Builder.CreateCall(fn, in.claimAll());
+  call->setCallingConv(IGF.IGM.DefaultCC);
+  call->setDoesNotThrow();
+}
+
 void IRGenSILFunction::visitRetainValueInst(swift::RetainValueInst *i) {
   Explosion in = getLoweredExplosion(i->getOperand());
   Explosion out;
-  cast<LoadableTypeInfo>(getTypeInfo(i->getOperand()->getType()))
-      .copy(*this, in, out, i->isAtomic() ? irgen::Atomicity::Atomic
-                                          : irgen::Atomicity::NonAtomic);
+  emitCopy(*this, i->getOperand()->getType(), in, out,
+           i->isAtomic() ? irgen::Atomicity::Atomic
+                         : irgen::Atomicity::NonAtomic);
   out.claimAll();
 }
 
 void IRGenSILFunction::visitCopyValueInst(swift::CopyValueInst *i) {
   Explosion in = getLoweredExplosion(i->getOperand());
   Explosion out;
-  cast<LoadableTypeInfo>(getTypeInfo(i->getOperand()->getType()))
-      .copy(*this, in, out, irgen::Atomicity::Atomic);
+  emitCopy(*this, i->getOperand()->getType(), in, out,
+           irgen::Atomicity::Atomic);
   setLoweredExplosion(i, out);
 }
 
@@ -2967,15 +3145,15 @@ void IRGenSILFunction::visitSetDeallocatingInst(SetDeallocatingInst *i) {
 
 void IRGenSILFunction::visitReleaseValueInst(swift::ReleaseValueInst *i) {
   Explosion in = getLoweredExplosion(i->getOperand());
-  cast<LoadableTypeInfo>(getTypeInfo(i->getOperand()->getType()))
-      .consume(*this, in, i->isAtomic() ? irgen::Atomicity::Atomic
-                                        : irgen::Atomicity::NonAtomic);
+  emitConsume(*this, i->getOperand()->getType(), in,
+              i->isAtomic() ? irgen::Atomicity::Atomic
+                            : irgen::Atomicity::NonAtomic);
 }
 
 void IRGenSILFunction::visitDestroyValueInst(swift::DestroyValueInst *i) {
   Explosion in = getLoweredExplosion(i->getOperand());
-  cast<LoadableTypeInfo>(getTypeInfo(i->getOperand()->getType()))
-      .consume(*this, in, irgen::Atomicity::Atomic);
+  emitConsume(*this, i->getOperand()->getType(), in,
+              irgen::Atomicity::Atomic);
 }
 
 void IRGenSILFunction::visitStructInst(swift::StructInst *i) {
@@ -3105,11 +3283,112 @@ void IRGenSILFunction::visitRefTailAddrInst(RefTailAddrInst *i) {
   setLoweredAddress(i, TailAddr);
 }
 
+/// Return the TBAA tag for accesses to the given address, or null if
+/// nothing is known about the memory it refers to.
+static llvm::MDNode *getTBAATagForAddress(IRGenModule &IGM, SILValue addr) {
+  bool indexed = false;
+  while (true) {
+    if (auto *rea = dyn_cast<RefElementAddrInst>(addr)) {
+      // Indexing past a stored property can reach any other property.
+      if (indexed)
+        return nullptr;
+      return IGM.getTBAATagForField(rea->getField());
+    }
+    if (isa<RefTailAddrInst>(addr))
+      return IGM.getTBAATagForTailElements();
+
+    // Projections stay within the memory of their base address.
+    if (auto *sea = dyn_cast<StructElementAddrInst>(addr)) {
+      addr = sea->getOperand();
+      continue;
+    }
+    if (auto *tea = dyn_cast<TupleElementAddrInst>(addr)) {
+      addr = tea->getOperand();
+      continue;
+    }
+    if (auto *iai = dyn_cast<IndexAddrInst>(addr)) {
+      addr = iai->getBase();
+      indexed = true;
+      continue;
+    }
+    if (auto *tai = dyn_cast<TailAddrInst>(addr)) {
+      addr = tai->getBase();
+      indexed = true;
+      continue;
+    }
+    return nullptr;
+  }
+}
+
+namespace {
+  /// Attaches TBAA metadata to the loads and stores of a class property or
+  /// of tail-allocated elements which are emitted while the scope is
+  /// active, so that LLVM knows that accesses to different properties do
+  /// not alias.
+  class TBAATagScope {
+    IRGenFunction &IGF;
+    llvm::MDNode *Tag;
+    llvm::Value *Base;
+    llvm::BasicBlock *BB;
+    llvm::Instruction *Prev;
+
+  public:
+    TBAATagScope(IRGenFunction &IGF, SILValue addr, Address lowered)
+        : IGF(IGF), Tag(nullptr), Base(lowered.getAddress()),
+          BB(IGF.Builder.GetInsertBlock()), Prev(nullptr) {
+      if (!IGF.IGM.IRGen.Opts.Optimize || !BB)
+        return;
+      Tag = getTBAATagForAddress(IGF.IGM, addr);
+      auto IP = IGF.Builder.GetInsertPoint();
+      if (IP != BB->begin())
+        Prev = &*std::prev(IP);
+    }
+
+    ~TBAATagScope() {
+      if (!Tag)
+        return;
+
+      // Only look at the block we started in; if the emission branched,
+      // the accesses in later blocks are simply left untagged.
+      auto I = Prev ? std::next(Prev->getIterator()) : BB->begin();
+      auto E = IGF.Builder.GetInsertBlock() == BB ? IGF.Builder.GetInsertPoint()
+                                                  : BB->end();
+      for (; I != E; ++I) {
+        llvm::Value *ptr;
+        if (auto *load = dyn_cast<llvm::LoadInst>(&*I))
+          ptr = load->getPointerOperand();
+        else if (auto *store = dyn_cast<llvm::StoreInst>(&*I))
+          ptr = store->getPointerOperand();
+        else
+          continue;
+        if (isDerivedFromBase(ptr))
+          I->setMetadata(llvm::LLVMContext::MD_tbaa, Tag);
+      }
+    }
+
+  private:
+    /// Only tag accesses to the address itself, and not, say, the
+    /// stores of a copy into another location.
+    bool isDerivedFromBase(llvm::Value *ptr) const {
+      while (ptr != Base) {
+        if (auto *cast = dyn_cast<llvm::BitCastOperator>(ptr))
+          ptr = cast->getOperand(0);
+        else if (auto *gep = dyn_cast<llvm::GEPOperator>(ptr))
+          ptr = gep->getPointerOperand();
+        else
+          return false;
+      }
+      return true;
+    }
+  };
+} // end anonymous namespace
+
 void IRGenSILFunction::visitLoadInst(swift::LoadInst *i) {
   Explosion lowered;
   Address source = getLoweredAddress(i->getOperand());
   SILType objType = i->getType().getObjectType();
   const auto &typeInfo = cast<LoadableTypeInfo>(getTypeInfo(objType));
+  TBAATagScope tbaa(*this, i->getOperand(), source);
 
   switch (i->getOwnershipQualifier()) {
   case LoadOwnershipQualifier::Unqualified:
@@ -3126,11 +3405,16 @@ void IRGenSILFunction::visitLoadInst(swift::LoadInst *i) {
 }
 
 void IRGenSILFunction::visitStoreInst(swift::StoreInst *i) {
+  // The value has already been passed to the allocation of the box.
+  if (claimEmissionNote(i))
+    return;
+
   Explosion source = getLoweredExplosion(i->getSrc());
   Address dest = getLoweredAddress(i->getDest());
   SILType objType = i->getSrc()->getType().getObjectType();
 
   const auto &typeInfo = cast<LoadableTypeInfo>(getTypeInfo(objType));
+  TBAATagScope tbaa(*this, i->getDest(), dest);
   switch (i->getOwnershipQualifier()) {
   case StoreOwnershipQualifier::Unqualified:
   case StoreOwnershipQualifier::Init:
@@ -3596,6 +3880,21 @@ void IRGenSILFunction::visitDeallocRefInst(swift::DeallocRefInst *i) {
   // Lower the operand.
   Explosion self = getLoweredExplosion(i->getOperand());
   auto selfValue = self.claimNext();
+  if (isa<PartialApplyInst>(i->getOperand())) {
+    // The dealloc_ref [stack] only marks the end of a closure context's
+    // lifetime. If the context is on the heap, it is freed by its final
+    // release.
+    if (!StackAllocs.count(cast<PartialApplyInst>(i->getOperand())))
+      return;
+    // The context is the second element of the function value.
+    selfValue = self.claimNext();
+    if (IGM.IRGen.Opts.EmitStackPromotionChecks) {
+      emitVerifyEndOfLifetimeCall(selfValue);
+    } else {
+      Builder.CreateLifetimeEnd(selfValue);
+    }
+    return;
+  }
   auto *ARI = dyn_cast<AllocRefInst>(i->getOperand());
   if (!i->canAllocOnStack()) {
     if (ARI && StackAllocs.count(ARI)) {
@@ -4479,7 +4778,68 @@ void IRGenSILFunction::visitInitBlockStorageHeaderInst(
   setLoweredExplosion(i, e);
 }
 
+/// Find a store of a case of an enum without payloads into the box made by
+/// \p allocBox, shortly after it, such as the ones for `throw E.someCase`.
+static StoreInst *
+findPayloadlessEnumStoreIntoBox(AllocExistentialBoxInst *allocBox) {
+  for (auto inst = &*std::next(allocBox->getIterator()); !isa<TermInst>(inst);
+       inst = &*std::next(inst->getIterator())) {
+    if (auto project = dyn_cast<ProjectExistentialBoxInst>(inst)) {
+      if (project->getOperand() == allocBox)
+        continue;
+      return nullptr;
+    }
+
+    if (auto enumInst = dyn_cast<EnumInst>(inst)) {
+      if (!enumInst->hasOperand())
+        continue;
+      return nullptr;
+    }
+
+    auto store = dyn_cast<StoreInst>(inst);
+    if (!store ||
+        store->getOwnershipQualifier() == StoreOwnershipQualifier::Assign)
+      return nullptr;
+    auto project = dyn_cast<ProjectExistentialBoxInst>(store->getDest());
+    auto enumInst = dyn_cast<EnumInst>(store->getSrc());
+    if (!project || project->getOperand() != allocBox ||
+        !enumInst || enumInst->hasOperand())
+      return nullptr;
+    return store;
+  }
+
+  return nullptr;
+}
+
 void IRGenSILFunction::visitAllocExistentialBoxInst(AllocExistentialBoxInst *i){
+  // If the box is initialized with a constant, pass it to the allocation, so
+  // that the runtime doesn't need a new box for every error thrown.
+  auto store = findPayloadlessEnumStoreIntoBox(i);
+  if (store && isa<LoadableTypeInfo>(getTypeInfo(store->getSrc()->getType()))) {
+    auto enumInst = cast<EnumInst>(store->getSrc());
+    SILType valueTy = enumInst->getType();
+    auto &valueTI = cast<LoadableTypeInfo>(getTypeInfo(valueTy));
+
+    Explosion value;
+    Explosion payload;
+    emitInjectLoadableEnum(*this, valueTy, enumInst->getElement(), payload,
+                           value);
+    auto temporary = valueTI.allocateStack(*this, valueTy, "error.value");
+    valueTI.initialize(*this, value, temporary.getAddress());
+
+    OwnedAddress boxWithAddr =
+      emitBoxedExistentialContainerAllocation(*this, i->getExistentialType(),
+                                              i->getFormalConcreteType(),
+                                              i->getConformances(),
+                                              temporary.getAddress());
+    valueTI.deallocateStack(*this, temporary.getAddress(), valueTy);
+    setLoweredBox(i, boxWithAddr);
+
+    // The store has nothing left to do.
+    addEmissionNote(store);
+    return;
+  }
+
   OwnedAddress boxWithAddr =
     emitBoxedExistentialContainerAllocation(*this, i->getExistentialType(),
                                             i->getFormalConcreteType(),
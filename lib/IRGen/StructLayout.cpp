@@ -189,14 +189,48 @@ void StructLayoutBuilder::addHeapHeader() {
   StructFields.push_back(IGM.RefCountedStructTy);
 }
 
+/// Decide the order in which the given elements are laid out.
+static void getFieldLayoutOrder(llvm::MutableArrayRef<ElementLayout> elts,
+                                LayoutStrategy strategy,
+                                SmallVectorImpl<unsigned> &order) {
+  for (unsigned i = 0, e = elts.size(); i != e; ++i)
+    order.push_back(i);
+
+  if (strategy != LayoutStrategy::Reordered)
+    return;
+
+  // Elements at non-fixed offsets are laid out by the runtime, which only
+  // knows about declaration order.
+  for (auto &elt : elts)
+    if (!isa<FixedTypeInfo>(elt.getType()))
+      return;
+
+  // Lay out the most-aligned elements first; at the same alignment, prefer
+  // elements which don't leave a tail for the next one to pad out.  This
+  // leaves padding only at the end of the aggregate.
+  std::stable_sort(order.begin(), order.end(), [&](unsigned a, unsigned b) {
+    auto &aTI = cast<FixedTypeInfo>(elts[a].getType());
+    auto &bTI = cast<FixedTypeInfo>(elts[b].getType());
+    if (aTI.getFixedAlignment() != bTI.getFixedAlignment())
+      return aTI.getFixedAlignment() > bTI.getFixedAlignment();
+    bool aHasTail = !(aTI.getFixedSize() % aTI.getFixedAlignment()).isZero();
+    bool bHasTail = !(bTI.getFixedSize() % bTI.getFixedAlignment()).isZero();
+    return !aHasTail && bHasTail;
+  });
+}
+
 bool StructLayoutBuilder::addFields(llvm::MutableArrayRef<ElementLayout> elts,
                                     LayoutStrategy strategy) {
   // Track whether we've added any storage to our layout.
   bool addedStorage = false;
 
+  SmallVector<unsigned, 8> order;
+  getFieldLayoutOrder(elts, strategy, order);
+
   // Loop through the elements.  The only valid field in each element
   // is Type; StructIndex and ByteOffset need to be laid out.
-  for (auto &elt : elts) {
+  for (unsigned index : order) {
+    auto &elt = elts[index];
     auto &eltTI = elt.getType();
     IsKnownPOD &= eltTI.isPOD(ResilienceExpansion::Maximal);
     IsKnownBitwiseTakable &= eltTI.isBitwiseTakable(ResilienceExpansion::Maximal);
@@ -209,9 +243,8 @@ bool StructLayoutBuilder::addFields(llvm::MutableArrayRef<ElementLayout> elts,
       // Anything else we do at least potentially adds storage requirements.
       addedStorage = true;
 
-      // TODO: consider using different layout rules.
-      // If the rules are changed so that fields aren't necessarily laid
-      // out sequentially, the computation of InstanceStart in the
+      // Only the Reordered strategy lays out fields out of order.  If
+      // classes ever use it, the computation of InstanceStart in the
       // RO-data will need to be fixed.
 
       // If this element is resiliently- or dependently-sized, record
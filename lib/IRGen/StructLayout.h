@@ -43,6 +43,12 @@ enum class LayoutStrategy {
   /// Compute an optimal layout;  there are no constraints at all.
   Optimal,
 
+  /// Like Optimal, but fixed-size fields may also be laid out in a
+  /// different order than they were declared in, to minimize padding.
+  /// This is only valid for types whose layout is never computed outside
+  /// of the current module.
+  Reordered,
+
   /// The 'universal' strategy: all modules must agree on the layout.
   Universal
 };
@@ -134,10 +134,16 @@ SwiftTargetInfo SwiftTargetInfo::get(IRGenModule &IGM) {
   SwiftTargetInfo target(triple.getObjectFormat(), pointerSize);
   
   // On Apple platforms, we implement "once" using dispatch_once, which exposes
-  // -1 as ABI for the "done" value.
-  if (triple.isOSDarwin())
+  // -1 as ABI for the "done" value. The runtime's own implementation on
+  // other platforms uses the same value, but unlike dispatch_once it
+  // doesn't make the initialized state visible to all threads, so the check
+  // has to be an acquire load.
+  if (triple.isOSDarwin()) {
+    target.OnceDonePredicateValue = -1L;
+  } else if (!triple.isWindowsCygwinEnvironment()) {
     target.OnceDonePredicateValue = -1L;
-  // TODO: Do we know this for Linux?
+    target.OnceDonePredicateNeedsAcquire = true;
+  }
   
   switch (triple.getArch()) {
   case llvm::Triple::x86_64:
@@ -95,6 +95,10 @@ public:
   /// The value stored in a Builtin.once predicate to indicate that an
   /// initialization has already happened, if known.
   Optional<int64_t> OnceDonePredicateValue = None;
+
+  /// True if the inline check of a Builtin.once predicate has to be an
+  /// acquire load to see the effects of the initialization.
+  bool OnceDonePredicateNeedsAcquire = false;
 };
 
 }
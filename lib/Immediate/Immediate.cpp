@@ -368,6 +368,11 @@ int swift::RunImmediately(CompilerInstance &CI, const ProcessCmdLine &CmdLine,
   builder.setMAttrs(Features);
   builder.setErrorStr(&ErrorMsg);
   builder.setEngineKind(llvm::EngineKind::JIT);
+  // Generate code as quickly as possible unless asked to optimize, like
+  // IRGen does for object files; the whole program is compiled before it
+  // starts.
+  builder.setOptLevel(IRGenOpts.Optimize ? llvm::CodeGenOpt::Aggressive
+                                         : llvm::CodeGenOpt::None);
   llvm::ExecutionEngine *EE = builder.create();
   if (!EE) {
     llvm::errs() << "Error loading JIT: " << ErrorMsg;
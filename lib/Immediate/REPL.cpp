@@ -884,6 +884,12 @@ private:
 
     stripPreviouslyGenerated(*NewModule);
 
+    // Everything defined so far has been handed to the JIT. Keep only
+    // declarations of it, which are all later lines need to link against,
+    // so that each line doesn't clone and relink the code of every line
+    // before it.
+    stripPreviouslyGenerated(*Module);
+
     if (!linkLLVMModules(&DumpModule, std::move(SaveLineModule))) {
       return false;
     }
@@ -959,6 +965,9 @@ public:
     builder.setMAttrs(Features);
     builder.setErrorStr(&ErrorMsg);
     builder.setEngineKind(llvm::EngineKind::JIT);
+    // Lines are IRGen'd without optimization below, and should start
+    // running as soon as they're entered.
+    builder.setOptLevel(llvm::CodeGenOpt::None);
     EE = builder.create();
 
     IRGenOpts.OutputFilenames.clear();
@@ -0,0 +1,541 @@
+//===--- IndexRecord.cpp - On-disk index records --------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// A record is the stream of IndexDataConsumer callbacks made while indexing a
+// source file. After a four byte signature and the format version, each
+// callback is a one-byte tag followed by its operands. Integers are ULEB128
+// encoded. Strings are written inline the first time they appear, as their
+// length plus one followed by the bytes, and afterwards as a zero followed by
+// their index; this keeps the repeated USRs small and lets the reader hand out
+// the same StringRef for equal USRs, as IndexSymbol promises.
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/Index/IndexRecord.h"
+#include "swift/Index/Index.h"
+
+#include "swift/AST/Attr.h"
+#include "swift/AST/Decl.h"
+#include "swift/AST/Module.h"
+#include "swift/AST/SearchPathOptions.h"
+#include "swift/Basic/LangOptions.h"
+#include "swift/Basic/SourceManager.h"
+#include "swift/Basic/Version.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include <cstring>
+
+using namespace swift;
+using namespace swift::index;
+
+static const char RecordSignature[] = {'S', 'I', 'D', 'X'};
+static const unsigned RecordVersion = 2;
+
+/// Returns the size and modification time of the file at \p path, or zeros if
+/// it can't be read.
+static std::pair<uint64_t, uint64_t> getDependencySignature(StringRef path) {
+  llvm::sys::fs::file_status status;
+  if (llvm::sys::fs::status(path, status))
+    return {0, 0};
+  return {status.getSize(), status.getLastModificationTime().toEpochTime()};
+}
+
+namespace {
+enum class RecordTag : uint8_t {
+  End,
+  Hash,
+  StartDependency,
+  FinishDependency,
+  StartSourceEntity,
+  RelatedEntity,
+  FinishSourceEntity,
+};
+
+/// Serializes the callbacks it receives into a record.
+class RecordWriter : public IndexDataConsumer {
+  SmallString<4096> Buffer;
+  llvm::raw_svector_ostream OS{Buffer};
+  llvm::StringMap<unsigned> StringIDs;
+
+public:
+  std::string Error;
+
+  RecordWriter() {
+    OS.write(RecordSignature, sizeof(RecordSignature));
+    writeInt(RecordVersion);
+  }
+
+  StringRef getBuffer() const { return Buffer; }
+
+private:
+  void writeInt(uint64_t value) {
+    do {
+      uint8_t byte = value & 0x7f;
+      value >>= 7;
+      if (value != 0)
+        byte |= 0x80;
+      OS << char(byte);
+    } while (value != 0);
+  }
+
+  void writeTag(RecordTag tag) { OS << char(tag); }
+
+  void writeString(StringRef str) {
+    auto inserted = StringIDs.insert({str, StringIDs.size()});
+    if (!inserted.second) {
+      writeInt(0);
+      writeInt(inserted.first->second);
+      return;
+    }
+    writeInt(str.size() + 1);
+    OS << str;
+  }
+
+  void writeSymbol(const IndexSymbol &symbol) {
+    writeInt(unsigned(symbol.kind));
+    writeInt(symbol.subKinds);
+    writeInt(symbol.roles);
+    writeString(symbol.name);
+    writeString(symbol.USR);
+    writeString(symbol.group);
+    writeString(symbol.receiverUSR);
+    writeInt(symbol.line);
+    writeInt(symbol.column);
+
+    // Only definitions report their attributes.
+    SmallVector<StringRef, 8> attrNames;
+    if (!(symbol.roles & (unsigned)SymbolRole::Reference) && symbol.decl)
+      getDeclAttributeNames(symbol.decl->getAttrs(), attrNames);
+    writeInt(attrNames.size());
+    for (StringRef name : attrNames)
+      writeString(name);
+  }
+
+  void failed(StringRef error) override { Error = error; }
+
+  bool recordHash(StringRef hash, bool isKnown) override {
+    writeTag(RecordTag::Hash);
+    writeString(hash);
+    return true;
+  }
+
+  bool startDependency(SymbolKind kind, StringRef name, StringRef path,
+                       bool isSystem, StringRef hash) override {
+    writeTag(RecordTag::StartDependency);
+    writeInt(unsigned(kind));
+    writeString(name);
+    writeString(path);
+    writeInt(isSystem);
+    writeString(hash);
+    // Lets a reader tell whether the module changed since this was written.
+    auto signature = getDependencySignature(path);
+    writeInt(signature.first);
+    writeInt(signature.second);
+    return true;
+  }
+
+  bool finishDependency(SymbolKind kind) override {
+    writeTag(RecordTag::FinishDependency);
+    writeInt(unsigned(kind));
+    return true;
+  }
+
+  bool startSourceEntity(const IndexSymbol &symbol) override {
+    writeTag(RecordTag::StartSourceEntity);
+    writeSymbol(symbol);
+    return true;
+  }
+
+  bool recordRelatedEntity(const IndexSymbol &symbol) override {
+    writeTag(RecordTag::RelatedEntity);
+    writeSymbol(symbol);
+    return true;
+  }
+
+  bool finishSourceEntity(SymbolKind kind, SymbolSubKindSet subKinds,
+                          SymbolRoleSet roles) override {
+    writeTag(RecordTag::FinishSourceEntity);
+    writeInt(unsigned(kind));
+    writeInt(subKinds);
+    writeInt(roles);
+    return true;
+  }
+
+  void finish() override { writeTag(RecordTag::End); }
+};
+
+/// One decoded callback.
+struct RecordEvent {
+  RecordTag tag;
+  IndexSymbol symbol;
+  unsigned firstAttr = 0;
+  unsigned numAttrs = 0;
+  // Dependency operands; the hash operand is also used by RecordTag::Hash.
+  StringRef name;
+  StringRef path;
+  StringRef hash;
+  bool isSystem = false;
+  uint64_t size = 0;
+  uint64_t modTime = 0;
+};
+
+/// Decodes a whole record up front, so that a truncated or corrupt record is
+/// rejected before any callback is made.
+class RecordReader {
+  const uint8_t *Ptr;
+  const uint8_t *End;
+  std::vector<StringRef> Strings;
+
+public:
+  std::vector<RecordEvent> Events;
+  std::vector<StringRef> AttrNames;
+
+  explicit RecordReader(StringRef data)
+      : Ptr(data.bytes_begin()), End(data.bytes_end()) {}
+
+  bool read() {
+    if (size_t(End - Ptr) < sizeof(RecordSignature) ||
+        memcmp(Ptr, RecordSignature, sizeof(RecordSignature)) != 0)
+      return false;
+    Ptr += sizeof(RecordSignature);
+
+    uint64_t version;
+    if (!readInt(version) || version != RecordVersion)
+      return false;
+
+    while (Ptr != End) {
+      RecordEvent event;
+      event.symbol.decl = nullptr;
+      event.tag = RecordTag(*Ptr++);
+      switch (event.tag) {
+      case RecordTag::End:
+        // Nothing may follow the end of the record.
+        return Ptr == End;
+      case RecordTag::Hash:
+        if (!readString(event.hash))
+          return false;
+        break;
+      case RecordTag::StartDependency:
+        if (!readKind(event.symbol.kind) || !readString(event.name) ||
+            !readString(event.path) || !readBool(event.isSystem) ||
+            !readString(event.hash) || !readInt(event.size) ||
+            !readInt(event.modTime))
+          return false;
+        break;
+      case RecordTag::FinishDependency:
+        if (!readKind(event.symbol.kind))
+          return false;
+        break;
+      case RecordTag::StartSourceEntity:
+      case RecordTag::RelatedEntity:
+        if (!readSymbol(event))
+          return false;
+        break;
+      case RecordTag::FinishSourceEntity:
+        if (!readKind(event.symbol.kind) ||
+            !readUInt32(event.symbol.subKinds) ||
+            !readUInt32(event.symbol.roles))
+          return false;
+        break;
+      default:
+        return false;
+      }
+      Events.push_back(event);
+    }
+
+    // Missing end tag.
+    return false;
+  }
+
+private:
+  bool readInt(uint64_t &value) {
+    value = 0;
+    unsigned shift = 0;
+    while (Ptr != End && shift < 64) {
+      uint8_t byte = *Ptr++;
+      value |= uint64_t(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+        return true;
+      shift += 7;
+    }
+    return false;
+  }
+
+  bool readUInt32(unsigned &value) {
+    uint64_t wide;
+    if (!readInt(wide) || wide > UINT32_MAX)
+      return false;
+    value = wide;
+    return true;
+  }
+
+  bool readBool(bool &value) {
+    uint64_t wide;
+    if (!readInt(wide) || wide > 1)
+      return false;
+    value = wide;
+    return true;
+  }
+
+  bool readKind(SymbolKind &kind) {
+    uint64_t wide;
+    if (!readInt(wide) || wide > uint64_t(SymbolKind::Destructor))
+      return false;
+    kind = SymbolKind(wide);
+    return true;
+  }
+
+  bool readString(StringRef &str) {
+    uint64_t lengthOrRef;
+    if (!readInt(lengthOrRef))
+      return false;
+    if (lengthOrRef == 0) {
+      uint64_t id;
+      if (!readInt(id) || id >= Strings.size())
+        return false;
+      str = Strings[id];
+      return true;
+    }
+    uint64_t length = lengthOrRef - 1;
+    if (uint64_t(End - Ptr) < length)
+      return false;
+    str = StringRef(reinterpret_cast<const char *>(Ptr), length);
+    Ptr += length;
+    Strings.push_back(str);
+    return true;
+  }
+
+  bool readSymbol(RecordEvent &event) {
+    IndexSymbol &symbol = event.symbol;
+    if (!readKind(symbol.kind) || !readUInt32(symbol.subKinds) ||
+        !readUInt32(symbol.roles) || !readString(symbol.name) ||
+        !readString(symbol.USR) || !readString(symbol.group) ||
+        !readString(symbol.receiverUSR) || !readUInt32(symbol.line) ||
+        !readUInt32(symbol.column))
+      return false;
+
+    uint64_t numAttrs;
+    if (!readInt(numAttrs) || numAttrs > uint64_t(End - Ptr))
+      return false;
+    event.firstAttr = AttrNames.size();
+    event.numAttrs = numAttrs;
+    for (unsigned i = 0; i != numAttrs; ++i) {
+      StringRef name;
+      if (!readString(name))
+        return false;
+      AttrNames.push_back(name);
+    }
+    return true;
+  }
+};
+} // end anonymous namespace
+
+/// Returns true if none of the modules \p reader's record depends on changed
+/// since the record was written.
+static bool areDependenciesUnchanged(const RecordReader &reader) {
+  for (const RecordEvent &event : reader.Events) {
+    if (event.tag != RecordTag::StartDependency)
+      continue;
+    if (getDependencySignature(event.path) !=
+        std::make_pair(event.size, event.modTime))
+      return false;
+  }
+  return true;
+}
+
+std::string
+index::getIndexRecordInvocationHash(const LangOptions &langOpts,
+                                    const SearchPathOptions &searchOpts) {
+  llvm::MD5 hash;
+  auto addString = [&](StringRef str) {
+    hash.update(str);
+    hash.update(ArrayRef<uint8_t>{0});
+  };
+  addString(langOpts.Target.str());
+  for (const std::string &flag :
+       langOpts.getCustomConditionalCompilationFlags())
+    addString(flag);
+  addString("-sdk");
+  addString(searchOpts.SDKPath);
+  addString("-I");
+  for (const std::string &path : searchOpts.ImportSearchPaths)
+    addString(path);
+  addString("-F");
+  for (const std::string &path : searchOpts.FrameworkSearchPaths)
+    addString(path);
+
+  llvm::MD5::MD5Result result;
+  hash.final(result);
+  SmallString<32> str;
+  llvm::MD5::stringifyResult(result, str);
+  return str.str();
+}
+
+std::string index::getIndexRecordKey(StringRef invocationHash,
+                                     StringRef moduleName, StringRef filename,
+                                     StringRef contents) {
+  llvm::MD5 hash;
+  // Records from another compiler may index the same source differently.
+  hash.update(version::getSwiftFullVersion());
+  hash.update(ArrayRef<uint8_t>{0});
+  hash.update(invocationHash);
+  hash.update(ArrayRef<uint8_t>{0});
+  hash.update(moduleName);
+  hash.update(ArrayRef<uint8_t>{0});
+  hash.update(filename);
+  hash.update(ArrayRef<uint8_t>{0});
+  hash.update(contents);
+
+  llvm::MD5::MD5Result result;
+  hash.final(result);
+  SmallString<32> str;
+  llvm::MD5::stringifyResult(result, str);
+  return str.str();
+}
+
+std::string index::getIndexRecordKey(SourceFile *SF,
+                                     StringRef invocationHash) {
+  auto &SM = SF->getASTContext().SourceMgr;
+  unsigned bufferID = SF->getBufferID().getValue();
+  StringRef contents = SM.extractText(SM.getRangeForBuffer(bufferID));
+  return getIndexRecordKey(invocationHash,
+                           SF->getParentModule()->getName().str(),
+                           SF->getFilename(), contents);
+}
+
+std::string index::getIndexRecordPath(StringRef storePath, StringRef key) {
+  SmallString<128> path(storePath);
+  llvm::sys::path::append(path, "records", key);
+  return path.str();
+}
+
+bool index::emitIndexRecord(SourceFile *SF, StringRef invocationHash,
+                            StringRef storePath, std::string &error) {
+  std::string recordPath =
+      getIndexRecordPath(storePath, getIndexRecordKey(SF, invocationHash));
+  // Neither the file nor the modules it imports changed since its record was
+  // written.
+  if (auto bufferOrErr = llvm::MemoryBuffer::getFile(recordPath)) {
+    RecordReader reader(bufferOrErr.get()->getBuffer());
+    if (reader.read() && areDependenciesUnchanged(reader))
+      return false;
+  }
+
+  RecordWriter writer;
+  indexSourceFile(SF, /*hash*/ StringRef(), writer);
+  if (!writer.Error.empty()) {
+    error = writer.Error;
+    return true;
+  }
+
+  StringRef recordDir = llvm::sys::path::parent_path(recordPath);
+  if (std::error_code EC = llvm::sys::fs::create_directories(recordDir)) {
+    error = EC.message();
+    return true;
+  }
+
+  // Write to a unique temporary file first; other jobs may be writing the
+  // same record at the same time.
+  int FD;
+  SmallString<128> tmpPath;
+  if (std::error_code EC = llvm::sys::fs::createUniqueFile(
+          recordPath + "-%%%%%%%%", FD, tmpPath)) {
+    error = EC.message();
+    return true;
+  }
+  {
+    llvm::raw_fd_ostream out(FD, /*shouldClose=*/true);
+    out << writer.getBuffer();
+    out.close();
+    if (out.has_error()) {
+      out.clear_error();
+      llvm::sys::fs::remove(tmpPath);
+      error = "failed to write '" + tmpPath.str().str() + "'";
+      return true;
+    }
+  }
+
+  if (std::error_code EC = llvm::sys::fs::rename(tmpPath, recordPath)) {
+    llvm::sys::fs::remove(tmpPath);
+    error = EC.message();
+    return true;
+  }
+  return false;
+}
+
+bool index::readIndexRecord(StringRef storePath, StringRef key,
+                            StringRef knownHash, IndexDataConsumer &consumer) {
+  auto bufferOrErr =
+      llvm::MemoryBuffer::getFile(getIndexRecordPath(storePath, key));
+  if (!bufferOrErr)
+    return false;
+
+  RecordReader reader(bufferOrErr.get()->getBuffer());
+  if (!reader.read() || reader.Events.empty() ||
+      reader.Events.front().tag != RecordTag::Hash)
+    return false;
+
+  // What references resolve to may have changed with the imported modules.
+  if (!areDependenciesUnchanged(reader))
+    return false;
+
+  // Mirror indexSourceFile(): dependencies are reported even if the hash is
+  // known, symbols are not.
+  bool hashIsKnown = false;
+  for (RecordEvent &event : reader.Events) {
+    bool keepGoing = true;
+    switch (event.tag) {
+    case RecordTag::End:
+      break;
+    case RecordTag::Hash:
+      hashIsKnown = event.hash == knownHash;
+      keepGoing = consumer.recordHash(event.hash, hashIsKnown);
+      break;
+    case RecordTag::StartDependency:
+      keepGoing = consumer.startDependency(event.symbol.kind, event.name,
+                                           event.path, event.isSystem,
+                                           event.hash);
+      break;
+    case RecordTag::FinishDependency:
+      keepGoing = consumer.finishDependency(event.symbol.kind);
+      break;
+    case RecordTag::StartSourceEntity:
+    case RecordTag::RelatedEntity:
+    case RecordTag::FinishSourceEntity:
+      if (hashIsKnown) {
+        keepGoing = false;
+        break;
+      }
+      if (event.tag == RecordTag::FinishSourceEntity) {
+        keepGoing = consumer.finishSourceEntity(
+            event.symbol.kind, event.symbol.subKinds, event.symbol.roles);
+        break;
+      }
+      event.symbol.attributeNames =
+          llvm::makeArrayRef(reader.AttrNames)
+              .slice(event.firstAttr, event.numAttrs);
+      keepGoing = event.tag == RecordTag::StartSourceEntity
+                      ? consumer.startSourceEntity(event.symbol)
+                      : consumer.recordRelatedEntity(event.symbol);
+      break;
+    }
+    if (!keepGoing)
+      break;
+  }
+
+  consumer.finish();
+  return true;
+}
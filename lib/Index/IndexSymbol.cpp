@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "swift/Index/IndexSymbol.h"
+#include "swift/AST/Attr.h"
 #include "swift/AST/Decl.h"
 
 using namespace swift;
@@ -83,3 +84,50 @@ SymbolKind index::getSymbolKindForDecl(const Decl *D) {
       return SymbolKind::Unknown;
   }
 }
+
+void index::getDeclAttributeNames(const DeclAttributes &attrs,
+                                  SmallVectorImpl<StringRef> &names) {
+  for (auto attr : attrs) {
+    // Check special-case names first.
+    switch (attr->getKind()) {
+    case DAK_IBAction:
+      names.push_back("ibaction");
+      continue;
+    case DAK_IBOutlet:
+      names.push_back("iboutlet");
+      continue;
+    case DAK_IBDesignable:
+      names.push_back("ibdesignable");
+      continue;
+    case DAK_IBInspectable:
+      names.push_back("ibinspectable");
+      continue;
+    case DAK_GKInspectable:
+      names.push_back("gkinspectable");
+      continue;
+    case DAK_ObjC:
+      names.push_back(cast<ObjCAttr>(attr)->hasName() ? "objc.name" : "objc");
+      continue;
+
+    // Accessibility is reported separately.
+    case DAK_Accessibility:
+    case DAK_SetterAccessibility:
+    // Ignore these.
+    case DAK_ShowInInterface:
+    case DAK_RawDocComment:
+      continue;
+    default:
+      break;
+    }
+
+    switch (attr->getKind()) {
+    case DAK_Count:
+      break;
+#define DECL_ATTR(X, CLASS, ...)\
+    case DAK_##CLASS:\
+      names.push_back(#X);\
+      break;
+#include "swift/AST/Attr.def"
+    }
+  }
+}
@@ -62,6 +62,8 @@ class ARCEntryPointBuilder {
   NullablePtr<Constant> UnknownReleaseN;
   NullablePtr<Constant> BridgeRetainN;
   NullablePtr<Constant> BridgeReleaseN;
+  NullablePtr<Constant> RetainArray;
+  NullablePtr<Constant> ReleaseArray;
 
   // The type cache.
   NullablePtr<Type> ObjectPtrTy;
@@ -211,6 +213,27 @@ public:
     return CI;
   }
 
+  /// Create a stack buffer that can hold \p n object pointers. The buffer is
+  /// placed in the entry block of \p F, so it can be reused by any number of
+  /// createRetainArray/createReleaseArray calls in the function.
+  Value *createObjectArrayBuffer(Function &F, uint32_t n) {
+    IRBuilder EntryB(&*F.getEntryBlock().begin());
+    return EntryB.CreateAlloca(llvm::ArrayType::get(getObjectPtrTy(), n),
+                               nullptr, "rc.array");
+  }
+
+  CallInst *createRetainArray(llvm::ArrayRef<Value *> Objects, Value *Buffer) {
+    Value *Array = storeObjectArray(Objects, Buffer);
+    // Not a tail call: the callee reads the caller's stack buffer.
+    return CreateCall(getRetainArray(), {Array, getIntConstant(Objects.size())});
+  }
+
+  CallInst *createReleaseArray(llvm::ArrayRef<Value *> Objects, Value *Buffer) {
+    Value *Array = storeObjectArray(Objects, Buffer);
+    // Not a tail call: the callee reads the caller's stack buffer.
+    return CreateCall(getReleaseArray(), {Array, getIntConstant(Objects.size())});
+  }
+
   bool isNonAtomic(CallInst *I) {
     return (I->getCalledFunction()->getName().find("nonatomic") !=
             llvm::StringRef::npos);
@@ -388,6 +411,48 @@ private:
     return BridgeReleaseN.get();
   }
 
+  /// Store \p Objects into consecutive elements of \p Buffer and return a
+  /// pointer to the first element.
+  Value *storeObjectArray(llvm::ArrayRef<Value *> Objects, Value *Buffer) {
+    auto *ArrayTy = llvm::cast<llvm::PointerType>(Buffer->getType())
+                        ->getElementType();
+    for (unsigned i = 0, e = Objects.size(); i != e; ++i) {
+      Value *Elt = B.CreateConstInBoundsGEP2_32(ArrayTy, Buffer, 0, i);
+      B.CreateStore(B.CreatePointerCast(Objects[i], getObjectPtrTy()), Elt);
+    }
+    return B.CreateConstInBoundsGEP2_32(ArrayTy, Buffer, 0, 0);
+  }
+
+  /// Return a callable function for swift_retain_array.
+  Constant *getRetainArray() {
+    if (RetainArray)
+      return RetainArray.get();
+    auto *ObjectPtrPtrTy = getObjectPtrTy()->getPointerTo();
+    auto *Int32Ty = Type::getInt32Ty(getModule().getContext());
+    auto *VoidTy = Type::getVoidTy(getModule().getContext());
+
+    llvm::Constant *cache = nullptr;
+    RetainArray =
+        getRuntimeFn(getModule(), cache, "swift_retain_array", DefaultCC,
+                     {VoidTy}, {ObjectPtrPtrTy, Int32Ty}, {NoUnwind});
+    return RetainArray.get();
+  }
+
+  /// Return a callable function for swift_release_array.
+  Constant *getReleaseArray() {
+    if (ReleaseArray)
+      return ReleaseArray.get();
+    auto *ObjectPtrPtrTy = getObjectPtrTy()->getPointerTo();
+    auto *Int32Ty = Type::getInt32Ty(getModule().getContext());
+    auto *VoidTy = Type::getVoidTy(getModule().getContext());
+
+    llvm::Constant *cache = nullptr;
+    ReleaseArray =
+        getRuntimeFn(getModule(), cache, "swift_release_array", DefaultCC,
+                     {VoidTy}, {ObjectPtrPtrTy, Int32Ty}, {NoUnwind});
+    return ReleaseArray.get();
+  }
+
   Type *getObjectPtrTy() {
     if (ObjectPtrTy)
       return ObjectPtrTy.get();
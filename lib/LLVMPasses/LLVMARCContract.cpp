@@ -15,6 +15,7 @@
 #include "ARCEntryPointBuilder.h"
 #include "LLVMARCOpts.h"
 #include "swift/Basic/Fallthrough.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/TinyPtrVector.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/IR/Verifier.h"
@@ -35,6 +36,14 @@ STATISTIC(NumUnknownRetainReleasesEliminatedByMergingIntoRetainReleaseN,
 STATISTIC(NumBridgeRetainReleasesEliminatedByMergingIntoRetainReleaseN,
           "Number of bridge retain/release eliminated by merging into "
           "bridgeRetain_n/bridgeRelease_n");
+STATISTIC(NumRetainReleasesEliminatedByMergingIntoRetainReleaseArray,
+          "Number of retain/release eliminated by merging into "
+          "retain_array/release_array");
+
+/// The minimum number of adjacent retains (or releases) of distinct objects
+/// that are worth replacing with a single retain_array (or release_array).
+/// Below this the stores into the stack buffer cost more than the calls.
+static const unsigned MinRetainReleaseArraySize = 3;
 
 /// Pimpl implementation of SwiftARCContractPass.
 namespace {
@@ -57,6 +66,9 @@ struct LocalState {
 ///
 ///   - Merging together retain and release calls into retain_n, release_n
 ///   - calls.
+///   - Merging runs of retains (or releases) of distinct objects, such as the
+///     fields of an aggregate being copied or destroyed, into a single
+///     retain_array (or release_array) call.
 ///
 /// Coming into this function, we assume that the code is in canonical form:
 /// none of these calls have any uses of their return values.
@@ -85,6 +97,21 @@ private:
   /// call.
   void
   performRRNOptimization(DenseMap<Value *, LocalState> &PtrToLocalStateMap);
+
+  /// Collect the runs of retains and releases in \p BB that can be merged
+  /// into retain_array/release_array calls. This must run after the RRN
+  /// optimization so that each run refers to distinct objects.
+  void collectRetainReleaseArrayRuns(BasicBlock &BB);
+
+  /// Replace each run collected by collectRetainReleaseArrayRuns with a single
+  /// call.
+  void performRetainReleaseArrayOptimization();
+
+  /// Runs of atomic swift_retain calls on distinct objects, in order.
+  SmallVector<SmallVector<CallInst *, 4>, 4> RetainArrayRuns;
+
+  /// Runs of atomic swift_release calls on distinct objects, in order.
+  SmallVector<SmallVector<CallInst *, 4>, 4> ReleaseArrayRuns;
 };
 
 } // end anonymous namespace
@@ -253,6 +280,99 @@ performRRNOptimization(DenseMap<Value *, LocalState> &PtrToLocalStateMap) {
   }
 }
 
+void SwiftARCContractImpl::collectRetainReleaseArrayRuns(BasicBlock &BB) {
+  SmallVector<CallInst *, 4> Retains, Releases;
+  SmallPtrSet<Value *, 8> RetainedObjects, ReleasedObjects;
+
+  auto finishRun = [](SmallVectorImpl<CallInst *> &Run,
+                      SmallPtrSetImpl<Value *> &Objects,
+                      SmallVectorImpl<SmallVector<CallInst *, 4>> &Runs) {
+    if (Run.size() >= MinRetainReleaseArraySize)
+      Runs.emplace_back(Run.begin(), Run.end());
+    Run.clear();
+    Objects.clear();
+  };
+
+  for (Instruction &Inst : BB) {
+    auto Kind = classifyInstruction(Inst);
+    // Instructions that do not touch memory can't observe reference counts,
+    // so runs can be formed across them.
+    if (Kind == RT_NoMemoryAccessed)
+      continue;
+
+    auto *CI = dyn_cast<CallInst>(&Inst);
+    if (Kind == RT_Retain && B.isAtomic(CI)) {
+      Value *Object = RC->getSwiftRCIdentityRoot(CI->getArgOperand(0));
+      if (!RetainedObjects.insert(Object).second)
+        finishRun(Retains, RetainedObjects, RetainArrayRuns);
+      RetainedObjects.insert(Object);
+      Retains.push_back(CI);
+      continue;
+    }
+
+    if (Kind == RT_Release && B.isAtomic(CI)) {
+      // A retain must never be moved below a release, which may be the last
+      // reference to the retained object.
+      finishRun(Retains, RetainedObjects, RetainArrayRuns);
+      Value *Object = RC->getSwiftRCIdentityRoot(CI->getArgOperand(0));
+      if (!ReleasedObjects.insert(Object).second)
+        finishRun(Releases, ReleasedObjects, ReleaseArrayRuns);
+      ReleasedObjects.insert(Object);
+      Releases.push_back(CI);
+      continue;
+    }
+
+    // Anything else that touches memory may make the reference count
+    // observable (e.g. by publishing the object to another thread), so it ends
+    // both runs.
+    finishRun(Retains, RetainedObjects, RetainArrayRuns);
+    finishRun(Releases, ReleasedObjects, ReleaseArrayRuns);
+  }
+
+  finishRun(Retains, RetainedObjects, RetainArrayRuns);
+  finishRun(Releases, ReleasedObjects, ReleaseArrayRuns);
+}
+
+void SwiftARCContractImpl::performRetainReleaseArrayOptimization() {
+  if (RetainArrayRuns.empty() && ReleaseArrayRuns.empty())
+    return;
+
+  // Share one stack buffer, sized for the longest run, between all of the
+  // calls in the function.
+  size_t MaxRunSize = 0;
+  for (auto &Run : RetainArrayRuns)
+    MaxRunSize = std::max(MaxRunSize, Run.size());
+  for (auto &Run : ReleaseArrayRuns)
+    MaxRunSize = std::max(MaxRunSize, Run.size());
+  Value *Buffer = B.createObjectArrayBuffer(F, MaxRunSize);
+
+  // Each new call is placed at the last call of its run. Every object in the
+  // run is available there, and by construction nothing between the first and
+  // the last call can observe the delayed reference count changes.
+  auto mergeRun = [&](ArrayRef<CallInst *> Run, bool IsRetain) {
+    SmallVector<Value *, 4> Objects;
+    for (auto *CI : Run)
+      Objects.push_back(CI->getArgOperand(0));
+    B.setInsertPoint(Run.back());
+    if (IsRetain)
+      B.createRetainArray(Objects, Buffer);
+    else
+      B.createReleaseArray(Objects, Buffer);
+    for (auto *CI : Run) {
+      CI->eraseFromParent();
+      ++NumRetainReleasesEliminatedByMergingIntoRetainReleaseArray;
+    }
+    --NumRetainReleasesEliminatedByMergingIntoRetainReleaseArray;
+  };
+
+  for (auto &Run : RetainArrayRuns)
+    mergeRun(Run, /*IsRetain*/ true);
+  for (auto &Run : ReleaseArrayRuns)
+    mergeRun(Run, /*IsRetain*/ false);
+  RetainArrayRuns.clear();
+  ReleaseArrayRuns.clear();
+  Changed = true;
+}
 
 bool SwiftARCContractImpl::run() {
   // intra-BB retain/release merging.
@@ -272,6 +392,8 @@ bool SwiftARCContractImpl::run() {
       case RT_ReleaseN:
       case RT_UnknownReleaseN:
       case RT_BridgeReleaseN:
+      case RT_RetainArray:
+      case RT_ReleaseArray:
         llvm_unreachable("These are only created by LLVMARCContract !");
       // Delete all fix lifetime and end borrow instructions. After llvm-ir they
       // have no use and show up as calls in the final binary.
@@ -368,8 +490,11 @@ bool SwiftARCContractImpl::run() {
     // Perform the RRNOptimization.
     performRRNOptimization(PtrToLocalStateMap);
     PtrToLocalStateMap.clear();
+
+    collectRetainReleaseArrayRuns(BB);
   }
 
+  performRetainReleaseArrayOptimization();
   return Changed;
 }
 
@@ -97,6 +97,8 @@ static bool canonicalizeInputFunction(Function &F, ARCEntryPointBuilder &B,
       case RT_ReleaseN:
       case RT_UnknownReleaseN:
       case RT_BridgeReleaseN:
+      case RT_RetainArray:
+      case RT_ReleaseArray:
         llvm_unreachable("These are only created by LLVMARCContract !");
       case RT_Unknown:
       case RT_BridgeRelease:
@@ -283,6 +285,8 @@ static bool performLocalReleaseMotion(CallInst &Release, BasicBlock &BB,
     case RT_UnknownReleaseN:
     case RT_BridgeReleaseN:
     case RT_ReleaseN:
+    case RT_RetainArray:
+    case RT_ReleaseArray:
         llvm_unreachable("These are only created by LLVMARCContract !");
     case RT_NoMemoryAccessed:
       // Skip over random instructions that don't touch memory.  They don't need
@@ -434,6 +438,8 @@ static bool performLocalRetainMotion(CallInst &Retain, BasicBlock &BB,
     case RT_ReleaseN:
     case RT_UnknownReleaseN:
     case RT_BridgeReleaseN:
+    case RT_RetainArray:
+    case RT_ReleaseArray:
         llvm_unreachable("These are only created by LLVMARCContract !");
     case RT_NoMemoryAccessed:
     case RT_AllocObject:
@@ -488,9 +494,13 @@ static bool performLocalRetainMotion(CallInst &Retain, BasicBlock &BB,
     }
 
     case RT_Unknown:
-      // Loads cannot affect the retain.
-      if (isa<LoadInst>(CurInst))
+      // Loads cannot affect the retain, except for volatile ones, which
+      // may be IRGen's inline uniqueness checks reading the reference count.
+      if (auto *Load = dyn_cast<LoadInst>(&CurInst)) {
+        if (Load->isVolatile())
+          goto OutOfLoop;
         continue;
+      }
 
       // Load, store, memcpy etc can't do a release.
       if (isa<LoadInst>(CurInst) || isa<StoreInst>(CurInst) ||
@@ -589,6 +599,8 @@ static DtorKind analyzeDestructor(Value *P) {
       case RT_ReleaseN:
       case RT_UnknownReleaseN:
       case RT_BridgeReleaseN:
+      case RT_RetainArray:
+      case RT_ReleaseArray:
         llvm_unreachable("These are only created by LLVMARCContract !");
       case RT_NoMemoryAccessed:
       case RT_AllocObject:
@@ -702,6 +714,8 @@ static bool performStoreOnlyObjectElimination(CallInst &Allocation,
     case RT_ReleaseN:
     case RT_UnknownReleaseN:
     case RT_BridgeReleaseN:
+    case RT_RetainArray:
+    case RT_ReleaseArray:
       llvm_unreachable("These are only created by LLVMARCContract !");
     case RT_AllocObject:
       // If this is a different swift_allocObject than we started with, then
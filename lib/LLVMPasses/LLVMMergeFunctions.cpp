@@ -13,8 +13,10 @@
 // merging identical functions, it merges functions which only differ by a few
 // constants in certain instructions.
 // Currently this is very Swift specific in the sense that it's intended to
-// merge specialized functions which only differ by loading different metadata
-// pointers.
+// merge specialized functions which only differ by referencing different
+// metadata, witness tables or type-specific functions. The differing constants
+// are passed to the merged function as additional parameters, if the code
+// size saved by merging outweighs the cost of passing them.
 // TODO: It could make sense to generalize this pass and move it to LLVM.
 //
 // This pass should run after LLVM's MergeFunctions pass, because it works best
@@ -302,7 +304,8 @@ private:
   /// 2. Constant offset, (using GEPOperator::accumulateConstantOffset method).
   /// 3. Pointer operand type (using cmpType method).
   /// 4. Number of operands.
-  /// 5. Compare operands, using cmpValues method.
+  /// 5. Compare index operands, using cmpValues method. The pointer operands
+  ///    are compared by the caller.
   int cmpGEPs(const GEPOperator *GEPL, const GEPOperator *GEPR);
   int cmpGEPs(const GetElementPtrInst *GEPL, const GetElementPtrInst *GEPR) {
     return cmpGEPs(cast<GEPOperator>(GEPL), cast<GEPOperator>(GEPR));
@@ -1024,7 +1027,7 @@ int FunctionComparator::cmpGEPs(const GEPOperator *GEPL,
   if (int Res = cmpNumbers(GEPL->getNumOperands(), GEPR->getNumOperands()))
     return Res;
 
-  for (unsigned i = 0, e = GEPL->getNumOperands(); i != e; ++i) {
+  for (unsigned i = 1, e = GEPL->getNumOperands(); i != e; ++i) {
     if (int Res = cmpValues(GEPL->getOperand(i), GEPR->getOperand(i)))
       return Res;
   }
@@ -1100,12 +1103,45 @@ int FunctionComparator::cmpValues(const Value *L, const Value *R) const {
   return cmpNumbers(LeftSN.first->second, RightSN.first->second);
 }
 
-static bool isEligibleForConstantSharing(const Instruction *I) {
+/// Returns true if the \p OpIdx's operand of \p I may be replaced by a
+/// parameter of the merged function if it is a constant which differs between
+/// the functions.
+///
+/// Besides plain constants, this lets us parameterize the references to
+/// globals which typically differ between generic specializations: metadata
+/// and witness tables (loaded, stored, compared, passed as arguments or
+/// returned) and the callees of type-specific calls.
+static bool isEligibleForConstantSharing(const Instruction *I,
+                                         unsigned OpIdx) {
   switch (I->getOpcode()) {
     case Instruction::Load:
     case Instruction::Store:
+    case Instruction::ICmp:
+    case Instruction::Select:
+    case Instruction::PHI:
+    case Instruction::Ret:
+    case Instruction::InsertValue:
+    case Instruction::BitCast:
+    case Instruction::PtrToInt:
+    case Instruction::IntToPtr:
+      return true;
+    case Instruction::GetElementPtr:
+      // Struct indices must stay constant, so only the base address can be
+      // parameterized.
+      return OpIdx == 0;
     case Instruction::Call:
+    case Instruction::Invoke: {
+      // Intrinsics may require constant arguments and can't be called
+      // indirectly.
+      ImmutableCallSite CS(I);
+      if (CS.isInlineAsm())
+        return false;
+      if (const Function *Callee = CS.getCalledFunction()) {
+        if (Callee->isIntrinsic())
+          return false;
+      }
       return true;
+    }
     default:
       return false;
   }
@@ -1123,25 +1159,10 @@ int FunctionComparator::cmpOperands(const Instruction *L, const Instruction *R,
   if (!isa<Constant>(OpL) || !isa<Constant>(OpR))
     return Res;
 
-  if (!isEligibleForConstantSharing(L))
+  if (!isEligibleForConstantSharing(L, opIdx) ||
+      !isEligibleForConstantSharing(R, opIdx))
     return Res;
 
-  if (const CallInst *CL = dyn_cast<CallInst>(L)) {
-    if (CL->isInlineAsm())
-      return Res;
-    if (Function *CalleeL = CL->getCalledFunction()) {
-      if (CalleeL->isIntrinsic())
-        return Res;
-    }
-    const CallInst *CR = cast<CallInst>(R);
-    if (CR->isInlineAsm())
-      return Res;
-    if (Function *CalleeR = CR->getCalledFunction()) {
-      if (CalleeR->isIntrinsic())
-        return Res;
-    }
-  }
-
   if (cmpTypes(OpL->getType(), OpR->getType()))
     return Res;
 
@@ -1167,8 +1188,7 @@ int FunctionComparator::cmpBasicBlocks(const BasicBlock *BBL,
       return -1;
 
     if (GEPL && GEPR) {
-      if (int Res =
-              cmpValues(GEPL->getPointerOperand(), GEPR->getPointerOperand()))
+      if (int Res = cmpOperands(GEPL, GEPR, GEPL->getPointerOperandIndex()))
         return Res;
       if (int Res = cmpGEPs(GEPL, GEPR))
         return Res;
@@ -1522,6 +1542,9 @@ private:
 
   bool deriveParams(ParamInfos &Params, FunctionInfos &FInfos);
 
+  bool isProfitable(const FunctionInfos &FInfos,
+                    const ParamInfos &Params) const;
+
   bool constsDiffer(const FunctionInfos &FInfos, unsigned OpIdx);
 
   bool tryMapToParameter(FunctionInfos &FInfos, unsigned OpIdx,
@@ -1627,6 +1650,27 @@ bool SwiftMergeFunctions::doSanityCheck(std::vector<WeakVH> &Worklist) {
   return true;
 }
 
+/// The estimated code size of a call, relative to other instructions.
+static const unsigned CallCost = 5;
+
+/// Returns a rough estimate of the code size of \p F.
+static unsigned getFunctionSize(Function *F) {
+  unsigned Size = 0;
+  for (BasicBlock &BB : *F) {
+    for (Instruction &I : BB) {
+      if (CallSite CS = CallSite(&I)) {
+        Function *Callee = CS.getCalledFunction();
+        if (!Callee || !Callee->isIntrinsic()) {
+          Size += CallCost;
+          continue;
+        }
+      }
+      Size += 1;
+    }
+  }
+  return Size;
+}
+
 /// Returns true if function \p F is eligible for merging.
 static bool isEligibleFunction(Function *F) {
   if (F->isDeclaration())
@@ -1638,24 +1682,10 @@ static bool isEligibleFunction(Function *F) {
   if (F->getFunctionType()->isVarArg())
     return false;
   
-  unsigned Benefit = 0;
-
   // We don't want to merge very small functions, because the overhead of
   // adding creating thunks and/or adding parameters to the call sites
   // outweighs the benefit.
-  for (BasicBlock &BB : *F) {
-    for (Instruction &I : BB) {
-      if (CallSite CS = CallSite(&I)) {
-        Function *Callee = CS.getCalledFunction();
-        if (!Callee || !Callee->isIntrinsic()) {
-          Benefit += 5;
-          continue;
-        }
-      }
-      Benefit += 1;
-    }
-  }
-  if (Benefit < FunctionMergeThreshold)
+  if (getFunctionSize(F) < FunctionMergeThreshold)
     return false;
   
   return true;
@@ -1828,13 +1858,13 @@ bool SwiftMergeFunctions::tryMergeEquivalenceClass(FunctionEntry *FirstInClass)
   // tries to a small number, because this is quadratic.
   while (FInfos.size() >= 2 && Try++ < 4) {
     ParamInfos Params;
-    bool Merged = deriveParams(Params, FInfos);
+    bool Merged = deriveParams(Params, FInfos) && isProfitable(FInfos, Params);
     if (Merged) {
       mergeWithParams(FInfos, Params);
       Changed = true;
     } else {
-      // We ran out of parameters. Remove the function from the set which
-      // differs most from the first function.
+      // We ran out of parameters or merging would not pay off. Remove the
+      // function from the set which differs most from the first function.
       Removed.push_back(removeFuncWithMostParams(FInfos));
     }
     if (Merged || FInfos.size() < 2) {
@@ -1875,17 +1905,15 @@ bool SwiftMergeFunctions::deriveParams(ParamInfos &Params,
 
   // Iterate over all instructions synchronously in all functions.
   do {
-    if (isEligibleForConstantSharing(FirstFI.CurrentInst)) {
-      for (unsigned OpIdx = 0, NumOps = FirstFI.CurrentInst->getNumOperands();
-           OpIdx != NumOps; ++OpIdx) {
-
-        if (constsDiffer(FInfos, OpIdx)) {
-          // This instruction has operands which differ in at least some
-          // functions. So we need to parameterize it.
-          if (!tryMapToParameter(FInfos, OpIdx, Params)) {
-            // We ran out of parameters.
-            return false;
-          }
+    for (unsigned OpIdx = 0, NumOps = FirstFI.CurrentInst->getNumOperands();
+         OpIdx != NumOps; ++OpIdx) {
+      if (isEligibleForConstantSharing(FirstFI.CurrentInst, OpIdx) &&
+          constsDiffer(FInfos, OpIdx)) {
+        // This instruction has operands which differ in at least some
+        // functions. So we need to parameterize it.
+        if (!tryMapToParameter(FInfos, OpIdx, Params)) {
+          // We ran out of parameters.
+          return false;
         }
       }
     }
@@ -1897,6 +1925,35 @@ bool SwiftMergeFunctions::deriveParams(ParamInfos &Params,
   return true;
 }
 
+/// Returns true if merging the functions in \p FInfos with the additional
+/// parameters \p Params reduces code size.
+///
+/// The merged function replaces all but one of the original function bodies.
+/// The basic overhead of the thunks is already accounted for by only
+/// considering functions above the FunctionMergeThreshold. But each added
+/// parameter must be passed by every thunk (or caller) and lifting a callee
+/// into a parameter turns a direct call into an indirect call.
+bool SwiftMergeFunctions::isProfitable(const FunctionInfos &FInfos,
+                                       const ParamInfos &Params) const {
+  unsigned NumFuncs = FInfos.size();
+  unsigned Benefit = (NumFuncs - 1) * getFunctionSize(FInfos.front().F);
+
+  unsigned Cost = 0;
+  for (const ParamInfo &PI : Params) {
+    Cost += NumFuncs;
+    for (const OpLocation &OL : PI.Uses) {
+      ImmutableCallSite CS(OL.I);
+      if (CS && CS.isCallee(&OL.I->getOperandUse(OL.OpIndex)))
+        Cost += 1;
+    }
+  }
+
+  DEBUG(dbgs() << "  merge " << NumFuncs << " functions with "
+               << Params.size() << " params: benefit=" << Benefit
+               << ", cost=" << Cost << '\n');
+  return Benefit > Cost;
+}
+
 /// Returns true if the \p OpIdx's constant operand in the current instruction
 /// does differ in any of the functions in \p FInfos.
 bool SwiftMergeFunctions::constsDiffer(const FunctionInfos &FInfos,
@@ -0,0 +1,107 @@
+//===--- LLVMProfileFirstHit.cpp - Record only the first hit of counters --===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// This pass runs after the lowering of the instrprof intrinsics. It replaces
+// each counter increment
+//
+//   %c = load i64, i64* @__profc_f[i]
+//   %c1 = add i64 %c, 1
+//   store i64 %c1, i64* @__profc_f[i]
+//
+// by a store of 1. The counters then only record whether a region was
+// executed, which is all that coverage needs. The store doesn't depend on the
+// previous value of the counter, so there is no load-add-store chain through
+// memory in loops any more.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "swift-profile-first-hit"
+#include "swift/LLVMPasses/Passes.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/Pass.h"
+#include "llvm/ProfileData/InstrProf.h"
+
+using namespace llvm;
+using namespace swift;
+
+STATISTIC(NumCounterUpdatesReplaced,
+          "Number of profile counter increments replaced by stores");
+
+//===----------------------------------------------------------------------===//
+//                          SwiftProfileFirstHit Pass
+//===----------------------------------------------------------------------===//
+
+char SwiftProfileFirstHit::ID = 0;
+
+INITIALIZE_PASS(SwiftProfileFirstHit,
+                "swift-profile-first-hit",
+                "Swift first-hit profile counters", false, false)
+
+FunctionPass *swift::createSwiftProfileFirstHitPass() {
+  initializeSwiftProfileFirstHitPass(*PassRegistry::getPassRegistry());
+  return new SwiftProfileFirstHit();
+}
+
+/// Returns true if \p Ptr is the address of a counter created by the
+/// lowering of the instrprof intrinsics.
+static bool isProfileCounterAddress(Value *Ptr) {
+  Ptr = Ptr->stripPointerCasts();
+  if (auto *CE = dyn_cast<ConstantExpr>(Ptr)) {
+    if (CE->getOpcode() == Instruction::GetElementPtr)
+      Ptr = CE->getOperand(0);
+  } else if (auto *GEP = dyn_cast<GetElementPtrInst>(Ptr)) {
+    Ptr = GEP->getPointerOperand();
+  }
+  auto *GV = dyn_cast<GlobalVariable>(Ptr);
+  return GV && GV->getName().startswith(getInstrProfCountersVarPrefix());
+}
+
+bool SwiftProfileFirstHit::runOnFunction(Function &F) {
+  bool Changed = false;
+  for (BasicBlock &BB : F) {
+    for (auto II = BB.begin(), IE = BB.end(); II != IE;) {
+      auto *SI = dyn_cast<StoreInst>(&*II);
+      ++II;
+      if (!SI || !isProfileCounterAddress(SI->getPointerOperand()))
+        continue;
+
+      // Match the increment of the value that is loaded from the counter.
+      auto *Add = dyn_cast<BinaryOperator>(SI->getValueOperand());
+      if (!Add || Add->getOpcode() != Instruction::Add)
+        continue;
+      auto *Step = dyn_cast<ConstantInt>(Add->getOperand(1));
+      auto *LI = dyn_cast<LoadInst>(Add->getOperand(0));
+      if (!Step || !Step->isOne() || !LI ||
+          LI->getPointerOperand() != SI->getPointerOperand())
+        continue;
+
+      SI->setOperand(0, ConstantInt::get(Add->getType(), 1));
+      if (Add->use_empty()) {
+        if (&*II == Add)
+          ++II;
+        Add->eraseFromParent();
+        if (LI->use_empty()) {
+          if (&*II == LI)
+            ++II;
+          LI->eraseFromParent();
+        }
+      }
+      ++NumCounterUpdatesReplaced;
+      Changed = true;
+    }
+  }
+  return Changed;
+}
@@ -37,11 +37,13 @@ ModRefInfo SwiftAAResult::getModRefInfo(llvm::ImmutableCallSite CS,
   // We know at compile time that certain entry points do not modify any
   // compiler-visible state ever. Quickly check if we have one of those
   // instructions and return if so.
-  if (MRI_NoModRef == getConservativeModRefForKind(*CS.getInstruction()))
+  ModRefInfo KindMRI = getConservativeModRefForKind(*CS.getInstruction());
+  if (MRI_NoModRef == KindMRI)
     return MRI_NoModRef;
 
-  // Otherwise, delegate to the rest of the AA ModRefInfo machinery.
-  return AAResultBase::getModRefInfo(CS, Loc);
+  // Otherwise, delegate to the rest of the AA ModRefInfo machinery, but never
+  // report more than the entry point is known to do.
+  return ModRefInfo(KindMRI & AAResultBase::getModRefInfo(CS, Loc));
 }
 
 //===----------------------------------------------------------------------===//
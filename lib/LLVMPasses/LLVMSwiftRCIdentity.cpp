@@ -44,6 +44,8 @@ SwiftRCIdentity::stripReferenceForwarding(llvm::Value *Val) {
   case RT_ReleaseN:
   case RT_UnknownReleaseN:
   case RT_BridgeReleaseN:
+  case RT_RetainArray:
+  case RT_ReleaseArray:
   case RT_FixLifetime:
   case RT_Retain:
   case RT_UnknownRetain:
@@ -304,8 +304,37 @@ static void diagnoseEmbeddedNul(DiagnosticEngine *Diags, const char *Ptr) {
       .fixItRemoveChars(NulLoc, NulEndLoc);
 }
 
+//===----------------------------------------------------------------------===//
+// Fast scanning
+//===----------------------------------------------------------------------===//
+//
+// Most bytes inside comments, string literals and identifiers are plain ASCII
+// that needs no processing at all. The loops below skip runs of such bytes
+// using the clang::CharInfo classification table before falling back to the
+// full, per-character handling for anything else.
+
+/// Returns true if \p c needs no handling inside a // comment: any ASCII
+/// character other than nul and the line terminators.
+static inline bool isPlainLineCommentChar(char c) {
+  return (signed char)c > 0 && !clang::isVerticalWhitespace(c);
+}
+
+/// Returns true if \p c needs no handling inside a /* comment.
+static inline bool isPlainBlockCommentChar(char c) {
+  return isPlainLineCommentChar(c) && c != '*' && c != '/';
+}
+
+/// Returns true if \p c needs no handling inside a string literal: printable
+/// ASCII other than quotes and backslash.
+static inline bool isPlainStringLiteralChar(char c) {
+  return clang::isPrintable(c) && c != '"' && c != '\'' && c != '\\';
+}
+
 void Lexer::skipToEndOfLine() {
   while (1) {
+    while (isPlainLineCommentChar(*CurPtr))
+      ++CurPtr;
+
     switch (*CurPtr++) {
     case '\n':
     case '\r':
@@ -359,6 +388,9 @@ void Lexer::skipSlashStarComment() {
   unsigned Depth = 1;
   
   while (1) {
+    while (isPlainBlockCommentChar(*CurPtr))
+      ++CurPtr;
+
     switch (*CurPtr++) {
     case '*':
       // Check for a '*/'
@@ -566,8 +598,15 @@ void Lexer::lexIdentifier() {
   assert(didStart && "Unexpected start");
   (void) didStart;
 
-  // Lex [a-zA-Z_$0-9[[:XID_Continue:]]]*
-  while (advanceIfValidContinuationOfIdentifier(CurPtr, BufferEnd));
+  // Lex [a-zA-Z_$0-9[[:XID_Continue:]]]*, handling ASCII runs directly and
+  // only decoding UTF-8 for the rest.
+  while (true) {
+    while (clang::isIdentifierBody(*CurPtr, /*dollar*/true))
+      ++CurPtr;
+    if ((signed char)*CurPtr >= 0 ||
+        !advanceIfValidContinuationOfIdentifier(CurPtr, BufferEnd))
+      break;
+  }
 
   tok Kind = kindOfIdentifier(StringRef(TokStart, CurPtr-TokStart), InSILMode);
   return formToken(Kind, TokStart);
@@ -1249,6 +1288,10 @@ void Lexer::lexStringLiteral() {
   bool wasErroneous = false;
   
   while (true) {
+    // Skip over the characters that lexCharacter() would just return as is.
+    while (isPlainStringLiteralChar(*CurPtr))
+      ++CurPtr;
+
     if (*CurPtr == '\\' && *(CurPtr + 1) == '(') {
       // Consume tokens until we hit the corresponding ')'.
       CurPtr += 2;
@@ -1666,6 +1709,8 @@ Restart:
   case '\t':
   case '\f':
   case '\v':
+    while (clang::isHorizontalWhitespace(*CurPtr))
+      ++CurPtr;
     goto Restart;  // Skip whitespace.
 
   case -1:
@@ -24,6 +24,8 @@ using namespace swift;
 using namespace Lowering;
 
 STATISTIC(NumFuncLinked, "Number of SIL functions linked");
+STATISTIC(NumFuncLinksSkipped,
+          "Number of SIL functions not relinked because they did not change");
 
 //===----------------------------------------------------------------------===//
 //                                  Utility
@@ -67,6 +69,13 @@ bool SILLinkerVisitor::processFunction(SILFunction *F) {
     F = NewFn;
   }
 
+  // The SILLinker pass links every function in the module on each run.
+  // Don't walk a body again if nothing changed since it was last linked.
+  if (isLinkAll() && F->isLinkedAll()) {
+    ++NumFuncLinksSkipped;
+    return false;
+  }
+
   ++NumFuncLinked;
 
   // Try to transitively deserialize everything referenced by this
@@ -371,6 +380,11 @@ bool SILLinkerVisitor::process() {
         }
       }
     }
+
+    // Everything Fn references has now been linked; linking it again is
+    // pointless until its body changes.
+    if (isLinkAll())
+      Fn->setLinkedAll();
   }
 
   // If we return true, we deserialized at least one function.
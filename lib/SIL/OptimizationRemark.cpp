@@ -0,0 +1,169 @@
+//===--- OptimizationRemark.cpp - Optimization diagnostics ----------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/SIL/OptimizationRemark.h"
+#include "swift/AST/ASTContext.h"
+#include "swift/AST/Decl.h"
+#include "swift/AST/DiagnosticEngine.h"
+#include "swift/AST/DiagnosticsSIL.h"
+#include "swift/Basic/Demangle.h"
+#include "swift/Basic/SourceManager.h"
+#include "swift/SIL/SILFunction.h"
+#include "swift/SIL/SILInstruction.h"
+#include "swift/SIL/SILModule.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/Regex.h"
+#include "llvm/Support/YAMLTraits.h"
+
+using namespace swift;
+using namespace OptRemark;
+
+Argument::Argument(StringRef Key, int N)
+    : Key(Key), Val(llvm::itostr(N)) {}
+
+Argument::Argument(StringRef Key, long N)
+    : Key(Key), Val(llvm::itostr(N)) {}
+
+Argument::Argument(StringRef Key, long long N)
+    : Key(Key), Val(llvm::itostr(N)) {}
+
+Argument::Argument(StringRef Key, unsigned N)
+    : Key(Key), Val(llvm::utostr(N)) {}
+
+Argument::Argument(StringRef Key, unsigned long N)
+    : Key(Key), Val(llvm::utostr(N)) {}
+
+Argument::Argument(StringRef Key, unsigned long long N)
+    : Key(Key), Val(llvm::utostr(N)) {}
+
+Argument::Argument(StringRef Key, SILFunction *F)
+    : Key(Key),
+      Val(Demangle::demangleSymbolAsString(
+          F->getName().data(), F->getName().size(),
+          Demangle::DemangleOptions::SimplifiedUIDemangleOptions())) {
+  if (F->hasLocation())
+    Loc = F->getLocation().getSourceLoc();
+}
+
+Argument::Argument(StringRef Key, SILType Ty) : Key(Key) {
+  llvm::raw_string_ostream OS(Val);
+  Ty.print(OS);
+}
+
+Argument::Argument(StringRef Key, ValueDecl *D) : Key(Key), Loc(D->getLoc()) {
+  llvm::raw_string_ostream OS(Val);
+  D->getFullName().printPretty(OS);
+}
+
+RemarkBase::RemarkBase(RemarkKind Kind, StringRef Identifier,
+                       SILInstruction &I)
+    : Kind(Kind), Identifier(Identifier), Location(I.getLoc().getSourceLoc()),
+      Function(I.getFunction()) {}
+
+std::string RemarkBase::getMsg() const {
+  std::string Msg;
+  for (const Argument &Arg : Args)
+    Msg += Arg.Val;
+  return Msg;
+}
+
+static bool matchesPattern(const std::shared_ptr<llvm::Regex> &Pattern,
+                           StringRef PassName) {
+  return Pattern && Pattern->match(PassName);
+}
+
+Emitter::Emitter(StringRef PassName, SILModule &M)
+    : Module(M), PassName(PassName),
+      PassedEnabled(
+          matchesPattern(M.getOptions().OptRemarkPassedPattern, PassName)),
+      MissedEnabled(
+          matchesPattern(M.getOptions().OptRemarkMissedPattern, PassName)) {}
+
+bool Emitter::isEnabled(RemarkKind Kind) const {
+  if (Module.getOptRecordStream())
+    return true;
+  return Kind == RemarkKind::Passed ? PassedEnabled : MissedEnabled;
+}
+
+LLVM_YAML_IS_SEQUENCE_VECTOR(swift::OptRemark::Argument)
+
+namespace llvm {
+namespace yaml {
+
+template <> struct MappingTraits<swift::SourceLoc> {
+  static void mapping(IO &io, swift::SourceLoc &Loc) {
+    assert(io.outputting() && "input not implemented");
+
+    auto *SM = static_cast<swift::SourceManager *>(io.getContext());
+    StringRef File = SM->getBufferIdentifierForLoc(Loc);
+    unsigned Line, Col;
+    std::tie(Line, Col) = SM->getLineAndColumn(Loc);
+
+    io.mapRequired("File", File);
+    io.mapRequired("Line", Line);
+    io.mapRequired("Column", Col);
+  }
+
+  static const bool flow = true;
+};
+
+template <> struct MappingTraits<swift::OptRemark::Argument> {
+  static void mapping(IO &io, swift::OptRemark::Argument &A) {
+    assert(io.outputting() && "input not implemented");
+
+    io.mapRequired(A.Key.c_str(), A.Val);
+    if (A.Loc.isValid())
+      io.mapOptional("DebugLoc", A.Loc);
+  }
+};
+
+template <> struct MappingTraits<swift::OptRemark::RemarkBase *> {
+  static void mapping(IO &io, swift::OptRemark::RemarkBase *&R) {
+    assert(io.outputting() && "input not implemented");
+
+    bool Passed = R->getKind() == swift::OptRemark::RemarkKind::Passed;
+    if (!io.mapTag("!Passed", Passed))
+      io.mapTag("!Missed", !Passed);
+
+    StringRef PassName = R->getPassName();
+    StringRef Id = R->getIdentifier();
+    std::string FnName = R->getFunction()->getName();
+    swift::SourceLoc Loc = R->getLocation();
+
+    io.mapRequired("Pass", PassName);
+    io.mapRequired("Name", Id);
+    if (Loc.isValid())
+      io.mapOptional("DebugLoc", Loc);
+    io.mapRequired("Function", FnName);
+    io.mapOptional("Args", R->getArgs());
+  }
+};
+
+} // end namespace yaml
+} // end namespace llvm
+
+void Emitter::emitRemark(RemarkBase &R) {
+  bool Shown = R.getKind() == RemarkKind::Passed ? PassedEnabled
+                                                 : MissedEnabled;
+  if (Shown) {
+    auto &Diags = Module.getASTContext().Diags;
+    if (R.getKind() == RemarkKind::Passed)
+      Diags.diagnose(R.getLocation(), diag::opt_remark_passed, R.getMsg());
+    else
+      Diags.diagnose(R.getLocation(), diag::opt_remark_missed, R.getMsg());
+  }
+
+  if (auto *Out = Module.getOptRecordStream()) {
+    RemarkBase *P = &R;
+    *Out << P;
+  }
+}
@@ -235,3 +235,10 @@ ScopeCloner::getOrCreateClonedScope(const SILDebugScope *OrigScope) {
 bool SILBasicBlock::isEntry() const {
   return this == &*getParent()->begin();
 }
+
+bool SILBasicBlock::isProfiledCold() const {
+  if (ProfileCount)
+    return *ProfileCount == 0;
+  auto EntryCount = getParent()->getEntryCount();
+  return EntryCount && *EntryCount == 0;
+}
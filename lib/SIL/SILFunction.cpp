@@ -85,19 +85,29 @@ SILFunction::SILFunction(SILModule &Module, SILLinkage Linkage, StringRef Name,
       Bare(isBareSILFunction), Transparent(isTrans), Fragile(isFragile),
       Thunk(isThunk), ClassVisibility(classVisibility), GlobalInitFlag(false),
       InlineStrategy(inlineStrategy), Linkage(unsigned(Linkage)),
-      KeepAsPublic(false), EffectsKindAttr(E) {
+      KeepAsPublic(false), EffectsKindAttr(E),
+      ChangeStamp(Module.allocateChangeStamp()) {
   if (InsertBefore)
     Module.functions.insert(SILModule::iterator(InsertBefore), this);
   else
     Module.functions.push_back(this);
 
   Module.removeFromZombieList(Name);
+  Module.noteFunctionChanged(this);
 
   // Set our BB list to have this function as its parent. This enables us to
   // splice efficiently basic blocks in between functions.
   BlockList.Parent = this;
 }
 
+void SILFunction::noteBodyChanged() {
+  // The module only needs to hear about the first change since it last
+  // cleared its changes.
+  if (!Module.isChangeStampUncleared(ChangeStamp))
+    Module.noteFunctionChanged(this);
+  ChangeStamp = Module.allocateChangeStamp();
+}
+
 SILFunction::~SILFunction() {
   // If the function is recursive, a function_ref inst inside of the function
   // will give the function a non-zero ref count triggering the assertion. Thus
@@ -66,24 +66,37 @@ SILBasicBlock *llvm::ilist_traits<SILInstruction>::getContainingBlock() {
 }
 
 
+/// Records that the function containing \p BB changed, if there is one.
+static void noteBodyChanged(SILBasicBlock *BB) {
+  if (SILFunction *F = BB->getParent())
+    F->noteBodyChanged();
+}
+
 void llvm::ilist_traits<SILInstruction>::addNodeToList(SILInstruction *I) {
   assert(I->ParentBB == nullptr && "Already in a list!");
   I->ParentBB = getContainingBlock();
+  noteBodyChanged(I->ParentBB);
 }
 
 void llvm::ilist_traits<SILInstruction>::removeNodeFromList(SILInstruction *I) {
   // When an instruction is removed from a BB, clear the parent pointer.
   assert(I->ParentBB && "Not in a list!");
+  noteBodyChanged(I->ParentBB);
   I->ParentBB = nullptr;
 }
 
 void llvm::ilist_traits<SILInstruction>::
 transferNodesFromList(llvm::ilist_traits<SILInstruction> &L2,
                       instr_iterator first, instr_iterator last) {
+  SILBasicBlock *ThisParent = getContainingBlock();
+  SILBasicBlock *OtherParent = L2.getContainingBlock();
+  noteBodyChanged(ThisParent);
+  if (OtherParent->getParent() != ThisParent->getParent())
+    noteBodyChanged(OtherParent);
+
   // If transferring instructions within the same basic block, no reason to
   // update their parent pointers.
-  SILBasicBlock *ThisParent = getContainingBlock();
-  if (ThisParent == L2.getContainingBlock()) return;
+  if (ThisParent == OtherParent) return;
 
   // Update the parent fields in the instructions.
   for (; first != last; ++first)
@@ -956,6 +969,10 @@ bool SILInstruction::isAllocatingStack() const {
     if (ARI->canAllocOnStack())
       return true;
   }
+  if (auto *PAI = dyn_cast<PartialApplyInst>(this)) {
+    if (PAI->canAllocOnStack())
+      return true;
+  }
   return false;
 }
 
@@ -994,6 +1011,10 @@ bool SILInstruction::isTriviallyDuplicatable() const {
     if (ARI->canAllocOnStack())
       return false;
   }
+  if (auto *PAI = dyn_cast<PartialApplyInst>(this)) {
+    if (PAI->canAllocOnStack())
+      return false;
+  }
 
   if (isa<OpenExistentialAddrInst>(this) ||
       isa<OpenExistentialRefInst>(this) ||
@@ -439,7 +439,8 @@ PartialApplyInst::PartialApplyInst(SILDebugLocation Loc, SILValue Callee,
     // should derive the type of its result by partially applying the callee's
     // type.
     : ApplyInstBase(ValueKind::PartialApplyInst, Loc, Callee, SubstCalleeTy,
-                    Subs, Args, TypeDependentOperands, ClosureType) {}
+                    Subs, Args, TypeDependentOperands, ClosureType),
+      StackPromotable(false) {}
 
 PartialApplyInst *
 PartialApplyInst::create(SILDebugLocation Loc, SILValue Callee,
@@ -25,6 +25,7 @@
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/YAMLTraits.h"
 #include <functional>
 using namespace swift;
 using namespace Lowering;
@@ -99,6 +100,13 @@ SILModule::~SILModule() {
     F.dropAllReferences();
 }
 
+void SILModule::setOptRecordStream(
+    std::unique_ptr<llvm::yaml::Output> &&Stream,
+    std::unique_ptr<llvm::raw_ostream> &&RawStream) {
+  OptRecordStream = std::move(Stream);
+  OptRecordRawStream = std::move(RawStream);
+}
+
 void *SILModule::allocate(unsigned Size, unsigned Align) const {
   if (getASTContext().LangOpts.UseMalloc)
     return AlignedAlloc(Size, Align);
@@ -106,12 +114,82 @@ void *SILModule::allocate(unsigned Size, unsigned Align) const {
   return BPA.Allocate(Size, Align);
 }
 
+STATISTIC(NumReusedInsts,
+          "Number of instructions allocated in the memory of deleted ones");
+
+namespace {
+/// Stored immediately before every instruction allocated by allocateInst, so
+/// that deallocateInst knows how to release it.
+///
+/// Pooled allocations start with the header, so it is aligned like the free
+/// list link which replaces it, and like the instructions which follow it.
+struct alignas(void *) InstAllocationHeader {
+  /// The size class of the allocation, or 0 if it came from AlignedAlloc.
+  uint32_t SizeClass;
+
+  /// The distance in bytes from the start of the allocation to the
+  /// instruction.
+  uint32_t Offset;
+};
+} // end anonymous namespace
+
+static_assert(sizeof(InstAllocationHeader) >= sizeof(void *),
+              "the free list link must fit into the header");
+
+/// The granularity of instruction size classes.
+static const unsigned InstSizeClassUnit = 16;
+
+/// Larger instructions, such as switches with many cases, are rare enough to
+/// come straight from malloc.
+static const unsigned MaxPooledInstSize = 512;
+
 void *SILModule::allocateInst(unsigned Size, unsigned Align) const {
-  return AlignedAlloc(Size, Align);
+  unsigned Offset = llvm::alignTo(sizeof(InstAllocationHeader), Align);
+  unsigned TotalSize = Offset + Size;
+  unsigned SizeClass = 0;
+  char *Base;
+
+  if (Align <= alignof(InstAllocationHeader) &&
+      TotalSize <= MaxPooledInstSize &&
+      !getASTContext().LangOpts.UseMalloc) {
+    SizeClass = (TotalSize + InstSizeClassUnit - 1) / InstSizeClassUnit;
+    if (InstFreeLists.size() <= SizeClass)
+      InstFreeLists.resize(SizeClass + 1);
+
+    if (void *Free = InstFreeLists[SizeClass]) {
+      // Reuse memory from a deleted instruction of the same size class.
+      InstFreeLists[SizeClass] = *static_cast<void **>(Free);
+      Base = static_cast<char *>(Free);
+      ++NumReusedInsts;
+    } else {
+      Base = static_cast<char *>(BPA.Allocate(SizeClass * InstSizeClassUnit,
+                                              alignof(InstAllocationHeader)));
+    }
+  } else {
+    Base = static_cast<char *>(
+        AlignedAlloc(TotalSize, std::max<unsigned>(
+                                    Align, alignof(InstAllocationHeader))));
+  }
+
+  auto *Header = reinterpret_cast<InstAllocationHeader *>(Base + Offset) - 1;
+  Header->SizeClass = SizeClass;
+  Header->Offset = Offset;
+  return Base + Offset;
 }
 
 void SILModule::deallocateInst(SILInstruction *I) {
-  AlignedFree(I);
+  auto *Header = reinterpret_cast<InstAllocationHeader *>(I) - 1;
+  char *Base = reinterpret_cast<char *>(I) - Header->Offset;
+  unsigned SizeClass = Header->SizeClass;
+
+  if (SizeClass == 0) {
+    AlignedFree(Base);
+    return;
+  }
+
+  // Push the memory onto its free list; the link overwrites the header.
+  *reinterpret_cast<void **>(Base) = InstFreeLists[SizeClass];
+  InstFreeLists[SizeClass] = Base;
 }
 
 SILWitnessTable *
@@ -599,6 +677,9 @@ void SILModule::eraseFunction(SILFunction *F) {
     FunctionTable.erase(F->getName());
     getFunctionList().erase(F);
   }
+
+  // Dropping the body of F noted a change, so this must come last.
+  ChangedFunctions.erase(F);
 }
 
 void SILModule::invalidateFunctionInSILCache(SILFunction *F) {
@@ -537,6 +537,14 @@ public:
       for (auto Id : PredIDs)
         *this << ' ' << Id;
     }
+
+    if (auto Count = BB->getProfileCount()) {
+      if (BB->pred_empty())
+        PrintState.OS.PadToColumn(50);
+      else
+        *this << ' ';
+      *this << "// count: " << *Count;
+    }
     *this << '\n';
 
     for (const SILInstruction &I : *BB) {
@@ -924,6 +932,8 @@ public:
   }
 
   void visitPartialApplyInst(PartialApplyInst *CI) {
+    if (CI->canAllocOnStack())
+      *this << "[stack] ";
     switch (CI->getFunctionType()->getCalleeConvention()) {
     case ParameterConvention::Direct_Owned:
       // Default; do nothing.
@@ -1781,6 +1791,8 @@ void SILFunction::print(SILPrintContext &PrintCtx) const {
   OS << "\n";
 
   OS << "// " << demangleSymbol(getName()) << '\n';
+  if (auto Count = getEntryCount())
+    OS << "// entry count: " << *Count << '\n';
   OS << "sil ";
   printLinkage(OS, getLinkage(), isDefinition());
 
@@ -36,6 +36,7 @@ SILVTable *SILVTable::create(SILModule &M, ClassDecl *Class,
   // Update the Module's cache with new vtable + vtable entries:
   for (auto &entry : Entries) {
     M.VTableEntryCache.insert({{vt, entry.first}, entry.second});
+    M.noteDispatchEntryChanged(entry.first, entry.second);
   }
   return vt;
 }
@@ -55,6 +56,7 @@ SILVTable::getImplementation(SILModule &M, SILDeclRef method) const {
 void SILVTable::removeFromVTableCache(Pair &entry) {
   SILModule &M = entry.second->getModule();
   M.VTableEntryCache.erase({this, entry.first});
+  M.noteDispatchEntryChanged(entry.first, entry.second);
 }
 
 SILVTable::SILVTable(ClassDecl *c, ArrayRef<Pair> entries)
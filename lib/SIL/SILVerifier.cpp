@@ -1702,6 +1702,13 @@ public:
   void checkDeallocRefInst(DeallocRefInst *DI) {
     require(DI->getOperand()->getType().isObject(),
             "Operand of dealloc_ref must be object");
+    // The context of a stack allocated closure is deallocated like a stack
+    // allocated object.
+    if (auto *PAI = dyn_cast<PartialApplyInst>(DI->getOperand())) {
+      require(DI->canAllocOnStack() && PAI->canAllocOnStack(),
+              "dealloc_ref of a partial_apply must be [stack]");
+      return;
+    }
     require(DI->getOperand()->getType().getClassOrBoundGenericClass(),
             "Operand of dealloc_ref must be of class type");
   }
@@ -147,6 +147,8 @@ void SILWitnessTable::convertToDefinition(ArrayRef<Entry> entries,
     case Method:
       if (entry.getMethodWitness().Witness) {
         entry.getMethodWitness().Witness->incrementRefCount();
+        Mod.noteDispatchEntryChanged(entry.getMethodWitness().Requirement,
+                                     entry.getMethodWitness().Witness);
       }
       break;
     case AssociatedType:
@@ -159,6 +161,13 @@ void SILWitnessTable::convertToDefinition(ArrayRef<Entry> entries,
   }
 }
 
+void SILWitnessTable::removeWitnessMethod(Entry &entry) {
+  const MethodWitness &MW = entry.getMethodWitness();
+  if (MW.Witness)
+    Mod.noteDispatchEntryChanged(MW.Requirement, MW.Witness);
+  entry.removeWitnessMethod();
+}
+
 Identifier SILWitnessTable::getIdentifier() const {
   return Mod.getASTContext().getIdentifier(Name);
 }
@@ -1349,11 +1349,40 @@ TypeConverter::getSILFunctionType(AbstractionPattern origType,
            .castTo<SILFunctionType>();
 }
 
+/// Returns true if \p type is its own lowered type under any abstraction
+/// pattern and in any generic context.
+static bool hasContextFreeLowering(CanType type) {
+  return (isa<NominalType>(type) || isa<BuiltinType>(type)) &&
+         !type->hasTypeParameter();
+}
+
+/// Look up the lowering of a type for which hasContextFreeLowering is true.
+const TypeLowering &TypeConverter::getContextFreeTypeLowering(CanType type) {
+  assert(hasContextFreeLowering(type));
+  auto found = ContextFreeTypes.find(type.getPointer());
+  if (found != ContextFreeTypes.end())
+    return *found->second;
+
+  // Lowering the type may lower its fields recursively, so don't hold on to
+  // the map entry across the call.
+  auto &lowering =
+    getTypeLoweringForLoweredType(getTypeKey(AbstractionPattern(type), type, 0));
+  ContextFreeTypes[type.getPointer()] = &lowering;
+  return lowering;
+}
+
 const TypeLowering &
 TypeConverter::getTypeLowering(AbstractionPattern origType,
                                Type origSubstType,
                                unsigned uncurryLevel) {
   CanType substType = origSubstType->getCanonicalType();
+
+  // Most requests are for simple nominal types, whose lowering doesn't depend
+  // on the abstraction pattern at all.
+  if (uncurryLevel == 0 && !origType.isForeign() &&
+      hasContextFreeLowering(substType))
+    return getContextFreeTypeLowering(substType);
+
   auto key = getTypeKey(origType, substType, uncurryLevel);
   
   assert((!key.isDependent() || CurGenericContext)
@@ -1516,6 +1545,9 @@ CanType TypeConverter::getLoweredRValueType(AbstractionPattern origType,
 
 const TypeLowering &TypeConverter::getTypeLowering(SILType type) {
   auto loweredType = type.getSwiftRValueType();
+  if (hasContextFreeLowering(loweredType))
+    return getContextFreeTypeLowering(loweredType);
+
   auto key = getTypeKey(AbstractionPattern(getCurGenericContext(), loweredType),
                         loweredType, 0);
 
@@ -17,6 +17,7 @@
 #include "ExitableFullExpr.h"
 #include "Initialization.h"
 #include "RValue.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/FormattedStream.h"
@@ -410,6 +411,9 @@ public:
 private:
   void emitWildcardDispatch(ClauseMatrix &matrix, ArgArray args, unsigned row,
                             const FailureHandler &failure);
+  bool emitIntegerLiteralDispatch(ClauseMatrix &matrix, ArgArray args,
+                                  unsigned &firstRow,
+                                  const FailureHandler &failure);
 
   void bindRefutablePatterns(const ClauseRow &row, ArgArray args,
                              const FailureHandler &failure);
@@ -941,10 +945,13 @@ void PatternMatchEmission::emitDispatch(ClauseMatrix &clauses, ArgArray args,
       SGF.Cleanups.emitBranchAndCleanups(scope.getExitDest(), loc);
     };
 
-    // If there is no necessary column, just emit the first row.
+    // If there is no necessary column, just emit the first row, unless it
+    // starts a run of integer literal cases that can share one test.
     if (!column) {
-      unsigned wildcardRow = firstRow++;
-      emitWildcardDispatch(clauses, args, wildcardRow, innerFailure);
+      if (!emitIntegerLiteralDispatch(clauses, args, firstRow, innerFailure)) {
+        unsigned wildcardRow = firstRow++;
+        emitWildcardDispatch(clauses, args, wildcardRow, innerFailure);
+      }
     } else {
       // Otherwise, specialize on the necessary column.
       emitSpecializedDispatch(clauses, args, firstRow, column.getValue(),
@@ -981,6 +988,157 @@ void PatternMatchEmission::emitDispatch(ClauseMatrix &clauses, ArgArray args,
   }
 }
 
+/// If the given pattern tests its subject against an integer literal using
+/// the standard library's Equatable ~= operator, return the literal.
+static IntegerLiteralExpr *getIntegerLiteralPattern(Pattern *pattern,
+                                                    CanType subjectTy) {
+  if (!pattern) return nullptr;
+  auto *exprPattern =
+    dyn_cast<ExprPattern>(pattern->getSemanticsProvidingPattern());
+  if (!exprPattern || !exprPattern->getMatchExpr())
+    return nullptr;
+
+  auto *match = dyn_cast<ApplyExpr>(exprPattern->getMatchExpr());
+  if (!match) return nullptr;
+  auto *matchFn = match->getCalledValue();
+  if (!matchFn || !matchFn->getModuleContext()->isStdlibModule())
+    return nullptr;
+
+  // Sema wraps the literal in a call to init(_builtinIntegerLiteral:).
+  auto *init = dyn_cast<CallExpr>(
+    exprPattern->getSubExpr()->getSemanticsProvidingExpr());
+  if (!init || !init->getType() ||
+      init->getType()->getCanonicalType() != subjectTy)
+    return nullptr;
+  auto *initRef =
+    dyn_cast<ConstructorRefCallExpr>(init->getFn()->getSemanticsProvidingExpr());
+  if (!initRef) return nullptr;
+  auto *initFn = initRef->getCalledValue();
+  if (!initFn || !isa<ConstructorDecl>(initFn) ||
+      !initFn->getModuleContext()->isStdlibModule())
+    return nullptr;
+
+  Expr *arg = init->getArg()->getSemanticsProvidingExpr();
+  if (auto *tuple = dyn_cast<TupleExpr>(arg)) {
+    if (tuple->getNumElements() != 1) return nullptr;
+    arg = tuple->getElement(0)->getSemanticsProvidingExpr();
+  }
+  auto *literal = dyn_cast<IntegerLiteralExpr>(arg);
+  if (!literal || !literal->getType()->is<BuiltinIntegerType>())
+    return nullptr;
+  return literal;
+}
+
+/// Emit a run of rows that compare a standard library integer against
+/// distinct integer literals as a single switch_value.
+///
+/// Without this, each row is a separate call to ~= followed by a cond_br,
+/// so a switch with many literal cases tests the subject once per case.
+/// The run stops at the first row that has a guard, binds a variable,
+/// tests something other than a literal, or repeats an earlier value;
+/// those rows are emitted as usual from the default destination, which
+/// preserves the first-match semantics of the statement.
+///
+/// \param firstRow - on success, updated to the first row that was not
+///   part of the run
+/// \returns false, without emitting anything, if fewer than two rows
+///   could be dispatched together
+bool PatternMatchEmission::emitIntegerLiteralDispatch(
+                                             ClauseMatrix &clauses,
+                                             ArgArray args,
+                                             unsigned &firstRow,
+                                             const FailureHandler &failure) {
+  if (args.size() != 1 || args[0].getType().isAddress())
+    return false;
+
+  auto &Context = SGF.getASTContext();
+  CanType subjectTy = args[0].getType().getSwiftRValueType();
+  auto *intDecl = dyn_cast_or_null<StructDecl>(subjectTy->getAnyNominal());
+  if (!intDecl)
+    return false;
+
+  bool isSigned;
+  if (intDecl == Context.getIntDecl() || intDecl == Context.getInt64Decl() ||
+      intDecl == Context.getInt32Decl() || intDecl == Context.getInt16Decl() ||
+      intDecl == Context.getInt8Decl())
+    isSigned = true;
+  else if (intDecl == Context.getUIntDecl() ||
+           intDecl == Context.getUInt64Decl() ||
+           intDecl == Context.getUInt32Decl() ||
+           intDecl == Context.getUInt16Decl() ||
+           intDecl == Context.getUInt8Decl())
+    isSigned = false;
+  else
+    return false;
+
+  auto members = intDecl->lookupDirect(Context.Id_value_);
+  if (members.size() != 1)
+    return false;
+  auto *valueField = dyn_cast<VarDecl>(members[0]);
+  if (!valueField || !valueField->hasStorage())
+    return false;
+  auto builtinTy = valueField->getInterfaceType()->getAs<BuiltinIntegerType>();
+  if (!builtinTy || !builtinTy->isFixedWidth())
+    return false;
+  unsigned width = builtinTy->getFixedWidth();
+
+  // Collect the run of literal rows and their values.
+  SmallVector<std::pair<unsigned, APInt>, 8> cases;
+  llvm::SmallDenseSet<uint64_t, 16> seenValues;
+  for (unsigned row = firstRow, e = clauses.rows(); row != e; ++row) {
+    auto &clause = clauses[row];
+    if (clause.getCaseGuardExpr() || clause.columns() != 1)
+      break;
+    auto *literal = getIntegerLiteralPattern(clause[0], subjectTy);
+    if (!literal)
+      break;
+
+    // Leave literals that overflow the subject type to the ordinary path so
+    // that they are still diagnosed.
+    APInt value = literal->getValue();
+    if (isSigned ? !value.isSignedIntN(width)
+                 : (value.isNegative() || !value.isIntN(width)))
+      break;
+    value = value.trunc(width);
+    if (!seenValues.insert(value.getZExtValue()).second)
+      break;
+    cases.push_back({row, value});
+  }
+  if (cases.size() < 2)
+    return false;
+
+  SILLocation loc = PatternMatchStmt;
+  loc.setDebugLoc(clauses[firstRow].getCasePattern());
+  SILBasicBlock *curBB = SGF.B.getInsertionBB();
+  SILValue intValue =
+    SGF.B.createStructExtract(loc, args[0].getValue(), valueField);
+
+  SmallVector<std::pair<SILValue, SILBasicBlock *>, 8> caseBBs;
+  for (auto &caseInfo : cases) {
+    SILValue caseValue =
+      SGF.B.createIntegerLiteral(loc, intValue->getType(), caseInfo.second);
+    caseBBs.push_back({caseValue, SGF.createBasicBlock(curBB)});
+  }
+  SILBasicBlock *defaultBB = SGF.createBasicBlock(curBB);
+  SGF.B.createSwitchValue(loc, intValue, defaultBB, caseBBs);
+
+  // The remaining rows are reached through the default destination.
+  unsigned lastRow = cases.back().first;
+  firstRow = lastRow + 1;
+
+  for (unsigned i = 0, e = cases.size(); i != e; ++i) {
+    SGF.B.setInsertionPoint(caseBBs[i].second);
+    ArgForwarder forwarder(SGF, args, /*isFinalUse*/ false);
+    CompletionHandler(*this, forwarder.getForwardedArgs(),
+                      clauses[cases[i].first]);
+    assert(!SGF.B.hasValidInsertionPoint());
+  }
+
+  SGF.B.setInsertionPoint(defaultBB);
+  failure(clauses[lastRow].getCasePattern());
+  return true;
+}
+
 /// Emit the decision tree for a row containing only non-specializing
 /// patterns.
 ///
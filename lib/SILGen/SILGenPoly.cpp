@@ -2413,6 +2413,26 @@ CanSILFunctionType SILGenFunction::buildThunkType(
   return thunkType;
 }
 
+/// If \p fn is a reabstraction thunk closure that was just formed around a
+/// function of type \p expectedType, and nothing else uses it yet, return
+/// the partial_apply that formed it.
+static PartialApplyInst *
+getInverseReabstractionThunk(ManagedValue fn, CanSILFunctionType expectedType) {
+  auto *PAI = dyn_cast<PartialApplyInst>(fn.getValue());
+  if (!PAI || !fn.hasCleanup() || !PAI->use_empty() ||
+      PAI->getNumArguments() != 1)
+    return nullptr;
+
+  auto *thunk = PAI->getReferencedFunction();
+  if (!thunk || thunk->isThunk() != IsReabstractionThunk)
+    return nullptr;
+
+  if (PAI->getArgument(0)->getType() !=
+        SILType::getPrimitiveObjectType(expectedType))
+    return nullptr;
+  return PAI;
+}
+
 /// Create a reabstraction thunk.
 static ManagedValue createThunk(SILGenFunction &gen,
                                 SILLocation loc,
@@ -2429,6 +2449,19 @@ static ManagedValue createThunk(SILGenFunction &gen,
          fn.getType().castTo<SILFunctionType>()->getLanguage() &&
          "bridging in re-abstraction thunk?");
 
+  // Reabstracting a thunk closure back to the abstraction of the function it
+  // wraps would only stack a second thunk and context on top of the first.
+  // Take the original function back out of the unused closure instead.
+  if (auto *PAI = getInverseReabstractionThunk(fn, expectedType)) {
+    SILValue orig = PAI->getArgument(0);
+    auto *thunkRef = dyn_cast<FunctionRefInst>(PAI->getCallee());
+    fn.forward(gen);
+    PAI->eraseFromParent();
+    if (thunkRef && thunkRef->use_empty())
+      thunkRef->eraseFromParent();
+    return gen.emitManagedRValueWithCleanup(orig, expectedTL);
+  }
+
   // Declare the thunk.
   SmallVector<Substitution, 4> substitutions;
   CanSILFunctionType substFnType;
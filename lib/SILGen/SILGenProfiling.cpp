@@ -23,6 +23,7 @@
 #include "llvm/ProfileData/Coverage/CoverageMapping.h"
 #include "llvm/ProfileData/Coverage/CoverageMappingWriter.h"
 #include "llvm/ProfileData/InstrProf.h"
+#include "llvm/ProfileData/InstrProfReader.h"
 
 #include <forward_list>
 
@@ -83,7 +84,7 @@ ProfilerRAII::ProfilerRAII(SILGenModule &SGM, Decl *D)
   assert(isa<AbstractFunctionDecl>(D) ||
          isa<TopLevelCodeDecl>(D) && "Cannot create profiler for this decl");
   const auto &Opts = SGM.M.getOptions();
-  if (!Opts.GenerateProfile || isUnmappedDecl(D))
+  if ((!Opts.GenerateProfile && !SGM.PGOReader) || isUnmappedDecl(D))
     return;
   SGM.Profiler =
       llvm::make_unique<SILGenProfiling>(SGM, Opts.EmitProfileCoverageMapping);
@@ -720,6 +721,9 @@ void SILGenProfiling::assignRegionCounters(Decl *Root) {
   // TODO: Mapper needs to calculate a function hash as it goes.
   FunctionHash = 0x0;
 
+  if (SGM.PGOReader)
+    loadRegionCounts();
+
   if (EmitCoverageMapping) {
     CoverageMapping Coverage(SM);
     walkForProfiling(Root, Coverage);
@@ -741,6 +745,26 @@ static SILLocation getLocation(ASTNode Node) {
     llvm_unreachable("unsupported ASTNode");
 }
 
+std::string SILGenProfiling::getPGOFuncName() const {
+  return llvm::getPGOFuncName(CurrentFuncName,
+                              getEquivalentPGOLinkage(CurrentFuncLinkage),
+                              CurrentFileName);
+}
+
+void SILGenProfiling::loadRegionCounts() {
+  RegionCounts.clear();
+  if (auto E = SGM.PGOReader->getFunctionCounts(getPGOFuncName(), FunctionHash,
+                                                RegionCounts)) {
+    // The function isn't in the profile, or the profile is stale. Either
+    // way, optimize it as if there were no profile.
+    llvm::consumeError(std::move(E));
+    RegionCounts.clear();
+    return;
+  }
+  if (RegionCounts.size() != NumRegionCounters)
+    RegionCounts.clear();
+}
+
 void SILGenProfiling::emitCounterIncrement(SILGenBuilder &Builder,ASTNode Node){
   auto &C = Builder.getASTContext();
 
@@ -748,12 +772,24 @@ void SILGenProfiling::emitCounterIncrement(SILGenBuilder &Builder,ASTNode Node){
   assert(CounterIt != RegionCounterMap.end() &&
          "cannot increment non-existent counter");
 
+  // The increment is emitted at the start of the region, so the region's
+  // count is the count of the current block.
+  if (!RegionCounts.empty()) {
+    uint64_t Count = RegionCounts[CounterIt->second];
+    if (auto *BB = Builder.getInsertionBB()) {
+      BB->setProfileCount(Count);
+      if (BB->isEntry() && !BB->getParent()->getEntryCount())
+        BB->getParent()->setEntryCount(Count);
+    }
+  }
+
+  if (!SGM.M.getOptions().GenerateProfile)
+    return;
+
   auto Int32Ty = SGM.Types.getLoweredType(BuiltinIntegerType::get(32, C));
   auto Int64Ty = SGM.Types.getLoweredType(BuiltinIntegerType::get(64, C));
 
-  std::string PGOFuncName = llvm::getPGOFuncName(
-      CurrentFuncName, getEquivalentPGOLinkage(CurrentFuncLinkage),
-      CurrentFileName);
+  std::string PGOFuncName = getPGOFuncName();
 
   SILLocation Loc = getLocation(Node);
   SILValue Args[] = {
@@ -43,6 +43,11 @@ private:
   uint64_t FunctionHash;
   llvm::DenseMap<ASTNode, unsigned> RegionCounterMap;
 
+  /// The execution counts of the current function's regions in the profile
+  /// passed with -profile-use, indexed by counter. Empty if there is no
+  /// usable profile data for the function.
+  std::vector<uint64_t> RegionCounts;
+
   std::vector<std::tuple<std::string, uint64_t, std::string>> CoverageData;
 
 public:
@@ -52,10 +57,18 @@ public:
 
   bool hasRegionCounters() const { return NumRegionCounters != 0; }
 
-  /// Emit SIL to increment the counter for \c Node.
+  /// Emit SIL to increment the counter for \c Node, and attach the
+  /// profiled count for \c Node to the current block if there is one.
   void emitCounterIncrement(SILGenBuilder &Builder, ASTNode Node);
 
 private:
+  /// Returns the name used for the current function in profile data.
+  std::string getPGOFuncName() const;
+
+  /// Load the counts for the current function from the profile passed with
+  /// -profile-use.
+  void loadRegionCounts();
+
   /// Map counters to ASTNodes and set them up for profiling the given function.
   void assignRegionCounters(Decl *Root);
 
@@ -14,6 +14,7 @@
 #include "swift/SILOptimizer/PassManager/Passes.h"
 #include "ARCSequenceOpts.h"
 #include "swift/Basic/Fallthrough.h"
+#include "swift/SIL/OptimizationRemark.h"
 #include "swift/SIL/SILBuilder.h"
 #include "swift/SIL/SILVisitor.h"
 #include "swift/SILOptimizer/Utils/Local.h"
@@ -39,7 +40,15 @@ using namespace swift;
 
 STATISTIC(NumRefCountOpsRemoved, "Total number of increments removed");
 
-llvm::cl::opt<bool> EnableLoopARC("enable-loop-arc", llvm::cl::init(false));
+llvm::cl::opt<bool> EnableLoopARC("enable-loop-arc", llvm::cl::init(true));
+
+/// Functions with more blocks than this are optimized with the block based
+/// dataflow, which doesn't need loop canonicalization and a loop region
+/// analysis.
+static llvm::cl::opt<unsigned> LoopARCMaxBlocks(
+    "loop-arc-max-blocks", llvm::cl::init(4000),
+    llvm::cl::desc("Maximum number of blocks in a function for which the loop "
+                   "based ARC sequence dataflow is used"));
 
 //===----------------------------------------------------------------------===//
 //                                Code Motion
@@ -53,12 +62,23 @@ void ARCPairingContext::optimizeMatchingSet(
     ARCMatchingSet &MatchSet, llvm::SmallVectorImpl<SILInstruction *> &NewInsts,
     llvm::SmallVectorImpl<SILInstruction *> &DeadInsts) {
   DEBUG(llvm::dbgs() << "**** Optimizing Matching Set ****\n");
+  OptRemark::Emitter ORE(DEBUG_TYPE, F.getModule());
+
   // Add the old increments to the delete list.
   for (SILInstruction *Increment : MatchSet.Increments) {
     MadeChange = true;
     DEBUG(llvm::dbgs() << "    Deleting increment: " << *Increment);
     DeadInsts.push_back(Increment);
     ++NumRefCountOpsRemoved;
+    ORE.emit([&]() {
+      using namespace OptRemark;
+      return RemarkPassed("RetainRemoved", *Increment)
+             << "Removed retain of "
+             << NV("Type", Increment->getOperand(0)->getType())
+             << " together with "
+             << NV("NumReleases", MatchSet.Decrements.size())
+             << " matching release(s)";
+    });
   }
 
   // Add the old decrements to the delete list.
@@ -268,7 +288,7 @@ class ARCSequenceOpts : public SILFunctionTransform {
     if (!getOptions().EnableARCOptimizations)
       return;
 
-    if (!EnableLoopARC) {
+    if (!EnableLoopARC || F->size() > LoopARCMaxBlocks) {
       auto *AA = getAnalysis<AliasAnalysis>();
       auto *POTA = getAnalysis<PostOrderAnalysis>();
       auto *RCFI = getAnalysis<RCIdentityAnalysis>()->get(F);
@@ -19,6 +19,7 @@
 #include "swift/SILOptimizer/Analysis/ClassHierarchyAnalysis.h"
 #include "swift/AST/Module.h"
 #include "swift/AST/SILOptions.h"
+#include "swift/Basic/Statistic.h"
 #include "swift/SIL/SILModule.h"
 #include "swift/SIL/SILFunction.h"
 #include "llvm/ADT/Statistic.h"
@@ -32,6 +33,26 @@ void SILAnalysis::verifyFunction(SILFunction *F) {
   assert(F->isDefinition() && "Can't analyze external functions");
 }
 
+StringRef SILAnalysis::getAnalysisName(AnalysisKind K) {
+  switch (K) {
+#define ANALYSIS(NAME) \
+  case AnalysisKind::NAME: return #NAME;
+#include "swift/SILOptimizer/Analysis/Analysis.def"
+  }
+  llvm_unreachable("unhandled analysis kind");
+}
+
+void SILAnalysis::recordFunctionResults(SILFunction *F, unsigned Count,
+                                        bool Invalidated) const {
+  UnifiedStatsReporter *Stats = F->getModule().getASTContext().Stats;
+  if (!Stats || Count == 0)
+    return;
+  Stats->addNamedCounter(("SILOptimizer.Analysis." +
+                          getAnalysisName(getKind()) +
+                          (Invalidated ? ".Invalidated" : ".Computed")).str(),
+                         Count);
+}
+
 SILAnalysis *swift::createDominanceAnalysis(SILModule *) {
   return new DominanceAnalysis();
 }
@@ -142,12 +142,20 @@ bool ColdBlockInfo::isCold(const SILBasicBlock *BB, int recursionDepth) {
   if (!Node)
     return true;
 
+  // A block the profile says never ran is cold, and so is everything it
+  // dominates.
+  if (BB->isProfiledCold()) {
+    ColdBlockMap[BB] = true;
+    return true;
+  }
+
   std::vector<const SILBasicBlock*> DomChain;
   DomChain.push_back(BB);
   bool IsCold = false;
   Node = Node->getIDom();
   while (Node) {
-    if (isSlowPath(Node->getBlock(), DomChain.back(), recursionDepth)) {
+    if (Node->getBlock()->isProfiledCold() ||
+        isSlowPath(Node->getBlock(), DomChain.back(), recursionDepth)) {
       IsCold = true;
       break;
     }
@@ -163,3 +171,22 @@ bool ColdBlockInfo::isCold(const SILBasicBlock *BB, int recursionDepth) {
     ColdBlockMap[ChainBB] = IsCold;
   return IsCold;
 }
+
+Optional<uint64_t> ColdBlockInfo::getProfileCount(const SILBasicBlock *BB) {
+  if (!BB->getParent()->getEntryCount())
+    return None;
+
+  DominanceInfo *DT = DA->get(const_cast<SILFunction*>(BB->getParent()));
+  auto *Node = DT->getNode(const_cast<SILBasicBlock*>(BB));
+  while (Node) {
+    if (auto Count = Node->getBlock()->getProfileCount())
+      return Count;
+    Node = Node->getIDom();
+  }
+  return BB->getParent()->getEntryCount();
+}
+
+bool ColdBlockInfo::isProfiledHot(const SILBasicBlock *BB) {
+  auto Count = getProfileCount(BB);
+  return Count && *Count > *BB->getParent()->getEntryCount();
+}
@@ -1070,9 +1070,13 @@ void EscapeAnalysis::buildConnectionGraph(FunctionInfo *FInfo,
   while (!WorkList.empty()) {
     SILBasicBlock *BB = WorkList.pop_back_val();
 
-    // Create edges for the instructions.
+    // Create edges for the instructions. If the graph is getting too large,
+    // give up precision for the rest of the function.
     for (auto &I : *BB) {
-      analyzeInstruction(&I, FInfo, BottomUpOrder, RecursionDepth);
+      if (ConGraph->exceedsNodeLimit(MaxGraphNodes))
+        setAllEscaping(&I, ConGraph);
+      else
+        analyzeInstruction(&I, FInfo, BottomUpOrder, RecursionDepth);
     }
     for (auto &Succ : BB->getSuccessors()) {
       if (VisitedBlocks.insert(Succ.getBB()).second)
@@ -1124,6 +1128,30 @@ static bool onlyUsedInTupleExtract(SILInstruction *I) {
   return true;
 }
 
+/// Returns true if a call to \p Callee with an @effects attribute cannot
+/// capture any of its arguments, even though the callee's body is not
+/// available to build a connection graph for it.
+/// A callee which doesn't write memory cannot store an argument anywhere, so
+/// the only way for an argument to escape is by returning it.
+static bool isNonCapturingCallee(FullApplySite FAS, SILFunction *Callee) {
+  switch (Callee->getEffectsKind()) {
+    case EffectsKind::ReadNone:
+      break;
+    case EffectsKind::ReadOnly:
+      // A release of an owned parameter inside the callee may call a deinit,
+      // which itself can do anything.
+      if (Callee->hasOwnedParameters())
+        return false;
+      break;
+    default:
+      return false;
+  }
+  if (FAS.hasIndirectResults())
+    return false;
+  SILModule *Mod = &FAS.getFunction()->getModule();
+  return !isOrContainsReference(FAS.getType(), Mod);
+}
+
 bool EscapeAnalysis::buildConnectionGraphForCallees(
     SILInstruction *Caller, CalleeList Callees, FunctionInfo *FInfo,
     FunctionOrder &BottomUpOrder, int RecursionDepth) {
@@ -1313,6 +1341,8 @@ void EscapeAnalysis::analyzeInstruction(SILInstruction *I,
       if (Fn->getName() == "swift_bufferAllocate")
         // The call is a buffer allocation, e.g. for Array.
         return;
+      if (isNonCapturingCallee(FAS, Fn))
+        return;
     }
   }
 
@@ -1372,6 +1402,10 @@ void EscapeAnalysis::analyzeInstruction(SILInstruction *I,
         // the object itself (because it will be a dangling pointer after
         // deallocation).
         CGNode *CapturedByDeinit = ConGraph->getContentNode(AddrNode);
+        // The context of a closure has one more level of indirection: its
+        // deinit releases the captured values.
+        if (OpV->getType().is<SILFunctionType>())
+          CapturedByDeinit = ConGraph->getContentNode(CapturedByDeinit);
         CapturedByDeinit = ConGraph->getContentNode(CapturedByDeinit);
         if (deinitIsKnownToNotCapture(OpV)) {
           CapturedByDeinit = ConGraph->getContentNode(CapturedByDeinit);
@@ -1448,14 +1482,17 @@ void EscapeAnalysis::analyzeInstruction(SILInstruction *I,
       }
       return;
     case ValueKind::PartialApplyInst: {
-      // The result of a partial_apply is a thick function which stores the
-      // boxed partial applied arguments. We create defer-edges from the
-      // partial_apply values to the arguments.
+      // The result of a partial_apply is a thick function which points to a
+      // context storing the partial applied arguments. We create defer-edges
+      // from the content of the partial_apply value to the arguments. This
+      // lets us distinguish between the closure itself escaping and only the
+      // captured values escaping (e.g. if the closure is called).
       CGNode *ResultNode = ConGraph->getNode(I, this);
       assert(ResultNode && "thick functions must have a CG node");
+      CGNode *ContextNode = ConGraph->getContentNode(ResultNode);
       for (const Operand &Op : I->getAllOperands()) {
         if (CGNode *ArgNode = ConGraph->getNode(Op.get(), this)) {
-          ResultNode = ConGraph->defer(ResultNode, ArgNode);
+          ContextNode = ConGraph->defer(ContextNode, ArgNode);
         }
       }
       return;
@@ -1602,8 +1639,16 @@ void EscapeAnalysis::setAllEscaping(SILInstruction *I,
   // operands to escaping, because they may "escape" to the result value in
   // an unspecified way. For example consider bit-casting a pointer to an int.
   // In this case we don't even create a node for the resulting int value.
+  bool IsFullApply = FullApplySite::isa(I);
   for (const Operand &Op : I->getAllOperands()) {
     SILValue OpVal = Op.get();
+    // Calling an unknown closure may capture the values in its context, but
+    // never the closure itself (the callee is the first operand).
+    if (IsFullApply && Op.getOperandNumber() == 0) {
+      if (CGNode *CalleeNd = ConGraph->getNode(OpVal, this))
+        ConGraph->setEscapesGlobal(ConGraph->getContentNode(CalleeNd));
+      continue;
+    }
     if (!isNonWritableMemoryAddress(OpVal))
       setEscapesGlobal(ConGraph, OpVal);
   }
@@ -1660,10 +1705,24 @@ void EscapeAnalysis::recompute(FunctionInfo *Initial) {
 
             // Only include callers which we are actually recomputing.
             if (BottomUpOrder.wasRecomputedWithCurrentUpdateID(E.Caller)) {
+              ConnectionGraph *CallerGraph = &E.Caller->Graph;
+              if (CallerGraph->exceedsNodeLimit(MaxGraphNodes)) {
+                // Don't let the caller's graph grow any further.
+                DEBUG(llvm::dbgs() << "  graph of " <<
+                      CallerGraph->F->getName() << " too large, set " <<
+                      "call to " << FInfo->Graph.F->getName() <<
+                      " to escaping\n");
+                setAllEscaping(E.FAS, CallerGraph);
+                E.Caller->NeedUpdateSummaryGraph = true;
+                if (!E.Caller->isScheduledAfter(FInfo))
+                  NeedAnotherIteration = true;
+                continue;
+              }
+
               DEBUG(llvm::dbgs() << "  merge  " << FInfo->Graph.F->getName() <<
                     " into " << E.Caller->Graph.F->getName() << '\n');
 
-              if (mergeCalleeGraph(E.FAS, &E.Caller->Graph,
+              if (mergeCalleeGraph(E.FAS, CallerGraph,
                                    &FInfo->SummaryGraph)) {
                 E.Caller->NeedUpdateSummaryGraph = true;
                 if (!E.Caller->isScheduledAfter(FInfo)) {
@@ -1716,15 +1775,15 @@ bool EscapeAnalysis::mergeCalleeGraph(SILInstruction *AS,
   for (unsigned Idx = 0; Idx < numCalleeArgs; ++Idx) {
     // If there are more callee parameters than arguments it means that the
     // callee is the result of a partial_apply - a thick function. A thick
-    // function also references the boxed partially applied arguments.
-    // Therefore we map all the extra callee parameters to the callee operand
-    // of the apply site.
+    // function references the partially applied arguments through its
+    // context. Therefore we map all the extra callee parameters to the content
+    // of the callee operand of the apply site.
+    bool IsCapture = Idx >= numCallerArgs;
     SILValue CallerArg;
     if (FAS)
-      CallerArg =
-          (Idx < numCallerArgs ? FAS.getArgument(Idx) : FAS.getCallee());
+      CallerArg = (!IsCapture ? FAS.getArgument(Idx) : FAS.getCallee());
     else
-      CallerArg = (Idx < numCallerArgs ? AS->getOperand(Idx) : SILValue());
+      CallerArg = (!IsCapture ? AS->getOperand(Idx) : SILValue());
 
     CGNode *CalleeNd = CalleeGraph->getNode(Callee->getArgument(Idx), this);
     if (!CalleeNd)
@@ -1736,6 +1795,8 @@ bool EscapeAnalysis::mergeCalleeGraph(SILInstruction *AS,
     // function type and the caller passes a function_ref.
     if (!CallerNd)
       continue;
+    if (IsCapture)
+      CallerNd = CallerGraph->getContentNode(CallerNd);
 
     Callee2CallerMapping.add(CalleeNd, CallerNd);
   }
@@ -26,7 +26,7 @@ static bool inSCC(ValueBase *Value, IVInfo::SCCType &SCC) {
 
 // For now, we'll consider only the simplest induction variables:
 // - Exactly one element in the cycle must be a SILArgument.
-// - Only a single increment by a literal.
+// - Only a single increment or decrement by a literal.
 //
 // In other words many valid things that could be considered induction
 // variables are disallowed at this point.
@@ -57,6 +57,14 @@ SILArgument *IVInfo::isInductionSequence(SCCType &SCC) {
       FoundBuiltin = cast<BuiltinInst>(I);
 
       SILValue L, R;
+      if (match(FoundBuiltin, m_ApplyInst(BuiltinValueKind::SSubOver,
+                                          m_SILValue(L), m_SILValue(R)))) {
+        // Only the literal can be subtracted from the induction variable.
+        if (!match(R, m_IntegerLiteralInst(IncValue)))
+          return nullptr;
+        break;
+      }
+
       if (!match(FoundBuiltin, m_ApplyInst(BuiltinValueKind::SAddOver,
                                            m_SILValue(L), m_SILValue(R))))
         return nullptr;
@@ -86,6 +94,13 @@ SILArgument *IVInfo::isInductionSequence(SCCType &SCC) {
   return FoundArgument;
 }
 
+APInt IVInfo::IVDesc::getStride() const {
+  assert(Inc && IncVal && "Invalid induction variable");
+  if (Inc->getBuiltinInfo().ID == BuiltinValueKind::SSubOver)
+    return -IncVal->getValue();
+  return IncVal->getValue();
+}
+
 void IVInfo::visit(SCCType &SCC) {
   assert(SCC.size() && "SCCs should have an element!!");
 
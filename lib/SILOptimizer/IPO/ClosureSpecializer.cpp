@@ -52,6 +52,16 @@
 /// 3. Handling addresses. We currently do not handle address types. We can in
 ///    the future by introducing alloc_stacks.
 ///
+/// 4. Reabstraction thunks. Closures passed to generic functions like map are
+///    typically wrapped in a generic reabstraction thunk, i.e. the argument is
+///    a partial_apply of the thunk which captures the original closure. We
+///    specialize for such a closure like for any other partial_apply (with
+///    its substitutions), so that the thunk and later the captured closure
+///    itself can be inlined into the specialized function.
+///
+/// The callee may also be a function from another module whose body was
+/// serialized, e.g. from the standard library.
+///
 //===----------------------------------------------------------------------===//
 
 #define DEBUG_TYPE "closure-specialization"
@@ -179,6 +189,14 @@ public:
     return cast<FunctionRefInst>(TTTFI->getCallee())->getReferencedFunction();
   }
 
+  /// Returns the type of the closure callee with the substitutions of the
+  /// closure applied.
+  CanSILFunctionType getClosureCalleeType() const {
+    if (auto *PAI = dyn_cast<PartialApplyInst>(getClosure()))
+      return PAI->getSubstCalleeType();
+    return getClosureCallee()->getLoweredFunctionType();
+  }
+
   bool closureHasRefSemanticContext() const {
     return isa<PartialApplyInst>(getClosure());
   }
@@ -190,9 +208,11 @@ public:
   SILInstruction *
   createNewClosure(SILBuilder &B, SILValue V,
                    llvm::SmallVectorImpl<SILValue> &Args) const {
-    if (isa<PartialApplyInst>(getClosure()))
-      return B.createPartialApply(getClosure()->getLoc(), V, V->getType(), {},
-                                  Args, getClosure()->getType());
+    if (auto *PAI = dyn_cast<PartialApplyInst>(getClosure()))
+      return B.createPartialApply(PAI->getLoc(), V,
+                                  PAI->getSubstCalleeSILType(),
+                                  PAI->getSubstitutions(), Args,
+                                  PAI->getType());
 
     assert(isa<ThinToThickFunctionInst>(getClosure()) &&
            "We only support partial_apply and thin_to_thick_function");
@@ -431,6 +451,32 @@ void CallSiteDescriptor::extendArgumentLifetime(SILValue Arg) const {
   }
 }
 
+/// Returns true if the substitutions of the reabstraction thunk closure \p PAI
+/// can be used in a specialized function.
+///
+/// The specialized function's name only contains the types of the captured
+/// arguments. Therefore every replacement type must be mentioned in them,
+/// and it must not depend on the generic context of the caller.
+static bool hasSupportedSubstitutions(const PartialApplyInst *PAI) {
+  auto *FRI = dyn_cast<FunctionRefInst>(PAI->getCallee());
+  if (!FRI ||
+      FRI->getReferencedFunction()->isThunk() != IsReabstractionThunk)
+    return false;
+
+  for (const Substitution &Sub : PAI->getSubstitutions()) {
+    CanType Replacement = Sub.getReplacement()->getCanonicalType();
+    if (Replacement->hasArchetype())
+      return false;
+    auto Args = PAI->getArguments();
+    if (std::none_of(Args.begin(), Args.end(), [&](SILValue Arg) -> bool {
+          return Arg->getType().getSwiftRValueType().findIf(
+              [&](Type Ty) -> bool { return Ty->isEqual(Replacement); });
+        }))
+      return false;
+  }
+  return true;
+}
+
 static bool isSupportedClosure(const SILInstruction *Closure) {
   if (!isSupportedClosureKind(Closure))
     return false;
@@ -442,8 +488,8 @@ static bool isSupportedClosure(const SILInstruction *Closure) {
 
   // If Closure is a partial apply...
   if (auto *PAI = dyn_cast<PartialApplyInst>(Closure)) {
-    // And it has substitutions, return false.
-    if (PAI->hasSubstitutions())
+    // And it has substitutions we can't handle, return false.
+    if (PAI->hasSubstitutions() && !hasSupportedSubstitutions(PAI))
       return false;
 
     // If any arguments are not objects, return false. This is a temporary
@@ -506,8 +552,7 @@ ClosureSpecCloner::initCloned(const CallSiteDescriptor &CallSiteDesc,
   // Then add any arguments that are captured in the closure to the function's
   // argument type. Since they are captured, we need to pass them directly into
   // the new specialized function.
-  SILFunction *ClosedOverFun = CallSiteDesc.getClosureCallee();
-  CanSILFunctionType ClosedOverFunTy = ClosedOverFun->getLoweredFunctionType();
+  CanSILFunctionType ClosedOverFunTy = CallSiteDesc.getClosureCalleeType();
   SILModule &M = ClosureUser->getModule();
 
   // Captured parameters are always appended to the function signature. If the
@@ -600,7 +645,7 @@ void ClosureSpecCloner::populateCloned() {
   // such arguments. After this pass is done the only thing that will reference
   // the arguments is the partial apply that we will create.
   SILFunction *ClosedOverFun = CallSiteDesc.getClosureCallee();
-  CanSILFunctionType ClosedOverFunTy = ClosedOverFun->getLoweredFunctionType();
+  CanSILFunctionType ClosedOverFunTy = CallSiteDesc.getClosureCalleeType();
   unsigned NumTotalParams = ClosedOverFunTy->getParameters().size();
   unsigned NumNotCaptured = NumTotalParams - CallSiteDesc.getNumArguments();
   llvm::SmallVector<SILValue, 4> NewPAIArgs;
@@ -740,7 +785,15 @@ void ClosureSpecializer::gatherCallSites(
         // If AI does not have a function_ref definition as its callee, we can
         // not do anything here... so continue...
         SILFunction *ApplyCallee = AI.getReferencedFunction();
-        if (!ApplyCallee || ApplyCallee->isExternalDeclaration())
+        if (!ApplyCallee)
+          continue;
+
+        // The callee may be defined in another module. Try to deserialize
+        // its body, so that we can specialize it like a local function.
+        if (ApplyCallee->isExternalDeclaration())
+          Caller->getModule().linkFunction(ApplyCallee,
+                                           SILModule::LinkingMode::LinkAll);
+        if (ApplyCallee->isExternalDeclaration())
           continue;
 
         // Ok, we know that we can perform the optimization but not whether or
@@ -0,0 +1,217 @@
+//===--- CrossModuleSerializationSetup.cpp - Serialize generic code -------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// With -cross-module-optimization, mark public generic functions and the
+// code they depend on as fragile, so that their bodies are serialized into
+// the module file and clients can specialize and inline them just like
+// @_inlineable code from the standard library.
+//
+// A function is only made fragile if everything its body refers to can be
+// used from another module: the types it mentions must be public, and any
+// non-public function or global it references must itself be serializable.
+// IRGen gives fragile functions and globals public symbols, so they stay
+// callable if the client doesn't inline them.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "cross-module-serialization-setup"
+#include "swift/SILOptimizer/PassManager/Passes.h"
+#include "swift/SILOptimizer/PassManager/Transforms.h"
+#include "swift/AST/GenericSignature.h"
+#include "swift/AST/Module.h"
+#include "swift/SIL/SILArgument.h"
+#include "swift/SIL/SILFunction.h"
+#include "swift/SIL/SILModule.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/Debug.h"
+
+using namespace swift;
+
+STATISTIC(NumFunctionsSerialized,
+          "Number of functions made fragile for cross-module optimization");
+
+namespace {
+
+class CrossModuleSerializationSetup : public SILModuleTransform {
+  /// Functions known to refer to something that can't be used from another
+  /// module.
+  llvm::SmallPtrSet<SILFunction *, 16> NotSerializable;
+
+  /// The functions and globals that have to be made fragile along with the
+  /// candidate currently being checked.
+  llvm::SmallPtrSet<SILFunction *, 16> FunctionsToSerialize;
+  llvm::SmallPtrSet<SILGlobalVariable *, 4> GlobalsToSerialize;
+
+  bool canSerialize(SILFunction *F);
+  bool canSerialize(SILInstruction *I);
+  bool canSerialize(SILGlobalVariable *G);
+  bool canUseFunction(SILFunction *F);
+  bool canUseSubstitutions(ArrayRef<Substitution> Subs);
+
+  void run() override;
+
+  StringRef getName() override { return "Cross Module Serialization Setup"; }
+};
+
+} // end anonymous namespace
+
+/// Returns true if \p Ty only refers to nominal types that are visible
+/// outside of the module, so that a client can emit their metadata.
+static bool isPubliclyUsableType(Type Ty) {
+  return !Ty.findIf([](Type T) -> bool {
+    if (auto *NTD = T->getAnyNominal())
+      return NTD->getEffectiveAccess() < Accessibility::Public;
+    return false;
+  });
+}
+
+static bool isPubliclyUsableType(SILType Ty) {
+  return isPubliclyUsableType(Ty.getSwiftRValueType());
+}
+
+static bool isPublicDecl(const ValueDecl *D) {
+  return D->getEffectiveAccess() >= Accessibility::Public;
+}
+
+bool CrossModuleSerializationSetup::
+canUseSubstitutions(ArrayRef<Substitution> Subs) {
+  for (const Substitution &Sub : Subs) {
+    if (!isPubliclyUsableType(Sub.getReplacement()))
+      return false;
+    for (ProtocolConformanceRef C : Sub.getConformances())
+      if (!isPublicDecl(C.getRequirement()))
+        return false;
+  }
+  return true;
+}
+
+/// Check whether a function referenced from serialized code is either
+/// visible to clients already, or can be serialized along with it.
+bool CrossModuleSerializationSetup::canUseFunction(SILFunction *F) {
+  if (F->hasValidLinkageForFragileRef())
+    return true;
+  if (F->isExternalDeclaration())
+    return false;
+  return canSerialize(F);
+}
+
+bool CrossModuleSerializationSetup::canSerialize(SILGlobalVariable *G) {
+  if (G->isFragile() || hasPublicVisibility(G->getLinkage()))
+    return true;
+  if (!G->isDefinition() || !isPubliclyUsableType(G->getLoweredType()))
+    return false;
+  GlobalsToSerialize.insert(G);
+  return true;
+}
+
+bool CrossModuleSerializationSetup::canSerialize(SILInstruction *I) {
+  if (I->hasValue() && !isPubliclyUsableType(I->getType()))
+    return false;
+
+  if (auto AS = ApplySite::isa(I))
+    if (!canUseSubstitutions(AS.getSubstitutions()))
+      return false;
+
+  if (auto *FRI = dyn_cast<FunctionRefInst>(I))
+    return canUseFunction(FRI->getReferencedFunction());
+
+  if (auto *GAI = dyn_cast<GlobalAddrInst>(I))
+    return canSerialize(GAI->getReferencedGlobal());
+
+  if (auto *AGI = dyn_cast<AllocGlobalInst>(I))
+    return canSerialize(AGI->getReferencedGlobal());
+
+  if (auto *MI = dyn_cast<MethodInst>(I))
+    return isPublicDecl(MI->getMember().getDecl());
+
+  // Client code can't compute the offset of a non-public stored property of
+  // a class.
+  if (auto *REAI = dyn_cast<RefElementAddrInst>(I))
+    return isPublicDecl(REAI->getField());
+
+  return true;
+}
+
+bool CrossModuleSerializationSetup::canSerialize(SILFunction *F) {
+  if (NotSerializable.count(F))
+    return false;
+
+  // A function we are already visiting for the current candidate is fine;
+  // if it turns out not to be serializable, the candidate is rejected as a
+  // whole.
+  if (!FunctionsToSerialize.insert(F).second)
+    return true;
+
+  bool Result = [&]() -> bool {
+    if (F->hasForeignBody() || F->isExternalDeclaration())
+      return false;
+
+    CanSILFunctionType FnTy = F->getLoweredFunctionType();
+    if (!isPubliclyUsableType(FnTy))
+      return false;
+    if (auto Sig = FnTy->getGenericSignature())
+      for (const Requirement &Req : Sig->getRequirements())
+        if (!isPubliclyUsableType(Req.getSecondType()))
+          return false;
+
+    for (SILBasicBlock &BB : *F) {
+      for (SILArgument *Arg : BB.getArguments())
+        if (!isPubliclyUsableType(Arg->getType()))
+          return false;
+      for (SILInstruction &I : BB)
+        if (!canSerialize(&I))
+          return false;
+    }
+    return true;
+  }();
+
+  if (!Result)
+    NotSerializable.insert(F);
+  return Result;
+}
+
+void CrossModuleSerializationSetup::run() {
+  SILModule &M = *getModule();
+  if (!M.getOptions().CrossModuleOptimization || !M.isWholeModule())
+    return;
+
+  // The layout of types in a resilient module may change, so clients can't
+  // inline code that depends on it.
+  if (M.getSwiftModule()->getResilienceStrategy() ==
+      ResilienceStrategy::Resilient)
+    return;
+
+  for (SILFunction &F : M) {
+    if (F.isFragile() || !F.isDefinition() ||
+        !hasPublicVisibility(F.getLinkage()) ||
+        !F.getLoweredFunctionType()->isPolymorphic())
+      continue;
+
+    FunctionsToSerialize.clear();
+    GlobalsToSerialize.clear();
+    if (!canSerialize(&F))
+      continue;
+
+    for (SILFunction *Dep : FunctionsToSerialize) {
+      DEBUG(llvm::dbgs() << "  make fragile: " << Dep->getName() << '\n');
+      Dep->setFragile(IsFragile);
+      ++NumFunctionsSerialized;
+    }
+    for (SILGlobalVariable *G : GlobalsToSerialize)
+      G->setFragile(true);
+  }
+}
+
+SILTransform *swift::createCrossModuleSerializationSetup() {
+  return new CrossModuleSerializationSetup();
+}
@@ -0,0 +1,107 @@
+//===--- EffectsSummaryInference.cpp - Record effects of public functions -===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// With -cross-module-optimization, record the side-effects which
+// SideEffectAnalysis computes for public functions as the function's effects
+// kind, just as if the function was annotated with @effects(readnone) or
+// @effects(readonly).
+//
+// The effects kind is serialized into the module file, together with a
+// declaration of the function, even if its body is not serialized. Clients
+// pick it up when they link the function's declaration, so that calls to it
+// no longer block ARC, load/store and loop optimizations.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "effects-summary-inference"
+#include "swift/SILOptimizer/PassManager/Passes.h"
+#include "swift/SILOptimizer/PassManager/Transforms.h"
+#include "swift/SILOptimizer/Analysis/SideEffectAnalysis.h"
+#include "swift/AST/Module.h"
+#include "swift/SIL/SILFunction.h"
+#include "swift/SIL/SILModule.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/Debug.h"
+
+using namespace swift;
+
+STATISTIC(NumReadNone, "Number of functions inferred as readnone");
+STATISTIC(NumReadOnly, "Number of functions inferred as readonly");
+
+/// Returns the strongest effects kind which is guaranteed by \p FE, or
+/// EffectsKind::Unspecified if the effects don't fit into any effects kind.
+///
+/// Calls to readnone and readonly functions may be removed if their results
+/// are unused, so neither can trap, allocate objects or touch reference
+/// counts.
+static EffectsKind
+getEffectsKind(const SideEffectAnalysis::FunctionEffects &FE,
+               SILFunction *F) {
+  if (FE.mayTrap() || FE.mayAllocObjects() || FE.mayReadRC())
+    return EffectsKind::Unspecified;
+
+  switch (FE.getMemBehavior(RetainObserveKind::ObserveRetains)) {
+    case SILInstruction::MemoryBehavior::None:
+      return EffectsKind::ReadNone;
+    case SILInstruction::MemoryBehavior::MayRead:
+      // Same restriction as for @effects(readonly): a release of an owned
+      // parameter by the caller's optimized code could call a deinit.
+      if (!F->hasOwnedParameters())
+        return EffectsKind::ReadOnly;
+      return EffectsKind::Unspecified;
+    default:
+      return EffectsKind::Unspecified;
+  }
+}
+
+namespace {
+
+class EffectsSummaryInference : public SILModuleTransform {
+  void run() override {
+    SILModule &M = *getModule();
+    if (!M.getOptions().CrossModuleOptimization || !M.isWholeModule())
+      return;
+
+    // The implementation of a function in a resilient module may change, so
+    // clients may not rely on its current effects.
+    if (M.getSwiftModule()->getResilienceStrategy() ==
+        ResilienceStrategy::Resilient)
+      return;
+
+    auto *SEA = PM->getAnalysis<SideEffectAnalysis>();
+    for (SILFunction &F : M) {
+      if (!F.isDefinition() || !hasPublicVisibility(F.getLinkage()) ||
+          F.getEffectsKind() != EffectsKind::Unspecified)
+        continue;
+
+      EffectsKind Kind = getEffectsKind(SEA->getEffects(&F), &F);
+      if (Kind == EffectsKind::Unspecified)
+        continue;
+
+      DEBUG(llvm::dbgs() << "  infer "
+                         << (Kind == EffectsKind::ReadNone ? "readnone"
+                                                           : "readonly")
+                         << ": " << F.getName() << '\n');
+      F.setEffectsKind(Kind);
+      if (Kind == EffectsKind::ReadNone)
+        ++NumReadNone;
+      else
+        ++NumReadOnly;
+    }
+  }
+};
+
+} // end anonymous namespace
+
+SILTransform *swift::createEffectsSummaryInference() {
+  return new EffectsSummaryInference();
+}
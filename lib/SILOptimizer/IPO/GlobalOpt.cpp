@@ -19,6 +19,7 @@
 #include "swift/SILOptimizer/Analysis/DominanceAnalysis.h"
 #include "swift/SILOptimizer/PassManager/Passes.h"
 #include "swift/SILOptimizer/PassManager/Transforms.h"
+#include "swift/SILOptimizer/Utils/ConstantFolding.h"
 #include "swift/SILOptimizer/Utils/Local.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/SCCIterator.h"
@@ -37,7 +38,8 @@ namespace {
 ///   entry points.
 ///
 /// - Convert trivial initializers to static initialization. This requires
-///   serializing globals.
+///   serializing globals. Initializers which compute a constant are evaluated
+///   at compile time first.
 ///
 /// - For global "lets", generate addressors that return by value. If we also
 ///  converted to a static initializer, then remove the load from the addressor.
@@ -700,6 +702,14 @@ void SILGlobalOpt::optimizeInitializer(SILFunction *AddrF,
       InitializerCount[InitF] > 1)
     return;
 
+  // If the globalinit_func computes a constant, reduce it to the trivial
+  // form first.
+  if (!SILGlobalVariable::canBeStaticInitializer(InitF) &&
+      evaluateGlobalInitializer(InitF)) {
+    DEBUG(llvm::dbgs() << "GlobalOpt: evaluated " << InitF->getName() << '\n');
+    HasChanged = true;
+  }
+
   // If the globalinit_func is trivial, continue; otherwise bail.
   auto *SILG = SILGlobalVariable::getVariableOfStaticInitializer(InitF);
   if (!SILG || !SILG->isDefinition())
@@ -695,7 +695,7 @@ static bool dominates(DominanceInfo *DT, SILValue V, SILBasicBlock *B) {
 }
 
 /// Subtract a constant from a builtin integer value.
-static SILValue getSub(SILLocation Loc, SILValue Val, unsigned SubVal,
+static SILValue getSub(SILLocation Loc, SILValue Val, const APInt &SubVal,
                        SILBuilder &B) {
   SmallVector<SILValue, 4> Args(1, Val);
   Args.push_back(B.createIntegerLiteral(Loc, Val->getType(), SubVal));
@@ -707,12 +707,14 @@ static SILValue getSub(SILLocation Loc, SILValue Val, unsigned SubVal,
   return B.createTupleExtract(Loc, AI, 0);
 }
 
-/// A canonical induction variable incremented by one from Start to End-1.
+/// A canonical induction variable incremented by a constant stride from Start
+/// to End-Stride.
 struct InductionInfo {
   SILArgument *HeaderVal;
   BuiltinInst *Inc;
   SILValue Start;
   SILValue End;
+  APInt Stride;
   BuiltinValueKind Cmp;
   bool IsOverflowCheckInserted;
 
@@ -720,8 +722,9 @@ struct InductionInfo {
       : Cmp(BuiltinValueKind::None), IsOverflowCheckInserted(false) {}
 
   InductionInfo(SILArgument *HV, BuiltinInst *I, SILValue S, SILValue E,
-                BuiltinValueKind C, bool IsOverflowChecked = false)
-      : HeaderVal(HV), Inc(I), Start(S), End(E), Cmp(C),
+                const APInt &St, BuiltinValueKind C,
+                bool IsOverflowChecked = false)
+      : HeaderVal(HV), Inc(I), Start(S), End(E), Stride(St), Cmp(C),
         IsOverflowCheckInserted(IsOverflowChecked) {}
 
   bool isValid() { return Start && End; }
@@ -734,9 +737,11 @@ struct InductionInfo {
   }
 
   SILValue getLastValue(SILLocation &Loc, SILBuilder &B) {
-    return getSub(Loc, End, 1, B);
+    return getSub(Loc, End, Stride, B);
   }
 
+  bool isUnitStride() { return Stride == 1; }
+
   /// If necessary insert an overflow for this induction variable.
   /// If we compare for equality we need to make sure that the range does wrap.
   /// We would have trapped either when overflowing or when accessing an array
@@ -747,10 +752,33 @@ struct InductionInfo {
       return false;
 
     auto Loc = Inc->getLoc();
+    auto Ty = Start->getType();
     auto ResultTy = SILType::getBuiltinIntegerType(1, Builder.getASTContext());
+
+    // A decrementing induction variable counts down from Start to End.
+    SILValue Low = Start;
+    SILValue High = End;
+    if (Stride.isNegative())
+      std::swap(Low, High);
     auto *CmpSGE = Builder.createBuiltinBinaryFunction(
-        Loc, "cmp_sge", Start->getType(), ResultTy, {Start, End});
+        Loc, "cmp_sge", Ty, ResultTy, {Low, High});
     Builder.createCondFail(Loc, CmpSGE);
+
+    // With a non-unit stride the induction variable only hits End if the
+    // distance is a multiple of the stride. As Low < High the subtraction
+    // cannot wrap when interpreted as an unsigned value.
+    APInt AbsStride = Stride.abs();
+    if (AbsStride != 1) {
+      auto *Distance = Builder.createBuiltinBinaryFunction(
+          Loc, "sub", Ty, Ty, {High, Low});
+      auto *StrideVal = Builder.createIntegerLiteral(Loc, Ty, AbsStride);
+      auto *Rem = Builder.createBuiltinBinaryFunction(
+          Loc, "urem", Ty, Ty, {Distance, StrideVal});
+      auto *Zero = Builder.createIntegerLiteral(Loc, Ty, 0);
+      auto *CmpNE = Builder.createBuiltinBinaryFunction(
+          Loc, "cmp_ne", Ty, ResultTy, {Rem, Zero});
+      Builder.createCondFail(Loc, CmpNE);
+    }
     IsOverflowCheckInserted = true;
 
     // We can now remove the cond fail on the increment the above comparison
@@ -765,7 +793,7 @@ struct InductionInfo {
 /// Analyze canonical induction variables in a loop to find their start and end
 /// values.
 /// At the moment we only handle very simple induction variables that increment
-/// by one and use equality comparison.
+/// or decrement by a constant and use equality comparison.
 class InductionAnalysis {
   using InductionInfoMap = llvm::DenseMap<SILArgument *, InductionInfo *>;
 
@@ -799,7 +827,7 @@ public:
       }
 
       InductionInfo *Info;
-      if (!(Info = analyzeIndVar(Arg, IV.Inc, IV.IncVal))) {
+      if (!(Info = analyzeIndVar(Arg, IV.Inc, IV.getStride()))) {
         DEBUG(llvm::dbgs() << " could not analyze the induction on: " << *Arg);
         continue;
       }
@@ -822,8 +850,8 @@ private:
 
   /// Analyze one potential induction variable starting at Arg.
   InductionInfo *analyzeIndVar(SILArgument *HeaderVal, BuiltinInst *Inc,
-                               IntegerLiteralInst *IncVal) {
-    if (IncVal->getValue() != 1)
+                               const APInt &Stride) {
+    if (!Stride)
       return nullptr;
 
     // Find the start value.
@@ -867,14 +895,19 @@ private:
 
     // Check whether the addition is overflow checked by a cond_fail or whether
     // code in the preheader's predecessor ensures that we won't overflow.
+    // A range check "Start < End" does not guarantee that an induction
+    // variable with a non-unit stride hits End.
     bool IsRangeChecked = false;
     if (!isOverflowChecked(Inc)) {
+      if (Stride != 1)
+        return nullptr;
       IsRangeChecked = isRangeChecked(Start, End, Preheader, DT);
       if (!IsRangeChecked)
         return nullptr;
     }
-    return new (Allocator.Allocate()) InductionInfo(
-        HeaderVal, Inc, Start, End, BuiltinValueKind::ICMP_EQ, IsRangeChecked);
+    return new (Allocator.Allocate())
+        InductionInfo(HeaderVal, Inc, Start, End, Stride,
+                      BuiltinValueKind::ICMP_EQ, IsRangeChecked);
   }
 };
 
@@ -914,15 +947,19 @@ public:
     if (!AsArg)
       return nullptr;
 
+    // The range of an induction variable with a non-unit stride is only
+    // known if the overflow check ensures that it hits the end value.
     if (auto *Ind = IndVars[AsArg])
-      return AccessFunction(Ind);
+      if (Ind->isUnitStride() || Ind->IsOverflowCheckInserted)
+        return AccessFunction(Ind);
 
     return nullptr;
   }
 
   /// Returns true if the loop iterates from 0 until count of \p Array.
   bool isZeroToCount(SILValue Array) {
-    return getZeroToCountArray(Ind->Start, Ind->End) == Array;
+    return !Ind->Stride.isNegative() &&
+           getZeroToCountArray(Ind->Start, Ind->End) == Array;
   }
 
   /// Hoists the necessary check for beginning and end of the induction
@@ -1087,7 +1124,7 @@ static bool isValueKnownFalseAt(SILValue Val, SILInstruction *At,
 /// true.
 static bool isComparisonKnownTrue(BuiltinInst *Builtin, InductionInfo &IndVar) {
   if (!IndVar.IsOverflowCheckInserted ||
-      IndVar.Cmp != BuiltinValueKind::ICMP_EQ)
+      IndVar.Cmp != BuiltinValueKind::ICMP_EQ || IndVar.Stride.isNegative())
     return false;
   return match(Builtin,
                m_ApplyInst(BuiltinValueKind::ICMP_SLE, m_Specific(IndVar.Start),
@@ -1102,7 +1139,7 @@ static bool isComparisonKnownTrue(BuiltinInst *Builtin, InductionInfo &IndVar) {
 static bool isComparisonKnownFalse(BuiltinInst *Builtin,
                                    InductionInfo &IndVar) {
   if (!IndVar.IsOverflowCheckInserted ||
-      IndVar.Cmp != BuiltinValueKind::ICMP_EQ)
+      IndVar.Cmp != BuiltinValueKind::ICMP_EQ || IndVar.Stride.isNegative())
     return false;
 
   // Pattern match a false condition patterns that we can detect and optimize:
@@ -1143,10 +1180,6 @@ static bool hoistBoundsChecks(SILLoop *Loop, DominanceInfo *DT, SILLoopInfo *LI,
     return false;
   }
 
-  // Only handle innermost loops for now.
-  if (!Loop->getSubLoops().empty())
-    return false;
-
   DEBUG(llvm::dbgs() << "Attempting to remove redundant checks in " << *Loop);
   DEBUG(Header->getParent()->dump());
 
@@ -0,0 +1,257 @@
+//===--- ArrayElementAccessOpt.cpp - Direct array element loads in loops --===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+///
+/// Replace array.get_element calls in loops by a load from the address which
+/// array.get_element_address returns, if the array is known to be a native
+/// Swift array.
+///
+/// This is the case in the fast-path loop nest which the array.props
+/// specializer (SwiftArrayOpts) creates, where wasNativeTypeChecked is the
+/// constant 'true', and for element types which can't be bridged from an
+/// NSArray. There, the element is always stored in the contiguous buffer,
+/// and get_element only hides a plain 'base + index' load. Exposing the load
+/// lets LICM hoist the buffer's base address out of the loop and lets
+/// LLVM vectorize loops over arrays of numbers. The bounds check stays as a
+/// separate array.check_subscript call, which is hoisted by ABCOpts.
+///
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "sil-array-element-access"
+
+#include "swift/AST/Decl.h"
+#include "swift/SIL/SILBuilder.h"
+#include "swift/SIL/SILFunction.h"
+#include "swift/SIL/SILInstruction.h"
+#include "swift/SILOptimizer/Analysis/ArraySemantic.h"
+#include "swift/SILOptimizer/Analysis/LoopAnalysis.h"
+#include "swift/SILOptimizer/PassManager/Passes.h"
+#include "swift/SILOptimizer/PassManager/Transforms.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+
+using namespace swift;
+
+STATISTIC(NumElementLoads,
+          "Number of array.get_element calls replaced by direct loads");
+
+static llvm::cl::opt<bool>
+EnableArrayElementAccessOpt("enable-array-element-access-opt",
+                            llvm::cl::init(true));
+
+/// Is the array of this get_element call known to be a native Swift array,
+/// whose elements are stored in its contiguous buffer?
+static bool isNativeArrayAccess(ArraySemanticsCall GetElement) {
+  if (!GetElement.mayHaveBridgedObjectElementType())
+    return true;
+
+  // The fast-path of a loop specialized on array.props.isNativeTypeChecked.
+  auto *SI = dyn_cast<StructInst>(GetElement.getTypeCheckedArgument());
+  if (!SI || SI->getNumOperands() != 1)
+    return false;
+  auto *IL = dyn_cast<IntegerLiteralInst>(SI->getOperand(0));
+  return IL && IL->getValue().getBoolValue();
+}
+
+/// Can a call to \p Callee be added to \p F?
+static bool canReferenceFunction(SILFunction *F, SILFunction *Callee) {
+  // A fragile function is inlined into other modules, which can only see
+  // public symbols and code they can inline themselves.
+  if (F->isFragile() && !Callee->hasValidLinkageForFragileRef())
+    return false;
+
+  // An internal function of another module, like the standard library's
+  // _getElementAddress unless it is @_versioned, has no symbol we could
+  // link against. Shared functions are emitted into each module using them.
+  SILLinkage Linkage = Callee->getLinkage();
+  return !isAvailableExternally(Linkage) || hasPublicVisibility(Linkage) ||
+         hasSharedVisibility(Linkage);
+}
+
+namespace {
+
+/// Replaces get_element calls by loads from get_element_address.
+class ElementAccessRewriter {
+  SILFunction *F;
+
+  /// The array.get_element_address function of each array type declaration,
+  /// or null if it is not available.
+  llvm::DenseMap<NominalTypeDecl *, SILFunction *> ElementAddressFunctions;
+
+public:
+  ElementAccessRewriter(SILFunction *F) : F(F) {}
+
+  bool rewrite(ArraySemanticsCall GetElement);
+
+private:
+  SILFunction *getElementAddressFunction(NominalTypeDecl *ArrayDecl,
+                                         SILLocation Loc);
+};
+
+} // end anonymous namespace
+
+SILFunction *
+ElementAccessRewriter::getElementAddressFunction(NominalTypeDecl *ArrayDecl,
+                                                 SILLocation Loc) {
+  auto It = ElementAddressFunctions.find(ArrayDecl);
+  if (It != ElementAddressFunctions.end())
+    return It->second;
+
+  SILFunction *Result = nullptr;
+  SILModule &M = F->getModule();
+  auto Name = M.getASTContext().getIdentifier("_getElementAddress");
+  for (auto *Member : ArrayDecl->lookupDirect(Name)) {
+    auto *FD = dyn_cast<FuncDecl>(Member);
+    if (!FD)
+      continue;
+    auto *Fn = M.getOrCreateFunction(Loc, SILDeclRef(FD),
+                                     ForDefinition_t::NotForDefinition);
+    if (!Fn || !Fn->hasSemanticsAttr("array.get_element_address"))
+      continue;
+
+    // Unlike the other array semantics passes, which only move or remove
+    // existing calls, this adds a reference to the function. We can't rely
+    // on it being inlined later, so the reference itself must be valid.
+    if (!canReferenceFunction(F, Fn))
+      break;
+
+    // We need the body to be able to inline the call later.
+    if (Fn->isExternalDeclaration())
+      M.linkFunction(Fn, SILModule::LinkingMode::LinkAll);
+    if (Fn->isExternalDeclaration())
+      break;
+
+    Result = Fn;
+    break;
+  }
+  ElementAddressFunctions[ArrayDecl] = Result;
+  return Result;
+}
+
+/// Replace
+///
+///   %e = apply %get_element(%i, %native, %token, %array)
+///
+/// by
+///
+///   %p = apply %get_element_address<Element>(%i, %array)
+///   %raw = struct_extract %p : $UnsafeMutablePointer<Element>, #_rawValue
+///   %a = pointer_to_address %raw to [strict] $*Element
+///   %e = load %a
+///   retain_value %e
+bool ElementAccessRewriter::rewrite(ArraySemanticsCall GetElement) {
+  ApplyInst *AI = GetElement;
+  SILModule &M = F->getModule();
+  SILLocation Loc = AI->getLoc();
+
+  if (!GetElement.hasGetElementDirectResult() || !isNativeArrayAccess(GetElement))
+    return false;
+
+  SILValue Self = GetElement.getSelf();
+  CanType ArrayTy = Self->getType().getSwiftRValueType();
+  auto *ArrayDecl = ArrayTy->getAnyNominal();
+  if (!ArrayDecl || !isa<BoundGenericType>(ArrayTy))
+    return false;
+
+  SILFunction *AddrFn = getElementAddressFunction(ArrayDecl, Loc);
+  if (!AddrFn)
+    return false;
+
+  // The address function is generic; it is specialized and inlined later.
+  auto Subs = ArrayTy->gatherAllSubstitutions(M.getSwiftModule(), nullptr);
+  SILType FnTy = AddrFn->getLoweredType();
+  SILType SubstFnTy = FnTy.substGenericArgs(M, Subs);
+  auto SubstFnInfo = SubstFnTy.castTo<SILFunctionType>();
+  SILType PtrTy = SubstFnInfo->getSILResult();
+  if (SubstFnInfo->getNumParameters() != 2 ||
+      SubstFnInfo->getSelfParameter().getSILType() != Self->getType())
+    return false;
+
+  auto *PtrDecl = PtrTy.getStructOrBoundGenericStruct();
+  if (!PtrDecl)
+    return false;
+  auto Properties = PtrDecl->getStoredProperties();
+  if (Properties.empty())
+    return false;
+  VarDecl *RawValueField = *Properties.begin();
+
+  SILType ElementTy = AI->getType();
+  if (!ElementTy.isLoadable(M))
+    return false;
+
+  SILBuilderWithScope B(AI);
+  if (SubstFnInfo->getSelfParameter().isConsumed())
+    B.createRetainValue(Loc, Self, Atomicity::Atomic);
+  auto *FnRef = B.createFunctionRef(Loc, AddrFn);
+  auto *Ptr = B.createApply(Loc, FnRef, SubstFnTy, PtrTy, Subs,
+                            {GetElement.getIndex(), Self},
+                            /*isNonThrowing*/ false);
+  auto *RawPtr = B.createStructExtract(Loc, Ptr, RawValueField);
+  auto *Addr = B.createPointerToAddress(Loc, RawPtr, ElementTy.getAddressType(),
+                                        /*isStrict*/ true);
+
+  // get_element returns the element at +1.
+  auto &ElementTL = M.getTypeLowering(ElementTy);
+  SILValue Element = ElementTL.emitLoadOfCopy(B, Loc, Addr, IsNotTake);
+
+  if (!GetElement.hasGuaranteedSelf())
+    B.createReleaseValue(Loc, Self, Atomicity::Atomic);
+
+  // Keep the array.check_subscript call which the token refers to.
+  AI->replaceAllUsesWith(Element);
+  AI->eraseFromParent();
+  ++NumElementLoads;
+  return true;
+}
+
+namespace {
+
+class ArrayElementAccessOpt : public SILFunctionTransform {
+  void run() override {
+    if (!EnableArrayElementAccessOpt)
+      return;
+
+    SILFunction *F = getFunction();
+    SILLoopInfo *LI = PM->getAnalysis<SILLoopAnalysis>()->get(F);
+    if (LI->empty())
+      return;
+
+    DEBUG(llvm::dbgs() << "ArrayElementAccessOpt on " << F->getName() << "\n");
+
+    // Only accesses in loops benefit from exposing the element address.
+    SmallVector<ArraySemanticsCall, 16> GetElementCalls;
+    for (auto &BB : *F) {
+      if (!LI->getLoopFor(&BB))
+        continue;
+      for (auto &Inst : BB) {
+        ArraySemanticsCall Call(&Inst, "array.get_element");
+        if (Call && Call.getKind() == ArrayCallKind::kGetElement)
+          GetElementCalls.push_back(Call);
+      }
+    }
+
+    ElementAccessRewriter Rewriter(F);
+    bool Changed = false;
+    for (auto Call : GetElementCalls)
+      Changed |= Rewriter.rewrite(Call);
+
+    if (Changed)
+      invalidateAnalysis(SILAnalysis::InvalidationKind::CallsAndInstructions);
+  }
+};
+
+} // end anonymous namespace
+
+SILTransform *swift::createArrayElementAccessOpt() {
+  return new ArrayElementAccessOpt();
+}
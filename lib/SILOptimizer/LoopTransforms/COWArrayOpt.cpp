@@ -959,6 +959,20 @@ findPrecedingCheckSubscriptOrMakeMutable(ApplyInst *GetElementAddr) {
   return nullptr;
 }
 
+/// Returns true if \p A and \p B are the same address, or project the same
+/// stored properties out of the same base address.
+static bool isSameFieldAddress(SILValue A, SILValue B) {
+  while (A != B) {
+    auto *SEA = dyn_cast<StructElementAddrInst>(A);
+    auto *SEB = dyn_cast<StructElementAddrInst>(B);
+    if (!SEA || !SEB || SEA->getField() != SEB->getField())
+      return false;
+    A = SEA->getOperand();
+    B = SEB->getOperand();
+  }
+  return true;
+}
+
 /// Matches the self parameter arguments, verifies that \p Self is called and
 /// stores the instructions in \p DepInsts in order.
 static bool
@@ -1006,11 +1020,13 @@ matchSelfParameterSetup(ArraySemanticsCall Call, LoadInst *Self,
 struct HoistableMakeMutable {
   SILLoop *Loop;
   bool IsHoistable;
+  bool IsElementOfArray;
   ApplyInst *MakeMutable;
   SmallVector<SILInstruction *, 24> DepInsts;
 
   HoistableMakeMutable(ArraySemanticsCall M, SILLoop *L) {
     IsHoistable = false;
+    IsElementOfArray = false;
     Loop = L;
     MakeMutable = M;
 
@@ -1018,15 +1034,20 @@ struct HoistableMakeMutable {
     if (Loop->contains(MakeMutable->getCallee()->getParentBlock()))
       return;
 
+    // The array is stored in a struct field of an address computed in the
+    // loop.
+    SILValue ArrayAddr = stripFieldProjectionsInLoop(M.getSelf());
+
     // The array reference is invariant.
-    if (!L->contains(M.getSelf()->getParentBlock())) {
+    if (!L->contains(ArrayAddr->getParentBlock())) {
       IsHoistable = true;
       return;
     }
 
     // Check whether we can hoist the dependent instructions resulting in the
     // array reference.
-    if (canHoistDependentInstructions(M))
+    IsElementOfArray = true;
+    if (canHoistDependentInstructions(ArrayAddr))
       IsHoistable = true;
   }
 
@@ -1035,6 +1056,12 @@ struct HoistableMakeMutable {
     return IsHoistable;
   }
 
+  /// Is the array an element of another array, whose make_mutable call must
+  /// be executed first.
+  bool isElementOfArray() {
+    return IsElementOfArray;
+  }
+
   /// Hoist this make_mutable call and depend instructions to the preheader.
   void hoist() {
     auto *Term = Loop->getLoopPreheader()->getTerminator();
@@ -1047,10 +1074,29 @@ struct HoistableMakeMutable {
 
 private:
 
+  /// Strips the struct_element_addr projections of \p Addr that are inside
+  /// the loop and adds them to the dependent instructions.
+  SILValue stripFieldProjectionsInLoop(SILValue Addr) {
+    while (auto *SEA = dyn_cast<StructElementAddrInst>(Addr)) {
+      if (!Loop->contains(SEA->getParent()))
+        break;
+      DepInsts.push_back(SEA);
+      Addr = SEA->getOperand();
+    }
+    return Addr;
+  }
+
+  /// Returns true if \p Addr is invariant in the loop, up to struct field
+  /// projections that can be hoisted along with the make_mutable call.
+  bool isInvariantAddress(SILValue Addr) {
+    Addr = stripFieldProjectionsInLoop(Addr);
+    return !Loop->contains(Addr->getParentBlock());
+  }
+
   /// Check whether we can hoist the dependent instructions resulting in the
   /// array reference passed to the make_mutable call.
   /// We pattern match the first dimension's array access here.
-  bool canHoistDependentInstructions(ArraySemanticsCall &M) {
+  bool canHoistDependentInstructions(SILValue ArrayAddr) {
     // Match get_element_addr call.
     // %124 = load %3
     // %125 = struct_extract %124
@@ -1067,7 +1113,7 @@ private:
     // %135 = pointer_to_address %134 to strict $*Array<Int>
     // %136 = mark_dependence %135 on %133
 
-    auto *MarkDependence = dyn_cast<MarkDependenceInst>(M.getSelf());
+    auto *MarkDependence = dyn_cast<MarkDependenceInst>(ArrayAddr);
     if (!MarkDependence)
       return false;
     DepInsts.push_back(MarkDependence);
@@ -1097,9 +1143,11 @@ private:
 
     SILValue ArrayBuffer = stripValueProjections(UncheckedRefCast->getOperand(), DepInsts);
     auto *BaseLoad = dyn_cast<LoadInst>(ArrayBuffer);
-    if (!BaseLoad ||  Loop->contains(BaseLoad->getOperand()->getParentBlock()))
+    if (!BaseLoad)
       return false;
     DepInsts.push_back(BaseLoad);
+    if (!isInvariantAddress(BaseLoad->getOperand()))
+      return false;
 
     // Check the get_element_addr call.
     ArraySemanticsCall GetElementAddrCall(
@@ -1115,14 +1163,15 @@ private:
 
     auto *GetElementAddrArrayLoad =
         dyn_cast<LoadInst>(GetElementAddrCall.getSelf());
-    if (!GetElementAddrArrayLoad ||
-        Loop->contains(GetElementAddrArrayLoad->getOperand()->getParentBlock()))
+    if (!GetElementAddrArrayLoad)
       return false;
 
     // Check the retain/release around the get_element_addr call.
     if (!matchSelfParameterSetup(GetElementAddrCall, GetElementAddrArrayLoad,
                                  DepInsts))
       return false;
+    if (!isInvariantAddress(GetElementAddrArrayLoad->getOperand()))
+      return false;
 
     // Check check_subscript.
     // %116 = load %3
@@ -1150,16 +1199,15 @@ private:
 
     auto *CheckSubscriptArrayLoad =
         dyn_cast<LoadInst>(CheckSubscript.getSelf());
-    if (!CheckSubscript ||
-        Loop->contains(CheckSubscriptArrayLoad->getOperand()->getParentBlock()))
+    if (!CheckSubscriptArrayLoad)
       return false;
-  if (Loop->contains(
+    if (Loop->contains(
             ((ApplyInst *)CheckSubscript)->getCallee()->getParentBlock()))
       return false;
 
     // The array must match get_element_addr's array.
-    if (CheckSubscriptArrayLoad->getOperand() !=
-        GetElementAddrArrayLoad->getOperand())
+    if (!isSameFieldAddress(CheckSubscriptArrayLoad->getOperand(),
+                            GetElementAddrArrayLoad->getOperand()))
       return false;
 
     // Check the retain/release around the check_subscript call.
@@ -1167,16 +1215,18 @@ private:
                                  DepInsts))
       return false;
 
-    return true;
+    return isInvariantAddress(CheckSubscriptArrayLoad->getOperand());
   }
 };
 
 /// Prove that there are not array value mutating or capturing operations in the
 /// loop and hoist make_mutable.
+///
+/// The loop may contain inner loops, e.g. the outer loop of a nested loop over
+/// a two dimensional array. If only some of the make_mutable calls are
+/// hoistable, the ones for arrays which are not an element of another array
+/// are still hoisted. Returns true if all make_mutable calls were hoisted.
 bool COWArrayOpt::hoistInLoopWithOnlyNonArrayValueMutatingOperations() {
-  // Only handle innermost loops.
-  assert(Loop->getSubLoops().empty() && "Only works in innermost loops");
-
   DEBUG(llvm::dbgs() << "    Checking whether loop only has only non array "
                         "value mutating operations ...\n");
 
@@ -1310,22 +1360,39 @@ bool COWArrayOpt::hoistInLoopWithOnlyNonArrayValueMutatingOperations() {
 
   // Collect all recursively hoistable calls.
   SmallVector<std::unique_ptr<HoistableMakeMutable>, 16> CallsToHoist;
+  bool AllHoistable = true;
   for (auto M : MakeMutableCalls) {
     auto Call = llvm::make_unique<HoistableMakeMutable>(M, Loop);
     if (!Call->isHoistable()) {
       DEBUG(llvm::dbgs() << "    (NO) make_mutable not hoistable"
                          << *Call->MakeMutable);
-      return ReturnWithCleanup(false);
+      AllHoistable = false;
+      continue;
     }
     CallsToHoist.push_back(std::move(Call));
   }
 
+  // The make_mutable call of an array element writes to the storage of the
+  // outer array. It must not be moved above an outer array's make_mutable
+  // call which stays in the loop.
+  if (!AllHoistable)
+    CallsToHoist.erase(
+        std::remove_if(CallsToHoist.begin(), CallsToHoist.end(),
+                       [](const std::unique_ptr<HoistableMakeMutable> &Call) {
+                         return Call->isElementOfArray();
+                       }),
+        CallsToHoist.end());
+
+  if (CallsToHoist.empty())
+    return ReturnWithCleanup(false);
+
   for (auto &Call: CallsToHoist)
     Call->hoist();
+  HasChanged = true;
 
   DEBUG(llvm::dbgs() << "    Hoisting make_mutable in " << Function->getName()
                      << "\n");
-  return ReturnWithCleanup(true);
+  return ReturnWithCleanup(AllHoistable);
 }
 
 /// Check if a loop has only 'safe' array operations such that we can hoist the
@@ -1518,11 +1585,10 @@ bool COWArrayOpt::run() {
   }
 
   // Hoist make_mutable in two dimensional arrays if there are no array value
-  // mutating operations in the loop.
-  if (Loop->getSubLoops().empty() &&
-      hoistInLoopWithOnlyNonArrayValueMutatingOperations()) {
+  // mutating operations in the loop. Calls which are left in the loop are
+  // handled below.
+  if (hoistInLoopWithOnlyNonArrayValueMutatingOperations())
     return true;
-  }
 
   for (auto *BB : Loop->getBlocks()) {
     if (ColdBlocks.isCold(BB))
@@ -30,6 +30,7 @@
 #include "swift/SIL/InstructionUtils.h"
 
 #include "llvm/ADT/DepthFirstIterator.h"
+#include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/Support/Debug.h"
 
@@ -88,6 +89,23 @@ static bool mayWriteTo(AliasAnalysis *AA, SideEffectAnalysis *SEA,
   return false;
 }
 
+/// Strips struct and tuple element projections from \p Addr.
+static SILValue stripStructAndTupleAddrs(SILValue Addr) {
+  while (isa<StructElementAddrInst>(Addr) || isa<TupleElementAddrInst>(Addr))
+    Addr = cast<SILInstruction>(Addr)->getOperand(0);
+  return Addr;
+}
+
+/// Returns true if \p LI loads from a `let` property of a class instance.
+/// Such a property is never written after the instance is initialized, so no
+/// write can clobber the load.
+static bool isLetPropertyLoad(LoadInst *LI) {
+  if (auto *REAI = dyn_cast<RefElementAddrInst>(
+          stripStructAndTupleAddrs(LI->getOperand())))
+    return REAI->getField()->isLet();
+  return false;
+}
+
 static void removeWrittenTo(AliasAnalysis *AA, ReadSet &Reads,
                             SILInstruction *ByInst) {
 
@@ -99,7 +117,8 @@ static void removeWrittenTo(AliasAnalysis *AA, ReadSet &Reads,
   SmallVector<SILInstruction *, 8> RS(Reads.begin(), Reads.end());
   for (auto R : RS) {
     auto *LI = dyn_cast<LoadInst>(R);
-    if (LI && !AA->mayWriteToMemory(ByInst, LI->getOperand()))
+    if (LI && (isLetPropertyLoad(LI) ||
+               !AA->mayWriteToMemory(ByInst, LI->getOperand())))
       continue;
 
     DEBUG(llvm::dbgs() << "  mayWriteTo\n" << *ByInst << " to " << *R << "\n");
@@ -107,20 +126,20 @@ static void removeWrittenTo(AliasAnalysis *AA, ReadSet &Reads,
   }
 }
 
+/// Returns true if \p V is defined outside the loop \p L.
+static bool isLoopInvariant(SILValue V, SILLoop *L) {
+  if (auto *Inst = dyn_cast<SILInstruction>(V))
+    return !L->contains(Inst->getParent());
+  if (auto *Arg = dyn_cast<SILArgument>(V))
+    return !L->contains(Arg->getParent());
+  return false;
+}
+
 static bool hasLoopInvariantOperands(SILInstruction *I, SILLoop *L) {
   auto Opds = I->getAllOperands();
 
   return std::all_of(Opds.begin(), Opds.end(), [=](Operand &Op) {
-
-    ValueBase *Def = Op.get();
-
-    // Operand is defined outside the loop.
-    if (auto *Inst = dyn_cast<SILInstruction>(Def))
-      return !L->contains(Inst->getParent());
-    if (auto *Arg = dyn_cast<SILArgument>(Def))
-      return !L->contains(Arg->getParent());
-
-    return false;
+    return isLoopInvariant(Op.get(), L);
   });
 }
 
@@ -371,6 +390,218 @@ static bool sinkFixLifetime(SILLoop *Loop, DominanceInfo *DomTree,
   return Changed;
 }
 
+/// Returns true if \p Inst can't access memory in a way that matters for
+/// promoting a memory location to registers.
+static bool isTransparentForPromotion(SILInstruction *Inst) {
+  return isa<StrongRetainInst>(Inst) || isa<RetainValueInst>(Inst) ||
+         isa<CondFailInst>(Inst) || isa<DeallocStackInst>(Inst) ||
+         isa<FixLifetimeInst>(Inst);
+}
+
+/// Returns true if the SSA updater can insert phi arguments into \p BB, i.e.
+/// if all predecessors branch to it with a br or cond_br.
+static bool canInsertPhiArgument(SILBasicBlock *BB) {
+  if (BB->getSinglePredecessorBlock())
+    return true;
+  for (SILBasicBlock *Pred : BB->getPredecessorBlocks()) {
+    TermInst *T = Pred->getTerminator();
+    if (!isa<BranchInst>(T) && !isa<CondBranchInst>(T))
+      return false;
+  }
+  return true;
+}
+
+/// Promotes the memory location at the loop invariant address \p Addr to
+/// registers: the value is loaded once in the preheader, loads and stores
+/// within the loop are replaced by SSA values and the final value is stored
+/// back at the loop exits.
+///
+/// This is done if all accesses to the location in the loop are loads and
+/// stores of \p Addr itself and if the location is stored on every path
+/// through the loop.
+static bool promoteToRegisters(SILLoop *Loop, SILValue Addr,
+                               AliasAnalysis *AA, DominanceInfo *DT,
+                               SILLoopInfo *LI) {
+  SILBasicBlock *Preheader = Loop->getLoopPreheader();
+  SmallVector<SILBasicBlock *, 8> ExitingBBs;
+  Loop->getExitingBlocks(ExitingBBs);
+
+  SmallVector<LoadInst *, 8> Loads;
+  SmallVector<StoreInst *, 8> Stores;
+  bool StoredOnAllPaths = false;
+  for (auto *BB : Loop->getBlocks()) {
+    if (!canInsertPhiArgument(BB))
+      return false;
+
+    for (auto &Inst : *BB) {
+      if (auto *LoadI = dyn_cast<LoadInst>(&Inst)) {
+        if (LoadI->getOperand() == Addr) {
+          if (LoadI->getOwnershipQualifier() == LoadOwnershipQualifier::Take ||
+              LoadI->getOwnershipQualifier() == LoadOwnershipQualifier::Copy)
+            return false;
+          Loads.push_back(LoadI);
+          continue;
+        }
+      } else if (auto *SI = dyn_cast<StoreInst>(&Inst)) {
+        if (SI->getDest() == Addr) {
+          Stores.push_back(SI);
+          if (std::all_of(ExitingBBs.begin(), ExitingBBs.end(),
+                          [=](SILBasicBlock *ExitingBB) {
+                            return DT->dominates(BB, ExitingBB);
+                          }))
+            StoredOnAllPaths = true;
+          continue;
+        }
+      }
+      if (isTransparentForPromotion(&Inst))
+        continue;
+      if (AA->mayReadOrWriteMemory(&Inst, Addr)) {
+        DEBUG(llvm::dbgs() << "   location may be accessed by " << Inst);
+        return false;
+      }
+    }
+  }
+  // If the location isn't stored on all paths, storing it at the exits could
+  // introduce a write which didn't happen in the original program.
+  if (Stores.empty() || !StoredOnAllPaths)
+    return false;
+
+  // Collect the exit edges. Split them so that each exit block has a single
+  // predecessor, in which the final value is available.
+  SmallVector<std::pair<SILBasicBlock *, unsigned>, 4> ExitEdges;
+  for (auto *ExitingBB : ExitingBBs) {
+    auto Succs = ExitingBB->getSuccessors();
+    for (unsigned EdgeIdx = 0; EdgeIdx < Succs.size(); ++EdgeIdx) {
+      SILBasicBlock *Succ = Succs[EdgeIdx];
+      if (Loop->contains(Succ))
+        continue;
+      // A critical edge from a cond_br is split below. Otherwise the exit
+      // block must only be reachable from within the loop.
+      if (!Succ->getSinglePredecessorBlock() &&
+          !isa<CondBranchInst>(ExitingBB->getTerminator())) {
+        if (!canInsertPhiArgument(Succ))
+          return false;
+        for (SILBasicBlock *Pred : Succ->getPredecessorBlocks())
+          if (!Loop->contains(Pred))
+            return false;
+      }
+      ExitEdges.push_back({ExitingBB, EdgeIdx});
+    }
+  }
+
+  DEBUG(llvm::dbgs() << "   promoting to registers: " << Addr);
+
+  llvm::SmallSetVector<SILBasicBlock *, 4> ExitBBs;
+  for (auto &Edge : ExitEdges) {
+    // Splitting an edge replaces the terminator, so don't keep it around.
+    TermInst *T = Edge.first->getTerminator();
+    SILBasicBlock *ExitBB = T->getSuccessors()[Edge.second];
+    if (SILBasicBlock *SplitBB = splitCriticalEdge(T, Edge.second, DT, LI))
+      ExitBB = SplitBB;
+    ExitBBs.insert(ExitBB);
+  }
+
+  StoreInst *FirstStore = Stores[0];
+  bool IsTrivial = FirstStore->getOwnershipQualifier() ==
+                   StoreOwnershipQualifier::Trivial;
+
+  SILBuilder B(Preheader->getTerminator());
+  LoadInst *InitialValue = B.createLoad(
+      FirstStore->getLoc(), Addr,
+      IsTrivial ? LoadOwnershipQualifier::Trivial
+                : LoadOwnershipQualifier::Unqualified);
+
+  SILSSAUpdater Updater;
+  Updater.Initialize(Addr->getType().getObjectType());
+  Updater.AddAvailableValue(Preheader, InitialValue);
+
+  // The value at the end of a block is the source of its last store.
+  for (StoreInst *SI : Stores)
+    Updater.AddAvailableValue(SI->getParent(), SI->getSrc());
+
+  // Replace the loads. A load which follows a store in the same block gets
+  // the stored value, all others get the value which reaches the block.
+  llvm::SmallPtrSet<SILBasicBlock *, 8> LoadBlocks;
+  for (LoadInst *LoadI : Loads)
+    LoadBlocks.insert(LoadI->getParent());
+  for (SILBasicBlock *BB : LoadBlocks) {
+    SILValue CurrentValue;
+    for (auto InstIt = BB->begin(), End = BB->end(); InstIt != End;) {
+      SILInstruction *Inst = &*InstIt;
+      ++InstIt;
+      if (auto *SI = dyn_cast<StoreInst>(Inst)) {
+        if (SI->getDest() == Addr)
+          CurrentValue = SI->getSrc();
+      } else if (auto *LoadI = dyn_cast<LoadInst>(Inst)) {
+        if (LoadI->getOperand() == Addr) {
+          if (!CurrentValue)
+            CurrentValue = Updater.GetValueInMiddleOfBlock(BB);
+          LoadI->replaceAllUsesWith(CurrentValue);
+          LoadI->eraseFromParent();
+        }
+      }
+    }
+  }
+
+  // Store the final value at the exits.
+  for (SILBasicBlock *ExitBB : ExitBBs) {
+    SILValue FinalValue = Updater.GetValueInMiddleOfBlock(ExitBB);
+    SILBuilder(&*ExitBB->begin())
+        .createStore(FirstStore->getLoc(), FinalValue, Addr,
+                     FirstStore->getOwnershipQualifier());
+  }
+
+  for (StoreInst *SI : Stores)
+    SI->eraseFromParent();
+
+  if (InitialValue->use_empty())
+    InitialValue->eraseFromParent();
+
+  return true;
+}
+
+/// Returns true if \p Addr is the address of a class property or global
+/// variable. Stack locations are left to other passes.
+static bool isPromotableAddress(SILValue Addr) {
+  SILValue Base = stripStructAndTupleAddrs(Addr);
+  return isa<RefElementAddrInst>(Base) || isa<GlobalAddrInst>(Base);
+}
+
+/// Promotes class properties and global variables with loop invariant
+/// addresses, which are stored in the loop, to registers.
+static bool promoteLoopCarriedLocations(SILLoop *Loop, AliasAnalysis *AA,
+                                        DominanceInfo *DT, SILLoopInfo *LI) {
+  if (!Loop->getLoopPreheader())
+    return false;
+
+  // Only handle innermost loops for now.
+  if (!Loop->getSubLoops().empty())
+    return false;
+
+  SILModule &M = Loop->getHeader()->getParent()->getModule();
+  llvm::SmallSetVector<SILValue, 8> Addrs;
+  for (auto *BB : Loop->getBlocks()) {
+    for (auto &Inst : *BB) {
+      auto *SI = dyn_cast<StoreInst>(&Inst);
+      if (!SI || !isLoopInvariant(SI->getDest(), Loop) ||
+          !isPromotableAddress(SI->getDest()))
+        continue;
+      // Only promote trivial values so that no ownership has to be
+      // transferred between the loop iterations.
+      if (SI->getOwnershipQualifier() == StoreOwnershipQualifier::Init ||
+          SI->getOwnershipQualifier() == StoreOwnershipQualifier::Assign ||
+          !SI->getSrc()->getType().isTrivial(M))
+        continue;
+      Addrs.insert(SI->getDest());
+    }
+  }
+
+  bool Changed = false;
+  for (SILValue Addr : Addrs)
+    Changed |= promoteToRegisters(Loop, Addr, AA, DT, LI);
+  return Changed;
+}
+
 namespace {
 /// \brief Summary of may writes occurring in the loop tree rooted at \p
 /// Loop. This includes all writes of the sub loops and the loop itself.
@@ -489,7 +720,7 @@ void LoopTreeOptimization::analyzeCurrentLoop(
       // Collect loads.
       auto LI = dyn_cast<LoadInst>(&Inst);
       if (LI) {
-        if (!mayWriteTo(AA, MayWrites, LI))
+        if (isLetPropertyLoad(LI) || !mayWriteTo(AA, MayWrites, LI))
           SafeReads.insert(LI);
         continue;
       }
@@ -521,6 +752,7 @@ void LoopTreeOptimization::optimizeLoop(SILLoop *CurrentLoop,
   Changed |= sinkCondFail(CurrentLoop);
   Changed |= hoistInstructions(CurrentLoop, DomTree, SafeReads,
                                RunsOnHighLevelSil);
+  Changed |= promoteLoopCarriedLocations(CurrentLoop, AA, DomTree, LoopInfo);
   Changed |= sinkFixLifetime(CurrentLoop, DomTree, LoopInfo);
 }
 
@@ -13,6 +13,7 @@
 #define DEBUG_TYPE "sil-loopunroll"
 
 #include "llvm/ADT/DepthFirstIterator.h"
+#include "llvm/Support/CommandLine.h"
 
 #include "swift/SIL/PatternMatch.h"
 #include "swift/SIL/SILCloner.h"
@@ -30,6 +31,12 @@ using llvm::MapVector;
 
 static const uint64_t SILLoopUnrollThreshold = 250;
 
+static llvm::cl::opt<unsigned> SILPartialUnrollCount(
+    "sil-partial-unroll-count", llvm::cl::init(0), llvm::cl::Hidden,
+    llvm::cl::desc("Unroll loops whose trip count is not known at compile "
+                   "time this many times, keeping all exit checks. Zero "
+                   "disables partial unrolling."));
+
 namespace {
 
 /// Clone the basic blocks in a loop.
@@ -188,8 +195,12 @@ static bool canAndShouldUnrollLoop(SILLoop *Loop, uint64_t TripCount) {
 /// Redirect the terminator of the current loop iteration's latch to the next
 /// iterations header or if this is the last iteration remove the backedge to
 /// the header.
+///
+/// \p CurrentHeader is the header of the loop copy that \p Latch belongs to,
+/// which is where its backedge currently branches.
 static void redirectTerminator(SILBasicBlock *Latch, unsigned CurLoopIter,
-                               unsigned LastLoopIter, SILBasicBlock *OrigHeader,
+                               unsigned LastLoopIter,
+                               SILBasicBlock *CurrentHeader,
                                SILBasicBlock *NextIterationsHeader) {
 
   auto *CurrentTerminator = Latch->getTerminator();
@@ -240,7 +251,7 @@ static void redirectTerminator(SILBasicBlock *Latch, unsigned CurLoopIter,
   // On the last iteration change the conditional exit to an unconditional
   // one.
   if (CurLoopIter == LastLoopIter) {
-    if (CondBr->getTrueBB() != OrigHeader)
+    if (CondBr->getTrueBB() != CurrentHeader)
       SILBuilder(CondBr).createBranch(CondBr->getLoc(), CondBr->getTrueBB(),
                                       CondBr->getTrueArgs());
     else
@@ -251,7 +262,7 @@ static void redirectTerminator(SILBasicBlock *Latch, unsigned CurLoopIter,
   }
 
   // Otherwise, branch to the next iteration's header.
-  if (CondBr->getTrueBB() == OrigHeader) {
+  if (CondBr->getTrueBB() == CurrentHeader) {
     SILBuilder(CondBr).createCondBranch(
         CondBr->getLoc(), CondBr->getCondition(), NextIterationsHeader,
         CondBr->getTrueArgs(), CondBr->getFalseBB(), CondBr->getFalseArgs());
@@ -326,6 +337,12 @@ updateSSA(SILLoop *Loop,
 
 /// Try to fully unroll the loop if we can determine the trip count and the trip
 /// count lis below a threshold.
+///
+/// Otherwise, if partial unrolling is enabled, replicate the loop body
+/// SILPartialUnrollCount times. Every copy keeps its exit check and the last
+/// copy branches back to the original header, so this is correct for any trip
+/// count; it gives later passes larger blocks to work on and halves the
+/// number of backedges taken.
 static bool tryToUnrollLoop(SILLoop *Loop) {
   assert(Loop->getSubLoops().empty() && "Expecting innermost loops");
 
@@ -339,12 +356,18 @@ static bool tryToUnrollLoop(SILLoop *Loop) {
 
   auto *Header = Loop->getHeader();
 
+  // Unrolling a loop the profile says never ran only costs code size.
+  if (Preheader->isProfiledCold() || Header->isProfiledCold())
+    return false;
+
   Optional<uint64_t> MaxTripCount =
       getMaxLoopTripCount(Loop, Preheader, Header, Latch);
-  if (!MaxTripCount)
+  bool FullyUnroll = MaxTripCount.hasValue();
+  uint64_t UnrollCount = FullyUnroll ? *MaxTripCount : SILPartialUnrollCount;
+  if (!FullyUnroll && UnrollCount < 2)
     return false;
 
-  if (!canAndShouldUnrollLoop(Loop, MaxTripCount.getValue()))
+  if (!canAndShouldUnrollLoop(Loop, UnrollCount))
     return false;
 
   // TODO: We need to split edges from non-condbr exits for the SSA updater. For
@@ -355,7 +378,8 @@ static bool tryToUnrollLoop(SILLoop *Loop) {
     if (!isa<CondBranchInst>(Exit->getTerminator()))
       return false;
 
-  DEBUG(llvm::dbgs() << "Unrolling loop in " << Header->getParent()->getName()
+  DEBUG(llvm::dbgs() << (FullyUnroll ? "Unrolling" : "Partially unrolling")
+                     << " loop in " << Header->getParent()->getName()
                      << " " << *Loop << "\n");
 
   SmallVector<SILBasicBlock *, 16> Headers;
@@ -366,8 +390,8 @@ static bool tryToUnrollLoop(SILLoop *Loop) {
 
   DenseMap<SILValue, SmallVector<SILValue, 8>> LoopLiveOutValues;
 
-  // Copy the body MaxTripCount-1 times.
-  for (uint64_t Cnt = 1; Cnt < *MaxTripCount; ++Cnt) {
+  // Copy the body UnrollCount-1 times.
+  for (uint64_t Cnt = 1; Cnt < UnrollCount; ++Cnt) {
     // Clone the blocks in the loop.
     LoopCloner Cloner(Loop);
     Cloner.cloneLoop();
@@ -398,17 +422,20 @@ static bool tryToUnrollLoop(SILLoop *Loop) {
   }
 
   // Thread the loop clones by redirecting the loop latches to the successor
-  // iteration's header.
+  // iteration's header. When partially unrolling, the last copy keeps its
+  // backedge, which now leads to the original header.
   for (unsigned Iteration = 0, End = Latches.size(); Iteration != End;
        ++Iteration) {
     auto *CurrentLatch = Latches[Iteration];
-    auto LastIteration = End - 1;
-    auto *OriginalHeader = Headers[0];
-    auto *NextIterationsHeader =
-        Iteration == LastIteration ? nullptr : Headers[Iteration + 1];
+    auto LastIteration = FullyUnroll ? End - 1 : End;
+    SILBasicBlock *NextIterationsHeader;
+    if (Iteration + 1 != End)
+      NextIterationsHeader = Headers[Iteration + 1];
+    else
+      NextIterationsHeader = FullyUnroll ? nullptr : Headers[0];
 
-    redirectTerminator(CurrentLatch, Iteration, LastIteration, OriginalHeader,
-                       NextIterationsHeader);
+    redirectTerminator(CurrentLatch, Iteration, LastIteration,
+                       Headers[Iteration], NextIterationsHeader);
   }
 
   // Fixup SSA form for loop values used outside the loop.
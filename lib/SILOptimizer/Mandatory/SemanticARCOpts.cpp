@@ -0,0 +1,144 @@
+//===--- SemanticARCOpts.cpp ----------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+///
+/// A small pass that removes copies which ownership SIL proves to be
+/// unnecessary. It runs on SIL straight out of SILGen, before the Ownership
+/// Model Eliminator lowers copy_value and destroy_value into retains and
+/// releases, while the distinction between owned and guaranteed values is
+/// still explicit.
+///
+/// Currently it handles copies of @guaranteed function arguments whose only
+/// uses are non-consuming. The caller keeps such an argument alive for the
+/// whole function, so the copy and all of its destroys can be removed without
+/// any dataflow.
+///
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "sil-semantic-arc-opts"
+#include "swift/SILOptimizer/PassManager/Passes.h"
+#include "swift/SILOptimizer/PassManager/Transforms.h"
+#include "swift/SIL/SILArgument.h"
+#include "swift/SIL/SILInstruction.h"
+#include "swift/SIL/SILVisitor.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/Debug.h"
+
+using namespace swift;
+
+STATISTIC(NumEliminatedCopies, "Number of copies of guaranteed values removed");
+
+//===----------------------------------------------------------------------===//
+//                               Implementation
+//===----------------------------------------------------------------------===//
+
+/// Returns true if \p V is a function argument that its caller guarantees to
+/// keep alive for the duration of the call.
+static bool isGuaranteedFunctionArgument(SILValue V) {
+  auto *Arg = dyn_cast<SILArgument>(V);
+  if (!Arg || !Arg->isFunctionArg())
+    return false;
+  return Arg->getArgumentConvention() ==
+         SILArgumentConvention::Direct_Guaranteed;
+}
+
+/// Returns true if \p Op uses its value without consuming it, and without
+/// producing a value whose lifetime depends on it beyond the use itself.
+static bool isNonConsumingUse(Operand *Op) {
+  auto *User = Op->getUser();
+
+  if (isa<DebugValueInst>(User) || isa<RefElementAddrInst>(User) ||
+      isa<RefTailAddrInst>(User) || isa<ClassMethodInst>(User) ||
+      isa<ValueMetatypeInst>(User) || isa<ExistentialMetatypeInst>(User))
+    return true;
+
+  // Arguments passed to a @guaranteed parameter are only borrowed by the
+  // callee.
+  if (auto FAS = FullApplySite::isa(User)) {
+    auto Args = FAS.getArgumentOperands();
+    if (Op < Args.begin() || Op >= Args.end())
+      return false;
+    return FAS.getArgumentConvention(Op - Args.begin()) ==
+           SILArgumentConvention::Direct_Guaranteed;
+  }
+
+  return false;
+}
+
+/// Removes \p CVI if it copies a guaranteed function argument and the copy is
+/// only borrowed and destroyed.
+static bool eliminateGuaranteedArgumentCopy(CopyValueInst *CVI) {
+  SILValue Operand = CVI->getOperand();
+  if (!isGuaranteedFunctionArgument(Operand))
+    return false;
+
+  SmallVector<DestroyValueInst *, 4> Destroys;
+  for (auto *Op : CVI->getUses()) {
+    if (auto *DVI = dyn_cast<DestroyValueInst>(Op->getUser())) {
+      Destroys.push_back(DVI);
+      continue;
+    }
+    if (!isNonConsumingUse(Op))
+      return false;
+  }
+
+  DEBUG(llvm::dbgs() << "Removing copy of guaranteed argument: " << *CVI);
+  for (auto *DVI : Destroys)
+    DVI->eraseFromParent();
+  CVI->replaceAllUsesWith(Operand);
+  CVI->eraseFromParent();
+  ++NumEliminatedCopies;
+  return true;
+}
+
+//===----------------------------------------------------------------------===//
+//                            Top Level Entrypoint
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+struct SemanticARCOpts : SILFunctionTransform {
+  void run() override {
+    SILFunction *F = getFunction();
+
+    // Copies and destroys are only explicit before the Ownership Model
+    // Eliminator has run on the function.
+    if (!F->hasQualifiedOwnership())
+      return;
+
+    // Collect the copies first; removing one also erases its destroys, which
+    // may come later in the same block.
+    SmallVector<CopyValueInst *, 16> Copies;
+    for (auto &BB : *F)
+      for (auto &I : BB)
+        if (auto *CVI = dyn_cast<CopyValueInst>(&I))
+          Copies.push_back(CVI);
+
+    bool MadeChange = false;
+    for (auto *CVI : Copies)
+      MadeChange |= eliminateGuaranteedArgumentCopy(CVI);
+
+    if (MadeChange) {
+      invalidateAnalysis(SILAnalysis::InvalidationKind::Instructions);
+    }
+  }
+
+  StringRef getName() override { return "Semantic ARC Opts"; }
+};
+
+} // end anonymous namespace
+
+SILTransform *swift::createSemanticARCOpts() {
+  return new SemanticARCOpts();
+}
@@ -14,6 +14,8 @@
 
 #include "swift/SILOptimizer/PassManager/PassManager.h"
 #include "swift/Basic/DemangleWrappers.h"
+#include "swift/Basic/Statistic.h"
+#include "swift/Basic/Timer.h"
 #include "swift/SIL/SILFunction.h"
 #include "swift/SIL/SILModule.h"
 #include "swift/SILOptimizer/Analysis/BasicCalleeAnalysis.h"
@@ -21,13 +23,21 @@
 #include "swift/SILOptimizer/PassManager/PrettyStackTrace.h"
 #include "swift/SILOptimizer/PassManager/Transforms.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Hashing.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/GraphWriter.h"
 #include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/TimeValue.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
 
 using namespace swift;
 
@@ -45,6 +55,17 @@ llvm::cl::opt<bool> SILPrintPassTime(
     "sil-print-pass-time", llvm::cl::init(false),
     llvm::cl::desc("Print the execution time of each SIL pass"));
 
+llvm::cl::opt<bool> SILPassReport(
+    "sil-pass-report", llvm::cl::init(false),
+    llvm::cl::desc("Print how long each SIL pass took in total, how often it "
+                   "invalidated analyses and how it changed the number of "
+                   "instructions"));
+
+llvm::cl::opt<std::string> SILCapturePipelineDir(
+    "sil-capture-pipeline-dir", llvm::cl::init(""),
+    llvm::cl::desc("Before each SIL pass pipeline, write the module and the "
+                   "pipeline to this directory, for replaying with sil-opt"));
+
 llvm::cl::opt<unsigned> SILNumOptPassesToRun(
     "sil-opt-pass-count", llvm::cl::init(UINT_MAX),
     llvm::cl::desc("Stop optimizing after <N> optimization passes"));
@@ -91,6 +112,16 @@ llvm::cl::opt<bool> SILVerifyWithoutInvalidation(
     "sil-verify-without-invalidation", llvm::cl::init(false),
     llvm::cl::desc("Verify after passes even if the pass has not invalidated"));
 
+llvm::cl::opt<bool> SILVerifyChangedOnly(
+    "sil-verify-changed-only", llvm::cl::init(false),
+    llvm::cl::desc("When verifying after passes, only verify functions whose "
+                   "instructions changed since they were last verified"));
+
+llvm::cl::opt<unsigned> SILVerifySampleRate(
+    "sil-verify-sample-rate", llvm::cl::init(0),
+    llvm::cl::desc("When verifying after passes, only verify about one in "
+                   "this many functions, picked anew after each pass"));
+
 llvm::cl::opt<bool> SILDisableSkippingPasses(
     "sil-disable-skipping-passes", llvm::cl::init(false),
     llvm::cl::desc("Do not skip passes even if nothing was changed"));
@@ -270,6 +301,22 @@ static bool breakBeforeRunning(StringRef fnName, StringRef passName) {
   return fnName == SILBreakOnFun && passName == SILBreakOnPass;
 }
 
+/// Counts the instructions in \p F, for the per-pass statistics.
+static int64_t countInstructions(SILFunction *F) {
+  int64_t Count = 0;
+  for (auto &BB : *F)
+    Count += BB.size();
+  return Count;
+}
+
+/// Counts the instructions in all functions of \p M.
+static int64_t countInstructions(SILModule *M) {
+  int64_t Count = 0;
+  for (auto &F : *M)
+    Count += countInstructions(&F);
+  return Count;
+}
+
 void SILPassManager::runPassOnFunction(SILFunctionTransform *SFT,
                                        SILFunction *F) {
 
@@ -284,6 +331,12 @@ void SILPassManager::runPassOnFunction(SILFunctionTransform *SFT,
   // If nothing changed since the last run of this pass, we can skip this
   // pass.
   CompletedPasses &completedPasses = CompletedPassesMap[F];
+  uint64_t &completedStamp = CompletedPassesStamps[F];
+  if (completedStamp != F->getChangeStamp()) {
+    // The function was changed by someone who didn't tell us.
+    completedPasses.reset();
+    completedStamp = F->getChangeStamp();
+  }
   if (completedPasses.test((size_t)SFT->getPassKind()) &&
       !SILDisableSkippingPasses) {
     if (SILPrintPassName)
@@ -319,7 +372,29 @@ void SILPassManager::runPassOnFunction(SILFunctionTransform *SFT,
   Mod->registerDeleteNotificationHandler(SFT);
   if (breakBeforeRunning(F->getName(), SFT->getName()))
     LLVM_BUILTIN_DEBUGTRAP;
-  SFT->run();
+  UnifiedStatsReporter *Stats = Mod->getASTContext().Stats;
+  int64_t InstructionsBefore =
+      (Stats || SILPassReport) ? countInstructions(F) : 0;
+  unsigned InvalidationsBefore = NumInvalidations;
+  auto ReportStartTime = std::chrono::steady_clock::now();
+  {
+    TracedEvent Event("sil-pass", SFT->getName(), F->getName());
+    SFT->run();
+  }
+  if (SILPassReport) {
+    std::chrono::duration<double> Duration =
+        std::chrono::steady_clock::now() - ReportStartTime;
+    recordPassRun(SFT, Duration.count(),
+                  NumInvalidations - InvalidationsBefore,
+                  CurrentPassHasInvalidated
+                      ? countInstructions(F) - InstructionsBefore
+                      : 0);
+  }
+  if (Stats && CurrentPassHasInvalidated) {
+    Stats->addNamedCounter(
+        ("SILOptimizer." + SFT->getName() + ".InstructionDelta").str(),
+        countInstructions(F) - InstructionsBefore);
+  }
   assert(analysesUnlocked() && "Expected all analyses to be unlocked!");
   Mod->removeDeleteNotificationHandler(SFT);
 
@@ -338,19 +413,30 @@ void SILPassManager::runPassOnFunction(SILFunctionTransform *SFT,
     F->dump(getOptions().EmitVerboseSIL);
   }
 
-  // Remember if this pass didn't change anything.
+  // Remember if this pass didn't change anything. The pass may have created
+  // functions, so look up the masks again.
   if (!CurrentPassHasInvalidated)
-    completedPasses.set((size_t)SFT->getPassKind());
+    CompletedPassesMap[F].set((size_t)SFT->getPassKind());
+  CompletedPassesStamps[F] = F->getChangeStamp();
 
   if (getOptions().VerifyAll &&
-      (CurrentPassHasInvalidated || SILVerifyWithoutInvalidation)) {
-    F->verify();
+      (CurrentPassHasInvalidated || SILVerifyWithoutInvalidation) &&
+      shouldVerify(F, /*IsKnownChanged*/ CurrentPassHasInvalidated)) {
+    verifyFunction(F);
     verifyAnalyses(F);
   }
 
   ++NumPassesRun;
 }
 
+// FIXME: Functions are optimized strictly one at a time. Running independent
+// call graph SCCs concurrently would require the SILModule's allocator and
+// function table to be thread-safe (passes such as the generic specializer
+// and function signature optimization create new functions and push them
+// onto FunctionWorklist), analyses like SideEffectAnalysis and
+// EscapeAnalysis to support concurrent queries and invalidation, and the
+// pass manager's restart and derivation state to be tracked per function
+// rather than on the SILPassManager.
 void SILPassManager::
 runFunctionPasses(ArrayRef<SILFunctionTransform *> FuncTransforms) {
   if (FuncTransforms.empty())
@@ -442,7 +528,26 @@ void SILPassManager::runModulePass(SILModuleTransform *SMT) {
   llvm::sys::TimeValue StartTime = llvm::sys::TimeValue::now();
   assert(analysesUnlocked() && "Expected all analyses to be unlocked!");
   Mod->registerDeleteNotificationHandler(SMT);
-  SMT->run();
+  int64_t InstructionsBefore = SILPassReport ? countInstructions(Mod) : 0;
+  unsigned InvalidationsBefore = NumInvalidations;
+  auto ReportStartTime = std::chrono::steady_clock::now();
+  {
+    TracedEvent Event("sil-pass", SMT->getName());
+    SMT->run();
+  }
+  // A module pass may only have invalidated the functions it changed, but its
+  // changes can still affect the functions depending on them.
+  if (CurrentPassHasInvalidated)
+    resetCompletedPassesOfChangedFunctions();
+  if (SILPassReport) {
+    std::chrono::duration<double> Duration =
+        std::chrono::steady_clock::now() - ReportStartTime;
+    recordPassRun(SMT, Duration.count(),
+                  NumInvalidations - InvalidationsBefore,
+                  CurrentPassHasInvalidated
+                      ? countInstructions(Mod) - InstructionsBefore
+                      : 0);
+  }
   Mod->removeDeleteNotificationHandler(SMT);
   assert(analysesUnlocked() && "Expected all analyses to be unlocked!");
 
@@ -463,11 +568,45 @@ void SILPassManager::runModulePass(SILModuleTransform *SMT) {
 
   if (Options.VerifyAll &&
       (CurrentPassHasInvalidated || !SILVerifyWithoutInvalidation)) {
-    Mod->verify();
+    verifyModule();
     verifyAnalyses();
   }
 }
 
+bool SILPassManager::shouldVerify(SILFunction *F, bool IsKnownChanged) const {
+  // The change stamp doesn't move when a pass only rewrites operands or block
+  // arguments, so it can't overrule a pass which said it changed F.
+  if (SILVerifyChangedOnly && !IsKnownChanged) {
+    auto It = VerifiedChangeStamps.find(F);
+    if (It != VerifiedChangeStamps.end() && It->second == F->getChangeStamp())
+      return false;
+  }
+  if (SILVerifySampleRate > 1) {
+    size_t Hash = llvm::hash_combine(F->getName(), NumPassesRun);
+    return Hash % SILVerifySampleRate == 0;
+  }
+  return true;
+}
+
+void SILPassManager::verifyFunction(SILFunction *F) {
+  F->verify();
+  VerifiedChangeStamps[F] = F->getChangeStamp();
+}
+
+void SILPassManager::verifyModule() {
+  if (!SILVerifyChangedOnly && SILVerifySampleRate <= 1) {
+    Mod->verify();
+    return;
+  }
+
+  // Partial verification only checks function bodies; the module-level checks
+  // of globals, vtables and witness tables are left to the full verifier.
+  for (auto &F : *Mod) {
+    if (shouldVerify(&F))
+      verifyFunction(&F);
+  }
+}
+
 void SILPassManager::runOneIteration() {
   const SILOptions &Options = getOptions();
 
@@ -539,8 +678,86 @@ void SILPassManager::run() {
   runOneIteration();
 }
 
+void SILPassManager::captureStage(const SILPassPipelinePlan &Plan,
+                                  const SILPassPipeline &Pipeline) {
+  if (SILCapturePipelineDir.empty())
+    return;
+
+  // Number the stages across all pass managers, so that the files sort in
+  // the order the stages ran.
+  static unsigned NumCapturedStages = 0;
+  std::string FileName;
+  llvm::raw_string_ostream(FileName)
+      << llvm::format("%03u-", NumCapturedStages++);
+  for (char C : Pipeline.Name)
+    FileName += isalnum(C) ? C : '_';
+
+  llvm::sys::fs::create_directories(SILCapturePipelineDir);
+  SmallString<128> Path(SILCapturePipelineDir);
+  llvm::sys::path::append(Path, FileName);
+
+  std::error_code EC;
+  llvm::raw_fd_ostream SILOut((Path + ".sil").str(), EC,
+                              llvm::sys::fs::F_None);
+  if (EC) {
+    llvm::errs() << "error: cannot capture SIL to " << Path << ".sil: "
+                 << EC.message() << '\n';
+    return;
+  }
+  Mod->print(SILOut, getOptions().EmitVerboseSIL, Mod->getSwiftModule());
+
+  SILPassPipelinePlan StagePlan;
+  StagePlan.startPipeline(Pipeline.ExecutionKind, Pipeline.Name);
+  SmallVector<PassKind, 32> Kinds(Plan.getPipelinePasses(Pipeline).begin(),
+                                  Plan.getPipelinePasses(Pipeline).end());
+  StagePlan.addPasses(Kinds);
+  llvm::raw_fd_ostream PipelineOut((Path + ".yaml").str(), EC,
+                                   llvm::sys::fs::F_Text);
+  if (EC) {
+    llvm::errs() << "error: cannot capture pass pipeline to " << Path
+                 << ".yaml: " << EC.message() << '\n';
+    return;
+  }
+  StagePlan.print(PipelineOut);
+  PipelineOut << '\n';
+}
+
+void SILPassManager::recordPassRun(SILTransform *T, double Seconds,
+                                   unsigned NumInvalidations,
+                                   int64_t InstructionDelta) {
+  PassReportEntry &Entry = PassReport[T->getName()];
+  ++Entry.NumRuns;
+  Entry.Seconds += Seconds;
+  Entry.NumInvalidations += NumInvalidations;
+  Entry.InstructionDelta += InstructionDelta;
+}
+
+void SILPassManager::printPassReport(llvm::raw_ostream &OS) const {
+  // The most expensive passes come first.
+  std::vector<const std::pair<StringRef, PassReportEntry> *> Entries;
+  for (auto &Entry : PassReport)
+    Entries.push_back(&Entry);
+  std::stable_sort(Entries.begin(), Entries.end(),
+                   [](const std::pair<StringRef, PassReportEntry> *LHS,
+                      const std::pair<StringRef, PassReportEntry> *RHS) {
+    return LHS->second.Seconds > RHS->second.Seconds;
+  });
+
+  OS << "*** SIL pass report ***\n"
+     << "    runs     seconds  invalidations  instructions  pass\n";
+  for (auto *Entry : Entries) {
+    const PassReportEntry &E = Entry->second;
+    OS << llvm::format("%8u  %10.6f  %13u  %+12lld  ", E.NumRuns, E.Seconds,
+                       E.NumInvalidations, (long long)E.InstructionDelta)
+       << Entry->first << '\n';
+  }
+}
+
 /// D'tor.
 SILPassManager::~SILPassManager() {
+  if (SILPassReport && !PassReport.empty())
+    printPassReport(llvm::dbgs());
+
   // Free all transformations.
   for (auto *T : Transformations)
     delete T;
@@ -579,7 +796,7 @@ void SILPassManager::addFunctionToWorklist(SILFunction *F,
     // this function to the pass manager to ensure that we perform this
     // verification.
     if (getOptions().VerifyAll) {
-      F->verify();
+      verifyFunction(F);
     }
 
     NewLevel = DerivationLevels[DerivedFrom] + 1;
@@ -616,6 +833,113 @@ void SILPassManager::resetAndRemoveTransformations() {
   NumOptimizationIterations = 0;
 }
 
+/// Returns the declaration identifying the vtable and witness table entries
+/// which a method instruction for \p Method may dispatch to.
+static ValueDecl *getDispatchedDecl(SILDeclRef Method) {
+  ValueDecl *D = Method.getDecl();
+  while (ValueDecl *Overridden = D->getOverriddenDecl())
+    D = Overridden;
+  return D;
+}
+
+void SILPassManager::updateDependencies(SILFunction *F) {
+  removeDependencies(F);
+
+  FunctionDependencies &Deps = Dependencies[F];
+  for (auto &BB : *F) {
+    for (auto &I : BB) {
+      if (auto *FRI = dyn_cast<FunctionRefInst>(&I)) {
+        SILFunction *Callee = FRI->getReferencedFunction();
+        if (Referrers[Callee].insert(F).second)
+          Deps.Functions.push_back(Callee);
+      } else if (auto *MI = dyn_cast<MethodInst>(&I)) {
+        ValueDecl *Method = getDispatchedDecl(MI->getMember());
+        if (DispatchUsers[Method].insert(F).second)
+          Deps.Methods.push_back(Method);
+      }
+    }
+  }
+}
+
+void SILPassManager::removeDependencies(SILFunction *F) {
+  auto It = Dependencies.find(F);
+  if (It == Dependencies.end())
+    return;
+  for (SILFunction *Callee : It->second.Functions)
+    Referrers[Callee].erase(F);
+  for (ValueDecl *Method : It->second.Methods)
+    DispatchUsers[Method].erase(F);
+  Dependencies.erase(It);
+}
+
+void SILPassManager::addImplementedMethod(SILFunction *Impl,
+                                          SILDeclRef Method) {
+  auto &Methods = ImplementedMethods[Impl];
+  ValueDecl *D = getDispatchedDecl(Method);
+  if (std::find(Methods.begin(), Methods.end(), D) == Methods.end())
+    Methods.push_back(D);
+}
+
+void SILPassManager::resetCompletedPassesOfChangedFunctions() {
+  if (!HasDependencies) {
+    // We can't tell what changed before we knew the dependencies, so let all
+    // passes run again. Record the dependencies of the whole module once, and
+    // from now on only follow the changes the module records.
+    for (SILFunction &F : *Mod)
+      updateDependencies(&F);
+    for (SILVTable &VT : Mod->getVTableList())
+      for (auto &Entry : VT.getEntries())
+        addImplementedMethod(Entry.second, Entry.first);
+    for (SILWitnessTable &WT : Mod->getWitnessTableList())
+      for (auto &Entry : WT.getEntries())
+        if (Entry.getKind() == SILWitnessTable::Method &&
+            Entry.getMethodWitness().Witness)
+          addImplementedMethod(Entry.getMethodWitness().Witness,
+                               Entry.getMethodWitness().Requirement);
+    Mod->clearChanges();
+    HasDependencies = true;
+    CompletedPassesMap.clear();
+    return;
+  }
+
+  llvm::SmallVector<SILFunction *, 16> Worklist;
+  auto addDispatchUsers = [&](ValueDecl *Method) {
+    auto It = DispatchUsers.find(Method);
+    if (It != DispatchUsers.end())
+      Worklist.append(It->second.begin(), It->second.end());
+  };
+
+  // A removed entry can change where a call dispatches to as much as an added
+  // one, as can the body of an entry's function.
+  for (auto &Entry : Mod->getChangedDispatchEntries()) {
+    addImplementedMethod(Entry.second, Entry.first);
+    addDispatchUsers(getDispatchedDecl(Entry.first));
+  }
+  for (SILFunction *F : Mod->getChangedFunctions()) {
+    updateDependencies(F);
+    Worklist.push_back(F);
+  }
+  Mod->clearChanges();
+
+  // A function's passes may depend on what its callees look like, e.g. for
+  // inlining, devirtualization or side effects, so a change has to let passes
+  // run again on all transitive callers as well.
+  llvm::SmallPtrSet<SILFunction *, 16> Reset;
+  while (!Worklist.empty()) {
+    SILFunction *F = Worklist.pop_back_val();
+    if (!Reset.insert(F).second)
+      continue;
+    CompletedPassesMap.erase(F);
+    auto It = Referrers.find(F);
+    if (It != Referrers.end())
+      Worklist.append(It->second.begin(), It->second.end());
+    auto MethodsIt = ImplementedMethods.find(F);
+    if (MethodsIt != ImplementedMethods.end())
+      for (ValueDecl *Method : MethodsIt->second)
+        addDispatchUsers(Method);
+  }
+}
+
 void SILPassManager::setStageName(llvm::StringRef NextStage) {
   StageName = NextStage;
 }
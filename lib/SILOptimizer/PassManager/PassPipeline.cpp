@@ -29,10 +29,12 @@
 #include "swift/SILOptimizer/PassManager/Transforms.h"
 #include "swift/SILOptimizer/Utils/Local.h"
 #include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorOr.h"
+#include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/YAMLParser.h"
 #include "llvm/Support/YAMLTraits.h"
@@ -75,6 +77,9 @@ static void addMandatoryDebugSerialization(SILPassPipelinePlan &P) {
 
 static void addOwnershipModelEliminatorPipeline(SILPassPipelinePlan &P) {
   P.startPipeline(ExecutionKind::OneIteration, "Ownership Model Eliminator");
+  // Remove the copies that ownership SIL makes trivially redundant while it
+  // is still available.
+  P.addSemanticARCOpts();
   P.addOwnershipModelEliminator();
 }
 
@@ -197,6 +202,8 @@ void addHighLevelLoopOptPasses(SILPassPipelinePlan &P) {
   // Cleanup.
   P.addDCE();
   P.addSwiftArrayOpts();
+  // Expose element loads in the loops specialized by SwiftArrayOpts.
+  P.addArrayElementAccessOpt();
 }
 
 // Perform classic SSA optimizations.
@@ -235,6 +242,9 @@ void addSSAPasses(SILPassPipelinePlan &P, OptimizationLevelKind OpLevel) {
     // global-init functions.
     P.addGlobalOpt();
     P.addLetPropertiesOpt();
+    // Outline cold paths, so that the hot part of functions with a large slow
+    // path becomes small enough to be inlined into its callers.
+    P.addColdPathOutliner();
     P.addPerfInliner();
     break;
   case OptimizationLevelKind::LowLevel:
@@ -400,10 +410,29 @@ static void addLateLoopOptPassPipeline(SILPassPipelinePlan &P) {
   // after FSO.
   P.addLateReleaseHoisting();
 
+  // Use non-atomic reference counting for objects which are proven to be
+  // thread-local. This should be after all passes which move or create
+  // reference counting instructions.
+  P.addNonAtomicRC();
+
   // Has only an effect if the -assume-single-thread option is specified.
   P.addAssumeSingleThreaded();
 }
 
+static void addSizeOptPassPipeline(SILPassPipelinePlan &P) {
+  P.startPipeline(ExecutionKind::OneIteration, "SizeOpt");
+
+  // The late inliner exposes new cold paths, like the trap paths of inlined
+  // precondition checks. Outline them once more, sharing identical ones.
+  P.addColdPathOutliner();
+}
+
+static void addCrossModuleSerializationPipeline(SILPassPipelinePlan &P) {
+  P.startPipeline(ExecutionKind::OneIteration, "Cross Module Serialization");
+  P.addCrossModuleSerializationSetup();
+  P.addEffectsSummaryInference();
+}
+
 static void addSILDebugInfoGeneratorPipeline(SILPassPipelinePlan &P) {
   P.startPipeline(ExecutionKind::OneIteration, "SIL Debug Info Generator");
   P.addSILDebugInfoGenerator();
@@ -439,6 +468,15 @@ SILPassPipelinePlan::getPerformancePassPipeline(SILOptions Options) {
 
   addLateLoopOptPassPipeline(P);
 
+  // Only run with -Osize.
+  if (Options.OptimizeForSize)
+    addSizeOptPassPipeline(P);
+
+  // Make generic code available to clients of the module, now that it is
+  // fully optimized.
+  if (Options.CrossModuleOptimization)
+    addCrossModuleSerializationPipeline(P);
+
   // Has only an effect if the -gsil option is specified.
   addSILDebugInfoGeneratorPipeline(P);
 
@@ -478,6 +516,41 @@ SILPassPipelinePlan SILPassPipelinePlan::getOnonePassPipeline() {
   return P;
 }
 
+//===----------------------------------------------------------------------===//
+//                            Odebug Pass Pipeline
+//===----------------------------------------------------------------------===//
+
+SILPassPipelinePlan SILPassPipelinePlan::getOdebugPassPipeline() {
+  SILPassPipelinePlan P;
+
+  // Like at Onone, first use the pre-specializations of the stdlib.
+  P.startPipeline(ExecutionKind::UntilFixPoint, "Prespecialization");
+  P.addUsePrespecialized();
+
+  // Then specialize the remaining calls of generic functions, which removes
+  // most of the overhead of unoptimized generic code. This only clones and
+  // rewrites callees; the code of the caller stays as is.
+  P.startPipeline(ExecutionKind::UntilFixPoint, "Odebug Specialization");
+  P.addSILLinker();
+  P.addGenericSpecializer();
+
+  P.startPipeline(ExecutionKind::OneIteration, "Rest of Odebug");
+  // The remaining external definitions were only needed for specialization.
+  P.addExternalDefsToDecls();
+
+  // Clean up the code specialized from the stdlib. At Odebug, SILCombine
+  // leaves the user's own functions alone.
+  P.addSILCombine();
+
+  // Has only an effect if the -assume-single-thread option is specified.
+  P.addAssumeSingleThreaded();
+
+  // Has only an effect if the -gsil option is specified.
+  P.addSILDebugInfoGenerator();
+
+  return P;
+}
+
 //===----------------------------------------------------------------------===//
 //                          Inst Count Pass Pipeline
 //===----------------------------------------------------------------------===//
@@ -554,6 +627,10 @@ void SILPassPipelinePlan::print(llvm::raw_ostream &os) {
   os << ']';
 }
 
+/// The names of the pipelines read from files. SILPassPipeline doesn't own its
+/// name, and the file's buffer doesn't outlive getPassPipelineFromFile.
+static llvm::ManagedStatic<llvm::StringSet<>> PipelineNamesFromFiles;
+
 SILPassPipelinePlan
 SILPassPipelinePlan::getPassPipelineFromFile(StringRef Filename) {
   namespace yaml = llvm::yaml;
@@ -586,6 +663,8 @@ SILPassPipelinePlan::getPassPipelineFromFile(StringRef Filename) {
     auto *Desc = cast<yaml::SequenceNode>(&PipelineNode);
     yaml::SequenceNode::iterator DescIter = Desc->begin();
     StringRef Name = cast<yaml::ScalarNode>(&*DescIter)->getRawValue();
+    Name = Name.drop_front().drop_back();
+    Name = PipelineNamesFromFiles->insert(Name).first->getKey();
     DEBUG(llvm::dbgs() << "    Name: \"" << Name << "\"\n");
     ++DescIter;
 
@@ -113,7 +113,10 @@ void swift::runSILPassesForOnone(SILModule &Module) {
     Module.verify();
 
   SILPassManager PM(&Module, "Onone");
-  PM.executePassPipelinePlan(SILPassPipelinePlan::getOnonePassPipeline());
+  if (Module.getOptions().Optimization == SILOptions::SILOptMode::Debug)
+    PM.executePassPipelinePlan(SILPassPipelinePlan::getOdebugPassPipeline());
+  else
+    PM.executePassPipelinePlan(SILPassPipelinePlan::getOnonePassPipeline());
 
   // Verify the module, if required.
   if (Module.getOptions().VerifyAll)
@@ -21,6 +21,7 @@
 #define DEBUG_TYPE "sil-combine"
 #include "swift/SILOptimizer/PassManager/Passes.h"
 #include "SILCombiner.h"
+#include "swift/AST/Module.h"
 #include "swift/SIL/SILBuilder.h"
 #include "swift/SIL/SILVisitor.h"
 #include "swift/SIL/DebugUtils.h"
@@ -315,6 +316,13 @@ SILInstruction *SILCombiner::eraseInstFromFunction(SILInstruction &I,
 //                                Entry Points
 //===----------------------------------------------------------------------===//
 
+/// Returns true if \p F was cloned from a function of another module, e.g. a
+/// specialization of a stdlib function.
+static bool isFromOtherModule(SILFunction *F) {
+  DeclContext *DC = F->getDeclContext();
+  return DC && DC->getParentModule() != F->getModule().getSwiftModule();
+}
+
 namespace {
 
 class SILCombine : public SILFunctionTransform {
@@ -323,6 +331,12 @@ class SILCombine : public SILFunctionTransform {
   
   /// The entry point to the transformation.
   void run() override {
+    // At Odebug, keep the user's code as written, so that all its variables
+    // stay inspectable. Only clean up code specialized from other modules.
+    if (getOptions().Optimization == SILOptions::SILOptMode::Debug &&
+        !isFromOtherModule(getFunction()))
+      return;
+
     auto *AA = PM->getAnalysis<AliasAnalysis>();
 
     // Create a SILBuilder with a tracking list for newly added
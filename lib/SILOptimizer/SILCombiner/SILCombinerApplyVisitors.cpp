@@ -995,9 +995,16 @@ hasOnlyRetainReleaseUsers(ApplyInst *AI, SILInstruction *IgnoreUser,
 /// \brief We only know how to simulate reference call effects for unary
 /// function calls that take their argument @owned or @guaranteed and return an
 /// @owned value.
+///
+/// The _unconditionallyBridgeFromObjectiveC conversion additionally takes the
+/// metatype of the bridged type, which doesn't need any reference counting.
 static bool knowHowToEmitReferenceCountInsts(ApplyInst *Call) {
-  if (Call->getNumArguments() != 1)
+  if (Call->getNumArguments() == 2) {
+    if (!Call->getArgument(1)->getType().is<AnyMetatypeType>())
+      return false;
+  } else if (Call->getNumArguments() != 1) {
     return false;
+  }
 
   FunctionRefInst *FRI = cast<FunctionRefInst>(Call->getCallee());
   SILFunction *F = FRI->getReferencedFunction();
@@ -1013,7 +1020,8 @@ static bool knowHowToEmitReferenceCountInsts(ApplyInst *Call) {
   // Look at the parameter.
   auto Params = FnTy->getParameters();
   (void) Params;
-  assert(Params.size() == 1 && "Expect one parameter");
+  assert(Params.size() == Call->getNumArguments() &&
+         "Expect a parameter per argument");
   auto ParamConv = FnTy->getParameters()[0].getConvention();
 
   return ParamConv == ParameterConvention::Direct_Owned ||
@@ -1031,7 +1039,7 @@ static void emitMatchingRCAdjustmentsForCall(ApplyInst *Call, SILValue OnX) {
 
   assert(ResultInfo.getConvention() == ResultConvention::Owned &&
          "Expect a @owned return");
-  assert(Call->getNumArguments() == 1 && "Expect a unary call");
+  assert(knowHowToEmitReferenceCountInsts(Call) && "Expect a unary call");
 
   // Emit a retain for the @owned return.
   SILBuilderWithScope Builder(Call);
@@ -1039,9 +1047,6 @@ static void emitMatchingRCAdjustmentsForCall(ApplyInst *Call, SILValue OnX) {
 
   // Emit a release for the @owned parameter, or none for a @guaranteed
   // parameter.
-  auto Params = FnTy->getParameters();
-  (void) Params;
-  assert(Params.size() == 1 && "Expect one parameter");
   auto ParamInfo = FnTy->getParameters()[0].getConvention();
   assert(ParamInfo == ParameterConvention::Direct_Owned ||
          ParamInfo == ParameterConvention::Direct_Guaranteed);
@@ -1062,8 +1067,20 @@ bool SILCombiner::optimizeIdentityCastComposition(ApplyInst *FInverse,
   if (!knowHowToEmitReferenceCountInsts(FInverse))
     return false;
 
+  // Conversions from Objective-C take an optional object, so f's result may
+  // be wrapped in an Optional.some.
+  SILValue FResult = FInverse->getArgument(0);
+  auto *SomeInst = dyn_cast<EnumInst>(FResult);
+  if (SomeInst) {
+    if (!SomeInst->hasOperand() || !SomeInst->hasOneUse() ||
+        SomeInst->getElement() !=
+            FInverse->getModule().getASTContext().getOptionalSomeDecl())
+      return false;
+    FResult = SomeInst->getOperand();
+  }
+
   // Need to have a matching 'f'.
-  auto *F = dyn_cast<ApplyInst>(FInverse->getArgument(0));
+  auto *F = dyn_cast<ApplyInst>(FResult);
   if (!F)
     return false;
   if (!F->hasSemantics(FName))
@@ -1071,13 +1088,18 @@ bool SILCombiner::optimizeIdentityCastComposition(ApplyInst *FInverse,
   if (!knowHowToEmitReferenceCountInsts(F))
     return false;
 
-  // The types must match.
+  // The types must match. This excludes a Swift to Objective-C conversion of
+  // the result of an _unconditionallyBridgeFromObjectiveC, whose argument is
+  // optional. That's intentional: bridging from Objective-C copies mutable
+  // objects, so the round trip doesn't return the original object.
   if (F->getArgument(0)->getType() != FInverse->getType())
     return false;
 
   // Retains, releases of the result of F.
   SmallVector<SILInstruction *, 16> RetainReleases;
-  if (!hasOnlyRetainReleaseUsers(F, FInverse, RetainReleases))
+  if (!hasOnlyRetainReleaseUsers(
+          F, SomeInst ? cast<SILInstruction>(SomeInst) : FInverse,
+          RetainReleases))
     return false;
 
   // Okay, now we know we can remove the calls.
@@ -1112,6 +1134,8 @@ bool SILCombiner::optimizeIdentityCastComposition(ApplyInst *FInverse,
 
   // Remove the calls.
   eraseInstFromFunction(*FInverse);
+  if (SomeInst)
+    eraseInstFromFunction(*SomeInst);
   eraseInstFromFunction(*F);
 
   return true;
@@ -73,7 +73,9 @@
 #include "swift/SIL/SILBuilder.h"
 #include "swift/SILOptimizer/Analysis/AliasAnalysis.h"
 #include "swift/SILOptimizer/Analysis/ARCAnalysis.h"
+#include "swift/SILOptimizer/Analysis/DominanceAnalysis.h"
 #include "swift/SILOptimizer/Analysis/EscapeAnalysis.h"
+#include "swift/SILOptimizer/Analysis/LoopAnalysis.h"
 #include "swift/SILOptimizer/Analysis/PostOrderAnalysis.h"
 #include "swift/SILOptimizer/Analysis/RCIdentityAnalysis.h"
 #include "swift/SILOptimizer/PassManager/Passes.h"
@@ -1044,7 +1046,14 @@ public:
     //
     // TODO: maybe we can do this lazily or maybe we should disallow SIL passes
     // to create critical edges.
-    bool EdgeChanged = splitAllCriticalEdges(*F, false, nullptr, nullptr);
+    //
+    // Keep dominance and loop info up to date while splitting if they have
+    // already been computed, so that later passes don't have to rebuild them.
+    auto *DA = PM->getAnalysis<DominanceAnalysis>();
+    auto *LA = PM->getAnalysis<SILLoopAnalysis>();
+    DominanceInfo *DT = DA->getIfComputed(F);
+    SILLoopInfo *LI = LA->getIfComputed(F);
+    bool EdgeChanged = splitAllCriticalEdges(*F, false, DT, LI);
 
     llvm::SpecificBumpPtrAllocator<BlockState> BPA;
     auto *PO = PM->getAnalysis<PostOrderAnalysis>()->get(F);
@@ -1069,8 +1078,17 @@ public:
     }
 
     if (EdgeChanged) {
-      // We splitted critical edges.
+      // We splitted critical edges, but updated the dominator tree and loop
+      // info if we had them.
+      if (DT)
+        DA->lockInvalidation();
+      if (LI)
+        LA->lockInvalidation();
       invalidateAnalysis(SILAnalysis::InvalidationKind::FunctionBody);
+      if (DT)
+        DA->unlockInvalidation();
+      if (LI)
+        LA->unlockInvalidation();
       return;
     }
     if (InstChanged) {
@@ -0,0 +1,535 @@
+//===--- ColdPathOutliner.cpp - Outline cold code into separate functions -===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Move large, rarely executed regions of a function into a separate,
+// never-inlined function. This is a form of partial inlining: the performance
+// inliner's cost model is all-or-nothing, so a function with a small fast path
+// and a big slow path (e.g. a growth or error path) would otherwise never be
+// inlined. After the slow path is outlined, only the fast path remains and the
+// inliner can inline it into its callers.
+//
+// A region is the dominator subtree of a block which is the cold successor of
+// its only predecessor. A successor is considered cold if ColdBlockInfo
+// classifies the edge as a slow path (e.g. because of _slowPath or
+// _fastPath hints), if the profile says the block is never executed, or if
+// all paths through the region end in an unreachable, like error reporting
+// and trap paths do.
+//
+// The region must leave the function either by branching to the return block
+// or by ending in an unreachable, so that the outlined function can return
+// the value the region passes to the return block.
+//
+// When optimizing for size (-Osize), the pass also outlines smaller regions,
+// as long as the call is cheaper than the code it replaces, and regions whose
+// outlined body is identical to a function it outlined before reuse that
+// function. Trap and error-reporting paths, like the ones emitted for
+// force-unwrapping an optional, tend to be repeated in many functions of a
+// module, and then share a single copy.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "cold-path-outliner"
+#include "swift/SILOptimizer/PassManager/Passes.h"
+#include "swift/SIL/Dominance.h"
+#include "swift/SIL/SILArgument.h"
+#include "swift/SIL/SILCloner.h"
+#include "swift/SIL/SILModule.h"
+#include "swift/SILOptimizer/Analysis/ColdBlockInfo.h"
+#include "swift/SILOptimizer/Analysis/DominanceAnalysis.h"
+#include "swift/SILOptimizer/PassManager/Transforms.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+
+using namespace swift;
+
+STATISTIC(NumRegionsOutlined, "Number of cold regions outlined");
+STATISTIC(NumOutlinedFunctionsShared,
+          "Number of cold regions which reuse an existing outlined function");
+
+llvm::cl::opt<unsigned> ColdPathOutlineMinSize(
+    "cold-path-outline-min-size", llvm::cl::init(24),
+    llvm::cl::desc("The minimum number of instructions in a cold region "
+                   "for it to be outlined"));
+
+llvm::cl::opt<unsigned> ColdPathOutlineMinSizeForSize(
+    "cold-path-outline-min-size-for-size", llvm::cl::init(8),
+    llvm::cl::desc("The minimum number of instructions in a cold region "
+                   "for it to be outlined when optimizing for size"));
+
+namespace {
+
+/// A cold region of a function and the information needed to outline it.
+struct ColdRegion {
+  /// The blocks of the region, each after its immediate dominator. The first
+  /// block is the region entry.
+  llvm::SmallVector<SILBasicBlock *, 8> Blocks;
+
+  /// Values used in the region but defined outside of it.
+  llvm::SmallSetVector<SILValue, 8> LiveIns;
+
+  /// The location of a branch from the region to the return block, if the
+  /// region returns at all.
+  Optional<SILLocation> ExitLoc;
+
+  /// The number of instructions in the region, not counting debug_values.
+  unsigned NumInsts = 0;
+
+  SILBasicBlock *getEntry() const { return Blocks.front(); }
+};
+
+/// Clones a cold region into the body of a new function, turning branches to
+/// the return block of the original function into returns.
+class ColdRegionCloner : public SILClonerWithScopes<ColdRegionCloner> {
+  friend class SILVisitor<ColdRegionCloner>;
+  friend class SILCloner<ColdRegionCloner>;
+
+  SILBasicBlock *ReturnBB;
+
+public:
+  ColdRegionCloner(SILFunction &OutlinedF, SILBasicBlock *ReturnBB)
+      : SILClonerWithScopes<ColdRegionCloner>(OutlinedF), ReturnBB(ReturnBB) {}
+
+  void cloneRegion(const ColdRegion &Region);
+
+protected:
+  void visitBranchInst(BranchInst *BI);
+};
+
+class ColdPathOutliner : public SILFunctionTransform {
+  SILFunction *F = nullptr;
+  SILBasicBlock *ReturnBB = nullptr;
+  bool OptimizeForSize = false;
+
+  /// The names of the functions outlined so far, by the number of
+  /// instructions in their body. Only used when optimizing for size, to find
+  /// an existing function identical to a newly outlined one.
+  llvm::DenseMap<unsigned, llvm::SmallVector<std::string, 2>>
+      OutlinedFunctions;
+
+  bool isColdEdge(ColdBlockInfo &CBI, SILBasicBlock *Pred, SILBasicBlock *BB,
+                  const ColdRegion &Region);
+  bool isWorthOutlining(const ColdRegion &Region);
+  bool collectRegion(DominanceInfo *DT, SILBasicBlock *BB, ColdRegion &Region);
+  SILFunction *createOutlinedFunction(const ColdRegion &Region);
+  SILFunction *findIdenticalOutlinedFunction(SILFunction *OutlinedF,
+                                             unsigned NumInsts);
+  void outlineRegion(const ColdRegion &Region);
+
+  void run() override;
+
+  StringRef getName() override { return "Cold Path Outliner"; }
+};
+
+} // end anonymous namespace
+
+void ColdRegionCloner::cloneRegion(const ColdRegion &Region) {
+  SILFunction &OutlinedF = getBuilder().getFunction();
+
+  // Create all blocks up front, so that terminators can refer to them. The
+  // entry block receives the live-in values as additional arguments.
+  for (SILBasicBlock *BB : Region.Blocks) {
+    SILBasicBlock *ClonedBB = OutlinedF.createBasicBlock();
+    BBMap.insert(std::make_pair(BB, ClonedBB));
+    for (SILArgument *Arg : BB->getArguments()) {
+      SILValue MappedArg = ClonedBB->createArgument(Arg->getType(),
+                                                    Arg->getDecl());
+      ValueMap.insert(std::make_pair(Arg, MappedArg));
+    }
+  }
+  SILBasicBlock *ClonedEntry = BBMap[Region.getEntry()];
+  for (SILValue LiveIn : Region.LiveIns) {
+    SILValue MappedArg = ClonedEntry->createArgument(LiveIn->getType());
+    ValueMap.insert(std::make_pair(LiveIn, MappedArg));
+  }
+
+  // Each block comes after its dominators, so all definitions are cloned
+  // before their uses.
+  for (SILBasicBlock *BB : Region.Blocks) {
+    getBuilder().setInsertionPoint(BBMap[BB]);
+    for (auto I = BB->begin(), E = --BB->end(); I != E; ++I)
+      visit(&*I);
+  }
+  for (SILBasicBlock *BB : Region.Blocks) {
+    getBuilder().setInsertionPoint(BBMap[BB]);
+    visit(BB->getTerminator());
+  }
+}
+
+void ColdRegionCloner::visitBranchInst(BranchInst *BI) {
+  if (BI->getDestBB() != ReturnBB) {
+    SILClonerWithScopes<ColdRegionCloner>::visitBranchInst(BI);
+    return;
+  }
+
+  getBuilder().setCurrentDebugScope(getOpScope(BI->getDebugScope()));
+  SILValue Result;
+  if (BI->getNumArgs() == 1) {
+    Result = remapValue(BI->getArg(0));
+  } else {
+    Result = getBuilder().createTuple(
+        RegularLocation(BI->getLoc().getSourceLoc()),
+        getBuilder().getModule().Types.getEmptyTupleType(), {});
+  }
+  getBuilder().createReturn(getOpLocation(BI->getLoc()), Result);
+}
+
+/// Returns true if \p V is defined in one of the blocks in \p Blocks.
+static bool isDefinedIn(SILValue V,
+                        const llvm::SmallPtrSetImpl<SILBasicBlock *> &Blocks) {
+  if (auto *Arg = dyn_cast<SILArgument>(V))
+    return Blocks.count(Arg->getParent());
+  if (auto *I = dyn_cast<SILInstruction>(V))
+    return Blocks.count(I->getParent());
+  return true;
+}
+
+/// Returns true if all paths through \p Region end in an unreachable.
+static bool endsInUnreachable(const ColdRegion &Region) {
+  if (Region.ExitLoc)
+    return false;
+  for (SILBasicBlock *BB : Region.Blocks)
+    if (isa<UnreachableInst>(BB->getTerminator()))
+      return true;
+  return false;
+}
+
+bool ColdPathOutliner::isColdEdge(ColdBlockInfo &CBI, SILBasicBlock *Pred,
+                                  SILBasicBlock *BB,
+                                  const ColdRegion &Region) {
+  return CBI.isSlowPath(Pred, BB) || BB->isProfiledCold() ||
+         endsInUnreachable(Region);
+}
+
+/// Returns the number of instructions which replace \p Region in the original
+/// function once it is outlined: the function_ref, the apply, the terminator
+/// and roughly one instruction per argument passed to the outlined function.
+static unsigned getCallCost(const ColdRegion &Region) {
+  return 3 + Region.getEntry()->getNumArguments() + Region.LiveIns.size();
+}
+
+bool ColdPathOutliner::isWorthOutlining(const ColdRegion &Region) {
+  if (!OptimizeForSize)
+    return Region.NumInsts >= ColdPathOutlineMinSize;
+
+  // The outlined function itself adds a prologue and an epilogue, which the
+  // call only pays off for if the region is shared with other regions.
+  return Region.NumInsts >= ColdPathOutlineMinSizeForSize &&
+         Region.NumInsts > getCallCost(Region);
+}
+
+/// Collect the dominator subtree of \p BB into \p Region and check that it can
+/// be outlined.
+bool ColdPathOutliner::collectRegion(DominanceInfo *DT, SILBasicBlock *BB,
+                                     ColdRegion &Region) {
+  llvm::SmallVector<DominanceInfoNode *, 8> Worklist;
+  Worklist.push_back(DT->getNode(BB));
+  while (!Worklist.empty()) {
+    DominanceInfoNode *Node = Worklist.pop_back_val();
+    Region.Blocks.push_back(Node->getBlock());
+    for (DominanceInfoNode *Child : *Node)
+      Worklist.push_back(Child);
+  }
+  llvm::SmallPtrSet<SILBasicBlock *, 16> InRegion(Region.Blocks.begin(),
+                                                    Region.Blocks.end());
+
+  if (ReturnBB && ReturnBB->getNumArguments() == 1 &&
+      ReturnBB->getArgument(0)->getType().isAddress())
+    return false;
+
+  for (SILBasicBlock *RegionBB : Region.Blocks) {
+    for (SILArgument *Arg : RegionBB->getArguments())
+      if (Arg->getType().isAddress())
+        return false;
+
+    TermInst *Term = RegionBB->getTerminator();
+    if (isa<ReturnInst>(Term) || isa<ThrowInst>(Term))
+      return false;
+
+    // The region may only be left through the return block.
+    for (SILBasicBlock *Succ : RegionBB->getSuccessorBlocks()) {
+      if (InRegion.count(Succ))
+        continue;
+      auto *BI = dyn_cast<BranchInst>(Term);
+      if (!BI || Succ != ReturnBB || BI->getNumArgs() > 1)
+        return false;
+      if (!Region.ExitLoc)
+        Region.ExitLoc = BI->getLoc();
+    }
+
+    for (SILInstruction &I : *RegionBB) {
+      if (!isa<DebugValueInst>(&I))
+        ++Region.NumInsts;
+      for (Operand &Op : I.getAllOperands()) {
+        SILValue V = Op.get();
+        if (isDefinedIn(V, InRegion))
+          continue;
+        // Addresses and opened existentials are bound to the stack frame or
+        // the generic context of the original function.
+        if (V->getType().isAddress() ||
+            V->getType().getSwiftRValueType()->hasOpenedExistential())
+          return false;
+        Region.LiveIns.insert(V);
+      }
+    }
+  }
+  return isWorthOutlining(Region);
+}
+
+static std::string getUniqueName(std::string Name, SILModule &M) {
+  if (!M.lookUpFunction(Name))
+    return Name;
+  return getUniqueName(Name + "_unique_suffix", M);
+}
+
+SILFunction *
+ColdPathOutliner::createOutlinedFunction(const ColdRegion &Region) {
+  SILModule &M = F->getModule();
+
+  // Live-ins are passed at +0. The outlined code does its own reference
+  // counting, just like it did in the original function.
+  llvm::SmallVector<SILParameterInfo, 8> Params;
+  for (SILArgument *Arg : Region.getEntry()->getArguments())
+    Params.push_back(SILParameterInfo(Arg->getType().getSwiftRValueType(),
+                                      ParameterConvention::Direct_Unowned));
+  for (SILValue LiveIn : Region.LiveIns)
+    Params.push_back(SILParameterInfo(LiveIn->getType().getSwiftRValueType(),
+                                      ParameterConvention::Direct_Unowned));
+
+  llvm::SmallVector<SILResultInfo, 1> Results;
+  if (Region.ExitLoc && ReturnBB->getNumArguments() == 1) {
+    Results.push_back(SILResultInfo(
+        ReturnBB->getArgument(0)->getType().getSwiftRValueType(),
+        ResultConvention::Owned));
+  }
+
+  auto ExtInfo = SILFunctionType::ExtInfo(SILFunctionTypeRepresentation::Thin,
+                                          /*pseudogeneric*/ false);
+  CanSILFunctionType FTy = SILFunctionType::get(
+      nullptr, ExtInfo, ParameterConvention::Direct_Unowned, Params, Results,
+      None, M.getASTContext());
+
+  std::string Name = getUniqueName(F->getName().str() + "_cold", M);
+  DEBUG(llvm::dbgs() << "  outline cold region of " << F->getName()
+                     << " into " << Name << "\n");
+
+  SILFunction *OutlinedF = M.createFunction(
+      SILLinkage::Private, Name, FTy, nullptr, F->getLocation(), IsBare,
+      IsNotTransparent, IsNotFragile, IsNotThunk, SILFunction::NotRelevant,
+      NoInline, EffectsKind::Unspecified, nullptr, F->getDebugScope(),
+      F->getDeclContext());
+  if (F->hasUnqualifiedOwnership()) {
+    OutlinedF->setUnqualifiedOwnership();
+  }
+
+  ColdRegionCloner Cloner(*OutlinedF, ReturnBB);
+  Cloner.cloneRegion(Region);
+  return OutlinedF;
+}
+
+/// Returns the instructions of \p BB, except for debug_values, which don't
+/// affect the generated code.
+static llvm::SmallVector<SILInstruction *, 16>
+getCodeInstructions(SILBasicBlock &BB) {
+  llvm::SmallVector<SILInstruction *, 16> Insts;
+  for (SILInstruction &I : BB)
+    if (!isa<DebugValueInst>(&I))
+      Insts.push_back(&I);
+  return Insts;
+}
+
+/// Returns true if the bodies of \p F1 and \p F2 are identical up to the
+/// naming of their values and blocks, and their debug_values.
+static bool haveIdenticalBodies(SILFunction *F1, SILFunction *F2) {
+  if (F1->getLoweredFunctionType() != F2->getLoweredFunctionType() ||
+      F1->hasUnqualifiedOwnership() != F2->hasUnqualifiedOwnership() ||
+      F1->size() != F2->size())
+    return false;
+
+  llvm::DenseMap<SILBasicBlock *, SILBasicBlock *> BlockMap;
+  llvm::DenseMap<SILValue, SILValue> ValueMap;
+  for (auto BB1 = F1->begin(), BB2 = F2->begin(), E = F1->end(); BB1 != E;
+       ++BB1, ++BB2) {
+    if (BB1->getNumArguments() != BB2->getNumArguments())
+      return false;
+    BlockMap[&*BB1] = &*BB2;
+    for (unsigned i = 0, e = BB1->getNumArguments(); i != e; ++i) {
+      if (BB1->getArgument(i)->getType() != BB2->getArgument(i)->getType())
+        return false;
+      ValueMap[BB1->getArgument(i)] = BB2->getArgument(i);
+    }
+  }
+
+  auto OpEqual = [&](const SILValue &V1, const SILValue &V2) -> bool {
+    return ValueMap.lookup(V1) == V2;
+  };
+
+  // Blocks are cloned in dominator order, so every value is mapped before it
+  // is used, except by a block argument.
+  for (auto BB1 = F1->begin(), BB2 = F2->begin(), E = F1->end(); BB1 != E;
+       ++BB1, ++BB2) {
+    auto Insts1 = getCodeInstructions(*BB1);
+    auto Insts2 = getCodeInstructions(*BB2);
+    if (Insts1.size() != Insts2.size())
+      return false;
+
+    for (unsigned i = 0, e = Insts1.size() - 1; i != e; ++i) {
+      if (!Insts1[i]->isIdenticalTo(Insts2[i], OpEqual))
+        return false;
+      ValueMap[Insts1[i]] = Insts2[i];
+    }
+
+    // The identity comparison doesn't handle terminators, so compare the
+    // ones the cloner creates here.
+    auto *T1 = cast<TermInst>(Insts1.back());
+    auto *T2 = cast<TermInst>(Insts2.back());
+    if (T1->getKind() != T2->getKind() ||
+        T1->getNumOperands() != T2->getNumOperands())
+      return false;
+    if (!isa<BranchInst>(T1) && !isa<CondBranchInst>(T1) &&
+        !isa<ReturnInst>(T1) && !isa<UnreachableInst>(T1))
+      return false;
+    for (unsigned i = 0, e = T1->getNumOperands(); i != e; ++i)
+      if (!OpEqual(T1->getOperand(i), T2->getOperand(i)))
+        return false;
+    auto Succs1 = T1->getSuccessors();
+    auto Succs2 = T2->getSuccessors();
+    for (unsigned i = 0, e = Succs1.size(); i != e; ++i)
+      if (BlockMap.lookup(Succs1[i].getBB()) != Succs2[i].getBB())
+        return false;
+  }
+  return true;
+}
+
+SILFunction *
+ColdPathOutliner::findIdenticalOutlinedFunction(SILFunction *OutlinedF,
+                                                unsigned NumInsts) {
+  SILModule &M = OutlinedF->getModule();
+  auto &Candidates = OutlinedFunctions[NumInsts];
+  for (const std::string &Name : Candidates) {
+    // Dead function elimination may have removed the function since.
+    SILFunction *Candidate = M.lookUpFunction(Name);
+    if (Candidate && Candidate != OutlinedF && !Candidate->empty() &&
+        haveIdenticalBodies(Candidate, OutlinedF))
+      return Candidate;
+  }
+  Candidates.push_back(OutlinedF->getName().str());
+  return nullptr;
+}
+
+void ColdPathOutliner::outlineRegion(const ColdRegion &Region) {
+  SILFunction *OutlinedF = createOutlinedFunction(Region);
+  SILBasicBlock *Entry = Region.getEntry();
+
+  bool IsNewFunction = true;
+  if (OptimizeForSize) {
+    if (SILFunction *Existing =
+            findIdenticalOutlinedFunction(OutlinedF, Region.NumInsts)) {
+      DEBUG(llvm::dbgs() << "  reuse identical function "
+                         << Existing->getName() << "\n");
+      OutlinedF->dropAllReferences();
+      F->getModule().eraseFunction(OutlinedF);
+      OutlinedF = Existing;
+      IsNewFunction = false;
+      ++NumOutlinedFunctionsShared;
+    }
+  }
+
+  // Keep the region entry with its arguments and replace its body with a
+  // call of the outlined function.
+  SILInstruction *First = &*Entry->begin();
+  RegularLocation Loc(First->getLoc().getSourceLoc());
+  const SILDebugScope *Scope = First->getDebugScope();
+
+  for (SILBasicBlock *BB : Region.Blocks)
+    for (SILInstruction &I : *BB)
+      I.dropAllReferences();
+  while (!Entry->empty())
+    Entry->back().eraseFromParent();
+  for (SILBasicBlock *BB : Region.Blocks)
+    if (BB != Entry)
+      BB->eraseFromParent();
+
+  llvm::SmallVector<SILValue, 8> Args(Entry->args_begin(), Entry->args_end());
+  Args.append(Region.LiveIns.begin(), Region.LiveIns.end());
+
+  SILBuilder B(Entry);
+  B.setCurrentDebugScope(Scope);
+  auto *FRI = B.createFunctionRef(Loc, OutlinedF);
+  auto *AI = B.createApply(Loc, FRI, Args, /*isNonThrowing*/ false);
+  if (!Region.ExitLoc) {
+    B.createUnreachable(Loc);
+  } else if (ReturnBB->getNumArguments() == 1) {
+    B.createBranch(*Region.ExitLoc, ReturnBB, {SILValue(AI)});
+  } else {
+    B.createBranch(*Region.ExitLoc, ReturnBB);
+  }
+
+  if (IsNewFunction)
+    notifyPassManagerOfFunction(OutlinedF, F);
+  ++NumRegionsOutlined;
+}
+
+void ColdPathOutliner::run() {
+  F = getFunction();
+  OptimizeForSize = F->getModule().getOptions().OptimizeForSize;
+  if (!F->shouldOptimize() || F->isFragile() || F->isThunk() ||
+      F->isTransparent() || F->getLoweredFunctionType()->isPolymorphic())
+    return;
+
+  auto ReturnIter = F->findReturnBB();
+  ReturnBB = ReturnIter == F->end() ? nullptr : &*ReturnIter;
+
+  DominanceAnalysis *DA = PM->getAnalysis<DominanceAnalysis>();
+  DominanceInfo *DT = DA->get(F);
+  ColdBlockInfo CBI(DA);
+
+  // Collect regions in dominator tree preorder, skipping regions which are
+  // nested in a region we already decided to outline. The remaining regions
+  // are disjoint, so outlining one doesn't affect the others.
+  llvm::SmallVector<ColdRegion, 4> Regions;
+  llvm::SmallVector<DominanceInfoNode *, 16> Worklist;
+  Worklist.push_back(DT->getRootNode());
+  while (!Worklist.empty()) {
+    DominanceInfoNode *Node = Worklist.pop_back_val();
+    SILBasicBlock *BB = Node->getBlock();
+    // Only consider the successors of conditional branches. This also avoids
+    // re-scanning the rest of the function for each block of a straight-line
+    // chain of blocks.
+    SILBasicBlock *Pred = BB->getSinglePredecessorBlock();
+    if (Pred && Pred != BB && Pred->getSuccessors().size() > 1) {
+      ColdRegion Region;
+      if (collectRegion(DT, BB, Region) &&
+          isColdEdge(CBI, Pred, BB, Region)) {
+        Regions.push_back(std::move(Region));
+        continue;
+      }
+    }
+    for (DominanceInfoNode *Child : *Node)
+      Worklist.push_back(Child);
+  }
+
+  if (Regions.empty())
+    return;
+
+  for (const ColdRegion &Region : Regions)
+    outlineRegion(Region);
+
+  invalidateAnalysis(SILAnalysis::InvalidationKind::FunctionBody);
+}
+
+SILTransform *swift::createColdPathOutliner() {
+  return new ColdPathOutliner();
+}
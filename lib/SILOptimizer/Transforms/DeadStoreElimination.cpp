@@ -80,10 +80,10 @@ STATISTIC(NumDeadStores, "Number of dead stores removed");
 STATISTIC(NumPartialDeadStores, "Number of partial dead stores removed");
 
 /// If a large store is broken down to too many smaller stores, bail out.
-/// Currently, we only do partial dead store if we can form a single contiguous
-/// live store.
+/// A partially dead store is replaced by up to this many live stores, which
+/// covers the common case of initializing a few fields of a struct twice.
 static llvm::cl::opt<unsigned>
-MaxPartialStoreCount("max-partial-store-count", llvm::cl::init(1), llvm::cl::Hidden);
+MaxPartialStoreCount("max-partial-store-count", llvm::cl::init(4), llvm::cl::Hidden);
 
 /// ComputeMaxStoreSet - If we ignore all reads, what is the max store set that
 /// can reach a particular point in a basic block. This helps in generating
@@ -158,9 +158,11 @@ namespace {
 /// behavior or alias query we need to do in worst case is roughly linear to
 /// # of BBs x(times) # of locations.
 ///
-/// we could run DSE on functions with 256 basic blocks and 256 locations,
-/// which is a large function.  
-constexpr unsigned MaxLSLocationBBMultiplicationNone = 256*256;
+/// we could run DSE on functions with 512 basic blocks and 512 locations,
+/// which is a large function. Above the pessimistic limit only locations
+/// with tracked stores are visited at each instruction, so the cost grows
+/// with the number of live stores rather than with the size of the function.
+constexpr unsigned MaxLSLocationBBMultiplicationNone = 512*512;
 
 /// we could run optimistic DSE on functions with less than 64 basic blocks
 /// and 64 locations which is a sizable function.
@@ -702,9 +704,8 @@ void DSEContext::invalidateBaseForGenKillSet(SILValue B, BlockState *S) {
 }
 
 void DSEContext::invalidateBaseForDSE(SILValue B, BlockState *S) {
-  for (unsigned i = 0; i < S->LocationNum; ++i) {
-    if (!S->BBWriteSetMid.test(i))
-      continue;
+  for (int i = S->BBWriteSetMid.find_first(); i >= 0;
+       i = S->BBWriteSetMid.find_next(i)) {
     if (LocationVault[i].getBase() != B)
       continue;
     S->stopTrackingLocation(S->BBWriteSetMid, i);
@@ -734,9 +735,8 @@ void DSEContext::processReadForDSE(BlockState *S, unsigned bit) {
   // Remove any may/must-aliasing stores to the LSLocation, as they can't be
   // used to kill any upward visible stores due to the interfering load.
   LSLocation &R = LocationVault[bit];
-  for (unsigned i = 0; i < S->LocationNum; ++i) {
-    if (!S->isTrackingLocation(S->BBWriteSetMid, i))
-      continue;
+  for (int i = S->BBWriteSetMid.find_first(); i >= 0;
+       i = S->BBWriteSetMid.find_next(i)) {
     LSLocation &L = LocationVault[i];
     if (!L.isMayAliasLSLocation(R, AA))
       continue;
@@ -751,9 +751,8 @@ void DSEContext::processReadForGenKillSet(BlockState *S, unsigned bit) {
   // Even though, LSLocations are canonicalized, we still need to consult
   // alias analysis to determine whether 2 LSLocations are disjointed.
   LSLocation &R = LocationVault[bit];
-  for (unsigned i = 0; i < S->LocationNum; ++i) {
-    if (!S->BBMaxStoreSet.test(i))
-      continue;
+  for (int i = S->BBMaxStoreSet.find_first(); i >= 0;
+       i = S->BBMaxStoreSet.find_next(i)) {
     // Do nothing if the read location NoAlias with the current location.
     LSLocation &L = LocationVault[i];
     if (!L.isMayAliasLSLocation(R, AA))
@@ -824,9 +823,8 @@ bool DSEContext::processWriteForDSE(BlockState *S, unsigned bit) {
   // If a tracked store must aliases with this store, then this store is dead.
   bool StoreDead = false;
   LSLocation &R = LocationVault[bit];
-  for (unsigned i = 0; i < S->LocationNum; ++i) {
-    if (!S->isTrackingLocation(S->BBWriteSetMid, i))
-      continue;
+  for (int i = S->BBWriteSetMid.find_first(); i >= 0;
+       i = S->BBWriteSetMid.find_next(i)) {
     // If 2 locations may alias, we can still keep both stores.
     LSLocation &L = LocationVault[i];
     if (!L.isMustAliasLSLocation(R, AA))
@@ -985,9 +983,8 @@ void DSEContext::processStoreInst(SILInstruction *I, DSEKind Kind) {
 void DSEContext::processDebugValueAddrInstForGenKillSet(SILInstruction *I) {
   BlockState *S = getBlockState(I);
   SILValue Mem = cast<DebugValueAddrInst>(I)->getOperand();
-  for (unsigned i = 0; i < S->LocationNum; ++i) {
-    if (!S->BBMaxStoreSet.test(i))
-      continue;
+  for (int i = S->BBMaxStoreSet.find_first(); i >= 0;
+       i = S->BBMaxStoreSet.find_next(i)) {
     if (AA->isNoAlias(Mem, LocationVault[i].getBase()))
       continue;
     S->stopTrackingLocation(S->BBGenSet, i);
@@ -998,9 +995,8 @@ void DSEContext::processDebugValueAddrInstForGenKillSet(SILInstruction *I) {
 void DSEContext::processDebugValueAddrInstForDSE(SILInstruction *I) {
   BlockState *S = getBlockState(I);
   SILValue Mem = cast<DebugValueAddrInst>(I)->getOperand();
-  for (unsigned i = 0; i < S->LocationNum; ++i) {
-    if (!S->isTrackingLocation(S->BBWriteSetMid, i))
-      continue;
+  for (int i = S->BBWriteSetMid.find_first(); i >= 0;
+       i = S->BBWriteSetMid.find_next(i)) {
     if (AA->isNoAlias(Mem, LocationVault[i].getBase()))
       continue;
     S->stopTrackingLocation(S->BBWriteSetMid, i);
@@ -1025,9 +1021,8 @@ void DSEContext::processDebugValueAddrInst(SILInstruction *I, DSEKind Kind) {
 
 void DSEContext::processUnknownReadInstForGenKillSet(SILInstruction *I) {
   BlockState *S = getBlockState(I);
-  for (unsigned i = 0; i < S->LocationNum; ++i) {
-    if (!S->BBMaxStoreSet.test(i))
-      continue;
+  for (int i = S->BBMaxStoreSet.find_first(); i >= 0;
+       i = S->BBMaxStoreSet.find_next(i)) {
     if (!AA->mayReadFromMemory(I, LocationVault[i].getBase()))
       continue;
     // Update the genset and kill set.
@@ -1038,9 +1033,8 @@ void DSEContext::processUnknownReadInstForGenKillSet(SILInstruction *I) {
 
 void DSEContext::processUnknownReadInstForDSE(SILInstruction *I) {
   BlockState *S = getBlockState(I);
-  for (unsigned i = 0; i < S->LocationNum; ++i) {
-    if (!S->isTrackingLocation(S->BBWriteSetMid, i))
-      continue;
+  for (int i = S->BBWriteSetMid.find_first(); i >= 0;
+       i = S->BBWriteSetMid.find_next(i)) {
     if (!AA->mayReadFromMemory(I, LocationVault[i].getBase()))
       continue;
     S->stopTrackingLocation(S->BBWriteSetMid, i);
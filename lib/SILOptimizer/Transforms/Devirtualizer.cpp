@@ -17,6 +17,7 @@
 
 #define DEBUG_TYPE "sil-devirtualizer"
 
+#include "swift/SIL/OptimizationRemark.h"
 #include "swift/SIL/SILFunction.h"
 #include "swift/SIL/SILInstruction.h"
 #include "swift/SILOptimizer/Analysis/ClassHierarchyAnalysis.h"
@@ -54,6 +55,7 @@ bool Devirtualizer::devirtualizeAppliesInFunction(SILFunction &F,
   bool Changed = false;
   llvm::SmallVector<SILInstruction *, 8> DeadApplies;
   llvm::SmallVector<ApplySite, 8> NewApplies;
+  OptRemark::Emitter ORE(DEBUG_TYPE, F.getModule());
 
   for (auto &BB : F) {
     for (auto It = BB.begin(), End = BB.end(); It != End;) {
@@ -66,12 +68,31 @@ bool Devirtualizer::devirtualizeAppliesInFunction(SILFunction &F,
         continue;
 
       auto NewInstPair = tryDevirtualizeApply(Apply, CHA);
-      if (!NewInstPair.second)
+      auto *AI = Apply.getInstruction();
+      if (!NewInstPair.second) {
+        // Only dynamically dispatched calls are worth a remark.
+        SILValue Callee = Apply.getCallee();
+        if (isa<ClassMethodInst>(Callee) || isa<WitnessMethodInst>(Callee)) {
+          ORE.emit([&]() {
+            using namespace OptRemark;
+            return RemarkMissed("NoDevirtualization", *AI)
+                   << "Unable to devirtualize the call of "
+                   << NV("Method",
+                         cast<MethodInst>(Callee)->getMember().getDecl());
+          });
+        }
         continue;
+      }
 
       Changed = true;
 
-      auto *AI = Apply.getInstruction();
+      ORE.emit([&]() {
+        using namespace OptRemark;
+        return RemarkPassed("Devirtualized", *AI)
+               << "Devirtualized call to "
+               << NV("Callee", NewInstPair.second.getReferencedFunction());
+      });
+
       if (!isa<TryApplyInst>(AI))
         AI->replaceAllUsesWith(NewInstPair.first);
 
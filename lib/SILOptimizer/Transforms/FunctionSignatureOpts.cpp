@@ -457,9 +457,13 @@ CanSILFunctionType FunctionSignatureTransform::createOptimizedSILFunctionType()
     InterfaceResults.push_back(InterfaceResult);
   }
 
-  // Don't use a method representation if we modified self.
+  // Don't use a method representation if we modified self. The optimized
+  // version of a protocol witness is only called directly from the thunk
+  // and devirtualized callers, so it doesn't need the witness_method
+  // convention either.
   auto ExtInfo = FTy->getExtInfo();
-  if (shouldModifySelfArgument) {
+  if (shouldModifySelfArgument ||
+      FTy->getRepresentation() == SILFunctionTypeRepresentation::WitnessMethod) {
     ExtInfo = ExtInfo.withRepresentation(SILFunctionTypeRepresentation::Thin);
   }
 
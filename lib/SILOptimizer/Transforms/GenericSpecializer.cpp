@@ -17,6 +17,7 @@
 
 #define DEBUG_TYPE "sil-generic-specializer"
 
+#include "swift/SIL/OptimizationRemark.h"
 #include "swift/SIL/SILFunction.h"
 #include "swift/SIL/SILInstruction.h"
 #include "swift/SILOptimizer/Analysis/BasicCalleeAnalysis.h"
@@ -55,8 +56,15 @@ bool GenericSpecializer::specializeAppliesInFunction(SILFunction &F) {
   DeadInstructionSet DeadApplies;
   llvm::SmallSetVector<SILInstruction *, 8> Applies;
 
+  OptRemark::Emitter ORE(DEBUG_TYPE, F.getModule());
+
   bool Changed = false;
   for (auto &BB : F) {
+    // Don't grow the code with specializations the profile says are never
+    // called.
+    if (BB.isProfiledCold())
+      continue;
+
     // Collect the applies for this block in reverse order so that we
     // can pop them off the end of our vector and process them in
     // forward order.
@@ -94,6 +102,21 @@ bool GenericSpecializer::specializeAppliesInFunction(SILFunction &F) {
       llvm::SmallVector<SILFunction *, 2> NewFunctions;
       trySpecializeApplyOfGeneric(Apply, DeadApplies, NewFunctions);
 
+      if (DeadApplies.count(I)) {
+        ORE.emit([&]() {
+          using namespace OptRemark;
+          return RemarkPassed("Specialized", *I)
+                 << "Specialized generic function " << NV("Callee", Callee);
+        });
+      } else {
+        ORE.emit([&]() {
+          using namespace OptRemark;
+          return RemarkMissed("NoSpecialization", *I)
+                 << "Unable to specialize generic function "
+                 << NV("Callee", Callee);
+        });
+      }
+
       // Remove all the now-dead applies. We must do this immediately
       // rather than defer it in order to avoid problems with cloning
       // dead instructions when doing recursive specialization.
@@ -0,0 +1,90 @@
+//===--- NonAtomicRC.cpp - Use non-atomic RC for thread-local objects -----===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Convert reference counting operations on objects which never escape the
+// current function into non-atomic ones.
+//
+// An object which doesn't escape its function can't be reached from any other
+// thread, so the reference counting operations on it don't need to be atomic.
+// This is the same conversion as AssumeSingleThreaded performs, but restricted
+// to the objects for which escape analysis can prove thread locality.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "non-atomic-rc"
+#include "swift/SILOptimizer/PassManager/Passes.h"
+#include "swift/SILOptimizer/PassManager/Transforms.h"
+#include "swift/SILOptimizer/Analysis/EscapeAnalysis.h"
+#include "swift/SIL/SILFunction.h"
+#include "swift/SIL/SILInstruction.h"
+#include "llvm/ADT/Statistic.h"
+
+STATISTIC(NumNonAtomicRC, "Number of RC operations made non-atomic");
+
+using namespace swift;
+
+namespace {
+
+class NonAtomicRC : public swift::SILFunctionTransform {
+
+  /// Returns true if the reference counted operand of \p RCI refers to an
+  /// object which can't be accessed by any other thread.
+  static bool isThreadLocal(RefCountingInst *RCI,
+                            EscapeAnalysis::ConnectionGraph *ConGraph,
+                            EscapeAnalysis *EA) {
+    SILValue Op = RCI->getOperand(0);
+    // Only handle single references. Aggregates may contain references which
+    // are not tracked by a single connection graph node.
+    if (!Op->getType().isReferenceCounted(RCI->getModule()))
+      return false;
+    auto *Node = ConGraph->getNodeOrNull(Op, EA);
+    return Node && !Node->escapes();
+  }
+
+  /// The entry point to the transformation.
+  void run() override {
+    // Everything is non-atomic anyway.
+    if (getOptions().AssumeSingleThreaded)
+      return;
+
+    auto *EA = PM->getAnalysis<EscapeAnalysis>();
+    EscapeAnalysis::ConnectionGraph *ConGraph = nullptr;
+    bool Changed = false;
+
+    for (auto &BB : *getFunction()) {
+      for (auto &I : BB) {
+        auto *RCI = dyn_cast<RefCountingInst>(&I);
+        if (!RCI || RCI->isNonAtomic() || RCI->getNumOperands() != 1)
+          continue;
+        // Only build the connection graph if there is something to do.
+        if (!ConGraph)
+          ConGraph = EA->getConnectionGraph(getFunction());
+        if (!isThreadLocal(RCI, ConGraph, EA))
+          continue;
+        DEBUG(llvm::dbgs() << "  make non-atomic: " << *RCI);
+        RCI->setNonAtomic();
+        ++NumNonAtomicRC;
+        Changed = true;
+      }
+    }
+    if (Changed)
+      invalidateAnalysis(SILAnalysis::InvalidationKind::Instructions);
+  }
+
+  StringRef getName() override { return "Non-atomic RC"; }
+};
+
+} // end anonymous namespace
+
+SILTransform *swift::createNonAtomicRC() {
+  return new NonAtomicRC();
+}
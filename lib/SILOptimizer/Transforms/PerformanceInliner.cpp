@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #define DEBUG_TYPE "sil-inliner"
+#include "swift/SIL/OptimizationRemark.h"
 #include "swift/SILOptimizer/PassManager/Passes.h"
 #include "swift/SILOptimizer/PassManager/Transforms.h"
 #include "swift/SILOptimizer/Utils/PerformanceInlinerUtils.h"
@@ -61,6 +62,8 @@ class SILPerformanceInliner {
 
   ColdBlockInfo CBI;
 
+  OptRemark::Emitter &ORE;
+
   /// The following constants define the cost model for inlining. Some constants
   /// are also defined in ShortestPathAnalysis.
   enum {
@@ -91,6 +94,11 @@ class SILPerformanceInliner {
     /// The benefit of a onFastPath builtin.
     FastPathBuiltinBenefit = RemovedCallBenefit + 40,
 
+    /// The benefit if an existential which is opened in the callee is created
+    /// in the caller: after inlining, the concrete type is known and the
+    /// witness method calls on the opened value can be devirtualized.
+    RemovedExistentialBenefit = RemovedCallBenefit + 40,
+
     /// Approximately up to this cost level a function can be inlined without
     /// increasing the code size.
     TrivialFunctionThreshold = 18,
@@ -143,14 +151,32 @@ class SILPerformanceInliner {
 
 public:
   SILPerformanceInliner(InlineSelection WhatToInline, DominanceAnalysis *DA,
-                        SILLoopAnalysis *LA)
-      : WhatToInline(WhatToInline), DA(DA), LA(LA), CBI(DA) {}
+                        SILLoopAnalysis *LA, OptRemark::Emitter &ORE)
+      : WhatToInline(WhatToInline), DA(DA), LA(LA), CBI(DA), ORE(ORE) {}
 
   bool inlineCallsIntoFunction(SILFunction *F);
 };
 
 } // namespace
 
+// Return true if \p V is an existential (or the address of an existential)
+// which is initialized in the caller.
+static bool isExistentialCreatedInCaller(ConstantTracker &Tracker,
+                                         SILValue V) {
+  SILInstruction *Def = Tracker.getDefInCaller(V);
+  if (!Def)
+    return false;
+  if (isa<InitExistentialRefInst>(Def))
+    return true;
+  if (auto *ASI = dyn_cast<AllocStackInst>(Def)) {
+    for (Operand *Use : ASI->getUses()) {
+      if (isa<InitExistentialAddrInst>(Use->getUser()))
+        return true;
+    }
+  }
+  return false;
+}
+
 // Return true if the callee has self-recursive calls.
 static bool calleeIsSelfRecursive(SILFunction *Callee) {
   for (auto &BB : *Callee)
@@ -278,6 +304,11 @@ bool SILPerformanceInliner::isProfitableToInline(FullApplySite AI,
   if (Opts.Optimization == SILOptions::SILOptMode::OptimizeUnchecked)
     BaseBenefit *= 2;
 
+  // Likewise for call sites the profile says are hotter than the caller's
+  // entry, which are usually in loops.
+  if (CBI.isProfiledHot(AI.getParent()))
+    BaseBenefit *= 2;
+
   CallerWeight.updateBenefit(Benefit, BaseBenefit);
 
   // Go through all blocks of the function, accumulate the cost and find
@@ -319,6 +350,12 @@ bool SILPerformanceInliner::isProfitableToInline(FullApplySite AI,
       } else if (auto *BI = dyn_cast<BuiltinInst>(&I)) {
         if (BI->getBuiltinInfo().ID == BuiltinValueKind::OnFastPath)
           BlockW.updateBenefit(Benefit, FastPathBuiltinBenefit);
+      } else if (isa<OpenExistentialAddrInst>(&I) ||
+                 isa<OpenExistentialRefInst>(&I)) {
+        // Check if the existential is created in the caller. If so, the
+        // concrete type is known after inlining.
+        if (isExistentialCreatedInCaller(constTracker, I.getOperand(0)))
+          BlockW.updateBenefit(Benefit, RemovedExistentialBenefit);
       }
     }
     // Don't count costs in blocks which are dead after inlining.
@@ -337,8 +374,17 @@ bool SILPerformanceInliner::isProfitableToInline(FullApplySite AI,
   if (AI.getFunction()->isThunk()) {
     // Only inline trivial functions into thunks (which will not increase the
     // code size).
-    if (CalleeCost > TrivialFunctionThreshold)
+    if (CalleeCost > TrivialFunctionThreshold) {
+      ORE.emit([&]() {
+        using namespace OptRemark;
+        return RemarkMissed("NoInlinedIntoThunk", *AI.getInstruction())
+               << "Not inlining " << NV("Callee", Callee)
+               << " into a thunk (cost = " << NV("Cost", CalleeCost)
+               << ", threshold = "
+               << NV("Threshold", int(TrivialFunctionThreshold)) << ")";
+      });
       return false;
+    }
 
     DEBUG(
       
@@ -359,6 +405,13 @@ bool SILPerformanceInliner::isProfitableToInline(FullApplySite AI,
 
   // This is the final inlining decision.
   if (CalleeCost > Benefit) {
+    ORE.emit([&]() {
+      using namespace OptRemark;
+      return RemarkMissed("NoInlinedCost", *AI.getInstruction())
+             << "Not profitable to inline " << NV("Callee", Callee)
+             << " (cost = " << NV("Cost", CalleeCost)
+             << ", benefit = " << NV("Benefit", Benefit) << ")";
+    });
     return false;
   }
 
@@ -563,7 +616,7 @@ void SILPerformanceInliner::collectAppliesToInline(
       }
     }
     domOrder.pushChildrenIf(block, [&] (SILBasicBlock *child) {
-      if (CBI.isSlowPath(block, child)) {
+      if (CBI.isSlowPath(block, child) || child->isProfiledCold()) {
         // Handle cold blocks separately.
         visitColdBlocks(InitialCandidates, child, DT);
         return false;
@@ -627,6 +680,13 @@ bool SILPerformanceInliner::inlineCallsIntoFunction(SILFunction *Caller) {
           Caller->size() << "] " << Callee->getName() << "\n";
     );
 
+    ORE.emit([&]() {
+      using namespace OptRemark;
+      return RemarkPassed("Inlined", *AI.getInstruction())
+             << NV("Callee", Callee) << " inlined into "
+             << NV("Caller", Caller);
+    });
+
     SILOpenedArchetypesTracker OpenedArchetypesTracker(*Caller);
     Caller->getModule().registerDeleteNotificationHandler(&OpenedArchetypesTracker);
     // The callee only needs to know about opened archetypes used in
@@ -699,7 +759,8 @@ public:
       return;
     }
 
-    SILPerformanceInliner Inliner(WhatToInline, DA, LA);
+    OptRemark::Emitter ORE(DEBUG_TYPE, getFunction()->getModule());
+    SILPerformanceInliner Inliner(WhatToInline, DA, LA, ORE);
 
     assert(getFunction()->isDefinition() &&
            "Expected only functions with bodies!");
@@ -174,9 +174,12 @@ namespace {
 /// behavior or alias query we need to do in worst case is roughly linear to
 /// # of BBs x(times) # of locations.
 ///
-/// we could run RLE on functions with 128 basic blocks and 128 locations,
-/// which is a large function.  
-constexpr unsigned MaxLSLocationBBMultiplicationNone = 128*128;
+/// we could run RLE on functions with 512 basic blocks and 512 locations,
+/// which is a large function. Above the pessimistic limit only locations
+/// which are actually available are visited at each instruction, so the cost
+/// grows with the number of live values rather than with the size of the
+/// function.
+constexpr unsigned MaxLSLocationBBMultiplicationNone = 512*512;
 
 /// we could run optimistic RLE on functions with less than 64 basic blocks
 /// and 64 locations which is a sizable function.
@@ -610,22 +613,30 @@ void BlockState::mergePredecessorAvailSetAndValue(RLEContext &Ctx) {
   ForwardSetIn = Ctx.getBlockState(*Iter).ForwardSetOut;
   ForwardValIn = Ctx.getBlockState(*Iter).ForwardValOut;
   Iter = std::next(Iter);
+  unsigned CoveringValue = Ctx.getValueBit(LSValue(true));
   for (auto EndIter = BB->pred_end(); Iter != EndIter; ++Iter) {
     BlockState &OtherState = Ctx.getBlockState(*Iter);
     ForwardSetIn &= OtherState.ForwardSetOut;
 
-    // Merge in the predecessor state.
-    for (unsigned i = 0; i < LocationNum; ++i) {
-      if (OtherState.ForwardSetOut[i]) {
-        // There are multiple values from multiple predecessors, set this as
-        // a covering value. We do not need to track the value itself, as we
-        // can always go to the predecessors BlockState to find it.
-        ForwardValIn[i] = Ctx.getValueBit(LSValue(true));
-        continue;
-      }
-      // If this location does have an available value, then clear it.
+    // Merge in the predecessor state. Only the locations which have a value
+    // so far or are available in the predecessor need to be visited, not
+    // every location in the function.
+    //
+    // If this location does not have an available value, then clear it.
+    llvm::SmallVector<unsigned, 8> Unavailable;
+    for (auto &X : ForwardValIn) {
+      if (!OtherState.ForwardSetOut[X.first])
+        Unavailable.push_back(X.first);
+    }
+    for (unsigned i : Unavailable)
       stopTrackingValue(ForwardValIn, i);
-      stopTrackingLocation(ForwardSetIn, i);
+
+    // There are multiple values from multiple predecessors, set this as
+    // a covering value. We do not need to track the value itself, as we
+    // can always go to the predecessors BlockState to find it.
+    for (int i = OtherState.ForwardSetOut.find_first(); i >= 0;
+         i = OtherState.ForwardSetOut.find_next(i)) {
+      ForwardValIn[i] = CoveringValue;
     }
   }
 }
@@ -737,9 +748,8 @@ void BlockState::updateGenKillSetForWrite(RLEContext &Ctx, unsigned B) {
   // This is a store, invalidate any location that this location may alias, as
   // their values can no longer be forwarded.
   LSLocation &R = Ctx.getLocation(B);
-  for (unsigned i = 0; i < LocationNum; ++i) {
-    if (!isTrackingLocation(ForwardSetMax, i))
-      continue;
+  for (int i = ForwardSetMax.find_first(); i >= 0;
+       i = ForwardSetMax.find_next(i)) {
     LSLocation &L = Ctx.getLocation(i);
     if (!L.isMayAliasLSLocation(R, Ctx.getAA()))
       continue;
@@ -765,9 +775,8 @@ void BlockState::updateForwardSetForWrite(RLEContext &Ctx, unsigned B) {
   // This is a store, invalidate any location that this location may alias, as
   // their values can no longer be forwarded.
   LSLocation &R = Ctx.getLocation(B);
-  for (unsigned i = 0; i < LocationNum; ++i) {
-    if (!isTrackingLocation(ForwardSetIn, i))
-      continue;
+  for (int i = ForwardSetIn.find_first(); i >= 0;
+       i = ForwardSetIn.find_next(i)) {
     LSLocation &L = Ctx.getLocation(i);
     if (!L.isMayAliasLSLocation(R, Ctx.getAA()))
       continue;
@@ -784,9 +793,8 @@ void BlockState::updateForwardSetAndValForWrite(RLEContext &Ctx, unsigned L,
   // This is a store, invalidate any location that this location may alias, as
   // their values can no longer be forwarded.
   LSLocation &R = Ctx.getLocation(L);
-  for (unsigned i = 0; i < LocationNum; ++i) {
-    if (!isTrackingLocation(ForwardSetIn, i))
-      continue;
+  for (int i = ForwardSetIn.find_first(); i >= 0;
+       i = ForwardSetIn.find_next(i)) {
     LSLocation &L = Ctx.getLocation(i);
     if (!L.isMayAliasLSLocation(R, Ctx.getAA()))
       continue;
@@ -930,9 +938,8 @@ void BlockState::processLoadInst(RLEContext &Ctx, LoadInst *LI, RLEKind Kind) {
 void BlockState::processUnknownWriteInstForGenKillSet(RLEContext &Ctx,
                                                       SILInstruction *I) {
   auto *AA = Ctx.getAA();
-  for (unsigned i = 0; i < LocationNum; ++i) {
-    if (!isTrackingLocation(ForwardSetMax, i))
-      continue;
+  for (int i = ForwardSetMax.find_first(); i >= 0;
+       i = ForwardSetMax.find_next(i)) {
     // Invalidate any location this instruction may write to.
     //
     // TODO: checking may alias with Base is overly conservative,
@@ -949,9 +956,8 @@ void BlockState::processUnknownWriteInstForGenKillSet(RLEContext &Ctx,
 void BlockState::processUnknownWriteInstForRLE(RLEContext &Ctx,
                                                SILInstruction *I) {
   auto *AA = Ctx.getAA();
-  for (unsigned i = 0; i < LocationNum; ++i) {
-    if (!isTrackingLocation(ForwardSetIn, i))
-      continue;
+  for (int i = ForwardSetIn.find_first(); i >= 0;
+       i = ForwardSetIn.find_next(i)) {
     // Invalidate any location this instruction may write to.
     //
     // TODO: checking may alias with Base is overly conservative,
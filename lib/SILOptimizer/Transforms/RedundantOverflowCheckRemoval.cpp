@@ -494,6 +494,120 @@ public:
     }
   }
 
+  /// The maximum depth of operands which getUnsignedUpperBound follows.
+  static const unsigned MaxRangeDepth = 8;
+
+  /// Return an upper bound of the value of the integer \p V, interpreted as
+  /// unsigned, or None if nothing is known about it.
+  ///
+  /// This is a simple value range analysis which follows the operands of
+  /// \p V, e.g. a zero-extended byte is at most 255 and a value which is
+  /// masked with 0xffff is at most 0xffff.
+  static Optional<APInt> getUnsignedUpperBound(SILValue V, unsigned Depth) {
+    auto *IntTy = V->getType().getAs<BuiltinIntegerType>();
+    if (!IntTy || !IntTy->isFixedWidth())
+      return None;
+    unsigned Width = IntTy->getFixedWidth();
+
+    if (auto *IL = dyn_cast<IntegerLiteralInst>(V))
+      return IL->getValue();
+
+    if (Depth >= MaxRangeDepth)
+      return None;
+
+    // The result of an arithmetic operation which can't overflow.
+    if (auto *TEI = dyn_cast<TupleExtractInst>(V)) {
+      auto *BI = dyn_cast<BuiltinInst>(TEI->getOperand());
+      if (!BI || TEI->getFieldNo() != 0)
+        return None;
+      return getUpperBoundIfNoOverflow(BI, Depth + 1);
+    }
+
+    auto *BI = dyn_cast<BuiltinInst>(V);
+    if (!BI)
+      return None;
+    OperandValueArrayRef Args = BI->getArguments();
+
+    switch (BI->getBuiltinInfo().ID) {
+      default:
+        return None;
+      case BuiltinValueKind::ZExt:
+      case BuiltinValueKind::ZExtOrBitCast: {
+        auto *OpTy = Args[0]->getType().getAs<BuiltinIntegerType>();
+        if (!OpTy || !OpTy->isFixedWidth())
+          return None;
+        if (auto OpBound = getUnsignedUpperBound(Args[0], Depth + 1))
+          return OpBound->zextOrSelf(Width);
+        if (OpTy->getFixedWidth() == Width)
+          return None;
+        return APInt::getLowBitsSet(Width, OpTy->getFixedWidth());
+      }
+      case BuiltinValueKind::Trunc:
+      case BuiltinValueKind::TruncOrBitCast: {
+        // Truncation doesn't change a value which fits into the result.
+        auto OpBound = getUnsignedUpperBound(Args[0], Depth + 1);
+        if (!OpBound || OpBound->getActiveBits() > Width)
+          return None;
+        return OpBound->zextOrTrunc(Width);
+      }
+      case BuiltinValueKind::And: {
+        auto LHS = getUnsignedUpperBound(Args[0], Depth + 1);
+        auto RHS = getUnsignedUpperBound(Args[1], Depth + 1);
+        if (LHS && RHS)
+          return LHS->ult(*RHS) ? LHS : RHS;
+        return LHS ? LHS : RHS;
+      }
+      case BuiltinValueKind::LShr: {
+        auto *Shift = dyn_cast<IntegerLiteralInst>(Args[1]);
+        if (!Shift || Shift->getValue().uge(Width))
+          return None;
+        APInt Bound = APInt::getAllOnesValue(Width);
+        if (auto OpBound = getUnsignedUpperBound(Args[0], Depth + 1))
+          Bound = *OpBound;
+        return Bound.lshr(Shift->getValue().getZExtValue());
+      }
+      case BuiltinValueKind::URem: {
+        auto *Divisor = dyn_cast<IntegerLiteralInst>(Args[1]);
+        if (!Divisor || Divisor->getValue() == 0)
+          return None;
+        return Divisor->getValue() - 1;
+      }
+    }
+  }
+
+  /// Return an upper bound of the result of the arithmetic operation with
+  /// overflow check \p BI, if the bounds of its operands prove that the
+  /// operation can't overflow. Otherwise return None.
+  static Optional<APInt> getUpperBoundIfNoOverflow(BuiltinInst *BI,
+                                                   unsigned Depth) {
+    bool IsSigned, IsAdd;
+    switch (BI->getBuiltinInfo().ID) {
+      default: return None;
+      case BuiltinValueKind::SAddOver: IsSigned = true;  IsAdd = true;  break;
+      case BuiltinValueKind::UAddOver: IsSigned = false; IsAdd = true;  break;
+      case BuiltinValueKind::SMulOver: IsSigned = true;  IsAdd = false; break;
+      case BuiltinValueKind::UMulOver: IsSigned = false; IsAdd = false; break;
+    }
+    auto LHS = getUnsignedUpperBound(BI->getArguments()[0], Depth);
+    if (!LHS)
+      return None;
+    auto RHS = getUnsignedUpperBound(BI->getArguments()[1], Depth);
+    if (!RHS)
+      return None;
+
+    // The operands of a signed operation are only known to be in the range
+    // 0...Bound if the bound is a positive number.
+    if (IsSigned && (LHS->isNegative() || RHS->isNegative()))
+      return None;
+
+    bool Overflow;
+    APInt Result = IsAdd ? LHS->uadd_ov(*RHS, Overflow)
+                         : LHS->umul_ov(*RHS, Overflow);
+    if (Overflow || (IsSigned && Result.isNegative()))
+      return None;
+    return Result;
+  }
+
   bool tryToRemoveCondFail(CondFailInst *CFI) {
     // Extract the arithmetic operation from the condfail.
     auto *TEI = dyn_cast<TupleExtractInst>(CFI->getOperand());
@@ -501,6 +615,12 @@ public:
     auto *BI = dyn_cast<BuiltinInst>(TEI->getOperand());
     if (!BI) return false;
 
+    // Check if the ranges of the operands already rule out an overflow.
+    if (TEI->getFieldNo() == 1 && getUpperBoundIfNoOverflow(BI, 0)) {
+      DEBUG(llvm::dbgs() << "Overflow ruled out by value ranges: " << *BI);
+      return true;
+    }
+
     for (auto &F : Constraints) {
       // If we are dominated by a constraint:
       if (DT->dominates(F.DominatingBlock, CFI->getParent())) {
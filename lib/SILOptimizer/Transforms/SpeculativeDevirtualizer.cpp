@@ -25,6 +25,8 @@
 #include "swift/SIL/SILModule.h"
 #include "swift/SIL/InstructionUtils.h"
 #include "swift/SILOptimizer/Analysis/ClassHierarchyAnalysis.h"
+#include "swift/SILOptimizer/Analysis/ColdBlockInfo.h"
+#include "swift/SILOptimizer/Analysis/DominanceAnalysis.h"
 #include "swift/SILOptimizer/Utils/Generics.h"
 #include "swift/SILOptimizer/PassManager/Passes.h"
 #include "swift/SILOptimizer/PassManager/PassManager.h"
@@ -42,7 +44,18 @@ using namespace swift;
 
 // This is the limit for the number of subclasses (jump targets) that the
 // speculative devirtualizer will try to predict.
-static const int MaxNumSpeculativeTargets = 6;
+static llvm::cl::opt<unsigned> MaxNumSpeculativeTargets(
+    "max-speculative-targets", llvm::cl::init(6),
+    llvm::cl::desc("Maximum number of subclasses checked when speculatively "
+                   "devirtualizing a class_method call"));
+
+// This is the limit for the number of conforming types that the speculative
+// devirtualizer will check for a witness_method call on an existential.
+// A protocol with more conforming types is not speculated at all.
+static llvm::cl::opt<unsigned> MaxNumSpeculativeWitnessTargets(
+    "max-speculative-witness-targets", llvm::cl::init(3),
+    llvm::cl::desc("Maximum number of conforming types checked when "
+                   "speculatively devirtualizing a witness_method call"));
 
 STATISTIC(NumTargetsPredicted, "Number of monomorphic functions predicted");
 
@@ -314,7 +327,8 @@ static bool isDefaultCaseKnown(ClassHierarchyAnalysis *CHA,
 /// \brief Try to speculate the call target for the call \p AI. This function
 /// returns true if a change was made.
 static bool tryToSpeculateTarget(FullApplySite AI,
-                                 ClassHierarchyAnalysis *CHA) {
+                                 ClassHierarchyAnalysis *CHA,
+                                 unsigned MaxTargets) {
   ClassMethodInst *CMI = cast<ClassMethodInst>(AI.getCallee());
 
   // We cannot devirtualize in cases where dynamic calls are
@@ -398,14 +412,14 @@ static bool tryToSpeculateTarget(FullApplySite AI,
 
   // Number of subclasses which cannot be handled by checked_cast_br checks.
   int NotHandledSubsNum = 0;
-  if (Subs.size() > MaxNumSpeculativeTargets) {
+  if (Subs.size() > MaxTargets) {
     DEBUG(llvm::dbgs() << "Class " << CD->getName() << " has too many ("
                        << Subs.size() << ") subclasses. Performing speculative "
                          "devirtualization only for the first "
-                       << MaxNumSpeculativeTargets << " of them.\n");
+                       << MaxTargets << " of them.\n");
 
-    NotHandledSubsNum += (Subs.size() - MaxNumSpeculativeTargets);
-    Subs.erase(&Subs[MaxNumSpeculativeTargets], Subs.end());
+    NotHandledSubsNum += (Subs.size() - MaxTargets);
+    Subs.erase(&Subs[MaxTargets], Subs.end());
   }
 
   DEBUG(llvm::dbgs() << "Class " << CD->getName() << " is a superclass. "
@@ -529,6 +543,194 @@ static bool tryToSpeculateTarget(FullApplySite AI,
   return Changed;
 }
 
+/// Insert a monomorphic inline cache for a witness_method call on the
+/// payload of the opaque existential opened by \p OEA, which checks if the
+/// dynamic type of the existential is the value type \p ConcreteTy.
+static FullApplySite
+speculateMonomorphicWitnessTarget(FullApplySite AI,
+                                  OpenExistentialAddrInst *OEA,
+                                  CanType ConcreteTy,
+                                  ProtocolConformanceRef Conformance) {
+  auto *WMI = cast<WitnessMethodInst>(AI.getCallee());
+  SILModule &M = AI.getModule();
+  SILFunction *F = AI.getFunction();
+  SILBasicBlock *Entry = AI.getParent();
+
+  // Iden is the basic block containing the direct call.
+  SILBasicBlock *Iden = F->createBasicBlock();
+  // Virt is the block containing the slow witness table call.
+  SILBasicBlock *Virt = F->createBasicBlock();
+  SILType ConcreteMetaTy = SILType::getPrimitiveObjectType(
+      CanMetatypeType::get(ConcreteTy, MetatypeRepresentation::Thick));
+  Iden->createArgument(ConcreteMetaTy);
+
+  SILBasicBlock *Continue = Entry->split(AI.getInstruction()->getIterator());
+
+  // Check the dynamic type of the existential. Value types don't have
+  // subtypes, so a cast of the metatype succeeds only for exactly this type.
+  SILBuilderWithScope Builder(Entry, AI.getInstruction());
+  SILValue Existential = OEA->getOperand();
+  SILType ExistentialMetaTy = SILType::getPrimitiveObjectType(
+      CanExistentialMetatypeType::get(
+          Existential->getType().getSwiftRValueType(),
+          MetatypeRepresentation::Thick));
+  auto *DynamicType = Builder.createExistentialMetatype(
+      AI.getLoc(), ExistentialMetaTy, Existential);
+  Builder.createCheckedCastBranch(AI.getLoc(), /*exact*/ false, DynamicType,
+                                  ConcreteMetaTy, Iden, Virt);
+
+  SILBuilderWithScope VirtBuilder(Virt, AI.getInstruction());
+  SILBuilderWithScope IdenBuilder(Iden, AI.getInstruction());
+
+  FullApplySite VirtAI = CloneApply(AI, VirtBuilder);
+
+  // On the identical path, call the method on the payload as a value of the
+  // concrete type.
+  auto Conformances =
+    M.getASTContext().AllocateUninitialized<ProtocolConformanceRef>(1);
+  Conformances[0] = Conformance;
+  Substitution Subs[1] = {
+    Substitution(ConcreteTy, Conformances)
+  };
+  auto *ConcreteWMI = IdenBuilder.createWitnessMethod(
+      AI.getLoc(), ConcreteTy, Conformance, WMI->getMember(), WMI->getType());
+  SmallVector<SILValue, 8> Args(AI.getArguments().begin(),
+                                AI.getArguments().end());
+  Args.back() = IdenBuilder.createUncheckedAddrCast(
+      AI.getLoc(), AI.getSelfArgument(),
+      SILType::getPrimitiveAddressType(ConcreteTy));
+  FullApplySite IdenAI = IdenBuilder.createApply(
+      AI.getLoc(), ConcreteWMI, ConcreteWMI->getType().substGenericArgs(M, Subs),
+      AI.getType(), Subs, Args, cast<ApplyInst>(AI)->isNonThrowing());
+
+  // Create a PHInode for returning the return value from both apply
+  // instructions.
+  SILArgument *Arg = Continue->createArgument(AI.getType());
+  IdenBuilder.createBranch(AI.getLoc(), Continue,
+                           ArrayRef<SILValue>(IdenAI.getInstruction()));
+  VirtBuilder.createBranch(AI.getLoc(), Continue,
+                           ArrayRef<SILValue>(VirtAI.getInstruction()));
+
+  // Remove the old Apply instruction.
+  assert(AI.getInstruction() == &Continue->front() &&
+         "AI should be the first instruction in the split Continue block");
+  AI.getInstruction()->replaceAllUsesWith(Arg);
+  AI.getInstruction()->eraseFromParent();
+
+  // Update the stats.
+  NumTargetsPredicted++;
+
+  // Devirtualize the apply instruction on the identical path. If this is not
+  // possible, the witness_method on the concrete type is still correct.
+  auto NewInstPair = tryDevirtualizeWitnessMethod(IdenAI);
+  if (NewInstPair.first)
+    replaceDeadApply(IdenAI, NewInstPair.first);
+
+  return VirtAI;
+}
+
+/// Returns true if all types which may conform to \p Proto are visible in
+/// the current module.
+static bool areAllConformancesKnown(SILModule &M, ProtocolDecl *Proto) {
+  const DeclContext *DC = M.getAssociatedContext();
+  if (!DC || !Proto->isChildContextOf(DC))
+    return false;
+
+  if (!Proto->hasAccessibility())
+    return false;
+
+  switch (Proto->getEffectiveAccess()) {
+  case Accessibility::Open:
+  case Accessibility::Public:
+    return false;
+  case Accessibility::Internal:
+    return M.isWholeModule();
+  case Accessibility::FilePrivate:
+  case Accessibility::Private:
+    return true;
+  }
+
+  llvm_unreachable("Unhandled Accessibility in switch.");
+}
+
+/// \brief Try to speculate the call target for the witness_method call \p AI
+/// on an existential, by checking for each of the few types conforming to
+/// the protocol. This function returns true if a change was made.
+static bool tryToSpeculateWitnessTarget(FullApplySite AI,
+                                        ClassHierarchyAnalysis *CHA,
+                                        unsigned MaxTargets) {
+  // A try_apply would need its error edges split as in
+  // speculateMonomorphicTarget.
+  if (!isa<ApplyInst>(AI))
+    return false;
+
+  auto *WMI = cast<WitnessMethodInst>(AI.getCallee());
+  if (WMI->isVolatile())
+    return false;
+
+  // Only handle methods on the payload of an opaque existential. Calls on
+  // other archetypes are handled by generic specialization.
+  auto *OEA = dyn_cast<OpenExistentialAddrInst>(AI.getSelfArgument());
+  if (!OEA || OEA->getType().getSwiftRValueType() != WMI->getLookupType())
+    return false;
+
+  // Bail if the method itself is generic, or if anything but self refers to
+  // the opened type.
+  if (AI.getSubstitutions().size() != 1)
+    return false;
+  if (AI.getType().getSwiftRValueType()->hasOpenedExistential())
+    return false;
+  for (unsigned i = 0, e = AI.getNumArguments() - 1; i != e; ++i) {
+    if (AI.getArgument(i)->getType().getSwiftRValueType()
+          ->hasOpenedExistential())
+      return false;
+  }
+
+  SILModule &M = AI.getModule();
+  ProtocolDecl *Proto = WMI->getLookupProtocol();
+  if (Proto->requiresClass() || !areAllConformancesKnown(M, Proto))
+    return false;
+
+  auto &Impls = CHA->getProtocolImplementations(Proto);
+  if (Impls.empty() || Impls.size() > MaxTargets) {
+    DEBUG(llvm::dbgs() << "Protocol " << Proto->getName() << " has "
+                       << Impls.size() << " conforming types. Not inserting "
+                          "speculative calls.\n");
+    return false;
+  }
+
+  bool Changed = false;
+  for (NominalTypeDecl *NTD : Impls) {
+    // A class may have subclasses which use a different witness.
+    if (!isa<StructDecl>(NTD) && !isa<EnumDecl>(NTD))
+      continue;
+    if (NTD->isGenericContext())
+      continue;
+
+    CanType ConcreteTy = NTD->getDeclaredType()->getCanonicalType();
+    auto Conformance =
+        M.getSwiftModule()->lookupConformance(ConcreteTy, Proto, nullptr);
+    if (!Conformance || !Conformance->isConcrete())
+      continue;
+
+    SILFunction *Witness;
+    std::tie(Witness, std::ignore) =
+        M.lookUpFunctionInWitnessTable(*Conformance, WMI->getMember());
+    if (!Witness || !Witness->shouldOptimize())
+      continue;
+    if (AI.getFunction()->isFragile() &&
+        !Witness->hasValidLinkageForFragileRef())
+      continue;
+
+    DEBUG(llvm::dbgs() << "Inserting a speculative call for protocol "
+          << Proto->getName() << " and type " << NTD->getName() << "\n");
+
+    AI = speculateMonomorphicWitnessTarget(AI, OEA, ConcreteTy, *Conformance);
+    Changed = true;
+  }
+  return Changed;
+}
+
 namespace {
   /// Speculate the targets of virtual calls by assuming that the requested
   /// class is at the bottom of the class hierarchy.
@@ -538,22 +740,38 @@ namespace {
 
     void run() override {
       ClassHierarchyAnalysis *CHA = PM->getAnalysis<ClassHierarchyAnalysis>();
+      ColdBlockInfo CBI(PM->getAnalysis<DominanceAnalysis>());
 
       bool Changed = false;
 
-      // Collect virtual calls that may be specialized.
-      SmallVector<FullApplySite, 16> ToSpecialize;
+      // Collect virtual calls that may be specialized, together with the
+      // factor by which the number of speculated targets may be scaled.
+      SmallVector<std::pair<FullApplySite, unsigned>, 16> ToSpecialize;
       for (auto &BB : *getFunction()) {
+        // Speculative calls in blocks that never ran are just code size.
+        if (BB.isProfiledCold())
+          continue;
+        // Call sites that run more often than their function is entered are
+        // worth checking for more targets.
+        unsigned Scale = CBI.isProfiledHot(&BB) ? 2 : 1;
         for (auto II = BB.begin(), IE = BB.end(); II != IE; ++II) {
           FullApplySite AI = FullApplySite::isa(&*II);
-          if (AI && isa<ClassMethodInst>(AI.getCallee()))
-            ToSpecialize.push_back(AI);
+          if (AI && (isa<ClassMethodInst>(AI.getCallee()) ||
+                     isa<WitnessMethodInst>(AI.getCallee())))
+            ToSpecialize.push_back({AI, Scale});
         }
       }
 
       // Go over the collected calls and try to insert speculative calls.
-      for (auto AI : ToSpecialize)
-        Changed |= tryToSpeculateTarget(AI, CHA);
+      for (auto &Call : ToSpecialize) {
+        FullApplySite AI = Call.first;
+        if (isa<ClassMethodInst>(AI.getCallee()))
+          Changed |= tryToSpeculateTarget(
+              AI, CHA, Call.second * MaxNumSpeculativeTargets);
+        else
+          Changed |= tryToSpeculateWitnessTarget(
+              AI, CHA, Call.second * MaxNumSpeculativeWitnessTargets);
+      }
 
       if (Changed) {
         invalidateAnalysis(SILAnalysis::InvalidationKind::FunctionBody);
@@ -15,6 +15,7 @@
 #include "swift/SILOptimizer/PassManager/Transforms.h"
 #include "swift/SILOptimizer/Analysis/EscapeAnalysis.h"
 #include "swift/SILOptimizer/Analysis/DominanceAnalysis.h"
+#include "swift/SIL/OptimizationRemark.h"
 #include "swift/SIL/SILArgument.h"
 #include "swift/SIL/SILBuilder.h"
 #include "swift/SIL/CFG.h"
@@ -31,6 +32,8 @@ using namespace swift;
 /// It handles alloc_ref instructions of native swift classes: if promoted,
 /// the [stack] attribute is set in the alloc_ref and a dealloc_ref [stack] is
 /// inserted at the end of the object's lifetime.
+/// The same is done for partial_apply instructions of non-escaping closures,
+/// in which case the closure context is allocated on the stack.
 class StackPromoter {
 
   // Some analysis we need.
@@ -39,6 +42,7 @@ class StackPromoter {
   EscapeAnalysis::ConnectionGraph *ConGraph;
   DominanceInfo *DT;
   EscapeAnalysis *EA;
+  OptRemark::Emitter ORE;
 
   // We use our own post-dominator tree instead of PostDominatorAnalysis,
   // because we ignore unreachable blocks (actually all unreachable sub-graphs).
@@ -103,14 +107,14 @@ class StackPromoter {
   };
 
   /// Tries to promote the allocation \p AI.
-  bool tryPromoteAlloc(AllocRefInst *ARI);
+  bool tryPromoteAlloc(SILInstruction *AI);
 
   /// Returns true if the allocation \p AI can be promoted.
   /// In this case it sets the \a DeallocInsertionPoint to the instruction
   /// where the deallocation must be inserted.
   /// It optionally also sets \a AllocInsertionPoint in case the allocation
   /// instruction must be moved to another place.
-  bool canPromoteAlloc(AllocRefInst *ARI,
+  bool canPromoteAlloc(SILInstruction *AI,
                        SILInstruction *&AllocInsertionPoint,
                        SILInstruction *&DeallocInsertionPoint);
 
@@ -167,7 +171,8 @@ public:
 
   StackPromoter(SILFunction *F, EscapeAnalysis::ConnectionGraph *ConGraph,
                 DominanceInfo *DT, EscapeAnalysis *EA) :
-    F(F), ConGraph(ConGraph), DT(DT), EA(EA), PostDomTree(true),
+    F(F), ConGraph(ConGraph), DT(DT), EA(EA), ORE(DEBUG_TYPE, F->getModule()),
+    PostDomTree(true),
     PostDomTreeValid(false) { }
 
   SILFunction *getFunction() const { return F; }
@@ -213,42 +218,51 @@ bool StackPromoter::promote() {
       // The allocation instruction may be moved, so increment Iter prior to
       // doing the optimization.
       SILInstruction *I = &*Iter++;
-      if (auto *ARI = dyn_cast<AllocRefInst>(I)) {
-        Changed |= tryPromoteAlloc(ARI);
+      if (isa<AllocRefInst>(I) || isa<PartialApplyInst>(I)) {
+        Changed |= tryPromoteAlloc(I);
       }
     }
   }
   return Changed;
 }
 
-bool StackPromoter::tryPromoteAlloc(AllocRefInst *ARI) {
+bool StackPromoter::tryPromoteAlloc(SILInstruction *AI) {
   
   SILInstruction *AllocInsertionPoint = nullptr;
   SILInstruction *DeallocInsertionPoint = nullptr;
-  if (!canPromoteAlloc(ARI, AllocInsertionPoint, DeallocInsertionPoint))
+  if (!canPromoteAlloc(AI, AllocInsertionPoint, DeallocInsertionPoint))
     return false;
 
   if (AllocInsertionPoint) {
-    // Check if any operands of the alloc_ref prevents us from moving the
+    // Check if any operands of the allocation prevents us from moving the
     // instruction.
-    for (const Operand &Op : ARI->getAllOperands()) {
+    for (const Operand &Op : AI->getAllOperands()) {
       if (!DT->properlyDominates(Op.get(), AllocInsertionPoint))
         return false;
     }
   }
 
-  DEBUG(llvm::dbgs() << "Promoted " << *ARI);
-  DEBUG(llvm::dbgs() << "    in " << ARI->getFunction()->getName() << '\n');
+  DEBUG(llvm::dbgs() << "Promoted " << *AI);
+  DEBUG(llvm::dbgs() << "    in " << AI->getFunction()->getName() << '\n');
   NumStackPromoted++;
+  ORE.emit([&]() {
+    using namespace OptRemark;
+    return RemarkPassed("StackPromoted", *AI)
+           << "Allocated " << NV("Type", AI->getType()) << " on the stack";
+  });
 
   SILBuilder B(DeallocInsertionPoint);
-  // It's an object allocation. We set the [stack] attribute in the alloc_ref.
-  ARI->setStackAllocatable();
+  // It's an object or closure context allocation. We set the [stack]
+  // attribute in the alloc_ref or partial_apply.
+  if (auto *ARI = dyn_cast<AllocRefInst>(AI))
+    ARI->setStackAllocatable();
+  else
+    cast<PartialApplyInst>(AI)->setStackAllocatable();
   if (AllocInsertionPoint)
-    ARI->moveBefore(AllocInsertionPoint);
+    AI->moveBefore(AllocInsertionPoint);
 
   /// And create a dealloc_ref [stack] at the end of the object's lifetime.
-  B.createDeallocRef(ARI->getLoc(), ARI, true);
+  B.createDeallocRef(AI->getLoc(), AI, true);
   return true;
 }
 
@@ -334,21 +348,39 @@ template <> struct GraphTraits<StackPromoter *>
 
 }
 
-bool StackPromoter::canPromoteAlloc(AllocRefInst *ARI,
+bool StackPromoter::canPromoteAlloc(SILInstruction *AI,
                                     SILInstruction *&AllocInsertionPoint,
                                     SILInstruction *&DeallocInsertionPoint) {
-  if (ARI->isObjC() || ARI->canAllocOnStack())
-    return false;
+  if (auto *ARI = dyn_cast<AllocRefInst>(AI)) {
+    if (ARI->isObjC() || ARI->canAllocOnStack())
+      return false;
+  } else {
+    auto *PAI = cast<PartialApplyInst>(AI);
+    if (PAI->canAllocOnStack())
+      return false;
+    // The partial application of an Objective-C method doesn't have a Swift
+    // closure context.
+    if (auto *MI = dyn_cast<MethodInst>(PAI->getCallee()))
+      if (MI->getMember().isForeign)
+        return false;
+  }
 
   AllocInsertionPoint = nullptr;
   DeallocInsertionPoint = nullptr;
-  auto *Node = ConGraph->getNodeOrNull(ARI, EA);
+  auto *Node = ConGraph->getNodeOrNull(AI, EA);
   if (!Node)
     return false;
 
   // The most important check: does the object escape the current function?
-  if (Node->escapes())
+  if (Node->escapes()) {
+    ORE.emit([&]() {
+      using namespace OptRemark;
+      return RemarkMissed("Escapes", *AI)
+             << "Cannot allocate " << NV("Type", AI->getType())
+             << " on the stack because it escapes";
+    });
     return false;
+  }
 
   // Now we have to determine the lifetime of the allocated object in its
   // function.
@@ -367,7 +399,7 @@ bool StackPromoter::canPromoteAlloc(AllocRefInst *ARI,
   // Try to find the point where to insert the deallocation.
   // This might need more than one try in case we need to move the allocation
   // out of a stack-alloc-dealloc pair. See findDeallocPoint().
-  SILInstruction *StartInst = ARI;
+  SILInstruction *StartInst = AI;
   for (;;) {
     SILInstruction *RestartPoint = nullptr;
     DeallocInsertionPoint = findDeallocPoint(StartInst, RestartPoint, Node,
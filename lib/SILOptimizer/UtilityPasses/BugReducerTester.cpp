@@ -30,11 +30,38 @@ static llvm::cl::opt<std::string> FunctionTarget(
     llvm::cl::desc("Function that when called by an apply should cause "
                    "BugReducerTester to blow up if the pass visits the apply"));
 
+static llvm::cl::opt<bool> BreakReturns(
+    "bug-reducer-tester-break-returns",
+    llvm::cl::desc("Make BugReducerTester return an argument of the wrong "
+                   "type by rewriting the operand of existing returns"));
+
 namespace {
 
 class BugReducerTester : public SILFunctionTransform {
 
+  /// Produces invalid SIL without inserting, removing or moving any
+  /// instruction.
+  void breakReturns() {
+    SILFunction *F = getFunction();
+    if (F->empty())
+      return;
+    for (auto &BB : *F) {
+      auto *RI = dyn_cast<ReturnInst>(BB.getTerminator());
+      if (!RI)
+        continue;
+      for (SILArgument *Arg : F->begin()->getArguments()) {
+        if (Arg->getType() != RI->getOperand()->getType()) {
+          RI->setOperand(0, Arg);
+          invalidateAnalysis(SILAnalysis::InvalidationKind::Instructions);
+          break;
+        }
+      }
+    }
+  }
+
   void run() override {
+    if (BreakReturns)
+      breakReturns();
     if (FunctionTarget.empty())
       return;
     for (auto &BB : *getFunction()) {
@@ -11,6 +11,10 @@
 //===----------------------------------------------------------------------===//
 
 #include "swift/SILOptimizer/Utils/ConstantFolding.h"
+#include "swift/SIL/SILBuilder.h"
+#include "swift/SIL/SILFunction.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/IR/Intrinsics.h"
 
 using namespace swift;
 
@@ -116,3 +120,408 @@ APInt swift::constantFoldCast(APInt val, const BuiltinInfo &BI) {
       return val.sext(DestBitWidth);
   }
 }
+
+namespace {
+
+/// Evaluates the body of a global initializer, materializing every value it
+/// computes as a literal, struct or tuple instruction in a new block.
+class GlobalInitEvaluator {
+  /// Bound the work done for initializers which loop.
+  static const unsigned MaxSteps = 1024;
+
+  SILFunction *F;
+  SILBasicBlock *NewBB;
+  SILBuilderWithScope B;
+
+  /// The constant value of each value of the original body evaluated so far.
+  llvm::DenseMap<SILValue, SILValue> Values;
+  SILGlobalVariable *Global = nullptr;
+  GlobalAddrInst *GlobalAddr = nullptr;
+  bool HasStore = false;
+  unsigned NumSteps = 0;
+
+public:
+  GlobalInitEvaluator(SILFunction *F)
+      : F(F), NewBB(F->createBasicBlock()),
+        B(NewBB, &*F->front().begin()) {}
+
+  bool run();
+
+private:
+  SILValue lookup(SILValue V) const { return Values.lookup(V); }
+
+  IntegerLiteralInst *getIntLiteral(SILValue V) const {
+    return dyn_cast_or_null<IntegerLiteralInst>(lookup(V));
+  }
+
+  bool evaluate(SILInstruction *I);
+  SILValue evaluateBuiltin(BuiltinInst *BI);
+  SILBasicBlock *evaluateTerminator(TermInst *T, bool &Done);
+  bool bindArguments(SILBasicBlock *Dest, OperandValueArrayRef Args);
+  void finish(SILLocation Loc);
+};
+
+} // end anonymous namespace
+
+SILValue GlobalInitEvaluator::evaluateBuiltin(BuiltinInst *BI) {
+  SILLocation Loc = BI->getLoc();
+  OperandValueArrayRef Args = BI->getArguments();
+
+  if (BI->getIntrinsicInfo().ID == llvm::Intrinsic::expect)
+    return lookup(Args[0]);
+
+  const BuiltinInfo &Info = BI->getBuiltinInfo();
+  switch (Info.ID) {
+  default:
+    return SILValue();
+
+  case BuiltinValueKind::SAddOver:
+  case BuiltinValueKind::UAddOver:
+  case BuiltinValueKind::SSubOver:
+  case BuiltinValueKind::USubOver:
+  case BuiltinValueKind::SMulOver:
+  case BuiltinValueKind::UMulOver: {
+    auto *LHS = getIntLiteral(Args[0]);
+    auto *RHS = getIntLiteral(Args[1]);
+    if (!LHS || !RHS)
+      return SILValue();
+    bool Overflow;
+    APInt Res = constantFoldBinaryWithOverflow(
+        LHS->getValue(), RHS->getValue(), Overflow,
+        getLLVMIntrinsicIDForBuiltinWithOverflow(Info.ID));
+    // An overflow traps in the cond_fail which checks the second element.
+    SILType Ty = BI->getType();
+    SILValue Elts[] = {
+      B.createIntegerLiteral(Loc, Ty.getTupleElementType(0), Res),
+      B.createIntegerLiteral(Loc, Ty.getTupleElementType(1), Overflow)
+    };
+    return B.createTuple(Loc, Ty, Elts);
+  }
+
+  case BuiltinValueKind::Add:
+  case BuiltinValueKind::Sub:
+  case BuiltinValueKind::Mul: {
+    auto *LHS = getIntLiteral(Args[0]);
+    auto *RHS = getIntLiteral(Args[1]);
+    if (!LHS || !RHS)
+      return SILValue();
+    APInt Res = Info.ID == BuiltinValueKind::Add ? LHS->getValue() + RHS->getValue()
+              : Info.ID == BuiltinValueKind::Sub ? LHS->getValue() - RHS->getValue()
+              : LHS->getValue() * RHS->getValue();
+    return B.createIntegerLiteral(Loc, BI->getType(), Res);
+  }
+
+  case BuiltinValueKind::SDiv:
+  case BuiltinValueKind::SRem:
+  case BuiltinValueKind::UDiv:
+  case BuiltinValueKind::URem: {
+    auto *LHS = getIntLiteral(Args[0]);
+    auto *RHS = getIntLiteral(Args[1]);
+    if (!LHS || !RHS || RHS->getValue() == 0)
+      return SILValue();
+    bool Overflow;
+    APInt Res = constantFoldDiv(LHS->getValue(), RHS->getValue(), Overflow,
+                                Info.ID);
+    if (Overflow)
+      return SILValue();
+    return B.createIntegerLiteral(Loc, BI->getType(), Res);
+  }
+
+  case BuiltinValueKind::And:
+  case BuiltinValueKind::AShr:
+  case BuiltinValueKind::LShr:
+  case BuiltinValueKind::Or:
+  case BuiltinValueKind::Shl:
+  case BuiltinValueKind::Xor: {
+    auto *LHS = getIntLiteral(Args[0]);
+    auto *RHS = getIntLiteral(Args[1]);
+    if (!LHS || !RHS)
+      return SILValue();
+    bool IsShift = Info.ID == BuiltinValueKind::AShr ||
+                   Info.ID == BuiltinValueKind::LShr ||
+                   Info.ID == BuiltinValueKind::Shl;
+    if (IsShift &&
+        RHS->getValue().getZExtValue() >= LHS->getValue().getBitWidth())
+      return SILValue();
+    APInt Res = constantFoldBitOperation(LHS->getValue(), RHS->getValue(),
+                                         Info.ID);
+    return B.createIntegerLiteral(Loc, BI->getType(), Res);
+  }
+
+#define BUILTIN(id, name, Attrs)
+#define BUILTIN_BINARY_PREDICATE(id, name, attrs, overload) \
+  case BuiltinValueKind::id:
+#include "swift/AST/Builtins.def"
+  {
+    auto *LHS = getIntLiteral(Args[0]);
+    auto *RHS = getIntLiteral(Args[1]);
+    if (!LHS || !RHS)
+      return SILValue();
+    APInt Res = constantFoldComparison(LHS->getValue(), RHS->getValue(),
+                                       Info.ID);
+    return B.createIntegerLiteral(Loc, BI->getType(), Res);
+  }
+
+  case BuiltinValueKind::Trunc:
+  case BuiltinValueKind::TruncOrBitCast:
+  case BuiltinValueKind::ZExt:
+  case BuiltinValueKind::ZExtOrBitCast:
+  case BuiltinValueKind::SExt:
+  case BuiltinValueKind::SExtOrBitCast: {
+    auto *Val = getIntLiteral(Args[0]);
+    if (!Val)
+      return SILValue();
+    APInt Res = constantFoldCast(Val->getValue(), Info);
+    return B.createIntegerLiteral(Loc, BI->getType(), Res);
+  }
+
+  case BuiltinValueKind::FAdd:
+  case BuiltinValueKind::FSub:
+  case BuiltinValueKind::FMul:
+  case BuiltinValueKind::FDiv: {
+    auto *LHS = dyn_cast_or_null<FloatLiteralInst>(lookup(Args[0]));
+    auto *RHS = dyn_cast_or_null<FloatLiteralInst>(lookup(Args[1]));
+    if (!LHS || !RHS)
+      return SILValue();
+    APFloat Res = LHS->getValue();
+    switch (Info.ID) {
+    default: llvm_unreachable("Not all cases are covered!");
+    case BuiltinValueKind::FAdd:
+      Res.add(RHS->getValue(), APFloat::rmNearestTiesToEven);
+      break;
+    case BuiltinValueKind::FSub:
+      Res.subtract(RHS->getValue(), APFloat::rmNearestTiesToEven);
+      break;
+    case BuiltinValueKind::FMul:
+      Res.multiply(RHS->getValue(), APFloat::rmNearestTiesToEven);
+      break;
+    case BuiltinValueKind::FDiv:
+      Res.divide(RHS->getValue(), APFloat::rmNearestTiesToEven);
+      break;
+    }
+    return B.createFloatLiteral(Loc, BI->getType(), Res);
+  }
+
+  case BuiltinValueKind::FPTrunc: {
+    auto *Val = dyn_cast_or_null<FloatLiteralInst>(lookup(Args[0]));
+    if (!Val)
+      return SILValue();
+    auto DestTy = BI->getType().getAs<BuiltinFloatType>();
+    if (!DestTy)
+      return SILValue();
+    APFloat Res = Val->getValue();
+    bool LosesInfo;
+    Res.convert(DestTy->getAPFloatSemantics(), APFloat::rmNearestTiesToEven,
+                &LosesInfo);
+    return B.createFloatLiteral(Loc, BI->getType(), Res);
+  }
+  }
+}
+
+bool GlobalInitEvaluator::evaluate(SILInstruction *I) {
+  SILLocation Loc = I->getLoc();
+  SILValue Result;
+
+  switch (I->getKind()) {
+  default:
+    return false;
+
+  case ValueKind::DebugValueInst:
+    return true;
+
+  case ValueKind::IntegerLiteralInst:
+    Result = B.createIntegerLiteral(Loc, I->getType(),
+                                    cast<IntegerLiteralInst>(I)->getValue());
+    break;
+
+  case ValueKind::FloatLiteralInst:
+    Result = B.createFloatLiteral(Loc, I->getType(),
+                                  cast<FloatLiteralInst>(I)->getValue());
+    break;
+
+  case ValueKind::StringLiteralInst: {
+    auto *SLI = cast<StringLiteralInst>(I);
+    // Objective-C selector string literals cannot be used in static
+    // initializers.
+    if (SLI->getEncoding() == StringLiteralInst::Encoding::ObjCSelector)
+      return false;
+    Result = B.createStringLiteral(Loc, SLI->getValue(), SLI->getEncoding());
+    break;
+  }
+
+  case ValueKind::StructInst:
+  case ValueKind::TupleInst: {
+    SmallVector<SILValue, 8> Elts;
+    for (auto &Op : I->getAllOperands()) {
+      SILValue V = lookup(Op.get());
+      if (!V)
+        return false;
+      Elts.push_back(V);
+    }
+    if (isa<StructInst>(I))
+      Result = B.createStruct(Loc, I->getType(), Elts);
+    else
+      Result = B.createTuple(Loc, I->getType(), Elts);
+    break;
+  }
+
+  case ValueKind::StructExtractInst: {
+    auto *SEI = cast<StructExtractInst>(I);
+    auto *SI = dyn_cast_or_null<StructInst>(lookup(SEI->getOperand()));
+    if (!SI)
+      return false;
+    Result = SI->getFieldValue(SEI->getField());
+    break;
+  }
+
+  case ValueKind::TupleExtractInst: {
+    auto *TEI = cast<TupleExtractInst>(I);
+    auto *TI = dyn_cast_or_null<TupleInst>(lookup(TEI->getOperand()));
+    if (!TI)
+      return false;
+    Result = TI->getElement(TEI->getFieldNo());
+    break;
+  }
+
+  case ValueKind::BuiltinInst:
+    Result = evaluateBuiltin(cast<BuiltinInst>(I));
+    break;
+
+  case ValueKind::CondFailInst: {
+    // Give up on initializers which trap; they are diagnosed at runtime.
+    auto *Cond = getIntLiteral(cast<CondFailInst>(I)->getOperand());
+    return Cond && Cond->getValue() == 0;
+  }
+
+  case ValueKind::AllocGlobalInst:
+  case ValueKind::GlobalAddrInst: {
+    auto *G = isa<AllocGlobalInst>(I)
+                  ? cast<AllocGlobalInst>(I)->getReferencedGlobal()
+                  : cast<GlobalAddrInst>(I)->getReferencedGlobal();
+    if (Global && Global != G)
+      return false;
+    Global = G;
+    if (isa<AllocGlobalInst>(I))
+      return true;
+    if (!GlobalAddr)
+      GlobalAddr = B.createGlobalAddr(Loc, Global);
+    Result = GlobalAddr;
+    break;
+  }
+
+  case ValueKind::StoreInst: {
+    auto *SI = cast<StoreInst>(I);
+    SILValue Src = lookup(SI->getSrc());
+    if (HasStore || !GlobalAddr || lookup(SI->getDest()) != GlobalAddr ||
+        !Src || (!isa<StructInst>(Src) && !isa<TupleInst>(Src)))
+      return false;
+    B.createStore(Loc, Src, GlobalAddr, StoreOwnershipQualifier::Unqualified);
+    HasStore = true;
+    return true;
+  }
+  }
+
+  if (!Result)
+    return false;
+  Values[I] = Result;
+  return true;
+}
+
+bool GlobalInitEvaluator::bindArguments(SILBasicBlock *Dest,
+                                        OperandValueArrayRef Args) {
+  for (unsigned i = 0, e = Args.size(); i != e; ++i) {
+    SILValue V = lookup(Args[i]);
+    if (!V)
+      return false;
+    Values[Dest->getArgument(i)] = V;
+  }
+  return true;
+}
+
+SILBasicBlock *GlobalInitEvaluator::evaluateTerminator(TermInst *T,
+                                                       bool &Done) {
+  Done = false;
+  if (isa<ReturnInst>(T)) {
+    Done = true;
+    return nullptr;
+  }
+  if (auto *BI = dyn_cast<BranchInst>(T)) {
+    if (!bindArguments(BI->getDestBB(), BI->getArgs()))
+      return nullptr;
+    return BI->getDestBB();
+  }
+  if (auto *CBI = dyn_cast<CondBranchInst>(T)) {
+    auto *Cond = getIntLiteral(CBI->getCondition());
+    if (!Cond)
+      return nullptr;
+    bool IsTrue = Cond->getValue() != 0;
+    SILBasicBlock *Dest = IsTrue ? CBI->getTrueBB() : CBI->getFalseBB();
+    if (!bindArguments(Dest, IsTrue ? CBI->getTrueArgs()
+                                    : CBI->getFalseArgs()))
+      return nullptr;
+    return Dest;
+  }
+  return nullptr;
+}
+
+/// Replace the original body by the evaluated one.
+void GlobalInitEvaluator::finish(SILLocation Loc) {
+  B.createReturn(Loc, B.createTuple(Loc, ArrayRef<SILValue>()));
+
+  // Remove literals and aggregates which only fed into other evaluations.
+  for (auto It = NewBB->rbegin(); It != NewBB->rend();) {
+    SILInstruction *I = &*It++;
+    if (I->use_empty() && (isa<LiteralInst>(I) || isa<StructInst>(I) ||
+                           isa<TupleInst>(I)))
+      I->eraseFromParent();
+  }
+
+  SmallVector<SILBasicBlock *, 8> OldBlocks;
+  for (auto &BB : *F)
+    if (&BB != NewBB)
+      OldBlocks.push_back(&BB);
+  for (auto *BB : OldBlocks)
+    BB->dropAllReferences();
+  for (auto *BB : OldBlocks)
+    BB->eraseFromParent();
+}
+
+bool GlobalInitEvaluator::run() {
+  SILBasicBlock *BB = &F->front();
+  while (true) {
+    for (auto &I : *BB) {
+      if (++NumSteps > MaxSteps)
+        return false;
+      if (auto *T = dyn_cast<TermInst>(&I)) {
+        bool Done;
+        BB = evaluateTerminator(T, Done);
+        if (Done) {
+          if (!HasStore)
+            return false;
+          finish(T->getLoc());
+          return true;
+        }
+        if (!BB)
+          return false;
+        break;
+      }
+      if (!evaluate(&I))
+        return false;
+    }
+  }
+}
+
+bool swift::evaluateGlobalInitializer(SILFunction *InitF) {
+  if (InitF->empty() || !InitF->front().args_empty())
+    return false;
+
+  GlobalInitEvaluator Evaluator(InitF);
+  if (Evaluator.run())
+    return true;
+
+  // Throw away the partially evaluated block.
+  SILBasicBlock *NewBB = &InitF->back();
+  NewBB->dropAllReferences();
+  NewBB->eraseFromParent();
+  return false;
+}
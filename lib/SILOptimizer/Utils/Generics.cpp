@@ -659,8 +659,19 @@ static bool linkSpecialization(SILModule &M, SILFunction *F) {
 // whose specializations we want to preserve.
 static const char *const WhitelistedSpecializations[] = {
     "Array",
+    "ArraySlice",
+    "ContiguousArray",
     "_ArrayBuffer",
     "_ContiguousArrayBuffer",
+    "_SliceBuffer",
+    "Dictionary",
+    "DictionaryIterator",
+    "_NativeDictionaryBuffer",
+    "_VariantDictionaryBuffer",
+    "Set",
+    "SetIterator",
+    "_NativeSetBuffer",
+    "_VariantSetBuffer",
     "Range",
     "RangeIterator",
     "CountableRange",
@@ -670,6 +681,7 @@ static const char *const WhitelistedSpecializations[] = {
     "CountableClosedRange",
     "CountableClosedRangeIterator",
     "IndexingIterator",
+    "Sequence",
     "Collection",
     "MutableCollection",
     "BidirectionalCollection",
@@ -72,10 +72,10 @@ swift::createDecrementBefore(SILValue Ptr, SILInstruction *InsertPt) {
 /// This routine only examines the state of the instruction at hand.
 bool
 swift::isInstructionTriviallyDead(SILInstruction *I) {
-  // At Onone, consider all uses, including the debug_info.
-  // This way, debug_info is preserved at Onone.
+  // At Onone and Odebug, consider all uses, including the debug_info.
+  // This way, debug_info is preserved at Onone and Odebug.
   if (!I->use_empty() &&
-      I->getModule().getOptions().Optimization <= SILOptions::SILOptMode::None)
+      I->getModule().getOptions().Optimization <= SILOptions::SILOptMode::Debug)
     return false;
 
   if (!onlyHaveDebugUses(I) || isa<TermInst>(I))
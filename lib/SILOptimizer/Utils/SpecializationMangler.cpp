@@ -27,20 +27,21 @@ void SpecializationMangler::beginMangling() {
 
 std::string SpecializationMangler::finalize() {
   std::string MangledSpecialization = ASTMangler::finalize();
-  Demangler D(MangledSpecialization);
+  NodeFactory Factory;
+  Demangler D(MangledSpecialization, Factory);
   NodePointer TopLevel = D.demangleTopLevel();
 
   StringRef FuncName = Function->getName();
-  NodePointer FuncTopLevel;
+  NodePointer FuncTopLevel = nullptr;
   if (FuncName.startswith(MANGLING_PREFIX_STR)) {
-    FuncTopLevel = Demangler(FuncName).demangleTopLevel();
+    FuncTopLevel = Demangler(FuncName, Factory).demangleTopLevel();
     assert(FuncTopLevel);
   } else if (FuncName.startswith("_T")) {
-    FuncTopLevel = demangleSymbolAsNode(FuncName.data(), FuncName.size());
+    FuncTopLevel = demangleSymbolAsNode(FuncName, Factory);
   }
   if (!FuncTopLevel) {
-    FuncTopLevel = NodeFactory::create(Node::Kind::Global);
-    FuncTopLevel->addChild(NodeFactory::create(Node::Kind::Identifier, FuncName));
+    FuncTopLevel = Factory.create(Node::Kind::Global);
+    FuncTopLevel->addChild(Factory.create(Node::Kind::Identifier, FuncName));
   }
   for (NodePointer FuncChild : *FuncTopLevel) {
     assert(FuncChild->getKind() != Node::Kind::Suffix ||
@@ -852,6 +852,130 @@ namespace {
     }
   }
   
+  /// Retrieve the parameter and result types of the binary operator
+  /// \p value, or null types if it does not take two parameters.
+  TypeChecker::BinaryOperatorSignature
+  getBinaryOperatorSignature(ConstraintSystem &CS, ValueDecl *value) {
+    auto &cache = CS.getTypeChecker().BinaryOperatorSignatures;
+    auto known = cache.find(value);
+    if (known != cache.end())
+      return known->second;
+
+    TypeChecker::BinaryOperatorSignature signature;
+    auto valueTy = value->getInterfaceType();
+    if (!valueTy)
+      return signature;
+
+    auto fnTy = valueTy->getAs<AnyFunctionType>();
+    if (fnTy && value->getDeclContext()->isTypeContext())
+      fnTy = fnTy->getResult()->getAs<AnyFunctionType>();
+
+    if (fnTy) {
+      Type paramTy = ArchetypeBuilder::mapTypeIntoContext(
+          value->getInnermostDeclContext(), fnTy->getInput());
+      auto paramTupleTy = paramTy->getAs<TupleType>();
+      if (paramTupleTy && paramTupleTy->getNumElements() == 2) {
+        signature.FirstParam = paramTupleTy->getElement(0).getType();
+        signature.SecondParam = paramTupleTy->getElement(1).getType();
+        signature.Result = ArchetypeBuilder::mapTypeIntoContext(
+            value->getInnermostDeclContext(), fnTy->getResult());
+      }
+    }
+
+    cache[value] = signature;
+    return signature;
+  }
+
+  /// Determine whether an argument of type \p argTy can never be passed to
+  /// a parameter of type \p paramTy.
+  ///
+  /// This only considers concrete, non-generic structs and enums, which
+  /// cannot be implicitly converted to one another except to AnyHashable.
+  bool isUnmatchableParamAndArg(ConstraintSystem &CS, Type paramTy,
+                                Type argTy) {
+    argTy = argTy->getLValueOrInOutObjectType();
+    if (paramTy->is<InOutType>() || paramTy->hasArchetype() ||
+        argTy->hasTypeVariable() || argTy->hasArchetype())
+      return false;
+
+    auto isConcreteValueType = [](Type type) -> NominalTypeDecl * {
+      auto nominalTy = type->getAs<NominalType>();
+      if (!nominalTy)
+        return nullptr;
+      auto decl = nominalTy->getDecl();
+      if (!isa<StructDecl>(decl) && !isa<EnumDecl>(decl))
+        return nullptr;
+      return decl;
+    };
+
+    auto paramDecl = isConcreteValueType(paramTy);
+    auto argDecl = isConcreteValueType(argTy);
+    if (!paramDecl || !argDecl || paramDecl == argDecl)
+      return false;
+
+    return paramDecl != CS.getASTContext().getAnyHashableDecl();
+  }
+
+  /// Drop binary operator overloads that cannot accept the concrete operand
+  /// types of \p expr from its overload disjunction, so the solver doesn't
+  /// have to attempt them one by one.
+  ///
+  /// The disjunction is left as it is if nothing would remain, so that
+  /// diagnostics still see every candidate.
+  void pruneBinaryOperatorOverloads(ApplyExpr *expr, ConstraintSystem &CS) {
+    auto fnTy = CS.getType(expr->getFn())->getAs<TypeVariableType>();
+    if (!fnTy)
+      return;
+
+    auto argTupleTy = CS.getType(expr->getArg())->getAs<TupleType>();
+    if (!argTupleTy || argTupleTy->getNumElements() != 2)
+      return;
+
+    Type firstArgTy = argTupleTy->getElement(0).getType()->getWithoutParens();
+    Type secondArgTy = argTupleTy->getElement(1).getType()->getWithoutParens();
+    if (firstArgTy->hasTypeVariable() && secondArgTy->hasTypeVariable())
+      return;
+
+    SmallVector<Constraint *, 4> constraints;
+    CS.getConstraintGraph().gatherConstraints(fnTy, constraints);
+
+    for (auto constraint : constraints) {
+      if (constraint->getKind() != ConstraintKind::Disjunction)
+        continue;
+
+      auto oldConstraints = constraint->getNestedConstraints();
+      if (oldConstraints[0]->getKind() != ConstraintKind::BindOverload)
+        continue;
+
+      SmallVector<Constraint *, 4> viableConstraints;
+      for (auto oldConstraint : oldConstraints) {
+        if (oldConstraint->getKind() == ConstraintKind::BindOverload &&
+            oldConstraint->getOverloadChoice().isDecl()) {
+          auto signature = getBinaryOperatorSignature(
+              CS, oldConstraint->getOverloadChoice().getDecl());
+          if (signature.FirstParam &&
+              (isUnmatchableParamAndArg(CS, signature.FirstParam,
+                                        firstArgTy) ||
+               isUnmatchableParamAndArg(CS, signature.SecondParam,
+                                        secondArgTy)))
+            continue;
+        }
+        viableConstraints.push_back(oldConstraint);
+      }
+
+      if (viableConstraints.empty() ||
+          viableConstraints.size() == oldConstraints.size())
+        break;
+
+      CS.removeInactiveConstraint(constraint);
+      CS.addDisjunctionConstraint(
+          viableConstraints, constraint->getLocator(),
+          RememberChoice_t(constraint->shouldRememberChoice()),
+          constraint->isFavored());
+      break;
+    }
+  }
+
   /// Favor binary operator constraints where we have exact matches
   /// for the operands and contextual type.
   void favorMatchingBinaryOperators(ApplyExpr *expr,
@@ -913,22 +1037,13 @@ namespace {
         }
       }
       
-      // Figure out the parameter type.
-      if (value->getDeclContext()->isTypeContext()) {
-        fnTy = fnTy->getResult()->castTo<AnyFunctionType>();
-      }
-      
-      Type paramTy = ArchetypeBuilder::mapTypeIntoContext(
-          value->getInnermostDeclContext(), fnTy->getInput());
-      auto paramTupleTy = paramTy->getAs<TupleType>();
-      if (!paramTupleTy || paramTupleTy->getNumElements() != 2)
+      auto signature = getBinaryOperatorSignature(CS, value);
+      if (!signature.FirstParam)
         return false;
       
-      auto firstParamTy = paramTupleTy->getElement(0).getType();
-      auto secondParamTy = paramTupleTy->getElement(1).getType();
-      
-      auto resultTy = ArchetypeBuilder::mapTypeIntoContext(
-          value->getInnermostDeclContext(), fnTy->getResult());
+      auto firstParamTy = signature.FirstParam;
+      auto secondParamTy = signature.SecondParam;
+      auto resultTy = signature.Result;
       auto contextualTy = CS.getContextualType(expr);
       
       return
@@ -958,6 +1073,7 @@ namespace {
             isa<PostfixUnaryExpr>(applyExpr)) {
           favorMatchingUnaryOperators(applyExpr, CS);
         } else if (isa<BinaryExpr>(applyExpr)) {
+          pruneBinaryOperatorOverloads(applyExpr, CS);
           favorMatchingBinaryOperators(applyExpr, CS);
         } else {
           favorMatchingOverloadExprs(applyExpr, CS);
@@ -16,6 +16,8 @@
 #include "ConstraintSystem.h"
 #include "ConstraintGraph.h"
 #include "swift/AST/TypeWalker.h"
+#include "swift/Basic/Statistic.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/SaveAndRestore.h"
@@ -426,6 +428,7 @@ ConstraintSystem::SolverState::SolverState(ConstraintSystem &cs) : CS(cs) {
   // turn on debugging now.
   ASTContext &ctx = CS.getTypeChecker().Context;
   LangOptions &langOpts = ctx.LangOpts;
+  MemoryThreshold = langOpts.SolverMemoryThreshold;
   OldDebugConstraintSolver = langOpts.DebugConstraintSolver;
   if (langOpts.DebugConstraintSolverAttempt &&
       langOpts.DebugConstraintSolverAttempt == SolutionAttempt) {
@@ -466,6 +469,8 @@ ConstraintSystem::SolverScope::SolverScope(ConstraintSystem &cs)
   : cs(cs), CGScope(cs.CG)
 {
   ++cs.solverState->depth;
+  if (auto *Stats = cs.getASTContext().Stats)
+    ++Stats->getFrontendCounters().NumConstraintScopes;
 
   resolvedOverloadSets = cs.resolvedOverloadSets;
   numTypeVariables = cs.TypeVariables.size();
@@ -1250,8 +1255,7 @@ static bool tryTypeVariableBindings(
   // If the solver has allocated an excessive amount of memory when solving for
   // this expression, short-circuit the binding operation and mark the parent
   // expression as "too complex".
-  if (cs.TC.Context.getSolverMemory() >
-        cs.TC.Context.LangOpts.SolverMemoryThreshold) {
+  if (cs.TC.Context.getSolverMemory() > cs.solverState->MemoryThreshold) {
     cs.setExpressionTooComplex(true);
     return true;
   }
@@ -1355,6 +1359,9 @@ static bool tryTypeVariableBindings(
         auto &log = cs.getASTContext().TypeCheckerDebug->getStream();
         log.indent(depth * 2) << ")\n";
       }
+
+      if (anySolved && cs.solverState->Greedy)
+        break;
     }
 
     // If we found any solution, we're done.
@@ -1910,13 +1917,54 @@ ConstraintSystem::solve(Expr *&expr,
   return solutions.empty() ? SolutionKind::Unsolved : SolutionKind::Solved;
 }
 
+/// Record the cost of solving one constraint system in the frontend stats.
+static void recordSolverStatistics(ConstraintSystem &cs, unsigned numStates) {
+  auto *stats = cs.getASTContext().Stats;
+  if (!stats)
+    return;
+
+  auto &counters = stats->getFrontendCounters();
+  ++counters.NumConstraintSystemsSolved;
+  counters.NumConstraintSolverStatesExplored += numStates;
+  if (numStates > counters.MaxConstraintSolverStatesPerSystem)
+    counters.MaxConstraintSolverStatesPerSystem = numStates;
+}
+
 bool ConstraintSystem::solve(SmallVectorImpl<Solution> &solutions,
                              FreeTypeVariableBinding allowFreeTypeVariables) {
-  // Set up solver state.
-  SolverState state(*this);
+  {
+    // Set up solver state.
+    SolverState state(*this);
 
-  // Solve the system.
-  solveRec(solutions, allowFreeTypeVariables);
+    // Solve the system.
+    solveRec(solutions, allowFreeTypeVariables);
+    recordSolverStatistics(*this, state.NumStatesExplored);
+  }
+
+  // If the exhaustive search gave up because the expression is too complex,
+  // make one last greedy attempt that takes the first choice leading to a
+  // solution at every step, with a quarter of the usual memory budget on top
+  // of what has been used so far.
+  if (solutions.empty() && getExpressionTooComplex()) {
+    setExpressionTooComplex(false);
+
+    SolverState state(*this);
+    state.Greedy = true;
+    state.MemoryThreshold = TC.Context.getSolverMemory() +
+                            TC.getLangOpts().SolverMemoryThreshold / 4;
+    solveRec(solutions, allowFreeTypeVariables);
+    recordSolverStatistics(*this, state.NumStatesExplored);
+
+    if (auto *stats = getASTContext().Stats) {
+      if (solutions.empty())
+        ++stats->getFrontendCounters().NumExpressionsTooComplex;
+      else
+        ++stats->getFrontendCounters().NumExpressionsSolvedGreedily;
+    }
+
+    if (solutions.empty())
+      setExpressionTooComplex(true);
+  }
 
   // If there is more than one viable system, attempt to pick the best
   // solution.
@@ -1933,10 +1981,79 @@ bool ConstraintSystem::solve(SmallVectorImpl<Solution> &solutions,
   return solutions.empty();
 }
 
+void ConstraintSystem::getSolverStateKey(
+    FreeTypeVariableBinding allowFreeTypeVariables,
+    SmallVectorImpl<char> &key) {
+  auto append = [&](uintptr_t value) {
+    auto bytes = reinterpret_cast<const char *>(&value);
+    key.append(bytes, bytes + sizeof(value));
+  };
+  auto appendScore = [&](const Score &score) {
+    for (unsigned i = 0; i != NumScoreKinds; ++i)
+      append(score.Data[i]);
+  };
+
+  append(static_cast<uintptr_t>(allowFreeTypeVariables));
+
+  // Failing to beat the best solution counts as failure, so the scores are
+  // part of the state. The best score is restored after solving connected
+  // components separately, so it can get worse as well as better.
+  appendScore(CurrentScore);
+  append(solverState->BestScore.hasValue());
+  if (solverState->BestScore)
+    appendScore(*solverState->BestScore);
+
+  // The order of the constraints matters, since it drives which disjunction
+  // gets attempted next.
+  append(ActiveConstraints.size());
+  for (auto &constraint : ActiveConstraints)
+    append(reinterpret_cast<uintptr_t>(&constraint));
+  append(InactiveConstraints.size());
+  for (auto &constraint : InactiveConstraints)
+    append(reinterpret_cast<uintptr_t>(&constraint));
+
+  // Types are uniqued, so fixed types can be compared by identity.
+  append(TypeVariables.size());
+  for (auto *typeVar : TypeVariables) {
+    append(reinterpret_cast<uintptr_t>(typeVar));
+    append(reinterpret_cast<uintptr_t>(getRepresentative(typeVar)));
+    append(reinterpret_cast<uintptr_t>(
+               getFixedType(typeVar).getPointer()));
+  }
+}
+
 bool ConstraintSystem::solveRec(SmallVectorImpl<Solution> &solutions,
                                 FreeTypeVariableBinding allowFreeTypeVariables){
-  // If we already failed, or simplification fails, we're done.
-  if (failedConstraint || simplify()) {
+  // If we already failed, we're done.
+  if (failedConstraint)
+    return true;
+
+  // If we've already been here and failed, don't bother trying again.
+  SmallString<256> stateKey;
+  getSolverStateKey(allowFreeTypeVariables, stateKey);
+  if (solverState->FailedStates.count(stateKey)) {
+    ++solverState->NumFailedStatesSkipped;
+    if (TC.getLangOpts().DebugConstraintSolver) {
+      auto &log = getASTContext().TypeCheckerDebug->getStream();
+      log.indent(solverState->depth * 2) << "(skipping known failure)\n";
+    }
+    return true;
+  }
+
+  bool failed = solveRecImpl(solutions, allowFreeTypeVariables);
+
+  // Don't record anything if we bailed out because the expression is too
+  // complex; that's not a property of this state.
+  if (failed && !getExpressionTooComplex())
+    solverState->FailedStates.insert(stateKey);
+  return failed;
+}
+
+bool
+ConstraintSystem::solveRecImpl(SmallVectorImpl<Solution> &solutions,
+                               FreeTypeVariableBinding allowFreeTypeVariables) {
+  // If simplification fails, we're done.
+  if (simplify()) {
     return true;
   } else {
     assert(ActiveConstraints.empty() && "Active constraints remain?");
@@ -2028,6 +2145,20 @@ bool ConstraintSystem::solveRec(SmallVectorImpl<Solution> &solutions,
     }
   };
 
+  // Partition the type variables by component up front, remembering their
+  // positions so each component sees them in their original order. Type
+  // variables without a component are visible to every component.
+  std::unique_ptr<SmallVector<unsigned, 4>[]>
+    typeVarBuckets(new SmallVector<unsigned, 4>[numComponents]);
+  SmallVector<unsigned, 8> sharedTypeVars;
+  for (unsigned i = 0, n = TypeVariables.size(); i != n; ++i) {
+    auto known = typeVarComponent.find(TypeVariables[i]);
+    if (known == typeVarComponent.end())
+      sharedTypeVars.push_back(i);
+    else
+      typeVarBuckets[known->second].push_back(i);
+  }
+
   // Compute the partial solutions produced for each connected component.
   std::unique_ptr<SmallVector<Solution, 4>[]> 
     partialSolutions(new SmallVector<Solution, 4>[numComponents]);
@@ -2048,12 +2179,17 @@ bool ConstraintSystem::solveRec(SmallVectorImpl<Solution> &solutions,
     // substituted all of those other type variables through.
     llvm::SmallVector<TypeVariableType *, 16> allTypeVariables 
       = std::move(TypeVariables);
-    for (auto typeVar : allTypeVariables) {
-      auto known = typeVarComponent.find(typeVar);
-      if (known != typeVarComponent.end() && known->second != component)
-        continue;
-
-      TypeVariables.push_back(typeVar);
+    TypeVariables.clear();
+    {
+      auto &bucket = typeVarBuckets[component];
+      auto next = bucket.begin(), nextEnd = bucket.end();
+      auto shared = sharedTypeVars.begin(), sharedEnd = sharedTypeVars.end();
+      while (next != nextEnd || shared != sharedEnd) {
+        if (shared == sharedEnd || (next != nextEnd && *next < *shared))
+          TypeVariables.push_back(allTypeVariables[*next++]);
+        else
+          TypeVariables.push_back(allTypeVariables[*shared++]);
+      }
     }
     
     // Solve for this component. If it fails, we're done.
@@ -2108,26 +2244,28 @@ bool ConstraintSystem::solveRec(SmallVectorImpl<Solution> &solutions,
 
     // Restore the previous best score.
     solverState->BestScore = PreviousBestScore;
+
+    // When there are multiple partial solutions for this component, rank
+    // them right away to pick the best ones. This limits the number of
+    // combinations we need to produce; in the common case, down to a single
+    // combination. Doing it now rather than after every component has been
+    // solved keeps only the surviving solutions alive.
+    auto &componentSolutions = partialSolutions[component];
+    if (componentSolutions.size() > 1) {
+      // If there's a single best solution, keep only that one.
+      // Otherwise, the set of solutions will at least have been minimized.
+      if (auto best = findBestSolution(componentSolutions, /*minimize=*/true)) {
+        if (*best > 0)
+          componentSolutions[0] = std::move(componentSolutions[*best]);
+        componentSolutions.erase(componentSolutions.begin() + 1,
+                                 componentSolutions.end());
+      }
+    }
   }
 
   // Move the constraints back. The system is back in a normal state.
   returnAllConstraints();
 
-  // When there are multiple partial solutions for a given connected component,
-  // rank those solutions to pick the best ones. This limits the number of
-  // combinations we need to produce; in the common case, down to a single
-  // combination.
-  for (unsigned component = 0; component != numComponents; ++component) {
-    auto &solutions = partialSolutions[component];
-    // If there's a single best solution, keep only that one.
-    // Otherwise, the set of solutions will at least have been minimized.
-    if (auto best = findBestSolution(solutions, /*minimize=*/true)) {
-      if (*best > 0)
-        solutions[0] = std::move(solutions[*best]);
-      solutions.erase(solutions.begin() + 1, solutions.end());
-    }
-  }
-
   // Produce all combinations of partial solutions.
   SmallVector<unsigned, 2> indices(numComponents, 0);
   bool done = false;
@@ -2365,7 +2503,8 @@ bool ConstraintSystem::solveSimplified(
     // We already have a solution; check whether we should
     // short-circuit the disjunction.
     if (firstSolvedConstraint &&
-        shortCircuitDisjunctionAt(constraint, firstSolvedConstraint))
+        (solverState->Greedy ||
+         shortCircuitDisjunctionAt(constraint, firstSolvedConstraint)))
       break;
     
     // If the expression was deemed "too complex", stop now and salvage.
@@ -34,6 +34,7 @@
 #include "llvm/ADT/ilist.h"
 #include "llvm/ADT/PointerUnion.h"
 #include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cstddef>
@@ -1029,6 +1030,25 @@ private:
     /// Refers to the innermost partial solution scope.
     SolverScope *PartialSolutionScope = nullptr;
 
+    /// The amount of solver arena memory past which the expression is
+    /// considered too complex.
+    size_t MemoryThreshold;
+
+    /// Whether to stop exploring a disjunction or a set of bindings as soon
+    /// as one choice leads to a solution, rather than looking for a better
+    /// one.
+    ///
+    /// Only used for a last, bounded attempt at expressions that were too
+    /// complex to solve exhaustively.
+    bool Greedy = false;
+
+    /// The keys of the states from which \c solveRec has already failed to
+    /// find a solution, so that an identical sub-problem reached again after
+    /// backtracking into a sibling choice isn't explored twice.
+    ///
+    /// \sa ConstraintSystem::getSolverStateKey
+    llvm::StringSet<> FailedStates;
+
     // Statistics
     #define CS_STATISTIC(Name, Description) unsigned Name = 0;
     #include "ConstraintSolverStats.def"
@@ -2302,6 +2322,20 @@ private:
   bool solveRec(SmallVectorImpl<Solution> &solutions,
              FreeTypeVariableBinding allowFreeTypeVariables);
 
+  /// \brief The body of \c solveRec, which is responsible for remembering
+  /// which states are known to fail.
+  bool solveRecImpl(SmallVectorImpl<Solution> &solutions,
+                    FreeTypeVariableBinding allowFreeTypeVariables);
+
+  /// \brief Compute a key that identifies the sub-problem the solver is
+  /// currently looking at.
+  ///
+  /// Two states with the same key have the same outstanding constraints,
+  /// the same type variable bindings, and the same current and best scores,
+  /// so solving from either of them has the same outcome.
+  void getSolverStateKey(FreeTypeVariableBinding allowFreeTypeVariables,
+                         SmallVectorImpl<char> &key);
+
   /// \brief Solve the system of constraints.
   ///
   /// \param allowFreeTypeVariables How to bind free type variables in
@@ -133,52 +133,71 @@ static void deriveBodyEquatable_enum_eq(AbstractFunctionDecl *eqDecl) {
   auto aParam = args->get(0);
   auto bParam = args->get(1);
 
-  CanType boolTy = C.getBoolDecl()->getDeclaredType().getCanonicalTypeOrNull();
+  Type enumType = aParam->getType();
+  auto enumDecl = cast<EnumDecl>(enumType->getAnyNominal());
 
-  auto enumDecl = cast<EnumDecl>(aParam->getType()->getAnyNominal());
+  // Match both operands in a single switch rather than converting each of
+  // them to an integer index first. This keeps the body to one expression
+  // per case for the type checker and avoids the index variables in SIL.
+  SmallVector<CaseStmt*, 4> cases;
+  for (auto elt : enumDecl->getAllElements()) {
+    // generate: case (.<Case>, .<Case>):
+    auto makeEltPattern = [&]() -> Pattern * {
+      auto pat = new (C) EnumElementPattern(TypeLoc::withoutLoc(enumType),
+                                            SourceLoc(), SourceLoc(),
+                                            Identifier(), elt, nullptr);
+      pat->setImplicit();
+      return pat;
+    };
+    TuplePatternElt tupleElts[] = {
+      TuplePatternElt(makeEltPattern()),
+      TuplePatternElt(makeEltPattern())
+    };
+    auto pat = TuplePattern::create(C, SourceLoc(), tupleElts, SourceLoc(),
+                                    /*implicit*/ true);
 
-  // Generate the conversion from the enums to integer indices.
-  SmallVector<ASTNode, 6> statements;
-  DeclRefExpr *aIndex = convertEnumToIndex(statements, parentDC, enumDecl,
-                                           aParam, eqDecl, "index_a");
-  DeclRefExpr *bIndex = convertEnumToIndex(statements, parentDC, enumDecl,
-                                           bParam, eqDecl, "index_b");
-  
-  // Generate the compare of the indices.
-  FuncDecl *cmpFunc = C.getEqualIntDecl();
-  assert(cmpFunc && "should have a == for int as we already checked for it");
-  
-  auto fnType = cast<FunctionType>(cmpFunc->getInterfaceType()
-      ->getCanonicalType());
-
-  Expr *cmpFuncExpr;
-  if (cmpFunc->getDeclContext()->isTypeContext()) {
-    auto contextTy = cmpFunc->getDeclContext()->getSelfInterfaceType();
-    Expr *base = TypeExpr::createImplicitHack(SourceLoc(), contextTy, C);
-    Expr *ref = new (C) DeclRefExpr(cmpFunc, DeclNameLoc(), /*Implicit*/ true,
-                                    AccessSemantics::Ordinary, fnType);
-
-    fnType = cast<FunctionType>(fnType.getResult());
-    cmpFuncExpr = new (C) DotSyntaxCallExpr(ref, SourceLoc(), base, fnType);
-    cmpFuncExpr->setImplicit();
-  } else {
-    cmpFuncExpr = new (C) DeclRefExpr(cmpFunc, DeclNameLoc(),
-                                      /*implicit*/ true,
-                                      AccessSemantics::Ordinary,
-                                      fnType);
-  }
+    auto labelItem = CaseLabelItem(/*IsDefault=*/false, pat, SourceLoc(),
+                                   nullptr);
 
-  auto tType = fnType.getInput();
-  TupleExpr *abTuple = TupleExpr::create(C, SourceLoc(), { aIndex, bIndex },
-                                         { }, { }, SourceLoc(),
-                                         /*HasTrailingClosure*/ false,
-                                         /*Implicit*/ true, tType);
+    // generate: return true
+    auto trueExpr = new (C) BooleanLiteralExpr(true, SourceLoc(),
+                                               /*implicit*/ true);
+    auto body = BraceStmt::create(C, SourceLoc(),
+                                  ASTNode(new (C) ReturnStmt(SourceLoc(),
+                                                             trueExpr)),
+                                  SourceLoc());
+    cases.push_back(CaseStmt::create(C, SourceLoc(), labelItem,
+                                     /*HasBoundDecls=*/false,
+                                     SourceLoc(), body));
+  }
 
-  auto *cmpExpr = new (C) BinaryExpr(cmpFuncExpr, abTuple, /*implicit*/ true,
-                                     boolTy);
-  statements.push_back(new (C) ReturnStmt(SourceLoc(), cmpExpr));
+  // generate: default: return false
+  auto anyPat = new (C) AnyPattern(SourceLoc());
+  anyPat->setImplicit();
+  auto dfltLabelItem = CaseLabelItem(/*IsDefault=*/true, anyPat, SourceLoc(),
+                                     nullptr);
+  auto falseExpr = new (C) BooleanLiteralExpr(false, SourceLoc(),
+                                              /*implicit*/ true);
+  auto dfltBody = BraceStmt::create(C, SourceLoc(),
+                                    ASTNode(new (C) ReturnStmt(SourceLoc(),
+                                                               falseExpr)),
+                                    SourceLoc());
+  cases.push_back(CaseStmt::create(C, SourceLoc(), dfltLabelItem,
+                                   /*HasBoundDecls=*/false,
+                                   SourceLoc(), dfltBody));
+
+  // generate: switch (a, b) { }
+  auto aRef = new (C) DeclRefExpr(aParam, DeclNameLoc(), /*implicit*/ true);
+  auto bRef = new (C) DeclRefExpr(bParam, DeclNameLoc(), /*implicit*/ true);
+  auto abExpr = TupleExpr::create(C, SourceLoc(), { aRef, bRef },
+                                  { }, { }, SourceLoc(),
+                                  /*HasTrailingClosure*/ false,
+                                  /*Implicit*/ true);
+  auto switchStmt = SwitchStmt::create(LabeledStmtInfo(), SourceLoc(), abExpr,
+                                       SourceLoc(), cases, SourceLoc(), C);
 
-  BraceStmt *body = BraceStmt::create(C, SourceLoc(), statements, SourceLoc());
+  BraceStmt *body = BraceStmt::create(C, SourceLoc(), ASTNode(switchStmt),
+                                      SourceLoc());
   eqDecl->setBody(body);
 }
 
@@ -190,19 +209,12 @@ deriveEquatable_enum_eq(TypeChecker &tc, Decl *parentDecl, EnumDecl *enumDecl) {
   //
   //   @derived
   //   func ==(a: SomeEnum<T...>, b: SomeEnum<T...>) -> Bool {
-  //     var index_a: Int
-  //     switch a {
-  //     case .A: index_a = 0
-  //     case .B: index_a = 1
-  //     case .C: index_a = 2
-  //     }
-  //     var index_b: Int
-  //     switch b {
-  //     case .A: index_b = 0
-  //     case .B: index_b = 1
-  //     case .C: index_b = 2
+  //     switch (a, b) {
+  //     case (.A, .A): return true
+  //     case (.B, .B): return true
+  //     case (.C, .C): return true
+  //     default: return false
   //     }
-  //     return index_a == index_b
   //   }
   
   ASTContext &C = tc.Context;
@@ -251,10 +263,6 @@ deriveEquatable_enum_eq(TypeChecker &tc, Decl *parentDecl, EnumDecl *enumDecl) {
                 diag::broken_equatable_eq_operator);
     return nullptr;
   }
-  if (!C.getEqualIntDecl()) {
-    tc.diagnose(parentDecl->getLoc(), diag::no_equal_overload_for_int);
-    return nullptr;
-  }
 
   eqDecl->setOperatorDecl(op);
   eqDecl->setBodySynthesizer(&deriveBodyEquatable_enum_eq);
@@ -332,11 +340,9 @@ deriveBodyHashable_enum_hashValue(AbstractFunctionDecl *hashValueDecl) {
   DeclRefExpr *indexRef = convertEnumToIndex(statements, parentDC, enumDecl,
                                              selfDecl, hashValueDecl, "index");
   
-  auto memberRef = new (C) UnresolvedDotExpr(indexRef, SourceLoc(),
-                                             C.Id_hashValue,
-                                             DeclNameLoc(),
-                                             /*implicit*/true);
-  auto returnStmt = new (C) ReturnStmt(SourceLoc(), memberRef);
+  // Int's hash value is the integer itself, so return the index directly
+  // rather than looking up 'hashValue' on it.
+  auto returnStmt = new (C) ReturnStmt(SourceLoc(), indexRef);
   statements.push_back(returnStmt);
 
   auto body = BraceStmt::create(C, SourceLoc(), statements, SourceLoc());
@@ -359,7 +365,7 @@ deriveHashable_enum_hashValue(TypeChecker &tc, Decl *parentDecl,
   //     case C:
   //       index = 2
   //     }
-  //     return index.hashValue
+  //     return index
   //   }
   // }
   ASTContext &C = tc.Context;
@@ -369,3 +369,36 @@ bool IterativeTypeChecker::breakCycleForResolveTypeDecl(TypeDecl *typeDecl) {
   // FIXME: Generalize this.
   return false;
 }
+
+//===----------------------------------------------------------------------===//
+// Resolve the signature of a function
+//===----------------------------------------------------------------------===//
+bool IterativeTypeChecker::isResolveFunctionSignatureSatisfied(
+       AbstractFunctionDecl *func) {
+  if (func->hasInterfaceType() || func->isBeingTypeChecked())
+    return true;
+
+  // validateDecl() can't make progress while the enclosing context is being
+  // type checked; treat the request as satisfied and fail elsewhere.
+  auto *dc = func->getDeclContext();
+  if (auto nominal = dyn_cast<NominalTypeDecl>(dc))
+    return nominal->isBeingTypeChecked();
+  if (auto ext = dyn_cast<ExtensionDecl>(dc))
+    return ext->isBeingTypeChecked();
+
+  return false;
+}
+
+void IterativeTypeChecker::processResolveFunctionSignature(
+       AbstractFunctionDecl *func,
+       UnsatisfiedDependency unsatisfiedDependency) {
+  // FIXME: Recursion into the old type checker.
+  TC.validateDecl(func, /*resolveTypeParams=*/true);
+}
+
+bool IterativeTypeChecker::breakCycleForResolveFunctionSignature(
+       AbstractFunctionDecl *func) {
+  func->setInvalid();
+  func->setInterfaceType(ErrorType::get(getASTContext()));
+  return true;
+}
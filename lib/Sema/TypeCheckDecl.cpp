@@ -238,6 +238,16 @@ void TypeChecker::resolveRawType(EnumDecl *enumDecl) {
   ITC.satisfy(requestTypeCheckRawType(enumDecl));
 }
 
+void TypeChecker::resolveDeclSignature(ValueDecl *VD) {
+  if (auto func = dyn_cast<AbstractFunctionDecl>(VD)) {
+    IterativeTypeChecker ITC(*this);
+    ITC.satisfy(requestResolveFunctionSignature(func));
+    return;
+  }
+
+  validateDecl(VD, true);
+}
+
 void TypeChecker::resolveInheritedProtocols(ProtocolDecl *protocol) {
   IterativeTypeChecker ITC(*this);
   ITC.satisfy(requestInheritedProtocols(protocol));
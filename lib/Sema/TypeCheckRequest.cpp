@@ -46,6 +46,7 @@ SourceLoc TypeCheckRequest::getLoc() const {
     return std::get<0>(getTypeResolutionPayload())->getLoc();
 
   DELEGATE_GET_LOC(TypeDeclResolution)
+  DELEGATE_GET_LOC(Function)
 
 #undef DELEGATE_GET_LOC
   }
@@ -87,6 +88,7 @@ Decl *TypeCheckRequest::getAnchor() const {
 
   NO_DECL_PAYLOAD(TypeResolution)
   DECL_PAYLOAD(TypeDeclResolution)
+  DECL_PAYLOAD(Function)
 
 #undef NO_DECL_PAYLOAD
 #undef DECL_PAYLOAD
@@ -26,6 +26,7 @@
 #include "swift/Basic/STLExtras.h"
 #include "swift/Basic/SourceManager.h"
 #include "swift/Basic/Statistic.h"
+#include "swift/Basic/Timer.h"
 #include "swift/Parse/Lexer.h"
 #include "swift/Parse/LocalContext.h"
 #include "llvm/ADT/DenseMap.h"
@@ -191,6 +192,26 @@ namespace {
   };
 }
 
+/// Starts a trace event covering the type-checking of the body of \p Fn,
+/// if compile events are being traced.
+static void startFunctionBodyEvent(Optional<TracedEvent> &event,
+                                   AnyFunctionRef Fn) {
+  if (!TracedEvent::isTracingEnabled())
+    return;
+
+  ASTContext &ctx = Fn.getAsDeclContext()->getASTContext();
+  std::string name, loc;
+  {
+    llvm::raw_string_ostream nameOut(name), locOut(loc);
+    if (auto *AFD = Fn.getAbstractFunctionDecl())
+      AFD->getFullName().print(nameOut);
+    else
+      nameOut << "(closure)";
+    Fn.getLoc().print(locOut, ctx.SourceMgr);
+  }
+  event.emplace("type-check", name, loc);
+}
+
 static void setAutoClosureDiscriminators(DeclContext *DC, Stmt *S) {
   S->walk(ContextualizeClosures(DC));
 }
@@ -1257,6 +1278,12 @@ bool TypeChecker::typeCheckAbstractFunctionBody(AbstractFunctionDecl *AFD) {
   if (DebugTimeFunctionBodies || WarnLongFunctionBodies)
     timer.emplace(AFD, DebugTimeFunctionBodies, WarnLongFunctionBodies);
 
+  Optional<TracedEvent> event;
+  startFunctionBodyEvent(event, AFD);
+
+  if (auto *Stats = Context.Stats)
+    ++Stats->getFrontendCounters().NumFunctionBodiesTypeChecked;
+
   if (typeCheckAbstractFunctionBodyUntil(AFD, SourceLoc()))
     return true;
   
@@ -1504,6 +1531,9 @@ void TypeChecker::typeCheckClosureBody(ClosureExpr *closure) {
   if (DebugTimeFunctionBodies || WarnLongFunctionBodies)
     timer.emplace(closure, DebugTimeFunctionBodies, WarnLongFunctionBodies);
 
+  Optional<TracedEvent> event;
+  startFunctionBodyEvent(event, closure);
+
   StmtChecker(*this, closure).typeCheckBody(body);
   if (body) {
     closure->setBody(body, closure->hasSingleExpressionBody());
@@ -406,6 +406,14 @@ void TypeChecker::bindExtension(ExtensionDecl *ext) {
   ::bindExtensionDecl(ext, *this);
 }
 
+// FIXME: Function bodies are checked one at a time, even in whole-module
+// mode. Handing them to a worker pool the way IRGen does with -num-threads
+// isn't possible yet: ASTContext arena allocation, interning of types and
+// conformances, lazy member loading, and the TypeChecker's own worklists
+// (definedFunctions, ValidatedTypes, UsedConformances) are all unsynchronized,
+// and checking a body routinely validates declarations from other files.
+// Diagnostics would also need to be buffered per body to keep their order
+// deterministic.
 static void typeCheckFunctionsAndExternalDecls(TypeChecker &TC) {
   unsigned currentFunctionIdx = 0;
   unsigned currentExternalDef = TC.Context.LastCheckedExternalDefinition;
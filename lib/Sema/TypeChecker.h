@@ -501,6 +501,18 @@ public:
   llvm::DenseMap<const SourceFile *, TypeAccessScopeCacheMap>
     TypeAccessScopeCache;
 
+  /// The parameter and result types of a binary operator overload, mapped
+  /// into the context of the overload.
+  struct BinaryOperatorSignature {
+    Type FirstParam;
+    Type SecondParam;
+    Type Result;
+  };
+
+  /// Caches the signatures of binary operator overloads, which are consulted
+  /// for every overload at every operator application.
+  llvm::DenseMap<ValueDecl *, BinaryOperatorSignature> BinaryOperatorSignatures;
+
   // Caches whether a given declaration is "as specialized" as another.
   llvm::DenseMap<std::pair<ValueDecl*, ValueDecl*>, bool> 
     specializedOverloadComparisonCache;
@@ -977,9 +989,7 @@ public:
     validateAccessibility(VD);
   }
 
-  virtual void resolveDeclSignature(ValueDecl *VD) override {
-    validateDecl(VD, true);
-  }
+  virtual void resolveDeclSignature(ValueDecl *VD) override;
 
   virtual void bindExtension(ExtensionDecl *ext) override;
 
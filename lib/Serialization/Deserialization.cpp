@@ -17,6 +17,8 @@
 #include "swift/AST/ForeignErrorConvention.h"
 #include "swift/AST/GenericEnvironment.h"
 #include "swift/AST/PrettyStackTrace.h"
+#include "swift/Basic/Statistic.h"
+#include "swift/Basic/Varint.h"
 #include "swift/ClangImporter/ClangImporter.h"
 #include "swift/Parse/Parser.h"
 #include "swift/Serialization/BCReadingExtras.h"
@@ -1064,28 +1066,36 @@ GenericEnvironment *ModuleFile::maybeReadGenericEnvironment() {
   return readGenericEnvironment(DeclTypeCursor);
 }
 
-bool ModuleFile::readMembers(SmallVectorImpl<Decl *> &Members) {
+bool ModuleFile::readRawMembers(SmallVectorImpl<uint64_t> &scratch,
+                                ArrayRef<uint64_t> &rawMemberIDsAndNames) {
   using namespace decls_block;
 
   auto entry = DeclTypeCursor.advance();
   if (entry.Kind != llvm::BitstreamEntry::Record)
     return true;
 
-  SmallVector<uint64_t, 16> memberIDBuffer;
-
-  unsigned kind = DeclTypeCursor.readRecord(entry.ID, memberIDBuffer);
+  unsigned kind = DeclTypeCursor.readRecord(entry.ID, scratch);
   assert(kind == MEMBERS);
   (void)kind;
 
-  ArrayRef<uint64_t> rawMemberIDs;
-  decls_block::MembersLayout::readRecord(memberIDBuffer, rawMemberIDs);
+  decls_block::MembersLayout::readRecord(scratch, rawMemberIDsAndNames);
+  if (rawMemberIDsAndNames.size() % 2 != 0)
+    return true;
+  return false;
+}
 
-  if (rawMemberIDs.empty())
+bool ModuleFile::readMembers(SmallVectorImpl<Decl *> &Members) {
+  SmallVector<uint64_t, 32> memberIDBuffer;
+  ArrayRef<uint64_t> rawMemberIDsAndNames;
+  if (readRawMembers(memberIDBuffer, rawMemberIDsAndNames))
+    return true;
+
+  if (rawMemberIDsAndNames.empty())
     return false;
 
-  Members.reserve(rawMemberIDs.size());
-  for (DeclID rawID : rawMemberIDs) {
-    Decl *D = getDecl(rawID);
+  Members.reserve(rawMemberIDsAndNames.size() / 2);
+  for (size_t i = 0, e = rawMemberIDsAndNames.size(); i != e; i += 2) {
+    Decl *D = getDecl(rawMemberIDsAndNames[i]);
     assert(D && "unable to deserialize next member");
     Members.push_back(D);
   }
@@ -1250,6 +1260,21 @@ Decl *ModuleFile::resolveCrossReference(Module *M, uint32_t pathLen) {
     if (!isType)
       pathTrace.addType(filterTy);
 
+    // A type is found by its name alone, so another module file may have
+    // looked it up already. This avoids repeating lookups into Clang
+    // modules, which import every declaration with the name. Lookups into
+    // this file's own module can't be shared, because its other files may
+    // not all be loaded yet.
+    bool canShare = isType && SharedXRefTypes && M != getAssociatedModule();
+    Identifier lookupName = name;
+    if (canShare) {
+      auto known = SharedXRefTypes->find({M, lookupName});
+      if (known != SharedXRefTypes->end()) {
+        values.push_back(known->second);
+        break;
+      }
+    }
+
     bool retrying = false;
     retry:
 
@@ -1286,6 +1311,8 @@ Decl *ModuleFile::resolveCrossReference(Module *M, uint32_t pathLen) {
       }
     }
 
+    if (canShare && values.size() == 1)
+      SharedXRefTypes->insert({{M, lookupName}, values.front()});
     break;
   }
 
@@ -1583,19 +1610,42 @@ Identifier ModuleFile::getIdentifier(IdentifierID IID) {
 
   size_t rawID = IID - NUM_SPECIAL_MODULES;
   assert(rawID < Identifiers.size() && "invalid identifier ID");
-  auto identRecord = Identifiers[rawID];
+  auto &identRecord = Identifiers[rawID];
 
   if (identRecord.Offset == 0)
     return identRecord.Ident;
 
   assert(!IdentifierData.empty() && "no identifier data in module");
 
-  StringRef rawStrPtr = IdentifierData.substr(identRecord.Offset);
-  size_t terminatorOffset = rawStrPtr.find('\0');
-  assert(terminatorOffset != StringRef::npos &&
-         "unterminated identifier string data");
+  // Decode the identifiers from the last one stored in full up to this one.
+  using identifier_block::IDENTIFIER_RESTART_INTERVAL;
+  unsigned position = identRecord.Offset - 1;
+  unsigned restart = position / IDENTIFIER_RESTART_INTERVAL;
+  assert(restart < IdentifierRestarts.size() && "invalid identifier offset");
+
+  SmallString<64> str;
+  size_t offset = IdentifierRestarts[restart];
+  for (unsigned i = restart * IDENTIFIER_RESTART_INTERVAL; i <= position;
+       ++i) {
+    assert(offset < IdentifierData.size() && "identifier data too short");
+    auto prefixLength = Varint::decode<uint64_t>(
+      reinterpret_cast<const uint8_t *>(IdentifierData.data() + offset));
+    while (IdentifierData[offset] & 0x80)
+      ++offset;
+    ++offset;
+
+    size_t terminatorOffset = IdentifierData.find('\0', offset);
+    assert(terminatorOffset != StringRef::npos &&
+           "unterminated identifier string data");
+    assert(prefixLength <= str.size() && "invalid identifier prefix");
+    str.resize(prefixLength);
+    str.append(IdentifierData.slice(offset, terminatorOffset));
+    offset = terminatorOffset + 1;
+  }
 
-  return getContext().getIdentifier(rawStrPtr.slice(0, terminatorOffset));
+  identRecord.Ident = getContext().getIdentifier(str);
+  identRecord.Offset = 0;
+  return identRecord.Ident;
 }
 
 DeclContext *ModuleFile::getLocalDeclContext(DeclContextID DCID) {
@@ -2013,6 +2063,9 @@ Decl *ModuleFile::getDecl(DeclID DID, Optional<DeclContext *> ForcedContext) {
   }
 
   ASTContext &ctx = getContext();
+  if (auto *Stats = ctx.Stats)
+    ++Stats->getFrontendCounters().NumDeclsDeserialized;
+
   SmallVector<uint64_t, 64> scratch;
   StringRef blobData;
 
@@ -3490,6 +3543,8 @@ Type ModuleFile::getType(TypeID TID) {
   }
 
   ASTContext &ctx = getContext();
+  if (auto *Stats = ctx.Stats)
+    ++Stats->getFrontendCounters().NumTypesDeserialized;
 
   SmallVector<uint64_t, 64> scratch;
   StringRef blobData;
@@ -4206,6 +4261,36 @@ void ModuleFile::loadAllMembers(Decl *D, uint64_t contextData) {
   }
 }
 
+bool ModuleFile::loadNamedMembers(const Decl *D, Identifier N,
+                                  uint64_t contextData,
+                                  SmallVectorImpl<ValueDecl *> &Members) {
+  PrettyStackTraceDecl trace("loading named members for", D);
+
+  BCOffsetRAII restoreOffset(DeclTypeCursor);
+  DeclTypeCursor.JumpToBit(contextData);
+  SmallVector<uint64_t, 32> memberIDBuffer;
+  ArrayRef<uint64_t> rawMemberIDsAndNames;
+  if (readRawMembers(memberIDBuffer, rawMemberIDsAndNames))
+    return false;
+
+  // Find the matching names before deserializing anything, since that moves
+  // the cursor and may clobber the buffer.
+  SmallVector<DeclID, 4> matchingIDs;
+  for (size_t i = 0, e = rawMemberIDsAndNames.size(); i != e; i += 2) {
+    IdentifierID nameID = rawMemberIDsAndNames[i + 1];
+    if (nameID != 0 && getIdentifier(nameID) == N)
+      matchingIDs.push_back(rawMemberIDsAndNames[i]);
+  }
+
+  for (DeclID memberID : matchingIDs) {
+    Decl *member = getDecl(memberID);
+    assert(member && "unable to deserialize named member");
+    if (auto VD = dyn_cast<ValueDecl>(member))
+      Members.push_back(VD);
+  }
+  return true;
+}
+
 void
 ModuleFile::loadAllConformances(const Decl *D, uint64_t contextData,
                           SmallVectorImpl<ProtocolConformance*> &conformances) {
@@ -437,6 +437,11 @@ SILFunction *SILDeserializer::readSILFunction(DeclID FID,
     if (isFragile)
       fn->setFragile(IsFragile);
 
+    // Pick up the effects which the defining module recorded for the
+    // function, unless the declaration already has explicit @effects.
+    if (fn->getEffectsKind() == EffectsKind::Unspecified)
+      fn->setEffectsKind((EffectsKind)effect);
+
     // Don't override the transparency or linkage of a function with
     // an existing declaration.
 
@@ -672,7 +677,8 @@ bool SILDeserializer::readSILInstruction(SILFunction *Fn, SILBasicBlock *BB,
   Builder.setInsertionPoint(BB);
   Builder.setCurrentDebugScope(Fn->getDebugScope());
   unsigned OpCode = 0, TyCategory = 0, TyCategory2 = 0, TyCategory3 = 0,
-           Attr = 0, NumSubs = 0, NumConformances = 0, IsNonThrowingApply = 0;
+           Attr = 0, NumSubs = 0, NumConformances = 0, IsNonThrowingApply = 0,
+           IsStackPartialApply = 0;
   ValueID ValID, ValID2, ValID3;
   TypeID TyID, TyID2, TyID3;
   TypeID ConcreteTyID;
@@ -742,6 +748,10 @@ bool SILDeserializer::readSILInstruction(SILFunction *Fn, SILBasicBlock *BB,
     case SIL_PARTIAL_APPLY:
       OpCode = (unsigned)ValueKind::PartialApplyInst;
       break;
+    case SIL_STACK_PARTIAL_APPLY:
+      OpCode = (unsigned)ValueKind::PartialApplyInst;
+      IsStackPartialApply = true;
+      break;
     case SIL_BUILTIN:
       OpCode = (unsigned)ValueKind::BuiltinInst;
       break;
@@ -1093,9 +1103,12 @@ bool SILDeserializer::readSILInstruction(SILFunction *Fn, SILBasicBlock *BB,
       Args.push_back(getLocalValue(ListOfValues[I], ArgTys[I + unappliedArgs]));
 
     // FIXME: Why the arbitrary order difference in IRBuilder type argument?
-    ResultVal = Builder.createPartialApply(Loc, FnVal, SubstFnTy,
+    auto *PAI = Builder.createPartialApply(Loc, FnVal, SubstFnTy,
                                            Substitutions, Args,
                                            closureTy);
+    if (IsStackPartialApply)
+      PAI->setStackAllocatable();
+    ResultVal = PAI;
     break;
   }
   case ValueKind::BuiltinInst: {
@@ -204,6 +204,9 @@ validateControlBlock(llvm::BitstreamCursor &cursor,
     case control_block::TARGET:
       result.targetTriple = blobData;
       break;
+    case control_block::INTERFACE_HASH:
+      result.interfaceHash = blobData;
+      break;
     default:
       // Unknown metadata record, possibly for use by a future version of the
       // module format.
@@ -804,6 +807,7 @@ ModuleFile::ModuleFile(
       }
       Name = info.name;
       TargetTriple = info.targetTriple;
+      InterfaceHash = info.interfaceHash;
 
       hasValidControlBlock = true;
       break;
@@ -928,6 +932,10 @@ ModuleFile::ModuleFile(
           assert(scratch.empty());
           IdentifierData = blobData;
           break;
+        case identifier_block::IDENTIFIER_RESTARTS:
+          assert(blobData.empty());
+          IdentifierRestarts.assign(scratch.begin(), scratch.end());
+          break;
         default:
           // Unknown identifier data, which this version of the compiler won't
           // use.
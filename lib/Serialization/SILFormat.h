@@ -329,7 +329,8 @@ namespace sil_block {
     SIL_PARTIAL_APPLY,
     SIL_BUILTIN,
     SIL_TRY_APPLY,
-    SIL_NON_THROWING_APPLY
+    SIL_NON_THROWING_APPLY,
+    SIL_STACK_PARTIAL_APPLY
   };
   
   using SILInstApplyLayout = BCRecordLayout<
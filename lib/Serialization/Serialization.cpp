@@ -27,10 +27,12 @@
 #include "swift/Basic/STLExtras.h"
 #include "swift/Basic/SourceManager.h"
 #include "swift/Basic/Timer.h"
+#include "swift/Basic/Varint.h"
 #include "swift/Basic/Version.h"
 #include "swift/ClangImporter/ClangImporter.h"
 #include "swift/ClangImporter/ClangModule.h"
 #include "swift/Serialization/SerializationOptions.h"
+#include "swift/Serialization/SerializedModuleLoader.h"
 
 #include "clang/Basic/Module.h"
 // FIXME: We're just using CompilerInstance::createOutputFile.
@@ -51,6 +53,8 @@
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/YAMLParser.h"
 
+#include <numeric>
+#include <thread>
 #include <vector>
 
 using namespace swift;
@@ -448,6 +452,7 @@ void Serializer::writeBlockInfoBlock() {
   BLOCK_RECORD(control_block, METADATA);
   BLOCK_RECORD(control_block, MODULE_NAME);
   BLOCK_RECORD(control_block, TARGET);
+  BLOCK_RECORD(control_block, INTERFACE_HASH);
 
   BLOCK(OPTIONS_BLOCK);
   BLOCK_RECORD(options_block, SDK_PATH);
@@ -470,6 +475,7 @@ void Serializer::writeBlockInfoBlock() {
 
   BLOCK(IDENTIFIER_DATA_BLOCK);
   BLOCK_RECORD(identifier_block, IDENTIFIER_DATA);
+  BLOCK_RECORD(identifier_block, IDENTIFIER_RESTARTS);
 
   BLOCK(INDEX_BLOCK);
   BLOCK_RECORD(index_block, TYPE_OFFSETS);
@@ -582,6 +588,54 @@ void Serializer::writeDocBlockInfoBlock() {
 #undef BLOCK_RECORD
 }
 
+/// Written in place of the interface hash until it's known.
+static const char InterfaceHashPlaceholder[] =
+  "00000000000000000000000000000000";
+
+/// Starts the hash of the public interface of \p M, or only of \p SF if
+/// given, from the interface hashes of the files being serialized.
+///
+/// \returns None if one of the files doesn't have an interface hash.
+static Optional<llvm::MD5> startInterfaceHash(const ModuleDecl *M,
+                                              const SourceFile *SF) {
+  llvm::MD5 hash;
+  auto addFile = [&](const FileUnit *file) -> bool {
+    SmallString<32> fileHash;
+    if (auto *sourceFile = dyn_cast<SourceFile>(file)) {
+      // Finalize a copy, so that the file's own hash is left alone.
+      llvm::MD5 state = sourceFile->getInterfaceHashState();
+      llvm::MD5::MD5Result result;
+      state.final(result);
+      llvm::MD5::stringifyResult(result, fileHash);
+    } else if (auto *astFile = dyn_cast<SerializedASTFile>(file)) {
+      fileHash = astFile->getInterfaceHash();
+    }
+    if (fileHash.empty())
+      return false;
+    hash.update(fileHash);
+    return true;
+  };
+
+  if (SF) {
+    if (!addFile(SF))
+      return None;
+  } else {
+    for (const FileUnit *file : M->getFiles())
+      if (!addFile(file))
+        return None;
+  }
+
+  // The flags select which declarations exist, but the interface tokens
+  // include the inactive ones.
+  for (StringRef flag :
+         M->getASTContext().LangOpts.getCustomConditionalCompilationFlags()) {
+    hash.update(flag);
+    uint8_t separator[1] = {0};
+    hash.update(separator);
+  }
+  return hash;
+}
+
 void Serializer::writeHeader(const SerializationOptions &options) {
   {
     BCBlockRAII restoreBlock(Out, CONTROL_BLOCK_ID, 3);
@@ -603,6 +657,16 @@ void Serializer::writeHeader(const SerializationOptions &options) {
 
     Target.emit(ScratchRecord, M->getASTContext().LangOpts.Target.str());
 
+    InterfaceHash = startInterfaceHash(M, SF);
+    if (InterfaceHash) {
+      // Blobs are word-aligned and the hash is a whole number of words, so
+      // it ends where the buffer does.
+      control_block::InterfaceHashLayout InterfaceHashRecord(Out);
+      InterfaceHashRecord.emit(ScratchRecord, InterfaceHashPlaceholder);
+      InterfaceHashOffset =
+        Buffer.size() - (sizeof(InterfaceHashPlaceholder) - 1);
+    }
+
     {
       llvm::BCBlockRAII restoreBlock(Out, OPTIONS_BLOCK_ID, 3);
 
@@ -632,6 +696,26 @@ void Serializer::writeHeader(const SerializationOptions &options) {
   }
 }
 
+void Serializer::writeInterfaceHash() {
+  if (!InterfaceHash)
+    return;
+
+  // Everything written so far covers the module's options and imports and
+  // the bodies of its inlinable functions, which the files' interface hashes
+  // leave out.
+  InterfaceHash->update(StringRef(Buffer.data(), Buffer.size()));
+  llvm::MD5::MD5Result result;
+  InterfaceHash->final(result);
+  SmallString<32> str;
+  llvm::MD5::stringifyResult(result, str);
+
+  assert(str.size() == sizeof(InterfaceHashPlaceholder) - 1);
+  assert(StringRef(Buffer.data() + InterfaceHashOffset, str.size()) ==
+           InterfaceHashPlaceholder && "interface hash placeholder moved");
+  std::copy(str.begin(), str.end(), Buffer.begin() + InterfaceHashOffset);
+  InterfaceHash = None;
+}
+
 void Serializer::writeDocHeader() {
   {
     BCBlockRAII restoreBlock(Out, CONTROL_BLOCK_ID, 3);
@@ -1398,6 +1482,12 @@ void Serializer::writeMembers(DeclRange members, bool isClass) {
     DeclID memberID = addDeclRef(member);
     memberIDs.push_back(memberID);
 
+    IdentifierID nameID = 0;
+    if (auto VD = dyn_cast<ValueDecl>(member))
+      if (VD->hasName())
+        nameID = addIdentifierRef(VD->getName());
+    memberIDs.push_back(nameID);
+
     if (isClass) {
       if (auto VD = dyn_cast<ValueDecl>(member)) {
         if (VD->canBeAccessedByDynamicLookup()) {
@@ -3473,19 +3563,45 @@ void Serializer::writeAllDeclsAndTypes() {
 void Serializer::writeAllIdentifiers() {
   BCBlockRAII restoreBlock(Out, IDENTIFIER_DATA_BLOCK_ID, 3);
   identifier_block::IdentifierDataLayout IdentifierData(Out);
+  identifier_block::IdentifierRestartsLayout IdentifierRestarts(Out);
+  using identifier_block::IDENTIFIER_RESTART_INTERVAL;
+
+  // Sort the identifiers so that neighbors share long prefixes. Each
+  // identifier's "offset" is its position in this order, plus one so that
+  // none is 0.
+  std::vector<unsigned> order(IdentifiersToWrite.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](unsigned lhs, unsigned rhs) {
+    return IdentifiersToWrite[lhs].str() < IdentifiersToWrite[rhs].str();
+  });
+  IdentifierOffsets.resize(IdentifiersToWrite.size(), 0);
 
   llvm::SmallString<4096> stringData;
+  std::vector<CharOffset> restarts;
+  StringRef previous;
+  for (unsigned position : indices(order)) {
+    StringRef str = IdentifiersToWrite[order[position]].str();
+    IdentifierOffsets[order[position]] = position + 1;
+
+    size_t prefixLength = 0;
+    if (position % IDENTIFIER_RESTART_INTERVAL == 0) {
+      restarts.push_back(stringData.size());
+    } else {
+      size_t maxLength = std::min(previous.size(), str.size());
+      while (prefixLength < maxLength &&
+             previous[prefixLength] == str[prefixLength])
+        ++prefixLength;
+    }
 
-  // Make sure no identifier has an offset of 0.
-  stringData.push_back('\0');
-
-  for (Identifier ident : IdentifiersToWrite) {
-    IdentifierOffsets.push_back(stringData.size());
-    stringData.append(ident.get());
+    auto encodedLength = Varint::encode<uint64_t>(prefixLength);
+    stringData.append(encodedLength.begin(), encodedLength.end());
+    stringData.append(str.substr(prefixLength));
     stringData.push_back('\0');
+    previous = str;
   }
 
   IdentifierData.emit(ScratchRecord, stringData.str());
+  IdentifierRestarts.emit(ScratchRecord, restarts);
 }
 
 void Serializer::writeOffsets(const index_block::OffsetsLayout &Offsets,
@@ -4205,6 +4321,7 @@ void Serializer::writeToStream(raw_ostream &os, ModuleOrSourceFile DC,
     S.writeHeader(options);
     S.writeInputBlock(options);
     S.writeSIL(SILMod, options.SerializeAllSIL);
+    S.writeInterfaceHash();
     S.writeAST(DC);
   }
 
@@ -4235,9 +4352,15 @@ void Serializer::writeDocToStream(raw_ostream &os, ModuleOrSourceFile DC,
   S.writeToStream(os);
 }
 
-static inline bool
-withOutputFile(ASTContext &ctx, StringRef outputPath,
-               llvm::function_ref<void(raw_ostream &)> action){
+/// Writes \p contents to \p outputPath through a temporary file, leaving an
+/// existing file with the same contents alone.
+///
+/// This doesn't touch the ASTContext, so that it can run on another thread.
+/// On failure, \p problematicPath is set to the file that couldn't be
+/// written.
+static std::error_code writeOutputFile(StringRef outputPath,
+                                       StringRef contents,
+                                       std::string &problematicPath) {
   namespace path = llvm::sys::path;
   clang::CompilerInstance Clang;
 
@@ -4256,26 +4379,22 @@ withOutputFile(ASTContext &ctx, StringRef outputPath,
                              &tmpFilePath);
 
     if (!out) {
-      StringRef problematicPath =
-          tmpFilePath.empty() ? outputPath : StringRef(tmpFilePath);
-      ctx.Diags.diagnose(SourceLoc(), diag::error_opening_output,
-                         problematicPath, EC.message());
-      return true;
+      problematicPath = tmpFilePath.empty() ? outputPath.str() : tmpFilePath;
+      return EC;
     }
 
-    action(*out);
+    out->write(contents.data(), contents.size());
   }
 
   if (!tmpFilePath.empty()) {
     std::error_code EC = swift::moveFileIfDifferent(tmpFilePath, outputPath);
     if (EC) {
-      ctx.Diags.diagnose(SourceLoc(), diag::error_opening_output,
-                         outputPath, EC.message());
-      return true;
+      problematicPath = outputPath;
+      return EC;
     }
   }
 
-  return false;
+  return std::error_code();
 }
 
 void swift::serialize(ModuleOrSourceFile DC,
@@ -4290,20 +4409,51 @@ void swift::serialize(ModuleOrSourceFile DC,
     return;
   }
 
-  bool hadError = withOutputFile(getContext(DC), options.OutputPath,
-                                 [&](raw_ostream &out) {
+  ASTContext &ctx = getContext(DC);
+  auto diagnoseError = [&](StringRef problematicPath, std::error_code EC) {
+    ctx.Diags.diagnose(SourceLoc(), diag::error_opening_output,
+                       problematicPath, EC.message());
+  };
+
+  SmallVector<char, 0> moduleBuffer;
+  {
     SharedTimer timer("Serialization (swiftmodule)");
+    llvm::raw_svector_ostream out(moduleBuffer);
     Serializer::writeToStream(out, DC, M, options);
+  }
+
+  // Write the module while the documentation is serialized. Only the
+  // serializers walk the AST, so they stay on this thread.
+  std::string moduleProblematicPath;
+  std::error_code moduleEC;
+  std::thread moduleWriter([&] {
+    moduleEC = writeOutputFile(options.OutputPath,
+                               StringRef(moduleBuffer.data(),
+                                         moduleBuffer.size()),
+                               moduleProblematicPath);
   });
-  if (hadError)
+
+  SmallVector<char, 0> docBuffer;
+  bool hasDocOutput = options.DocOutputPath && options.DocOutputPath[0] != '\0';
+  if (hasDocOutput) {
+    SharedTimer timer("Serialization (swiftdoc)");
+    llvm::raw_svector_ostream out(docBuffer);
+    Serializer::writeDocToStream(out, DC, options.GroupInfoPath, ctx);
+  }
+
+  moduleWriter.join();
+  if (moduleEC) {
+    diagnoseError(moduleProblematicPath, moduleEC);
     return;
+  }
 
-  if (options.DocOutputPath && options.DocOutputPath[0] != '\0') {
-    (void)withOutputFile(getContext(DC), options.DocOutputPath,
-                         [&](raw_ostream &out) {
-      SharedTimer timer("Serialization (swiftdoc)");
-      Serializer::writeDocToStream(out, DC, options.GroupInfoPath,
-                                   getContext(DC));
-    });
+  if (hasDocOutput) {
+    std::string docProblematicPath;
+    std::error_code docEC =
+      writeOutputFile(options.DocOutputPath,
+                      StringRef(docBuffer.data(), docBuffer.size()),
+                      docProblematicPath);
+    if (docEC)
+      diagnoseError(docProblematicPath, docEC);
   }
 }
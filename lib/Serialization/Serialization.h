@@ -23,6 +23,7 @@
 #include "swift/AST/Identifier.h"
 #include "swift/Basic/LLVM.h"
 #include "llvm/ADT/MapVector.h"
+#include "llvm/Support/MD5.h"
 #include <array>
 #include <queue>
 #include <tuple>
@@ -187,6 +188,14 @@ private:
   /// The decls that adopt compiler-known protocols.
   SmallVector<DeclID, 2> KnownProtocolAdopters[NumKnownProtocols];
 
+  /// The hash of the module's public interface, while it's being computed,
+  /// or None if it isn't recorded.
+  Optional<llvm::MD5> InterfaceHash;
+
+  /// The byte offset of the interface hash in the buffer, which is written
+  /// as a placeholder until the hash is known.
+  size_t InterfaceHashOffset = 0;
+
   /// The last assigned DeclID for decls from this module.
   uint32_t /*DeclID*/ LastDeclID = 0;
 
@@ -244,6 +253,10 @@ private:
   /// if the module can be loaded.
   void writeHeader(const SerializationOptions &options = {});
 
+  /// Writes the hash of the module's public interface over the placeholder
+  /// written by writeHeader, covering everything serialized so far.
+  void writeInterfaceHash();
+
   /// Writes the Swift doc module file header and name.
   void writeDocHeader();
 
@@ -798,7 +798,8 @@ void SILSerializer::writeSILInstruction(const SILInstruction &SI) {
       Args.push_back(addValueRef(Arg));
     }
     SILInstApplyLayout::emitRecord(Out, ScratchRecord,
-        SILAbbrCodes[SILInstApplyLayout::Code], SIL_PARTIAL_APPLY,
+        SILAbbrCodes[SILInstApplyLayout::Code],
+        PAI->canAllocOnStack() ? SIL_STACK_PARTIAL_APPLY : SIL_PARTIAL_APPLY,
         PAI->getSubstitutions().size(),
         S.addTypeRef(PAI->getCallee()->getType().getSwiftRValueType()),
         S.addTypeRef(PAI->getType().getSwiftRValueType()),
@@ -1973,6 +1974,18 @@ void SILSerializer::writeSILBlock(const SILModule *SILMod) {
     processSILFunctionWorklist();
   }
 
+  // Clients can't see the bodies of most public functions, but their effects
+  // are cheap to serialize and still enable optimizations around calls.
+  // Emit a declaration for every public function with known effects.
+  if (!emitDeclarationsForOnoneSupport) {
+    for (const SILFunction &F : *SILMod) {
+      if (F.isDefinition() && hasPublicVisibility(F.getLinkage()) &&
+          F.getEffectsKind() < EffectsKind::ReadWrite &&
+          !FuncsToEmit.count(&F))
+        FuncsToEmit[&F] = true;
+    }
+  }
+
   // Now write function declarations for every function we've
   // emitted a reference to without emitting a function body for.
   for (const SILFunction &F : *SILMod) {
@@ -17,6 +17,7 @@
 #include "swift/AST/DiagnosticsSema.h"
 #include "swift/Basic/STLExtras.h"
 #include "swift/Basic/SourceManager.h"
+#include "swift/Basic/Timer.h"
 #include "swift/Basic/Version.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/Support/MemoryBuffer.h"
@@ -42,12 +43,22 @@ openModuleFiles(StringRef DirName, StringRef ModuleFilename,
                 std::unique_ptr<llvm::MemoryBuffer> &ModuleBuffer,
                 std::unique_ptr<llvm::MemoryBuffer> &ModuleDocBuffer,
                 llvm::SmallVectorImpl<char> &Scratch) {
+  // Module files are only ever read through a bitstream cursor, which doesn't
+  // need a null terminator. Not asking for one means the buffer can always be
+  // mmapped read-only rather than copied into the heap when its size happens
+  // to be a multiple of the page size, so every frontend job importing the
+  // module shares the same pages.
+  auto getFile = [](StringRef path) {
+    return llvm::MemoryBuffer::getFile(path, /*FileSize=*/-1,
+                                       /*RequiresNullTerminator=*/false);
+  };
+
   // Try to open the module file first.  If we fail, don't even look for the
   // module documentation file.
   Scratch.clear();
   llvm::sys::path::append(Scratch, DirName, ModuleFilename);
   llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> ModuleOrErr =
-    llvm::MemoryBuffer::getFile(StringRef(Scratch.data(), Scratch.size()));
+    getFile(StringRef(Scratch.data(), Scratch.size()));
   if (!ModuleOrErr)
     return ModuleOrErr.getError();
 
@@ -56,7 +67,7 @@ openModuleFiles(StringRef DirName, StringRef ModuleFilename,
   Scratch.clear();
   llvm::sys::path::append(Scratch, DirName, ModuleDocFilename);
   llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> ModuleDocOrErr =
-    llvm::MemoryBuffer::getFile(StringRef(Scratch.data(), Scratch.size()));
+    getFile(StringRef(Scratch.data(), Scratch.size()));
   if (!ModuleDocOrErr &&
       ModuleDocOrErr.getError() != std::errc::no_such_file_or_directory) {
     return ModuleDocOrErr.getError();
@@ -171,6 +182,7 @@ FileUnit *SerializedModuleLoader::loadAST(
                        &extendedInfo);
   if (loadInfo.status == serialization::Status::Valid) {
     Ctx.bumpGeneration();
+    loadedModuleFile->setXRefTypeCache(&XRefTypes);
 
     M.setResilienceStrategy(extendedInfo.getResilienceStrategy());
 
@@ -362,6 +374,8 @@ Module *SerializedModuleLoader::loadModule(SourceLoc importLoc,
   auto moduleID = path[0];
   bool isFramework = false;
 
+  TracedEvent event("import", moduleID.first.str());
+
   std::unique_ptr<llvm::MemoryBuffer> moduleInputBuffer;
   std::unique_ptr<llvm::MemoryBuffer> moduleDocInputBuffer;
   // First see if we find it in the registered memory buffers.
@@ -461,6 +475,10 @@ void SerializedASTFile::collectLinkLibraries(
   }
 }
 
+StringRef SerializedASTFile::getInterfaceHash() const {
+  return File.getInterfaceHash();
+}
+
 bool SerializedASTFile::isSystemModule() const {
   if (auto Mod = File.getShadowedModule()) {
     return Mod->isSystemModule();
@@ -15,15 +15,21 @@
 //
 //===----------------------------------------------------------------------===//
 
-#include "swift/Basic/DemangleWrappers.h"
+#include "swift/Basic/Demangle.h"
+#include "swift/Basic/PrettyStackTrace.h"
 #include "swift/SwiftDemangle/SwiftDemangle.h"
 
+struct swift_demangle_context_s {
+  swift::Demangle::Context Ctx;
+};
+
 /// \returns true if \p MangledName starts with Swift prefix, "_T".
 static bool isSwiftPrefixed(const char *MangledName) {
   return (MangledName[0] == '_' && MangledName[1] == 'T');
 }
 
-static size_t swift_demangle_getDemangledName_Options(const char *MangledName,
+static size_t swift_demangle_getDemangledName_Options(
+    swift::Demangle::Context &Ctx, const char *MangledName,
     char *OutputBuffer, size_t Length,
     swift::Demangle::DemangleOptions DemangleOptions) {
   assert(MangledName != nullptr && "null input");
@@ -32,8 +38,13 @@ static size_t swift_demangle_getDemangledName_Options(const char *MangledName,
   if (!isSwiftPrefixed(MangledName))
     return 0; // Not a mangled name
 
-  std::string Result = swift::demangle_wrappers::demangleSymbolAsString(
-      MangledName, DemangleOptions);
+  swift::PrettyStackTraceStringAction prettyStackTrace("demangling string",
+                                                       MangledName);
+  std::string Result = Ctx.demangleSymbolAsString(MangledName,
+                                                  DemangleOptions);
+  // Only the string is returned, so the tree can go. The context keeps its
+  // memory for the next name.
+  Ctx.clear();
 
   if (Result == MangledName)
     return 0; // Not a mangled name
@@ -42,13 +53,26 @@ static size_t swift_demangle_getDemangledName_Options(const char *MangledName,
   return strlcpy(OutputBuffer, Result.c_str(), Length);
 }
 
+static size_t swift_demangle_getDemangledName_Options(const char *MangledName,
+    char *OutputBuffer, size_t Length,
+    swift::Demangle::DemangleOptions DemangleOptions) {
+  swift::Demangle::Context Ctx;
+  return swift_demangle_getDemangledName_Options(Ctx, MangledName,
+                                                 OutputBuffer, Length,
+                                                 DemangleOptions);
+}
+
+static swift::Demangle::DemangleOptions getDefaultOptions() {
+  swift::Demangle::DemangleOptions DemangleOptions;
+  DemangleOptions.SynthesizeSugarOnTypes = true;
+  return DemangleOptions;
+}
+
 size_t swift_demangle_getDemangledName(const char *MangledName,
                                        char *OutputBuffer,
                                        size_t Length) {
-  swift::Demangle::DemangleOptions DemangleOptions;
-  DemangleOptions.SynthesizeSugarOnTypes = true;
   return swift_demangle_getDemangledName_Options(MangledName, OutputBuffer,
-                                                 Length, DemangleOptions);
+                                                 Length, getDefaultOptions());
 }
 
 size_t swift_demangle_getSimplifiedDemangledName(const char *MangledName,
@@ -59,6 +83,32 @@ size_t swift_demangle_getSimplifiedDemangledName(const char *MangledName,
                                                  Length, Opts);
 }
 
+swift_demangle_context_t swift_demangle_createContext(void) {
+  return new swift_demangle_context_s();
+}
+
+void swift_demangle_disposeContext(swift_demangle_context_t Context) {
+  delete Context;
+}
+
+size_t swift_demangle_getDemangledNameInContext(
+    swift_demangle_context_t Context, const char *MangledName,
+    char *OutputBuffer, size_t Length) {
+  assert(Context != nullptr && "null context");
+  return swift_demangle_getDemangledName_Options(Context->Ctx, MangledName,
+                                                 OutputBuffer, Length,
+                                                 getDefaultOptions());
+}
+
+size_t swift_demangle_getSimplifiedDemangledNameInContext(
+    swift_demangle_context_t Context, const char *MangledName,
+    char *OutputBuffer, size_t Length) {
+  assert(Context != nullptr && "null context");
+  auto Opts = swift::Demangle::DemangleOptions::SimplifiedUIDemangleOptions();
+  return swift_demangle_getDemangledName_Options(Context->Ctx, MangledName,
+                                                 OutputBuffer, Length, Opts);
+}
+
 size_t fnd_get_demangled_name(const char *MangledName, char *OutputBuffer,
                               size_t Length) {
   return swift_demangle_getDemangledName(MangledName, OutputBuffer, Length);
@@ -0,0 +1,268 @@
+//===--- HeapGraph.cpp - Object graph of a Swift heap ---------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Computes dominators and retained sizes for a HeapGraph, using the
+// iterative algorithm from Cooper, Harvey and Kennedy, "A Simple, Fast
+// Dominance Algorithm".
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/Reflection/HeapGraph.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+#include <iostream>
+
+using namespace swift;
+using namespace reflection;
+
+HeapGraph::TypeID HeapGraph::getType(const std::string &Name) {
+  auto found = TypesByName.find(Name);
+  if (found != TypesByName.end())
+    return found->second;
+
+  TypeID ID = Types.size();
+  Types.emplace_back();
+  Types.back().Name = Name;
+  TypesByName.insert({Name, ID});
+  return ID;
+}
+
+HeapGraph::NodeID HeapGraph::addNode(uint64_t Address, TypeID Type,
+                                     uint64_t Size) {
+  assert(Type < Types.size() && "Unknown type");
+  Types[Type].InstanceCount++;
+  Types[Type].ShallowSize += Size;
+  Nodes.push_back({Address, Type, Size, 0});
+  return Nodes.size() - 1;
+}
+
+namespace {
+
+/// The edges of a graph in compressed sparse row form.
+class Adjacency {
+  std::vector<unsigned> Begin;
+  std::vector<unsigned> Targets;
+
+public:
+  Adjacency(unsigned NumNodes,
+            const std::vector<std::pair<unsigned, unsigned>> &Edges)
+      : Begin(NumNodes + 1), Targets(Edges.size()) {
+    for (auto &Edge : Edges)
+      Begin[Edge.first + 1]++;
+    for (unsigned i = 0; i < NumNodes; ++i)
+      Begin[i + 1] += Begin[i];
+    auto Next = Begin;
+    for (auto &Edge : Edges)
+      Targets[Next[Edge.first]++] = Edge.second;
+  }
+
+  const unsigned *begin(unsigned Node) const {
+    return Targets.data() + Begin[Node];
+  }
+  const unsigned *end(unsigned Node) const {
+    return Targets.data() + Begin[Node + 1];
+  }
+};
+
+} // end anonymous namespace
+
+void HeapGraph::computeRetainedSizes() {
+  // Node number NumNodes is a virtual root, which references the roots.
+  const unsigned NumNodes = Nodes.size();
+  const unsigned VirtualRoot = NumNodes;
+  const unsigned Undefined = ~0U;
+
+  // Nodes nobody references are roots, too.
+  std::vector<bool> HasPredecessor(NumNodes);
+  for (auto &Edge : Edges)
+    if (Edge.first != Edge.second)
+      HasPredecessor[Edge.second] = true;
+
+  std::vector<std::pair<unsigned, unsigned>> AllEdges(Edges);
+  for (auto Root : Roots)
+    AllEdges.push_back({VirtualRoot, Root});
+  for (unsigned i = 0; i < NumNodes; ++i)
+    if (!HasPredecessor[i])
+      AllEdges.push_back({VirtualRoot, i});
+
+  // Number the nodes in depth-first postorder. Cycles which are not
+  // reachable from any root get one of their nodes as a root.
+  std::vector<unsigned> PostOrderNumber(NumNodes + 1, Undefined);
+  std::vector<unsigned> PostOrder;
+  std::vector<bool> Visited(NumNodes + 1);
+  std::vector<std::pair<unsigned, const unsigned *>> Stack;
+
+  auto visit = [&](const Adjacency &Successors, unsigned Start) {
+    Visited[Start] = true;
+    Stack.push_back({Start, Successors.begin(Start)});
+    while (!Stack.empty()) {
+      unsigned Node = Stack.back().first;
+      auto &Next = Stack.back().second;
+      if (Next != Successors.end(Node)) {
+        unsigned Succ = *Next++;
+        if (!Visited[Succ]) {
+          Visited[Succ] = true;
+          Stack.push_back({Succ, Successors.begin(Succ)});
+        }
+        continue;
+      }
+      PostOrderNumber[Node] = PostOrder.size();
+      PostOrder.push_back(Node);
+      Stack.pop_back();
+    }
+  };
+
+  {
+    Adjacency Successors(NumNodes + 1, AllEdges);
+    Visited[VirtualRoot] = true;
+    for (auto *i = Successors.begin(VirtualRoot),
+              *e = Successors.end(VirtualRoot); i != e; ++i)
+      if (!Visited[*i])
+        visit(Successors, *i);
+    for (unsigned i = 0; i < NumNodes; ++i) {
+      if (Visited[i])
+        continue;
+      AllEdges.push_back({VirtualRoot, i});
+      visit(Successors, i);
+    }
+    PostOrderNumber[VirtualRoot] = PostOrder.size();
+    PostOrder.push_back(VirtualRoot);
+  }
+
+  std::vector<std::pair<unsigned, unsigned>> ReversedEdges;
+  ReversedEdges.reserve(AllEdges.size());
+  for (auto &Edge : AllEdges)
+    ReversedEdges.push_back({Edge.second, Edge.first});
+  Adjacency Predecessors(NumNodes + 1, ReversedEdges);
+
+  std::vector<unsigned> IDom(NumNodes + 1, Undefined);
+  IDom[VirtualRoot] = VirtualRoot;
+
+  auto intersect = [&](unsigned A, unsigned B) {
+    while (A != B) {
+      while (PostOrderNumber[A] < PostOrderNumber[B])
+        A = IDom[A];
+      while (PostOrderNumber[B] < PostOrderNumber[A])
+        B = IDom[B];
+    }
+    return A;
+  };
+
+  bool Changed = true;
+  while (Changed) {
+    Changed = false;
+    // Visit the nodes in reverse postorder, skipping the virtual root.
+    for (auto i = PostOrder.rbegin() + 1, e = PostOrder.rend(); i != e; ++i) {
+      unsigned Node = *i;
+      unsigned NewIDom = Undefined;
+      for (auto *p = Predecessors.begin(Node), *pe = Predecessors.end(Node);
+           p != pe; ++p) {
+        if (IDom[*p] == Undefined)
+          continue;
+        NewIDom = NewIDom == Undefined ? *p : intersect(*p, NewIDom);
+      }
+      if (IDom[Node] != NewIDom) {
+        IDom[Node] = NewIDom;
+        Changed = true;
+      }
+    }
+  }
+
+  Dominators.resize(NumNodes);
+  for (unsigned i = 0; i < NumNodes; ++i)
+    Dominators[i] = IDom[i] == VirtualRoot ? i : IDom[i];
+
+  // A dominator comes after the nodes it dominates in postorder, so one
+  // pass accumulates the retained sizes bottom up.
+  for (auto &Node : Nodes)
+    Node.RetainedSize = Node.Size;
+  for (unsigned Node : PostOrder) {
+    if (Node == VirtualRoot || IDom[Node] == VirtualRoot)
+      continue;
+    Nodes[IDom[Node]].RetainedSize += Nodes[Node].RetainedSize;
+  }
+
+  // An instance only adds to the retained size of its type if it isn't
+  // dominated by another instance of the same type, whose retained size
+  // includes it already.
+  for (auto &Type : Types)
+    Type.RetainedSize = 0;
+  std::vector<std::pair<unsigned, unsigned>> DominatorTreeEdges;
+  DominatorTreeEdges.reserve(NumNodes);
+  for (unsigned i = 0; i < NumNodes; ++i)
+    DominatorTreeEdges.push_back({IDom[i], i});
+  Adjacency Children(NumNodes + 1, DominatorTreeEdges);
+
+  std::vector<unsigned> ActiveInstances(Types.size());
+  std::vector<std::pair<unsigned, const unsigned *>> TreeStack;
+  TreeStack.push_back({VirtualRoot, Children.begin(VirtualRoot)});
+  while (!TreeStack.empty()) {
+    unsigned Node = TreeStack.back().first;
+    auto &Next = TreeStack.back().second;
+    if (Next != Children.end(Node)) {
+      unsigned Child = *Next++;
+      auto Type = Nodes[Child].Type;
+      if (ActiveInstances[Type]++ == 0)
+        Types[Type].RetainedSize += Nodes[Child].RetainedSize;
+      TreeStack.push_back({Child, Children.begin(Child)});
+      continue;
+    }
+    if (Node != VirtualRoot)
+      ActiveInstances[Nodes[Node].Type]--;
+    TreeStack.pop_back();
+  }
+}
+
+std::vector<HeapGraph::TypeID> HeapGraph::getTypesByRetainedSize() const {
+  std::vector<TypeID> Result;
+  for (TypeID i = 0, e = Types.size(); i != e; ++i)
+    Result.push_back(i);
+  std::stable_sort(Result.begin(), Result.end(), [&](TypeID A, TypeID B) {
+    return Types[A].RetainedSize > Types[B].RetainedSize;
+  });
+  return Result;
+}
+
+void HeapGraph::dumpTypeStatistics(std::ostream &OS) const {
+  OS << std::setw(10) << "instances" << ' '
+     << std::setw(14) << "shallow bytes" << ' '
+     << std::setw(14) << "retained bytes" << "  type\n";
+  for (auto ID : getTypesByRetainedSize()) {
+    auto &Type = Types[ID];
+    OS << std::setw(10) << Type.InstanceCount << ' '
+       << std::setw(14) << Type.ShallowSize << ' '
+       << std::setw(14) << Type.RetainedSize << "  " << Type.Name << '\n';
+  }
+}
+
+void HeapGraph::writeGraph(std::ostream &OS) const {
+  OS << "types " << Types.size() << '\n';
+  for (TypeID i = 0, e = Types.size(); i != e; ++i) {
+    auto &Type = Types[i];
+    OS << i << ' ' << Type.InstanceCount << ' ' << Type.ShallowSize << ' '
+       << Type.RetainedSize << ' ' << Type.Name << '\n';
+  }
+
+  OS << "nodes " << Nodes.size() << '\n';
+  for (NodeID i = 0, e = Nodes.size(); i != e; ++i) {
+    auto &Node = Nodes[i];
+    OS << i << " 0x" << std::hex << Node.Address << std::dec << ' '
+       << Node.Type << ' ' << Node.Size << ' ' << Node.RetainedSize << ' '
+       << (i < Dominators.size() ? Dominators[i] : i) << '\n';
+  }
+
+  OS << "edges " << Edges.size() << '\n';
+  for (auto &Edge : Edges)
+    OS << Edge.first << ' ' << Edge.second << '\n';
+}
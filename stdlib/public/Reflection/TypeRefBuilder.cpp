@@ -28,6 +28,43 @@ using namespace reflection;
 
 TypeRefBuilder::TypeRefBuilder() : TC(*this) {}
 
+void TypeRefBuilder::indexReflectionInfos() {
+  // If several images describe the same type, the first one wins, as it did
+  // when we searched the sections in order.
+  for (auto e = ReflectionInfos.size(); NumIndexedReflectionInfos != e;
+       ++NumIndexedReflectionInfos) {
+    const auto &Info = ReflectionInfos[NumIndexedReflectionInfos];
+
+    for (auto &FD : Info.fieldmd) {
+      if (!FD.hasMangledTypeName())
+        continue;
+      FieldDescriptors.insert({FD.getMangledTypeName(), &FD});
+    }
+
+    for (auto &AssocTyDescriptor : Info.assocty) {
+      auto ConformingName = AssocTyDescriptor.getMangledConformingTypeName();
+      AssociatedTypeDescriptors[ConformingName].push_back(&AssocTyDescriptor);
+    }
+
+    for (auto &BuiltinTypeDescriptor : Info.builtin) {
+      assert(BuiltinTypeDescriptor.Size > 0);
+      assert(BuiltinTypeDescriptor.Alignment > 0);
+      assert(BuiltinTypeDescriptor.Stride > 0);
+      if (!BuiltinTypeDescriptor.hasMangledTypeName())
+        continue;
+      BuiltinTypeDescriptors.insert(
+        {BuiltinTypeDescriptor.getMangledTypeName(), &BuiltinTypeDescriptor});
+    }
+
+    for (auto &CD : Info.capture) {
+      auto RemoteAddr = ((uintptr_t) &CD -
+                         Info.LocalStartAddress +
+                         Info.RemoteStartAddress);
+      CaptureDescriptors.insert({RemoteAddr, &CD});
+    }
+  }
+}
+
 const TypeRef * TypeRefBuilder::
 lookupTypeWitness(const std::string &MangledTypeName,
                   const std::string &Member,
@@ -40,32 +77,34 @@ lookupTypeWitness(const std::string &MangledTypeName,
   if (found != AssociatedTypeCache.end())
     return found->second;
 
-  // Cache missed - we need to look through all of the assocty sections
-  // for all images that we've been notified about.
-  for (auto &Info : ReflectionInfos) {
-    for (const auto &AssocTyDescriptor : Info.assocty) {
-      std::string ConformingTypeName(AssocTyDescriptor.ConformingTypeName);
-      if (ConformingTypeName.compare(MangledTypeName) != 0)
-        continue;
+  // Cache missed - we need to look through the assocty descriptors for the
+  // conforming type in all images that we've been notified about.
+  indexReflectionInfos();
+  auto Descriptors = AssociatedTypeDescriptors.find(MangledTypeName);
+  if (Descriptors == AssociatedTypeDescriptors.end())
+    return nullptr;
 
-      std::string ProtocolMangledName(AssocTyDescriptor.ProtocolTypeName);
-      auto DemangledProto = Demangle::demangleTypeAsNode(ProtocolMangledName);
-      auto TR = swift::remote::decodeMangledType(*this, DemangledProto);
+  for (auto *AssocTyDescriptor : Descriptors->second) {
+    std::string ProtocolMangledName(AssocTyDescriptor->ProtocolTypeName);
+    Demangle::NodeFactory Factory;
+    auto DemangledProto = Demangle::demangleTypeAsNode(ProtocolMangledName,
+                                                       Factory);
+    auto TR = swift::remote::decodeMangledType(*this, DemangledProto);
 
-      if (Protocol != TR)
-        continue;
+    if (Protocol != TR)
+      continue;
 
-      for (auto &AssocTy : AssocTyDescriptor) {
-        if (Member.compare(AssocTy.getName()) != 0)
-          continue;
+    for (auto &AssocTy : *AssocTyDescriptor) {
+      if (Member.compare(AssocTy.getName()) != 0)
+        continue;
 
-        auto SubstitutedTypeName = AssocTy.getMangledSubstitutedTypeName();
-        auto Demangled = Demangle::demangleTypeAsNode(SubstitutedTypeName);
-        auto *TypeWitness = swift::remote::decodeMangledType(*this, Demangled);
+      auto SubstitutedTypeName = AssocTy.getMangledSubstitutedTypeName();
+      auto Demangled = Demangle::demangleTypeAsNode(SubstitutedTypeName,
+                                                    Factory);
+      auto *TypeWitness = swift::remote::decodeMangledType(*this, Demangled);
 
-        AssociatedTypeCache.insert(std::make_pair(key, TypeWitness));
-        return TypeWitness;
-      }
+      AssociatedTypeCache.insert(std::make_pair(key, TypeWitness));
+      return TypeWitness;
     }
   }
   return nullptr;
@@ -109,18 +148,11 @@ TypeRefBuilder::getFieldTypeInfo(const TypeRef *TR) {
     return {};
 
   std::vector<std::pair<std::string, const TypeRef *>> Fields;
-  for (auto Info : ReflectionInfos) {
-    for (auto &FD : Info.fieldmd) {
-      if (!FD.hasMangledTypeName())
-        continue;
-      auto CandidateMangledName = FD.getMangledTypeName();
-      if (MangledName.compare(CandidateMangledName) != 0)
-        continue;
-      return &FD;
-    }
-  }
-
-  return nullptr;
+  indexReflectionInfos();
+  auto found = FieldDescriptors.find(MangledName);
+  if (found == FieldDescriptors.end())
+    return nullptr;
+  return found->second;
 }
 
 std::vector<FieldTypeInfo>
@@ -140,8 +172,9 @@ TypeRefBuilder::getFieldTypeRefs(const TypeRef *TR, const FieldDescriptor *FD) {
       continue;
     }
 
+    Demangle::NodeFactory Factory;
     auto Demangled
-      = Demangle::demangleTypeAsNode(Field.getMangledTypeName());
+      = Demangle::demangleTypeAsNode(Field.getMangledTypeName(), Factory);
     auto Unsubstituted = swift::remote::decodeMangledType(*this, Demangled);
     if (!Unsubstituted)
       return {};
@@ -168,36 +201,20 @@ TypeRefBuilder::getBuiltinTypeInfo(const TypeRef *TR) {
   else
     return nullptr;
 
-  for (auto Info : ReflectionInfos) {
-    for (auto &BuiltinTypeDescriptor : Info.builtin) {
-      assert(BuiltinTypeDescriptor.Size > 0);
-      assert(BuiltinTypeDescriptor.Alignment > 0);
-      assert(BuiltinTypeDescriptor.Stride > 0);
-      if (!BuiltinTypeDescriptor.hasMangledTypeName())
-        continue;
-      auto CandidateMangledName = BuiltinTypeDescriptor.getMangledTypeName();
-      if (MangledName.compare(CandidateMangledName) != 0)
-        continue;
-      return &BuiltinTypeDescriptor;
-    }
-  }
-
-  return nullptr;
+  indexReflectionInfos();
+  auto found = BuiltinTypeDescriptors.find(MangledName);
+  if (found == BuiltinTypeDescriptors.end())
+    return nullptr;
+  return found->second;
 }
 
 const CaptureDescriptor *
 TypeRefBuilder::getCaptureDescriptor(uintptr_t RemoteAddress) {
-  for (auto Info : ReflectionInfos) {
-    for (auto &CD : Info.capture) {
-      auto OtherAddr = ((uintptr_t) &CD -
-                        Info.LocalStartAddress +
-                        Info.RemoteStartAddress);
-      if (OtherAddr == RemoteAddress)
-        return &CD;
-    }
-  }
-
-  return nullptr;
+  indexReflectionInfos();
+  auto found = CaptureDescriptors.find(RemoteAddress);
+  if (found == CaptureDescriptors.end())
+    return nullptr;
+  return found->second;
 }
 
 /// Get the unsubstituted capture types for a closure context.
@@ -209,7 +226,8 @@ TypeRefBuilder::getClosureContextInfo(const CaptureDescriptor &CD) {
     const TypeRef *TR = nullptr;
     if (i->hasMangledTypeName()) {
       auto MangledName = i->getMangledTypeName();
-      auto DemangleTree = Demangle::demangleTypeAsNode(MangledName);
+      Demangle::NodeFactory Factory;
+      auto DemangleTree = Demangle::demangleTypeAsNode(MangledName, Factory);
       TR = swift::remote::decodeMangledType(*this, DemangleTree);
     }
     Info.CaptureTypes.push_back(TR);
@@ -219,7 +237,8 @@ TypeRefBuilder::getClosureContextInfo(const CaptureDescriptor &CD) {
     const TypeRef *TR = nullptr;
     if (i->hasMangledTypeName()) {
       auto MangledName = i->getMangledTypeName();
-      auto DemangleTree = Demangle::demangleTypeAsNode(MangledName);
+      Demangle::NodeFactory Factory;
+      auto DemangleTree = Demangle::demangleTypeAsNode(MangledName, Factory);
       TR = swift::remote::decodeMangledType(*this, DemangleTree);
     }
 
@@ -247,7 +266,8 @@ TypeRefBuilder::dumpTypeRef(const std::string &MangledName,
   auto TypeName = Demangle::demangleTypeAsString(MangledName);
   OS << TypeName << '\n';
 
-  auto DemangleTree = Demangle::demangleTypeAsNode(MangledName);
+  Demangle::NodeFactory Factory;
+  auto DemangleTree = Demangle::demangleTypeAsNode(MangledName, Factory);
   auto TR = swift::remote::decodeMangledType(*this, DemangleTree);
   if (!TR) {
     OS << "!!! Invalid typeref: " << MangledName << '\n';
@@ -84,6 +84,7 @@ extension Array : _ObjectiveCBridgeable {
     return result != nil
   }
 
+  @_semantics("convertFromObjectiveC")
   public static func _unconditionallyBridgeFromObjectiveC(
     _ source: NSArray?
   ) -> Array {
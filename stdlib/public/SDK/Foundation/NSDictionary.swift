@@ -109,6 +109,7 @@ extension Dictionary : _ObjectiveCBridgeable {
     return result != nil
   }
 
+  @_semantics("convertFromObjectiveC")
   public static func _unconditionallyBridgeFromObjectiveC(
     _ d: NSDictionary?
   ) -> Dictionary {
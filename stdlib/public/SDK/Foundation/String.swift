@@ -50,6 +50,7 @@ extension String : _ObjectiveCBridgeable {
     return result != nil
   }
 
+  @_semantics("convertFromObjectiveC")
   public static func _unconditionallyBridgeFromObjectiveC(
     _ source: NSString?
   ) -> String {
@@ -13,6 +13,9 @@
 //===----------------------------------------------------------------------===//
 import Swift
 
+/// An instance of a class, to pre-specialize for elements of type `AnyObject`.
+internal final class _PrespecializedObject {}
+
 struct _Prespecialize {
   // Create specializations for the arrays of most
   // popular builtin integer and floating point types.
@@ -140,6 +143,90 @@ struct _Prespecialize {
     _createArrayUserWithoutSorting("a".utf16)
     _createArrayUserWithoutSorting("a".unicodeScalars)
     _createArrayUserWithoutSorting("a".characters)
+
+    // Force pre-specialization of arrays of existentials.
+    _createArrayUserWithoutSorting(1 as Any)
+    _createArrayUserWithoutSorting(_PrespecializedObject() as AnyObject)
+  }
+
+  // Create specializations for the dictionaries with the most popular key and
+  // value types.
+  static internal func _specializeDictionaries() {
+    func _createDictionaryUser<Key : Hashable, Value>(
+      _ sampleKey: Key, _ sampleValue: Value
+    ) {
+      // Initializers.
+      let _: [Key: Value] = [sampleKey: sampleValue]
+      var d = [Key: Value](minimumCapacity: 1)
+
+      // Insert, update and read elements
+      d[sampleKey] = sampleValue
+      let _ = d.updateValue(sampleValue, forKey: sampleKey)
+      let _ = d[sampleKey]
+      if let i = d.index(forKey: sampleKey) {
+        let _ = d[i]
+      }
+
+      // Get count
+      let _ = d.count
+
+      // Iterate over dictionary
+      for (k, v) in d {
+        print(k)
+        print(v)
+      }
+
+      print(d)
+
+      // Remove elements and reserve capacity
+      let _ = d.removeValue(forKey: sampleKey)
+      d.removeAll()
+      d.reserveCapacity(100)
+    }
+
+    func _createDictionaryUsers<Key : Hashable>(_ sampleKey: Key) {
+      _createDictionaryUser(sampleKey, 1 as Int)
+      _createDictionaryUser(sampleKey, 1.5 as Double)
+      _createDictionaryUser(sampleKey, "a" as String)
+      _createDictionaryUser(sampleKey, 1 as Any)
+      _createDictionaryUser(sampleKey, _PrespecializedObject() as AnyObject)
+    }
+
+    _createDictionaryUsers(1 as Int)
+    _createDictionaryUsers("a" as String)
+  }
+
+  // Create specializations for the sets of the most popular element types.
+  static internal func _specializeSets() {
+    func _createSetUser<Element : Hashable>(_ sampleValue: Element) {
+      // Initializers.
+      let _: Set<Element> = [sampleValue]
+      var s = Set<Element>(minimumCapacity: 1)
+
+      // Insert and look up elements
+      s.insert(sampleValue)
+      let _ = s.update(with: sampleValue)
+      let _ = s.contains(sampleValue)
+
+      // Get count
+      let _ = s.count
+
+      // Iterate over set
+      for e in s {
+        print(e)
+      }
+
+      print(s)
+
+      // Remove elements and reserve capacity
+      let _ = s.remove(sampleValue)
+      s.removeAll()
+      s.reserveCapacity(100)
+    }
+
+    _createSetUser(1 as Int)
+    _createSetUser(1.5 as Double)
+    _createSetUser("a" as String)
   }
 
   // Force pre-specialization of Range<Int>
@@ -164,5 +251,7 @@ struct _Prespecialize {
 @_semantics("optimize.sil.never")
 internal func _swift_forcePrespecializations() {
   _Prespecialize._specializeArrays()
+  _Prespecialize._specializeDictionaries()
+  _Prespecialize._specializeSets()
   _Prespecialize._specializeRanges()
 }
@@ -14,6 +14,7 @@
 #include "swift/Reflection/ReflectionContext.h"
 #include "swift/Reflection/TypeLowering.h"
 #include "swift/Remote/CMemoryReader.h"
+#include "swift/Remote/CachingMemoryReader.h"
 #include "swift/SwiftRemoteMirror/SwiftRemoteMirror.h"
 
 using namespace swift;
@@ -50,6 +51,34 @@ swift_reflection_createReflectionContext(void *ReaderContext,
   return reinterpret_cast<SwiftReflectionContextRef>(Context);
 }
 
+SwiftReflectionContextRef
+swift_reflection_createCachingReflectionContext(
+    void *ReaderContext,
+    PointerSizeFunction getPointerSize,
+    SizeSizeFunction getSizeSize,
+    ReadBytesFunction readBytes,
+    GetStringLengthFunction getStringLength,
+    GetSymbolAddressFunction getSymbolAddress) {
+  MemoryReaderImpl ReaderImpl {
+    ReaderContext,
+    getPointerSize,
+    getSizeSize,
+    readBytes,
+    getStringLength,
+    getSymbolAddress
+  };
+
+  auto Reader = std::make_shared<CachingMemoryReader>(
+    std::make_shared<CMemoryReader>(ReaderImpl));
+  auto Context = new NativeReflectionContext(Reader);
+  return reinterpret_cast<SwiftReflectionContextRef>(Context);
+}
+
+void swift_reflection_clearCaches(SwiftReflectionContextRef ContextRef) {
+  auto Context = reinterpret_cast<NativeReflectionContext *>(ContextRef);
+  Context->clear();
+}
+
 void swift_reflection_destroyReflectionContext(SwiftReflectionContextRef ContextRef) {
   auto Context = reinterpret_cast<swift::reflection::ReflectionContext<InProcess> *>(ContextRef);
   delete Context;
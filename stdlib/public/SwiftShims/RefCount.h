@@ -393,13 +393,16 @@ private:
 
 
 // Weak reference count.
+//
+// Despite its name, this counts unowned references. Weak references point
+// at an out-of-line side table, whose existence is recorded by the flag.
 
 class WeakRefCount {
   uint32_t refCount;
 
   enum : uint32_t {
-    // There isn't really a flag here.
-    RC_UNUSED_FLAG = 1,
+    // Set once a weak reference side table has been created for the object.
+    RC_SIDE_TABLE_FLAG = 1,
 
     RC_FLAGS_COUNT = 1,
     RC_FLAGS_MASK = 1,
@@ -476,6 +479,21 @@ class WeakRefCount {
   uint32_t getCount() const {
     return __atomic_load_n(&refCount, __ATOMIC_RELAXED) >> RC_FLAGS_COUNT;
   }
+
+  // Record that the object has a weak reference side table, which must be
+  // cleared when the object is deallocated.
+  void setHasSideTable() {
+    __atomic_fetch_or(&refCount, RC_SIDE_TABLE_FLAG, __ATOMIC_RELAXED);
+  }
+
+  // Record that the object's side table has been detached from it.
+  void clearHasSideTable() {
+    __atomic_fetch_and(&refCount, ~RC_SIDE_TABLE_FLAG, __ATOMIC_RELAXED);
+  }
+
+  bool hasSideTable() const {
+    return __atomic_load_n(&refCount, __ATOMIC_RELAXED) & RC_SIDE_TABLE_FLAG;
+  }
 };
 
 static_assert(swift::IsTriviallyConstructible<StrongRefCount>::value,
@@ -39,6 +39,19 @@ SWIFT_RUNTIME_STDLIB_INTERFACE
 void
 _swift_stdlib_overrideUnsafeArgvArgc(char * _Nullable * _Nonnull argv, int argc);
 
+/// Calls body(context, i) for every i in 0..<count, on the calling thread and
+/// on a shared pool of worker threads, and returns once all calls are done.
+SWIFT_RUNTIME_STDLIB_INTERFACE
+void
+_swift_stdlib_parallelFor(__swift_intptr_t count, void * _Nonnull context,
+                          void (* _Nonnull body)(void * _Nonnull context,
+                                                 __swift_intptr_t index));
+
+/// Returns the number of threads _swift_stdlib_parallelFor runs on.
+SWIFT_RUNTIME_STDLIB_INTERFACE
+__swift_intptr_t
+_swift_stdlib_getParallelism(void);
+
 SWIFT_END_NULLABILITY_ANNOTATIONS
 
 #ifdef __cplusplus
@@ -109,6 +109,64 @@ __swift_int32_t _swift_stdlib_unicode_strToLower(
   __swift_uint16_t *Destination, __swift_int32_t DestinationCapacity,
   const __swift_uint16_t *Source, __swift_int32_t SourceLength);
 
+/// Returns the number of leading ASCII code units in the given UTF-8 buffer.
+SWIFT_RUNTIME_STDLIB_INTERFACE
+__attribute__((__pure__)) __swift_intptr_t
+_swift_stdlib_utf8_countLeadingASCII(const __swift_uint8_t *Source,
+                                     __swift_intptr_t SourceLength);
+
+/// Returns the number of leading ASCII code units in the given UTF-16 buffer.
+SWIFT_RUNTIME_STDLIB_INTERFACE
+__attribute__((__pure__)) __swift_intptr_t
+_swift_stdlib_utf16_countLeadingASCII(const __swift_uint16_t *Source,
+                                      __swift_intptr_t SourceLength);
+
+/// Zero-extends `Count` ASCII code units into UTF-16 code units.
+SWIFT_RUNTIME_STDLIB_INTERFACE
+void _swift_stdlib_widenASCII(__swift_uint16_t *Destination,
+                              const __swift_uint8_t *Source,
+                              __swift_intptr_t Count);
+
+/// Truncates `Count` UTF-16 code units, which must all be ASCII, into
+/// single bytes.
+SWIFT_RUNTIME_STDLIB_INTERFACE
+void _swift_stdlib_narrowASCII(__swift_uint8_t *Destination,
+                               const __swift_uint16_t *Source,
+                               __swift_intptr_t Count);
+
+/// Validates the given UTF-8 buffer and returns the number of UTF-16 code
+/// units needed to represent it, or -1 if it contains an ill-formed code unit
+/// sequence. `IsASCII` is set if all code units are ASCII.
+SWIFT_RUNTIME_STDLIB_INTERFACE
+__attribute__((__pure__)) __swift_intptr_t
+_swift_stdlib_utf8_validatedUTF16Length(const __swift_uint8_t *Source,
+                                        __swift_intptr_t SourceLength,
+                                        __swift_bool *IsASCII);
+
+/// Transcodes well-formed UTF-8 into UTF-16 and returns the number of UTF-16
+/// code units written. The input must have been validated with
+/// `_swift_stdlib_utf8_validatedUTF16Length`.
+SWIFT_RUNTIME_STDLIB_INTERFACE
+__swift_intptr_t
+_swift_stdlib_utf8_transcodeToUTF16(__swift_uint16_t *Destination,
+                                    const __swift_uint8_t *Source,
+                                    __swift_intptr_t SourceLength);
+
+/// Returns the number of UTF-8 code units needed to represent the given UTF-16
+/// buffer, where each unpaired surrogate is replaced by U+FFFD.
+SWIFT_RUNTIME_STDLIB_INTERFACE
+__attribute__((__pure__)) __swift_intptr_t
+_swift_stdlib_utf16_utf8Length(const __swift_uint16_t *Source,
+                               __swift_intptr_t SourceLength);
+
+/// Transcodes UTF-16 into UTF-8, replacing each unpaired surrogate by U+FFFD,
+/// and returns the number of UTF-8 code units written.
+SWIFT_RUNTIME_STDLIB_INTERFACE
+__swift_intptr_t
+_swift_stdlib_utf16_transcodeToUTF8(__swift_uint8_t *Destination,
+                                    const __swift_uint16_t *Source,
+                                    __swift_intptr_t SourceLength);
+
 #ifdef __cplusplus
 }} // extern "C", namespace swift
 #endif
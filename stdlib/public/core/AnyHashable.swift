@@ -143,6 +143,15 @@ public struct AnyHashable {
   ///
   /// - Parameter base: A hashable value to wrap.
   public init<H : Hashable>(_ base: H) {
+    // The most common types are never bridged to a custom representation
+    // and don't need upcasting, so skip the dynamic casts for them. These
+    // checks fold away once `H` is known.
+    if H.self == String.self || H.self == Int.self || H.self == Double.self {
+      self._box = _ConcreteHashableBox(base)
+      self._usedCustomRepresentation = false
+      return
+    }
+
     if let customRepresentation =
       (base as? _HasCustomAnyHashableRepresentation)?._toCustomAnyHashable() {
       self = customRepresentation
@@ -157,6 +157,20 @@ extension _ArrayBufferProtocol {
       // so as not to self-clobber.
       newTailStart.moveInitialize(from: oldTailStart, count: tailCount)
 
+      // Copy contiguous new elements in bulk: assign over the original
+      // subrange, then initialize the hole left by sliding the tail forward.
+      if let copied = newValues.withContiguousStorageIfAvailable({
+        source -> Bool in
+        _precondition(source.count == newCount,
+          "invalid Collection: count differed in successive traversals")
+        let base = source.baseAddress!
+        (elements + subrange.lowerBound).assign(from: base, count: eraseCount)
+        oldTailStart.initialize(from: base + eraseCount, count: growth)
+        return true
+      }), copied {
+        return
+      }
+
       // Assign over the original subrange
       var i = newValues.startIndex
       for j in CountableRange(subrange) {
@@ -172,14 +186,25 @@ extension _ArrayBufferProtocol {
     }
     else { // We're not growing the buffer
       // Assign all the new elements into the start of the subrange
-      var i = subrange.lowerBound
-      var j = newValues.startIndex
-      for _ in 0..<newCount {
-        elements[i] = newValues[j]
-        i += 1
-        newValues.formIndex(after: &j)
+      let copied = newValues.withContiguousStorageIfAvailable {
+        source -> Bool in
+        _precondition(source.count == newCount,
+          "invalid Collection: count differed in successive traversals")
+        if let base = source.baseAddress {
+          (elements + subrange.lowerBound).assign(from: base, count: newCount)
+        }
+        return true
+      }
+      if copied == nil {
+        var i = subrange.lowerBound
+        var j = newValues.startIndex
+        for _ in 0..<newCount {
+          elements[i] = newValues[j]
+          i += 1
+          newValues.formIndex(after: &j)
+        }
+        _expectEnd(of: newValues, is: j)
       }
-      _expectEnd(of: newValues, is: j)
 
       // If the size didn't change, we're done.
       if growth == 0 {
@@ -159,6 +159,57 @@ extension String {
       repairingInvalidCodeUnits: isRepairing)
   }
 
+  /// Creates a new string from the UTF-8 data at the start of the given
+  /// buffer, taking ownership of the buffer.
+  ///
+  /// When the first `count` bytes of `buffer` are ASCII and `buffer` has room
+  /// for at least one more byte, the new string uses `buffer` as its storage
+  /// without copying it; `deallocator` is called with `buffer` after the last
+  /// string that refers to it is destroyed. Otherwise, the UTF-8 data is
+  /// transcoded into new storage and `deallocator` is called before this
+  /// initializer returns. Ill-formed UTF-8 code unit sequences are replaced
+  /// with the Unicode replacement character (`"\u{FFFD}"`).
+  ///
+  /// The following example creates a string from a buffer that was filled by
+  /// a call to `read(2)`:
+  ///
+  ///     let buffer = UnsafeMutableRawBufferPointer(
+  ///       start: malloc(4096), count: 4096)
+  ///     let n = read(fd, buffer.baseAddress, buffer.count)
+  ///     let s = String(adoptingUTF8: buffer, count: n) {
+  ///       free($0.baseAddress)
+  ///     }
+  ///
+  /// The contents of `buffer` must not be modified while any string refers to
+  /// them.
+  ///
+  /// - Parameters:
+  ///   - buffer: The memory to adopt.
+  ///   - count: The number of initialized UTF-8 code units at the start of
+  ///     `buffer`. `count` must not be greater than `buffer.count`.
+  ///   - deallocator: A closure that releases `buffer`.
+  public init(
+    adoptingUTF8 buffer: UnsafeMutableRawBufferPointer, count: Int,
+    deallocator: @escaping (UnsafeMutableRawBufferPointer) -> Void
+  ) {
+    _precondition(count >= 0 && count <= buffer.count,
+      "String(adoptingUTF8:) count exceeds the buffer size")
+    guard let base = buffer.baseAddress, count > 0 else {
+      deallocator(buffer)
+      self = ""
+      return
+    }
+    let utf8 = base.assumingMemoryBound(to: UTF8.CodeUnit.self)
+    if count < buffer.count &&
+       _swift_stdlib_utf8_countLeadingASCII(utf8, count) == count {
+      self = String(_StringBuffer._adoptingASCII(
+        buffer, count: count, deallocator: deallocator))
+      return
+    }
+    defer { deallocator(buffer) }
+    self = _decodeCString(utf8, as: UTF8.self, length: count,
+      repairingInvalidCodeUnits: true)!.result
+  }
 }
 
 /// From a non-`nil` `UnsafePointer` to a null-terminated string
@@ -186,6 +237,17 @@ func _decodeCString<Encoding : UnicodeCodec>(
   repairingInvalidCodeUnits isRepairing: Bool = true)
 -> (result: String, repairsMade: Bool)? {
 
+  // Well-formed UTF-8 is validated and transcoded by the vectorized stubs.
+  if encoding == UTF8.self {
+    let utf8 = UnsafeBufferPointer(
+      start: UnsafeRawPointer(cString).assumingMemoryBound(
+        to: UTF8.CodeUnit.self),
+      count: length)
+    if let stringBuffer = _StringBuffer._fromWellFormedUTF8(utf8) {
+      return (result: String(_storage: stringBuffer), repairsMade: false)
+    }
+  }
+
   let buffer = UnsafeBufferPointer<Encoding.CodeUnit>(
     start: cString, count: length)
 
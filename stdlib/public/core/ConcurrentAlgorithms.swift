@@ -0,0 +1,351 @@
+//===--- ConcurrentAlgorithms.swift ---------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Variants of map, forEach, reduce and sorted that process the elements of a
+// random-access collection on several threads at once.
+//
+// The elements are split into chunks whose bounds depend only on the number
+// of elements, and the chunks are run on the runtime's shared thread pool.
+// Results are always assembled in chunk order, so they don't depend on the
+// number of threads or on how the chunks happen to be scheduled.
+//
+//===----------------------------------------------------------------------===//
+
+import SwiftShims
+
+/// The context `_parallelFor` passes to `_swift_stdlib_parallelFor`.
+internal final class _ParallelForBody {
+  internal let body: (Int) -> Void
+
+  internal init(_ body: @escaping (Int) -> Void) {
+    self.body = body
+  }
+}
+
+/// Calls `body` with every integer in `0..<count`, on several threads at
+/// once, and returns when all of the calls have returned.
+internal func _parallelFor(_ count: Int, _ body: @escaping (Int) -> Void) {
+  let context = _ParallelForBody(body)
+  withExtendedLifetime(context) {
+    _swift_stdlib_parallelFor(
+      count, Unmanaged.passUnretained(context).toOpaque()
+    ) { rawContext, index in
+      Unmanaged<_ParallelForBody>.fromOpaque(rawContext)
+        .takeUnretainedValue().body(index)
+    }
+  }
+}
+
+/// Returns the number of chunks the concurrent algorithms split `count`
+/// elements into.
+///
+/// This only depends on `count`, and not on the number of threads, so that
+/// `concurrentReduce` combines the same partial results on every machine.
+/// 64 chunks keep all the cores of large machines busy even when chunks
+/// take different amounts of time, without making the scheduling of each
+/// chunk significant for small collections.
+internal func _concurrentChunkCount(_ count: Int) -> Int {
+  return Swift.min(count, 64)
+}
+
+/// Returns the offset of the first element of the given chunk, or `count`
+/// for `chunk == chunkCount`.
+internal func _concurrentChunkStart(
+  _ chunk: Int, chunkCount: Int, count: Int
+) -> Int {
+  let base = count / chunkCount
+  let remainder = count % chunkCount
+  return chunk * base + Swift.min(chunk, remainder)
+}
+
+extension RandomAccessCollection {
+  /// Calls `body` with the range of offsets of each chunk of the collection's
+  /// elements, on several threads at once.
+  internal func _forEachConcurrentChunk(
+    _ body: @escaping (Range<Int>) -> Void
+  ) {
+    let count: Int = numericCast(self.count)
+    let chunkCount = _concurrentChunkCount(count)
+    _parallelFor(chunkCount) { chunk in
+      body(
+        _concurrentChunkStart(chunk, chunkCount: chunkCount, count: count) ..<
+        _concurrentChunkStart(chunk + 1, chunkCount: chunkCount, count: count))
+    }
+  }
+
+  /// Returns an array containing the results of mapping the given closure
+  /// over the collection's elements, calling the closure on several threads
+  /// at once.
+  ///
+  /// The elements of the result are in the same order as the elements they
+  /// were computed from, as with `map(_:)`. Because the closure is called
+  /// concurrently, it must not access shared mutable state without
+  /// synchronization.
+  ///
+  ///     let squares = (1...100_000).concurrentMap { $0 * $0 }
+  ///
+  /// - Parameter transform: A mapping closure. `transform` accepts an
+  ///   element of this collection as its parameter and returns a transformed
+  ///   value of the same or of a different type.
+  /// - Returns: An array containing the transformed elements of this
+  ///   collection.
+  ///
+  /// - SeeAlso: `map(_:)`
+  public func concurrentMap<T>(
+    _ transform: @escaping (Iterator.Element) -> T
+  ) -> [T] {
+    let count: Int = numericCast(self.count)
+    if count == 0 {
+      return []
+    }
+
+    let result = _ContiguousArrayBuffer<T>(
+      _uninitializedCount: count,
+      minimumCapacity: 0)
+    let elements = result.firstElementAddress
+
+    _forEachConcurrentChunk { offsets in
+      var i = self.index(self.startIndex,
+                         offsetBy: numericCast(offsets.lowerBound))
+      for offset in offsets {
+        (elements + offset).initialize(to: transform(self[i]))
+        self.formIndex(after: &i)
+      }
+    }
+    return Array(ContiguousArray(_buffer: result))
+  }
+
+  /// Calls the given closure on each element of the collection, on several
+  /// threads at once.
+  ///
+  /// Unlike `forEach(_:)`, the elements are not visited in order. Because the
+  /// closure is called concurrently, it must not access shared mutable state
+  /// without synchronization.
+  ///
+  /// - Parameter body: A closure that takes an element of the collection as
+  ///   a parameter.
+  ///
+  /// - SeeAlso: `forEach(_:)`
+  public func concurrentForEach(
+    _ body: @escaping (Iterator.Element) -> Void
+  ) {
+    _forEachConcurrentChunk { offsets in
+      var i = self.index(self.startIndex,
+                         offsetBy: numericCast(offsets.lowerBound))
+      for _ in offsets {
+        body(self[i])
+        self.formIndex(after: &i)
+      }
+    }
+  }
+
+  /// Returns the result of combining the elements of the collection, working
+  /// on several parts of the collection on different threads at once.
+  ///
+  /// The elements are split into consecutive chunks. Each chunk is reduced
+  /// on its own, starting from `initialResult`, with `nextPartialResult`,
+  /// and then the results of the chunks are joined in order with `combine`.
+  /// For the result to be the same as that of `reduce(_:_:)`,
+  /// `initialResult` must be an identity of `combine`, and `combine` must be
+  /// associative. How the elements are split only depends on the number of
+  /// elements, so the result is the same every time, even for operations
+  /// such as floating-point addition that are only nearly associative.
+  ///
+  ///     let total = measurements.concurrentReduce(0, +, combining: +)
+  ///
+  /// Because the closures are called concurrently, they must not access
+  /// shared mutable state without synchronization.
+  ///
+  /// - Parameters:
+  ///   - initialResult: The value each chunk's partial result starts from.
+  ///   - nextPartialResult: A closure that combines a partial result and an
+  ///     element of the collection into a new partial result.
+  ///   - combine: A closure that joins the partial results of two adjacent
+  ///     chunks, the earlier one first.
+  /// - Returns: The final accumulated value. If the collection has no
+  ///   elements, the result is `initialResult`.
+  ///
+  /// - SeeAlso: `reduce(_:_:)`
+  public func concurrentReduce<Result>(
+    _ initialResult: Result,
+    _ nextPartialResult: @escaping (Result, Iterator.Element) -> Result,
+    combining combine: @escaping (Result, Result) -> Result
+  ) -> Result {
+    let count: Int = numericCast(self.count)
+    let chunkCount = _concurrentChunkCount(count)
+    if chunkCount == 0 {
+      return initialResult
+    }
+
+    let partialResults =
+      UnsafeMutablePointer<Result>.allocate(capacity: chunkCount)
+    defer { partialResults.deallocate(capacity: chunkCount) }
+
+    _parallelFor(chunkCount) { chunk in
+      let start = _concurrentChunkStart(chunk, chunkCount: chunkCount,
+                                        count: count)
+      let end = _concurrentChunkStart(chunk + 1, chunkCount: chunkCount,
+                                      count: count)
+      var i = self.index(self.startIndex, offsetBy: numericCast(start))
+      var partialResult = initialResult
+      for _ in start..<end {
+        partialResult = nextPartialResult(partialResult, self[i])
+        self.formIndex(after: &i)
+      }
+      (partialResults + chunk).initialize(to: partialResult)
+    }
+
+    var result = partialResults.move()
+    for chunk in 1..<chunkCount {
+      result = combine(result, (partialResults + chunk).move())
+    }
+    return result
+  }
+
+  /// Returns the elements of the collection, sorted using the given
+  /// predicate as the comparison between elements, sorting several parts of
+  /// the collection on different threads at once.
+  ///
+  /// The elements are split into consecutive chunks, which are sorted
+  /// concurrently and then merged. Like `sorted(by:)`, the sort is not
+  /// stable, but the result only depends on the elements and their order in
+  /// the collection, and is the same every time.
+  ///
+  /// The predicate must be a *strict weak ordering* over the elements, as
+  /// for `sorted(by:)`. Because it's called concurrently, it must not access
+  /// shared mutable state without synchronization.
+  ///
+  /// - Parameter areInIncreasingOrder: A predicate that returns `true` if its
+  ///   first argument should be ordered before its second argument;
+  ///   otherwise, `false`.
+  /// - Returns: A sorted array of the collection's elements.
+  ///
+  /// - SeeAlso: `sorted(by:)`
+  public func concurrentSorted(
+    by areInIncreasingOrder:
+      @escaping (Iterator.Element, Iterator.Element) -> Bool
+  ) -> [Iterator.Element] {
+    var result = ContiguousArray(self)
+    let count = result.count
+    let chunkCount = _concurrentChunkCount(count)
+    if chunkCount < 2 {
+      result.sort(by: areInIncreasingOrder)
+      return Array(result)
+    }
+
+    result.withUnsafeMutableBufferPointer { buffer in
+      let elements = buffer.baseAddress!
+      _parallelFor(chunkCount) { chunk in
+        let start = _concurrentChunkStart(chunk, chunkCount: chunkCount,
+                                          count: count)
+        let end = _concurrentChunkStart(chunk + 1, chunkCount: chunkCount,
+                                        count: count)
+        var sortedChunk = UnsafeMutableBufferPointer(
+          start: elements + start, count: end - start)
+        sortedChunk.sort(by: areInIncreasingOrder)
+      }
+      _concurrentMergeSortedChunks(
+        elements, count: count, chunkCount: chunkCount,
+        by: areInIncreasingOrder)
+    }
+    return Array(result)
+  }
+}
+
+extension RandomAccessCollection where Iterator.Element : Comparable {
+  /// Returns the elements of the collection, sorted, sorting several parts
+  /// of the collection on different threads at once.
+  ///
+  /// This is equivalent to calling `concurrentSorted(by:)` with the
+  /// less-than operator (`<`) as the predicate.
+  ///
+  /// - Returns: A sorted array of the collection's elements.
+  ///
+  /// - SeeAlso: `sorted()`, `concurrentSorted(by:)`
+  public func concurrentSorted() -> [Iterator.Element] {
+    return concurrentSorted(by: <)
+  }
+}
+
+/// Merges the sorted runs `lower..<middle` and `middle..<upper` of `source`
+/// into the same positions of `destination`, moving the elements.
+///
+/// Elements of the second run are only taken first if they are ordered
+/// strictly before the element of the first run, so equivalent elements
+/// keep their relative order.
+internal func _mergeMovingSortedRuns<T>(
+  from source: UnsafeMutablePointer<T>,
+  into destination: UnsafeMutablePointer<T>,
+  lower: Int, middle: Int, upper: Int,
+  by areInIncreasingOrder: (T, T) -> Bool
+) {
+  var i = lower
+  var j = middle
+  var k = lower
+  while i < middle && j < upper {
+    if areInIncreasingOrder(source[j], source[i]) {
+      (destination + k).moveInitialize(from: source + j, count: 1)
+      j += 1
+    } else {
+      (destination + k).moveInitialize(from: source + i, count: 1)
+      i += 1
+    }
+    k += 1
+  }
+  (destination + k).moveInitialize(from: source + i, count: middle - i)
+  k += middle - i
+  (destination + k).moveInitialize(from: source + j, count: upper - j)
+}
+
+/// Merges the sorted chunks of the `count` elements at `elements`, merging
+/// pairs of adjacent runs concurrently until one run is left.
+internal func _concurrentMergeSortedChunks<T>(
+  _ elements: UnsafeMutablePointer<T>,
+  count: Int,
+  chunkCount: Int,
+  by areInIncreasingOrder: @escaping (T, T) -> Bool
+) {
+  // The start of each run, followed by `count`.
+  var runStarts = (0...chunkCount).map {
+    _concurrentChunkStart($0, chunkCount: chunkCount, count: count)
+  }
+
+  let scratch = UnsafeMutablePointer<T>.allocate(capacity: count)
+  defer { scratch.deallocate(capacity: count) }
+
+  // Each round moves all the elements from one buffer to the other.
+  var source = elements
+  var destination = scratch
+  while runStarts.count > 2 {
+    let starts = runStarts
+    let runCount = starts.count - 1
+    let from = source
+    let to = destination
+    _parallelFor((runCount + 1) / 2) { pair in
+      // An odd run out is merged with an empty one, which just moves it.
+      _mergeMovingSortedRuns(
+        from: from, into: to,
+        lower: starts[2 * pair],
+        middle: starts[Swift.min(2 * pair + 1, runCount)],
+        upper: starts[Swift.min(2 * pair + 2, runCount)],
+        by: areInIncreasingOrder)
+    }
+
+    runStarts = stride(from: 0, to: runCount, by: 2).map { starts[$0] }
+    runStarts.append(count)
+    swap(&source, &destination)
+  }
+
+  if source != elements {
+    elements.moveInitialize(from: source, count: count)
+  }
+}
@@ -577,6 +577,17 @@ internal func _copyCollectionToContiguousArray<
     _uninitializedCount: count,
     minimumCapacity: 0)
 
+  if let copied = source.withContiguousStorageIfAvailable({
+    buffer -> Bool in
+    _precondition(buffer.count == count,
+      "invalid Collection: count differed in successive traversals")
+    result.firstElementAddress.initialize(
+      from: buffer.baseAddress!, count: count)
+    return true
+  }), copied {
+    return ContiguousArray(_buffer: result)
+  }
+
   var p = result.firstElementAddress
   var i = source.startIndex
   for _ in 0..<count {
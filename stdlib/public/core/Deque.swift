@@ -0,0 +1,511 @@
+//===--- Deque.swift ------------------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+/// The header of a deque's storage.
+internal struct _DequeHeader {
+  /// The number of element slots allocated.
+  internal var capacity: Int
+
+  /// The number of initialized elements.
+  internal var count: Int
+
+  /// The slot holding the first element.
+  internal var startSlot: Int
+}
+
+/// The ring buffer holding the elements of a `Deque`.
+///
+/// The elements occupy `count` consecutive slots starting at `startSlot`,
+/// wrapping around from the last slot to the first, so they form at most two
+/// contiguous segments.
+internal final class _DequeStorage<Element>
+  : ManagedBuffer<_DequeHeader, Element> {
+
+  internal class func _allocate(minimumCapacity: Int) -> _DequeStorage {
+    let buffer = self.create(minimumCapacity: minimumCapacity) {
+      _DequeHeader(capacity: $0.capacity, count: 0, startSlot: 0)
+    }
+    return unsafeDowncast(buffer, to: _DequeStorage.self)
+  }
+
+  deinit {
+    _deinitializeElements(0..<header.count)
+  }
+
+  /// Returns the slot holding the element at `offset` from the start.
+  internal func _slot(forOffset offset: Int) -> Int {
+    let slot = header.startSlot + offset
+    return slot >= header.capacity ? slot - header.capacity : slot
+  }
+
+  /// Returns the address of the element at `offset` from the start.
+  internal func _address(forOffset offset: Int) -> UnsafeMutablePointer<Element> {
+    return firstElementAddress + _slot(forOffset: offset)
+  }
+
+  /// The elements at offsets `bounds` as two contiguous segments, the second
+  /// of which is empty unless `bounds` wraps around the end of the buffer.
+  internal func _segments(_ bounds: Range<Int>) -> (
+    UnsafeMutableBufferPointer<Element>, UnsafeMutableBufferPointer<Element>
+  ) {
+    let start = _slot(forOffset: bounds.lowerBound)
+    let firstCount = Swift.min(bounds.count, header.capacity - start)
+    return (
+      UnsafeMutableBufferPointer(
+        start: firstElementAddress + start, count: firstCount),
+      UnsafeMutableBufferPointer(
+        start: firstElementAddress, count: bounds.count - firstCount))
+  }
+
+  /// Copies or moves the elements at offsets `bounds` into uninitialized
+  /// memory starting at `target`, returning a pointer past the last element
+  /// initialized.
+  @discardableResult
+  internal func _transferElements(
+    _ bounds: Range<Int>,
+    initializing target: UnsafeMutablePointer<Element>,
+    moving: Bool
+  ) -> UnsafeMutablePointer<Element> {
+    let (first, second) = _segments(bounds)
+    if moving {
+      target.moveInitialize(from: first.baseAddress!, count: first.count)
+      (target + first.count).moveInitialize(
+        from: second.baseAddress!, count: second.count)
+    } else {
+      target.initialize(from: first.baseAddress!, count: first.count)
+      (target + first.count).initialize(
+        from: second.baseAddress!, count: second.count)
+    }
+    return target + bounds.count
+  }
+
+  /// Destroys the elements at offsets `bounds`.
+  internal func _deinitializeElements(_ bounds: Range<Int>) {
+    let (first, second) = _segments(bounds)
+    first.baseAddress!.deinitialize(count: first.count)
+    second.baseAddress!.deinitialize(count: second.count)
+  }
+
+  /// Returns new storage with room for at least `minimumCapacity` elements,
+  /// holding this storage's elements starting at the first slot.
+  ///
+  /// If `moving` is true, the elements are moved out and this storage is left
+  /// empty.
+  internal func _copy(minimumCapacity: Int, moving: Bool) -> _DequeStorage {
+    let count = header.count
+    let result = _DequeStorage._allocate(
+      minimumCapacity: Swift.max(minimumCapacity, count))
+    _transferElements(
+      0..<count, initializing: result.firstElementAddress, moving: moving)
+    result.header.count = count
+    if moving {
+      header.count = 0
+    }
+    return result
+  }
+}
+
+/// An ordered, random-access collection that supports efficient insertion
+/// and removal of elements at both ends.
+///
+/// A deque, or double-ended queue, is a good fit for queues and work lists,
+/// where elements are added at one end and taken from the other. Appending or
+/// prepending an element and removing the first or last element all take
+/// amortized O(1) time, while the same operations at the front of an `Array`
+/// take O(*n*) time because they shift every other element.
+///
+///     var queue: Deque = [1, 2, 3]
+///     queue.append(4)
+///     queue.prepend(0)
+///     print(queue.removeFirst())
+///     // Prints "0"
+///     print(queue)
+///     // Prints "[1, 2, 3, 4]"
+///
+/// A deque stores its elements in a ring buffer, so they may wrap around from
+/// the end of its storage to the beginning. Use the
+/// `withUnsafeBufferPointers(_:)` method to access the two contiguous
+/// segments directly. Inserting or removing elements anywhere other than the
+/// ends takes O(*n*) time.
+///
+/// Like `Array`, `Deque` has value semantics, and copies of a deque share
+/// storage until one of them is mutated.
+public struct Deque<Element>
+  : RandomAccessCollection, MutableCollection, RangeReplaceableCollection {
+
+  public typealias Index = Int
+  public typealias IndexDistance = Int
+  public typealias Indices = CountableRange<Int>
+  public typealias Iterator = IndexingIterator<Deque<Element>>
+  public typealias SubSequence =
+    MutableRangeReplaceableRandomAccessSlice<Deque<Element>>
+
+  internal var _storage: _DequeStorage<Element>
+
+  /// Creates an empty deque.
+  public init() {
+    _storage = _DequeStorage<Element>._allocate(minimumCapacity: 0)
+  }
+
+  /// Creates an empty deque with room for at least `minimumCapacity`
+  /// elements.
+  public init(minimumCapacity: Int) {
+    _storage = _DequeStorage<Element>._allocate(
+      minimumCapacity: minimumCapacity)
+  }
+
+  /// The total number of elements that the deque can contain without
+  /// allocating new storage.
+  public var capacity: Int {
+    return _storage.header.capacity
+  }
+
+  /// The number of elements in the deque.
+  public var count: Int {
+    return _storage.header.count
+  }
+
+  public var startIndex: Int {
+    return 0
+  }
+
+  public var endIndex: Int {
+    return count
+  }
+
+  public var indices: CountableRange<Int> {
+    return 0..<count
+  }
+
+  public func index(after i: Int) -> Int {
+    return i + 1
+  }
+
+  public func formIndex(after i: inout Int) {
+    i += 1
+  }
+
+  public func index(before i: Int) -> Int {
+    return i - 1
+  }
+
+  public func formIndex(before i: inout Int) {
+    i -= 1
+  }
+
+  public func index(_ i: Int, offsetBy n: Int) -> Int {
+    return i + n
+  }
+
+  public func distance(from start: Int, to end: Int) -> Int {
+    return end - start
+  }
+
+  internal func _checkIndex(_ position: Int) {
+    _precondition(position >= 0 && position < count, "Deque index out of range")
+  }
+
+  /// Accesses the element at the specified position.
+  ///
+  /// - Complexity: Reading an element is O(1). Writing is O(1) unless the
+  ///   deque's storage is shared with another deque, in which case it is
+  ///   O(*n*).
+  public subscript(position: Int) -> Element {
+    get {
+      _checkIndex(position)
+      return _storage._address(forOffset: position).pointee
+    }
+    set {
+      _checkIndex(position)
+      _makeUniqueAndReserveCapacity(count)
+      _storage._address(forOffset: position).pointee = newValue
+    }
+  }
+
+  /// Accesses a contiguous subrange of the deque's elements.
+  public subscript(bounds: Range<Int>) -> SubSequence {
+    get {
+      _failEarlyRangeCheck(bounds, bounds: startIndex..<endIndex)
+      return MutableRangeReplaceableRandomAccessSlice(base: self, bounds: bounds)
+    }
+    set {
+      replaceSubrange(bounds, with: newValue)
+    }
+  }
+
+  /// Ensures that the storage is uniquely referenced and has room for at
+  /// least `minimumCapacity` elements, growing it geometrically if not.
+  internal mutating func _makeUniqueAndReserveCapacity(
+    _ minimumCapacity: Int
+  ) {
+    let isUnique = isKnownUniquelyReferenced(&_storage)
+    if _fastPath(isUnique && minimumCapacity <= capacity) {
+      return
+    }
+    let newCapacity = minimumCapacity <= capacity
+      ? capacity
+      : Swift.max(minimumCapacity, _growArrayCapacity(capacity))
+    _storage = _storage._copy(minimumCapacity: newCapacity, moving: isUnique)
+  }
+
+  /// Reserves enough space to store the specified number of elements.
+  ///
+  /// - Complexity: O(*n*), where *n* is the number of elements in the deque.
+  public mutating func reserveCapacity(_ minimumCapacity: Int) {
+    let isUnique = isKnownUniquelyReferenced(&_storage)
+    if isUnique && minimumCapacity <= capacity {
+      return
+    }
+    _storage = _storage._copy(
+      minimumCapacity: minimumCapacity, moving: isUnique)
+  }
+
+  /// Adds an element to the end of the deque.
+  ///
+  /// - Complexity: Amortized O(1).
+  public mutating func append(_ newElement: Element) {
+    _makeUniqueAndReserveCapacity(count + 1)
+    _storage._address(forOffset: count).initialize(to: newElement)
+    _storage.header.count += 1
+  }
+
+  /// Adds an element to the start of the deque.
+  ///
+  ///     var numbers: Deque = [2, 3]
+  ///     numbers.prepend(1)
+  ///     print(numbers)
+  ///     // Prints "[1, 2, 3]"
+  ///
+  /// - Complexity: Amortized O(1).
+  public mutating func prepend(_ newElement: Element) {
+    _makeUniqueAndReserveCapacity(count + 1)
+    let startSlot = _storage.header.startSlot
+    let newStartSlot = (startSlot == 0 ? capacity : startSlot) - 1
+    (_storage.firstElementAddress + newStartSlot).initialize(to: newElement)
+    _storage.header.startSlot = newStartSlot
+    _storage.header.count += 1
+  }
+
+  /// Removes and returns the first element of the deque.
+  ///
+  /// The deque must not be empty.
+  ///
+  /// - Complexity: O(1) if the deque's storage isn't shared with another
+  ///   deque; otherwise, O(*n*).
+  @discardableResult
+  public mutating func removeFirst() -> Element {
+    _precondition(!isEmpty, "can't remove first element from an empty Deque")
+    _makeUniqueAndReserveCapacity(0)
+    let result = _storage._address(forOffset: 0).move()
+    _storage.header.startSlot = _storage._slot(forOffset: 1)
+    _storage.header.count -= 1
+    return result
+  }
+
+  /// Removes and returns the last element of the deque.
+  ///
+  /// The deque must not be empty.
+  ///
+  /// - Complexity: O(1) if the deque's storage isn't shared with another
+  ///   deque; otherwise, O(*n*).
+  @discardableResult
+  public mutating func removeLast() -> Element {
+    _precondition(!isEmpty, "can't remove last element from an empty Deque")
+    _makeUniqueAndReserveCapacity(0)
+    _storage.header.count -= 1
+    return _storage._address(forOffset: count).move()
+  }
+
+  /// Removes the specified number of elements from the start of the deque.
+  ///
+  /// - Parameter n: The number of elements to remove. `n` must be greater
+  ///   than or equal to zero, and must not exceed the number of elements in
+  ///   the deque.
+  ///
+  /// - Complexity: O(*n*), where *n* is the number of elements removed.
+  public mutating func removeFirst(_ n: Int) {
+    _precondition(n >= 0, "number of elements to remove should be non-negative")
+    _precondition(count >= n,
+      "can't remove more items from a collection than it contains")
+    _makeUniqueAndReserveCapacity(0)
+    _storage._deinitializeElements(0..<n)
+    _storage.header.startSlot = n == count ? 0 : _storage._slot(forOffset: n)
+    _storage.header.count -= n
+  }
+
+  /// Removes the specified number of elements from the end of the deque.
+  ///
+  /// - Parameter n: The number of elements to remove. `n` must be greater
+  ///   than or equal to zero, and must not exceed the number of elements in
+  ///   the deque.
+  ///
+  /// - Complexity: O(*n*), where *n* is the number of elements removed.
+  public mutating func removeLast(_ n: Int) {
+    _precondition(n >= 0, "number of elements to remove should be non-negative")
+    _precondition(count >= n,
+      "can't remove more items from a collection than it contains")
+    _makeUniqueAndReserveCapacity(0)
+    _storage._deinitializeElements((count - n)..<count)
+    _storage.header.count -= n
+  }
+
+  /// Removes and returns the first element of the deque, or returns `nil` if
+  /// the deque is empty.
+  ///
+  /// - Complexity: O(1) if the deque's storage isn't shared with another
+  ///   deque; otherwise, O(*n*).
+  public mutating func popFirst() -> Element? {
+    return isEmpty ? nil : removeFirst()
+  }
+
+  /// Removes and returns the last element of the deque, or returns `nil` if
+  /// the deque is empty.
+  ///
+  /// - Complexity: O(1) if the deque's storage isn't shared with another
+  ///   deque; otherwise, O(*n*).
+  public mutating func popLast() -> Element? {
+    return isEmpty ? nil : removeLast()
+  }
+
+  /// Replaces the specified subrange of elements with the given collection.
+  ///
+  /// - Complexity: O(*m* + *n*), where *m* is the length of the resulting
+  ///   deque and *n* is the length of `newElements`.
+  public mutating func replaceSubrange<C>(
+    _ subrange: Range<Int>,
+    with newElements: C
+  ) where C : Collection, C.Iterator.Element == Element {
+    _precondition(subrange.lowerBound >= 0,
+      "Deque replace: subrange start is negative")
+    _precondition(subrange.upperBound <= count,
+      "Deque replace: subrange extends past the end")
+
+    let oldCount = count
+    let newElementsCount: Int = numericCast(newElements.count)
+    let newCount = oldCount - subrange.count + newElementsCount
+
+    // Move the surviving elements when nobody else can see them; copy them
+    // otherwise.
+    let isUnique = isKnownUniquelyReferenced(&_storage)
+    let result = _DequeStorage<Element>._allocate(
+      minimumCapacity: newCount <= capacity
+        ? capacity
+        : Swift.max(newCount, _growArrayCapacity(capacity)))
+
+    var p = result.firstElementAddress
+    p = _storage._transferElements(
+      0..<subrange.lowerBound, initializing: p, moving: isUnique)
+    p.initialize(from: newElements)
+    p += newElementsCount
+    _storage._transferElements(
+      subrange.upperBound..<oldCount, initializing: p, moving: isUnique)
+    result.header.count = newCount
+
+    if isUnique {
+      _storage._deinitializeElements(subrange)
+      _storage.header.count = 0
+    }
+    _storage = result
+  }
+
+  /// Calls the given closure with the two contiguous segments holding the
+  /// deque's elements.
+  ///
+  /// The elements of the first buffer pointer, followed by the elements of
+  /// the second, are the elements of the deque in order. The second buffer
+  /// pointer is empty unless the elements wrap around the end of the
+  /// deque's storage.
+  ///
+  /// The buffer pointers are valid only for the duration of the call to
+  /// `body`.
+  public func withUnsafeBufferPointers<R>(
+    _ body: (UnsafeBufferPointer<Element>, UnsafeBufferPointer<Element>)
+      throws -> R
+  ) rethrows -> R {
+    let (first, second) = _storage._segments(0..<count)
+    defer { _fixLifetime(_storage) }
+    return try body(
+      UnsafeBufferPointer(start: first.baseAddress, count: first.count),
+      UnsafeBufferPointer(start: second.baseAddress, count: second.count))
+  }
+
+  public func withContiguousStorageIfAvailable<R>(
+    _ body: (UnsafeBufferPointer<Element>) throws -> R
+  ) rethrows -> R? {
+    let (first, second) = _storage._segments(0..<count)
+    if !second.isEmpty {
+      return nil
+    }
+    defer { _fixLifetime(_storage) }
+    return try body(
+      UnsafeBufferPointer(start: first.baseAddress, count: first.count))
+  }
+
+  @discardableResult
+  public func _copyContents(
+    initializing ptr: UnsafeMutablePointer<Element>
+  ) -> UnsafeMutablePointer<Element> {
+    defer { _fixLifetime(_storage) }
+    return _storage._transferElements(
+      0..<count, initializing: ptr, moving: false)
+  }
+}
+
+extension Deque : ExpressibleByArrayLiteral {
+  /// Creates a deque containing the elements of an array literal.
+  public init(arrayLiteral elements: Element...) {
+    self.init(elements)
+  }
+}
+
+extension Deque : CustomStringConvertible, CustomDebugStringConvertible {
+  internal func _makeDescription(isDebug: Bool) -> String {
+    var result = isDebug ? "Deque([" : "["
+    var first = true
+    for item in self {
+      if first {
+        first = false
+      } else {
+        result += ", "
+      }
+      debugPrint(item, terminator: "", to: &result)
+    }
+    result += isDebug ? "])" : "]"
+    return result
+  }
+
+  /// A textual representation of the deque and its elements.
+  public var description: String {
+    return _makeDescription(isDebug: false)
+  }
+
+  /// A textual representation of the deque and its elements, suitable for
+  /// debugging.
+  public var debugDescription: String {
+    return _makeDescription(isDebug: true)
+  }
+}
+
+/// Returns `true` if these deques contain the same elements.
+public func == <Element : Equatable>(
+  lhs: Deque<Element>, rhs: Deque<Element>
+) -> Bool {
+  return lhs.count == rhs.count &&
+    (lhs._storage === rhs._storage || lhs.elementsEqual(rhs))
+}
+
+/// Returns `true` if the deques do not contain the same elements.
+public func != <Element : Equatable>(
+  lhs: Deque<Element>, rhs: Deque<Element>
+) -> Bool {
+  return !(lhs == rhs)
+}
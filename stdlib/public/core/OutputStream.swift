@@ -72,11 +72,25 @@ public protocol TextOutputStream {
 
   /// Appends the given string to the stream.
   mutating func write(_ string: String)
+
+  /// Appends the given ASCII code units to the stream.
+  ///
+  /// The standard library's numeric types write their textual
+  /// representation through this requirement, so streams that can consume
+  /// bytes directly avoid creating an intermediate `String`.
+  mutating func _writeASCII(_ buffer: UnsafeBufferPointer<UInt8>)
 }
 
 extension TextOutputStream {
   public mutating func _lock() {}
   public mutating func _unlock() {}
+
+  public mutating func _writeASCII(_ buffer: UnsafeBufferPointer<UInt8>) {
+    if buffer.isEmpty { return }
+    var string = String()
+    string._core._appendASCII(buffer)
+    write(string)
+  }
 }
 
 /// A source of text-streaming operations.
@@ -494,31 +508,51 @@ internal func _dumpPrint_unlocked<T, TargetStream : TextOutputStream>(
 //===----------------------------------------------------------------------===//
 
 internal struct _Stdout : TextOutputStream {
+  /// The number of outstanding `_lock()` calls.
+  ///
+  /// `print` takes the lock once for all of its items, so that the writes in
+  /// between can bypass stdio's per-call locking.
+  internal var _lockCount = 0
+
   mutating func _lock() {
     _swift_stdlib_flockfile_stdout()
+    _lockCount += 1
   }
 
   mutating func _unlock() {
+    _lockCount -= 1
     _swift_stdlib_funlockfile_stdout()
   }
 
+  func _write(_ bytes: UnsafeRawPointer, count: Int) {
+    if _lockCount > 0 {
+      _swift_stdlib_fwrite_stdout_unlocked(bytes, count, 1)
+    } else {
+      _swift_stdlib_fwrite_stdout(bytes, count, 1)
+    }
+  }
+
   mutating func write(_ string: String) {
     if string.isEmpty { return }
 
     if let asciiBuffer = string._core.asciiBuffer {
       defer { _fixLifetime(string) }
 
-      _swift_stdlib_fwrite_stdout(
-        UnsafePointer(asciiBuffer.baseAddress!),
-        asciiBuffer.count,
-        1)
+      _write(UnsafeRawPointer(asciiBuffer.baseAddress!),
+        count: asciiBuffer.count)
       return
     }
 
-    for c in string.utf8 {
-      _swift_stdlib_putchar_unlocked(Int32(c))
+    string._withUnsafeBufferPointerToUTF8 {
+      (utf8) -> Void in
+      _write(UnsafeRawPointer(utf8.baseAddress!), count: utf8.count)
     }
   }
+
+  mutating func _writeASCII(_ buffer: UnsafeBufferPointer<UInt8>) {
+    if buffer.isEmpty { return }
+    _write(UnsafeRawPointer(buffer.baseAddress!), count: buffer.count)
+  }
 }
 
 extension String : TextOutputStream {
@@ -528,6 +562,10 @@ extension String : TextOutputStream {
   public mutating func write(_ other: String) {
     self += other
   }
+
+  public mutating func _writeASCII(_ buffer: UnsafeBufferPointer<UInt8>) {
+    _core._appendASCII(buffer)
+  }
 }
 
 //===----------------------------------------------------------------------===//
@@ -576,6 +614,9 @@ internal struct _TeeStream<
   mutating func write(_ string: String)
   { left.write(string); right.write(string) }
 
+  mutating func _writeASCII(_ buffer: UnsafeBufferPointer<UInt8>)
+  { left._writeASCII(buffer); right._writeASCII(buffer) }
+
   mutating func _lock() { left._lock(); right._lock() }
   mutating func _unlock() { right._unlock(); left._unlock() }
 }
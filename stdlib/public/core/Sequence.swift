@@ -615,6 +615,24 @@ public protocol Sequence {
     _ preprocess: () throws -> R
   ) rethrows -> R?
 
+  /// Calls a closure with a pointer to the sequence's contiguous storage.
+  ///
+  /// If the elements of the sequence are stored in a single, contiguous
+  /// region of memory, calls `body` with a buffer pointer to that region and
+  /// returns its result. Otherwise, returns `nil` without calling `body`.
+  ///
+  /// Generic algorithms use this method to replace element-by-element
+  /// iteration with bulk operations on memory. The buffer pointer argument
+  /// is valid only for the duration of the call to `body`.
+  ///
+  /// - Parameter body: A closure with an `UnsafeBufferPointer` parameter
+  ///   that points to the contiguous storage of the sequence.
+  /// - Returns: The return value of `body`, or `nil` if the sequence doesn't
+  ///   have contiguous storage.
+  func withContiguousStorageIfAvailable<R>(
+    _ body: (UnsafeBufferPointer<Iterator.Element>) throws -> R
+  ) rethrows -> R?
+
   /// Create a native array buffer containing the elements of `self`,
   /// in the same order.
   func _copyToContiguousArray() -> ContiguousArray<Iterator.Element>
@@ -1015,6 +1033,12 @@ extension Sequence {
     return nil
   }
 
+  public func withContiguousStorageIfAvailable<R>(
+    _ body: (UnsafeBufferPointer<Iterator.Element>) throws -> R
+  ) rethrows -> R? {
+    return nil
+  }
+
   public func _customContainsEquatableElement(
     _ element: Iterator.Element
   ) -> Bool? {
@@ -1373,6 +1397,16 @@ extension Sequence {
   public func _copyContents(
     initializing ptr: UnsafeMutablePointer<Iterator.Element>
   ) -> UnsafeMutablePointer<Iterator.Element> {
+    if let end = self.withContiguousStorageIfAvailable({
+      source -> UnsafeMutablePointer<Iterator.Element> in
+      if let base = source.baseAddress {
+        ptr.initialize(from: base, count: source.count)
+      }
+      return ptr + source.count
+    }) {
+      return end
+    }
+
     var p = UnsafeMutablePointer<Iterator.Element>(ptr)
     for x in IteratorSequence(self.makeIterator()) {
       p.initialize(to: x)
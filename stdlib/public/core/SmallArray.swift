@@ -0,0 +1,332 @@
+//===--- SmallArray.swift -------------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+/// An ordered, random-access collection that stores up to four elements
+/// inline, without allocating.
+///
+/// Every nonempty `Array` allocates storage on the heap. When a program
+/// creates many short-lived, short collections---tags, path components,
+/// argument lists---use `SmallArray` instead: it keeps its first four
+/// elements in the collection value itself, and moves them to an array only
+/// when a fifth element is added.
+///
+///     var components = SmallArray<String>()
+///     components.append("usr")
+///     components.append("lib")
+///     components.append("swift")
+///     print(components)
+///     // Prints "["usr", "lib", "swift"]"
+///
+/// Removing the last element of a small array whose elements have moved out
+/// of line doesn't move them back, so that a count hovering around four
+/// doesn't allocate repeatedly. Other replacements that leave four or fewer
+/// elements store them inline again.
+///
+/// Like `Array`, `SmallArray` has value semantics.
+public struct SmallArray<Element>
+  : RandomAccessCollection, MutableCollection, RangeReplaceableCollection {
+
+  public typealias Index = Int
+  public typealias IndexDistance = Int
+  public typealias Indices = CountableRange<Int>
+  public typealias Iterator = IndexingIterator<SmallArray<Element>>
+  public typealias SubSequence =
+    MutableRangeReplaceableRandomAccessSlice<SmallArray<Element>>
+
+  /// The number of elements a small array can store without allocating.
+  internal static var _inlineCapacity: Int {
+    return 4
+  }
+
+  /// The number of inline elements. Only meaningful when `_outOfLine` is
+  /// `nil`.
+  internal var _inlineCount: Int
+
+  /// Inline storage for the elements; the first `_inlineCount` are non-nil.
+  internal var _inline: (Element?, Element?, Element?, Element?)
+
+  /// The elements, once they no longer fit inline.
+  internal var _outOfLine: [Element]?
+
+  /// Creates an empty small array.
+  public init() {
+    _inlineCount = 0
+    _inline = (nil, nil, nil, nil)
+    _outOfLine = nil
+  }
+
+  /// The number of elements in the small array.
+  public var count: Int {
+    if _outOfLine != nil {
+      return _outOfLine!.count
+    }
+    return _inlineCount
+  }
+
+  public var startIndex: Int {
+    return 0
+  }
+
+  public var endIndex: Int {
+    return count
+  }
+
+  public var indices: CountableRange<Int> {
+    return 0..<count
+  }
+
+  public func index(after i: Int) -> Int {
+    return i + 1
+  }
+
+  public func formIndex(after i: inout Int) {
+    i += 1
+  }
+
+  public func index(before i: Int) -> Int {
+    return i - 1
+  }
+
+  public func formIndex(before i: inout Int) {
+    i -= 1
+  }
+
+  public func index(_ i: Int, offsetBy n: Int) -> Int {
+    return i + n
+  }
+
+  public func distance(from start: Int, to end: Int) -> Int {
+    return end - start
+  }
+
+  internal func _inlineElement(at position: Int) -> Element {
+    switch position {
+    case 0: return _inline.0!
+    case 1: return _inline.1!
+    case 2: return _inline.2!
+    default: return _inline.3!
+    }
+  }
+
+  internal mutating func _setInlineElement(
+    at position: Int, to newValue: Element?
+  ) {
+    switch position {
+    case 0: _inline.0 = newValue
+    case 1: _inline.1 = newValue
+    case 2: _inline.2 = newValue
+    default: _inline.3 = newValue
+    }
+  }
+
+  /// Moves the inline elements to out-of-line storage with room for at least
+  /// `minimumCapacity` elements.
+  internal mutating func _moveOutOfLine(minimumCapacity: Int) {
+    _sanityCheck(_outOfLine == nil)
+    var elements: [Element] = []
+    elements.reserveCapacity(
+      Swift.max(minimumCapacity, 2 * SmallArray._inlineCapacity))
+    for i in 0..<_inlineCount {
+      elements.append(_inlineElement(at: i))
+    }
+    _inline = (nil, nil, nil, nil)
+    _inlineCount = 0
+    _outOfLine = elements
+  }
+
+  /// Accesses the element at the specified position.
+  public subscript(position: Int) -> Element {
+    get {
+      _precondition(position >= 0 && position < count, "Index out of range")
+      if _outOfLine != nil {
+        return _outOfLine![position]
+      }
+      return _inlineElement(at: position)
+    }
+    set {
+      _precondition(position >= 0 && position < count, "Index out of range")
+      if _outOfLine != nil {
+        _outOfLine![position] = newValue
+      } else {
+        _setInlineElement(at: position, to: newValue)
+      }
+    }
+  }
+
+  /// Accesses a contiguous subrange of the small array's elements.
+  public subscript(bounds: Range<Int>) -> SubSequence {
+    get {
+      _failEarlyRangeCheck(bounds, bounds: startIndex..<endIndex)
+      return MutableRangeReplaceableRandomAccessSlice(base: self, bounds: bounds)
+    }
+    set {
+      replaceSubrange(bounds, with: newValue)
+    }
+  }
+
+  /// Reserves enough space to store the specified number of elements.
+  ///
+  /// Reserving room for more than four elements moves the elements out of
+  /// line.
+  public mutating func reserveCapacity(_ minimumCapacity: Int) {
+    if _outOfLine != nil {
+      _outOfLine!.reserveCapacity(minimumCapacity)
+    } else if minimumCapacity > SmallArray._inlineCapacity {
+      _moveOutOfLine(minimumCapacity: minimumCapacity)
+    }
+  }
+
+  /// Adds an element to the end of the small array.
+  ///
+  /// - Complexity: Amortized O(1).
+  public mutating func append(_ newElement: Element) {
+    if _outOfLine == nil {
+      if _inlineCount < SmallArray._inlineCapacity {
+        _setInlineElement(at: _inlineCount, to: newElement)
+        _inlineCount += 1
+        return
+      }
+      _moveOutOfLine(minimumCapacity: _inlineCount + 1)
+    }
+    _outOfLine!.append(newElement)
+  }
+
+  /// Removes and returns the last element of the small array.
+  ///
+  /// The small array must not be empty.
+  ///
+  /// - Complexity: O(1)
+  @discardableResult
+  public mutating func removeLast() -> Element {
+    _precondition(!isEmpty, "can't remove last element from an empty collection")
+    if _outOfLine != nil {
+      return _outOfLine!.removeLast()
+    }
+    _inlineCount -= 1
+    let result = _inlineElement(at: _inlineCount)
+    _setInlineElement(at: _inlineCount, to: nil)
+    return result
+  }
+
+  /// Removes and returns the last element of the small array, or returns
+  /// `nil` if it's empty.
+  ///
+  /// - Complexity: O(1)
+  public mutating func popLast() -> Element? {
+    return isEmpty ? nil : removeLast()
+  }
+
+  /// Removes all elements from the small array.
+  ///
+  /// - Parameter keepCapacity: Pass `true` to keep any out-of-line storage
+  ///   for reuse. The default is `false`.
+  public mutating func removeAll(keepingCapacity keepCapacity: Bool = false) {
+    if keepCapacity && _outOfLine != nil {
+      _outOfLine!.removeAll(keepingCapacity: true)
+    } else {
+      self = SmallArray()
+    }
+  }
+
+  /// Replaces the specified subrange of elements with the given collection.
+  ///
+  /// If the result has four or fewer elements, they're stored inline.
+  ///
+  /// - Complexity: O(*m* + *n*), where *m* is the length of the resulting
+  ///   small array and *n* is the length of `newElements`.
+  public mutating func replaceSubrange<C>(
+    _ subrange: Range<Int>,
+    with newElements: C
+  ) where C : Collection, C.Iterator.Element == Element {
+    _precondition(subrange.lowerBound >= 0,
+      "SmallArray replace: subrange start is negative")
+    _precondition(subrange.upperBound <= count,
+      "SmallArray replace: subrange extends past the end")
+
+    let newCount = count - subrange.count + numericCast(newElements.count)
+    if _outOfLine != nil && newCount > SmallArray._inlineCapacity {
+      _outOfLine!.replaceSubrange(subrange, with: newElements)
+      return
+    }
+
+    var result = SmallArray()
+    result.reserveCapacity(newCount)
+    for i in 0..<subrange.lowerBound {
+      result.append(self[i])
+    }
+    for element in newElements {
+      result.append(element)
+    }
+    for i in subrange.upperBound..<count {
+      result.append(self[i])
+    }
+    self = result
+  }
+
+  public func withContiguousStorageIfAvailable<R>(
+    _ body: (UnsafeBufferPointer<Element>) throws -> R
+  ) rethrows -> R? {
+    if _outOfLine != nil {
+      return try _outOfLine!.withUnsafeBufferPointer(body)
+    }
+    return nil
+  }
+}
+
+extension SmallArray : ExpressibleByArrayLiteral {
+  /// Creates a small array containing the elements of an array literal.
+  public init(arrayLiteral elements: Element...) {
+    self.init(elements)
+  }
+}
+
+extension SmallArray : CustomStringConvertible, CustomDebugStringConvertible {
+  internal func _makeDescription(isDebug: Bool) -> String {
+    var result = isDebug ? "SmallArray([" : "["
+    var first = true
+    for item in self {
+      if first {
+        first = false
+      } else {
+        result += ", "
+      }
+      debugPrint(item, terminator: "", to: &result)
+    }
+    result += isDebug ? "])" : "]"
+    return result
+  }
+
+  /// A textual representation of the small array and its elements.
+  public var description: String {
+    return _makeDescription(isDebug: false)
+  }
+
+  /// A textual representation of the small array and its elements, suitable
+  /// for debugging.
+  public var debugDescription: String {
+    return _makeDescription(isDebug: true)
+  }
+}
+
+/// Returns `true` if these small arrays contain the same elements.
+public func == <Element : Equatable>(
+  lhs: SmallArray<Element>, rhs: SmallArray<Element>
+) -> Bool {
+  return lhs.count == rhs.count && lhs.elementsEqual(rhs)
+}
+
+/// Returns `true` if the small arrays do not contain the same elements.
+public func != <Element : Equatable>(
+  lhs: SmallArray<Element>, rhs: SmallArray<Element>
+) -> Bool {
+  return !(lhs == rhs)
+}
@@ -508,6 +508,12 @@ extension String {
   ///
   /// - Parameter other: Another string.
   public mutating func append(_ other: String) {
+    // Share the storage of `other` instead of allocating a copy, unless this
+    // string owns a buffer, which may have reserved capacity.
+    if _core.count == 0 && _core._owner == nil {
+      self = other
+      return
+    }
     _core.append(other._core)
   }
 
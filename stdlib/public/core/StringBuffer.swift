@@ -10,6 +10,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+import SwiftShims
+
 @_versioned
 struct _StringBufferIVars {
   internal init(_elementWidth: Int) {
@@ -143,6 +145,82 @@ public struct _StringBuffer {
     }
   }
 
+  /// Create and initialize a `_StringBuffer` from contiguous UTF-8 code
+  /// units, or return nil if `input` contains ill-formed sequences.
+  ///
+  /// Validation and transcoding are done by vectorized runtime stubs; callers
+  /// fall back to `fromCodeUnits` to repair ill-formed input.
+  static func _fromWellFormedUTF8(
+    _ input: UnsafeBufferPointer<UTF8.CodeUnit>, minimumCapacity: Int = 0
+  ) -> _StringBuffer? {
+    guard let source = input.baseAddress else {
+      return nil
+    }
+    var isASCII = false
+    let utf16Count = _swift_stdlib_utf8_validatedUTF16Length(
+      source, input.count, &isASCII)
+    if utf16Count < 0 {
+      return nil
+    }
+
+    let result = _StringBuffer(
+        capacity: max(utf16Count, minimumCapacity),
+        initialSize: utf16Count,
+        elementWidth: isASCII ? 1 : 2)
+
+    if isASCII {
+      _memcpy(
+        dest: result.start,
+        src: UnsafeMutableRawPointer(mutating: UnsafeRawPointer(source)),
+        size: UInt(utf16Count))
+    }
+    else {
+      let written = _swift_stdlib_utf8_transcodeToUTF16(
+        result._storage.baseAddress, source, input.count)
+      _sanityCheck(written == utf16Count, "miscounted UTF-16 code units")
+    }
+    return result
+  }
+
+  /// Create a `_StringCore` whose ASCII code units are the first `count`
+  /// bytes of `bytes`, taking ownership of that memory.  `deallocator` is
+  /// called with `bytes` once the last string referring to it is destroyed.
+  ///
+  /// - Precondition: `bytes` is at least one byte longer than `count`, as
+  ///   `_StringCore` may read one byte past the end of its 8-bit elements.
+  static func _adoptingASCII(
+    _ bytes: UnsafeMutableRawBufferPointer, count: Int,
+    deallocator: @escaping (UnsafeMutableRawBufferPointer) -> Void
+  ) -> _StringCore {
+    _sanityCheck(count >= 0 && count < bytes.count)
+    let storage = _Storage(
+      _AdoptedStringStorage.self,
+      _StringBufferIVars(_elementWidth: 1),
+      (MemoryLayout<_AdoptedStringBytes>.stride + 1) >> 1)
+    let tail = UnsafeMutableRawPointer(storage.baseAddress)
+    _sanityCheck(
+      Int(bitPattern: tail) % MemoryLayout<_AdoptedStringBytes>.alignment == 0,
+      "misaligned adopted string bytes")
+    tail.bindMemory(to: _AdoptedStringBytes.self, capacity: 1).initialize(
+      to: _AdoptedStringBytes(bytes: bytes, deallocator: deallocator))
+
+    // Claim no capacity, so that growing the string always copies it out of
+    // the adopted memory.
+    storage.value.usedEnd = tail
+
+    return _StringCore(
+      baseAddress: bytes.baseAddress,
+      count: count,
+      elementShift: 0,
+      hasCocoaBuffer: false,
+      owner: storage.storage)
+  }
+
+  /// `true` iff this buffer owns adopted memory that it does not contain.
+  var _isAdopted: Bool {
+    return _storage.storage is _AdoptedStringStorage
+  }
+
   /// A pointer to the start of this buffer's data area.
   public // @testable
   var start: UnsafeMutableRawPointer {
@@ -194,7 +272,7 @@ public struct _StringBuffer {
     // The substring to be grown could be pointing in the middle of this
     // _StringBuffer.
     let offset = (r.lowerBound - UnsafeRawPointer(start)) >> elementShift
-    return cap + offset <= capacity
+    return offset >= 0 && cap + offset <= capacity
   }
 
 
@@ -216,10 +294,11 @@ public struct _StringBuffer {
     // The substring to be grown could be pointing in the middle of this
     // _StringBuffer.  Adjust the size so that it covers the imaginary
     // substring from the start of the buffer to `oldUsedEnd`.
-    newUsedCount
-      += (bounds.lowerBound - UnsafeRawPointer(start)) >> elementShift
+    let offset = (bounds.lowerBound - UnsafeRawPointer(start)) >> elementShift
+    newUsedCount += offset
 
-    if _slowPath(newUsedCount > capacity) {
+    // A negative offset means the substring lives in adopted memory.
+    if _slowPath(offset < 0 || newUsedCount > capacity) {
       return false
     }
 
@@ -260,3 +339,27 @@ public struct _StringBuffer {
 
   var _storage: _Storage
 }
+
+/// A buffer allocated outside the standard library, and the function that
+/// releases it.
+internal struct _AdoptedStringBytes {
+  let bytes: UnsafeMutableRawBufferPointer
+  let deallocator: (UnsafeMutableRawBufferPointer) -> Void
+}
+
+/// The owner of a string whose code units live in adopted memory, e.g. a
+/// buffer filled by an I/O library.
+///
+/// Its header is that of a `_StringBuffer` without capacity, so
+/// `_StringCore` treats it like any other native buffer that is too small to
+/// grow in place.  The `_AdoptedStringBytes` are stored in its tail elements.
+final class _AdoptedStringStorage
+  : _HeapBufferStorage<_StringBufferIVars, UTF16.CodeUnit> {
+
+  deinit {
+    let tail = UnsafeMutableRawPointer(_StringBuffer._Storage(self).baseAddress)
+    let adopted = tail.assumingMemoryBound(to: _AdoptedStringBytes.self)
+    adopted.pointee.deallocator(adopted.pointee.bytes)
+    adopted.deinitialize()
+  }
+}
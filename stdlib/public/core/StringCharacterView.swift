@@ -217,6 +217,27 @@ extension String.CharacterView : BidirectionalCollection {
     return Index(_base: unicodeScalars.endIndex, in: self)
   }
 
+  /// The number of characters in the view.
+  ///
+  /// - Complexity: O(*n*), where *n* is the length of the view.
+  public var count: Int {
+    if _fastPath(_core.isASCII) {
+      // In ASCII text only CR-LF pairs form multi-scalar characters, so no
+      // grapheme cluster segmentation is needed.
+      let length = _core.count
+      if length == 0 {
+        return 0
+      }
+      let ascii = _core.startASCII
+      var result = length
+      for i in 1..<length where ascii[i] == 0x0A && ascii[i - 1] == 0x0D {
+        result -= 1
+      }
+      return result
+    }
+    return distance(from: startIndex, to: endIndex)
+  }
+
   /// Returns the next consecutive position after `i`.
   ///
   /// - Precondition: The next position is valid.
@@ -262,6 +283,17 @@ extension String.CharacterView : BidirectionalCollection {
     }
     
     let startIndexUTF16 = start._position
+
+    // Fast path: there is a boundary between two scalars below U+0300 unless
+    // they are CR-LF; this covers ASCII and Latin text without the trie.
+    let coreStart = startIndexUTF16 - _coreOffset
+    let u0 = _core[coreStart]
+    if _fastPath(u0 < 0x300 && u0 != 0x0D /* CR */) {
+      if coreStart + 1 == _core.count || _core[coreStart + 1] < 0x300 {
+        return 1
+      }
+    }
+
     let graphemeClusterBreakProperty =
       _UnicodeGraphemeClusterBreakPropertyTrie()
     let segmenter = _UnicodeExtendedGraphemeClusterSegmenter()
@@ -304,6 +336,19 @@ extension String.CharacterView : BidirectionalCollection {
     }
     
     let endIndexUTF16 = end._position
+
+    // Fast path: see _measureExtendedGraphemeClusterForward.
+    let coreEnd = endIndexUTF16 - _coreOffset
+    if _fastPath(_core[coreEnd - 1] < 0x300) {
+      if coreEnd == 1 {
+        return 1
+      }
+      let u0 = _core[coreEnd - 2]
+      if u0 < 0x300 && u0 != 0x0D /* CR */ {
+        return 1
+      }
+    }
+
     let graphemeClusterBreakProperty =
       _UnicodeGraphemeClusterBreakPropertyTrie()
     let segmenter = _UnicodeExtendedGraphemeClusterSegmenter()
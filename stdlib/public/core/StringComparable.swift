@@ -121,6 +121,14 @@ extension String {
 
 extension String : Equatable {
   public static func == (lhs: String, rhs: String) -> Bool {
+    // Strings which share their contiguous storage are trivially equal. This
+    // is common for dictionary keys which are looked up with the string that
+    // was inserted.
+    if lhs._core._baseAddress != nil &&
+       lhs._core._baseAddress == rhs._core._baseAddress &&
+       lhs._core._countAndFlags == rhs._core._countAndFlags {
+      return true
+    }
 #if _runtime(_ObjC)
     // We only want to perform this optimization on objc runtimes. Elsewhere,
     // we will make it follow the unicode collation algorithm even for ASCII.
@@ -10,6 +10,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+import SwiftShims
+
 /// The core implementation of a highly-optimizable String that
 /// can store both ASCII and UTF-16, and can wrap native Swift
 /// _StringBuffer or NSString instances.
@@ -64,7 +66,7 @@ public struct _StringCore {
       _sanityCheck(count == 0, "Empty string storage with non-zero count")
       _sanityCheck(_owner == nil, "String pointing at empty storage has owner")
     }
-    else if let buffer = nativeBuffer {
+    else if let buffer = nativeBuffer, !buffer._isAdopted {
       _sanityCheck(!hasCocoaBuffer)
       _sanityCheck(elementWidth == buffer.elementWidth,
         "_StringCore elementWidth doesn't match its buffer's")
@@ -115,26 +117,18 @@ public struct _StringCore {
         size: UInt(count << (srcElementWidth - 1)))
     }
     else if (srcElementWidth < dstElementWidth) {
-      // Widening ASCII to UTF-16; we need to copy the bytes manually
-      var dest = dstStart.assumingMemoryBound(to: UTF16.CodeUnit.self)
-      var src = srcStart.assumingMemoryBound(to: UTF8.CodeUnit.self)
-      let srcEnd = src + count
-      while (src != srcEnd) {
-        dest.pointee = UTF16.CodeUnit(src.pointee)
-        dest += 1
-        src += 1
-      }
+      // Widening ASCII to UTF-16
+      _swift_stdlib_widenASCII(
+        dstStart.assumingMemoryBound(to: UTF16.CodeUnit.self),
+        srcStart.assumingMemoryBound(to: UTF8.CodeUnit.self),
+        count)
     }
     else {
-      // Narrowing UTF-16 to ASCII; we need to copy the bytes manually
-      var dest = dstStart.assumingMemoryBound(to: UTF8.CodeUnit.self)
-      var src = srcStart.assumingMemoryBound(to: UTF16.CodeUnit.self)
-      let srcEnd = src + count
-      while (src != srcEnd) {
-        dest.pointee = UTF8.CodeUnit(src.pointee)
-        dest += 1
-        src += 1
-      }
+      // Narrowing UTF-16 to ASCII
+      _swift_stdlib_narrowASCII(
+        dstStart.assumingMemoryBound(to: UTF8.CodeUnit.self),
+        srcStart.assumingMemoryBound(to: UTF16.CodeUnit.self),
+        count)
     }
   }
 
@@ -557,6 +551,21 @@ public struct _StringCore {
     _invariantCheck()
   }
 
+  /// Append the ASCII code units in `bytes` to `self`.
+  mutating func _appendASCII(_ bytes: UnsafeBufferPointer<UInt8>) {
+    _invariantCheck()
+    let count = bytes.count
+    if _slowPath(count == 0) { return }
+
+    let source = UnsafeRawPointer(bytes.baseAddress!)
+    let destination = _growBuffer(
+      self.count + count, minElementWidth: 1)
+    _StringCore._copyElements(
+      UnsafeMutableRawPointer(mutating: source), srcElementWidth: 1,
+      dstStart: destination, dstElementWidth: elementWidth, count: count)
+    _invariantCheck()
+  }
+
   /// Returns `true` iff the contents of this string can be
   /// represented as pure ASCII.
   ///
@@ -568,11 +577,9 @@ public struct _StringCore {
     if _fastPath(elementWidth == 1) {
       return true
     }
-    let unsafeBuffer =
-      UnsafeBufferPointer(
-        start: _baseAddress!.assumingMemoryBound(to: UTF16.CodeUnit.self),
-        count: count)
-    return !unsafeBuffer.contains { $0 > 0x7f }
+    return _swift_stdlib_utf16_countLeadingASCII(
+      _baseAddress!.assumingMemoryBound(to: UTF16.CodeUnit.self),
+      count) == count
   }
 }
 
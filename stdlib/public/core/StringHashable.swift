@@ -21,26 +21,77 @@ func _stdlib_NSStringHashValuePointer(_ str: OpaquePointer, _ isASCII: Bool) ->
 #endif
 
 extension _Unicode {
-  internal static func hashASCII(
-    _ string: UnsafeBufferPointer<UInt8>
+  /// The number of collation elements buffered before they're mixed into the
+  /// hasher.
+  internal static var _asciiHashBlockCapacity: Int {
+    return 64
+  }
+
+  /// Hashes the collation elements of ASCII code units.
+  ///
+  /// Rather than appending one 4-byte element at a time, which makes the
+  /// hasher merge every element into its partial-word tail, the elements are
+  /// gathered into a stack buffer and appended in blocks, so that the hasher
+  /// consumes whole words. Appending the same bytes in larger pieces doesn't
+  /// change the resulting hash value.
+  @inline(__always)
+  internal static func _hashASCII<CodeUnit>(
+    _ string: UnsafeBufferPointer<CodeUnit>,
+    tableIndex: (CodeUnit) -> Int
   ) -> Int {
     let collationTable = _swift_stdlib_unicode_getASCIICollationTable()
     var hasher = _SipHash13Context(key: _Hashing.secretKey)
-    for c in string {
-      _precondition(c <= 127)
-      let element = collationTable[Int(c)]
-      // Ignore zero valued collation elements. They don't participate in the
-      // ordering relation.
-      if element != 0 {
-        hasher.append(element)
+    let blockCapacity = _asciiHashBlockCapacity
+    withUnsafeTemporaryAllocation(of: Int32.self, capacity: blockCapacity) {
+      block in
+      let blockStart = block.baseAddress!
+      var blockCount = 0
+      for c in string {
+        let i = tableIndex(c)
+        _precondition(i <= 127)
+        let element = collationTable[i]
+        // Ignore zero valued collation elements. They don't participate in
+        // the ordering relation.
+        if element != 0 {
+          blockStart[blockCount] = element
+          blockCount += 1
+          if blockCount == blockCapacity {
+            hasher._append_alwaysInline(
+              blockStart, byteCount: blockCount * MemoryLayout<Int32>.size)
+            blockCount = 0
+          }
+        }
       }
+      hasher._append_alwaysInline(
+        blockStart, byteCount: blockCount * MemoryLayout<Int32>.size)
     }
     return hasher._finalizeAndReturnIntHash()
   }
 
+  internal static func hashASCII(
+    _ string: UnsafeBufferPointer<UInt8>
+  ) -> Int {
+    return _hashASCII(string) { Int($0) }
+  }
+
+  /// Hashes UTF-16 code units which are all ASCII, consistently with
+  /// `hashASCII(_: UnsafeBufferPointer<UInt8>)`.
+  internal static func hashASCII(
+    _ string: UnsafeBufferPointer<UInt16>
+  ) -> Int {
+    return _hashASCII(string) { Int($0) }
+  }
+
   internal static func hashUTF16(
     _ string: UnsafeBufferPointer<UInt16>
   ) -> Int {
+    // Short keys are often ASCII even when stored as UTF-16; hash them
+    // without allocating a collation iterator.
+    if _swift_stdlib_utf16_countLeadingASCII(
+      string.baseAddress!, string.count) == string.count {
+      return hashASCII(string)
+    }
+
     let collationIterator = _swift_stdlib_unicodeCollationIterator_create(
       string.baseAddress!,
       UInt32(string.count))
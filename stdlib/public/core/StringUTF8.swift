@@ -16,6 +16,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+import SwiftShims
+
 // FIXME(ABI)#72 : The UTF-8 string view should conform to
 // `BidirectionalCollection`.
 
@@ -395,6 +397,31 @@ extension String {
   ///     }
   ///     // Prints "6"
   public var utf8CString: ContiguousArray<CChar> {
+    let count = _core.count
+    if _fastPath(_core.hasContiguousStorage && count > 0) {
+      // Contiguous storage is copied or transcoded by the vectorized stubs.
+      if _core.isASCII {
+        let (result, p) = ContiguousArray<CChar>._allocateUninitialized(
+          count + 1)
+        _memcpy(
+          dest: UnsafeMutableRawPointer(p),
+          src: UnsafeMutableRawPointer(_core.startASCII),
+          size: UInt(count))
+        p[count] = 0
+        return result
+      }
+      let utf16 = _core.startUTF16
+      let utf8Count = _swift_stdlib_utf16_utf8Length(utf16, count)
+      let (result, p) = ContiguousArray<CChar>._allocateUninitialized(
+        utf8Count + 1)
+      p.withMemoryRebound(to: UTF8.CodeUnit.self, capacity: utf8Count) {
+        let written = _swift_stdlib_utf16_transcodeToUTF8($0, utf16, count)
+        _sanityCheck(written == utf8Count, "miscounted UTF-8 code units")
+      }
+      p[utf8Count] = 0
+      return result
+    }
+
     var result = ContiguousArray<CChar>()
     result.reserveCapacity(utf8.count + 1)
     for c in utf8 {
@@ -412,11 +439,16 @@ extension String {
         start: asciiBuffer.baseAddress,
         count: asciiBuffer.count))
     }
-    var nullTerminatedUTF8 = ContiguousArray<UTF8.CodeUnit>()
-    nullTerminatedUTF8.reserveCapacity(utf8.count + 1)
-    nullTerminatedUTF8 += utf8
-    nullTerminatedUTF8.append(0)
-    return try nullTerminatedUTF8.withUnsafeBufferPointer(body)
+    // Like the ASCII buffer, the transcoded buffer is null-terminated, but
+    // the terminator is not part of the buffer passed to `body`.
+    let nullTerminatedUTF8 = utf8CString
+    return try nullTerminatedUTF8.withUnsafeBufferPointer {
+      (buffer) -> R in
+      try buffer.baseAddress!.withMemoryRebound(
+        to: UTF8.CodeUnit.self, capacity: buffer.count) {
+        try body(UnsafeBufferPointer(start: $0, count: buffer.count - 1))
+      }
+    }
   }
 
   /// Creates a string corresponding to the given sequence of UTF-8 code units.
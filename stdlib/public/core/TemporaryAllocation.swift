@@ -0,0 +1,111 @@
+//===--- TemporaryAllocation.swift ----------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+/// The largest temporary allocation, in bytes, that's made on the stack.
+///
+/// Larger allocations use the heap, so that a large or attacker-controlled
+/// capacity can't overflow the stack.
+internal var _maxStackTemporaryAllocationByteCount: Int {
+  return 1024
+}
+
+/// The alignment of memory allocated by `Builtin.stackAlloc`.
+internal var _stackTemporaryAllocationAlignment: Int {
+  return 16
+}
+
+/// Calls the given closure with a pointer to temporary, uninitialized memory
+/// of the given size and alignment.
+///
+/// Small allocations are made on the stack, which is much cheaper than
+/// allocating on the heap; larger allocations fall back to the heap. Either
+/// way, the memory is released when `body` returns.
+///
+/// - Parameters:
+///   - byteCount: The number of bytes to allocate. `byteCount` must not be
+///     negative.
+///   - alignment: The alignment of the memory, in bytes. `alignment` must be
+///     a positive power of 2.
+///   - body: A closure that takes a raw buffer pointer to the allocated
+///     memory. The buffer pointer argument is valid only for the duration
+///     of the call to `body`, and `body` must leave the memory
+///     deinitialized.
+/// - Returns: The return value of `body`.
+public func withUnsafeTemporaryAllocation<R>(
+  byteCount: Int,
+  alignment: Int,
+  _ body: (UnsafeMutableRawBufferPointer) throws -> R
+) rethrows -> R {
+  _precondition(byteCount >= 0,
+    "withUnsafeTemporaryAllocation with negative byte count")
+  _precondition(alignment > 0 && alignment & (alignment - 1) == 0,
+    "withUnsafeTemporaryAllocation alignment must be a power of 2")
+
+  if _fastPath(byteCount <= _maxStackTemporaryAllocationByteCount &&
+               alignment <= _stackTemporaryAllocationAlignment) {
+    let memory = Builtin.stackAlloc(byteCount._builtinWordValue)
+    defer { Builtin.stackDealloc(memory) }
+    return try body(UnsafeMutableRawBufferPointer(
+      start: UnsafeMutableRawPointer(memory), count: byteCount))
+  }
+
+  let memory = UnsafeMutableRawPointer.allocate(
+    bytes: byteCount, alignedTo: alignment)
+  defer { memory.deallocate(bytes: byteCount, alignedTo: alignment) }
+  return try body(UnsafeMutableRawBufferPointer(
+    start: memory, count: byteCount))
+}
+
+/// Calls the given closure with a pointer to temporary, uninitialized memory
+/// for the given number of instances of a type.
+///
+/// Small allocations are made on the stack, which is much cheaper than
+/// allocating on the heap; larger allocations fall back to the heap. Either
+/// way, the memory is released when `body` returns.
+///
+///     let squares = withUnsafeTemporaryAllocation(of: Int.self,
+///                                                  capacity: 5) {
+///       buffer -> [Int] in
+///       for i in 0..<buffer.count {
+///         buffer[i] = i * i
+///       }
+///       return Array(buffer)
+///     }
+///     print(squares)
+///     // Prints "[0, 1, 4, 9, 16]"
+///
+/// - Parameters:
+///   - type: The type of the instances to allocate memory for.
+///   - capacity: The number of instances to allocate memory for. `capacity`
+///     must not be negative.
+///   - body: A closure that takes a buffer pointer to the allocated memory,
+///     which is bound to `T`. The buffer pointer argument is valid only for
+///     the duration of the call to `body`, and `body` must deinitialize any
+///     instances it initializes in the memory.
+/// - Returns: The return value of `body`.
+public func withUnsafeTemporaryAllocation<T, R>(
+  of type: T.Type,
+  capacity: Int,
+  _ body: (UnsafeMutableBufferPointer<T>) throws -> R
+) rethrows -> R {
+  _precondition(capacity >= 0,
+    "withUnsafeTemporaryAllocation with negative capacity")
+  let byteCount = MemoryLayout<T>.stride * capacity
+
+  return try withUnsafeTemporaryAllocation(
+    byteCount: byteCount, alignment: MemoryLayout<T>.alignment
+  ) { rawBuffer in
+    let start = rawBuffer.baseAddress!.bindMemory(
+      to: T.self, capacity: capacity)
+    return try body(UnsafeMutableBufferPointer(start: start, count: capacity))
+  }
+}
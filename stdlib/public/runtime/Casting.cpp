@@ -18,17 +18,17 @@
 #include "swift/Basic/Demangle.h"
 #include "swift/Basic/Fallthrough.h"
 #include "swift/Basic/Lazy.h"
+#include "swift/Runtime/Concurrent.h"
 #include "swift/Runtime/Config.h"
 #include "swift/Runtime/Enum.h"
 #include "swift/Runtime/HeapObject.h"
 #include "swift/Runtime/Metadata.h"
 #include "swift/Runtime/Mutex.h"
-#include "llvm/ADT/DenseMap.h"
-#include "llvm/ADT/PointerIntPair.h"
 #include "swift/Runtime/Debug.h"
 #include "ErrorObject.h"
 #include "ExistentialMetadataImpl.h"
 #include "Private.h"
+#include "Profiler.h"
 #include "SwiftHashableSupport.h"
 #include "../SwiftShims/RuntimeShims.h"
 #include "stddef.h"
@@ -88,7 +88,8 @@ static void _buildNameForMetadata(const Metadata *type,
 #endif
 
   // Use the remangler to generate a mangled name from the type metadata.
-  auto demangling = _swift_buildDemanglingForMetadata(type);
+  Demangle::NodeFactory Factory;
+  auto demangling = _swift_buildDemanglingForMetadata(type, Factory);
   if (demangling == nullptr) {
     result = "<<< invalid type >>>";
     return;
@@ -107,53 +108,60 @@ std::string swift::nameForMetadata(const Metadata *type,
   return result;
 }
 
-SWIFT_CC(swift) SWIFT_RUNTIME_EXPORT
-TwoWordPair<const char *, uintptr_t>::Return
-swift::swift_getTypeName(const Metadata *type, bool qualified) {
-  using Pair = TwoWordPair<const char *, uintptr_t>;
-  using Key = llvm::PointerIntPair<const Metadata *, 1, bool>;
+namespace {
+struct TypeNameCacheKey {
+  const Metadata *Type;
+  bool Qualified;
+};
 
-  static StaticReadWriteLock TypeNameCacheLock;
-  static Lazy<llvm::DenseMap<Key, std::pair<const char *, size_t>>>
-    TypeNameCache;
-  
-  Key key(type, qualified);
-  auto &cache = TypeNameCache.get();
+struct TypeNameCacheEntry {
+  const Metadata *Type;
+  bool Qualified;
 
-  // Attempt read-only lookup of cache entry.
-  {
-    StaticScopedReadLock guard(TypeNameCacheLock);
+  /// The name, which is never freed once the entry is in the cache.
+  std::string Name;
 
-    auto found = cache.find(key);
-    if (found != cache.end()) {
-      auto result = found->second;
-      return Pair{result.first, result.second};
-    }
+  TypeNameCacheEntry(TypeNameCacheKey key, std::string name)
+    : Type(key.Type), Qualified(key.Qualified), Name(std::move(name)) {}
+
+  int compareWithKey(TypeNameCacheKey key) const {
+    if (key.Type != Type)
+      return (uintptr_t(key.Type) < uintptr_t(Type) ? -1 : 1);
+    if (key.Qualified != Qualified)
+      return (key.Qualified < Qualified ? -1 : 1);
+    return 0;
   }
 
-  // Read-only lookup failed to find item, we may need to create it.
-  {
-    StaticScopedWriteLock guard(TypeNameCacheLock);
+  static size_t getExtraAllocationSize(TypeNameCacheKey key,
+                                       const std::string &name) {
+    return 0;
+  }
 
-    // Do lookup again just to make sure it wasn't created by another
-    // thread before we acquired the write lock.
-    auto found = cache.find(key);
-    if (found != cache.end()) {
-      auto result = found->second;
-      return Pair{result.first, result.second};
-    }
+  size_t getExtraAllocationSize() const {
+    return 0;
+  }
+};
+} // end anonymous namespace
 
-    // Build the metadata name.
-    auto name = nameForMetadata(type, qualified);
-    // Copy it to memory we can reference forever.
-    auto size = name.size();
-    auto result = (char *)malloc(size + 1);
-    memcpy(result, name.data(), size);
-    result[size] = 0;
+/// The names returned by swift_getTypeName. Lookups don't take a lock, since
+/// they happen whenever a type is printed.
+static ConcurrentMap<TypeNameCacheEntry, /*Destructor*/ false> TypeNameCache;
 
-    cache.insert({key, {result, size}});
-    return Pair{result, size};
-  }
+SWIFT_CC(swift) SWIFT_RUNTIME_EXPORT
+TwoWordPair<const char *, uintptr_t>::Return
+swift::swift_getTypeName(const Metadata *type, bool qualified) {
+  using Pair = TwoWordPair<const char *, uintptr_t>;
+
+  TypeNameCacheKey key{type, qualified};
+  if (auto entry = TypeNameCache.find(key))
+    return Pair{entry->Name.c_str(), entry->Name.size()};
+
+  // Build the metadata name. If another thread races us to it, its name is
+  // the one that stays in the cache.
+  auto entry = TypeNameCache.getOrInsert(key,
+                                         nameForMetadata(type, qualified));
+  auto &name = entry.first->Name;
+  return Pair{name.c_str(), name.size()};
 }
 
 /// Report a dynamic cast failure.
@@ -760,6 +768,85 @@ static bool _dynamicCastFromAnyHashable(OpaqueValue *destination,
 /******************************************************************************/
 
 /// Perform a dynamic cast to an existential type.
+namespace {
+  struct CastFailureCacheKey {
+    const Metadata *Source;
+    const ExistentialTypeMetadata *Target;
+  };
+
+  /// A cast from a value type to an existential type which failed because
+  /// the value type doesn't conform to the existential's protocols.
+  struct CastFailureCacheEntry {
+  private:
+    const Metadata *Source;
+    const ExistentialTypeMetadata *Target;
+    /// The conformance generation under which the cast failed.
+    std::atomic<uintptr_t> Generation;
+
+  public:
+    CastFailureCacheEntry(CastFailureCacheKey key, uintptr_t generation)
+      : Source(key.Source), Target(key.Target), Generation(generation) {}
+
+    int compareWithKey(const CastFailureCacheKey &key) const {
+      if (key.Source != Source)
+        return (uintptr_t(key.Source) < uintptr_t(Source) ? -1 : 1);
+      if (key.Target != Target)
+        return (uintptr_t(key.Target) < uintptr_t(Target) ? -1 : 1);
+      return 0;
+    }
+
+    template <class... Args>
+    static size_t getExtraAllocationSize(Args &&... ignored) {
+      return 0;
+    }
+
+    uintptr_t getGeneration() const {
+      return Generation.load(std::memory_order_relaxed);
+    }
+
+    void setGeneration(uintptr_t generation) {
+      Generation.store(generation, std::memory_order_relaxed);
+    }
+  };
+}
+
+/// Failed casts from value types to existentials. Whether such a cast
+/// succeeds depends only on the pair of types and the set of loaded
+/// conformances, so code that repeatedly tries a failing cast (e.g. from
+/// 'Any') can skip the conformance lookups.
+static Lazy<ConcurrentMap<CastFailureCacheEntry>> CastFailureCache;
+
+/// Returns true if the result of a cast from a value of dynamic type
+/// \p srcType to an existential only depends on \p srcType's conformances.
+static bool isCastFailureCacheable(const Metadata *srcType) {
+  switch (srcType->getKind()) {
+  case MetadataKind::Struct:
+    // AnyHashable casts look at the wrapped value.
+    return !isAnyHashableType(cast<StructMetadata>(srcType));
+  case MetadataKind::Enum:
+    return true;
+  default:
+    return false;
+  }
+}
+
+static bool isCachedCastFailure(const Metadata *srcType,
+                                const ExistentialTypeMetadata *targetType,
+                                uintptr_t generation) {
+  auto *entry = CastFailureCache.get().find(
+    CastFailureCacheKey{srcType, targetType});
+  return entry && entry->getGeneration() == generation;
+}
+
+static void cacheCastFailure(const Metadata *srcType,
+                             const ExistentialTypeMetadata *targetType,
+                             uintptr_t generation) {
+  auto result = CastFailureCache.get().getOrInsert(
+    CastFailureCacheKey{srcType, targetType}, generation);
+  if (!result.second)
+    result.first->setGeneration(generation);
+}
+
 static bool _dynamicCastToExistential(OpaqueValue *dest,
                                       OpaqueValue *src,
                                       const Metadata *srcType,
@@ -829,6 +916,24 @@ static bool _dynamicCastToExistential(OpaqueValue *dest,
     return _fail(src, srcType, targetType, flags, srcDynamicType);
   };
 
+  // Whether a value type conforms to a non-class existential only depends on
+  // the loaded conformances, so remember failures.
+  bool canCacheFailure =
+    srcDynamicType &&
+    targetType->getRepresentation() != ExistentialTypeRepresentation::Class &&
+    isCastFailureCacheable(srcDynamicType);
+  uintptr_t conformanceGeneration = 0;
+  if (canCacheFailure) {
+    conformanceGeneration = _swift_getProtocolConformanceGeneration();
+    if (isCachedCastFailure(srcDynamicType, targetType, conformanceGeneration))
+      return _fail(src, srcType, targetType, flags, srcDynamicType);
+  }
+  auto failForNonConformance = [&] {
+    if (canCacheFailure)
+      cacheCastFailure(srcDynamicType, targetType, conformanceGeneration);
+    return fallbackForNonDirectConformance();
+  };
+
   // The representation of an existential is different for some protocols.
   switch (targetType->getRepresentation()) {
   case ExistentialTypeRepresentation::Class: {
@@ -950,7 +1055,7 @@ static bool _dynamicCastToExistential(OpaqueValue *dest,
     if (!_conformsToProtocols(srcDynamicValue, srcDynamicType,
                               targetType->Protocols,
                               destExistential->getWitnessTables()))
-      return fallbackForNonDirectConformance();
+      return failForNonConformance();
 
     // Fill in the type and value.
     destExistential->Type = srcDynamicType;
@@ -974,7 +1079,7 @@ static bool _dynamicCastToExistential(OpaqueValue *dest,
     if (!_conformsToProtocols(srcDynamicValue, srcDynamicType,
                               targetType->Protocols,
                               &errorWitness))
-      return fallbackForNonDirectConformance();
+      return failForNonConformance();
 
 #if SWIFT_OBJC_INTEROP
     // Check whether there is an embedded NSError. If so, use that for our Error
@@ -2395,6 +2500,11 @@ static bool _dynamicCastTupleToTuple(OpaqueValue *destination,
 /****************************** Main Entrypoint *******************************/
 /******************************************************************************/
 
+static bool dynamicCastImpl(OpaqueValue *dest, OpaqueValue *src,
+                            const Metadata *srcType,
+                            const Metadata *targetType,
+                            DynamicCastFlags flags);
+
 /// Perform a dynamic cast to an arbitrary type.
 SWIFT_RT_ENTRY_VISIBILITY
 bool swift::swift_dynamicCast(OpaqueValue *dest,
@@ -2403,6 +2513,18 @@ bool swift::swift_dynamicCast(OpaqueValue *dest,
                               const Metadata *targetType,
                               DynamicCastFlags flags)
     SWIFT_CC(RegisterPreservingCC_IMPL) {
+  if (LLVM_LIKELY(!profiler::isEnabled()))
+    return dynamicCastImpl(dest, src, srcType, targetType, flags);
+
+  bool result = dynamicCastImpl(dest, src, srcType, targetType, flags);
+  profiler::recordDynamicCast(srcType, targetType, result);
+  return result;
+}
+
+static bool dynamicCastImpl(OpaqueValue *dest, OpaqueValue *src,
+                            const Metadata *srcType,
+                            const Metadata *targetType,
+                            DynamicCastFlags flags) {
   auto unwrapResult = checkDynamicCastFromOptional(dest, src, srcType,
                                                    targetType, flags);
   srcType = unwrapResult.payloadType;
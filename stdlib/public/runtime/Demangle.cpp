@@ -27,11 +27,13 @@
 // to change stdlib reflection over to using remote mirrors.
 
 Demangle::NodePointer
-swift::_swift_buildDemanglingForMetadata(const Metadata *type);
+swift::_swift_buildDemanglingForMetadata(const Metadata *type,
+                                         Demangle::NodeFactory &Factory);
 
 // Build a demangled type tree for a nominal type.
 static Demangle::NodePointer
-_buildDemanglingForNominalType(const Metadata *type) {
+_buildDemanglingForNominalType(const Metadata *type,
+                               Demangle::NodeFactory &Factory) {
   using namespace Demangle;
 
   const Metadata *parent;
@@ -68,40 +70,41 @@ _buildDemanglingForNominalType(const Metadata *type) {
 
   // Demangle the base name.
   auto node = demangleTypeAsNode(description->Name,
-                                 strlen(description->Name));
+                                 strlen(description->Name), Factory);
   assert(node->getKind() == Node::Kind::Type);
 
   // Demangle the parent.
   if (parent) {
-    auto parentNode = _swift_buildDemanglingForMetadata(parent);
+    auto parentNode = _swift_buildDemanglingForMetadata(parent, Factory);
     if (parentNode->getKind() == Node::Kind::Type)
       parentNode = parentNode->getChild(0);
 
     auto typeNode = node->getChild(0);
-    auto newTypeNode = NodeFactory::create(typeNode->getKind());
+    auto newTypeNode = Factory.create(typeNode->getKind());
     newTypeNode->addChild(parentNode);
     newTypeNode->addChild(typeNode->getChild(1));
 
-    auto newNode = NodeFactory::create(Node::Kind::Type);
+    auto newNode = Factory.create(Node::Kind::Type);
     newNode->addChild(newTypeNode);
     node = newNode;
   }
 
   // If generic, demangle the type parameters.
   if (description->GenericParams.NumPrimaryParams > 0) {
-    auto typeParams = NodeFactory::create(Node::Kind::TypeList);
+    auto typeParams = Factory.create(Node::Kind::TypeList);
     auto typeBytes = reinterpret_cast<const char *>(type);
     auto genericParam = reinterpret_cast<const Metadata * const *>(
                  typeBytes + sizeof(void*) * description->GenericParams.Offset);
     for (unsigned i = 0, e = description->GenericParams.NumPrimaryParams;
          i < e; ++i, ++genericParam) {
-      auto demangling = _swift_buildDemanglingForMetadata(*genericParam);
+      auto demangling =
+        _swift_buildDemanglingForMetadata(*genericParam, Factory);
       if (demangling == nullptr)
         return nullptr;
       typeParams->addChild(demangling);
     }
 
-    auto genericNode = NodeFactory::create(boundGenericKind);
+    auto genericNode = Factory.create(boundGenericKind);
     genericNode->addChild(node);
     genericNode->addChild(typeParams);
     return genericNode;
@@ -110,7 +113,9 @@ _buildDemanglingForNominalType(const Metadata *type) {
 }
 
 // Build a demangled type tree for a type.
-Demangle::NodePointer swift::_swift_buildDemanglingForMetadata(const Metadata *type) {
+Demangle::NodePointer
+swift::_swift_buildDemanglingForMetadata(const Metadata *type,
+                                         Demangle::NodeFactory &Factory) {
   using namespace Demangle;
 
   switch (type->getKind()) {
@@ -118,19 +123,19 @@ Demangle::NodePointer swift::_swift_buildDemanglingForMetadata(const Metadata *t
   case MetadataKind::Enum:
   case MetadataKind::Optional:
   case MetadataKind::Struct:
-    return _buildDemanglingForNominalType(type);
+    return _buildDemanglingForNominalType(type, Factory);
   case MetadataKind::ObjCClassWrapper: {
 #if SWIFT_OBJC_INTEROP
     auto objcWrapper = static_cast<const ObjCClassWrapperMetadata *>(type);
     const char *className = class_getName((Class)objcWrapper->Class);
     
     // ObjC classes mangle as being in the magic "__ObjC" module.
-    auto module = NodeFactory::create(Node::Kind::Module, "__ObjC");
+    auto module = Factory.create(Node::Kind::Module, "__ObjC");
     
-    auto node = NodeFactory::create(Node::Kind::Class);
+    auto node = Factory.create(Node::Kind::Class);
     node->addChild(module);
-    node->addChild(NodeFactory::create(Node::Kind::Identifier,
-                                       llvm::StringRef(className)));
+    node->addChild(Factory.create(Node::Kind::Identifier,
+                                  llvm::StringRef(className)));
     
     return node;
 #else
@@ -141,12 +146,12 @@ Demangle::NodePointer swift::_swift_buildDemanglingForMetadata(const Metadata *t
   case MetadataKind::ForeignClass: {
     auto foreign = static_cast<const ForeignClassMetadata *>(type);
     return Demangle::demangleTypeAsNode(foreign->getName(),
-                                        strlen(foreign->getName()));
+                                        strlen(foreign->getName()), Factory);
   }
   case MetadataKind::Existential: {
     auto exis = static_cast<const ExistentialTypeMetadata *>(type);
-    NodePointer proto_list = NodeFactory::create(Node::Kind::ProtocolList);
-    NodePointer type_list = NodeFactory::create(Node::Kind::TypeList);
+    NodePointer proto_list = Factory.create(Node::Kind::ProtocolList);
+    NodePointer type_list = Factory.create(Node::Kind::TypeList);
 
     proto_list->addChild(type_list);
     
@@ -166,17 +171,18 @@ Demangle::NodePointer swift::_swift_buildDemanglingForMetadata(const Metadata *t
     for (auto *protocol : protocols) {
       // The protocol name is mangled as a type symbol, with the _Tt prefix.
       auto protocolNode = demangleSymbolAsNode(protocol->Name,
-                                               strlen(protocol->Name));
+                                               strlen(protocol->Name),
+                                               Factory);
       
       // ObjC protocol names aren't mangled.
       if (!protocolNode) {
-        auto module = NodeFactory::create(Node::Kind::Module,
-                                          MANGLING_MODULE_OBJC);
-        auto node = NodeFactory::create(Node::Kind::Protocol);
+        auto module = Factory.create(Node::Kind::Module,
+                                     MANGLING_MODULE_OBJC);
+        auto node = Factory.create(Node::Kind::Protocol);
         node->addChild(module);
-        node->addChild(NodeFactory::create(Node::Kind::Identifier,
-                                           llvm::StringRef(protocol->Name)));
-        auto typeNode = NodeFactory::create(Node::Kind::Type);
+        node->addChild(Factory.create(Node::Kind::Identifier,
+                                      llvm::StringRef(protocol->Name)));
+        auto typeNode = Factory.create(Node::Kind::Type);
         typeNode->addChild(node);
         type_list->addChild(typeNode);
         continue;
@@ -199,8 +205,9 @@ Demangle::NodePointer swift::_swift_buildDemanglingForMetadata(const Metadata *t
   }
   case MetadataKind::ExistentialMetatype: {
     auto metatype = static_cast<const ExistentialMetatypeMetadata *>(type);
-    auto instance = _swift_buildDemanglingForMetadata(metatype->InstanceType);
-    auto node = NodeFactory::create(Node::Kind::ExistentialMetatype);
+    auto instance =
+      _swift_buildDemanglingForMetadata(metatype->InstanceType, Factory);
+    auto node = Factory.create(Node::Kind::ExistentialMetatype);
     node->addChild(instance);
     return node;
   }
@@ -226,18 +233,19 @@ Demangle::NodePointer swift::_swift_buildDemanglingForMetadata(const Metadata *t
     std::vector<NodePointer> inputs;
     for (unsigned i = 0, e = func->getNumArguments(); i < e; ++i) {
       auto arg = func->getArguments()[i];
-      auto input = _swift_buildDemanglingForMetadata(arg.getPointer());
+      auto input =
+        _swift_buildDemanglingForMetadata(arg.getPointer(), Factory);
       if (arg.getFlag()) {
-        NodePointer inout = NodeFactory::create(Node::Kind::InOut);
+        NodePointer inout = Factory.create(Node::Kind::InOut);
         inout->addChild(input);
         input = inout;
       }
       inputs.push_back(input);
     }
 
-    NodePointer totalInput;
+    NodePointer totalInput = nullptr;
     if (inputs.size() > 1) {
-      auto tuple = NodeFactory::create(Node::Kind::NonVariadicTuple);
+      auto tuple = Factory.create(Node::Kind::NonVariadicTuple);
       for (auto &input : inputs)
         tuple->addChild(input);
       totalInput = tuple;
@@ -245,35 +253,37 @@ Demangle::NodePointer swift::_swift_buildDemanglingForMetadata(const Metadata *t
       totalInput = inputs.front();
     }
     
-    NodePointer args = NodeFactory::create(Node::Kind::ArgumentTuple);
+    NodePointer args = Factory.create(Node::Kind::ArgumentTuple);
     args->addChild(totalInput);
     
-    NodePointer resultTy = _swift_buildDemanglingForMetadata(func->ResultType);
-    NodePointer result = NodeFactory::create(Node::Kind::ReturnType);
+    NodePointer resultTy =
+      _swift_buildDemanglingForMetadata(func->ResultType, Factory);
+    NodePointer result = Factory.create(Node::Kind::ReturnType);
     result->addChild(resultTy);
     
-    auto funcNode = NodeFactory::create(kind);
+    auto funcNode = Factory.create(kind);
     if (func->throws())
-      funcNode->addChild(NodeFactory::create(Node::Kind::ThrowsAnnotation));
+      funcNode->addChild(Factory.create(Node::Kind::ThrowsAnnotation));
     funcNode->addChild(args);
     funcNode->addChild(result);
     return funcNode;
   }
   case MetadataKind::Metatype: {
     auto metatype = static_cast<const MetatypeMetadata *>(type);
-    auto instance = _swift_buildDemanglingForMetadata(metatype->InstanceType);
-    auto typeNode = NodeFactory::create(Node::Kind::Type);
+    auto instance =
+      _swift_buildDemanglingForMetadata(metatype->InstanceType, Factory);
+    auto typeNode = Factory.create(Node::Kind::Type);
     typeNode->addChild(instance);
-    auto node = NodeFactory::create(Node::Kind::Metatype);
+    auto node = Factory.create(Node::Kind::Metatype);
     node->addChild(typeNode);
     return node;
   }
   case MetadataKind::Tuple: {
     auto tuple = static_cast<const TupleTypeMetadata *>(type);
     const char *labels = tuple->Labels;
-    auto tupleNode = NodeFactory::create(Node::Kind::NonVariadicTuple);
+    auto tupleNode = Factory.create(Node::Kind::NonVariadicTuple);
     for (unsigned i = 0, e = tuple->NumElements; i < e; ++i) {
-      auto elt = NodeFactory::create(Node::Kind::TupleElement);
+      auto elt = Factory.create(Node::Kind::TupleElement);
 
       // Add a label child if applicable:
       if (labels) {
@@ -282,8 +292,8 @@ Demangle::NodePointer swift::_swift_buildDemanglingForMetadata(const Metadata *t
           // If there is one, and the label isn't empty, add a label child.
           if (labels != space) {
             auto eltName =
-              NodeFactory::create(Node::Kind::TupleElementName,
-                                  std::string(labels, space));
+              Factory.create(Node::Kind::TupleElementName,
+                             StringRef(labels, space - labels));
             elt->addChild(std::move(eltName));
           }
 
@@ -294,7 +304,7 @@ Demangle::NodePointer swift::_swift_buildDemanglingForMetadata(const Metadata *t
 
       // Add the element type child.
       auto eltType =
-        _swift_buildDemanglingForMetadata(tuple->getElement(i).Type);
+        _swift_buildDemanglingForMetadata(tuple->getElement(i).Type, Factory);
       elt->addChild(std::move(eltType));
 
       // Add the completed element to the tuple.
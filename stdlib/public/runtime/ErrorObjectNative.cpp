@@ -22,9 +22,11 @@
 #if !SWIFT_OBJC_INTEROP
 
 #include <stdio.h>
+#include "swift/Runtime/Concurrent.h"
 #include "swift/Runtime/Debug.h"
 #include "ErrorObject.h"
 #include "Private.h"
+#include <atomic>
 
 using namespace swift;
 
@@ -64,13 +66,9 @@ static const FullMetadata<HeapMetadata> ErrorMetadata{
   Metadata{MetadataKind::ErrorObject},
 };
 
-SWIFT_CC(swift) SWIFT_RUNTIME_EXPORT
-extern "C"
-BoxPair::Return
-swift::swift_allocError(const swift::Metadata *type,
-                        const swift::WitnessTable *errorConformance,
-                        OpaqueValue *initialValue,
-                        bool isTake) {
+static BoxPair _allocErrorBox(const Metadata *type,
+                              const WitnessTable *errorConformance,
+                              OpaqueValue *initialValue, bool isTake) {
   auto sizeAndAlign = _getErrorAllocatedSizeAndAlignmentMask(type);
   
   auto allocated = swift_allocObject(&ErrorMetadata,
@@ -93,6 +91,100 @@ swift::swift_allocError(const swift::Metadata *type,
   return BoxPair{allocated, valuePtr};
 }
 
+namespace {
+struct SharedErrorBoxKey {
+  const Metadata *type;
+  const WitnessTable *errorConformance;
+  uint8_t value;
+};
+
+/// A box for an error value that is at most a byte of POD, such as a case
+/// of an enum without payloads. Error boxes are immutable once they are
+/// initialized, so every throw of the same value can share one.
+struct SharedErrorBoxEntry {
+  SharedErrorBoxKey key;
+
+  /// The box, or null until the first throw of the value has made it. The
+  /// cache holds a reference to it, so it is never destroyed.
+  std::atomic<HeapObject *> box;
+
+  SharedErrorBoxEntry(SharedErrorBoxKey key) : key(key), box(nullptr) {}
+
+  int compareWithKey(const SharedErrorBoxKey &other) const {
+    if (other.type != key.type)
+      return uintptr_t(other.type) < uintptr_t(key.type) ? -1 : 1;
+    if (other.errorConformance != key.errorConformance)
+      return uintptr_t(other.errorConformance)
+               < uintptr_t(key.errorConformance) ? -1 : 1;
+    if (other.value != key.value)
+      return other.value < key.value ? -1 : 1;
+    return 0;
+  }
+
+  static size_t getExtraAllocationSize(SharedErrorBoxKey key) {
+    return 0;
+  }
+
+  size_t getExtraAllocationSize() const {
+    return 0;
+  }
+};
+} // end anonymous namespace
+
+/// There are at most 256 entries for each error type.
+static ConcurrentMap<SharedErrorBoxEntry, /*Destructor*/ false>
+SharedErrorBoxes;
+
+/// Returns the shared box holding a copy of \p initialValue, or null if the
+/// value can't be shared.
+static HeapObject *_getSharedErrorBox(const Metadata *type,
+                                      const WitnessTable *errorConformance,
+                                      OpaqueValue *initialValue) {
+  auto vw = type->getValueWitnesses();
+  if (!vw->isPOD() || vw->getSize() > 1)
+    return nullptr;
+
+  uint8_t value = vw->getSize() == 0
+    ? 0 : *reinterpret_cast<const uint8_t *>(initialValue);
+  auto entry = SharedErrorBoxes.getOrInsert(
+      SharedErrorBoxKey{type, errorConformance, value}).first;
+
+  if (auto box = entry->box.load(std::memory_order_acquire))
+    return box;
+
+  HeapObject *box = _allocErrorBox(type, errorConformance, initialValue,
+                                   /*isTake*/ false).first;
+  HeapObject *existing = nullptr;
+  if (entry->box.compare_exchange_strong(existing, box,
+                                         std::memory_order_acq_rel,
+                                         std::memory_order_acquire))
+    return box;
+
+  // Another thread made the box first.
+  swift_release(box);
+  return existing;
+}
+
+SWIFT_CC(swift) SWIFT_RUNTIME_EXPORT
+extern "C"
+BoxPair::Return
+swift::swift_allocError(const swift::Metadata *type,
+                        const swift::WitnessTable *errorConformance,
+                        OpaqueValue *initialValue,
+                        bool isTake) {
+  // Errors that are thrown with a known value, like a case of an enum
+  // without payloads, don't need a box of their own. The value is POD, so
+  // taking it needs no cleanup.
+  if (initialValue) {
+    if (auto box = _getSharedErrorBox(type, errorConformance, initialValue)) {
+      swift_retain(box);
+      return BoxPair{box, static_cast<SwiftError *>(box)->getValue()};
+    }
+  }
+
+  return _allocErrorBox(type, errorConformance, initialValue, isTake);
+}
+
 void
 swift::swift_deallocError(SwiftError *error, const Metadata *type) {
   auto sizeAndAlign = _getErrorAllocatedSizeAndAlignmentMask(type);
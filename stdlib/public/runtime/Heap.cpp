@@ -20,11 +20,330 @@
 #include "swift/Runtime/Debug.h"
 #include <stdlib.h>
 
+#if SWIFT_RUNTIME_ENABLE_SLAB_ALLOCATOR
+#include "swift/Runtime/Mutex.h"
+#include <atomic>
+#include <new>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#endif
+
 using namespace swift;
 
+#if SWIFT_RUNTIME_ENABLE_SLAB_ALLOCATOR
+
+// The slab allocator serves small allocations from per-thread caches of
+// free blocks, one cache per size class. Blocks are carved out of large
+// chunks, which are never returned to the system allocator. A thread that
+// frees more blocks than it caches hands a batch back to a shared pool, from
+// which other threads refill their caches; this keeps producer/consumer
+// patterns from growing one thread's cache without bound.
+//
+// All chunks are carved out of one range of address space, which is
+// reserved up front. swift_slowDealloc can therefore tell from the pointer
+// alone whether a block came from a slab, and which size class it has. Not
+// every caller passes the size that was allocated (e.g. tail-allocated
+// objects are released with their instance size), so the size passed to
+// swift_slowDealloc can't be trusted for that.
+namespace {
+
+/// Allocations of at most this size are served from slabs...
+constexpr size_t SlabMaxAllocSize = 256;
+/// ...as long as they don't require more than this alignment.
+constexpr size_t SlabQuantum = 16;
+constexpr unsigned SlabNumSizeClasses = SlabMaxAllocSize / SlabQuantum;
+
+/// The size of the chunks which are carved into blocks.
+constexpr size_t SlabChunkSize = 64 * 1024;
+
+/// The size of the address range reserved for chunks. Once it is used up,
+/// small allocations fall back to malloc.
+constexpr size_t SlabRegionSize =
+  sizeof(void *) >= 8 ? (size_t(4) << 30) : (size_t(256) << 20);
+constexpr size_t SlabMaxChunks = SlabRegionSize / SlabChunkSize;
+
+/// The maximum number of free blocks a thread caches for each size class.
+constexpr unsigned SlabMaxCachedBlocks = 256;
+
+/// The number of blocks moved between a thread's cache and the shared pool
+/// at once.
+constexpr unsigned SlabTransferBlocks = SlabMaxCachedBlocks / 2;
+
+struct SlabFreeBlock {
+  SlabFreeBlock *Next;
+};
+
+struct SlabFreeList {
+  SlabFreeBlock *Head = nullptr;
+  unsigned Count = 0;
+
+  bool empty() const { return Head == nullptr; }
+
+  void push(void *ptr) {
+    auto *block = static_cast<SlabFreeBlock *>(ptr);
+    block->Next = Head;
+    Head = block;
+    ++Count;
+  }
+
+  void *pop() {
+    SlabFreeBlock *block = Head;
+    Head = block->Next;
+    --Count;
+    return block;
+  }
+
+  /// Move up to \p n blocks from this list to \p dest.
+  void transferTo(SlabFreeList &dest, unsigned n) {
+    while (n-- && !empty())
+      dest.push(pop());
+  }
+};
+
+struct SlabThreadCache {
+  SlabFreeList FreeLists[SlabNumSizeClasses];
+
+  // Only ever written by the owning thread, but read by
+  // swift_getSlabAllocatorStatistics on other threads.
+  std::atomic<uint64_t> NumAllocations{0};
+  std::atomic<uint64_t> NumDeallocations{0};
+
+  // The list of live thread caches, guarded by the shared pool's lock.
+  SlabThreadCache *Prev = nullptr;
+  SlabThreadCache *Next = nullptr;
+};
+
+/// Free blocks shared by all threads.
+struct SlabSharedPool {
+  StaticMutex Lock;
+  SlabFreeList FreeLists[SlabNumSizeClasses];
+  SlabThreadCache *ThreadCaches = nullptr;
+
+  // Counters of exited threads. Guarded by Lock.
+  uint64_t NumExitedAllocations = 0;
+  uint64_t NumExitedDeallocations = 0;
+
+  std::atomic<uint64_t> NumChunks{0};
+  std::atomic<uint64_t> NumTransfers{0};
+};
+
+SlabSharedPool SlabPool;
+pthread_key_t SlabThreadCacheKey;
+
+/// The start of the reserved range of chunks.
+uintptr_t SlabRegionBegin = 0;
+
+/// The size class of each chunk in the reserved range, plus one; zero for
+/// chunks which have not been carved up yet.
+std::atomic<uint8_t> SlabChunkSizeClasses[SlabMaxChunks];
+
+LLVM_THREAD_LOCAL SlabThreadCache *CurrentSlabThreadCache = nullptr;
+
+void printSlabAllocatorStatistics() {
+  SlabAllocatorStatistics stats;
+  swift_getSlabAllocatorStatistics(&stats);
+  fprintf(stderr,
+          "Swift slab allocator: %llu allocations, %llu deallocations, "
+          "%llu chunks (%llu KiB), %llu transfers\n",
+          (unsigned long long)stats.NumAllocations,
+          (unsigned long long)stats.NumDeallocations,
+          (unsigned long long)stats.NumChunks,
+          (unsigned long long)(stats.NumChunks * SlabChunkSize / 1024),
+          (unsigned long long)stats.NumTransfers);
+}
+
+/// Returns the cached blocks and counters of an exiting thread to the
+/// shared pool.
+void destroySlabThreadCache(void *ptr) {
+  auto *cache = static_cast<SlabThreadCache *>(ptr);
+  SlabPool.Lock.withLock([&] {
+    for (unsigned i = 0; i != SlabNumSizeClasses; ++i)
+      cache->FreeLists[i].transferTo(SlabPool.FreeLists[i], ~0U);
+    SlabPool.NumExitedAllocations += cache->NumAllocations.load();
+    SlabPool.NumExitedDeallocations += cache->NumDeallocations.load();
+    if (cache->Prev)
+      cache->Prev->Next = cache->Next;
+    else
+      SlabPool.ThreadCaches = cache->Next;
+    if (cache->Next)
+      cache->Next->Prev = cache->Prev;
+  });
+  // Later destructors on this thread may still free memory; they will get a
+  // fresh cache.
+  if (CurrentSlabThreadCache == cache)
+    CurrentSlabThreadCache = nullptr;
+  cache->~SlabThreadCache();
+  free(cache);
+}
+
+bool isSlabAllocatorEnabled() {
+  static const bool enabled = [] {
+    const char *value = getenv("SWIFT_RUNTIME_SLAB_ALLOCATOR");
+    if (!value || !value[0] || strcmp(value, "0") == 0)
+      return false;
+    void *region = mmap(nullptr, SlabRegionSize, PROT_NONE,
+                        MAP_PRIVATE | MAP_ANON | MAP_NORESERVE, -1, 0);
+    if (region == MAP_FAILED)
+      return false;
+    if (pthread_key_create(&SlabThreadCacheKey, destroySlabThreadCache) != 0) {
+      munmap(region, SlabRegionSize);
+      return false;
+    }
+    SlabRegionBegin = reinterpret_cast<uintptr_t>(region);
+    if (getenv("SWIFT_RUNTIME_SLAB_ALLOCATOR_STATS"))
+      atexit(printSlabAllocatorStatistics);
+    return true;
+  }();
+  return enabled;
+}
+
+/// Returns the size class for an allocation, or -1 if it is not served from
+/// slabs.
+int getSlabSizeClass(size_t size, size_t alignMask) {
+  if (size > SlabMaxAllocSize || alignMask >= SlabQuantum ||
+      !isSlabAllocatorEnabled())
+    return -1;
+  return size == 0 ? 0 : (size - 1) / SlabQuantum;
+}
+
+/// Returns the size class of the slab block \p ptr, or -1 if it was not
+/// allocated from a slab.
+int getSlabSizeClassOfBlock(void *ptr) {
+  if (!isSlabAllocatorEnabled())
+    return -1;
+  uintptr_t offset = reinterpret_cast<uintptr_t>(ptr) - SlabRegionBegin;
+  if (offset >= SlabRegionSize)
+    return -1;
+  // The chunk's entry was written before any of its blocks were handed out.
+  auto entry = SlabChunkSizeClasses[offset / SlabChunkSize]
+                 .load(std::memory_order_acquire);
+  assert(entry != 0 && "pointer into a chunk which is not in use");
+  return int(entry) - 1;
+}
+
+SlabThreadCache *getSlabThreadCache() {
+  if (LLVM_LIKELY(CurrentSlabThreadCache != nullptr))
+    return CurrentSlabThreadCache;
+
+  void *memory = malloc(sizeof(SlabThreadCache));
+  if (!memory) swift::crash("Could not allocate memory.");
+  auto *cache = new (memory) SlabThreadCache();
+  SlabPool.Lock.withLock([&] {
+    cache->Next = SlabPool.ThreadCaches;
+    if (cache->Next)
+      cache->Next->Prev = cache;
+    SlabPool.ThreadCaches = cache;
+  });
+  pthread_setspecific(SlabThreadCacheKey, cache);
+  CurrentSlabThreadCache = cache;
+  return cache;
+}
+
+/// Refill \p list, which must be empty, from the shared pool, carving up a
+/// new chunk if the pool has run dry. Returns false if the reserved range
+/// is used up.
+bool refillSlabFreeList(SlabFreeList &list, unsigned sizeClass) {
+  bool refilled = false;
+  SlabPool.Lock.withLock([&] {
+    SlabFreeList &shared = SlabPool.FreeLists[sizeClass];
+    if (shared.empty()) {
+      auto chunkIndex = SlabPool.NumChunks.load(std::memory_order_relaxed);
+      if (chunkIndex == SlabMaxChunks)
+        return;
+      char *begin = reinterpret_cast<char *>(SlabRegionBegin) +
+                    chunkIndex * SlabChunkSize;
+      if (mprotect(begin, SlabChunkSize, PROT_READ | PROT_WRITE) != 0)
+        swift::crash("Could not allocate memory.");
+      SlabChunkSizeClasses[chunkIndex].store(sizeClass + 1,
+                                             std::memory_order_release);
+      size_t blockSize = (sizeClass + 1) * SlabQuantum;
+      for (char *block = begin + SlabChunkSize - SlabChunkSize % blockSize;
+           block != begin; )
+        shared.push(block -= blockSize);
+      SlabPool.NumChunks.store(chunkIndex + 1, std::memory_order_relaxed);
+    }
+    shared.transferTo(list, SlabTransferBlocks);
+    refilled = true;
+  });
+  if (refilled)
+    SlabPool.NumTransfers.fetch_add(1, std::memory_order_relaxed);
+  return refilled;
+}
+
+void bumpCounter(std::atomic<uint64_t> &counter) {
+  // Only the owning thread writes the counter; avoid a read-modify-write.
+  counter.store(counter.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+}
+
+void *slabAlloc(unsigned sizeClass) {
+  SlabThreadCache *cache = getSlabThreadCache();
+  SlabFreeList &list = cache->FreeLists[sizeClass];
+  if (LLVM_UNLIKELY(list.empty()) && !refillSlabFreeList(list, sizeClass))
+    return nullptr;
+  bumpCounter(cache->NumAllocations);
+  return list.pop();
+}
+
+void slabDealloc(void *ptr, unsigned sizeClass) {
+  SlabThreadCache *cache = getSlabThreadCache();
+  SlabFreeList &list = cache->FreeLists[sizeClass];
+  list.push(ptr);
+  bumpCounter(cache->NumDeallocations);
+  if (LLVM_UNLIKELY(list.Count > SlabMaxCachedBlocks)) {
+    SlabPool.Lock.withLock([&] {
+      list.transferTo(SlabPool.FreeLists[sizeClass], SlabTransferBlocks);
+    });
+    SlabPool.NumTransfers.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+} // end anonymous namespace
+
+#endif // SWIFT_RUNTIME_ENABLE_SLAB_ALLOCATOR
+
+bool swift::swift_getSlabAllocatorStatistics(SlabAllocatorStatistics *stats) {
+#if SWIFT_RUNTIME_ENABLE_SLAB_ALLOCATOR
+  if (!isSlabAllocatorEnabled())
+    return false;
+  SlabPool.Lock.withLock([&] {
+    stats->NumAllocations = SlabPool.NumExitedAllocations;
+    stats->NumDeallocations = SlabPool.NumExitedDeallocations;
+    for (auto *cache = SlabPool.ThreadCaches; cache; cache = cache->Next) {
+      stats->NumAllocations +=
+        cache->NumAllocations.load(std::memory_order_relaxed);
+      stats->NumDeallocations +=
+        cache->NumDeallocations.load(std::memory_order_relaxed);
+    }
+  });
+  stats->NumChunks = SlabPool.NumChunks.load(std::memory_order_relaxed);
+  stats->NumTransfers = SlabPool.NumTransfers.load(std::memory_order_relaxed);
+  return true;
+#else
+  return false;
+#endif
+}
+
+size_t swift::swift_getSlabAllocationSize(const void *ptr) {
+#if SWIFT_RUNTIME_ENABLE_SLAB_ALLOCATOR
+  int sizeClass = getSlabSizeClassOfBlock(const_cast<void *>(ptr));
+  if (sizeClass >= 0)
+    return (sizeClass + 1) * SlabQuantum;
+#endif
+  return 0;
+}
+
 SWIFT_RT_ENTRY_VISIBILITY
 void *swift::swift_slowAlloc(size_t size, size_t alignMask)
     SWIFT_CC(RegisterPreservingCC_IMPL) {
+#if SWIFT_RUNTIME_ENABLE_SLAB_ALLOCATOR
+  int sizeClass = getSlabSizeClass(size, alignMask);
+  if (sizeClass >= 0)
+    if (void *p = slabAlloc(sizeClass))
+      return p;
+#endif
   // FIXME: use posix_memalign if alignMask is larger than the system guarantee.
   void *p = malloc(size);
   if (!p) swift::crash("Could not allocate memory.");
@@ -34,5 +353,11 @@ void *swift::swift_slowAlloc(size_t size, size_t alignMask)
 SWIFT_RT_ENTRY_VISIBILITY
 void swift::swift_slowDealloc(void *ptr, size_t bytes, size_t alignMask)
     SWIFT_CC(RegisterPreservingCC_IMPL) {
+#if SWIFT_RUNTIME_ENABLE_SLAB_ALLOCATOR
+  // Only the block's address tells where it came from; see above.
+  int sizeClass = getSlabSizeClassOfBlock(ptr);
+  if (sizeClass >= 0)
+    return slabDealloc(ptr, sizeClass);
+#endif
   free(ptr);
 }
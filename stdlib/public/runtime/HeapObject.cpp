@@ -18,12 +18,16 @@
 #include "swift/Runtime/HeapObject.h"
 #include "swift/Runtime/Heap.h"
 #include "swift/Runtime/Metadata.h"
+#include "swift/Runtime/Mutex.h"
 #include "swift/ABI/System.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/Support/MathExtras.h"
 #include "MetadataCache.h"
 #include "Private.h"
+#include "Profiler.h"
 #include "swift/Runtime/Debug.h"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstring>
 #include <cstdio>
@@ -71,6 +75,9 @@ SWIFT_RT_ENTRY_IMPL(swift_allocObject)(HeapMetadata const *metadata,
   // If leak tracking is enabled, start tracking this object.
   SWIFT_LEAKS_START_TRACKING_OBJECT(object);
 
+  if (profiler::isEnabled())
+    profiler::recordAllocation(metadata, requiredSize);
+
   return object;
 }
 
@@ -85,13 +92,21 @@ swift::swift_initStackObject(HeapMetadata const *metadata,
 
 }
 
+static bool clearWeakSideTable(HeapObject *object);
+
 void
 swift::swift_verifyEndOfLifetime(HeapObject *object) {
   if (object->refCount.getCount() != 0)
     swift::fatalError(/* flags = */ 0,
                       "fatal error: stack object escaped\n");
   
-  if (object->weakRefCount.getCount() != 1)
+  // Weak references point at the object's side table rather than counting
+  // on the object, so they have to be looked for there. If the object wasn't
+  // deallocated, its side table is still attached and must be detached here.
+  bool hasWeakReferences = object->weakRefCount.hasSideTable() &&
+                           clearWeakSideTable(object);
+
+  if (object->weakRefCount.getCount() != 1 || hasWeakReferences)
     swift::fatalError(/* flags = */ 0,
                       "fatal error: weak/unowned reference to stack object\n");
 }
@@ -299,6 +314,19 @@ void SWIFT_RT_ENTRY_IMPL(swift_release_n)(HeapObject *object, uint32_t n)
   }
 }
 
+void swift::swift_retain_array(HeapObject * const *objects, uint32_t count) {
+  for (uint32_t i = 0; i != count; ++i)
+    _swift_retain_inlined(objects[i]);
+}
+
+void swift::swift_release_array(HeapObject * const *objects, uint32_t count) {
+  for (uint32_t i = 0; i != count; ++i) {
+    HeapObject *object = objects[i];
+    if (object && object->refCount.decrementShouldDeallocate())
+      _swift_release_dealloc(object);
+  }
+}
+
 void swift::swift_setDeallocating(HeapObject *object) {
   object->refCount.decrementFromOneAndDeallocateNonAtomic();
 }
@@ -617,6 +645,10 @@ void swift::swift_deallocObject(HeapObject *object,
   // If we are tracking leaks, stop tracking this object.
   SWIFT_LEAKS_STOP_TRACKING_OBJECT(object);
 
+  // Any weak references to the object now refer to nothing.
+  if (object->weakRefCount.hasSideTable())
+    clearWeakSideTable(object);
+
   // Drop the initial weak retain of the object.
   //
   // If the outstanding weak retain count is 1 (i.e. only the initial
@@ -705,27 +737,152 @@ enum: short {
   WR_SPINLIMIT = 64,
 };
 
-bool swift::isNativeSwiftWeakReference(WeakReference *ref) {
-  return (ref->Value & WR_NATIVEMASK) == WR_NATIVE;
+namespace {
+/// The out-of-line record of a native object that weak references point to.
+///
+/// Weak references don't hold an unowned reference to the object itself, so
+/// an object's storage can be freed as soon as it is deallocated, even if
+/// stale weak references to it remain. Instead, the first weak reference to
+/// an object creates a side table for it, which is reference-counted by the
+/// weak references to it and by the object while it is alive. Deallocating
+/// the object clears the side table's pointer to it.
+class WeakSideTable {
+  /// The object, or null once it has been deallocated.
+  HeapObject *Object;
+
+  /// Guards Object against the object being deallocated while a weak
+  /// reference is being loaded.
+  Mutex Lock;
+
+  /// The number of weak references to this side table, plus one until the
+  /// object is deallocated.
+  std::atomic<size_t> RefCount;
+
+public:
+  explicit WeakSideTable(HeapObject *object) : Object(object), RefCount(1) {}
+
+  void retain() {
+    RefCount.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void release() {
+    if (RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      delete this;
+  }
+
+  /// Returns a strong reference to the object, or null if it is being or
+  /// has been deallocated.
+  HeapObject *tryRetainObject() {
+    ScopedLock guard(Lock);
+    if (!Object || Object->refCount.isDeallocating())
+      return nullptr;
+    return swift_tryRetain(Object);
+  }
+
+  /// Returns true if the object is being or has been deallocated.
+  bool isObjectDead() {
+    ScopedLock guard(Lock);
+    return !Object || Object->refCount.isDeallocating();
+  }
+
+  /// Returns true if any weak references to this side table remain.
+  bool hasWeakReferences() const {
+    return RefCount.load(std::memory_order_acquire) > 1;
+  }
+
+  /// Called when the object is deallocated.
+  void clearObject() {
+    {
+      ScopedLock guard(Lock);
+      Object = nullptr;
+    }
+    release();
+  }
+};
+
+/// The side tables of all live objects that have had weak references formed
+/// to them.
+///
+/// The map is split into shards selected by the object's address, so that
+/// forming weak references to different objects rarely contends on the same
+/// lock.
+struct WeakSideTableState {
+  enum : size_t { NumShards = 64 };
+
+  struct alignas(64) Shard {
+    Mutex Lock;
+    llvm::DenseMap<HeapObject *, WeakSideTable *> Tables;
+  };
+
+  Shard Shards[NumShards];
+
+  Shard &getShard(HeapObject *object) {
+    // Heap objects are at least 16-byte aligned, so the low bits carry no
+    // information.
+    auto bits = reinterpret_cast<uintptr_t>(object) >> 4;
+    return Shards[(bits ^ (bits >> 6)) % NumShards];
+  }
+};
+} // end anonymous namespace
+
+static Lazy<WeakSideTableState> WeakSideTables;
+
+/// Returns a new weak reference to the side table of \p object, creating
+/// the side table if necessary. The caller must hold a strong reference to
+/// \p object.
+static WeakSideTable *formWeakReference(HeapObject *object) {
+  auto &shard = WeakSideTables.get().getShard(object);
+  WeakSideTable *result = nullptr;
+  shard.Lock.withLock([&] {
+    auto &table = shard.Tables[object];
+    // The flag is only ever set with the shard's lock held. A table without
+    // the flag belongs to an earlier object at this address whose storage
+    // was reclaimed without being deallocated, such as a stack object in a
+    // build without stack promotion checks; detach it.
+    if (table && !object->weakRefCount.hasSideTable()) {
+      table->clearObject();
+      table = nullptr;
+    }
+    if (!table) {
+      table = new WeakSideTable(object);
+      object->weakRefCount.setHasSideTable();
+    }
+    table->retain();
+    result = table;
+  });
+  return result;
 }
 
-void swift::swift_weakInit(WeakReference *ref, HeapObject *value) {
-  ref->Value = (uintptr_t)value | WR_NATIVE;
-  SWIFT_RT_ENTRY_CALL(swift_unownedRetain)(value);
+/// Detaches \p object from its side table as it is deallocated. Returns true
+/// if weak references to the object remain.
+static bool clearWeakSideTable(HeapObject *object) {
+  auto &shard = WeakSideTables.get().getShard(object);
+  WeakSideTable *table = nullptr;
+  shard.Lock.withLock([&] {
+    auto found = shard.Tables.find(object);
+    assert(found != shard.Tables.end() && "object has no side table");
+    table = found->second;
+    shard.Tables.erase(found);
+    object->weakRefCount.clearHasSideTable();
+  });
+  bool hasWeakReferences = table->hasWeakReferences();
+  table->clearObject();
+  return hasWeakReferences;
 }
 
-void swift::swift_weakAssign(WeakReference *ref, HeapObject *newValue) {
-  SWIFT_RT_ENTRY_CALL(swift_unownedRetain)(newValue);
-  auto oldValue = (HeapObject*) (ref->Value & ~WR_NATIVE);
-  ref->Value = (uintptr_t)newValue | WR_NATIVE;
-  SWIFT_RT_ENTRY_CALL(swift_unownedRelease)(oldValue);
+static WeakSideTable *getSideTable(uintptr_t value) {
+  return (WeakSideTable *)(value & ~WR_NATIVE);
 }
 
-HeapObject *swift::swift_weakLoadStrong(WeakReference *ref) {
-  if (ref->Value == (uintptr_t)nullptr) {
-    return nullptr;
-  }
+static uintptr_t makeWeakReferenceValue(HeapObject *value) {
+  if (!value)
+    return WR_NATIVE;
+  return (uintptr_t)formWeakReference(value) | WR_NATIVE;
+}
 
+/// Sets the WR_READING bit of \p ref, waiting for any other reader to
+/// finish first, and returns the previous value of the reference.
+static uintptr_t beginReadingWeakReference(WeakReference *ref) {
   // ref might be visible to other threads
   auto ptr = __atomic_fetch_or(&ref->Value, WR_READING, __ATOMIC_RELAXED);
   while (ptr & WR_READING) {
@@ -738,35 +895,62 @@ HeapObject *swift::swift_weakLoadStrong(WeakReference *ref) {
     }
     ptr = __atomic_fetch_or(&ref->Value, WR_READING, __ATOMIC_RELAXED);
   }
+  return ptr;
+}
+
+bool swift::isNativeSwiftWeakReference(WeakReference *ref) {
+  return (ref->Value & WR_NATIVEMASK) == WR_NATIVE;
+}
 
-  auto object = (HeapObject*)(ptr & ~WR_NATIVE);
-  if (object == nullptr) {
+void swift::swift_weakInit(WeakReference *ref, HeapObject *value) {
+  ref->Value = makeWeakReferenceValue(value);
+}
+
+void swift::swift_weakAssign(WeakReference *ref, HeapObject *newValue) {
+  auto newRef = makeWeakReferenceValue(newValue);
+  auto oldTable = getSideTable(ref->Value);
+  ref->Value = newRef;
+  if (oldTable)
+    oldTable->release();
+}
+
+HeapObject *swift::swift_weakLoadStrong(WeakReference *ref) {
+  if (ref->Value == (uintptr_t)nullptr) {
+    return nullptr;
+  }
+
+  auto ptr = beginReadingWeakReference(ref);
+  auto table = getSideTable(ptr);
+  if (table == nullptr) {
     __atomic_store_n(&ref->Value, (uintptr_t)nullptr, __ATOMIC_RELAXED);
     return nullptr;
   }
-  if (object->refCount.isDeallocating()) {
+  auto result = table->tryRetainObject();
+  if (!result) {
+    // The object is gone; drop the reference to its side table so that the
+    // side table can be freed.
     __atomic_store_n(&ref->Value, (uintptr_t)nullptr, __ATOMIC_RELAXED);
-    SWIFT_RT_ENTRY_CALL(swift_unownedRelease)(object);
+    table->release();
     return nullptr;
   }
-  auto result = swift_tryRetain(object);
   __atomic_store_n(&ref->Value, ptr, __ATOMIC_RELAXED);
   return result;
 }
 
 HeapObject *swift::swift_weakTakeStrong(WeakReference *ref) {
-  auto object = (HeapObject*) (ref->Value & ~WR_NATIVE);
-  if (object == nullptr) return nullptr;
-  auto result = swift_tryRetain(object);
+  auto table = getSideTable(ref->Value);
+  if (table == nullptr) return nullptr;
+  auto result = table->tryRetainObject();
   ref->Value = (uintptr_t)nullptr;
-  swift_unownedRelease(object);
+  table->release();
   return result;
 }
 
 void swift::swift_weakDestroy(WeakReference *ref) {
-  auto tmp = (HeapObject*) (ref->Value & ~WR_NATIVE);
+  auto table = getSideTable(ref->Value);
   ref->Value = (uintptr_t)nullptr;
-  SWIFT_RT_ENTRY_CALL(swift_unownedRelease)(tmp);
+  if (table)
+    table->release();
 }
 
 void swift::swift_weakCopyInit(WeakReference *dest, WeakReference *src) {
@@ -775,60 +959,44 @@ void swift::swift_weakCopyInit(WeakReference *dest, WeakReference *src) {
     return;
   }
 
-  // src might be visible to other threads
-  auto ptr = __atomic_fetch_or(&src->Value, WR_READING, __ATOMIC_RELAXED);
-  while (ptr & WR_READING) {
-    short c = 0;
-    while (__atomic_load_n(&src->Value, __ATOMIC_RELAXED) & WR_READING) {
-      if (++c == WR_SPINLIMIT) {
-        std::this_thread::yield();
-        c -= 1;
-      }
-    }
-    ptr = __atomic_fetch_or(&src->Value, WR_READING, __ATOMIC_RELAXED);
-  }
-
-  auto object = (HeapObject*)(ptr & ~WR_NATIVE);
-  if (object == nullptr) {
+  auto ptr = beginReadingWeakReference(src);
+  auto table = getSideTable(ptr);
+  if (table == nullptr) {
     __atomic_store_n(&src->Value, (uintptr_t)nullptr, __ATOMIC_RELAXED);
     dest->Value = (uintptr_t)nullptr;
-  } else if (object->refCount.isDeallocating()) {
+  } else if (table->isObjectDead()) {
     __atomic_store_n(&src->Value, (uintptr_t)nullptr, __ATOMIC_RELAXED);
-    SWIFT_RT_ENTRY_CALL(swift_unownedRelease)(object);
+    table->release();
     dest->Value = (uintptr_t)nullptr;
   } else {
-    SWIFT_RT_ENTRY_CALL(swift_unownedRetain)(object);
+    table->retain();
     __atomic_store_n(&src->Value, ptr, __ATOMIC_RELAXED);
-    dest->Value = (uintptr_t)object | WR_NATIVE;
+    dest->Value = (uintptr_t)table | WR_NATIVE;
   }
 }
 
 void swift::swift_weakTakeInit(WeakReference *dest, WeakReference *src) {
-  auto object = (HeapObject*) (src->Value & ~WR_NATIVE);
-  if (object == nullptr) {
+  auto table = getSideTable(src->Value);
+  if (table == nullptr) {
     dest->Value = (uintptr_t)nullptr;
-  } else if (object->refCount.isDeallocating()) {
+  } else if (table->isObjectDead()) {
     dest->Value = (uintptr_t)nullptr;
-    SWIFT_RT_ENTRY_CALL(swift_unownedRelease)(object);
+    table->release();
   } else {
-    dest->Value = (uintptr_t)object | WR_NATIVE;
+    dest->Value = (uintptr_t)table | WR_NATIVE;
   }
   src->Value = (uintptr_t)nullptr;
 }
 
 void swift::swift_weakCopyAssign(WeakReference *dest, WeakReference *src) {
-  if (dest->Value) {
-    auto object = (HeapObject*) (dest->Value & ~WR_NATIVE);
-    SWIFT_RT_ENTRY_CALL(swift_unownedRelease)(object);
-  }
+  if (auto table = getSideTable(dest->Value))
+    table->release();
   swift_weakCopyInit(dest, src);
 }
 
 void swift::swift_weakTakeAssign(WeakReference *dest, WeakReference *src) {
-  if (dest->Value) {
-    auto object = (HeapObject*) (dest->Value & ~WR_NATIVE);
-    SWIFT_RT_ENTRY_CALL(swift_unownedRelease)(object);
-  }
+  if (auto table = getSideTable(dest->Value))
+    table->release();
   swift_weakTakeInit(dest, src);
 }
 
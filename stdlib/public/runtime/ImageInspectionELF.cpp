@@ -19,10 +19,12 @@
 #if defined(__ELF__) || defined(__ANDROID__)
 
 #include "ImageInspection.h"
+#include "swift/Basic/Lazy.h"
 #include <elf.h>
 #include <link.h>
 #include <dlfcn.h>
 #include <string.h>
+#include <vector>
 
 using namespace swift;
 
@@ -35,17 +37,57 @@ static const char ProtocolConformancesSymbol[] =
 static const char TypeMetadataRecordsSymbol[] =
   ".swift2_type_metadata_start";
 
-/// Context arguments passed down from dl_iterate_phdr to its callback.
-struct InspectArgs {
-  /// Symbol name to look up.
-  const char *symbolName;
-  /// Callback function to invoke with the metadata block.
-  void (*addBlock)(const void *start, uintptr_t size);
+namespace {
+/// A table of records in a loaded image.
+struct SectionInfo {
+  const void *start = nullptr;
+  uintptr_t size = 0;
 };
 
-static int iteratePHDRCallback(struct dl_phdr_info *info,
-                               size_t size, void *data) {
-  const InspectArgs *inspectArgs = reinterpret_cast<const InspectArgs *>(data);
+/// The tables of the images that were loaded when they were first needed.
+///
+/// The conformance and type metadata lookups are usually both initialized
+/// early, so find the tables for both while visiting each image once.
+/// Opening an image and searching its symbols costs more than the lookups
+/// need afterwards.
+struct LoadedImageSections {
+  std::vector<SectionInfo> ProtocolConformances;
+  std::vector<SectionInfo> TypeMetadataRecords;
+
+  LoadedImageSections() {
+    // Search the loaded dls. This only searches the already
+    // loaded ones.
+    // FIXME: Find a way to have this continue to happen for dlopen-ed images.
+    // rdar://problem/19045112
+    dl_iterate_phdr(iteratePHDRCallback, this);
+  }
+
+  static int iteratePHDRCallback(struct dl_phdr_info *info,
+                                 size_t size, void *data);
+};
+} // end anonymous namespace
+
+/// Returns the table whose beginning is identified by \p symbolName in the
+/// image with the given \p handle, if there is one.
+static SectionInfo findSection(void *handle, const char *symbolName) {
+  const char *records =
+    reinterpret_cast<const char*>(dlsym(handle, symbolName));
+  if (!records)
+    return SectionInfo();
+
+  // Extract the size of the records block from the head of the section.
+  uint64_t recordsSize;
+  memcpy(&recordsSize, records, sizeof(recordsSize));
+
+  SectionInfo section;
+  section.start = records + sizeof(recordsSize);
+  section.size = recordsSize;
+  return section;
+}
+
+int LoadedImageSections::iteratePHDRCallback(struct dl_phdr_info *info,
+                                             size_t size, void *data) {
+  auto sections = reinterpret_cast<LoadedImageSections *>(data);
   void *handle;
   if (!info->dlpi_name || info->dlpi_name[0] == '\0') {
     handle = dlopen(nullptr, RTLD_LAZY);
@@ -58,44 +100,27 @@ static int iteratePHDRCallback(struct dl_phdr_info *info,
     return 0;
   }
 
-  const char *conformances =
-    reinterpret_cast<const char*>(dlsym(handle, inspectArgs->symbolName));
-
-  if (!conformances) {
-    // if there are no conformances, don't hold this handle open.
-    dlclose(handle);
-    return 0;
-  }
-
-  // Extract the size of the conformances block from the head of the section.
-  uint64_t conformancesSize;
-  memcpy(&conformancesSize, conformances, sizeof(conformancesSize));
-  conformances += sizeof(conformancesSize);
-
-  inspectArgs->addBlock(conformances, conformancesSize);
+  SectionInfo conformances = findSection(handle, ProtocolConformancesSymbol);
+  if (conformances.start)
+    sections->ProtocolConformances.push_back(conformances);
+  SectionInfo typeMetadata = findSection(handle, TypeMetadataRecordsSymbol);
+  if (typeMetadata.start)
+    sections->TypeMetadataRecords.push_back(typeMetadata);
 
   dlclose(handle);
   return 0;
 }
 
+static Lazy<LoadedImageSections> ImageSections;
+
 void swift::initializeProtocolConformanceLookup() {
-  // Search the loaded dls. This only searches the already
-  // loaded ones.
-  // FIXME: Find a way to have this continue to happen for dlopen-ed images.
-  // rdar://problem/19045112
-  InspectArgs ProtocolConformanceArgs = {
-    ProtocolConformancesSymbol,
-    addImageProtocolConformanceBlockCallback
-  };
-  dl_iterate_phdr(iteratePHDRCallback, &ProtocolConformanceArgs);
+  for (auto &section : ImageSections->ProtocolConformances)
+    addImageProtocolConformanceBlockCallback(section.start, section.size);
 }
 
 void swift::initializeTypeMetadataRecordLookup() {
-  InspectArgs TypeMetadataRecordArgs = {
-    TypeMetadataRecordsSymbol,
-    addImageTypeMetadataRecordBlockCallback
-  };
-  dl_iterate_phdr(iteratePHDRCallback, &TypeMetadataRecordArgs);
+  for (auto &section : ImageSections->TypeMetadataRecords)
+    addImageTypeMetadataRecordBlockCallback(section.start, section.size);
 }
 
 int swift::lookupSymbol(const void *address, SymbolInfo *info) {
@@ -143,6 +143,70 @@ const ExtraInhabitantsValueWitnessTable
 const ValueWitnessTable swift::VALUE_WITNESS_SYM(EMPTY_TUPLE_MANGLING) =
   ValueWitnessTableForBox<AggregateBox<>>::table;
 
+/*** Common layouts **********************************************************/
+
+// Value witnesses for layouts that instantiated generic value types often
+// have. installCommonValueWitnesses and the struct layout functions install
+// them in place of the compiler's generic witnesses, which have to go
+// through the witnesses of every field.
+
+namespace {
+  struct two_words_like {
+    uintptr_t data[2];
+  };
+
+  using NativeReferencePairBox =
+    AggregateBox<SwiftRetainableBox, SwiftRetainableBox>;
+  using NativeReferenceTripleBox =
+    AggregateBox<SwiftRetainableBox, SwiftRetainableBox, SwiftRetainableBox>;
+}
+
+const ValueWitnessTable swift::TwoWordPODValueWitnesses =
+  ValueWitnessTableForBox<NativeBox<two_words_like>>::table;
+
+static const ValueWitnessTable NativeReferencePairValueWitnesses =
+  ValueWitnessTableForBox<NativeReferencePairBox>::table;
+
+static const ValueWitnessTable NativeReferenceTripleValueWitnesses =
+  ValueWitnessTableForBox<NativeReferenceTripleBox>::table;
+
+const ValueWitnessTable *
+swift::getCommonValueWitnessesForFields(size_t numFields,
+                                        const TypeLayout * const *fieldTypes) {
+  // A value that is a single field is laid out like it, so it can use the
+  // field's witnesses if we know them.
+  if (numFields == 1) {
+    const ValueWitnessTable *knownVWTs[] = {
+      &VALUE_WITNESS_SYM(Bo),
+      &VALUE_WITNESS_SYM(Bb),
+#if SWIFT_OBJC_INTEROP
+      &VALUE_WITNESS_SYM(BO),
+#endif
+      &VALUE_WITNESS_SYM(FUNCTION_MANGLING),
+    };
+    for (auto knownVWT : knownVWTs) {
+      if (fieldTypes[0] == knownVWT->getTypeLayout())
+        return knownVWT;
+    }
+    return nullptr;
+  }
+
+  // Otherwise, look for a short run of native references, which fits in a
+  // value buffer.
+  for (size_t i = 0; i != numFields; ++i) {
+    if (fieldTypes[i] != VALUE_WITNESS_SYM(Bo).getTypeLayout())
+      return nullptr;
+  }
+  switch (numFields) {
+  case 2:
+    return &NativeReferencePairValueWitnesses;
+  case 3:
+    return &NativeReferenceTripleValueWitnesses;
+  default:
+    return nullptr;
+  }
+}
+
 /*** Known metadata **********************************************************/
 
 // Define some builtin opaque metadata.
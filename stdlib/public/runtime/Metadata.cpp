@@ -34,6 +34,7 @@
 #define NOMINMAX
 #include <windows.h>
 #else
+#include <pthread.h>
 #include <sys/mman.h>
 #include <unistd.h>
 #endif
@@ -43,6 +44,7 @@
 #include "ExistentialMetadataImpl.h"
 #include "swift/Runtime/Debug.h"
 #include "Private.h"
+#include "Profiler.h"
 
 #if defined(__APPLE__)
 #include <mach/vm_page_size.h>
@@ -103,6 +105,24 @@ namespace {
   };
 }
 
+namespace {
+  /// The pool of queues that threads wait on for metadata cache entries.
+  struct MetadataCacheWaitQueues {
+    static const unsigned NumQueues = 64;
+    MetadataCacheWaitQueue Queues[NumQueues];
+  };
+}
+
+static Lazy<MetadataCacheWaitQueues> WaitQueues;
+
+MetadataCacheWaitQueue &swift::getMetadataCacheWaitQueue(const void *entry) {
+  // Entries are heap-allocated, so the low bits carry little information.
+  auto bits = reinterpret_cast<uintptr_t>(entry);
+  auto index =
+    ((bits >> 4) ^ (bits >> 12)) % MetadataCacheWaitQueues::NumQueues;
+  return WaitQueues.get().Queues[index];
+}
+
 using GenericMetadataCache = MetadataCache<GenericCacheEntry>;
 using LazyGenericMetadataCache = Lazy<GenericMetadataCache>;
 
@@ -225,6 +245,17 @@ swift::swift_allocateGenericValueMetadata(GenericMetadata *pattern,
 }
 
 /// The primary entrypoint.
+///
+/// FIXME: Every instantiation is created here on first use, even when the
+/// compiler could see the complete set of arguments (Array<String>,
+/// Optional<Int>, ...) and could have emitted the metadata statically.
+/// Doing so needs IRGen to lay out full value and class metadata for
+/// bound generic types (including field offsets, value witnesses and, for
+/// classes, the Objective-C class structures) in a form that the runtime can
+/// register into the pattern's cache before the first lookup, and it needs
+/// a way to unique such records across images. Until then, the per-use-site
+/// lazy cache variables that IRGen emits in type metadata accessors are what
+/// keeps repeated lookups off this path.
 SWIFT_RT_ENTRY_VISIBILITY
 const Metadata *
 swift::swift_getGenericMetadata(GenericMetadata *pattern,
@@ -233,15 +264,20 @@ swift::swift_getGenericMetadata(GenericMetadata *pattern,
   auto genericArgs = (const void * const *) arguments;
   size_t numGenericArgs = pattern->NumKeyArguments;
 
+  bool instantiated = false;
   auto entry = getCache(pattern).findOrAdd(genericArgs, numGenericArgs,
     [&]() -> GenericCacheEntry* {
       // Create new metadata to cache.
       auto metadata = pattern->CreateFunction(pattern, arguments);
       auto entry = GenericCacheEntry::getFromMetadata(pattern, metadata);
       entry->Value = metadata;
+      instantiated = true;
       return entry;
     });
 
+  if (profiler::isEnabled())
+    profiler::recordGenericMetadata(entry->Value, instantiated);
+
   return entry->Value;
 }
 
@@ -1309,6 +1345,9 @@ void swift::installCommonValueWitnesses(ValueWitnessTable *vwtable) {
     case sizeWithAlignmentMask(32, 31):
       commonVWT = &VALUE_WITNESS_SYM(Bi256_);
       break;
+    case sizeWithAlignmentMask(2 * sizeof(void*), alignof(void*) - 1):
+      commonVWT = &TwoWordPODValueWitnesses;
+      break;
     }
     
   #define INSTALL_POD_COMMON_WITNESS(NAME) vwtable->NAME = commonVWT->NAME;
@@ -1370,7 +1409,14 @@ void swift::swift_initStructMetadata_UniversalStrategy(size_t numFields,
   vwtable->stride = layout.stride;
   
   // Substitute in better value witnesses if we have them.
-  installCommonValueWitnesses(vwtable);
+  if (auto commonVWT = getCommonValueWitnessesForFields(numFields,
+                                                        fieldTypes)) {
+#define INSTALL_COMMON_WITNESS(NAME) vwtable->NAME = commonVWT->NAME;
+    FOR_ALL_FUNCTION_VALUE_WITNESSES(INSTALL_COMMON_WITNESS)
+#undef INSTALL_COMMON_WITNESS
+  } else {
+    installCommonValueWitnesses(vwtable);
+  }
 
   // We have extra inhabitants if the first element does.
   // FIXME: generalize this.
@@ -1447,14 +1493,13 @@ static inline ClassROData *getROData(ClassMetadata *theClass) {
 
 static void _swift_initGenericClassObjCName(ClassMetadata *theClass) {
   // Use the remangler to generate a mangled name from the type metadata.
-  auto demangling = _swift_buildDemanglingForMetadata(theClass);
+  Demangle::NodeFactory Factory;
+  auto demangling = _swift_buildDemanglingForMetadata(theClass, Factory);
 
   // Remangle that into a new type mangling string.
-  auto typeNode
-    = Demangle::NodeFactory::create(Demangle::Node::Kind::TypeMangling);
+  auto typeNode = Factory.create(Demangle::Node::Kind::TypeMangling);
   typeNode->addChild(demangling);
-  auto globalNode
-    = Demangle::NodeFactory::create(Demangle::Node::Kind::Global);
+  auto globalNode = Factory.create(Demangle::Node::Kind::Global);
   globalNode->addChild(typeNode);
   
   auto string = Demangle::mangleNode(globalNode);
@@ -2669,11 +2714,11 @@ using LazyGenericWitnessTableCache = Lazy<GenericWitnessTableCache>;
 static GenericWitnessTableCache &getCache(GenericWitnessTable *gen) {
   // Keep this assert even if you change the representation above.
   static_assert(sizeof(LazyGenericWitnessTableCache) <=
-                sizeof(GenericWitnessTable::PrivateData),
+                sizeof(void *) * swift::NumGenericMetadataPrivateDataWords,
                 "metadata cache is larger than the allowed space");
 
   auto lazyCache =
-    reinterpret_cast<LazyGenericWitnessTableCache*>(gen->PrivateData);
+    reinterpret_cast<LazyGenericWitnessTableCache*>(gen->PrivateData.get());
   return lazyCache->get();
 }
 
@@ -2796,4 +2841,50 @@ swift::swift_getGenericWitnessTable(GenericWitnessTable *genericTable,
   return entry->get(genericTable);
 }
 
+/***************************************************************************/
+/*** Metadata warming ******************************************************/
+/***************************************************************************/
+
+namespace {
+  struct MetadataToWarm {
+    const Metadata *(* const *Accessors)();
+    size_t Count;
+  };
+} // end anonymous namespace
+
+static void warmMetadata(MetadataToWarm *toWarm) {
+  for (size_t i = 0; i != toWarm->Count; ++i)
+    (void) toWarm->Accessors[i]();
+  delete toWarm;
+}
+
+void swift::swift_warmMetadata(const Metadata *(* const *accessors)(),
+                               size_t count) {
+  // The accessors are constant data in the image, but the thread may start
+  // after we return, so pass them on the heap. If no thread can be started,
+  // the metadata is just instantiated on first use as usual.
+  auto toWarm = new MetadataToWarm{accessors, count};
+#if defined(_MSC_VER)
+  HANDLE thread = CreateThread(nullptr, 0, [](LPVOID context) -> DWORD {
+    warmMetadata(static_cast<MetadataToWarm *>(context));
+    return 0;
+  }, toWarm, 0, nullptr);
+  if (!thread) {
+    delete toWarm;
+    return;
+  }
+  CloseHandle(thread);
+#else
+  pthread_t thread;
+  if (pthread_create(&thread, nullptr, [](void *context) -> void * {
+        warmMetadata(static_cast<MetadataToWarm *>(context));
+        return nullptr;
+      }, toWarm) != 0) {
+    delete toWarm;
+    return;
+  }
+  pthread_detach(thread);
+#endif
+}
+
 uint64_t swift::RelativeDirectPointerNullPtr = 0;
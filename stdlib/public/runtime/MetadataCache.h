@@ -110,6 +110,20 @@ public:
   unsigned size() const { return Length; }
 };
 
+/// The lock and condition variable that threads block on while another thread
+/// initializes a metadata cache entry they need.
+struct MetadataCacheWaitQueue {
+  Mutex Lock;
+  ConditionVariable Queue;
+};
+
+/// Return the wait queue for the metadata cache entry at \p entry.
+///
+/// Entries are spread over a fixed pool of queues shared by every cache, so
+/// finishing one entry only wakes up the threads waiting on entries that
+/// happen to share its queue, rather than every waiter in the cache.
+MetadataCacheWaitQueue &getMetadataCacheWaitQueue(const void *entry);
+
 template <class Impl>
 struct CacheEntryHeader {};
 
@@ -253,14 +267,8 @@ template <class ValueTy> class MetadataCache {
   /// The concurrent map.
   ConcurrentMap<Entry, /*Destructor*/ false, MetadataAllocator> Map;
 
-  struct ConcurrencyControl {
-    Mutex Lock;
-    ConditionVariable Queue;
-  };
-  std::unique_ptr<ConcurrencyControl> Concurrency;
-
 public:
-  MetadataCache() : Concurrency(new ConcurrencyControl()) {}
+  MetadataCache() = default;
   ~MetadataCache() = default;
 
   /// Caches are not copyable.
@@ -306,11 +314,11 @@ public:
         return value;
       }
 
-      // Otherwise, we have to grab the lock and wait for the value to
-      // appear there.  Note that we have to check again immediately
+      // Otherwise, we have to grab the entry's wait queue and wait for the
+      // value to appear there.  Note that we have to check again immediately
       // after acquiring the lock to prevent a race.
-      auto concurrency = Concurrency.get();
-      concurrency->Lock.withLockOrWait(concurrency->Queue, [&, this] {
+      auto &waitQueue = getMetadataCacheWaitQueue(entry);
+      waitQueue.Lock.withLockOrWait(waitQueue.Queue, [&, this] {
         if ((value = entry->getValue())) {
           return true; // found a value, done waiting
         }
@@ -340,10 +348,10 @@ public:
                ValueTy::getName(), (void*) this, value);
 #endif
 
-    // Acquire the lock, set the value, and notify any waiters.
-    auto concurrency = Concurrency.get();
-    concurrency->Lock.withLockThenNotifyAll(
-        concurrency->Queue, [&entry, &value] { entry->setValue(value); });
+    // Acquire the entry's wait queue, set the value, and notify any waiters.
+    auto &waitQueue = getMetadataCacheWaitQueue(entry);
+    waitQueue.Lock.withLockThenNotifyAll(
+        waitQueue.Queue, [&entry, &value] { entry->setValue(value); });
 
     return value;
   }
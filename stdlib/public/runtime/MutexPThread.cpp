@@ -86,7 +86,11 @@ void ConditionPlatformHelper::wait(pthread_cond_t &condition,
 
 void MutexPlatformHelper::init(pthread_mutex_t &mutex, bool checked) {
   pthread_mutexattr_t attr;
+#if SWIFT_MUTEX_IS_ADAPTIVE
+  int kind = (checked ? PTHREAD_MUTEX_ERRORCHECK : PTHREAD_MUTEX_ADAPTIVE_NP);
+#else
   int kind = (checked ? PTHREAD_MUTEX_ERRORCHECK : PTHREAD_MUTEX_NORMAL);
+#endif
   reportError(pthread_mutexattr_init(&attr));
   reportError(pthread_mutexattr_settype(&attr, kind));
   reportError(pthread_mutex_init(&mutex, &attr));
@@ -148,6 +148,16 @@ namespace swift {
   /// Returns true if common value witnesses were used, false otherwise.
   void installCommonValueWitnesses(ValueWitnessTable *vwtable);
 
+  /// Value witnesses for two pointer-sized words of POD, such as a pair of
+  /// Ints.
+  extern const ValueWitnessTable TwoWordPODValueWitnesses;
+
+  /// Returns value witnesses for a value type with the given fields, if they
+  /// have a layout with witnesses of its own, like a single class reference.
+  const ValueWitnessTable *
+  getCommonValueWitnessesForFields(size_t numFields,
+                                   const TypeLayout * const *fieldTypes);
+
   const Metadata *
   _matchMetadataByMangledTypeName(const llvm::StringRef metadataNameRef,
                                   const Metadata *metadata,
@@ -156,7 +166,14 @@ namespace swift {
   const Metadata *
   _searchConformancesByMangledTypeName(const llvm::StringRef typeName);
 
-  Demangle::NodePointer _swift_buildDemanglingForMetadata(const Metadata *type);
+  /// Returns a number that changes whenever new protocol conformance records
+  /// are registered, i.e. whenever a negative result of
+  /// swift_conformsToProtocol may have become stale.
+  uintptr_t _swift_getProtocolConformanceGeneration();
+
+  Demangle::NodePointer
+  _swift_buildDemanglingForMetadata(const Metadata *type,
+                                    Demangle::NodeFactory &Factory);
 
   /// A helper function which avoids performing a store if the destination
   /// address already contains the source value.  This is useful when
@@ -0,0 +1,578 @@
+//===--- Profiler.cpp - Opt-in runtime profiling --------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Implementation of the SWIFT_RUNTIME_PROFILE counters; see Profiler.h.
+//
+//===----------------------------------------------------------------------===//
+
+#if defined(__CYGWIN__) || defined(__ANDROID__) || defined(_MSC_VER)
+#  define SWIFT_PROFILER_SUPPORTS_BACKTRACES 0
+#  define SWIFT_PROFILER_SUPPORTS_SIGNALS 0
+#else
+#  define SWIFT_PROFILER_SUPPORTS_BACKTRACES 1
+#  define SWIFT_PROFILER_SUPPORTS_SIGNALS 1
+#endif
+
+#include "Profiler.h"
+#include "ImageInspection.h"
+#include "swift/Basic/Lazy.h"
+#include "swift/Runtime/HeapObject.h"
+#include "swift/Runtime/Mutex.h"
+#include "llvm/ADT/DenseMap.h"
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#if SWIFT_PROFILER_SUPPORTS_BACKTRACES
+#include <execinfo.h>
+#endif
+
+#if SWIFT_PROFILER_SUPPORTS_SIGNALS
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace swift;
+using namespace swift::profiler;
+
+std::atomic<ProfilerState> swift::profiler::CurrentState{ProfilerState::Unknown};
+
+namespace {
+
+/// The number of frames kept for a sampled allocation backtrace.
+constexpr unsigned MaxSampledFrames = 16;
+
+/// The number of distinct backtraces kept per type.
+constexpr unsigned MaxSampledStacksPerType = 8;
+
+/// The number of entries printed per report section.
+constexpr unsigned MaxReportEntries = 50;
+
+struct StackSample {
+  void *Frames[MaxSampledFrames];
+  unsigned NumFrames;
+  uint64_t Count;
+};
+
+struct AllocationCounters {
+  uint64_t Count = 0;
+  uint64_t Bytes = 0;
+  std::vector<StackSample> Stacks;
+};
+
+struct MetadataCounters {
+  uint64_t Lookups = 0;
+  uint64_t Instantiations = 0;
+};
+
+struct PairCounters {
+  uint64_t Count = 0;
+  uint64_t Failures = 0;
+  uint64_t Scans = 0;
+};
+
+using TypePair = std::pair<const void *, const void *>;
+
+struct ProfileData {
+  Mutex Lock;
+  std::string ReportPath;
+  uint64_t SampleInterval = 1000;
+  uint64_t AllocationsUntilSample = 1;
+
+  llvm::DenseMap<const HeapMetadata *, AllocationCounters> Allocations;
+  llvm::DenseMap<const Metadata *, MetadataCounters> GenericMetadata;
+  llvm::DenseMap<TypePair, PairCounters> ConformanceLookups;
+  llvm::DenseMap<TypePair, PairCounters> DynamicCasts;
+};
+
+Lazy<ProfileData> Profile;
+
+/// Set while the profiler itself is running on this thread, so that anything
+/// the profiler calls into isn't recorded.
+LLVM_THREAD_LOCAL bool InProfiler = false;
+
+class ProfilerScope {
+  bool WasInProfiler;
+public:
+  ProfilerScope() : WasInProfiler(InProfiler) { InProfiler = true; }
+  ~ProfilerScope() { InProfiler = WasInProfiler; }
+  bool isNested() const { return WasInProfiler; }
+};
+
+std::string getTypeName(const void *type) {
+  return nameForMetadata(static_cast<const Metadata *>(type));
+}
+
+std::string getProtocolName(const void *protocol) {
+  auto name = static_cast<const ProtocolDescriptor *>(protocol)->Name;
+  return name ? name : "<unnamed protocol>";
+}
+
+template <typename Map, typename Count>
+std::vector<typename Map::const_iterator>
+getTopEntries(const Map &map, Count getCount) {
+  std::vector<typename Map::const_iterator> entries;
+  for (auto i = map.begin(), e = map.end(); i != e; ++i)
+    entries.push_back(i);
+  std::sort(entries.begin(), entries.end(),
+            [&](typename Map::const_iterator a, typename Map::const_iterator b) {
+    return getCount(a->second) > getCount(b->second);
+  });
+  if (entries.size() > MaxReportEntries)
+    entries.resize(MaxReportEntries);
+  return entries;
+}
+
+void printStack(FILE *out, const StackSample &stack) {
+  for (unsigned i = 0; i != stack.NumFrames; ++i) {
+    SymbolInfo info;
+    if (lookupSymbol(stack.Frames[i], &info) && info.symbolName) {
+      fprintf(out, "        #%u %p %s + %zu (%s)\n", i, stack.Frames[i],
+              info.symbolName,
+              (size_t)((const char *)stack.Frames[i] -
+                       (const char *)info.symbolAddress),
+              info.fileName ? info.fileName : "?");
+    } else {
+      fprintf(out, "        #%u %p\n", i, stack.Frames[i]);
+    }
+  }
+}
+
+void writeReport(ProfileData &data, FILE *out) {
+  fprintf(out, "Swift runtime profile\n");
+
+  uint64_t totalCount = 0, totalBytes = 0;
+  for (auto &entry : data.Allocations) {
+    totalCount += entry.second.Count;
+    totalBytes += entry.second.Bytes;
+  }
+  fprintf(out, "\n== Object allocations: %llu objects, %llu bytes ==\n",
+          (unsigned long long)totalCount, (unsigned long long)totalBytes);
+  fprintf(out, "%12s %14s  %s\n", "count", "bytes", "type");
+  for (auto entry : getTopEntries(data.Allocations,
+                      [](const AllocationCounters &c) { return c.Bytes; })) {
+    auto &counters = entry->second;
+    fprintf(out, "%12llu %14llu  %s\n", (unsigned long long)counters.Count,
+            (unsigned long long)counters.Bytes,
+            getTypeName(entry->first).c_str());
+    auto stacks = counters.Stacks;
+    std::sort(stacks.begin(), stacks.end(),
+              [](const StackSample &a, const StackSample &b) {
+      return a.Count > b.Count;
+    });
+    for (auto &stack : stacks) {
+      fprintf(out, "    sampled %llu times:\n",
+              (unsigned long long)stack.Count);
+      printStack(out, stack);
+    }
+  }
+
+  fprintf(out, "\n== Generic metadata: %u records ==\n",
+          (unsigned)data.GenericMetadata.size());
+  fprintf(out, "%12s %14s  %s\n", "lookups", "instantiated", "type");
+  for (auto entry : getTopEntries(data.GenericMetadata,
+                      [](const MetadataCounters &c) { return c.Lookups; })) {
+    fprintf(out, "%12llu %14llu  %s\n",
+            (unsigned long long)entry->second.Lookups,
+            (unsigned long long)entry->second.Instantiations,
+            getTypeName(entry->first).c_str());
+  }
+
+  fprintf(out, "\n== Protocol conformance lookups ==\n");
+  fprintf(out, "%12s %10s %10s  %s\n", "lookups", "failures", "scans",
+          "type: protocol");
+  for (auto entry : getTopEntries(data.ConformanceLookups,
+                      [](const PairCounters &c) { return c.Count; })) {
+    fprintf(out, "%12llu %10llu %10llu  %s: %s\n",
+            (unsigned long long)entry->second.Count,
+            (unsigned long long)entry->second.Failures,
+            (unsigned long long)entry->second.Scans,
+            getTypeName(entry->first.first).c_str(),
+            getProtocolName(entry->first.second).c_str());
+  }
+
+  fprintf(out, "\n== Dynamic casts ==\n");
+  fprintf(out, "%12s %10s  %s\n", "casts", "failures", "source -> target");
+  for (auto entry : getTopEntries(data.DynamicCasts,
+                      [](const PairCounters &c) { return c.Count; })) {
+    fprintf(out, "%12llu %10llu  %s -> %s\n",
+            (unsigned long long)entry->second.Count,
+            (unsigned long long)entry->second.Failures,
+            getTypeName(entry->first.first).c_str(),
+            getTypeName(entry->first.second).c_str());
+  }
+}
+
+void writeReport() {
+  ProfilerScope scope;
+  auto &data = Profile.get();
+  ScopedLock guard(data.Lock);
+
+  FILE *out = fopen(data.ReportPath.c_str(), "w");
+  if (!out) {
+    fprintf(stderr, "swift runtime: could not open profile report '%s'\n",
+            data.ReportPath.c_str());
+    return;
+  }
+  writeReport(data, out);
+  fclose(out);
+}
+
+#if SWIFT_PROFILER_SUPPORTS_SIGNALS
+int ReportSignalPipe[2] = {-1, -1};
+
+void handleReportSignal(int) {
+  char byte = 0;
+  (void)write(ReportSignalPipe[1], &byte, 1);
+}
+
+/// Writing the report isn't async-signal-safe, so the signal handler wakes
+/// up this thread to do it.
+void *reportSignalThread(void *) {
+  char byte;
+  while (read(ReportSignalPipe[0], &byte, 1) >= 0)
+    writeReport();
+  return nullptr;
+}
+
+void installReportSignalHandler() {
+  if (pipe(ReportSignalPipe) != 0)
+    return;
+  pthread_t thread;
+  if (pthread_create(&thread, nullptr, reportSignalThread, nullptr) != 0)
+    return;
+  pthread_detach(thread);
+  signal(SIGUSR2, handleReportSignal);
+}
+#endif
+
+ProfilerState initializeOnce() {
+  const char *path = getenv("SWIFT_RUNTIME_PROFILE");
+  if (!path || !path[0])
+    return ProfilerState::Disabled;
+
+  ProfilerScope scope;
+  auto &data = Profile.get();
+  data.ReportPath = path;
+  if (const char *interval = getenv("SWIFT_RUNTIME_PROFILE_SAMPLE_INTERVAL"))
+    data.SampleInterval = strtoull(interval, nullptr, 10);
+
+  atexit([] { writeReport(); });
+#if SWIFT_PROFILER_SUPPORTS_SIGNALS
+  installReportSignalHandler();
+#endif
+  return ProfilerState::Enabled;
+}
+
+LLVM_ATTRIBUTE_NOINLINE
+void sampleStack(AllocationCounters &counters) {
+#if SWIFT_PROFILER_SUPPORTS_BACKTRACES
+  // Skip this function and recordAllocation.
+  constexpr unsigned SkippedFrames = 2;
+  void *frames[MaxSampledFrames + SkippedFrames];
+  int numFrames = backtrace(frames, MaxSampledFrames + SkippedFrames);
+  if (numFrames <= (int)SkippedFrames)
+    return;
+
+  StackSample sample;
+  sample.NumFrames = numFrames - SkippedFrames;
+  sample.Count = 1;
+  memcpy(sample.Frames, frames + SkippedFrames,
+         sample.NumFrames * sizeof(void *));
+
+  for (auto &stack : counters.Stacks) {
+    if (stack.NumFrames == sample.NumFrames &&
+        memcmp(stack.Frames, sample.Frames,
+               sample.NumFrames * sizeof(void *)) == 0) {
+      ++stack.Count;
+      return;
+    }
+  }
+  if (counters.Stacks.size() < MaxSampledStacksPerType)
+    counters.Stacks.push_back(sample);
+#endif
+}
+
+} // end anonymous namespace
+
+ProfilerState swift::profiler::initialize() {
+  static const ProfilerState state = initializeOnce();
+  CurrentState.store(state, std::memory_order_relaxed);
+  return state;
+}
+
+void swift::profiler::recordAllocation(const HeapMetadata *type, size_t size) {
+  ProfilerScope scope;
+  if (scope.isNested())
+    return;
+  auto &data = Profile.get();
+  ScopedLock guard(data.Lock);
+  auto &counters = data.Allocations[type];
+  ++counters.Count;
+  counters.Bytes += size;
+  if (data.SampleInterval && --data.AllocationsUntilSample == 0) {
+    data.AllocationsUntilSample = data.SampleInterval;
+    sampleStack(counters);
+  }
+}
+
+void swift::profiler::recordGenericMetadata(const Metadata *metadata,
+                                            bool instantiated) {
+  ProfilerScope scope;
+  if (scope.isNested())
+    return;
+  auto &data = Profile.get();
+  ScopedLock guard(data.Lock);
+  auto &counters = data.GenericMetadata[metadata];
+  ++counters.Lookups;
+  if (instantiated)
+    ++counters.Instantiations;
+}
+
+void swift::profiler::recordConformanceLookup(
+    const Metadata *type, const ProtocolDescriptor *protocol, bool succeeded) {
+  ProfilerScope scope;
+  if (scope.isNested())
+    return;
+  auto &data = Profile.get();
+  ScopedLock guard(data.Lock);
+  auto &counters = data.ConformanceLookups[TypePair(type, protocol)];
+  ++counters.Count;
+  if (!succeeded)
+    ++counters.Failures;
+}
+
+void swift::profiler::recordConformanceScan(
+    const Metadata *type, const ProtocolDescriptor *protocol) {
+  ProfilerScope scope;
+  if (scope.isNested())
+    return;
+  auto &data = Profile.get();
+  ScopedLock guard(data.Lock);
+  ++data.ConformanceLookups[TypePair(type, protocol)].Scans;
+}
+
+void swift::profiler::recordDynamicCast(const Metadata *srcType,
+                                        const Metadata *targetType,
+                                        bool succeeded) {
+  ProfilerScope scope;
+  if (scope.isNested())
+    return;
+  auto &data = Profile.get();
+  ScopedLock guard(data.Lock);
+  auto &counters = data.DynamicCasts[TypePair(srcType, targetType)];
+  ++counters.Count;
+  if (!succeeded)
+    ++counters.Failures;
+}
+
+//===----------------------------------------------------------------------===//
+//                                 Counting
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+std::atomic<uint64_t>
+    CallCounts[unsigned(RuntimeCallCount::NumCounts)];
+
+/// The hooks replaced while counting, or null if we are not counting.
+decltype(_swift_allocObject) CountedAllocObject = nullptr;
+decltype(_swift_retain) CountedRetain = nullptr;
+decltype(_swift_retain_n) CountedRetainN = nullptr;
+decltype(_swift_release) CountedRelease = nullptr;
+decltype(_swift_release_n) CountedReleaseN = nullptr;
+
+StaticMutex CountingLock;
+
+void addCount(RuntimeCallCount count, uint64_t n) {
+  CallCounts[unsigned(count)].fetch_add(n, std::memory_order_relaxed);
+}
+
+HeapObject *countingAllocObject(HeapMetadata const *metadata,
+                                size_t requiredSize,
+                                size_t requiredAlignmentMask)
+    SWIFT_CC(RegisterPreservingCC_IMPL) {
+  addCount(RuntimeCallCount::Allocations, 1);
+  addCount(RuntimeCallCount::AllocatedBytes, requiredSize);
+  return CountedAllocObject(metadata, requiredSize, requiredAlignmentMask);
+}
+
+void countingRetain(HeapObject *object) SWIFT_CC(RegisterPreservingCC_IMPL) {
+  addCount(RuntimeCallCount::Retains, 1);
+  CountedRetain(object);
+}
+
+void countingRetainN(HeapObject *object, uint32_t n)
+    SWIFT_CC(RegisterPreservingCC_IMPL) {
+  addCount(RuntimeCallCount::Retains, n);
+  CountedRetainN(object, n);
+}
+
+void countingRelease(HeapObject *object) SWIFT_CC(RegisterPreservingCC_IMPL) {
+  addCount(RuntimeCallCount::Releases, 1);
+  CountedRelease(object);
+}
+
+void countingReleaseN(HeapObject *object, uint32_t n)
+    SWIFT_CC(RegisterPreservingCC_IMPL) {
+  addCount(RuntimeCallCount::Releases, n);
+  CountedReleaseN(object, n);
+}
+
+} // end anonymous namespace
+
+void swift_profiler_startCounting() {
+  StaticScopedLock guard(CountingLock);
+  if (CountedAllocObject)
+    return;
+  for (auto &count : CallCounts)
+    count.store(0, std::memory_order_relaxed);
+  CountedAllocObject = _swift_allocObject;
+  CountedRetain = _swift_retain;
+  CountedRetainN = _swift_retain_n;
+  CountedRelease = _swift_release;
+  CountedReleaseN = _swift_release_n;
+  _swift_allocObject = countingAllocObject;
+  _swift_retain = countingRetain;
+  _swift_retain_n = countingRetainN;
+  _swift_release = countingRelease;
+  _swift_release_n = countingReleaseN;
+}
+
+void swift_profiler_stopCounting(uint64_t *counts) {
+  StaticScopedLock guard(CountingLock);
+  if (CountedAllocObject) {
+    _swift_allocObject = CountedAllocObject;
+    _swift_retain = CountedRetain;
+    _swift_retain_n = CountedRetainN;
+    _swift_release = CountedRelease;
+    _swift_release_n = CountedReleaseN;
+    CountedAllocObject = nullptr;
+  }
+  for (unsigned i = 0; i != unsigned(RuntimeCallCount::NumCounts); ++i)
+    counts[i] = CallCounts[i].load(std::memory_order_relaxed);
+}
+
+//===----------------------------------------------------------------------===//
+//                             Hardware Counters
+//===----------------------------------------------------------------------===//
+
+#if defined(__linux__)
+
+namespace {
+
+/// The perf events opened by swift_profiler_startHardwareCounters, or -1 for
+/// events which the kernel or the CPU does not support.
+int HardwareCounterFDs[unsigned(HardwareCounter::NumCounters)];
+bool CountingHardwareEvents = false;
+
+StaticMutex HardwareCounterLock;
+
+int openPerfEvent(uint32_t type, uint64_t config) {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  // The kernel multiplexes events if there are more than the CPU has
+  // counters for; these let us scale the counts back up.
+  attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return syscall(SYS_perf_event_open, &attr, /*pid*/ 0, /*cpu*/ -1,
+                 /*group_fd*/ -1, /*flags*/ 0);
+}
+
+uint64_t cacheReadMisses(uint64_t cache) {
+  return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+uint64_t readPerfEvent(int fd) {
+  uint64_t values[3];
+  if (read(fd, values, sizeof(values)) != sizeof(values) || values[2] == 0)
+    return 0;
+  if (values[1] == values[2])
+    return values[0];
+  return uint64_t(double(values[0]) * values[1] / values[2]);
+}
+
+} // end anonymous namespace
+
+bool swift_profiler_startHardwareCounters() {
+  StaticScopedLock guard(HardwareCounterLock);
+  if (CountingHardwareEvents)
+    return true;
+
+  const std::pair<uint32_t, uint64_t>
+      events[unsigned(HardwareCounter::NumCounters)] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, cacheReadMisses(PERF_COUNT_HW_CACHE_L1D)},
+    {PERF_TYPE_HW_CACHE, cacheReadMisses(PERF_COUNT_HW_CACHE_LL)},
+  };
+  bool any = false;
+  for (unsigned i = 0; i != unsigned(HardwareCounter::NumCounters); ++i) {
+    HardwareCounterFDs[i] = openPerfEvent(events[i].first, events[i].second);
+    any |= HardwareCounterFDs[i] >= 0;
+  }
+  if (!any)
+    return false;
+
+  CountingHardwareEvents = true;
+  for (int fd : HardwareCounterFDs)
+    if (fd >= 0)
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+  return true;
+}
+
+void swift_profiler_stopHardwareCounters(uint64_t *counts) {
+  StaticScopedLock guard(HardwareCounterLock);
+  for (unsigned i = 0; i != unsigned(HardwareCounter::NumCounters); ++i) {
+    int fd = CountingHardwareEvents ? HardwareCounterFDs[i] : -1;
+    if (fd < 0) {
+      counts[i] = 0;
+      continue;
+    }
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    counts[i] = readPerfEvent(fd);
+    close(fd);
+  }
+  CountingHardwareEvents = false;
+}
+
+#else
+
+bool swift_profiler_startHardwareCounters() {
+  return false;
+}
+
+void swift_profiler_stopHardwareCounters(uint64_t *counts) {
+  for (unsigned i = 0; i != unsigned(HardwareCounter::NumCounters); ++i)
+    counts[i] = 0;
+}
+
+#endif
@@ -0,0 +1,138 @@
+//===--- Profiler.h - Opt-in runtime profiling ------------------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Counters for object allocation, generic metadata instantiation, protocol
+// conformance lookup and dynamic casts, enabled by setting the
+// SWIFT_RUNTIME_PROFILE environment variable to the path of a report file.
+//
+// The report is written when the process exits, and whenever the process
+// receives SIGUSR2. SWIFT_RUNTIME_PROFILE_SAMPLE_INTERVAL sets how many
+// allocations there are per sampled backtrace (the default is 1000; 0
+// disables sampling).
+//
+// When profiling is disabled, each entry point pays for one relaxed load and
+// a well-predicted branch.
+//
+// Independently of the report, swift_profiler_startCounting and
+// swift_profiler_stopCounting count allocations, retains and releases for a
+// region of the program, e.g. one benchmark. They temporarily replace the
+// runtime's instrumentation hooks (see InstrumentsSupport.h), so counting
+// costs nothing while it is off.
+//
+// On Linux, swift_profiler_startHardwareCounters and
+// swift_profiler_stopHardwareCounters count CPU events of the calling thread
+// with perf_event_open(2).
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_RUNTIME_PROFILER_H
+#define SWIFT_RUNTIME_PROFILER_H
+
+#include "swift/Runtime/Metadata.h"
+#include "llvm/Support/Compiler.h"
+#include <atomic>
+#include <cstddef>
+
+namespace swift {
+namespace profiler {
+
+enum class ProfilerState : uint8_t {
+  /// The environment has not been checked yet.
+  Unknown,
+  Disabled,
+  Enabled
+};
+
+extern std::atomic<ProfilerState> CurrentState;
+
+/// Check the environment and set up profiling if requested.
+ProfilerState initialize();
+
+/// Returns true if runtime events should be recorded.
+static inline bool isEnabled() {
+  ProfilerState state = CurrentState.load(std::memory_order_relaxed);
+  if (LLVM_LIKELY(state == ProfilerState::Disabled))
+    return false;
+  if (state == ProfilerState::Unknown)
+    state = initialize();
+  return state == ProfilerState::Enabled;
+}
+
+/// Record an object allocation made by swift_allocObject.
+void recordAllocation(const HeapMetadata *type, size_t size);
+
+/// Record a call to swift_getGenericMetadata. \p instantiated is true if the
+/// call created the metadata.
+void recordGenericMetadata(const Metadata *metadata, bool instantiated);
+
+/// Record a call to swift_conformsToProtocol.
+void recordConformanceLookup(const Metadata *type,
+                             const ProtocolDescriptor *protocol,
+                             bool succeeded);
+
+/// Record that swift_conformsToProtocol had to scan conformance records.
+void recordConformanceScan(const Metadata *type,
+                           const ProtocolDescriptor *protocol);
+
+/// Record a call to swift_dynamicCast, including nested casts of the
+/// contents of existentials and optionals.
+void recordDynamicCast(const Metadata *srcType, const Metadata *targetType,
+                       bool succeeded);
+
+/// The runtime calls counted between swift_profiler_startCounting and
+/// swift_profiler_stopCounting, by their index in the counts array.
+enum class RuntimeCallCount : unsigned {
+  Allocations,
+  AllocatedBytes,
+  Retains,
+  Releases,
+  NumCounts
+};
+
+/// The CPU events counted between swift_profiler_startHardwareCounters and
+/// swift_profiler_stopHardwareCounters, by their index in the counts array.
+enum class HardwareCounter : unsigned {
+  Instructions,
+  Cycles,
+  BranchMisses,
+  L1DataMisses,
+  LastLevelCacheMisses,
+  NumCounters
+};
+
+} // end namespace profiler
+} // end namespace swift
+
+/// Start counting object allocations, retains and releases on all threads.
+SWIFT_RUNTIME_EXPORT
+extern "C" void swift_profiler_startCounting();
+
+/// Stop counting, and store the counts since the matching
+/// swift_profiler_startCounting into \p counts, which must have room for
+/// RuntimeCallCount::NumCounts elements.
+SWIFT_RUNTIME_EXPORT
+extern "C" void swift_profiler_stopCounting(uint64_t *counts);
+
+/// Start counting the CPU events of the calling thread in user mode. Returns
+/// false if none of them can be counted, e.g. because the platform is not
+/// Linux or perf events are restricted by kernel.perf_event_paranoid.
+SWIFT_RUNTIME_EXPORT
+extern "C" bool swift_profiler_startHardwareCounters();
+
+/// Stop counting CPU events, and store the counts since the matching
+/// swift_profiler_startHardwareCounters into \p counts, which must have room
+/// for HardwareCounter::NumCounters elements. Events which could not be
+/// counted are stored as 0.
+SWIFT_RUNTIME_EXPORT
+extern "C" void swift_profiler_stopHardwareCounters(uint64_t *counts);
+
+#endif // SWIFT_RUNTIME_PROFILER_H
@@ -21,6 +21,9 @@
 #include "swift/Runtime/Mutex.h"
 #include "ImageInspection.h"
 #include "Private.h"
+#include "Profiler.h"
+#include "llvm/ADT/DenseMap.h"
+#include <algorithm>
 
 using namespace swift;
 
@@ -142,6 +145,13 @@ namespace {
     }
   };
 
+  /// A conformance record together with the index of the section containing
+  /// it.
+  struct IndexedConformanceRecord {
+    const ProtocolConformanceRecord *Record;
+    unsigned SectionIndex;
+  };
+
   struct ConformanceCacheKey {
     /// Either a Metadata* or a NominalTypeDescriptor*.
     const void *Type;
@@ -213,6 +223,26 @@ struct ConformanceState {
   ConcurrentMap<ConformanceCacheEntry> Cache;
   std::vector<ConformanceSection> SectionsToScan;
   Mutex SectionsToScanLock;
+
+  /// The number of entries in SectionsToScan, which can be read without
+  /// taking SectionsToScanLock. Negative cache entries record this count as
+  /// their failure generation.
+  std::atomic<uintptr_t> SectionsToScanCount{0};
+
+  /// The conformance records of the first NumIndexedSections sections whose
+  /// type can only be identified by instantiating metadata, grouped by
+  /// protocol and ordered by section. Guarded by SectionsToScanLock.
+  llvm::DenseMap<const ProtocolDescriptor *,
+                 std::vector<IndexedConformanceRecord>> RecordsByProtocol;
+
+  /// The remaining conformance records of the first NumIndexedSections
+  /// sections, grouped by the canonical metadata or nominal type descriptor
+  /// they reference and by protocol, and ordered by section. Guarded by
+  /// SectionsToScanLock.
+  llvm::DenseMap<std::pair<const void *, const ProtocolDescriptor *>,
+                 std::vector<IndexedConformanceRecord>> RecordsByTypeAndProtocol;
+
+  unsigned NumIndexedSections = 0;
   
   ConformanceState() {
     SectionsToScan.reserve(16);
@@ -232,6 +262,7 @@ struct ConformanceState {
 
   void cacheFailure(const void *type, const ProtocolDescriptor *proto) {
     uintptr_t failureGeneration = SectionsToScan.size();
+    assert(failureGeneration == SectionsToScanCount.load());
     auto result = Cache.getOrInsert(ConformanceCacheKey(type, proto),
                                     (const WitnessTable *) nullptr,
                                     failureGeneration);
@@ -246,6 +277,76 @@ struct ConformanceState {
                                     const ProtocolDescriptor *proto) {
     return Cache.find(ConformanceCacheKey(type, proto));
   }
+
+  /// Returns the metadata or nominal type descriptor that \p record applies
+  /// to, if that can be read off the record without instantiating anything.
+  static const void *getIndexableType(const ProtocolConformanceRecord &record) {
+    switch (record.getTypeKind()) {
+    case TypeMetadataRecordKind::UniqueDirectType:
+      return record.getDirectType();
+    case TypeMetadataRecordKind::UniqueNominalTypeDescriptor:
+      return record.getNominalTypeDescriptor();
+    case TypeMetadataRecordKind::Universal:
+    case TypeMetadataRecordKind::NonuniqueDirectType:
+    case TypeMetadataRecordKind::UniqueIndirectClass:
+    case TypeMetadataRecordKind::UniqueDirectClass:
+      return nullptr;
+    }
+    return nullptr;
+  }
+
+  /// Add the records of any sections registered since the last call to
+  /// the index. Must be called with SectionsToScanLock held.
+  void indexNewSections() {
+    for (unsigned e = SectionsToScan.size(); NumIndexedSections != e;
+         ++NumIndexedSections) {
+      for (const auto &record : SectionsToScan[NumIndexedSections]) {
+        IndexedConformanceRecord indexed{&record, NumIndexedSections};
+        if (auto type = getIndexableType(record))
+          RecordsByTypeAndProtocol[{type, record.getProtocol()}]
+            .push_back(indexed);
+        else
+          RecordsByProtocol[record.getProtocol()].push_back(indexed);
+      }
+    }
+  }
+
+  /// Returns the records from \p records in sections starting at
+  /// \p firstSection.
+  static ArrayRef<IndexedConformanceRecord>
+  fromSection(ArrayRef<IndexedConformanceRecord> records,
+              unsigned firstSection) {
+    auto first = std::lower_bound(records.begin(), records.end(),
+                                  firstSection,
+                                  [](const IndexedConformanceRecord &record,
+                                     unsigned section) {
+                                    return record.SectionIndex < section;
+                                  });
+    return records.slice(first - records.begin());
+  }
+
+  /// Returns the indexed records for \p proto that could not be keyed by
+  /// type, in sections starting at \p firstSection. Must be called with
+  /// SectionsToScanLock held.
+  ArrayRef<IndexedConformanceRecord>
+  getRecordsFor(const ProtocolDescriptor *proto, unsigned firstSection) {
+    auto found = RecordsByProtocol.find(proto);
+    if (found == RecordsByProtocol.end())
+      return {};
+    return fromSection(found->second, firstSection);
+  }
+
+  /// Returns the indexed records for \p proto that reference \p type, a
+  /// Metadata* or a NominalTypeDescriptor*, in sections starting at
+  /// \p firstSection. Must be called with SectionsToScanLock held.
+  ArrayRef<IndexedConformanceRecord>
+  getRecordsFor(const void *type, const ProtocolDescriptor *proto,
+                unsigned firstSection) {
+    auto found = RecordsByTypeAndProtocol.find({type, proto});
+    if (found == RecordsByTypeAndProtocol.end())
+      return {};
+    return fromSection(found->second, firstSection);
+  }
 };
 
 static Lazy<ConformanceState> Conformances;
@@ -256,6 +357,8 @@ _registerProtocolConformances(ConformanceState &C,
                               const ProtocolConformanceRecord *end) {
   ScopedLock guard(C.SectionsToScanLock);
   C.SectionsToScan.push_back(ConformanceSection{begin, end});
+  C.SectionsToScanCount.store(C.SectionsToScan.size(),
+                              std::memory_order_release);
 }
 
 void swift::addImageProtocolConformanceBlockCallback(const void *conformances,
@@ -317,7 +420,10 @@ recur_inside_cache_lock:
         foundEntry = Value;
 
       // If we got a cached negative response, check the generation number.
-      if (Value->getFailureGeneration() == C.SectionsToScan.size()) {
+      // This doesn't need the lock; if a section is being added concurrently
+      // the caller will take the slow path and pick it up.
+      if (Value->getFailureGeneration() ==
+            C.SectionsToScanCount.load(std::memory_order_acquire)) {
         // We found an entry with a negative value.
         return std::make_pair(nullptr, true);
       }
@@ -388,9 +494,22 @@ bool isRelatedType(const Metadata *type, const void *candidate,
   return false;
 }
 
+static const WitnessTable *
+conformsToProtocolImpl(const Metadata *type,
+                       const ProtocolDescriptor *protocol);
+
 const WitnessTable *
 swift::swift_conformsToProtocol(const Metadata *type,
                                 const ProtocolDescriptor *protocol) {
+  auto witnessTable = conformsToProtocolImpl(type, protocol);
+  if (profiler::isEnabled())
+    profiler::recordConformanceLookup(type, protocol, witnessTable != nullptr);
+  return witnessTable;
+}
+
+static const WitnessTable *
+conformsToProtocolImpl(const Metadata *type,
+                       const ProtocolDescriptor *protocol) {
   auto &C = Conformances.get();
   auto origType = type;
   unsigned numSections = 0;
@@ -437,67 +556,84 @@ recur:
   // Update the last known number of sections to scan.
   numSections = C.SectionsToScan.size();
 
+  if (profiler::isEnabled())
+    profiler::recordConformanceScan(origType, protocol);
+
   // Scan only sections that were not scanned yet.
   unsigned sectionIdx = foundEntry ? foundEntry->getFailureGeneration() : 0;
-  unsigned endSectionIdx = C.SectionsToScan.size();
 
-  for (; sectionIdx < endSectionIdx; ++sectionIdx) {
-    auto &section = C.SectionsToScan[sectionIdx];
-    // Eagerly pull records for nondependent witnesses into our cache.
-    for (const auto &record : section) {
-      // If the record applies to a specific type, cache it.
-      if (auto metadata = record.getCanonicalTypeMetadata()) {
-        auto P = record.getProtocol();
-
-        // Look for an exact match.
-        if (protocol != P)
-          continue;
-
-        if (!isRelatedType(type, metadata, /*isMetadata=*/true))
-          continue;
-
-        // Store the type-protocol pair in the cache.
-        auto witness = record.getWitnessTable(metadata);
-        if (witness) {
-          C.cacheSuccess(metadata, P, witness);
-        } else {
-          C.cacheFailure(metadata, P);
-        }
-
-      // TODO: "Nondependent witness table" probably deserves its own flag.
-      // An accessor function might still be necessary even if the witness table
-      // can be shared.
-      } else if (record.getTypeKind()
-                   == TypeMetadataRecordKind::UniqueNominalTypeDescriptor) {
-
-        auto R = record.getNominalTypeDescriptor();
-        auto P = record.getProtocol();
-
-        // Look for an exact match.
-        if (protocol != P)
-          continue;
-
-        if (!isRelatedType(type, R, /*isMetadata=*/false))
-          continue;
-
-        // Store the type-protocol pair in the cache.
-        switch (record.getConformanceKind()) {
-        case ProtocolConformanceReferenceKind::WitnessTable:
-          // If the record provides a nondependent witness table for all
-          // instances of a generic type, cache it for the generic pattern.
-          C.cacheSuccess(R, P, record.getStaticWitnessTable());
-          break;
-
-        case ProtocolConformanceReferenceKind::WitnessTableAccessor:
-          // If the record provides a dependent witness table accessor,
-          // cache the result for the instantiated type metadata.
-          C.cacheSuccess(type, P, record.getWitnessTable(type));
-          break;
-
-        }
+  // Only look at the records for this protocol. They are indexed the first
+  // time somebody misses in the cache after their section is registered.
+  C.indexNewSections();
+
+  auto scanRecord = [&](const IndexedConformanceRecord &indexed) {
+    const auto &record = *indexed.Record;
+    assert(record.getProtocol() == protocol);
+
+    // If the record applies to a specific type, cache it.
+    if (auto metadata = record.getCanonicalTypeMetadata()) {
+      auto P = record.getProtocol();
+
+      if (!isRelatedType(type, metadata, /*isMetadata=*/true))
+        return;
+
+      // Store the type-protocol pair in the cache.
+      auto witness = record.getWitnessTable(metadata);
+      if (witness) {
+        C.cacheSuccess(metadata, P, witness);
+      } else {
+        C.cacheFailure(metadata, P);
+      }
+
+    // TODO: "Nondependent witness table" probably deserves its own flag.
+    // An accessor function might still be necessary even if the witness table
+    // can be shared.
+    } else if (record.getTypeKind()
+                 == TypeMetadataRecordKind::UniqueNominalTypeDescriptor) {
+
+      auto R = record.getNominalTypeDescriptor();
+      auto P = record.getProtocol();
+
+      if (!isRelatedType(type, R, /*isMetadata=*/false))
+        return;
+
+      // Store the type-protocol pair in the cache.
+      switch (record.getConformanceKind()) {
+      case ProtocolConformanceReferenceKind::WitnessTable:
+        // If the record provides a nondependent witness table for all
+        // instances of a generic type, cache it for the generic pattern.
+        C.cacheSuccess(R, P, record.getStaticWitnessTable());
+        break;
+
+      case ProtocolConformanceReferenceKind::WitnessTableAccessor:
+        // If the record provides a dependent witness table accessor,
+        // cache the result for the instantiated type metadata.
+        C.cacheSuccess(type, P, record.getWitnessTable(type));
+        break;
+
       }
     }
+  };
+
+  // Records keyed by type can only apply if they reference the type itself,
+  // one of its superclasses, or their nominal type descriptors; the same set
+  // of candidates isRelatedType checks.
+  for (auto related = type;;) {
+    for (const auto &indexed : C.getRecordsFor(related, protocol, sectionIdx))
+      scanRecord(indexed);
+    if (auto *description = related->getNominalTypeDescriptor().get())
+      for (const auto &indexed :
+             C.getRecordsFor(description, protocol, sectionIdx))
+        scanRecord(indexed);
+
+    const ClassMetadata *classType = related->getClassObject();
+    if (!classType || !classHasSuperclass(classType))
+      break;
+    related = swift_getObjCClassMetadata(classType->SuperClass);
   }
+
+  for (const auto &indexed : C.getRecordsFor(protocol, sectionIdx))
+    scanRecord(indexed);
   ++ConformanceCacheGeneration;
 
   C.SectionsToScanLock.unlock();
@@ -506,6 +642,10 @@ recur:
   goto recur;
 }
 
+uintptr_t swift::_swift_getProtocolConformanceGeneration() {
+  return Conformances.get().SectionsToScanCount.load(std::memory_order_acquire);
+}
+
 const Metadata *
 swift::_searchConformancesByMangledTypeName(const llvm::StringRef typeName) {
   auto &C = Conformances.get();
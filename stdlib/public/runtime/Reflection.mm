@@ -12,6 +12,7 @@
 
 #include "swift/Basic/Fallthrough.h"
 #include "swift/Runtime/Reflection.h"
+#include "swift/Runtime/Concurrent.h"
 #include "swift/Runtime/Config.h"
 #include "swift/Runtime/HeapObject.h"
 #include "swift/Runtime/Metadata.h"
@@ -23,6 +24,7 @@
 #include <cassert>
 #include <cstdio>
 #include <cstring>
+#include <memory>
 #include <new>
 #include <string>
 #include <tuple>
@@ -417,6 +419,87 @@ static const char *getFieldName(const char *fieldNames, size_t i) {
   return fieldName;
 }
 
+/// The stored properties of a struct or class type, in a form that makes
+/// reflecting each child of a value cheap.
+struct ReflectedFieldsEntry {
+  const Metadata *Type;
+  size_t NumFields;
+  std::unique_ptr<ReflectedField[]> Fields;
+
+  ReflectedFieldsEntry(const Metadata *type);
+
+  int compareWithKey(const Metadata *type) const {
+    if (type != Type)
+      return (uintptr_t(type) < uintptr_t(Type) ? -1 : 1);
+    return 0;
+  }
+
+  static size_t getExtraAllocationSize(const Metadata *type) {
+    return 0;
+  }
+
+  size_t getExtraAllocationSize() const {
+    return 0;
+  }
+};
+
+ReflectedFieldsEntry::ReflectedFieldsEntry(const Metadata *type)
+  : Type(type), NumFields(0) {
+  const char *names;
+  const FieldType *types;
+  if (type->getKind() == MetadataKind::Struct) {
+    auto Struct = static_cast<const StructMetadata *>(type);
+    NumFields = Struct->Description->Struct.NumFields;
+    if (NumFields == 0)
+      return;
+    names = Struct->Description->Struct.FieldNames;
+    types = Struct->getFieldTypes();
+    Fields.reset(new ReflectedField[NumFields]);
+    auto offsets = Struct->getFieldOffsets();
+    for (size_t i = 0; i < NumFields; ++i)
+      Fields[i].Offset = offsets[i];
+  } else {
+    auto Clas = static_cast<const ClassMetadata *>(type);
+    NumFields = Clas->getDescription()->Class.NumFields;
+    if (NumFields == 0)
+      return;
+    names = Clas->getDescription()->Class.FieldNames;
+    types = Clas->getFieldTypes();
+    Fields.reset(new ReflectedField[NumFields]);
+
+    // FIXME: If the class has ObjC heritage, get the field offsets using the
+    // ObjC metadata, because we don't update the field offsets in the face of
+    // resilient base classes.
+    if (usesNativeSwiftReferenceCounting(Clas)) {
+      auto offsets = Clas->getFieldOffsets();
+      for (size_t i = 0; i < NumFields; ++i)
+        Fields[i].Offset = offsets[i];
+    } else {
+#if SWIFT_OBJC_INTEROP
+      Ivar *ivars = class_copyIvarList((Class)Clas, nullptr);
+      for (size_t i = 0; i < NumFields; ++i)
+        Fields[i].Offset = ivar_getOffset(ivars[i]);
+      free(ivars);
+#else
+      swift::crash("Object appears to be Objective-C, but no runtime.");
+#endif
+    }
+  }
+
+  // Walk the doubly-null-terminated list of names once, rather than once per
+  // field.
+  for (size_t i = 0; i < NumFields; ++i) {
+    Fields[i].Name = names;
+    names += strlen(names) + 1;
+    Fields[i].Type = types[i];
+  }
+}
+
+/// The stored properties of each struct and class type that has been
+/// reflected.
+static ConcurrentMap<ReflectedFieldsEntry, /*Destructor*/ false>
+  ReflectedFieldsCache;
+
 
 static bool loadSpecialReferenceStorage(HeapObject *owner,
                                         OpaqueValue *fieldData,
@@ -501,19 +584,19 @@ void swift_StructMirror_subscript(String *outString,
                                   HeapObject *owner,
                                   OpaqueValue *value,
                                   const Metadata *type) {
-  auto Struct = static_cast<const StructMetadata *>(type);
+  size_t numFields;
+  auto fields = swift_getReflectedFields(type, &numFields);
 
-  if (i < 0 || (size_t)i > Struct->Description->Struct.NumFields)
+  if (i < 0 || (size_t)i >= numFields)
     swift::crash("Swift mirror subscript bounds check failure");
 
-  // Load the type and offset from their respective vectors.
-  auto fieldType = Struct->getFieldTypes()[i];
-  auto fieldOffset = Struct->getFieldOffsets()[i];
+  auto &field = fields[i];
+  auto fieldType = field.Type;
 
   auto bytes = reinterpret_cast<char*>(value);
-  auto fieldData = reinterpret_cast<OpaqueValue *>(bytes + fieldOffset);
+  auto fieldData = reinterpret_cast<OpaqueValue *>(bytes + field.Offset);
 
-  new (outString) String(getFieldName(Struct->Description->Struct.FieldNames, i));
+  new (outString) String(field.Name);
 
   // 'owner' is consumed by this call.
   assert(!fieldType.isIndirect() && "indirect struct fields not implemented");
@@ -718,35 +801,21 @@ void swift_ClassMirror_subscript(String *outString,
     --i;
   }
 
-  if (i < 0 || (size_t)i > Clas->getDescription()->Class.NumFields)
+  size_t numFields;
+  auto fields = swift_getReflectedFields(type, &numFields);
+
+  if (i < 0 || (size_t)i >= numFields)
     swift::crash("Swift mirror subscript bounds check failure");
 
-  // Load the type and offset from their respective vectors.
-  auto fieldType = Clas->getFieldTypes()[i];
+  auto &field = fields[i];
+  auto fieldType = field.Type;
   assert(!fieldType.isIndirect()
          && "class indirect properties not implemented");
 
-  // FIXME: If the class has ObjC heritage, get the field offset using the ObjC
-  // metadata, because we don't update the field offsets in the face of
-  // resilient base classes.
-  uintptr_t fieldOffset;
-  if (usesNativeSwiftReferenceCounting(Clas)) {
-    fieldOffset = Clas->getFieldOffsets()[i];
-  } else {
-#if SWIFT_OBJC_INTEROP
-    Ivar *ivars = class_copyIvarList((Class)Clas, nullptr);
-    fieldOffset = ivar_getOffset(ivars[i]);
-    free(ivars);
-#else
-    swift::crash("Object appears to be Objective-C, but no runtime.");
-#endif
-  }
-
   auto bytes = *reinterpret_cast<char * const *>(value);
-  auto fieldData = reinterpret_cast<OpaqueValue *>(bytes + fieldOffset);
+  auto fieldData = reinterpret_cast<OpaqueValue *>(bytes + field.Offset);
 
-  new (outString) String(getFieldName(Clas->getDescription()->Class.FieldNames,
-                                      i));
+  new (outString) String(field.Name);
 
  if (loadSpecialReferenceStorage(owner, fieldData, fieldType, outMirror))
    return;
@@ -1157,6 +1226,13 @@ MagicMirror::MagicMirror(HeapObject *owner,
 
 } // end anonymous namespace
 
+const ReflectedField *swift::swift_getReflectedFields(const Metadata *type,
+                                                      size_t *count) {
+  auto entry = ReflectedFieldsCache.getOrInsert(type).first;
+  *count = entry->NumFields;
+  return entry->Fields.get();
+}
+
 /// func reflect<T>(x: T) -> Mirror
 ///
 /// Produce a mirror for any value.  The runtime produces a mirror that
@@ -22,6 +22,7 @@
 #include <stdio.h>
 #include <string.h>
 #include "swift/Basic/Lazy.h"
+#include "swift/Runtime/Heap.h"
 #include "../SwiftShims/LibcShims.h"
 #include "llvm/Support/DataTypes.h"
 
@@ -51,6 +52,20 @@ __swift_size_t swift::_swift_stdlib_fwrite_stdout(const void *ptr,
   return fwrite(ptr, size, nitems, stdout);
 }
 
+SWIFT_RUNTIME_STDLIB_INTERFACE
+__swift_size_t
+swift::_swift_stdlib_fwrite_stdout_unlocked(const void *ptr,
+                                            __swift_size_t size,
+                                            __swift_size_t nitems) {
+#if defined(_WIN32)
+  return _fwrite_nolock(ptr, size, nitems, stdout);
+#elif defined(__GLIBC__)
+  return fwrite_unlocked(ptr, size, nitems, stdout);
+#else
+  return fwrite(ptr, size, nitems, stdout);
+#endif
+}
+
 SWIFT_RUNTIME_STDLIB_INTERFACE
 __swift_size_t swift::_swift_stdlib_strlen(const char *s) {
   return strlen(s);
@@ -62,6 +77,12 @@ int swift::_swift_stdlib_memcmp(const void *s1, const void *s2,
   return memcmp(s1, s2, n);
 }
 
+SWIFT_RUNTIME_STDLIB_INTERFACE
+const void *swift::_swift_stdlib_memchr(const void *s, int c,
+                                        __swift_size_t n) {
+  return memchr(s, c, n);
+}
+
 SWIFT_RUNTIME_STDLIB_INTERFACE
 __swift_ssize_t
 swift::_swift_stdlib_read(int fd, void *buf, __swift_size_t nbyte) {
@@ -93,32 +114,37 @@ int swift::_swift_stdlib_close(int fd) {
 
 #if defined(__APPLE__)
 #include <malloc/malloc.h>
-SWIFT_RUNTIME_STDLIB_INTERFACE
-size_t swift::_swift_stdlib_malloc_size(const void *ptr) {
+static size_t getMallocSize(const void *ptr) {
   return malloc_size(ptr);
 }
 #elif defined(__GNU_LIBRARY__) || defined(__CYGWIN__) || defined(__ANDROID__)
 #include <malloc.h>
-SWIFT_RUNTIME_STDLIB_INTERFACE
-size_t swift::_swift_stdlib_malloc_size(const void *ptr) {
+static size_t getMallocSize(const void *ptr) {
   return malloc_usable_size(const_cast<void *>(ptr));
 }
 #elif defined(_WIN32)
 #include <malloc.h>
-SWIFT_RUNTIME_STDLIB_INTERFACE
-size_t swift::_swift_stdlib_malloc_size(const void *ptr) {
+static size_t getMallocSize(const void *ptr) {
   return _msize(const_cast<void *>(ptr));
 }
 #elif defined(__FreeBSD__)
 #include <malloc_np.h>
-SWIFT_RUNTIME_STDLIB_INTERFACE
-size_t swift::_swift_stdlib_malloc_size(const void *ptr) {
+static size_t getMallocSize(const void *ptr) {
   return malloc_usable_size(const_cast<void *>(ptr));
 }
 #else
 #error No malloc_size analog known for this platform/libc.
 #endif
 
+SWIFT_RUNTIME_STDLIB_INTERFACE
+size_t swift::_swift_stdlib_malloc_size(const void *ptr) {
+  // Small objects may come from the runtime's slab allocator instead of
+  // malloc.
+  if (size_t size = swift_getSlabAllocationSize(ptr))
+    return size;
+  return getMallocSize(ptr);
+}
+
 static Lazy<std::mt19937> theGlobalMT19937;
 
 static std::mt19937 &getGlobalMT19937() {
@@ -0,0 +1,153 @@
+//===--- ParallelFor.cpp - Thread pool for parallel algorithms ------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// A pool of worker threads shared by the standard library's concurrent
+// collection algorithms.
+//
+// Each call to _swift_stdlib_parallelFor publishes a job, and the calling
+// thread and any idle workers claim its iterations one at a time from a
+// shared counter until there are none left. The caller always takes part,
+// so a job finishes even when every worker is busy, and a job started from
+// inside another job's iteration doesn't deadlock. Idle workers pick the
+// most recently published job, which is the innermost one when jobs nest.
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/Basic/Lazy.h"
+#include "../SwiftShims/RuntimeStubs.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace swift;
+
+namespace {
+
+struct ParallelForJob {
+  void (*Body)(void *context, __swift_intptr_t index);
+  void *Context;
+  __swift_intptr_t Count;
+
+  /// The next iteration to claim.
+  std::atomic<__swift_intptr_t> Next{0};
+
+  /// The number of workers running iterations of this job. Guarded by the
+  /// pool's lock.
+  unsigned Helpers = 0;
+
+  ParallelForJob(void (*body)(void *, __swift_intptr_t), void *context,
+                 __swift_intptr_t count)
+    : Body(body), Context(context), Count(count) {}
+
+  /// Run iterations until all of them have been claimed.
+  void run() {
+    __swift_intptr_t i;
+    while ((i = Next.fetch_add(1, std::memory_order_relaxed)) < Count)
+      Body(Context, i);
+  }
+};
+
+class WorkPool {
+  std::mutex Lock;
+  std::condition_variable JobAvailable;
+  std::condition_variable HelperFinished;
+
+  /// The jobs which may still have iterations to claim.
+  std::vector<ParallelForJob *> Jobs;
+
+  unsigned NumWorkers;
+
+  void removeJob(ParallelForJob *job) {
+    auto found = std::find(Jobs.begin(), Jobs.end(), job);
+    if (found != Jobs.end())
+      Jobs.erase(found);
+  }
+
+  void runWorker() {
+    std::unique_lock<std::mutex> guard(Lock);
+    while (true) {
+      JobAvailable.wait(guard, [&] { return !Jobs.empty(); });
+      ParallelForJob *job = Jobs.back();
+      ++job->Helpers;
+      guard.unlock();
+
+      job->run();
+
+      guard.lock();
+      removeJob(job);
+      if (--job->Helpers == 0)
+        HelperFinished.notify_all();
+    }
+  }
+
+public:
+  WorkPool() {
+    // The calling thread takes part in every job, so one thread per core
+    // besides it is enough.
+    unsigned cores = std::thread::hardware_concurrency();
+    NumWorkers = cores > 1 ? std::min(cores - 1, 63u) : 0;
+
+    // The workers live for the rest of the process.
+    for (unsigned i = 0; i < NumWorkers; ++i)
+      std::thread([this] { runWorker(); }).detach();
+  }
+
+  WorkPool(const WorkPool &) = delete;
+  WorkPool &operator=(const WorkPool &) = delete;
+
+  unsigned getNumWorkers() const { return NumWorkers; }
+
+  void run(ParallelForJob &job) {
+    {
+      std::lock_guard<std::mutex> guard(Lock);
+      Jobs.push_back(&job);
+    }
+    JobAvailable.notify_all();
+
+    job.run();
+
+    // Every iteration has been claimed, and the ones we didn't run are
+    // running on workers. Wait for them, since the job lives on our stack.
+    std::unique_lock<std::mutex> guard(Lock);
+    removeJob(&job);
+    HelperFinished.wait(guard, [&] { return job.Helpers == 0; });
+  }
+};
+
+} // end anonymous namespace
+
+static Lazy<WorkPool> ThePool;
+
+SWIFT_RUNTIME_STDLIB_INTERFACE
+void swift::_swift_stdlib_parallelFor(
+    __swift_intptr_t count, void *context,
+    void (*body)(void *context, __swift_intptr_t index)) {
+  if (count <= 0)
+    return;
+
+  if (count == 1 || ThePool.get().getNumWorkers() == 0) {
+    for (__swift_intptr_t i = 0; i < count; ++i)
+      body(context, i);
+    return;
+  }
+
+  ParallelForJob job(body, context, count);
+  ThePool.get().run(job);
+}
+
+SWIFT_RUNTIME_STDLIB_INTERFACE
+__swift_intptr_t swift::_swift_stdlib_getParallelism() {
+  return ThePool.get().getNumWorkers() + 1;
+}
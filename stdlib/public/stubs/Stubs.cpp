@@ -30,7 +30,9 @@
 #include <sys/errno.h>
 #include <unistd.h>
 #endif
+#include <cfloat>
 #include <climits>
+#include <cmath>
 #include <cstdarg>
 #include <cstdint>
 #include <cstdio>
@@ -74,28 +76,48 @@ static long double swift_strtold_l(const char *nptr,
 static uint64_t uint64ToStringImpl(char *Buffer, uint64_t Value,
                                    int64_t Radix, bool Uppercase,
                                    bool Negative) {
-  char *P = Buffer;
+  // Digits are generated from the least significant one, so write them to
+  // the end of a scratch buffer that fits a 64-bit value in binary.
+  char Digits[64];
+  char *End = Digits + sizeof(Digits);
+  char *P = End;
   uint64_t Y = Value;
 
-  if (Y == 0) {
-    *P++ = '0';
-  } else if (Radix == 10) {
-    while (Y) {
-      *P++ = '0' + char(Y % 10);
-      Y /= 10;
+  if (Radix == 10) {
+    static const char DigitPairs[] =
+      "00010203040506070809101112131415161718192021222324252627282930313233"
+      "34353637383940414243444546474849505152535455565758596061626364656667"
+      "6869707172737475767778798081828384858687888990919293949596979899";
+    while (Y >= 100) {
+      P -= 2;
+      memcpy(P, &DigitPairs[2 * (Y % 100)], 2);
+      Y /= 100;
+    }
+    if (Y >= 10) {
+      P -= 2;
+      memcpy(P, &DigitPairs[2 * Y], 2);
+    } else {
+      *--P = '0' + char(Y);
     }
+  } else if ((Radix & (Radix - 1)) == 0) {
+    unsigned Shift = __builtin_ctzll(Radix);
+    do {
+      *--P = llvm::hexdigit(Y & (Radix - 1), !Uppercase);
+      Y >>= Shift;
+    } while (Y);
   } else {
     unsigned Radix32 = Radix;
-    while (Y) {
-      *P++ = llvm::hexdigit(Y % Radix32, !Uppercase);
+    do {
+      *--P = llvm::hexdigit(Y % Radix32, !Uppercase);
       Y /= Radix32;
-    }
+    } while (Y);
   }
 
+  char *Q = Buffer;
   if (Negative)
-    *P++ = '-';
-  std::reverse(Buffer, P);
-  return size_t(P - Buffer);
+    *Q++ = '-';
+  memcpy(Q, P, End - P);
+  return size_t(Q + (End - P) - Buffer);
 }
 
 SWIFT_CC(swift) SWIFT_RUNTIME_STDLIB_INTERFACE
@@ -181,6 +203,356 @@ static int swift_snprintf_l(char *Str, size_t StrSize, locale_t Locale,
 }
 #endif
 
+//===----------------------------------------------------------------------===//
+// Shortest round-trip formatting of floating-point numbers
+//===----------------------------------------------------------------------===//
+
+// This is an implementation of the Grisu3 algorithm from Florian Loitsch,
+// "Printing Floating-Point Numbers Quickly and Accurately with Integers"
+// (PLDI 2010). Grisu3 produces the shortest digit string that parses back to
+// the same value, or reports that it cannot decide, in which case we fall back
+// to the C library.
+
+namespace {
+
+/// An unsigned floating-point number with a 64-bit significand and a binary
+/// exponent, without hidden bit: Value = F * 2^E.
+struct DiyFp {
+  uint64_t F;
+  int E;
+};
+
+/// A normalized power of ten 10^K = F * 2^E, rounded to 64 bits.
+struct CachedPower {
+  uint64_t F;
+  int16_t E;
+  int16_t K;
+};
+
+} // end anonymous namespace
+
+/// The powers of ten from 10^-348 to 10^340, in steps of 8.
+static const CachedPower CachedPowers[] = {
+    {0xfa8fd5a0081c0288ULL, -1220, -348},
+    {0xbaaee17fa23ebf76ULL, -1193, -340},
+    {0x8b16fb203055ac76ULL, -1166, -332},
+    {0xcf42894a5dce35eaULL, -1140, -324},
+    {0x9a6bb0aa55653b2dULL, -1113, -316},
+    {0xe61acf033d1a45dfULL, -1087, -308},
+    {0xab70fe17c79ac6caULL, -1060, -300},
+    {0xff77b1fcbebcdc4fULL, -1034, -292},
+    {0xbe5691ef416bd60cULL, -1007, -284},
+    {0x8dd01fad907ffc3cULL, -980, -276},
+    {0xd3515c2831559a83ULL, -954, -268},
+    {0x9d71ac8fada6c9b5ULL, -927, -260},
+    {0xea9c227723ee8bcbULL, -901, -252},
+    {0xaecc49914078536dULL, -874, -244},
+    {0x823c12795db6ce57ULL, -847, -236},
+    {0xc21094364dfb5637ULL, -821, -228},
+    {0x9096ea6f3848984fULL, -794, -220},
+    {0xd77485cb25823ac7ULL, -768, -212},
+    {0xa086cfcd97bf97f4ULL, -741, -204},
+    {0xef340a98172aace5ULL, -715, -196},
+    {0xb23867fb2a35b28eULL, -688, -188},
+    {0x84c8d4dfd2c63f3bULL, -661, -180},
+    {0xc5dd44271ad3cdbaULL, -635, -172},
+    {0x936b9fcebb25c996ULL, -608, -164},
+    {0xdbac6c247d62a584ULL, -582, -156},
+    {0xa3ab66580d5fdaf6ULL, -555, -148},
+    {0xf3e2f893dec3f126ULL, -529, -140},
+    {0xb5b5ada8aaff80b8ULL, -502, -132},
+    {0x87625f056c7c4a8bULL, -475, -124},
+    {0xc9bcff6034c13053ULL, -449, -116},
+    {0x964e858c91ba2655ULL, -422, -108},
+    {0xdff9772470297ebdULL, -396, -100},
+    {0xa6dfbd9fb8e5b88fULL, -369, -92},
+    {0xf8a95fcf88747d94ULL, -343, -84},
+    {0xb94470938fa89bcfULL, -316, -76},
+    {0x8a08f0f8bf0f156bULL, -289, -68},
+    {0xcdb02555653131b6ULL, -263, -60},
+    {0x993fe2c6d07b7facULL, -236, -52},
+    {0xe45c10c42a2b3b06ULL, -210, -44},
+    {0xaa242499697392d3ULL, -183, -36},
+    {0xfd87b5f28300ca0eULL, -157, -28},
+    {0xbce5086492111aebULL, -130, -20},
+    {0x8cbccc096f5088ccULL, -103, -12},
+    {0xd1b71758e219652cULL, -77, -4},
+    {0x9c40000000000000ULL, -50, 4},
+    {0xe8d4a51000000000ULL, -24, 12},
+    {0xad78ebc5ac620000ULL, 3, 20},
+    {0x813f3978f8940984ULL, 30, 28},
+    {0xc097ce7bc90715b3ULL, 56, 36},
+    {0x8f7e32ce7bea5c70ULL, 83, 44},
+    {0xd5d238a4abe98068ULL, 109, 52},
+    {0x9f4f2726179a2245ULL, 136, 60},
+    {0xed63a231d4c4fb27ULL, 162, 68},
+    {0xb0de65388cc8ada8ULL, 189, 76},
+    {0x83c7088e1aab65dbULL, 216, 84},
+    {0xc45d1df942711d9aULL, 242, 92},
+    {0x924d692ca61be758ULL, 269, 100},
+    {0xda01ee641a708deaULL, 295, 108},
+    {0xa26da3999aef774aULL, 322, 116},
+    {0xf209787bb47d6b85ULL, 348, 124},
+    {0xb454e4a179dd1877ULL, 375, 132},
+    {0x865b86925b9bc5c2ULL, 402, 140},
+    {0xc83553c5c8965d3dULL, 428, 148},
+    {0x952ab45cfa97a0b3ULL, 455, 156},
+    {0xde469fbd99a05fe3ULL, 481, 164},
+    {0xa59bc234db398c25ULL, 508, 172},
+    {0xf6c69a72a3989f5cULL, 534, 180},
+    {0xb7dcbf5354e9beceULL, 561, 188},
+    {0x88fcf317f22241e2ULL, 588, 196},
+    {0xcc20ce9bd35c78a5ULL, 614, 204},
+    {0x98165af37b2153dfULL, 641, 212},
+    {0xe2a0b5dc971f303aULL, 667, 220},
+    {0xa8d9d1535ce3b396ULL, 694, 228},
+    {0xfb9b7cd9a4a7443cULL, 720, 236},
+    {0xbb764c4ca7a44410ULL, 747, 244},
+    {0x8bab8eefb6409c1aULL, 774, 252},
+    {0xd01fef10a657842cULL, 800, 260},
+    {0x9b10a4e5e9913129ULL, 827, 268},
+    {0xe7109bfba19c0c9dULL, 853, 276},
+    {0xac2820d9623bf429ULL, 880, 284},
+    {0x80444b5e7aa7cf85ULL, 907, 292},
+    {0xbf21e44003acdd2dULL, 933, 300},
+    {0x8e679c2f5e44ff8fULL, 960, 308},
+    {0xd433179d9c8cb841ULL, 986, 316},
+    {0x9e19db92b4e31ba9ULL, 1013, 324},
+    {0xeb96bf6ebadf77d9ULL, 1039, 332},
+    {0xaf87023b9bf0ee6bULL, 1066, 340},
+};
+
+static const int CachedPowersOffset = 348;
+static const int CachedPowersDecimalDistance = 8;
+
+/// Grisu wants the scaled values to have a binary exponent in this range, so
+/// that the integral part of a scaled value fits in 32 bits and at least one
+/// digit is generated from it.
+static const int MinimalTargetExponent = -60;
+
+static DiyFp multiply(DiyFp X, DiyFp Y) {
+  // Computes the upper 64 bits of the 128-bit product, rounded.
+  const uint64_t Mask32 = 0xFFFFFFFFu;
+  uint64_t A = X.F >> 32, B = X.F & Mask32;
+  uint64_t C = Y.F >> 32, D = Y.F & Mask32;
+  uint64_t AC = A * C, BC = B * C, AD = A * D, BD = B * D;
+  uint64_t Tmp = (BD >> 32) + (AD & Mask32) + (BC & Mask32) + (1u << 31);
+  return {AC + (AD >> 32) + (BC >> 32) + (Tmp >> 32), X.E + Y.E + 64};
+}
+
+static DiyFp normalize(DiyFp X) {
+  int Shift = __builtin_clzll(X.F);
+  return {X.F << Shift, X.E - Shift};
+}
+
+/// Returns the cached power of ten that scales a number with binary exponent
+/// `E` into the target exponent range.
+static CachedPower getCachedPower(int E) {
+  int MinExponent = MinimalTargetExponent - (E + 64);
+  int K = int(std::ceil((MinExponent + 63) * 0.30102999566398114));
+  int Index = (CachedPowersOffset + K - 1) / CachedPowersDecimalDistance + 1;
+  return CachedPowers[Index];
+}
+
+/// Returns the biggest power of ten that is less than or equal to `Number`,
+/// which must be non-zero, and the number of its decimal digits.
+static uint32_t biggestPowerTen(uint32_t Number, int &Digits) {
+  static const uint32_t PowersOfTen[] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+  };
+  int Exponent = 9;
+  while (PowersOfTen[Exponent] > Number)
+    --Exponent;
+  Digits = Exponent + 1;
+  return PowersOfTen[Exponent];
+}
+
+/// Moves the last generated digit towards the scaled value while the result
+/// stays inside the rounding interval, then checks that the digits are
+/// guaranteed to be the closest shortest representation.
+static bool roundWeed(char *Buffer, int Length, uint64_t DistanceTooHighW,
+                      uint64_t UnsafeInterval, uint64_t Rest,
+                      uint64_t TenKappa, uint64_t Unit) {
+  uint64_t SmallDistance = DistanceTooHighW - Unit;
+  uint64_t BigDistance = DistanceTooHighW + Unit;
+  while (Rest < SmallDistance && UnsafeInterval - Rest >= TenKappa &&
+         (Rest + TenKappa < SmallDistance ||
+          SmallDistance - Rest >= Rest + TenKappa - SmallDistance)) {
+    --Buffer[Length - 1];
+    Rest += TenKappa;
+  }
+  if (Rest < BigDistance && UnsafeInterval - Rest >= TenKappa &&
+      (Rest + TenKappa < BigDistance ||
+       BigDistance - Rest > Rest + TenKappa - BigDistance))
+    return false;
+  return 2 * Unit <= Rest && Rest <= UnsafeInterval - 4 * Unit;
+}
+
+/// Generates the shortest digits of a number in the interval (Low, High)
+/// that is closest to W. All three must have the same exponent. On return,
+/// the digits times 10^Kappa approximate W.
+static bool digitGen(DiyFp Low, DiyFp W, DiyFp High, char *Buffer,
+                     int &Length, int &Kappa) {
+  // The boundaries are imprecise by one unit after scaling, so only the
+  // interval between them widened by that unit is safe to look at.
+  uint64_t Unit = 1;
+  uint64_t TooLow = Low.F - Unit;
+  uint64_t TooHigh = High.F + Unit;
+  uint64_t UnsafeInterval = TooHigh - TooLow;
+
+  int Shift = -W.E;
+  uint64_t One = uint64_t(1) << Shift;
+  uint32_t Integrals = uint32_t(TooHigh >> Shift);
+  uint64_t Fractionals = TooHigh & (One - 1);
+
+  uint32_t Divisor = biggestPowerTen(Integrals, Kappa);
+  Length = 0;
+  while (Kappa > 0) {
+    Buffer[Length++] = char('0' + Integrals / Divisor);
+    Integrals %= Divisor;
+    --Kappa;
+    uint64_t Rest = (uint64_t(Integrals) << Shift) + Fractionals;
+    if (Rest < UnsafeInterval)
+      return roundWeed(Buffer, Length, TooHigh - W.F, UnsafeInterval, Rest,
+                       uint64_t(Divisor) << Shift, Unit);
+    Divisor /= 10;
+  }
+
+  for (;;) {
+    Fractionals *= 10;
+    Unit *= 10;
+    UnsafeInterval *= 10;
+    Buffer[Length++] = char('0' + (Fractionals >> Shift));
+    Fractionals &= One - 1;
+    --Kappa;
+    if (Fractionals < UnsafeInterval)
+      return roundWeed(Buffer, Length, (TooHigh - W.F) * Unit, UnsafeInterval,
+                       Fractionals, One, Unit);
+  }
+}
+
+/// Computes the shortest digits D and the exponent X such that D * 10^X
+/// parses back to the positive, finite value F * 2^E. `LowerBoundaryIsCloser`
+/// is set if F * 2^E is a power of two above the smallest normal number,
+/// where the gap to the next smaller value is half as big.
+static bool grisu3(uint64_t F, int E, bool LowerBoundaryIsCloser,
+                   char *Buffer, int &Length, int &DecimalExponent) {
+  DiyFp W = normalize({F, E});
+  DiyFp Plus = normalize({(F << 1) + 1, E - 1});
+  DiyFp Minus = LowerBoundaryIsCloser ? DiyFp{(F << 2) - 1, E - 2}
+                                      : DiyFp{(F << 1) - 1, E - 1};
+  Minus.F <<= Minus.E - Plus.E;
+  Minus.E = Plus.E;
+
+  CachedPower Power = getCachedPower(W.E);
+  DiyFp Scale = {Power.F, Power.E};
+  int Kappa;
+  bool Result = digitGen(multiply(Minus, Scale), multiply(W, Scale),
+                         multiply(Plus, Scale), Buffer, Length, Kappa);
+  DecimalExponent = Kappa - Power.K;
+  return Result;
+}
+
+static bool shortestDigits(double Value, char *Buffer, int &Length,
+                           int &DecimalExponent) {
+  uint64_t Bits;
+  memcpy(&Bits, &Value, sizeof(Bits));
+  uint64_t Significand = Bits & ((uint64_t(1) << 52) - 1);
+  int BiasedExponent = int((Bits >> 52) & 0x7FF);
+  if (BiasedExponent == 0)
+    return grisu3(Significand, -1074, false, Buffer, Length, DecimalExponent);
+  return grisu3(Significand | (uint64_t(1) << 52), BiasedExponent - 1075,
+                Significand == 0 && BiasedExponent > 1, Buffer, Length,
+                DecimalExponent);
+}
+
+static bool shortestDigits(float Value, char *Buffer, int &Length,
+                           int &DecimalExponent) {
+  uint32_t Bits;
+  memcpy(&Bits, &Value, sizeof(Bits));
+  uint32_t Significand = Bits & ((uint32_t(1) << 23) - 1);
+  int BiasedExponent = int((Bits >> 23) & 0xFF);
+  if (BiasedExponent == 0)
+    return grisu3(Significand, -149, false, Buffer, Length, DecimalExponent);
+  return grisu3(Significand | (uint32_t(1) << 23), BiasedExponent - 150,
+                Significand == 0 && BiasedExponent > 1, Buffer, Length,
+                DecimalExponent);
+}
+
+/// Formats a finite value the way `"%.*g"` does with the given precision, if
+/// its shortest round-trip representation has at most that many digits.
+///
+/// In that case the `"%.*g"` output consists of the same digits: any decimal
+/// with at most `digits10` significant digits survives a round trip through
+/// the floating-point type. Returns 0 if the value needs more digits.
+template <typename T>
+static uint64_t swift_formatShortest(char *Buffer, T Value, int Precision) {
+  char *P = Buffer;
+  if (std::signbit(Value)) {
+    *P++ = '-';
+    Value = -Value;
+  }
+  if (Value == 0) {
+    memcpy(P, "0.0", 3);
+    return P + 3 - Buffer;
+  }
+
+  // Subnormal numbers have fewer than `digits10` digits of precision.
+  if (!std::isnormal(Value))
+    return 0;
+
+  char Digits[24];
+  int Length, DecimalExponent;
+  if (!shortestDigits(Value, Digits, Length, DecimalExponent) ||
+      Length > Precision)
+    return 0;
+
+  // The exponent of the first digit.
+  int Exponent = Length + DecimalExponent - 1;
+  if (Exponent < -4 || Exponent >= Precision) {
+    *P++ = Digits[0];
+    if (Length > 1) {
+      *P++ = '.';
+      memcpy(P, Digits + 1, Length - 1);
+      P += Length - 1;
+    }
+    *P++ = 'e';
+    *P++ = Exponent < 0 ? '-' : '+';
+    unsigned AbsExponent = Exponent < 0 ? -Exponent : Exponent;
+    if (AbsExponent >= 100)
+      *P++ = char('0' + AbsExponent / 100);
+    *P++ = char('0' + AbsExponent / 10 % 10);
+    *P++ = char('0' + AbsExponent % 10);
+  } else if (Exponent < 0) {
+    memcpy(P, "0.", 2);
+    P += 2;
+    memset(P, '0', -Exponent - 1);
+    P += -Exponent - 1;
+    memcpy(P, Digits, Length);
+    P += Length;
+  } else if (Length <= Exponent + 1) {
+    memcpy(P, Digits, Length);
+    P += Length;
+    memset(P, '0', Exponent + 1 - Length);
+    P += Exponent + 1 - Length;
+    memcpy(P, ".0", 2);
+    P += 2;
+  } else {
+    memcpy(P, Digits, Exponent + 1);
+    P += Exponent + 1;
+    *P++ = '.';
+    memcpy(P, Digits + Exponent + 1, Length - Exponent - 1);
+    P += Length - Exponent - 1;
+  }
+  return P - Buffer;
+}
+
+// The cached powers of ten are not precise enough for Float80.
+static uint64_t swift_formatShortest(char *Buffer, long double Value,
+                                     int Precision) {
+  return 0;
+}
+
 template <typename T>
 static uint64_t swift_floatingPointToString(char *Buffer, size_t BufferLength,
                                             T Value, const char *Format, 
@@ -191,6 +563,9 @@ static uint64_t swift_floatingPointToString(char *Buffer, size_t BufferLength,
   int Precision = std::numeric_limits<T>::digits10;
   if (Debug) {
     Precision = std::numeric_limits<T>::max_digits10;
+  } else if (uint64_t Length =
+                 swift_formatShortest(Buffer, Value, Precision)) {
+    return Length;
   }
 
 #if defined(__CYGWIN__) || defined(_WIN32)
@@ -438,12 +813,120 @@ __mulodi4(di_int a, di_int b, int* overflow)
 }
 #endif
 
+/// Parses a plain decimal number, `[+-]?[0-9]*(.[0-9]*)?([eE][+-]?[0-9]+)?`,
+/// whose significand and power of ten are both exactly representable in `T`.
+/// A single correctly rounded multiplication or division then gives the
+/// correctly rounded result (Clinger's fast path). Returns a pointer past the
+/// parsed characters, or null if the fast path does not apply.
+template <typename T, uint64_t MaxExactSignificand, int MaxExactPowerOfTen>
+static const char *parseDecimalFastImpl(const char *nptr, T *outResult) {
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+  static const T PowersOfTen[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+  const char *P = nptr;
+  bool Negative = *P == '-';
+  if (*P == '-' || *P == '+')
+    ++P;
+  // Leave hexadecimal numbers, infinity and NaN to the C library.
+  if (P[0] == '0' && (P[1] == 'x' || P[1] == 'X'))
+    return nullptr;
+
+  uint64_t Significand = 0;
+  int SignificantDigits = 0;
+  int Exponent = 0;
+  bool SawDigit = false;
+  for (; *P >= '0' && *P <= '9'; ++P) {
+    SawDigit = true;
+    if (Significand == 0 && *P == '0')
+      continue;
+    if (++SignificantDigits > 19)
+      return nullptr;
+    Significand = Significand * 10 + (*P - '0');
+  }
+  if (*P == '.') {
+    for (++P; *P >= '0' && *P <= '9'; ++P) {
+      SawDigit = true;
+      --Exponent;
+      if (Significand == 0 && *P == '0')
+        continue;
+      if (++SignificantDigits > 19)
+        return nullptr;
+      Significand = Significand * 10 + (*P - '0');
+    }
+  }
+  if (!SawDigit)
+    return nullptr;
+
+  if (*P == 'e' || *P == 'E') {
+    const char *E = P + 1;
+    bool NegativeExponent = *E == '-';
+    if (*E == '-' || *E == '+')
+      ++E;
+    if (*E >= '0' && *E <= '9') {
+      int ExplicitExponent = 0;
+      for (; *E >= '0' && *E <= '9'; ++E) {
+        if (ExplicitExponent > 9999)
+          return nullptr;
+        ExplicitExponent = ExplicitExponent * 10 + (*E - '0');
+      }
+      Exponent += NegativeExponent ? -ExplicitExponent : ExplicitExponent;
+      P = E;
+    }
+  }
+
+  T Result;
+  if (Significand == 0) {
+    Result = 0;
+  } else {
+    if (Significand > MaxExactSignificand)
+      return nullptr;
+    // A larger exponent still works if the excess can be moved into the
+    // significand without making it inexact.
+    for (; Exponent > MaxExactPowerOfTen; --Exponent) {
+      if (Significand > MaxExactSignificand / 10)
+        return nullptr;
+      Significand *= 10;
+    }
+    if (Exponent < -MaxExactPowerOfTen)
+      return nullptr;
+    Result = T(Significand);
+    if (Exponent < 0)
+      Result /= PowersOfTen[-Exponent];
+    else
+      Result *= PowersOfTen[Exponent];
+  }
+  *outResult = Negative ? -Result : Result;
+  return P;
+#else
+  // Excess precision in intermediate results would round twice.
+  return nullptr;
+#endif
+}
+
+static const char *swift_parseDecimalFast(const char *nptr, double *outResult) {
+  return parseDecimalFastImpl<double, uint64_t(1) << 53, 22>(nptr, outResult);
+}
+
+static const char *swift_parseDecimalFast(const char *nptr, float *outResult) {
+  return parseDecimalFastImpl<float, uint64_t(1) << 24, 10>(nptr, outResult);
+}
+
+static const char *swift_parseDecimalFast(const char *nptr,
+                                          long double *outResult) {
+  return nullptr;
+}
+
 #if defined(__CYGWIN__) || defined(_WIN32)
 // Cygwin does not support uselocale(), but we can use the locale feature 
 // in stringstream object.
 template <typename T>
 static const char *_swift_stdlib_strtoX_clocale_impl(
     const char *nptr, T *outResult) {
+  if (const char *EndPtr = swift_parseDecimalFast(nptr, outResult))
+    return EndPtr;
+
   std::istringstream ValueStream(nptr);
   ValueStream.imbue(std::locale::classic());
   T ParsedValue;
@@ -481,6 +964,9 @@ static const char *_swift_stdlib_strtoX_clocale_impl(
     const char * nptr, T* outResult, T huge,
     T (*posixImpl)(const char *, char **, locale_t)
 ) {
+  if (const char *EndPtr = swift_parseDecimalFast(nptr, outResult))
+    return EndPtr;
+
   char *EndPtr;
   errno = 0;
   const auto result = posixImpl(nptr, &EndPtr, getCLocale());
@@ -112,6 +112,30 @@ private:
   ASCIICollation(const ASCIICollation &) = delete;
 };
 
+/// Returns the number of leading code units of the two strings which can be
+/// dropped before comparing them, or -1 if the strings are identical ASCII.
+///
+/// Every ASCII character has a single collation element which doesn't depend
+/// on the characters before it (the ASCII collation table relies on this
+/// too), so a common ASCII prefix contributes the same weights to both
+/// strings at every level and doesn't affect the result. The last character
+/// of the prefix isn't dropped, because a combining mark or contraction
+/// following it can change its collation elements.
+template <typename LeftCodeUnit, typename RightCodeUnit>
+static int32_t skippableASCIIPrefix(const LeftCodeUnit *LeftString,
+                                    int32_t LeftLength,
+                                    const RightCodeUnit *RightString,
+                                    int32_t RightLength) {
+  int32_t MinLength = std::min(LeftLength, RightLength);
+  int32_t i = 0;
+  while (i < MinLength && LeftString[i] < 0x80 &&
+         LeftString[i] == RightString[i])
+    ++i;
+  if (i == LeftLength && i == RightLength)
+    return -1;
+  return i == 0 ? 0 : i - 1;
+}
+
 /// Compares the strings via the Unicode Collation Algorithm on the root locale.
 /// Results are the usual string comparison results:
 ///  <0 the left string is less than the right string.
@@ -122,6 +146,15 @@ swift::_swift_stdlib_unicode_compare_utf16_utf16(const uint16_t *LeftString,
                                                  int32_t LeftLength,
                                                  const uint16_t *RightString,
                                                  int32_t RightLength) {
+  int32_t Prefix = skippableASCIIPrefix(LeftString, LeftLength,
+                                        RightString, RightLength);
+  if (Prefix < 0)
+    return 0;
+  LeftString += Prefix;
+  LeftLength -= Prefix;
+  RightString += Prefix;
+  RightLength -= Prefix;
+
 #if defined(__CYGWIN__) || defined(_MSC_VER)
   // ICU UChar type is platform dependent. In Cygwin, it is defined
   // as wchar_t which size is 2. It seems that the underlying binary
@@ -146,6 +179,15 @@ swift::_swift_stdlib_unicode_compare_utf8_utf16(const unsigned char *LeftString,
                                                 int32_t LeftLength,
                                                 const uint16_t *RightString,
                                                 int32_t RightLength) {
+  int32_t Prefix = skippableASCIIPrefix(LeftString, LeftLength,
+                                        RightString, RightLength);
+  if (Prefix < 0)
+    return 0;
+  LeftString += Prefix;
+  LeftLength -= Prefix;
+  RightString += Prefix;
+  RightLength -= Prefix;
+
   UCharIterator LeftIterator;
   UCharIterator RightIterator;
   UErrorCode ErrorCode = U_ZERO_ERROR;
@@ -176,6 +218,15 @@ swift::_swift_stdlib_unicode_compare_utf8_utf8(const unsigned char *LeftString,
                                                int32_t LeftLength,
                                                const unsigned char *RightString,
                                                int32_t RightLength) {
+  int32_t Prefix = skippableASCIIPrefix(LeftString, LeftLength,
+                                        RightString, RightLength);
+  if (Prefix < 0)
+    return 0;
+  LeftString += Prefix;
+  LeftLength -= Prefix;
+  RightString += Prefix;
+  RightLength -= Prefix;
+
   UCharIterator LeftIterator;
   UCharIterator RightIterator;
   UErrorCode ErrorCode = U_ZERO_ERROR;
@@ -0,0 +1,332 @@
+//===--- UnicodeTranscoding.cpp - Vectorized UTF-8/UTF-16 transcoding -----===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Fast paths for validating and transcoding the contiguous storage of strings.
+// Runs of ASCII code units are processed 16 at a time, with SSE2 or NEON where
+// available; everything else is handled one scalar at a time. Ill-formed
+// UTF-8 is only detected here: repairing it is left to the generic codecs in
+// the standard library.
+//
+//===----------------------------------------------------------------------===//
+
+#include <string.h>
+#include "../SwiftShims/UnicodeShims.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SWIFT_STDLIB_UNICODE_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define SWIFT_STDLIB_UNICODE_NEON 1
+#endif
+
+using namespace swift;
+
+/// The number of code units processed by one vector step.
+static const __swift_intptr_t ChunkSize = 16;
+
+/// Returns true if all 16 bytes at `Source` are ASCII.
+static inline bool isASCIIChunk(const __swift_uint8_t *Source) {
+#if defined(SWIFT_STDLIB_UNICODE_SSE2)
+  __m128i V = _mm_loadu_si128(reinterpret_cast<const __m128i *>(Source));
+  return _mm_movemask_epi8(V) == 0;
+#elif defined(SWIFT_STDLIB_UNICODE_NEON)
+  return vmaxvq_u8(vld1q_u8(Source)) < 0x80;
+#else
+  __swift_uint64_t Words[2];
+  memcpy(Words, Source, sizeof(Words));
+  return ((Words[0] | Words[1]) & 0x8080808080808080ULL) == 0;
+#endif
+}
+
+/// Returns true if all 16 UTF-16 code units at `Source` are ASCII.
+static inline bool isASCIIChunk(const __swift_uint16_t *Source) {
+#if defined(SWIFT_STDLIB_UNICODE_SSE2)
+  auto *P = reinterpret_cast<const __m128i *>(Source);
+  __m128i V = _mm_or_si128(_mm_loadu_si128(P), _mm_loadu_si128(P + 1));
+  __m128i High = _mm_and_si128(V, _mm_set1_epi16(static_cast<short>(0xFF80)));
+  return _mm_movemask_epi8(_mm_cmpeq_epi16(High, _mm_setzero_si128()))
+    == 0xFFFF;
+#elif defined(SWIFT_STDLIB_UNICODE_NEON)
+  uint16x8_t V = vorrq_u16(vld1q_u16(Source), vld1q_u16(Source + 8));
+  return vmaxvq_u16(V) < 0x80;
+#else
+  __swift_uint64_t Words[4];
+  memcpy(Words, Source, sizeof(Words));
+  return ((Words[0] | Words[1] | Words[2] | Words[3]) &
+          0xFF80FF80FF80FF80ULL) == 0;
+#endif
+}
+
+/// Zero-extends 16 bytes at `Source` into 16 UTF-16 code units.
+static inline void widenChunk(__swift_uint16_t *Destination,
+                              const __swift_uint8_t *Source) {
+#if defined(SWIFT_STDLIB_UNICODE_SSE2)
+  __m128i V = _mm_loadu_si128(reinterpret_cast<const __m128i *>(Source));
+  __m128i Zero = _mm_setzero_si128();
+  auto *D = reinterpret_cast<__m128i *>(Destination);
+  _mm_storeu_si128(D, _mm_unpacklo_epi8(V, Zero));
+  _mm_storeu_si128(D + 1, _mm_unpackhi_epi8(V, Zero));
+#elif defined(SWIFT_STDLIB_UNICODE_NEON)
+  uint8x16_t V = vld1q_u8(Source);
+  vst1q_u16(Destination, vmovl_u8(vget_low_u8(V)));
+  vst1q_u16(Destination + 8, vmovl_high_u8(V));
+#else
+  for (__swift_intptr_t i = 0; i < ChunkSize; ++i)
+    Destination[i] = Source[i];
+#endif
+}
+
+/// Truncates 16 ASCII UTF-16 code units at `Source` into bytes.
+static inline void narrowChunk(__swift_uint8_t *Destination,
+                               const __swift_uint16_t *Source) {
+#if defined(SWIFT_STDLIB_UNICODE_SSE2)
+  auto *P = reinterpret_cast<const __m128i *>(Source);
+  __m128i V = _mm_packus_epi16(_mm_loadu_si128(P), _mm_loadu_si128(P + 1));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(Destination), V);
+#elif defined(SWIFT_STDLIB_UNICODE_NEON)
+  vst1q_u8(Destination, vcombine_u8(vmovn_u16(vld1q_u16(Source)),
+                                    vmovn_u16(vld1q_u16(Source + 8))));
+#else
+  for (__swift_intptr_t i = 0; i < ChunkSize; ++i)
+    Destination[i] = static_cast<__swift_uint8_t>(Source[i]);
+#endif
+}
+
+template <typename CodeUnit>
+static __swift_intptr_t countLeadingASCII(const CodeUnit *Source,
+                                          __swift_intptr_t Length) {
+  __swift_intptr_t i = 0;
+  while (i + ChunkSize <= Length && isASCIIChunk(Source + i))
+    i += ChunkSize;
+  while (i < Length && Source[i] < 0x80)
+    ++i;
+  return i;
+}
+
+/// Returns the length of the well-formed UTF-8 sequence starting at `Source`,
+/// or 0 if it is ill-formed, according to table 3-7 of the Unicode standard.
+static inline __swift_intptr_t
+getWellFormedSequenceLength(const __swift_uint8_t *Source,
+                            __swift_intptr_t Remaining) {
+  __swift_uint8_t Lead = Source[0];
+  if (Lead < 0x80)
+    return 1;
+  auto isContinuation = [](__swift_uint8_t Byte) {
+    return (Byte & 0xC0) == 0x80;
+  };
+  if (Lead < 0xC2)
+    return 0;
+  if (Lead < 0xE0) {
+    return Remaining >= 2 && isContinuation(Source[1]) ? 2 : 0;
+  }
+  if (Lead < 0xF0) {
+    if (Remaining < 3)
+      return 0;
+    __swift_uint8_t Second = Source[1];
+    if ((Lead == 0xE0 && Second < 0xA0) || (Lead == 0xED && Second > 0x9F))
+      return 0;
+    return isContinuation(Second) && isContinuation(Source[2]) ? 3 : 0;
+  }
+  if (Lead < 0xF5) {
+    if (Remaining < 4)
+      return 0;
+    __swift_uint8_t Second = Source[1];
+    if ((Lead == 0xF0 && Second < 0x90) || (Lead == 0xF4 && Second > 0x8F))
+      return 0;
+    return isContinuation(Second) && isContinuation(Source[2]) &&
+      isContinuation(Source[3]) ? 4 : 0;
+  }
+  return 0;
+}
+
+SWIFT_RUNTIME_STDLIB_INTERFACE
+__swift_intptr_t
+swift::_swift_stdlib_utf8_countLeadingASCII(const __swift_uint8_t *Source,
+                                            __swift_intptr_t SourceLength) {
+  return countLeadingASCII(Source, SourceLength);
+}
+
+SWIFT_RUNTIME_STDLIB_INTERFACE
+__swift_intptr_t
+swift::_swift_stdlib_utf16_countLeadingASCII(const __swift_uint16_t *Source,
+                                             __swift_intptr_t SourceLength) {
+  return countLeadingASCII(Source, SourceLength);
+}
+
+SWIFT_RUNTIME_STDLIB_INTERFACE
+void swift::_swift_stdlib_widenASCII(__swift_uint16_t *Destination,
+                                     const __swift_uint8_t *Source,
+                                     __swift_intptr_t Count) {
+  __swift_intptr_t i = 0;
+  for (; i + ChunkSize <= Count; i += ChunkSize)
+    widenChunk(Destination + i, Source + i);
+  for (; i < Count; ++i)
+    Destination[i] = Source[i];
+}
+
+SWIFT_RUNTIME_STDLIB_INTERFACE
+void swift::_swift_stdlib_narrowASCII(__swift_uint8_t *Destination,
+                                      const __swift_uint16_t *Source,
+                                      __swift_intptr_t Count) {
+  __swift_intptr_t i = 0;
+  for (; i + ChunkSize <= Count; i += ChunkSize)
+    narrowChunk(Destination + i, Source + i);
+  for (; i < Count; ++i)
+    Destination[i] = static_cast<__swift_uint8_t>(Source[i]);
+}
+
+SWIFT_RUNTIME_STDLIB_INTERFACE
+__swift_intptr_t
+swift::_swift_stdlib_utf8_validatedUTF16Length(const __swift_uint8_t *Source,
+                                               __swift_intptr_t SourceLength,
+                                               __swift_bool *IsASCII) {
+  __swift_intptr_t i = countLeadingASCII(Source, SourceLength);
+  __swift_intptr_t UTF16Length = i;
+  *IsASCII = i == SourceLength;
+
+  while (i < SourceLength) {
+    if (i + ChunkSize <= SourceLength && isASCIIChunk(Source + i)) {
+      i += ChunkSize;
+      UTF16Length += ChunkSize;
+      continue;
+    }
+    __swift_intptr_t Length =
+      getWellFormedSequenceLength(Source + i, SourceLength - i);
+    if (Length == 0)
+      return -1;
+    i += Length;
+    // Only scalars outside of the BMP need a surrogate pair.
+    UTF16Length += Length == 4 ? 2 : 1;
+  }
+  return UTF16Length;
+}
+
+SWIFT_RUNTIME_STDLIB_INTERFACE
+__swift_intptr_t
+swift::_swift_stdlib_utf8_transcodeToUTF16(__swift_uint16_t *Destination,
+                                           const __swift_uint8_t *Source,
+                                           __swift_intptr_t SourceLength) {
+  __swift_uint16_t *D = Destination;
+  __swift_intptr_t i = 0;
+  while (i < SourceLength) {
+    if (i + ChunkSize <= SourceLength && isASCIIChunk(Source + i)) {
+      widenChunk(D, Source + i);
+      i += ChunkSize;
+      D += ChunkSize;
+      continue;
+    }
+    __swift_uint32_t Lead = Source[i];
+    if (Lead < 0x80) {
+      *D++ = static_cast<__swift_uint16_t>(Lead);
+      i += 1;
+    } else if (Lead < 0xE0) {
+      *D++ = static_cast<__swift_uint16_t>(((Lead & 0x1F) << 6) |
+                                           (Source[i + 1] & 0x3F));
+      i += 2;
+    } else if (Lead < 0xF0) {
+      *D++ = static_cast<__swift_uint16_t>(((Lead & 0x0F) << 12) |
+                                           ((Source[i + 1] & 0x3F) << 6) |
+                                           (Source[i + 2] & 0x3F));
+      i += 3;
+    } else {
+      __swift_uint32_t Scalar = ((Lead & 0x07) << 18) |
+                                ((Source[i + 1] & 0x3F) << 12) |
+                                ((Source[i + 2] & 0x3F) << 6) |
+                                (Source[i + 3] & 0x3F);
+      Scalar -= 0x10000;
+      *D++ = static_cast<__swift_uint16_t>(0xD800 + (Scalar >> 10));
+      *D++ = static_cast<__swift_uint16_t>(0xDC00 + (Scalar & 0x3FF));
+      i += 4;
+    }
+  }
+  return D - Destination;
+}
+
+static inline bool isLeadSurrogate(__swift_uint16_t CodeUnit) {
+  return (CodeUnit & 0xFC00) == 0xD800;
+}
+
+static inline bool isTrailSurrogate(__swift_uint16_t CodeUnit) {
+  return (CodeUnit & 0xFC00) == 0xDC00;
+}
+
+SWIFT_RUNTIME_STDLIB_INTERFACE
+__swift_intptr_t
+swift::_swift_stdlib_utf16_utf8Length(const __swift_uint16_t *Source,
+                                      __swift_intptr_t SourceLength) {
+  __swift_intptr_t UTF8Length = 0;
+  __swift_intptr_t i = 0;
+  while (i < SourceLength) {
+    if (i + ChunkSize <= SourceLength && isASCIIChunk(Source + i)) {
+      i += ChunkSize;
+      UTF8Length += ChunkSize;
+      continue;
+    }
+    __swift_uint16_t CodeUnit = Source[i++];
+    if (CodeUnit < 0x80) {
+      UTF8Length += 1;
+    } else if (CodeUnit < 0x800) {
+      UTF8Length += 2;
+    } else if (isLeadSurrogate(CodeUnit) && i < SourceLength &&
+               isTrailSurrogate(Source[i])) {
+      ++i;
+      UTF8Length += 4;
+    } else {
+      // Includes U+FFFD for unpaired surrogates.
+      UTF8Length += 3;
+    }
+  }
+  return UTF8Length;
+}
+
+SWIFT_RUNTIME_STDLIB_INTERFACE
+__swift_intptr_t
+swift::_swift_stdlib_utf16_transcodeToUTF8(__swift_uint8_t *Destination,
+                                           const __swift_uint16_t *Source,
+                                           __swift_intptr_t SourceLength) {
+  __swift_uint8_t *D = Destination;
+  __swift_intptr_t i = 0;
+  while (i < SourceLength) {
+    if (i + ChunkSize <= SourceLength && isASCIIChunk(Source + i)) {
+      narrowChunk(D, Source + i);
+      i += ChunkSize;
+      D += ChunkSize;
+      continue;
+    }
+    __swift_uint32_t Scalar = Source[i++];
+    if (Scalar < 0x80) {
+      *D++ = static_cast<__swift_uint8_t>(Scalar);
+      continue;
+    }
+    if (Scalar < 0x800) {
+      *D++ = static_cast<__swift_uint8_t>(0xC0 | (Scalar >> 6));
+      *D++ = static_cast<__swift_uint8_t>(0x80 | (Scalar & 0x3F));
+      continue;
+    }
+    if (isLeadSurrogate(Scalar) && i < SourceLength &&
+        isTrailSurrogate(Source[i])) {
+      Scalar = 0x10000 + ((Scalar - 0xD800) << 10) + (Source[i++] - 0xDC00);
+      *D++ = static_cast<__swift_uint8_t>(0xF0 | (Scalar >> 18));
+      *D++ = static_cast<__swift_uint8_t>(0x80 | ((Scalar >> 12) & 0x3F));
+      *D++ = static_cast<__swift_uint8_t>(0x80 | ((Scalar >> 6) & 0x3F));
+      *D++ = static_cast<__swift_uint8_t>(0x80 | (Scalar & 0x3F));
+      continue;
+    }
+    if (isLeadSurrogate(Scalar) || isTrailSurrogate(Scalar))
+      Scalar = 0xFFFD;
+    *D++ = static_cast<__swift_uint8_t>(0xE0 | (Scalar >> 12));
+    *D++ = static_cast<__swift_uint8_t>(0x80 | ((Scalar >> 6) & 0x3F));
+    *D++ = static_cast<__swift_uint8_t>(0x80 | (Scalar & 0x3F));
+  }
+  return D - Destination;
+}
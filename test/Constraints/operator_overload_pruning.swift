@@ -0,0 +1,36 @@
+// RUN: %target-typecheck-verify-swift
+
+// Overloads whose concrete parameter types cannot accept concrete operands
+// are dropped before solving; make sure the remaining ones still resolve.
+struct Meters {}
+struct Feet {}
+enum Unit { case metric, imperial }
+
+func +(lhs: Meters, rhs: Meters) -> Meters { return lhs }
+func +(lhs: Feet, rhs: Feet) -> Feet { return lhs }
+func +(lhs: Meters, rhs: Feet) -> Meters { return lhs }
+func +(lhs: Unit, rhs: Unit) -> Unit { return lhs }
+
+func testConcreteOperands(m: Meters, f: Feet, u: Unit) {
+  let _: Meters = m + m
+  let _: Feet = f + f
+  let _: Meters = m + f
+  let _: Unit = u + u
+  let _: Unit = u + .metric
+  let _: Meters = m + m + f + f
+}
+
+// Structs still convert implicitly to AnyHashable.
+func ==(lhs: AnyHashable, rhs: Meters) -> Bool { return true }
+
+func testAnyHashable(m: Meters, i: Int) {
+  _ = i == m
+}
+
+// Generic overloads are never pruned.
+func +<T>(lhs: T, rhs: Meters) -> T { return lhs }
+
+func testGeneric(i: Int, f: Feet, m: Meters) {
+  let _: Int = i + m
+  let _: Feet = f + m
+}
@@ -0,0 +1,8 @@
+public struct Other {
+  var otherField: Int64
+}
+
+public enum OtherEnum {
+  case otherCase(Int64)
+  case otherNone
+}
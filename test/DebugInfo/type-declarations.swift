@@ -0,0 +1,34 @@
+// RUN: %target-swift-frontend -primary-file %s %S/Inputs/type-declarations-other.swift -emit-ir -gdwarf-types -o - | %FileCheck %s
+// RUN: %target-swift-frontend -primary-file %s %S/Inputs/type-declarations-other.swift -emit-ir -gdwarf-types -o - | %FileCheck %s --check-prefix=NOMEMBERS
+// RUN: %target-swift-frontend %s %S/Inputs/type-declarations-other.swift -emit-ir -gdwarf-types -o - | %FileCheck %s --check-prefix=WMO
+
+// Types of this module are only described in full by the file that declares
+// them, whether or not that file uses them. The other files of the module
+// only declare them by their mangled name. Types of other modules are always
+// described in full.
+
+// CHECK-DAG: !DICompositeType(tag: DW_TAG_structure_type, name: "Local",{{.*}} elements: ![[LOCALELTS:[0-9]+]]
+// CHECK-DAG: ![[LOCALELTS]] = !{![[LOCALFIELD:[0-9]+]]}
+// CHECK-DAG: ![[LOCALFIELD]] = !DIDerivedType(tag: DW_TAG_member, name: "localField"
+// CHECK-DAG: !DIDerivedType(tag: DW_TAG_member, name: "unusedField"
+// CHECK-DAG: !DICompositeType(tag: DW_TAG_structure_type, name: "Other",{{.*}} flags: DIFlagFwdDecl
+// CHECK-DAG: !DICompositeType(tag: DW_TAG_structure_type, name: "OtherEnum",{{.*}} flags: DIFlagFwdDecl
+// CHECK-DAG: !DIDerivedType(tag: DW_TAG_member, name: "_value"
+
+// NOMEMBERS-NOT: name: "otherField"
+// NOMEMBERS-NOT: name: "otherCase"
+
+// WMO-DAG: !DIDerivedType(tag: DW_TAG_member, name: "localField"
+// WMO-DAG: !DIDerivedType(tag: DW_TAG_member, name: "unusedField"
+// WMO-DAG: !DIDerivedType(tag: DW_TAG_member, name: "otherField"
+// WMO-DAG: !DIDerivedType(tag: DW_TAG_member, name: "otherCase"
+
+public struct Local {
+  var localField: Int32
+}
+
+struct Unused {
+  var unusedField: Int8
+}
+
+public func use(_ l: Local, _ o: Other, _ e: OtherEnum) {}
@@ -9,6 +9,10 @@ RUN: sed -ne '/--->/s/^.*---> *//p' < %S/Inputs/manglings.txt > %t.check
 RUN: swift-demangle < %t.input > %t.output
 RUN: diff %t.check %t.output
 
+The output of a multi-threaded run is in the order of the input.
+RUN: swift-demangle -num-threads=4 < %t.input > %t.threads.output
+RUN: diff %t.check %t.threads.output
+
 ; RUN: swift-demangle __TtSi | %FileCheck %s -check-prefix=DOUBLE
 ; DOUBLE: _TtSi ---> Swift.Int
 
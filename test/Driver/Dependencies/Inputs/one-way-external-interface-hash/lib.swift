@@ -0,0 +1,3 @@
+public struct S {}
+
+public func f() {}
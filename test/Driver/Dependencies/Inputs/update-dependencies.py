@@ -55,6 +55,13 @@ outputFile = sys.argv[sys.argv.index('-o') + 1]
 with open(outputFile, 'a'):
     os.utime(outputFile, None)
 
+# Like the real frontend, leave the module and its documentation untouched
+# when they don't change.
+for flag in ['-emit-module-path', '-emit-module-doc-path']:
+    if flag in sys.argv:
+        with open(sys.argv[sys.argv.index(flag) + 1], 'a'):
+            pass
+
 if primaryFile:
     print("Handled", os.path.basename(primaryFile))
 else:
@@ -0,0 +1,34 @@
+// RUN: rm -rf %t && cp -r %S/Inputs/one-way/ %t
+// RUN: touch -t 201401240005 %t/*
+
+// The build record remembers how much memory each compile job used.
+
+// RUN: cd %t && %swiftc_driver -c -driver-use-frontend-path %S/Inputs/update-dependencies.py -output-file-map %t/output.json -incremental ./main.swift ./other.swift -module-name main -j2
+// RUN: %FileCheck -check-prefix=CHECK-RECORD %s < %t/main~buildrecord.swiftdeps
+
+// CHECK-RECORD: job_times:
+// CHECK-RECORD: job_memory:
+// CHECK-RECORD-DAG: "./main.swift": {{[0-9]+$}}
+// CHECK-RECORD-DAG: "./other.swift": {{[0-9]+$}}
+
+// Without a memory limit, both jobs start right away...
+
+// RUN: echo '{version: "bogus", inputs: {}, job_memory: {"./main.swift": 600000000, "./other.swift": 600000000}}' > %t/main~buildrecord.swiftdeps
+// RUN: cd %t && %swiftc_driver -c -driver-use-frontend-path %S/Inputs/update-dependencies.py -output-file-map %t/output.json -incremental ./main.swift ./other.swift -module-name main -j2 -parseable-output 2>&1 | %FileCheck -check-prefix=CHECK-UNLIMITED %s
+
+// CHECK-UNLIMITED: "kind": "began"
+// CHECK-UNLIMITED-NOT: "kind": "finished"
+// CHECK-UNLIMITED: "kind": "began"
+
+// ...but if they don't fit into the limit together, one waits for the other.
+
+// RUN: echo '{version: "bogus", inputs: {}, job_memory: {"./main.swift": 600000000, "./other.swift": 600000000}}' > %t/main~buildrecord.swiftdeps
+// RUN: cd %t && %swiftc_driver -c -driver-use-frontend-path %S/Inputs/update-dependencies.py -output-file-map %t/output.json -incremental ./main.swift ./other.swift -module-name main -j2 -job-memory-limit 1000 -parseable-output 2>&1 | %FileCheck -check-prefix=CHECK-LIMITED %s
+
+// CHECK-LIMITED: "kind": "began"
+// CHECK-LIMITED: "kind": "finished"
+// CHECK-LIMITED: "kind": "began"
+// CHECK-LIMITED: "kind": "finished"
+
+// RUN: not %swiftc_driver -c ./main.swift -job-memory-limit lots 2>&1 | %FileCheck -check-prefix=CHECK-INVALID %s
+// CHECK-INVALID: error: invalid value 'lots' in '-job-memory-limit lots'
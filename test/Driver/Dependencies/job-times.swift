@@ -0,0 +1,28 @@
+// RUN: rm -rf %t && cp -r %S/Inputs/one-way/ %t
+// RUN: touch -t 201401240005 %t/*
+
+// The build record remembers how long each compile job took.
+
+// RUN: cd %t && %swiftc_driver -c -driver-use-frontend-path %S/Inputs/update-dependencies.py -output-file-map %t/output.json -incremental ./main.swift ./other.swift -module-name main -j2
+// RUN: %FileCheck -check-prefix=CHECK-RECORD %s < %t/main~buildrecord.swiftdeps
+
+// CHECK-RECORD: inputs:
+// CHECK-RECORD: job_times:
+// CHECK-RECORD-DAG: "./main.swift": {{[0-9]+\.[0-9]+$}}
+// CHECK-RECORD-DAG: "./other.swift": {{[0-9]+\.[0-9]+$}}
+
+// With several jobs at a time, the slowest ones start first.
+
+// RUN: echo '{version: "bogus", inputs: {}, job_times: {"./main.swift": 1.0, "./other.swift": 10.0}}' > %t/main~buildrecord.swiftdeps
+// RUN: cd %t && %swiftc_driver -c -driver-use-frontend-path %S/Inputs/update-dependencies.py -output-file-map %t/output.json -incremental ./main.swift ./other.swift -module-name main -j2 -v 2>&1 | %FileCheck -check-prefix=CHECK-PARALLEL %s
+
+// CHECK-PARALLEL: -primary-file ./other.swift
+// CHECK-PARALLEL: -primary-file ./main.swift
+
+// ...but one at a time, they run in order.
+
+// RUN: echo '{version: "bogus", inputs: {}, job_times: {"./main.swift": 1.0, "./other.swift": 10.0}}' > %t/main~buildrecord.swiftdeps
+// RUN: cd %t && %swiftc_driver -c -driver-use-frontend-path %S/Inputs/update-dependencies.py -output-file-map %t/output.json -incremental ./main.swift ./other.swift -module-name main -j1 -v 2>&1 | %FileCheck -check-prefix=CHECK-SERIAL %s
+
+// CHECK-SERIAL: -primary-file ./main.swift
+// CHECK-SERIAL: -primary-file ./other.swift
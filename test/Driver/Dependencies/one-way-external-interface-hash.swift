@@ -0,0 +1,36 @@
+/// "./Lib.swiftmodule" ==> main
+/// other ==> main
+
+// RUN: rm -rf %t && cp -r %S/Inputs/one-way-external-interface-hash/ %t
+// RUN: %target-swift-frontend -emit-module -parse-stdlib -module-name Lib -o %t/Lib.swiftmodule %t/lib.swift
+// RUN: touch -t 201401240005 %t/*
+
+// RUN: cd %t && %swiftc_driver -c -driver-use-frontend-path %S/Inputs/update-dependencies.py -output-file-map %t/output.json -incremental ./main.swift ./other.swift -module-name main -j1 -v 2>&1 | %FileCheck -check-prefix=CHECK-FIRST %s
+// RUN: %FileCheck -check-prefix=CHECK-RECORD %s < %t/main~buildrecord.swiftdeps
+
+// CHECK-FIRST-NOT: warning
+// CHECK-FIRST: Handled main.swift
+// CHECK-FIRST: Handled other.swift
+
+// CHECK-RECORD: external_interface_hashes:
+// CHECK-RECORD-NEXT: "./Lib.swiftmodule": "{{[0-9a-f]+}}"
+
+// Changing a function body rebuilds the module without changing its
+// interface.
+// RUN: %target-swift-frontend -emit-module -parse-stdlib -module-name Lib -o %t/Lib.swiftmodule %t/lib-body-changed.swift
+// RUN: touch -t 201401240005 %t/*.swift
+// RUN: touch -t 201401240006 %t/*.o
+// RUN: touch -t 203704010005 %t/Lib.swiftmodule
+// RUN: cd %t && %swiftc_driver -c -driver-use-frontend-path %S/Inputs/update-dependencies.py -output-file-map %t/output.json -incremental ./main.swift ./other.swift -module-name main -j1 -v 2>&1 | %FileCheck -check-prefix=CHECK-SECOND %s
+
+// CHECK-SECOND-NOT: Handled
+
+// RUN: %target-swift-frontend -emit-module -parse-stdlib -module-name Lib -o %t/Lib.swiftmodule %t/lib-interface-changed.swift
+// RUN: touch -t 201401240005 %t/*.swift
+// RUN: touch -t 201401240006 %t/*.o
+// RUN: touch -t 203704010005 %t/Lib.swiftmodule
+// RUN: cd %t && %swiftc_driver -c -driver-use-frontend-path %S/Inputs/update-dependencies.py -output-file-map %t/output.json -incremental ./main.swift ./other.swift -module-name main -j1 -v 2>&1 | %FileCheck -check-prefix=CHECK-THIRD %s
+
+// CHECK-THIRD-NOT: Handled other.swift
+// CHECK-THIRD: Handled main.swift
+// CHECK-THIRD-NOT: Handled other.swift
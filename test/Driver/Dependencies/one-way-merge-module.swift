@@ -10,8 +10,27 @@
 // CHECK-FIRST: Handled other.swift
 // CHECK-FIRST: Produced master.swiftmodule
 
+// RUN: touch -t 201401240006 %t/main.swiftmodule %t/main.swiftdoc %t/master.swiftmodule %t/master.swiftdoc
+
 // RUN: cd %t && %swiftc_driver -driver-use-frontend-path %S/Inputs/update-dependencies.py -output-file-map %t/output.json -incremental -driver-always-rebuild-dependents ./main.swift ./other.swift -emit-module-path %t/master.swiftmodule -module-name main -j1 -v 2>&1 | %FileCheck -check-prefix=CHECK-SECOND %s
 
 // CHECK-SECOND-NOT: warning
 // CHECK-SECOND-NOT: Handled
 // CHECK-SECOND: Produced master.swiftmodule
+
+// Once the merged module is newer than the partial modules, it isn't merged
+// again until one of them changes.
+
+// RUN: touch -t 201401240005 %t/main.swiftmodule %t/main.swiftdoc
+// RUN: touch -t 201401240006 %t/master.swiftmodule %t/master.swiftdoc
+// RUN: cd %t && %swiftc_driver -driver-use-frontend-path %S/Inputs/update-dependencies.py -output-file-map %t/output.json -incremental -driver-always-rebuild-dependents ./main.swift ./other.swift -emit-module-path %t/master.swiftmodule -module-name main -j1 -parseable-output 2>&1 | %FileCheck -check-prefix=CHECK-THIRD %s
+
+// CHECK-THIRD-NOT: "kind": "began"
+// CHECK-THIRD: "name": "merge-module"
+// CHECK-THIRD-NOT: "kind": "began"
+
+// RUN: touch -t 201401240007 %t/main.swiftmodule
+// RUN: cd %t && %swiftc_driver -driver-use-frontend-path %S/Inputs/update-dependencies.py -output-file-map %t/output.json -incremental -driver-always-rebuild-dependents ./main.swift ./other.swift -emit-module-path %t/master.swiftmodule -module-name main -j1 -v 2>&1 | %FileCheck -check-prefix=CHECK-FOURTH %s
+
+// CHECK-FOURTH-NOT: Handled
+// CHECK-FOURTH: Produced master.swiftmodule
@@ -0,0 +1,26 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: touch %t/file-01.swift %t/file-02.swift %t/file-03.swift %t/file-04.swift %t/file-05.swift
+
+// RUN: %swiftc_driver -driver-print-bindings -target x86_64-apple-macosx10.9 -enable-batch-mode -j 2 -c %t/file-01.swift %t/file-02.swift %t/file-03.swift %t/file-04.swift %t/file-05.swift 2>&1 | %FileCheck %s -check-prefix=BINDINGS
+// BINDINGS: # "x86_64-apple-macosx10.9" - "swift", inputs: ["{{.*}}file-01.swift", "{{.*}}file-02.swift", "{{.*}}file-03.swift"], output: {object: "file-01.o", object: "file-02.o", object: "file-03.o"}
+// BINDINGS: # "x86_64-apple-macosx10.9" - "swift", inputs: ["{{.*}}file-04.swift", "{{.*}}file-05.swift"], output: {object: "file-04.o", object: "file-05.o"}
+
+// RUN: %swiftc_driver -driver-print-jobs -target x86_64-apple-macosx10.9 -enable-batch-mode -driver-batch-count 2 -c %t/file-01.swift %t/file-02.swift %t/file-03.swift %t/file-04.swift %t/file-05.swift 2>&1 | %FileCheck %s -check-prefix=JOBS
+// JOBS: bin/swift{{c?}} -frontend -c -primary-file {{.*}}file-01.swift -primary-file {{.*}}file-02.swift -primary-file {{.*}}file-03.swift {{.*}}file-04.swift {{.*}}file-05.swift {{.*}} -o file-01.o -o file-02.o -o file-03.o
+// JOBS: bin/swift{{c?}} -frontend -c {{.*}}file-01.swift {{.*}}file-02.swift {{.*}}file-03.swift -primary-file {{.*}}file-04.swift -primary-file {{.*}}file-05.swift {{.*}} -o file-04.o -o file-05.o
+
+// RUN: %swiftc_driver -driver-print-jobs -target x86_64-apple-macosx10.9 -enable-batch-mode -driver-batch-count 2 -driver-use-filelists -c %t/file-01.swift %t/file-02.swift %t/file-03.swift 2>&1 | %FileCheck %s -check-prefix=FILELISTS
+// FILELISTS: bin/swift{{c?}} -frontend -c -filelist {{[^ ]+}} -primary-file {{.*}}file-01.swift -primary-file {{.*}}file-02.swift {{.*}} -output-filelist
+// FILELISTS: bin/swift{{c?}} -frontend -c -filelist {{[^ ]+}} -primary-file {{.*}}file-03.swift {{.*}} -output-filelist
+
+// RUN: %swiftc_driver -driver-print-bindings -target x86_64-apple-macosx10.9 -enable-batch-mode -disable-batch-mode -c %t/file-01.swift %t/file-02.swift 2>&1 | %FileCheck %s -check-prefix=DISABLED
+// DISABLED: # "x86_64-apple-macosx10.9" - "swift", inputs: ["{{.*}}file-01.swift"], output: {object: "file-01.o"}
+// DISABLED: # "x86_64-apple-macosx10.9" - "swift", inputs: ["{{.*}}file-02.swift"], output: {object: "file-02.o"}
+
+// RUN: %swiftc_driver -driver-print-bindings -target x86_64-apple-macosx10.9 -enable-batch-mode -emit-module -c %t/file-01.swift %t/file-02.swift 2>&1 | %FileCheck %s -check-prefix=MODULE
+// MODULE: warning: ignoring -enable-batch-mode (not compatible with '-emit-module')
+// MODULE: # "x86_64-apple-macosx10.9" - "swift", inputs: ["{{.*}}file-01.swift"], output: {object: "file-01.o", swiftmodule:
+// MODULE: # "x86_64-apple-macosx10.9" - "swift", inputs: ["{{.*}}file-02.swift"], output: {object: "file-02.o", swiftmodule:
+
+// RUN: not %swiftc_driver -driver-print-bindings -target x86_64-apple-macosx10.9 -enable-batch-mode -driver-batch-count 0 -c %t/file-01.swift 2>&1 | %FileCheck %s -check-prefix=BAD-COUNT
+// BAD-COUNT: error: invalid value '0' in '-driver-batch-count 0'
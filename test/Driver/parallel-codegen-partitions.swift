@@ -0,0 +1,43 @@
+// RUN: %target-swiftc_driver -driver-print-jobs -module-name=ThisModule -parallel-codegen-partitions 3 %S/Inputs/main.swift %s -c | %FileCheck -check-prefix=OBJECT %s
+// RUN: env TMPDIR=/tmp %swiftc_driver -driver-print-jobs -module-name=ThisModule -parallel-codegen-partitions 3 %S/Inputs/main.swift %s -o a.out | %FileCheck -check-prefix=EXEC %s
+// RUN: %target-swiftc_driver -driver-print-jobs -module-name=ThisModule -parallel-codegen-partitions 3 %S/Inputs/main.swift %s -S | %FileCheck -check-prefix=ASSEMBLY %s
+// RUN: %target-swiftc_driver -driver-print-jobs -module-name=ThisModule -parallel-codegen-partitions 3 -wmo %S/Inputs/main.swift %s -c | %FileCheck -check-prefix=WMO %s
+// RUN: %target-swiftc_driver -driver-print-jobs -module-name=ThisModule -parallel-codegen-partitions 3 -embed-bitcode %S/Inputs/main.swift %s -c | %FileCheck -check-prefix=BITCODE %s
+
+// OBJECT: -frontend
+// OBJECT-SAME: -primary-file {{[^ ]*}}/Inputs/main.swift
+// OBJECT-SAME: -codegen-partition-output main.part1.o -codegen-partition-output main.part2.o
+// OBJECT-SAME: -o main.o
+// OBJECT: -frontend
+// OBJECT-SAME: -primary-file {{[^ ]*}}/parallel-codegen-partitions.swift
+// OBJECT-SAME: -codegen-partition-output parallel-codegen-partitions.part1.o -codegen-partition-output parallel-codegen-partitions.part2.o
+// OBJECT-SAME: -o parallel-codegen-partitions.o
+// OBJECT-NOT: ld
+
+// EXEC: -frontend
+// EXEC-SAME: -codegen-partition-output /tmp/main{{[^ ]*}}.part1.o -codegen-partition-output /tmp/main{{[^ ]*}}.part2.o
+// EXEC-SAME: -o /tmp/main{{[^ ]*}}.o
+// EXEC: -frontend
+// EXEC-SAME: -codegen-partition-output /tmp/parallel-codegen-partitions{{[^ ]*}}.part1.o -codegen-partition-output /tmp/parallel-codegen-partitions{{[^ ]*}}.part2.o
+// EXEC-SAME: -o /tmp/parallel-codegen-partitions{{[^ ]*}}.o
+// EXEC: {{ld|clang}}
+// EXEC-SAME: /tmp/main{{[^ ]*}}.o /tmp/main{{[^ ]*}}.part1.o /tmp/main{{[^ ]*}}.part2.o /tmp/parallel-codegen-partitions{{[^ ]*}}.o /tmp/parallel-codegen-partitions{{[^ ]*}}.part1.o /tmp/parallel-codegen-partitions{{[^ ]*}}.part2.o
+
+// Only object files are partitioned.
+// ASSEMBLY: -frontend
+// ASSEMBLY-NOT: -codegen-partition-output
+// ASSEMBLY: -o main.s
+
+// Whole module compilation is not partitioned; it has -num-threads instead.
+// WMO: -frontend
+// WMO-NOT: -codegen-partition-output
+// WMO: -o ThisModule.o
+
+// With -embed-bitcode, the backend jobs generate the partitions.
+// BITCODE: -frontend -emit-bc
+// BITCODE-NOT: -codegen-partition-output
+// BITCODE-SAME: -o {{[^ ]*}}main{{[^ ]*}}.bc
+// BITCODE: -frontend -c -primary-file {{[^ ]*}}main{{[^ ]*}}.bc
+// BITCODE-SAME: -o main.o -codegen-partition-output main.part1.o -codegen-partition-output main.part2.o -embed-bitcode
+
+func foo() {}
@@ -19,6 +19,9 @@
 
 // RUN: %swiftc_driver -driver-print-jobs -profile-generate -target x86_64-unknown-linux-gnu %s | %FileCheck -check-prefix=CHECK -check-prefix=LINUX %s
 
+// RUN: %swiftc_driver -driver-print-jobs -profile-use=%t.profdata %s | %FileCheck -check-prefix=USE %s
+// RUN: not %swiftc_driver -driver-print-jobs -profile-generate -profile-use=%t.profdata %s 2>&1 | %FileCheck -check-prefix=CONFLICT %s
+
 // CHECK: swift
 // CHECK: -profile-generate
 
@@ -46,3 +49,8 @@
 // LINUX: clang++{{"? }}
 // LINUX: lib/swift/clang/lib/linux/libclang_rt.profile-x86_64.a
 // LINUX: -u__llvm_profile_runtime
+
+// USE: swift
+// USE: -profile-use={{.*}}.profdata
+
+// CONFLICT: error: conflicting options '-profile-generate' and '-profile-use'
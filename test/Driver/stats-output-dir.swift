@@ -0,0 +1,28 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %target-build-swift -c -module-name main -o %t/main.o -stats-output-dir %t/stats %s
+// RUN: cat %t/stats/*swift-frontend*.json | %FileCheck -check-prefix=FRONTEND %s
+// RUN: cat %t/stats/*swift-driver*.json | %FileCheck -check-prefix=DRIVER %s
+
+// FRONTEND: {
+// FRONTEND-DAG: "AST.NumDeclsDeserialized": {{[1-9][0-9]*}}
+// FRONTEND-DAG: "Frontend.MaxMallocUsage": {{[1-9][0-9]*}}
+// FRONTEND-DAG: "IRModule.NumIRInstructions": {{[1-9][0-9]*}}
+// FRONTEND-DAG: "LLVM.NumLLVMInstructions": {{[1-9][0-9]*}}
+// FRONTEND-DAG: "SILModule.NumSILGenFunctions": {{[1-9][0-9]*}}
+// FRONTEND-DAG: "Sema.NumConstraintScopes": {{[1-9][0-9]*}}
+// FRONTEND-DAG: "Sema.NumFunctionBodiesTypeChecked": 1
+// FRONTEND-DAG: "Time.swift-frontend.Parsing": {{[0-9]+\.[0-9]+}}
+// FRONTEND-DAG: "Time.swift-frontend.Total": {{[0-9]+\.[0-9]+}}
+// FRONTEND: }
+
+// DRIVER: {
+// DRIVER-DAG: "AST.NumDeclsDeserialized": {{[1-9][0-9]*}}
+// DRIVER-DAG: "Driver.NumDriverJobsRun": 1
+// DRIVER-DAG: "Driver.NumFrontendStatsFilesCombined": 1
+// DRIVER-DAG: "Time.swift-driver.Total": {{[0-9]+\.[0-9]+}}
+// DRIVER-DAG: "Time.swift-frontend.Parsing": {{[0-9]+\.[0-9]+}}
+// DRIVER: }
+
+func compute(_ x: Int) -> Int {
+  return x * 2 + 1
+}
@@ -0,0 +1,14 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %target-build-swift -typecheck -trace-compile-events %t/trace.json %s %S/../Inputs/empty.swift
+// RUN: %FileCheck %s < %t/trace.json
+
+// CHECK: {"traceEvents":[
+// CHECK-DAG: {"name":"process_name","ph":"M",{{.*}}"args":{"name":"{{.*}}trace-compile-events.swift"}}
+// CHECK-DAG: {"name":"process_name","ph":"M",{{.*}}"args":{"name":"{{.*}}empty.swift"}}
+// CHECK-DAG: {"name":"Parsing","cat":"phase","ph":"X","ts":{{[0-9]+}},"dur":{{[0-9]+}},"pid":{{[0-9]+}},"tid":{{[0-9]+}}}
+// CHECK-DAG: {"name":"tracedFunction(_:)","cat":"type-check","ph":"X",{{.*}}"args":{"detail":"{{.*}}trace-compile-events.swift:12:6"}}
+// CHECK: ]}
+
+func tracedFunction(_ x: Int) -> Int {
+  return x + 1
+}
@@ -0,0 +1,15 @@
+struct Point {
+  var x: Int
+
+  var doubled: Int {
+    get { return x * 2 }
+  }
+
+  func scaled(by factor: Int) -> Point {
+    // The body contains a syntax error that is only diagnosed when it is
+    // parsed.
+    return Point(x: x * factor +)
+  }
+}
+
+func makePoint() -> Point { return Point(x: 1) }
@@ -0,0 +1,26 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %target-swift-frontend -emit-ir -primary-file %s -primary-file %S/Inputs/filelist-other.swift -o %t/batch-mode.ll -o %t/filelist-other.ll -module-name main
+// RUN: %FileCheck -check-prefix=CHECK-MAIN %s < %t/batch-mode.ll
+// RUN: %FileCheck -check-prefix=CHECK-OTHER %s < %t/filelist-other.ll
+
+// RUN: echo '%s' > %t/input.txt
+// RUN: echo '%S/Inputs/filelist-other.swift' >> %t/input.txt
+// RUN: %target-swift-frontend -emit-ir -filelist %t/input.txt -primary-file %S/Inputs/filelist-other.swift -primary-file %s -o %t/filelist-other-2.ll -o %t/batch-mode-2.ll -module-name main
+// RUN: %FileCheck -check-prefix=CHECK-MAIN %s < %t/batch-mode-2.ll
+// RUN: %FileCheck -check-prefix=CHECK-OTHER %s < %t/filelist-other-2.ll
+
+// RUN: not %target-swift-frontend -emit-ir -primary-file %s -primary-file %S/Inputs/filelist-other.swift -o %t/batch-mode.ll -module-name main 2>&1 | %FileCheck -check-prefix=CHECK-COUNT %s
+// CHECK-COUNT: error: 1 output files given for 2 primary files
+
+// RUN: not %target-swift-frontend -emit-ir -primary-file %s -primary-file %S/Inputs/filelist-other.swift -o %t/batch-mode.ll -o %t/filelist-other.ll -emit-reference-dependencies-path %t/batch-mode.swiftdeps -module-name main 2>&1 | %FileCheck -check-prefix=CHECK-SUPPLEMENTARY %s
+// CHECK-SUPPLEMENTARY: error: '-emit-reference-dependencies-path' is not supported with more than one -primary-file
+
+// RUN: not %target-swift-frontend -emit-module -primary-file %s -primary-file %S/Inputs/filelist-other.swift -o %t/batch-mode.swiftmodule -o %t/filelist-other.swiftmodule -module-name main 2>&1 | %FileCheck -check-prefix=CHECK-ACTION %s
+// CHECK-ACTION: error: this mode does not support more than one -primary-file
+
+// CHECK-MAIN: define{{.*}} @_TF4main4test
+// CHECK-MAIN-NOT: define{{.*}} @_TF4main5other
+// CHECK-OTHER: define{{.*}} @_TF4main5other
+// CHECK-OTHER-NOT: define{{.*}} @_TF4main4test
+
+func test() -> Foo { return Foo() }
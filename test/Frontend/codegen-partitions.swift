@@ -0,0 +1,16 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %target-swift-frontend -emit-bc -module-name someModule -o %t/test.bc %s
+
+// Each partition object embeds the bitcode of its own partition.
+// RUN: %target-swift-frontend -c -module-name someModule -embed-bitcode -disable-llvm-optzns -primary-file %t/test.bc -o %t/test.o -codegen-partition-output %t/test.part1.o
+// RUN: llvm-objdump -section-headers %t/test.o | %FileCheck -check-prefix=EMBED %s
+// RUN: llvm-objdump -section-headers %t/test.part1.o | %FileCheck -check-prefix=EMBED %s
+// EMBED: __bitcode
+
+// A partition which can't be written fails the compile and the backend job.
+// RUN: not %target-swift-frontend -c -module-name someModule -primary-file %s -o %t/test.o -codegen-partition-output %t/missing/test.part1.o 2>&1 | %FileCheck -check-prefix=MISSING %s
+// RUN: not %target-swift-frontend -c -module-name someModule -embed-bitcode -primary-file %t/test.bc -o %t/test.o -codegen-partition-output %t/missing/test.part1.o 2>&1 | %FileCheck -check-prefix=MISSING %s
+// MISSING: error: error opening '{{.*}}missing{{/|\\}}test.part1.o' for output
+
+func first() {}
+func second() {}
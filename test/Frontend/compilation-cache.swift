@@ -0,0 +1,60 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: cp %s %t/main.swift
+
+// RUN: %target-swift-frontend -c %t/main.swift -o %t/main.o -compilation-cache-path %t/cache 2>&1 | %FileCheck -check-prefix=WARNING %s
+// RUN: ls %t/cache/*/*/ | %FileCheck -check-prefix=ENTRY %s
+// RUN: cmp %t/main.o %t/cache/*/*/0
+
+// Replace the cached object so that a hit can be told from a compile.
+// RUN: for f in %t/cache/*/*/0; do echo cached > $f; done
+// RUN: rm %t/main.o
+// RUN: %target-swift-frontend -c %t/main.swift -o %t/main.o -compilation-cache-path %t/cache 2>&1 | %FileCheck -check-prefix=WARNING %s
+// RUN: %FileCheck -check-prefix=CACHED %s < %t/main.o
+
+// Changing the input misses.
+// RUN: echo "// changed" >> %t/main.swift
+// RUN: %target-swift-frontend -c %t/main.swift -o %t/main.o -compilation-cache-path %t/cache 2>&1 | %FileCheck -check-prefix=WARNING %s
+// RUN: not grep cached %t/main.o
+// RUN: ls -d %t/cache/*/* | wc -l | %FileCheck -check-prefix=TWO-ENTRIES %s
+
+// A hit which restores an unchanged output leaves its modification time
+// alone, like a compile which writes an unchanged module does.
+// RUN: touch -t 201001010000 %t/main.o %t/reference
+// RUN: %target-swift-frontend -c %t/main.swift -o %t/main.o -compilation-cache-path %t/cache 2>&1 | %FileCheck -check-prefix=WARNING %s
+// RUN: not test %t/main.o -nt %t/reference
+
+// Changing a file an option points at misses.
+// RUN: printf 'f\n0\n1\n1\n' > %t/first.proftext
+// RUN: %llvm-profdata merge %t/first.proftext -o %t/default.profdata
+// RUN: %target-swift-frontend -c %t/main.swift -o %t/main.o -profile-use=%t/default.profdata -compilation-cache-path %t/cache 2>&1 | %FileCheck -check-prefix=WARNING %s
+// RUN: for f in %t/cache/*/*/0; do echo cached > $f; done
+// RUN: printf 'f\n0\n1\n2\n' > %t/second.proftext
+// RUN: %llvm-profdata merge %t/second.proftext -o %t/default.profdata
+// RUN: %target-swift-frontend -c %t/main.swift -o %t/main.o -profile-use=%t/default.profdata -compilation-cache-path %t/cache 2>&1 | %FileCheck -check-prefix=WARNING %s
+// RUN: not grep cached %t/main.o
+
+// Jobs with errors aren't stored.
+// RUN: rm -rf %t/cache
+// RUN: not %target-swift-frontend -c %t/main.swift -o %t/main.o -compilation-cache-path %t/cache -DERROR
+// RUN: ls %t/cache/*/*/manifest 2>&1 | %FileCheck -check-prefix=NO-ENTRY %s
+
+// WARNING: variable 'x' was never mutated
+
+// ENTRY: 0
+// ENTRY: diagnostics
+// ENTRY: manifest
+
+// CACHED: cached
+
+// TWO-ENTRIES: 2
+
+// NO-ENTRY: No such file
+
+func f() -> Int {
+  var x = 1
+#if ERROR
+  return undefined
+#else
+  return x
+#endif
+}
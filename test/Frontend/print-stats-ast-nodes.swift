@@ -0,0 +1,15 @@
+// RUN: %target-swift-frontend -typecheck -print-stats %s 2>&1 | %FileCheck %s
+
+// CHECK: *** AST node statistics ***
+// CHECK-NEXT: count bytes kind
+// CHECK-DAG: {{^ *}}2 {{[0-9]+}} FuncDecl
+// CHECK-DAG: {{^ *}}1 {{[0-9]+}} StructDecl
+// CHECK-DAG: {{^ *}}1 {{[0-9]+}} ReturnStmt
+// CHECK: {{[0-9]+}} total in nodes
+// CHECK-NEXT: {{[0-9]+}} total ASTContext memory
+
+struct S {
+  func f() -> Int { return 1 }
+}
+
+func g() {}
@@ -0,0 +1,12 @@
+// RUN: %target-swift-frontend -typecheck -primary-file %s %S/Inputs/skip-function-bodies-other.swift -skip-non-primary-function-bodies
+// RUN: not %target-swift-frontend -typecheck -primary-file %s %S/Inputs/skip-function-bodies-other.swift 2>&1 | %FileCheck %s
+
+// Bodies in the primary file are still parsed and type-checked.
+// RUN: not %target-swift-frontend -typecheck -primary-file %S/Inputs/skip-function-bodies-other.swift %s -skip-non-primary-function-bodies 2>&1 | %FileCheck %s
+
+// CHECK: skip-function-bodies-other.swift:{{[0-9]+}}:{{[0-9]+}}: error:
+
+func use() -> Int {
+  let p = makePoint().scaled(by: 2)
+  return p.doubled
+}
@@ -261,6 +261,15 @@ func allocDealloc(_ size: Builtin.Word, align: Builtin.Word) {
   Builtin.deallocRaw(ptr, size, align)
 }
 
+// CHECK-LABEL: define hidden void @_TF8builtins17stackAllocDealloc
+func stackAllocDealloc(_ size: Builtin.Word) {
+  // CHECK:      [[SP:%.*]] = call i8* @llvm.stacksave()
+  // CHECK-NEXT: [[PTR:%.*]] = alloca i8, i64 %0, align 16
+  var ptr = Builtin.stackAlloc(size)
+  // CHECK:      call void @llvm.stackrestore(i8* [[SP]])
+  Builtin.stackDealloc(ptr)
+}
+
 func fence_test() {
   // CHECK: fence acquire
   Builtin.fence_acquire()
@@ -375,15 +384,16 @@ func testCondFail(_ b: Bool, c: Bool) {
 // CHECK-LABEL: define hidden void @_TF8builtins8testOnce{{.*}}(i8*, i8*) {{.*}} {
 // CHECK:         [[PRED_PTR:%.*]] = bitcast i8* %0 to [[WORD:i64|i32]]*
 // CHECK-objc:    [[PRED:%.*]] = load {{.*}} [[WORD]]* [[PRED_PTR]]
-// CHECK-objc:    [[IS_DONE:%.*]] = icmp eq [[WORD]] [[PRED]], -1
-// CHECK-objc:    br i1 [[IS_DONE]], label %[[DONE:.*]], label %[[NOT_DONE:.*]]
-// CHECK-objc:  [[NOT_DONE]]:
+// CHECK-native:  [[PRED:%.*]] = load atomic [[WORD]], [[WORD]]* [[PRED_PTR]] acquire
+// CHECK:         [[IS_DONE:%.*]] = icmp eq [[WORD]] [[PRED]], -1
+// CHECK:         br i1 [[IS_DONE]], label %[[DONE:.*]], label %[[NOT_DONE:.*]]
+// CHECK:       [[NOT_DONE]]:
 // CHECK:         call void @swift_once([[WORD]]* [[PRED_PTR]], i8* %1)
-// CHECK-objc:    br label %[[DONE]]
-// CHECK-objc:  [[DONE]]:
-// CHECK-objc:    [[PRED:%.*]] = load {{.*}} [[WORD]]* [[PRED_PTR]]
-// CHECK-objc:    [[IS_DONE:%.*]] = icmp eq [[WORD]] [[PRED]], -1
-// CHECK-objc:    call void @llvm.assume(i1 [[IS_DONE]])
+// CHECK:         br label %[[DONE]]
+// CHECK:       [[DONE]]:
+// CHECK:         [[PRED:%.*]] = load {{.*}} [[WORD]]* [[PRED_PTR]]
+// CHECK:         [[IS_DONE:%.*]] = icmp eq [[WORD]] [[PRED]], -1
+// CHECK:         call void @llvm.assume(i1 [[IS_DONE]])
 
 func testOnce(_ p: Builtin.RawPointer, f: @escaping @convention(thin) () -> ()) {
   Builtin.once(p, f)
@@ -575,8 +585,11 @@ func isUnique(_ ref: inout Builtin.NativeObject?) -> Bool {
 // CHECK-LABEL: define hidden i1 @_TF8builtins8isUniqueFRBoBi1_(%swift.refcounted** nocapture dereferenceable({{.*}})) {{.*}} {
 // CHECK-NEXT: entry:
 // CHECK-NEXT: load %swift.refcounted*, %swift.refcounted** %0
-// CHECK-NEXT: call i1 @swift_rt_swift_isUniquelyReferenced_nonNull_native(%swift.refcounted* %1)
-// CHECK-NEXT: ret i1 %2
+// CHECK-NEXT: [[REFCOUNT_ADDR:%.*]] = getelementptr inbounds %swift.refcounted, %swift.refcounted* %{{[0-9]+}}, i32 0, i32 1
+// CHECK-NEXT: [[REFCOUNT:%.*]] = load volatile i32, i32* [[REFCOUNT_ADDR]]
+// CHECK-NEXT: [[COUNT:%.*]] = and i32 [[REFCOUNT]], -4
+// CHECK-NEXT: [[UNIQUE:%.*]] = icmp eq i32 [[COUNT]], 4
+// CHECK-NEXT: ret i1 [[UNIQUE]]
 func isUnique(_ ref: inout Builtin.NativeObject) -> Bool {
   return Builtin.isUnique(&ref)
 }
@@ -596,8 +609,13 @@ func isUniqueOrPinned(_ ref: inout Builtin.NativeObject?) -> Bool {
 // CHECK-LABEL: define hidden i1 @_TF8builtins16isUniqueOrPinnedFRBoBi1_(%swift.refcounted** nocapture dereferenceable({{.*}})) {{.*}} {
 // CHECK-NEXT: entry:
 // CHECK-NEXT: load %swift.refcounted*, %swift.refcounted** %0
-// CHECK-NEXT: call i1 @swift_rt_swift_isUniquelyReferencedOrPinned_nonNull_native(%swift.refcounted* %1)
-// CHECK-NEXT: ret i1 %2
+// CHECK-NEXT: [[REFCOUNT_ADDR:%.*]] = getelementptr inbounds %swift.refcounted, %swift.refcounted* %{{[0-9]+}}, i32 0, i32 1
+// CHECK-NEXT: [[REFCOUNT:%.*]] = load volatile i32, i32* [[REFCOUNT_ADDR]]
+// CHECK-NEXT: [[LOW:%.*]] = lshr i32 [[REFCOUNT]], 1
+// CHECK-NEXT: [[HIGH:%.*]] = shl i32 [[REFCOUNT]], 31
+// CHECK-NEXT: [[ROTATED:%.*]] = or i32 [[LOW]], [[HIGH]]
+// CHECK-NEXT: [[UNIQUE:%.*]] = icmp slt i32 [[ROTATED]], 4
+// CHECK-NEXT: ret i1 [[UNIQUE]]
 func isUniqueOrPinned(_ ref: inout Builtin.NativeObject) -> Bool {
   return Builtin.isUniqueOrPinned(&ref)
 }
@@ -661,8 +679,11 @@ func isUniqueOrPinned(_ ref: inout Builtin.BridgeObject) -> Bool {
 // CHECK-NEXT: entry:
 // CHECK-NEXT: bitcast %swift.bridge** %0 to %swift.refcounted**
 // CHECK-NEXT: load %swift.refcounted*, %swift.refcounted** %1
-// CHECK-NEXT: call i1 @swift_rt_swift_isUniquelyReferenced_nonNull_native(%swift.refcounted* %2)
-// CHECK-NEXT: ret i1 %3
+// CHECK-NEXT: [[REFCOUNT_ADDR:%.*]] = getelementptr inbounds %swift.refcounted, %swift.refcounted* %{{[0-9]+}}, i32 0, i32 1
+// CHECK-NEXT: [[REFCOUNT:%.*]] = load volatile i32, i32* [[REFCOUNT_ADDR]]
+// CHECK-NEXT: [[COUNT:%.*]] = and i32 [[REFCOUNT]], -4
+// CHECK-NEXT: [[UNIQUE:%.*]] = icmp eq i32 [[COUNT]], 4
+// CHECK-NEXT: ret i1 [[UNIQUE]]
 func isUnique_native(_ ref: inout Builtin.BridgeObject) -> Bool {
   return Builtin.isUnique_native(&ref)
 }
@@ -672,8 +693,13 @@ func isUnique_native(_ ref: inout Builtin.BridgeObject) -> Bool {
 // CHECK-NEXT: entry:
 // CHECK-NEXT: bitcast %swift.bridge** %0 to %swift.refcounted**
 // CHECK-NEXT: load %swift.refcounted*, %swift.refcounted** %1
-// CHECK-NEXT: call i1 @swift_rt_swift_isUniquelyReferencedOrPinned_nonNull_native(%swift.refcounted* %2)
-// CHECK-NEXT: ret i1 %3
+// CHECK-NEXT: [[REFCOUNT_ADDR:%.*]] = getelementptr inbounds %swift.refcounted, %swift.refcounted* %{{[0-9]+}}, i32 0, i32 1
+// CHECK-NEXT: [[REFCOUNT:%.*]] = load volatile i32, i32* [[REFCOUNT_ADDR]]
+// CHECK-NEXT: [[LOW:%.*]] = lshr i32 [[REFCOUNT]], 1
+// CHECK-NEXT: [[HIGH:%.*]] = shl i32 [[REFCOUNT]], 31
+// CHECK-NEXT: [[ROTATED:%.*]] = or i32 [[LOW]], [[HIGH]]
+// CHECK-NEXT: [[UNIQUE:%.*]] = icmp slt i32 [[ROTATED]], 4
+// CHECK-NEXT: ret i1 [[UNIQUE]]
 func isUniqueOrPinned_native(_ ref: inout Builtin.BridgeObject) -> Bool {
   return Builtin.isUniqueOrPinned_native(&ref)
 }
@@ -0,0 +1,32 @@
+// RUN: %target-swift-frontend -primary-file %s -emit-ir | %FileCheck %s --check-prefix=DEFAULT
+// RUN: %target-swift-frontend -primary-file %s -emit-ir -enable-struct-field-reordering | %FileCheck %s --check-prefix=REORDER
+
+// REQUIRES: CPU=x86_64
+
+// Internal structs are laid out by decreasing alignment.
+// DEFAULT: %V24struct_field_reordering6Padded = type <{ %Vs4Int8, [7 x i8], %Si, %Vs4Int8 }>
+// REORDER: %V24struct_field_reordering6Padded = type <{ %Si, %Vs4Int8, %Vs4Int8 }>
+struct Padded {
+  var a: Int8
+  var b: Int
+  var c: Int8
+}
+
+// Public structs keep their declared layout.
+// DEFAULT: %V24struct_field_reordering12PublicPadded = type <{ %Vs4Int8, [7 x i8], %Si, %Vs4Int8 }>
+// REORDER: %V24struct_field_reordering12PublicPadded = type <{ %Vs4Int8, [7 x i8], %Si, %Vs4Int8 }>
+public struct PublicPadded {
+  public var a: Int8
+  public var b: Int
+  public var c: Int8
+}
+
+class C {}
+
+// The reference field is moved to the front, where 'Optional' can use its
+// extra inhabitants.
+// REORDER: %V24struct_field_reordering7WithRef = type <{ %C24struct_field_reordering1C*, %Vs4Int8 }>
+struct WithRef {
+  var a: Int8
+  var c: C
+}
@@ -0,0 +1,39 @@
+// RUN: %target-swift-frontend -primary-file %s -emit-ir -enable-struct-field-reordering | %FileCheck %s --check-prefix=REFLECT
+// RUN: %target-swift-frontend -primary-file %s -emit-ir -enable-struct-field-reordering -gdwarf-types | %FileCheck %s --check-prefix=DWARF
+
+// REQUIRES: CPU=x86_64
+
+// Reflection metadata and debug info have to describe the fields where the
+// reordered layout put them, not where they were declared.
+
+// REFLECT-DAG: [[SMALL1:@[0-9]+]] = private constant [7 x i8] c"small1\00", section "{{[^"]*}}swift3_reflstr
+// REFLECT-DAG: [[LARGE:@[0-9]+]] = private constant [6 x i8] c"large\00", section "{{[^"]*}}swift3_reflstr
+// REFLECT-DAG: [[SMALL2:@[0-9]+]] = private constant [7 x i8] c"small2\00", section "{{[^"]*}}swift3_reflstr
+
+// Remote mirrors lay out the fields in descriptor order, so the descriptor
+// has to list them in memory order.
+// REFLECT: @_TMRfV32struct_field_reordering_metadata6Padded = internal constant
+// REFLECT-SAME: i32 3,
+// REFLECT-SAME: [[LARGE]] to i64)
+// REFLECT-SAME: [[SMALL1]] to i64)
+// REFLECT-SAME: [[SMALL2]] to i64)
+// REFLECT-SAME: swift3_fieldmd
+
+// DWARF: !DICompositeType(tag: DW_TAG_structure_type, name: "Padded",{{.*}} size: 80,{{.*}} elements: ![[ELTS:[0-9]+]]
+// DWARF: ![[ELTS]] = !{![[LARGEMEMBER:[0-9]+]], ![[SMALL1MEMBER:[0-9]+]], ![[SMALL2MEMBER:[0-9]+]]}
+// DWARF: ![[LARGEMEMBER]] = !DIDerivedType(tag: DW_TAG_member, name: "large",
+// DWARF-NOT: offset:
+// DWARF-SAME: ){{$}}
+// DWARF: ![[SMALL1MEMBER]] = !DIDerivedType(tag: DW_TAG_member, name: "small1",
+// DWARF-SAME: offset: 64)
+// DWARF: ![[SMALL2MEMBER]] = !DIDerivedType(tag: DW_TAG_member, name: "small2",
+// DWARF-SAME: offset: 72)
+struct Padded {
+  var small1: Int8
+  var large: Int
+  var small2: Int8
+}
+
+func use(_ p: Padded) -> Int {
+  return p.large
+}
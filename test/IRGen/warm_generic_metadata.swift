@@ -0,0 +1,24 @@
+// RUN: %target-swift-frontend -assume-parsing-unqualified-ownership-sil -primary-file %s -emit-ir -warm-generic-metadata | %FileCheck %s
+// RUN: %target-swift-frontend -assume-parsing-unqualified-ownership-sil -primary-file %s -emit-ir | %FileCheck %s --check-prefix=NO-WARM
+
+// REQUIRES: CPU=x86_64
+
+class Model<T> {
+  var value: T
+  init(value: T) { self.value = value }
+}
+
+func makeModel() -> AnyObject {
+  return Model(value: 1)
+}
+
+_ = makeModel()
+
+// CHECK: @generic_metadata_to_warm = private constant [{{[0-9]+}} x i8*] [{{.*}}i8* bitcast (%swift.type* ()* @_TMaGC21warm_generic_metadata5ModelSi_ to i8*){{.*}}], align 8
+
+// CHECK: define{{( protected)?}} i32 @main(i32, i8**) {{.*}} {
+// CHECK-NOT: call
+// CHECK: call void @swift_warmMetadata(i8** bitcast ([{{[0-9]+}} x i8*]* @generic_metadata_to_warm to i8**), i64 {{[0-9]+}})
+
+// NO-WARM-NOT: generic_metadata_to_warm
+// NO-WARM-NOT: swift_warmMetadata
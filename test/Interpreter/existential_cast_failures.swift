@@ -0,0 +1,40 @@
+// RUN: %target-run-simple-swift | %FileCheck %s
+// REQUIRES: executable_test
+
+// Repeated failing casts from 'Any' to protocol types must keep failing, and
+// must not affect casts of other types to the same protocol.
+
+protocol P { func describe() -> String }
+protocol Q {}
+protocol AnyErrorLike: Error {}
+
+struct S: P { func describe() -> String { return "S" } }
+struct NotP {}
+enum E: P { case a; func describe() -> String { return "E" } }
+enum NotPEnum { case a }
+struct MyError: AnyErrorLike {}
+
+func describeAll(_ values: [Any]) -> String {
+  var result = ""
+  for value in values {
+    if let p = value as? P {
+      result += p.describe()
+    } else {
+      result += "-"
+    }
+  }
+  return result
+}
+
+let values: [Any] = [S(), NotP(), E.a, NotPEnum.a, 1, "x"]
+for _ in 0..<3 {
+  // CHECK-COUNT-3: S-E---
+  print(describeAll(values))
+}
+
+// CHECK: false false
+print(NotP() as Any is Q, NotP() as Any is Q)
+// CHECK: false true
+print(NotP() as Any is Error, MyError() as Any is Error)
+// CHECK: true
+print(MyError() as Any is AnyErrorLike)
@@ -19,3 +19,12 @@ var someval = 0xFFeeFF0033
 print("value = \(someval)")
 
 
+
+// Segments of different widths share one buffer.
+// CHECK: UTF-16 café next to ASCII "3", then "".
+var cafe = "café"
+var empty = ""
+print("UTF-16 \(cafe) next to ASCII \"\(pi)\", then \"\(empty)\".")
+
+// CHECK: café
+print("\(cafe)")
@@ -186,6 +186,18 @@ define i32 @move_retain_across_load(%swift.refcounted* %A, i32* %ptr) {
   ret i32 %val
 }
 
+; CHECK-LABEL: @dont_move_retain_across_volatile_load
+; CHECK: tail call void @swift_retain(%swift.refcounted* %A)
+; CHECK-NEXT: load volatile i32
+; CHECK-NEXT: tail call void @swift_release(%swift.refcounted* %A)
+; CHECK: ret
+define i32 @dont_move_retain_across_volatile_load(%swift.refcounted* %A, i32* %ptr) {
+  tail call void @swift_retain(%swift.refcounted* %A)
+  %val = load volatile i32, i32* %ptr
+  tail call void @swift_release(%swift.refcounted* %A) nounwind
+  ret i32 %val
+}
+
 ; CHECK-LABEL: @move_retain_but_not_release_across_objc_fix_lifetime
 ; CHECK: call void @__swift_fixLifetime
 ; CHECK-NEXT: tail call void @swift_retain
@@ -581,6 +581,46 @@ bb3:
   ret %swift.bridge* %A
 }
 
+; CHECK-LABEL: define{{( protected)?}} void @swift_contractRetainReleaseArray(%swift.refcounted* %A, %swift.refcounted* %B, %swift.refcounted* %C) {
+; CHECK: entry:
+; CHECK-NEXT: [[BUF:%.*]] = alloca [3 x %swift.refcounted*]
+; CHECK-NOT: @swift_rt_swift_retain(
+; CHECK: [[ELT0:%.*]] = getelementptr inbounds [3 x %swift.refcounted*], [3 x %swift.refcounted*]* [[BUF]], i32 0, i32 0
+; CHECK-NEXT: store %swift.refcounted* %A, %swift.refcounted** [[ELT0]]
+; CHECK: store %swift.refcounted* %B
+; CHECK: store %swift.refcounted* %C
+; CHECK: call void @swift_retain_array(%swift.refcounted** {{%.*}}, i32 3)
+; CHECK-NEXT: call void @user(%swift.refcounted* %A)
+; CHECK-NOT: @swift_rt_swift_release(
+; CHECK: call void @swift_release_array(%swift.refcounted** {{%.*}}, i32 3)
+; CHECK-NEXT: ret void
+define void @swift_contractRetainReleaseArray(%swift.refcounted* %A, %swift.refcounted* %B, %swift.refcounted* %C) {
+entry:
+  tail call void @swift_rt_swift_retain(%swift.refcounted* %A)
+  call void @noread_user(%swift.refcounted* %A)
+  tail call void @swift_rt_swift_retain(%swift.refcounted* %B)
+  tail call void @swift_rt_swift_retain(%swift.refcounted* %C)
+  call void @user(%swift.refcounted* %A)
+  tail call void @swift_rt_swift_release(%swift.refcounted* %A)
+  tail call void @swift_rt_swift_release(%swift.refcounted* %B)
+  tail call void @swift_rt_swift_release(%swift.refcounted* %C)
+  ret void
+}
+
+; Two retains are not worth an array, and a release ends a run of retains.
+; CHECK-LABEL: define{{( protected)?}} void @swift_contractRetainArrayTooShort(%swift.refcounted* %A, %swift.refcounted* %B, %swift.refcounted* %C) {
+; CHECK-NOT: alloca
+; CHECK-NOT: @swift_retain_array
+; CHECK: ret void
+define void @swift_contractRetainArrayTooShort(%swift.refcounted* %A, %swift.refcounted* %B, %swift.refcounted* %C) {
+entry:
+  tail call void @swift_rt_swift_retain(%swift.refcounted* %A)
+  tail call void @swift_rt_swift_retain(%swift.refcounted* %B)
+  tail call void @swift_rt_swift_release(%swift.refcounted* %A)
+  tail call void @swift_rt_swift_retain(%swift.refcounted* %C)
+  ret void
+}
+
 !llvm.dbg.cu = !{!1}
 !llvm.module.flags = !{!4}
 
@@ -16,3 +16,33 @@ entry:
   %3 = add i8 %1, %2
   ret i8 %3
 }
+
+declare void @swift_retain_array(i8**, i32) nounwind
+declare void @swift_release_array(i8**, i32) nounwind
+
+; swift_retain_array only reads memory, so loads can move over it.
+; CHECK-LABEL: define{{( protected)?}} i8 @test_eliminate_loads_over_retain_array(i8*, i8**) {
+; CHECK: load
+; CHECK-NOT: load
+define i8 @test_eliminate_loads_over_retain_array(i8*, i8**) {
+entry:
+  %2 = load i8, i8* %0
+  call void @swift_retain_array(i8** %1, i32 3)
+  %3 = load i8, i8* %0
+  %4 = add i8 %2, %3
+  ret i8 %4
+}
+
+; swift_release_array may run deinits, which can write to memory.
+; CHECK-LABEL: define{{( protected)?}} i8 @test_keep_loads_over_release_array(i8*, i8**) {
+; CHECK: load
+; CHECK: call void @swift_release_array
+; CHECK: load
+define i8 @test_keep_loads_over_release_array(i8*, i8**) {
+entry:
+  %2 = load i8, i8* %0
+  call void @swift_release_array(i8** %1, i32 3)
+  %3 = load i8, i8* %0
+  %4 = add i8 %2, %3
+  ret i8 %4
+}
@@ -323,3 +323,83 @@ done:
 ; CHECK: ret i1
   ret i1 %result
 }
+
+
+; Merge functions which differ in the constant operands of icmp, select,
+; getelementptr and insertvalue instructions, like specializations which only
+; differ in the metadata and functions they reference.
+
+%swift.type = type { i64 }
+@md1 = external global %swift.type
+@md2 = external global %swift.type
+
+; CHECK-LABEL: define { i8*, %swift.type* } @spec_func1(%swift.type* %t, i64 %x)
+; CHECK: %1 = tail call { i8*, %swift.type* } @spec_func1_merged(%swift.type* %t, i64 %x, %swift.type* @md1, i8* bitcast (void (i32)* @callee1 to i8*))
+; CHECK: ret { i8*, %swift.type* } %1
+define { i8*, %swift.type* } @spec_func1(%swift.type* %t, i64 %x) {
+  %eq = icmp eq %swift.type* %t, @md1
+  %s = select i1 %eq, %swift.type* %t, %swift.type* @md1
+  %a = getelementptr inbounds %swift.type, %swift.type* @md1, i64 %x
+  %p = bitcast %swift.type* %a to i64*
+  %l = load i64, i64* %p
+  %sum = add i64 %l, %x
+  store i64 %sum, i64* %p
+  %r1 = insertvalue { i8*, %swift.type* } undef, i8* bitcast (void (i32)* @callee1 to i8*), 0
+  %r2 = insertvalue { i8*, %swift.type* } %r1, %swift.type* %s, 1
+  ret { i8*, %swift.type* } %r2
+}
+
+; CHECK-LABEL: define { i8*, %swift.type* } @spec_func2(%swift.type* %t, i64 %x)
+; CHECK: %1 = tail call { i8*, %swift.type* } @spec_func1_merged(%swift.type* %t, i64 %x, %swift.type* @md2, i8* bitcast (void (i32)* @callee2 to i8*))
+; CHECK: ret { i8*, %swift.type* } %1
+define { i8*, %swift.type* } @spec_func2(%swift.type* %t, i64 %x) {
+  %eq = icmp eq %swift.type* %t, @md2
+  %s = select i1 %eq, %swift.type* %t, %swift.type* @md2
+  %a = getelementptr inbounds %swift.type, %swift.type* @md2, i64 %x
+  %p = bitcast %swift.type* %a to i64*
+  %l = load i64, i64* %p
+  %sum = add i64 %l, %x
+  store i64 %sum, i64* %p
+  %r1 = insertvalue { i8*, %swift.type* } undef, i8* bitcast (void (i32)* @callee2 to i8*), 0
+  %r2 = insertvalue { i8*, %swift.type* } %r1, %swift.type* %s, 1
+  ret { i8*, %swift.type* } %r2
+}
+
+; CHECK-LABEL: define internal { i8*, %swift.type* } @spec_func1_merged(%swift.type*, i64, %swift.type*, i8*)
+; CHECK: %eq = icmp eq %swift.type* %0, %2
+; CHECK: %s = select i1 %eq, %swift.type* %0, %swift.type* %2
+; CHECK: %a = getelementptr inbounds %swift.type, %swift.type* %2, i64 %1
+; CHECK: %r1 = insertvalue { i8*, %swift.type* } undef, i8* %3, 0
+; CHECK: ret
+
+
+; Don't merge functions if passing the additional parameters costs more than
+; merging saves.
+
+; CHECK-LABEL: define i32 @expensive_func1(i32 %x)
+; CHECK-NOT: _merged
+; CHECK: ret i32
+define i32 @expensive_func1(i32 %x) {
+  %l1 = load i32, i32* @g1, align 4
+  %l2 = load i32, i32* @g2, align 4
+  %l3 = load i32, i32* @g3, align 4
+  %l4 = load i32, i32* @g4, align 4
+  %sum = add i32 %l1, %l2
+  %sum2 = add i32 %sum, %l3
+  %sum3 = add i32 %sum2, %l4
+  ret i32 %sum3
+}
+
+; CHECK-LABEL: define i32 @expensive_func2(i32 %x)
+; CHECK-NOT: _merged
+; CHECK: ret i32
+define i32 @expensive_func2(i32 %x) {
+  %l1 = load i32, i32* @g2, align 4
+  %l2 = load i32, i32* @g3, align 4
+  %l3 = load i32, i32* @g4, align 4
+  %l4 = load i32, i32* @g5, align 4
+  %sum = add i32 %l1, %l2
+  %sum2 = add i32 %sum, %l3
+  %sum3 = add i32 %sum2, %l4
+  ret i32 %sum3
+}
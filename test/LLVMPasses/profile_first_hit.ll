@@ -0,0 +1,50 @@
+; RUN: %swift-llvm-opt -swift-profile-first-hit %s | %FileCheck %s
+
+target datalayout = "e-p:64:64:64-S128-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f16:16:16-f32:32:32-f64:64:64-f128:128:128-v64:64:64-v128:128:128-a0:0:64-s0:64:64-f80:128:128-n8:16:32:64"
+target triple = "x86_64-apple-macosx10.9"
+
+@__profc_loop = private global [2 x i64] zeroinitializer, section "__DATA,__llvm_prf_cnts", align 8
+@other = global [2 x i64] zeroinitializer, align 8
+
+declare void @body()
+
+; CHECK-LABEL: define void @loop(
+; CHECK: entry:
+; CHECK-NEXT: store i64 1, i64* getelementptr inbounds ([2 x i64], [2 x i64]* @__profc_loop, i64 0, i64 0)
+; CHECK-NEXT: br label %header
+; CHECK: header:
+; CHECK-NEXT: store i64 1, i64* getelementptr inbounds ([2 x i64], [2 x i64]* @__profc_loop, i64 0, i64 1)
+; CHECK-NEXT: call void @body()
+; CHECK: ret void
+define void @loop(i1 %c) {
+entry:
+  %c0 = load i64, i64* getelementptr inbounds ([2 x i64], [2 x i64]* @__profc_loop, i64 0, i64 0)
+  %c0.1 = add i64 %c0, 1
+  store i64 %c0.1, i64* getelementptr inbounds ([2 x i64], [2 x i64]* @__profc_loop, i64 0, i64 0)
+  br label %header
+
+header:
+  %c1 = load i64, i64* getelementptr inbounds ([2 x i64], [2 x i64]* @__profc_loop, i64 0, i64 1)
+  %c1.1 = add i64 %c1, 1
+  store i64 %c1.1, i64* getelementptr inbounds ([2 x i64], [2 x i64]* @__profc_loop, i64 0, i64 1)
+  call void @body()
+  br i1 %c, label %header, label %exit
+
+exit:
+  ret void
+}
+
+; Other globals are not counters.
+
+; CHECK-LABEL: define void @not_a_counter(
+; CHECK: load
+; CHECK: add
+; CHECK: store i64 %
+; CHECK: ret void
+define void @not_a_counter() {
+entry:
+  %v = load i64, i64* getelementptr inbounds ([2 x i64], [2 x i64]* @other, i64 0, i64 0)
+  %v.1 = add i64 %v, 1
+  store i64 %v.1, i64* getelementptr inbounds ([2 x i64], [2 x i64]* @other, i64 0, i64 0)
+  ret void
+}
@@ -0,0 +1,13 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: echo "func f() {" > %t/many.swift
+// RUN: for i in $(seq 1 3000); do echo "  var x$i = 0; _ = x$i"; done >> %t/many.swift
+// RUN: echo "}" >> %t/many.swift
+
+// The diagnostics are written out in several pieces.
+// RUN: %target-swift-frontend -typecheck -serialize-diagnostics-path %t/many.dia %t/many.swift 2>/dev/null
+// RUN: c-index-test -read-diagnostics %t/many.dia > %t/many.txt 2>&1
+// RUN: %FileCheck --input-file=%t/many.txt %s
+
+// CHECK: many.swift:2:7: warning: variable 'x1' was never mutated
+// CHECK: many.swift:3001:7: warning: variable 'x3000' was never mutated
+// CHECK: Number of diagnostics: 3000
@@ -0,0 +1,19 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %target-swift-frontend -emit-sil -O -trace-compile-events %t/trace.json %s -o /dev/null
+// RUN: %FileCheck %s < %t/trace.json
+
+// RUN: not %target-swift-frontend -typecheck -trace-compile-events %t/nonexistent/trace.json %s 2>&1 | %FileCheck -check-prefix=CHECK-ERROR %s
+// CHECK-ERROR: error: cannot open file '{{.*}}nonexistent/trace.json'
+
+// CHECK: {"traceEvents":[
+// CHECK-DAG: {"name":"process_name","ph":"M",
+// CHECK-DAG: {"name":"Type checking / Semantic analysis","cat":"phase","ph":"X",
+// CHECK-DAG: {"name":"SILGen","cat":"phase","ph":"X",
+// CHECK-DAG: {"name":"compute(_:)","cat":"type-check","ph":"X",
+// CHECK-DAG: {"name":"(closure)","cat":"type-check","ph":"X",
+// CHECK-DAG: {"name":"SIL Combine","cat":"sil-pass","ph":"X",{{.*}}"args":{"detail":"{{.*}}compute{{.*}}"}}
+// CHECK: ]}
+
+public func compute(_ values: [Int]) -> [Int] {
+  return values.map { $0 * 2 }
+}
@@ -14,6 +14,8 @@
 // RUN: %FileCheck -check-prefix=DEPENDS-NOMINAL-NEGATIVE %s < %t.swiftdeps
 // RUN: %FileCheck -check-prefix=DEPENDS-MEMBER %s < %t.swiftdeps
 // RUN: %FileCheck -check-prefix=DEPENDS-MEMBER-NEGATIVE %s < %t.swiftdeps
+// RUN: %FileCheck -check-prefix=FINGERPRINTS %s < %t.swiftdeps
+// RUN: %FileCheck -check-prefix=FINGERPRINTS-NEGATIVE %s < %t.swiftdeps
 
 
 // PROVIDES-NOMINAL-LABEL: {{^provides-nominal:$}}
@@ -24,6 +26,8 @@
 // DEPENDS-NOMINAL-NEGATIVE-LABEL: {{^depends-nominal:$}}
 // DEPENDS-MEMBER-LABEL: {{^depends-member:$}}
 // DEPENDS-MEMBER-NEGATIVE-LABEL: {{^depends-member:$}}
+// FINGERPRINTS-LABEL: {{^fingerprints-top-level:$}}
+// FINGERPRINTS-NEGATIVE-LABEL: {{^fingerprints-top-level:$}}
 
 // PROVIDES-NOMINAL-DAG: 4Base"
 class Base {
@@ -71,5 +75,35 @@ extension OtherStruct {
   private func baz() {}
 }
 
+// PROVIDES-NOMINAL-DAG: 14FineGrainedBox"
+// PROVIDES-MEMBER-DAG: - ["{{.+}}14FineGrainedBox", ""]
+// FINGERPRINTS-DAG: - ["FineGrainedBox", "{{[0-9a-f]+}}"]
+// FINGERPRINTS-DAG: - ["{{.+}}14FineGrainedBox", "{{[0-9a-f]+}}"]
+// FINGERPRINTS-DAG: - ["{{.+}}14FineGrainedBox", "", "{{[0-9a-f]+}}"]
+struct FineGrainedBox {
+  // PROVIDES-MEMBER-NEGATIVE-NOT: "value"
+  // FINGERPRINTS-NEGATIVE-NOT: "value"
+  var value: Int
+
+  // PROVIDES-MEMBER-DAG: - ["{{.+}}14FineGrainedBox", "get"]
+  // FINGERPRINTS-DAG: - ["{{.+}}14FineGrainedBox", "get", "{{[0-9a-f]+}}"]
+  func get() -> Int { return value }
+
+  // PROVIDES-MEMBER-DAG: - ["{{.+}}14FineGrainedBox", "subscript"]
+  // FINGERPRINTS-DAG: - ["{{.+}}14FineGrainedBox", "subscript", "{{[0-9a-f]+}}"]
+  subscript(i: Int) -> Int { return value + i }
+
+  // PROVIDES-MEMBER-NEGATIVE-NOT: "secret"
+  // FINGERPRINTS-NEGATIVE-NOT: "secret"
+  private func secret() {}
+}
+
+// PROVIDES-MEMBER-DAG: - ["{{.+}}14FineGrainedBox", "reset"]
+// FINGERPRINTS-DAG: - ["{{.+}}14FineGrainedBox", "reset", "{{[0-9a-f]+}}"]
+extension FineGrainedBox {
+  mutating func reset() { value = 0 }
+}
+
 // PROVIDES-NOMINAL-NEGATIVE-LABEL: {{^depends-nominal:$}}
 // PROVIDES-MEMBER-NEGATIVE-LABEL: {{^depends-member:$}}
+// FINGERPRINTS-NEGATIVE-LABEL: {{^interface-hash:}}
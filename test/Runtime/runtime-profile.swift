@@ -0,0 +1,54 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %target-build-swift %s -o %t/a.out
+// RUN: env SWIFT_RUNTIME_PROFILE=%t/profile.txt SWIFT_RUNTIME_PROFILE_SAMPLE_INTERVAL=1 %target-run %t/a.out
+// RUN: %FileCheck %s < %t/profile.txt
+// REQUIRES: executable_test
+
+// CHECK: Swift runtime profile
+
+// CHECK: == Object allocations:
+// CHECK: {{^ *}}100 {{[0-9]+}}  a.Node
+// CHECK: sampled 100 times:
+
+// CHECK: == Generic metadata:
+// CHECK: {{[0-9]+}}  a.Box<Swift.Int>
+
+// CHECK: == Protocol conformance lookups ==
+// CHECK: a.Node: {{.*}}Describable
+
+// CHECK: == Dynamic casts ==
+// CHECK: {{^ *}}11 {{ *}}10  {{.*}} -> a.Describable
+
+protocol Describable {}
+
+final class Node: Describable {
+  var next: Node?
+  init(next: Node?) { self.next = next }
+}
+
+struct Box<T> {
+  var value: T
+}
+
+@inline(never)
+func makeList(_ count: Int) -> Node? {
+  var head: Node? = nil
+  for _ in 0..<count {
+    head = Node(next: head)
+  }
+  return head
+}
+
+@inline(never)
+func isDescribable(_ value: Any) -> Bool {
+  return value is Describable
+}
+
+let list = makeList(100)
+var boxed: Any = Box(value: 1)
+var describable = 0
+for _ in 0..<10 {
+  if isDescribable(1) { describable += 1 }
+}
+if isDescribable(list!) { describable += 1 }
+print(describable)
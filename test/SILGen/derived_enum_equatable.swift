@@ -0,0 +1,28 @@
+// RUN: %target-swift-frontend -emit-silgen %s | %FileCheck %s
+
+enum Direction {
+  case north, south, east, west
+}
+
+func same(_ a: Direction, _ b: Direction) -> Bool {
+  return a == b
+}
+
+func hash(_ d: Direction) -> Int {
+  return d.hashValue
+}
+
+// The derived '==' matches both operands directly instead of computing an
+// integer index for each of them.
+// CHECK-LABEL: sil hidden @{{.*}}9Directionoi2ee{{.*}} : $@convention(method)
+// CHECK-NOT: alloc_box
+// CHECK: switch_enum
+// CHECK-NOT: alloc_box
+// CHECK: } // end sil function '{{.*}}9Directionoi2ee{{.*}}'
+
+// The derived 'hashValue' returns the case index without asking Int for its
+// hash value.
+// CHECK-LABEL: sil hidden @{{.*}}9Directiong9hashValueSi : $@convention(method)
+// CHECK: switch_enum
+// CHECK-NOT: function_ref {{.*}}hashValue
+// CHECK: } // end sil function '{{.*}}9Directiong9hashValueSi'
@@ -0,0 +1,31 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %target-build-swift %s -profile-generate -Xfrontend -disable-incremental-llvm-codegen -o %t/main
+// RUN: env LLVM_PROFILE_FILE=%t/default.profraw %target-run %t/main
+// RUN: %llvm-profdata merge %t/default.profraw -o %t/default.profdata
+// RUN: %target-swift-frontend -emit-silgen -module-name profile_use -profile-use=%t/default.profdata %s | %FileCheck %s
+// RUN: not %target-swift-frontend -emit-silgen -profile-use=%t/missing.profdata %s 2>&1 | %FileCheck %s --check-prefix=CHECK-MISSING
+// RUN: rm -rf %t
+
+// REQUIRES: profile_runtime
+// REQUIRES: OS=macosx
+
+// CHECK-MISSING: error: failed to load profile data '{{.*}}missing.profdata'
+
+// CHECK: // entry count: 3
+// CHECK-LABEL: sil hidden @_TF11profile_use10mostly_notFSbSi
+func mostly_not(_ x: Bool) -> Int {
+  // CHECK: bb0({{.*}}):{{ *}}// count: 3
+  if x {
+    // CHECK: bb{{[0-9]+}}:{{.*}}// count: 0
+    return 1
+  }
+  return 0
+}
+
+// CHECK: // entry count: 0
+// CHECK-LABEL: sil hidden @_TF11profile_use5never
+func never() {}
+
+_ = mostly_not(false)
+_ = mostly_not(false)
+_ = mostly_not(false)
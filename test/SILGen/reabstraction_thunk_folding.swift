@@ -0,0 +1,41 @@
+// RUN: %target-swift-frontend -emit-silgen %s | %FileCheck %s
+
+struct Box<T> {
+  var value: T
+}
+
+// Reading the function out of the box reabstracts it to its substituted
+// type, and assigning it back reabstracts it to the opaque abstraction
+// again. The second thunk would undo the first, so neither is emitted.
+// CHECK-LABEL: sil hidden @{{.*}}roundTrip
+// CHECK-NOT:     @_TTR
+// CHECK-NOT:     partial_apply
+// CHECK:         return
+func roundTrip(_ b: inout Box<(Int) -> Int>) {
+  b.value = b.value
+}
+
+// Converting the function to a different type isn't an inverse, so both
+// thunks stay.
+// CHECK-LABEL: sil hidden @{{.*}}convertToOptionalResult
+// CHECK:         [[FIRST:%.*]] = function_ref @_TTR
+// CHECK:         [[FIRSTCLOSURE:%.*]] = partial_apply [[FIRST]]
+// CHECK:         [[SECOND:%.*]] = function_ref @_TTR
+// CHECK:         partial_apply [[SECOND]]([[FIRSTCLOSURE]])
+// CHECK:         return
+func convertToOptionalResult(_ b: Box<(Int) -> Int>) -> (Int) -> Int? {
+  return b.value
+}
+
+// Reabstracting a closure which is also used elsewhere leaves both thunks.
+// CHECK-LABEL: sil hidden @{{.*}}roundTripAndKeep
+// CHECK:         function_ref @_TTR
+// CHECK:         partial_apply
+// CHECK:         function_ref @_TTR
+// CHECK:         partial_apply
+// CHECK:         return
+func roundTripAndKeep(_ b: inout Box<(Int) -> Int>) -> (Int) -> Int {
+  let f = b.value
+  b.value = f
+  return f
+}
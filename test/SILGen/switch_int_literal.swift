@@ -0,0 +1,52 @@
+// RUN: %target-swift-frontend -emit-silgen %s | %FileCheck %s
+
+func a() {}
+func b() {}
+func c() {}
+func d() {}
+
+// CHECK-LABEL: sil hidden @_TF18switch_int_literal5test1FSiT_
+func test1(_ x: Int) {
+  switch x {
+  // CHECK:   [[VALUE:%.*]] = struct_extract %0 : $Int, #Int._value
+  // CHECK:   [[ZERO:%.*]] = integer_literal $Builtin.Int64, 0
+  // CHECK:   [[ONE:%.*]] = integer_literal $Builtin.Int64, 1
+  // CHECK:   [[MINUS:%.*]] = integer_literal $Builtin.Int64, -7
+  // CHECK:   switch_value [[VALUE]] : $Builtin.Int64, case [[ZERO]]: [[CASE0:bb[0-9]+]], case [[ONE]]: [[CASE1:bb[0-9]+]], case [[MINUS]]: [[CASE2:bb[0-9]+]], default [[DEFAULT:bb[0-9]+]]
+  // CHECK-NOT: ~=
+  // CHECK: [[CASE0]]:
+  // CHECK:   function_ref @_TF18switch_int_literal1aFT_T_
+  case 0:
+    a()
+  // CHECK: [[CASE1]]:
+  // CHECK:   function_ref @_TF18switch_int_literal1bFT_T_
+  case 1:
+    b()
+  // CHECK: [[CASE2]]:
+  // CHECK:   function_ref @_TF18switch_int_literal1cFT_T_
+  case -7:
+    c()
+  // CHECK: [[DEFAULT]]:
+  // CHECK:   function_ref @_TF18switch_int_literal1dFT_T_
+  default:
+    d()
+  }
+}
+
+// Repeated values and guarded rows keep the ordinary ~= tests.
+// CHECK-LABEL: sil hidden @_TF18switch_int_literal5test2FVs5UInt8T_
+func test2(_ x: UInt8) {
+  switch x {
+  // CHECK:   switch_value {{%.*}} : $Builtin.Int8, case {{%.*}}: {{bb[0-9]+}}, case {{%.*}}: {{bb[0-9]+}}, default [[DEFAULT:bb[0-9]+]]
+  case 1, 2:
+    a()
+  // CHECK: [[DEFAULT]]:
+  // CHECK:   function_ref @_TFsoi2teuRxs9EquatablerFTxx_Sb
+  case 1:
+    b()
+  case 3 where x > 2:
+    c()
+  default:
+    d()
+  }
+}
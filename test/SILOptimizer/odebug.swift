@@ -0,0 +1,20 @@
+// RUN: %target-swift-frontend -module-name odebug %s -Odebug -emit-sil | %FileCheck %s
+
+// Check that -Odebug specializes generic code, but keeps the variables of the
+// caller inspectable.
+
+@inline(never)
+func twice<T : Equatable>(_ x: T) -> [T] {
+  return [x, x]
+}
+
+// CHECK-LABEL: sil hidden @_TF6odebug4testFT_Si
+// CHECK: debug_value {{.*}} let, name "value"
+// CHECK: function_ref @_TTSg5Si{{.*}}5twice
+// CHECK: debug_value {{.*}} let, name "result"
+// CHECK: return
+func test() -> Int {
+  let value = 27
+  let result = twice(value)
+  return result.count
+}
@@ -0,0 +1,46 @@
+// RUN: %target-swift-frontend -O -emit-sil %s -o /dev/null -Rpass=sil-inliner -verify
+// RUN: %target-swift-frontend -O -emit-sil %s -o /dev/null -Rpass-missed=sil-inliner -verify -DMISSED
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %target-swift-frontend -O -emit-sil %s -o /dev/null -save-optimization-record-path %t/opt-remarks.opt.yaml
+// RUN: %FileCheck -check-prefix=YAML %s < %t/opt-remarks.opt.yaml
+
+func small() -> Int {
+  return 27
+}
+
+#if MISSED
+func large(_ x: Int) -> Int {
+  var result = x
+  for i in 0..<x {
+    result = result &* 31 &+ i
+    result = result ^ (result >> 7)
+    result = result &+ (result << 3)
+    result = result ^ (result >> 11)
+    result = result &* 17
+  }
+  print(result)
+  print(result &+ 1)
+  print(result &+ 2)
+  return result
+}
+
+public func callLarge(_ x: Int) -> Int {
+  return large(x) &+ large(x &+ 1) // expected-remark 2 {{Not profitable to inline large(_:) -> Int}}
+}
+#else
+public func callSmall() -> Int {
+  return small() // expected-remark {{small() -> Int inlined into callSmall() -> Int}}
+}
+#endif
+
+// YAML:      Pass: sil-inliner
+// YAML-NEXT: Name: Inlined
+// YAML-NEXT: DebugLoc: { File: {{.*}}opt-remarks.swift, Line: 32, Column: {{[0-9]+}} }
+// YAML-NEXT: Function: {{.*}}callSmall
+// YAML-NEXT: Args:
+// YAML-NEXT:   - Callee: {{'?}}small() -> Int{{'?}}
+// YAML-NEXT:     DebugLoc: { File: {{.*}}opt-remarks.swift, Line: 7, Column: {{[0-9]+}} }
+// YAML-NEXT:   - String: ' inlined into '
+// YAML-NEXT:   - Caller: {{'?}}callSmall() -> Int{{'?}}
+// YAML-NEXT:     DebugLoc: { File: {{.*}}opt-remarks.swift, Line: 31, Column: {{[0-9]+}} }
+// YAML-NEXT: ...
@@ -0,0 +1,28 @@
+// RUN: %target-swift-frontend  %s -Onone  -emit-sil | %FileCheck %s
+
+// REQUIRES: optimized_stdlib
+
+// FIXME: https://bugs.swift.org/browse/SR-2808
+// XFAIL: resilient_stdlib
+
+// Check that the pre-specializations of dictionaries and sets are used at
+// -Onone. This test requires the standard library to be compiled with
+// pre-specializations!
+
+// CHECK-LABEL: sil [noinline] @_TF25prespecialize_collections10updateDictFTRGVs10DictionarySSSi_3keySS_T_
+// Look for generic specialization <Swift.String, Swift.Int> of Swift.Dictionary.updateValue
+// CHECK: function_ref @_TTSg{{.*}}_TFVs10Dictionary11updateValue
+// CHECK: return
+@inline(never)
+public func updateDict(_ d: inout [String: Int], key: String) {
+  d.updateValue(1, forKey: key)
+}
+
+// CHECK-LABEL: sil [noinline] @_TF25prespecialize_collections9insertSetFTRGVs3SetSi_7elementSi_T_
+// Look for generic specialization <Swift.Int> of Swift.Set.insert
+// CHECK: function_ref @_TTSg{{.*}}_TFVs3Set6insert
+// CHECK: return
+@inline(never)
+public func insertSet(_ s: inout Set<Int>, element: Int) {
+  s.insert(element)
+}
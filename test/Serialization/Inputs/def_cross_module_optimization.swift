@@ -0,0 +1,31 @@
+public struct Box<T> {
+  public var value: T
+
+  public init(_ value: T) {
+    self.value = value
+  }
+}
+
+@inline(never)
+internal func unwrap<T>(_ box: Box<T>) -> T {
+  return box.value
+}
+
+@inline(never)
+public func roundTrip<T>(_ x: T) -> T {
+  return unwrap(Box(x))
+}
+
+final class Hidden {
+  var count = 0
+}
+
+@inline(never)
+public func makeHidden<T>(_ x: T) -> AnyObject {
+  return Hidden()
+}
+
+@inline(never)
+public func notGeneric(_ x: Int) -> Int {
+  return x + 1
+}
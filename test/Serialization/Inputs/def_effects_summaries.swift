@@ -0,0 +1,12 @@
+@inline(never)
+public func mix(_ x: Int, _ y: Int) -> Int {
+  return (x &* 31) ^ y
+}
+
+public var counter = 0
+
+@inline(never)
+public func bump() -> Int {
+  counter = counter &+ 1
+  return counter
+}
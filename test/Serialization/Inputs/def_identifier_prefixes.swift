@@ -0,0 +1,24 @@
+public struct Prefix {
+  public var a: Int = 0
+  public var ab: Int = 0
+  public var abc: Int = 0
+  public var abcd: Int = 0
+  public var abcde: Int = 0
+  public var abd: Int = 0
+  public var abe: Int = 0
+  public var b: Int = 0
+  public var ba: Int = 0
+  public var value: Int = 0
+  public var value1: Int = 0
+  public var value10: Int = 0
+  public var value11: Int = 0
+  public var value2: Int = 0
+  public var valueA: Int = 0
+  public var valueAB: Int = 0
+  public var valueB: Int = 0
+  public var values: Int = 0
+  public var valueWithAVeryLongNameSharingAPrefix: Int = 0
+  public var valueWithAVeryLongNameSharingAPrefixToo: Int = 0
+  public var z: Int = 0
+  public init() {}
+}
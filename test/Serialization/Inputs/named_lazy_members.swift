@@ -0,0 +1,24 @@
+public struct Box {
+  public var value: Int
+  public init(value: Int) { self.value = value }
+  public func get() -> Int { return value }
+  public func get(plus other: Int) -> Int { return value + other }
+  public struct Nested {
+    public init() {}
+  }
+}
+
+extension Box {
+  public func doubled() -> Box { return Box(value: value * 2) }
+  public static var zero: Box { return Box(value: 0) }
+}
+
+public class Base {
+  public init() {}
+  public func describe() -> String { return "Base" }
+}
+
+public enum Choice {
+  case first, second
+  public var isFirst: Bool { return self == .first }
+}
@@ -0,0 +1,33 @@
+// RUN: rm -rf %t
+// RUN: mkdir -p %t
+// RUN: %target-swift-frontend -emit-module -O -cross-module-optimization -module-name def_cross_module_optimization -o %t %S/Inputs/def_cross_module_optimization.swift
+// RUN: llvm-bcanalyzer %t/def_cross_module_optimization.swiftmodule | %FileCheck %s -check-prefix=BCANALYZER
+// RUN: %target-swift-frontend -emit-silgen -sil-link-all -I %t %s | %FileCheck %s
+// RUN: %target-swift-frontend -emit-silgen -sil-link-all -I %t %s | %FileCheck %s -check-prefix=NEGATIVE
+// RUN: %target-swift-frontend -emit-sil -O -I %t %s | %FileCheck %s -check-prefix=OPT
+
+// BCANALYZER-NOT: UnknownCode
+
+import def_cross_module_optimization
+
+// Generic code, and the internal code it calls, is available to clients.
+// CHECK-DAG: sil public_external [fragile] [noinline] @_TF29def_cross_module_optimization9roundTrip{{.*}} {
+// CHECK-DAG: sil hidden_external [fragile] [noinline] @_TF29def_cross_module_optimization6unwrap{{.*}} {
+
+// Code that uses internal types or isn't generic is not.
+// NEGATIVE-NOT: sil public_external [fragile] {{.*}}@_TF29def_cross_module_optimization10makeHidden{{.*}} {
+// NEGATIVE-NOT: sil public_external [fragile] {{.*}}@_TF29def_cross_module_optimization10notGeneric{{.*}} {
+
+// The client specializes the generic function for its own types.
+// OPT-LABEL: sil shared [noinline] @_TTSg5Si___TF29def_cross_module_optimization9roundTrip
+public func testRoundTrip() -> Int {
+  return roundTrip(42)
+}
+
+public func testMakeHidden() -> AnyObject {
+  return makeHidden(42)
+}
+
+public func testNotGeneric() -> Int {
+  return notGeneric(42)
+}
@@ -0,0 +1,30 @@
+// RUN: rm -rf %t
+// RUN: mkdir -p %t
+// RUN: %target-swift-frontend -emit-module -O -cross-module-optimization -module-name def_effects_summaries -o %t %S/Inputs/def_effects_summaries.swift
+// RUN: llvm-bcanalyzer %t/def_effects_summaries.swiftmodule | %FileCheck %s -check-prefix=BCANALYZER
+// RUN: %target-swift-frontend -emit-sil -O -I %t %s | %FileCheck %s
+// RUN: %target-swift-frontend -emit-sil -O -I %t %s | %FileCheck %s -check-prefix=DECL
+
+// BCANALYZER-NOT: UnknownCode
+
+import def_effects_summaries
+
+// The client doesn't see the bodies, but it knows that mix() has no side
+// effects, so a call with an unused result is removed.
+// CHECK-LABEL: sil @_TF17effects_summaries7testMixFT_T_
+// CHECK-NOT: apply
+// CHECK: return
+public func testMix() {
+  _ = mix(1, 2)
+}
+
+// bump() writes a global, so the call stays.
+// CHECK-LABEL: sil @_TF17effects_summaries8testBumpFT_T_
+// CHECK: apply
+// CHECK: return
+public func testBump() {
+  _ = bump()
+}
+
+// DECL: sil {{.*}}[readnone] @_TF21def_effects_summaries3mixFTSiSi_Si
+// DECL-NOT: sil {{.*}}[read{{.*}} @_TF21def_effects_summaries4bumpFT_Si
@@ -0,0 +1,35 @@
+// RUN: rm -rf %t
+// RUN: mkdir -p %t
+// RUN: %target-swift-frontend -emit-module -o %t %S/Inputs/def_identifier_prefixes.swift
+// RUN: llvm-bcanalyzer %t/def_identifier_prefixes.swiftmodule | %FileCheck %s
+// RUN: %target-swift-frontend -typecheck -I %t %s
+
+// CHECK-NOT: UnknownCode
+
+// Identifiers are front-coded in groups, so use enough of them with shared
+// prefixes to need more than one group.
+
+import def_identifier_prefixes
+
+let p = Prefix()
+_ = p.a
+_ = p.ab
+_ = p.abc
+_ = p.abcd
+_ = p.abcde
+_ = p.abd
+_ = p.abe
+_ = p.b
+_ = p.ba
+_ = p.value
+_ = p.value1
+_ = p.value10
+_ = p.value11
+_ = p.value2
+_ = p.valueA
+_ = p.valueAB
+_ = p.valueB
+_ = p.values
+_ = p.valueWithAVeryLongNameSharingAPrefix
+_ = p.valueWithAVeryLongNameSharingAPrefixToo
+_ = p.z
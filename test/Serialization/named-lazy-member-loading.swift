@@ -0,0 +1,28 @@
+// RUN: rm -rf %t
+// RUN: mkdir -p %t
+// RUN: %target-swift-frontend -emit-module -o %t %S/Inputs/named_lazy_members.swift
+// RUN: %target-swift-frontend -typecheck -verify -I %t %s
+// RUN: %target-swift-frontend -typecheck -verify -enable-named-lazy-member-loading -I %t %s
+// RUN: %target-swift-frontend -emit-sil -enable-named-lazy-member-loading -I %t %s -o /dev/null
+
+import named_lazy_members
+
+func useBox(_ b: Box) -> Int {
+  _ = Box.Nested()
+  _ = Box.zero
+  _ = b.doubled().get(plus: 1)
+  return b.get() + b.value
+}
+
+func useOthers(_ c: Choice, _ base: Base) -> Bool {
+  _ = base.describe()
+  return c.isFirst || Choice.second.isFirst
+}
+
+class Derived : Base {
+  override func describe() -> String { return "Derived" }
+}
+
+func missing(_ b: Box) {
+  b.missing() // expected-error {{value of type 'Box' has no member 'missing'}}
+}
@@ -124,3 +124,32 @@ struct UnnamedArgs {
 // UNNAMED_ARGS_0-NEXT: ]
 // UNNAMED_ARGS_0-NEXT: Results for filterText: unnamed [
 // UNNAMED_ARGS_0-NEXT: ]
+
+func testNarrowing(x: Foo) {
+  x.#^NARROW,b,bc,a,ab,abc,c^#
+}
+// A longer filter text only re-filters the previous matches, but moving from
+// prefix to fuzzy matching, or to an unrelated filter text, must not lose
+// results.
+// RUN: %complete-test -fuzz -tok=NARROW %s | %FileCheck %s -check-prefix=NARROW
+// NARROW-LABEL: Results for filterText: b [
+// NARROW-NEXT:   b()
+// NARROW-NEXT: ]
+// NARROW-LABEL: Results for filterText: bc [
+// NARROW-NEXT:   abc()
+// NARROW-NEXT: ]
+// NARROW-LABEL: Results for filterText: a [
+// NARROW-NEXT:   aaa()
+// NARROW-NEXT:   aab()
+// NARROW-NEXT:   abc()
+// NARROW-NEXT: ]
+// NARROW-LABEL: Results for filterText: ab [
+// NARROW-DAG:   aab()
+// NARROW-DAG:   abc()
+// NARROW: ]
+// NARROW-LABEL: Results for filterText: abc [
+// NARROW-NEXT:   abc()
+// NARROW-NEXT: ]
+// NARROW-LABEL: Results for filterText: c [
+// NARROW-NEXT:   c()
+// NARROW-NEXT: ]
@@ -0,0 +1,30 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %target-swift-frontend -typecheck -module-name index_from_store -index-store-path %t/idx %s
+// RUN: ls %t/idx/records | count 1
+
+// Compiling again with unchanged contents keeps the existing record.
+// RUN: %target-swift-frontend -typecheck -module-name index_from_store -index-store-path %t/idx %s
+// RUN: ls %t/idx/records | count 1
+
+// Options that change how the file is indexed get a record of their own.
+// RUN: %target-swift-frontend -typecheck -module-name index_from_store -index-store-path %t/idx -D EXTRA %s
+// RUN: ls %t/idx/records | count 2
+
+// Indexing through the store reports the same entities as indexing the file.
+// RUN: %sourcekitd-test -req=index %s -- -module-name index_from_store %s | %sed_clean > %t.direct
+// RUN: %sourcekitd-test -req=index %s -- -module-name index_from_store -index-store-path %t/idx %s | %sed_clean > %t.replayed
+// RUN: diff -u %t.direct %t.replayed
+
+protocol Shape {
+  func area() -> Double
+}
+
+struct Square : Shape {
+  var side: Double
+  @discardableResult
+  func area() -> Double { return side * side }
+}
+
+func totalArea(_ shapes: [Shape]) -> Double {
+  return shapes.reduce(0) { $0 + $1.area() }
+}
@@ -0,0 +1,11 @@
+// RUN: rm -rf %t.mod
+// RUN: mkdir -p %t.mod
+// RUN: %swift -emit-module -o %t.mod/swift_mod.swiftmodule %S/Inputs/swift_mod.swift -parse-as-library
+
+// Opening the interface again reuses the one which was already generated and
+// reports the same editor info.
+
+// RUN: %sourcekitd-test -req=interface-gen -module swift_mod -- -I %t.mod \
+// RUN:   == -req=interface-gen -module swift_mod -- -I %t.mod > %t.response
+// RUN: cat %S/gen_swift_module.swift.response %S/gen_swift_module.swift.response > %t.expected
+// RUN: diff -u %t.expected %t.response
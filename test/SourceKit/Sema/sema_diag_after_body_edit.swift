@@ -0,0 +1,28 @@
+func foo() {
+  let a = 0
+}
+
+func bar() {
+  let b: Int = "xyz"
+}
+
+// Test that the diagnostics of a function body that was not edited are kept,
+// at their updated positions, when only another function body is edited.
+
+// RUN: %sourcekitd-test -req=open %s -- %s == -req=print-diags %s \
+// RUN:    == -req=edit -pos=2:7 -replace="aaaa" -length=1 %s == -req=print-diags %s \
+// RUN: | %FileCheck %s
+
+// CHECK:      key.line: 2,
+// CHECK-NEXT: key.column: 7,
+// CHECK:      key.description: "initialization of immutable value 'a'
+// CHECK:      key.line: 6,
+// CHECK:      key.description: "cannot convert value of type 'String' to specified type 'Int'"
+
+// == After the edit =====
+
+// CHECK:      key.line: 2,
+// CHECK-NEXT: key.column: 7,
+// CHECK:      key.description: "initialization of immutable value 'aaaa'
+// CHECK:      key.line: 6,
+// CHECK:      key.description: "cannot convert value of type 'String' to specified type 'Int'"
@@ -0,0 +1,38 @@
+// RUN: %sourcekitd-test -req=annotations -line=6 -length=2 %s | %FileCheck %s
+
+func foo() {}
+
+struct S {
+  var a: Int
+  func b() {}
+}
+
+// CHECK:      key.offset: 106,
+// CHECK-NEXT: key.length: 27,
+// CHECK-NEXT: key.syntaxmap: [
+// CHECK-NEXT:   {
+// CHECK-NEXT:     key.kind: source.lang.swift.syntaxtype.keyword,
+// CHECK-NEXT:     key.offset: 108,
+// CHECK-NEXT:     key.length: 3
+// CHECK-NEXT:   },
+// CHECK-NEXT:   {
+// CHECK-NEXT:     key.kind: source.lang.swift.syntaxtype.identifier,
+// CHECK-NEXT:     key.offset: 112,
+// CHECK-NEXT:     key.length: 1
+// CHECK-NEXT:   },
+// CHECK-NEXT:   {
+// CHECK-NEXT:     key.kind: source.lang.swift.syntaxtype.typeidentifier,
+// CHECK-NEXT:     key.offset: 115,
+// CHECK-NEXT:     key.length: 3
+// CHECK-NEXT:   },
+// CHECK-NEXT:   {
+// CHECK-NEXT:     key.kind: source.lang.swift.syntaxtype.keyword,
+// CHECK-NEXT:     key.offset: 121,
+// CHECK-NEXT:     key.length: 4
+// CHECK-NEXT:   },
+// CHECK-NEXT:   {
+// CHECK-NEXT:     key.kind: source.lang.swift.syntaxtype.identifier,
+// CHECK-NEXT:     key.offset: 126,
+// CHECK-NEXT:     key.length: 1
+// CHECK-NEXT:   }
+// CHECK-NEXT: ]
@@ -0,0 +1,77 @@
+// RUN: %target-run-simple-swift
+// REQUIRES: executable_test
+
+import StdlibUnittest
+
+var ConcurrentAlgorithms = TestSuite("ConcurrentAlgorithms")
+
+// Enough elements that every chunk has several, and a count which doesn't
+// divide evenly into chunks.
+let counts = [0, 1, 2, 63, 64, 65, 1_000, 10_007]
+
+ConcurrentAlgorithms.test("concurrentMap") {
+  for count in counts {
+    let input = Array(0..<count)
+    expectEqual(input.map { $0 * 3 }, input.concurrentMap { $0 * 3 })
+    expectEqual(input.map { String($0) }, input.concurrentMap { String($0) })
+  }
+}
+
+ConcurrentAlgorithms.test("concurrentMap/Slice") {
+  let input = Array(0..<1_000)[100..<900]
+  expectEqual(input.map { $0 + 1 }, input.concurrentMap { $0 + 1 })
+}
+
+ConcurrentAlgorithms.test("concurrentForEach") {
+  for count in counts {
+    var seen = Array(repeating: 0, count: count)
+    seen.withUnsafeMutableBufferPointer { buffer in
+      let base = buffer.baseAddress
+      (0..<count).concurrentForEach { base![$0] += 1 }
+    }
+    expectEqual(Array(repeating: 1, count: count), seen)
+  }
+}
+
+ConcurrentAlgorithms.test("concurrentReduce") {
+  for count in counts {
+    let input = Array(0..<count)
+    expectEqual(input.reduce(0, +), input.concurrentReduce(0, +, combining: +))
+    expectEqual(
+      input.reduce("") { $0 + String($1 % 10) },
+      input.concurrentReduce("", { $0 + String($1 % 10) }, combining: +))
+  }
+}
+
+ConcurrentAlgorithms.test("concurrentReduce/Deterministic") {
+  let input = (0..<10_007).map { 1.0 / Double($0 + 1) }
+  let first = input.concurrentReduce(0, +, combining: +)
+  for _ in 0..<10 {
+    expectEqual(first, input.concurrentReduce(0, +, combining: +))
+  }
+}
+
+ConcurrentAlgorithms.test("concurrentSorted") {
+  for count in counts {
+    // A fixed pseudo-random permutation with repeated elements.
+    let input = (0..<count).map { ($0 &* 7_919) % 1_009 }
+    expectEqual(input.sorted(), input.concurrentSorted())
+    expectEqual(input.sorted(by: >), input.concurrentSorted(by: >))
+    expectEqual(
+      input.map { String($0) }.sorted(),
+      input.map { String($0) }.concurrentSorted())
+  }
+}
+
+ConcurrentAlgorithms.test("concurrentSorted/Nested") {
+  let groups = (0..<100).map { group in
+    (0..<500).map { ($0 &* 31 &+ group) % 500 }
+  }
+  let sortedGroups = groups.concurrentMap { $0.concurrentSorted() }
+  expectEqual(groups.count, sortedGroups.count)
+  for (group, sortedGroup) in zip(groups, sortedGroups) {
+    expectEqual(group.sorted(), sortedGroup)
+  }
+}
+
+runAllTests()
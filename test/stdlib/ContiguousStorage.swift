@@ -0,0 +1,77 @@
+// RUN: %target-run-simple-swift
+// REQUIRES: executable_test
+
+import StdlibUnittest
+
+var ContiguousStorage = TestSuite("ContiguousStorage")
+
+func contiguousElements<S : Sequence>(_ s: S) -> [S.Iterator.Element]? {
+  return s.withContiguousStorageIfAvailable { Array($0) }
+}
+
+ContiguousStorage.test("Available") {
+  let array = [1, 2, 3, 4, 5]
+  expectEqual(array, contiguousElements(array)!)
+  expectEqual(array, contiguousElements(ContiguousArray(array))!)
+  expectEqual([2, 3, 4], contiguousElements(array[1..<4])!)
+  expectEqual([], contiguousElements([Int]())!)
+
+  array.withUnsafeBufferPointer { buffer in
+    expectEqual(array, contiguousElements(buffer)!)
+    var copy = array
+    copy.withUnsafeMutableBufferPointer { mutableBuffer in
+      expectEqual(array, contiguousElements(mutableBuffer)!)
+    }
+  }
+}
+
+ContiguousStorage.test("Unavailable") {
+  expectNil(contiguousElements(0..<5))
+  expectNil(contiguousElements(AnySequence([1, 2, 3])))
+  expectNil(contiguousElements([1, 2, 3].lazy.map { $0 }))
+}
+
+func appendGeneric<
+  C : RangeReplaceableCollection, S : Sequence
+>(_ c: inout C, _ s: S) where C.Iterator.Element == S.Iterator.Element {
+  c.append(contentsOf: s)
+}
+
+ContiguousStorage.test("BulkCopies") {
+  let source = (0..<100).map { String($0) }
+
+  var appended = ["a"]
+  appendGeneric(&appended, source)
+  expectEqual(["a"] + source, appended)
+
+  source.withUnsafeBufferPointer { buffer in
+    expectEqual(source, Array(buffer))
+
+    var replaced = ["a", "b", "c"]
+    replaced.replaceSubrange(1..<2, with: buffer)
+    expectEqual(["a"] + source + ["c"], replaced)
+
+    replaced = source + source
+    replaced.replaceSubrange(0..<150, with: buffer)
+    expectEqual(source + source[50..<100], replaced)
+
+    replaced = ["a"]
+    replaced.insert(contentsOf: buffer, at: 0)
+    expectEqual(source + ["a"], replaced)
+  }
+}
+
+ContiguousStorage.test("elementsEqual") {
+  let a = [1, 2, 3]
+  expectTrue(a.elementsEqual(ContiguousArray(a)))
+  expectTrue(a.elementsEqual([0, 1, 2, 3][1..<4]))
+  expectFalse(a.elementsEqual([1, 2]))
+  expectFalse(a.elementsEqual([1, 2, 3, 4]))
+  expectFalse(a.elementsEqual([1, 2, 4]))
+  expectTrue(a.elementsEqual([2, 4, 6]) { $0 * 2 == $1 })
+  expectFalse(a.elementsEqual([2, 4, 7]) { $0 * 2 == $1 })
+  expectTrue([Double.nan].elementsEqual([Double.nan]) { $0.isNaN && $1.isNaN })
+  expectFalse([Double.nan].elementsEqual([Double.nan]))
+}
+
+runAllTests()
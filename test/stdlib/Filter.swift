@@ -60,4 +60,30 @@ FilterTests.test("filtering sequences") {
   expectEqualSequence([7, 14, 21, 28], f1)
 }
 
+FilterTests.test("filtering filtered collections") {
+  var calls = 0
+  var f0 = (0..<30).lazy.filter { $0 % 2 == 0 }.filter {
+    (x: Int) -> Bool in
+    calls += 1
+    return x % 3 == 0
+  }
+  expectType(LazyFilterBidirectionalCollection<CountableRange<Int>>.self, &f0)
+
+  var result: [Int] = []
+  for x in f0 {
+    result.append(x)
+  }
+  expectEqual([0, 6, 12, 18, 24], result)
+  // The second predicate only sees elements which pass the first.
+  expectEqual(15, calls)
+  expectEqualSequence([24, 18, 12, 6, 0], f0.reversed())
+}
+
+FilterTests.test("filtering filtered sequences") {
+  var f0 = (0..<30).makeIterator().lazy.filter { $0 % 2 == 0 }
+    .filter { $0 % 3 == 0 }
+  expectType(LazyFilterSequence<CountableRange<Int>.Iterator>.self, &f0)
+  expectEqualSequence([0, 6, 12, 18, 24], f0)
+}
+
 runAllTests()
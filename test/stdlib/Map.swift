@@ -100,5 +100,18 @@ print(Array(m1))
 // CHECK-NEXT: [2, 4, 6, 8]
 print(Array(m1))
 
+// Chained maps compose into a single view over the original base.
+let m2 = IntRange(start: 1, end: 5).lazy.map { $0 * 2 }.map { $0 + 1 }
+// CHECK-NEXT: LazyMapSequence<IntRange, Int>
+print(type(of: m2))
+// CHECK-NEXT: [3, 5, 7, 9]
+print(Array(m2))
+
+let m3 = [1, 2, 3].lazy.map { $0 * 2 }.map { "<\($0)>" }
+// CHECK-NEXT: LazyMapRandomAccessCollection<Array<Int>, String>
+print(type(of: m3))
+// CHECK-NEXT: ["<2>", "<4>", "<6>"]
+print(Array(m3))
+
 // CHECK-NEXT: all done.
 print("all done.")
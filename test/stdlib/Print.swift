@@ -53,6 +53,55 @@ PrintTests.test("Varargs") {
   expectEqual("|1|2|3|4|\n", s3)
 }
 
+struct ChunkedStream : TextOutputStream {
+  var chunks: [String] = []
+  var asciiChunkCount = 0
+
+  mutating func write(_ string: String) {
+    chunks.append(string)
+  }
+
+  mutating func _writeASCII(_ buffer: UnsafeBufferPointer<UInt8>) {
+    asciiChunkCount += 1
+    chunks.append(
+      String._fromWellFormedCodeUnitSequence(UTF8.self, input: buffer))
+  }
+}
+
+struct StringOnlyStream : TextOutputStream {
+  var contents = ""
+
+  mutating func write(_ string: String) {
+    contents += string
+  }
+}
+
+PrintTests.test("NumbersWriteASCII") {
+  var s0 = ChunkedStream()
+  print(42, -7, UInt8(255), Int64.min, 1.5, Float(0.25), 1 / 0.0,
+    separator: ",", terminator: "", to: &s0)
+  expectEqual("42,-7,255,-9223372036854775808,1.5,0.25,inf",
+    s0.chunks.joined())
+  // Infinity and NaN still go through `write(_:)`.
+  expectEqual(6, s0.asciiChunkCount)
+
+  var s1 = StringOnlyStream()
+  print(UInt.max, -0.5, separator: " ", to: &s1)
+  expectEqual("\(UInt.max) -0.5\n", s1.contents)
+
+  var s2 = "\u{00B5}"
+  17.write(to: &s2)
+  Double(2.5).write(to: &s2)
+  Int.min.write(to: &s2)
+  expectEqual("\u{00B5}172.5\(Int.min)", s2)
+
+  var s3 = ""
+  for i in 0..<1000 {
+    i.write(to: &s3)
+  }
+  expectEqual((0..<1000).map { String($0) }.joined(), s3)
+}
+
 PrintTests.test("PlaygroundPrintHook") {
   var printed = ""
   _playgroundPrintHook = { printed = $0 }
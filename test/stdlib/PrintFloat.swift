@@ -267,4 +267,30 @@ PrintTests.test("Printable") {
 #endif
 }
 
+PrintTests.test("Printable/Rounding") {
+  // Values whose shortest round-trip representation fits in `digits10`
+  // digits and values that need to be rounded to `digits10` digits must be
+  // printed the same way.
+  expectPrinted("0.1", Float(0.1))
+  expectPrinted("0.3", Float(0.1) + Float(0.2))
+  expectPrinted("1.67772e+07", Float(16777216.0))
+  expectPrinted("123457.0", Float(123456.8))
+  expectPrinted("3.40282e+38", Float.greatestFiniteMagnitude)
+  expectPrinted("1.17549e-38", Float.leastNormalMagnitude)
+  expectPrinted("1.4013e-45", Float.leastNonzeroMagnitude)
+
+  expectPrinted("0.1", 0.1)
+  expectPrinted("0.3", 0.1 + 0.2)
+  expectPrinted("3.14159265358979", Double.pi)
+  expectPrinted("123456789012345.0", 123456789012345.0)
+  expectPrinted("1.23456789012346e+15", 1234567890123456.0)
+  expectPrinted("1e+15", 1e15)
+  expectPrinted("1e-05", 0.00001)
+  expectPrinted("0.0001", 0.0001)
+  expectPrinted("-2.5e-100", -2.5e-100)
+  expectPrinted("1.79769313486232e+308", Double.greatestFiniteMagnitude)
+  expectPrinted("2.2250738585072e-308", Double.leastNormalMagnitude)
+  expectPrinted("4.94065645841247e-324", Double.leastNonzeroMagnitude)
+}
+
 runAllTests()
@@ -146,4 +146,29 @@ PrintTests.test("Printable") {
   expectPrinted("*", CChar32(42)!)
 }
 
+PrintTests.test("Printable/Radix") {
+  expectPrinted("-9223372036854775808", Int64.min)
+  expectPrinted("18446744073709551615", UInt64.max)
+  expectPrinted("1000000", 1000000)
+  expectPrinted("99", 99)
+  expectPrinted("0", 0)
+  expectEqual("7fffffffffffffff", String(Int64.max, radix: 16))
+  expectEqual("-1000", String(-8, radix: 2))
+  expectEqual("ZZ", String(1295, radix: 36, uppercase: true))
+  expectEqual("-777", String(-511, radix: 8))
+}
+
+PrintTests.test("_int64ToString(_:into:)") {
+  var bytes = [UInt8](repeating: 0, count: 65)
+  bytes.withUnsafeMutableBufferPointer { buffer in
+    let count = _int64ToString(-1234567890, into: buffer)
+    expectEqualSequence("-1234567890".utf8, buffer[0..<count])
+    let hexCount = _uint64ToString(
+      0xBEEF, into: buffer, radix: 16, uppercase: true)
+    expectEqualSequence("BEEF".utf8, buffer[0..<hexCount])
+    let binaryCount = _uint64ToString(5, into: buffer, radix: 2)
+    expectEqualSequence("101".utf8, buffer[0..<binaryCount])
+  }
+}
+
 runAllTests()
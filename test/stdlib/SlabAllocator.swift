@@ -0,0 +1,37 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %target-build-swift %s -o %t/a.out
+// RUN: env SWIFT_RUNTIME_SLAB_ALLOCATOR=1 %target-run %t/a.out
+// REQUIRES: executable_test
+// REQUIRES: slab-allocator
+
+// Small tail-allocated buffers come from slabs, so asking for their capacity
+// must not end up in malloc_size.
+
+import StdlibUnittest
+
+let SlabAllocatorTests = TestSuite("SlabAllocator")
+
+SlabAllocatorTests.test("Array/Grow") {
+  var a: [Int] = []
+  for i in 0..<1000 {
+    a.append(i)
+    expectGE(a.capacity, a.count)
+  }
+  expectEqual(Array(0..<1000), a)
+
+  let small = [1, 2, 3]
+  expectGE(small.capacity, 3)
+}
+
+SlabAllocatorTests.test("ManagedBuffer/Grow") {
+  for minimumCapacity in 0..<64 {
+    let buffer = ManagedBuffer<Int, Int>.create(
+      minimumCapacity: minimumCapacity) { _ in 0 }
+    expectGE(buffer.capacity, minimumCapacity)
+    _ = buffer.withUnsafeMutablePointerToElements { elements in
+      elements.initialize(to: 0, count: buffer.capacity)
+    }
+  }
+}
+
+runAllTests()
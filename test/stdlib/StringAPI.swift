@@ -76,6 +76,14 @@ let tests = [
   ComparisonTest(.lt, "a", "a\u{301}"),
   ComparisonTest(.lt, "a", "\u{e1}"),
 
+  // Common ASCII prefixes, followed by a combining mark on either side.
+  ComparisonTest(.eq, "abca\u{301}", "abc\u{e1}"),
+  ComparisonTest(.eq, "abc\u{e1}", "abca\u{301}"),
+  ComparisonTest(.lt, "abca", "abca\u{301}"),
+  ComparisonTest(.lt, "abca\u{301}", "abcb"),
+  ComparisonTest(.lt, "prefix-a", "prefix-b"),
+  ComparisonTest(.lt, "prefix", "prefix-"),
+
   // U+304B HIRAGANA LETTER KA
   // U+304C HIRAGANA LETTER GA
   // U+3099 COMBINING KATAKANA-HIRAGANA VOICED SOUND MARK
@@ -361,6 +369,25 @@ StringTests.test("CompareStringsWithUnpairedSurrogates")
   )
 }
 
+StringTests.test("CharacterView/count") {
+  let samples: [(String, [String])] = [
+    ("", []),
+    ("abc", ["a", "b", "c"]),
+    ("a\r\nb\r\r\n", ["a", "\r\n", "b", "\r", "\r\n"]),
+    ("\n\r", ["\n", "\r"]),
+    ("e\u{301}x", ["e\u{301}", "x"]),
+    ("caf\u{e9}\r\n\u{e9}\u{301}", ["c", "a", "f", "\u{e9}", "\r\n",
+      "\u{e9}\u{301}"]),
+    ("\u{1f1fa}\u{1f1f8}a", ["\u{1f1fa}\u{1f1f8}", "a"]),
+  ]
+  for (string, expected) in samples {
+    expectEqual(expected.count, string.characters.count)
+    expectEqualSequence(expected, string.characters.map { String($0) })
+    expectEqualSequence(
+      expected.reversed(), string.characters.reversed().map { String($0) })
+  }
+}
+
 var CStringTests = TestSuite("CStringTests")
 
 func getNullUTF8() -> UnsafeMutablePointer<UInt8>? {
@@ -500,6 +527,71 @@ CStringTests.test("String(cString:)") {
   }
 }
 
+CStringTests.test("String(cString:)/long") {
+  // Longer than the 16-byte chunks of the vectorized transcoding, with
+  // non-ASCII characters around chunk boundaries.
+  let samples = [
+    String(repeating: "a", count: 100),
+    String(repeating: "a", count: 15) + "\u{e9}" +
+      String(repeating: "b", count: 33),
+    String(repeating: "xyz", count: 11) + "\u{20ac}\u{1f600}" +
+      String(repeating: "q", count: 17),
+    String(repeating: "\u{430}\u{431}", count: 40),
+  ]
+  for expected in samples {
+    let utf8 = Array(expected.utf8) + [0]
+    utf8.withUnsafeBufferPointer {
+      expectEqual(expected, String(cString: $0.baseAddress!))
+    }
+    expectEqualSequence(asCCharArray(utf8), expected.utf8CString)
+  }
+
+  // Ill-formed input after a long ASCII prefix is still repaired.
+  let illFormed: [UInt8] = Array(repeating: 0x41, count: 40) +
+    [0xed, 0xa0, 0x80, 0x41, 0]
+  illFormed.withUnsafeBufferPointer {
+    expectEqual(
+      String(repeating: "A", count: 40) + "\u{fffd}\u{fffd}\u{fffd}A",
+      String(cString: $0.baseAddress!))
+    expectNil(String(validatingUTF8: bindAsCChar($0.baseAddress!)))
+  }
+}
+
+CStringTests.test("String(adoptingUTF8:count:deallocator:)") {
+  var deallocations = 0
+  func adopt(_ utf8: [UInt8], spareBytes: Int) -> String {
+    let buffer = UnsafeMutableRawBufferPointer(
+      start: UnsafeMutableRawPointer.allocate(
+        bytes: utf8.count + spareBytes, alignedTo: 1),
+      count: utf8.count + spareBytes)
+    buffer.copyBytes(from: utf8)
+    return String(adoptingUTF8: buffer, count: utf8.count) {
+      $0.baseAddress!.deallocate(bytes: $0.count, alignedTo: 1)
+      deallocations += 1
+    }
+  }
+
+  // ASCII content with a spare byte is adopted without copying.
+  do {
+    var s = adopt(Array("hello, adopted world".utf8), spareBytes: 1)
+    expectEqual("hello, adopted world", s)
+    expectEqual(0, deallocations)
+    let copy = s
+    s += "!"
+    expectEqual("hello, adopted world!", s)
+    expectEqual("hello, adopted world", copy)
+  }
+  expectEqual(1, deallocations)
+
+  // Non-ASCII content, and content filling the buffer, is copied.
+  expectEqual("caf\u{e9}", adopt([0x63, 0x61, 0x66, 0xc3, 0xa9], spareBytes: 1))
+  expectEqual(2, deallocations)
+  expectEqual("abc", adopt(Array("abc".utf8), spareBytes: 0))
+  expectEqual(3, deallocations)
+  expectEqual("\u{fffd}A", adopt([0xff, 0x41], spareBytes: 4))
+  expectEqual(4, deallocations)
+}
+
 CStringTests.test("String.decodeCString") {
   do {
     let s = getNullUTF8()
@@ -0,0 +1,73 @@
+// RUN: %target-run-simple-swift
+// REQUIRES: executable_test
+
+import StdlibUnittest
+
+var TemporaryAllocationTests = TestSuite("TemporaryAllocation")
+
+TemporaryAllocationTests.test("Typed") {
+  for capacity in [0, 1, 10, 100, 1_000, 10_000] {
+    let result = withUnsafeTemporaryAllocation(
+      of: LifetimeTracked.self, capacity: capacity
+    ) { buffer -> [Int] in
+      expectEqual(capacity, buffer.count)
+      expectEqual(0,
+        UInt(bitPattern: buffer.baseAddress!) %
+          UInt(MemoryLayout<LifetimeTracked>.alignment))
+      buffer.baseAddress!.initialize(
+        from: (0..<capacity).map { LifetimeTracked($0) })
+      defer { buffer.baseAddress!.deinitialize(count: capacity) }
+      return buffer.map { $0.value }
+    }
+    expectEqualSequence(0..<capacity, result)
+  }
+}
+
+TemporaryAllocationTests.test("Raw") {
+  for alignment in [1, 2, 4, 8, 16, 32, 64] {
+    for byteCount in [0, 1, 100, 1_000, 100_000] {
+      withUnsafeTemporaryAllocation(
+        byteCount: byteCount, alignment: alignment
+      ) { buffer in
+        expectEqual(byteCount, buffer.count)
+        expectEqual(0,
+          UInt(bitPattern: buffer.baseAddress!) % UInt(alignment))
+        for i in 0..<byteCount {
+          buffer[i] = UInt8(truncatingBitPattern: i)
+        }
+        for i in 0..<byteCount {
+          expectEqual(UInt8(truncatingBitPattern: i), buffer[i])
+        }
+      }
+    }
+  }
+}
+
+TemporaryAllocationTests.test("StackIsReleased") {
+  // Repeated allocations in a loop must not grow the stack; 100 MB worth of
+  // them would overflow it.
+  var sum = 0
+  for i in 0..<100_000 {
+    sum += withUnsafeTemporaryAllocation(
+      byteCount: 1_000, alignment: 8
+    ) { buffer -> Int in
+      buffer[999] = UInt8(truncatingBitPattern: i)
+      return Int(buffer[999])
+    }
+  }
+  expectEqual((0..<100_000).reduce(0) { $0 + ($1 & 0xFF) }, sum)
+}
+
+TemporaryAllocationTests.test("Throws") {
+  struct E : Error {}
+  do {
+    try withUnsafeTemporaryAllocation(of: Int.self, capacity: 10) { _ in
+      throw E()
+    }
+    expectUnreachable()
+  } catch {
+    expectTrue(error is E)
+  }
+}
+
+runAllTests()
@@ -422,4 +422,53 @@ UnsafeRawBufferPointerTestSuite.test("copy.overlap") {
   expectEqual(1, bytes[3])
 }
 
+UnsafeRawBufferPointerTestSuite.test("loadUnaligned") {
+  let bytes: [UInt8] = [0xFF, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08]
+  bytes.withUnsafeBytes { buffer in
+    expectEqual(0x01, buffer.loadUnaligned(fromByteOffset: 1, as: UInt8.self))
+    expectEqual(0x0102,
+      buffer.loadBigEndian(fromByteOffset: 1, as: UInt16.self))
+    expectEqual(0x0201,
+      buffer.loadLittleEndian(fromByteOffset: 1, as: UInt16.self))
+    expectEqual(0x01020304,
+      buffer.loadBigEndian(fromByteOffset: 1, as: UInt32.self))
+    expectEqual(0x04030201,
+      buffer.loadLittleEndian(fromByteOffset: 1, as: Int32.self))
+    expectEqual(0x0102030405060708,
+      buffer.loadBigEndian(fromByteOffset: 1, as: UInt64.self))
+    expectEqual(0x0807060504030201,
+      buffer.loadLittleEndian(fromByteOffset: 1, as: Int64.self))
+    expectEqual(-255,
+      buffer.loadBigEndian(fromByteOffset: 0, as: Int16.self))
+  }
+}
+
+UnsafeRawBufferPointerTestSuite.test("index(of:)") {
+  let bytes: [UInt8] = [1, 2, 3, 2, 1]
+  bytes.withUnsafeBytes { buffer in
+    expectOptionalEqual(1, buffer.index(of: 2))
+    expectOptionalEqual(4, buffer[1..<5].index(of: 1))
+    expectNil(buffer.index(of: 4))
+    expectTrue(buffer.contains(3))
+    expectFalse(buffer.contains(0))
+  }
+  expectNil(UnsafeRawBufferPointer(start: nil, count: 0).index(of: 0))
+}
+
+UnsafeRawBufferPointerTestSuite.test("range(of:)") {
+  let bytes = Array("abracadabra".utf8)
+  bytes.withUnsafeBytes { buffer in
+    func range(of pattern: String) -> Range<Int>? {
+      return Array(pattern.utf8).withUnsafeBytes { buffer.range(of: $0) }
+    }
+    expectOptionalEqual(0..<4, range(of: "abra"))
+    expectOptionalEqual(3..<5, range(of: "ac"))
+    expectOptionalEqual(1..<4, range(of: "bra"))
+    expectOptionalEqual(6..<11, range(of: "dabra"))
+    expectOptionalEqual(0..<0, range(of: ""))
+    expectNil(range(of: "abrax"))
+    expectNil(range(of: "abracadabra!"))
+  }
+}
+
 runAllTests()
@@ -444,6 +444,13 @@ public:
   virtual void editorApplyFormatOptions(StringRef Name,
                                         OptionsDictionary &FmtOptions) = 0;
 
+  /// Reports the syntax map and semantic annotations of the open document
+  /// \p Name, restricted to the tokens that start on the lines
+  /// [Line, Line + Length).
+  virtual void editorReadAnnotations(StringRef Name, unsigned Line,
+                                     unsigned Length,
+                                     EditorConsumer &Consumer) = 0;
+
   virtual void editorFormatText(StringRef Name, unsigned Line, unsigned Length,
                                 EditorConsumer &Consumer) = 0;
 
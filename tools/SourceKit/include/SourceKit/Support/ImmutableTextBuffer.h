@@ -27,6 +27,10 @@ namespace llvm {
   class SourceMgr;
 }
 
+namespace clang {
+  class RewriteRope;
+}
+
 namespace SourceKit {
 
 class ImmutableTextUpdate;
@@ -158,8 +162,14 @@ class EditableTextBuffer : public ThreadSafeRefCountedBase<EditableTextBuffer> {
   ImmutableTextUpdateRef CurrUpd;
   std::string Filename;
 
+  /// The text as of \c CurrUpd. It's updated in O(log n) with every edit, so
+  /// that creating the buffer for the latest snapshot doesn't need to replay
+  /// the updates since the last buffer.
+  std::unique_ptr<clang::RewriteRope> CurrText;
+
 public:
   explicit EditableTextBuffer(StringRef Filename, StringRef Text = StringRef());
+  ~EditableTextBuffer();
 
   StringRef getFilename() const { return Filename; }
 
@@ -20,6 +20,24 @@ using clang::toUppercase;
 using clang::toLowercase;
 using clang::isUppercase;
 using clang::isLowercase;
+using clang::isDigit;
+
+FuzzyStringMatcher::CharacterMask
+FuzzyStringMatcher::getCharacterMask(StringRef str) {
+  CharacterMask mask = 0;
+  for (char c : str) {
+    unsigned char lower = static_cast<unsigned char>(toLowercase(c));
+    unsigned bit;
+    if (lower >= 'a' && lower <= 'z')
+      bit = lower - 'a';
+    else if (isDigit(lower))
+      bit = 26 + (lower - '0');
+    else
+      bit = 36 + lower % 28;
+    mask |= CharacterMask(1) << bit;
+  }
+  return mask;
+}
 
 FuzzyStringMatcher::FuzzyStringMatcher(StringRef pattern_)
     : pattern(pattern_), charactersInPattern(1 << (sizeof(char) * 8)) {
@@ -33,6 +51,7 @@ FuzzyStringMatcher::FuzzyStringMatcher(StringRef pattern_)
     charactersInPattern.set(static_cast<unsigned char>(toUppercase(c)));
   }
   assert(pattern.size() == lowercasePattern.size());
+  patternMask = getCharacterMask(lowercasePattern);
 
   // FIXME: pull out the magic constants.
   // This depends on the inner details of the matching algorithm and will need
@@ -69,6 +88,14 @@ bool FuzzyStringMatcher::matchesCandidate(StringRef candidate) const {
   return pidx == patternLength;
 }
 
+bool FuzzyStringMatcher::matchesCandidate(StringRef candidate,
+                                          CharacterMask candidateMask) const {
+  assert(candidateMask == getCharacterMask(candidate) && "stale mask");
+  if (patternMask & ~candidateMask)
+    return false;
+  return matchesCandidate(candidate);
+}
+
 static bool isTokenizingChar(char c) {
   switch (c) {
   case '/':
@@ -210,6 +237,7 @@ CandidateSpecificMatcher::CandidateSpecificMatcher(
 
   assert(!pattern.empty() && pattern.size() <= candidate.size());
   assert(pattern.size() == lowercasePattern.size());
+  patternMask = getCharacterMask(lowercasePattern);
 
   // Build a table that points at the next pattern character so we skip
   // through candidate faster.
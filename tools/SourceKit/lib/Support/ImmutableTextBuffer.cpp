@@ -119,12 +119,24 @@ bool ImmutableTextSnapshot::foreachReplaceUntil(
 
 static std::atomic<uint64_t> Generation{ 0 };
 
+static void applyUpdate(RewriteRope &Rope, const ImmutableTextUpdateRef &Upd) {
+  if (auto ReplaceUpd = dyn_cast<ReplaceImmutableTextUpdate>(Upd)) {
+    Rope.erase(ReplaceUpd->getByteOffset(), ReplaceUpd->getLength());
+    StringRef Text = ReplaceUpd->getText();
+    Rope.insert(ReplaceUpd->getByteOffset(), Text.begin(), Text.end());
+  }
+}
+
 EditableTextBuffer::EditableTextBuffer(StringRef Filename, StringRef Text) {
   this->Filename = Filename;
   Root = new ImmutableTextBuffer(Filename, Text, ++Generation);
   CurrUpd = Root;
+  CurrText.reset(new RewriteRope());
+  CurrText->assign(Text.begin(), Text.end());
 }
 
+EditableTextBuffer::~EditableTextBuffer() = default;
+
 ImmutableTextSnapshotRef EditableTextBuffer::getSnapshot() const {
   return new ImmutableTextSnapshot(const_cast<EditableTextBuffer*>(this), Root,
                                    CurrUpd);
@@ -164,19 +176,15 @@ ImmutableTextSnapshotRef EditableTextBuffer::addAtomicUpdate(
   assert(CurrUpd->Next == nullptr);
   CurrUpd->Next = NewUpd;
   CurrUpd = NewUpd;
+  applyUpdate(*CurrText, CurrUpd);
 
   return new ImmutableTextSnapshot(this, Root, CurrUpd);
 }
 
 static std::unique_ptr<llvm::MemoryBuffer>
 getMemBufferFromRope(StringRef Filename, const RewriteRope &Rope) {
-  size_t Length = 0;
-  for (RewriteRope::iterator I = Rope.begin(), E = Rope.end(); I != E;
-       I.MoveToNextPiece()) {
-    Length += I.piece().size();
-  }
-
-  auto MemBuf = llvm::MemoryBuffer::getNewUninitMemBuffer(Length, Filename);
+  auto MemBuf = llvm::MemoryBuffer::getNewUninitMemBuffer(Rope.size(),
+                                                          Filename);
   char *Ptr = (char*)MemBuf->getBufferStart();
   for (RewriteRope::iterator I = Rope.begin(), E = Rope.end(); I != E;
        I.MoveToNextPiece()) {
@@ -198,6 +206,21 @@ ImmutableTextBufferRef EditableTextBuffer::getBufferForSnapshot(
     if (auto Buf = dyn_cast<ImmutableTextBuffer>(Next))
       return Buf;
 
+  // Usually the buffer is needed for the latest snapshot, whose text is
+  // already available.
+  {
+    llvm::sys::ScopedLock L(EditMtx);
+    refresh();
+    if (Snap.DiffEnd == CurrUpd) {
+      auto MemBuf = getMemBufferFromRope(getFilename(), *CurrText);
+      ImmutableTextBufferRef ImmBuf =
+          new ImmutableTextBuffer(std::move(MemBuf), Snap.getStamp());
+      Snap.DiffEnd->Next = ImmBuf;
+      refresh();
+      return ImmBuf;
+    }
+  }
+
   // Check if a buffer was created in the middle of the snapshot updates.
   ImmutableTextBufferRef StartBuf = Snap.BufferStart;
   ImmutableTextUpdateRef Upd = StartBuf;  
@@ -209,19 +232,11 @@ ImmutableTextBufferRef EditableTextBuffer::getBufferForSnapshot(
   StringRef StartText = StartBuf->getText();
 
   RewriteRope Rope;
-  auto applyUpdate = [&](const ImmutableTextUpdateRef &Upd) {
-    if (auto ReplaceUpd = dyn_cast<ReplaceImmutableTextUpdate>(Upd)) {
-      Rope.erase(ReplaceUpd->getByteOffset(), ReplaceUpd->getLength());
-      StringRef Text = ReplaceUpd->getText();
-      Rope.insert(ReplaceUpd->getByteOffset(), Text.begin(), Text.end());
-    }
-  };
-
   Rope.assign(StartText.begin(), StartText.end());
   Upd = StartBuf;
   while (Upd != Snap.DiffEnd) {
     Upd = Upd->Next;
-    applyUpdate(Upd);
+    applyUpdate(Rope, Upd);
   }
 
   auto MemBuf = getMemBufferFromRope(getFilename(), Rope);
@@ -11,8 +11,10 @@
 //===----------------------------------------------------------------------===//
 
 #include "SourceKit/Support/UIdent.h"
-#include "SourceKit/Support/Concurrency.h"
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/RWMutex.h"
 #include "llvm/Support/raw_ostream.h"
 #include <mutex>
 #include <vector>
@@ -24,8 +26,22 @@ namespace {
 class UIDRegistryImpl {
   typedef llvm::StringMap<void *, llvm::BumpPtrAllocator> HashTableTy;
   typedef llvm::StringMapEntry<void *> EntryTy;
-  HashTableTy HashTable;
-  WorkQueue Queue{ WorkQueue::Dequeuing::Concurrent, "UIDRegistryImpl" };
+
+  /// The table is split into shards with a lock each, so that concurrent
+  /// requests only contend when they look up UIDs in the same shard.
+  /// Entries are never removed, so their addresses stay valid.
+  struct Shard {
+    HashTableTy HashTable;
+    llvm::sys::RWMutex Mtx;
+  };
+  enum { NumShards = 16 };
+  Shard Shards[NumShards];
+
+  Shard &getShard(StringRef Str) {
+    // Use a different hash function than StringMap's, so that each shard's
+    // entries still spread over all of its buckets.
+    return Shards[llvm::hash_value(Str) % NumShards];
+  }
 
 public:
 
@@ -85,21 +101,17 @@ void UIdent::print(llvm::raw_ostream &OS) const {
 void *UIDRegistryImpl::get(StringRef Str) {
   assert(!Str.empty());
   assert(Str.find(' ') == StringRef::npos);
-  EntryTy *Ptr = 0;
-  Queue.dispatchSync([&]{
-    HashTableTy::iterator It = HashTable.find(Str);
-    if (It != HashTable.end())
-      Ptr = &(*It);
-  });
-
-  if (Ptr == 0) {
-    Queue.dispatchBarrierSync([&]{
-      EntryTy &Entry = *HashTable.insert(std::make_pair(Str, nullptr)).first;
-      Ptr = &Entry;
-    });
+  Shard &S = getShard(Str);
+  {
+    llvm::sys::ScopedReader L(S.Mtx);
+    HashTableTy::iterator It = S.HashTable.find(Str);
+    if (It != S.HashTable.end())
+      return &(*It);
   }
 
-  return Ptr;
+  llvm::sys::ScopedWriter L(S.Mtx);
+  EntryTy &Entry = *S.HashTable.insert(std::make_pair(Str, nullptr)).first;
+  return &Entry;
 }
 
 StringRef UIDRegistryImpl::getName(void *Ptr) {
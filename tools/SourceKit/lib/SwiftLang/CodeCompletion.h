@@ -14,6 +14,7 @@
 #define LLVM_SOURCEKIT_LIB_SWIFTLANG_CODECOMPLETION_H
 
 #include "SourceKit/Core/LLVM.h"
+#include "SourceKit/Support/FuzzyStringMatcher.h"
 #include "swift/IDE/CodeCompletion.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/Optional.h"
@@ -79,6 +80,9 @@ class Completion : public SwiftResult {
   PopularityFactor popularityFactor;
   StringRef name;
   StringRef description;
+  /// The character mask of \c name, computed once so that filtering the same
+  /// completions again with every keystroke can skip most of them cheaply.
+  FuzzyStringMatcher::CharacterMask nameMask;
   friend class CompletionBuilder;
 
 public:
@@ -89,12 +93,14 @@ public:
   /// should outlive the result, generally by being stored in the same
   /// \c CompletionSink.
   Completion(SwiftResult base, StringRef name, StringRef description)
-      : SwiftResult(base), name(name), description(description) {}
+      : SwiftResult(base), name(name), description(description),
+        nameMask(FuzzyStringMatcher::getCharacterMask(name)) {}
 
   bool hasCustomKind() const { return opaqueCustomKind; }
   void *getCustomKind() const { return opaqueCustomKind; }
   StringRef getName() const { return name; }
   StringRef getDescription() const { return description; }
+  FuzzyStringMatcher::CharacterMask getNameMask() const { return nameMask; }
   Optional<uint8_t> getModuleImportDepth() const { return moduleImportDepth; }
 
   /// A popularity factory in the range [-1, 1]. The higher the value, the more
@@ -216,7 +216,8 @@ public:
   void addCompletionsWithFilter(ArrayRef<Completion *> completions,
                                 StringRef filterText, Options options,
                                 const FilterRules &rules,
-                                Completion *&exactMatch);
+                                Completion *&exactMatch,
+                                std::vector<Completion *> *matched);
 
   void sort(Options options);
 
@@ -289,11 +290,32 @@ void CodeCompletionOrganizer::preSortCompletions(
    });
 }
 
+bool CodeCompletionOrganizer::usesFuzzyMatching(const Options &options,
+                                                StringRef filterText) {
+  return options.fuzzyMatching && filterText.size() >= options.minFuzzyLength;
+}
+
+bool CodeCompletionOrganizer::filterNarrows(StringRef oldFilterText,
+                                            bool oldWasFuzzy,
+                                            StringRef newFilterText,
+                                            const Options &options) {
+  // An empty filter text uses different hiding rules, so its results are not a
+  // superset of the filtered ones.
+  if (oldFilterText.empty() || !newFilterText.startswith_lower(oldFilterText))
+    return false;
+
+  // Both prefix and fuzzy (subsequence) matching only lose candidates when the
+  // pattern is extended, and a prefix match is also a fuzzy match. The only
+  // unsafe transition is from prefix matching to fuzzy matching.
+  return oldWasFuzzy || !usesFuzzyMatching(options, newFilterText);
+}
+
 void CodeCompletionOrganizer::addCompletionsWithFilter(
     ArrayRef<Completion *> completions, StringRef filterText,
-    const FilterRules &rules, Completion *&exactMatch) {
+    const FilterRules &rules, Completion *&exactMatch,
+    std::vector<Completion *> *matched) {
   impl.addCompletionsWithFilter(completions, filterText, options, rules,
-                                exactMatch);
+                                exactMatch, matched);
 }
 
 void CodeCompletionOrganizer::groupAndSort(const Options &options) {
@@ -508,7 +530,8 @@ bool FilterRules::hideCompletion(SwiftResult *completion, StringRef name, void *
 
 void CodeCompletionOrganizer::Impl::addCompletionsWithFilter(
     ArrayRef<Completion *> completions, StringRef filterText, Options options,
-    const FilterRules &rules, Completion *&exactMatch) {
+    const FilterRules &rules, Completion *&exactMatch,
+    std::vector<Completion *> *matched) {
   assert(rootGroup);
 
   auto &contents = rootGroup->contents;
@@ -575,6 +598,8 @@ void CodeCompletionOrganizer::Impl::addCompletionsWithFilter(
 
   FuzzyStringMatcher pattern(filterText);
   pattern.normalize = true;
+  bool fuzzy = CodeCompletionOrganizer::usesFuzzyMatching(options, filterText);
+  Optional<double> exactMatchScore;
   for (Completion *completion : completions) {
     if (rules.hideCompletion(completion))
       continue;
@@ -590,24 +615,43 @@ void CodeCompletionOrganizer::Impl::addCompletionsWithFilter(
       continue;
 
     bool match = false;
-    if (options.fuzzyMatching && filterText.size() >= options.minFuzzyLength) {
-      match = pattern.matchesCandidate(completion->getName());
+    if (fuzzy) {
+      match = pattern.matchesCandidate(completion->getName(),
+                                       completion->getNameMask());
     } else {
       match = completion->getName().startswith_lower(filterText);
     }
 
+    if (match && matched)
+      matched->push_back(completion);
+
     bool isExactMatch = match && completion->getName().equals_lower(filterText);
 
+    // Scoring is the expensive part, so score each candidate at most once.
+    Optional<double> score;
+    auto getScore = [&]() -> double {
+      if (!score)
+        score = pattern.scoreCandidate(completion->getName());
+      return *score;
+    };
+
     if (isExactMatch) {
       if (!exactMatch) { // first match
         exactMatch = completion;
+        exactMatchScore = None;
       } else if (completion->getName() != exactMatch->getName()) {
         if (completion->getName() == filterText && // first case-sensitive match
-            exactMatch->getName() != filterText)
-          exactMatch = completion;
-        else if (pattern.scoreCandidate(completion->getName()) > // better match
-                 pattern.scoreCandidate(exactMatch->getName()))
+            exactMatch->getName() != filterText) {
           exactMatch = completion;
+          exactMatchScore = None;
+        } else {
+          if (!exactMatchScore)
+            exactMatchScore = pattern.scoreCandidate(exactMatch->getName());
+          if (getScore() > *exactMatchScore) { // better match
+            exactMatch = completion;
+            exactMatchScore = score;
+          }
+        }
       }
 
       match = (options.addInnerResults || options.addInnerOperators)
@@ -619,7 +663,7 @@ void CodeCompletionOrganizer::Impl::addCompletionsWithFilter(
     if (match) {
       auto wrapper = make_result(completion);
       if (options.fuzzyMatching) {
-        wrapper->matchScore = pattern.scoreCandidate(completion->getName());
+        wrapper->matchScore = getScore();
       }
       wrapper->isExactMatch = isExactMatch;
 
@@ -80,13 +80,26 @@ public:
   static void
   preSortCompletions(llvm::MutableArrayRef<Completion *> completions);
 
+  /// Whether \p filterText is matched fuzzily rather than by name prefix.
+  static bool usesFuzzyMatching(const Options &options, StringRef filterText);
+
+  /// Whether every completion matching \p newFilterText also matches
+  /// \p oldFilterText, so that filtering can start from the results that
+  /// matched \p oldFilterText instead of the full set.
+  static bool filterNarrows(StringRef oldFilterText, bool oldWasFuzzy,
+                            StringRef newFilterText, const Options &options);
+
   /// Add \p completions to the organizer, removing any results that don't match
   /// \p filterText and returning \p exactMatch if there is an exact match.
   ///
+  /// If \p matched is non-null and \p filterText is not empty, the completions
+  /// that match \p filterText are appended to it in their original order.
+  ///
   /// Precondition: \p completions should be sorted with preSortCompletions().
   void addCompletionsWithFilter(ArrayRef<Completion *> completions,
                                 StringRef filterText, const FilterRules &rules,
-                                Completion *&exactMatch);
+                                Completion *&exactMatch,
+                                std::vector<Completion *> *matched = nullptr);
 
   void groupAndSort(const Options &options);
 
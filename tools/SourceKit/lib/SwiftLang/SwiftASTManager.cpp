@@ -23,16 +23,23 @@
 #include "swift/Basic/Cache.h"
 #include "swift/Frontend/Frontend.h"
 #include "swift/Frontend/PrintingDiagnosticConsumer.h"
+#include "swift/Parse/DelayedParsingCallbacks.h"
+#include "swift/AST/ASTWalker.h"
 #include "swift/Strings.h"
 #include "swift/Subsystems.h"
 #include "swift/SILOptimizer/PassManager/Passes.h"
 // This is included only for createLazyResolver(). Move to different header ?
 #include "swift/Sema/IDETypeChecking.h"
 
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/ExternalASTSource.h"
+#include "clang/Basic/SourceManager.h"
+#include "clang/Lex/Preprocessor.h"
 #include "llvm/ADT/FoldingSet.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
+#include <deque>
 
 using namespace SourceKit;
 using namespace swift;
@@ -53,6 +60,7 @@ public:
       case DiagnosticKind::Error: OS << "error: "; break;
       case DiagnosticKind::Warning: OS << "warning: "; break;
       case DiagnosticKind::Note: OS << "note: "; break;
+      case DiagnosticKind::Remark: OS << "remark: "; break;
     }
     OS << Text;
   }
@@ -162,6 +170,16 @@ namespace SourceKit {
     OwnedResolver TypeResolver{ nullptr, nullptr };
     WorkQueue Queue{ WorkQueue::Dequeuing::Serial, "sourcekit.swift.ConsumeAST" };
 
+    /// The snapshot of the primary file, if it came from an editor document.
+    ImmutableTextSnapshotRef PrimarySnapshot;
+    /// The offsets of the braces of the function bodies in the primary file,
+    /// used to check whether the next edits are confined to one of them.
+    std::vector<std::pair<unsigned, unsigned>> BodyBraceOffsets;
+
+    /// Set for a partial AST; see \c ASTUnit::isPartial().
+    ImmutableTextSnapshotRef BaseSnapshot;
+    std::vector<std::pair<unsigned, unsigned>> SkippedBodyRanges;
+
     Implementation(uint64_t Generation) : Generation(Generation) {}
 
     void consumeAsync(SwiftASTConsumerRef ASTConsumer, ASTUnitRef ASTRef);
@@ -210,6 +228,19 @@ namespace SourceKit {
     return Impl.CollectDiagConsumer;
   }
 
+  bool ASTUnit::isPartial() const {
+    return Impl.BaseSnapshot != nullptr;
+  }
+
+  ImmutableTextSnapshotRef ASTUnit::getBaseSnapshot() const {
+    return Impl.BaseSnapshot;
+  }
+
+  ArrayRef<std::pair<unsigned, unsigned>>
+  ASTUnit::getSkippedBodyRanges() const {
+    return Impl.SkippedBodyRanges;
+  }
+
   void ASTUnit::performAsync(std::function<void()> Fn) {
     Impl.Queue.dispatch(std::move(Fn));
   }
@@ -232,6 +263,32 @@ struct FileContent {
       Stamp(Stamp) {}
 };
 
+/// Returns the memory owned by \p Ctx, including that of the Clang importer.
+///
+/// Imported Clang modules are usually the bulk of an AST's memory, so leaving
+/// them out makes the cache evict small ASTs as eagerly as huge ones.
+static size_t getASTContextMemoryCost(ASTContext &Ctx) {
+  size_t Cost = Ctx.getTotalMemory();
+
+  auto *ClangLoader = Ctx.getClangModuleLoader();
+  if (!ClangLoader)
+    return Cost;
+
+  clang::ASTContext &ClangCtx = ClangLoader->getClangASTContext();
+  Cost += ClangCtx.getASTAllocatedMemory();
+  Cost += ClangCtx.getSideTableAllocatedMemory();
+  Cost += ClangLoader->getClangPreprocessor().getTotalMemory();
+
+  // Memory-mapped buffers are backed by the files and shared with the other
+  // ASTs that import the same modules; only count the ones read into the heap.
+  clang::SourceManager &ClangSM = ClangCtx.getSourceManager();
+  Cost += ClangSM.getDataStructureSizes();
+  Cost += ClangSM.getMemoryBufferSizes().malloc_bytes;
+  if (auto *ExternalSource = ClangCtx.getExternalSource())
+    Cost += ExternalSource->getMemoryBufferSizes().malloc_bytes;
+  return Cost;
+}
+
 class ASTProducer : public ThreadSafeRefCountedBase<ASTProducer> {
   SwiftInvocationRef InvokRef;
   SmallVector<BufferStamp, 8> Stamps;
@@ -252,27 +309,32 @@ public:
 
   void getASTUnitAsync(SwiftASTManager::Implementation &MgrImpl,
                        ArrayRef<ImmutableTextSnapshotRef> Snapshots,
+                       bool IsInteractive,
                 std::function<void(ASTUnitRef Unit, StringRef Error)> Receiver);
   bool shouldRebuild(SwiftASTManager::Implementation &MgrImpl,
                      ArrayRef<ImmutableTextSnapshotRef> Snapshots);
 
   void enqueueConsumer(SwiftASTConsumerRef Consumer, const void *OncePerASTToken);
   std::vector<SwiftASTConsumerRef> popQueuedConsumers();
+  bool hasQueuedConsumers();
+  bool canQueuedConsumersUsePartialAST();
 
   size_t getMemoryCost() const {
     // FIXME: Report the memory cost of the overall CompilerInstance.
     if (AST && AST->getCompilerInstance().hasASTContext())
-      return AST->Impl.CompInst.getASTContext().getTotalMemory();
+      return getASTContextMemoryCost(AST->Impl.CompInst.getASTContext());
     return sizeof(*this) + sizeof(*AST);
   }
 
 private:
   ASTUnitRef getASTUnitImpl(SwiftASTManager::Implementation &MgrImpl,
                             ArrayRef<ImmutableTextSnapshotRef> Snapshots,
+                            bool AllowPartial,
                             std::string &Error);
 
   ASTUnitRef createASTUnit(SwiftASTManager::Implementation &MgrImpl,
                            ArrayRef<ImmutableTextSnapshotRef> Snapshots,
+                           bool AllowPartial,
                            std::string &Error);
 };
 
@@ -317,6 +379,17 @@ struct SwiftASTManager::Implementation {
   WorkQueue ASTBuildQueue{ WorkQueue::Dequeuing::Serial,
                            "sourcekit.swift.ASTBuilding" };
 
+  /// The builds waiting for ASTBuildQueue. Each item dispatched to the queue
+  /// runs the oldest interactive build, or else the oldest background one,
+  /// so that requests the user waits on do not queue behind semantic
+  /// refreshes of other documents.
+  std::deque<std::function<void()>> PendingInteractiveBuilds;
+  std::deque<std::function<void()>> PendingBackgroundBuilds;
+  llvm::sys::Mutex PendingBuildsMtx;
+
+  void scheduleASTBuild(bool IsInteractive, std::function<void()> Build);
+  void runNextASTBuild();
+
   ASTProducerRef getASTProducer(SwiftInvocationRef InvokRef);
   FileContent getFileContent(StringRef FilePath, std::string &Error);
   BufferStamp getBufferStamp(StringRef FilePath);
@@ -476,23 +549,34 @@ void SwiftASTManager::processASTAsync(SwiftInvocationRef InvokRef,
   ASTProducerRef Producer = Impl.getASTProducer(InvokRef);
 
   if (ASTUnitRef Unit = Producer->getExistingAST()) {
-    if (ASTConsumer->canUseASTWithSnapshots(Unit->getSnapshots())) {
+    if ((!Unit->isPartial() || ASTConsumer->canUsePartialAST()) &&
+        ASTConsumer->canUseASTWithSnapshots(Unit->getSnapshots())) {
       Unit->Impl.consumeAsync(std::move(ASTConsumer), Unit);
       return;
     }
   }
 
+  bool IsInteractive = ASTConsumer->isInteractive();
   Producer->enqueueConsumer(std::move(ASTConsumer), OncePerASTToken);
 
-  Producer->getASTUnitAsync(Impl, Snapshots,
-    [Producer](ASTUnitRef Unit, StringRef Error) {
+  SmallVector<ImmutableTextSnapshotRef, 4> SnapshotsCopy;
+  SnapshotsCopy.append(Snapshots.begin(), Snapshots.end());
+  Producer->getASTUnitAsync(Impl, Snapshots, IsInteractive,
+    [this, InvokRef, Producer, SnapshotsCopy](ASTUnitRef Unit,
+                                              StringRef Error) {
       auto Consumers = Producer->popQueuedConsumers();
 
       for (auto &Consumer : Consumers) {
-        if (Unit)
-          Unit->Impl.consumeAsync(std::move(Consumer), Unit);
-        else
+        if (!Unit) {
           Consumer->failed(Error);
+        } else if (Unit->isPartial() && !Consumer->canUsePartialAST()) {
+          // The consumer was queued after the partial build was decided on;
+          // ask again so that it gets a complete AST.
+          processASTAsync(InvokRef, std::move(Consumer), nullptr,
+                          SnapshotsCopy);
+        } else {
+          Unit->Impl.consumeAsync(std::move(Consumer), Unit);
+        }
       }
     });
 }
@@ -560,25 +644,61 @@ SwiftASTManager::Implementation::getMemoryBuffer(StringRef Filename,
   return nullptr;
 }
 
+void SwiftASTManager::Implementation::scheduleASTBuild(
+    bool IsInteractive, std::function<void()> Build) {
+  {
+    llvm::sys::ScopedLock L(PendingBuildsMtx);
+    if (IsInteractive)
+      PendingInteractiveBuilds.push_back(std::move(Build));
+    else
+      PendingBackgroundBuilds.push_back(std::move(Build));
+  }
+  ASTBuildQueue.dispatch([this] { runNextASTBuild(); }, /*isStackDeep=*/true);
+}
+
+void SwiftASTManager::Implementation::runNextASTBuild() {
+  std::function<void()> Build;
+  {
+    llvm::sys::ScopedLock L(PendingBuildsMtx);
+    auto &Pending = PendingInteractiveBuilds.empty() ? PendingBackgroundBuilds
+                                                     : PendingInteractiveBuilds;
+    assert(!Pending.empty() && "dispatched more builds than were scheduled");
+    Build = std::move(Pending.front());
+    Pending.pop_front();
+  }
+  Build();
+}
+
 void ASTProducer::getASTUnitAsync(SwiftASTManager::Implementation &MgrImpl,
                                   ArrayRef<ImmutableTextSnapshotRef> Snaps,
+                                  bool IsInteractive,
                std::function<void(ASTUnitRef Unit, StringRef Error)> Receiver) {
 
   ASTProducerRef ThisProducer = this;
   SmallVector<ImmutableTextSnapshotRef, 4> Snapshots;
   Snapshots.append(Snaps.begin(), Snaps.end());
 
-  MgrImpl.ASTBuildQueue.dispatch([ThisProducer, &MgrImpl, Snapshots, Receiver] {
+  MgrImpl.scheduleASTBuild(IsInteractive,
+                           [ThisProducer, &MgrImpl, Snapshots, Receiver] {
+    // An earlier build may have already served the consumers that this one
+    // was scheduled for, or they may have been superseded and cancelled.
+    if (!ThisProducer->hasQueuedConsumers())
+      return;
+
     std::string Error;
-    ASTUnitRef Unit = ThisProducer->getASTUnitImpl(MgrImpl, Snapshots, Error);
+    bool AllowPartial = ThisProducer->canQueuedConsumersUsePartialAST();
+    ASTUnitRef Unit = ThisProducer->getASTUnitImpl(MgrImpl, Snapshots,
+                                                   AllowPartial, Error);
     Receiver(Unit, Error);
-  }, /*isStackDeep=*/true);
+  });
 }
 
 ASTUnitRef ASTProducer::getASTUnitImpl(SwiftASTManager::Implementation &MgrImpl,
                                    ArrayRef<ImmutableTextSnapshotRef> Snapshots,
+                                   bool AllowPartial,
                                    std::string &Error) {
-  if (!AST || shouldRebuild(MgrImpl, Snapshots)) {
+  if (!AST || shouldRebuild(MgrImpl, Snapshots) ||
+      (AST->isPartial() && !AllowPartial)) {
     bool IsRebuild = AST != nullptr;
     const InvocationOptions &Opts = InvokRef->Impl.Opts;
 
@@ -592,7 +712,7 @@ ASTUnitRef ASTProducer::getASTUnitImpl(SwiftASTManager::Implementation &MgrImpl,
       Log->getOS() << Opts.Invok.getModuleName() << '/' << Opts.PrimaryFile;
     }
 
-    auto NewAST = createASTUnit(MgrImpl, Snapshots, Error);
+    auto NewAST = createASTUnit(MgrImpl, Snapshots, AllowPartial, Error);
     {
       // FIXME: ThreadSafeRefCntPtr is racy.
       llvm::sys::ScopedLock L(Mtx);
@@ -626,6 +746,20 @@ void ASTProducer::enqueueConsumer(SwiftASTConsumerRef Consumer,
   QueuedConsumers.push_back({ std::move(Consumer), OncePerASTToken });
 }
 
+bool ASTProducer::hasQueuedConsumers() {
+  llvm::sys::ScopedLock L(Mtx);
+  return !QueuedConsumers.empty();
+}
+
+bool ASTProducer::canQueuedConsumersUsePartialAST() {
+  llvm::sys::ScopedLock L(Mtx);
+  for (auto &C : QueuedConsumers) {
+    if (!C.first->canUsePartialAST())
+      return false;
+  }
+  return true;
+}
+
 std::vector<SwiftASTConsumerRef> ASTProducer::popQueuedConsumers() {
   llvm::sys::ScopedLock L(Mtx);
   std::vector<SwiftASTConsumerRef> Consumers;
@@ -716,11 +850,213 @@ static void collectModuleDependencies(Module *TopMod,
   }
 }
 
+namespace {
+
+/// Collects the offsets of the braces of the bodies of the functions that are
+/// not nested in another function.
+class FunctionBodyCollector : public ASTWalker {
+  SourceManager &SM;
+  unsigned BufferID;
+  StringRef Text;
+
+public:
+  std::vector<std::pair<unsigned, unsigned>> BraceOffsets;
+
+  FunctionBodyCollector(SourceManager &SM, unsigned BufferID)
+    : SM(SM), BufferID(BufferID),
+      Text(SM.extractText(SM.getRangeForBuffer(BufferID))) {}
+
+  bool walkToDeclPre(Decl *D) override {
+    auto *AFD = dyn_cast<AbstractFunctionDecl>(D);
+    if (!AFD)
+      return true;
+    if (AFD->isImplicit() || AFD->getDeclContext()->isLocalContext())
+      return false;
+    // Accessor body ranges do not include the braces.
+    if (auto *FD = dyn_cast<FuncDecl>(AFD))
+      if (FD->isAccessor())
+        return false;
+
+    SourceRange BodyRange = AFD->getBodySourceRange();
+    if (BodyRange.isInvalid())
+      return false;
+    unsigned Start = SM.getLocOffsetInBuffer(BodyRange.Start, BufferID);
+    unsigned End = SM.getLocOffsetInBuffer(BodyRange.End, BufferID);
+    // The body may have been cut short while recovering from a parse error.
+    if (End < Text.size() && Text[Start] == '{' && Text[End] == '}')
+      BraceOffsets.push_back({ Start, End });
+    return false;
+  }
+};
+
+/// Parsing callbacks used to rebuild an AST after edits that are confined to
+/// one function body of the primary file. Only that body is parsed again; the
+/// bodies of the other functions are skipped, and the results of the previous
+/// AST are reused for them.
+class IncrementalParsingCallbacks : public DelayedParsingCallbacks {
+  const std::string PrimaryFilename;
+  const unsigned EditedBodyStart;
+  const unsigned EditedBodyEnd;
+
+public:
+  bool FoundEditedBody = false;
+  bool StructureChanged = false;
+  std::vector<std::pair<unsigned, unsigned>> SkippedBodyRanges;
+
+  IncrementalParsingCallbacks(StringRef PrimaryFilename,
+                              unsigned EditedBodyStart, unsigned EditedBodyEnd)
+    : PrimaryFilename(PrimaryFilename), EditedBodyStart(EditedBodyStart),
+      EditedBodyEnd(EditedBodyEnd) {}
+
+  /// Whether the AST that was built is usable as a partial AST.
+  bool succeeded() const {
+    return FoundEditedBody && !StructureChanged;
+  }
+
+  bool shouldDelayFunctionBodyParsing(Parser &TheParser,
+                                      AbstractFunctionDecl *AFD,
+                                      const DeclAttributes &Attrs,
+                                      SourceRange BodyRange) override {
+    if (TheParser.SF.getFilename() != PrimaryFilename)
+      return !canSkipBody(AFD, Attrs);
+
+    SourceManager &SM = TheParser.SourceMgr;
+    unsigned BufferID = TheParser.SF.getBufferID().getValue();
+    unsigned Start = SM.getLocOffsetInBuffer(BodyRange.Start, BufferID);
+    unsigned End = SM.getLocOffsetInBuffer(BodyRange.End, BufferID);
+
+    if (Start == EditedBodyStart) {
+      FoundEditedBody = true;
+      if (End != EditedBodyEnd)
+        StructureChanged = true;
+      return true;
+    }
+    if (Start <= EditedBodyEnd && End >= EditedBodyStart) {
+      StructureChanged = true;
+      return true;
+    }
+    if (!canSkipBody(AFD, Attrs))
+      return true;
+    SkippedBodyRanges.push_back({ Start, End + 1 - Start });
+    return false;
+  }
+
+private:
+  /// Constructor and destructor bodies are always needed by SILGen, and
+  /// transparent ones by the mandatory inliner. Accessors and local functions
+  /// are not tracked by \c FunctionBodyCollector.
+  static bool canSkipBody(AbstractFunctionDecl *AFD,
+                          const DeclAttributes &Attrs) {
+    auto *FD = dyn_cast<FuncDecl>(AFD);
+    if (!FD || FD->isAccessor())
+      return false;
+    if (FD->getDeclContext()->isLocalContext())
+      return false;
+    return !Attrs.hasAttribute<TransparentAttr>();
+  }
+};
+
+} // anonymous namespace.
+
+/// If the edits to the primary file that came after the snapshot of
+/// \p OldAST are all inside the same function body, returns the parsing
+/// callbacks for rebuilding only that body.
+static std::unique_ptr<IncrementalParsingCallbacks>
+createIncrementalParsingCallbacks(const ASTUnit &OldAST,
+                                  ImmutableTextSnapshotRef NewSnapshot,
+                                  StringRef PrimaryFilename) {
+  ImmutableTextSnapshotRef OldSnapshot = OldAST.Impl.PrimarySnapshot;
+  if (!OldSnapshot || !NewSnapshot ||
+      !OldSnapshot->isFromSameBuffer(NewSnapshot) ||
+      !OldSnapshot->precedesOrSame(NewSnapshot))
+    return nullptr;
+
+  auto &BraceOffsets = OldAST.Impl.BodyBraceOffsets;
+  bool HasEdits = false;
+  bool IsConfined = true;
+  unsigned Start = 0, End = 0;
+  OldSnapshot->foreachReplaceUntil(NewSnapshot,
+    [&](ReplaceImmutableTextUpdateRef Upd) -> bool {
+      unsigned Offset = Upd->getByteOffset();
+      unsigned Length = Upd->getLength();
+      if (!HasEdits) {
+        HasEdits = true;
+        auto Found = std::find_if(BraceOffsets.begin(), BraceOffsets.end(),
+            [&](const std::pair<unsigned, unsigned> &Braces) -> bool {
+              return Braces.first < Offset && Offset + Length <= Braces.second;
+            });
+        if (Found == BraceOffsets.end()) {
+          IsConfined = false;
+          return false;
+        }
+        std::tie(Start, End) = *Found;
+      } else if (!(Start < Offset && Offset + Length <= End)) {
+        IsConfined = false;
+        return false;
+      }
+      End = End + Upd->getText().size() - Length;
+      return true;
+    });
+
+  if (!HasEdits || !IsConfined)
+    return nullptr;
+  return llvm::make_unique<IncrementalParsingCallbacks>(PrimaryFilename,
+                                                        Start, End);
+}
+
 static std::atomic<uint64_t> ASTUnitGeneration{ 0 };
 
+/// Creates an ASTUnit for \p Contents and type-checks its primary file.
+static ASTUnitRef performSemaOnContents(const InvocationOptions &Opts,
+                                       ArrayRef<FileContent> Contents,
+                                       DelayedParsingCallbacks *ParseCB,
+                                       std::string &Error) {
+  ASTUnitRef ASTRef = new ASTUnit(++ASTUnitGeneration);
+  for (auto &Content : Contents) {
+    if (Content.Snapshot)
+      ASTRef->Impl.Snapshots.push_back(Content.Snapshot);
+  }
+  auto &CompIns = ASTRef->Impl.CompInst;
+  auto &Consumer = ASTRef->Impl.CollectDiagConsumer;
+
+  // Display diagnostics to stderr.
+  CompIns.addDiagnosticConsumer(&Consumer);
+
+  CompilerInvocation Invocation;
+  Opts.applyTo(Invocation);
+
+  for (auto &Content : Contents)
+    Invocation.addInputBuffer(Content.Buffer.get());
+
+  if (CompIns.setup(Invocation)) {
+    // FIXME: Report the diagnostic.
+    LOG_WARN_FUNC("Compilation setup failed!!!");
+    Error = "compilation setup failed";
+    return nullptr;
+  }
+
+  if (ParseCB)
+    CompIns.setDelayedParsingCallbacks(ParseCB);
+
+  Consumer.setInputBufferIDs(ASTRef->getCompilerInstance().getInputBufferIDs());
+  CompIns.performSema();
+  return ASTRef;
+}
+
 ASTUnitRef ASTProducer::createASTUnit(SwiftASTManager::Implementation &MgrImpl,
                                       ArrayRef<ImmutableTextSnapshotRef> Snapshots,
+                                      bool AllowPartial,
                                       std::string &Error) {
+  // Remember what the existing AST was built from, in case it can be reused.
+  SmallVector<BufferStamp, 8> OldStamps(Stamps.begin(), Stamps.end());
+  bool DependenciesChanged = false;
+  for (auto &Dependency : DependencyStamps) {
+    if (Dependency.second != MgrImpl.getBufferStamp(Dependency.first)) {
+      DependenciesChanged = true;
+      break;
+    }
+  }
+
   Stamps.clear();
   DependencyStamps.clear();
 
@@ -752,52 +1088,69 @@ ASTUnitRef ASTProducer::createASTUnit(SwiftASTManager::Implementation &MgrImpl,
   for (auto &Content : Contents)
     Stamps.push_back(Content.Stamp);
 
+  unsigned PrimaryIndex = Opts.Invok.getFrontendOptions().PrimaryInput->Index;
+  StringRef PrimaryFilename = Opts.Invok.getInputFilenames()[PrimaryIndex];
+
+  // If only the primary file changed since the existing AST was built, and
+  // only inside one function body, avoid parsing and type-checking the other
+  // function bodies.
+  std::unique_ptr<IncrementalParsingCallbacks> IncrementalCB;
+  if (AllowPartial && AST && !DependenciesChanged &&
+      OldStamps.size() == Stamps.size()) {
+    bool OthersChanged = false;
+    for (unsigned i = 0, e = Stamps.size(); i != e; ++i) {
+      if (i != PrimaryIndex && OldStamps[i] != Stamps[i]) {
+        OthersChanged = true;
+        break;
+      }
+    }
+    if (!OthersChanged)
+      IncrementalCB = createIncrementalParsingCallbacks(
+          *AST, Contents[PrimaryIndex].Snapshot, PrimaryFilename);
+  }
+
   trace::SwiftInvocation TraceInfo;
 
   if (trace::enabled()) {
     TraceInfo.Args.PrimaryFile = Opts.PrimaryFile;
     TraceInfo.Args.Args = Opts.Args;
-  }
-
-  ASTUnitRef ASTRef = new ASTUnit(++ASTUnitGeneration);
-  for (auto &Content : Contents) {
-    if (Content.Snapshot)
-      ASTRef->Impl.Snapshots.push_back(Content.Snapshot);
-
-    if (trace::enabled()) {
+    for (auto &Content : Contents) {
       TraceInfo.addFile(Content.Buffer->getBufferIdentifier(),
                         Content.Buffer->getBuffer());
 
     }
   }
-  auto &CompIns = ASTRef->Impl.CompInst;
-  auto &Consumer = ASTRef->Impl.CollectDiagConsumer;
-
-  // Display diagnostics to stderr.
-  CompIns.addDiagnosticConsumer(&Consumer);
-
-  CompilerInvocation Invocation;
-  Opts.applyTo(Invocation);
-
-  for (auto &Content : Contents)
-    Invocation.addInputBuffer(Content.Buffer.get());
-
-  if (CompIns.setup(Invocation)) {
-    // FIXME: Report the diagnostic.
-    LOG_WARN_FUNC("Compilation setup failed!!!");
-    Error = "compilation setup failed";
-    return nullptr;
-  }
 
   trace::TracedOperation TracedOp;
   if (trace::enabled()) {
     TracedOp.start(trace::OperationKind::PerformSema, TraceInfo);
   }
 
+  ASTUnitRef ASTRef = performSemaOnContents(Opts, Contents, IncrementalCB.get(),
+                                            Error);
+  if (!ASTRef)
+    return nullptr;
+
+  if (IncrementalCB) {
+    if (IncrementalCB->succeeded()) {
+      LOG_INFO_FUNC(High, "reparsed only the edited function body of: "
+                          << PrimaryFilename);
+      ASTRef->Impl.BaseSnapshot = AST->Impl.PrimarySnapshot;
+      ASTRef->Impl.SkippedBodyRanges =
+          std::move(IncrementalCB->SkippedBodyRanges);
+    } else {
+      // The edits changed more than the body, e.g. by unbalancing its braces.
+      ASTRef = performSemaOnContents(Opts, Contents, nullptr, Error);
+      if (!ASTRef)
+        return nullptr;
+    }
+  }
+
+  auto &CompIns = ASTRef->Impl.CompInst;
+  auto &Consumer = ASTRef->Impl.CollectDiagConsumer;
+
   CloseClangModuleFiles scopedCloseFiles(
       *CompIns.getASTContext().getClangModuleLoader());
-  Consumer.setInputBufferIDs(ASTRef->getCompilerInstance().getInputBufferIDs());
-  CompIns.performSema();
 
   llvm::SmallPtrSet<Module *, 16> Visited;
   SmallVector<std::string, 8> Filenames;
@@ -835,6 +1188,18 @@ ASTUnitRef ASTProducer::createASTUnit(SwiftASTManager::Implementation &MgrImpl,
     }
   }
 
+  // Record the function bodies of the primary file, so that the next AST can
+  // reuse this one for edits inside one of them.
+  ASTRef->Impl.PrimarySnapshot = Contents[PrimaryIndex].Snapshot;
+  if (auto SF = CompIns.getPrimarySourceFile()) {
+    if (SF->Kind == SourceFileKind::Library && SF->getBufferID().hasValue()) {
+      FunctionBodyCollector Collector(CompIns.getSourceMgr(),
+                                      SF->getBufferID().getValue());
+      SF->walk(Collector);
+      ASTRef->Impl.BodyBraceOffsets = std::move(Collector.BraceOffsets);
+    }
+  }
+
   // We mirror the compiler and don't set the TypeResolver during SIL
   // processing. This is to avoid unnecessary typechecking that can occur if the
   // TypeResolver is set before.
@@ -57,6 +57,18 @@ public:
   EditorDiagConsumer &getEditorDiagConsumer() const;
   swift::SourceFile &getPrimarySourceFile() const;
 
+  /// Whether this AST was built for an edit confined to one function body and
+  /// left the bodies of the other functions of the primary file unparsed.
+  bool isPartial() const;
+
+  /// For a partial AST, the snapshot of the primary file that the previous,
+  /// reused AST was built from.
+  ImmutableTextSnapshotRef getBaseSnapshot() const;
+
+  /// For a partial AST, the (offset, length) ranges of the function bodies of
+  /// the primary file that were not parsed, sorted by offset.
+  ArrayRef<std::pair<unsigned, unsigned>> getSkippedBodyRanges() const;
+
   /// Perform \p Fn asynchronously while preventing concurrent access to the
   /// AST.
   void performAsync(std::function<void()> Fn);
@@ -77,6 +89,18 @@ public:
       ArrayRef<ImmutableTextSnapshotRef> Snapshots) {
     return false;
   }
+  /// Whether the consumer can handle an AST that is missing the function
+  /// bodies of the primary file that were not affected by the latest edits.
+  /// \sa ASTUnit::isPartial()
+  virtual bool canUsePartialAST() {
+    return false;
+  }
+  /// Whether the consumer serves a request that the user is waiting on. If it
+  /// needs an AST to be built, the build runs ahead of the ones for
+  /// consumers that only refresh editor state in the background.
+  virtual bool isInteractive() {
+    return true;
+  }
   virtual void failed(StringRef Error);
   virtual void handlePrimaryAST(ASTUnitRef AstUnit) = 0;
 };
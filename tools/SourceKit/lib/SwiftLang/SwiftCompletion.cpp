@@ -713,6 +713,22 @@ ArrayRef<Completion *> CodeCompletion::SessionCache::getSortedCompletions() {
   llvm::sys::ScopedLock L(mtx);
   return sortedCompletions;
 }
+void CodeCompletion::SessionCache::setFilteredCompletions(
+    StringRef filterText, bool wasFuzzy,
+    std::vector<Completion *> &&completions) {
+  llvm::sys::ScopedLock L(mtx);
+  lastFilterText = filterText;
+  lastFilterWasFuzzy = wasFuzzy;
+  lastFilteredCompletions = std::move(completions);
+}
+std::vector<Completion *> CodeCompletion::SessionCache::getCompletionsToFilter(
+    StringRef filterText, const Options &options) {
+  llvm::sys::ScopedLock L(mtx);
+  if (CodeCompletionOrganizer::filterNarrows(lastFilterText, lastFilterWasFuzzy,
+                                             filterText, options))
+    return lastFilteredCompletions;
+  return sortedCompletions;
+}
 llvm::MemoryBuffer *CodeCompletion::SessionCache::getBuffer() {
   llvm::sys::ScopedLock L(mtx);
   return buffer.get();
@@ -1025,8 +1041,17 @@ static void transformAndForwardResults(
       session->getCompletionKind() == CompletionKind::PostfixExpr;
 
   if (!hasEarlyInnerResults) {
-    organizer.addCompletionsWithFilter(session->getSortedCompletions(),
-                                       filterText, rules, exactMatch);
+    // While the user keeps typing, each new filter text extends the previous
+    // one, so only the completions that matched last time need re-filtering.
+    auto completions = session->getCompletionsToFilter(filterText, options);
+    std::vector<Completion *> matched;
+    organizer.addCompletionsWithFilter(completions, filterText, rules,
+                                       exactMatch, &matched);
+    if (!filterText.empty()) {
+      bool fuzzy = CodeCompletion::CodeCompletionOrganizer::usesFuzzyMatching(
+          options, filterText);
+      session->setFilteredCompletions(filterText, fuzzy, std::move(matched));
+    }
   }
 
   if (hasEarlyInnerResults &&
@@ -53,6 +53,11 @@ void EditorDiagConsumer::handleDiagnostic(SourceManager &SM, SourceLoc Loc,
   if (Info.ID == diag::lex_editor_placeholder.ID)
     return;
 
+  // Optimization remarks are only emitted by the SIL optimizer, which the
+  // editor never runs.
+  if (Kind == DiagnosticKind::Remark)
+    return;
+
   if (Loc.isInvalid()) {
     if (Kind == DiagnosticKind::Error)
       HadInvalidLocError = true;
@@ -140,6 +145,7 @@ void EditorDiagConsumer::handleDiagnostic(SourceManager &SM, SourceLoc Loc,
       SKInfo.Severity = DiagnosticSeverityKind::Warning;
       break;
     case DiagnosticKind::Note:
+    case DiagnosticKind::Remark:
       llvm_unreachable("already covered");
   }
 
@@ -284,6 +290,13 @@ public:
     return false;
   }
 
+  ArrayRef<SwiftSyntaxToken> getTokensForLine(unsigned Line) const {
+    assert(Line > 0);
+    if (Lines.size() < Line)
+      return {};
+    return Lines[Line - 1];
+  }
+
   void addTokenForLine(unsigned Line, const SwiftSyntaxToken &Token) {
     assert(Line > 0);
     if (Lines.size() < Line) {
@@ -402,6 +415,12 @@ class SwiftDocumentSemanticInfo :
   ImmutableTextSnapshotRef DiagSnapshot;
   std::vector<DiagnosticEntryInfo> SemaDiags;
 
+  /// The latest results that cover every function body, kept for filling in
+  /// the bodies that a partial AST skipped.
+  ImmutableTextSnapshotRef CompleteSnapshot;
+  std::vector<SwiftSemanticToken> CompleteToks;
+  std::vector<DiagnosticEntryInfo> CompleteDiags;
+
   mutable llvm::sys::Mutex Mtx;
 
 public:
@@ -425,12 +444,30 @@ public:
                         std::vector<DiagnosticEntryInfo> &Diags,
                         ArrayRef<DiagnosticEntryInfo> ParserDiags);
 
-  void processLatestSnapshotAsync(EditableTextBufferRef EditableBuffer);
+  /// Appends the semantic tokens of \p NewSnapshot that start in
+  /// [StartOffset, EndOffset) to \p Tokens. Unlike readSemanticInfo(), this
+  /// keeps the tokens around so other ranges can be read later.
+  void readSemanticTokensInRange(ImmutableTextSnapshotRef NewSnapshot,
+                                 unsigned StartOffset, unsigned EndOffset,
+                                 std::vector<SwiftSemanticToken> &Tokens);
+
+  void processLatestSnapshotAsync(EditableTextBufferRef EditableBuffer,
+                                  bool AllowPartialAST = true);
 
   void updateSemanticInfo(std::vector<SwiftSemanticToken> Toks,
                           std::vector<DiagnosticEntryInfo> Diags,
                           ImmutableTextSnapshotRef Snapshot,
                           uint64_t ASTGeneration);
+
+  /// Adds the tokens and diagnostics inside \p SkippedRanges of \p Snapshot
+  /// from the complete results for \p BaseSnapshot.
+  ///
+  /// \returns false if there are no complete results for \p BaseSnapshot.
+  bool addSkippedBodyInfo(ImmutableTextSnapshotRef BaseSnapshot,
+                          ImmutableTextSnapshotRef Snapshot,
+                          ArrayRef<std::pair<unsigned, unsigned>> SkippedRanges,
+                          std::vector<SwiftSemanticToken> &Toks,
+                          std::vector<DiagnosticEntryInfo> &Diags);
   void removeCachedAST() {
     if (InvokRef)
       ASTMgr.removeCachedAST(InvokRef);
@@ -541,6 +578,35 @@ void SwiftDocumentSemanticInfo::readSemanticInfo(
   Diags = getSemanticDiagnostics(NewSnapshot, ParserDiags);
 }
 
+static void adjustSemanticTokens(std::vector<SwiftSemanticToken> &Toks,
+                                 ReplaceImmutableTextUpdateRef Upd) {
+  auto ReplaceBegin = std::lower_bound(Toks.begin(), Toks.end(),
+      Upd->getByteOffset(),
+      [&](const SwiftSemanticToken &Tok, unsigned StartOffset) -> bool {
+        return Tok.ByteOffset+Tok.Length < StartOffset;
+      });
+
+  std::vector<SwiftSemanticToken>::iterator ReplaceEnd;
+  if (Upd->getLength() == 0) {
+    ReplaceEnd = ReplaceBegin;
+  } else {
+    ReplaceEnd = std::upper_bound(ReplaceBegin, Toks.end(),
+        Upd->getByteOffset() + Upd->getLength(),
+        [&](unsigned EndOffset, const SwiftSemanticToken &Tok) -> bool {
+          return EndOffset < Tok.ByteOffset;
+        });
+  }
+
+  unsigned InsertLen = Upd->getText().size();
+  int Delta = InsertLen - Upd->getLength();
+  if (Delta != 0) {
+    for (std::vector<SwiftSemanticToken>::iterator
+           I = ReplaceEnd, E = Toks.end(); I != E; ++I)
+      I->ByteOffset += Delta;
+  }
+  Toks.erase(ReplaceBegin, ReplaceEnd);
+}
+
 std::vector<SwiftSemanticToken>
 SwiftDocumentSemanticInfo::takeSemanticTokens(
     ImmutableTextSnapshotRef NewSnapshot) {
@@ -556,37 +622,42 @@ SwiftDocumentSemanticInfo::takeSemanticTokens(
       if (SemaToks.empty())
         return false;
 
-      auto ReplaceBegin = std::lower_bound(SemaToks.begin(), SemaToks.end(),
-          Upd->getByteOffset(),
-          [&](const SwiftSemanticToken &Tok, unsigned StartOffset) -> bool {
-            return Tok.ByteOffset+Tok.Length < StartOffset;
-          });
-
-      std::vector<SwiftSemanticToken>::iterator ReplaceEnd;
-      if (Upd->getLength() == 0) {
-        ReplaceEnd = ReplaceBegin;
-      } else {
-        ReplaceEnd = std::upper_bound(ReplaceBegin, SemaToks.end(),
-            Upd->getByteOffset() + Upd->getLength(),
-            [&](unsigned EndOffset, const SwiftSemanticToken &Tok) -> bool {
-              return EndOffset < Tok.ByteOffset;
-            });
-      }
-
-      unsigned InsertLen = Upd->getText().size();
-      int Delta = InsertLen - Upd->getLength();
-      if (Delta != 0) {
-        for (std::vector<SwiftSemanticToken>::iterator
-               I = ReplaceEnd, E = SemaToks.end(); I != E; ++I)
-          I->ByteOffset += Delta;
-      }
-      SemaToks.erase(ReplaceBegin, ReplaceEnd);
+      adjustSemanticTokens(SemaToks, Upd);
       return true;
     });
 
   return std::move(SemaToks);
 }
 
+void SwiftDocumentSemanticInfo::readSemanticTokensInRange(
+    ImmutableTextSnapshotRef NewSnapshot, unsigned StartOffset,
+    unsigned EndOffset, std::vector<SwiftSemanticToken> &Tokens) {
+
+  llvm::sys::ScopedLock L(Mtx);
+
+  if (SemaToks.empty())
+    return;
+
+  // Bring the tokens up to date and remember that they now describe
+  // NewSnapshot, so later reads only adjust for newer edits.
+  TokSnapshot->foreachReplaceUntil(NewSnapshot,
+    [&](ReplaceImmutableTextUpdateRef Upd) -> bool {
+      if (SemaToks.empty())
+        return false;
+
+      adjustSemanticTokens(SemaToks, Upd);
+      return true;
+    });
+  TokSnapshot = NewSnapshot;
+
+  auto I = std::lower_bound(SemaToks.begin(), SemaToks.end(), StartOffset,
+      [](const SwiftSemanticToken &Tok, unsigned Offset) -> bool {
+        return Tok.ByteOffset < Offset;
+      });
+  for (auto E = SemaToks.end(); I != E && I->ByteOffset < EndOffset; ++I)
+    Tokens.push_back(*I);
+}
+
 static bool
 adjustDiagnosticRanges(SmallVectorImpl<std::pair<unsigned, unsigned>> &Ranges,
                        unsigned ByteOffset, unsigned RemoveLen, int Delta) {
@@ -747,6 +818,9 @@ void SwiftDocumentSemanticInfo::updateSemanticInfo(
   {
     llvm::sys::ScopedLock L(Mtx);
     if (ASTGeneration > this->ASTGeneration) {
+      CompleteToks = Toks;
+      CompleteDiags = Diags;
+      CompleteSnapshot = Snapshot;
       SemaToks = std::move(Toks);
       SemaDiags = std::move(Diags);
       TokSnapshot = DiagSnapshot = std::move(Snapshot);
@@ -758,6 +832,76 @@ void SwiftDocumentSemanticInfo::updateSemanticInfo(
   NotificationCtr.postDocumentUpdateNotification(Filename);
 }
 
+bool SwiftDocumentSemanticInfo::addSkippedBodyInfo(
+    ImmutableTextSnapshotRef BaseSnapshot,
+    ImmutableTextSnapshotRef Snapshot,
+    ArrayRef<std::pair<unsigned, unsigned>> SkippedRanges,
+    std::vector<SwiftSemanticToken> &Toks,
+    std::vector<DiagnosticEntryInfo> &Diags) {
+
+  std::vector<SwiftSemanticToken> OldToks;
+  std::vector<DiagnosticEntryInfo> OldDiags;
+  {
+    llvm::sys::ScopedLock L(Mtx);
+    if (!CompleteSnapshot ||
+        CompleteSnapshot->getStamp() != BaseSnapshot->getStamp())
+      return false;
+    OldToks = CompleteToks;
+    OldDiags = CompleteDiags;
+  }
+
+  // Bring the old results to the positions of the new snapshot; the skipped
+  // bodies were not edited so nothing inside them is dropped.
+  BaseSnapshot->foreachReplaceUntil(Snapshot,
+    [&](ReplaceImmutableTextUpdateRef Upd) -> bool {
+      adjustSemanticTokens(OldToks, Upd);
+
+      unsigned ByteOffset = Upd->getByteOffset();
+      unsigned RemoveLen = Upd->getLength();
+      unsigned InsertLen = Upd->getText().size();
+      int Delta = InsertLen - RemoveLen;
+      OldDiags = adjustDiagnostics(std::move(OldDiags), Filename,
+                                   ByteOffset, RemoveLen, Delta);
+      return true;
+    });
+
+  auto isInSkippedRange = [&](unsigned Offset) -> bool {
+    auto I = std::upper_bound(SkippedRanges.begin(), SkippedRanges.end(),
+        Offset,
+        [](unsigned Offset, const std::pair<unsigned, unsigned> &Range) {
+          return Offset < Range.first;
+        });
+    if (I == SkippedRanges.begin())
+      return false;
+    --I;
+    return Offset < I->first + I->second;
+  };
+
+  for (auto &Tok : OldToks) {
+    if (isInSkippedRange(Tok.ByteOffset))
+      Toks.push_back(Tok);
+  }
+  std::stable_sort(Toks.begin(), Toks.end(),
+                   [](const SwiftSemanticToken &LHS,
+                      const SwiftSemanticToken &RHS) {
+                     return LHS.ByteOffset < RHS.ByteOffset;
+                   });
+
+  auto ImmBuf = Snapshot->getBuffer();
+  for (auto &Diag : OldDiags) {
+    if (!isInSkippedRange(Diag.Offset))
+      continue;
+    std::tie(Diag.Line, Diag.Column) = ImmBuf->getLineAndColumn(Diag.Offset);
+    Diags.push_back(std::move(Diag));
+  }
+  std::stable_sort(Diags.begin(), Diags.end(),
+                   [](const DiagnosticEntryInfo &LHS,
+                      const DiagnosticEntryInfo &RHS) {
+                     return LHS.Offset < RHS.Offset;
+                   });
+  return true;
+}
+
 namespace {
 
 class SemanticAnnotator : public SourceEntityWalker {
@@ -807,14 +951,25 @@ namespace {
 class AnnotAndDiagASTConsumer : public SwiftASTConsumer {
   EditableTextBufferRef EditableBuffer;
   RefPtr<SwiftDocumentSemanticInfo> SemaInfoRef;
+  bool AllowPartialAST;
 
 public:
   std::vector<SwiftSemanticToken> SemaToks;
 
   AnnotAndDiagASTConsumer(EditableTextBufferRef EditableBuffer,
-                          RefPtr<SwiftDocumentSemanticInfo> SemaInfoRef)
+                          RefPtr<SwiftDocumentSemanticInfo> SemaInfoRef,
+                          bool AllowPartialAST)
     : EditableBuffer(std::move(EditableBuffer)),
-      SemaInfoRef(std::move(SemaInfoRef)) { }
+      SemaInfoRef(std::move(SemaInfoRef)),
+      AllowPartialAST(AllowPartialAST) { }
+
+  bool canUsePartialAST() override {
+    return AllowPartialAST;
+  }
+
+  bool isInteractive() override {
+    return false;
+  }
 
   void failed(StringRef Error) override {
     LOG_WARN_FUNC("sema annotations failed: " << Error);
@@ -873,12 +1028,26 @@ public:
     SemanticAnnotator Annotator(CompIns.getSourceMgr(), BufferID);
     Annotator.walk(AstUnit->getPrimarySourceFile());
     SemaToks = std::move(Annotator.SemaToks);
+    std::vector<DiagnosticEntryInfo> SemaDiags =
+        Consumer.getDiagnosticsForBuffer(BufferID);
 
     TracedOp.finish();
 
+    if (AstUnit->isPartial() &&
+        !SemaInfoRef->addSkippedBodyInfo(AstUnit->getBaseSnapshot(),
+                                         DocSnapshot,
+                                         AstUnit->getSkippedBodyRanges(),
+                                         SemaToks, SemaDiags)) {
+      // The results for the bodies that the AST skipped are not available
+      // anymore; get an AST with all of them.
+      SemaInfoRef->processLatestSnapshotAsync(EditableBuffer,
+                                              /*AllowPartialAST=*/false);
+      return;
+    }
+
     SemaInfoRef->
       updateSemanticInfo(std::move(SemaToks),
-                     std::move(Consumer.getDiagnosticsForBuffer(BufferID)),
+                         std::move(SemaDiags),
                          DocSnapshot,
                          Generation);
 
@@ -892,7 +1061,7 @@ public:
 } // anonymous namespace
 
 void SwiftDocumentSemanticInfo::processLatestSnapshotAsync(
-    EditableTextBufferRef EditableBuffer) {
+    EditableTextBufferRef EditableBuffer, bool AllowPartialAST) {
 
   SwiftInvocationRef Invok = InvokRef;
   if (!Invok)
@@ -900,7 +1069,8 @@ void SwiftDocumentSemanticInfo::processLatestSnapshotAsync(
 
   RefPtr<SwiftDocumentSemanticInfo> SemaInfoRef = this;
   auto Consumer = std::make_shared<AnnotAndDiagASTConsumer>(EditableBuffer,
-                                                            SemaInfoRef);
+                                                            SemaInfoRef,
+                                                            AllowPartialAST);
 
   // Semantic annotation queries for a particular document should cancel
   // previously queued queries for the same document. Each document has a
@@ -1799,6 +1969,60 @@ void SwiftEditorDocument::readSemanticInfo(ImmutableTextSnapshotRef Snapshot,
     Consumer.handleDiagnostic(Diag, SemaDiagStage);
 }
 
+void SwiftEditorDocument::readAnnotationsInLineRange(unsigned Line,
+                                                     unsigned Length,
+                                                     EditorConsumer &Consumer) {
+  ImmutableTextSnapshotRef Snapshot = getLatestSnapshot();
+  unsigned StartOffset;
+  unsigned EndOffset;
+  {
+    llvm::sys::ScopedLock L(Impl.AccessMtx);
+
+    SourceManager &SM = Impl.SyntaxInfo->getSourceManager();
+    unsigned BufferID = Impl.SyntaxInfo->getBufferID();
+    StringRef Text =
+        SM.getLLVMSourceMgr().getMemoryBuffer(BufferID)->getBuffer();
+
+    auto getNextLineStart = [&](size_t LineStart) -> size_t {
+      size_t Newline = Text.find('\n', LineStart);
+      return Newline == StringRef::npos ? Text.size() : Newline + 1;
+    };
+
+    size_t LineStart = 0;
+    for (unsigned CurLine = 1; CurLine < Line && LineStart < Text.size();
+         ++CurLine)
+      LineStart = getNextLineStart(LineStart);
+    StartOffset = LineStart;
+
+    // The syntax map is kept up to date per line by readSyntaxInfo(), so we
+    // only need to translate the columns of the requested lines to offsets.
+    // Tokens that start before Line (e.g. a multi-line comment) are not
+    // reported.
+    for (unsigned CurLine = Line; CurLine < Line + Length &&
+                                  LineStart < Text.size(); ++CurLine) {
+      for (auto &Tok : Impl.SyntaxMap.getTokensForLine(CurLine)) {
+        UIdent Kind = SwiftLangSupport::getUIDForSyntaxNodeKind(Tok.Kind);
+        Consumer.handleSyntaxMap(LineStart + Tok.Column - 1, Tok.Length, Kind);
+      }
+      LineStart = getNextLineStart(LineStart);
+    }
+    EndOffset = LineStart;
+  }
+
+  std::vector<SwiftSemanticToken> SemaToks;
+  Impl.SemanticInfo->readSemanticTokensInRange(Snapshot, StartOffset,
+                                               EndOffset, SemaToks);
+  for (auto SemaTok : SemaToks) {
+    UIdent Kind = SemaTok.getUIdentForKind();
+    if (Kind.isValid())
+      if (!Consumer.handleSemanticAnnotation(SemaTok.ByteOffset, SemaTok.Length,
+                                             Kind, SemaTok.IsSystem))
+        break;
+  }
+
+  Consumer.recordAffectedRange(StartOffset, EndOffset - StartOffset);
+}
+
 void SwiftEditorDocument::removeCachedAST() {
   Impl.SemanticInfo->removeCachedAST();
 }
@@ -2090,6 +2314,23 @@ void SwiftLangSupport::editorReplaceText(StringRef Name, llvm::MemoryBuffer *Buf
 }
 
 
+//===----------------------------------------------------------------------===//
+// EditorReadAnnotations
+//===----------------------------------------------------------------------===//
+
+void SwiftLangSupport::editorReadAnnotations(StringRef Name, unsigned Line,
+                                             unsigned Length,
+                                             EditorConsumer &Consumer) {
+  auto EditorDoc = EditorDocuments.getByUnresolvedName(Name);
+  if (!EditorDoc) {
+    Consumer.handleRequestError("No associated Editor Document");
+    return;
+  }
+
+  EditorDoc->readAnnotationsInLineRange(Line, Length, Consumer);
+}
+
+
 //===----------------------------------------------------------------------===//
 // EditorFormatText
 //===----------------------------------------------------------------------===//
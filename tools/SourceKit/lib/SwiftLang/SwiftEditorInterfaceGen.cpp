@@ -23,8 +23,9 @@
 #include "swift/IDE/Utils.h"
 #include "swift/Strings.h"
 
-#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/ConvertUTF.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
 
 using namespace SourceKit;
 using namespace swift;
@@ -69,7 +70,6 @@ public:
 
   // Hold an AstUnit so that the Decl* we have are always valid.
   ASTUnitRef AstUnit;
-  std::string DocumentName;
   bool IsModule = false;
   std::string ModuleOrHeaderName;
   CompilerInvocation Invocation;
@@ -79,6 +79,14 @@ public:
   SourceTextInfo Info;
   // This is the non-typechecked AST for the generated interface source.
   CompilerInstance TextCI;
+  // The group that was printed, and whether synthesized extensions were
+  // included, for deciding whether a later request can reuse this interface.
+  Optional<std::string> Group;
+  bool SynthesizedExtensions = false;
+  // The module file the interface was printed from, if known, and its
+  // modification time when it was printed.
+  std::string ModuleFilename;
+  llvm::sys::TimeValue ModuleModificationTime;
   // Synchronize access to the embedded compiler instance (if we don't have an
   // ASTUnit).
   WorkQueue Queue{WorkQueue::Dequeuing::Serial,
@@ -324,6 +332,23 @@ static bool getModuleInterfaceInfo(ASTContext &Ctx,
   if (!Group && InterestedUSR) {
     Group = findGroupNameForUSR(Mod, InterestedUSR.getValue());
   }
+  if (Group)
+    Impl.Group = Group->str();
+  Impl.SynthesizedExtensions = Group.hasValue() && SynthesizedExtensions;
+
+  // Remember which file the interface is printed from, so that it's reused
+  // only as long as that file doesn't change.
+  if (!Mod->getFiles().empty()) {
+    if (auto *File = dyn_cast<LoadedFile>(Mod->getFiles().front())) {
+      llvm::sys::fs::file_status Status;
+      if (!File->getFilename().empty() &&
+          !llvm::sys::fs::status(File->getFilename(), Status)) {
+        Impl.ModuleFilename = File->getFilename();
+        Impl.ModuleModificationTime = Status.getLastModificationTime();
+      }
+    }
+  }
+
   printSubmoduleInterface(Mod, SplitModuleName,
     Group.hasValue() ? llvm::makeArrayRef(Group.getValue()) : ArrayRef<StringRef>(),
                           TraversalOptions,
@@ -360,7 +385,7 @@ SwiftInterfaceGenContext::createForSwiftSource(StringRef DocumentName,
                                                ASTUnitRef AstUnit,
                                                std::string &ErrMsg) {
   SwiftInterfaceGenContextRef IFaceGenCtx{ new SwiftInterfaceGenContext() };
-  IFaceGenCtx->Impl.DocumentName = DocumentName;
+  IFaceGenCtx->DocumentName = DocumentName;
   IFaceGenCtx->Impl.IsModule = true;
   IFaceGenCtx->Impl.ModuleOrHeaderName = SourceFileName;
   IFaceGenCtx->Impl.AstUnit = AstUnit;
@@ -388,7 +413,7 @@ SwiftInterfaceGenContext::create(StringRef DocumentName,
                                  bool SynthesizedExtensions,
                                  Optional<StringRef> InterestedUSR) {
   SwiftInterfaceGenContextRef IFaceGenCtx{ new SwiftInterfaceGenContext() };
-  IFaceGenCtx->Impl.DocumentName = DocumentName;
+  IFaceGenCtx->DocumentName = DocumentName;
   IFaceGenCtx->Impl.IsModule = IsModule;
   IFaceGenCtx->Impl.ModuleOrHeaderName = ModuleOrHeaderName;
   IFaceGenCtx->Impl.Invocation = Invocation;
@@ -442,6 +467,15 @@ SwiftInterfaceGenContext::create(StringRef DocumentName,
   return IFaceGenCtx;
 }
 
+SwiftInterfaceGenContextRef
+SwiftInterfaceGenContext::createReusing(StringRef DocumentName,
+                                        SwiftInterfaceGenContextRef Existing) {
+  SwiftInterfaceGenContextRef IFaceGenCtx{
+    new SwiftInterfaceGenContext(Existing->ImplRef) };
+  IFaceGenCtx->DocumentName = DocumentName;
+  return IFaceGenCtx;
+}
+
 SwiftInterfaceGenContextRef
 SwiftInterfaceGenContext::createForTypeInterface(CompilerInvocation Invocation,
                                                  StringRef TypeUSR,
@@ -479,7 +513,7 @@ SwiftInterfaceGenContext::createForTypeInterface(CompilerInvocation Invocation,
   llvm::raw_svector_ostream OS(Text);
   AnnotatingPrinter Printer(Info, OS);
   if (ide::printTypeInterface(Module, TypeUSR, Printer,
-                              IFaceGenCtx->Impl.DocumentName, ErrorMsg))
+                              IFaceGenCtx->DocumentName, ErrorMsg))
     return nullptr;
   IFaceGenCtx->Impl.Info.Text = OS.str();
   if (makeParserAST(IFaceGenCtx->Impl.TextCI, IFaceGenCtx->Impl.Info.Text)) {
@@ -490,14 +524,16 @@ SwiftInterfaceGenContext::createForTypeInterface(CompilerInvocation Invocation,
 }
 
 SwiftInterfaceGenContext::SwiftInterfaceGenContext()
-  : Impl(*new Implementation) {
+  : SwiftInterfaceGenContext(std::make_shared<Implementation>()) {
 }
-SwiftInterfaceGenContext::~SwiftInterfaceGenContext() {
-  delete &Impl;
+SwiftInterfaceGenContext::SwiftInterfaceGenContext(
+    std::shared_ptr<Implementation> SharedImpl)
+  : ImplRef(std::move(SharedImpl)), Impl(*ImplRef) {
 }
+SwiftInterfaceGenContext::~SwiftInterfaceGenContext() = default;
 
 StringRef SwiftInterfaceGenContext::getDocumentName() const {
-  return Impl.DocumentName;
+  return DocumentName;
 }
 
 StringRef SwiftInterfaceGenContext::getModuleOrHeaderName() const {
@@ -541,6 +577,29 @@ bool SwiftInterfaceGenContext::matches(StringRef ModuleName,
   return true;
 }
 
+bool SwiftInterfaceGenContext::isReusable() const {
+  return Impl.IsModule && !Impl.ModuleFilename.empty();
+}
+
+bool SwiftInterfaceGenContext::canBeReusedFor(
+    StringRef ModuleName, Optional<StringRef> Group, bool SynthesizedExtensions,
+    const swift::CompilerInvocation &Invok) {
+  if (!isReusable() || !matches(ModuleName, Invok))
+    return false;
+
+  if (Group.hasValue() != Impl.Group.hasValue() ||
+      (Group && *Group != *Impl.Group))
+    return false;
+  if ((Group.hasValue() && SynthesizedExtensions) !=
+      Impl.SynthesizedExtensions)
+    return false;
+
+  llvm::sys::fs::file_status Status;
+  if (llvm::sys::fs::status(Impl.ModuleFilename, Status))
+    return false;
+  return Status.getLastModificationTime() == Impl.ModuleModificationTime;
+}
+
 void SwiftInterfaceGenContext::reportEditorInfo(EditorConsumer &Consumer) const {
   Consumer.handleSourceText(Impl.Info.Text);
   reportSyntacticAnnotations(Impl.TextCI, Consumer);
@@ -627,7 +686,16 @@ void SwiftInterfaceGenMap::set(StringRef Name,
 
 bool SwiftInterfaceGenMap::remove(StringRef Name) {
   llvm::sys::ScopedLock L(Mtx);
-  return IFaceGens.erase(Name);
+  auto It = IFaceGens.find(Name);
+  if (It == IFaceGens.end())
+    return false;
+  if (It->second->isReusable()) {
+    Closed.push_back(It->second);
+    if (Closed.size() > MaxClosed)
+      Closed.erase(Closed.begin());
+  }
+  IFaceGens.erase(It);
+  return true;
 }
 
 SwiftInterfaceGenContextRef
@@ -640,6 +708,25 @@ SwiftInterfaceGenMap::find(StringRef ModuleName,
   }
   return nullptr;
 }
+
+SwiftInterfaceGenContextRef
+SwiftInterfaceGenMap::findReusable(StringRef ModuleName,
+                                   Optional<StringRef> Group,
+                                   bool SynthesizedExtensions,
+                                   const CompilerInvocation &Invok) {
+  llvm::sys::ScopedLock L(Mtx);
+  for (auto &Entry : IFaceGens) {
+    if (Entry.getValue()->canBeReusedFor(ModuleName, Group,
+                                         SynthesizedExtensions, Invok))
+      return Entry.getValue();
+  }
+  for (auto I = Closed.rbegin(), E = Closed.rend(); I != E; ++I) {
+    if ((*I)->canBeReusedFor(ModuleName, Group, SynthesizedExtensions, Invok))
+      return *I;
+  }
+  return nullptr;
+}
+
 //===----------------------------------------------------------------------===//
 // EditorOpenTypeInterface
 //===----------------------------------------------------------------------===//
@@ -712,6 +799,29 @@ void SwiftLangSupport::editorOpenInterface(EditorConsumer &Consumer,
 
   Invocation.getClangImporterOptions().ImportForwardDeclarations = true;
 
+  // Printing a big module takes a while, so reuse the interface if it was
+  // generated before (and possibly closed since) and the module hasn't
+  // changed. Without an explicit group, the interested USR picks the group,
+  // which isn't known until the module is loaded.
+  if (Group || !InterestedUSR) {
+    if (auto Existing = IFaceGenContexts.findReusable(ModuleName, Group,
+                                                      SynthesizedExtensions,
+                                                      Invocation)) {
+      auto IFaceGenRef =
+          SwiftInterfaceGenContext::createReusing(Name, Existing);
+      // The AST is shared with the existing interface, so wait for exclusive
+      // access to it.
+      Semaphore Done(0);
+      IFaceGenRef->accessASTAsync([&] {
+        IFaceGenRef->reportEditorInfo(Consumer);
+        Done.signal();
+      });
+      Done.wait();
+      IFaceGenContexts.set(Name, IFaceGenRef);
+      return;
+    }
+  }
+
   std::string ErrMsg;
   auto IFaceGenRef = SwiftInterfaceGenContext::create(Name,
                                                       /*IsModule=*/true,
@@ -19,6 +19,7 @@
 #include "swift/Frontend/Frontend.h"
 #include "swift/Frontend/PrintingDiagnosticConsumer.h"
 #include "swift/Index/Index.h"
+#include "swift/Index/IndexRecord.h"
 #include "swift/Serialization/SerializedModuleLoader.h"
 // This is included only for createLazyResolver(). Move to different header ?
 #include "swift/Sema/IDETypeChecking.h"
@@ -106,8 +107,13 @@ private:
     info.IsTestCandidate = symbol.subKinds & SymbolSubKind::UnitTest;
     std::vector<UIdent> uidAttrs;
     if (!isRef) {
-      uidAttrs =
-        SwiftLangSupport::UIDsFromDeclAttributes(symbol.decl->getAttrs());
+      // Symbols replayed from an index record have no decl.
+      if (symbol.decl)
+        uidAttrs =
+          SwiftLangSupport::UIDsFromDeclAttributes(symbol.decl->getAttrs());
+      else
+        uidAttrs =
+          SwiftLangSupport::UIDsFromDeclAttributeNames(symbol.attributeNames);
       info.Attrs = uidAttrs;
     }
     return func(info);
@@ -249,6 +255,19 @@ void SwiftLangSupport::indexSource(StringRef InputFile,
     return;
   }
 
+  // If the build wrote an index record for the current contents of the file,
+  // replay it instead of type-checking the file again.
+  StringRef IndexStorePath = Invocation.getFrontendOptions().IndexStorePath;
+  if (!IndexStorePath.empty()) {
+    std::string Key = index::getIndexRecordKey(
+        index::getIndexRecordInvocationHash(Invocation.getLangOptions(),
+                                            Invocation.getSearchPathOptions()),
+        Invocation.getModuleName(), InputFile, InputBuf->getBuffer());
+    SKIndexDataConsumer IdxDataConsumer(IdxConsumer);
+    if (index::readIndexRecord(IndexStorePath, Key, Hash, IdxDataConsumer))
+      return;
+  }
+
   if (CI.setup(Invocation))
     return;
 
@@ -16,6 +16,7 @@
 #include "SourceKit/Core/LLVM.h"
 #include "swift/AST/Module.h"
 #include "swift/Basic/ThreadSafeRefCounted.h"
+#include <memory>
 #include <string>
 
 namespace swift {
@@ -52,6 +53,12 @@ public:
                                                           ASTUnitRef AstUnit,
                                                           std::string &ErrMsg);
 
+  /// Creates a context named \p DocumentName for the same interface as
+  /// \p Existing, sharing its generated text and AST instead of printing the
+  /// module again.
+  static SwiftInterfaceGenContextRef
+    createReusing(StringRef DocumentName, SwiftInterfaceGenContextRef Existing);
+
   ~SwiftInterfaceGenContext();
 
   StringRef getDocumentName() const;
@@ -60,6 +67,18 @@ public:
 
   bool matches(StringRef ModuleName, const swift::CompilerInvocation &Invok);
 
+  /// Whether this is a module interface that can be reused by later requests,
+  /// i.e. it's known which module file it was printed from.
+  bool isReusable() const;
+
+  /// Whether this interface can be reused for a request for \p ModuleName
+  /// with \p Group and \p SynthesizedExtensions. It must match \p Invok (see
+  /// \c matches) and its module file must not have changed since it was
+  /// printed.
+  bool canBeReusedFor(StringRef ModuleName, Optional<StringRef> Group,
+                      bool SynthesizedExtensions,
+                      const swift::CompilerInvocation &Invok);
+
   /// Note: requires exclusive access to the underlying AST.
   void reportEditorInfo(EditorConsumer &Consumer) const;
 
@@ -94,9 +113,13 @@ public:
   class Implementation;
 
 private:
+  /// Shared by all contexts which reuse the same generated interface.
+  std::shared_ptr<Implementation> ImplRef;
   Implementation &Impl;
+  std::string DocumentName;
 
   SwiftInterfaceGenContext();
+  explicit SwiftInterfaceGenContext(std::shared_ptr<Implementation> SharedImpl);
 };
 
 } // namespace SourceKit.
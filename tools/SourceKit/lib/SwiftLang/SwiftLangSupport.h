@@ -87,6 +87,8 @@ public:
   void readSyntaxInfo(EditorConsumer& consumer);
   void readSemanticInfo(ImmutableTextSnapshotRef Snapshot,
                         EditorConsumer& Consumer);
+  void readAnnotationsInLineRange(unsigned Line, unsigned Length,
+                                  EditorConsumer &Consumer);
 
   void applyFormatOptions(OptionsDictionary &FmtOptions);
   void formatText(unsigned Line, unsigned Length, EditorConsumer &Consumer);
@@ -122,6 +124,8 @@ public:
 
 namespace CodeCompletion {
 
+struct Options;
+
 /// Provides a thread-safe cache for code completion results that remain valid
 /// for the duration of a 'session' - for example, from the point that a user
 /// invokes code completion until they accept a completion, or otherwise close
@@ -137,6 +141,10 @@ class SessionCache : public ThreadSafeRefCountedBase<SessionCache> {
   CompletionKind completionKind;
   bool completionHasExpectedTypes;
   FilterRules filterRules;
+  /// The completions that matched \c lastFilterText, in sorted order.
+  std::vector<Completion *> lastFilteredCompletions;
+  std::string lastFilterText;
+  bool lastFilterWasFuzzy = false;
   llvm::sys::Mutex mtx;
 
 public:
@@ -150,6 +158,14 @@ public:
         filterRules(std::move(filterRules)) {}
   void setSortedCompletions(std::vector<Completion *> &&completions);
   ArrayRef<Completion *> getSortedCompletions();
+  /// Records the completions that matched \p filterText so that a later
+  /// update extending the filter text only has to look at those.
+  void setFilteredCompletions(StringRef filterText, bool wasFuzzy,
+                              std::vector<Completion *> &&completions);
+  /// Returns the smallest known set of completions that may match
+  /// \p filterText, falling back to all the sorted completions.
+  std::vector<Completion *> getCompletionsToFilter(StringRef filterText,
+                                                   const Options &options);
   llvm::MemoryBuffer *getBuffer();
   ArrayRef<std::string> getCompilerArgs();
   const FilterRules &getFilterRules();
@@ -178,14 +194,26 @@ public:
 
 class SwiftInterfaceGenMap {
   llvm::StringMap<SwiftInterfaceGenContextRef> IFaceGens;
+  /// Recently closed module interfaces, oldest first. They are kept around
+  /// so that opening the same interface again can reuse them.
+  std::vector<SwiftInterfaceGenContextRef> Closed;
   mutable llvm::sys::Mutex Mtx;
 
+  /// The maximum number of closed interfaces to keep.
+  static const unsigned MaxClosed = 4;
+
 public:
   SwiftInterfaceGenContextRef get(StringRef Name) const;
   void set(StringRef Name, SwiftInterfaceGenContextRef IFaceGen);
   bool remove(StringRef Name);
   SwiftInterfaceGenContextRef find(StringRef ModuleName,
                                    const swift::CompilerInvocation &Invok);
+  /// Finds an open or recently closed interface which can be reused for a
+  /// new request. See \c SwiftInterfaceGenContext::canBeReusedFor.
+  SwiftInterfaceGenContextRef
+  findReusable(StringRef ModuleName, Optional<StringRef> Group,
+               bool SynthesizedExtensions,
+               const swift::CompilerInvocation &Invok);
 };
 
 struct SwiftCompletionCache
@@ -258,6 +286,9 @@ public:
 
   static std::vector<UIdent> UIDsFromDeclAttributes(const swift::DeclAttributes &Attrs);
 
+  /// Maps the names from \c swift::index::getDeclAttributeNames() to UIDs.
+  static std::vector<UIdent> UIDsFromDeclAttributeNames(ArrayRef<StringRef> Names);
+
 
   static bool printDisplayName(const swift::ValueDecl *D, llvm::raw_ostream &OS);
 
@@ -367,6 +398,9 @@ public:
   void editorApplyFormatOptions(StringRef Name,
                                 OptionsDictionary &FmtOptions) override;
 
+  void editorReadAnnotations(StringRef Name, unsigned Line, unsigned Length,
+                             EditorConsumer &Consumer) override;
+
   void editorFormatText(StringRef Name, unsigned Line, unsigned Length,
                         EditorConsumer &Consumer) override;
 
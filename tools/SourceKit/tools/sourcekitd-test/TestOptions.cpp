@@ -117,6 +117,7 @@ bool TestOptions::parseArgs(llvm::ArrayRef<const char *> Args) {
         .Case("syntax-map", SourceKitRequest::SyntaxMap)
         .Case("structure", SourceKitRequest::Structure)
         .Case("format", SourceKitRequest::Format)
+        .Case("annotations", SourceKitRequest::Annotations)
         .Case("expand-placeholder", SourceKitRequest::ExpandPlaceholder)
         .Case("doc-info", SourceKitRequest::DocInfo)
         .Case("sema", SourceKitRequest::SemanticInfo)
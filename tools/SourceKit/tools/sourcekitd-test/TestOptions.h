@@ -37,6 +37,7 @@ enum class SourceKitRequest {
   SyntaxMap,
   Structure,
   Format,
+  Annotations,
   ExpandPlaceholder,
   DocInfo,
   SemanticInfo,
@@ -151,6 +151,7 @@ static sourcekitd_uid_t RequestEditorOpenHeaderInterface;
 static sourcekitd_uid_t RequestEditorExtractTextFromComment;
 static sourcekitd_uid_t RequestEditorReplaceText;
 static sourcekitd_uid_t RequestEditorFormatText;
+static sourcekitd_uid_t RequestEditorReadAnnotations;
 static sourcekitd_uid_t RequestEditorExpandPlaceholder;
 static sourcekitd_uid_t RequestEditorFindUSR;
 static sourcekitd_uid_t RequestEditorFindInterfaceDoc;
@@ -270,6 +271,8 @@ static int skt_main(int argc, const char **argv) {
   RequestEditorExtractTextFromComment = sourcekitd_uid_get_from_cstr("source.request.editor.extract.comment");
   RequestEditorReplaceText = sourcekitd_uid_get_from_cstr("source.request.editor.replacetext");
   RequestEditorFormatText = sourcekitd_uid_get_from_cstr("source.request.editor.formattext");
+  RequestEditorReadAnnotations =
+      sourcekitd_uid_get_from_cstr("source.request.editor.annotations");
   RequestEditorExpandPlaceholder = sourcekitd_uid_get_from_cstr("source.request.editor.expand_placeholder");
   RequestEditorFindUSR = sourcekitd_uid_get_from_cstr("source.request.editor.find_usr");
   RequestEditorFindInterfaceDoc = sourcekitd_uid_get_from_cstr("source.request.editor.find_interface_doc");
@@ -576,6 +579,7 @@ static int handleTestInvocation(ArrayRef<const char *> Args,
     break;
 
   case SourceKitRequest::Format:
+  case SourceKitRequest::Annotations:
     sourcekitd_request_dictionary_set_uid(Req, KeyRequest, RequestEditorOpen);
     sourcekitd_request_dictionary_set_string(Req, KeyName, SourceFile.c_str());
     sourcekitd_request_dictionary_set_int64(Req, KeyEnableSyntaxMap, false);
@@ -921,6 +925,25 @@ static bool handleResponse(sourcekitd_response_t Resp, const TestOptions &Opts,
       }
       break;
 
+    case SourceKitRequest::Annotations:
+      {
+        sourcekitd_object_t AnnReq =
+            sourcekitd_request_dictionary_create(nullptr, nullptr, 0);
+        sourcekitd_request_dictionary_set_uid(AnnReq, KeyRequest,
+                                              RequestEditorReadAnnotations);
+        sourcekitd_request_dictionary_set_string(AnnReq, KeyName,
+                                                 SourceFile.c_str());
+        sourcekitd_request_dictionary_set_int64(AnnReq, KeyLine, Opts.Line);
+        sourcekitd_request_dictionary_set_int64(AnnReq, KeyLength,
+                                                Opts.Length);
+
+        sourcekitd_response_t AnnResp = sourcekitd_send_request_sync(AnnReq);
+        sourcekitd_response_description_dump_filedesc(AnnResp, STDOUT_FILENO);
+        sourcekitd_response_dispose(AnnResp);
+        sourcekitd_request_release(AnnReq);
+      }
+      break;
+
       case SourceKitRequest::ExpandPlaceholder:
         expandPlaceholders(SourceBuf.get(), llvm::outs());
         break;
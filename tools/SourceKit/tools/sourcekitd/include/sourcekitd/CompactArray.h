@@ -15,6 +15,7 @@
 
 #include "sourcekitd/Internal.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringMap.h"
 
 namespace sourcekitd {
 
@@ -41,6 +42,9 @@ private:
 
   llvm::SmallVector<uint8_t, 256> EntriesBuffer;
   llvm::SmallString<256> StringBuffer;
+  /// Offsets of the strings already in \c StringBuffer, so that repeated
+  /// strings (type names, module names, ...) are stored only once.
+  llvm::StringMap<unsigned> StringOffsets;
 };
 
 
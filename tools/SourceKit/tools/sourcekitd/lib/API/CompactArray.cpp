@@ -63,10 +63,13 @@ unsigned CompactArrayBuilderImpl::getOffsetForString(StringRef Str) {
   if (Str.empty())
     return 0;
 
-  unsigned Offset = StringBuffer.size();
+  auto Inserted = StringOffsets.insert({Str, unsigned(StringBuffer.size())});
+  if (!Inserted.second)
+    return Inserted.first->getValue();
+
   StringBuffer += Str;
   StringBuffer += '\0';
-  return Offset;
+  return Inserted.first->getValue();
 }
 
 std::unique_ptr<llvm::MemoryBuffer>
@@ -99,6 +99,8 @@ static LazySKDUID RequestEditorExtractTextFromComment(
 static LazySKDUID RequestEditorClose("source.request.editor.close");
 static LazySKDUID RequestEditorReplaceText("source.request.editor.replacetext");
 static LazySKDUID RequestEditorFormatText("source.request.editor.formattext");
+static LazySKDUID RequestEditorReadAnnotations(
+    "source.request.editor.annotations");
 static LazySKDUID RequestEditorExpandPlaceholder(
     "source.request.editor.expand_placeholder");
 static LazySKDUID RequestEditorFindUSR("source.request.editor.find_usr");
@@ -234,6 +236,9 @@ editorApplyFormatOptions(StringRef Name, RequestDict &FmtOptions);
 static sourcekitd_response_t
 editorFormatText(StringRef Name, unsigned Line, unsigned Length);
 
+static sourcekitd_response_t
+editorReadAnnotations(StringRef Name, unsigned Line, unsigned Length);
+
 static sourcekitd_response_t
 editorExpandPlaceholder(StringRef Name, unsigned Offset, unsigned Length);
 
@@ -467,6 +472,19 @@ void handleRequestImpl(sourcekitd_object_t ReqObj, ResponseReceiver Rec) {
     Req.getInt64(KeyLength, Length, /*isOptional=*/true);
     return Rec(editorFormatText(*Name, Line, Length));
   }
+  if (ReqUID == RequestEditorReadAnnotations) {
+    Optional<StringRef> Name = Req.getString(KeyName);
+    if (!Name.hasValue())
+      return Rec(createErrorRequestInvalid("missing 'key.name'"));
+    int64_t Line = 0;
+    if (Req.getInt64(KeyLine, Line, /*isOptional=*/false))
+      return Rec(createErrorRequestInvalid("missing 'key.line'"));
+    if (Line < 1)
+      return Rec(createErrorRequestInvalid("'key.line' must be 1 or greater"));
+    int64_t Length = 1;
+    Req.getInt64(KeyLength, Length, /*isOptional=*/true);
+    return Rec(editorReadAnnotations(*Name, Line, Length));
+  }
   if (ReqUID == RequestEditorExpandPlaceholder) {
     Optional<StringRef> Name = Req.getString(KeyName);
     if (!Name.hasValue())
@@ -1086,12 +1104,13 @@ static std::string mangleSimpleClass(StringRef moduleName,
                                      StringRef className) {
   using namespace swift::Demangle;
 
-  auto moduleNode = NodeFactory::create(Node::Kind::Module, moduleName);
-  auto IdNode = NodeFactory::create(Node::Kind::Identifier, className);
-  auto classNode = NodeFactory::create(Node::Kind::Class);
-  auto typeNode = NodeFactory::create(Node::Kind::Type);
-  auto typeManglingNode = NodeFactory::create(Node::Kind::TypeMangling);
-  auto globalNode = NodeFactory::create(Node::Kind::Global);
+  NodeFactory Factory;
+  auto moduleNode = Factory.create(Node::Kind::Module, moduleName);
+  auto IdNode = Factory.create(Node::Kind::Identifier, className);
+  auto classNode = Factory.create(Node::Kind::Class);
+  auto typeNode = Factory.create(Node::Kind::Type);
+  auto typeManglingNode = Factory.create(Node::Kind::TypeMangling);
+  auto globalNode = Factory.create(Node::Kind::Global);
 
   classNode->addChildren(moduleNode, IdNode);
   typeNode->addChild(classNode);
@@ -1934,6 +1953,15 @@ editorFormatText(StringRef Name, unsigned Line, unsigned Length) {
   return EditC.createResponse();
 }
 
+static sourcekitd_response_t
+editorReadAnnotations(StringRef Name, unsigned Line, unsigned Length) {
+  SKEditorConsumer EditC(/*EnableSyntaxMap=*/true, /*EnableStructure=*/false,
+                         /*EnableDiagnostics=*/false, /*SyntacticOnly=*/true);
+  LangSupport &Lang = getGlobalContext().getSwiftLangSupport();
+  Lang.editorReadAnnotations(Name, Line, Length, EditC);
+  return EditC.createResponse();
+}
+
 static sourcekitd_response_t
 editorExpandPlaceholder(StringRef Name, unsigned Offset, unsigned Length) {
   SKEditorConsumer EditC(false, false, false,
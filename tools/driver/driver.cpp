@@ -161,6 +161,15 @@ int main(int argc_, const char **argv_) {
                                                 argv.data()+argv.size()),
                              argv[0], (void *)(intptr_t)getExecutablePath);
     }
+    if (FirstArg == "-frontend-server") {
+      if (argv.size() != 3) {
+        llvm::errs() << "error: expected a socket path after "
+                     << "'-frontend-server'\n";
+        return 1;
+      }
+      return performFrontendServer(argv[2], argv[0],
+                                   (void *)(intptr_t)getExecutablePath);
+    }
     if (FirstArg == "-modulewrap") {
       return modulewrap_main(llvm::makeArrayRef(argv.data()+2,
                                                 argv.data()+argv.size()),
@@ -104,6 +104,12 @@ Passes(llvm::cl::desc("Passes:"),
 #include "swift/SILOptimizer/PassManager/Passes.def"
        clEnumValEnd));
 
+static llvm::cl::opt<std::string>
+ExternalPassPipelineFilename(
+    "external-pass-pipeline-filename",
+    llvm::cl::desc("Run the pass pipeline in the given file, as written by "
+                   "sil-passpipeline-dumper or -sil-capture-pipeline-dir"));
+
 static llvm::cl::opt<bool>
 PrintStats("print-stats", llvm::cl::desc("Print various statistics"));
 
@@ -126,6 +132,13 @@ EnableSILVerifyAll("enable-sil-verify-all",
                    llvm::cl::init(true),
                    llvm::cl::desc("Run sil verifications after every pass."));
 
+static llvm::cl::opt<bool>
+OptimizeForSize("optimize-for-size",
+                llvm::cl::Hidden,
+                llvm::cl::init(false),
+                llvm::cl::desc("Prefer smaller code over faster code, as with "
+                               "-Osize."));
+
 static llvm::cl::opt<bool>
 RemoveRuntimeAsserts("remove-runtime-asserts",
                      llvm::cl::Hidden,
@@ -232,6 +245,7 @@ int main(int argc, char **argv) {
   SILOpts.InlineThreshold = SILInlineThreshold;
   SILOpts.VerifyAll = EnableSILVerifyAll;
   SILOpts.RemoveRuntimeAsserts = RemoveRuntimeAsserts;
+  SILOpts.OptimizeForSize = OptimizeForSize;
   SILOpts.AssertConfig = AssertConfId;
   if (OptimizationGroup != OptGroup::Diagnostics)
     SILOpts.Optimization = SILOptions::SILOptMode::Optimize;
@@ -313,7 +327,10 @@ int main(int argc, char **argv) {
   if (VerifyMode)
     enableDiagnosticVerifier(CI.getSourceMgr());
 
-  if (OptimizationGroup == OptGroup::Diagnostics) {
+  if (!ExternalPassPipelineFilename.empty()) {
+    runSILOptimizationPassesWithFileSpecification(*CI.getSILModule(),
+                                                  ExternalPassPipelineFilename);
+  } else if (OptimizationGroup == OptGroup::Diagnostics) {
     runSILDiagnosticPasses(*CI.getSILModule());
   } else if (OptimizationGroup == OptGroup::Performance) {
     runSILOptimizationPasses(*CI.getSILModule());
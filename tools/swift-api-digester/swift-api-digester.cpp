@@ -151,7 +151,7 @@ SwiftVersion("swift-version",
 namespace {
 
 template<typename T>
-bool contains(std::vector<T> container, T instance) {
+bool contains(const std::vector<T> &container, T instance) {
   return std::find(container.begin(), container.end(), instance) != container.end();
 }
 
@@ -1895,18 +1895,46 @@ public:
 };
 
 void SameNameNodeMatcher::match() {
-  NodeVector MatchedRight;
+  llvm::SmallPtrSet<NodePtr, 16> MatchedRight;
   NodeVector Removed;
   NodeVector Added;
 
+  // Index the right-hand nodes by printed name and USR, so that each
+  // left-hand node only looks at the nodes it can possibly match.
+  llvm::StringMap<SmallVector<unsigned, 1>> RightByName;
+  llvm::StringMap<SmallVector<unsigned, 1>> RightByUsr;
+  for (unsigned I = 0, E = Right.size(); I != E; ++I) {
+    auto *RD = Right[I]->getAs<SDKNodeDecl>();
+    RightByName[RD->getPrintedName()].push_back(I);
+    RightByUsr[RD->getUsr()].push_back(I);
+  }
+
   for (auto *LN : Left) {
+    auto *LD = LN->getAs<SDKNodeDecl>();
+    SmallVector<unsigned, 4> CandidateIndices;
+    auto ByName = RightByName.find(LD->getPrintedName());
+    if (ByName != RightByName.end())
+      CandidateIndices.append(ByName->getValue().begin(),
+                              ByName->getValue().end());
+    auto ByUsr = RightByUsr.find(LD->getUsr());
+    if (ByUsr != RightByUsr.end())
+      CandidateIndices.append(ByUsr->getValue().begin(),
+                              ByUsr->getValue().end());
+
+    // Keep the candidates in their original order, which decides between
+    // equally good matches.
+    std::sort(CandidateIndices.begin(), CandidateIndices.end());
+    CandidateIndices.erase(std::unique(CandidateIndices.begin(),
+                                       CandidateIndices.end()),
+                           CandidateIndices.end());
 
     // This collects all the candidates that can match with LN.
     std::vector<NameMatchCandidate> Candidates;
-    for (auto *RN : Right) {
+    for (unsigned Index : CandidateIndices) {
+      auto *RN = Right[Index];
 
       // If RN has matched before, ignore it.
-      if (contains(MatchedRight, RN))
+      if (MatchedRight.count(RN))
         continue;
 
       // If LN and RN have the same name for some reason, keep track of RN.
@@ -1919,13 +1947,13 @@ void SameNameNodeMatcher::match() {
     if (auto Match = findBestNameMatch(Candidates,
                                     getNameMatchKindPriority(LN->getKind()))) {
       Listener.foundMatch(LN, Match);
-      MatchedRight.push_back(Match);
+      MatchedRight.insert(Match);
     } else {
       Removed.push_back(LN);
     }
   }
   for (auto &R : Right) {
-    if (!contains(MatchedRight, R)) {
+    if (!MatchedRight.count(R)) {
       Added.push_back(R);
     }
   }
@@ -2034,8 +2062,23 @@ class PrunePass : public MatchedNodeListener, public SDKTreeDiffPass {
   static void removeCommonChildren(NodePtr Left, NodePtr Right) {
     llvm::SmallPtrSet<NodePtr, 16> LeftToRemove;
     llvm::SmallPtrSet<NodePtr, 16> RightToRemove;
+
+    // Identical decls have the same printed name, so only compare a decl
+    // with the right-hand children of the same name.
+    llvm::StringMap<NodeVector> RightDeclsByName;
+    for (auto RC : Right->getChildren()) {
+      if (isa<SDKNodeDecl>(RC))
+        RightDeclsByName[RC->getPrintedName()].push_back(RC);
+    }
     for (auto LC : Left->getChildren()) {
-      for (auto RC : Right->getChildren()) {
+      ArrayRef<NodePtr> Candidates = Right->getChildren();
+      if (isa<SDKNodeDecl>(LC)) {
+        auto It = RightDeclsByName.find(LC->getPrintedName());
+        if (It == RightDeclsByName.end())
+          continue;
+        Candidates = It->getValue();
+      }
+      for (auto RC : Candidates) {
         if (*LC == *RC) {
           LeftToRemove.insert(LC);
           RightToRemove.insert(RC);
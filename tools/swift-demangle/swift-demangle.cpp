@@ -24,8 +24,12 @@
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <algorithm>
+#include <cerrno>
 #include <cstdlib>
 #include <string>
+#include <thread>
+#include <vector>
 #if !defined(_MSC_VER) && !defined(__MINGW32__)
 #include <unistd.h>
 #else
@@ -56,6 +60,11 @@ static llvm::cl::opt<bool>
 Simplified("simplified",
            llvm::cl::desc("Don't display module names or implicit self types"));
 
+static llvm::cl::opt<unsigned>
+NumThreads("num-threads",
+           llvm::cl::desc("Demangle the standard input on <n> threads"),
+           llvm::cl::value_desc("n"), llvm::cl::init(1));
+
 static llvm::cl::list<std::string>
 InputNames(llvm::cl::Positional, llvm::cl::desc("[mangled name...]"),
                llvm::cl::ZeroOrMore);
@@ -71,17 +80,21 @@ static llvm::StringRef substrAfter(llvm::StringRef whole,
 }
 
 static void demangle(llvm::raw_ostream &os, llvm::StringRef name,
+                     swift::Demangle::Context &context,
                      const swift::Demangle::DemangleOptions &options) {
   bool hadLeadingUnderscore = false;
   if (name.startswith("__")) {
     hadLeadingUnderscore = true;
     name = name.substr(1);
   }
+  // The tree is only needed while printing this name.
+  context.clear();
   swift::Demangle::NodePointer pointer =
-      swift::demangle_wrappers::demangleSymbolAsNode(name);
+      swift::demangle_wrappers::demangleSymbolAsNode(name,
+                                                     context.getFactory());
   if (ExpandMode || TreeOnly) {
-    llvm::outs() << "Demangling for " << name << '\n';
-    swift::demangle_wrappers::NodeDumper(pointer).print(llvm::outs());
+    os << "Demangling for " << name << '\n';
+    swift::demangle_wrappers::NodeDumper(pointer).print(os);
   }
   if (RemangleMode) {
     std::string remangled;
@@ -99,46 +112,99 @@ static void demangle(llvm::raw_ostream &os, llvm::StringRef name,
         exit(1);
       }
     }
-    if (hadLeadingUnderscore) llvm::outs() << '_';
-    llvm::outs() << remangled;
+    if (hadLeadingUnderscore) os << '_';
+    os << remangled;
     return;
   }
   if (!TreeOnly) {
     std::string string = swift::Demangle::nodeToString(pointer, options);
     if (!CompactMode)
-      llvm::outs() << name << " ---> ";
-    llvm::outs() << (string.empty() ? name : llvm::StringRef(string));
+      os << name << " ---> ";
+    os << (string.empty() ? name : llvm::StringRef(string));
   }
 }
 
-static int demangleSTDIN(const swift::Demangle::DemangleOptions &options) {
-  // This doesn't handle Unicode symbols, but maybe that's okay.
-  llvm::Regex maybeSymbol("(_T|" MANGLING_PREFIX_STR ")[_a-zA-Z0-9$]+");
+// This doesn't handle Unicode symbols, but maybe that's okay.
+#define MAYBE_SYMBOL_REGEX "(_T|" MANGLING_PREFIX_STR ")[_a-zA-Z0-9$]+"
+
+/// Demangles all symbols in \p line and writes the line to \p os.
+static void demangleLine(llvm::raw_ostream &os, llvm::StringRef line,
+                         llvm::Regex &maybeSymbol,
+                         swift::Demangle::Context &context,
+                         const swift::Demangle::DemangleOptions &options) {
+  llvm::SmallVector<llvm::StringRef, 1> matches;
+  while (maybeSymbol.match(line, &matches)) {
+    os << substrBefore(line, matches.front());
+    demangle(os, matches.front(), context, options);
+    line = substrAfter(line, matches.front());
+  }
+  os << line;
+}
 
+/// Demangles \p lines on NumThreads threads and writes them in order.
+///
+/// Each thread demangles a contiguous slice of the lines into its own buffer,
+/// with its own demangle context.
+static void
+demangleLinesInParallel(llvm::ArrayRef<std::string> lines,
+                        const swift::Demangle::DemangleOptions &options) {
+  unsigned numThreads = std::min<size_t>(NumThreads, lines.size());
+  std::vector<std::string> outputs(numThreads);
+  std::vector<std::thread> threads;
+  size_t sliceSize = (lines.size() + numThreads - 1) / numThreads;
+  for (unsigned i = 0; i < numThreads; ++i) {
+    threads.emplace_back([&, i] {
+      llvm::Regex maybeSymbol(MAYBE_SYMBOL_REGEX);
+      swift::Demangle::Context context;
+      llvm::raw_string_ostream os(outputs[i]);
+      size_t begin = i * sliceSize;
+      size_t end = std::min(begin + sliceSize, lines.size());
+      for (size_t l = begin; l < end; ++l)
+        demangleLine(os, lines[l], maybeSymbol, context, options);
+    });
+  }
+  for (unsigned i = 0; i < numThreads; ++i) {
+    threads[i].join();
+    llvm::outs() << outputs[i];
+  }
+}
+
+static int demangleSTDIN(const swift::Demangle::DemangleOptions &options) {
+  llvm::Regex maybeSymbol(MAYBE_SYMBOL_REGEX);
+  swift::Demangle::Context context;
+
+  // With more than one thread, lines are demangled in batches. A single
+  // thread demangles each line as soon as it is read, so that the tool can
+  // be used as a filter on a live log.
+  const size_t batchSize = 1024 * NumThreads;
+  std::vector<std::string> batch;
+
+  char *inputLine = nullptr;
+  size_t size = 0;
+  int result = EXIT_SUCCESS;
   while (true) {
-    char *inputLine = nullptr;
-    size_t size;
+    errno = 0;
     if (getline(&inputLine, &size, stdin) == -1 || size <= 0) {
-      if (errno == 0) {
-        break;
-      }
-
-      return EXIT_FAILURE;
+      if (errno != 0)
+        result = EXIT_FAILURE;
+      break;
     }
 
-    llvm::StringRef inputContents(inputLine);
-    llvm::SmallVector<llvm::StringRef, 1> matches;
-    while (maybeSymbol.match(inputContents, &matches)) {
-      llvm::outs() << substrBefore(inputContents, matches.front());
-      demangle(llvm::outs(), matches.front(), options);
-      inputContents = substrAfter(inputContents, matches.front());
+    if (NumThreads <= 1) {
+      demangleLine(llvm::outs(), inputLine, maybeSymbol, context, options);
+      continue;
+    }
+    batch.push_back(inputLine);
+    if (batch.size() == batchSize) {
+      demangleLinesInParallel(batch, options);
+      batch.clear();
     }
-
-    llvm::outs() << inputContents;
-    free(inputLine);
   }
+  if (!batch.empty())
+    demangleLinesInParallel(batch, options);
 
-  return EXIT_SUCCESS;
+  free(inputLine);
+  return result;
 }
 
 int main(int argc, char **argv) {
@@ -158,8 +224,9 @@ int main(int argc, char **argv) {
     CompactMode = true;
     return demangleSTDIN(options);
   } else {
+    swift::Demangle::Context context;
     for (llvm::StringRef name : InputNames) {
-      demangle(llvm::outs(), name, options);
+      demangle(llvm::outs(), name, context, options);
       llvm::outs() << '\n';
     }
 
@@ -236,6 +236,7 @@ int main(int argc, char **argv) {
   initializeSwiftARCContractPass(Registry);
   initializeInlineTreePrinterPass(Registry);
   initializeSwiftMergeFunctionsPass(Registry);
+  initializeSwiftProfileFirstHitPass(Registry);
 
   llvm::cl::ParseCommandLineOptions(argc, argv, "Swift LLVM optimizer\n");
 
@@ -398,13 +398,14 @@ int doDumpHeapInstance(const char *BinaryFilename) {
     default: { // Parent
       close(PipeMemoryReader_getChildReadFD(&Pipe));
       close(PipeMemoryReader_getChildWriteFD(&Pipe));
-      SwiftReflectionContextRef RC = swift_reflection_createReflectionContext(
-        (void*)&Pipe,
-        PipeMemoryReader_getPointerSize,
-        PipeMemoryReader_getSizeSize,
-        PipeMemoryReader_readBytes,
-        PipeMemoryReader_getStringLength,
-        PipeMemoryReader_getSymbolAddress);
+      SwiftReflectionContextRef RC =
+        swift_reflection_createCachingReflectionContext(
+          (void*)&Pipe,
+          PipeMemoryReader_getPointerSize,
+          PipeMemoryReader_getSizeSize,
+          PipeMemoryReader_readBytes,
+          PipeMemoryReader_getStringLength,
+          PipeMemoryReader_getSymbolAddress);
 
       uint8_t PointerSize = PipeMemoryReader_getPointerSize((void*)&Pipe);
       if (PointerSize != sizeof(uintptr_t))
@@ -414,6 +415,8 @@ int doDumpHeapInstance(const char *BinaryFilename) {
 
       while (1) {
         InstanceKind Kind = PipeMemoryReader_receiveInstanceKind(&Pipe);
+        // The child ran to get us the next instance.
+        swift_reflection_clearCaches(RC);
         switch (Kind) {
         case Object:
           printf("Reflecting an object.\n");
@@ -0,0 +1,73 @@
+//===--- DiagnosticEngineTests.cpp - Tests for DiagnosticEngine -----------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/AST/DiagnosticEngine.h"
+#include "swift/AST/DiagnosticsFrontend.h"
+#include "swift/Basic/DiagnosticConsumer.h"
+#include "swift/Basic/SourceManager.h"
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+using namespace swift;
+
+namespace {
+
+class TextRecorder : public DiagnosticConsumer {
+  bool NeedsText;
+
+public:
+  std::vector<std::string> Texts;
+
+  explicit TextRecorder(bool NeedsText) : NeedsText(NeedsText) {}
+
+  void handleDiagnostic(SourceManager &SM, SourceLoc Loc,
+                        DiagnosticKind Kind, StringRef Text,
+                        const DiagnosticInfo &Info) override {
+    Texts.push_back(Text);
+  }
+
+  bool needsDiagnosticText() const override { return NeedsText; }
+};
+
+} // end anonymous namespace
+
+TEST(DiagnosticEngine, FormatsTextOnlyWhenNeeded) {
+  SourceManager SM;
+  DiagnosticEngine Diags(SM);
+
+  TextRecorder Counter(/*NeedsText=*/false);
+  Diags.addConsumer(Counter);
+  Diags.diagnose(SourceLoc(), diag::error_no_such_file_or_directory,
+                 "a.swift");
+  ASSERT_EQ(1u, Counter.Texts.size());
+  EXPECT_EQ("", Counter.Texts[0]);
+  EXPECT_TRUE(Diags.hadAnyError());
+
+  TextRecorder Printer(/*NeedsText=*/true);
+  Diags.addConsumer(Printer);
+  Diags.diagnose(SourceLoc(), diag::error_no_such_file_or_directory,
+                 "b.swift");
+  ASSERT_EQ(1u, Printer.Texts.size());
+  EXPECT_EQ("no such file or directory: 'b.swift'", Printer.Texts[0]);
+  ASSERT_EQ(2u, Counter.Texts.size());
+  EXPECT_EQ(Printer.Texts[0], Counter.Texts[1]);
+}
+
+TEST(DiagnosticEngine, TracksErrorsWithoutConsumers) {
+  SourceManager SM;
+  DiagnosticEngine Diags(SM);
+  Diags.diagnose(SourceLoc(), diag::error_no_such_file_or_directory,
+                 "a.swift");
+  EXPECT_TRUE(Diags.hadAnyError());
+}
@@ -1,4 +1,5 @@
 #include "swift/Basic/ClusteredBitVector.h"
+#include "llvm/ADT/APInt.h"
 #include "gtest/gtest.h"
 
 using namespace swift;
@@ -208,3 +209,56 @@ TEST(ClusteredBitVector, FlipAllBig) {
   EXPECT_EQ(true, vec[7]);
   EXPECT_EQ(1u, vec.count());
 }
+
+TEST(ClusteredBitVector, FromAPInt) {
+  llvm::APInt value(150, 0);
+  value.setBit(3);
+  value.setBit(64);
+  value.setBit(149);
+  ClusteredBitVector vec = ClusteredBitVector::fromAPInt(value);
+  EXPECT_EQ(150u, vec.size());
+  EXPECT_EQ(3u, vec.count());
+  EXPECT_EQ(true, vec[3]);
+  EXPECT_EQ(true, vec[64]);
+  EXPECT_EQ(true, vec[149]);
+  EXPECT_EQ(false, vec[63]);
+  EXPECT_EQ(value, vec.asAPInt());
+
+  ClusteredBitVector zero = ClusteredBitVector::fromAPInt(llvm::APInt(150, 0));
+  EXPECT_EQ(150u, zero.size());
+  EXPECT_EQ(0u, zero.count());
+}
+
+TEST(ClusteredBitVector, Slice) {
+  ClusteredBitVector vec;
+  vec.appendClearBits(10);
+  vec.appendSetBits(100);
+  vec.appendClearBits(50);
+  vec.setBit(150);
+
+  // Slices within a chunk, across chunks and of whole chunks.
+  ClusteredBitVector slice = vec.getSlice(5, 10);
+  EXPECT_EQ(10u, slice.size());
+  EXPECT_EQ(5u, slice.count());
+  EXPECT_EQ(false, slice[4]);
+  EXPECT_EQ(true, slice[5]);
+
+  slice = vec.getSlice(60, 100);
+  EXPECT_EQ(100u, slice.size());
+  EXPECT_EQ(51u, slice.count());
+  EXPECT_EQ(true, slice[49]);
+  EXPECT_EQ(false, slice[50]);
+  EXPECT_EQ(true, slice[90]);
+
+  slice = vec.getSlice(10, 64);
+  EXPECT_EQ(ClusteredBitVector::getConstant(64, true), slice);
+
+  EXPECT_EQ(vec, vec.getSlice(0, vec.size()));
+  EXPECT_EQ(0u, vec.getSlice(111, 30).count());
+  EXPECT_EQ(0u, vec.getSlice(20, 0).size());
+
+  ClusteredBitVector clear;
+  clear.appendClearBits(200);
+  EXPECT_EQ(ClusteredBitVector::getConstant(70, false),
+            clear.getSlice(100, 70));
+}
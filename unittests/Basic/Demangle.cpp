@@ -11,3 +11,30 @@ TEST(Demangle, DemangleWrappers) {
       demangleSymbolAsString(MangledName));
 }
 
+
+TEST(Demangle, NodeFactory) {
+  using namespace swift::Demangle;
+  NodeFactory Factory;
+
+  // The text is copied into the factory.
+  std::string Text = "Swift";
+  NodePointer Module = Factory.create(Node::Kind::Module, Text);
+  Text = "Other";
+  EXPECT_EQ("Swift", Module->getText());
+
+  // Children grow past the inline storage.
+  NodePointer List = Factory.create(Node::Kind::TypeList);
+  for (unsigned i = 0; i < 100; ++i)
+    List->addChild(Factory.create(Node::Kind::Number, i));
+  ASSERT_EQ(100u, List->getNumChildren());
+  for (unsigned i = 0; i < 100; ++i)
+    EXPECT_EQ(i, List->getChild(i)->getIndex());
+}
+
+TEST(Demangle, Context) {
+  swift::Demangle::Context Ctx;
+  EXPECT_EQ("a.b", Ctx.demangleTypeAsString("V1a1b"));
+  Ctx.clear();
+  EXPECT_NE(nullptr, Ctx.demangleSymbolAsNode("_TtV1a1b"));
+  EXPECT_EQ(nullptr, Ctx.demangleSymbolAsNode("x"));
+}
@@ -85,3 +85,28 @@ TEST(SourceManager, RangeContains) {
   EXPECT_TRUE(SM.rangeContains(R_ad, R_bc));
 }
 
+
+TEST(SourceManager, LineAndColumn) {
+  SourceManager SM;
+  StringRef Source = "a\nbb\r\nccc\r dd\n\neee";
+  unsigned ID = SM.addMemBufferCopy(Source);
+  unsigned OtherID = SM.addMemBufferCopy("x\ny");
+  SourceLoc Start = SM.getLocForBufferStart(ID);
+
+  // Every offset, including the one just past the end, must agree with
+  // llvm::SourceMgr, in an order unlike a front-to-back scan.
+  for (unsigned i = Source.size() + 1; i != 0; --i) {
+    SourceLoc Loc = Start.getAdvancedLoc(i - 1);
+    auto Expected = SM.getLLVMSourceMgr().getLineAndColumn(Loc.Value, ID);
+    auto Actual = SM.getLineAndColumn(Loc);
+    EXPECT_EQ(Expected.first, Actual.first);
+    EXPECT_EQ(Expected.second, Actual.second);
+    EXPECT_EQ(Actual.first, SM.getLineNumber(Loc, ID));
+  }
+
+  SourceLoc OtherLoc = SM.getLocForOffset(OtherID, 2);
+  EXPECT_EQ(OtherID, SM.findBufferContainingLoc(OtherLoc));
+  EXPECT_EQ(2U, SM.getLineAndColumn(OtherLoc).first);
+  EXPECT_EQ(ID, SM.findBufferContainingLoc(Start));
+  EXPECT_EQ(1U, SM.getLineAndColumn(Start).second);
+}
@@ -0,0 +1,214 @@
+//===--- SpawnServerTest.cpp - for swift/Basic/SpawnServer.h --------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/Basic/SpawnServer.h"
+#include "swift/Basic/LLVM.h"
+#include "swift/Basic/TaskQueue.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+
+#if LLVM_ON_UNIX && !defined(__CYGWIN__)
+
+#include <map>
+#include <string>
+
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace llvm::sys;
+using namespace swift;
+using namespace swift::sys;
+
+namespace {
+
+/// Runs a spawn server in a child process for the duration of a test.
+class SpawnServerTest : public ::testing::Test {
+protected:
+  SmallString<128> Dir;
+  SmallString<128> SocketPath;
+  SmallString<128> ExecutablePath;
+  pid_t ServerPid = -1;
+
+  void SetUp() override {
+    ASSERT_FALSE(fs::createUniqueDirectory("SpawnServer-test", Dir));
+    SocketPath = Dir;
+    path::append(SocketPath, "server.sock");
+    // The server only runs its own executable, which stands in for a shell.
+    ExecutablePath = Dir;
+    path::append(ExecutablePath, "compiler");
+    {
+      std::error_code EC;
+      llvm::raw_fd_ostream OS(ExecutablePath, EC, fs::F_None);
+      ASSERT_FALSE(EC);
+      OS << "#!/bin/sh\n# version 1\nexec /bin/sh \"$@\"\n";
+    }
+    ASSERT_EQ(0, chmod(ExecutablePath.c_str(), S_IRWXU));
+
+    ServerPid = fork();
+    ASSERT_GE(ServerPid, 0);
+    if (ServerPid == 0) {
+      _exit(runSpawnServer(SocketPath, ExecutablePath,
+                           [](StringRef ExecPath, ArrayRef<const char *> Args)
+                               -> Optional<int> {
+        if (Args.empty() || StringRef(Args.front()) != "-in-process")
+          return None;
+        llvm::outs() << "in process:";
+        for (const char *Arg : Args)
+          llvm::outs() << " " << Arg;
+        llvm::outs() << "\n";
+        return 42;
+      }));
+    }
+
+    // Wait for the server to listen.
+    for (unsigned i = 0; i < 500 && !fs::exists(SocketPath); ++i)
+      usleep(10000);
+    ASSERT_TRUE(fs::exists(SocketPath));
+  }
+
+  void TearDown() override {
+    if (ServerPid > 0) {
+      kill(ServerPid, SIGTERM);
+      waitpid(ServerPid, nullptr, 0);
+    }
+    fs::remove(SocketPath);
+    fs::remove(ExecutablePath);
+    fs::remove(Dir);
+  }
+
+  struct Result {
+    ProcessId Pid = 0;
+    int ReturnCode = -1;
+    std::string Output;
+    Optional<TaskResourceUsage> Usage;
+  };
+
+  /// Runs the given tasks through a TaskQueue using the server, and returns
+  /// their results in order.
+  std::vector<Result>
+  runTasks(ArrayRef<std::pair<const char *, std::vector<const char *>>> Tasks,
+           bool &Failed) {
+    std::vector<Result> Results(Tasks.size());
+    TaskQueue TQ(2, SocketPath);
+    for (unsigned i = 0; i < Tasks.size(); ++i)
+      TQ.addTask(Tasks[i].first, Tasks[i].second, llvm::None,
+                 reinterpret_cast<void *>(uintptr_t(i)));
+    Failed = TQ.execute(
+        nullptr,
+        [&](ProcessId Pid, int ReturnCode, StringRef Output,
+            Optional<TaskResourceUsage> Usage, void *Context) {
+          auto &R = Results[reinterpret_cast<uintptr_t>(Context)];
+          R.Pid = Pid;
+          R.ReturnCode = ReturnCode;
+          R.Output = Output;
+          R.Usage = Usage;
+          return TaskFinishedResponse::ContinueExecution;
+        });
+    return Results;
+  }
+};
+
+TEST_F(SpawnServerTest, RunsTasks) {
+  ASSERT_TRUE(supportsSpawnServer());
+
+  bool Failed;
+  auto Results = runTasks({
+    {ExecutablePath.c_str(),
+     {"-c", "echo $SWIFT_TASK_QUEUE_IDLE_SLOTS; exit 3"}},
+    {ExecutablePath.c_str(), {"-in-process", "-c", "a.swift"}},
+  }, Failed);
+  EXPECT_FALSE(Failed);
+
+  EXPECT_NE(0, Results[0].Pid);
+  EXPECT_EQ(3, Results[0].ReturnCode);
+  EXPECT_EQ("0\n", Results[0].Output);
+
+  // Without the server, the shell would reject the option.
+  EXPECT_EQ(42, Results[1].ReturnCode);
+  EXPECT_EQ("in process: -in-process -c a.swift\n", Results[1].Output);
+
+  // The server reaps its tasks, so their resource usage isn't known.
+  EXPECT_FALSE(Results[0].Usage.hasValue());
+  EXPECT_FALSE(Results[1].Usage.hasValue());
+}
+
+TEST_F(SpawnServerTest, UsesWorkingDirectory) {
+  SmallString<128> OldDirectory;
+  ASSERT_FALSE(fs::current_path(OldDirectory));
+  ASSERT_EQ(0, chdir(Dir.c_str()));
+
+  bool Failed;
+  auto Results = runTasks(
+      {{ExecutablePath.c_str(), {"-c", "ls; echo error >&2"}}}, Failed);
+  ASSERT_EQ(0, chdir(OldDirectory.c_str()));
+
+  EXPECT_FALSE(Failed);
+  EXPECT_EQ(0, Results[0].ReturnCode);
+  EXPECT_EQ("compiler\nserver.sock\nerror\n", Results[0].Output);
+}
+
+TEST_F(SpawnServerTest, IsOnlyAccessibleToOwner) {
+  fs::file_status Status;
+  ASSERT_FALSE(fs::status(SocketPath, Status));
+  EXPECT_EQ(fs::owner_read | fs::owner_write, Status.permissions());
+}
+
+TEST_F(SpawnServerTest, DeclinesOtherExecutables) {
+  // The server declines, so the TaskQueue starts the task itself.
+  bool Failed;
+  auto Results = runTasks({{"/bin/sh", {"-c", "echo fallback"}}}, Failed);
+  EXPECT_FALSE(Failed);
+  EXPECT_EQ(0, Results[0].ReturnCode);
+  EXPECT_EQ("fallback\n", Results[0].Output);
+  EXPECT_TRUE(Results[0].Usage.hasValue());
+
+  // The server keeps running.
+  EXPECT_EQ(0, waitpid(ServerPid, nullptr, WNOHANG));
+}
+
+TEST_F(SpawnServerTest, StopsWhenExecutableChanges) {
+  {
+    std::error_code EC;
+    llvm::raw_fd_ostream OS(ExecutablePath, EC, fs::F_Append);
+    ASSERT_FALSE(EC);
+    OS << "# version 2\n";
+  }
+
+  // The server declines, so the TaskQueue starts the task itself.
+  bool Failed;
+  auto Results = runTasks(
+      {{ExecutablePath.c_str(), {"-c", "echo fallback"}}}, Failed);
+  EXPECT_FALSE(Failed);
+  EXPECT_EQ(0, Results[0].ReturnCode);
+  EXPECT_EQ("fallback\n", Results[0].Output);
+  ASSERT_TRUE(Results[0].Usage.hasValue());
+  EXPECT_NE(0u, Results[0].Usage->MaxResidentSetSizeBytes);
+
+  int Status;
+  ASSERT_EQ(ServerPid, waitpid(ServerPid, &Status, 0));
+  ServerPid = -1;
+  EXPECT_TRUE(WIFEXITED(Status));
+  EXPECT_EQ(0, WEXITSTATUS(Status));
+  EXPECT_FALSE(fs::exists(SocketPath));
+
+  // With the server gone, tasks still run.
+  Results = runTasks({{"/bin/sh", {"-c", "echo again"}}}, Failed);
+  EXPECT_FALSE(Failed);
+  EXPECT_EQ("again\n", Results[0].Output);
+}
+
+} // end anonymous namespace
+
+#endif
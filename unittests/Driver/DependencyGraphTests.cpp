@@ -790,3 +790,156 @@ TEST(DependencyGraph, ChainedExternalPreMarked) {
   EXPECT_TRUE(graph.isMarked(0));
   EXPECT_FALSE(graph.isMarked(1));
 }
+
+TEST(DependencyGraph, MalformedFingerprints) {
+  DependencyGraph<uintptr_t> graph;
+  uintptr_t i = 0;
+
+  EXPECT_EQ(graph.loadFromString(i++, "fingerprints-top-level: [[a, x]]"),
+            LoadResult::UpToDate);
+  EXPECT_EQ(graph.loadFromString(i++, "fingerprints-member: [[a, b, x]]"),
+            LoadResult::UpToDate);
+  EXPECT_EQ(graph.loadFromString(i++, "fingerprints-top-level: [a]"),
+            LoadResult::HadError);
+  EXPECT_EQ(graph.loadFromString(i++, "fingerprints-nominal: [[a]]"),
+            LoadResult::HadError);
+  EXPECT_EQ(graph.loadFromString(i++, "fingerprints-member: [[a, x]]"),
+            LoadResult::HadError);
+  EXPECT_EQ(graph.loadFromString(i++, "fingerprints-dynamic-lookup: [[a, x]]"),
+            LoadResult::HadError);
+}
+
+TEST(DependencyGraph, FingerprintedMembers) {
+  DependencyGraph<uintptr_t> graph;
+
+  EXPECT_EQ(graph.loadFromString(0,
+                                 "provides-top-level: [a]\n"
+                                 "provides-member: [[a, aa], [a, bb]]\n"
+                                 "fingerprints-top-level: [[a, '1']]\n"
+                                 "fingerprints-member: [[a, aa, '2'], "
+                                                       "[a, bb, '3']]"),
+            LoadResult::UpToDate);
+  EXPECT_EQ(graph.loadFromString(1,
+                                 "depends-top-level: [a]\n"
+                                 "depends-member: [[a, aa]]"),
+            LoadResult::UpToDate);
+  EXPECT_EQ(graph.loadFromString(2,
+                                 "depends-top-level: [a]\n"
+                                 "depends-member: [[a, bb]]"),
+            LoadResult::UpToDate);
+
+  // Only "bb" changed.
+  EXPECT_EQ(graph.loadFromString(0,
+                                 "provides-top-level: [a]\n"
+                                 "provides-member: [[a, aa], [a, bb]]\n"
+                                 "fingerprints-top-level: [[a, '1']]\n"
+                                 "fingerprints-member: [[a, aa, '2'], "
+                                                       "[a, bb, '4']]"),
+            LoadResult::UpToDate);
+
+  SmallVector<uintptr_t, 4> marked;
+
+  graph.markTransitive(marked, 0);
+  EXPECT_EQ(1u, marked.size());
+  EXPECT_EQ(2u, marked.front());
+  EXPECT_TRUE(graph.isMarked(0));
+  EXPECT_FALSE(graph.isMarked(1));
+  EXPECT_TRUE(graph.isMarked(2));
+}
+
+TEST(DependencyGraph, FingerprintedMembersAddedAndRemoved) {
+  DependencyGraph<uintptr_t> graph;
+
+  EXPECT_EQ(graph.loadFromString(0,
+                                 "provides-member: [[a, aa], [a, bb]]\n"
+                                 "fingerprints-member: [[a, aa, '1'], "
+                                                       "[a, bb, '2']]"),
+            LoadResult::UpToDate);
+  EXPECT_EQ(graph.loadFromString(1, "depends-member: [[a, aa]]"),
+            LoadResult::UpToDate);
+  EXPECT_EQ(graph.loadFromString(2, "depends-member: [[a, bb]]"),
+            LoadResult::UpToDate);
+  EXPECT_EQ(graph.loadFromString(3, "depends-member: [[a, cc]]"),
+            LoadResult::UpToDate);
+
+  // "bb" went away and "cc" was added.
+  EXPECT_EQ(graph.loadFromString(0,
+                                 "provides-member: [[a, aa], [a, cc]]\n"
+                                 "fingerprints-member: [[a, aa, '1'], "
+                                                       "[a, cc, '3']]"),
+            LoadResult::UpToDate);
+
+  SmallVector<uintptr_t, 4> marked;
+
+  graph.markTransitive(marked, 0);
+  EXPECT_EQ(2u, marked.size());
+  EXPECT_TRUE(graph.isMarked(0));
+  EXPECT_FALSE(graph.isMarked(1));
+  EXPECT_TRUE(graph.isMarked(2));
+  EXPECT_TRUE(graph.isMarked(3));
+}
+
+TEST(DependencyGraph, FingerprintsOnlyFollowedFromStartingNode) {
+  DependencyGraph<uintptr_t> graph;
+
+  EXPECT_EQ(graph.loadFromString(0,
+                                 "provides-member: [[a, aa]]\n"
+                                 "fingerprints-member: [[a, aa, '1']]"),
+            LoadResult::UpToDate);
+  EXPECT_EQ(graph.loadFromString(1,
+                                 "depends-member: [[a, aa]]\n"
+                                 "provides-member: [[b, bb]]\n"
+                                 "fingerprints-member: [[b, bb, '2']]"),
+            LoadResult::UpToDate);
+  EXPECT_EQ(graph.loadFromString(2, "depends-member: [[b, bb]]"),
+            LoadResult::UpToDate);
+
+  EXPECT_EQ(graph.loadFromString(0,
+                                 "provides-member: [[a, aa]]\n"
+                                 "fingerprints-member: [[a, aa, '3']]"),
+            LoadResult::UpToDate);
+  EXPECT_EQ(graph.loadFromString(1,
+                                 "depends-member: [[a, aa]]\n"
+                                 "provides-member: [[b, bb]]\n"
+                                 "fingerprints-member: [[b, bb, '2']]"),
+            LoadResult::UpToDate);
+
+  // Node 1 is rebuilt because of node 0, so everything it provides is
+  // suspect even though its own fingerprints didn't change.
+  SmallVector<uintptr_t, 4> marked;
+
+  graph.markTransitive(marked, 0);
+  EXPECT_EQ(2u, marked.size());
+  EXPECT_TRUE(graph.isMarked(0));
+  EXPECT_TRUE(graph.isMarked(1));
+  EXPECT_TRUE(graph.isMarked(2));
+}
+
+TEST(DependencyGraph, UnfingerprintedEntriesAlwaysFollowed) {
+  DependencyGraph<uintptr_t> graph;
+
+  EXPECT_EQ(graph.loadFromString(0,
+                                 "provides-top-level: [a]\n"
+                                 "provides-member: [[a, aa]]\n"
+                                 "fingerprints-member: [[a, aa, '1']]"),
+            LoadResult::UpToDate);
+  EXPECT_EQ(graph.loadFromString(1, "depends-top-level: [a]"),
+            LoadResult::UpToDate);
+  EXPECT_EQ(graph.loadFromString(2, "depends-member: [[a, aa]]"),
+            LoadResult::UpToDate);
+
+  EXPECT_EQ(graph.loadFromString(0,
+                                 "provides-top-level: [a]\n"
+                                 "provides-member: [[a, aa]]\n"
+                                 "fingerprints-member: [[a, aa, '1']]"),
+            LoadResult::UpToDate);
+
+  SmallVector<uintptr_t, 4> marked;
+
+  graph.markTransitive(marked, 0);
+  EXPECT_EQ(1u, marked.size());
+  EXPECT_EQ(1u, marked.front());
+  EXPECT_TRUE(graph.isMarked(0));
+  EXPECT_TRUE(graph.isMarked(1));
+  EXPECT_FALSE(graph.isMarked(2));
+}
@@ -0,0 +1,164 @@
+//===--- CachingMemoryReader.cpp - CachingMemoryReader tests --------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/Remote/CachingMemoryReader.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+using namespace swift;
+using namespace remote;
+
+namespace {
+
+/// Presents a buffer as the memory from address Base onwards, and counts
+/// the reads.
+class BufferMemoryReader final : public MemoryReader {
+public:
+  static const uint64_t Base = 0x10000;
+
+  std::vector<uint8_t> Memory;
+  unsigned NumReads = 0;
+  unsigned NumInvalidations = 0;
+
+  explicit BufferMemoryReader(size_t size) : Memory(size) {
+    for (size_t i = 0; i < size; ++i)
+      Memory[i] = uint8_t(i * 7 + 1);
+  }
+
+  uint8_t getPointerSize() override { return sizeof(void *); }
+  uint8_t getSizeSize() override { return sizeof(size_t); }
+
+  RemoteAddress getSymbolAddress(const std::string &name) override {
+    return RemoteAddress((uint64_t)0);
+  }
+
+  bool readBytes(RemoteAddress address, uint8_t *dest,
+                 uint64_t size) override {
+    ++NumReads;
+    uint64_t start = address.getAddressData();
+    if (start < Base || start - Base + size > Memory.size())
+      return false;
+    memcpy(dest, Memory.data() + (start - Base), size);
+    return true;
+  }
+
+  bool readString(RemoteAddress address, std::string &dest) override {
+    ++NumReads;
+    uint64_t start = address.getAddressData();
+    if (start < Base || start - Base >= Memory.size())
+      return false;
+    auto *begin = reinterpret_cast<const char *>(Memory.data());
+    auto *end = begin + Memory.size();
+    auto *str = begin + (start - Base);
+    auto *nul = std::find(str, end, '\0');
+    if (nul == end)
+      return false;
+    dest.assign(str, nul);
+    return true;
+  }
+
+  void invalidateCache() override { ++NumInvalidations; }
+};
+
+static const uint64_t PageSize = 256;
+
+} // end anonymous namespace
+
+TEST(CachingMemoryReaderTest, ReadsWithinAPageAreCached) {
+  auto Underlying = std::make_shared<BufferMemoryReader>(4 * PageSize);
+  CachingMemoryReader Reader(Underlying, PageSize, 64);
+
+  uint32_t A, B;
+  EXPECT_TRUE(Reader.readInteger(RemoteAddress(BufferMemoryReader::Base + 8),
+                                 &A));
+  EXPECT_TRUE(Reader.readInteger(RemoteAddress(BufferMemoryReader::Base + 40),
+                                 &B));
+  EXPECT_EQ(1u, Underlying->NumReads);
+  EXPECT_EQ(0, memcmp(&A, Underlying->Memory.data() + 8, sizeof(A)));
+  EXPECT_EQ(0, memcmp(&B, Underlying->Memory.data() + 40, sizeof(B)));
+}
+
+TEST(CachingMemoryReaderTest, ReadsAcrossPages) {
+  auto Underlying = std::make_shared<BufferMemoryReader>(4 * PageSize);
+  CachingMemoryReader Reader(Underlying, PageSize, 64);
+
+  // The missing pages are fetched with a single read.
+  uint8_t Buffer[2 * PageSize];
+  uint64_t Offset = PageSize / 2;
+  EXPECT_TRUE(Reader.readBytes(RemoteAddress(BufferMemoryReader::Base + Offset),
+                               Buffer, sizeof(Buffer)));
+  EXPECT_EQ(1u, Underlying->NumReads);
+  EXPECT_EQ(0, memcmp(Buffer, Underlying->Memory.data() + Offset,
+                      sizeof(Buffer)));
+
+  // Only the last page is new.
+  EXPECT_TRUE(Reader.readBytes(
+      RemoteAddress(BufferMemoryReader::Base + Offset + PageSize),
+      Buffer, sizeof(Buffer)));
+  EXPECT_EQ(2u, Underlying->NumReads);
+  EXPECT_EQ(0, memcmp(Buffer, Underlying->Memory.data() + Offset + PageSize,
+                      sizeof(Buffer)));
+}
+
+TEST(CachingMemoryReaderTest, FallsBackAtTheEndOfReadableMemory) {
+  // The last page is only partly readable.
+  auto Underlying = std::make_shared<BufferMemoryReader>(PageSize + 16);
+  CachingMemoryReader Reader(Underlying, PageSize, 64);
+
+  uint64_t Value;
+  EXPECT_TRUE(Reader.readInteger(
+      RemoteAddress(BufferMemoryReader::Base + PageSize + 8), &Value));
+  EXPECT_EQ(0, memcmp(&Value, Underlying->Memory.data() + PageSize + 8,
+                      sizeof(Value)));
+  EXPECT_FALSE(Reader.readInteger(
+      RemoteAddress(BufferMemoryReader::Base + PageSize + 12), &Value));
+}
+
+TEST(CachingMemoryReaderTest, ReadsStrings) {
+  auto Underlying = std::make_shared<BufferMemoryReader>(4 * PageSize);
+  std::string Long(PageSize + 10, 'x');
+  memcpy(Underlying->Memory.data() + PageSize - 5, Long.c_str(),
+         Long.size() + 1);
+  memcpy(Underlying->Memory.data() + 3 * PageSize - 4, "abc", 4);
+  CachingMemoryReader Reader(Underlying, PageSize, 64);
+
+  std::string Str;
+  EXPECT_TRUE(Reader.readString(
+      RemoteAddress(BufferMemoryReader::Base + PageSize - 5), Str));
+  EXPECT_EQ(Long, Str);
+  EXPECT_TRUE(Reader.readString(
+      RemoteAddress(BufferMemoryReader::Base + 3 * PageSize - 4), Str));
+  EXPECT_EQ("abc", Str);
+
+  // A string running into unreadable memory.
+  Underlying->Memory.back() = 'y';
+  EXPECT_FALSE(Reader.readString(
+      RemoteAddress(BufferMemoryReader::Base + 4 * PageSize - 1), Str));
+  EXPECT_EQ("abc", Str);
+}
+
+TEST(CachingMemoryReaderTest, Invalidation) {
+  auto Underlying = std::make_shared<BufferMemoryReader>(4 * PageSize);
+  CachingMemoryReader Reader(Underlying, PageSize, 64);
+  RemoteAddress Address(BufferMemoryReader::Base + 8);
+
+  uint8_t Value;
+  EXPECT_TRUE(Reader.readInteger(Address, &Value));
+  Underlying->Memory[8] = Value + 1;
+  EXPECT_TRUE(Reader.readInteger(Address, &Value));
+  EXPECT_NE(Underlying->Memory[8], Value);
+
+  Reader.invalidateCache();
+  EXPECT_EQ(1u, Underlying->NumInvalidations);
+  EXPECT_TRUE(Reader.readInteger(Address, &Value));
+  EXPECT_EQ(Underlying->Memory[8], Value);
+}
@@ -0,0 +1,138 @@
+//===--- HeapGraph.cpp - HeapGraph tests ----------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/Reflection/HeapGraph.h"
+#include "gtest/gtest.h"
+#include <sstream>
+
+using namespace swift;
+using namespace reflection;
+
+TEST(HeapGraphTest, Types) {
+  HeapGraph Graph;
+  auto A = Graph.getType("A");
+  auto B = Graph.getType("B");
+  EXPECT_NE(A, B);
+  EXPECT_EQ(A, Graph.getType("A"));
+
+  Graph.addNode(0x1000, A, 16);
+  Graph.addNode(0x2000, A, 32);
+  Graph.addNode(0x3000, B, 48);
+  EXPECT_EQ(2u, Graph.getTypes()[A].InstanceCount);
+  EXPECT_EQ(48u, Graph.getTypes()[A].ShallowSize);
+  EXPECT_EQ(1u, Graph.getTypes()[B].InstanceCount);
+  EXPECT_EQ(48u, Graph.getTypes()[B].ShallowSize);
+}
+
+TEST(HeapGraphTest, RetainedSizes) {
+  // Root -> N1 -> N2 -> N4
+  //           \-> N3 -/
+  // N3 -> N5
+  HeapGraph Graph;
+  auto T = Graph.getType("T");
+  auto N0 = Graph.addNode(0x1000, T, 1);
+  auto N1 = Graph.addNode(0x2000, T, 2);
+  auto N2 = Graph.addNode(0x3000, T, 4);
+  auto N3 = Graph.addNode(0x4000, T, 8);
+  auto N4 = Graph.addNode(0x5000, T, 16);
+  auto N5 = Graph.addNode(0x6000, T, 32);
+  Graph.addRoot(N0);
+  Graph.addEdge(N0, N1);
+  Graph.addEdge(N1, N2);
+  Graph.addEdge(N1, N3);
+  Graph.addEdge(N2, N4);
+  Graph.addEdge(N3, N4);
+  Graph.addEdge(N3, N5);
+  Graph.computeRetainedSizes();
+
+  auto &Nodes = Graph.getNodes();
+  EXPECT_EQ(63u, Nodes[N0].RetainedSize);
+  EXPECT_EQ(62u, Nodes[N1].RetainedSize);
+  EXPECT_EQ(4u, Nodes[N2].RetainedSize);
+  EXPECT_EQ(40u, Nodes[N3].RetainedSize);
+  EXPECT_EQ(16u, Nodes[N4].RetainedSize);
+  EXPECT_EQ(32u, Nodes[N5].RetainedSize);
+
+  EXPECT_EQ(N0, Graph.getDominator(N0));
+  EXPECT_EQ(N1, Graph.getDominator(N4));
+  EXPECT_EQ(N3, Graph.getDominator(N5));
+
+  // Nested instances of one type are only counted once.
+  EXPECT_EQ(63u, Graph.getTypes()[T].RetainedSize);
+}
+
+TEST(HeapGraphTest, SharedObjectsAreNotRetainedByEither) {
+  HeapGraph Graph;
+  auto Owner = Graph.getType("Owner");
+  auto Shared = Graph.getType("Shared");
+  auto A = Graph.addNode(0x1000, Owner, 16);
+  auto B = Graph.addNode(0x2000, Owner, 16);
+  auto S = Graph.addNode(0x3000, Shared, 100);
+  Graph.addRoot(A);
+  Graph.addRoot(B);
+  Graph.addEdge(A, S);
+  Graph.addEdge(B, S);
+  Graph.computeRetainedSizes();
+
+  EXPECT_EQ(16u, Graph.getNodes()[A].RetainedSize);
+  EXPECT_EQ(16u, Graph.getNodes()[B].RetainedSize);
+  EXPECT_EQ(S, Graph.getDominator(S));
+  EXPECT_EQ(32u, Graph.getTypes()[Owner].RetainedSize);
+  EXPECT_EQ(100u, Graph.getTypes()[Shared].RetainedSize);
+
+  auto Order = Graph.getTypesByRetainedSize();
+  ASSERT_EQ(2u, Order.size());
+  EXPECT_EQ(Shared, Order[0]);
+  EXPECT_EQ(Owner, Order[1]);
+}
+
+TEST(HeapGraphTest, UnreachableObjects) {
+  // An unreferenced object and a cycle nothing else references.
+  HeapGraph Graph;
+  auto T = Graph.getType("T");
+  auto Leaf = Graph.addNode(0x1000, T, 1);
+  auto Unreferenced = Graph.addNode(0x2000, T, 2);
+  auto C1 = Graph.addNode(0x3000, T, 4);
+  auto C2 = Graph.addNode(0x4000, T, 8);
+  Graph.addEdge(Unreferenced, Leaf);
+  Graph.addEdge(C1, C2);
+  Graph.addEdge(C2, C1);
+  Graph.computeRetainedSizes();
+
+  auto &Nodes = Graph.getNodes();
+  EXPECT_EQ(3u, Nodes[Unreferenced].RetainedSize);
+  EXPECT_EQ(Unreferenced, Graph.getDominator(Leaf));
+  // Whichever node of the cycle was picked as its root retains the other.
+  EXPECT_EQ(12u, std::max(Nodes[C1].RetainedSize, Nodes[C2].RetainedSize));
+  EXPECT_EQ(15u, Graph.getTypes()[T].RetainedSize);
+}
+
+TEST(HeapGraphTest, WriteGraph) {
+  HeapGraph Graph;
+  auto T = Graph.getType("Module.T");
+  auto A = Graph.addNode(0x10, T, 16);
+  auto B = Graph.addNode(0x20, T, 32);
+  Graph.addRoot(A);
+  Graph.addEdge(A, B);
+  Graph.computeRetainedSizes();
+
+  std::ostringstream OS;
+  Graph.writeGraph(OS);
+  EXPECT_EQ("types 1\n"
+            "0 2 48 48 Module.T\n"
+            "nodes 2\n"
+            "0 0x10 0 16 48 0\n"
+            "1 0x20 0 32 32 0\n"
+            "edges 1\n"
+            "0 1\n",
+            OS.str());
+}
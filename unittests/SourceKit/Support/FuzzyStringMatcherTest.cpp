@@ -316,3 +316,30 @@ TEST(FuzzyStringMatcher, ShortUnconnectedMatches) {
   EXPECT_GT(m.scoreCandidate("xaxbxcdxxxxxx"), m.scoreCandidate("xaxbxcxd"));
   EXPECT_GT(m.scoreCandidate("xaxbxc_d"), m.scoreCandidate("xaxbxcxd"));
 }
+
+TEST(FuzzyStringMatcher, CharacterMask) {
+  using CharacterMask = FuzzyStringMatcher::CharacterMask;
+  EXPECT_EQ(CharacterMask(0), FuzzyStringMatcher::getCharacterMask(""));
+  EXPECT_EQ(FuzzyStringMatcher::getCharacterMask("abc"),
+            FuzzyStringMatcher::getCharacterMask("CBA"));
+  EXPECT_EQ(FuzzyStringMatcher::getCharacterMask("aab"),
+            FuzzyStringMatcher::getCharacterMask("ab"));
+  EXPECT_NE(FuzzyStringMatcher::getCharacterMask("a"),
+            FuzzyStringMatcher::getCharacterMask("b"));
+  EXPECT_NE(FuzzyStringMatcher::getCharacterMask("1"),
+            FuzzyStringMatcher::getCharacterMask("a"));
+
+  // Matching with a mask gives the same answer as matching without one.
+  const char *patterns[] = {"a", "Ab", "abc", "a_b", "a1", u8"☂", "xyz"};
+  const char *candidates[] = {"",     "a",     "ab",       "ABC",
+                              "a_b",  "a1b",   "xaxbxc",   "zyx",
+                              "x.yz", "hello", u8"☂a"};
+  for (const char *p : patterns) {
+    FuzzyStringMatcher m(p);
+    for (const char *c : candidates) {
+      EXPECT_EQ(m.matchesCandidate(c),
+                m.matchesCandidate(c, FuzzyStringMatcher::getCharacterMask(c)))
+          << "pattern '" << p << "', candidate '" << c << "'";
+    }
+  }
+}
@@ -43,3 +43,21 @@ TEST(EditableTextBuffer, Updates) {
 
   EXPECT_EQ(Buf->getFilename(), "/a/test");
 }
+
+TEST(EditableTextBuffer, OlderSnapshots) {
+  EditableTextBufferManager BufMgr;
+  EditableTextBufferRef EdBuf = BufMgr.getOrCreateBuffer("/a/test", "abc");
+
+  ImmutableTextSnapshotRef Snap1 = EdBuf->insert(3, "def");
+  ImmutableTextSnapshotRef Snap2 = EdBuf->erase(0, 1);
+  EXPECT_EQ(EdBuf->getBuffer()->getText(), "bcdef");
+
+  ImmutableTextSnapshotRef Snap3 = EdBuf->replace(1, 2, "XY");
+  EXPECT_EQ(Snap1->getBuffer()->getText(), "abcdef");
+  EXPECT_EQ(Snap3->getBuffer()->getText(), "bXYef");
+  EXPECT_EQ(Snap2->getBuffer()->getText(), "bcdef");
+
+  // Edits after materializing an older snapshot apply to the latest text.
+  EdBuf->insert(5, "!");
+  EXPECT_EQ(EdBuf->getBuffer()->getText(), "bXYef!");
+}
@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "SourceKit/Support/UIdent.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+#include <thread>
+#include <vector>
+
+using namespace SourceKit;
+
+static std::string getTestName(unsigned I) {
+  llvm::SmallString<32> Name;
+  llvm::raw_svector_ostream(Name) << "key.uident_test." << I;
+  return Name.str();
+}
+
+TEST(UIdent, Identity) {
+  UIdent A("key.uident_test.identity");
+  UIdent B("key.uident_test.identity");
+  UIdent C("key.uident_test.other");
+  EXPECT_EQ(A, B);
+  EXPECT_NE(A, C);
+  EXPECT_EQ("key.uident_test.identity", A.getName());
+  EXPECT_EQ("key.uident_test.other", C.getName());
+}
+
+TEST(UIdent, ConcurrentCreation) {
+  const unsigned NumThreads = 8;
+  const unsigned NumNames = 500;
+
+  // Every thread creates the same UIDs, in a different order.
+  std::vector<std::vector<UIdent>> Results(NumThreads);
+  std::vector<std::thread> Threads;
+  for (unsigned T = 0; T != NumThreads; ++T) {
+    Threads.emplace_back([&Results, T] {
+      Results[T].resize(NumNames);
+      for (unsigned I = 0; I != NumNames; ++I) {
+        unsigned Index = (I + T * 61) % NumNames;
+        Results[T][Index] = UIdent(getTestName(Index));
+      }
+    });
+  }
+  for (auto &Thread : Threads)
+    Thread.join();
+
+  for (unsigned I = 0; I != NumNames; ++I) {
+    EXPECT_EQ(getTestName(I), Results[0][I].getName());
+    for (unsigned T = 1; T != NumThreads; ++T)
+      EXPECT_EQ(Results[0][I], Results[T][I]);
+  }
+}
@@ -60,3 +60,31 @@ TEST(FunctionNameDemangleTests, IgnoresNonMangledInputs) {
   EXPECT_STREQ("0123456789abcdef", OutputBuffer);
 }
 
+
+TEST(FunctionNameDemangleTests, DemanglesInContext) {
+  swift_demangle_context_t Context = swift_demangle_createContext();
+  char OutputBuffer[128];
+
+  const char *FunctionName = "_TFC3foo3bar3basfT3zimCS_3zim_T_";
+  const char *DemangledName = "foo.bar.bas (zim : foo.zim) -> ()";
+  const char *SimplifiedName = "bar.bas(zim : zim) -> ()";
+
+  // The context can be reused for any number of names.
+  for (unsigned i = 0; i < 3; ++i) {
+    size_t Result = swift_demangle_getDemangledNameInContext(
+        Context, FunctionName, OutputBuffer, sizeof(OutputBuffer));
+    EXPECT_STREQ(DemangledName, OutputBuffer);
+    EXPECT_EQ(Result, strlen(DemangledName));
+
+    Result = swift_demangle_getSimplifiedDemangledNameInContext(
+        Context, FunctionName, OutputBuffer, sizeof(OutputBuffer));
+    EXPECT_STREQ(SimplifiedName, OutputBuffer);
+    EXPECT_EQ(Result, strlen(SimplifiedName));
+
+    Result = swift_demangle_getDemangledNameInContext(
+        Context, "printf", OutputBuffer, sizeof(OutputBuffer));
+    EXPECT_EQ(0U, Result);
+  }
+
+  swift_demangle_disposeContext(Context);
+}
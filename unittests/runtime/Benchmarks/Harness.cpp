@@ -0,0 +1,253 @@
+//===--- Harness.cpp - Runtime microbenchmark harness ---------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// Usage: SwiftRuntimeBenchmarks [--filter=<substring>] [--min-time=<seconds>]
+//                               [--repetitions=<n>] [--format=csv|json]
+//                               [--list]
+//
+// Each benchmark first runs with a growing number of iterations until one run
+// takes at least --min-time (default 0.2s), then that number of iterations is
+// measured --repetitions times (default 5). The reported times are the wall
+// clock nanoseconds per iteration; for multi-threaded benchmarks every
+// thread runs all of the iterations.
+//
+//===----------------------------------------------------------------------===//
+
+#include "Harness.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace swift;
+using namespace swift::runtime_benchmarks;
+
+namespace {
+
+struct Benchmark {
+  std::string Name;
+  BenchmarkFunction Function;
+  unsigned Threads;
+};
+
+struct Options {
+  const char *Filter = nullptr;
+  double MinTime = 0.2;
+  unsigned Repetitions = 5;
+  bool JSON = false;
+  bool List = false;
+};
+
+struct Result {
+  const Benchmark *Bench;
+  uint64_t Iterations;
+  std::vector<double> Samples;
+};
+
+} // end anonymous namespace
+
+static std::vector<Benchmark> &getBenchmarks() {
+  static std::vector<Benchmark> Benchmarks;
+  return Benchmarks;
+}
+
+RegisterBenchmark::RegisterBenchmark(const char *name,
+                                     BenchmarkFunction function,
+                                     unsigned threads) {
+  std::string fullName = name;
+  if (threads > 1)
+    fullName += "/threads:" + std::to_string(threads);
+  getBenchmarks().push_back({fullName, function, threads});
+}
+
+/// Runs \p bench with \p iterations iterations on each of its threads and
+/// returns the elapsed wall clock time in seconds.
+static double runOnce(const Benchmark &bench, uint64_t iterations) {
+  using Clock = std::chrono::steady_clock;
+
+  if (bench.Threads == 1) {
+    State state(iterations, 0, 1);
+    auto start = Clock::now();
+    bench.Function(state);
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  }
+
+  // Start all threads at once, so that they really run concurrently.
+  std::atomic<unsigned> ready(0);
+  std::atomic<bool> go(false);
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i < bench.Threads; ++i) {
+    threads.push_back(std::thread([&, i] {
+      State state(iterations, i, bench.Threads);
+      ready++;
+      while (!go)
+        std::this_thread::yield();
+      bench.Function(state);
+    }));
+  }
+  while (ready < bench.Threads)
+    std::this_thread::yield();
+
+  auto start = Clock::now();
+  go = true;
+  for (auto &thread : threads)
+    thread.join();
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static Result runBenchmark(const Benchmark &bench, const Options &options) {
+  // Find out how many iterations take at least MinTime.
+  uint64_t iterations = 1;
+  const uint64_t maxIterations = 1000000000;
+  while (iterations < maxIterations) {
+    double seconds = runOnce(bench, iterations);
+    if (seconds >= options.MinTime)
+      break;
+    double factor = seconds > 0 ? options.MinTime * 1.4 / seconds : 10;
+    factor = std::min(std::max(factor, 2.0), 10.0);
+    iterations = std::min(uint64_t(iterations * factor), maxIterations);
+  }
+
+  Result result{&bench, iterations, {}};
+  for (unsigned i = 0; i < options.Repetitions; ++i) {
+    double seconds = runOnce(bench, iterations);
+    result.Samples.push_back(seconds * 1e9 / iterations);
+  }
+  std::sort(result.Samples.begin(), result.Samples.end());
+  return result;
+}
+
+static double median(const std::vector<double> &sorted) {
+  size_t n = sorted.size();
+  return n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+}
+
+static double mean(const std::vector<double> &samples) {
+  double sum = 0;
+  for (double sample : samples)
+    sum += sample;
+  return sum / samples.size();
+}
+
+static void printCSVHeader() {
+  printf("name,threads,iterations,repetitions,min_ns,median_ns,mean_ns,"
+         "max_ns\n");
+}
+
+static void printCSV(const Result &result) {
+  printf("%s,%u,%llu,%zu,%.2f,%.2f,%.2f,%.2f\n",
+         result.Bench->Name.c_str(), result.Bench->Threads,
+         (unsigned long long)result.Iterations, result.Samples.size(),
+         result.Samples.front(), median(result.Samples),
+         mean(result.Samples), result.Samples.back());
+  fflush(stdout);
+}
+
+static void printJSON(const std::vector<Result> &results,
+                      const Options &options) {
+  printf("{\n");
+  printf("  \"context\": {\n");
+  printf("    \"min_time\": %g,\n", options.MinTime);
+  printf("    \"repetitions\": %u,\n", options.Repetitions);
+  printf("    \"time_unit\": \"ns\"\n");
+  printf("  },\n");
+  printf("  \"benchmarks\": [");
+  for (size_t i = 0, e = results.size(); i != e; ++i) {
+    const Result &result = results[i];
+    printf(i ? ",\n" : "\n");
+    printf("    {\n");
+    printf("      \"name\": \"%s\",\n", result.Bench->Name.c_str());
+    printf("      \"threads\": %u,\n", result.Bench->Threads);
+    printf("      \"iterations\": %llu,\n",
+           (unsigned long long)result.Iterations);
+    printf("      \"min_ns\": %.2f,\n", result.Samples.front());
+    printf("      \"median_ns\": %.2f,\n", median(result.Samples));
+    printf("      \"mean_ns\": %.2f,\n", mean(result.Samples));
+    printf("      \"max_ns\": %.2f,\n", result.Samples.back());
+    printf("      \"samples_ns\": [");
+    for (size_t j = 0, je = result.Samples.size(); j != je; ++j)
+      printf("%s%.2f", j ? ", " : "", result.Samples[j]);
+    printf("]\n");
+    printf("    }");
+  }
+  printf("\n  ]\n}\n");
+}
+
+static bool startsWith(const char *string, const char *prefix) {
+  return strncmp(string, prefix, strlen(prefix)) == 0;
+}
+
+static bool parseOptions(int argc, char **argv, Options &options) {
+  for (int i = 1; i < argc; ++i) {
+    const char *arg = argv[i];
+    if (startsWith(arg, "--filter=")) {
+      options.Filter = arg + strlen("--filter=");
+    } else if (startsWith(arg, "--min-time=")) {
+      options.MinTime = atof(arg + strlen("--min-time="));
+      if (options.MinTime <= 0)
+        return false;
+    } else if (startsWith(arg, "--repetitions=")) {
+      int repetitions = atoi(arg + strlen("--repetitions="));
+      if (repetitions <= 0)
+        return false;
+      options.Repetitions = repetitions;
+    } else if (strcmp(arg, "--format=csv") == 0) {
+      options.JSON = false;
+    } else if (strcmp(arg, "--format=json") == 0) {
+      options.JSON = true;
+    } else if (strcmp(arg, "--list") == 0) {
+      options.List = true;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    fprintf(stderr,
+            "usage: %s [--filter=<substring>] [--min-time=<seconds>] "
+            "[--repetitions=<n>] [--format=csv|json] [--list]\n",
+            argv[0]);
+    return 1;
+  }
+
+  std::vector<const Benchmark *> selected;
+  for (const Benchmark &bench : getBenchmarks())
+    if (!options.Filter || bench.Name.find(options.Filter) != std::string::npos)
+      selected.push_back(&bench);
+
+  if (options.List) {
+    for (const Benchmark *bench : selected)
+      printf("%s\n", bench->Name.c_str());
+    return 0;
+  }
+
+  std::vector<Result> results;
+  if (!options.JSON)
+    printCSVHeader();
+  for (const Benchmark *bench : selected) {
+    results.push_back(runBenchmark(*bench, options));
+    if (!options.JSON)
+      printCSV(results.back());
+  }
+  if (options.JSON)
+    printJSON(results, options);
+  return 0;
+}
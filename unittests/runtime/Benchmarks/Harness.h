@@ -0,0 +1,105 @@
+//===--- Harness.h - Runtime microbenchmark harness -------------*- C++ -*-===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+//
+// A minimal harness for timing runtime entry points, modeled on Google
+// Benchmark. A benchmark is a function which repeats the operation it measures
+// while State::keepRunning() returns true:
+//
+//   RUNTIME_BENCHMARK(RetainRelease) {
+//     auto *object = ...;
+//     while (state.keepRunning()) {
+//       swift_retain(object);
+//       swift_release(object);
+//     }
+//   }
+//
+// The harness picks the number of iterations, repeats the measurement and
+// reports the time per iteration as CSV or JSON.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SWIFT_UNITTESTS_RUNTIME_BENCHMARKS_HARNESS_H
+#define SWIFT_UNITTESTS_RUNTIME_BENCHMARKS_HARNESS_H
+
+#include <cstdint>
+
+namespace swift {
+namespace runtime_benchmarks {
+
+/// The state of one thread running a benchmark.
+class State {
+  uint64_t Iterations;
+  uint64_t Remaining;
+  unsigned ThreadIndex;
+  unsigned NumThreads;
+
+public:
+  State(uint64_t iterations, unsigned threadIndex, unsigned numThreads)
+    : Iterations(iterations), Remaining(iterations),
+      ThreadIndex(threadIndex), NumThreads(numThreads) {}
+
+  /// Returns true while the benchmark should run another iteration.
+  bool keepRunning() {
+    if (Remaining == 0)
+      return false;
+    --Remaining;
+    return true;
+  }
+
+  /// The number of iterations this thread runs.
+  uint64_t iterations() const { return Iterations; }
+
+  /// The index of this thread, from 0 to numThreads() - 1.
+  unsigned threadIndex() const { return ThreadIndex; }
+
+  /// The number of threads running the benchmark at the same time.
+  unsigned numThreads() const { return NumThreads; }
+};
+
+using BenchmarkFunction = void (*)(State &state);
+
+/// Adds a benchmark to the list the harness runs. Benchmarks with more than
+/// one thread run the function on that many threads at once, and are reported
+/// as "<Name>/threads:<N>".
+struct RegisterBenchmark {
+  RegisterBenchmark(const char *name, BenchmarkFunction function,
+                    unsigned threads = 1);
+};
+
+/// Keeps the compiler from optimizing away the computation of \p value.
+template <typename T>
+inline void doNotOptimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  const volatile T *sink = &value;
+  (void)sink;
+#endif
+}
+
+} // end namespace runtime_benchmarks
+} // end namespace swift
+
+/// Defines and registers a single-threaded benchmark. The body gets the
+/// benchmark's State as 'state'.
+#define RUNTIME_BENCHMARK(Name)                                                \
+  static void Name(::swift::runtime_benchmarks::State &state);                 \
+  static ::swift::runtime_benchmarks::RegisterBenchmark                        \
+    Name##_registration(#Name, Name);                                          \
+  static void Name(::swift::runtime_benchmarks::State &state)
+
+/// Registers the benchmark \p Name again to run on \p Threads threads at once.
+#define RUNTIME_BENCHMARK_THREADS(Name, Threads)                               \
+  static ::swift::runtime_benchmarks::RegisterBenchmark                        \
+    Name##_registration_##Threads(#Name, Name, Threads)
+
+#endif // SWIFT_UNITTESTS_RUNTIME_BENCHMARKS_HARNESS_H
@@ -0,0 +1,327 @@
+//===--- RuntimeBenchmarks.cpp - Runtime entry point benchmarks -----------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2016 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "Harness.h"
+#include "swift/Basic/Demangle.h"
+#include "swift/Basic/ManglingMacros.h"
+#include "swift/Runtime/HeapObject.h"
+#include "swift/Runtime/Metadata.h"
+#include <atomic>
+#include <string>
+
+using namespace swift;
+using namespace swift::runtime_benchmarks;
+
+//===----------------------------------------------------------------------===//
+//                              Test Objects
+//===----------------------------------------------------------------------===//
+
+struct TestObject : HeapObject {
+  size_t Value;
+};
+
+static void destroyTestObject(HeapObject *object) {
+  swift_deallocObject(object, sizeof(TestObject), alignof(TestObject) - 1);
+}
+
+static const FullMetadata<ClassMetadata> TestClassObjectMetadata = {
+  { { &destroyTestObject }, { &VALUE_WITNESS_SYM(Bo) } },
+  { { { MetadataKind::Class } }, 0, /*rodata*/ 1,
+  ClassFlags::UsesSwift1Refcounting, nullptr, 0, 0, 0, 0, 0 }
+};
+
+/// A subclass of TestClassObjectMetadata, to give casts a superclass chain
+/// to walk.
+static const FullMetadata<ClassMetadata> TestSubclassObjectMetadata = {
+  { { &destroyTestObject }, { &VALUE_WITNESS_SYM(Bo) } },
+  { { { MetadataKind::Class } }, &TestClassObjectMetadata, /*rodata*/ 1,
+  ClassFlags::UsesSwift1Refcounting, nullptr, 0, 0, 0, 0, 0 }
+};
+
+/// An unrelated class, which casts of the test objects fail to.
+static const FullMetadata<ClassMetadata> UnrelatedClassMetadata = {
+  { { &destroyTestObject }, { &VALUE_WITNESS_SYM(Bo) } },
+  { { { MetadataKind::Class } }, 0, /*rodata*/ 1,
+  ClassFlags::UsesSwift1Refcounting, nullptr, 0, 0, 0, 0, 0 }
+};
+
+static HeapObject *allocTestObject(const FullMetadata<ClassMetadata> &metadata
+                                     = TestClassObjectMetadata) {
+  return swift_allocObject(&metadata, sizeof(TestObject),
+                           alignof(TestObject) - 1);
+}
+
+//===----------------------------------------------------------------------===//
+//                            Reference Counting
+//===----------------------------------------------------------------------===//
+
+RUNTIME_BENCHMARK(RetainRelease) {
+  auto *object = allocTestObject();
+  while (state.keepRunning()) {
+    swift_retain(object);
+    swift_release(object);
+  }
+  swift_release(object);
+}
+// Each thread has an object of its own.
+RUNTIME_BENCHMARK_THREADS(RetainRelease, 2);
+RUNTIME_BENCHMARK_THREADS(RetainRelease, 4);
+RUNTIME_BENCHMARK_THREADS(RetainRelease, 8);
+
+/// One object that all threads retain and release, so that they contend for
+/// its reference count.
+static HeapObject *getSharedObject() {
+  static HeapObject *object = allocTestObject();
+  return object;
+}
+
+RUNTIME_BENCHMARK(RetainReleaseShared) {
+  auto *object = getSharedObject();
+  while (state.keepRunning()) {
+    swift_retain(object);
+    swift_release(object);
+  }
+}
+RUNTIME_BENCHMARK_THREADS(RetainReleaseShared, 2);
+RUNTIME_BENCHMARK_THREADS(RetainReleaseShared, 4);
+RUNTIME_BENCHMARK_THREADS(RetainReleaseShared, 8);
+
+RUNTIME_BENCHMARK(RetainNRelease) {
+  auto *object = allocTestObject();
+  while (state.keepRunning()) {
+    swift_retain_n(object, 8);
+    swift_release_n(object, 8);
+  }
+  swift_release(object);
+}
+
+RUNTIME_BENCHMARK(AllocObject) {
+  while (state.keepRunning())
+    swift_release(allocTestObject());
+}
+RUNTIME_BENCHMARK_THREADS(AllocObject, 4);
+
+//===----------------------------------------------------------------------===//
+//                                Metadata
+//===----------------------------------------------------------------------===//
+
+/// Some unique global pointers.
+static uint32_t Global1 = 0;
+static uint32_t Global2 = 0;
+
+/// The general structure of a generic metadata.
+template <typename Instance>
+struct GenericMetadataTest {
+  GenericMetadata Header;
+  Instance Template;
+};
+
+static Metadata *allocateTestMetadata(GenericMetadata *pattern,
+                                      const void *args) {
+  auto metadata = swift_allocateGenericValueMetadata(pattern, args);
+  auto metadataWords = reinterpret_cast<const void**>(metadata);
+  auto argsWords = reinterpret_cast<const void* const*>(args);
+  metadataWords[2] = argsWords[0];
+  return metadata;
+}
+
+#define GENERIC_METADATA_PATTERN(Name)                                         \
+  static GenericMetadataTest<StructMetadata> Name = {                          \
+    {                                                                          \
+      allocateTestMetadata,                                                    \
+      3 * sizeof(void*), /* metadata size */                                   \
+      1, /* num arguments */                                                   \
+      0, /* address point */                                                   \
+      {} /* private data */                                                    \
+    },                                                                         \
+    {                                                                          \
+      MetadataKind::Struct,                                                    \
+      reinterpret_cast<const NominalTypeDescriptor*>(&Global1),                \
+      nullptr                                                                  \
+    }                                                                          \
+  }
+
+// The hit and miss benchmarks use separate patterns, so that the entries the
+// miss benchmark adds don't slow down the lookups of the hit benchmark.
+GENERIC_METADATA_PATTERN(HitPattern);
+GENERIC_METADATA_PATTERN(MissPattern);
+
+RUNTIME_BENCHMARK(GetGenericMetadataHit) {
+  auto pattern = (GenericMetadata*) &HitPattern;
+  const void *args[] = { &Global2 };
+  while (state.keepRunning())
+    doNotOptimize(swift_getGenericMetadata(pattern, args));
+}
+RUNTIME_BENCHMARK_THREADS(GetGenericMetadataHit, 4);
+
+// Every iteration instantiates metadata for arguments that have not been seen
+// before. The arguments are only used as keys, so they need not point to
+// anything. The cache keeps growing from run to run, so the late runs are
+// somewhat slower than the early ones.
+RUNTIME_BENCHMARK(GetGenericMetadataMiss) {
+  static std::atomic<uintptr_t> nextKey(1);
+  auto pattern = (GenericMetadata*) &MissPattern;
+  while (state.keepRunning()) {
+    const void *args[] = {
+      reinterpret_cast<const void *>(nextKey++ * alignof(void*))
+    };
+    doNotOptimize(swift_getGenericMetadata(pattern, args));
+  }
+}
+
+RUNTIME_BENCHMARK(GetMetatypeMetadata) {
+  while (state.keepRunning())
+    doNotOptimize(swift_getMetatypeMetadata(&TestClassObjectMetadata));
+}
+
+//===----------------------------------------------------------------------===//
+//                        Conformances and Casting
+//===----------------------------------------------------------------------===//
+
+extern "C" const Metadata METADATA_SYM(Si); // Int
+extern "C" const ProtocolDescriptor PROTOCOL_DESCR_SYM(s23CustomStringConvertible);
+extern "C" const ProtocolDescriptor PROTOCOL_DESCR_SYM(s5Error);
+
+// Int conforms to CustomStringConvertible, but not to Error. Both answers are
+// cached after the first lookup.
+RUNTIME_BENCHMARK(ConformsToProtocolHit) {
+  while (state.keepRunning())
+    doNotOptimize(swift_conformsToProtocol(
+        &METADATA_SYM(Si), &PROTOCOL_DESCR_SYM(s23CustomStringConvertible)));
+}
+RUNTIME_BENCHMARK_THREADS(ConformsToProtocolHit, 4);
+
+RUNTIME_BENCHMARK(ConformsToProtocolMiss) {
+  while (state.keepRunning())
+    doNotOptimize(swift_conformsToProtocol(&METADATA_SYM(Si),
+                                           &PROTOCOL_DESCR_SYM(s5Error)));
+}
+
+static const Metadata *getAnyMetadata() {
+  return swift_getExistentialTypeMetadata(0, nullptr);
+}
+
+static const Metadata *getCustomStringConvertibleMetadata() {
+  const ProtocolDescriptor *protocols[] = {
+    &PROTOCOL_DESCR_SYM(s23CustomStringConvertible)
+  };
+  return swift_getExistentialTypeMetadata(1, protocols);
+}
+
+/// An existential container with room for one witness table.
+struct ExistentialWithOneWitnessTable {
+  OpaqueExistentialContainer Container;
+  const WitnessTable *Table;
+};
+
+RUNTIME_BENCHMARK(DynamicCastIntToInt) {
+  intptr_t source = 42, dest = 0;
+  while (state.keepRunning()) {
+    swift_dynamicCast(reinterpret_cast<OpaqueValue *>(&dest),
+                      reinterpret_cast<OpaqueValue *>(&source),
+                      &METADATA_SYM(Si), &METADATA_SYM(Si),
+                      DynamicCastFlags::Default);
+    doNotOptimize(dest);
+  }
+}
+
+RUNTIME_BENCHMARK(DynamicCastIntToAny) {
+  auto anyMetadata = getAnyMetadata();
+  intptr_t source = 42;
+  OpaqueExistentialContainer dest;
+  while (state.keepRunning()) {
+    swift_dynamicCast(reinterpret_cast<OpaqueValue *>(&dest),
+                      reinterpret_cast<OpaqueValue *>(&source),
+                      &METADATA_SYM(Si), anyMetadata,
+                      DynamicCastFlags::Default);
+    doNotOptimize(dest);
+  }
+}
+
+RUNTIME_BENCHMARK(DynamicCastAnyToInt) {
+  auto anyMetadata = getAnyMetadata();
+  OpaqueExistentialContainer source;
+  *reinterpret_cast<intptr_t *>(&source.Buffer) = 42;
+  source.Type = &METADATA_SYM(Si);
+  intptr_t dest = 0;
+  while (state.keepRunning()) {
+    swift_dynamicCast(reinterpret_cast<OpaqueValue *>(&dest),
+                      reinterpret_cast<OpaqueValue *>(&source),
+                      anyMetadata, &METADATA_SYM(Si),
+                      DynamicCastFlags::Default);
+    doNotOptimize(dest);
+  }
+}
+
+RUNTIME_BENCHMARK(DynamicCastIntToProtocol) {
+  auto protocolMetadata = getCustomStringConvertibleMetadata();
+  intptr_t source = 42;
+  ExistentialWithOneWitnessTable dest;
+  while (state.keepRunning()) {
+    swift_dynamicCast(reinterpret_cast<OpaqueValue *>(&dest),
+                      reinterpret_cast<OpaqueValue *>(&source),
+                      &METADATA_SYM(Si), protocolMetadata,
+                      DynamicCastFlags::Default);
+    doNotOptimize(dest);
+  }
+}
+
+RUNTIME_BENCHMARK(DynamicCastClassToSuperclass) {
+  auto *object = allocTestObject(TestSubclassObjectMetadata);
+  while (state.keepRunning())
+    doNotOptimize(swift_dynamicCastClass(object, &TestClassObjectMetadata));
+  swift_release(object);
+}
+
+RUNTIME_BENCHMARK(DynamicCastClassFailure) {
+  auto *object = allocTestObject(TestSubclassObjectMetadata);
+  while (state.keepRunning())
+    doNotOptimize(swift_dynamicCastClass(object, &UnrelatedClassMetadata));
+  swift_release(object);
+}
+
+//===----------------------------------------------------------------------===//
+//                               Demangling
+//===----------------------------------------------------------------------===//
+
+/// A mix of type, function, and specialized function symbols.
+static const char *const MangledNames[] = {
+  "_TtSa",
+  "_TtGSaSS_",
+  "_TtGSqGSaC5sugar7MyClass__",
+  "_TFC3foo3bar3basfT3zimCS_3zim_T_",
+  "_TFC3foo3barCfT_S0_",
+  "_TWPC3foo3barS_8barrables",
+  "_TTSg5Si___TFSqcfT_GSqx_",
+  "_TTSg5SiSis3Foos_Sf___TFSqcfT_GSqx_",
+};
+
+static const size_t NumMangledNames =
+    sizeof(MangledNames) / sizeof(MangledNames[0]);
+
+RUNTIME_BENCHMARK(DemangleSymbolAsString) {
+  size_t index = 0;
+  while (state.keepRunning()) {
+    doNotOptimize(Demangle::demangleSymbolAsString(MangledNames[index]));
+    index = (index + 1) % NumMangledNames;
+  }
+}
+
+RUNTIME_BENCHMARK(DemangleSymbolAsNode) {
+  Demangle::Context context;
+  size_t index = 0;
+  while (state.keepRunning()) {
+    doNotOptimize(context.demangleSymbolAsNode(MangledNames[index]));
+    context.clear();
+    index = (index + 1) % NumMangledNames;
+  }
+}
@@ -0,0 +1,98 @@
+//===--- Heap.cpp - Heap allocation tests ---------------------------------===//
+//
+// This source file is part of the Swift.org open source project
+//
+// Copyright (c) 2014 - 2017 Apple Inc. and the Swift project authors
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://swift.org/LICENSE.txt for license information
+// See https://swift.org/CONTRIBUTORS.txt for the list of Swift project authors
+//
+//===----------------------------------------------------------------------===//
+
+#include "swift/Runtime/Heap.h"
+#include "swift/Runtime/HeapObject.h"
+#include "gtest/gtest.h"
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace swift;
+
+static void allocAndFree(size_t maxSize, size_t alignMask) {
+  std::vector<std::pair<void *, size_t>> allocations;
+  for (size_t size = 0; size <= maxSize; ++size) {
+    void *p = swift_slowAlloc(size, alignMask);
+    ASSERT_NE(nullptr, p);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(p) & alignMask);
+    memset(p, 0xAB, size);
+    allocations.push_back({p, size});
+  }
+  for (auto &allocation : allocations)
+    swift_slowDealloc(allocation.first, allocation.second, alignMask);
+}
+
+TEST(HeapTest, slowAlloc_small_sizes) {
+  allocAndFree(512, 7);
+  allocAndFree(512, 15);
+}
+
+TEST(HeapTest, slowAlloc_free_on_other_thread) {
+  std::vector<void *> allocations;
+  for (unsigned i = 0; i != 1000; ++i)
+    allocations.push_back(swift_slowAlloc(48, 7));
+
+  std::thread([&] {
+    for (void *p : allocations)
+      swift_slowDealloc(p, 48, 7);
+  }).join();
+
+  // The freed blocks must be reusable from this thread.
+  allocAndFree(64, 7);
+}
+
+TEST(HeapTest, slab_allocator_statistics) {
+  SlabAllocatorStatistics before;
+  if (!swift_getSlabAllocatorStatistics(&before))
+    return;
+
+  void *p = swift_slowAlloc(32, 7);
+  swift_slowDealloc(p, 32, 7);
+
+  SlabAllocatorStatistics after;
+  ASSERT_TRUE(swift_getSlabAllocatorStatistics(&after));
+  EXPECT_EQ(before.NumAllocations + 1, after.NumAllocations);
+  EXPECT_EQ(before.NumDeallocations + 1, after.NumDeallocations);
+  EXPECT_LE(1u, after.NumChunks);
+}
+
+TEST(HeapTest, slowDealloc_with_different_size) {
+  SlabAllocatorStatistics stats;
+  if (!swift_getSlabAllocatorStatistics(&stats))
+    return;
+
+  // Tail-allocated objects are freed with their instance size, which is
+  // smaller than what was allocated. The block must still go back to its own
+  // size class.
+  void *p = swift_slowAlloc(200, 7);
+  swift_slowDealloc(p, 40, 7);
+  void *q = swift_slowAlloc(200, 7);
+  EXPECT_EQ(p, q);
+  memset(q, 0xAB, 200);
+  swift_slowDealloc(q, 200, 7);
+}
+
+TEST(HeapTest, slab_allocation_size) {
+  SlabAllocatorStatistics stats;
+  if (!swift_getSlabAllocatorStatistics(&stats))
+    return;
+
+  // Blocks are rounded up to their size class; malloc'd memory is not ours.
+  void *p = swift_slowAlloc(40, 7);
+  EXPECT_EQ(48u, swift_getSlabAllocationSize(p));
+  swift_slowDealloc(p, 40, 7);
+
+  void *q = swift_slowAlloc(1000, 7);
+  EXPECT_EQ(0u, swift_getSlabAllocationSize(q));
+  swift_slowDealloc(q, 1000, 7);
+}
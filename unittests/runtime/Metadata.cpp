@@ -12,6 +12,7 @@
 
 #include "swift/Runtime/Metadata.h"
 #include "swift/Runtime/Concurrent.h"
+#include "swift/Runtime/HeapObject.h"
 #include "gtest/gtest.h"
 #include <iterator>
 #include <functional>
@@ -791,6 +792,79 @@ TEST(MetadataTest, installCommonValueWitnesses_pod_indirect) {
   EXPECT_EQ(buf2.canary, (uintptr_t)0xA5A5A5A5U);
 }
 
+static void destroyTestObject(HeapObject *object) {
+  swift_deallocObject(object, sizeof(HeapObject), alignof(HeapObject) - 1);
+}
+
+static const FullMetadata<ClassMetadata> TestClassObjectMetadata = {
+  { { &destroyTestObject }, { &VALUE_WITNESS_SYM(Bo) } },
+  { { { MetadataKind::Class } }, 0, /*rodata*/ 1,
+  ClassFlags::UsesSwift1Refcounting, nullptr, 0, 0, 0, 0, 0 }
+};
+
+static HeapObject *allocTestObject() {
+  return swift_allocObject(&TestClassObjectMetadata, sizeof(HeapObject),
+                           alignof(HeapObject) - 1);
+}
+
+TEST(MetadataTest, initStructMetadata_singleReference) {
+  ExtraInhabitantsValueWitnessTable testTable;
+  testTable.storeExtraInhabitant = VALUE_WITNESS_SYM(Bo).storeExtraInhabitant;
+  testTable.getExtraInhabitantIndex =
+    VALUE_WITNESS_SYM(Bo).getExtraInhabitantIndex;
+
+  const TypeLayout *fieldTypes[] = { VALUE_WITNESS_SYM(Bo).getTypeLayout() };
+  size_t fieldOffsets[1];
+  swift_initStructMetadata_UniversalStrategy(1, fieldTypes, fieldOffsets,
+                                             &testTable);
+
+  // The struct borrows the witnesses of the reference.
+  EXPECT_EQ(VALUE_WITNESS_SYM(Bo).initializeWithCopy,
+            testTable.initializeWithCopy);
+  EXPECT_EQ(VALUE_WITNESS_SYM(Bo).destroy, testTable.destroy);
+  EXPECT_EQ(VALUE_WITNESS_SYM(Bo).size, testTable.size);
+}
+
+TEST(MetadataTest, initStructMetadata_referencePair) {
+  ExtraInhabitantsValueWitnessTable testTable;
+  testTable.storeExtraInhabitant = VALUE_WITNESS_SYM(Bo).storeExtraInhabitant;
+  testTable.getExtraInhabitantIndex =
+    VALUE_WITNESS_SYM(Bo).getExtraInhabitantIndex;
+  FullMetadata<Metadata> testMetadata{{&testTable}, {MetadataKind::Opaque}};
+
+  const TypeLayout *fieldTypes[] = {
+    VALUE_WITNESS_SYM(Bo).getTypeLayout(),
+    VALUE_WITNESS_SYM(Bo).getTypeLayout()
+  };
+  size_t fieldOffsets[2];
+  swift_initStructMetadata_UniversalStrategy(2, fieldTypes, fieldOffsets,
+                                             &testTable);
+  EXPECT_EQ(0u, fieldOffsets[0]);
+  EXPECT_EQ(sizeof(void*), fieldOffsets[1]);
+  EXPECT_EQ(2 * sizeof(void*), testTable.size);
+
+  HeapObject *first = allocTestObject();
+  HeapObject *second = allocTestObject();
+  HeapObject *src[2] = { first, second };
+  HeapObject *dest[2];
+
+  // Copying retains both references, and destroying releases them.
+  testTable.initializeWithCopy(reinterpret_cast<OpaqueValue *>(dest),
+                               reinterpret_cast<OpaqueValue *>(src),
+                               &testMetadata);
+  EXPECT_EQ(first, dest[0]);
+  EXPECT_EQ(second, dest[1]);
+  EXPECT_EQ(2u, swift_retainCount(first));
+  EXPECT_EQ(2u, swift_retainCount(second));
+
+  testTable.destroy(reinterpret_cast<OpaqueValue *>(dest), &testMetadata);
+  EXPECT_EQ(1u, swift_retainCount(first));
+  EXPECT_EQ(1u, swift_retainCount(second));
+
+  swift_release(first);
+  swift_release(second);
+}
+
 // We cannot construct RelativeDirectPointer instances, so define
 // a "shadow" struct for that purpose
 struct GenericWitnessTableStorage {
@@ -799,7 +873,7 @@ struct GenericWitnessTableStorage {
   int32_t Protocol;
   int32_t Pattern;
   int32_t Instantiator;
-  void *PrivateData[swift::NumGenericMetadataPrivateDataWords];
+  int32_t PrivateData;
 };
 
 template<typename T>
@@ -850,6 +924,10 @@ GenericWitnessTableStorage tableStorage1;
 GenericWitnessTableStorage tableStorage2;
 GenericWitnessTableStorage tableStorage3;
 GenericWitnessTableStorage tableStorage4;
+void *tablePrivateData1[swift::NumGenericMetadataPrivateDataWords];
+void *tablePrivateData2[swift::NumGenericMetadataPrivateDataWords];
+void *tablePrivateData3[swift::NumGenericMetadataPrivateDataWords];
+void *tablePrivateData4[swift::NumGenericMetadataPrivateDataWords];
 
 const void *witnesses[] = {
   (void *) 123,
@@ -875,6 +953,7 @@ TEST(WitnessTableTest, getGenericWitnessTable) {
     initializeRelativePointer(&tableStorage1.Protocol, &testProtocol.descriptor);
     initializeRelativePointer(&tableStorage1.Pattern, witnesses);
     initializeRelativePointer(&tableStorage1.Instantiator, nullptr);
+    initializeRelativePointer(&tableStorage1.PrivateData, tablePrivateData1);
 
     GenericWitnessTable *table = reinterpret_cast<GenericWitnessTable *>(
         &tableStorage1);
@@ -898,6 +977,7 @@ TEST(WitnessTableTest, getGenericWitnessTable) {
     initializeRelativePointer(&tableStorage2.Pattern, witnesses);
     initializeRelativePointer(&tableStorage2.Instantiator,
                               (const void *) witnessTableInstantiator);
+    initializeRelativePointer(&tableStorage2.PrivateData, tablePrivateData2);
 
     GenericWitnessTable *table = reinterpret_cast<GenericWitnessTable *>(
         &tableStorage2);
@@ -928,6 +1008,7 @@ TEST(WitnessTableTest, getGenericWitnessTable) {
     initializeRelativePointer(&tableStorage3.Protocol, &testProtocol.descriptor);
     initializeRelativePointer(&tableStorage3.Pattern, witnesses);
     initializeRelativePointer(&tableStorage3.Instantiator, witnessTableInstantiator);
+    initializeRelativePointer(&tableStorage3.PrivateData, tablePrivateData3);
 
     GenericWitnessTable *table = reinterpret_cast<GenericWitnessTable *>(
         &tableStorage3);
@@ -959,6 +1040,7 @@ TEST(WitnessTableTest, getGenericWitnessTable) {
     initializeRelativePointer(&tableStorage4.Protocol, &testProtocol.descriptor);
     initializeRelativePointer(&tableStorage4.Pattern, witnesses);
     initializeRelativePointer(&tableStorage4.Instantiator, witnessTableInstantiator);
+    initializeRelativePointer(&tableStorage4.PrivateData, tablePrivateData4);
 
     GenericWitnessTable *table = reinterpret_cast<GenericWitnessTable *>(
         &tableStorage4);
@@ -117,6 +117,24 @@ TEST(RefcountingTest, retain_release_n) {
   EXPECT_EQ(1u, swift_retainCount(object));
 }
 
+TEST(RefcountingTest, retain_release_array) {
+  size_t value1 = 0, value2 = 0;
+  auto object1 = allocTestObject(&value1, 1);
+  auto object2 = allocTestObject(&value2, 2);
+  HeapObject *objects[] = { object1, nullptr, object2, object1 };
+  swift_retain_array(objects, 4);
+  EXPECT_EQ(3u, swift_retainCount(object1));
+  EXPECT_EQ(2u, swift_retainCount(object2));
+  swift_release_array(objects, 3);
+  EXPECT_EQ(0u, value1);
+  EXPECT_EQ(0u, value2);
+  EXPECT_EQ(2u, swift_retainCount(object1));
+  EXPECT_EQ(1u, swift_retainCount(object2));
+  swift_release_array(objects, 4);
+  EXPECT_EQ(1u, value1);
+  EXPECT_EQ(2u, value2);
+}
+
 TEST(RefcountingTest, unknown_retain_release_n) {
   size_t value = 0;
   auto object = allocTestObject(&value, 1);
@@ -246,3 +264,73 @@ TEST(RefcountingTest, nonatomic_unknown_retain_release_n) {
   EXPECT_EQ(1u, swift_retainCount(object));
 }
 
+
+TEST(RefcountingTest, weak_does_not_retain_unowned) {
+  size_t value = 0;
+  auto object = allocTestObject(&value, 1);
+  EXPECT_EQ(1u, swift_unownedRetainCount(object));
+
+  WeakReference ref1, ref2;
+  swift_weakInit(&ref1, object);
+  swift_weakCopyInit(&ref2, &ref1);
+  EXPECT_EQ(1u, swift_unownedRetainCount(object));
+
+  auto loaded = swift_weakLoadStrong(&ref2);
+  EXPECT_EQ(object, loaded);
+  swift_release(loaded);
+
+  swift_weakDestroy(&ref1);
+  swift_weakDestroy(&ref2);
+  swift_release(object);
+  EXPECT_EQ(1u, value);
+}
+
+TEST(RefcountingTest, weak_load_after_dealloc) {
+  size_t value = 0;
+  auto object = allocTestObject(&value, 1);
+
+  WeakReference ref1, ref2, ref3;
+  swift_weakInit(&ref1, object);
+  swift_weakCopyInit(&ref2, &ref1);
+  swift_weakInit(&ref3, nullptr);
+  swift_weakAssign(&ref3, object);
+
+  swift_release(object);
+  EXPECT_EQ(1u, value);
+
+  EXPECT_EQ(nullptr, swift_weakLoadStrong(&ref1));
+  EXPECT_EQ(nullptr, swift_weakLoadStrong(&ref1));
+  EXPECT_EQ(nullptr, swift_weakTakeStrong(&ref2));
+
+  WeakReference ref4;
+  swift_weakTakeInit(&ref4, &ref3);
+  EXPECT_EQ(nullptr, swift_weakLoadStrong(&ref4));
+
+  swift_weakDestroy(&ref1);
+  swift_weakDestroy(&ref4);
+}
+
+TEST(RefcountingTest, weak_reference_to_reused_stack_object) {
+  alignas(TestObject) char storage[sizeof(TestObject)];
+  auto object = reinterpret_cast<TestObject *>(storage);
+
+  // A stack object whose lifetime ends without it being deallocated leaves
+  // its side table behind.
+  swift_initStackObject(&TestClassObjectMetadata, object);
+  WeakReference ref1;
+  swift_weakInit(&ref1, object);
+  swift_weakDestroy(&ref1);
+
+  // A new object at the same address must not pick that side table up.
+  size_t value = 0;
+  swift_initStackObject(&TestClassObjectMetadata, object);
+  object->Addr = &value;
+  object->Value = 1;
+  WeakReference ref2;
+  swift_weakInit(&ref2, object);
+  swift_release(object);
+  EXPECT_EQ(1u, value);
+  EXPECT_EQ(nullptr, swift_weakLoadStrong(&ref2));
+  swift_weakDestroy(&ref2);
+  swift_verifyEndOfLifetime(object);
+}
@@ -889,6 +889,31 @@ DictionaryTestSuite.test("COW.Slow.RemoveAllDoesNotReallocate") {
 }
 
 
+DictionaryTestSuite.test("reserveCapacity") {
+  var d = Dictionary<Int, Int>()
+  d.reserveCapacity(100)
+  let identity1 = d._rawIdentifier()
+  let capacity = d._variantBuffer.asNative.capacity
+  for i in 0..<100 {
+    d[i] = i * 10
+  }
+  // Inserting the reserved number of elements does not reallocate.
+  expectEqual(identity1, d._rawIdentifier())
+  expectEqual(100, d.count)
+  expectOptionalEqual(990, d[99])
+
+  // Reserving less than the current count does not shrink the buffer.
+  d.reserveCapacity(10)
+  expectEqual(identity1, d._rawIdentifier())
+  expectEqual(capacity, d._variantBuffer.asNative.capacity)
+
+  // A shared buffer is copied.
+  var d2 = d
+  d2.reserveCapacity(10)
+  expectNotEqual(identity1, d2._rawIdentifier())
+  expectEqual(d, d2)
+}
+
 DictionaryTestSuite.test("COW.Fast.CountDoesNotReallocate") {
   var d = getCOWFastDictionary()
   var identity1 = d._rawIdentifier()
@@ -1011,6 +1011,33 @@ SetTestSuite.test("COW.Fast.FirstDoesNotReallocate") {
   expectEqual(identity1, s._rawIdentifier())
 }
 
+SetTestSuite.test("reserveCapacity") {
+  var s = Set<Int>()
+  s.reserveCapacity(100)
+  let identity1 = s._rawIdentifier()
+  let capacity = s._variantBuffer.asNative.capacity
+  for i in 0..<100 {
+    s.insert(i)
+  }
+  // Inserting the reserved number of elements does not reallocate.
+  expectEqual(identity1, s._rawIdentifier())
+  expectEqual(100, s.count)
+
+  // Reserving less than the current count does not shrink the buffer.
+  s.reserveCapacity(10)
+  expectEqual(identity1, s._rawIdentifier())
+  expectEqual(capacity, s._variantBuffer.asNative.capacity)
+}
+
+SetTestSuite.test("init(_:)/Capacity") {
+  let s = Set(0..<100)
+  let capacity = s._variantBuffer.asNative.capacity
+  // The buffer is sized for the final count and the maximum load factor up
+  // front.
+  expectLE(100 * 4, capacity * 3)
+  expectEqual(100, s.count)
+}
+
 SetTestSuite.test("COW.Fast.CountDoesNotReallocate") {
   var s = getCOWFastSet()
   var identity1 = s._rawIdentifier()
@@ -0,0 +1,102 @@
+// RUN: %target-run-simple-swift
+// REQUIRES: executable_test
+
+import StdlibUnittest
+import StdlibCollectionUnittest
+
+var SmallArrayTests = TestSuite("SmallArray")
+
+SmallArrayTests.test("InlineAndOutOfLine") {
+  var a = SmallArray<LifetimeTracked>()
+  for i in 0..<4 {
+    a.append(LifetimeTracked(i))
+  }
+  expectNil(a.withContiguousStorageIfAvailable { _ in true })
+  expectEqualSequence(0..<4, a.map { $0.value })
+
+  a.append(LifetimeTracked(4))
+  expectTrue(a.withContiguousStorageIfAvailable { _ in true } ?? false)
+  expectEqualSequence(0..<5, a.map { $0.value })
+
+  // Removing from the end keeps the out-of-line storage.
+  expectEqual(4, a.removeLast().value)
+  expectTrue(a.withContiguousStorageIfAvailable { _ in true } ?? false)
+
+  // Other replacements which fit move the elements back inline.
+  a.remove(at: 0)
+  expectNil(a.withContiguousStorageIfAvailable { _ in true })
+  expectEqualSequence(1..<4, a.map { $0.value })
+
+  a[1] = LifetimeTracked(20)
+  expectEqualSequence([1, 20, 3], a.map { $0.value })
+  expectEqual(3, a.popLast()?.value)
+  a.removeAll()
+  expectTrue(a.isEmpty)
+  expectNil(a.popLast())
+}
+
+SmallArrayTests.test("ValueSemantics") {
+  var a: SmallArray = [1, 2, 3]
+  let b = a
+  a[0] = 10
+  a.append(contentsOf: 4..<8)
+  expectEqualSequence([1, 2, 3], b)
+  expectEqualSequence([10, 2, 3, 4, 5, 6, 7], a)
+
+  var c = a
+  c[0] = 1
+  expectEqualSequence([10, 2, 3, 4, 5, 6, 7], a)
+  expectEqualSequence([1, 2, 3, 4, 5, 6, 7], c)
+}
+
+SmallArrayTests.test("Equatable/Description") {
+  let a: SmallArray = [1, 2, 3]
+  expectTrue(a == SmallArray(1...3))
+  expectTrue(a != [1, 2, 3, 4, 5])
+  expectEqual("[1, 2, 3]", a.description)
+  expectEqual("SmallArray([1, 2, 3])", a.debugDescription)
+}
+
+do {
+  var resiliencyChecks = CollectionMisuseResiliencyChecks.all
+  resiliencyChecks.creatingOutOfBoundsIndicesBehavior = .none
+
+  SmallArrayTests.addMutableRandomAccessCollectionTests(
+    makeCollection: { (elements: [LifetimeTracked]) in
+      return SmallArray(elements)
+    },
+    wrapValue: { (element: OpaqueValue<Int>) in
+      LifetimeTracked(element.value, identity: element.identity)
+    },
+    extractValue: { (element: LifetimeTracked) in
+      OpaqueValue(element.value, identity: element.identity)
+    },
+    makeCollectionOfEquatable: { (elements: [MinimalEquatableValue]) in
+      return SmallArray(elements)
+    },
+    wrapValueIntoEquatable: identityEq,
+    extractValueFromEquatable: identityEq,
+    makeCollectionOfComparable: { (elements: [MinimalComparableValue]) in
+      return SmallArray(elements)
+    },
+    wrapValueIntoComparable: identityComp,
+    extractValueFromComparable: identityComp,
+    resiliencyChecks: resiliencyChecks,
+    withUnsafeMutableBufferPointerIsSupported: false,
+    isFixedLengthCollection: false)
+
+  SmallArrayTests.addRangeReplaceableRandomAccessCollectionTests(
+    makeCollection: { (elements: [LifetimeTracked]) in
+      return SmallArray(elements)
+    },
+    wrapValue: { (element: OpaqueValue<Int>) in LifetimeTracked(element.value) },
+    extractValue: { (element: LifetimeTracked) in OpaqueValue(element.value) },
+    makeCollectionOfEquatable: { (elements: [MinimalEquatableValue]) in
+      return SmallArray(elements)
+    },
+    wrapValueIntoEquatable: identityEq,
+    extractValueFromEquatable: identityEq,
+    resiliencyChecks: resiliencyChecks)
+}
+
+runAllTests()
@@ -321,6 +321,25 @@ StringTests.test("_splitFirst") {
   expectEqual("bar", after)
 }
 
+StringTests.test("hashValue/ASCII") {
+  // Lengths on either side of the block size the ASCII hash path buffers
+  // collation elements in.
+  for count in [0, 1, 7, 8, 63, 64, 65, 127, 128, 129, 1_000] {
+    let alphabet = Array("ab-C:0\t".characters)
+    var ascii = ""
+    for i in 0..<count {
+      ascii.append(alphabet[i % alphabet.count])
+    }
+    var utf16 = ascii + "\u{00e9}"
+    utf16.removeLast()
+    expectEqual(ascii, utf16)
+    expectEqual(ascii.hashValue, utf16.hashValue)
+
+    let longer = ascii + "x"
+    expectEqual(longer.hashValue, (utf16 + "x").hashValue)
+  }
+}
+
 StringTests.test("hasPrefix")
   .skip(.nativeRuntime("String.hasPrefix undefined without _runtime(_ObjC)"))
   .code {